@@ -3,6 +3,7 @@
 include(APR)
 include(Boost)
 include(EXPAT)
+include(Mimalloc)
 include(Tracy)
 include(xxHash)
 include(ZLIBNG)
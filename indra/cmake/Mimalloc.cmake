@@ -0,0 +1,29 @@
+# -*- cmake -*-
+include(Prebuilt)
+
+include_guard()
+add_library( ll::mimalloc INTERFACE IMPORTED )
+
+# Off by default: with it on, LLHeap (indra/llcommon/llheap.h) serves the
+# image, LLSD, geometry and UI heaps from mimalloc instead of the CRT.
+option(USE_MIMALLOC "Serve the LLHeap subsystem heaps from mimalloc." OFF)
+
+if (NOT USE_MIMALLOC)
+  return()
+endif ()
+
+target_compile_definitions( ll::mimalloc INTERFACE LL_USE_MIMALLOC=1 )
+
+if (USE_CONAN)
+  target_link_libraries( ll::mimalloc INTERFACE CONAN_PKG::mimalloc )
+  return()
+endif ()
+
+use_system_binary(mimalloc)
+use_prebuilt_binary(mimalloc)
+if (WINDOWS)
+  target_link_libraries( ll::mimalloc INTERFACE ${ARCH_PREBUILT_DIRS_RELEASE}/mimalloc-static.lib )
+else ()
+  target_link_libraries( ll::mimalloc INTERFACE ${ARCH_PREBUILT_DIRS_RELEASE}/libmimalloc.a )
+endif ()
+target_include_directories( ll::mimalloc SYSTEM INTERFACE ${LIBS_PREBUILT_DIR}/include/mimalloc )
@@ -0,0 +1,494 @@
+/**
+ * @file llbenchmark.cpp
+ * @brief Microbenchmarks of the hot kernels of llcommon, llmath and llimage
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+#include "linden_common.h"
+#include "llpointer.h"
+#include "lltimer.h"
+
+// Linden library includes
+#include "lldate.h"
+#include "llimage.h"
+#include "llimagej2c.h"
+#include "llmath.h"
+#include "llmatrix4a.h"
+#include "lloctree.h"
+#include "llsdserialize.h"
+#include "lluuid.h"
+#include "llvector4a.h"
+#include "llvector4abulk.h"
+#include "llvolume.h"
+#include "llvolumeoctree.h"
+
+// system libraries
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+// doc string provided when invoking the program with --help
+static const char USAGE[] = "\n"
+"usage:\tllbenchmark [options]\n"
+"\n"
+" -h, --help\n"
+"        Print this help\n"
+" -f, --filter <text>\n"
+"        Only run the benchmarks whose name contains <text>.\n"
+" -o, --output <file>\n"
+"        Write the results to <file> as LLSD XML, milliseconds per operation by benchmark name.\n"
+" -b, --baseline <file>\n"
+"        Compare the results with the ones of an earlier run written with -o.\n"
+"\n";
+
+// Times 'op' over enough runs to be meaningful and returns milliseconds per run
+template<typename OP>
+F64 time_op(OP op)
+{
+    op(); // warm up the caches
+    LLTimer timer;
+    S32 runs = 0;
+    do
+    {
+        op();
+        ++runs;
+    } while (runs < 100000 && timer.getElapsedTimeF64() < 0.5);
+    return timer.getElapsedTimeF64() * 1000.0 / runs;
+}
+
+// Keeps the optimizer from dropping work whose result is otherwise unused
+static volatile F32 sSink = 0.f;
+
+struct Benchmark
+{
+    std::string mName;
+    std::function<F64()> mRun; // milliseconds per operation
+};
+
+static std::vector<Benchmark> sBenchmarks;
+
+static void add(const std::string& name, std::function<F64()> run)
+{
+    sBenchmarks.push_back({ name, run });
+}
+
+// Pseudo random content, the same from run to run
+static U32 sSeed = 1;
+static F32 rand_unit()
+{
+    sSeed = sSeed * 1664525 + 1013904223;
+    return (F32)(sSeed >> 8) / (F32)(1 << 24);
+}
+
+static void add_math_benchmarks()
+{
+    const U32 COUNT = 4096;
+
+    add("llmath/affine_transform_4096", [=]()
+        {
+            LLMatrix4a mat;
+            mat.setIdentity();
+            mat.mMatrix[3].set(1.f, 2.f, 3.f, 1.f);
+            std::vector<LLVector4a> src(COUNT), dst(COUNT);
+            for (LLVector4a& v : src)
+            {
+                v.set(rand_unit(), rand_unit(), rand_unit(), 1.f);
+            }
+            return time_op([&]()
+                {
+                    for (U32 i = 0; i < COUNT; ++i)
+                    {
+                        mat.affineTransform(src[i], dst[i]);
+                    }
+                    sSink = sSink + dst[COUNT - 1][0];
+                });
+        });
+
+    add("llmath/affine_transform_bulk_4096", [=]()
+        {
+            LLMatrix4a mat;
+            mat.setIdentity();
+            mat.mMatrix[3].set(1.f, 2.f, 3.f, 1.f);
+            std::vector<LLVector4a> src(COUNT), dst(COUNT);
+            for (LLVector4a& v : src)
+            {
+                v.set(rand_unit(), rand_unit(), rand_unit(), 1.f);
+            }
+            return time_op([&]()
+                {
+                    LLVector4aBulk::affineTransform(mat, src.data(), dst.data(), COUNT);
+                    sSink = sSink + dst[COUNT - 1][0];
+                });
+        });
+
+    add("llmath/mat_mul_4096", [=]()
+        {
+            LLMatrix4a a, b, res;
+            a.setIdentity();
+            b.setIdentity();
+            b.mMatrix[3].set(1.f, 2.f, 3.f, 1.f);
+            return time_op([&]()
+                {
+                    for (U32 i = 0; i < COUNT; ++i)
+                    {
+                        matMulUnsafe(a, b, res);
+                        a.mMatrix[0] = res.mMatrix[3];
+                    }
+                    sSink = sSink + res.mMatrix[3][0];
+                });
+        });
+}
+
+static void add_volume_benchmarks()
+{
+    // a sphere at high detail is a face of a few thousand triangles, the
+    // size of a typical mesh LOD
+    static LLPointer<LLVolume> sphere;
+    if (sphere.isNull())
+    {
+        LLVolumeParams params;
+        params.setType(LL_PCODE_PROFILE_CIRCLE_HALF, LL_PCODE_PATH_CIRCLE);
+        sphere = new LLVolume(params, 4.f);
+    }
+
+    add("llmath/volume_face_optimize", []()
+        {
+            const LLVolumeFace& face = sphere->getVolumeFace(0);
+            return time_op([&]()
+                {
+                    LLVolumeFace copy = face;
+                    copy.optimize();
+                    sSink = sSink + (F32)copy.mNumVertices;
+                });
+        });
+
+    add("llmath/volume_face_cache_optimize", []()
+        {
+            const LLVolumeFace& face = sphere->getVolumeFace(0);
+            return time_op([&]()
+                {
+                    LLVolumeFace copy = face;
+                    copy.cacheOptimize();
+                    sSink = sSink + (F32)copy.mNumIndices;
+                });
+        });
+
+    add("llmath/octree_insert", []()
+        {
+            const LLVolumeFace& face = sphere->getVolumeFace(0);
+            return time_op([&]()
+                {
+                    LLVolumeFace copy = face;
+                    copy.createOctree();
+                    sSink = sSink + (F32)copy.mNumIndices;
+                });
+        });
+
+    add("llmath/octree_ray_traverse_64", []()
+        {
+            LLVolumeFace face = sphere->getVolumeFace(0);
+            face.createOctree();
+            return time_op([&]()
+                {
+                    for (U32 i = 0; i < 64; ++i)
+                    {
+                        LLVector4a start(rand_unit() - 0.5f, rand_unit() - 0.5f, 2.f);
+                        LLVector4a dir(0.f, 0.f, -4.f);
+                        F32 closest_t = 1.f;
+                        LLVector4a intersection;
+                        LLOctreeTriangleRayIntersect intersect(start, dir, &face, &closest_t, &intersection, nullptr, nullptr, nullptr);
+                        intersect.traverse(face.getOctree());
+                        sSink = sSink + closest_t;
+                    }
+                });
+        });
+}
+
+static void add_llsd_benchmarks()
+{
+    // an object update sized map of arrays, strings, reals and uuids
+    static LLSD sd;
+    if (sd.isUndefined())
+    {
+        for (S32 i = 0; i < 256; ++i)
+        {
+            LLSD entry;
+            entry["id"] = LLUUID::generateNewID();
+            entry["name"] = llformat("object %d", i);
+            entry["position"] = LLSD::emptyArray();
+            entry["position"].append(rand_unit() * 256.0);
+            entry["position"].append(rand_unit() * 256.0);
+            entry["position"].append(rand_unit() * 256.0);
+            entry["flags"] = (LLSD::Integer)i;
+            entry["visible"] = (i % 2) == 0;
+            sd["objects"].append(entry);
+        }
+    }
+
+    const std::pair<LLSDSerialize::ELLSD_Serialize, const char*> formats[] =
+    {
+        { LLSDSerialize::LLSD_BINARY, "binary" },
+        { LLSDSerialize::LLSD_XML, "xml" },
+        { LLSDSerialize::LLSD_NOTATION, "notation" }
+    };
+    for (const auto& format : formats)
+    {
+        LLSDSerialize::ELLSD_Serialize type = format.first;
+        add(std::string("llcommon/llsd_format_") + format.second, [=]()
+            {
+                return time_op([&]()
+                    {
+                        std::ostringstream str;
+                        LLSDSerialize::serialize(sd, str, type);
+                        sSink = sSink + (F32)str.tellp();
+                    });
+            });
+        add(std::string("llcommon/llsd_parse_") + format.second, [=]()
+            {
+                std::ostringstream str;
+                LLSDSerialize::serialize(sd, str, type);
+                std::string buffer = str.str();
+                return time_op([&]()
+                    {
+                        std::istringstream in(buffer);
+                        LLSD parsed;
+                        LLSDSerialize::deserialize(parsed, in, buffer.size());
+                        sSink = sSink + (F32)parsed["objects"].size();
+                    });
+            });
+    }
+}
+
+static void add_uuid_benchmarks()
+{
+    const U32 COUNT = 16384;
+    static std::vector<LLUUID> ids;
+    if (ids.empty())
+    {
+        ids.resize(COUNT);
+        for (LLUUID& id : ids)
+        {
+            id.generate();
+        }
+    }
+
+    add("llcommon/uuid_map_insert_find_16384", []()
+        {
+            return time_op([&]()
+                {
+                    std::map<LLUUID, U32> map;
+                    for (U32 i = 0; i < COUNT; ++i)
+                    {
+                        map[ids[i]] = i;
+                    }
+                    U32 found = 0;
+                    for (const LLUUID& id : ids)
+                    {
+                        found += map.count(id);
+                    }
+                    sSink = sSink + (F32)found;
+                });
+        });
+
+    add("llcommon/uuid_unordered_map_insert_find_16384", []()
+        {
+            return time_op([&]()
+                {
+                    std::unordered_map<LLUUID, U32> map;
+                    for (U32 i = 0; i < COUNT; ++i)
+                    {
+                        map[ids[i]] = i;
+                    }
+                    U32 found = 0;
+                    for (const LLUUID& id : ids)
+                    {
+                        found += (U32)map.count(id);
+                    }
+                    sSink = sSink + (F32)found;
+                });
+        });
+}
+
+static void add_image_benchmarks()
+{
+    const S32 SIZE = 512;
+    static LLPointer<LLImageRaw> raw;
+    static LLPointer<LLImageJ2C> j2c;
+    if (raw.isNull())
+    {
+        raw = new LLImageRaw(SIZE, SIZE, 3);
+        // smooth gradients with some noise, closer to a real texture than
+        // pure noise, which does not compress
+        U8* data = raw->getData();
+        for (S32 y = 0; y < SIZE; ++y)
+        {
+            for (S32 x = 0; x < SIZE; ++x)
+            {
+                U8* pixel = data + (y * SIZE + x) * 3;
+                pixel[0] = (U8)(x / 2);
+                pixel[1] = (U8)(y / 2);
+                pixel[2] = (U8)(rand_unit() * 32.f);
+            }
+        }
+        j2c = new LLImageJ2C;
+        j2c->encode(raw, 0.f);
+    }
+
+    add("llimage/raw_scale_512_to_256", []()
+        {
+            return time_op([&]()
+                {
+                    LLPointer<LLImageRaw> scaled = new LLImageRaw((const U8*)raw->getData(), SIZE, SIZE, 3);
+                    scaled->scale(SIZE / 2, SIZE / 2);
+                    sSink = sSink + (F32)scaled->getData()[0];
+                });
+        });
+
+    add("llimage/raw_scale_512_to_1024", []()
+        {
+            return time_op([&]()
+                {
+                    LLPointer<LLImageRaw> scaled = new LLImageRaw((const U8*)raw->getData(), SIZE, SIZE, 3);
+                    scaled->scale(SIZE * 2, SIZE * 2);
+                    sSink = sSink + (F32)scaled->getData()[0];
+                });
+        });
+
+    add("llimage/j2c_decode_512", []()
+        {
+            return time_op([&]()
+                {
+                    LLPointer<LLImageRaw> decoded = new LLImageRaw;
+                    j2c->decode(decoded, 0.f);
+                    sSink = sSink + (F32)decoded->getWidth();
+                });
+        });
+}
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    std::string output_name;
+    std::string baseline_name;
+
+    // Analyze command line arguments
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp(argv[arg], "--help") || !strcmp(argv[arg], "-h"))
+        {
+            // Send the usage to standard out
+            std::cout << USAGE << std::endl;
+            return 0;
+        }
+        else if ((!strcmp(argv[arg], "--filter") || !strcmp(argv[arg], "-f")) && arg < argc-1)
+        {
+            filter = argv[++arg];
+        }
+        else if ((!strcmp(argv[arg], "--output") || !strcmp(argv[arg], "-o")) && arg < argc-1)
+        {
+            output_name = argv[++arg];
+        }
+        else if ((!strcmp(argv[arg], "--baseline") || !strcmp(argv[arg], "-b")) && arg < argc-1)
+        {
+            baseline_name = argv[++arg];
+        }
+        else
+        {
+            std::cout << "Unknown argument " << argv[arg] << USAGE << std::endl;
+            return 1;
+        }
+    }
+
+    LLSD baseline;
+    if (!baseline_name.empty())
+    {
+        std::ifstream in(baseline_name.c_str());
+        if (!in || LLSDSerialize::fromXML(baseline, in) <= 0)
+        {
+            std::cout << "Error: baseline " << baseline_name << " could not be read" << std::endl;
+            return 1;
+        }
+    }
+
+    // Init whatever is necessary
+    LLImage::initClass();
+
+    add_math_benchmarks();
+    add_volume_benchmarks();
+    add_llsd_benchmarks();
+    add_uuid_benchmarks();
+    add_image_benchmarks();
+
+    LLSD results;
+    results["date"] = LLDate::now();
+
+    std::cout << "benchmark\tms per operation";
+    if (baseline.isMap())
+    {
+        std::cout << "\tbaseline\tchange";
+    }
+    std::cout << std::endl;
+
+    for (const Benchmark& benchmark : sBenchmarks)
+    {
+        if (!filter.empty() && benchmark.mName.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        F64 ms = benchmark.mRun();
+        results["ms"][benchmark.mName] = ms;
+
+        std::cout << benchmark.mName << "\t" << std::setprecision(4) << ms;
+        if (baseline["ms"].has(benchmark.mName))
+        {
+            F64 base_ms = baseline["ms"][benchmark.mName].asReal();
+            std::cout << "\t" << base_ms;
+            if (base_ms > 0.0)
+            {
+                std::cout << "\t" << std::showpos << (ms - base_ms) * 100.0 / base_ms << "%" << std::noshowpos;
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    if (!output_name.empty())
+    {
+        std::ofstream out(output_name.c_str());
+        if (!out)
+        {
+            std::cout << "Error: results could not be written to " << output_name << std::endl;
+        }
+        else
+        {
+            LLSDSerialize::toPrettyXML(results, out);
+        }
+    }
+
+    LLImage::cleanupClass();
+
+    return 0;
+}
@@ -38,6 +38,7 @@
 #include "llimagebmp.h"
 #include "llimagetga.h"
 #include "llimagej2c.h"
+#include "llimagesimd.h"
 #include "lldir.h"
 #include "lldiriterator.h"
 #include "v4coloru.h"
@@ -97,6 +98,9 @@ static const char USAGE[] = "\n"
 "        Results in <metric>_report.csv\n"
 " -s, --image-stats\n"
 "        Output stats for each input and output image.\n"
+" -bench, --benchmark\n"
+"        Time the raw image pixel loops (composite, copy, scale) with every kernel set\n"
+"        (scalar, SSE2, AVX2) the CPU supports. Input files are not required.\n"
 "\n";
 
 // true when all image loading is done. Used by metric logging thread to know when to stop the thread.
@@ -313,6 +317,68 @@ void store_output_file(std::list<std::string> &output_filenames, std::list<std::
     }
 }
 
+// Times 'op' over enough runs to be meaningful and returns milliseconds per run
+template<typename OP>
+F64 time_op(OP op)
+{
+    op(); // warm up the caches
+    LLTimer timer;
+    S32 runs = 0;
+    do
+    {
+        op();
+        ++runs;
+    } while (runs < 1000 && timer.getElapsedTimeF64() < 0.25);
+    return timer.getElapsedTimeF64() * 1000.0 / runs;
+}
+
+// Compares the LLImageRaw pixel loops across every supported kernel set
+void run_benchmark()
+{
+    const S32 sizes[] = { 64, 256, 1024, 2048 };
+    const LLImageSIMD::EPath best = LLImageSIMD::getBestPath();
+
+    std::cout << "Image kernel benchmark, ms per operation" << std::endl;
+    std::cout << "size\tkernels\tcomposite\tcopy 3 onto 4\tcopy 4 onto 3\tscale up x2" << std::endl;
+    for (S32 size : sizes)
+    {
+        LLPointer<LLImageRaw> rgba = new LLImageRaw(size, size, 4);
+        LLPointer<LLImageRaw> rgb = new LLImageRaw(size, size, 3);
+        // Pseudo random content, so that the alpha takes every blend branch
+        U8* data = rgba->getData();
+        U32 seed = 1;
+        for (S32 i = 0; i < rgba->getDataSize(); ++i)
+        {
+            seed = seed * 1664525 + 1013904223;
+            data[i] = (U8)(seed >> 24);
+        }
+        rgb->fill(LLColor4U(64, 128, 192, 255));
+
+        for (S32 path = LLImageSIMD::PATH_SCALAR; path <= best; ++path)
+        {
+            if (!LLImageSIMD::isSupported((LLImageSIMD::EPath)path))
+            {
+                continue;
+            }
+            LLImageSIMD::setPath((LLImageSIMD::EPath)path);
+
+            LLPointer<LLImageRaw> rgba_out = new LLImageRaw(size, size, 4);
+            F64 composite_ms = time_op([&]() { rgb->composite(rgba); });
+            F64 copy34_ms = time_op([&]() { rgba_out->copy(rgb); });
+            F64 copy43_ms = time_op([&]() { rgb->copy(rgba); });
+            F64 scale_ms = time_op([&]()
+                {
+                    LLPointer<LLImageRaw> scaled = new LLImageRaw((const U8*)rgba->getData(), size, size, 4);
+                    scaled->scale(size * 2, size * 2);
+                });
+
+            std::cout << size << "x" << size << "\t" << LLImageSIMD::getPathName((LLImageSIMD::EPath)path)
+                << "\t" << composite_ms << "\t" << copy34_ms << "\t" << copy43_ms << "\t" << scale_ms << std::endl;
+        }
+    }
+    LLImageSIMD::setPath(best);
+}
+
 // Holds the metric gathering output in a thread safe way
 class LogThread : public LLThread
 {
@@ -349,6 +415,7 @@ int main(int argc, char** argv)
     // Other optional parsed arguments
     bool analyze_performance = false;
     bool image_stats = false;
+    bool benchmark = false;
     int* region = NULL;
     int discard_level = -1;
     int load_size = 0;
@@ -557,12 +624,24 @@ int main(int argc, char** argv)
         {
             image_stats = true;
         }
+        else if (!strcmp(argv[arg], "--benchmark") || !strcmp(argv[arg], "-bench"))
+        {
+            benchmark = true;
+        }
+    }
+
+    if (benchmark)
+    {
+        run_benchmark();
     }
 
     // Check arguments consistency. Exit with proper message if inconsistent.
     if (input_filenames.size() == 0)
     {
-        std::cout << "No input file, nothing to do -> exit" << std::endl;
+        if (!benchmark)
+        {
+            std::cout << "No input file, nothing to do -> exit" << std::endl;
+        }
         return 0;
     }
     if (analyze_performance && !LLFastTimer::sMetricLog)
@@ -64,7 +64,7 @@ class LLAvatarBoneInfo
     friend class LLAvatarAppearance;
     friend class LLAvatarSkeletonInfo;
 public:
-    LLAvatarBoneInfo() : mIsJoint(false) {}
+    LLAvatarBoneInfo() : mIsJoint(false), mSupport(LLJoint::SUPPORT_BASE) {}
     ~LLAvatarBoneInfo()
     {
         std::for_each(mChildren.begin(), mChildren.end(), DeletePointer());
@@ -73,13 +73,14 @@ public:
     bool parseXml(LLXmlTreeNode* node);
 
 private:
+    // Worked out once here rather than for the joints of every avatar built
     std::string mName;
-    std::string mSupport;
+    LLJoint::SupportCategory mSupport;
     std::string mAliases;
     bool mIsJoint;
     LLVector3 mPos;
     LLVector3 mEnd;
-    LLVector3 mRot;
+    LLQuaternion mRotation;
     LLVector3 mScale;
     LLVector3 mPivot;
     typedef std::vector<LLAvatarBoneInfo*> bones_t;
@@ -108,7 +109,7 @@ public:
 private:
     S32 mNumBones;
     S32 mNumCollisionVolumes;
-    LLAvatarAppearance::joint_alias_map_t mJointAliasMap;
+    LLAvatarAppearance::joint_alias_map_t sJointAliasMap;
     typedef std::vector<LLAvatarBoneInfo*> bone_info_list_t;
     bone_info_list_t mBoneInfoList;
 };
@@ -159,6 +160,7 @@ LLAvatarAppearance::LLAvatarXmlInfo::~LLAvatarXmlInfo()
 //-----------------------------------------------------------------------------
 LLAvatarSkeletonInfo* LLAvatarAppearance::sAvatarSkeletonInfo = NULL;
 LLAvatarAppearance::LLAvatarXmlInfo* LLAvatarAppearance::sAvatarXmlInfo = NULL;
+LLAvatarAppearance::joint_alias_map_t LLAvatarAppearance::sJointAliasMap;
 LLAvatarAppearanceDefines::LLAvatarAppearanceDictionary* LLAvatarAppearance::sAvatarDictionary = NULL;
 
 
@@ -387,6 +389,7 @@ void LLAvatarAppearance::initClass(const std::string& avatar_file_name_arg, cons
     { //this can happen if a login attempt failed
         delete sAvatarSkeletonInfo;
     }
+    sJointAliasMap.clear(); // built again from the new infos
     sAvatarSkeletonInfo = new LLAvatarSkeletonInfo;
     if (!sAvatarSkeletonInfo->parseXml(skeleton_xml_tree.getRoot()))
     {
@@ -429,6 +432,7 @@ void LLAvatarAppearance::cleanupClass()
     delete_and_clear(sAvatarXmlInfo);
     delete_and_clear(sAvatarDictionary);
     delete_and_clear(sAvatarSkeletonInfo);
+    sJointAliasMap.clear();
 }
 
 using namespace LLAvatarAppearanceDefines;
@@ -630,8 +634,7 @@ bool LLAvatarAppearance::setupBone(const LLAvatarBoneInfo* info, LLJoint* parent
     // SL-315
     joint->setPosition(info->mPos);
     joint->setDefaultPosition(info->mPos);
-    joint->setRotation(mayaQ(info->mRot.mV[VX], info->mRot.mV[VY],
-                             info->mRot.mV[VZ], LLQuaternion::XYZ));
+    joint->setRotation(info->mRotation);
     joint->setScale(info->mScale);
     joint->setDefaultScale(info->mScale);
     joint->setSupport(info->mSupport);
@@ -885,7 +888,7 @@ bool LLAvatarAppearance::loadAvatar()
         return false;
     }
 
-    // initialize mJointAliasMap
+    // initialize sJointAliasMap, once for all avatars
     getJointAliases();
 
     // avatar_lad.xml : <skeleton>
@@ -1572,11 +1575,13 @@ bool LLAvatarBoneInfo::parseXml(LLXmlTreeNode* node)
     }
 
     static LLStdStringHandle rot_string = LLXmlTree::addAttributeString("rot");
-    if (!node->getFastAttributeVector3(rot_string, mRot))
+    LLVector3 rot;
+    if (!node->getFastAttributeVector3(rot_string, rot))
     {
         LL_WARNS() << "Bone without rotation" << LL_ENDL;
         return false;
     }
+    mRotation = mayaQ(rot.mV[VX], rot.mV[VY], rot.mV[VZ], LLQuaternion::XYZ);
 
     static LLStdStringHandle scale_string = LLXmlTree::addAttributeString("scale");
     if (!node->getFastAttributeVector3(scale_string, mScale))
@@ -1593,11 +1598,13 @@ bool LLAvatarBoneInfo::parseXml(LLXmlTreeNode* node)
     }
 
     static LLStdStringHandle support_string = LLXmlTree::addAttributeString("support");
-    if (!node->getFastAttributeString(support_string,mSupport))
+    std::string support;
+    if (!node->getFastAttributeString(support_string, support))
     {
         LL_WARNS() << "Bone without support " << mName << LL_ENDL;
-        mSupport = "base";
+        support = "base";
     }
+    mSupport = LLJoint::supportFromString(support);
 
     if (mIsJoint)
     {
@@ -1655,6 +1662,7 @@ bool LLAvatarSkeletonInfo::parseXml(LLXmlTreeNode* node)
 }
 
 //Make aliases for joint and push to map.
+// static
 void LLAvatarAppearance::makeJointAliases(LLAvatarBoneInfo *bone_info)
 {
     if (! bone_info->mIsJoint )
@@ -1663,7 +1671,7 @@ void LLAvatarAppearance::makeJointAliases(LLAvatarBoneInfo *bone_info)
     }
 
     std::string bone_name = bone_info->mName;
-    mJointAliasMap[bone_name] = bone_name; //Actual name is a valid alias.
+    sJointAliasMap[bone_name] = bone_name; //Actual name is a valid alias.
 
     std::string aliases = bone_info->mAliases;
 
@@ -1671,11 +1679,11 @@ void LLAvatarAppearance::makeJointAliases(LLAvatarBoneInfo *bone_info)
     boost::tokenizer<boost::char_separator<char> > tok(aliases, sep);
     for(const std::string& i : tok)
     {
-        if ( mJointAliasMap.find(i) != mJointAliasMap.end() )
+        if ( sJointAliasMap.find(i) != sJointAliasMap.end() )
         {
-            LL_WARNS() << "avatar skeleton:  Joint alias \"" << i << "\" remapped from " << mJointAliasMap[i] << " to " << bone_name << LL_ENDL;
+            LL_WARNS() << "avatar skeleton:  Joint alias \"" << i << "\" remapped from " << sJointAliasMap[i] << " to " << bone_name << LL_ENDL;
         }
-        mJointAliasMap[i] = bone_name;
+        sJointAliasMap[i] = bone_name;
     }
 
     for (LLAvatarBoneInfo* bone : bone_info->mChildren)
@@ -1684,10 +1692,10 @@ void LLAvatarAppearance::makeJointAliases(LLAvatarBoneInfo *bone_info)
     }
 }
 
+// static
 const LLAvatarAppearance::joint_alias_map_t& LLAvatarAppearance::getJointAliases ()
 {
-    LLAvatarAppearance::joint_alias_map_t alias_map;
-    if (mJointAliasMap.empty())
+    if (sJointAliasMap.empty() && sAvatarSkeletonInfo && sAvatarXmlInfo)
     {
 
         for (LLAvatarBoneInfo* bone_info : sAvatarSkeletonInfo->mBoneInfoList)
@@ -1707,12 +1715,12 @@ const LLAvatarAppearance::joint_alias_map_t& LLAvatarAppearance::getJointAliases
             LLStringUtil::replaceChar(sub_space_to_underscore, ' ', '_');
             if (sub_space_to_underscore != bone_name)
             {
-                mJointAliasMap[sub_space_to_underscore] = bone_name;
+                sJointAliasMap[sub_space_to_underscore] = bone_name;
             }
         }
     }
 
-    return mJointAliasMap;
+    return sJointAliasMap;
 }
 
 
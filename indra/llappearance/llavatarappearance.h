@@ -128,7 +128,7 @@ protected:
     virtual LLAvatarJoint*  createAvatarJoint() = 0;
     virtual LLAvatarJoint*  createAvatarJoint(S32 joint_num) = 0;
     virtual LLAvatarJointMesh*  createAvatarJointMesh() = 0;
-    void makeJointAliases(LLAvatarBoneInfo *bone_info);
+    static void makeJointAliases(LLAvatarBoneInfo *bone_info);
 
 
 public:
@@ -152,7 +152,8 @@ public:
     typedef std::vector<LLAvatarJoint*> avatar_joint_list_t;
     const avatar_joint_list_t& getSkeleton() { return mSkeleton; }
     typedef std::map<std::string, std::string> joint_alias_map_t;
-    const joint_alias_map_t& getJointAliases();
+    // the same for all avatars, built on first use
+    static const joint_alias_map_t& getJointAliases();
 
 
 protected:
@@ -168,7 +169,7 @@ protected:
     bool                mIsBuilt{ false }; // state of deferred character building
     avatar_joint_list_t mSkeleton;
     LLVector3OverrideMap    mPelvisFixups;
-    joint_alias_map_t   mJointAliasMap;
+    static joint_alias_map_t sJointAliasMap;
 
     //--------------------------------------------------------------------
     // Pelvis height adjustment members.
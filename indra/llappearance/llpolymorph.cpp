@@ -40,6 +40,8 @@
 //#include "../tools/imdebug/imdebug.h"
 
 const F32 NORMAL_SOFTEN_FACTOR = 0.65f;
+// weight changes smaller than this are held back until they add up
+const F32 MORPH_WEIGHT_EPSILON = 0.0001f;
 
 //-----------------------------------------------------------------------------
 // LLPolyMorphData()
@@ -562,11 +564,13 @@ void LLPolyMorphTarget::apply( ESex avatar_sex )
 
     // perform differential update of morph
     F32 delta_weight = ( getSex() & avatar_sex ) ? (mCurWeight - mLastWeight) : (getDefaultWeight() - mLastWeight);
-    // store last weight
-    mLastWeight += delta_weight;
 
-    if (delta_weight != 0.f)
+    // tiny steps of a blend only cost a pass over the vertices, they are applied once they add up
+    if (fabsf(delta_weight) >= MORPH_WEIGHT_EPSILON)
     {
+        // store last weight
+        mLastWeight += delta_weight;
+
         llassert(!mMesh->isLOD());
         LLVector4a *coords = mMesh->getWritableCoords();
 
@@ -576,38 +580,45 @@ void LLPolyMorphTarget::apply( ESex avatar_sex )
         LLVector4a *scaled_binormals = mMesh->getScaledBinormals();
         LLVector4a *binormals = mMesh->getWritableBinormals();
 
-        LLVector4a *clothing_weights = mMesh->getWritableClothingWeights();
+        LLVector4a *clothing_weights = getInfo()->mIsClothingMorph ? mMesh->getWritableClothingWeights() : NULL;
         LLVector2 *tex_coords = mMesh->getWritableTexCoords();
 
-        F32 *maskWeightArray = (mVertMask) ? mVertMask->getMorphMaskWeights() : NULL;
-
-        for(U32 vert_index_morph = 0; vert_index_morph < mMorphData->mNumIndices; vert_index_morph++)
-        {
-            S32 vert_index_mesh = mMorphData->mVertexIndices[vert_index_morph];
+        const F32 *maskWeightArray = (mVertMask) ? mVertMask->getMorphMaskWeights() : NULL;
 
-            F32 maskWeight = 1.f;
-            if (maskWeightArray)
-            {
-                maskWeight = maskWeightArray[vert_index_morph];
-            }
+        const LLVector4a* morph_coords = mMorphData->mCoords;
+        const LLVector4a* morph_normals = mMorphData->mNormals;
+        const LLVector4a* morph_binormals = mMorphData->mBinormals;
+        const LLVector2* morph_tex_coords = mMorphData->mTexCoords;
+        const U32* vertex_indices = mMorphData->mVertexIndices;
 
+        LLVector4a default_binormal(1.f, 0.f, 0.f, 1.f);
 
-            LLVector4a pos = mMorphData->mCoords[vert_index_morph];
-            pos.mul(delta_weight*maskWeight);
+        for(U32 vert_index_morph = 0; vert_index_morph < mMorphData->mNumIndices; vert_index_morph++)
+        {
+            const F32 maskWeight = maskWeightArray ? maskWeightArray[vert_index_morph] : 1.f;
+            const S32 vert_index_mesh = vertex_indices[vert_index_morph];
+            const F32 weight = delta_weight * maskWeight;
+
+            // one splat per vertex instead of a scalar multiply per attribute
+            LLVector4a pos_weight;
+            pos_weight.splat(weight);
+            LLVector4a normal_weight;
+            normal_weight.splat(weight * NORMAL_SOFTEN_FACTOR);
+
+            LLVector4a pos;
+            pos.setMul(morph_coords[vert_index_morph], pos_weight);
             coords[vert_index_mesh].add(pos);
 
-            if (getInfo()->mIsClothingMorph && clothing_weights)
+            if (clothing_weights)
             {
-                LLVector4a clothing_offset = mMorphData->mCoords[vert_index_morph];
-                clothing_offset.mul(delta_weight * maskWeight);
-                LLVector4a* clothing_weight = &clothing_weights[vert_index_mesh];
-                clothing_weight->add(clothing_offset);
-                clothing_weight->getF32ptr()[VW] = maskWeight;
+                LLVector4a& clothing_weight = clothing_weights[vert_index_mesh];
+                clothing_weight.add(pos);
+                clothing_weight.getF32ptr()[VW] = maskWeight;
             }
 
             // calculate new normals based on half angles
-            LLVector4a norm = mMorphData->mNormals[vert_index_morph];
-            norm.mul(delta_weight*maskWeight*NORMAL_SOFTEN_FACTOR);
+            LLVector4a norm;
+            norm.setMul(morph_normals[vert_index_morph], normal_weight);
             scaled_normals[vert_index_mesh].add(norm);
             norm = scaled_normals[vert_index_mesh];
 
@@ -617,16 +628,17 @@ void LLPolyMorphTarget::apply( ESex avatar_sex )
             normals[vert_index_mesh] = norm;
 
             // calculate new binormals
-            LLVector4a binorm = mMorphData->mBinormals[vert_index_morph];
+            const LLVector4a* binorm_src = &morph_binormals[vert_index_morph];
 
             // guard against degenerate input data before we create NaNs below!
             //
-            if (!binorm.isFinite3() || (binorm.dot3(binorm).getF32() <= F_APPROXIMATELY_ZERO))
+            if (!binorm_src->isFinite3() || (binorm_src->dot3(*binorm_src).getF32() <= F_APPROXIMATELY_ZERO))
             {
-                binorm.set(1,0,0,1);
+                binorm_src = &default_binormal;
             }
 
-            binorm.mul(delta_weight*maskWeight*NORMAL_SOFTEN_FACTOR);
+            LLVector4a binorm;
+            binorm.setMul(*binorm_src, normal_weight);
             scaled_binormals[vert_index_mesh].add(binorm);
             LLVector4a tangent;
             tangent.setCross3(scaled_binormals[vert_index_mesh], norm);
@@ -635,7 +647,7 @@ void LLPolyMorphTarget::apply( ESex avatar_sex )
             normalized_binormal.setCross3(norm, tangent);
             normalized_binormal.normalize3fast();
 
-            tex_coords[vert_index_mesh] += mMorphData->mTexCoords[vert_index_morph] * delta_weight * maskWeight;
+            tex_coords[vert_index_mesh] += morph_tex_coords[vert_index_morph] * weight;
         }
 
         // now apply volume changes
@@ -657,9 +669,9 @@ void LLPolyMorphTarget::apply( ESex avatar_sex )
 }
 
 //-----------------------------------------------------------------------------
-// applyMask()
+// resetMask()
 //-----------------------------------------------------------------------------
-void    LLPolyMorphTarget::applyMask(const U8 *maskTextureData, S32 width, S32 height, S32 num_components, bool invert)
+LLVector4a* LLPolyMorphTarget::resetMask()
 {
     LLVector4a *clothing_weights = getInfo()->mIsClothingMorph ? mMesh->getWritableClothingWeights() : NULL;
 
@@ -724,11 +736,33 @@ void    LLPolyMorphTarget::applyMask(const U8 *maskTextureData, S32 width, S32 h
     // set last weight to 0, since we've removed the effect of this morph
     mLastWeight = 0.f;
 
+    return clothing_weights;
+}
+
+//-----------------------------------------------------------------------------
+// applyMask()
+//-----------------------------------------------------------------------------
+void    LLPolyMorphTarget::applyMask(const U8 *maskTextureData, S32 width, S32 height, S32 num_components, bool invert)
+{
+    LLVector4a *clothing_weights = resetMask();
+
     mVertMask->generateMask(maskTextureData, width, height, num_components, invert, clothing_weights);
 
     apply(mLastSex);
 }
 
+//-----------------------------------------------------------------------------
+// applyMaskWeights()
+//-----------------------------------------------------------------------------
+void    LLPolyMorphTarget::applyMaskWeights(const F32* weights)
+{
+    LLVector4a *clothing_weights = resetMask();
+
+    mVertMask->setWeights(weights, clothing_weights);
+
+    apply(mLastSex);
+}
+
 void LLPolyMorphTarget::applyVolumeChanges(F32 delta_weight)
 {
     // now apply volume changes
@@ -782,49 +816,60 @@ LLPolyVertexMask::~LLPolyVertexMask()
 //-----------------------------------------------------------------------------
 void LLPolyVertexMask::generateMask(const U8 *maskTextureData, S32 width, S32 height, S32 num_components, bool invert, LLVector4a *clothing_weights)
 {
-// RN debug output that uses Image Debugger (http://www.cs.unc.edu/~baxter/projects/imdebug/)
-//  bool debugImg = false;
-//  if (debugImg)
-//  {
-//      if (invert)
-//      {
-//          imdebug("lum rbga=rgba b=8 w=%d h=%d *-1 %p", width, height, maskTextureData);
-//      }
-//      else
-//      {
-//          imdebug("lum rbga=rgba b=8 w=%d h=%d %p", width, height, maskTextureData);
-//      }
-//  }
-    for (U32 index = 0; index < mMorphData->mNumIndices; index++)
-    {
-        S32 vertIndex = mMorphData->mVertexIndices[index];
-        const S32 *sharedVertIndex = mMorphData->mMesh->getSharedVert(vertIndex);
+    generateWeights(mMorphData, maskTextureData, width, height, num_components, invert, mWeights);
+    setWeights(mWeights, clothing_weights);
+}
+
+//-----------------------------------------------------------------------------
+// generateWeights()
+//-----------------------------------------------------------------------------
+// static
+void LLPolyVertexMask::generateWeights(const LLPolyMorphData* morph_data, const U8 *maskTextureData, S32 width, S32 height, S32 num_components, bool invert, F32* weights)
+{
+    for (U32 index = 0; index < morph_data->mNumIndices; index++)
+    {
+        S32 vertIndex = morph_data->mVertexIndices[index];
+        const S32 *sharedVertIndex = morph_data->mMesh->getSharedVert(vertIndex);
         LLVector2 uvCoords;
 
         if (sharedVertIndex)
         {
-            uvCoords = mMorphData->mMesh->getUVs(*sharedVertIndex);
+            uvCoords = morph_data->mMesh->getUVs(*sharedVertIndex);
         }
         else
         {
-            uvCoords = mMorphData->mMesh->getUVs(vertIndex);
+            uvCoords = morph_data->mMesh->getUVs(vertIndex);
         }
         U32 s = llclamp((U32)(uvCoords.mV[VX] * (F32)(width - 1)), (U32)0, (U32)width - 1);
         U32 t = llclamp((U32)(uvCoords.mV[VY] * (F32)(height - 1)), (U32)0, (U32)height - 1);
 
-        mWeights[index] = maskTextureData ? ((F32) maskTextureData[((t * width + s) * num_components) + (num_components - 1)]) / 255.f : 0.0f;
+        weights[index] = maskTextureData ? ((F32) maskTextureData[((t * width + s) * num_components) + (num_components - 1)]) / 255.f : 0.0f;
 
         if (invert)
         {
-            mWeights[index] = 1.f - mWeights[index];
+            weights[index] = 1.f - weights[index];
         }
 
         // now apply step function
-        // mWeights[index] = mWeights[index] > 0.95f ? 1.f : 0.f;
+        // weights[index] = weights[index] > 0.95f ? 1.f : 0.f;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// setWeights()
+//-----------------------------------------------------------------------------
+void LLPolyVertexMask::setWeights(const F32* weights, LLVector4a *clothing_weights)
+{
+    if (weights != mWeights)
+    {
+        memcpy(mWeights, weights, sizeof(F32) * mMorphData->mNumIndices);
+    }
 
-        if (clothing_weights)
+    if (clothing_weights)
+    {
+        for (U32 index = 0; index < mMorphData->mNumIndices; index++)
         {
-            clothing_weights[vertIndex].getF32ptr()[VW] = mWeights[index];
+            clothing_weights[mMorphData->mVertexIndices[index]].getF32ptr()[VW] = mWeights[index];
         }
     }
     mWeightsGenerated = true;
@@ -85,6 +85,9 @@ public:
     ~LLPolyVertexMask();
 
     void generateMask(const U8 *maskData, S32 width, S32 height, S32 num_components, bool invert, LLVector4a *clothing_weights);
+    // the weights generateMask computes, only reads the shared morph and mesh data so it can run off the main thread
+    static void generateWeights(const LLPolyMorphData* morph_data, const U8 *maskData, S32 width, S32 height, S32 num_components, bool invert, F32* weights);
+    void setWeights(const F32* weights, LLVector4a *clothing_weights);
     F32* getMorphMaskWeights();
 
 
@@ -171,13 +174,19 @@ public:
     /*virtual*/ const LLVector4a*   getNextDistortion(U32 *index, LLPolyMesh **poly_mesh);
 
     void    applyMask(const U8 *maskData, S32 width, S32 height, S32 num_components, bool invert);
+    // same as applyMask with weights from LLPolyVertexMask::generateWeights
+    void    applyMaskWeights(const F32* weights);
     void    addPendingMorphMask() { mNumMorphMasksPending++; }
+    const LLPolyMorphData* getMorphData() const { return mMorphData; }
 
     void    applyVolumeChanges(F32 delta_weight); // SL-315 - for resetSkeleton()
 
 protected:
     LLPolyMorphTarget(const LLPolyMorphTarget& pOther);
 
+    // creates the vertex mask or removes the effect of the current one, returns the clothing weights to write
+    LLVector4a* resetMask();
+
     LLPolyMorphData*                mMorphData;
     LLPolyMesh*                     mMesh;
     LLPolyVertexMask *              mVertMask;
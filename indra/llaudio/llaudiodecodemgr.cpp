@@ -43,6 +43,7 @@
 #include "vorbis/codec.h"
 #include "vorbis/vorbisfile.h"
 #include <iterator>
+#include <algorithm>
 #include <deque>
 
 extern LLAudioEngine *gAudiop;
@@ -80,6 +81,8 @@ public:
     bool isValid() const                { return mValid; }
     bool isDone() const                 { return mDone; }
     const LLUUID &getUUID() const       { return mUUID; }
+    // Only to be taken once the decode is done and written
+    std::vector<U8> &getWAVBuffer()     { return mWAVBuffer; }
 
 protected:
     virtual ~LLVorbisDecodeState();
@@ -543,7 +546,12 @@ class LLAudioDecodeMgr::Impl
     void checkDecodesFinished();
 
   protected:
-    std::deque<LLUUID> mDecodeQueue;
+    struct QueuedDecode
+    {
+        LLUUID mID;
+        F32 mPriority; // see LLAudioSource::getPriority()
+    };
+    std::deque<QueuedDecode> mDecodeQueue;
     std::map<LLUUID, LLPointer<LLVorbisDecodeState>> mDecodes;
 };
 
@@ -592,8 +600,12 @@ void LLAudioDecodeMgr::Impl::startMoreDecodes()
 
     while (!mDecodeQueue.empty() && mDecodes.size() < max_decodes)
     {
-        const LLUUID decode_id = mDecodeQueue.front();
-        mDecodeQueue.pop_front();
+        // Sounds triggered close to the listener first, in order of request
+        // otherwise, so that a burst of far away sounds doesn't delay them
+        auto next_iter = std::max_element(mDecodeQueue.begin(), mDecodeQueue.end(),
+            [](const QueuedDecode& a, const QueuedDecode& b) { return a.mPriority < b.mPriority; });
+        const LLUUID decode_id = next_iter->mID;
+        mDecodeQueue.erase(next_iter);
 
         // Don't decode the same file twice
         if (mDecodes.find(decode_id) != mDecodes.end())
@@ -756,6 +768,8 @@ bool tryFinishAudio(const LLUUID &decode_id, LLPointer<LLVorbisDecodeState> deco
     if (valid)
     {
         adp->setHasWAVLoadFailed(false);
+        // Keep it in memory too, the sound is likely to be loaded right away
+        gAudiop->cacheDecodedWAV(decode_id, decode_state->getWAVBuffer());
     }
 
     return true;
@@ -779,7 +793,7 @@ void LLAudioDecodeMgr::processQueue()
     mImpl->processQueue();
 }
 
-bool LLAudioDecodeMgr::addDecodeRequest(const LLUUID &uuid)
+bool LLAudioDecodeMgr::addDecodeRequest(const LLUUID &uuid, F32 priority)
 {
     if (gAudiop && gAudiop->hasDecodedFile(uuid))
     {
@@ -792,9 +806,15 @@ bool LLAudioDecodeMgr::addDecodeRequest(const LLUUID &uuid)
     {
         // Just put it on the decode queue it if it's not already in the queue
         LL_DEBUGS("AudioEngine") << "addDecodeRequest for " << uuid << " has local asset file already" << LL_ENDL;
-        if (std::find(mImpl->mDecodeQueue.begin(), mImpl->mDecodeQueue.end(), uuid) == mImpl->mDecodeQueue.end())
+        auto queued_iter = std::find_if(mImpl->mDecodeQueue.begin(), mImpl->mDecodeQueue.end(),
+            [&uuid](const Impl::QueuedDecode& queued) { return queued.mID == uuid; });
+        if (queued_iter == mImpl->mDecodeQueue.end())
+        {
+            mImpl->mDecodeQueue.push_back({ uuid, priority });
+        }
+        else
         {
-            mImpl->mDecodeQueue.emplace_back(uuid);
+            queued_iter->mPriority = llmax(queued_iter->mPriority, priority);
         }
         return true;
     }
@@ -43,7 +43,8 @@ class LLAudioDecodeMgr : public LLSingleton<LLAudioDecodeMgr>
     ~LLAudioDecodeMgr();
 public:
     void processQueue();
-    bool addDecodeRequest(const LLUUID &uuid);
+    // Decodes with a higher priority start first, see LLAudioSource::getPriority()
+    bool addDecodeRequest(const LLUUID &uuid, F32 priority = 0.f);
     void addAudioRequest(const LLUUID &uuid);
 
 protected:
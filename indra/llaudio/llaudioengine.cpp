@@ -35,11 +35,14 @@
 
 #include "sound_ids.h"  // temporary hack for min/max distances
 
+#include "llfile.h"
 #include "llfilesystem.h"
 #include "lldir.h"
 #include "llaudiodecodemgr.h"
 #include "llassetstorage.h"
 
+#include <iterator>
+
 
 // necessary for grabbing sounds from sim (implemented in viewer)
 extern void request_sound(const LLUUID &sound_guid);
@@ -88,6 +91,10 @@ void LLAudioEngine::setDefaults()
     mChannels.fill(nullptr);
     mBuffers.fill(nullptr);
 
+    mDecodedWAVs.clear();
+    mDecodedWAVMap.clear();
+    mDecodedWAVBytes = 0;
+
     mMasterGain = 1.f;
     // Setting mInternalGain to an out of range value fixes the issue reported in STORM-830.
     // There is an edge case in setMasterGain during startup which prevents setInternalGain from
@@ -150,6 +157,10 @@ void LLAudioEngine::shutdown()
         delete mBuffers[i];
         mBuffers[i] = NULL;
     }
+
+    mDecodedWAVs.clear();
+    mDecodedWAVMap.clear();
+    mDecodedWAVBytes = 0;
 }
 
 
@@ -238,6 +249,10 @@ void LLAudioEngine::idle()
         }
     }
 
+    // Priority of a full gain source at LL_AUDIO_FAR_DISTANCE
+    const F32 far_priority = 1.f / (LL_AUDIO_FAR_DISTANCE * LL_AUDIO_FAR_DISTANCE);
+    const F64 now = LLFrameTimer::getTotalSeconds();
+
     F32 max_priority = -1.f;
     LLAudioSource *max_sourcep = NULL; // Maximum priority source without a channel
     source_map::iterator iter;
@@ -245,8 +260,16 @@ void LLAudioEngine::idle()
     {
         LLAudioSource *sourcep = iter->second;
 
-        // Update this source
-        sourcep->update();
+        // Update this source. Sims full of scripted emitters have hundreds of
+        // sources out of earshot, their mute and cutoff checks can wait a bit.
+        bool far_away = !sourcep->getChannel()
+                        && !sourcep->isForcedPriority()
+                        && sourcep->getPriority() < far_priority;
+        if (!far_away || now >= sourcep->mNextFullUpdate)
+        {
+            sourcep->update();
+            sourcep->mNextFullUpdate = now + LL_AUDIO_FAR_UPDATE_INTERVAL;
+        }
         sourcep->updatePriority();
 
         if (sourcep->isDone())
@@ -333,7 +356,7 @@ void LLAudioEngine::idle()
             // Make sure we have the buffer set up if we just decoded the data
             if (sourcep->mCurrentDatap)
             {
-                updateBufferForData(sourcep->mCurrentDatap);
+                updateBufferForData(sourcep->mCurrentDatap, LLUUID::null, sourcep->getPriority());
             }
 
             // Actually play the associated data.
@@ -359,7 +382,7 @@ void LLAudioEngine::idle()
             // Make sure we have the buffer set up if we just decoded the data
             if (sourcep->mCurrentDatap)
             {
-                updateBufferForData(sourcep->mCurrentDatap);
+                updateBufferForData(sourcep->mCurrentDatap, LLUUID::null, sourcep->getPriority());
             }
 
             // Actually play the associated data.
@@ -481,7 +504,7 @@ void LLAudioEngine::idle()
 
 
 
-bool LLAudioEngine::updateBufferForData(LLAudioData *adp, const LLUUID &audio_uuid)
+bool LLAudioEngine::updateBufferForData(LLAudioData *adp, const LLUUID &audio_uuid, F32 priority)
 {
     if (!adp)
     {
@@ -503,7 +526,7 @@ bool LLAudioEngine::updateBufferForData(LLAudioData *adp, const LLUUID &audio_uu
         {
             if (audio_uuid.notNull())
             {
-                LLAudioDecodeMgr::getInstance()->addDecodeRequest(audio_uuid);
+                LLAudioDecodeMgr::getInstance()->addDecodeRequest(audio_uuid, priority);
             }
         }
         else
@@ -642,6 +665,93 @@ void LLAudioEngine::cleanupBuffer(LLAudioBuffer *bufferp)
 }
 
 
+void LLAudioEngine::cacheDecodedWAV(const LLUUID &uuid, std::vector<U8> &wav)
+{
+    if (wav.empty() || wav.size() > LL_MAX_DECODED_WAV_CACHE_BYTES / 4)
+    {
+        // Long sounds would push out many short ones
+        return;
+    }
+
+    removeDecodedWAV(uuid);
+
+    mDecodedWAVBytes += wav.size();
+    mDecodedWAVs.emplace_back(uuid, std::vector<U8>());
+    mDecodedWAVs.back().second.swap(wav);
+    mDecodedWAVMap[uuid] = std::prev(mDecodedWAVs.end());
+
+    while (mDecodedWAVBytes > LL_MAX_DECODED_WAV_CACHE_BYTES)
+    {
+        // Evict the least recently used
+        mDecodedWAVBytes -= mDecodedWAVs.front().second.size();
+        mDecodedWAVMap.erase(mDecodedWAVs.front().first);
+        mDecodedWAVs.pop_front();
+    }
+}
+
+
+const std::vector<U8> *LLAudioEngine::getDecodedWAV(const LLUUID &uuid)
+{
+    auto iter = mDecodedWAVMap.find(uuid);
+    if (iter != mDecodedWAVMap.end())
+    {
+        mDecodedWAVs.splice(mDecodedWAVs.end(), mDecodedWAVs, iter->second);
+        return &iter->second->second;
+    }
+
+    std::string wav_path = gDirUtilp->getExpandedFilename(LL_PATH_CACHE, uuid.asString()) + ".dsf";
+    llifstream wav_file(wav_path.c_str(), std::ios::in | std::ios::binary);
+    if (!wav_file.is_open())
+    {
+        return NULL;
+    }
+
+    std::vector<U8> wav((std::istreambuf_iterator<char>(wav_file)), std::istreambuf_iterator<char>());
+    if (wav.empty())
+    {
+        return NULL;
+    }
+
+    cacheDecodedWAV(uuid, wav);
+    iter = mDecodedWAVMap.find(uuid);
+    if (iter == mDecodedWAVMap.end())
+    {
+        // Too large to be kept
+        return NULL;
+    }
+    return &iter->second->second;
+}
+
+
+void LLAudioEngine::removeDecodedWAV(const LLUUID &uuid)
+{
+    auto iter = mDecodedWAVMap.find(uuid);
+    if (iter != mDecodedWAVMap.end())
+    {
+        mDecodedWAVBytes -= iter->second->second.size();
+        mDecodedWAVs.erase(iter->second);
+        mDecodedWAVMap.erase(iter);
+    }
+}
+
+
+F32 LLAudioEngine::getDecodePriority(const LLUUID &uuid)
+{
+    F32 priority = 0.f;
+    for (source_map::value_type& src_pair : mAllSources)
+    {
+        LLAudioSource *sourcep = src_pair.second;
+        LLAudioData *currentp = sourcep->getCurrentData();
+        LLAudioData *queuedp = sourcep->getQueuedData();
+        if ((currentp && currentp->getID() == uuid) || (queuedp && queuedp->getID() == uuid))
+        {
+            priority = llmax(priority, sourcep->getPriority());
+        }
+    }
+    return priority;
+}
+
+
 bool LLAudioEngine::preloadSound(const LLUUID &uuid)
 {
     LL_DEBUGS("AudioEngine")<<"( "<<uuid<<" )"<<LL_ENDL;
@@ -966,6 +1076,11 @@ void LLAudioEngine::cleanupAudioSource(LLAudioSource *asp)
 
 bool LLAudioEngine::hasDecodedFile(const LLUUID &uuid)
 {
+    if (mDecodedWAVMap.find(uuid) != mDecodedWAVMap.end())
+    {
+        return true;
+    }
+
     std::string uuid_str;
     uuid.toString(uuid_str);
 
@@ -1226,7 +1341,7 @@ void LLAudioEngine::assetCallback(const LLUUID &uuid, LLAssetType::EType type, v
             // LL_INFOS() << "Got asset callback with good audio data for " << uuid << ", making decode request" << LL_ENDL;
             adp->setHasDecodeFailed(false);
             adp->setHasLocalData(true);
-            LLAudioDecodeMgr::getInstance()->addDecodeRequest(uuid);
+            LLAudioDecodeMgr::getInstance()->addDecodeRequest(uuid, gAudiop->getDecodePriority(uuid));
         }
     }
     gAudiop->mCurrentTransfer = LLUUID::null;
@@ -1255,7 +1370,8 @@ LLAudioSource::LLAudioSource(const LLUUID& id, const LLUUID& owner_id, const F32
     mType(type),
     mChannelp(NULL),
     mCurrentDatap(NULL),
-    mQueuedDatap(NULL)
+    mQueuedDatap(NULL),
+    mNextFullUpdate(0.0)
 {
 }
 
@@ -1422,7 +1538,9 @@ bool LLAudioSource::play(const LLUUID &audio_uuid)
         return false;
     }
 
-    bool has_buffer = gAudiop->updateBufferForData(adp, audio_uuid);
+    // A freshly triggered source hasn't been through idle() yet
+    updatePriority();
+    bool has_buffer = gAudiop->updateBufferForData(adp, audio_uuid, getPriority());
     if (!has_buffer)
     {
         // Don't bother trying to set up a channel or anything, we don't have an audio buffer.
@@ -1822,12 +1940,17 @@ bool LLAudioData::load()
     mID.toString(uuid_str);
     wav_path= gDirUtilp->getExpandedFilename(LL_PATH_CACHE,uuid_str) + ".dsf";
 
-    mHasWAVLoadFailed = !mBufferp->loadWAV(wav_path);
+    // Prefer the copy in memory, repeat triggers of a sound whose buffer went
+    // away then don't touch the disk
+    const std::vector<U8> *wav = gAudiop->getDecodedWAV(mID);
+    mHasWAVLoadFailed = !(wav && mBufferp->loadWAVData(wav->data(), wav->size()))
+                        && !mBufferp->loadWAV(wav_path);
     if (mHasWAVLoadFailed)
     {
         // Hrm.  Right now, let's unset the buffer, since it's empty.
         gAudiop->cleanupBuffer(mBufferp);
         mBufferp = nullptr;
+        gAudiop->removeDecodedWAV(mID);
 
         if (!gDirUtilp->fileExists(wav_path))
         {
@@ -31,6 +31,7 @@
 #include <list>
 #include <map>
 #include <array>
+#include <vector>
 
 #include "v3math.h"
 #include "v3dmath.h"
@@ -48,8 +49,14 @@ const F32 LL_WIND_UNDERWATER_CENTER_FREQ = 20.f;
 const F32 ATTACHED_OBJECT_TIMEOUT = 5.0f;
 const F32 DEFAULT_MIN_DISTANCE = 2.0f;
 
+// Sources that aren't playing and sound fainter than a full gain source this
+// far away only get their full update every LL_AUDIO_FAR_UPDATE_INTERVAL
+const F32 LL_AUDIO_FAR_DISTANCE = 64.f;
+const F32 LL_AUDIO_FAR_UPDATE_INTERVAL = 0.25f;
+
 #define LL_MAX_AUDIO_CHANNELS 30
 #define LL_MAX_AUDIO_BUFFERS 40 // Some extra for preloading, maybe?
+#define LL_MAX_DECODED_WAV_CACHE_BYTES (32 * 1024 * 1024)
 
 class LLAudioSource;
 class LLAudioData;
@@ -168,7 +175,18 @@ public:
     bool hasDecodedFile(const LLUUID &uuid);
     bool hasLocalFile(const LLUUID &uuid);
 
-    bool updateBufferForData(LLAudioData *adp, const LLUUID &audio_uuid = LLUUID::null);
+    // Decoded wav files of recently used sounds are kept in memory, up to
+    // LL_MAX_DECODED_WAV_CACHE_BYTES, so that loading a buffer for a sound
+    // triggered again does not read the disk. cacheDecodedWAV() takes wav.
+    void cacheDecodedWAV(const LLUUID &uuid, std::vector<U8> &wav);
+    // From memory, or read from the decoded file and kept. NULL if neither.
+    const std::vector<U8> *getDecodedWAV(const LLUUID &uuid);
+    void removeDecodedWAV(const LLUUID &uuid);
+
+    // Highest priority of the sources waiting to play uuid
+    F32 getDecodePriority(const LLUUID &uuid);
+
+    bool updateBufferForData(LLAudioData *adp, const LLUUID &audio_uuid = LLUUID::null, F32 priority = 0.f);
 
 
     // Asset callback when we're retrieved a sound from the asset server.
@@ -231,6 +249,12 @@ protected:
     // that we have active should be limited by RAM usage, not count.
     std::array<LLAudioBuffer*, LL_MAX_AUDIO_BUFFERS> mBuffers;
 
+    // Most recently used last
+    typedef std::list<std::pair<LLUUID, std::vector<U8>>> decoded_wav_list;
+    decoded_wav_list mDecodedWAVs;
+    std::map<LLUUID, decoded_wav_list::iterator> mDecodedWAVMap;
+    size_t mDecodedWAVBytes;
+
     F32 mMasterGain;
     F32 mInternalGain;          // Actual gain set; either mMasterGain or 0 when mMuted is true.
     F32 mSecondaryGain[AUDIO_TYPE_COUNT];
@@ -347,6 +371,7 @@ protected:
     data_map mPreloadMap;
 
     LLFrameTimer mAgeTimer;
+    F64 mNextFullUpdate; // see LL_AUDIO_FAR_DISTANCE
 };
 
 
@@ -447,6 +472,9 @@ class LLAudioBuffer
 public:
     virtual ~LLAudioBuffer() {};
     virtual bool loadWAV(const std::string& filename) = 0;
+    // Same from the image of a wav file in memory, for the implementations
+    // that can
+    virtual bool loadWAVData(const U8* data, size_t size) { return false; }
     virtual U32 getLength() = 0;
 
     friend class LLAudioEngine;
@@ -371,6 +371,21 @@ bool LLAudioBufferOpenAL::loadWAV(const std::string& filename)
     return true;
 }
 
+bool LLAudioBufferOpenAL::loadWAVData(const U8* data, size_t size)
+{
+    cleanup();
+    mALBuffer = alutCreateBufferFromFileImage(data, (ALsizei)size);
+    if(mALBuffer == AL_NONE)
+    {
+        LL_WARNS() <<
+            "LLAudioBufferOpenAL::loadWAVData() Error loading wav image: "
+            << alutGetErrorString(alutGetError()) << LL_ENDL;
+        return false;
+    }
+
+    return true;
+}
+
 U32 LLAudioBufferOpenAL::getLength()
 {
     if(mALBuffer == AL_NONE)
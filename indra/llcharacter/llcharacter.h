@@ -33,6 +33,7 @@
 #include <string>
 
 #include "lljoint.h"
+#include "lljointhierarchy.h"
 #include "llmotioncontroller.h"
 #include "llvisualparam.h"
 #include "llstringtable.h"
@@ -162,6 +163,10 @@ public:
 
     LLMotionController& getMotionController() { return mMotionController; }
 
+    // same as getRootJoint()->updateWorldMatrixChildren(), in one linear pass over the joints
+    void updateJointWorldMatrices() { mJointHierarchy.update(getRootJoint()); }
+    const LLJointHierarchy& getJointHierarchy() const { return mJointHierarchy; }
+
     // Releases all motion instances which should result in
     // no cached references to character joint data.  This is
     // useful if a character wants to rebuild it's skeleton.
@@ -281,6 +286,7 @@ public:
 
 protected:
     LLMotionController  mMotionController;
+    LLJointHierarchy    mJointHierarchy;
 
     typedef std::map<std::string, void *> animation_data_map_t;
     animation_data_map_t mAnimationData;
@@ -36,6 +36,7 @@
 
 S32 LLJoint::sNumUpdates = 0;
 S32 LLJoint::sNumTouches = 0;
+U32 LLJoint::sTreeSerial = 0;
 
 template <class T>
 bool attachment_map_iter_compare_key(const T& a, const T& b)
@@ -174,20 +175,22 @@ void LLJoint::setup(const std::string &name, LLJoint *parent)
 // setSupport()
 //-----------------------------------------------------------------------------
 void LLJoint::setSupport(const std::string& support_name)
+{
+    setSupport(supportFromString(support_name));
+}
+
+// static
+LLJoint::SupportCategory LLJoint::supportFromString(const std::string& support_name)
 {
     if (support_name == "extended")
     {
-        setSupport(SUPPORT_EXTENDED);
+        return SUPPORT_EXTENDED;
     }
-    else if (support_name == "base")
-    {
-        setSupport(SUPPORT_BASE);
-    }
-    else
+    if (support_name != "base")
     {
         LL_WARNS() << "unknown support string " << support_name << LL_ENDL;
-        setSupport(SUPPORT_BASE);
     }
+    return SUPPORT_BASE;
 }
 
 
@@ -272,6 +275,7 @@ void LLJoint::addChild(LLJoint* joint)
     joint->mXform.setParent(&mXform);
     joint->mParent = this;
     joint->touch();
+    sTreeSerial++;
 }
 
 
@@ -288,6 +292,7 @@ void LLJoint::removeChild(LLJoint* joint)
         joint->mXform.setParent(NULL);
         joint->mParent = NULL;
         joint->touch();
+        sTreeSerial++;
     }
 }
 
@@ -308,6 +313,7 @@ void LLJoint::removeAllChildren()
         }
     }
     mChildren.clear();
+    sTreeSerial++;
 }
 
 
@@ -151,6 +151,8 @@ public:
     // debug statics
     static S32      sNumTouches;
     static S32      sNumUpdates;
+    // bumped whenever any joint gains or loses a child, see LLJointHierarchy
+    static U32      sTreeSerial;
     typedef std::set<std::string> debug_joint_name_t;
     static debug_joint_name_t s_debugJointNames;
     static void setDebugJointNames(const debug_joint_name_t& names);
@@ -210,6 +212,7 @@ public:
     SupportCategory getSupport() const { return mSupport; }
     void setSupport( const SupportCategory& support) { mSupport = support; }
     void setSupport( const std::string& support_string);
+    static SupportCategory supportFromString(const std::string& support_name);
 
     // get/set end point
     void setEnd( const LLVector3& end) { mEnd = end; }
@@ -0,0 +1,97 @@
+/**
+ * @file lljointhierarchy.cpp
+ * @brief Flattened joint tree updated in one linear pass.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#include "linden_common.h"
+
+#include "lljointhierarchy.h"
+
+#include "lljoint.h"
+
+void LLJointHierarchy::build(LLJoint* root)
+{
+    mJoints.clear();
+    mParents.clear();
+
+    // explicit stack, pushing children in reverse keeps them in mChildren order
+    std::vector<std::pair<LLJoint*, S32> > stack;
+    stack.emplace_back(root, -1);
+    while (!stack.empty())
+    {
+        LLJoint* joint = stack.back().first;
+        S32 parent = stack.back().second;
+        stack.pop_back();
+
+        S32 index = (S32)mJoints.size();
+        mJoints.push_back(joint);
+        mParents.push_back(parent);
+
+        for (auto iter = joint->mChildren.rbegin(); iter != joint->mChildren.rend(); ++iter)
+        {
+            stack.emplace_back(*iter, index);
+        }
+    }
+
+    mWorldMatrices.resize(mJoints.size());
+    mSkipped.resize(mJoints.size());
+
+    mRoot = root;
+    mTreeSerial = LLJoint::sTreeSerial;
+}
+
+void LLJointHierarchy::update(LLJoint* root)
+{
+    LL_PROFILE_ZONE_SCOPED;
+
+    if (!root)
+    {
+        return;
+    }
+
+    if (root != mRoot || mTreeSerial != LLJoint::sTreeSerial)
+    {
+        build(root);
+    }
+
+    const S32 count = (S32)mJoints.size();
+    for (S32 i = 0; i < count; ++i)
+    {
+        LLJoint* joint = mJoints[i];
+        S32 parent = mParents[i];
+
+        // updateWorldMatrixChildren() does not descend below a joint with mUpdateXform off
+        bool skipped = !joint->mUpdateXform || (parent >= 0 && mSkipped[parent]);
+        mSkipped[i] = skipped;
+        if (skipped)
+        {
+            continue;
+        }
+
+        // the parent comes first, so its world transform is already current
+        joint->updateWorldMatrix();
+        mWorldMatrices[i] = joint->getWorldMatrix4a();
+    }
+}
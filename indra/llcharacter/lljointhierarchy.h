@@ -0,0 +1,73 @@
+/**
+ * @file lljointhierarchy.h
+ * @brief Flattened joint tree updated in one linear pass.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#ifndef LL_LLJOINTHIERARCHY_H
+#define LL_LLJOINTHIERARCHY_H
+
+#include <vector>
+
+#include "llmath.h"
+#include "llmatrix4a.h"
+
+class LLJoint;
+
+//-----------------------------------------------------------------------------
+// class LLJointHierarchy
+// A character's joint tree flattened in depth first order, so every joint
+// comes after its parent and a subtree is the range following its root.
+// update() refreshes the world matrices in one linear pass instead of
+// recursing through LLJoint::updateWorldMatrixChildren(), and leaves a copy
+// of each in a contiguous array. The joints keep their own transforms, so
+// the LLJoint accessors see the same results as after the recursive update.
+//-----------------------------------------------------------------------------
+class LLJointHierarchy
+{
+public:
+    // same as root->updateWorldMatrixChildren(), the order is rebuilt when
+    // the root or any joint's children changed since the last call
+    void update(LLJoint* root);
+
+    S32 getJointCount() const { return (S32)mJoints.size(); }
+    LLJoint* getJoint(S32 i) const { return mJoints[i]; }
+
+    // world matrix of joint i as of the last update, undefined for joints
+    // skipped because they or an ancestor have mUpdateXform off
+    const LLMatrix4a& getWorldMatrix(S32 i) const { return mWorldMatrices[i]; }
+
+private:
+    void build(LLJoint* root);
+
+    std::vector<LLJoint*> mJoints;
+    std::vector<S32> mParents; // index into mJoints, -1 for the root
+    std::vector<LLMatrix4a> mWorldMatrices;
+    std::vector<bool> mSkipped;
+
+    LLJoint* mRoot = nullptr;
+    U32 mTreeSerial = 0;
+};
+
+#endif // LL_LLJOINTHIERARCHY_H
@@ -153,58 +153,33 @@ LLVector3 LLKeyframeMotion::ScaleCurve::getValue(F32 time, F32 duration)
 {
     LLVector3 value;
 
-    if (mKeys.empty())
+    if (mTrack.empty())
     {
         value.clearVec();
         return value;
     }
 
-    key_map_t::iterator right = mKeys.lower_bound(time);
-    if (right == mKeys.end())
-    {
-        // Past last key
-        --right;
-        value = right->second.mScale;
-    }
-    else if (right == mKeys.begin() || right->first == time)
-    {
-        // Before first key or exactly on a key
-        value = right->second.mScale;
-    }
-    else
-    {
-        // Between two keys
-        key_map_t::iterator left = right; --left;
-        F32 index_before = left->first;
-        F32 index_after = right->first;
-        ScaleKey& scale_before = left->second;
-        ScaleKey& scale_after = right->second;
-        if (right == mKeys.end())
-        {
-            scale_after = mLoopInKey;
-            index_after = duration;
-        }
+    S32 left, right;
+    F32 u;
+    mTrack.findKeys(time, mInterpolationType, left, right, u);
 
-        F32 u = (time - index_before) / (index_after - index_before);
-        value = interp(u, scale_before, scale_after);
-    }
+    LLVector4a blend;
+    blend.setLerp(mTrack.mValues[left], mTrack.mValues[right], u);
+    value.set(blend.getF32ptr());
     return value;
 }
 
 //-----------------------------------------------------------------------------
-// interp()
+// flatten()
 //-----------------------------------------------------------------------------
-LLVector3 LLKeyframeMotion::ScaleCurve::interp(F32 u, ScaleKey& before, ScaleKey& after)
+void LLKeyframeMotion::ScaleCurve::flatten()
 {
-    switch (mInterpolationType)
+    mTrack.mTimes.clear();
+    mTrack.mValues.clear();
+    for (const key_map_t::value_type& key : mKeys)
     {
-    case IT_STEP:
-        return before.mScale;
-
-    default:
-    case IT_LINEAR:
-    case IT_SPLINE:
-        return lerp(before.mScale, after.mScale, u);
+        mTrack.mTimes.push_back(key.first);
+        mTrack.mValues.emplace_back().load3(key.second.mScale.mV);
     }
 }
 
@@ -233,58 +208,48 @@ LLQuaternion LLKeyframeMotion::RotationCurve::getValue(F32 time, F32 duration)
 {
     LLQuaternion value;
 
-    if (mKeys.empty())
+    if (mTrack.empty())
     {
         value = LLQuaternion::DEFAULT;
         return value;
     }
 
-    key_map_t::iterator right = mKeys.lower_bound(time);
-    if (right == mKeys.end())
+    S32 left, right;
+    F32 u;
+    mTrack.findKeys(time, mInterpolationType, left, right, u);
+
+    const LLVector4a& before = mTrack.mValues[left];
+    const LLVector4a& after = mTrack.mValues[right];
+    if (left == right)
     {
-        // Past last key
-        --right;
-        value = right->second.mRotation;
+        value.set(before.getF32ptr());
     }
-    else if (right == mKeys.begin() || right->first == time)
+    else if (before.dot4(after).getF32() < 0.f)
     {
-        // Before first key or exactly on a key
-        value = right->second.mRotation;
+        // nlerp falls back to slerp across the hemisphere
+        value = slerp(u, LLQuaternion(before.getF32ptr()), LLQuaternion(after.getF32ptr()));
     }
     else
     {
-        // Between two keys
-        key_map_t::iterator left = right; --left;
-        F32 index_before = left->first;
-        F32 index_after = right->first;
-        RotationKey& rot_before = left->second;
-        RotationKey& rot_after = right->second;
-        if (right == mKeys.end())
-        {
-            rot_after = mLoopInKey;
-            index_after = duration;
-        }
-
-        F32 u = (time - index_before) / (index_after - index_before);
-        value = interp(u, rot_before, rot_after);
+        // set() normalizes, finishing the nlerp
+        LLVector4a blend;
+        blend.setLerp(before, after, u);
+        value.set(blend.getF32ptr());
     }
     return value;
 }
 
 //-----------------------------------------------------------------------------
-// interp()
+// RotationCurve::flatten()
 //-----------------------------------------------------------------------------
-LLQuaternion LLKeyframeMotion::RotationCurve::interp(F32 u, RotationKey& before, RotationKey& after)
+void LLKeyframeMotion::RotationCurve::flatten()
 {
-    switch (mInterpolationType)
+    mTrack.mTimes.clear();
+    mTrack.mValues.clear();
+    for (const key_map_t::value_type& key : mKeys)
     {
-    case IT_STEP:
-        return before.mRotation;
-
-    default:
-    case IT_LINEAR:
-    case IT_SPLINE:
-        return nlerp(u, before.mRotation, after.mRotation);
+        mTrack.mTimes.push_back(key.first);
+        mTrack.mValues.emplace_back().loadua(key.second.mRotation.mQ);
     }
 }
 
@@ -314,41 +279,19 @@ LLVector3 LLKeyframeMotion::PositionCurve::getValue(F32 time, F32 duration)
 {
     LLVector3 value;
 
-    if (mKeys.empty())
+    if (mTrack.empty())
     {
         value.clearVec();
         return value;
     }
 
-    key_map_t::iterator right = mKeys.lower_bound(time);
-    if (right == mKeys.end())
-    {
-        // Past last key
-        --right;
-        value = right->second.mPosition;
-    }
-    else if (right == mKeys.begin() || right->first == time)
-    {
-        // Before first key or exactly on a key
-        value = right->second.mPosition;
-    }
-    else
-    {
-        // Between two keys
-        key_map_t::iterator left = right; --left;
-        F32 index_before = left->first;
-        F32 index_after = right->first;
-        PositionKey& pos_before = left->second;
-        PositionKey& pos_after = right->second;
-        if (right == mKeys.end())
-        {
-            pos_after = mLoopInKey;
-            index_after = duration;
-        }
+    S32 left, right;
+    F32 u;
+    mTrack.findKeys(time, mInterpolationType, left, right, u);
 
-        F32 u = (time - index_before) / (index_after - index_before);
-        value = interp(u, pos_before, pos_after);
-    }
+    LLVector4a blend;
+    blend.setLerp(mTrack.mValues[left], mTrack.mValues[right], u);
+    value.set(blend.getF32ptr());
 
     llassert(value.isFinite());
 
@@ -356,19 +299,47 @@ LLVector3 LLKeyframeMotion::PositionCurve::getValue(F32 time, F32 duration)
 }
 
 //-----------------------------------------------------------------------------
-// interp()
+// PositionCurve::flatten()
 //-----------------------------------------------------------------------------
-LLVector3 LLKeyframeMotion::PositionCurve::interp(F32 u, PositionKey& before, PositionKey& after)
+void LLKeyframeMotion::PositionCurve::flatten()
 {
-    switch (mInterpolationType)
+    mTrack.mTimes.clear();
+    mTrack.mValues.clear();
+    for (const key_map_t::value_type& key : mKeys)
     {
-    case IT_STEP:
-        return before.mPosition;
-    default:
-    case IT_LINEAR:
-    case IT_SPLINE:
-        return lerp(before.mPosition, after.mPosition, u);
+        mTrack.mTimes.push_back(key.first);
+        mTrack.mValues.emplace_back().load3(key.second.mPosition.mV);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// KeyTrack::findKeys()
+//-----------------------------------------------------------------------------
+void LLKeyframeMotion::KeyTrack::findKeys(F32 time, InterpolationType type, S32& left, S32& right, F32& u) const
+{
+    const S32 count = (S32)mTimes.size();
+    right = (S32)(std::lower_bound(mTimes.begin(), mTimes.end(), time) - mTimes.begin());
+    if (right == count)
+    {
+        // Past last key
+        left = right = count - 1;
+    }
+    else if (right == 0 || mTimes[right] == time)
+    {
+        // Before first key or exactly on a key
+        left = right;
+    }
+    else if (type == IT_STEP)
+    {
+        left = right = right - 1;
+    }
+    else
+    {
+        // Between two keys
+        left = right - 1;
     }
+
+    u = (left == right) ? 0.f : (time - mTimes[left]) / (mTimes[right] - mTimes[left]);
 }
 
 
@@ -482,6 +453,48 @@ LLJoint* LLKeyframeMotion::getJoint(U32 index)
     return joint;
 }
 
+//-----------------------------------------------------------------------------
+// initializeFromCache()
+//-----------------------------------------------------------------------------
+bool LLKeyframeMotion::initializeFromCache()
+{
+    LLKeyframeMotion::JointMotionList* joint_motion_list = LLKeyframeDataCache::getKeyframeData(getID());
+
+    if (!joint_motion_list)
+    {
+        return false;
+    }
+
+    // motion already existed in cache, so grab it
+    mJointMotionList = joint_motion_list;
+
+    mJointStates.clear();
+    mJointStates.reserve(mJointMotionList->getNumJointMotions());
+
+    // don't forget to allocate joint states
+    // set up joint states to point to character joints
+    for(U32 i = 0; i < mJointMotionList->getNumJointMotions(); i++)
+    {
+        JointMotion* joint_motion = mJointMotionList->getJointMotion(i);
+        if (LLJoint *joint = mCharacter->getJoint(joint_motion->mJointName))
+        {
+            LLPointer<LLJointState> joint_state = new LLJointState;
+            mJointStates.push_back(joint_state);
+            joint_state->setJoint(joint);
+            joint_state->setUsage(joint_motion->mUsage);
+            joint_state->setPriority(joint_motion->mPriority);
+        }
+        else
+        {
+            // add dummy joint state with no associated joint
+            mJointStates.push_back(new LLJointState);
+        }
+    }
+    mAssetStatus = ASSET_LOADED;
+    setupPose();
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 // LLKeyframeMotion::onInitialize(LLCharacter *character)
 //-----------------------------------------------------------------------------
@@ -495,6 +508,12 @@ LLMotion::LLMotionInitStatus LLKeyframeMotion::onInitialize(LLCharacter *charact
     switch(mAssetStatus)
     {
     case ASSET_NEEDS_FETCH:
+        // another avatar may have loaded it meanwhile
+        if (initializeFromCache())
+        {
+            return STATUS_SUCCESS;
+        }
+
         // request asset
         mAssetStatus = ASSET_FETCHED;
 
@@ -516,7 +535,8 @@ LLMotion::LLMotionInitStatus LLKeyframeMotion::onInitialize(LLCharacter *charact
 
         return STATUS_HOLD;
     case ASSET_FETCHED:
-        return STATUS_HOLD;
+        // a fetch of this animation for another avatar may have completed first
+        return initializeFromCache() ? STATUS_SUCCESS : STATUS_HOLD;
     case ASSET_FETCH_FAILED:
         return STATUS_FAILURE;
     case ASSET_LOADED:
@@ -527,36 +547,8 @@ LLMotion::LLMotionInitStatus LLKeyframeMotion::onInitialize(LLCharacter *charact
         break;
     }
 
-    LLKeyframeMotion::JointMotionList* joint_motion_list = LLKeyframeDataCache::getKeyframeData(getID());
-
-    if(joint_motion_list)
+    if (initializeFromCache())
     {
-        // motion already existed in cache, so grab it
-        mJointMotionList = joint_motion_list;
-
-        mJointStates.reserve(mJointMotionList->getNumJointMotions());
-
-        // don't forget to allocate joint states
-        // set up joint states to point to character joints
-        for(U32 i = 0; i < mJointMotionList->getNumJointMotions(); i++)
-        {
-            JointMotion* joint_motion = mJointMotionList->getJointMotion(i);
-            if (LLJoint *joint = mCharacter->getJoint(joint_motion->mJointName))
-            {
-                LLPointer<LLJointState> joint_state = new LLJointState;
-                mJointStates.push_back(joint_state);
-                joint_state->setJoint(joint);
-                joint_state->setUsage(joint_motion->mUsage);
-                joint_state->setPriority(joint_motion->mPriority);
-            }
-            else
-            {
-                // add dummy joint state with no associated joint
-                mJointStates.push_back(new LLJointState);
-            }
-        }
-        mAssetStatus = ASSET_LOADED;
-        setupPose();
         return STATUS_SUCCESS;
     }
 
@@ -736,8 +728,19 @@ bool LLKeyframeMotion::onUpdate(F32 time, U8* joint_mask)
 void LLKeyframeMotion::applyKeyframes(F32 time)
 {
     llassert_always (mJointMotionList->getNumJointMotions() <= mJointStates.size());
+    // at far animation LODs the extended joints keep their last pose
+    const bool base_only = mCharacter->getMotionController().getBaseJointsOnly();
     for (U32 i=0; i<mJointMotionList->getNumJointMotions(); i++)
     {
+        if (base_only)
+        {
+            LLJoint* joint = mJointStates[i]->getJoint();
+            if (joint && joint->getSupport() == LLJoint::SUPPORT_EXTENDED)
+            {
+                continue;
+            }
+        }
+
         mJointMotionList->getJointMotion(i)->update(mJointStates[i],
                                                       time,
                                                       mJointMotionList->mDuration );
@@ -2030,6 +2033,13 @@ bool LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id, boo
         }
     }
 
+    for (JointMotion* joint_motion : joint_motion_list->mJointMotionArray)
+    {
+        joint_motion->mScaleCurve.flatten();
+        joint_motion->mRotationCurve.flatten();
+        joint_motion->mPositionCurve.flatten();
+    }
+
     // *FIX: support cleanup of old keyframe data
     mJointMotionList = joint_motion_list.release(); // release from unique_ptr to member;
     LLKeyframeDataCache::addKeyframeData(getID(),  mJointMotionList);
@@ -2437,6 +2447,12 @@ void LLKeyframeMotion::onLoadComplete(const LLUUID& asset_uuid,
                 // asset already loaded
                 return;
             }
+
+            // decoded for another avatar since this one requested it
+            if (motionp->initializeFromCache())
+            {
+                return;
+            }
             LLFileSystem file(asset_uuid, type, LLFileSystem::READ);
             S32 size = file.getSize();
 
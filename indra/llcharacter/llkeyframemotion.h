@@ -39,6 +39,7 @@
 #include "lljointstate.h"
 #include "llmotion.h"
 #include "llquaternion.h"
+#include "llvector4a.h"
 #include "v3dmath.h"
 #include "v3math.h"
 #include "llbvhconsts.h"
@@ -273,6 +274,10 @@ protected:
 
     bool    setupPose();
 
+    // take the decoded data of this animation from LLKeyframeDataCache if
+    // another instance already loaded it, returns false if none did
+    bool    initializeFromCache();
+
 public:
     enum AssetStatus { ASSET_LOADED, ASSET_FETCHED, ASSET_NEEDS_FETCH, ASSET_FETCH_FAILED, ASSET_UNDEFINED };
 
@@ -317,6 +322,23 @@ public:
         LLVector3   mPosition;
     };
 
+    //-------------------------------------------------------------------------
+    // KeyTrack
+    // The keys of a curve copied into flat arrays once the curve is decoded,
+    // sampling is a binary search over contiguous times and a SIMD blend.
+    //-------------------------------------------------------------------------
+    class KeyTrack
+    {
+    public:
+        // the keys around 'time' as the curves pick them from their key map,
+        // left == right when the value is just that key's
+        void findKeys(F32 time, InterpolationType type, S32& left, S32& right, F32& u) const;
+        bool empty() const { return mTimes.empty(); }
+
+        std::vector<F32>        mTimes;
+        std::vector<LLVector4a> mValues;
+    };
+
     //-------------------------------------------------------------------------
     // ScaleCurve
     //-------------------------------------------------------------------------
@@ -326,7 +348,8 @@ public:
         ScaleCurve();
         ~ScaleCurve();
         LLVector3 getValue(F32 time, F32 duration);
-        LLVector3 interp(F32 u, ScaleKey& before, ScaleKey& after);
+        // copy mKeys into mTrack, getValue reads only that
+        void flatten();
 
         InterpolationType   mInterpolationType;
         S32                 mNumKeys;
@@ -334,6 +357,7 @@ public:
         key_map_t           mKeys;
         ScaleKey            mLoopInKey;
         ScaleKey            mLoopOutKey;
+        KeyTrack            mTrack;
     };
 
     //-------------------------------------------------------------------------
@@ -345,7 +369,8 @@ public:
         RotationCurve();
         ~RotationCurve();
         LLQuaternion getValue(F32 time, F32 duration);
-        LLQuaternion interp(F32 u, RotationKey& before, RotationKey& after);
+        // copy mKeys into mTrack, getValue reads only that
+        void flatten();
 
         InterpolationType   mInterpolationType;
         S32                 mNumKeys;
@@ -353,6 +378,7 @@ public:
         key_map_t       mKeys;
         RotationKey     mLoopInKey;
         RotationKey     mLoopOutKey;
+        KeyTrack        mTrack;
     };
 
     //-------------------------------------------------------------------------
@@ -364,7 +390,8 @@ public:
         PositionCurve();
         ~PositionCurve();
         LLVector3 getValue(F32 time, F32 duration);
-        LLVector3 interp(F32 u, PositionKey& before, PositionKey& after);
+        // copy mKeys into mTrack, getValue reads only that
+        void flatten();
 
         InterpolationType   mInterpolationType;
         S32                 mNumKeys;
@@ -372,6 +399,7 @@ public:
         key_map_t       mKeys;
         PositionKey     mLoopInKey;
         PositionKey     mLoopOutKey;
+        KeyTrack        mTrack;
     };
 
     //-------------------------------------------------------------------------
@@ -88,6 +88,7 @@ public:
     F32 getFadeWeight() const { return mFadeWeight; }
 
     F32 getStopTime() const { return mStopTimestamp; }
+    F32 getActivationTime() const { return mActivationTimestamp; }
 
     virtual void setStopTime(F32 time);
 
@@ -139,6 +139,8 @@ LLMotionController::LLMotionController()
       mTimeStep(0.f),
       mTimeStepCount(0),
       mLastInterp(0.f),
+      mSkipAdditiveMotions(false),
+      mBaseJointsOnly(false),
       mIsSelf(false),
       mLastCountAfterPurge(0)
 {
@@ -264,21 +266,30 @@ void LLMotionController::deactivateStoppedMotions()
 //-----------------------------------------------------------------------------
 void LLMotionController::setTimeStep(F32 step)
 {
+    if (step == mTimeStep)
+    {
+        return;
+    }
+
+    // the next update starts a new quantum
+    mTimeStepCount = 0;
     mTimeStep = step;
 
     if (step != 0.f)
     {
+        // looping motions never stop, F32_MAX would overflow llfloor
+        auto quantize = [step](F32 time) { return time < F32_MAX ? (F32)llfloor(time / step) * step : time; };
+
         // make sure timestamps conform to new quantum
         for (motion_list_t::iterator iter = mActiveMotions.begin();
              iter != mActiveMotions.end(); ++iter)
         {
             LLMotion* motionp = *iter;
-            F32 activation_time = motionp->mActivationTimestamp;
-            motionp->mActivationTimestamp = (F32)(llfloor(activation_time / step)) * step;
+            motionp->mActivationTimestamp = quantize(motionp->mActivationTimestamp);
             bool stopped = motionp->isStopped();
-            motionp->setStopTime((F32)(llfloor(motionp->getStopTime() / step)) * step);
+            motionp->setStopTime(quantize(motionp->getStopTime()));
             motionp->setStopped(stopped);
-            motionp->mSendStopTimestamp = (F32)llfloor(motionp->mSendStopTimestamp / step) * step;
+            motionp->mSendStopTimestamp = quantize(motionp->mSendStopTimestamp);
         }
     }
 }
@@ -808,14 +819,24 @@ void LLMotionController::updateLoadingMotions()
 //-----------------------------------------------------------------------------
 // updateMotion()
 //-----------------------------------------------------------------------------
+F32 LLMotionController::getPendingAnimTime() const
+{
+    if (mPaused)
+    {
+        return mAnimTime;
+    }
+    return mAnimTime + (mTimer.getElapsedTimeF32() - mPrevTimerElapsed) * mTimeFactor;
+}
+
 void LLMotionController::updateMotions(bool force_update)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
     // SL-763: "Distant animated objects run at super fast speed"
-    // The use_quantum optimization or possibly the associated code in setTimeStamp()
-    // does not work as implemented.
-    // Currently setting mTimeStep to nonzero is disabled elsewhere.
+    // mAnimTime used to stay at the end of the quantum it was evaluated for,
+    // so every quantum started that far ahead. It now always follows the
+    // timer, motions only see the quantized time while they are evaluated.
     bool use_quantum = (mTimeStep != 0.f);
+    F32 real_anim_time = mAnimTime;
 
     // Always update mPrevTimerElapsed
     F32 cur_time = mTimer.getElapsedTimeF32();
@@ -839,12 +860,13 @@ void LLMotionController::updateMotions(bool force_update)
             if (quantum_count == mTimeStepCount)
             {
                 // we're still in same time quantum as before, so just interpolate and exit
-                if (!mPaused)
-                {
-                    F32 interp = time_interval / mTimeStep;
-                    mPoseBlender.interpolate(interp - mLastInterp);
-                    mLastInterp = interp;
-                }
+                mAnimTime = update_time;
+
+                // the joints are mLastInterp of the way to the cached pose,
+                // cover the same fraction of what is left to stay linear
+                F32 interp = time_interval / mTimeStep;
+                mPoseBlender.interpolate((interp - mLastInterp) / (1.f - mLastInterp));
+                mLastInterp = interp;
 
                 updateLoadingMotions();
 
@@ -855,9 +877,15 @@ void LLMotionController::updateMotions(bool force_update)
             mPoseBlender.interpolate(1.f);
             clearBlenders();
 
+            if (mTimeStepCount > 0)
+            {
+                // stop times are checked against the span since the last evaluation
+                mLastTime = (F32)mTimeStepCount * mTimeStep;
+            }
             mTimeStepCount = quantum_count;
             mAnimTime = (F32)quantum_count * mTimeStep;
             mLastInterp = 0.f;
+            real_anim_time = update_time;
         }
         else
         {
@@ -876,7 +904,10 @@ void LLMotionController::updateMotions(bool force_update)
     else
     {
         // update additive motions
-        updateAdditiveMotions();
+        if (!mSkipAdditiveMotions)
+        {
+            updateAdditiveMotions();
+        }
 
         resetJointSignatures();
 
@@ -893,6 +924,12 @@ void LLMotionController::updateMotions(bool force_update)
         }
     }
 
+    if (use_quantum && !mPaused)
+    {
+        // evaluated ahead, back to the actual time
+        mAnimTime = real_anim_time;
+    }
+
     mHasRunOnce = true;
 //  LL_INFOS() << "Motion controller time " << motionTimer.getElapsedTimeF32() << LL_ENDL;
 }
@@ -150,13 +150,26 @@ public:
     bool isPaused() const { return mPaused; }
     S32 getPausedFrame() const { return mPausedFrame; }
 
+    // with a non zero step, motions are evaluated at the end of each step
+    // and the joints interpolated toward that pose in between
     void setTimeStep(F32 step);
     F32 getTimeStep() const { return mTimeStep; }
 
+    // animation LOD for distant characters, skip the additive motions
+    // (head rotation, hands, targeting, physics) and/or only animate the
+    // joints of the base skeleton
+    void setSkipAdditiveMotions(bool skip) { mSkipAdditiveMotions = skip; }
+    bool getSkipAdditiveMotions() const { return mSkipAdditiveMotions; }
+    void setBaseJointsOnly(bool base_only) { mBaseJointsOnly = base_only; }
+    bool getBaseJointsOnly() const { return mBaseJointsOnly; }
+
     void setTimeFactor(F32 time_factor);
     F32 getTimeFactor() const { return mTimeFactor; }
 
     F32 getAnimTime() const { return mAnimTime; }
+    // what getAnimTime() will be once updateMotions() catches up with the
+    // timer, the same before and after this frame's update
+    F32 getPendingAnimTime() const;
 
     motion_list_t& getActiveMotions() { return mActiveMotions; }
 
@@ -165,6 +178,8 @@ public:
 //protected:
     bool isMotionActive( LLMotion *motion );
     bool isMotionLoading( LLMotion *motion );
+    // true if a motion still waits for its data, updating then may request assets
+    bool hasLoadingMotions() const { return !mLoadingMotions.empty(); }
     LLMotion *findMotion( const LLUUID& id ) const;
 
     void dumpMotions();
@@ -226,6 +241,8 @@ protected:
     F32                 mTimeStep;
     S32                 mTimeStepCount;
     F32                 mLastInterp;
+    bool                mSkipAdditiveMotions;
+    bool                mBaseJointsOnly;
 
     U8                  mJointSignature[2][LL_CHARACTER_MAX_ANIMATED_JOINTS];
 private:
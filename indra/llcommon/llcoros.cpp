@@ -35,7 +35,11 @@
 // STL headers
 // std headers
 #include <atomic>
+#include <cstring>
+#include <map>
+#include <mutex>
 #include <stdexcept>
+#include <vector>
 // external library headers
 #include <boost/bind.hpp>
 #include <boost/fiber/fiber.hpp>
@@ -62,6 +66,164 @@
 #include <excpt.h>
 #endif
 
+namespace
+{
+    std::atomic<bool> sStackDebug{ false };
+
+    // Coroutine stacks come from protected_fixedsize_stack, guard page and
+    // all, but when a coroutine ends its stack goes back on a free list for
+    // its size rather than being unmapped, so the next launch() of that size
+    // doesn't have to map a new one. Only so many are kept per size, so a
+    // burst of coroutines doesn't stay resident after it's over.
+    class StackPool
+    {
+    public:
+        static const size_t MAX_FREE = 16;
+        static const U64 FILL = 0xcdcdcdcdcdcdcdcdULL;
+
+        static StackPool& instance()
+        {
+            // never destroyed: coroutines can still be ending during
+            // static destruction
+            static StackPool* sPool = new StackPool;
+            return *sPool;
+        }
+
+        boost::context::stack_context allocate(size_t size)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                auto& free = mFree[size];
+                if (! free.empty())
+                {
+                    boost::context::stack_context sctx = free.back();
+                    free.pop_back();
+                    return sctx;
+                }
+            }
+            return boost::fibers::protected_fixedsize_stack(size).allocate();
+        }
+
+        void deallocate(size_t size, boost::context::stack_context& sctx)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                auto& free = mFree[size];
+                if (free.size() < MAX_FREE)
+                {
+                    free.push_back(sctx);
+                    return;
+                }
+            }
+            boost::fibers::protected_fixedsize_stack(size).deallocate(sctx);
+        }
+
+        // the usable part of a stack, above the guard page
+        static U64* bottom(const boost::context::stack_context& sctx)
+        {
+            return reinterpret_cast<U64*>(static_cast<char*>(sctx.sp) - sctx.size
+                                          + boost::context::stack_traits::page_size());
+        }
+
+        static void fill(const boost::context::stack_context& sctx)
+        {
+            char* low = reinterpret_cast<char*>(bottom(sctx));
+            memset(low, FILL & 0xff, static_cast<char*>(sctx.sp) - low);
+        }
+
+        // how much of a filled stack was written; stacks grow down
+        static size_t used(const boost::context::stack_context& sctx)
+        {
+            const U64* word = bottom(sctx);
+            const U64* top = static_cast<const U64*>(sctx.sp);
+            while (word < top && *word == FILL)
+            {
+                ++word;
+            }
+            return (top - word) * sizeof(U64);
+        }
+
+        void recordUse(const std::string& prefix, size_t used, size_t size)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                auto& high = mHighWater[prefix];
+                if (used <= high.first)
+                {
+                    return;
+                }
+                high = { used, size };
+            }
+            if (used > size - size / 4)
+            {
+                LL_WARNS("LLCoros") << "Coroutine " << prefix << " used " << used
+                                    << " bytes of its " << size << " byte stack" << LL_ENDL;
+            }
+            else
+            {
+                LL_DEBUGS("LLCoros") << "Coroutine " << prefix << " used " << used
+                                     << " bytes of its " << size << " byte stack" << LL_ENDL;
+            }
+        }
+
+        LLSD getHighWater()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            LLSD result(LLSD::emptyMap());
+            for (const auto& pair : mHighWater)
+            {
+                result[pair.first] = llsd::map("used", LLSD::Integer(pair.second.first),
+                                               "size", LLSD::Integer(pair.second.second));
+            }
+            return result;
+        }
+
+    private:
+        std::mutex mMutex;
+        std::map<size_t, std::vector<boost::context::stack_context>> mFree;
+        // launch() prefix -> (deepest use, stack size)
+        std::map<std::string, std::pair<size_t, size_t>> mHighWater;
+    };
+
+    // StackAllocator for boost::fibers drawing on StackPool. The fiber keeps
+    // the instance that allocated its stack and uses it to deallocate, so it
+    // can remember whether it filled that stack, and for whom.
+    class PooledStack
+    {
+    public:
+        PooledStack(size_t size, const std::string& prefix):
+            mSize(size),
+            mPrefix(prefix)
+        {}
+
+        boost::context::stack_context allocate()
+        {
+            boost::context::stack_context sctx = StackPool::instance().allocate(mSize);
+            mFilled = sStackDebug.load(std::memory_order_relaxed);
+            if (mFilled)
+            {
+                StackPool::fill(sctx);
+            }
+            return sctx;
+        }
+
+        void deallocate(boost::context::stack_context& sctx)
+        {
+            if (mFilled)
+            {
+                StackPool::instance().recordUse(mPrefix, StackPool::used(sctx),
+                                                sctx.size - boost::context::stack_traits::page_size());
+            }
+            StackPool::instance().deallocate(mSize, sctx);
+        }
+
+    private:
+        size_t mSize;
+        std::string mPrefix;
+        bool mFilled{ false };
+    };
+} // anonymous namespace
+
 // static
 bool LLCoros::on_main_coro()
 {
@@ -182,6 +344,12 @@ void LLCoros::cleanupSingleton()
         boost::this_fiber::yield();
     }
     printActiveCoroutines("after pumping");
+
+    if (sStackDebug.load(std::memory_order_relaxed))
+    {
+        LL_INFOS("LLCoros") << "Coroutine stack high water marks: "
+                            << getStackHighWater() << LL_ENDL;
+    }
 }
 
 std::string LLCoros::generateDistinctName(const std::string& prefix) const
@@ -256,6 +424,16 @@ void LLCoros::setStackSize(S32 stacksize)
     mStackSize = stacksize;
 }
 
+void LLCoros::setStackDebug(bool enable)
+{
+    sStackDebug.store(enable, std::memory_order_relaxed);
+}
+
+LLSD LLCoros::getStackHighWater() const
+{
+    return StackPool::instance().getHighWater();
+}
+
 void LLCoros::printActiveCoroutines(const std::string& when)
 {
     LL_INFOS("LLCoros") << "Number of active coroutines " << when
@@ -275,22 +453,26 @@ void LLCoros::printActiveCoroutines(const std::string& when)
     }
 }
 
-std::string LLCoros::launch(const std::string& prefix, const callable_t& callable)
+std::string LLCoros::launch(const std::string& prefix, const callable_t& callable, StackSize stack)
 {
     std::string name(generateDistinctName(prefix));
     // 'dispatch' means: enter the new fiber immediately, returning here only
     // when the fiber yields for whatever reason.
     // std::allocator_arg is a flag to indicate that the following argument is
     // a StackAllocator.
-    // protected_fixedsize_stack sets a guard page past the end of the new
-    // stack so that stack overflow will result in an access violation
-    // instead of weird, subtle, possibly undiagnosed memory stomps.
+    // PooledStack hands out protected_fixedsize_stack stacks, which have a
+    // guard page past the end so that stack overflow will result in an
+    // access violation instead of weird, subtle, possibly undiagnosed memory
+    // stomps.
+    size_t stacksize = (stack == STACK_SMALL)? 128*1024
+                     : (stack == STACK_LARGE)? 4 * size_t(mStackSize)
+                     : size_t(mStackSize);
 
     try
     {
         boost::fibers::fiber newCoro(boost::fibers::launch::dispatch,
             std::allocator_arg,
-            boost::fibers::protected_fixedsize_stack(mStackSize),
+            PooledStack(stacksize, prefix),
             [this, &name, &callable]() { toplevel(name, callable); });
 
         // You have two choices with a fiber instance: you can join() it or you
@@ -136,8 +136,18 @@ public:
      * existing coroutine instance, creates the coroutine instance, registers
      * it with the tweaked name and runs it until its first wait. At that
      * point it returns the tweaked name.
+     *
+     * Pass a smaller or larger stack size class when you know the coroutine
+     * needs it; see setStackDebug() for finding out.
      */
-    std::string launch(const std::string& prefix, const callable_t& callable);
+    enum StackSize
+    {
+        STACK_SMALL,    ///< 128KB, for short, shallow work like a single request
+        STACK_DEFAULT,  ///< setStackSize()
+        STACK_LARGE     ///< four times STACK_DEFAULT
+    };
+    std::string launch(const std::string& prefix, const callable_t& callable,
+                       StackSize stack=STACK_DEFAULT);
 
     /**
      * Ask the named coroutine to abort. Normally, when a coroutine either
@@ -183,6 +193,19 @@ public:
      */
     void setStackSize(S32 stacksize);
 
+    /**
+     * With stack debugging on, every coroutine stack is filled with a known
+     * pattern when launch() hands it out and checked when the coroutine
+     * ends, to see how much of it was used. The deepest use for each launch()
+     * prefix is kept for getStackHighWater(), and a prefix that gets within
+     * a quarter of its stack size is warned about. Filling the stack costs
+     * time on every launch(), so this is for finding out what size classes
+     * coroutines can live with, not for everyday use.
+     */
+    void setStackDebug(bool enable);
+    /// map of launch() prefix to map with "used" and "size", in bytes
+    LLSD getStackHighWater() const;
+
     /// diagnostic
     void printActiveCoroutines(const std::string& when=std::string());
 
@@ -31,7 +31,9 @@
 #include "llerrorcontrol.h"
 #include "llsdutil.h"
 
+#include <atomic>
 #include <cctype>
+#include <condition_variable>
 #ifdef __GNUC__
 # include <cxxabi.h>
 #endif // __GNUC__
@@ -43,6 +45,8 @@
 #else
 # include <io.h>
 #endif // !LL_WINDOWS
+#include <set>
+#include <thread>
 #include <vector>
 #include "string.h"
 
@@ -503,6 +507,7 @@ namespace
         LevelMap                            mClassLevelMap;
         LevelMap                            mFileLevelMap;
         LevelMap                            mTagLevelMap;
+        std::set<std::string>               mOnceTags;
         std::map<std::string, unsigned int> mUniqueLogMessages;
 
         LLError::FatalFunction              mCrashFunction;
@@ -528,6 +533,7 @@ namespace
         mClassLevelMap(),
         mFileLevelMap(),
         mTagLevelMap(),
+        mOnceTags(),
         mUniqueLogMessages(),
         mCrashFunction(NULL),
         mTimeFunction(NULL),
@@ -639,6 +645,7 @@ namespace LLError
         mFunction(function),
         mCached(false),
         mShouldLog(false),
+        mTagOnce(false),
         mPrintOnce(printOnce),
         mTags(new const char* [tag_count]),
         mTagCount(tag_count)
@@ -875,6 +882,21 @@ namespace LLError
         s->mTagLevelMap[tag_name] = level;
     }
 
+    void setTagOnce(const std::string& tag_name, bool once)
+    {
+        Globals *g = Globals::getInstance();
+        g->invalidateCallSites();
+        SettingsConfigPtr s = g->getSettingsConfig();
+        if (once)
+        {
+            s->mOnceTags.insert(tag_name);
+        }
+        else
+        {
+            s->mOnceTags.erase(tag_name);
+        }
+    }
+
     LLError::ELevel decodeLevel(std::string name)
     {
         static LevelMap level_names;
@@ -924,6 +946,7 @@ namespace LLError
         s->mClassLevelMap.clear();
         s->mFileLevelMap.clear();
         s->mTagLevelMap.clear();
+        s->mOnceTags.clear();
         s->mUniqueLogMessages.clear();
 
         setDefaultLevel(decodeLevel(config["default-level"]));
@@ -954,6 +977,13 @@ namespace LLError
                 }
             }
         }
+
+        // tags whose messages are each written once, as with LL_WARNS_ONCE
+        const LLSD& once_tags = config["once-tags"];
+        for (LLSD::array_const_iterator t = once_tags.beginArray(), end = once_tags.endArray(); t != end; ++t)
+        {
+            s->mOnceTags.insert(t->asString());
+        }
     }
 }
 
@@ -1215,7 +1245,10 @@ namespace
         return out.str();
     }
 
-    void writeToRecorders(const LLError::CallSite& site, const std::string& message)
+    // time, if given, stands in for calling the time function, for messages
+    // that were stamped when they were logged rather than when written
+    void writeToRecorders(const LLError::CallSite& site, const std::string& message,
+                          const std::string* time = nullptr)
     {
         LL_PROFILE_ZONE_SCOPED_CATEGORY_LOGGING;
         LLError::ELevel level = site.mLevel;
@@ -1235,7 +1268,14 @@ namespace
 
             if (r->wantsTime() && s->mTimeFunction != NULL)
             {
-                message_stream << s->mTimeFunction();
+                if (time)
+                {
+                    message_stream << *time;
+                }
+                else
+                {
+                    message_stream << s->mTimeFunction();
+                }
             }
             message_stream << " ";
 
@@ -1340,6 +1380,225 @@ namespace {
     }
 }
 
+namespace
+{
+    // Writes log messages on a background thread, for
+    // LLError::setAsyncLogging(). Log::flush() only ever posts while holding
+    // the log mutex, so there's one producer at a time and the queue can be
+    // a single-producer, single-consumer ring.
+    class AsyncLogWriter
+    {
+    public:
+        static AsyncLogWriter& instance()
+        {
+            // never destroyed: there may be logging during static destruction
+            static AsyncLogWriter* sInstance = new AsyncLogWriter;
+            return *sInstance;
+        }
+
+        bool running() const { return mRunning.load(std::memory_order_acquire); }
+        bool onWriterThread() const { return std::this_thread::get_id() == mThreadID; }
+
+        void start()
+        {
+            std::unique_lock lock(*getLogMutex());
+            if (running())
+            {
+                return;
+            }
+            mStopping.store(false);
+            mThread = std::thread([this](){ run(); });
+            mThreadID = mThread.get_id();
+            mRunning.store(true, std::memory_order_release);
+        }
+
+        void stop()
+        {
+            {
+                // with the log mutex held, nobody can post after the drain
+                std::unique_lock lock(*getLogMutex());
+                if (!running())
+                {
+                    return;
+                }
+                flushRepeats();
+                drain();
+                mRunning.store(false, std::memory_order_release);
+            }
+            mStopping.store(true);
+            wake();
+            mThread.join();
+            mThreadID = std::thread::id();
+        }
+
+        // caller holds the log mutex
+        void post(const LLError::CallSite& site, std::string&& time, std::string&& message)
+        {
+            if (&site == mLastSite && message == mLastMessage)
+            {
+                ++mRepeats;
+                return;
+            }
+            flushRepeats();
+            if (mDropped && enqueue(getNoteSite(), std::string(time),
+                                    stringize("(", mDropped, " log messages dropped: the log queue was full)")))
+            {
+                mDropped = 0;
+            }
+            mLastSite = &site;
+            mLastMessage = message;
+            if (!enqueue(site, std::move(time), std::move(message)))
+            {
+                ++mDropped;
+            }
+        }
+
+        // Queue the count of repeats of the last message, if any. Caller
+        // holds the log mutex.
+        void flushRepeats()
+        {
+            if (mRepeats
+                && enqueue(*mLastSite, currentTime(),
+                           stringize("(previous message repeated ", mRepeats, " times)")))
+            {
+                mRepeats = 0;
+            }
+        }
+
+        // wait until whatever's queued has been written
+        void drain()
+        {
+            if (!running() || onWriterThread())
+            {
+                return;
+            }
+            size_t target = mTail.load();
+            wake();
+            while (mHead.load(std::memory_order_acquire) < target)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+    private:
+        struct Entry
+        {
+            const LLError::CallSite* mSite{ nullptr };
+            std::string mTime, mMessage;
+        };
+        // a power of 2
+        static const size_t CAPACITY = 4096;
+        // so that a flood of long messages can't eat memory either
+        static const size_t MAX_BYTES = 4 * 1024 * 1024;
+
+        static std::string currentTime()
+        {
+            SettingsConfigPtr s = Globals::getInstance()->getSettingsConfig();
+            return s->mTimeFunction? s->mTimeFunction() : std::string();
+        }
+
+        // for the writer's own notes
+        static const LLError::CallSite& getNoteSite()
+        {
+            static const char* tags[] = { "Logging" };
+            static LLError::CallSite sSite(LLError::LEVEL_WARN, __FILE__, __LINE__,
+                                           typeid(LLError::NoClassInfo), __FUNCTION__,
+                                           false, tags, LL_ARRAY_SIZE(tags));
+            return sSite;
+        }
+
+        bool enqueue(const LLError::CallSite& site, std::string&& time, std::string&& message)
+        {
+            size_t tail = mTail.load(std::memory_order_relaxed);
+            if (tail - mHead.load(std::memory_order_acquire) >= CAPACITY
+                || mBytes.load(std::memory_order_relaxed) + message.size() > MAX_BYTES)
+            {
+                return false;
+            }
+            Entry& entry = mRing[tail & (CAPACITY - 1)];
+            entry.mSite = &site;
+            entry.mTime = std::move(time);
+            entry.mMessage = std::move(message);
+            mBytes.fetch_add(entry.mMessage.size(), std::memory_order_relaxed);
+            // seq_cst, pairing with run(): either it sees this entry before
+            // it sleeps, or we see it waiting
+            mTail.store(tail + 1);
+            if (mWaiting.load())
+            {
+                wake();
+            }
+            return true;
+        }
+
+        void wake()
+        {
+            std::lock_guard<std::mutex> lock(mWakeMutex);
+            mWake.notify_one();
+        }
+
+        void run()
+        {
+            LL_PROFILER_SET_THREAD_NAME("Logging");
+            for (;;)
+            {
+                size_t head = mHead.load(std::memory_order_relaxed);
+                if (head != mTail.load(std::memory_order_acquire))
+                {
+                    Entry entry = std::move(mRing[head & (CAPACITY - 1)]);
+                    mBytes.fetch_sub(entry.mMessage.size(), std::memory_order_relaxed);
+                    writeToRecorders(*entry.mSite, entry.mMessage, &entry.mTime);
+                    mHead.store(head + 1, std::memory_order_release);
+                    continue;
+                }
+                if (mStopping.load())
+                {
+                    return;
+                }
+
+                bool idle;
+                {
+                    std::unique_lock<std::mutex> lock(mWakeMutex);
+                    mWaiting.store(true);
+                    idle = !mWake.wait_for(lock, std::chrono::seconds(1),
+                                           [this, head]()
+                                           { return mTail.load() != head || mStopping.load(); });
+                    mWaiting.store(false);
+                }
+                if (idle)
+                {
+                    // Don't leave a run of repeats untold just because
+                    // nothing else has been logged since. If someone else is
+                    // logging, they'll get to it.
+                    std::unique_lock log_lock(*getLogMutex(), std::try_to_lock);
+                    if (log_lock)
+                    {
+                        flushRepeats();
+                    }
+                }
+            }
+        }
+
+        std::vector<Entry> mRing{ CAPACITY };
+        std::atomic<size_t> mHead{ 0 };     // next to write out
+        std::atomic<size_t> mTail{ 0 };     // next to fill
+        std::atomic<size_t> mBytes{ 0 };
+
+        // guarded by the log mutex
+        const LLError::CallSite* mLastSite{ nullptr };
+        std::string mLastMessage;
+        U32 mRepeats{ 0 };
+        U32 mDropped{ 0 };
+
+        std::atomic<bool> mRunning{ false };
+        std::atomic<bool> mStopping{ false };
+        std::atomic<bool> mWaiting{ false };
+        std::mutex mWakeMutex;
+        std::condition_variable mWake;
+        std::thread mThread;
+        std::thread::id mThreadID;
+    };
+}
+
 namespace LLError
 {
 
@@ -1382,6 +1641,16 @@ namespace LLError
             ? checkLevelMap(s->mTagLevelMap, site.mTags, site.mTagCount, compareLevel)
             : false);
 
+        site.mTagOnce = false;
+        for (size_t i = 0; i < site.mTagCount && !s->mOnceTags.empty(); ++i)
+        {
+            if (s->mOnceTags.count(site.mTags[i]))
+            {
+                site.mTagOnce = true;
+                break;
+            }
+        }
+
         site.mCached = true;
         g->addCallSite(site);
         return site.mShouldLog = site.mLevel >= compareLevel;
@@ -1402,7 +1671,7 @@ namespace LLError
 
         std::string message = out.str();
 
-        if (site.mPrintOnce)
+        if (site.mPrintOnce || site.mTagOnce)
         {
             std::ostringstream message_stream;
 
@@ -1429,6 +1698,20 @@ namespace LLError
             message = message_stream.str();
         }
 
+        AsyncLogWriter& writer = AsyncLogWriter::instance();
+        if (writer.running())
+        {
+            if (site.mLevel != LEVEL_ERROR && !writer.onWriterThread())
+            {
+                writer.post(site, s->mTimeFunction? s->mTimeFunction() : std::string(),
+                            std::move(message));
+                return;
+            }
+            // keep order: anything queued goes out ahead of this
+            writer.flushRepeats();
+            writer.drain();
+        }
+
         writeToRecorders(site, message);
 
         if (site.mLevel == LEVEL_ERROR)
@@ -1443,6 +1726,34 @@ namespace LLError
     }
 }
 
+namespace LLError
+{
+    void setAsyncLogging(bool async)
+    {
+        if (async)
+        {
+            AsyncLogWriter::instance().start();
+        }
+        else
+        {
+            AsyncLogWriter::instance().stop();
+        }
+    }
+
+    bool getAsyncLogging()
+    {
+        return AsyncLogWriter::instance().running();
+    }
+
+    void flushAsyncLogging()
+    {
+        AsyncLogWriter& writer = AsyncLogWriter::instance();
+        std::unique_lock lock(*getLogMutex());
+        writer.flushRepeats();
+        writer.drain();
+    }
+}
+
 namespace LLError
 {
     SettingsStoragePtr saveAndResetSettings()
@@ -267,7 +267,8 @@ namespace LLError
                                 mFunctionString,
                                 mTagString;
         bool                    mCached,
-                                mShouldLog;
+                                mShouldLog,
+                                mTagOnce;   // setTagOnce() on one of mTags
 
         friend class Log;
     };
@@ -81,12 +81,30 @@ namespace LLError
     LL_COMMON_API void setClassLevel(const std::string& class_name, LLError::ELevel);
     LL_COMMON_API void setFileLevel(const std::string& file_name, LLError::ELevel);
     LL_COMMON_API void setTagLevel(const std::string& file_name, LLError::ELevel);
+    // Treat every message with this tag as if it were logged with one of the
+    // _ONCE macros: each distinct message is written the first time, then
+    // only on its 10th, 50th and every 100th repeat.
+    LL_COMMON_API void setTagOnce(const std::string& tag_name, bool once = true);
 
     LL_COMMON_API LLError::ELevel decodeLevel(std::string name);
     LL_COMMON_API void configure(const LLSD&);
         // the LLSD can configure all of the settings
         // usually read automatically from the live errorlog.xml file
 
+    /*
+        Asynchronous logging: the logging thread only queues each message,
+        and a background thread formats it and hands it to the recorders.
+        The queue is bounded; if it fills, further messages are counted and
+        dropped rather than blocking whoever is logging. A message logged
+        several times in a row is queued once, followed by a note of how
+        many times it repeated. LL_ERRS still writes synchronously, after
+        everything queued before it.
+    */
+    LL_COMMON_API void setAsyncLogging(bool async);
+    LL_COMMON_API bool getAsyncLogging();
+    LL_COMMON_API void flushAsyncLogging();
+        // wait until everything logged so far has reached the recorders
+
 
     /*
         Control functions.
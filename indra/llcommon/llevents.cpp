@@ -74,12 +74,15 @@ LLEventPumps::LLEventPumps():
                              { return new LLEventStream(name, tweak); } },
         { "LLEventMailDrop", [](const std::string& name, bool tweak, const std::string& /*type*/)
                              { return new LLEventMailDrop(name, tweak); } },
+        { "LLEventFastStream", [](const std::string& name, bool tweak, const std::string& /*type*/)
+                             { return new LLEventFastStream(name, tweak); } },
         { "LLEventLogProxy", [](const std::string& name, bool tweak, const std::string& /*type*/)
                              { return new LLEventLogProxyFor<LLEventStream>(name, tweak); } }
     },
     mTypes
     {
-//      { "placeholder", "LLEventStream" }
+        // posted every frame
+        { "mainloop", "LLEventFastStream" }
     }
 {}
 
@@ -167,6 +170,16 @@ LLEventPump& LLEventPumps::obtain(const std::string& name)
     return make(name, false, type);
 }
 
+LLEventPump& LLEventPumps::obtain(const LLSymbol& name)
+{
+    PumpSymbolMap::iterator found = mPumpSymbols.find(name);
+    if (found != mPumpSymbols.end())
+    {
+        return *found->second;
+    }
+    return obtain(name.str());
+}
+
 LLEventPump& LLEventPumps::make(const std::string& name, bool tweak,
                                 const std::string& type)
 {
@@ -200,6 +213,18 @@ bool LLEventPumps::post(const std::string&name, const LLSD&message)
     return (*found).second->post(message);
 }
 
+bool LLEventPumps::post(const LLSymbol& name, const LLSD& message)
+{
+    PumpSymbolMap::iterator found = mPumpSymbols.find(name);
+    if (found == mPumpSymbols.end())
+    {
+        LL_DEBUGS("LLEventPumps") << "LLEventPump(" << std::quoted(name.str()) << ") not found"
+                                  << LL_ENDL;
+        return false;
+    }
+    return found->second->post(message);
+}
+
 void LLEventPumps::flush()
 {
     // Flush every known LLEventPump instance. Leave it up to each instance to
@@ -245,7 +270,10 @@ std::string LLEventPumps::registerNew(const LLEventPump& pump, const std::string
         mPumpMap.insert(PumpMap::value_type(name, const_cast<LLEventPump*>(&pump)));
     // If the insert worked, then the name is unique; return that.
     if (inserted.second)
+    {
+        mPumpSymbols[LLSymbol(name)] = const_cast<LLEventPump*>(&pump);
         return name;
+    }
     // Here the new entry was NOT inserted, and therefore name isn't unique.
     // Unless we're permitted to tweak it, that's Bad.
     if (! tweak)
@@ -320,6 +348,7 @@ void LLEventPumps::unregister(const LLEventPump& pump)
     if (found != mPumpMap.end())
     {
         mPumpMap.erase(found);
+        mPumpSymbols.erase(LLSymbol::find(pump.getName()));
     }
     // If this instance is one we created, also remove it from mOurPumps so we
     // won't try again to delete it later!
@@ -692,6 +721,202 @@ void LLEventMailDrop::discard()
     mEventHistory.clear();
 }
 
+/*****************************************************************************
+*   LLEventFastStream
+*****************************************************************************/
+namespace
+{
+    // boost::signals2::connection's public connected() locks the connection
+    // and walks its tracked objects, which would cost more than the call it
+    // guards. Holding the connection body lets post() just read the flags.
+    struct ConnectionBody: public boost::signals2::connection
+    {
+        typedef boost::shared_ptr<boost::signals2::detail::connection_body_base> ptr;
+
+        static ptr get(const boost::signals2::connection& connection)
+        {
+            return (connection.*(&ConnectionBody::_weak_connection_body)).lock();
+        }
+    };
+}
+
+struct LLEventFastStream::Dispatch
+{
+    struct Entry
+    {
+        float mOrder;
+        LLBoundListener mConnection;
+        ConnectionBody::ptr mBody;
+        // for LLSD posts
+        LLAwareListener mListener;
+        // for typed posts; if set, mListener is never called
+        TypedListener mTyped;
+
+        bool connected() const { return mBody->nolock_nograb_connected(); }
+    };
+    typedef std::vector<Entry> Entries;
+
+    // replaced, never modified, so post() can keep walking the one it has
+    // while listeners come and go
+    std::shared_ptr<const Entries> mEntries{ std::make_shared<Entries>() };
+    bool mStale{ false };
+
+    template <typename CALL>
+    bool dispatch(bool typed, const CALL& call)
+    {
+        std::shared_ptr<const Entries> entries(mEntries);
+        for (const Entry& entry : *entries)
+        {
+            if (! entry.connected())
+            {
+                mStale = true;
+                continue;
+            }
+            if (bool(entry.mTyped) != typed || entry.mBody->blocked())
+            {
+                continue;
+            }
+            if (! typed && entry.mListener.expired())
+            {
+                // as LLStandardSignal does when a tracked object goes away
+                entry.mConnection.disconnect();
+                mStale = true;
+                continue;
+            }
+            // stop as soon as a listener handles the event, as
+            // LLStopWhenHandled does
+            if (call(entry))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // copy of mEntries without the disconnected listeners
+    std::shared_ptr<Entries> live() const
+    {
+        auto entries = std::make_shared<Entries>();
+        entries->reserve(mEntries->size() + 1);
+        std::copy_if(mEntries->begin(), mEntries->end(), std::back_inserter(*entries),
+                     [](const Entry& entry){ return entry.connected(); });
+        return entries;
+    }
+
+    void prune()
+    {
+        if (mStale)
+        {
+            mStale = false;
+            mEntries = live();
+        }
+    }
+
+    void add(Entry&& entry)
+    {
+        auto entries = live();
+        // after any others in the same position, as signals2 would put it
+        auto where = std::upper_bound(entries->begin(), entries->end(), entry.mOrder,
+                                      [](float order, const Entry& other){ return order < other.mOrder; });
+        entries->insert(where, std::move(entry));
+        mEntries = entries;
+        mStale = false;
+    }
+};
+
+LLEventFastStream::LLEventFastStream(const std::string& name, bool tweak):
+    LLEventStream(name, tweak),
+    mDispatch(std::make_shared<Dispatch>())
+{}
+
+LLEventFastStream::~LLEventFastStream() {}
+
+bool LLEventFastStream::post(const LLSD& event)
+{
+    if (! mEnabled || !mSignal)
+    {
+        return false;
+    }
+    // Don't touch 'this' after dispatching: see LLEventStream::post()
+    std::shared_ptr<Dispatch> dispatch(mDispatch);
+    bool handled = dispatch->dispatch(
+        false,
+        [&event](const Dispatch::Entry& entry){ return entry.mListener(entry.mConnection, event); });
+    dispatch->prune();
+    return handled;
+}
+
+bool LLEventFastStream::postTyped_impl(const void* payload)
+{
+    if (! mEnabled || !mSignal)
+    {
+        return false;
+    }
+    std::shared_ptr<Dispatch> dispatch(mDispatch);
+    bool handled = dispatch->dispatch(
+        true,
+        [payload](const Dispatch::Entry& entry){ return entry.mTyped(entry.mConnection, payload); });
+    dispatch->prune();
+    return handled;
+}
+
+LLBoundListener LLEventFastStream::listen_impl(const std::string& name,
+                                               const LLAwareListener& listener,
+                                               const NameList& after,
+                                               const NameList& before)
+{
+    return add(name, listener, TypedListener(), after, before);
+}
+
+LLBoundListener LLEventFastStream::listenTyped_impl(const std::string& name,
+                                                    const TypedListener& listener,
+                                                    const NameList& after,
+                                                    const NameList& before)
+{
+    return add(name, [](const LLBoundListener&, const LLSD&){ return false; }, listener, after, before);
+}
+
+LLBoundListener LLEventFastStream::add(const std::string& name,
+                                       const LLAwareListener& listener,
+                                       const TypedListener& typed,
+                                       const NameList& after,
+                                       const NameList& before)
+{
+    // Let LLEventPump check the name, sort the dependencies and connect a
+    // placeholder to mSignal: that gives us a real LLBoundListener, and our
+    // listener's place in the order. post() never calls mSignal.
+    LLBoundListener bound = LLEventPump::listen_impl(
+        name, [](const LLBoundListener&, const LLSD&){ return false; }, after, before);
+    ConnectionBody::ptr body(ConnectionBody::get(bound));
+    if (! body)
+    {
+        return bound;
+    }
+
+    float order = 1.f;              // as for an ANONYMOUS listener
+    if (! name.empty())
+    {
+        if (const float* found = mDeps.get(name))
+        {
+            order = *found;
+        }
+    }
+    mDispatch->add(Dispatch::Entry{ order, bound, body, listener, typed });
+    return bound;
+}
+
+void LLEventFastStream::clear()
+{
+    LLEventStream::clear();
+    mDispatch = std::make_shared<Dispatch>();
+}
+
+void LLEventFastStream::reset()
+{
+    LLEventStream::reset();
+    mDispatch = std::make_shared<Dispatch>();
+}
+
 /*****************************************************************************
 *   LLListenerOrPumpName
 *****************************************************************************/
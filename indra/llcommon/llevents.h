@@ -38,6 +38,7 @@
 #include <set>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include <boost/signals2.hpp>
@@ -47,6 +48,7 @@
 #include "llexception.h"
 #include "llsd.h"
 #include "llsingleton.h"
+#include "llsymbol.h"
 
 // hack for testing
 #ifndef testable
@@ -220,6 +222,12 @@ public:
      * an instance without conferring @em ownership.
      */
     LLEventPump& obtain(const std::string& name);
+    /**
+     * Same, but finding an existing instance is a pointer-keyed hash lookup
+     * rather than string comparisons: worth it for a name you look up every
+     * frame, kept in a static LLSymbol.
+     */
+    LLEventPump& obtain(const LLSymbol& name);
 
     /// exception potentially thrown by make()
     struct BadType: public LLException
@@ -294,6 +302,7 @@ public:
      * however if the pump does not already exist it will not be created.
      */
     bool post(const std::string&, const LLSD&);
+    bool post(const LLSymbol&, const LLSD&);
 
     /**
      * Flush all known LLEventPump instances
@@ -335,6 +344,10 @@ testable:
     // lifespan.
     typedef std::map<std::string, LLEventPump*> PumpMap;
     PumpMap mPumpMap;
+    // The same instances again, by interned name, for the LLSymbol
+    // overloads. mPumpMap stays ordered by name for registerNew()'s benefit.
+    typedef std::unordered_map<LLSymbol, LLEventPump*> PumpSymbolMap;
+    PumpSymbolMap mPumpSymbols;
     // Set of all LLEventPumps we instantiated. Membership in this set means
     // we claim ownership, and will delete them when this LLEventPumps is
     // destroyed.
@@ -542,7 +555,7 @@ public:
     /// flush queued events
     virtual void flush() {}
 
-private:
+protected:
     friend class LLEventPumps;
     virtual void clear();
     virtual void reset();
@@ -664,6 +677,121 @@ private:
     EventList mEventHistory;
 };
 
+/*****************************************************************************
+*   LLEventFastStream
+*****************************************************************************/
+/**
+ * LLEventFastStream behaves like LLEventStream -- same listen() options,
+ * same listener order, LLBoundListener disconnect and Blocker both work --
+ * but post() doesn't go through LLStandardSignal. Each listen() flattens the
+ * listener into an array already sorted in dependency order, and post()
+ * simply walks it. Use it for pumps posted every frame, like "mainloop".
+ *
+ * Listening is no cheaper than on LLEventStream: the dependency sort and
+ * bookkeeping are the same.
+ */
+class LL_COMMON_API LLEventFastStream: public LLEventStream
+{
+public:
+    LLEventFastStream(const std::string& name, bool tweak=false);
+    virtual ~LLEventFastStream();
+
+    /// Post an event to all listeners
+    virtual bool post(const LLSD& event) override;
+
+protected:
+    /// a listener taking a pointer to the payload of whatever type the
+    /// subclass posts, as LLEventTypedStream does
+    typedef std::function<bool(const LLBoundListener&, const void*)> TypedListener;
+
+    virtual LLBoundListener listen_impl(const std::string& name, const LLAwareListener&,
+                                        const NameList& after,
+                                        const NameList& before) override;
+    LLBoundListener listenTyped_impl(const std::string& name, const TypedListener&,
+                                     const NameList& after,
+                                     const NameList& before);
+    /// call the typed listeners, not the LLSD ones
+    bool postTyped_impl(const void* payload);
+
+    virtual void clear() override;
+    virtual void reset() override;
+
+private:
+    LLBoundListener add(const std::string& name, const LLAwareListener& listener,
+                        const TypedListener& typed,
+                        const NameList& after, const NameList& before);
+
+    // As for LLEventStream's mSignal, post() holds a reference to this in
+    // case a listener destroys the pump.
+    struct Dispatch;
+    std::shared_ptr<Dispatch> mDispatch;
+};
+
+/*****************************************************************************
+*   LLEventTypedStream
+*****************************************************************************/
+/**
+ * LLEventTypedStream<PAYLOAD> is an LLEventFastStream that can also carry a
+ * plain C++ PAYLOAD, so internal events don't have to build an LLSD to be
+ * posted. Typed listeners attached with listenTyped() see only typed posts;
+ * listeners attached with listen() see only LLSD posts, so code that only
+ * knows the LLEventPump interface still works.
+ *
+ * @code
+ * struct FrameEvent { F64 mTime; U32 mFrame; };
+ * LLEventTypedStream<FrameEvent> frames("frames");
+ * LLTempBoundListener conn = frames.listenTyped("stats",
+ *     [](const FrameEvent& event) { sample(event.mTime); });
+ * frames.post(FrameEvent{ now, count });
+ * @endcode
+ *
+ * A typed listener may return bool, meaning the same as for an LLSD
+ * listener, or void.
+ */
+template <typename PAYLOAD>
+class LLEventTypedStream: public LLEventFastStream
+{
+    static_assert(! std::is_same_v<PAYLOAD, LLSD>, "LLEventTypedStream<LLSD> is just LLEventFastStream");
+
+public:
+    LLEventTypedStream(const std::string& name, bool tweak=false): LLEventFastStream(name, tweak) {}
+
+    using LLEventFastStream::post;
+    /// Post payload to all typed listeners
+    bool post(const PAYLOAD& payload) { return postTyped_impl(&payload); }
+
+    /// As listen(), for a listener taking (const PAYLOAD&)
+    template <typename LISTENER>
+    LLBoundListener listenTyped(const std::string& name,
+                                LISTENER&& listener,
+                                const NameList& after=NameList(),
+                                const NameList& before=NameList())
+    {
+        static_assert(std::is_invocable_v<LISTENER, const PAYLOAD&>,
+                      "LLEventTypedStream::listenTyped() listener has bad parameter signature");
+        using result_t = std::decay_t<std::invoke_result_t<LISTENER, const PAYLOAD&>>;
+        static_assert(std::is_same_v<result_t, bool> || std::is_same_v<result_t, void>,
+                      "LLEventTypedStream::listenTyped() listener has bad return type");
+        return listenTyped_impl(
+            name,
+            [listener=std::forward<LISTENER>(listener)]
+            (const LLBoundListener&, const void* payload)
+            {
+                if constexpr (std::is_same_v<result_t, bool>)
+                {
+                    return listener(*static_cast<const PAYLOAD*>(payload));
+                }
+                else
+                {
+                    listener(*static_cast<const PAYLOAD*>(payload));
+                    return false;
+                }
+            },
+            after,
+            before);
+    }
+};
+
 /*****************************************************************************
 *   LLNamedListener
 *****************************************************************************/
@@ -63,6 +63,7 @@ namespace LLTrace
 bool        BlockTimer::sLog             = false;
 std::string BlockTimer::sLogName         = "";
 bool        BlockTimer::sMetricLog       = false;
+std::atomic<bool> BlockTimer::sFullTiming{ true };
 
 #if LL_LINUX
 U64         BlockTimer::sClockResolution = 1000000000; // Nanosecond resolution
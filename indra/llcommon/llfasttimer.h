@@ -29,7 +29,9 @@
 
 #include "llinstancetracker.h"
 #include "lltrace.h"
+#include "lltracecapture.h"
 #include "lltreeiterators.h"
+#include <atomic>
 
 #if LL_WINDOWS
 #include <intrin.h>
@@ -200,6 +202,14 @@ public:
     // call nextFrame() to reset timers
     static void dumpCurTimes();
 
+    // Full timing maintains the timer call stack, which self times and the
+    // timer tree are built from. Without it, each timer only takes a pair of
+    // clock samples and counts calls and total time, which is all that's
+    // needed while nobody is looking at the fast timer view or logging.
+    // Scopes already open keep the mode they started in.
+    static void setFullTiming(bool full) { sFullTiming.store(full, std::memory_order_relaxed); }
+    static bool getFullTiming() { return sFullTiming.load(std::memory_order_relaxed); }
+
 private:
     friend class BlockTimerStatHandle;
     // FIXME: this friendship exists so that each thread can instantiate a root timer,
@@ -216,6 +226,8 @@ private:
 private:
     U64                     mStartTime;
     BlockTimerStackRecord   mParentTimerData{};
+    // just sampling the clock, see setFullTiming()
+    bool                    mSampled{ false };
 
 public:
     // statics
@@ -224,6 +236,8 @@ public:
                             sLog;
     static U64              sClockResolution;
 
+private:
+    static std::atomic<bool> sFullTiming;
 };
 
 // this dummy function assists in allocating a block timer with stack-based lifetime.
@@ -293,6 +307,13 @@ LL_FORCE_INLINE BlockTimer::BlockTimer(BlockTimerStatHandle& timer)
         mStartTime = 0;
         return;
     }
+    if (!sFullTiming.load(std::memory_order_relaxed))
+    {
+        mSampled = true;
+        mParentTimerData.mTimeBlock = &timer;
+        mStartTime = getCPUClockCount64();
+        return;
+    }
     TimeBlockAccumulator& accumulator = timer.getCurrentAccumulator();
     accumulator.mActiveCount++;
     // keep current parent as long as it is active when we are
@@ -313,6 +334,18 @@ LL_FORCE_INLINE BlockTimer::~BlockTimer()
 {
 #if LL_FAST_TIMER_ON
     U64 total_time = getCPUClockCount64() - mStartTime;
+    if (mSampled)
+    {
+        // not on the timer stack, so no self time or caller to record
+        TimeBlockAccumulator& accumulator = mParentTimerData.mTimeBlock->getCurrentAccumulator();
+        accumulator.mCalls++;
+        accumulator.mTotalTimeCounter += total_time;
+        if (TraceCapture::isEnabled())
+        {
+            TraceCapture::recordScope(mParentTimerData.mTimeBlock->getName().c_str(), mStartTime, mStartTime + total_time);
+        }
+        return;
+    }
     BlockTimerStackRecord* cur_timer_data = LLThreadLocalSingletonPointer<BlockTimerStackRecord>::getInstance();
     if (!cur_timer_data) return;
 
@@ -330,6 +363,13 @@ LL_FORCE_INLINE BlockTimer::~BlockTimer()
     // we are only tracking self time, so subtract our total time delta from parents
     mParentTimerData.mChildTime += total_time;
 
+    if (TraceCapture::isEnabled())
+    {
+        // processTimes() may have moved mStartTime up, in which case the
+        // capture only has the part of the scope since then
+        TraceCapture::recordScope(cur_timer_data->mTimeBlock->getName().c_str(), mStartTime, mStartTime + total_time);
+    }
+
     //pop stack
     *cur_timer_data = mParentTimerData;
 #endif
@@ -0,0 +1,222 @@
+/**
+ * @file llheap.cpp
+ * @brief Named heaps for the viewer's big allocating subsystems.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llheap.h"
+
+#include "llerror.h"
+#include "lltimer.h"
+
+#include <atomic>
+#include <cstdlib>
+
+#if LL_USE_MIMALLOC
+#include <mimalloc.h>
+#endif
+
+#if LL_WINDOWS || LL_LINUX
+#include <malloc.h>
+#elif LL_DARWIN
+#include <malloc/malloc.h>
+#endif
+
+namespace
+{
+    const char* HEAP_NAMES[LLHeap::HEAP_COUNT] = { "image", "llsd", "geometry", "ui", "scene" };
+
+    // Signed, as a buffer adopted from elsewhere is still subtracted when it
+    // is freed
+    std::atomic<S64> sInUse[LLHeap::HEAP_COUNT];
+    std::atomic<U64> sAllocations[LLHeap::HEAP_COUNT];
+
+#if LL_USE_MIMALLOC
+    // mimalloc heaps belong to the thread that made them: only it may
+    // allocate from one, though any thread may free into it. So each thread
+    // gets its own set, made as it first needs them.
+    struct ThreadHeaps
+    {
+        mi_heap_t* mHeaps[LLHeap::HEAP_COUNT] = {};
+
+        ~ThreadHeaps()
+        {
+            for (mi_heap_t* heap : mHeaps)
+            {
+                if (heap)
+                {
+                    // blocks still in use move to the thread's default heap
+                    mi_heap_delete(heap);
+                }
+            }
+        }
+
+        mi_heap_t* get(LLHeap::EHeap heap)
+        {
+            if (!mHeaps[heap])
+            {
+                mHeaps[heap] = mi_heap_new();
+            }
+            return mHeaps[heap];
+        }
+    };
+
+    thread_local ThreadHeaps sThreadHeaps;
+#endif // LL_USE_MIMALLOC
+
+    // Compatible with ll_aligned_malloc_16() and ll_aligned_free_16()
+    void* system_allocate(size_t size, size_t alignment)
+    {
+#if LL_WINDOWS
+        return _aligned_malloc(size, alignment);
+#else
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, llmax(alignment, sizeof(void*)), size) != 0)
+        {
+            return nullptr;
+        }
+        return ptr;
+#endif
+    }
+
+    void system_free(void* ptr)
+    {
+#if LL_WINDOWS
+        _aligned_free(ptr);
+#else
+        ::free(ptr);
+#endif
+    }
+}
+
+//static
+void* LLHeap::allocate(EHeap heap, size_t size, size_t alignment)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_MEMORY;
+#if LL_USE_MIMALLOC
+    void* ptr = mi_heap_malloc_aligned(sThreadHeaps.get(heap), size, alignment);
+#else
+    void* ptr = system_allocate(size, alignment);
+#endif
+    if (ptr)
+    {
+        sInUse[heap].fetch_add((S64)size, std::memory_order_relaxed);
+        sAllocations[heap].fetch_add(1, std::memory_order_relaxed);
+        LL_PROFILE_ALLOC(ptr, size);
+    }
+    return ptr;
+}
+
+//static
+void LLHeap::free(EHeap heap, void* ptr, size_t size, size_t alignment)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_MEMORY;
+    if (!ptr)
+    {
+        return;
+    }
+
+    LL_PROFILE_FREE(ptr);
+#if LL_USE_MIMALLOC
+    if (!mi_is_in_heap_region(ptr))
+    {
+        // adopted from ll_aligned_malloc_16(), never counted
+        system_free(ptr);
+        return;
+    }
+    mi_free(ptr);
+#else
+    system_free(ptr);
+#endif
+    sInUse[heap].fetch_sub((S64)size, std::memory_order_relaxed);
+}
+
+//static
+const char* LLHeap::getName(EHeap heap)
+{
+    return heap < HEAP_COUNT ? HEAP_NAMES[heap] : "unknown";
+}
+
+//static
+size_t LLHeap::getInUse(EHeap heap)
+{
+    return (size_t)llmax(sInUse[heap].load(std::memory_order_relaxed), (S64)0);
+}
+
+//static
+U64 LLHeap::getAllocations(EHeap heap)
+{
+    return sAllocations[heap].load(std::memory_order_relaxed);
+}
+
+//static
+size_t LLHeap::getCommitted()
+{
+#if LL_USE_MIMALLOC
+    size_t current_commit = 0;
+    mi_process_info(nullptr, nullptr, nullptr, nullptr, nullptr, &current_commit, nullptr, nullptr);
+    return current_commit;
+#else
+    return 0;
+#endif
+}
+
+//static
+bool LLHeap::usingMimalloc()
+{
+#if LL_USE_MIMALLOC
+    return true;
+#else
+    return false;
+#endif
+}
+
+//static
+void LLHeap::purge()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_MEMORY;
+    LLTimer timer;
+    size_t committed = getCommitted();
+
+#if LL_USE_MIMALLOC
+    // this thread's heaps, and the pages of threads that have exited
+    mi_collect(true);
+#endif
+    // everything else still goes through the CRT
+#if LL_WINDOWS
+    _heapmin();
+#elif LL_LINUX
+    malloc_trim(0);
+#elif LL_DARWIN
+    malloc_zone_pressure_relief(nullptr, 0);
+#endif
+
+    LL_INFOS("Heap") << "Purged heaps in " << timer.getElapsedTimeF32() * 1000.f << "ms";
+    if (committed)
+    {
+        LL_CONT << ", committed " << (committed >> 20) << "MB -> " << (getCommitted() >> 20) << "MB";
+    }
+    LL_CONT << LL_ENDL;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file llheap.h
+ * @brief Named heaps for the viewer's big allocating subsystems.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLHEAP_H
+#define LL_LLHEAP_H
+
+#include "llpreprocessor.h"
+#include "stdtypes.h"
+
+#include <cstddef>
+#include <new>
+
+/**
+ * LLHeap keeps the allocations of one subsystem -- decoded images, LLSD
+ * values, volume geometry, UI widgets, scene objects -- together, so their footprint can be
+ * watched separately and their churn doesn't fragment each other.
+ *
+ * Built with USE_MIMALLOC, each heap is a mimalloc heap (one per thread, as
+ * mimalloc heaps are; any thread may free). Otherwise every heap is the CRT
+ * heap and only the accounting is separate.
+ *
+ * free() also takes memory that came from ll_aligned_malloc_16(), so an owner
+ * that frees through LLHeap, as LLImageRaw does, can safely adopt a stray
+ * buffer, though the heap's count will be off by its size. The reverse isn't
+ * true: never free LLHeap memory any way but LLHeap::free().
+ */
+class LL_COMMON_API LLHeap
+{
+public:
+    enum EHeap
+    {
+        HEAP_IMAGE,
+        HEAP_LLSD,
+        HEAP_GEOMETRY,
+        HEAP_UI,
+        HEAP_SCENE,
+        HEAP_COUNT
+    };
+
+    /// nullptr on failure, like malloc; alignment is a power of two
+    static void* allocate(EHeap heap, size_t size, size_t alignment = 16);
+    /// size and alignment as allocated; ptr may be nullptr
+    static void free(EHeap heap, void* ptr, size_t size, size_t alignment = 16);
+
+    static const char* getName(EHeap heap);
+
+    /// bytes currently allocated from heap, as requested
+    static size_t getInUse(EHeap heap);
+    /// allocations made from heap so far, for its churn
+    static U64 getAllocations(EHeap heap);
+    /// bytes the allocator has committed from the OS for everything it
+    /// serves, or 0 when that isn't known (without mimalloc)
+    static size_t getCommitted();
+
+    static bool usingMimalloc();
+
+    /// Give memory the allocator no longer needs back to the OS. This can
+    /// take a few milliseconds, so call it when the viewer is idle.
+    static void purge();
+};
+
+/// Class-level operator new and delete for classes whose instances belong
+/// in the given heap. Put it in the public section of the base class;
+/// placement new still works.
+#define LL_HEAP_OPERATORS(HEAP)                                             \
+    void* operator new(size_t size)                                         \
+    {                                                                       \
+        void* ptr = LLHeap::allocate(HEAP, size);                           \
+        if (!ptr)                                                           \
+        {                                                                   \
+            throw std::bad_alloc();                                         \
+        }                                                                   \
+        return ptr;                                                         \
+    }                                                                       \
+    void operator delete(void* ptr, size_t size)                            \
+    {                                                                       \
+        LLHeap::free(HEAP, ptr, size);                                      \
+    }                                                                       \
+    void* operator new(size_t, void* where) noexcept                        \
+    {                                                                       \
+        return where;                                                       \
+    }                                                                       \
+    void operator delete(void*, void*) noexcept                             \
+    {                                                                       \
+    }
+
+#endif // LL_LLHEAP_H
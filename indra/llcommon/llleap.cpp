@@ -315,59 +315,127 @@ public:
                 LL_DEBUGS("LLLeap") << "needed " << mExpect << " bytes, got "
                                     << childout.size() << ", parsing LLSD" << LL_ENDL;
                 LLSD data;
-#if 1
-                // specifically require notation LLSD from child
-                LLPointer<LLSDParser> parser(new LLSDNotationParser());
-                S32 parse_status(parser->parse(childout.get_istream(), data, mExpect));
-                if (parse_status == LLSDParser::PARSE_FAILURE)
-#else
-                // SL-18330: accept any valid LLSD serialization format from child
-                // Unfortunately this runs into trouble we have not yet debugged.
-                bool parse_status(LLSDSerialize::deserialize(data, childout.get_istream(), mExpect));
-                if (! parse_status)
-#endif
+                if (size_t header = peekBinaryHeader(childout))
                 {
-                    bad_protocol("unparseable LLSD data");
-                    break;
+                    // Binary LLSD, as we send, is much cheaper to parse than
+                    // notation for large or frequent events. LLSDBinaryParser
+                    // doesn't expect the header, so consume it here.
+                    childout.read(header);
+                    LLPointer<LLSDParser> parser(new LLSDBinaryParser());
+                    if (parser->parse(childout.get_istream(), data, mExpect - header)
+                        == LLSDParser::PARSE_FAILURE)
+                    {
+                        bad_protocol("unparseable binary LLSD data");
+                        break;
+                    }
                 }
-                else if (! (data.isMap() && data["pump"].isString() && data.has("data")))
+                else
                 {
-                    // we got an LLSD object, but it lacks required keys
-                    bad_protocol("missing 'pump' or 'data'");
-                    break;
+                    // otherwise require notation LLSD from child
+                    // (LLSDSerialize::deserialize() would detect the format,
+                    // but it runs into trouble on this stream we have not yet
+                    // debugged)
+                    LLPointer<LLSDParser> parser(new LLSDNotationParser());
+                    if (parser->parse(childout.get_istream(), data, mExpect)
+                        == LLSDParser::PARSE_FAILURE)
+                    {
+                        bad_protocol("unparseable LLSD data");
+                        break;
+                    }
                 }
-                else
+
+                // A child streaming many small events may batch them as an
+                // array of requests in one packet.
+                if (data.isArray())
                 {
-                    try
+                    bool valid(true);
+                    for (const LLSD& request : llsd::inArray(data))
                     {
-                        // The LLSD object we got from our stream contains the
-                        // keys we need.
-                        LLEventPumps::instance().post(data["pump"], data["data"]);
+                        if (! isRequest(request))
+                        {
+                            valid = false;
+                            break;
+                        }
                     }
-                    catch (const std::exception& err)
+                    if (! valid)
                     {
-                        // No plugin should be allowed to crash the viewer by
-                        // driving an exception -- intentionally or not.
-                        LOG_UNHANDLED_EXCEPTION(stringize("handling request ", data));
-                        // Whether or not the plugin added a "reply" key to the
-                        // request, send a reply. We happen to know who originated
-                        // this request, and the reply LLEventPump of interest.
-                        // Not our problem if the plugin ignores the reply event.
-                        data["reply"] = mListener->getReplyPump().getName();
-                        sendReply(llsd::map("error",
-                                            stringize(LLError::Log::classname(err), ": ", err.what())),
-                                  data);
+                        bad_protocol("missing 'pump' or 'data' in batch");
+                        break;
                     }
-                    // Transition to "read prefix" mode and go check for any
-                    // more pending events in the buffer.
-                    mReadPrefix = true;
-                    continue;
+                    for (const LLSD& request : llsd::inArray(data))
+                    {
+                        post(request);
+                    }
+                }
+                else if (! isRequest(data))
+                {
+                    // we got an LLSD object, but it lacks required keys
+                    bad_protocol("missing 'pump' or 'data'");
+                    break;
                 }
+                else
+                {
+                    post(data);
+                }
+                // Transition to "read prefix" mode and go check for any
+                // more pending events in the buffer.
+                mReadPrefix = true;
+                continue;
             }
         }
         return false;
     }
 
+    static bool isRequest(const LLSD& data)
+    {
+        return data.isMap() && data["pump"].isString() && data.has("data");
+    }
+
+    // If the packet waiting in childout starts with a binary LLSD header,
+    // return the length of that header line, else 0. Accept both our own
+    // "<? LLSD/Binary ?>" and the "<?llsd/binary?>" other LLSD
+    // implementations write.
+    size_t peekBinaryHeader(const LLProcess::ReadPipe& childout) const
+    {
+        std::string header(childout.peek(0, (std::min)(mExpect, LLProcess::ReadPipe::size_type(24))));
+        std::string::size_type newline(header.find('\n'));
+        if (newline == std::string::npos || header.compare(0, 2, "<?") != 0)
+        {
+            return 0;
+        }
+        header.erase(newline);
+        header.erase(std::remove(header.begin(), header.end(), ' '), header.end());
+        if (LLStringUtil::compareInsensitive(header, "<?llsd/binary?>") != 0)
+        {
+            return 0;
+        }
+        return newline + 1;
+    }
+
+    void post(LLSD request)
+    {
+        try
+        {
+            // The LLSD object we got from our stream contains the
+            // keys we need.
+            LLEventPumps::instance().post(request["pump"], request["data"]);
+        }
+        catch (const std::exception& err)
+        {
+            // No plugin should be allowed to crash the viewer by
+            // driving an exception -- intentionally or not.
+            LOG_UNHANDLED_EXCEPTION(stringize("handling request ", request));
+            // Whether or not the plugin added a "reply" key to the
+            // request, send a reply. We happen to know who originated
+            // this request, and the reply LLEventPump of interest.
+            // Not our problem if the plugin ignores the reply event.
+            request["reply"] = mListener->getReplyPump().getName();
+            sendReply(llsd::map("error",
+                                stringize(LLError::Log::classname(err), ": ", err.what())),
+                      request);
+        }
+    }
+
     void bad_protocol(const std::string& data)
     {
         LL_WARNS("LLLeap") << mDesc << ": invalid protocol: " << data << LL_ENDL;
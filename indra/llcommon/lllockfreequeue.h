@@ -0,0 +1,478 @@
+/**
+ * @file   lllockfreequeue.h
+ * @date   2026-10-14
+ * @brief  Multi-producer, multi-consumer queue whose push and pop don't take
+ *         a lock while it has room.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLLOCKFREEQUEUE_H
+#define LL_LLLOCKFREEQUEUE_H
+
+#include "llthreadsafequeue.h"      // LLThreadSafeQueueInterrupt
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+
+/*****************************************************************************
+*   LLLockFreeQueue
+*****************************************************************************/
+/**
+ * LLLockFreeQueue is a drop-in alternative to LLThreadSafeQueue, with the
+ * same push/pop/close semantics, for queues where many threads post and
+ * the lock itself is the bottleneck.
+ *
+ * Elements live in a bounded ring (Vyukov's MPMC array queue), so pushing
+ * and popping are a compare-and-swap apiece. When the ring is full, further
+ * elements go to a mutex-protected spill queue until it drains, which
+ * keeps both FIFO order and the overall capacity of an LLThreadSafeQueue
+ * without reserving a ring that large. Blocking calls wait on a
+ * fiber-aware condition variable, which pushers only touch when someone is
+ * actually waiting.
+ *
+ * ElementT must be default-constructible and move-assignable.
+ *
+ * A push that races with close() may still land and be popped, or not;
+ * every push that starts after close() fails.
+ */
+template <typename ElementT>
+class LLLockFreeQueue
+{
+public:
+    typedef ElementT value_type;
+
+    // The ring holds the largest power of two no more than capacity, up to
+    // MAX_RING elements; the spill queue holds the rest.
+    LLLockFreeQueue(size_t capacity = 1024);
+
+    // Add an element to the queue (will block if the queue has reached
+    // capacity). Throws LLThreadSafeQueueInterrupt if the queue is closed.
+    template <typename T>
+    void push(T&& element);
+
+    // Add an element to the queue (will block if the queue has reached
+    // capacity). Return false if the queue is closed before push is possible.
+    template <typename T>
+    bool pushIfOpen(T&& element);
+
+    // Try to add an element to the queue without blocking. Returns true only
+    // if the element was actually added.
+    template <typename T>
+    bool tryPush(T&& element);
+
+    // Pop the element at the head of the queue (will block if the queue is
+    // empty). Throws LLThreadSafeQueueInterrupt once the queue is closed and
+    // drained.
+    ElementT pop();
+
+    // Pop an element from the head of the queue if there is one available.
+    // Returns true only if an element was popped.
+    bool tryPop(ElementT& element);
+
+    // Pop the element at the head of the queue, blocking if the queue is
+    // empty, until the specified timeout or time_point. Returns true only
+    // if an element was popped.
+    template <typename Rep, typename Period>
+    bool tryPopFor(const std::chrono::duration<Rep, Period>& timeout,
+                   ElementT& element);
+    template <typename Clock, typename Duration>
+    bool tryPopUntil(const std::chrono::time_point<Clock, Duration>& until,
+                     ElementT& element);
+
+    // Returns the (approximate) size of the queue.
+    size_t size() const;
+
+    // Returns the capacity of the queue.
+    size_t capacity() const { return mCapacity; }
+
+    // closes the queue:
+    // - every subsequent push() call will throw LLThreadSafeQueueInterrupt
+    // - every subsequent pushIfOpen() or tryPush() call will return false
+    // - pop() calls will return normally until the queue is drained, then
+    //   every subsequent pop() will throw LLThreadSafeQueueInterrupt
+    // - tryPop() calls will return normally until the queue is drained,
+    //   then every subsequent tryPop() call will return false
+    void close();
+
+    // producer end: are we prevented from pushing any additional items?
+    bool isClosed() const { return mClosed.load(std::memory_order_acquire); }
+    // consumer end: are we done, is the queue entirely drained?
+    bool done() const { return isClosed() && ! size(); }
+
+    static constexpr size_t MAX_RING = 16384;
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> mSeq;
+        ElementT mValue;
+    };
+
+    // lock-free ring operations: false if full, resp. empty
+    bool ringPush(ElementT& element);
+    bool ringPop(ElementT& element);
+    // while lock is locked
+    bool spillPop(ElementT& element);
+    bool push_(ElementT&& element, bool block, bool trying);
+    template <typename Clock, typename Duration>
+    bool pop_(const std::chrono::time_point<Clock, Duration>* until, ElementT& element);
+    void notify();
+
+    std::unique_ptr<Cell[]> mRing;
+    size_t mMask;
+    size_t mCapacity;
+    size_t mSpillCapacity;
+    // keep the producers' and the consumers' ends on separate cache lines
+    alignas(64) std::atomic<size_t> mHead{ 0 };
+    alignas(64) std::atomic<size_t> mTail{ 0 };
+    alignas(64) std::atomic<size_t> mSpillSize{ 0 };
+    std::atomic<bool> mClosed{ false };
+    std::atomic<U32> mWaiters{ 0 };
+
+    boost::fibers::timed_mutex mLock;
+    typedef std::unique_lock<decltype(mLock)> lock_t;
+    boost::fibers::condition_variable_any mCond;
+    std::deque<ElementT> mSpill;            // protected by mLock
+};
+
+/*****************************************************************************
+*   LLLockFreeQueue implementation
+*****************************************************************************/
+template <typename ElementT>
+LLLockFreeQueue<ElementT>::LLLockFreeQueue(size_t capacity):
+    mCapacity(capacity)
+{
+    size_t ring = 2;
+    while (ring * 2 <= capacity && ring < MAX_RING)
+    {
+        ring *= 2;
+    }
+    mRing.reset(new Cell[ring]);
+    for (size_t i = 0; i < ring; ++i)
+    {
+        mRing[i].mSeq.store(i, std::memory_order_relaxed);
+    }
+    mMask = ring - 1;
+    mSpillCapacity = (capacity > ring)? capacity - ring : 0;
+}
+
+template <typename ElementT>
+bool LLLockFreeQueue<ElementT>::ringPush(ElementT& element)
+{
+    size_t pos = mHead.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Cell& cell = mRing[pos & mMask];
+        size_t seq = cell.mSeq.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos);
+        if (diff == 0)
+        {
+            if (mHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                cell.mValue = std::move(element);
+                cell.mSeq.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // the cell a whole lap behind us hasn't been popped yet: full
+            return false;
+        }
+        else
+        {
+            pos = mHead.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename ElementT>
+bool LLLockFreeQueue<ElementT>::ringPop(ElementT& element)
+{
+    size_t pos = mTail.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Cell& cell = mRing[pos & mMask];
+        size_t seq = cell.mSeq.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos + 1);
+        if (diff == 0)
+        {
+            if (mTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                element = std::move(cell.mValue);
+                // don't let the ring keep whatever the element holds alive
+                cell.mValue = ElementT();
+                cell.mSeq.store(pos + mMask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // nothing pushed here yet: empty
+            return false;
+        }
+        else
+        {
+            pos = mTail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename ElementT>
+bool LLLockFreeQueue<ElementT>::spillPop(ElementT& element)
+{
+    if (mSpill.empty())
+    {
+        return false;
+    }
+    element = std::move(mSpill.front());
+    mSpill.pop_front();
+    mSpillSize.store(mSpill.size(), std::memory_order_release);
+    return true;
+}
+
+template <typename ElementT>
+void LLLockFreeQueue<ElementT>::notify()
+{
+    // Pairs with the fence in pop_(): either a waiter sees what we just did,
+    // or we see it counted in mWaiters.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (mWaiters.load(std::memory_order_relaxed))
+    {
+        {
+            // Waiters check and start waiting with mLock held, so once we
+            // have it nobody's between the two. Like LLThreadSafeQueue,
+            // notify only after letting go.
+            lock_t lock(mLock);
+        }
+        mCond.notify_all();
+    }
+}
+
+template <typename ElementT>
+bool LLLockFreeQueue<ElementT>::push_(ElementT&& element, bool block, bool trying)
+{
+    if (isClosed())
+    {
+        return false;
+    }
+    // While anything is spilled, queue up behind it rather than jump ahead.
+    if (! mSpillSize.load(std::memory_order_acquire) && ringPush(element))
+    {
+        notify();
+        return true;
+    }
+
+    lock_t lock(mLock, std::defer_lock);
+    if (trying)
+    {
+        if (! lock.try_lock())
+            return false;
+    }
+    else
+    {
+        lock.lock();
+    }
+    for (;;)
+    {
+        if (isClosed())
+        {
+            return false;
+        }
+        // the ring may have drained while we waited for the lock
+        if (mSpill.empty() && ringPush(element))
+        {
+            break;
+        }
+        if (mSpill.size() < mSpillCapacity)
+        {
+            mSpill.push_back(std::move(element));
+            mSpillSize.store(mSpill.size(), std::memory_order_release);
+            break;
+        }
+        if (! block)
+        {
+            return false;
+        }
+        // full: wait for a pop to make room
+        mWaiters.fetch_add(1, std::memory_order_relaxed);
+        // pairs with the fence in notify()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // look again now that we're counted: any later pop will notify us
+        if (mSpill.empty() && ringPush(element))
+        {
+            mWaiters.fetch_sub(1, std::memory_order_relaxed);
+            break;
+        }
+        mCond.wait(lock);
+        mWaiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+    lock.unlock();
+    notify();
+    return true;
+}
+
+template <typename ElementT>
+template <typename T>
+void LLLockFreeQueue<ElementT>::push(T&& element)
+{
+    if (! pushIfOpen(std::forward<T>(element)))
+    {
+        LLTHROW(LLThreadSafeQueueInterrupt());
+    }
+}
+
+template <typename ElementT>
+template <typename T>
+bool LLLockFreeQueue<ElementT>::pushIfOpen(T&& element)
+{
+    return push_(ElementT(std::forward<T>(element)), true, false);
+}
+
+template <typename ElementT>
+template <typename T>
+bool LLLockFreeQueue<ElementT>::tryPush(T&& element)
+{
+    return push_(ElementT(std::forward<T>(element)), false, true);
+}
+
+template <typename ElementT>
+bool LLLockFreeQueue<ElementT>::tryPop(ElementT& element)
+{
+    if (ringPop(element))
+    {
+        if (! mSpillCapacity)
+        {
+            // with nowhere to spill, a full pusher waits on the ring itself
+            notify();
+        }
+        return true;
+    }
+    if (! mSpillSize.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+    lock_t lock(mLock, std::try_to_lock);
+    if (! (lock.owns_lock() && spillPop(element)))
+    {
+        return false;
+    }
+    lock.unlock();
+    // a full pusher may be waiting for this room
+    notify();
+    return true;
+}
+
+template <typename ElementT>
+template <typename Clock, typename Duration>
+bool LLLockFreeQueue<ElementT>::pop_(const std::chrono::time_point<Clock, Duration>* until,
+                                     ElementT& element)
+{
+    for (;;)
+    {
+        if (tryPop(element))
+        {
+            return true;
+        }
+        lock_t lock(mLock);
+        mWaiters.fetch_add(1, std::memory_order_relaxed);
+        // pairs with the fence in notify()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // look again now that we're counted: any later push will notify us
+        bool popped = ringPop(element) || spillPop(element);
+        if (! popped && ! isClosed())
+        {
+            if (! until)
+            {
+                mCond.wait(lock);
+            }
+            else if (mCond.wait_until(lock, *until) == boost::fibers::cv_status::timeout)
+            {
+                mWaiters.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+            mWaiters.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+        }
+        mWaiters.fetch_sub(1, std::memory_order_relaxed);
+        if (! popped)
+        {
+            // closed and drained
+            if (! until)
+            {
+                LLTHROW(LLThreadSafeQueueInterrupt());
+            }
+            return false;
+        }
+        lock.unlock();
+        notify();
+        return true;
+    }
+}
+
+template <typename ElementT>
+ElementT LLLockFreeQueue<ElementT>::pop()
+{
+    ElementT element;
+    pop_<std::chrono::steady_clock, std::chrono::steady_clock::duration>(nullptr, element);
+    return element;
+}
+
+template <typename ElementT>
+template <typename Rep, typename Period>
+bool LLLockFreeQueue<ElementT>::tryPopFor(const std::chrono::duration<Rep, Period>& timeout,
+                                          ElementT& element)
+{
+    // Convert duration to time_point: passing the same timeout duration to
+    // each of multiple calls is wrong.
+    return tryPopUntil(std::chrono::steady_clock::now() + timeout, element);
+}
+
+template <typename ElementT>
+template <typename Clock, typename Duration>
+bool LLLockFreeQueue<ElementT>::tryPopUntil(const std::chrono::time_point<Clock, Duration>& until,
+                                            ElementT& element)
+{
+    return pop_(&until, element);
+}
+
+template <typename ElementT>
+size_t LLLockFreeQueue<ElementT>::size() const
+{
+    size_t head = mHead.load(std::memory_order_relaxed);
+    size_t tail = mTail.load(std::memory_order_relaxed);
+    return ((head > tail)? head - tail : 0) + mSpillSize.load(std::memory_order_relaxed);
+}
+
+template <typename ElementT>
+void LLLockFreeQueue<ElementT>::close()
+{
+    {
+        lock_t lock(mLock);
+        mClosed.store(true, std::memory_order_release);
+    }
+    mCond.notify_all();
+}
+
+#endif /* ! defined(LL_LLLOCKFREEQUEUE_H) */
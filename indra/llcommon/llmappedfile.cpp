@@ -0,0 +1,234 @@
+/**
+ * @file llmappedfile.cpp
+ * @brief Cross-platform memory-mapped view of a file on disk.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llmappedfile.h"
+#include "llerror.h"
+#include "llstring.h"
+
+#if LL_WINDOWS
+#include "llwin32headers.h"
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+LLMappedFile::LLMappedFile()
+:   mData(nullptr),
+    mSize(0),
+    mReadOnly(true),
+#if LL_WINDOWS
+    mFile(INVALID_HANDLE_VALUE),
+    mMapping(nullptr)
+#else
+    mFD(-1)
+#endif
+{
+}
+
+LLMappedFile::~LLMappedFile()
+{
+    close();
+}
+
+#if LL_WINDOWS
+
+bool LLMappedFile::open(const std::string& filename, size_t size, bool read_only)
+{
+    close();
+    if (!size)
+    {
+        return false;
+    }
+
+    llutf16string utf16filename = utf8str_to_utf16str(filename);
+    DWORD access = read_only ? GENERIC_READ : GENERIC_READ | GENERIC_WRITE;
+    DWORD disposition = read_only ? OPEN_EXISTING : OPEN_ALWAYS;
+    // FILE_SHARE_DELETE so that purging the cache directory is not blocked
+    // by a view we have not released yet.
+    HANDLE file = CreateFileW((LPCWSTR)utf16filename.c_str(), access,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL, disposition, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        LL_WARNS() << "Could not open " << filename << " for mapping, error: " << GetLastError() << LL_ENDL;
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || (read_only && (size_t)file_size.QuadPart < size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // CreateFileMapping() extends a writable file to the mapping size.
+    LARGE_INTEGER map_size;
+    map_size.QuadPart = (LONGLONG)size;
+    HANDLE mapping = CreateFileMappingW(file, NULL, read_only ? PAGE_READONLY : PAGE_READWRITE,
+                                        map_size.HighPart, map_size.LowPart, NULL);
+    if (!mapping)
+    {
+        LL_WARNS() << "Could not create mapping for " << filename << ", error: " << GetLastError() << LL_ENDL;
+        CloseHandle(file);
+        return false;
+    }
+
+    void* data = MapViewOfFile(mapping, read_only ? FILE_MAP_READ : FILE_MAP_WRITE, 0, 0, size);
+    if (!data)
+    {
+        LL_WARNS() << "Could not map view of " << filename << ", error: " << GetLastError() << LL_ENDL;
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    mFile = file;
+    mMapping = mapping;
+    mData = (U8*)data;
+    mSize = size;
+    mReadOnly = read_only;
+    return true;
+}
+
+void LLMappedFile::close()
+{
+    if (mData)
+    {
+        if (!mReadOnly)
+        {
+            FlushViewOfFile(mData, 0);
+        }
+        UnmapViewOfFile(mData);
+        mData = nullptr;
+    }
+    if (mMapping)
+    {
+        CloseHandle((HANDLE)mMapping);
+        mMapping = nullptr;
+    }
+    if (mFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle((HANDLE)mFile);
+        mFile = INVALID_HANDLE_VALUE;
+    }
+    mSize = 0;
+    mReadOnly = true;
+}
+
+bool LLMappedFile::flush()
+{
+    if (!mData || mReadOnly)
+    {
+        return mData != nullptr;
+    }
+    return FlushViewOfFile(mData, 0) != 0;
+}
+
+#else // !LL_WINDOWS
+
+bool LLMappedFile::open(const std::string& filename, size_t size, bool read_only)
+{
+    close();
+    if (!size)
+    {
+        return false;
+    }
+
+    int fd = ::open(filename.c_str(), read_only ? O_RDONLY : O_RDWR | O_CREAT, 0600);
+    if (fd < 0)
+    {
+        LL_WARNS() << "Could not open " << filename << " for mapping, errno: " << errno << LL_ENDL;
+        return false;
+    }
+
+    struct stat file_status;
+    if (fstat(fd, &file_status) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    if ((size_t)file_status.st_size < size)
+    {
+        // Touching a page past the end of the file raises SIGBUS, so the
+        // whole view has to be backed before we hand it out.
+        if (read_only || ftruncate(fd, (off_t)size) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+    }
+
+    void* data = mmap(NULL, size, read_only ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        LL_WARNS() << "Could not map " << filename << ", errno: " << errno << LL_ENDL;
+        ::close(fd);
+        return false;
+    }
+
+    mFD = fd;
+    mData = (U8*)data;
+    mSize = size;
+    mReadOnly = read_only;
+    return true;
+}
+
+void LLMappedFile::close()
+{
+    if (mData)
+    {
+        if (!mReadOnly)
+        {
+            msync(mData, mSize, MS_ASYNC);
+        }
+        munmap(mData, mSize);
+        mData = nullptr;
+    }
+    if (mFD >= 0)
+    {
+        ::close(mFD);
+        mFD = -1;
+    }
+    mSize = 0;
+    mReadOnly = true;
+}
+
+bool LLMappedFile::flush()
+{
+    if (!mData || mReadOnly)
+    {
+        return mData != nullptr;
+    }
+    return msync(mData, mSize, MS_ASYNC) == 0;
+}
+
+#endif // !LL_WINDOWS
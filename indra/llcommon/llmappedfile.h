@@ -0,0 +1,78 @@
+/**
+ * @file llmappedfile.h
+ * @brief Cross-platform memory-mapped view of a file on disk.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLMAPPEDFILE_H
+#define LL_LLMAPPEDFILE_H
+
+#include <boost/noncopyable.hpp>
+#include <string>
+
+#include "stdtypes.h"
+
+/**
+ * LLMappedFile maps a fixed-size region at the start of a file into memory.
+ *
+ * A writable mapping grows the file to the requested size when it is
+ * shorter, so every byte of the view is backed by the file. The view is
+ * shared: stores land in the OS page cache and reach the disk on flush(),
+ * on close() or whenever the OS decides to write them back.
+ *
+ * The class does no locking of its own; callers that share a view between
+ * threads must serialize access to overlapping bytes.
+ */
+class LL_COMMON_API LLMappedFile : private boost::noncopyable
+{
+public:
+    LLMappedFile();
+    ~LLMappedFile();
+
+    // Maps the first 'size' bytes of the UTF8 path 'filename'. A writable
+    // mapping creates and extends the file as needed; a read only mapping
+    // fails when the file is shorter than 'size'.
+    bool open(const std::string& filename, size_t size, bool read_only = false);
+    void close();
+
+    // Schedules dirty pages for write back. Returns false on failure.
+    bool flush();
+
+    bool isOpen() const { return mData != nullptr; }
+    bool isReadOnly() const { return mReadOnly; }
+    U8* getData() const { return mData; }
+    size_t getSize() const { return mSize; }
+
+private:
+    U8*     mData;
+    size_t  mSize;
+    bool    mReadOnly;
+#if LL_WINDOWS
+    void*   mFile;      // HANDLE
+    void*   mMapping;   // HANDLE
+#else
+    int     mFD;
+#endif
+};
+
+#endif // LL_LLMAPPEDFILE_H
@@ -0,0 +1,118 @@
+/**
+ * @file   llparallel.cpp
+ * @date   2026-10-14
+ * @brief  Implementation for llparallel.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Copyright (c) 2026, Linden Research, Inc.
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "llparallel.h"
+// STL headers
+// std headers
+#include <chrono>
+#include <thread>
+// external library headers
+// other Linden headers
+#include "llerror.h"
+#include "threadpool.h"
+
+namespace
+{
+    LL::WorkStealingThreadPool* getComputePool()
+    {
+        static LL::WorkStealingThreadPool* sPool = []()
+        {
+            unsigned cores = std::max(std::thread::hardware_concurrency(), 2u);
+            // The pool closes and joins its threads on viewer shutdown. It's
+            // deliberately never destroyed: any static could still be
+            // running parallel work after that, which then runs inline.
+            auto pool = new LL::WorkStealingThreadPool("Compute", cores - 1);
+            pool->start();
+            LL_INFOS("ThreadPool") << "Compute pool has " << pool->getWidth() << " threads" << LL_ENDL;
+            return pool;
+        }();
+        return sPool;
+    }
+} // anonymous namespace
+
+LL::WorkStealingQueue* LL::getComputeQueue()
+{
+    auto pool = getComputePool();
+    return pool->getWidth()? &pool->getQueue() : nullptr;
+}
+
+size_t LL::getComputeWidth()
+{
+    return getComputePool()->getWidth();
+}
+
+LL::TaskGroup::TaskGroup():
+    mQueue(getComputeQueue())
+{
+}
+
+LL::TaskGroup::~TaskGroup()
+{
+    try
+    {
+        wait();
+    }
+    catch (...)
+    {
+        LOG_UNHANDLED_EXCEPTION("TaskGroup");
+    }
+}
+
+void LL::TaskGroup::wait()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_THREAD;
+    while (mPending.load(std::memory_order_acquire))
+    {
+        // Help rather than block: the next item may well be one of ours.
+        if (mQueue && mQueue->size())
+        {
+            mQueue->runOne();
+            continue;
+        }
+        // Whatever's left is running on other threads. Look again now and
+        // then in case one of them queues more work.
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait_for(lock, std::chrono::milliseconds(1),
+                       [this](){ return ! mPending.load(std::memory_order_acquire); });
+    }
+
+    std::exception_ptr exc;
+    {
+        // finish() holds mMutex while it notifies, so once we have it the
+        // last task is done touching this TaskGroup
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::swap(exc, mException);
+    }
+    if (exc)
+    {
+        std::rethrow_exception(exc);
+    }
+}
+
+void LL::TaskGroup::capture(std::exception_ptr exc)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (! mException)
+    {
+        mException = exc;
+    }
+}
+
+void LL::TaskGroup::finish()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        mDone.notify_all();
+    }
+}
@@ -0,0 +1,138 @@
+/**
+ * @file   llparallel.h
+ * @date   2026-10-14
+ * @brief  Fork/join helpers, TaskGroup and parallel_for, running on a shared
+ *         pool of compute threads.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Copyright (c) 2026, Linden Research, Inc.
+ * $/LicenseInfo$
+ */
+
+#if ! defined(LL_LLPARALLEL_H)
+#define LL_LLPARALLEL_H
+
+#include "workqueue.h"
+#include <algorithm>                // std::max
+#include <atomic>
+#include <condition_variable>
+#include <exception>                // std::exception_ptr
+#include <mutex>
+#include <utility>                  // std::forward
+
+namespace LL
+{
+    /**
+     * The queue of the "Compute" WorkStealingThreadPool, which TaskGroup and
+     * parallel_for use. It's launched on first use, one thread per core
+     * less one for the thread waiting on the work, unless "ThreadPoolSizes"
+     * says otherwise. Returns nullptr if the pool has no threads.
+     */
+    WorkStealingQueue* getComputeQueue();
+    /// how many threads the "Compute" pool has: 0 means work runs inline
+    size_t getComputeWidth();
+
+    /**
+     * TaskGroup runs any number of callables on the compute pool and lets
+     * you wait() for all of them. While waiting, the calling thread runs
+     * queued compute work itself rather than just blocking, so it's safe
+     * to wait on a TaskGroup from within a compute task.
+     *
+     * If the pool has no threads or has been closed, run() calls the
+     * callable inline.
+     */
+    class TaskGroup
+    {
+    public:
+        TaskGroup();
+        /// waits for any tasks still running, logging any exception
+        ~TaskGroup();
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        template <typename CALLABLE>
+        void run(CALLABLE&& callable)
+        {
+            WorkQueueBase::Work work{
+                [this, callable = std::forward<CALLABLE>(callable)]() mutable
+                {
+                    try
+                    {
+                        callable();
+                    }
+                    catch (...)
+                    {
+                        capture(std::current_exception());
+                    }
+                    finish();
+                } };
+            mPending.fetch_add(1, std::memory_order_relaxed);
+            if (! (mQueue && mQueue->post(work)))
+            {
+                work();
+            }
+        }
+
+        /**
+         * Return once every callable passed to run() has finished. If any
+         * of them threw, rethrow the first exception.
+         */
+        void wait();
+
+    private:
+        void capture(std::exception_ptr exc);
+        void finish();
+
+        WorkStealingQueue* mQueue;
+        std::atomic<size_t> mPending{ 0 };
+        std::mutex mMutex;
+        std::condition_variable mDone;
+        std::exception_ptr mException;
+    };
+
+    /**
+     * Call func(first, last) over consecutive subranges of [begin, end),
+     * spread across the compute pool, and return when they're all done. No
+     * subrange is shorter than grain, except possibly the last; pick grain
+     * so that one subrange is worth more than the cost of handing it to
+     * another thread. If func throws, parallel_for() rethrows the first
+     * exception once every subrange has finished.
+     */
+    template <typename INDEX, typename FUNC>
+    void parallel_for(INDEX begin, INDEX end, INDEX grain, FUNC&& func)
+    {
+        if (! (begin < end))
+        {
+            return;
+        }
+        size_t count = size_t(end - begin);
+        size_t step = std::max(size_t(grain), size_t(1));
+        size_t width = getComputeWidth();
+        // no point in cutting the range finer than a few pieces per thread
+        size_t max_pieces = (width + 1) * 4;
+        if ((count + step - 1) / step > max_pieces)
+        {
+            step = (count + max_pieces - 1) / max_pieces;
+        }
+        if (! width || step >= count)
+        {
+            func(begin, end);
+            return;
+        }
+
+        TaskGroup group;
+        // keep the first piece for this thread
+        INDEX mine = INDEX(begin + step);
+        for (INDEX first = mine; first < end; )
+        {
+            INDEX last = (size_t(end - first) > step)? INDEX(first + step) : end;
+            group.run([&func, first, last](){ func(first, last); });
+            first = last;
+        }
+        func(begin, mine);
+        group.wait();
+    }
+} // namespace LL
+
+#endif /* ! defined(LL_LLPARALLEL_H) */
@@ -34,9 +34,11 @@
 #include "llerror.h"
 #include "../llmath/llmath.h"
 #include "llformat.h"
+#include "llheap.h"
 #include "llsdserialize.h"
 #include "stringize.h"
 
+#include <atomic>
 #include <limits>
 
 // Defend against a caller forcibly passing a negative number into an unsigned
@@ -79,6 +81,148 @@ S32 sLLSDNetObjects = 0;
 #define ALLOC_LLSD_OBJECT           { llsd::sLLSDNetObjects++;  llsd::sLLSDAllocationCount++;   }
 #define FREE_LLSD_OBJECT            { llsd::sLLSDNetObjects--;                                  }
 
+namespace
+{
+    // The arena hands out memory from blocks aligned to their size, so the
+    // block of any allocation is found by masking its address. A block counts
+    // its live allocations, plus one while a thread is still carving it, and
+    // is freed when the count drops to zero.
+    constexpr size_t ARENA_BLOCK_SIZE = 64 * 1024;
+    constexpr size_t ARENA_ALIGNMENT = 16;
+
+    struct alignas(ARENA_ALIGNMENT) ArenaBlock
+    {
+        std::atomic<U32> mLive;
+    };
+
+    void* allocate_block()
+    {
+        return LLHeap::allocate(LLHeap::HEAP_LLSD, ARENA_BLOCK_SIZE, ARENA_BLOCK_SIZE);
+    }
+
+    void free_block(ArenaBlock* block)
+    {
+        block->~ArenaBlock();
+        LLHeap::free(LLHeap::HEAP_LLSD, block, ARENA_BLOCK_SIZE, ARENA_BLOCK_SIZE);
+    }
+
+    struct ArenaState
+    {
+        ArenaBlock* mBlock = nullptr;
+        size_t mOffset = 0;
+        U32 mScopes = 0;
+
+        ~ArenaState() { releaseBlock(); }
+
+        void releaseBlock()
+        {
+            if (mBlock && --mBlock->mLive == 0)
+            {
+                free_block(mBlock);
+            }
+            mBlock = nullptr;
+        }
+    };
+
+    thread_local ArenaState sArena;
+
+    bool arena_active()
+    {
+        return sArena.mScopes > 0;
+    }
+
+    void* arena_allocate(size_t size)
+    {
+        size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+        llassert_always(size <= ARENA_BLOCK_SIZE - sizeof(ArenaBlock));
+
+        ArenaState& arena = sArena;
+        if (!arena.mBlock || arena.mOffset + size > ARENA_BLOCK_SIZE)
+        {
+            arena.releaseBlock();
+            void* mem = allocate_block();
+            if (!mem)
+            {
+                LLError::LLUserWarningMsg::showOutOfMemory();
+                LL_ERRS() << "Failed to allocate an LLSD arena block" << LL_ENDL;
+            }
+            arena.mBlock = new (mem) ArenaBlock;
+            arena.mBlock->mLive = 1;
+            arena.mOffset = sizeof(ArenaBlock);
+        }
+
+        void* ret = reinterpret_cast<U8*>(arena.mBlock) + arena.mOffset;
+        arena.mOffset += size;
+        ++arena.mBlock->mLive;
+        return ret;
+    }
+
+    void arena_free(void* p)
+    {
+        ArenaBlock* block = reinterpret_cast<ArenaBlock*>(reinterpret_cast<uintptr_t>(p) & ~(uintptr_t)(ARENA_BLOCK_SIZE - 1));
+        if (--block->mLive == 0)
+        {
+            free_block(block);
+        }
+    }
+
+    // Allocator for the nodes of maps. Whether a map uses the arena is decided
+    // when it is created, so that all of its nodes come from the same place.
+    template<class T>
+    class ArenaAllocator
+    {
+    public:
+        typedef T value_type;
+        typedef std::false_type is_always_equal;
+
+        ArenaAllocator() : mArena(arena_active()) { }
+        template<class U>
+        ArenaAllocator(const ArenaAllocator<U>& other) : mArena(other.mArena) { }
+
+        // copies follow the scope they are made in, not their source
+        ArenaAllocator select_on_container_copy_construction() const { return ArenaAllocator(); }
+
+        T* allocate(size_t n)
+        {
+            if (mArena)
+            {
+                static_assert(alignof(T) <= ARENA_ALIGNMENT);
+                return static_cast<T*>(arena_allocate(n * sizeof(T)));
+            }
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T* p, size_t n)
+        {
+            if (mArena)
+            {
+                arena_free(p);
+            }
+            else
+            {
+                std::allocator<T>().deallocate(p, n);
+            }
+        }
+
+        template<class U>
+        bool operator==(const ArenaAllocator<U>& other) const { return mArena == other.mArena; }
+        template<class U>
+        bool operator!=(const ArenaAllocator<U>& other) const { return mArena != other.mArena; }
+
+        bool mArena;
+    };
+}
+
+LLSD::ArenaScope::ArenaScope()
+{
+    ++sArena.mScopes;
+}
+
+LLSD::ArenaScope::~ArenaScope()
+{
+    --sArena.mScopes;
+}
+
 class LLSD::Impl
     /**< This class is the abstract base class of the implementation of LLSD
          It provides the reference counting implementation, and the default
@@ -101,8 +245,18 @@ protected:
     bool shared() const                         { return (mUseCount > 1) && (mUseCount != STATIC_USAGE_COUNT); }
 
     U32 mUseCount;
+    bool mInArena;
 
 public:
+    LL_HEAP_OPERATORS(LLHeap::HEAP_LLSD)
+
+    template<class T, class... Args>
+    static T* create(Args&&... args);
+        ///< new T, from the arena when an LLSD::ArenaScope is open
+
+    static void destroy(Impl* impl);
+        ///< delete impl, wherever it came from
+
     static void reset(Impl*& var, Impl* impl);
         ///< safely set var to refer to the new impl (possibly shared)
 
@@ -188,6 +342,42 @@ public:
     static U32 sOutstandingCount;
 };
 
+template<class T, class... Args>
+T* LLSD::Impl::create(Args&&... args)
+{
+    if (!arena_active())
+    {
+        return new T(std::forward<Args>(args)...);
+    }
+
+    void* mem = arena_allocate(sizeof(T));
+    T* impl;
+    try
+    {
+        impl = new (mem) T(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        arena_free(mem);
+        throw;
+    }
+    impl->mInArena = true;
+    return impl;
+}
+
+void LLSD::Impl::destroy(Impl* impl)
+{
+    if (impl->mInArena)
+    {
+        impl->~Impl();
+        arena_free(impl);
+    }
+    else
+    {
+        delete impl;
+    }
+}
+
 #ifdef NAME_UNNAMED_NAMESPACE
 namespace LLSDUnnamedNamespace
 #else
@@ -346,6 +536,11 @@ namespace
     LLSD::Real ImplString::asReal() const
     {
         F64 v = 0.0;
+        if (ll_decimal_to_f64(mValue, v))
+        {
+            return v;
+        }
+
         std::istringstream i_stream(mValue);
         i_stream >> v;
 
@@ -431,10 +626,15 @@ namespace
     class ImplMap final : public LLSD::Impl
     {
     private:
-        typedef std::map<LLSD::String, LLSD, std::less<>> DataMap;
+        typedef std::map<LLSD::String, LLSD, std::less<>,
+                         ArenaAllocator<std::pair<const LLSD::String, LLSD>>> DataMap;
+        static_assert(std::is_same_v<DataMap::iterator, LLSD::map_iterator>,
+                      "LLSD::map_iterator must stay valid for the arena map");
 
         DataMap mData;
 
+        friend class LLSD::Impl;
+
     protected:
         ImplMap(const DataMap& data) : mData(data) { }
 
@@ -488,7 +688,7 @@ namespace
         LL_PROFILE_ZONE_SCOPED_CATEGORY_LLSD;
         if (shared())
         {
-            ImplMap* i = new ImplMap(mData);
+            ImplMap* i = create<ImplMap>(mData);
             Impl::assign(var, i);
             return *i;
         }
@@ -594,6 +794,8 @@ namespace
 
         DataVector mData;
 
+        friend class LLSD::Impl;
+
     protected:
         ImplArray(const DataVector& data) : mData(data) { }
 
@@ -644,7 +846,7 @@ namespace
     {
         if (shared())
         {
-            ImplArray* i = new ImplArray(mData);
+            ImplArray* i = create<ImplArray>(mData);
             Impl::assign(var, i);
             return *i;
         }
@@ -747,14 +949,14 @@ namespace
 }
 
 LLSD::Impl::Impl()
-    : mUseCount(0)
+    : mUseCount(0), mInArena(false)
 {
     ++sAllocationCount;
     ++sOutstandingCount;
 }
 
 LLSD::Impl::Impl(StaticAllocationMarker)
-    : mUseCount(0)
+    : mUseCount(0), mInArena(false)
 {
 }
 
@@ -771,7 +973,7 @@ void LLSD::Impl::reset(Impl*& var, Impl* impl)
     }
     if (var  &&  var->mUseCount != STATIC_USAGE_COUNT && --var->mUseCount == 0)
     {
-        delete var;
+        destroy(var);
     }
     var = impl;
 }
@@ -780,7 +982,7 @@ void LLSD::Impl::move(Impl*& var, Impl*& impl)
 {
     if (var && var->mUseCount != STATIC_USAGE_COUNT && --var->mUseCount == 0)
     {
-        delete var; // destroy var if usage falls to 0 and not static
+        destroy(var); // destroy var if usage falls to 0 and not static
     }
     var = impl; // Steal impl to var without incrementing use since this is a move
     impl = nullptr; // null out old-impl pointer
@@ -801,14 +1003,14 @@ const LLSD::Impl& LLSD::Impl::safe(const Impl* impl)
 ImplMap& LLSD::Impl::makeMap(Impl*& var)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_LLSD;
-    ImplMap* im = new ImplMap;
+    ImplMap* im = create<ImplMap>();
     reset(var, im);
     return *im;
 }
 
 ImplArray& LLSD::Impl::makeArray(Impl*& var)
 {
-    ImplArray* ia = new ImplArray;
+    ImplArray* ia = create<ImplArray>();
     reset(var, ia);
     return *ia;
 }
@@ -826,72 +1028,72 @@ void LLSD::Impl::assignUndefined(Impl*& var)
 
 void LLSD::Impl::assign(Impl*& var, LLSD::Boolean v)
 {
-    reset(var, new ImplBoolean(v));
+    reset(var, create<ImplBoolean>(v));
 }
 
 void LLSD::Impl::assign(Impl*& var, LLSD::Integer v)
 {
-    reset(var, new ImplInteger(v));
+    reset(var, create<ImplInteger>(v));
 }
 
 void LLSD::Impl::assign(Impl*& var, LLSD::Real v)
 {
-    reset(var, new ImplReal(v));
+    reset(var, create<ImplReal>(v));
 }
 
 void LLSD::Impl::assign(Impl*& var, const char* v)
 {
-    reset(var, new ImplString(v));
+    reset(var, create<ImplString>(v));
 }
 
 void LLSD::Impl::assign(Impl*& var, const LLSD::String& v)
 {
-    reset(var, new ImplString(v));
+    reset(var, create<ImplString>(v));
 }
 
 void LLSD::Impl::assign(Impl*& var, const LLSD::UUID& v)
 {
-    reset(var, new ImplUUID(v));
+    reset(var, create<ImplUUID>(v));
 }
 
 void LLSD::Impl::assign(Impl*& var, const LLSD::Date& v)
 {
-    reset(var, new ImplDate(v));
+    reset(var, create<ImplDate>(v));
 }
 
 void LLSD::Impl::assign(Impl*& var, const LLSD::URI& v)
 {
-    reset(var, new ImplURI(v));
+    reset(var, create<ImplURI>(v));
 }
 
 void LLSD::Impl::assign(Impl*& var, const LLSD::Binary& v)
 {
-    reset(var, new ImplBinary(v));
+    reset(var, create<ImplBinary>(v));
 }
 
 void LLSD::Impl::assign(Impl*& var, LLSD::String&& v)
 {
-    reset(var, new ImplString(std::move(v)));
+    reset(var, create<ImplString>(std::move(v)));
 }
 
 void LLSD::Impl::assign(Impl*& var, LLSD::UUID&& v)
 {
-    reset(var, new ImplUUID(std::move(v)));
+    reset(var, create<ImplUUID>(std::move(v)));
 }
 
 void LLSD::Impl::assign(Impl*& var, LLSD::Date&& v)
 {
-    reset(var, new ImplDate(std::move(v)));
+    reset(var, create<ImplDate>(std::move(v)));
 }
 
 void LLSD::Impl::assign(Impl*& var, LLSD::URI&& v)
 {
-    reset(var, new ImplURI(std::move(v)));
+    reset(var, create<ImplURI>(std::move(v)));
 }
 
 void LLSD::Impl::assign(Impl*& var, LLSD::Binary&& v)
 {
-    reset(var, new ImplBinary(std::move(v)));
+    reset(var, create<ImplBinary>(std::move(v)));
 }
 
 
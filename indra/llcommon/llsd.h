@@ -423,6 +423,30 @@ public:
         bool isEmpty() const;
     //@}
 
+    /** @name Arena Allocation
+        While an ArenaScope is open on a thread, the values created on that
+        thread, and the nodes of their maps, are carved from shared 64KB
+        blocks instead of being allocated one at a time, which is most of the
+        cost of parsing a large reply. They behave like any other LLSD, may be
+        copied, modified and freed on any thread, and a block goes back to the
+        heap once the last value in it is gone, so keep values that outlive
+        the parse few or copy them out.
+
+        Scopes nest. Don't keep one open across a coroutine suspension, the
+        values other coroutines create meanwhile would land in the arena.
+     */
+    //@{
+        class LL_COMMON_API ArenaScope
+        {
+        public:
+            ArenaScope();
+            ~ArenaScope();
+
+            ArenaScope(const ArenaScope&) = delete;
+            ArenaScope& operator=(const ArenaScope&) = delete;
+        };
+    //@}
+
     /** @name Automatic Cast Protection
         These are not implemented on purpose.  Without them, C++ can perform
         some conversions that are clearly not what the programmer intended.
@@ -31,7 +31,14 @@
 #include "llpointer.h"
 #include "llstreamtools.h" // for fullread
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include <iostream>
+#include <optional>
 #include "apr_base64.h"
 
 #include <boost/iostreams/device/array.hpp>
@@ -379,7 +386,7 @@ static const char BINARY_FALSE_SERIAL = '0';
  * LLSDParser
  */
 LLSDParser::LLSDParser()
-    : mCheckLimits(true), mMaxBytesLeft(0), mParseLines(false)
+    : mCheckLimits(true), mMaxBytesLeft(0), mParseLines(false), mUseArena(false), mVisitor(NULL)
 {
 }
 
@@ -391,6 +398,11 @@ S32 LLSDParser::parse(std::istream& istr, LLSD& data, llssize max_bytes, S32 max
 {
     mCheckLimits = LLSDSerialize::SIZE_UNLIMITED != max_bytes;
     mMaxBytesLeft = max_bytes;
+    std::optional<LLSD::ArenaScope> arena;
+    if (mUseArena)
+    {
+        arena.emplace();
+    }
     return doParse(istr, data, max_depth);
 }
 
@@ -400,9 +412,113 @@ S32 LLSDParser::parseLines(std::istream& istr, LLSD& data)
 {
     mCheckLimits = false;
     mParseLines = true;
+    std::optional<LLSD::ArenaScope> arena;
+    if (mUseArena)
+    {
+        arena.emplace();
+    }
     return doParse(istr, data);
 }
 
+S32 LLSDParser::parseBuffer(const char* buf, size_t len, LLSD& data, S32 max_depth)
+{
+    mCheckLimits = true;
+    mMaxBytesLeft = len;
+    std::optional<LLSD::ArenaScope> arena;
+    if (mUseArena)
+    {
+        arena.emplace();
+    }
+    return doParseBuffer(buf, len, data, max_depth);
+}
+
+// virtual
+S32 LLSDParser::doParseBuffer(const char* buf, size_t len, LLSD& data, S32 max_depth) const
+{
+    LLMemoryStream istr((const U8*)buf, (S32)len);
+    return doParse(istr, data, max_depth);
+}
+
+S32 LLSDParser::visit(std::istream& istr, LLSDVisitor& visitor, llssize max_bytes, S32 max_depth)
+{
+    // the parsers still fill in scalars and empty containers as they go,
+    // they just don't keep them
+    LLSD scratch;
+    mVisitor = &visitor;
+    S32 count = parse(istr, scratch, max_bytes, max_depth);
+    mVisitor = NULL;
+    return count;
+}
+
+S32 LLSDParser::visitBuffer(const char* buf, size_t len, LLSDVisitor& visitor, S32 max_depth)
+{
+    LLSD scratch;
+    mVisitor = &visitor;
+    S32 count = parseBuffer(buf, len, scratch, max_depth);
+    mVisitor = NULL;
+    return count;
+}
+
+/**
+ * LLSDTreeBuilder
+ */
+LLSD& LLSDTreeBuilder::slot()
+{
+    if (mStack.empty())
+    {
+        mHasValue = true;
+        return mRoot;
+    }
+    LLSD& container = *mStack.back();
+    if (container.isMap())
+    {
+        return container[mKey];
+    }
+    return container.append(LLSD());
+}
+
+void LLSDTreeBuilder::beginMap()
+{
+    LLSD& map = slot();
+    map = LLSD::emptyMap();
+    mStack.push_back(&map);
+}
+
+void LLSDTreeBuilder::key(const std::string& name)
+{
+    mKey = name;
+}
+
+void LLSDTreeBuilder::endMap()
+{
+    mStack.pop_back();
+}
+
+void LLSDTreeBuilder::beginArray()
+{
+    LLSD& array = slot();
+    array = LLSD::emptyArray();
+    mStack.push_back(&array);
+}
+
+void LLSDTreeBuilder::endArray()
+{
+    mStack.pop_back();
+}
+
+void LLSDTreeBuilder::value(const LLSD& value)
+{
+    slot() = value;
+}
+
+void LLSDTreeBuilder::clear()
+{
+    mRoot.clear();
+    mStack.clear();
+    mKey.clear();
+    mHasValue = false;
+}
+
 
 int LLSDParser::get(std::istream& istr) const
 {
@@ -730,6 +846,10 @@ S32 LLSDNotationParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) c
     {
         data.clear();
     }
+    else if (mVisitor && parse_count > 0 && c != '{' && c != '[')
+    {
+        mVisitor->value(data);
+    }
     return parse_count;
 }
 
@@ -742,6 +862,10 @@ S32 LLSDNotationParser::parseMap(std::istream& istr, LLSD& map, S32 max_depth) c
     char c = get(istr);
     if(c == '{')
     {
+        if (mVisitor)
+        {
+            mVisitor->beginMap();
+        }
         // eat commas, white
         bool found_name = false;
         std::string name;
@@ -768,6 +892,10 @@ S32 LLSDNotationParser::parseMap(std::istream& istr, LLSD& map, S32 max_depth) c
                     continue;
                 }
                 putback(istr, c);
+                if (mVisitor)
+                {
+                    mVisitor->key(name);
+                }
                 LLSD child;
                 S32 count = doParse(istr, child, max_depth);
                 if(count > 0)
@@ -775,7 +903,10 @@ S32 LLSDNotationParser::parseMap(std::istream& istr, LLSD& map, S32 max_depth) c
                     // There must be a value for every key, thus
                     // child_count must be greater than 0.
                     parse_count += count;
-                    map.insert(name, child);
+                    if (!mVisitor)
+                    {
+                        map.insert(name, child);
+                    }
                 }
                 else
                 {
@@ -790,6 +921,10 @@ S32 LLSDNotationParser::parseMap(std::istream& istr, LLSD& map, S32 max_depth) c
             map.clear();
             return PARSE_FAILURE;
         }
+        if (mVisitor)
+        {
+            mVisitor->endMap();
+        }
     }
     return parse_count;
 }
@@ -803,6 +938,10 @@ S32 LLSDNotationParser::parseArray(std::istream& istr, LLSD& array, S32 max_dept
     char c = get(istr);
     if(c == '[')
     {
+        if (mVisitor)
+        {
+            mVisitor->beginArray();
+        }
         // eat commas, white
         c = get(istr);
         while((c != ']') && istr.good())
@@ -822,7 +961,10 @@ S32 LLSDNotationParser::parseArray(std::istream& istr, LLSD& array, S32 max_dept
             else
             {
                 parse_count += count;
-                array.append(child);
+                if (!mVisitor)
+                {
+                    array.append(child);
+                }
             }
             c = get(istr);
         }
@@ -830,6 +972,10 @@ S32 LLSDNotationParser::parseArray(std::istream& istr, LLSD& array, S32 max_dept
         {
             return PARSE_FAILURE;
         }
+        if (mVisitor)
+        {
+            mVisitor->endArray();
+        }
     }
     return parse_count;
 }
@@ -934,6 +1080,685 @@ bool LLSDNotationParser::parseBinary(std::istream& istr, LLSD& data) const
     return true;
 }
 
+namespace
+{
+    // first 'a' or 'b' in [begin, end), end if there is none
+    const char* find_either(const char* begin, const char* end, char a, char b)
+    {
+#if defined(__SSE2__) || defined(_M_X64)
+        const __m128i va = _mm_set1_epi8(a);
+        const __m128i vb = _mm_set1_epi8(b);
+        for (; end - begin >= 16; begin += 16)
+        {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)begin);
+            int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb)));
+            if (mask)
+            {
+#if LL_MSVC
+                unsigned long bit;
+                _BitScanForward(&bit, mask);
+                return begin + bit;
+#else
+                return begin + __builtin_ctz(mask);
+#endif
+            }
+        }
+#elif defined(__ARM_NEON)
+        const uint8x16_t va = vdupq_n_u8((U8)a);
+        const uint8x16_t vb = vdupq_n_u8((U8)b);
+        for (; end - begin >= 16; begin += 16)
+        {
+            uint8x16_t chunk = vld1q_u8((const U8*)begin);
+            if (vmaxvq_u8(vorrq_u8(vceqq_u8(chunk, va), vceqq_u8(chunk, vb))))
+            {
+                break;
+            }
+        }
+#endif
+        for (; begin < end; ++begin)
+        {
+            if (*begin == a || *begin == b)
+            {
+                break;
+            }
+        }
+        return begin;
+    }
+
+    /**
+     * Notation parser working on a buffer. Every case is LLSDNotationParser's
+     * over again, without a stream and with quoted strings copied in runs.
+     */
+    class LLSDNotationBufferParser
+    {
+    public:
+        LLSDNotationBufferParser(const char* buf, size_t len, LLSDVisitor* visitor)
+            : mPos(buf), mEnd(buf + len), mVisitor(visitor)
+        {
+        }
+
+        S32 parse(LLSD& data, S32 max_depth);
+
+    private:
+        // next character, -1 at the end, like std::istream::get()
+        int get() { return mPos < mEnd ? (U8)*mPos++ : -1; }
+        int peek() const { return mPos < mEnd ? (U8)*mPos : -1; }
+        size_t left() const { return mEnd - mPos; }
+
+        S32 parseMap(LLSD& map, S32 max_depth);
+        S32 parseArray(LLSD& array, S32 max_depth);
+        bool parseBoolean(LLSD& data, const std::string& compare, bool value);
+        bool parseInteger(LLSD& data);
+        bool parseReal(LLSD& data);
+        bool parseUUID(LLSD& data);
+        bool parseBinary(LLSD& data);
+
+        // deserialize_string() and friends
+        bool parseString(std::string& value);
+        bool parseDelimited(std::string& value, int delim);
+        bool parseRaw(std::string& value);
+
+        // std::istream::get(buf, size, delim) for the short headers of raw
+        // strings and binaries, false if nothing was read
+        bool getUntil(char delim, size_t max_len, std::string_view& out);
+
+        const char* mPos;
+        const char* mEnd;
+        LLSDVisitor* mVisitor;
+    };
+
+    S32 LLSDNotationBufferParser::parse(LLSD& data, S32 max_depth)
+    {
+        if (max_depth == 0)
+        {
+            return LLSDParser::PARSE_FAILURE;
+        }
+        while (mPos < mEnd && isspace((U8)*mPos))
+        {
+            ++mPos;
+        }
+        if (mPos >= mEnd)
+        {
+            return 0;
+        }
+        S32 parse_count = 1;
+        int c = *mPos;
+        switch (c)
+        {
+        case '{':
+        {
+            S32 child_count = parseMap(data, max_depth - 1);
+            if ((child_count == LLSDParser::PARSE_FAILURE) || data.isUndefined())
+            {
+                parse_count = LLSDParser::PARSE_FAILURE;
+            }
+            else
+            {
+                parse_count += child_count;
+            }
+            break;
+        }
+
+        case '[':
+        {
+            S32 child_count = parseArray(data, max_depth - 1);
+            if ((child_count == LLSDParser::PARSE_FAILURE) || data.isUndefined())
+            {
+                parse_count = LLSDParser::PARSE_FAILURE;
+            }
+            else
+            {
+                parse_count += child_count;
+            }
+            break;
+        }
+
+        case '!':
+            ++mPos;
+            data.clear();
+            break;
+
+        case '0':
+            ++mPos;
+            data = false;
+            break;
+
+        case 'F':
+        case 'f':
+            ++mPos;
+            if (isalpha(peek()))
+            {
+                if (!parseBoolean(data, NOTATION_FALSE_SERIAL, false))
+                {
+                    parse_count = LLSDParser::PARSE_FAILURE;
+                }
+            }
+            else
+            {
+                data = false;
+            }
+            break;
+
+        case '1':
+            ++mPos;
+            data = true;
+            break;
+
+        case 'T':
+        case 't':
+            ++mPos;
+            if (isalpha(peek()))
+            {
+                if (!parseBoolean(data, NOTATION_TRUE_SERIAL, true))
+                {
+                    parse_count = LLSDParser::PARSE_FAILURE;
+                }
+            }
+            else
+            {
+                data = true;
+            }
+            break;
+
+        case 'i':
+            ++mPos;
+            if (!parseInteger(data))
+            {
+                LL_INFOS() << "STREAM FAILURE reading integer." << LL_ENDL;
+                parse_count = LLSDParser::PARSE_FAILURE;
+            }
+            break;
+
+        case 'r':
+            ++mPos;
+            if (!parseReal(data))
+            {
+                LL_INFOS() << "STREAM FAILURE reading real." << LL_ENDL;
+                parse_count = LLSDParser::PARSE_FAILURE;
+            }
+            break;
+
+        case 'u':
+            ++mPos;
+            if (!parseUUID(data))
+            {
+                LL_INFOS() << "STREAM FAILURE reading uuid." << LL_ENDL;
+                parse_count = LLSDParser::PARSE_FAILURE;
+            }
+            break;
+
+        case '\"':
+        case '\'':
+        case 's':
+        {
+            std::string value;
+            if (parseString(value))
+            {
+                data = std::move(value);
+            }
+            else
+            {
+                parse_count = LLSDParser::PARSE_FAILURE;
+            }
+            break;
+        }
+
+        case 'l':
+        case 'd':
+        {
+            ++mPos; // pop the 'l' or 'd'
+            int delim = get();
+            std::string str;
+            if (!parseDelimited(str, delim))
+            {
+                parse_count = LLSDParser::PARSE_FAILURE;
+            }
+            else if (c == 'l')
+            {
+                data = LLURI(str);
+            }
+            else
+            {
+                data = LLDate(str);
+            }
+            break;
+        }
+
+        case 'b':
+            if (!parseBinary(data))
+            {
+                parse_count = LLSDParser::PARSE_FAILURE;
+            }
+            break;
+
+        default:
+            parse_count = LLSDParser::PARSE_FAILURE;
+            LL_INFOS() << "Unrecognized character while parsing: int(" << int((char)c)
+                << ")" << LL_ENDL;
+            break;
+        }
+        if (LLSDParser::PARSE_FAILURE == parse_count)
+        {
+            data.clear();
+        }
+        else if (mVisitor && c != '{' && c != '[')
+        {
+            mVisitor->value(data);
+        }
+        return parse_count;
+    }
+
+    S32 LLSDNotationBufferParser::parseMap(LLSD& map, S32 max_depth)
+    {
+        // map: { string:object, string:object }
+        map = LLSD::emptyMap();
+        S32 parse_count = 0;
+        int c = get(); // the '{'
+        if (mVisitor)
+        {
+            mVisitor->beginMap();
+        }
+        bool found_name = false;
+        std::string name;
+        c = get();
+        while (c != '}' && c != -1)
+        {
+            if (!found_name)
+            {
+                if ((c == '\"') || (c == '\'') || (c == 's'))
+                {
+                    --mPos;
+                    found_name = true;
+                    if (!parseString(name))
+                    {
+                        return LLSDParser::PARSE_FAILURE;
+                    }
+                }
+                c = get();
+            }
+            else
+            {
+                if (isspace(c) || (c == ':'))
+                {
+                    c = get();
+                    continue;
+                }
+                --mPos;
+                if (mVisitor)
+                {
+                    mVisitor->key(name);
+                }
+                // like LLSD::insert(), the first of duplicate keys wins
+                LLSD child;
+                LLSD& slot = (mVisitor || map.has(name)) ? child : map[name];
+                S32 count = parse(slot, max_depth);
+                if (count > 0)
+                {
+                    // There must be a value for every key, thus
+                    // child_count must be greater than 0.
+                    parse_count += count;
+                }
+                else
+                {
+                    return LLSDParser::PARSE_FAILURE;
+                }
+                found_name = false;
+                c = get();
+            }
+        }
+        if (c != '}')
+        {
+            map.clear();
+            return LLSDParser::PARSE_FAILURE;
+        }
+        if (mVisitor)
+        {
+            mVisitor->endMap();
+        }
+        return parse_count;
+    }
+
+    S32 LLSDNotationBufferParser::parseArray(LLSD& array, S32 max_depth)
+    {
+        // array: [ object, object, object ]
+        array = LLSD::emptyArray();
+        S32 parse_count = 0;
+        int c = get(); // the '['
+        if (mVisitor)
+        {
+            mVisitor->beginArray();
+        }
+        c = get();
+        while ((c != ']') && c != -1)
+        {
+            if (isspace(c) || (c == ','))
+            {
+                c = get();
+                continue;
+            }
+            --mPos;
+            LLSD child;
+            S32 count = parse(mVisitor ? child : array.append(LLSD()), max_depth);
+            if (LLSDParser::PARSE_FAILURE == count)
+            {
+                return LLSDParser::PARSE_FAILURE;
+            }
+            parse_count += count;
+            c = get();
+        }
+        if (c != ']')
+        {
+            return LLSDParser::PARSE_FAILURE;
+        }
+        if (mVisitor)
+        {
+            mVisitor->endArray();
+        }
+        return parse_count;
+    }
+
+    bool LLSDNotationBufferParser::parseBoolean(LLSD& data, const std::string& compare, bool value)
+    {
+        // the first character has been consumed, see deserialize_boolean()
+        std::string::size_type ii = 0;
+        while ((++ii < compare.size()) && (tolower(peek()) == (int)compare[ii]))
+        {
+            ++mPos;
+        }
+        if (compare.size() != ii)
+        {
+            data.clear();
+            return false;
+        }
+        data = value;
+        return true;
+    }
+
+    bool LLSDNotationBufferParser::parseInteger(LLSD& data)
+    {
+        // std::istream >> S32 skips white space, takes a sign and fails
+        // without digits or on overflow
+        while (mPos < mEnd && isspace((U8)*mPos))
+        {
+            ++mPos;
+        }
+        bool negative = false;
+        if (mPos < mEnd && (*mPos == '-' || *mPos == '+'))
+        {
+            negative = (*mPos == '-');
+            ++mPos;
+        }
+        if (mPos >= mEnd || !isdigit((U8)*mPos))
+        {
+            return false;
+        }
+        U64 value = 0;
+        bool overflow = false;
+        for (; mPos < mEnd && isdigit((U8)*mPos); ++mPos)
+        {
+            value = value * 10 + (*mPos - '0');
+            overflow = overflow || value > 0x80000000ULL;
+        }
+        if (overflow || value > (negative ? 0x80000000ULL : 0x7fffffffULL))
+        {
+            return false;
+        }
+        data = (S32)(negative ? -(S64)value : (S64)value);
+        return true;
+    }
+
+    bool LLSDNotationBufferParser::parseReal(LLSD& data)
+    {
+        while (mPos < mEnd && isspace((U8)*mPos))
+        {
+            ++mPos;
+        }
+        // the characters std::istream >> F64 could take
+        const char* start = mPos;
+        const char* stop = start;
+        while (stop < mEnd && (isdigit((U8)*stop) || *stop == '.' || *stop == '-' || *stop == '+'
+                               || *stop == 'e' || *stop == 'E'))
+        {
+            ++stop;
+        }
+        F64 real = 0.0;
+        if (ll_decimal_to_f64(std::string_view(start, stop - start), real))
+        {
+            mPos = stop;
+        }
+        else
+        {
+            std::istringstream istr(std::string(start, stop - start));
+            istr >> real;
+            if (istr.fail())
+            {
+                return false;
+            }
+            std::streamoff consumed = istr.eof() ? (std::streamoff)(stop - start) : (std::streamoff)istr.tellg();
+            mPos = start + consumed;
+        }
+        data = real;
+        return true;
+    }
+
+    bool LLSDNotationBufferParser::parseUUID(LLSD& data)
+    {
+        // operator>>(std::istream&, LLUUID&) reads characters one by one,
+        // skipping white space
+        char uuid_str[UUID_STR_LENGTH];
+        for (U32 i = 0; i < UUID_STR_LENGTH - 1; i++)
+        {
+            while (mPos < mEnd && isspace((U8)*mPos))
+            {
+                ++mPos;
+            }
+            if (mPos >= mEnd)
+            {
+                return false;
+            }
+            uuid_str[i] = *mPos++;
+        }
+        uuid_str[UUID_STR_LENGTH - 1] = '\0';
+        LLUUID id;
+        id.set(std::string(uuid_str));
+        data = id;
+        return true;
+    }
+
+    bool LLSDNotationBufferParser::parseString(std::string& value)
+    {
+        int c = get();
+        switch (c)
+        {
+        case '\'':
+        case '"':
+            return parseDelimited(value, c);
+        case 's':
+            return parseRaw(value);
+        default:
+            return false;
+        }
+    }
+
+    bool LLSDNotationBufferParser::parseDelimited(std::string& value, int delim)
+    {
+        value.clear();
+        if (delim < 0)
+        {
+            return false;
+        }
+        while (true)
+        {
+            const char* run = find_either(mPos, mEnd, (char)delim, '\\');
+            value.append(mPos, run);
+            mPos = run;
+            int c = get();
+            if (c < 0)
+            {
+                return false;
+            }
+            if (c != '\\')
+            {
+                return true; // the delimiter
+            }
+
+            // escape: see deserialize_string_delim()
+            c = get();
+            if (c < 0)
+            {
+                return false;
+            }
+            switch (c)
+            {
+            case 'x':
+            {
+                int high = get();
+                int low = get();
+                if (low < 0)
+                {
+                    return false;
+                }
+                value += (char)((hex_as_nybble((char)high) << 4) | hex_as_nybble((char)low));
+                break;
+            }
+            case 'a': value += '\a'; break;
+            case 'b': value += '\b'; break;
+            case 'f': value += '\f'; break;
+            case 'n': value += '\n'; break;
+            case 'r': value += '\r'; break;
+            case 't': value += '\t'; break;
+            case 'v': value += '\v'; break;
+            default:  value += (char)c; break;
+            }
+        }
+    }
+
+    bool LLSDNotationBufferParser::getUntil(char delim, size_t max_len, std::string_view& out)
+    {
+        const char* stop = mPos;
+        while (stop < mEnd && (size_t)(stop - mPos) < max_len && *stop != delim)
+        {
+            ++stop;
+        }
+        if (stop == mPos)
+        {
+            return false;
+        }
+        out = std::string_view(mPos, stop - mPos);
+        mPos = stop;
+        return true;
+    }
+
+    bool LLSDNotationBufferParser::parseRaw(std::string& value)
+    {
+        // s(len)"raw data", see deserialize_string_raw()
+        std::string_view header;
+        if (!getUntil(')', 18, header))
+        {
+            return false;
+        }
+        get(); // the ')'
+        int c = get();
+        if (!((c == '"') || (c == '\'')) || header[0] != '(')
+        {
+            return false;
+        }
+        auto len = strtol(std::string(header.substr(1)).c_str(), NULL, 0);
+        if (len < 0 || (size_t)len > left())
+        {
+            return false;
+        }
+        value.assign(mPos, len);
+        mPos += len;
+        c = get();
+        return (c == '"') || (c == '\'');
+    }
+
+    bool LLSDNotationBufferParser::parseBinary(LLSD& data)
+    {
+        // binary: b##"ff3120ab1"
+        // or: b(len)"..."
+        // see LLSDNotationParser::parseBinary()
+        std::string_view header;
+        if (!getUntil('"', 254, header) || get() != '"')
+        {
+            return false;
+        }
+        if (0 == header.compare(0, 2, "b("))
+        {
+            auto len = strtol(std::string(header.substr(2)).c_str(), NULL, 0);
+            if (len < 0 || (size_t)len > left())
+            {
+                return false;
+            }
+            std::vector<U8> value(mPos, mPos + len);
+            mPos += len;
+            // strip off the trailing double-quote
+            if (get() < 0)
+            {
+                LL_INFOS() << "STREAM FAILURE reading data." << LL_ENDL;
+                return false;
+            }
+            data = std::move(value);
+        }
+        else if (0 == header.compare(0, 3, "b64"))
+        {
+            const char* stop = find_either(mPos, mEnd, '"', '"');
+            if (stop == mPos || stop == mEnd)
+            {
+                LL_INFOS() << "STREAM FAILURE reading data." << LL_ENDL;
+                return false;
+            }
+            std::string encoded(mPos, stop);
+            mPos = stop + 1;
+            S32 len = apr_base64_decode_len(encoded.c_str());
+            std::vector<U8> value;
+            if (len)
+            {
+                value.resize(len);
+                len = apr_base64_decode_binary(&value[0], encoded.c_str());
+                value.resize(len);
+            }
+            data = std::move(value);
+        }
+        else if (0 == header.compare(0, 3, "b16"))
+        {
+            const char* stop = find_either(mPos, mEnd, '"', '"');
+            if (stop == mEnd)
+            {
+                LL_INFOS() << "STREAM FAILURE reading data." << LL_ENDL;
+                return false;
+            }
+            std::vector<U8> value;
+            value.reserve((stop - mPos + 1) / 2);
+            for (const char* read = mPos; read < stop; read += 2)
+            {
+                U8 byte = hex_as_nybble(*read) << 4;
+                if (read + 1 < stop)
+                {
+                    byte |= hex_as_nybble(read[1]);
+                }
+                value.push_back(byte);
+            }
+            mPos = stop + 1;
+            data = std::move(value);
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+}
+
+// virtual
+S32 LLSDNotationParser::doParseBuffer(const char* buf, size_t len, LLSD& data, S32 max_depth) const
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_LLSD;
+    LLSDNotationBufferParser parser(buf, len, mVisitor);
+    return parser.parse(data, max_depth);
+}
+
 
 /**
  * LLSDBinaryParser
@@ -1179,6 +2004,10 @@ S32 LLSDBinaryParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) con
     {
         data.clear();
     }
+    else if (mVisitor && parse_count > 0 && c != '{' && c != '[')
+    {
+        mVisitor->value(data);
+    }
     return parse_count;
 }
 
@@ -1190,6 +2019,10 @@ S32 LLSDBinaryParser::parseMap(std::istream& istr, LLSD& map, S32 max_depth) con
     S32 size = (S32)ntohl(value_nbo);
     S32 parse_count = 0;
     S32 count = 0;
+    if (mVisitor)
+    {
+        mVisitor->beginMap();
+    }
     char c = get(istr);
     while(c != '}' && (count < size) && istr.good())
     {
@@ -1211,6 +2044,10 @@ S32 LLSDBinaryParser::parseMap(std::istream& istr, LLSD& map, S32 max_depth) con
             break;
         }
         }
+        if (mVisitor)
+        {
+            mVisitor->key(name);
+        }
         LLSD child;
         S32 child_count = doParse(istr, child, max_depth);
         if(child_count > 0)
@@ -1218,7 +2055,10 @@ S32 LLSDBinaryParser::parseMap(std::istream& istr, LLSD& map, S32 max_depth) con
             // There must be a value for every key, thus child_count
             // must be greater than 0.
             parse_count += child_count;
-            map.insert(name, child);
+            if (!mVisitor)
+            {
+                map.insert(name, child);
+            }
         }
         else
         {
@@ -1233,6 +2073,10 @@ S32 LLSDBinaryParser::parseMap(std::istream& istr, LLSD& map, S32 max_depth) con
         // as were said to be there.
         return PARSE_FAILURE;
     }
+    if (mVisitor)
+    {
+        mVisitor->endMap();
+    }
     return parse_count;
 }
 
@@ -1248,6 +2092,10 @@ S32 LLSDBinaryParser::parseArray(std::istream& istr, LLSD& array, S32 max_depth)
 
     S32 parse_count = 0;
     S32 count = 0;
+    if (mVisitor)
+    {
+        mVisitor->beginArray();
+    }
     char c = istr.peek();
     while((c != ']') && (count < size) && istr.good())
     {
@@ -1260,7 +2108,10 @@ S32 LLSDBinaryParser::parseArray(std::istream& istr, LLSD& array, S32 max_depth)
         if(child_count)
         {
             parse_count += child_count;
-            array.append(child);
+            if (!mVisitor)
+            {
+                array.append(child);
+            }
         }
         ++count;
         c = istr.peek();
@@ -1272,6 +2123,10 @@ S32 LLSDBinaryParser::parseArray(std::istream& istr, LLSD& array, S32 max_depth)
         // as were said to be there.
         return PARSE_FAILURE;
     }
+    if (mVisitor)
+    {
+        mVisitor->endArray();
+    }
     return parse_count;
 }
 
@@ -34,6 +34,63 @@
 #include "llrefcount.h"
 #include "llsd.h"
 
+/**
+ * @class LLSDVisitor
+ * @brief Receives a document's structure as a parser reads it.
+ *
+ * For consumers that turn what they parse into structures of their own, so
+ * that no LLSD tree has to be built only to be walked and dropped. See
+ * LLSDParser::visit(). A map is beginMap(), then key() and the value for
+ * each entry in the order of the document, duplicates included, then
+ * endMap(). An array is beginArray(), its values, then endArray(). Any
+ * other value comes as a single value() call. When the parse fails the
+ * events up to the failure have already been delivered, and it is up to the
+ * visitor to throw away what it made of them.
+ */
+class LL_COMMON_API LLSDVisitor
+{
+public:
+    virtual ~LLSDVisitor() {}
+
+    virtual void beginMap() = 0;
+    virtual void key(const std::string& name) = 0;
+    virtual void endMap() = 0;
+    virtual void beginArray() = 0;
+    virtual void endArray() = 0;
+    virtual void value(const LLSD& value) = 0;
+};
+
+/**
+ * @class LLSDTreeBuilder
+ * @brief Visitor building the LLSD the events describe.
+ *
+ * Lets a visitor keep the parts of a document it has no direct use for as
+ * LLSD, by passing their events on. With duplicate keys the last one wins.
+ */
+class LL_COMMON_API LLSDTreeBuilder : public LLSDVisitor
+{
+public:
+    void beginMap() override;
+    void key(const std::string& name) override;
+    void endMap() override;
+    void beginArray() override;
+    void endArray() override;
+    void value(const LLSD& value) override;
+
+    // true once a whole value has been built
+    bool done() const { return mStack.empty() && mHasValue; }
+    const LLSD& get() const { return mRoot; }
+    void clear();
+
+private:
+    LLSD& slot();
+
+    LLSD mRoot;
+    std::vector<LLSD*> mStack;
+    std::string mKey;
+    bool mHasValue = false;
+};
+
 /**
  * @class LLSDParser
  * @brief Abstract base class for LLSD parsers.
@@ -85,11 +142,52 @@ public:
      */
     S32 parseLines(std::istream& istr, LLSD& data);
 
+    /**
+     * @brief Parse one LLSD object from the start of a buffer in memory.
+     *
+     * Gives the same data and return value as parse() on a stream of the
+     * same bytes. The notation and XML parsers scan the buffer directly
+     * instead of going through an istream, which makes them several times
+     * faster, the other formats read it through an LLMemoryStream.
+     * @param buf The document.
+     * @param len Its length in bytes.
+     * @param data[out] The newly parse structured data.
+     * @param max_depth Max depth parser will check before exiting
+     *  with parse error, -1 - unlimited.
+     * @return Returns the number of LLSD objects parsed into
+     * data. Returns PARSE_FAILURE (-1) on parse failure.
+     */
+    S32 parseBuffer(const char* buf, size_t len, LLSD& data, S32 max_depth = -1);
+
+    /**
+     * @brief Parse a stream, handing what is read to a visitor.
+     *
+     * Like parse(), with the data going to visitor as it is read instead
+     * of into an LLSD.
+     * @return Returns the number of LLSD objects visited. Returns
+     * PARSE_FAILURE (-1) on parse failure.
+     */
+    S32 visit(std::istream& istr, LLSDVisitor& visitor, llssize max_bytes, S32 max_depth = -1);
+
+    /**
+     * @brief Parse a buffer in memory, handing what is read to a visitor.
+     *
+     * Like parseBuffer(), with the data going to visitor.
+     */
+    S32 visitBuffer(const char* buf, size_t len, LLSDVisitor& visitor, S32 max_depth = -1);
+
     /**
      * @brief Resets the parser so parse() or parseLines() can be called again for another <llsd> chunk.
      */
     void reset()    { doReset();    };
 
+    /**
+     * @brief Build the parsed data in the LLSD arena, see LLSD::ArenaScope.
+     *
+     * Worth it for big documents that are walked once and dropped, like an
+     * inventory cache or a large capability reply.
+     */
+    void setUseArena(bool use_arena) { mUseArena = use_arena; }
 
 protected:
     /**
@@ -110,6 +208,13 @@ protected:
      */
     virtual S32 doParse(std::istream& istr, LLSD& data, S32 max_depth = -1) const = 0;
 
+    /**
+     * @brief Virtual default function for parsing a buffer.
+     *
+     * Wraps the buffer in a stream for doParse().
+     */
+    virtual S32 doParseBuffer(const char* buf, size_t len, LLSD& data, S32 max_depth) const;
+
     /**
      * @brief Virtual default function for resetting the parser
      */
@@ -211,6 +316,16 @@ protected:
      * @brief Use line-based reading to get text
      */
     bool mParseLines;
+
+    /**
+     * @brief Parse with an LLSD::ArenaScope open
+     */
+    bool mUseArena;
+
+    /**
+     * @brief Where the parse goes when visiting, NULL when building LLSD.
+     */
+    LLSDVisitor* mVisitor;
 };
 
 /**
@@ -250,6 +365,13 @@ protected:
      */
     virtual S32 doParse(std::istream& istr, LLSD& data, S32 max_depth = -1) const;
 
+    /**
+     * @brief Parse notation straight from memory.
+     *
+     * Follows doParse() case for case, including the input it tolerates.
+     */
+    virtual S32 doParseBuffer(const char* buf, size_t len, LLSD& data, S32 max_depth) const;
+
 private:
     /**
      * @brief Parse a map from the istream
@@ -327,6 +449,15 @@ protected:
      */
     virtual S32 doParse(std::istream& istr, LLSD& data, S32 max_depth = -1) const;
 
+    /**
+     * @brief Parse a document in memory without expat.
+     *
+     * Handles what LLSD documents are made of itself and gives anything it
+     * doesn't, or any malformed document, to expat as is, so the results
+     * are always expat's.
+     */
+    virtual S32 doParseBuffer(const char* buf, size_t len, LLSD& data, S32 max_depth) const;
+
     /**
      * @brief Virtual default function for resetting the parser
      */
@@ -790,6 +921,12 @@ public:
         (void)p->parse(str, sd, max_bytes);
         return sd;
     }
+    // parse a document held in memory, faster than going through a stream
+    static S32 fromNotation(LLSD& sd, const char* buf, size_t len)
+    {
+        LLPointer<LLSDNotationParser> p = new LLSDNotationParser;
+        return p->parseBuffer(buf, len, sd);
+    }
 
     /*
      * XML Methods
@@ -825,6 +962,12 @@ public:
         return fromXMLEmbedded(sd, str, emit_errors);
 //      return fromXMLDocument(sd, str, emit_errors);
     }
+    // parse a document held in memory, faster than going through a stream
+    static S32 fromXML(LLSD& sd, const char* buf, size_t len, bool emit_errors=true)
+    {
+        LLPointer<LLSDXMLParser> p = new LLSDXMLParser(emit_errors);
+        return p->parseBuffer(buf, len, sd);
+    }
 
     /*
      * Binary Methods
@@ -839,6 +982,12 @@ public:
         LLPointer<LLSDBinaryParser> p = new LLSDBinaryParser;
         return p->parse(str, sd, max_bytes, max_depth);
     }
+    // parse a document held in memory
+    static S32 fromBinary(LLSD& sd, const char* buf, size_t len, S32 max_depth = -1)
+    {
+        LLPointer<LLSDBinaryParser> p = new LLSDBinaryParser;
+        return p->parseBuffer(buf, len, sd, max_depth);
+    }
     static LLSD fromBinary(std::istream& str, llssize max_bytes, S32 max_depth = -1)
     {
         LLPointer<LLSDBinaryParser> p = new LLSDBinaryParser;
@@ -33,6 +33,12 @@
 #include "apr_base64.h"
 #include <boost/regex.hpp>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 extern "C"
 {
 #ifdef LL_USESYSTEMLIBS
@@ -262,6 +268,13 @@ public:
 
     void parsePart(const char *buf, llssize len);
 
+    // Parse a whole document held in memory without expat. Returns the
+    // parse count, or PARSE_FAILURE for anything it leaves to expat.
+    S32 parseBuffer(const char* buf, size_t len, LLSD& data);
+    bool hasStarted() const { return mStarted; }
+
+    void setVisitor(LLSDVisitor* visitor) { mVisitor = visitor; }
+
     void reset();
 
 private:
@@ -294,7 +307,12 @@ private:
         ELEMENT_KEY,
         ELEMENT_UNKNOWN
     };
-    static Element readElement(const XML_Char* name);
+    static Element readElement(std::string_view name);
+
+    // the value of a leaf element once its content is complete
+    static void assignValue(Element element, const std::string& content, LLSD& value);
+
+    class BufferParser;
 
     static const XML_Char* findAttribute(const XML_Char* name, const XML_Char** pairs);
 
@@ -317,11 +335,16 @@ private:
 
     std::string mCurrentKey;        // Current XML <tag>
     std::string mCurrentContent;    // String data between <tag> and </tag>
+
+    bool mStarted;                  // expat has been given part of a document
+
+    LLSDVisitor* mVisitor;          // gets the values instead of mResult
+    std::deque<LLSD> mScratch;      // the open values when visiting
 };
 
 
 LLSDXMLParser::Impl::Impl(bool emit_errors)
-    : mEmitErrors(emit_errors)
+    : mEmitErrors(emit_errors), mVisitor(NULL)
 {
     mParser = XML_ParserCreate(NULL);
     reset();
@@ -363,6 +386,7 @@ static unsigned get_till_eol(std::istream& input, char *buf, unsigned bufsize)
 S32 LLSDXMLParser::Impl::parse(std::istream& input, LLSD& data)
 {
     XML_Status status;
+    mStarted = true;
 
     static const int BUFFER_SIZE = 1024;
     void* buffer = NULL;
@@ -431,6 +455,7 @@ S32 LLSDXMLParser::Impl::parseLines(std::istream& input, LLSD& data)
     XML_Status status = XML_STATUS_OK;
 
     data = LLSD();
+    mStarted = true;
 
     static const int BUFFER_SIZE = 1024;
 
@@ -522,6 +547,9 @@ void LLSDXMLParser::Impl::reset()
 
     mCurrentKey.clear();
 
+    mStarted = false;
+    mScratch.clear();
+
     XML_ParserReset(mParser, "utf-8");
     XML_SetUserData(mParser, this);
     XML_SetElementHandler(mParser, sStartElementHandler, sEndElementHandler);
@@ -554,6 +582,7 @@ void LLSDXMLParser::Impl::parsePart(const char* buf, llssize len)
     if ( buf != NULL
         && len > 0 )
     {
+        mStarted = true;
         XML_Status status = XML_Parse(mParser, buf, (int)len, 0);
         if (status == XML_STATUS_ERROR)
         {
@@ -638,24 +667,46 @@ void LLSDXMLParser::Impl::startElementHandler(const XML_Char* name, const XML_Ch
 
     if (mStack.empty())
     {
-        mStack.push_back(&mResult);
+        if (mVisitor)
+        {
+            mStack.push_back(&mScratch.emplace_back());
+        }
+        else
+        {
+            mStack.push_back(&mResult);
+        }
     }
     else if (mStack.back()->isMap())
     {
         if (mCurrentKey.empty()) { return startSkipping(); }
 
-        LLSD& map = *mStack.back();
-        LLSD& newElement = map[mCurrentKey];
-        mStack.push_back(&newElement);
+        if (mVisitor)
+        {
+            mVisitor->key(mCurrentKey);
+            mStack.push_back(&mScratch.emplace_back());
+        }
+        else
+        {
+            LLSD& map = *mStack.back();
+            LLSD& newElement = map[mCurrentKey];
+            mStack.push_back(&newElement);
+        }
 
         mCurrentKey.clear();
     }
     else if (mStack.back()->isArray())
     {
-        LLSD& array = *mStack.back();
-        array.append(LLSD());
-        LLSD& newElement = array[array.size()-1];
-        mStack.push_back(&newElement);
+        if (mVisitor)
+        {
+            mStack.push_back(&mScratch.emplace_back());
+        }
+        else
+        {
+            LLSD& array = *mStack.back();
+            array.append(LLSD());
+            LLSD& newElement = array[array.size()-1];
+            mStack.push_back(&newElement);
+        }
     }
     else {
         // improperly nested value in a non-structure
@@ -667,10 +718,12 @@ void LLSDXMLParser::Impl::startElementHandler(const XML_Char* name, const XML_Ch
     {
         case ELEMENT_MAP:
             *mStack.back() = LLSD::emptyMap();
+            if (mVisitor) { mVisitor->beginMap(); }
             break;
 
         case ELEMENT_ARRAY:
             *mStack.back() = LLSD::emptyArray();
+            if (mVisitor) { mVisitor->beginArray(); }
             break;
 
         default:
@@ -722,6 +775,31 @@ void LLSDXMLParser::Impl::endElementHandler(const XML_Char* name)
     LLSD& value = *mStack.back();
     mStack.pop_back();
 
+    assignValue(element, mCurrentContent, value);
+
+    if (mVisitor)
+    {
+        if (element == ELEMENT_MAP)
+        {
+            mVisitor->endMap();
+        }
+        else if (element == ELEMENT_ARRAY)
+        {
+            mVisitor->endArray();
+        }
+        else
+        {
+            mVisitor->value(value);
+        }
+        mScratch.pop_back();
+    }
+
+    mCurrentContent.clear();
+}
+
+// static
+void LLSDXMLParser::Impl::assignValue(Element element, const std::string& content, LLSD& value)
+{
     switch (element)
     {
         case ELEMENT_UNDEF:
@@ -729,56 +807,56 @@ void LLSDXMLParser::Impl::endElementHandler(const XML_Char* name)
             break;
 
         case ELEMENT_BOOL:
-            value = (mCurrentContent == "true" || mCurrentContent == "1");
+            value = (content == "true" || content == "1");
             break;
 
         case ELEMENT_INTEGER:
             {
                 S32 i;
                 // sscanf okay here with different locales - ints don't change for different locale settings like floats do.
-                if ( sscanf(mCurrentContent.c_str(), "%d", &i ) == 1 )
+                if ( sscanf(content.c_str(), "%d", &i ) == 1 )
                 {   // See if sscanf works - it's faster
                     value = i;
                 }
                 else
                 {
-                    value = LLSD(mCurrentContent).asInteger();
+                    value = LLSD(content).asInteger();
                 }
             }
             break;
 
         case ELEMENT_REAL:
             {
-                value = LLSD(mCurrentContent).asReal();
+                value = LLSD(content).asReal();
                 // removed since this breaks when locale has decimal separator that isn't '.'
                 // investigated changing local to something compatible each time but deemed higher
                 // risk that just using LLSD.asReal() each time.
                 //F64 r;
-                //if ( sscanf(mCurrentContent.c_str(), "%lf", &r ) == 1 )
+                //if ( sscanf(content.c_str(), "%lf", &r ) == 1 )
                 //{ // See if sscanf works - it's faster
                 //  value = r;
                 //}
                 //else
                 //{
-                //  value = LLSD(mCurrentContent).asReal();
+                //  value = LLSD(content).asReal();
                 //}
             }
             break;
 
         case ELEMENT_STRING:
-            value = mCurrentContent;
+            value = content;
             break;
 
         case ELEMENT_UUID:
-            value = LLSD(mCurrentContent).asUUID();
+            value = LLSD(content).asUUID();
             break;
 
         case ELEMENT_DATE:
-            value = LLSD(mCurrentContent).asDate();
+            value = LLSD(content).asDate();
             break;
 
         case ELEMENT_URI:
-            value = LLSD(mCurrentContent).asURI();
+            value = LLSD(content).asURI();
             break;
 
         case ELEMENT_BINARY:
@@ -789,7 +867,7 @@ void LLSDXMLParser::Impl::endElementHandler(const XML_Char* name)
             // so performance impact shold be negligible. + poppy 2009-09-04
             boost::regex r;
             r.assign("\\s");
-            std::string stripped = boost::regex_replace(mCurrentContent, r, "");
+            std::string stripped = boost::regex_replace(content, r, "");
             S32 len = apr_base64_decode_len(stripped.c_str());
             std::vector<U8> data;
             data.resize(len);
@@ -807,8 +885,6 @@ void LLSDXMLParser::Impl::endElementHandler(const XML_Char* name)
             // other values, map and array, have already been set
             break;
     }
-
-    mCurrentContent.clear();
 }
 
 void LLSDXMLParser::Impl::characterDataHandler(const XML_Char* data, int length)
@@ -860,47 +936,47 @@ void LLSDXMLParser::Impl::sCharacterDataHandler(
         uri     -      38
         date    -       1
 */
-LLSDXMLParser::Impl::Element LLSDXMLParser::Impl::readElement(const XML_Char* name)
+LLSDXMLParser::Impl::Element LLSDXMLParser::Impl::readElement(std::string_view name)
 {
     #ifdef XML_PARSER_PERFORMANCE_TESTS
     XML_Timer timer( &readElementTime );
     #endif // XML_PARSER_PERFORMANCE_TESTS
 
-    XML_Char c = *name;
+    XML_Char c = name.empty() ? '\0' : name[0];
     switch (c)
     {
         case 'k':
-            if (strcmp(name, "key") == 0) { return ELEMENT_KEY; }
+            if (name == "key") { return ELEMENT_KEY; }
             break;
         case 'r':
-            if (strcmp(name, "real") == 0) { return ELEMENT_REAL; }
+            if (name == "real") { return ELEMENT_REAL; }
             break;
         case 'i':
-            if (strcmp(name, "integer") == 0) { return ELEMENT_INTEGER; }
+            if (name == "integer") { return ELEMENT_INTEGER; }
             break;
         case 'a':
-            if (strcmp(name, "array") == 0) { return ELEMENT_ARRAY; }
+            if (name == "array") { return ELEMENT_ARRAY; }
             break;
         case 'm':
-            if (strcmp(name, "map") == 0) { return ELEMENT_MAP; }
+            if (name == "map") { return ELEMENT_MAP; }
             break;
         case 'u':
-            if (strcmp(name, "uuid") == 0) { return ELEMENT_UUID; }
-            if (strcmp(name, "undef") == 0) { return ELEMENT_UNDEF; }
-            if (strcmp(name, "uri") == 0) { return ELEMENT_URI; }
+            if (name == "uuid") { return ELEMENT_UUID; }
+            if (name == "undef") { return ELEMENT_UNDEF; }
+            if (name == "uri") { return ELEMENT_URI; }
             break;
         case 'b':
-            if (strcmp(name, "binary") == 0) { return ELEMENT_BINARY; }
-            if (strcmp(name, "boolean") == 0) { return ELEMENT_BOOL; }
+            if (name == "binary") { return ELEMENT_BINARY; }
+            if (name == "boolean") { return ELEMENT_BOOL; }
             break;
         case 's':
-            if (strcmp(name, "string") == 0) { return ELEMENT_STRING; }
+            if (name == "string") { return ELEMENT_STRING; }
             break;
         case 'l':
-            if (strcmp(name, "llsd") == 0) { return ELEMENT_LLSD; }
+            if (name == "llsd") { return ELEMENT_LLSD; }
             break;
         case 'd':
-            if (strcmp(name, "date") == 0) { return ELEMENT_DATE; }
+            if (name == "date") { return ELEMENT_DATE; }
             break;
     }
     return ELEMENT_UNKNOWN;
@@ -908,6 +984,767 @@ LLSDXMLParser::Impl::Element LLSDXMLParser::Impl::readElement(const XML_Char* na
 
 
 
+/**
+ * LLSDXMLParser::Impl::BufferParser
+ *
+ * Parses a document held in memory straight into LLSD. It only deals with
+ * the well formed subset of XML that LLSD documents are written in: the
+ * known elements, the predefined entities and character references and
+ * comments, and gives up on anything else so that expat can have it. A
+ * document it accepts gets exactly the result expat would have produced.
+ */
+namespace
+{
+    // Finds the next byte in character data that needs more than copying:
+    // markup, references, line ends, ']' for "]]>" and any control or
+    // non-ASCII byte.
+    const char* find_special(const char* begin, const char* end)
+    {
+#if defined(__SSE2__) || defined(_M_X64)
+        const __m128i lt = _mm_set1_epi8('<');
+        const __m128i amp = _mm_set1_epi8('&');
+        const __m128i cr = _mm_set1_epi8('\r');
+        const __m128i bracket = _mm_set1_epi8(']');
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i nl = _mm_set1_epi8('\n');
+        const __m128i space = _mm_set1_epi8(' ');
+        for (; end - begin >= 16; begin += 16)
+        {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)begin);
+            // signed compare, so bytes of 0x80 and up count as below ' ' too
+            __m128i ctl = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, tab), _mm_cmpeq_epi8(chunk, nl)),
+                                           _mm_cmplt_epi8(chunk, space));
+            __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, lt), _mm_cmpeq_epi8(chunk, amp)),
+                                       _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, bracket)));
+            int mask = _mm_movemask_epi8(_mm_or_si128(hit, ctl));
+            if (mask)
+            {
+#if LL_MSVC
+                unsigned long bit;
+                _BitScanForward(&bit, mask);
+                return begin + bit;
+#else
+                return begin + __builtin_ctz(mask);
+#endif
+            }
+        }
+#elif defined(__ARM_NEON)
+        const uint8x16_t lt = vdupq_n_u8('<');
+        const uint8x16_t amp = vdupq_n_u8('&');
+        const uint8x16_t cr = vdupq_n_u8('\r');
+        const uint8x16_t bracket = vdupq_n_u8(']');
+        const uint8x16_t tab = vdupq_n_u8('\t');
+        const uint8x16_t nl = vdupq_n_u8('\n');
+        const uint8x16_t space = vdupq_n_u8(' ');
+        const uint8x16_t high = vdupq_n_u8(0x7f);
+        for (; end - begin >= 16; begin += 16)
+        {
+            uint8x16_t chunk = vld1q_u8((const U8*)begin);
+            uint8x16_t ctl = vbicq_u8(vorrq_u8(vcltq_u8(chunk, space), vcgtq_u8(chunk, high)),
+                                      vorrq_u8(vceqq_u8(chunk, tab), vceqq_u8(chunk, nl)));
+            uint8x16_t hit = vorrq_u8(vorrq_u8(vceqq_u8(chunk, lt), vceqq_u8(chunk, amp)),
+                                      vorrq_u8(vceqq_u8(chunk, cr), vceqq_u8(chunk, bracket)));
+            if (vmaxvq_u8(vorrq_u8(hit, ctl)))
+            {
+                break;
+            }
+        }
+#endif
+        for (; begin < end; ++begin)
+        {
+            U8 c = (U8)*begin;
+            if (c == '<' || c == '&' || c == '\r' || c == ']' || c >= 0x80
+                || (c < ' ' && c != '\t' && c != '\n'))
+            {
+                break;
+            }
+        }
+        return begin;
+    }
+
+    inline bool is_xml_space(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    inline bool is_name_char(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+            || c == '_' || c == ':' || c == '.' || c == '-';
+    }
+
+    inline bool is_name_start(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':';
+    }
+
+    // Length of the UTF-8 sequence at begin, 0 if it is malformed or not an XML Char.
+    size_t utf8_char_length(const char* begin, const char* end)
+    {
+        const U8* p = (const U8*)begin;
+        size_t avail = end - begin;
+        U8 c = p[0];
+        if (c < 0xc2 || c > 0xf4)
+        {
+            return 0;
+        }
+        if (c < 0xe0)
+        {
+            return (avail >= 2 && (p[1] & 0xc0) == 0x80) ? 2 : 0;
+        }
+        if (c < 0xf0)
+        {
+            if (avail < 3 || (p[1] & 0xc0) != 0x80 || (p[2] & 0xc0) != 0x80
+                || (c == 0xe0 && p[1] < 0xa0)       // overlong
+                || (c == 0xed && p[1] > 0x9f)       // surrogates
+                || (c == 0xef && p[1] == 0xbf && p[2] > 0xbd)) // U+FFFE, U+FFFF
+            {
+                return 0;
+            }
+            return 3;
+        }
+        if (avail < 4 || (p[1] & 0xc0) != 0x80 || (p[2] & 0xc0) != 0x80 || (p[3] & 0xc0) != 0x80
+            || (c == 0xf0 && p[1] < 0x90)           // overlong
+            || (c == 0xf4 && p[1] > 0x8f))          // beyond U+10FFFF
+        {
+            return 0;
+        }
+        return 4;
+    }
+
+    void append_utf8(std::string& out, U32 code)
+    {
+        if (code < 0x80)
+        {
+            out += (char)code;
+        }
+        else if (code < 0x800)
+        {
+            out += (char)(0xc0 | (code >> 6));
+            out += (char)(0x80 | (code & 0x3f));
+        }
+        else if (code < 0x10000)
+        {
+            out += (char)(0xe0 | (code >> 12));
+            out += (char)(0x80 | ((code >> 6) & 0x3f));
+            out += (char)(0x80 | (code & 0x3f));
+        }
+        else
+        {
+            out += (char)(0xf0 | (code >> 18));
+            out += (char)(0x80 | ((code >> 12) & 0x3f));
+            out += (char)(0x80 | ((code >> 6) & 0x3f));
+            out += (char)(0x80 | (code & 0x3f));
+        }
+    }
+}
+
+class LLSDXMLParser::Impl::BufferParser
+{
+public:
+    BufferParser(const char* buf, size_t len) : mPos(buf), mEnd(buf + len), mCount(0) {}
+
+    S32 parse(LLSD& data);
+
+private:
+    // Nesting beyond this is left to expat rather than to our stack.
+    static const S32 MAX_DEPTH = 512;
+
+    bool parseProlog();
+    bool parseXMLDecl();
+    bool parseValue(LLSD& value, S32 depth);
+    bool parseStartTag(std::string_view& name, bool& empty, bool& base64);
+    bool parseEndTag(std::string_view name);
+    bool parseText(std::string* content);
+    bool parseReference(std::string* content);
+    bool skipComment();
+    bool atEndTag() const { return mEnd - mPos >= 2 && mPos[0] == '<' && mPos[1] == '/'; }
+    bool skipLiteral(std::string_view literal);
+    void skipSpace();
+    std::string_view readName();
+
+    const char* mPos;
+    const char* mEnd;
+    S32 mCount;
+    std::string mContent;
+};
+
+S32 LLSDXMLParser::Impl::BufferParser::parse(LLSD& data)
+{
+    data.clear();
+    if (!parseProlog())
+    {
+        return LLSDParser::PARSE_FAILURE;
+    }
+
+    std::string_view name;
+    bool empty, base64;
+    if (!parseStartTag(name, empty, base64) || readElement(name) != ELEMENT_LLSD)
+    {
+        return LLSDParser::PARSE_FAILURE;
+    }
+    if (empty)
+    {
+        return mCount;
+    }
+
+    bool has_value = false;
+    for (;;)
+    {
+        if (!parseText(NULL))
+        {
+            return LLSDParser::PARSE_FAILURE;
+        }
+        if (atEndTag())
+        {
+            break;
+        }
+        // expat would let a second value replace the first, don't bother
+        if (has_value || !parseValue(data, 0))
+        {
+            return LLSDParser::PARSE_FAILURE;
+        }
+        has_value = true;
+    }
+
+    // whatever follows </llsd> is never looked at, as with expat
+    if (!parseEndTag("llsd"))
+    {
+        return LLSDParser::PARSE_FAILURE;
+    }
+    return mCount;
+}
+
+bool LLSDXMLParser::Impl::BufferParser::parseProlog()
+{
+    skipLiteral("\xEF\xBB\xBF");
+    if (skipLiteral("<?xml") && !parseXMLDecl())
+    {
+        return false;
+    }
+    for (;;)
+    {
+        skipSpace();
+        if (mEnd - mPos >= 4 && !memcmp(mPos, "<!--", 4))
+        {
+            if (!skipComment())
+            {
+                return false;
+            }
+        }
+        else
+        {
+            // the root element, anything else (doctype, processing
+            // instructions) is for expat
+            return mEnd - mPos >= 2 && mPos[0] == '<' && is_name_start(mPos[1]);
+        }
+    }
+}
+
+bool LLSDXMLParser::Impl::BufferParser::parseXMLDecl()
+{
+    // <?xml version="1.0" encoding="UTF-8" standalone="yes"?> with the
+    // leading "<?xml" already consumed and the optional parts optional
+    static const char* const attributes[] = { "version", "encoding", "standalone" };
+    S32 index = 0;
+    for (;;)
+    {
+        bool spaced = mPos < mEnd && is_xml_space(*mPos);
+        skipSpace();
+        if (skipLiteral("?>"))
+        {
+            return index > 0;
+        }
+        if (!spaced)
+        {
+            return false;
+        }
+        std::string_view name = readName();
+        while (index < 3 && name != attributes[index])
+        {
+            if (index == 0)
+            {
+                return false;   // version is required and comes first
+            }
+            ++index;
+        }
+        if (index == 3)
+        {
+            return false;
+        }
+        skipSpace();
+        if (!skipLiteral("="))
+        {
+            return false;
+        }
+        skipSpace();
+        if (mPos >= mEnd || (*mPos != '"' && *mPos != '\''))
+        {
+            return false;
+        }
+        char quote = *mPos++;
+        const char* value_end = (const char*)memchr(mPos, quote, mEnd - mPos);
+        if (!value_end)
+        {
+            return false;
+        }
+        std::string value(mPos, value_end);
+        mPos = value_end + 1;
+        if (index == 0)
+        {
+            if (value != "1.0") return false;
+        }
+        else if (index == 1)
+        {
+            LLStringUtil::toLower(value);
+            if (value != "utf-8") return false;
+        }
+        else if (value != "yes" && value != "no")
+        {
+            return false;
+        }
+        ++index;
+    }
+}
+
+bool LLSDXMLParser::Impl::BufferParser::parseValue(LLSD& value, S32 depth)
+{
+    std::string_view name;
+    bool empty, base64;
+    if (depth > MAX_DEPTH || !parseStartTag(name, empty, base64))
+    {
+        return false;
+    }
+
+    Element element = readElement(name);
+    switch (element)
+    {
+        case ELEMENT_LLSD:
+        case ELEMENT_KEY:
+        case ELEMENT_UNKNOWN:
+            return false;
+
+        case ELEMENT_BINARY:
+            // expat skips anything not base64 encoded
+            if (!base64) return false;
+            break;
+
+        default:
+            break;
+    }
+    ++mCount;
+
+    if (element == ELEMENT_MAP)
+    {
+        value = LLSD::emptyMap();
+        if (empty)
+        {
+            return true;
+        }
+        std::string key;
+        for (;;)
+        {
+            if (!parseText(NULL))
+            {
+                return false;
+            }
+            if (atEndTag())
+            {
+                return parseEndTag(name);
+            }
+            // a <key> with some text in it, then its value
+            bool key_empty, key_base64;
+            std::string_view key_name;
+            if (!parseStartTag(key_name, key_empty, key_base64) || key_empty
+                || readElement(key_name) != ELEMENT_KEY)
+            {
+                return false;
+            }
+            key.clear();
+            if (!parseText(&key) || key.empty() || !parseEndTag(key_name)
+                || !parseText(NULL) || atEndTag()
+                || !parseValue(value[key], depth + 1))
+            {
+                return false;
+            }
+        }
+    }
+
+    if (element == ELEMENT_ARRAY)
+    {
+        value = LLSD::emptyArray();
+        if (empty)
+        {
+            return true;
+        }
+        for (;;)
+        {
+            if (!parseText(NULL))
+            {
+                return false;
+            }
+            if (atEndTag())
+            {
+                return parseEndTag(name);
+            }
+            value.append(LLSD());
+            if (!parseValue(value[value.size() - 1], depth + 1))
+            {
+                return false;
+            }
+        }
+    }
+
+    mContent.clear();
+    if (!empty && (!parseText(&mContent) || !parseEndTag(name)))
+    {
+        return false;
+    }
+
+    // the common numeric cases without the round trip through an LLSD string,
+    // anything unusual converts the way the expat handlers do
+    if (element == ELEMENT_REAL)
+    {
+        F64 real;
+        if (ll_decimal_to_f64(mContent, real))
+        {
+            value = real;
+            return true;
+        }
+    }
+    else if (element == ELEMENT_INTEGER)
+    {
+        const char* p = mContent.data();
+        const char* end = p + mContent.size();
+        bool negative = (p < end && *p == '-');
+        p += negative;
+        if (end - p > 0 && end - p <= 9)
+        {
+            S32 integer = 0;
+            for (; p < end && *p >= '0' && *p <= '9'; ++p)
+            {
+                integer = integer * 10 + (*p - '0');
+            }
+            if (p == end)
+            {
+                value = negative ? -integer : integer;
+                return true;
+            }
+        }
+    }
+    assignValue(element, mContent, value);
+    return true;
+}
+
+bool LLSDXMLParser::Impl::BufferParser::parseStartTag(std::string_view& name, bool& empty, bool& base64)
+{
+    if (mPos >= mEnd || *mPos != '<')
+    {
+        return false;
+    }
+    ++mPos;
+    name = readName();
+    if (name.empty())
+    {
+        return false;
+    }
+
+    base64 = true;
+    std::string_view seen[4];
+    size_t num_seen = 0;
+    for (;;)
+    {
+        bool spaced = mPos < mEnd && is_xml_space(*mPos);
+        skipSpace();
+        if (skipLiteral(">"))
+        {
+            empty = false;
+            return true;
+        }
+        if (skipLiteral("/>"))
+        {
+            empty = true;
+            return true;
+        }
+        if (!spaced)
+        {
+            return false;
+        }
+
+        // name="value", no references or anything needing normalizing
+        std::string_view attribute = readName();
+        if (attribute.empty() || num_seen == LL_ARRAY_SIZE(seen))
+        {
+            return false;
+        }
+        for (size_t i = 0; i < num_seen; ++i)
+        {
+            if (seen[i] == attribute) return false;
+        }
+        seen[num_seen++] = attribute;
+        skipSpace();
+        if (!skipLiteral("="))
+        {
+            return false;
+        }
+        skipSpace();
+        if (mPos >= mEnd || (*mPos != '"' && *mPos != '\''))
+        {
+            return false;
+        }
+        char quote = *mPos++;
+        const char* value_begin = mPos;
+        for (; mPos < mEnd && *mPos != quote; ++mPos)
+        {
+            U8 c = (U8)*mPos;
+            if (c < ' ' || c >= 0x80 || c == '<' || c == '&')
+            {
+                return false;
+            }
+        }
+        if (mPos >= mEnd)
+        {
+            return false;
+        }
+        if (attribute == "encoding" && name == "binary")
+        {
+            base64 = (std::string_view(value_begin, mPos - value_begin) == "base64");
+        }
+        ++mPos;
+    }
+}
+
+bool LLSDXMLParser::Impl::BufferParser::parseEndTag(std::string_view name)
+{
+    if (!skipLiteral("</") || readName() != name)
+    {
+        return false;
+    }
+    skipSpace();
+    return skipLiteral(">");
+}
+
+// Character data up to the next tag, in content if there is one, else just
+// checked. Comments in it are skipped as expat does.
+bool LLSDXMLParser::Impl::BufferParser::parseText(std::string* content)
+{
+    for (;;)
+    {
+        const char* special = find_special(mPos, mEnd);
+        if (content)
+        {
+            content->append(mPos, special);
+        }
+        mPos = special;
+        if (mPos >= mEnd)
+        {
+            return false;   // no </llsd>
+        }
+
+        char c = *mPos;
+        if (c == '<')
+        {
+            if (mEnd - mPos >= 4 && !memcmp(mPos, "<!--", 4))
+            {
+                if (!skipComment())
+                {
+                    return false;
+                }
+                continue;
+            }
+            return true;
+        }
+        else if (c == '&')
+        {
+            if (!parseReference(content))
+            {
+                return false;
+            }
+        }
+        else if (c == '\r')
+        {
+            // line ends all come through as \n
+            ++mPos;
+            if (mPos < mEnd && *mPos == '\n')
+            {
+                ++mPos;
+            }
+            if (content)
+            {
+                *content += '\n';
+            }
+        }
+        else if (c == ']')
+        {
+            if (mEnd - mPos >= 3 && mPos[1] == ']' && mPos[2] == '>')
+            {
+                return false;
+            }
+            ++mPos;
+            if (content)
+            {
+                *content += ']';
+            }
+        }
+        else if ((U8)c >= 0x80)
+        {
+            size_t len = utf8_char_length(mPos, mEnd);
+            if (!len)
+            {
+                return false;
+            }
+            if (content)
+            {
+                content->append(mPos, len);
+            }
+            mPos += len;
+        }
+        else
+        {
+            return false;   // control character
+        }
+    }
+}
+
+bool LLSDXMLParser::Impl::BufferParser::parseReference(std::string* content)
+{
+    const char* semi = (const char*)memchr(mPos, ';', std::min<size_t>(mEnd - mPos, 12));
+    if (!semi)
+    {
+        return false;
+    }
+    std::string_view ref(mPos + 1, semi - mPos - 1);
+    mPos = semi + 1;
+
+    char c;
+    if (ref == "lt") c = '<';
+    else if (ref == "gt") c = '>';
+    else if (ref == "amp") c = '&';
+    else if (ref == "quot") c = '"';
+    else if (ref == "apos") c = '\'';
+    else if (ref.size() >= 2 && ref[0] == '#')
+    {
+        bool hex = (ref[1] == 'x');
+        size_t i = hex ? 2 : 1;
+        if (i >= ref.size())
+        {
+            return false;
+        }
+        U32 code = 0;
+        for (; i < ref.size(); ++i)
+        {
+            U32 digit;
+            char d = ref[i];
+            if (d >= '0' && d <= '9') digit = d - '0';
+            else if (hex && d >= 'a' && d <= 'f') digit = d - 'a' + 10;
+            else if (hex && d >= 'A' && d <= 'F') digit = d - 'A' + 10;
+            else return false;
+            code = code * (hex ? 16 : 10) + digit;
+            if (code > 0x10ffff)
+            {
+                return false;
+            }
+        }
+        // only what XML allows as a Char
+        if (code < 0x20 ? (code != 0x9 && code != 0xa && code != 0xd)
+            : ((code >= 0xd800 && code <= 0xdfff) || code == 0xfffe || code == 0xffff))
+        {
+            return false;
+        }
+        if (content)
+        {
+            append_utf8(*content, code);
+        }
+        return true;
+    }
+    else
+    {
+        return false;   // no DTD, so nothing else is defined
+    }
+
+    if (content)
+    {
+        *content += c;
+    }
+    return true;
+}
+
+bool LLSDXMLParser::Impl::BufferParser::skipComment()
+{
+    // "<!--" already checked for, "--" may only appear as the end
+    for (mPos += 4; mPos < mEnd; )
+    {
+        U8 c = (U8)*mPos;
+        if (c == '-' && mEnd - mPos >= 2 && mPos[1] == '-')
+        {
+            if (mEnd - mPos < 3 || mPos[2] != '>')
+            {
+                return false;
+            }
+            mPos += 3;
+            return true;
+        }
+        if (c >= 0x80)
+        {
+            size_t len = utf8_char_length(mPos, mEnd);
+            if (!len)
+            {
+                return false;
+            }
+            mPos += len;
+        }
+        else if (c < ' ' && !is_xml_space(c))
+        {
+            return false;
+        }
+        else
+        {
+            ++mPos;
+        }
+    }
+    return false;
+}
+
+bool LLSDXMLParser::Impl::BufferParser::skipLiteral(std::string_view literal)
+{
+    if ((size_t)(mEnd - mPos) < literal.size() || memcmp(mPos, literal.data(), literal.size()))
+    {
+        return false;
+    }
+    mPos += literal.size();
+    return true;
+}
+
+void LLSDXMLParser::Impl::BufferParser::skipSpace()
+{
+    while (mPos < mEnd && is_xml_space(*mPos))
+    {
+        ++mPos;
+    }
+}
+
+// An ASCII name, empty if there isn't one. Names with anything else in them
+// are never LLSD's, and the caller gives up on them.
+std::string_view LLSDXMLParser::Impl::BufferParser::readName()
+{
+    const char* begin = mPos;
+    if (mPos < mEnd && is_name_start(*mPos))
+    {
+        for (++mPos; mPos < mEnd && is_name_char(*mPos); ++mPos)
+            ;
+        if (mPos < mEnd && (U8)*mPos >= 0x80)
+        {
+            mPos = begin;
+        }
+    }
+    return std::string_view(begin, mPos - begin);
+}
+
+S32 LLSDXMLParser::Impl::parseBuffer(const char* buf, size_t len, LLSD& data)
+{
+    BufferParser parser(buf, len);
+    return parser.parse(data);
+}
 
 
 /**
@@ -936,6 +1773,7 @@ S32 LLSDXMLParser::doParse(std::istream& input, LLSD& data, S32 max_depth) const
     XML_Timer timer( &parseTime );
     #endif  // XML_PARSER_PERFORMANCE_TESTS
 
+    impl.setVisitor(mVisitor);
     if (mParseLines)
     {
         // Use line-based reading (faster code)
@@ -945,6 +1783,24 @@ S32 LLSDXMLParser::doParse(std::istream& input, LLSD& data, S32 max_depth) const
     return impl.parse(input, data);
 }
 
+// virtual
+S32 LLSDXMLParser::doParseBuffer(const char* buf, size_t len, LLSD& data, S32 max_depth) const
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_LLSD;
+
+    // a visitor can't be told to forget what the buffer parser gave it
+    // before handing the document to expat
+    if (!mParseLines && !mVisitor && !impl.hasStarted())
+    {
+        S32 count = impl.parseBuffer(buf, len, data);
+        if (count != PARSE_FAILURE)
+        {
+            return count;
+        }
+    }
+    return LLSDParser::doParseBuffer(buf, len, data, max_depth);
+}
+
 //  virtual
 void LLSDXMLParser::doReset()
 {
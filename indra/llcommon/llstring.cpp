@@ -84,6 +84,103 @@ U8 hex_as_nybble(char hex)
     return 0; // uh - oh, not hex any more...
 }
 
+bool ll_decimal_to_f64(std::string_view str, F64& value)
+{
+    // Every integer up to 2^53 and every power of ten up to 1e22 is exact in
+    // an F64, so one multiplication or division of the two rounds exactly
+    // like strtod() does.
+    static const F64 POWERS_OF_TEN[] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const S32 MAX_POWER = 22;
+    const S32 MAX_DIGITS = 19; // still fits a U64
+
+    const char* p = str.data();
+    const char* end = p + str.size();
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    U64 mantissa = 0;
+    S32 digits = 0;
+    S32 exponent = 0;
+    bool found_digit = false;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p)
+    {
+        found_digit = true;
+        if (mantissa || *p != '0')
+        {
+            if (++digits > MAX_DIGITS)
+            {
+                return false;
+            }
+            mantissa = mantissa * 10 + (*p - '0');
+        }
+    }
+    if (p < end && *p == '.')
+    {
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p)
+        {
+            found_digit = true;
+            if (mantissa || *p != '0')
+            {
+                if (++digits > MAX_DIGITS)
+                {
+                    return false;
+                }
+                mantissa = mantissa * 10 + (*p - '0');
+            }
+            --exponent;
+        }
+    }
+    if (!found_digit)
+    {
+        return false;
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        ++p;
+        bool negative_exponent = false;
+        if (p < end && (*p == '-' || *p == '+'))
+        {
+            negative_exponent = (*p == '-');
+            ++p;
+        }
+        S32 explicit_exponent = 0;
+        const char* exponent_start = p;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p)
+        {
+            if (p - exponent_start >= 4)
+            {
+                return false;
+            }
+            explicit_exponent = explicit_exponent * 10 + (*p - '0');
+        }
+        if (p == exponent_start)
+        {
+            return false;
+        }
+        exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+    }
+
+    if (p != end || mantissa > (1ULL << 53) || exponent < -MAX_POWER || exponent > MAX_POWER)
+    {
+        return false;
+    }
+
+    F64 result = (F64)mantissa;
+    result = exponent < 0 ? result / POWERS_OF_TEN[-exponent] : result * POWERS_OF_TEN[exponent];
+    value = negative ? -result : result;
+    return true;
+}
+
 bool iswindividual(llwchar elem)
 {
     U32 cur_char = (U32)elem;
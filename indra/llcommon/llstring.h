@@ -569,6 +569,17 @@ inline std::string chop_tail_copy(
 LL_COMMON_API bool is_char_hex(char hex);
 LL_COMMON_API U8 hex_as_nybble(char hex);
 
+/**
+ * @brief Converts a plain decimal number like "-12", "3.25" or "1e-5"
+ * to the same F64 that std::istream >> F64 would give, without a stream.
+ *
+ * Only handles numbers whose digits and exponent can be converted exactly,
+ * which is nearly all of them. Returns false, leaving value alone, for the
+ * rest: leading or trailing characters, too many digits, big exponents,
+ * with callers then falling back to a stream.
+ */
+LL_COMMON_API bool ll_decimal_to_f64(std::string_view str, F64& value);
+
 /**
  * @brief read the contents of a file into a string.
  *
@@ -0,0 +1,109 @@
+/**
+ * @file llsymbol.cpp
+ * @brief Interned strings that compare and hash by address.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llsymbol.h"
+
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+
+namespace
+{
+    // Sharded so that threads interning different names rarely contend.
+    // Each shard maps a view of the interned string to the string itself;
+    // the strings are never freed, so the views and LLSymbols stay valid.
+    struct Shard
+    {
+        std::mutex mMutex;
+        std::unordered_map<std::string_view, std::unique_ptr<const std::string>> mNames;
+    };
+
+    const size_t SHARDS = 64;
+
+    // function statics, since LLSymbols are themselves often statics in
+    // other translation units
+    Shard* get_shards()
+    {
+        static Shard* sShards = new Shard[SHARDS];
+        return sShards;
+    }
+
+    const std::string* get_empty()
+    {
+        static const std::string* sEmpty = new std::string;
+        return sEmpty;
+    }
+
+    Shard& get_shard(std::string_view name)
+    {
+        return get_shards()[std::hash<std::string_view>()(name) % SHARDS];
+    }
+}
+
+LLSymbol::LLSymbol():
+    mName(get_empty())
+{
+}
+
+LLSymbol::LLSymbol(std::string_view name):
+    mName(get_empty())
+{
+    if (name.empty())
+    {
+        return;
+    }
+    Shard& shard = get_shard(name);
+    std::lock_guard<std::mutex> lock(shard.mMutex);
+    auto found = shard.mNames.find(name);
+    if (found == shard.mNames.end())
+    {
+        auto interned = std::make_unique<const std::string>(name);
+        std::string_view key(*interned);
+        found = shard.mNames.emplace(key, std::move(interned)).first;
+    }
+    mName = found->second.get();
+}
+
+//static
+LLSymbol LLSymbol::find(std::string_view name)
+{
+    if (name.empty())
+    {
+        return LLSymbol();
+    }
+    Shard& shard = get_shard(name);
+    std::lock_guard<std::mutex> lock(shard.mMutex);
+    auto found = shard.mNames.find(name);
+    return (found == shard.mNames.end())? LLSymbol() : LLSymbol(found->second.get());
+}
+
+std::ostream& operator<<(std::ostream& out, const LLSymbol& symbol)
+{
+    return out << symbol.str();
+}
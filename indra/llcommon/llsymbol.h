@@ -0,0 +1,94 @@
+/**
+ * @file llsymbol.h
+ * @brief Interned strings that compare and hash by address.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLSYMBOL_H
+#define LL_LLSYMBOL_H
+
+#include "llpreprocessor.h"
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+/**
+ * LLSymbol is a name interned in a process-wide table: two LLSymbols made
+ * from equal strings hold the same pointer, so comparing or hashing them
+ * never looks at the characters. Making one costs a hash and a table lookup,
+ * so make them once -- typically as statics -- and keep them, rather than
+ * constructing one per lookup:
+ *
+ * @code
+ * static const LLSymbol sMainloop("mainloop");
+ * LLEventPumps::instance().obtain(sMainloop);
+ * @endcode
+ *
+ * Interned strings are never freed, so don't intern arbitrary data: this
+ * is meant for the fixed vocabulary of names a program uses. The table is
+ * thread-safe.
+ */
+class LL_COMMON_API LLSymbol
+{
+public:
+    /// the empty string
+    LLSymbol();
+    explicit LLSymbol(std::string_view name);
+
+    /// the symbol for name if anything has interned it yet, else the empty
+    /// symbol; never adds to the table
+    static LLSymbol find(std::string_view name);
+
+    const std::string& str() const  { return *mName; }
+    const char* c_str() const       { return mName->c_str(); }
+    bool empty() const              { return mName->empty(); }
+    // so an LLSymbol works wherever a string_view key does, LLSD included
+    operator std::string_view() const { return *mName; }
+
+    bool operator==(const LLSymbol& other) const { return mName == other.mName; }
+    bool operator!=(const LLSymbol& other) const { return mName != other.mName; }
+    /// an arbitrary but consistent order, NOT alphabetical
+    bool operator<(const LLSymbol& other) const  { return std::less<const std::string*>()(mName, other.mName); }
+
+    size_t hash() const { return std::hash<const std::string*>()(mName); }
+
+private:
+    explicit LLSymbol(const std::string* name): mName(name) {}
+
+    const std::string* mName;
+};
+
+LL_COMMON_API std::ostream& operator<<(std::ostream& out, const LLSymbol& symbol);
+
+namespace std
+{
+    template <>
+    struct hash<LLSymbol>
+    {
+        size_t operator()(const LLSymbol& symbol) const { return symbol.hash(); }
+    };
+}
+
+#endif // LL_LLSYMBOL_H
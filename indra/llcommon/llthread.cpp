@@ -33,6 +33,7 @@
 
 #include "lltimer.h"
 #include "lltrace.h"
+#include "lltracecapture.h"
 #include "lltracethreadrecorder.h"
 #include "llexception.h"
 
@@ -147,6 +148,7 @@ void LLThread::threadRun()
 #endif
 
     LL_PROFILER_SET_THREAD_NAME( mName.c_str() );
+    LLTrace::TraceCapture::nameThread(mName);
 
     // this is the first point at which we're actually running in the new thread
     mID = currentID();
@@ -0,0 +1,313 @@
+/**
+ * @file lltracecapture.cpp
+ * @brief Ring buffers of recent fast timer scopes, dumpable as a Chrome trace.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "lltracecapture.h"
+#include "llfasttimer.h"
+#include "llfile.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+namespace LLTrace
+{
+
+std::atomic<bool> TraceCapture::sEnabled{ false };
+
+namespace
+{
+    // marks an instant() rather than a scope
+    const U64 INSTANT = ~U64(0);
+
+    // Only the owning thread writes a ring, but dump() reads it from
+    // another, hence the relaxed atomics: a slot being overwritten while
+    // dump() copies it is detectable from mHead, and then thrown away.
+    struct Event
+    {
+        std::atomic<const char*> mName{ nullptr };
+        std::atomic<U64> mStart{ 0 };
+        std::atomic<U64> mEnd{ 0 };
+    };
+
+    struct Ring
+    {
+        void push(const char* name, U64 start, U64 end)
+        {
+            U64 head = mHead.load(std::memory_order_relaxed);
+            Event& event = mEvents[head & (TraceCapture::EVENTS_PER_THREAD - 1)];
+            event.mName.store(name, std::memory_order_relaxed);
+            event.mStart.store(start, std::memory_order_relaxed);
+            event.mEnd.store(end, std::memory_order_relaxed);
+            mHead.store(head + 1, std::memory_order_release);
+        }
+
+        std::atomic<U64> mHead{ 0 };
+        // events before this belong to a thread that has since exited
+        std::atomic<U64> mFirst{ 0 };
+        std::atomic<bool> mOwned{ true };
+        // the rest are guarded by sRingsMutex
+        std::string mName;
+        U32 mID{ 0 };
+        Event mEvents[TraceCapture::EVENTS_PER_THREAD];
+    };
+
+    // Rings outlive their threads, so that a dump can still show what a
+    // thread did just before it exited, and are handed on to new threads
+    // rather than freed.
+    std::mutex sRingsMutex;
+    std::vector<Ring*> sRings;
+    U32 sNextID = 0;
+
+    struct RingOwner
+    {
+        ~RingOwner()
+        {
+            if (mRing)
+            {
+                mRing->mOwned.store(false, std::memory_order_release);
+            }
+        }
+
+        Ring* mRing{ nullptr };
+        std::string mName;
+    };
+    thread_local RingOwner sOwner;
+
+    Ring* get_ring()
+    {
+        if (sOwner.mRing)
+        {
+            return sOwner.mRing;
+        }
+
+        std::lock_guard<std::mutex> lock(sRingsMutex);
+        Ring* ring = nullptr;
+        for (Ring* candidate : sRings)
+        {
+            bool owned = false;
+            if (candidate->mOwned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+            {
+                ring = candidate;
+                ring->mFirst.store(ring->mHead.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                break;
+            }
+        }
+        if (!ring)
+        {
+            ring = new Ring;
+            sRings.push_back(ring);
+        }
+        ring->mID = ++sNextID;
+        ring->mName = sOwner.mName.empty()? llformat("Thread %u", ring->mID) : sOwner.mName;
+        sOwner.mRing = ring;
+        return ring;
+    }
+
+    struct Copied
+    {
+        const char* mName;
+        U64 mStart;
+        U64 mEnd;
+    };
+
+    // copy out whatever of ring is newer than cutoff and not overwritten
+    void copy_ring(const Ring& ring, U64 cutoff, std::vector<Copied>& out)
+    {
+        const U64 size = TraceCapture::EVENTS_PER_THREAD;
+        U64 head = ring.mHead.load(std::memory_order_acquire);
+        U64 first = std::max(ring.mFirst.load(std::memory_order_relaxed), head > size? head - size : 0);
+        size_t start = out.size();
+        for (U64 i = first; i < head; ++i)
+        {
+            const Event& event = ring.mEvents[i & (size - 1)];
+            out.push_back({ event.mName.load(std::memory_order_relaxed),
+                            event.mStart.load(std::memory_order_relaxed),
+                            event.mEnd.load(std::memory_order_relaxed) });
+        }
+        // anything the owner lapped while we copied may be torn
+        std::atomic_thread_fence(std::memory_order_acquire);
+        U64 now_head = ring.mHead.load(std::memory_order_relaxed);
+        U64 lapped = (now_head >= first + size)? std::min(now_head - size - first + 1, head - first) : 0;
+        out.erase(out.begin() + start, out.begin() + start + size_t(lapped));
+
+        out.erase(std::remove_if(out.begin() + start, out.end(),
+                                 [cutoff](const Copied& event)
+                                 {
+                                     return !event.mName
+                                         || ((event.mEnd == INSTANT)? event.mStart : event.mEnd) < cutoff;
+                                 }),
+                  out.end());
+    }
+
+    void write_string(std::ostream& os, const char* str)
+    {
+        os << '"';
+        for (const char* p = str; *p; ++p)
+        {
+            U8 c = U8(*p);
+            if (c == '"' || c == '\\')
+            {
+                os << '\\' << char(c);
+            }
+            else if (c < 0x20)
+            {
+                os << llformat("\\u%04x", c);
+            }
+            else
+            {
+                os << char(c);
+            }
+        }
+        os << '"';
+    }
+}
+
+//static
+void TraceCapture::nameThread(const std::string& name)
+{
+    sOwner.mName = name;
+    if (sOwner.mRing)
+    {
+        std::lock_guard<std::mutex> lock(sRingsMutex);
+        sOwner.mRing->mName = name;
+    }
+}
+
+//static
+void TraceCapture::recordScope(const char* name, U64 start, U64 end)
+{
+    get_ring()->push(name, start, end);
+}
+
+//static
+void TraceCapture::instant(const char* name)
+{
+    if (isEnabled())
+    {
+        get_ring()->push(name, BlockTimer::getCPUClockCount64(), INSTANT);
+    }
+}
+
+//static
+F64 TraceCapture::endFrame()
+{
+    static U64 sLastFrame = 0;
+    U64 now = BlockTimer::getCPUClockCount64();
+    U64 last = sLastFrame;
+    sLastFrame = now;
+    if (!last)
+    {
+        return 0.0;
+    }
+    if (isEnabled())
+    {
+        get_ring()->push("Frame", last, now);
+    }
+    return F64(now - last) / F64(BlockTimer::countsPerSecond());
+}
+
+//static
+bool TraceCapture::dump(const std::string& filename, F64 seconds)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_STATS;
+    const F64 counts_per_sec = F64(BlockTimer::countsPerSecond());
+    U64 now = BlockTimer::getCPUClockCount64();
+    U64 window = U64(std::max(seconds, 0.0) * counts_per_sec);
+    U64 cutoff = (now > window)? now - window : 0;
+
+    struct Thread
+    {
+        U32 mID;
+        std::string mName;
+        size_t mBegin, mEnd;
+    };
+    std::vector<Thread> threads;
+    std::vector<Copied> events;
+    {
+        std::lock_guard<std::mutex> lock(sRingsMutex);
+        for (const Ring* ring : sRings)
+        {
+            size_t begin = events.size();
+            copy_ring(*ring, cutoff, events);
+            threads.push_back({ ring->mID, ring->mName, begin, events.size() });
+        }
+    }
+
+    U64 base = now;
+    for (const Copied& event : events)
+    {
+        base = std::min(base, event.mStart);
+    }
+    auto micros = [base, counts_per_sec](U64 counts)
+    {
+        return F64(counts - base) * 1000000.0 / counts_per_sec;
+    };
+
+    llofstream out(filename.c_str());
+    if (!out.is_open())
+    {
+        LL_WARNS("TraceCapture") << "Couldn't write " << filename << LL_ENDL;
+        return false;
+    }
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    const char* sep = "\n";
+    for (const Thread& thread : threads)
+    {
+        out << sep << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << thread.mID
+            << ",\"args\":{\"name\":";
+        write_string(out, thread.mName.c_str());
+        out << "}}";
+        sep = ",\n";
+        for (size_t i = thread.mBegin; i < thread.mEnd; ++i)
+        {
+            const Copied& event = events[i];
+            out << sep << "{\"name\":";
+            write_string(out, event.mName);
+            if (event.mEnd == INSTANT)
+            {
+                out << ",\"ph\":\"i\",\"s\":\"t\",\"ts\":" << micros(event.mStart);
+            }
+            else
+            {
+                out << ",\"ph\":\"X\",\"ts\":" << micros(event.mStart)
+                    << ",\"dur\":" << micros(event.mEnd) - micros(event.mStart);
+            }
+            out << ",\"pid\":1,\"tid\":" << thread.mID << "}";
+        }
+    }
+    out << "\n]}\n";
+    out.close();
+
+    LL_INFOS("TraceCapture") << "Wrote " << events.size() << " events from "
+                             << threads.size() << " threads to " << filename << LL_ENDL;
+    return !out.fail();
+}
+
+}
@@ -0,0 +1,78 @@
+/**
+ * @file lltracecapture.h
+ * @brief Ring buffers of recent fast timer scopes, dumpable as a Chrome trace.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLTRACECAPTURE_H
+#define LL_LLTRACECAPTURE_H
+
+#include "stdtypes.h"
+#include "llpreprocessor.h"
+
+#include <atomic>
+#include <string>
+
+namespace LLTrace
+{
+
+// While enabled, every BlockTimer scope that closes, on any thread, lands in
+// a ring buffer belonging to that thread, along with frame markers and any
+// instant() events. The rings only ever hold the most recent events, so
+// capture can stay on; dump() writes out the last few seconds of them as
+// Chrome trace event JSON, which chrome://tracing and Perfetto both open.
+class LL_COMMON_API TraceCapture
+{
+public:
+    // events each thread keeps; at 24 bytes apiece, 1.5MB per thread that
+    // has recorded anything
+    static const U32 EVENTS_PER_THREAD = 1 << 16;
+
+    static void setEnabled(bool enabled) { sEnabled.store(enabled, std::memory_order_relaxed); }
+    static bool isEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+
+    // name the calling thread in dumps; unnamed threads show as "Thread n"
+    static void nameThread(const std::string& name);
+
+    // Record a scope from start to end, in BlockTimer clock counts. name
+    // must outlive the capture: in practice, a string literal or the name
+    // of a static stat handle.
+    static void recordScope(const char* name, U64 start, U64 end);
+    // record a point in time on the calling thread
+    static void instant(const char* name);
+    // Mark the end of a frame on the calling thread, which should be the
+    // main thread, and return how long, in seconds, since the last call.
+    static F64 endFrame();
+
+    // Write everything recorded in the last seconds to filename. Returns
+    // false if the file couldn't be written. Safe to call while other
+    // threads go on recording.
+    static bool dump(const std::string& filename, F64 seconds);
+
+private:
+    static std::atomic<bool> sEnabled;
+};
+
+}
+
+#endif // LL_LLTRACECAPTURE_H
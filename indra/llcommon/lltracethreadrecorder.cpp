@@ -30,6 +30,8 @@
 #include "lltrace.h"
 #include "llstl.h"
 
+#include <thread>
+
 namespace LLTrace
 {
 //extern MemStatHandle gTraceMemStat;
@@ -267,9 +269,12 @@ void ThreadRecorder::pushToParent()
 #if LL_TRACE_ENABLED
     if (ThreadRecorder* recorder = LLTrace::get_thread_recorder())
     {
-        LLMutexLock lock(&mSharedRecordingMutex);
         recorder->bringUpToDate(&mThreadRecordingBuffers);
-        mSharedRecordingBuffers.append(mThreadRecordingBuffers);
+        // seq_cst, pairing with the flip in pullFromChildren():
+        // either it sees us pushing or we see the index it flipped to
+        mSharedPushing.store(true);
+        mSharedRecordingBuffers[mSharedIndex.load()].append(mThreadRecordingBuffers);
+        mSharedPushing.store(false, std::memory_order_release);
         mThreadRecordingBuffers.reset();
     }
 #endif
@@ -287,9 +292,16 @@ void ThreadRecorder::pullFromChildren()
         target_recording_buffers.sync();
         for (LLTrace::ThreadRecorder* rec : mChildThreadRecorders)
         {
-            LLMutexLock lock(&(rec->mSharedRecordingMutex));
-            target_recording_buffers.merge(rec->mSharedRecordingBuffers);
-            rec->mSharedRecordingBuffers.reset();
+            // only this thread flips the index, so relaxed is enough to read it
+            U32 taken = rec->mSharedIndex.load(std::memory_order_relaxed);
+            rec->mSharedIndex.store(taken ^ 1);
+            // a push that read the old index is at most one append from done
+            while (rec->mSharedPushing.load())
+            {
+                std::this_thread::yield();
+            }
+            target_recording_buffers.merge(rec->mSharedRecordingBuffers[taken]);
+            rec->mSharedRecordingBuffers[taken].reset();
         }
     }
 #endif
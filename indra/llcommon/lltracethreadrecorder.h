@@ -33,6 +33,8 @@
 #include "llmutex.h"
 #include "lltraceaccumulators.h"
 
+#include <atomic>
+
 namespace LLTrace
 {
     class LL_COMMON_API ThreadRecorder
@@ -55,6 +57,8 @@ namespace LLTrace
 
         // call this periodically to gather stats data from child threads
         void pullFromChildren();
+        // call this from a child thread, say once a frame, to hand its stats
+        // to pullFromChildren(); it never waits on the parent
         void pushToParent();
 
         TimeBlockTreeNode* getTimeBlockTreeNode(size_t index);
@@ -85,8 +89,13 @@ namespace LLTrace
 
         child_thread_recorder_list_t    mChildThreadRecorders;  // list of child thread recorders associated with this master
         LLMutex                         mChildListMutex;        // protects access to child list
-        LLMutex                         mSharedRecordingMutex;
-        AccumulatorBufferGroup          mSharedRecordingBuffers;
+        // Double buffered: pushToParent() appends to the buffer mSharedIndex
+        // names, while pullFromChildren() flips mSharedIndex and merges the
+        // other one. mSharedPushing tells the parent to wait out a push that
+        // may have started on the buffer it just took.
+        AccumulatorBufferGroup          mSharedRecordingBuffers[2];
+        std::atomic<U32>                mSharedIndex{ 0 };
+        std::atomic<bool>               mSharedPushing{ false };
         ThreadRecorder*                 mParentRecorder;
 
     };
@@ -0,0 +1,706 @@
+/**
+ * @file lluuidhashmap.h
+ * @brief Flat open addressing hash map and set keyed by LLUUID.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLUUIDHASHMAP_H
+#define LL_LLUUIDHASHMAP_H
+
+#include "llmemory.h"
+#include "lluuid.h"
+
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LL_UUIDHASH_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define LL_UUIDHASH_NEON 1
+#endif
+
+#if LL_MSVC
+#include <intrin.h>
+#endif
+
+/**
+ * LLUUIDHashMap<T> and LLUUIDHashSet are drop-in replacements for the
+ * std::map and std::unordered_map we key by LLUUID, for the lookups that run
+ * every frame: objects by id, textures, skin info, inventory.
+ *
+ * Entries sit in one flat array next to an array of control bytes, each
+ * holding 7 bits of the entry's hash, or empty, or deleted. A lookup checks
+ * 16 control bytes at once with SIMD, then compares the 16 byte keys of the
+ * few candidates with a single SIMD compare each, so a hit usually costs one
+ * cache miss for the control bytes and one for the entry, against a dozen
+ * for a std::map.
+ *
+ * What they give up:
+ * - Iteration order is arbitrary, not sorted by id.
+ * - Inserting may move every entry: it invalidates all iterators, pointers
+ *   and references into the container. Erasing invalidates only the erased
+ *   entry, so the erase-while-iterating loops used with std::map still work.
+ * - Values should be small or cheap to move, LLPointers and raw pointers
+ *   being ideal; a big value is better held by pointer.
+ */
+namespace LLUUIDHash
+{
+    // Control bytes. A full slot holds the low 7 bits of its hash, so only
+    // empty and deleted have the top bit set.
+    const U8 CTRL_EMPTY = 0x80;
+    const U8 CTRL_DELETED = 0xfe;
+
+    const size_t GROUP_WIDTH = 16;
+
+    // getDigest64() is fine for ids from LLUUID::generate(), but ids made by
+    // hand or by combine() aren't always that random in their low bits,
+    // which both halves of the hash below come from.
+    inline U64 hash(const LLUUID& id)
+    {
+        U64 h = id.getDigest64();
+        h ^= h >> 32;
+        h *= 0x9e3779b97f4a7c15ULL;
+        h ^= h >> 29;
+        return h;
+    }
+
+    inline bool equal(const LLUUID& a, const LLUUID& b)
+    {
+#if LL_UUIDHASH_SSE2
+        __m128i va = _mm_loadu_si128((const __m128i*)a.mData);
+        __m128i vb = _mm_loadu_si128((const __m128i*)b.mData);
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) == 0xffff;
+#elif LL_UUIDHASH_NEON
+        uint8x16_t eq = vceqq_u8(vld1q_u8(a.mData), vld1q_u8(b.mData));
+        return vminvq_u8(eq) == 0xff;
+#else
+        return memcmp(a.mData, b.mData, UUID_BYTES) == 0;
+#endif
+    }
+
+    // Set bits for the slots of a group that matched, lowest slot first
+    class BitMask
+    {
+    public:
+#if LL_UUIDHASH_NEON
+        typedef U64 mask_t;
+        // vshrn leaves four bits per slot; keep one
+        static const U32 SHIFT = 2;
+        explicit BitMask(mask_t mask) : mMask(mask & 0x8888888888888888ULL) {}
+#else
+        typedef U32 mask_t;
+        static const U32 SHIFT = 0;
+        explicit BitMask(mask_t mask) : mMask(mask) {}
+#endif
+
+        explicit operator bool() const { return mMask != 0; }
+
+        U32 lowest() const
+        {
+#if LL_MSVC
+            unsigned long bit;
+#if LL_UUIDHASH_NEON
+            _BitScanForward64(&bit, mMask);
+#else
+            _BitScanForward(&bit, mMask);
+#endif
+            return (U32)bit >> SHIFT;
+#elif LL_UUIDHASH_NEON
+            return (U32)__builtin_ctzll(mMask) >> SHIFT;
+#else
+            return (U32)__builtin_ctz(mMask) >> SHIFT;
+#endif
+        }
+
+        void clearLowest() { mMask &= mMask - 1; }
+
+    private:
+        mask_t mMask;
+    };
+
+    // The 16 control bytes at the start of a group
+    class Group
+    {
+    public:
+        explicit Group(const U8* ctrl)
+        {
+#if LL_UUIDHASH_SSE2
+            mCtrl = _mm_load_si128((const __m128i*)ctrl);
+#elif LL_UUIDHASH_NEON
+            mCtrl = vld1q_u8(ctrl);
+#else
+            memcpy(mCtrl, ctrl, GROUP_WIDTH);
+#endif
+        }
+
+        BitMask match(U8 h2) const
+        {
+#if LL_UUIDHASH_SSE2
+            return BitMask((U32)_mm_movemask_epi8(_mm_cmpeq_epi8(mCtrl, _mm_set1_epi8((char)h2))));
+#elif LL_UUIDHASH_NEON
+            return narrow(vceqq_u8(mCtrl, vdupq_n_u8(h2)));
+#else
+            return scalar([h2](U8 ctrl) { return ctrl == h2; });
+#endif
+        }
+
+        BitMask matchEmpty() const
+        {
+            return match(CTRL_EMPTY);
+        }
+
+        BitMask matchEmptyOrDeleted() const
+        {
+#if LL_UUIDHASH_SSE2
+            return BitMask((U32)_mm_movemask_epi8(mCtrl));
+#elif LL_UUIDHASH_NEON
+            return narrow(vcltq_s8(vreinterpretq_s8_u8(mCtrl), vdupq_n_s8(0)));
+#else
+            return scalar([](U8 ctrl) { return (ctrl & 0x80) != 0; });
+#endif
+        }
+
+    private:
+#if LL_UUIDHASH_SSE2
+        __m128i mCtrl;
+#elif LL_UUIDHASH_NEON
+        static BitMask narrow(uint8x16_t eq)
+        {
+            uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+            return BitMask(vget_lane_u64(vreinterpret_u64_u8(nibbles), 0));
+        }
+        uint8x16_t mCtrl;
+#else
+        template <typename PRED>
+        BitMask scalar(PRED pred) const
+        {
+            U32 mask = 0;
+            for (U32 i = 0; i < GROUP_WIDTH; ++i)
+            {
+                mask |= pred(mCtrl[i]) ? (1U << i) : 0;
+            }
+            return BitMask(mask);
+        }
+        U8 mCtrl[GROUP_WIDTH];
+#endif
+    };
+
+    /**
+     * The table under both containers. SLOT is what it stores, POLICY says
+     * how to get the key of one and how to make one.
+     */
+    template <typename SLOT, typename POLICY>
+    class Table
+    {
+    public:
+        typedef LLUUID key_type;
+        typedef SLOT value_type;
+        typedef size_t size_type;
+
+        template <bool CONST>
+        class Iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef SLOT value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef std::conditional_t<CONST, const SLOT*, SLOT*> pointer;
+            typedef std::conditional_t<CONST, const SLOT&, SLOT&> reference;
+            typedef std::conditional_t<CONST, const Table*, Table*> table_ptr;
+
+            Iterator() = default;
+            Iterator(table_ptr table, size_t index) : mTable(table), mIndex(index) {}
+            // iterator converts to const_iterator
+            template <bool OTHER, typename = std::enable_if_t<CONST && !OTHER>>
+            Iterator(const Iterator<OTHER>& other) : mTable(other.mTable), mIndex(other.mIndex) {}
+
+            reference operator*() const { return mTable->mSlots[mIndex]; }
+            pointer operator->() const { return &mTable->mSlots[mIndex]; }
+
+            Iterator& operator++()
+            {
+                mIndex = mTable->nextFull(mIndex + 1);
+                return *this;
+            }
+
+            Iterator operator++(int)
+            {
+                Iterator prev(*this);
+                ++*this;
+                return prev;
+            }
+
+            template <bool OTHER>
+            bool operator==(const Iterator<OTHER>& other) const { return mIndex == other.mIndex; }
+            template <bool OTHER>
+            bool operator!=(const Iterator<OTHER>& other) const { return mIndex != other.mIndex; }
+
+        private:
+            friend class Table;
+            template <bool> friend class Iterator;
+
+            table_ptr mTable = nullptr;
+            size_t mIndex = 0;
+        };
+
+        typedef Iterator<false> iterator;
+        typedef Iterator<true> const_iterator;
+
+        Table() = default;
+
+        Table(const Table& other)
+        {
+            if (other.mSize)
+            {
+                allocate(other.mCapacity);
+                memcpy(mCtrl, other.mCtrl, mCapacity);
+                for (size_t i = 0; i < mCapacity; ++i)
+                {
+                    if (isFull(mCtrl[i]))
+                    {
+                        new (&mSlots[i]) SLOT(other.mSlots[i]);
+                    }
+                }
+                mSize = other.mSize;
+                mGrowthLeft = other.mGrowthLeft;
+            }
+        }
+
+        Table(Table&& other) noexcept
+        {
+            swap(other);
+        }
+
+        Table& operator=(const Table& other)
+        {
+            if (this != &other)
+            {
+                Table copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        Table& operator=(Table&& other) noexcept
+        {
+            Table moved(std::move(other));
+            swap(moved);
+            return *this;
+        }
+
+        ~Table()
+        {
+            destroy();
+        }
+
+        void swap(Table& other) noexcept
+        {
+            std::swap(mCtrl, other.mCtrl);
+            std::swap(mSlots, other.mSlots);
+            std::swap(mCapacity, other.mCapacity);
+            std::swap(mSize, other.mSize);
+            std::swap(mGrowthLeft, other.mGrowthLeft);
+        }
+
+        iterator begin() { return iterator(this, nextFull(0)); }
+        iterator end() { return iterator(this, mCapacity); }
+        const_iterator begin() const { return const_iterator(this, nextFull(0)); }
+        const_iterator end() const { return const_iterator(this, mCapacity); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+        bool empty() const { return mSize == 0; }
+        size_t size() const { return mSize; }
+        size_t capacity() const { return mCapacity; }
+
+        iterator find(const LLUUID& key)
+        {
+            return iterator(this, findIndex(key));
+        }
+
+        const_iterator find(const LLUUID& key) const
+        {
+            return const_iterator(this, findIndex(key));
+        }
+
+        size_t count(const LLUUID& key) const
+        {
+            return findIndex(key) != mCapacity ? 1 : 0;
+        }
+
+        bool contains(const LLUUID& key) const
+        {
+            return findIndex(key) != mCapacity;
+        }
+
+        size_t erase(const LLUUID& key)
+        {
+            size_t index = findIndex(key);
+            if (index == mCapacity)
+            {
+                return 0;
+            }
+            eraseIndex(index);
+            return 1;
+        }
+
+        // Returns the entry after the erased one, as std::unordered_map does
+        iterator erase(const_iterator pos)
+        {
+            eraseIndex(pos.mIndex);
+            return iterator(this, nextFull(pos.mIndex + 1));
+        }
+
+        // Keeps the capacity, like the std containers' clear()
+        void clear()
+        {
+            if (mCapacity)
+            {
+                destroySlots();
+                memset(mCtrl, CTRL_EMPTY, mCapacity);
+                mSize = 0;
+                mGrowthLeft = maxLoad(mCapacity);
+            }
+        }
+
+        // Room for count entries without another rehash
+        void reserve(size_t count)
+        {
+            if (count > mSize + mGrowthLeft)
+            {
+                rehash(capacityFor(count));
+            }
+        }
+
+    protected:
+        template <typename... ARGS>
+        std::pair<iterator, bool> emplaceKey(const LLUUID& key, ARGS&&... args)
+        {
+            U64 h = hash(key);
+            size_t index = findIndex(key, h);
+            if (index != mCapacity)
+            {
+                return { iterator(this, index), false };
+            }
+
+            index = findInsertSlot(h);
+            if (mGrowthLeft == 0 && mCtrl[index] == CTRL_EMPTY)
+            {
+                // full of live entries, grow; mostly deleted ones, just
+                // clear them out
+                rehash(mSize * 2 < maxLoad(mCapacity) ? mCapacity : mCapacity * 2);
+                index = findInsertSlot(h);
+            }
+
+            POLICY::construct(&mSlots[index], key, std::forward<ARGS>(args)...);
+            if (mCtrl[index] == CTRL_EMPTY)
+            {
+                --mGrowthLeft;
+            }
+            mCtrl[index] = h2(h);
+            ++mSize;
+            return { iterator(this, index), true };
+        }
+
+    private:
+        static bool isFull(U8 ctrl) { return (ctrl & 0x80) == 0; }
+        static U8 h2(U64 h) { return (U8)(h & 0x7f); }
+        static size_t maxLoad(size_t capacity) { return capacity - capacity / 8; }
+
+        static size_t capacityFor(size_t count)
+        {
+            size_t capacity = GROUP_WIDTH;
+            while (maxLoad(capacity) < count)
+            {
+                capacity *= 2;
+            }
+            return capacity;
+        }
+
+        // Groups in triangular order visit every group of a power of two
+        // table once.
+        class Probe
+        {
+        public:
+            Probe(U64 h, size_t groups) : mMask(groups - 1), mGroup((size_t)(h >> 7) & mMask) {}
+            size_t offset() const { return mGroup * GROUP_WIDTH; }
+            void next()
+            {
+                ++mStride;
+                mGroup = (mGroup + mStride) & mMask;
+            }
+
+        private:
+            size_t mMask;
+            size_t mGroup;
+            size_t mStride = 0;
+        };
+
+        size_t findIndex(const LLUUID& key) const
+        {
+            return findIndex(key, hash(key));
+        }
+
+        size_t findIndex(const LLUUID& key, U64 h) const
+        {
+            if (!mSize)
+            {
+                return mCapacity;
+            }
+            Probe probe(h, mCapacity / GROUP_WIDTH);
+            while (true)
+            {
+                Group group(mCtrl + probe.offset());
+                for (BitMask match = group.match(h2(h)); match; match.clearLowest())
+                {
+                    size_t index = probe.offset() + match.lowest();
+                    if (equal(POLICY::key(mSlots[index]), key))
+                    {
+                        return index;
+                    }
+                }
+                if (group.matchEmpty())
+                {
+                    return mCapacity;
+                }
+                probe.next();
+            }
+        }
+
+        // First empty or deleted slot on h's probe sequence. Only called with
+        // room in the table, and the load limit guarantees some.
+        size_t findInsertSlot(U64 h)
+        {
+            if (!mCapacity)
+            {
+                rehash(GROUP_WIDTH);
+            }
+            Probe probe(h, mCapacity / GROUP_WIDTH);
+            while (true)
+            {
+                BitMask free_slots = Group(mCtrl + probe.offset()).matchEmptyOrDeleted();
+                if (free_slots)
+                {
+                    return probe.offset() + free_slots.lowest();
+                }
+                probe.next();
+            }
+        }
+
+        size_t nextFull(size_t index) const
+        {
+            while (index < mCapacity && !isFull(mCtrl[index]))
+            {
+                ++index;
+            }
+            return index;
+        }
+
+        void eraseIndex(size_t index)
+        {
+            POLICY::destroy(&mSlots[index]);
+            --mSize;
+            // A lookup stops at the first group with an empty slot. If this
+            // group already has one, nothing was ever placed past it while
+            // this slot was taken, so it can go back to empty; otherwise it
+            // must stay a step on the way.
+            size_t group = index & ~(GROUP_WIDTH - 1);
+            if (Group(mCtrl + group).matchEmpty())
+            {
+                mCtrl[index] = CTRL_EMPTY;
+                ++mGrowthLeft;
+            }
+            else
+            {
+                mCtrl[index] = CTRL_DELETED;
+            }
+        }
+
+        void allocate(size_t capacity)
+        {
+            mCapacity = capacity;
+            mCtrl = (U8*)ll_aligned_malloc_16(capacity);
+            memset(mCtrl, CTRL_EMPTY, capacity);
+            mSlots = std::allocator<SLOT>().allocate(capacity);
+            mSize = 0;
+            mGrowthLeft = maxLoad(capacity);
+        }
+
+        void rehash(size_t capacity)
+        {
+            U8* old_ctrl = mCtrl;
+            SLOT* old_slots = mSlots;
+            size_t old_capacity = mCapacity;
+
+            allocate(capacity);
+            for (size_t i = 0; i < old_capacity; ++i)
+            {
+                if (isFull(old_ctrl[i]))
+                {
+                    U64 h = hash(POLICY::key(old_slots[i]));
+                    size_t index = findInsertSlot(h);
+                    new (&mSlots[index]) SLOT(std::move(old_slots[i]));
+                    POLICY::destroy(&old_slots[i]);
+                    mCtrl[index] = h2(h);
+                    ++mSize;
+                    --mGrowthLeft;
+                }
+            }
+            if (old_capacity)
+            {
+                ll_aligned_free_16(old_ctrl);
+                std::allocator<SLOT>().deallocate(old_slots, old_capacity);
+            }
+        }
+
+        void destroySlots()
+        {
+            for (size_t i = 0; i < mCapacity; ++i)
+            {
+                if (isFull(mCtrl[i]))
+                {
+                    POLICY::destroy(&mSlots[i]);
+                }
+            }
+        }
+
+        void destroy()
+        {
+            if (mCapacity)
+            {
+                destroySlots();
+                ll_aligned_free_16(mCtrl);
+                std::allocator<SLOT>().deallocate(mSlots, mCapacity);
+                mCtrl = nullptr;
+                mSlots = nullptr;
+                mCapacity = mSize = mGrowthLeft = 0;
+            }
+        }
+
+        U8* mCtrl = nullptr;
+        SLOT* mSlots = nullptr;
+        size_t mCapacity = 0;   // 0 or a power of two, at least GROUP_WIDTH
+        size_t mSize = 0;
+        size_t mGrowthLeft = 0; // empty slots we may still fill
+    };
+
+    template <typename T>
+    struct MapPolicy
+    {
+        typedef std::pair<const LLUUID, T> slot_t;
+
+        static const LLUUID& key(const slot_t& slot) { return slot.first; }
+
+        template <typename... ARGS>
+        static void construct(slot_t* where, const LLUUID& key, ARGS&&... args)
+        {
+            new (where) slot_t(std::piecewise_construct, std::forward_as_tuple(key),
+                               std::forward_as_tuple(std::forward<ARGS>(args)...));
+        }
+
+        static void destroy(slot_t* slot) { slot->~slot_t(); }
+    };
+
+    struct SetPolicy
+    {
+        static const LLUUID& key(const LLUUID& slot) { return slot; }
+        static void construct(LLUUID* where, const LLUUID& key) { new (where) LLUUID(key); }
+        static void destroy(LLUUID*) {}
+    };
+} // namespace LLUUIDHash
+
+template <typename T>
+class LLUUIDHashMap : public LLUUIDHash::Table<std::pair<const LLUUID, T>, LLUUIDHash::MapPolicy<T>>
+{
+    typedef LLUUIDHash::Table<std::pair<const LLUUID, T>, LLUUIDHash::MapPolicy<T>> table_t;
+
+public:
+    typedef T mapped_type;
+    typedef typename table_t::value_type value_type;
+    typedef typename table_t::iterator iterator;
+    typedef typename table_t::const_iterator const_iterator;
+
+    T& operator[](const LLUUID& key)
+    {
+        return this->emplaceKey(key).first->second;
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        return this->emplaceKey(value.first, value.second);
+    }
+
+    // Like std::unordered_map::try_emplace(): args are only used if key is
+    // new
+    template <typename... ARGS>
+    std::pair<iterator, bool> emplace(const LLUUID& key, ARGS&&... args)
+    {
+        return this->emplaceKey(key, std::forward<ARGS>(args)...);
+    }
+
+    template <typename... ARGS>
+    std::pair<iterator, bool> try_emplace(const LLUUID& key, ARGS&&... args)
+    {
+        return this->emplaceKey(key, std::forward<ARGS>(args)...);
+    }
+};
+
+class LLUUIDHashSet : public LLUUIDHash::Table<LLUUID, LLUUIDHash::SetPolicy>
+{
+    typedef LLUUIDHash::Table<LLUUID, LLUUIDHash::SetPolicy> table_t;
+
+public:
+    // entries are keys, so never modifiable in place
+    typedef table_t::const_iterator iterator;
+    typedef table_t::const_iterator const_iterator;
+
+    LLUUIDHashSet() = default;
+
+    template <typename ITER>
+    LLUUIDHashSet(ITER first, ITER last)
+    {
+        for (; first != last; ++first)
+        {
+            insert(*first);
+        }
+    }
+
+    const_iterator begin() const { return table_t::begin(); }
+    const_iterator end() const { return table_t::end(); }
+    const_iterator find(const LLUUID& key) const { return table_t::find(key); }
+
+    std::pair<const_iterator, bool> insert(const LLUUID& key)
+    {
+        auto result = emplaceKey(key);
+        return { result.first, result.second };
+    }
+};
+
+#endif // LL_LLUUIDHASHMAP_H
@@ -615,6 +615,15 @@ LuaState::LuaState()
     }
     /*---------------------------- feature flag ----------------------------*/
 
+    try
+    {
+        mSliceSeconds = LL::CommonControl::get("Global", "LuaTimeSliceMs").asReal() / 1000.f;
+    }
+    catch (const LL::CommonControl::Error&)
+    {
+        // not a viewer, or an older settings file: keep the default
+    }
+
     mState = luaL_newstate();
     // Ensure that we can always find this LuaState instance, given the
     // lua_State we just created or any of its coroutines.
@@ -986,6 +995,8 @@ LuaState& LuaState::getParent(lua_State* L)
 void LuaState::set_interrupts_counter(S32 counter)
 {
     mInterrupts = counter;
+    // called when the script has just yielded, so it starts a new time slice
+    mSliceTimer.reset();
 }
 
 void LuaState::check_interrupts_counter()
@@ -1002,11 +1013,16 @@ void LuaState::check_interrupts_counter()
     {
         lluau::error(mState, "Possible infinite loop, terminated.");
     }
-    else if (mInterrupts % INTERRUPTS_SUSPEND_LIMIT == 0)
+    else if (mInterrupts % INTERRUPTS_SUSPEND_LIMIT == 0 ||
+             // a script calling into expensive viewer functions can run far
+             // longer than a frame within its interrupts budget
+             mSliceTimer.getElapsedTimeF32() > mSliceSeconds)
     {
         LL_DEBUGS("Lua.suspend") << LLCoros::getName() << " suspending at "
-                                 << mInterrupts << " interrupts" << LL_ENDL;
+                                 << mInterrupts << " interrupts after "
+                                 << mSliceTimer.getElapsedTimeF32() * 1000.f << " ms" << LL_ENDL;
         llcoro::suspend();
+        mSliceTimer.reset();
     }
 }
 
@@ -19,6 +19,7 @@
 #include "fsyspath.h"
 #include "llerror.h"
 #include "llsd.h"
+#include "lltimer.h"
 #include "scriptcommand.h"
 #include "stringize.h"
 #include <exception>                // std::uncaught_exceptions()
@@ -129,6 +130,9 @@ private:
     lua_State* mState{ nullptr };
     std::string mError;
     S32 mInterrupts{ 0 };
+    // time the script has run since it last let the viewer have a turn
+    LLTimer mSliceTimer;
+    F32 mSliceSeconds{ 0.002f };
 };
 
 /*****************************************************************************
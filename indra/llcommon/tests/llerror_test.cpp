@@ -963,6 +963,46 @@ namespace tut
     }
 }
 
+namespace tut
+{
+    template<> template<>
+    void ErrorTestObject::test<19>()
+        // asynchronous logging, with repeats coalesced
+    {
+        LLError::setAsyncLogging(true);
+        for (int i = 0; i < 3; ++i)
+        {
+            LL_INFOS() << "same again" << LL_ENDL;
+        }
+        LL_INFOS() << "something else" << LL_ENDL;
+        LLError::flushAsyncLogging();
+        LLError::setAsyncLogging(false);
+        ensure("async logging still on", !LLError::getAsyncLogging());
+
+        ensure_message_count(3);
+        ensure_message_field_equals(0, MSG_FIELD, "same again");
+        ensure_message_field_equals(1, MSG_FIELD, "(previous message repeated 2 times)");
+        ensure_message_field_equals(2, MSG_FIELD, "something else");
+    }
+
+    template<> template<>
+    void ErrorTestObject::test<20>()
+        // per-tag ONCE policy
+    {
+        LLError::setTagOnce("Chatty");
+        for (int i = 0; i < 10; ++i)
+        {
+            LL_INFOS("Chatty") << "over and over" << LL_ENDL;
+            LL_INFOS("Quiet") << "not once" << LL_ENDL;
+        }
+        ensure_message_count(12);
+        ensure_message_field_equals(0, MSG_FIELD, "ONCE: over and over");
+        ensure_message_field_equals(1, MSG_FIELD, "not once");
+        ensure_message_field_equals(11, MSG_FIELD, "not once");
+        ensure_message_field_equals(10, MSG_FIELD, "ONCE (10th time seen): over and over");
+    }
+}
+
 /* Tests left:
     handling of classes without LOG_CLASS
 
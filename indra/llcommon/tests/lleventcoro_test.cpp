@@ -314,4 +314,32 @@ namespace tut
         set_test_name("LLEventLogProxyFor<LLEventMailDrop>");
         tut::test< LLEventLogProxyFor<LLEventMailDrop> >();
     }
+
+    // touch about depth bytes of stack
+    static size_t dig(size_t depth)
+    {
+        volatile char frame[4096];
+        frame[0] = char(depth);
+        return (depth > sizeof(frame))? dig(depth - sizeof(frame)) + frame[0] : frame[0];
+    }
+
+    template<> template<>
+    void object::test<8>()
+    {
+        set_test_name("stack pool and high water marks");
+        LLCoros::instance().setStackDebug(true);
+        for (int i = 0; i < 3; ++i)
+        {
+            LLCoros::instance().launch("test<8>", [](){ dig(40000); },
+                                       LLCoros::STACK_SMALL);
+            // let the scheduler clean up the finished coroutine, handing
+            // its stack back
+            llcoro::suspend();
+        }
+        LLCoros::instance().setStackDebug(false);
+        LLSD high(LLCoros::instance().getStackHighWater()["test<8>"]);
+        ensure("used", high["used"].asInteger() >= 40000);
+        ensure("within the stack", high["used"].asInteger() < high["size"].asInteger());
+        ensure_equals("small stack", high["size"].asInteger(), 128*1024);
+    }
 }
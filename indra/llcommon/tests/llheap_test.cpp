@@ -0,0 +1,115 @@
+/**
+ * @file   llheap_test.cpp
+ * @brief  Test for llheap.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Copyright (c) 2026, Linden Research, Inc.
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "llheap.h"
+// std headers
+#include <cstring>
+#include <memory>
+#include <thread>
+// other Linden headers
+#include "llmemory.h"
+#include "llsd.h"
+#include "../test/lltut.h"
+
+namespace
+{
+    struct Widget
+    {
+        LL_HEAP_OPERATORS(LLHeap::HEAP_UI)
+
+        virtual ~Widget() = default;
+        char mPayload[40];
+    };
+
+    struct BigWidget : public Widget
+    {
+        char mMore[200];
+    };
+}
+
+namespace tut
+{
+    struct llheap_data
+    {
+    };
+    typedef test_group<llheap_data> llheap_group;
+    typedef llheap_group::object object;
+    llheap_group llheapgrp("llheap");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("allocate, align and count");
+        size_t before = LLHeap::getInUse(LLHeap::HEAP_GEOMETRY);
+        for (size_t alignment : { 16, 64, 4096 })
+        {
+            U64 allocations = LLHeap::getAllocations(LLHeap::HEAP_GEOMETRY);
+            void* ptr = LLHeap::allocate(LLHeap::HEAP_GEOMETRY, 1000, alignment);
+            ensure("allocated", ptr != nullptr);
+            ensure_equals("allocation counted", LLHeap::getAllocations(LLHeap::HEAP_GEOMETRY), allocations + 1);
+            ensure_equals("aligned", (uintptr_t)ptr % alignment, (uintptr_t)0);
+            memset(ptr, 0xab, 1000);
+            ensure_equals("counted", LLHeap::getInUse(LLHeap::HEAP_GEOMETRY), before + 1000);
+            LLHeap::free(LLHeap::HEAP_GEOMETRY, ptr, 1000, alignment);
+            ensure_equals("uncounted", LLHeap::getInUse(LLHeap::HEAP_GEOMETRY), before);
+        }
+        // as with free()
+        LLHeap::free(LLHeap::HEAP_GEOMETRY, nullptr, 1000);
+        ensure_equals("null free", LLHeap::getInUse(LLHeap::HEAP_GEOMETRY), before);
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("class operators count the dynamic size");
+        size_t before = LLHeap::getInUse(LLHeap::HEAP_UI);
+        Widget* widget = new BigWidget;
+        ensure_equals("derived size", LLHeap::getInUse(LLHeap::HEAP_UI), before + sizeof(BigWidget));
+        delete widget;
+        ensure_equals("freed through base", LLHeap::getInUse(LLHeap::HEAP_UI), before);
+
+        alignas(Widget) char storage[sizeof(Widget)];
+        Widget* placed = new (storage) Widget;
+        ensure_equals("placement not counted", LLHeap::getInUse(LLHeap::HEAP_UI), before);
+        placed->~Widget();
+    }
+
+    template<> template<>
+    void object::test<3>()
+    {
+        set_test_name("free from another thread");
+        void* ptr = nullptr;
+        std::thread([&ptr]() { ptr = LLHeap::allocate(LLHeap::HEAP_IMAGE, 12345); }).join();
+        ensure("allocated on the other thread", ptr != nullptr);
+        LLHeap::free(LLHeap::HEAP_IMAGE, ptr, 12345);
+
+        // a buffer LLHeap didn't allocate goes back where it came from; it
+        // was never counted
+        void* foreign = ll_aligned_malloc_16(256);
+        LLHeap::free(LLHeap::HEAP_IMAGE, foreign, 0);
+
+        LLHeap::purge();
+    }
+
+    template<> template<>
+    void object::test<4>()
+    {
+        set_test_name("LLSD values live in the LLSD heap");
+        size_t before = LLHeap::getInUse(LLHeap::HEAP_LLSD);
+        {
+            LLSD sd;
+            sd["key"] = "value";
+            ensure("counted", LLHeap::getInUse(LLHeap::HEAP_LLSD) > before);
+        }
+        ensure_equals("freed", LLHeap::getInUse(LLHeap::HEAP_LLSD), before);
+    }
+}
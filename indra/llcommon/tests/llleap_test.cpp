@@ -656,4 +656,22 @@ namespace tut
         set_test_name("very large message");
         test_or_split(PYTHON, reader_module, get_test_name(), BUFFERED_LENGTH);
     }
+
+    template<> template<>
+    void object::test<11>()
+    {
+        set_test_name("binary batch");
+        Result result;
+        NamedExtTempFile script("py",
+                                [&](std::ostream& out){ out <<
+                                "from " << reader_module << " import *\n"
+                                // Result keeps the last data it gets, so the
+                                // batch passes only if both entries are posted
+                                // in order
+                                "put(llsd.format_binary([\n"
+                                "    dict(pump='" << result.getName() << "', data='bad: first only'),\n"
+                                "    dict(pump='" << result.getName() << "', data='')]))\n";});
+        waitfor(LLLeap::create(get_test_name(), StringVec{PYTHON, script.getName()}));
+        result.ensure();
+    }
 } // namespace tut
@@ -0,0 +1,87 @@
+/**
+ * @file   llmappedfile_test.cpp
+ * @brief  Test for llmappedfile.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Copyright (c) 2026, Linden Research, Inc.
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "llmappedfile.h"
+// other Linden headers
+#include "llfile.h"
+#include "../test/lltut.h"
+#include "../test/namedtempfile.h"
+
+#include <cstring>
+
+namespace tut
+{
+    struct llmappedfile_data
+    {
+        llmappedfile_data():
+            mPath(NamedTempFile::temp_path("llmappedfile").string())
+        {}
+        ~llmappedfile_data()
+        {
+            LLFile::remove(mPath, 1);
+        }
+
+        std::string mPath;
+    };
+    typedef test_group<llmappedfile_data> llmappedfile_group;
+    typedef llmappedfile_group::object object;
+    llmappedfile_group llmappedfilegrp("llmappedfile");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("writable mapping creates and sizes the file");
+        LLMappedFile mapped;
+        ensure("mapped a new file", mapped.open(mPath, 4096));
+        ensure("isOpen()", mapped.isOpen());
+        ensure_equals("getSize()", mapped.getSize(), 4096);
+        mapped.close();
+        ensure("closed", ! mapped.isOpen());
+
+        llstat file_status;
+        ensure_equals("stat()", LLFile::stat(mPath, &file_status), 0);
+        ensure_equals("file grown to the mapped size", (size_t)file_status.st_size, 4096);
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("stores reach the file");
+        const char* text = "mapped entries";
+        {
+            LLMappedFile mapped;
+            ensure("mapped for write", mapped.open(mPath, 64));
+            memcpy(mapped.getData() + 10, text, strlen(text));
+            ensure("flush()", mapped.flush());
+        }
+        LLMappedFile reader;
+        ensure("mapped for read", reader.open(mPath, 64, true));
+        ensure("read only", reader.isReadOnly());
+        ensure_equals("contents",
+                      std::string((const char*)reader.getData() + 10, strlen(text)),
+                      std::string(text));
+    }
+
+    template<> template<>
+    void object::test<3>()
+    {
+        set_test_name("read only mapping requires an existing, large enough file");
+        LLMappedFile mapped;
+        ensure("missing file", ! mapped.open(mPath, 64, true));
+        {
+            LLMappedFile writer;
+            ensure("create", writer.open(mPath, 32));
+        }
+        ensure("file too short", ! mapped.open(mPath, 64, true));
+        ensure("exact size", mapped.open(mPath, 32, true));
+    }
+} // namespace tut
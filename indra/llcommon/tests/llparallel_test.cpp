@@ -0,0 +1,130 @@
+/**
+ * @file   llparallel_test.cpp
+ * @date   2026-10-14
+ * @brief  Test for llparallel.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Copyright (c) 2026, Linden Research, Inc.
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "llparallel.h"
+// STL headers
+#include <string>
+#include <vector>
+// std headers
+#include <atomic>
+#include <stdexcept>
+// external library headers
+// other Linden headers
+#include "../test/lltut.h"
+
+/*****************************************************************************
+*   TUT
+*****************************************************************************/
+namespace tut
+{
+    struct llparallel_data
+    {
+    };
+    typedef test_group<llparallel_data> llparallel_group;
+    typedef llparallel_group::object object;
+    llparallel_group llparallelgrp("llparallel");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("parallel_for");
+        std::vector<S32> values(100000);
+        std::atomic<S32> pieces{ 0 };
+        LL::parallel_for(size_t(0), values.size(), size_t(1000),
+            [&values, &pieces](size_t first, size_t last)
+            {
+                ensure("piece too short", last - first >= 1000 || last == values.size());
+                for (size_t i = first; i < last; ++i)
+                {
+                    values[i] += S32(i);
+                }
+                ++pieces;
+            });
+        size_t i = 0;
+        while (i < values.size() && values[i] == S32(i))
+        {
+            ++i;
+        }
+        ensure_equals("first wrong value", i, values.size());
+        ensure("never split", LL::getComputeWidth() == 0 || pieces > 1);
+
+        // empty and backwards ranges do nothing
+        LL::parallel_for(10, 10, 1, [](S32, S32){ fail("ran empty range"); });
+        LL::parallel_for(10, 5, 1, [](S32, S32){ fail("ran backwards range"); });
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("nested TaskGroups");
+        // Waiting inside a compute task must help rather than deadlock,
+        // however many of them are waiting at once.
+        std::atomic<S32> ran{ 0 };
+        LL::TaskGroup outer;
+        for (S32 i = 0; i < 32; ++i)
+        {
+            outer.run([&ran]()
+            {
+                LL::TaskGroup inner;
+                for (S32 j = 0; j < 32; ++j)
+                {
+                    inner.run([&ran](){ ++ran; });
+                }
+                inner.wait();
+            });
+        }
+        outer.wait();
+        ensure_equals("wrong number of tasks run", ran.load(), 32 * 32);
+    }
+
+    template<> template<>
+    void object::test<3>()
+    {
+        set_test_name("exceptions");
+        std::atomic<S32> ran{ 0 };
+        bool caught = false;
+        try
+        {
+            LL::parallel_for(0, 64, 1, [&ran](S32 first, S32 last)
+            {
+                ++ran;
+                if (first <= 17 && 17 < last)
+                {
+                    throw std::runtime_error("seventeen");
+                }
+            });
+        }
+        catch (const std::runtime_error& exc)
+        {
+            caught = true;
+            ensure_equals("wrong exception", std::string(exc.what()), "seventeen");
+        }
+        ensure("exception not rethrown", caught);
+
+        // the TaskGroup itself is reusable after wait() rethrows
+        LL::TaskGroup group;
+        group.run([](){ throw std::runtime_error("once"); });
+        caught = false;
+        try
+        {
+            group.wait();
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+        ensure("TaskGroup didn't rethrow", caught);
+        group.run([&ran](){ ++ran; });
+        group.wait();
+    }
+} // namespace tut
@@ -0,0 +1,317 @@
+/**
+ * @file llsdparse_test.cpp
+ * @date 2026-10
+ * @brief Checks and timings for parsing LLSD from memory buffers
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llsd.h"
+#include "llsdserialize.h"
+#include "llsdserialize_xml.h"
+#include "llsdutil.h"
+#include "lltimer.h"
+
+#include "../test/lltut.h"
+#include "stringize.h"
+
+#include <sstream>
+
+namespace
+{
+    // The kind of reply the event queue gets: a few events with positions
+    // and ids in them.
+    LLSD make_event_reply()
+    {
+        LLSD events(LLSD::emptyArray());
+        for (S32 i = 0; i < 40; ++i)
+        {
+            LLSD body;
+            LLUUID id;
+            id.generate();
+            body["AgentID"] = id;
+            body["SessionID"] = id;
+            body["Position"] = llsd::array(128.5 + i, 64.25, 22.0 + i / 3.0);
+            body["Message"] = stringize("Hello & <welcome> number ", i);
+            body["Timestamp"] = (S32)(1700000000 + i);
+            body["Offline"] = (i % 2 == 0);
+            events.append(llsd::map("message", "ChatterBoxInvitation", "body", body));
+        }
+        return llsd::map("events", events, "id", 12345);
+    }
+
+    // An inventory skeleton: a long array of small maps.
+    LLSD make_inventory()
+    {
+        LLSD folders(LLSD::emptyArray());
+        for (S32 i = 0; i < 2000; ++i)
+        {
+            LLUUID id, parent;
+            id.generate();
+            parent.generate();
+            folders.append(llsd::map(
+                "folder_id", id,
+                "parent_id", parent,
+                "name", stringize("Folder ", i),
+                "type_default", (S32)(i % 8) - 1,
+                "version", i * 3));
+        }
+        return folders;
+    }
+
+    // Like settings.xml: a map of maps with a Type and a Value.
+    LLSD make_settings()
+    {
+        LLSD settings;
+        for (S32 i = 0; i < 1500; ++i)
+        {
+            LLSD setting;
+            setting["Comment"] = stringize("What setting ", i, " controls, in a sentence or two.");
+            setting["Persist"] = 1;
+            switch (i % 4)
+            {
+            case 0:
+                setting["Type"] = "Boolean";
+                setting["Value"] = (i % 3) ? 1 : 0;
+                break;
+            case 1:
+                setting["Type"] = "F32";
+                setting["Value"] = 0.25 * i;
+                break;
+            case 2:
+                setting["Type"] = "String";
+                setting["Value"] = "https://example.com/path?a=1&b=2";
+                break;
+            default:
+                setting["Type"] = "Vector3";
+                setting["Value"] = llsd::array(1.0, -2.5, 1e-3);
+                break;
+            }
+            settings[stringize("Setting", i)] = setting;
+        }
+        return settings;
+    }
+
+    // Average milliseconds for one parse over some repeats.
+    template <typename PARSE>
+    F64 time_parses(PARSE parse)
+    {
+        const S32 REPEATS = 5;
+        LLTimer timer;
+        for (S32 i = 0; i < REPEATS; ++i)
+        {
+            parse();
+        }
+        return timer.getElapsedTimeF64() * 1000.0 / REPEATS;
+    }
+}
+
+namespace tut
+{
+    struct sd_parse_data
+    {
+        std::vector<std::pair<std::string, LLSD>> mPayloads{
+            { "event reply", make_event_reply() },
+            { "inventory", make_inventory() },
+            { "settings", make_settings() }
+        };
+
+        static std::string format(const LLSD& sd, LLSDFormatter* formatter,
+                                  LLSDFormatter::EFormatterOptions options = LLSDFormatter::OPTIONS_NONE)
+        {
+            LLPointer<LLSDFormatter> holder(formatter);
+            std::ostringstream ostr;
+            formatter->format(sd, ostr, options);
+            return ostr.str();
+        }
+
+        // Parses doc from a stream and from the buffer, expecting the same
+        // result and count from both, and logs how long each one took.
+        template <typename PARSER>
+        void compare(const std::string& format_name, const std::string& payload, const std::string& doc)
+        {
+            LLSD from_stream, from_buffer;
+            S32 stream_count = 0, buffer_count = 0;
+            F64 stream_ms = time_parses([&]()
+            {
+                std::istringstream istr(doc);
+                LLPointer<LLSDParser> parser(new PARSER);
+                stream_count = parser->parse(istr, from_stream, doc.size());
+            });
+            F64 buffer_ms = time_parses([&]()
+            {
+                LLPointer<LLSDParser> parser(new PARSER);
+                buffer_count = parser->parseBuffer(doc.data(), doc.size(), from_buffer);
+            });
+
+            std::string what(stringize(format_name, ' ', payload));
+            ensure(what + " parses", stream_count > 0);
+            ensure_equals(what + " count", buffer_count, stream_count);
+            ensure(what + " contents", llsd_equals(from_stream, from_buffer));
+
+            LL_INFOS("LLSDParse") << what << ", " << doc.size() << " bytes: stream "
+                                  << stream_ms << "ms, buffer " << buffer_ms << "ms" << LL_ENDL;
+        }
+
+        // Whatever the stream parse makes of doc, good or bad, the buffer
+        // parse makes of it too.
+        template <typename PARSER>
+        void same(const std::string& what, const std::string& doc)
+        {
+            LLSD from_stream, from_buffer;
+            std::istringstream istr(doc);
+            LLPointer<LLSDParser> stream_parser(new PARSER);
+            S32 stream_count = stream_parser->parse(istr, from_stream, doc.size());
+            LLPointer<LLSDParser> buffer_parser(new PARSER);
+            S32 buffer_count = buffer_parser->parseBuffer(doc.data(), doc.size(), from_buffer);
+            ensure_equals(what + " count", buffer_count, stream_count);
+            ensure(what + " contents", llsd_equals(from_stream, from_buffer));
+        }
+    };
+
+    typedef test_group<sd_parse_data> sd_parse_test;
+    typedef sd_parse_test::object sd_parse_object;
+    tut::sd_parse_test sd_parse("LLSDParse");
+
+    template<> template<>
+    void sd_parse_object::test<1>()
+    {
+        set_test_name("notation payloads");
+        for (const auto& payload : mPayloads)
+        {
+            compare<LLSDNotationParser>("notation", payload.first,
+                                        format(payload.second, new LLSDNotationFormatter));
+            compare<LLSDNotationParser>("pretty notation", payload.first,
+                                        format(payload.second, new LLSDNotationFormatter,
+                                               LLSDFormatter::OPTIONS_PRETTY));
+        }
+    }
+
+    template<> template<>
+    void sd_parse_object::test<2>()
+    {
+        set_test_name("xml payloads");
+        for (const auto& payload : mPayloads)
+        {
+            compare<LLSDXMLParser>("xml", payload.first,
+                                   format(payload.second, new LLSDXMLFormatter));
+            compare<LLSDXMLParser>("pretty xml", payload.first,
+                                   format(payload.second, new LLSDXMLFormatter,
+                                          LLSDFormatter::OPTIONS_PRETTY));
+        }
+    }
+
+    template<> template<>
+    void sd_parse_object::test<3>()
+    {
+        set_test_name("binary payloads");
+        // no buffer parser of its own, but the same numbers for comparison
+        for (const auto& payload : mPayloads)
+        {
+            compare<LLSDBinaryParser>("binary", payload.first,
+                                      format(payload.second, new LLSDBinaryFormatter));
+        }
+    }
+
+    template<> template<>
+    void sd_parse_object::test<4>()
+    {
+        set_test_name("xml the buffer parser hands to expat");
+        same<LLSDXMLParser>("declaration",
+                            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<llsd><integer>3</integer></llsd>");
+        same<LLSDXMLParser>("comments and entities",
+                            "<!-- c --><llsd><map><!-- k --><key>a&amp;b</key>"
+                            "<string>x&#65;&#x42;\r\ny<!-- z --></string></map></llsd>");
+        same<LLSDXMLParser>("doctype",
+                            "<!DOCTYPE llsd><llsd><string>a</string></llsd>");
+        same<LLSDXMLParser>("cdata",
+                            "<llsd><string><![CDATA[<a>]]></string></llsd>");
+        same<LLSDXMLParser>("unknown element",
+                            "<llsd><array><foo/><integer>1</integer></array></llsd>");
+        same<LLSDXMLParser>("key without value",
+                            "<llsd><map><key>a</key></map></llsd>");
+        same<LLSDXMLParser>("llsd inside something else",
+                            "<outer><llsd><real>1.5</real></llsd></outer>");
+        same<LLSDXMLParser>("other binary encoding",
+                            "<llsd><array><binary encoding=\"base16\">00</binary></array></llsd>");
+        same<LLSDXMLParser>("truncated",
+                            "<llsd><map><key>a</key><string>b</str");
+        same<LLSDXMLParser>("bad character",
+                            "<llsd><string>a\x01</string></llsd>");
+        same<LLSDXMLParser>("trailing garbage",
+                            "<llsd><undef /></llsd><<<");
+    }
+
+    template<> template<>
+    void sd_parse_object::test<5>()
+    {
+        set_test_name("notation the buffer parser sees differently");
+        same<LLSDNotationParser>("escapes", "{'a\\'b':\"c\\x41\\n\"}");
+        same<LLSDNotationParser>("raw string", "[s(3)\"abc\",s(99)\"abc\"]");
+        same<LLSDNotationParser>("binary", "[b64\"QUJD\",b16\"414243\",b(3)\"ABC\"]");
+        same<LLSDNotationParser>("numbers", "[i-12,r1.5e3,r-0.0,r1e400,i99999999999]");
+        same<LLSDNotationParser>("truncated", "{'a':[i1,i2");
+        same<LLSDNotationParser>("duplicate keys", "{'a':i1,'a':i2}");
+    }
+
+    template<> template<>
+    void sd_parse_object::test<6>()
+    {
+        set_test_name("visiting builds what parsing does");
+        for (const auto& payload : mPayloads)
+        {
+            std::string docs[] = {
+                format(payload.second, new LLSDNotationFormatter),
+                format(payload.second, new LLSDXMLFormatter),
+                format(payload.second, new LLSDBinaryFormatter)
+            };
+            LLPointer<LLSDParser> parsers[] = {
+                new LLSDNotationParser, new LLSDXMLParser, new LLSDBinaryParser
+            };
+            const char* names[] = { "notation", "xml", "binary" };
+            for (S32 i = 0; i < 3; ++i)
+            {
+                // formatting can round reals, so against the parse, not the payload
+                std::string what(stringize(names[i], ' ', payload.first));
+                LLSD parsed;
+                S32 count = parsers[i]->parseBuffer(docs[i].data(), docs[i].size(), parsed);
+                ensure(what + " parses", count > 0);
+
+                LLSDTreeBuilder from_buffer;
+                parsers[i]->reset();
+                ensure_equals(what + " buffer count",
+                              parsers[i]->visitBuffer(docs[i].data(), docs[i].size(), from_buffer), count);
+                ensure(what + " buffer visited", from_buffer.done());
+                ensure(what + " buffer contents", llsd_equals(parsed, from_buffer.get()));
+
+                LLSDTreeBuilder from_stream;
+                std::istringstream istr(docs[i]);
+                parsers[i]->reset();
+                ensure_equals(what + " stream count",
+                              parsers[i]->visit(istr, from_stream, docs[i].size()), count);
+                ensure(what + " stream contents", llsd_equals(parsed, from_stream.get()));
+            }
+        }
+    }
+}
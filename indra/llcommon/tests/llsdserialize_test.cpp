@@ -1257,6 +1257,45 @@ namespace tut
             9);
     }
 
+    template<> template<>
+    void TestLLSDNotationParsingObject::test<22>()
+    {
+        std::string doc("[{'name':'a long enough name to leave the small string buffer',"
+                        "'id':u3c115e51-04f4-523c-9fa6-98aff1034730,'count':i42,"
+                        "'nested':{'real':r1.5,'on':true,'list':[i1,i2,'three']}}]");
+        LLSD expected;
+        {
+            std::istringstream istr(doc);
+            LLPointer<LLSDParser> parser = new LLSDNotationParser();
+            ensure_equals("heap parse", parser->parse(istr, expected, doc.size()), 1);
+        }
+
+        LLSD parsed;
+        {
+            std::istringstream istr(doc);
+            LLPointer<LLSDParser> parser = new LLSDNotationParser();
+            parser->setUseArena(true);
+            ensure_equals("arena parse", parser->parse(istr, parsed, doc.size()), 1);
+        }
+        ensure("arena parse matches", llsd_equals(parsed, expected));
+
+        // values from the arena keep working once the parse is over
+        LLSD copy(parsed);
+        copy[0]["nested"]["list"].append("four");
+        copy[0]["name"] = "renamed";
+        copy[0].erase("count");
+        ensure("copy unshared on write", llsd_equals(parsed, expected));
+        ensure_equals(copy[0]["nested"]["list"].size(), 4);
+        ensure_equals(copy[0]["name"].asString(), "renamed");
+        ensure("erased", !copy[0].has("count"));
+
+        parsed[0]["nested"]["added"] = "after the parse";
+        ensure_equals(parsed[0]["nested"].size(), 4);
+        expected = LLSD();
+        copy = LLSD();
+        ensure_equals(parsed[0]["id"].asUUID(), LLUUID("3c115e51-04f4-523c-9fa6-98aff1034730"));
+    }
+
     /**
      * @class TestLLSDBinaryParsing
      * @brief Concrete instance of a parse tester.
@@ -0,0 +1,104 @@
+/**
+ * @file   llsymbol_test.cpp
+ * @brief  Test for llsymbol.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Copyright (c) 2026, Linden Research, Inc.
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "llsymbol.h"
+// std headers
+#include <thread>
+#include <unordered_set>
+#include <vector>
+// other Linden headers
+#include "llevents.h"
+#include "llsd.h"
+#include "stringize.h"
+#include "../test/lltut.h"
+
+namespace tut
+{
+    struct llsymbol_data
+    {
+    };
+    typedef test_group<llsymbol_data> llsymbol_group;
+    typedef llsymbol_group::object object;
+    llsymbol_group llsymbolgrp("llsymbol");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("interning");
+        std::string built(stringize("sym", "bol"));
+        LLSymbol a("symbol"), b(built);
+        ensure("same name, same symbol", a == b);
+        ensure("same storage", &a.str() == &b.str());
+        ensure_equals("text", a.str(), "symbol");
+        ensure("different names", a != LLSymbol("symbols"));
+        ensure("default is empty", LLSymbol().empty() && LLSymbol() == LLSymbol(""));
+
+        ensure("find existing", LLSymbol::find("symbol") == a);
+        ensure("find doesn't intern", LLSymbol::find("never interned anywhere").empty());
+
+        LLSD sd;
+        sd[a] = 17;
+        ensure_equals("LLSD key", sd["symbol"].asInteger(), 17);
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("threads agree");
+        const S32 THREADS = 4, NAMES = 500;
+        std::vector<std::vector<LLSymbol>> made(THREADS);
+        std::vector<std::thread> threads;
+        for (S32 t = 0; t < THREADS; ++t)
+        {
+            threads.emplace_back([&made, t]()
+            {
+                for (S32 i = 0; i < NAMES; ++i)
+                {
+                    made[t].emplace_back(stringize("name", i));
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        std::unordered_set<LLSymbol> distinct;
+        for (S32 t = 0; t < THREADS; ++t)
+        {
+            for (S32 i = 0; i < NAMES; ++i)
+            {
+                ensure("same symbol on every thread", made[t][i] == made[0][i]);
+                distinct.insert(made[t][i]);
+            }
+        }
+        ensure_equals("distinct", distinct.size(), size_t(NAMES));
+    }
+
+    template<> template<>
+    void object::test<3>()
+    {
+        set_test_name("LLEventPumps by symbol");
+        static const LLSymbol name("llsymbol_test pump");
+        LLEventPump& pump(LLEventPumps::instance().obtain(name));
+        ensure("same pump by string", &pump == &LLEventPumps::instance().obtain(name.str()));
+        ensure("same pump by symbol", &pump == &LLEventPumps::instance().obtain(name));
+        LLSD received;
+        LLTempBoundListener conn(pump.listen("test", [&received](const LLSD& event)
+                                             {
+                                                 received = event;
+                                                 return false;
+                                             }));
+        ensure("post by symbol", LLEventPumps::instance().post(name, LLSD(5)));
+        ensure_equals("received", received.asInteger(), 5);
+        ensure("post to unknown", ! LLEventPumps::instance().post(LLSymbol("llsymbol_test nobody"), LLSD()));
+    }
+} // namespace tut
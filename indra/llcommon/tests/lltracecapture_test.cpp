@@ -0,0 +1,125 @@
+/**
+ * @file   lltracecapture_test.cpp
+ * @brief  Test for lltracecapture.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Copyright (c) 2026, Linden Research, Inc.
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "lltracecapture.h"
+// std headers
+#include <fstream>
+#include <sstream>
+#include <thread>
+// external library headers
+#include <boost/json.hpp>
+// other Linden headers
+#include "llfasttimer.h"
+#include "llfile.h"
+#include "../test/lltut.h"
+#include "../test/namedtempfile.h"
+
+namespace tut
+{
+    struct lltracecapture_data
+    {
+        lltracecapture_data():
+            mPath(NamedTempFile::temp_path("lltracecapture").string())
+        {
+            LLTrace::TraceCapture::setEnabled(true);
+        }
+        ~lltracecapture_data()
+        {
+            LLTrace::TraceCapture::setEnabled(false);
+            LLFile::remove(mPath, 1);
+        }
+
+        boost::json::array dump(F64 seconds)
+        {
+            ensure("dump", LLTrace::TraceCapture::dump(mPath, seconds));
+            std::ifstream in(mPath);
+            std::stringstream text;
+            text << in.rdbuf();
+            return boost::json::parse(text.str()).at("traceEvents").as_array();
+        }
+
+        static size_t count(const boost::json::array& events, const char* name, const char* ph)
+        {
+            size_t found = 0;
+            for (const auto& event : events)
+            {
+                const auto& obj = event.as_object();
+                if (obj.at("name").as_string() == name && obj.at("ph").as_string() == ph)
+                {
+                    ++found;
+                }
+            }
+            return found;
+        }
+
+        std::string mPath;
+    };
+    typedef test_group<lltracecapture_data> lltracecapture_group;
+    typedef lltracecapture_group::object object;
+    lltracecapture_group lltracecapturegrp("lltracecapture");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("scopes, instants and thread names");
+        LLTrace::TraceCapture::nameThread("Tester");
+        U64 now = LLTrace::BlockTimer::getCPUClockCount64();
+        LLTrace::TraceCapture::recordScope("test \"scope\"", now - 1000, now);
+        LLTrace::TraceCapture::instant("test instant");
+        std::thread([]()
+        {
+            LLTrace::TraceCapture::nameThread("Helper");
+            U64 now = LLTrace::BlockTimer::getCPUClockCount64();
+            LLTrace::TraceCapture::recordScope("helper scope", now - 1000, now);
+        }).join();
+
+        boost::json::array events(dump(10.0));
+        ensure_equals("scope", count(events, "test \"scope\"", "X"), 1);
+        ensure_equals("instant", count(events, "test instant", "i"), 1);
+        ensure_equals("helper scope", count(events, "helper scope", "X"), 1);
+        size_t names = 0;
+        for (const auto& event : events)
+        {
+            const auto& obj = event.as_object();
+            if (obj.at("ph").as_string() == "M")
+            {
+                auto name = obj.at("args").at("name").as_string();
+                names += (name == "Tester" || name == "Helper");
+            }
+        }
+        ensure_equals("thread names", names, 2);
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("dump keeps only the window and the newest events");
+        U64 now = LLTrace::BlockTimer::getCPUClockCount64();
+        U64 hour = LLTrace::BlockTimer::countsPerSecond() * 3600;
+        LLTrace::TraceCapture::recordScope("long ago", now - hour - 1000, now - hour);
+        for (U32 i = 0; i < LLTrace::TraceCapture::EVENTS_PER_THREAD + 10; ++i)
+        {
+            LLTrace::TraceCapture::recordScope("recent", now, now + 1);
+        }
+        boost::json::array events(dump(60.0));
+        ensure_equals("long ago", count(events, "long ago", "X"), 0);
+        // dump() can't tell the newest slot from one being overwritten, so
+        // it passes on the oldest event of a full ring
+        size_t recent = count(events, "recent", "X");
+        ensure("recent", recent == LLTrace::TraceCapture::EVENTS_PER_THREAD
+                         || recent == LLTrace::TraceCapture::EVENTS_PER_THREAD - 1);
+
+        LLTrace::TraceCapture::setEnabled(false);
+        LLTrace::TraceCapture::instant("disabled");
+        ensure_equals("disabled", count(dump(60.0), "disabled", "i"), 0);
+    }
+} // namespace tut
@@ -0,0 +1,274 @@
+/**
+ * @file   lluuidhashmap_test.cpp
+ * @date   2026-10
+ * @brief  Checks for LLUUIDHashMap and LLUUIDHashSet, and timings against
+ *         the std containers they replace
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "lluuidhashmap.h"
+// std headers
+#include <algorithm>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
+// other Linden headers
+#include "llpointer.h"
+#include "llrefcount.h"
+#include "lltimer.h"
+#include "../test/lltut.h"
+#include "stringize.h"
+
+namespace
+{
+    struct Counted : public LLRefCount
+    {
+        static S32 sLive;
+        Counted() { ++sLive; }
+        ~Counted() { --sLive; }
+    };
+    S32 Counted::sLive = 0;
+
+    std::vector<LLUUID> make_ids(size_t count, U64 seed)
+    {
+        std::mt19937_64 rng(seed);
+        std::vector<LLUUID> ids(count);
+        for (LLUUID& id : ids)
+        {
+            U64 words[2] = { rng(), rng() };
+            memcpy(id.mData, words, sizeof(words));
+        }
+        return ids;
+    }
+
+    // Milliseconds for find() of every id, repeats times; sum keeps the
+    // lookups from being optimized away.
+    template <typename MAP>
+    F64 time_finds(const MAP& map, const std::vector<LLUUID>& ids, S32 repeats, S64& sum)
+    {
+        LLTimer timer;
+        for (S32 i = 0; i < repeats; ++i)
+        {
+            for (const LLUUID& id : ids)
+            {
+                auto found = map.find(id);
+                if (found != map.end())
+                {
+                    sum += found->second;
+                }
+            }
+        }
+        return timer.getElapsedTimeF64() * 1000.0;
+    }
+
+    // Milliseconds to fill a map with ids then erase them all again
+    template <typename MAP>
+    F64 time_churn(const std::vector<LLUUID>& ids)
+    {
+        LLTimer timer;
+        MAP map;
+        S32 value = 0;
+        for (const LLUUID& id : ids)
+        {
+            map[id] = value++;
+        }
+        for (const LLUUID& id : ids)
+        {
+            map.erase(id);
+        }
+        return timer.getElapsedTimeF64() * 1000.0;
+    }
+}
+
+namespace tut
+{
+    struct lluuidhashmap_data
+    {
+    };
+    typedef test_group<lluuidhashmap_data> lluuidhashmap_group;
+    typedef lluuidhashmap_group::object object;
+    lluuidhashmap_group lluuidhashmapgrp("LLUUIDHashMap");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("insert, find and erase agree with std::unordered_map");
+        std::vector<LLUUID> ids(make_ids(5000, 1));
+        // the null id is a key like any other
+        ids.push_back(LLUUID::null);
+
+        LLUUIDHashMap<S32> map;
+        std::unordered_map<LLUUID, S32> expected;
+        std::mt19937 rng(2);
+        for (S32 i = 0; i < 100000; ++i)
+        {
+            const LLUUID& id = ids[rng() % ids.size()];
+            switch (rng() % 3)
+            {
+            case 0:
+                map[id] = i;
+                expected[id] = i;
+                break;
+            case 1:
+                ensure_equals(STRINGIZE("erase " << i), map.erase(id), expected.erase(id));
+                break;
+            default:
+            {
+                auto found = map.find(id);
+                auto want = expected.find(id);
+                ensure_equals(STRINGIZE("found " << i), found != map.end(), want != expected.end());
+                if (want != expected.end())
+                {
+                    ensure_equals(STRINGIZE("value " << i), found->second, want->second);
+                }
+            }
+            }
+        }
+        ensure_equals("size", map.size(), expected.size());
+
+        size_t visited = 0;
+        for (const auto& pair : map)
+        {
+            ++visited;
+            ensure_equals("iterated value", pair.second, expected.at(pair.first));
+        }
+        ensure_equals("iterated all", visited, map.size());
+
+        auto inserted = map.insert({ ids[0], -1 });
+        map.emplace(ids[0], -2);
+        ensure_equals("insert keeps the first value", map[ids[0]], inserted.first->second);
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("erase while iterating, copy and move");
+        std::vector<LLUUID> ids(make_ids(1000, 3));
+        LLUUIDHashMap<LLPointer<Counted>> map;
+        for (const LLUUID& id : ids)
+        {
+            map[id] = new Counted;
+        }
+        ensure_equals("all live", Counted::sLive, 1000);
+
+        // as LLMeshRepository culls its skin info
+        for (auto it = map.begin(), end = map.end(); it != end;)
+        {
+            auto copy = it++;
+            if (copy->first.mData[0] & 1)
+            {
+                map.erase(copy);
+            }
+        }
+        for (const LLUUID& id : ids)
+        {
+            ensure_equals("kept the even ones", map.contains(id), !(id.mData[0] & 1));
+        }
+        ensure_equals("odd ones released", Counted::sLive, (S32)map.size());
+
+        LLUUIDHashMap<LLPointer<Counted>> copy(map);
+        ensure_equals("copy shares values", Counted::sLive, (S32)map.size());
+        ensure("copy finds", copy.find(ids[0]) != copy.end() || !map.contains(ids[0]));
+        LLUUIDHashMap<LLPointer<Counted>> moved(std::move(copy));
+        ensure("moved from is empty", copy.empty());
+        ensure_equals("moved", moved.size(), map.size());
+
+        map.clear();
+        moved.clear();
+        ensure_equals("clear releases", Counted::sLive, 0);
+        ensure("find in cleared", map.find(ids[0]) == map.end());
+    }
+
+    template<> template<>
+    void object::test<3>()
+    {
+        set_test_name("LLUUIDHashSet");
+        std::vector<LLUUID> ids(make_ids(300, 4));
+        LLUUIDHashSet set(ids.begin(), ids.begin() + 200);
+        ensure_equals("size", set.size(), (size_t)200);
+        ensure("second insert", !set.insert(ids[0]).second);
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            ensure_equals(STRINGIZE("contains " << i), set.contains(ids[i]), i < 200);
+        }
+        for (size_t i = 0; i < 200; i += 2)
+        {
+            set.erase(ids[i]);
+        }
+        size_t visited = 0;
+        for (const LLUUID& id : set)
+        {
+            ++visited;
+            ensure("only odd ones left", set.count(id) == 1);
+        }
+        ensure_equals("iterated", visited, (size_t)100);
+    }
+
+    template<> template<>
+    void object::test<4>()
+    {
+        set_test_name("timings against std::map and std::unordered_map");
+        // about the size of a busy region's object list, and a big inventory
+        for (size_t count : { 5000, 100000 })
+        {
+            std::vector<LLUUID> ids(make_ids(count, 5));
+            // half the lookups miss, as texture and object lookups often do
+            std::vector<LLUUID> lookups(make_ids(count, 6));
+            lookups.insert(lookups.end(), ids.begin(), ids.end());
+            std::shuffle(lookups.begin(), lookups.end(), std::mt19937(7));
+
+            std::map<LLUUID, S32> tree;
+            std::unordered_map<LLUUID, S32> buckets;
+            LLUUIDHashMap<S32> flat;
+            for (S32 i = 0; i < (S32)ids.size(); ++i)
+            {
+                tree[ids[i]] = i;
+                buckets[ids[i]] = i;
+                flat[ids[i]] = i;
+            }
+
+            const S32 REPEATS = 10;
+            S64 tree_sum = 0, buckets_sum = 0, flat_sum = 0;
+            F64 tree_ms = time_finds(tree, lookups, REPEATS, tree_sum);
+            F64 buckets_ms = time_finds(buckets, lookups, REPEATS, buckets_sum);
+            F64 flat_ms = time_finds(flat, lookups, REPEATS, flat_sum);
+            ensure_equals("same hits as std::map", flat_sum, tree_sum);
+            ensure_equals("same hits as std::unordered_map", flat_sum, buckets_sum);
+
+            LL_INFOS("LLUUIDHashMap") << count << " ids, " << lookups.size() * REPEATS
+                                      << " finds: std::map " << tree_ms
+                                      << "ms, std::unordered_map " << buckets_ms
+                                      << "ms, LLUUIDHashMap " << flat_ms << "ms" << LL_ENDL;
+            LL_INFOS("LLUUIDHashMap") << count << " ids, insert and erase all: std::map "
+                                      << time_churn<std::map<LLUUID, S32>>(ids)
+                                      << "ms, std::unordered_map "
+                                      << time_churn<std::unordered_map<LLUUID, S32>>(ids)
+                                      << "ms, LLUUIDHashMap "
+                                      << time_churn<LLUUIDHashMap<S32>>(ids) << "ms" << LL_ENDL;
+        }
+    }
+}
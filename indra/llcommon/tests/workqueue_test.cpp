@@ -15,8 +15,11 @@
 #include "workqueue.h"
 // STL headers
 // std headers
+#include <atomic>
 #include <chrono>
 #include <deque>
+#include <thread>
+#include <vector>
 // external library headers
 // other Linden headers
 #include "../test/lltut.h"
@@ -236,4 +239,93 @@ namespace tut
         ensure_equals("didn't run coroutine", stored, "ran");
         ensure("void waitForResult() didn't return", done);
     }
+
+    template<> template<>
+    void object::test<7>()
+    {
+        set_test_name("WorkStealingQueue");
+        WorkStealingQueue stealing("stealing");
+        ensure("not findable",
+               WorkStealingQueue::getInstance("stealing") == stealing.getWeak().lock());
+
+        std::atomic<int> ran{ 0 }, posted{ 0 };
+        std::vector<std::thread> workers;
+        for (int i = 0; i < 4; ++i)
+        {
+            workers.emplace_back([&stealing](){ stealing.runUntilClose(); });
+        }
+        // Work from this thread goes to the injection queue; every tenth item
+        // posts more from its worker onto that worker's own deque, for the
+        // others to steal.
+        for (int i = 0; i < 10000; ++i)
+        {
+            ensure("post failed", stealing.post(
+                [&stealing, &ran, &posted, i]()
+                {
+                    ++ran;
+                    if (i % 10 == 0)
+                    {
+                        for (int j = 0; j < 5; ++j)
+                        {
+                            if (stealing.post([&ran](){ ++ran; }))
+                                ++posted;
+                        }
+                    }
+                }));
+            ++posted;
+        }
+        stealing.close();
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        ensure("not drained", stealing.done());
+        ensure_equals("wrong number of items run", ran.load(), posted.load());
+        ensure_not("post after close", stealing.post([](){}));
+    }
+
+    template<> template<>
+    void object::test<8>()
+    {
+        set_test_name("lock-free WorkQueue");
+        // small enough that the posts below spill past the ring
+        WorkQueue lockfree("lockfree", 100, true);
+        std::atomic<int> ran{ 0 };
+        std::vector<std::thread> posters;
+        for (int i = 0; i < 4; ++i)
+        {
+            posters.emplace_back([&lockfree, &ran]()
+            {
+                for (int j = 0; j < 1000; ++j)
+                {
+                    while (! lockfree.tryPost([&ran](){ ++ran; }))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        // service it the way the main thread does, without blocking
+        while (ran < 4000)
+        {
+            lockfree.runPending();
+            std::this_thread::yield();
+        }
+        for (auto& poster : posters)
+        {
+            poster.join();
+        }
+
+        // posts from one thread still run in order
+        std::string order;
+        for (char c = 'a'; c <= 'z'; ++c)
+        {
+            lockfree.post([&order, c](){ order.push_back(c); });
+        }
+        lockfree.close();
+        ensure_not("post after close", lockfree.post([](){}));
+        lockfree.runUntilClose();
+        ensure_equals("out of order", order, "abcdefghijklmnopqrstuvwxyz");
+        ensure("not drained", lockfree.done());
+    }
 } // namespace tut
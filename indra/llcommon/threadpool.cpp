@@ -22,6 +22,7 @@
 #include "llerror.h"
 #include "llevents.h"
 #include "llsd.h"
+#include "lltracecapture.h"
 #include "stringize.h"
 
 #include <boost/fiber/algo/round_robin.hpp>
@@ -80,6 +81,7 @@ void LL::ThreadPoolBase::start()
         mThreads.emplace_back(tname, [this, tname]()
             {
                 LL_PROFILER_SET_THREAD_NAME(tname.c_str());
+                LLTrace::TraceCapture::nameThread(tname);
                 run(tname);
             });
     }
@@ -138,6 +138,13 @@ namespace LL
     /// ThreadPool is shorthand for using the simpler WorkQueue
     using ThreadPool = ThreadPoolUsing<WorkQueue>;
 
+    /**
+     * WorkStealingThreadPool gives each of its threads a deque of its own,
+     * for pools fed many small jobs where the single WorkQueue lock would be
+     * the bottleneck. See WorkStealingQueue.
+     */
+    using WorkStealingThreadPool = ThreadPoolUsing<WorkStealingQueue>;
+
 } // namespace LL
 
 #endif /* ! defined(LL_THREADPOOL_H) */
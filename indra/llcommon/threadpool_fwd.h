@@ -20,6 +20,7 @@ namespace LL
     struct ThreadPoolUsing;
 
     using ThreadPool = ThreadPoolUsing<WorkQueue>;
+    using WorkStealingThreadPool = ThreadPoolUsing<WorkStealingQueue>;
 } // namespace LL
 
 #endif /* ! defined(LL_THREADPOOL_FWD_H) */
@@ -14,7 +14,9 @@
 // associated header
 #include "workqueue.h"
 // STL headers
+#include <algorithm>                // std::min
 // std headers
+#include <thread>                   // std::this_thread::yield
 // external library headers
 // other Linden headers
 #include "llcoros.h"
@@ -138,50 +140,58 @@ void LL::WorkQueueBase::checkCoroutine(const std::string& method)
 /*****************************************************************************
 *   WorkQueue
 *****************************************************************************/
-LL::WorkQueue::WorkQueue(const std::string& name, size_t capacity):
+LL::WorkQueue::WorkQueue(const std::string& name, size_t capacity, bool lock_free):
     super(name),
-    mQueue(capacity)
+    mQueue(lock_free? 1 : capacity)
 {
+    if (lock_free)
+    {
+        mLockFree.reset(new LockFreeQueue(capacity));
+    }
 }
 
 void LL::WorkQueue::close()
 {
+    if (mLockFree)
+    {
+        mLockFree->close();
+    }
     mQueue.close();
 }
 
 size_t LL::WorkQueue::size()
 {
-    return mQueue.size();
+    return mLockFree? mLockFree->size() : mQueue.size();
 }
 
 bool LL::WorkQueue::isClosed()
 {
-    return mQueue.isClosed();
+    return mLockFree? mLockFree->isClosed() : mQueue.isClosed();
 }
 
 bool LL::WorkQueue::done()
 {
-    return mQueue.done();
+    return mLockFree? mLockFree->done() : mQueue.done();
 }
 
 bool LL::WorkQueue::post(const Work& callable)
 {
-    return mQueue.pushIfOpen(callable);
+    return mLockFree? mLockFree->pushIfOpen(callable) : mQueue.pushIfOpen(callable);
 }
 
 bool LL::WorkQueue::tryPost(const Work& callable)
 {
-    return mQueue.tryPush(callable);
+    return mLockFree? mLockFree->tryPush(callable) : mQueue.tryPush(callable);
 }
 
 LL::WorkQueue::Work LL::WorkQueue::pop_()
 {
-    return mQueue.pop();
+    return mLockFree? mLockFree->pop() : mQueue.pop();
 }
 
 bool LL::WorkQueue::tryPop_(Work& work)
 {
-    return mQueue.tryPop(work);
+    return mLockFree? mLockFree->tryPop(work) : mQueue.tryPop(work);
 }
 
 /*****************************************************************************
@@ -246,3 +256,441 @@ bool LL::WorkSchedule::tryPop_(Work& work)
 {
     return mQueue.tryPop(work);
 }
+
+/*****************************************************************************
+*   WorkStealingQueue
+*****************************************************************************/
+namespace
+{
+    // most items a worker moves from the injection queue to its own deque
+    constexpr size_t INJECTION_BATCH = 32;
+    // how many times an idle worker looks around before parking
+    constexpr U32 SPIN_ROUNDS = 16;
+} // anonymous namespace
+
+thread_local const LL::WorkStealingQueue* LL::WorkStealingQueue::sCurrentQueue = nullptr;
+thread_local LL::WorkStealingQueue::Worker* LL::WorkStealingQueue::sCurrentWorker = nullptr;
+
+// Chase-Lev work-stealing deque, as in Le, Pop, Cohen and Zappa Nardelli,
+// "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+// Only the owning worker calls push() and pop(), at the bottom; any thread
+// may steal() from the top.
+class LL::WorkStealingQueue::Deque
+{
+public:
+    Deque():
+        mArray(new Array(INITIAL_SIZE))
+    {}
+
+    ~Deque()
+    {
+        // by now nobody else can be looking at us
+        while (Work* work = pop())
+        {
+            delete work;
+        }
+        delete mArray.load(std::memory_order_relaxed);
+        for (Array* array : mRetired)
+        {
+            delete array;
+        }
+    }
+
+    void push(Work* work)
+    {
+        S64 bottom = mBottom.load(std::memory_order_relaxed);
+        S64 top = mTop.load(std::memory_order_acquire);
+        Array* array = mArray.load(std::memory_order_relaxed);
+        if (bottom - top >= array->mSize)
+        {
+            array = grow(array, top, bottom);
+        }
+        array->put(bottom, work);
+        std::atomic_thread_fence(std::memory_order_release);
+        mBottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    Work* pop()
+    {
+        S64 bottom = mBottom.load(std::memory_order_relaxed) - 1;
+        Array* array = mArray.load(std::memory_order_relaxed);
+        mBottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        S64 top = mTop.load(std::memory_order_relaxed);
+        if (top > bottom)
+        {
+            // empty
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Work* work = array->get(bottom);
+        if (top == bottom)
+        {
+            // the last item: a thief may be after it too
+            if (! mTop.compare_exchange_strong(top, top + 1,
+                                               std::memory_order_seq_cst,
+                                               std::memory_order_relaxed))
+            {
+                work = nullptr;
+            }
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return work;
+    }
+
+    // Returns nullptr if empty, or if some other thread took the top item
+    // first, in which case it also sets contended.
+    Work* steal(bool& contended)
+    {
+        S64 top = mTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        S64 bottom = mBottom.load(std::memory_order_acquire);
+        if (top >= bottom)
+        {
+            return nullptr;
+        }
+        Array* array = mArray.load(std::memory_order_acquire);
+        Work* work = array->get(top);
+        if (! mTop.compare_exchange_strong(top, top + 1,
+                                           std::memory_order_seq_cst,
+                                           std::memory_order_relaxed))
+        {
+            contended = true;
+            return nullptr;
+        }
+        return work;
+    }
+
+    size_t size() const
+    {
+        S64 bottom = mBottom.load(std::memory_order_relaxed);
+        S64 top = mTop.load(std::memory_order_relaxed);
+        return bottom > top ? size_t(bottom - top) : 0;
+    }
+
+private:
+    struct Array
+    {
+        Array(S64 size):
+            mSize(size),
+            mMask(size - 1),
+            mSlots(new std::atomic<Work*>[size])
+        {}
+
+        // Release/acquire on the slot itself, not just the fences around
+        // it, so a thief is sure to see the Work the pointer points to.
+        Work* get(S64 i) const { return mSlots[i & mMask].load(std::memory_order_acquire); }
+        void put(S64 i, Work* work) { mSlots[i & mMask].store(work, std::memory_order_release); }
+
+        const S64 mSize;
+        const S64 mMask;
+        std::unique_ptr<std::atomic<Work*>[]> mSlots;
+    };
+
+    Array* grow(Array* array, S64 top, S64 bottom)
+    {
+        Array* bigger = new Array(array->mSize * 2);
+        for (S64 i = top; i < bottom; ++i)
+        {
+            bigger->put(i, array->get(i));
+        }
+        // A thief may still be reading the old array. Deques only grow to
+        // the most work a single worker ever had queued, so just keep it.
+        mRetired.push_back(array);
+        mArray.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    static constexpr S64 INITIAL_SIZE = 256;
+
+    // keep the owner's end and the thieves' end on separate cache lines
+    alignas(64) std::atomic<S64> mTop{ 0 };
+    alignas(64) std::atomic<S64> mBottom{ 0 };
+    std::atomic<Array*> mArray;
+    std::vector<Array*> mRetired;           // touched only by the owner
+};
+
+struct LL::WorkStealingQueue::Worker
+{
+    Worker(size_t index): mIndex(index) {}
+
+    Deque mDeque;
+    size_t mIndex;
+    // this worker's own steals, touched only by its thread
+    U64 mSteals{ 0 };
+};
+
+LL::WorkStealingQueue::WorkStealingQueue(const std::string& name, size_t capacity):
+    super(name),
+    mCapacity(capacity)
+{
+}
+
+LL::WorkStealingQueue::~WorkStealingQueue()
+{
+}
+
+void LL::WorkStealingQueue::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mInjectMutex);
+        mClosed = true;
+    }
+    mNotFull.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(mParkMutex);
+        ++mWakeups;
+    }
+    mParkCond.notify_all();
+    LL_DEBUGS("WorkQueue") << getKey() << " closed, " << getStealCount() << " steals" << LL_ENDL;
+}
+
+size_t LL::WorkStealingQueue::size()
+{
+    size_t size = mInjectedSize.load(std::memory_order_relaxed);
+    for (size_t i = 0, count = mWorkerCount.load(std::memory_order_acquire); i < count; ++i)
+    {
+        size += mWorkers[i]->mDeque.size();
+    }
+    return size;
+}
+
+bool LL::WorkStealingQueue::isClosed()
+{
+    return mClosed;
+}
+
+bool LL::WorkStealingQueue::done()
+{
+    return mClosed && ! hasWork();
+}
+
+bool LL::WorkStealingQueue::post(const Work& callable)
+{
+    if (Worker* self = getWorker())
+    {
+        // a worker posting more work for its own pool takes no lock
+        if (mClosed)
+            return false;
+        self->mDeque.push(new Work(callable));
+    }
+    else
+    {
+        std::unique_lock<std::mutex> lock(mInjectMutex);
+        mNotFull.wait(lock, [this](){ return mClosed || mInjected.size() < mCapacity; });
+        if (mClosed)
+            return false;
+        mInjected.push_back(callable);
+        mInjectedSize.store(mInjected.size(), std::memory_order_relaxed);
+    }
+    wake();
+    return true;
+}
+
+bool LL::WorkStealingQueue::tryPost(const Work& callable)
+{
+    if (Worker* self = getWorker())
+    {
+        if (mClosed)
+            return false;
+        self->mDeque.push(new Work(callable));
+    }
+    else
+    {
+        // like LLThreadSafeQueue::tryPush(), don't wait for the lock either
+        std::unique_lock<std::mutex> lock(mInjectMutex, std::try_to_lock);
+        if (! lock.owns_lock() || mClosed || mInjected.size() >= mCapacity)
+            return false;
+        mInjected.push_back(callable);
+        mInjectedSize.store(mInjected.size(), std::memory_order_relaxed);
+    }
+    wake();
+    return true;
+}
+
+LL::WorkStealingQueue::Worker* LL::WorkStealingQueue::getWorker() const
+{
+    return (sCurrentQueue == this)? sCurrentWorker : nullptr;
+}
+
+LL::WorkStealingQueue::Worker* LL::WorkStealingQueue::enlist()
+{
+    if (sCurrentQueue == this)
+    {
+        return sCurrentWorker;
+    }
+
+    Worker* worker = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mParkMutex);
+        size_t index = mWorkerCount.load(std::memory_order_relaxed);
+        if (index < MAX_WORKERS)
+        {
+            mWorkers[index].reset(new Worker(index));
+            worker = mWorkers[index].get();
+            // publish the new slot only once it's filled in
+            mWorkerCount.store(index + 1, std::memory_order_release);
+        }
+    }
+    if (! worker)
+    {
+        LL_WARNS_ONCE("WorkQueue") << getKey() << " has more than " << MAX_WORKERS
+                                   << " workers, the rest share the injection queue" << LL_ENDL;
+    }
+    sCurrentQueue = this;
+    sCurrentWorker = worker;
+    return worker;
+}
+
+bool LL::WorkStealingQueue::tryTake(Worker* self, Work& work)
+{
+    if (self)
+    {
+        if (Work* mine = self->mDeque.pop())
+        {
+            work = std::move(*mine);
+            delete mine;
+            return true;
+        }
+    }
+    return takeInjected(self, work) || steal(self, work);
+}
+
+bool LL::WorkStealingQueue::takeInjected(Worker* self, Work& work)
+{
+    if (! mInjectedSize.load(std::memory_order_relaxed))
+    {
+        // don't contend with the posting thread just to find nothing
+        return false;
+    }
+
+    size_t batched = 0;
+    {
+        std::lock_guard<std::mutex> lock(mInjectMutex);
+        if (mInjected.empty())
+        {
+            return false;
+        }
+        work = std::move(mInjected.front());
+        mInjected.pop_front();
+        if (self)
+        {
+            // Take our share of whatever else is waiting: we'll run it
+            // without touching mInjectMutex again, and idle workers can
+            // steal it from us without touching it either. Push it in
+            // reverse so our own newest-first pops run it in posting order.
+            batched = std::min(mInjected.size() / mWorkerCount.load(std::memory_order_relaxed),
+                               INJECTION_BATCH);
+            for (size_t i = batched; i-- > 0; )
+            {
+                self->mDeque.push(new Work(std::move(mInjected[i])));
+            }
+            mInjected.erase(mInjected.begin(), mInjected.begin() + batched);
+        }
+        mInjectedSize.store(mInjected.size(), std::memory_order_relaxed);
+    }
+    mNotFull.notify_all();
+    if (batched)
+    {
+        wake();
+    }
+    return true;
+}
+
+bool LL::WorkStealingQueue::steal(Worker* self, Work& work)
+{
+    size_t count = mWorkerCount.load(std::memory_order_acquire);
+    // start with our neighbor, so thieves don't all pile onto worker 0
+    size_t start = self? self->mIndex + 1 : 0;
+    bool contended;
+    do
+    {
+        contended = false;
+        for (size_t n = 0; n < count; ++n)
+        {
+            Worker* victim = mWorkers[(start + n) % count].get();
+            if (victim == self)
+                continue;
+            if (Work* stolen = victim->mDeque.steal(contended))
+            {
+                // show running totals, the pool's and then this worker's
+                LL_PROFILE_ZONE_NAMED_CATEGORY_THREAD("WorkStealingQueue steal");
+                U64 steals = mSteals.fetch_add(1, std::memory_order_relaxed) + 1;
+                LL_PROFILE_ZONE_NUM(steals);
+                if (self)
+                {
+                    ++self->mSteals;
+                    LL_PROFILE_ZONE_NUM(self->mSteals);
+                }
+                work = std::move(*stolen);
+                delete stolen;
+                return true;
+            }
+        }
+    } while (contended);
+    return false;
+}
+
+bool LL::WorkStealingQueue::hasWork()
+{
+    return size() > 0;
+}
+
+void LL::WorkStealingQueue::wake()
+{
+    // Pairs with the fence in pop_(): either a worker about to park sees the
+    // work we just queued, or we see that worker counted in mSleepers.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (mSleepers.load(std::memory_order_relaxed))
+    {
+        {
+            std::lock_guard<std::mutex> lock(mParkMutex);
+            ++mWakeups;
+        }
+        mParkCond.notify_one();
+    }
+}
+
+LL::WorkStealingQueue::Work LL::WorkStealingQueue::pop_()
+{
+    Worker* self = enlist();
+    Work work;
+    for (;;)
+    {
+        // Fine-grained work tends to come in bursts: look around a few
+        // times before going to the trouble of parking.
+        for (U32 spin = 0; spin < SPIN_ROUNDS; ++spin)
+        {
+            if (tryTake(self, work))
+            {
+                return work;
+            }
+            std::this_thread::yield();
+        }
+
+        LL_PROFILE_ZONE_NAMED_CATEGORY_THREAD("WorkStealingQueue park");
+        std::unique_lock<std::mutex> lock(mParkMutex);
+        U64 wakeups = mWakeups;
+        mSleepers.fetch_add(1, std::memory_order_relaxed);
+        // pairs with the fence in wake()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (! hasWork())
+        {
+            if (mClosed)
+            {
+                // closed and drained: same as LLThreadSafeQueue::pop()
+                mSleepers.fetch_sub(1, std::memory_order_relaxed);
+                sCurrentQueue = nullptr;
+                sCurrentWorker = nullptr;
+                LLTHROW(Closed());
+            }
+            mParkCond.wait(lock, [this, wakeups](){ return mWakeups != wakeups; });
+        }
+        mSleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+bool LL::WorkStealingQueue::tryPop_(Work& work)
+{
+    return tryTake(getWorker(), work);
+}
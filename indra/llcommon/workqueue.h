@@ -17,10 +17,16 @@
 #include "llexception.h"
 #include "llinstancetracker.h"
 #include "llinstancetrackersubclass.h"
+#include "lllockfreequeue.h"
 #include "threadsafeschedule.h"
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <exception>                // std::current_exception
 #include <functional>               // std::function
+#include <memory>
+#include <mutex>
 #include <string>
 
 namespace LL
@@ -227,8 +233,14 @@ namespace LL
         /**
          * You may omit the WorkQueue name, in which case a unique name is
          * synthesized; for practical purposes that makes it anonymous.
+         *
+         * Pass lock_free=true for a queue that many threads post to, such
+         * as one collecting results on the main thread: it then stores work
+         * in an LLLockFreeQueue rather than an LLThreadSafeQueue, with the
+         * same semantics.
          */
-        WorkQueue(const std::string& name = std::string(), size_t capacity=1024);
+        WorkQueue(const std::string& name = std::string(), size_t capacity=1024,
+                  bool lock_free=false);
 
         /**
          * Since the point of WorkQueue is to pass work to some other worker
@@ -272,12 +284,100 @@ namespace LL
 
     private:
         using Queue = LLThreadSafeQueue<Work>;
+        using LockFreeQueue = LLLockFreeQueue<Work>;
+        // unused if we have mLockFree
         Queue mQueue;
+        std::unique_ptr<LockFreeQueue> mLockFree;
 
         Work pop_() override;
         bool tryPop_(Work&) override;
     };
 
+/*****************************************************************************
+*   WorkStealingQueue: per-thread deques for a pool of worker threads
+*****************************************************************************/
+    /**
+     * WorkStealingQueue presents the same API as WorkQueue, but is meant to
+     * be served by the worker threads of a ThreadPool. Each worker thread
+     * that pops from it gets its own lock-free (Chase-Lev) deque: work posted
+     * by that worker goes onto its own deque, work posted by any other thread
+     * goes onto a shared injection queue. A worker takes from its own deque
+     * first, then a batch from the injection queue, and only then steals
+     * from the other workers' deques. Idle workers park on a condition
+     * variable rather than spinning.
+     *
+     * There is no ordering guarantee among items run by different workers,
+     * just as with WorkQueue, and items a worker posts to itself run
+     * newest-first. Don't use it for a queue that must run strictly in FIFO
+     * order.
+     */
+    class WorkStealingQueue: public LLInstanceTrackerSubclass<WorkStealingQueue, WorkQueueBase>
+    {
+    private:
+        using super = LLInstanceTrackerSubclass<WorkStealingQueue, WorkQueueBase>;
+
+    public:
+        /**
+         * capacity limits only the injection queue: a worker posting to its
+         * own deque never blocks.
+         */
+        WorkStealingQueue(const std::string& name = std::string(), size_t capacity=1024);
+        ~WorkStealingQueue() override;
+
+        void close() override;
+        /// approximate: the injection queue plus every worker's deque
+        size_t size() override;
+        bool isClosed() override;
+        bool done() override;
+
+        /// post work, unless the queue is closed before we can post
+        bool post(const Work&) override;
+        /// post work, unless the queue is full
+        bool tryPost(const Work&) override;
+
+        /// how many work items workers have stolen from each other so far
+        U64 getStealCount() const { return mSteals.load(std::memory_order_relaxed); }
+
+    private:
+        class Deque;
+        struct Worker;
+        // more workers than this share the injection queue without a deque
+        static constexpr size_t MAX_WORKERS = 64;
+
+        Worker* getWorker() const;
+        Worker* enlist();
+        bool tryTake(Worker* self, Work& work);
+        bool takeInjected(Worker* self, Work& work);
+        bool steal(Worker* self, Work& work);
+        bool hasWork();
+        void wake();
+
+        Work pop_() override;
+        bool tryPop_(Work&) override;
+
+        std::mutex mInjectMutex;
+        std::condition_variable mNotFull;
+        std::deque<Work> mInjected;
+        // mInjected.size(), so idle workers can look without locking
+        std::atomic<size_t> mInjectedSize{ 0 };
+        size_t mCapacity;
+        std::atomic<bool> mClosed{ false };
+
+        std::unique_ptr<Worker> mWorkers[MAX_WORKERS];
+        std::atomic<size_t> mWorkerCount{ 0 };
+
+        std::mutex mParkMutex;
+        std::condition_variable mParkCond;
+        std::atomic<U32> mSleepers{ 0 };
+        U64 mWakeups{ 0 };                  // protected by mParkMutex
+
+        std::atomic<U64> mSteals{ 0 };
+
+        // which WorkStealingQueue, if any, the calling thread works for
+        static thread_local const WorkStealingQueue* sCurrentQueue;
+        static thread_local Worker* sCurrentWorker;
+    };
+
 /*****************************************************************************
 *   WorkSchedule: add support for timestamped tasks
 *****************************************************************************/
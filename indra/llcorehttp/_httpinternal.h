@@ -157,6 +157,17 @@ constexpr long HTTP_PIPELINING_MAX = 20L;
 constexpr bool HTTP_USE_RETRY_AFTER_DEFAULT = true;
 constexpr long HTTP_THROTTLE_RATE_DEFAULT = 0L;
 
+// Largest Content-Length a response body is preallocated for
+constexpr long HTTP_REPLY_RESERVE_MAX = 64L * 1024L * 1024L;
+
+// Urgency scheduling across classes
+constexpr long HTTP_ACTIVE_LIMIT_MAX = 1024L;
+constexpr long HTTP_URGENCY_MAX = 100L;
+
+// Microseconds a ready request may wait before its class
+// gains an urgency level over the classes it competes with.
+constexpr long HTTP_URGENCY_AGING_INTERVAL = 500000L;
+
 // Tuning parameters
 
 // Time worker thread sleeps after a pass through the
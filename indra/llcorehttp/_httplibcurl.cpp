@@ -30,6 +30,7 @@
 #include "bufferarray.h"
 #include "_httpoprequest.h"
 #include "_httppolicy.h"
+#include "httpstats.h"
 
 #include "llhttpconstants.h"
 
@@ -64,7 +65,8 @@ HttpLibcurl::HttpLibcurl(HttpService * service)
       mPolicyCount(0),
       mMultiHandles(NULL),
       mActiveHandles(NULL),
-      mDirtyPolicy(NULL)
+      mDirtyPolicy(NULL),
+      mShareHandle(NULL)
 {}
 
 
@@ -107,6 +109,13 @@ void HttpLibcurl::shutdown()
         mDirtyPolicy = NULL;
     }
 
+    if (mShareHandle)
+    {
+        // freed handles have left the share already
+        curl_share_cleanup(mShareHandle);
+        mShareHandle = NULL;
+    }
+
     mPolicyCount = 0;
 }
 
@@ -117,6 +126,21 @@ void HttpLibcurl::start(int policy_count)
     llassert_always(policy_count <= HTTP_POLICY_CLASS_LIMIT);
     llassert_always(! mMultiHandles);                   // One-time call only
 
+    // DNS answers and TLS sessions are shared by all the policy classes, so a
+    // new connection to a host any class has talked to resumes the session
+    // instead of going through a full handshake.  Only the worker thread uses
+    // the share, it needs no locking.
+    mShareHandle = curl_share_init();
+    if (mShareHandle)
+    {
+        curl_share_setopt(mShareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(mShareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+    else
+    {
+        LL_WARNS(LOG_CORE) << "Failed to allocate share handle in libcurl." << LL_ENDL;
+    }
+
     mPolicyCount = policy_count;
     mMultiHandles = new CURLM * [mPolicyCount];
     mActiveHandles = new int [mPolicyCount];
@@ -409,6 +433,11 @@ bool HttpLibcurl::completeRequest(CURLM * multi_handle, CURL * handle, CURLcode
         }
     }
 
+    if (handle)
+    {
+        recordHostStats(handle);
+    }
+
     if (multi_handle && handle)
     {
         // Detach from multi and recycle handle
@@ -440,6 +469,40 @@ bool HttpLibcurl::completeRequest(CURLM * multi_handle, CURL * handle, CURLcode
 }
 
 
+void HttpLibcurl::recordHostStats(CURL * handle)
+{
+    char * url(NULL);
+    if (curl_easy_getinfo(handle, CURLINFO_EFFECTIVE_URL, &url) != CURLE_OK || ! url)
+    {
+        return;
+    }
+
+    // scheme://host[:port]/path
+    std::string host(url);
+    std::string::size_type start(host.find("://"));
+    start = (start == std::string::npos) ? 0 : start + 3;
+    host = host.substr(start, host.find_first_of("/?", start) - start);
+
+    long version(0L);
+    long connects(0L);
+    double name_lookup(0.0);
+    double connect(0.0);
+    double app_connect(0.0);
+    curl_easy_getinfo(handle, CURLINFO_HTTP_VERSION, &version);
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects);
+    curl_easy_getinfo(handle, CURLINFO_NAMELOOKUP_TIME, &name_lookup);
+    curl_easy_getinfo(handle, CURLINFO_CONNECT_TIME, &connect);
+    curl_easy_getinfo(handle, CURLINFO_APPCONNECT_TIME, &app_connect);
+
+    // the TCP handshake of a new connection takes one round trip
+    const bool new_connection(connects > 0);
+    const F32 rtt(new_connection ? F32(connect - name_lookup) : 0.f);
+    const F32 tls_time((new_connection && app_connect > connect) ? F32(app_connect - connect) : 0.f);
+
+    HTTPStats::instance().recordHostTransfer(host, version >= CURL_HTTP_VERSION_2_0, new_connection, rtt, tls_time);
+}
+
+
 int HttpLibcurl::getActiveCount() const
 {
     return static_cast<int>(mActiveOps.size());
@@ -489,13 +552,17 @@ void HttpLibcurl::policyUpdated(unsigned int policy_class)
 
         if (options.mPipelining > 1)
         {
-            // We'll try to do pipelining on this multihandle
+            // We'll try to multiplex HTTP/2 streams on this multihandle,
+            // libcurl has no HTTP/1.1 pipelining anymore.  The pipelining
+            // depth is the number of streams per connection.
             check_curl_multi_setopt(multi_handle,
                                      CURLMOPT_PIPELINING,
-                                     1L);
+                                     long(CURLPIPE_MULTIPLEX));
+#if LIBCURL_VERSION_NUM >= 0x074300
             check_curl_multi_setopt(multi_handle,
-                                     CURLMOPT_MAX_PIPELINE_LENGTH,
+                                     CURLMOPT_MAX_CONCURRENT_STREAMS,
                                      long(options.mPipelining));
+#endif
             check_curl_multi_setopt(multi_handle,
                                      CURLMOPT_MAX_HOST_CONNECTIONS,
                                      long(options.mPerHostConnectionLimit));
@@ -507,7 +574,7 @@ void HttpLibcurl::policyUpdated(unsigned int policy_class)
         {
             check_curl_multi_setopt(multi_handle,
                                      CURLMOPT_PIPELINING,
-                                     0L);
+                                     long(CURLPIPE_NOTHING));
             check_curl_multi_setopt(multi_handle,
                                      CURLMOPT_MAX_HOST_CONNECTIONS,
                                      0L);
@@ -587,6 +654,8 @@ void HttpLibcurl::HandleCache::freeHandle(CURL * handle)
         return;
     }
 
+    // a reset keeps the share, leave it so it can be released
+    curl_easy_setopt(handle, CURLOPT_SHARE, NULL);
     curl_easy_reset(handle);
     if (! mHandleTemplate)
     {
@@ -143,6 +143,16 @@ public:
             return mHandleCache.getHandle();
         }
 
+    /// Share handle of the DNS and TLS session caches, NULL if
+    /// libcurl could not allocate one.  Requests attach their
+    /// handles to it.
+    ///
+    /// Threading:  callable by worker thread.
+    CURLSH * getShareHandle() const
+        {
+            return mShareHandle;
+        }
+
 protected:
     /// Invoked when libcurl has indicated a request has been processed
     /// to completion and we need to move the request to a new state.
@@ -152,6 +162,10 @@ protected:
     /// and destroy.
     void cancelRequest(const opReqPtr_t &op);
 
+    /// Adds the connection details of a finished request to the
+    /// per-host HTTPStats.
+    void recordHostStats(CURL * handle);
+
 protected:
     typedef std::set<opReqPtr_t> active_set_t;
 
@@ -215,6 +229,7 @@ protected:
     CURLM **            mMultiHandles;      // One handle per policy class
     int *               mActiveHandles;     // Active count per policy class
     bool *              mDirtyPolicy;       // Dirty policy update waiting for stall (per pc)
+    CURLSH *            mShareHandle;       // DNS and TLS sessions of all classes, owner
 
 }; // end class HttpLibcurl
 
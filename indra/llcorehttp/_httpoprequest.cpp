@@ -526,6 +526,11 @@ HttpStatus HttpOpRequest::prepareRequest(HttpService * service)
 
     check_curl_easy_setopt(mCurlHandle, CURLOPT_COOKIEFILE, "");
 
+    if (CURLSH * share = service->getTransport().getShareHandle())
+    {
+        check_curl_easy_setopt(mCurlHandle, CURLOPT_SHARE, share);
+    }
+
     if (gpolicy.mSslCtxCallback)
     {
         check_curl_easy_setopt(mCurlHandle, CURLOPT_SSL_CTX_FUNCTION, curlSslCtxCallback);
@@ -739,12 +744,12 @@ HttpStatus HttpOpRequest::prepareRequest(HttpService * service)
         // xfer_timeout *= cpolicy.mPipelining;
         xfer_timeout *= 2L;
 
-        // Also try requesting HTTP/2.
-/******************************/
-        // but for test purposes, only if overriding VIEWERASSET
-        if (getenv("VIEWERASSET"))
-/******************************/
-        check_curl_easy_setopt(mCurlHandle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_0);
+        // Multiplex over HTTP/2 where the server offers it during the
+        // TLS handshake, HTTP/1.1 otherwise.  Waiting for a connection
+        // still being set up to turn out multiplexed spares opening (and
+        // handshaking) one of our own.
+        check_curl_easy_setopt(mCurlHandle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        check_curl_easy_setopt(mCurlHandle, CURLOPT_PIPEWAIT, 1L);
     }
     // *DEBUG:  Enable following override for timeout handling and "[curl:bugs] #1420" tests
     //if (cpolicy.mPipelining)
@@ -785,6 +790,18 @@ size_t HttpOpRequest::writeCallback(void * data, size_t size, size_t nmemb, void
     if (! op->mReplyBody)
     {
         op->mReplyBody = new BufferArray();
+
+#if LIBCURL_VERSION_NUM >= 0x073700
+        // Headers are in by the first write, a known length gets the
+        // body in one block consumers can use without copying
+        curl_off_t content_length(-1);
+        if (CURLE_OK == curl_easy_getinfo(op->mCurlHandle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &content_length)
+            && content_length > 0
+            && content_length <= HTTP_REPLY_RESERVE_MAX)
+        {
+            op->mReplyBody->reserve(size_t(content_length));
+        }
+#endif
     }
     const size_t req_size(size * nmemb);
     const size_t write_size(op->mReplyBody->append(static_cast<char *>(data), req_size));
@@ -33,6 +33,8 @@
 #include "_httplibcurl.h"
 #include "_httppolicyclass.h"
 
+#include <algorithm>
+
 #include "lltimer.h"
 #include "httpstats.h"
 
@@ -204,6 +206,11 @@ void HttpPolicy::retryOp(const HttpOpRequest::ptr_t &op)
 // the worker thread may sleep hard otherwise will ask for
 // normal polling frequency.
 //
+// When a global active limit is set, classes with an urgency
+// share it and are visited most urgent first, a class gaining
+// urgency the longer its oldest ready request waits.  Classes
+// without an urgency follow in their usual order, unlimited.
+//
 // Implements a client-side request rate throttle as well.
 // This is intended to mimic and predict throttling behavior
 // of grid services but that is difficult to do with different
@@ -217,8 +224,52 @@ HttpService::ELoopSpeed HttpPolicy::processReadyQueue()
     HttpService::ELoopSpeed result(HttpService::REQUEST_SLEEP);
     HttpLibcurl & transport(mService->getTransport());
 
+    const bool budgeted(mGlobalOptions.mActiveLimit > 0L);
+    int budget(budgeted ? int(mGlobalOptions.mActiveLimit) : 0);
+
+    mServiceOrder.clear();
+    if (budgeted)
+    {
+        for (int policy_class(0); policy_class < mClasses.size(); ++policy_class)
+        {
+            const ClassState & state(*mClasses[policy_class]);
+            if (state.mOptions.mUrgency <= 0L)
+            {
+                continue;
+            }
+
+            budget -= transport.getActiveCountInClass(policy_class);
+
+            long urgency(state.mOptions.mUrgency);
+            if (! state.mReadyQueue.empty())
+            {
+                const HttpTime created(state.mReadyQueue.top()->mMetricCreated);
+                if (now > created)
+                {
+                    urgency += long((now - created) / HttpTime(HTTP_URGENCY_AGING_INTERVAL));
+                }
+            }
+            mServiceOrder.push_back(std::make_pair(urgency, policy_class));
+        }
+
+        // Most urgent first, ties keep class order
+        std::stable_sort(mServiceOrder.begin(), mServiceOrder.end(),
+                         [](const std::pair<long, int> & a, const std::pair<long, int> & b)
+                         {
+                             return a.first > b.first;
+                         });
+    }
     for (int policy_class(0); policy_class < mClasses.size(); ++policy_class)
     {
+        if (! budgeted || mClasses[policy_class]->mOptions.mUrgency <= 0L)
+        {
+            mServiceOrder.push_back(std::make_pair(0L, policy_class));
+        }
+    }
+
+    for (const std::pair<long, int> & entry : mServiceOrder)
+    {
+        const int policy_class(entry.second);
         ClassState & state(*mClasses[policy_class]);
         HttpRetryQueue & retryq(state.mRetryQueue);
         HttpReadyQueue & readyq(state.mReadyQueue);
@@ -253,6 +304,12 @@ HttpService::ELoopSpeed HttpPolicy::processReadyQueue()
                             * state.mOptions.mPipelining)
                          : state.mOptions.mConnectionLimit);
         int needed(active_limit - active);      // Expect negatives here
+        const bool limited(budgeted && state.mOptions.mUrgency > 0L);
+        if (limited)
+        {
+            needed = llmin(needed, budget);
+        }
+        const int allowed(needed);
 
         if (needed > 0)
         {
@@ -320,12 +377,17 @@ HttpService::ELoopSpeed HttpPolicy::processReadyQueue()
 
     throttle_on:
 
+        if (limited && allowed > needed)
+        {
+            budget -= allowed - needed;
+        }
+
         if (! readyq.empty() || ! retryq.empty())
         {
             // If anything is ready, continue looping...
             result = HttpService::NORMAL;
         }
-    } // end foreach policy_class
+    } // end foreach policy_class in service order
 
     return result;
 }
@@ -165,9 +165,11 @@ public:
 protected:
     struct ClassState;
     typedef std::vector<ClassState *>   class_list_t;
+    typedef std::vector<std::pair<long, int> > service_order_t;     // (urgency, policy class)
 
     HttpPolicyGlobal                    mGlobalOptions;
     class_list_t                        mClasses;
+    service_order_t                     mServiceOrder;          // Scratch for processReadyQueue()
     HttpService *                       mService;               // Naked pointer, not refcounted, not owner
 };  // end class HttpPolicy
 
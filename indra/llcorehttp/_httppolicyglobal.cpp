@@ -36,7 +36,8 @@ namespace LLCore
 HttpPolicyGlobal::HttpPolicyGlobal()
     : mConnectionLimit(HTTP_CONNECTION_LIMIT_DEFAULT),
       mTrace(HTTP_TRACE_OFF),
-      mUseLLProxy(0)
+      mUseLLProxy(0),
+      mActiveLimit(0L)
 {}
 
 
@@ -54,6 +55,8 @@ HttpPolicyGlobal & HttpPolicyGlobal::operator=(const HttpPolicyGlobal & other)
         mHttpProxy = other.mHttpProxy;
         mTrace = other.mTrace;
         mUseLLProxy = other.mUseLLProxy;
+        mActiveLimit = other.mActiveLimit;
+        mSslCtxCallback = other.mSslCtxCallback;
     }
     return *this;
 }
@@ -75,6 +78,10 @@ HttpStatus HttpPolicyGlobal::set(HttpRequest::EPolicyOption opt, long value)
         mUseLLProxy = llclamp(value, 0L, 1L);
         break;
 
+    case HttpRequest::PO_ACTIVE_LIMIT:
+        mActiveLimit = llclamp(value, 0L, HTTP_ACTIVE_LIMIT_MAX);
+        break;
+
     default:
         return HttpStatus(HttpStatus::LLCORE, HE_INVALID_ARG);
     }
@@ -140,6 +147,10 @@ HttpStatus HttpPolicyGlobal::get(HttpRequest::EPolicyOption opt, long * value) c
         *value = mUseLLProxy;
         break;
 
+    case HttpRequest::PO_ACTIVE_LIMIT:
+        *value = mActiveLimit;
+        break;
+
     default:
         return HttpStatus(HttpStatus::LLCORE, HE_INVALID_ARG);
     }
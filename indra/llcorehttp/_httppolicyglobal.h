@@ -72,6 +72,7 @@ public:
     std::string         mHttpProxy;
     long                mTrace;
     long                mUseLLProxy;
+    long                mActiveLimit;
     HttpRequest::policyCallback_t   mSslCtxCallback;
 };  // end class HttpPolicyGlobal
 
@@ -90,6 +90,41 @@ HttpStatus HttpRequestQueue::addOp(const HttpRequestQueue::opPtr_t &op)
 }
 
 
+HttpStatus HttpRequestQueue::addOps(HttpRequestQueue::OpContainer & ops)
+{
+    if (ops.empty())
+    {
+        return HttpStatus();
+    }
+
+    bool wake(false);
+    {
+        HttpScopedLock lock(mQueueMutex);
+
+        if (mQueueStopped)
+        {
+            // Return ops and error to caller
+            return HttpStatus(HttpStatus::LLCORE, HE_SHUTTING_DOWN);
+        }
+        wake = mQueue.empty();
+        if (wake)
+        {
+            mQueue.swap(ops);
+        }
+        else
+        {
+            mQueue.insert(mQueue.end(), ops.begin(), ops.end());
+            ops.clear();
+        }
+    }
+    if (wake)
+    {
+        mQueueCV.notify_all();
+    }
+    return HttpStatus();
+}
+
+
 HttpRequestQueue::opPtr_t HttpRequestQueue::fetchOp(bool wait)
 {
     HttpOperation::ptr_t result;
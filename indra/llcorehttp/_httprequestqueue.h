@@ -87,6 +87,15 @@ public:
     /// Threading:  callable by any thread.
     HttpStatus addOp(const opPtr_t &op);
 
+    /// Insert a group of objects at the back of the request queue
+    /// in their current order.  Same contract as @addOp but with
+    /// a single lock acquisition and at most one wakeup of the
+    /// worker thread for the whole group.  On success, @ops is
+    /// left empty.
+    ///
+    /// Threading:  callable by any thread.
+    HttpStatus addOps(OpContainer & ops);
+
     /// Return the operation on the front of the queue.  If
     /// the queue is empty and @wait is false, call returns
     /// immediately and a NULL pointer is returned.  If true,
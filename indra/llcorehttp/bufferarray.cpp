@@ -67,18 +67,26 @@ protected:
     // buffered data at the end of the object.
     void * operator new(size_t len, size_t addl_len);
 
+    Block(size_t len, char * data);
+
 public:
-    // Only public entry to get a block.
+    // Only public entries to get a block.
     static Block * alloc(size_t len);
 
+    // Block with its data in a separate 16-byte aligned
+    // allocation that BufferArray::detach() can hand over.
+    static Block * allocAligned(size_t len);
+
 public:
     size_t mUsed;
     size_t mAlloced;
+    char * mData;
 
     // *NOTE:  Must be last member of the object.  We'll
     // overallocate as requested via operator new and index
-    // into the array at will.
-    char mData[1];
+    // into the array at will.  mData points here unless
+    // the block was allocated by allocAligned().
+    char mStorage[1];
 };
 
 
@@ -169,6 +177,59 @@ size_t BufferArray::append(const void * src, size_t len)
 }
 
 
+bool BufferArray::reserve(size_t len)
+{
+    if (! len || ! mBlocks.empty())
+    {
+        return false;
+    }
+
+    Block * block(Block::allocAligned(len));
+    if (! block)
+    {
+        LL_WARNS() << "Failed to reserve " << len << " bytes for BufferArray" << LL_ENDL;
+        return false;
+    }
+    mBlocks.push_back(block);
+    return true;
+}
+
+
+char * BufferArray::contiguous(size_t pos, size_t len)
+{
+    if (len > mLen || pos > mLen - len)
+        return NULL;
+
+    size_t offset(0);
+    int block(findBlock(pos, &offset));
+    if (block < 0)
+        return NULL;
+
+    Block & b(*mBlocks[block]);
+    return (b.mUsed - offset >= len) ? &b.mData[offset] : NULL;
+}
+
+
+void * BufferArray::detach(size_t * len)
+{
+    if (mBlocks.size() != 1 || mBlocks[0]->mData == mBlocks[0]->mStorage)
+    {
+        return NULL;
+    }
+
+    Block * block(mBlocks[0]);
+    void * data(block->mData);
+    *len = block->mUsed;
+
+    // Block no longer owns its data
+    block->mData = block->mStorage;
+    delete block;
+    mBlocks.clear();
+    mLen = 0;
+    return data;
+}
+
+
 void * BufferArray::appendBufferAlloc(size_t len)
 {
     // If someone asks for zero-length, we give them a valid pointer.
@@ -325,14 +386,27 @@ bool BufferArray::getBlockStartEnd(int block, const char ** start, const char **
 
 BufferArray::Block::Block(size_t len)
     : mUsed(0),
-      mAlloced(len)
+      mAlloced(len),
+      mData(mStorage)
 {
     memset(mData, 0, len);
 }
 
 
+BufferArray::Block::Block(size_t len, char * data)
+    : mUsed(0),
+      mAlloced(len),
+      mData(data)
+{}
+
+
 BufferArray::Block::~Block()
 {
+    if (mData != mStorage)
+    {
+        ll_aligned_free_16(mData);
+    }
+    mData = mStorage;
     mUsed = 0;
     mAlloced = 0;
 }
@@ -365,4 +439,16 @@ BufferArray::Block * BufferArray::Block::alloc(size_t len)
 }
 
 
+BufferArray::Block * BufferArray::Block::allocAligned(size_t len)
+{
+    char * data = static_cast<char *>(ll_aligned_malloc_16(len));
+    if (! data)
+    {
+        return NULL;
+    }
+    Block * block = new (0) Block(len, data);
+    return block;
+}
+
+
 }  // end namespace LLCore
@@ -103,6 +103,30 @@ public:
     ///                 of BufferArray of 'len' size.
     void * appendBufferAlloc(size_t len);
 
+    /// Prepares an empty BufferArray for 'len' bytes of appends,
+    /// typically a response body of known Content-Length, so
+    /// that they land in a single contiguous block which can
+    /// then be used in place or handed over with detach().
+    /// Does nothing if the instance already holds data.
+    ///
+    /// @return         True if the block was allocated.
+    bool reserve(size_t len);
+
+    /// Pointer to the 'len' bytes at 'pos' if they are contiguous
+    /// in memory, NULL if they span blocks or extend beyond the
+    /// data.  Valid until the next modification of the instance.
+    char * contiguous(size_t pos, size_t len);
+
+    /// Hands the storage over to the caller when all the data
+    /// is in a single block allocated by reserve().  The caller
+    /// frees it with ll_aligned_free_16() and the BufferArray is
+    /// left empty.
+    ///
+    /// @return         Pointer to the data with its size in 'len',
+    ///                 or NULL if the data can't be handed over,
+    ///                 in which case use read() instead.
+    void * detach(size_t * len);
+
     /// Current count of bytes in BufferArray instance.
     size_t size() const
         {
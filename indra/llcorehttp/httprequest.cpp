@@ -38,11 +38,59 @@
 #include "lltimer.h"
 #include "httpstats.h"
 
+#include <algorithm>
+
 namespace
 {
 
 bool has_inited(false);
 
+// Sort key keeping requests for the same policy class and host together
+std::string request_host_key(const LLCore::HttpOpRequest & op)
+{
+    const std::string & url(op.mReqURL);
+    std::string::size_type start(url.find("://"));
+    start = (std::string::npos == start) ? 0 : start + 3;
+    std::string::size_type end(url.find_first_of("/?", start));
+    std::string key(std::to_string(op.mReqPolicy));
+    key += ' ';
+    key += url.substr(start, (std::string::npos == end) ? std::string::npos : end - start);
+    return key;
+}
+
+// Stable-sort each run of request operations by host, leaving every
+// other operation where it is.
+void group_requests_by_host(LLCore::HttpRequestQueue::OpContainer & ops)
+{
+    typedef std::pair<std::string, LLCore::HttpOperation::ptr_t> keyed_op_t;
+    std::vector<keyed_op_t> run;
+    for (size_t i(0); i <= ops.size(); ++i)
+    {
+        LLCore::HttpOpRequest * req((i < ops.size())
+                                    ? dynamic_cast<LLCore::HttpOpRequest *>(ops[i].get())
+                                    : NULL);
+        if (req)
+        {
+            run.push_back(keyed_op_t(request_host_key(*req), ops[i]));
+            continue;
+        }
+        if (run.size() > 1)
+        {
+            std::stable_sort(run.begin(), run.end(),
+                             [](const keyed_op_t & lhs, const keyed_op_t & rhs)
+                             {
+                                 return lhs.first < rhs.first;
+                             });
+            size_t start(i - run.size());
+            for (size_t j(0); j < run.size(); ++j)
+            {
+                ops[start + j] = run[j].second;
+            }
+        }
+        run.clear();
+    }
+}
+
 }
 
 namespace LLCore
@@ -55,7 +103,8 @@ namespace LLCore
 
 HttpRequest::HttpRequest()
     : mReplyQueue(),
-      mRequestQueue(NULL)
+      mRequestQueue(NULL),
+      mBatching(false)
 {
     mRequestQueue = HttpRequestQueue::instanceOf();
     mRequestQueue->addRef();
@@ -136,7 +185,7 @@ HttpHandle HttpRequest::setPolicyOption(EPolicyOption opt, policy_t pclass,
         return LLCORE_HTTP_HANDLE_INVALID;
     }
     op->setReplyPath(mReplyQueue, handler);
-    if (! (status = mRequestQueue->addOp(op)))          // transfers refcount
+    if (! (status = queueOp(op)))          // transfers refcount
     {
         mLastReqStatus = status;
         return LLCORE_HTTP_HANDLE_INVALID;
@@ -159,7 +208,7 @@ HttpHandle HttpRequest::setPolicyOption(EPolicyOption opt, policy_t pclass,
         return LLCORE_HTTP_HANDLE_INVALID;
     }
     op->setReplyPath(mReplyQueue, handler);
-    if (! (status = mRequestQueue->addOp(op)))          // transfers refcount
+    if (! (status = queueOp(op)))          // transfers refcount
     {
         mLastReqStatus = status;
         return LLCORE_HTTP_HANDLE_INVALID;
@@ -197,7 +246,7 @@ HttpHandle HttpRequest::requestGet(policy_t policy_id,
         return LLCORE_HTTP_HANDLE_INVALID;
     }
     op->setReplyPath(mReplyQueue, user_handler);
-    if (! (status = mRequestQueue->addOp(op)))          // transfers refcount
+    if (! (status = queueOp(op)))          // transfers refcount
     {
         mLastReqStatus = status;
         return LLCORE_HTTP_HANDLE_INVALID;
@@ -226,7 +275,7 @@ HttpHandle HttpRequest::requestGetByteRange(policy_t policy_id,
         return LLCORE_HTTP_HANDLE_INVALID;
     }
     op->setReplyPath(mReplyQueue, user_handler);
-    if (! (status = mRequestQueue->addOp(op)))          // transfers refcount
+    if (! (status = queueOp(op)))          // transfers refcount
     {
         mLastReqStatus = status;
         return LLCORE_HTTP_HANDLE_INVALID;
@@ -253,7 +302,7 @@ HttpHandle HttpRequest::requestPost(policy_t policy_id,
         return LLCORE_HTTP_HANDLE_INVALID;
     }
     op->setReplyPath(mReplyQueue, user_handler);
-    if (! (status = mRequestQueue->addOp(op)))          // transfers refcount
+    if (! (status = queueOp(op)))          // transfers refcount
     {
         mLastReqStatus = status;
         return LLCORE_HTTP_HANDLE_INVALID;
@@ -280,7 +329,7 @@ HttpHandle HttpRequest::requestPut(policy_t policy_id,
         return LLCORE_HTTP_HANDLE_INVALID;
     }
     op->setReplyPath(mReplyQueue, user_handler);
-    if (! (status = mRequestQueue->addOp(op)))          // transfers refcount
+    if (! (status = queueOp(op)))          // transfers refcount
     {
         mLastReqStatus = status;
         return LLCORE_HTTP_HANDLE_INVALID;
@@ -305,7 +354,7 @@ HttpHandle HttpRequest::requestDelete(policy_t policy_id,
         return LLCORE_HTTP_HANDLE_INVALID;
     }
     op->setReplyPath(mReplyQueue, user_handler);
-    if (!(status = mRequestQueue->addOp(op)))           // transfers refcount
+    if (!(status = queueOp(op)))           // transfers refcount
     {
         mLastReqStatus = status;
         return LLCORE_HTTP_HANDLE_INVALID;
@@ -331,7 +380,7 @@ HttpHandle HttpRequest::requestPatch(policy_t policy_id,
         return LLCORE_HTTP_HANDLE_INVALID;
     }
     op->setReplyPath(mReplyQueue, user_handler);
-    if (!(status = mRequestQueue->addOp(op)))           // transfers refcount
+    if (!(status = queueOp(op)))           // transfers refcount
     {
         mLastReqStatus = status;
         return LLCORE_HTTP_HANDLE_INVALID;
@@ -356,7 +405,7 @@ HttpHandle HttpRequest::requestCopy(policy_t policy_id,
         return LLCORE_HTTP_HANDLE_INVALID;
     }
     op->setReplyPath(mReplyQueue, user_handler);
-    if (!(status = mRequestQueue->addOp(op)))           // transfers refcount
+    if (!(status = queueOp(op)))           // transfers refcount
     {
         mLastReqStatus = status;
         return LLCORE_HTTP_HANDLE_INVALID;
@@ -382,7 +431,7 @@ HttpHandle HttpRequest::requestMove(policy_t policy_id,
         return LLCORE_HTTP_HANDLE_INVALID;
     }
     op->setReplyPath(mReplyQueue, user_handler);
-    if (!(status = mRequestQueue->addOp(op)))           // transfers refcount
+    if (!(status = queueOp(op)))           // transfers refcount
     {
         mLastReqStatus = status;
         return LLCORE_HTTP_HANDLE_INVALID;
@@ -399,7 +448,7 @@ HttpHandle HttpRequest::requestNoOp(HttpHandler::ptr_t user_handler)
 
     HttpOperation::ptr_t op (new HttpOpNull());
     op->setReplyPath(mReplyQueue, user_handler);
-    if (! (status = mRequestQueue->addOp(op)))          // transfers refcount
+    if (! (status = queueOp(op)))          // transfers refcount
     {
         mLastReqStatus = status;
         return LLCORE_HTTP_HANDLE_INVALID;
@@ -465,7 +514,7 @@ HttpHandle HttpRequest::requestCancel(HttpHandle request, HttpHandler::ptr_t use
 
     HttpOperation::ptr_t op(new HttpOpCancel(request));
     op->setReplyPath(mReplyQueue, user_handler);
-    if (! (status = mRequestQueue->addOp(op)))          // transfers refcount
+    if (! (status = queueOp(op)))          // transfers refcount
     {
         mLastReqStatus = status;
         return LLCORE_HTTP_HANDLE_INVALID;
@@ -476,6 +525,60 @@ HttpHandle HttpRequest::requestCancel(HttpHandle request, HttpHandler::ptr_t use
 }
 
 
+void HttpRequest::beginBatch()
+{
+    std::lock_guard<std::mutex> lock(mBatchMutex);
+    mBatching = true;
+}
+
+
+HttpStatus HttpRequest::flushBatch()
+{
+    HttpRequestQueue::OpContainer ops;
+    {
+        std::lock_guard<std::mutex> lock(mBatchMutex);
+        mBatching = false;
+        ops.swap(mBatchOps);
+    }
+    if (ops.empty())
+    {
+        return HttpStatus();
+    }
+
+    group_requests_by_host(ops);
+    HttpStatus status(mRequestQueue->addOps(ops));
+    if (! status)
+    {
+        LL_WARNS("CoreHttp") << "Dropped batch of " << ops.size()
+                             << " requests.  Reason:  " << status.toString()
+                             << LL_ENDL;
+        mLastReqStatus = status;
+    }
+    return status;
+}
+
+
+size_t HttpRequest::getBatchSize() const
+{
+    std::lock_guard<std::mutex> lock(mBatchMutex);
+    return mBatchOps.size();
+}
+
+
+HttpStatus HttpRequest::queueOp(const HttpOperationPtr_t & op)
+{
+    {
+        std::lock_guard<std::mutex> lock(mBatchMutex);
+        if (mBatching)
+        {
+            mBatchOps.push_back(op);
+            return HttpStatus();
+        }
+    }
+    return mRequestQueue->addOp(op);
+}
+
+
 // ====================================
 // Utility Methods
 // ====================================
@@ -528,9 +631,12 @@ HttpHandle HttpRequest::requestStopThread(HttpHandler::ptr_t user_handler)
     HttpStatus status;
     HttpHandle handle(LLCORE_HTTP_HANDLE_INVALID);
 
+    // Anything still deferred has to go out ahead of the stop
+    flushBatch();
+
     HttpOperation::ptr_t op(new HttpOpStop());
     op->setReplyPath(mReplyQueue, user_handler);
-    if (! (status = mRequestQueue->addOp(op)))          // transfers refcount
+    if (! (status = queueOp(op)))          // transfers refcount
     {
         mLastReqStatus = status;
         return handle;
@@ -550,7 +656,7 @@ HttpHandle HttpRequest::requestSpin(int mode)
 
     HttpOperation::ptr_t op(new HttpOpSpin(mode));
     op->setReplyPath(mReplyQueue, HttpHandler::ptr_t());
-    if (! (status = mRequestQueue->addOp(op)))          // transfers refcount
+    if (! (status = queueOp(op)))          // transfers refcount
     {
         mLastReqStatus = status;
         return handle;
@@ -34,6 +34,10 @@
 #include "httpheaders.h"
 #include "httpoptions.h"
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace LLCore
 {
 
@@ -197,7 +201,11 @@ public:
         /// request limit.  Libcurl itself may be caching additional
         /// connections under its connection cache policy.
         ///
-        /// When PIPELINING_DEPTH is 2 or more, libcurl performs
+        /// When PIPELINING_DEPTH is 2 or more, requests are multiplexed
+        /// as HTTP/2 streams where servers support it, PIPELINING_DEPTH
+        /// streams per connection, and the in-flight request limit is
+        /// PO_PER_HOST_CONNECTION_LIMIT times that many streams.
+        /// libcurl performs
         /// connection management and both PO_CONNECTION_LIMIT and
         /// PO_PER_HOST_CONNECTION_LIMIT should be set and non-zero.
         /// In this case (as of libcurl 7.37.0), libcurl will
@@ -232,6 +240,27 @@ public:
         /// Global only
         PO_SSL_VERIFY_CALLBACK,
 
+        /// Long value limiting the number of requests in flight
+        /// over all policy classes with a non-zero PO_URGENCY.
+        /// When the limit is reached, ready requests of those
+        /// classes are started in order of urgency as others
+        /// complete.  Classes with an urgency of zero are not
+        /// counted and not limited.  Zero, the default, disables
+        /// the limit.
+        ///
+        /// Global only
+        PO_ACTIVE_LIMIT,
+
+        /// Long value giving the urgency of requests in this class
+        /// when competing for PO_ACTIVE_LIMIT.  Higher values are
+        /// served first.  A class whose oldest ready request has
+        /// waited longer than HTTP_URGENCY_AGING_INTERVAL gains one
+        /// level per interval waited so that it isn't starved.
+        /// Zero, the default, leaves the class outside of the limit.
+        ///
+        /// Per-class only
+        PO_URGENCY,
+
         PO_LAST  // Always at end
     };
 
@@ -575,6 +604,30 @@ public:
 
     HttpHandle requestCancel(HttpHandle request, HttpHandler::ptr_t);
 
+    /// Defers submission of requests made through this instance.
+    /// Until @see flushBatch() is called, request methods still set
+    /// up their operations and return valid handles but the
+    /// operations are held here instead of being handed to the
+    /// worker thread one at a time.  Calling this while already
+    /// batching is a no-op.
+    void beginBatch();
+
+    /// Submits all deferred operations to the worker thread with a
+    /// single queue insertion and ends batching.  Runs of HTTP
+    /// requests are stably reordered so that requests for the same
+    /// policy class and host are adjacent and can go out back to
+    /// back on kept-alive or pipelined connections.  Any other
+    /// operation keeps its place relative to the requests.
+    ///
+    /// @return                 Standard status.  On failure (i.e.
+    ///                         shutting down), the deferred operations
+    ///                         are dropped without notification.
+    HttpStatus flushBatch();
+
+    /// @return                 Number of operations currently held
+    ///                         back by @see beginBatch().
+    size_t getBatchSize() const;
+
     /// @}
 
     /// @name UtilityMethods
@@ -628,6 +681,9 @@ protected:
 
 private:
     typedef std::shared_ptr<HttpReplyQueue> HttpReplyQueuePtr_t;
+    typedef std::shared_ptr<HttpOperation> HttpOperationPtr_t;
+
+    HttpStatus queueOp(const HttpOperationPtr_t & op);
 
     /// @name InstanceData
     ///
@@ -636,6 +692,12 @@ private:
     HttpReplyQueuePtr_t mReplyQueue;
     HttpRequestQueue *  mRequestQueue;
 
+    // Batching.  Guarded by mBatchMutex as cancels may come from
+    // threads other than the consumer.
+    mutable std::mutex  mBatchMutex;
+    bool                mBatching;
+    std::vector<HttpOperationPtr_t> mBatchOps;
+
     /// @}
 
     // ====================================
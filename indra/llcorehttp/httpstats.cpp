@@ -42,6 +42,7 @@ HTTPStats::~HTTPStats()
 void HTTPStats::resetStats()
 {
     mResutCodes.clear();
+    mHosts.clear();
     mDataDown.reset();
     mDataUp.reset();
     mRequests = 0;
@@ -61,6 +62,25 @@ void HTTPStats::recordResultCode(S32 code)
 
 }
 
+void HTTPStats::recordHostTransfer(const std::string& host, bool http2, bool new_connection, F32 rtt, F32 tls_time)
+{
+    HostStats& stats(mHosts[host]);
+    ++stats.mTransfers;
+    if (http2)
+    {
+        ++stats.mStreams;
+    }
+    if (new_connection)
+    {
+        ++stats.mConnections;
+        stats.mRTT.push(rtt);
+        if (tls_time > 0.f)
+        {
+            stats.mTLSTime.push(tls_time);
+        }
+    }
+}
+
 namespace
 {
     std::string byte_count_converter(F32 bytes)
@@ -101,6 +121,16 @@ void HTTPStats::dumpStats()
         out << (*it).first << " " << (*it).second << std::endl;
     }
 
+    out << std::endl;
+    out << "Hosts (transfers, HTTP/2 streams, connections, mean RTT ms, mean TLS handshake ms):" << std::endl;
+    for (const auto& host : mHosts)
+    {
+        const HostStats& stats(host.second);
+        out << host.first << " " << stats.mTransfers << " " << stats.mStreams << " " << stats.mConnections
+            << " " << std::setprecision(4) << stats.mRTT.getMean() * 1000.f
+            << " " << stats.mTLSTime.getMean() * 1000.f << std::endl;
+    }
+
     LL_WARNS("HTTPCore") << out.str() << LL_ENDL;
 }
 
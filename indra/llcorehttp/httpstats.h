@@ -59,14 +59,27 @@ namespace LLCore
 
         void    recordResultCode(S32 code);
 
+        // a finished transfer to 'host', rtt and tls_time (seconds) only count for new connections
+        void    recordHostTransfer(const std::string& host, bool http2, bool new_connection, F32 rtt, F32 tls_time);
+
         void    dumpStats();
     private:
+        struct HostStats
+        {
+            S32              mTransfers = 0;
+            S32              mStreams = 0;      // transfers multiplexed over HTTP/2
+            S32              mConnections = 0;
+            StatsAccumulator mRTT;
+            StatsAccumulator mTLSTime;
+        };
+
         StatsAccumulator mDataDown;
         StatsAccumulator mDataUp;
 
         S32              mRequests;
 
         std::map<S32, S32> mResutCodes;
+        std::map<std::string, HostStats> mHosts;
     };
 
 
@@ -27,6 +27,7 @@
 #define TEST_LLCORE_BUFFER_ARRAY_H_
 
 #include "bufferarray.h"
+#include "llmemory.h"
 
 #include <iostream>
 
@@ -374,6 +375,58 @@ void BufferArrayTestObjectType::test<8>()
     ba->release();
 }
 
+template <> template <>
+void BufferArrayTestObjectType::test<9>()
+{
+    set_test_name("BufferArray reserve, contiguous and detach");
+
+    // create a new ref counted object with an implicit reference
+    BufferArray * ba = new BufferArray();
+
+    // reserve more than a default block and fill it in pieces
+    const size_t total_len(BufferArray::BLOCK_ALLOC_SIZE * 3 + 17);
+    ensure("Reserve on empty instance succeeds", ba->reserve(total_len));
+    ensure("Reserve doesn't change size", 0 == ba->size());
+    ensure("Second reserve refused", ! ba->reserve(total_len));
+
+    std::vector<char> src(total_len);
+    for (size_t i(0); i < total_len; ++i)
+    {
+        src[i] = char(i * 7);
+    }
+    size_t len(0);
+    for (size_t pos(0); pos < total_len; pos += len)
+    {
+        len = (std::min)(size_t(4000), total_len - pos);
+        ensure_equals("Append length correct", ba->append(&src[pos], len), len);
+    }
+    ensure_equals("Size correct after appends", ba->size(), total_len);
+
+    // all of it is in place
+    char * data(ba->contiguous(0, total_len));
+    ensure("Reserved data contiguous", NULL != data);
+    ensure("Contiguous content correct", 0 == memcmp(data, &src[0], total_len));
+    ensure("Contiguous at offset", (data + 100) == ba->contiguous(100, 50));
+    ensure("Contiguous beyond end refused", NULL == ba->contiguous(100, total_len));
+
+    // hand it over
+    size_t detached_len(0);
+    void * detached(ba->detach(&detached_len));
+    ensure("Detach succeeds", detached == data);
+    ensure_equals("Detached length correct", detached_len, total_len);
+    ensure("Detach leaves instance empty", 0 == ba->size());
+    ll_aligned_free_16(detached);
+
+    // data spread over default blocks stays with the instance
+    ba->append(&src[0], total_len);
+    ensure("Unreserved data not contiguous", NULL == ba->contiguous(0, total_len));
+    ensure("Unreserved data not detached", NULL == ba->detach(&detached_len));
+    ensure_equals("Failed detach keeps data", ba->size(), total_len);
+
+    // release the implicit reference, causing the object to be released
+    ba->release();
+}
+
 }  // end namespace tut
 
 
@@ -0,0 +1,541 @@
+/**
+ * @file llasyncfileio.cpp
+ * @brief Reads and writes completed by the OS rather than a blocking thread.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "llasyncfileio.h"
+
+#include "lltimer.h"
+
+#if LL_LINUX && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define LL_IO_URING 1
+#endif
+#endif
+
+#if LL_IO_URING
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#elif LL_WINDOWS
+#include "llstring.h"
+#include "llwin32headers.h"
+#endif
+
+#include <memory>
+
+//============================================================================
+
+LLAsyncFileIO::LLAsyncFileIO() :
+    mQueueDepth(0),
+    mPending(0),
+    mQuitting(false)
+{
+}
+
+LLAsyncFileIO::~LLAsyncFileIO()
+{
+    // the backends shut down in their destructors, run() is gone by now
+    llassert(!mThread.joinable());
+}
+
+void LLAsyncFileIO::startThread()
+{
+    mThread = std::thread([this]()
+        {
+            LL_PROFILER_SET_THREAD_NAME("AsyncFileIO");
+            run();
+        });
+}
+
+void LLAsyncFileIO::shutdown()
+{
+    if (!mThread.joinable())
+    {
+        return;
+    }
+    mQuitting = true;
+    wake();
+    mThread.join();
+}
+
+bool LLAsyncFileIO::read(const std::string& filename, U8* buffer, S32 offset, S32 bytes, const callback_t& callback)
+{
+    if (offset < 0 || bytes <= 0 || mQuitting)
+    {
+        return false;
+    }
+    return submit(filename, buffer, offset, bytes, false, callback);
+}
+
+bool LLAsyncFileIO::write(const std::string& filename, const U8* buffer, S32 offset, S32 bytes, const callback_t& callback)
+{
+    if (bytes <= 0 || mQuitting)
+    {
+        return false;
+    }
+    // the backends never write through the buffer of a write
+    return submit(filename, const_cast<U8*>(buffer), offset, bytes, true, callback);
+}
+
+void LLAsyncFileIO::beginRequest()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mRequestDone.wait(lock, [this]() { return mPending < (S32)mQueueDepth; });
+    ++mPending;
+}
+
+void LLAsyncFileIO::endRequest()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        --mPending;
+    }
+    mRequestDone.notify_all();
+}
+
+//============================================================================
+
+#if LL_IO_URING
+
+// Talks to the kernel directly rather than through liburing, the rings are
+// simple enough: one submitter at a time under mSubmitMutex, and only the
+// completion thread consumes completions.
+class LLIOUring : public LLAsyncFileIO
+{
+public:
+    LLIOUring() = default;
+    ~LLIOUring() override;
+
+    bool init(U32 queue_depth);
+
+protected:
+    bool submit(const std::string& filename, U8* buffer, S32 offset, S32 bytes, bool write, const callback_t& callback) override;
+    void wake() override;
+    void run() override;
+
+private:
+    struct Request
+    {
+        int mFile;
+        struct iovec mIov;
+        callback_t mCallback;
+        std::string mFilename;
+    };
+
+    // queue one entry, 'request' null for a wake up, the caller holds mSubmitMutex
+    bool push(U8 opcode, Request* request, U64 offset);
+    int enter(U32 to_submit, U32 min_complete, U32 flags);
+
+    std::mutex mSubmitMutex;
+    int mRing = -1;
+    void* mSQRing = MAP_FAILED;
+    void* mCQRing = MAP_FAILED;
+    size_t mSQRingSize = 0;
+    size_t mCQRingSize = 0;
+    struct io_uring_sqe* mSQEs = (struct io_uring_sqe*)MAP_FAILED;
+    size_t mSQEsSize = 0;
+
+    U32* mSQHead = nullptr;
+    U32* mSQTail = nullptr;
+    U32 mSQMask = 0;
+    U32* mSQArray = nullptr;
+    U32* mCQHead = nullptr;
+    U32* mCQTail = nullptr;
+    U32 mCQMask = 0;
+    struct io_uring_cqe* mCQEs = nullptr;
+};
+
+LLIOUring::~LLIOUring()
+{
+    shutdown();
+    if (mSQEs != MAP_FAILED)
+    {
+        munmap(mSQEs, mSQEsSize);
+    }
+    if (mCQRing != MAP_FAILED && mCQRing != mSQRing)
+    {
+        munmap(mCQRing, mCQRingSize);
+    }
+    if (mSQRing != MAP_FAILED)
+    {
+        munmap(mSQRing, mSQRingSize);
+    }
+    if (mRing >= 0)
+    {
+        close(mRing);
+    }
+}
+
+bool LLIOUring::init(U32 queue_depth)
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    mRing = (int)syscall(__NR_io_uring_setup, queue_depth, &params);
+    if (mRing < 0)
+    {
+        // old kernel, or io_uring disabled by the system
+        LL_INFOS() << "io_uring not available: " << strerror(errno) << LL_ENDL;
+        return false;
+    }
+
+    mSQRingSize = params.sq_off.array + params.sq_entries * sizeof(U32);
+    mCQRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap)
+    {
+        mSQRingSize = mCQRingSize = llmax(mSQRingSize, mCQRingSize);
+    }
+
+    mSQRing = mmap(nullptr, mSQRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRing, IORING_OFF_SQ_RING);
+    if (mSQRing == MAP_FAILED)
+    {
+        return false;
+    }
+    mCQRing = single_mmap ? mSQRing : mmap(nullptr, mCQRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRing, IORING_OFF_CQ_RING);
+    if (mCQRing == MAP_FAILED)
+    {
+        return false;
+    }
+    mSQEsSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    mSQEs = (struct io_uring_sqe*)mmap(nullptr, mSQEsSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRing, IORING_OFF_SQES);
+    if (mSQEs == MAP_FAILED)
+    {
+        return false;
+    }
+
+    U8* sq = (U8*)mSQRing;
+    mSQHead = (U32*)(sq + params.sq_off.head);
+    mSQTail = (U32*)(sq + params.sq_off.tail);
+    mSQMask = *(U32*)(sq + params.sq_off.ring_mask);
+    mSQArray = (U32*)(sq + params.sq_off.array);
+    U8* cq = (U8*)mCQRing;
+    mCQHead = (U32*)(cq + params.cq_off.head);
+    mCQTail = (U32*)(cq + params.cq_off.tail);
+    mCQMask = *(U32*)(cq + params.cq_off.ring_mask);
+    mCQEs = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    // the completion ring is at least twice the submission ring, the wake up always fits
+    mQueueDepth = params.sq_entries;
+    startThread();
+    return true;
+}
+
+int LLIOUring::enter(U32 to_submit, U32 min_complete, U32 flags)
+{
+    return (int)syscall(__NR_io_uring_enter, mRing, to_submit, min_complete, flags, nullptr, 0);
+}
+
+bool LLIOUring::push(U8 opcode, Request* request, U64 offset)
+{
+    U32 tail = *mSQTail;
+    U32 head = __atomic_load_n(mSQHead, __ATOMIC_ACQUIRE);
+    if (tail - head > mSQMask)
+    {
+        return false; // entries the kernel did not take yet fill the ring
+    }
+
+    U32 index = tail & mSQMask;
+    struct io_uring_sqe* sqe = &mSQEs[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    if (request)
+    {
+        sqe->fd = request->mFile;
+        sqe->addr = (U64)(uintptr_t)&request->mIov;
+        sqe->len = 1;
+        sqe->off = offset;
+    }
+    else
+    {
+        sqe->fd = -1;
+    }
+    sqe->user_data = (U64)(uintptr_t)request;
+    mSQArray[index] = index;
+    __atomic_store_n(mSQTail, tail + 1, __ATOMIC_RELEASE);
+
+    // also hands over anything an interrupted submission left behind
+    U32 to_submit = tail + 1 - __atomic_load_n(mSQHead, __ATOMIC_ACQUIRE);
+    int ret;
+    do
+    {
+        ret = enter(to_submit, 0, 0);
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0)
+    {
+        // the entry stays in the ring, the next submission hands it over
+        LL_WARNS() << "io_uring submission failed: " << strerror(errno) << LL_ENDL;
+    }
+    return true;
+}
+
+bool LLIOUring::submit(const std::string& filename, U8* buffer, S32 offset, S32 bytes, bool write, const callback_t& callback)
+{
+    int flags = O_CLOEXEC;
+    if (write)
+    {
+        // like LLLFSThread's blocking writes: create, don't truncate, offset -1 appends
+        flags |= O_WRONLY | O_CREAT | (offset < 0 ? O_APPEND : 0);
+    }
+    else
+    {
+        flags |= O_RDONLY;
+    }
+    int file = open(filename.c_str(), flags, 0666);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    Request* request = new Request;
+    request->mFile = file;
+    request->mIov.iov_base = buffer;
+    request->mIov.iov_len = bytes;
+    request->mCallback = callback;
+    request->mFilename = filename;
+
+    beginRequest();
+    bool queued;
+    {
+        std::lock_guard<std::mutex> lock(mSubmitMutex);
+        // O_APPEND writes go to the end whatever the offset
+        queued = push(write ? IORING_OP_WRITEV : IORING_OP_READV, request, offset < 0 ? 0 : (U64)offset);
+    }
+    if (!queued)
+    {
+        endRequest();
+        close(file);
+        delete request;
+    }
+    return queued;
+}
+
+void LLIOUring::wake()
+{
+    std::lock_guard<std::mutex> lock(mSubmitMutex);
+    push(IORING_OP_NOP, nullptr, 0);
+}
+
+void LLIOUring::run()
+{
+    while (!isQuitting() || getPending() > 0)
+    {
+        int ret = enter(0, 1, IORING_ENTER_GETEVENTS);
+        if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            LL_WARNS() << "io_uring wait failed: " << strerror(errno) << LL_ENDL;
+            ms_sleep(1);
+        }
+
+        U32 head = *mCQHead;
+        U32 tail = __atomic_load_n(mCQTail, __ATOMIC_ACQUIRE);
+        while (head != tail)
+        {
+            struct io_uring_cqe* cqe = &mCQEs[head & mCQMask];
+            Request* request = (Request*)(uintptr_t)cqe->user_data;
+            S32 result = cqe->res;
+            __atomic_store_n(mCQHead, ++head, __ATOMIC_RELEASE);
+            if (!request)
+            {
+                continue; // wake up
+            }
+
+            close(request->mFile);
+            if (result < 0)
+            {
+                LL_WARNS() << "Asynchronous I/O failed on " << request->mFilename << ": " << strerror(-result) << LL_ENDL;
+                result = 0;
+            }
+            request->mCallback(result);
+            delete request;
+            endRequest();
+        }
+    }
+}
+
+#elif LL_WINDOWS
+
+class LLIOCompletionPort : public LLAsyncFileIO
+{
+public:
+    LLIOCompletionPort() = default;
+    ~LLIOCompletionPort() override;
+
+    bool init(U32 queue_depth);
+
+protected:
+    bool submit(const std::string& filename, U8* buffer, S32 offset, S32 bytes, bool write, const callback_t& callback) override;
+    void wake() override;
+    void run() override;
+
+private:
+    struct Request
+    {
+        OVERLAPPED mOverlapped;     // first, the completion hands back its address
+        HANDLE mFile;
+        callback_t mCallback;
+        std::string mFilename;
+    };
+
+    // 'error' is 0 on success
+    void complete(Request* request, DWORD bytes, DWORD error);
+
+    HANDLE mPort = NULL;
+};
+
+LLIOCompletionPort::~LLIOCompletionPort()
+{
+    shutdown();
+    if (mPort)
+    {
+        CloseHandle(mPort);
+    }
+}
+
+bool LLIOCompletionPort::init(U32 queue_depth)
+{
+    mPort = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+    if (!mPort)
+    {
+        LL_WARNS() << "Could not create an I/O completion port, error " << GetLastError() << LL_ENDL;
+        return false;
+    }
+    mQueueDepth = queue_depth;
+    startThread();
+    return true;
+}
+
+bool LLIOCompletionPort::submit(const std::string& filename, U8* buffer, S32 offset, S32 bytes, bool write, const callback_t& callback)
+{
+    bool append = write && offset < 0;
+    DWORD access = write ? (append ? FILE_APPEND_DATA : GENERIC_WRITE) : GENERIC_READ;
+    HANDLE file = CreateFileW(ll_convert_string_to_wide(filename).c_str(), access,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+                              write ? OPEN_ALWAYS : OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    if (!CreateIoCompletionPort(file, mPort, 0, 0))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    Request* request = new Request;
+    memset(&request->mOverlapped, 0, sizeof(request->mOverlapped));
+    // all ones asks for the end of the file
+    request->mOverlapped.Offset = append ? 0xFFFFFFFF : (DWORD)offset;
+    request->mOverlapped.OffsetHigh = append ? 0xFFFFFFFF : 0;
+    request->mFile = file;
+    request->mCallback = callback;
+    request->mFilename = filename;
+
+    beginRequest();
+    BOOL started = write ? WriteFile(file, buffer, bytes, NULL, &request->mOverlapped)
+                         : ReadFile(file, buffer, bytes, NULL, &request->mOverlapped);
+    if (!started)
+    {
+        DWORD error = GetLastError();
+        if (error != ERROR_IO_PENDING)
+        {
+            // failed right away, no completion will be queued
+            complete(request, 0, error);
+        }
+    }
+    return true;
+}
+
+void LLIOCompletionPort::complete(Request* request, DWORD bytes, DWORD error)
+{
+    CloseHandle(request->mFile);
+    // reading at or past the end of the file is not a failure
+    if (error && error != ERROR_HANDLE_EOF)
+    {
+        LL_WARNS() << "Asynchronous I/O failed on " << request->mFilename << ", error " << error << LL_ENDL;
+        bytes = 0;
+    }
+    request->mCallback((S32)bytes);
+    delete request;
+    endRequest();
+}
+
+void LLIOCompletionPort::wake()
+{
+    PostQueuedCompletionStatus(mPort, 0, 0, NULL);
+}
+
+void LLIOCompletionPort::run()
+{
+    while (!isQuitting() || getPending() > 0)
+    {
+        DWORD bytes = 0;
+        ULONG_PTR key = 0;
+        LPOVERLAPPED overlapped = NULL;
+        BOOL success = GetQueuedCompletionStatus(mPort, &bytes, &key, &overlapped, INFINITE);
+        if (!overlapped)
+        {
+            if (!success)
+            {
+                LL_WARNS() << "I/O completion port wait failed, error " << GetLastError() << LL_ENDL;
+                ms_sleep(1);
+            }
+            continue; // wake up
+        }
+        complete((Request*)overlapped, bytes, success ? 0 : GetLastError());
+    }
+}
+
+#endif
+
+//============================================================================
+
+//static
+LLAsyncFileIO* LLAsyncFileIO::create(U32 queue_depth)
+{
+#if LL_IO_URING || LL_WINDOWS
+    if (queue_depth > 0)
+    {
+#if LL_IO_URING
+        std::unique_ptr<LLIOUring> io = std::make_unique<LLIOUring>();
+#else
+        std::unique_ptr<LLIOCompletionPort> io = std::make_unique<LLIOCompletionPort>();
+#endif
+        if (io->init(queue_depth))
+        {
+            LL_INFOS() << "Asynchronous file I/O with up to " << io->getQueueDepth() << " requests in flight" << LL_ENDL;
+            return io.release();
+        }
+    }
+#endif
+    // no backend, dispatch_io on macOS hands the data back in buffers of its own
+    return nullptr;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file llasyncfileio.h
+ * @brief Reads and writes completed by the OS rather than a blocking thread.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLASYNCFILEIO_H
+#define LL_LLASYNCFILEIO_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <boost/noncopyable.hpp>
+
+/**
+ * Submission queue for file reads and writes: io_uring on Linux, overlapped
+ * I/O on a completion port on Windows. A request only costs the submitting
+ * thread the open and the submission, so a thread with many requests keeps
+ * the drive busy with all of them instead of waiting on one at a time.
+ *
+ * Completions run on a thread of the backend's own. Platforms without a
+ * backend get nullptr from create() and keep their blocking reads.
+ */
+class LLAsyncFileIO : private boost::noncopyable
+{
+public:
+    // bytes transferred, 0 on failure like LLLFSThread::Responder::completed()
+    typedef std::function<void(S32 bytes)> callback_t;
+
+    // at most 'queue_depth' requests in flight, submitting more waits for one to complete
+    // returns nullptr if the platform or the kernel have no asynchronous file I/O
+    static LLAsyncFileIO* create(U32 queue_depth);
+
+    // the backends shut down first thing in their destructors
+    virtual ~LLAsyncFileIO();
+
+    // 'buffer' must stay valid until 'callback' ran
+    // returns false, without calling 'callback', if the file can't be opened or the request queued
+    bool read(const std::string& filename, U8* buffer, S32 offset, S32 bytes, const callback_t& callback);
+    // offset -1 appends
+    bool write(const std::string& filename, const U8* buffer, S32 offset, S32 bytes, const callback_t& callback);
+
+    // requests submitted and not completed
+    S32 getPending() const { return mPending; }
+    U32 getQueueDepth() const { return mQueueDepth; }
+
+    // waits for the requests in flight and stops the completion thread
+    void shutdown();
+
+protected:
+    LLAsyncFileIO();
+
+    // start the completion thread once the backend is set up
+    void startThread();
+
+    // open 'filename' and queue the request, false if it can't be done
+    virtual bool submit(const std::string& filename, U8* buffer, S32 offset, S32 bytes, bool write, const callback_t& callback) = 0;
+    // wake the completion thread so it sees mQuitting
+    virtual void wake() = 0;
+    // wait for and run completions until quitting with nothing in flight
+    virtual void run() = 0;
+
+    // call when a submission is about to be made, waits for room in the queue
+    void beginRequest();
+    // call from the completion thread when a request is done, or when a submission failed after beginRequest()
+    void endRequest();
+
+    bool isQuitting() const { return mQuitting; }
+
+    U32 mQueueDepth;
+
+private:
+    std::mutex mMutex;
+    std::condition_variable mRequestDone;
+    std::atomic<S32> mPending;
+    std::atomic<bool> mQuitting;
+    std::thread mThread;
+};
+
+#endif // LL_LLASYNCFILEIO_H
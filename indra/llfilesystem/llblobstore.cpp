@@ -0,0 +1,401 @@
+/**
+ * @file llblobstore.cpp
+ * @brief Small cache files packed into shared segment files.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llblobstore.h"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+
+#include "lldir.h"
+#include "llfile.h"
+
+// Segments are mapped whole, records never span two of them
+static const U32 SEGMENT_SIZE = 16 * 1024 * 1024;
+static const U32 RECORD_ALIGN = 16;
+static const U32 BLOB_MAGIC = 0x424c4f42;  // "BLOB"
+static const U32 BLOB_REMOVED = 0x1;
+static const std::string SEGMENT_PREFIX("blob_segment_");
+
+// Written after the data, a record only counts once its magic is there
+struct RecordHeader
+{
+    U32 mMagic;
+    U32 mSize;
+    U32 mFlags;
+    U32 mNameLength;
+    U64 mSerial;
+    S64 mTime;
+    char mName[64];
+};
+static_assert(sizeof(RecordHeader) % RECORD_ALIGN == 0, "record data has to stay aligned");
+
+static U32 record_size(U32 size)
+{
+    return (U32)((sizeof(RecordHeader) + size + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1));
+}
+
+LLBlobStore::LLBlobStore(const std::string& dir, U32 max_blob_size) :
+    mDir(dir),
+    mMaxBlobSize(llmin(max_blob_size, SEGMENT_SIZE / 4)),
+    mNextSerial(1)
+{
+    openSegments();
+}
+
+LLBlobStore::~LLBlobStore()
+{
+    // the mappings flush as they close
+    mSegments.clear();
+}
+
+std::string LLBlobStore::getSegmentPath(U32 segment) const
+{
+    return mDir + gDirUtilp->getDirDelimiter() + SEGMENT_PREFIX + llformat("%04u.dat", segment);
+}
+
+void LLBlobStore::openSegments()
+{
+    std::vector<U32> numbers;
+
+    boost::system::error_code ec;
+#if LL_WINDOWS
+    std::wstring dir_path(utf8str_to_utf16str(mDir));
+#else
+    std::string dir_path(mDir);
+#endif
+    if (boost::filesystem::is_directory(dir_path, ec) && !ec.failed())
+    {
+        boost::filesystem::directory_iterator iter(dir_path, ec);
+        while (iter != boost::filesystem::directory_iterator() && !ec.failed())
+        {
+            const std::string name = (*iter).path().filename().string();
+            U32 number = 0;
+            if (name.compare(0, SEGMENT_PREFIX.size(), SEGMENT_PREFIX) == 0
+                && sscanf(name.c_str() + SEGMENT_PREFIX.size(), "%u.dat", &number) == 1)
+            {
+                numbers.push_back(number);
+            }
+            iter.increment(ec);
+        }
+    }
+
+    // segments were written in order, so the newest record comes last
+    std::sort(numbers.begin(), numbers.end());
+    std::unordered_map<std::string, U64> serials;
+    for (U32 number : numbers)
+    {
+        if (number >= mSegments.size())
+        {
+            mSegments.resize(number + 1);
+        }
+
+        std::unique_ptr<Segment> segment(new Segment);
+        if (!segment->mFile.open(getSegmentPath(number), SEGMENT_SIZE))
+        {
+            LL_WARNS() << "Unable to map blob segment " << getSegmentPath(number) << LL_ENDL;
+            continue;
+        }
+        mSegments[number] = std::move(segment);
+        scanSegment(number, serials);
+    }
+
+    LL_INFOS() << "Blob store has " << mIndex.size() << " blobs in " << numbers.size() << " segments" << LL_ENDL;
+}
+
+void LLBlobStore::scanSegment(U32 number, std::unordered_map<std::string, U64>& serials)
+{
+    Segment* segment = mSegments[number].get();
+    const U8* data = segment->mFile.getData();
+
+    U32 offset = 0;
+    while (offset + sizeof(RecordHeader) <= SEGMENT_SIZE)
+    {
+        RecordHeader header;
+        memcpy(&header, data + offset, sizeof(RecordHeader));
+        if (header.mMagic != BLOB_MAGIC
+            || header.mSize > SEGMENT_SIZE - offset - sizeof(RecordHeader)
+            || header.mNameLength == 0 || header.mNameLength > sizeof(header.mName))
+        {
+            // the end of what was written, or a record cut short by a crash
+            break;
+        }
+
+        const std::string name(header.mName, header.mNameLength);
+        U64& serial = serials[name];
+        if (header.mSerial > serial)
+        {
+            serial = header.mSerial;
+
+            index_t::iterator it = mIndex.find(name);
+            if (it != mIndex.end())
+            {
+                mSegments[it->second.mSegment]->mLiveBytes -= it->second.mSize;
+                mIndex.erase(it);
+            }
+            if (!(header.mFlags & BLOB_REMOVED))
+            {
+                mIndex[name] = { number, offset, header.mSize, (std::time_t)header.mTime };
+                segment->mLiveBytes += header.mSize;
+            }
+        }
+        mNextSerial = llmax(mNextSerial, header.mSerial + 1);
+        offset += record_size(header.mSize);
+    }
+    segment->mWriteOffset = offset;
+}
+
+LLBlobStore::Segment* LLBlobStore::getWritableSegment(U32 size, U32& number)
+{
+    if (!mSegments.empty() && mSegments.back()
+        && mSegments.back()->mWriteOffset + size <= SEGMENT_SIZE)
+    {
+        number = (U32)mSegments.size() - 1;
+        return mSegments.back().get();
+    }
+
+    number = (U32)mSegments.size();
+    std::unique_ptr<Segment> segment(new Segment);
+    if (!segment->mFile.open(getSegmentPath(number), SEGMENT_SIZE))
+    {
+        LL_WARNS() << "Unable to create blob segment " << getSegmentPath(number) << LL_ENDL;
+        return nullptr;
+    }
+    mSegments.push_back(std::move(segment));
+    return mSegments.back().get();
+}
+
+bool LLBlobStore::appendRecord(const std::string& name, const U8* data, U32 size, std::time_t time, bool removed)
+{
+    RecordHeader header;
+    if (name.empty() || name.size() > sizeof(header.mName))
+    {
+        return false;
+    }
+
+    U32 number = 0;
+    Segment* segment = getWritableSegment(record_size(size), number);
+    if (!segment)
+    {
+        return false;
+    }
+
+    memset(&header, 0, sizeof(header));
+    header.mMagic = BLOB_MAGIC;
+    header.mSize = size;
+    header.mFlags = removed ? BLOB_REMOVED : 0;
+    header.mNameLength = (U32)name.size();
+    header.mSerial = mNextSerial++;
+    header.mTime = (S64)time;
+    memcpy(header.mName, name.data(), name.size());
+
+    const U32 offset = segment->mWriteOffset;
+    U8* record = segment->mFile.getData() + offset;
+    if (size)
+    {
+        memcpy(record + sizeof(RecordHeader), data, size);
+    }
+    memcpy(record, &header, sizeof(RecordHeader));
+    segment->mWriteOffset += record_size(size);
+
+    index_t::iterator it = mIndex.find(name);
+    if (it != mIndex.end())
+    {
+        mSegments[it->second.mSegment]->mLiveBytes -= it->second.mSize;
+        mIndex.erase(it);
+    }
+    if (!removed)
+    {
+        mIndex[name] = { number, offset, size, time };
+        segment->mLiveBytes += size;
+    }
+    return true;
+}
+
+bool LLBlobStore::put(const std::string& name, const U8* data, U32 size)
+{
+    if (size > mMaxBlobSize)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    return appendRecord(name, data, size, std::time(nullptr), false);
+}
+
+S32 LLBlobStore::getSize(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    index_t::const_iterator it = mIndex.find(name);
+    return it != mIndex.end() ? (S32)it->second.mSize : -1;
+}
+
+S32 LLBlobStore::read(const std::string& name, U32 offset, U8* buffer, S32 bytes)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    index_t::const_iterator it = mIndex.find(name);
+    if (it == mIndex.end())
+    {
+        return -1;
+    }
+
+    const Location& location = it->second;
+    if (offset >= location.mSize || bytes <= 0)
+    {
+        return 0;
+    }
+
+    U32 count = llmin((U32)bytes, location.mSize - offset);
+    const U8* data = mSegments[location.mSegment]->mFile.getData() + location.mOffset + sizeof(RecordHeader);
+    memcpy(buffer, data + offset, count);
+    return (S32)count;
+}
+
+bool LLBlobStore::remove(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    index_t::iterator it = mIndex.find(name);
+    if (it == mIndex.end())
+    {
+        return false;
+    }
+
+    if (!appendRecord(name, nullptr, 0, std::time(nullptr), true))
+    {
+        // no room for the tombstone, the blob comes back after a restart
+        mSegments[it->second.mSegment]->mLiveBytes -= it->second.mSize;
+        mIndex.erase(it);
+    }
+    return true;
+}
+
+bool LLBlobStore::rename(const std::string& old_name, const std::string& new_name)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    index_t::iterator it = mIndex.find(old_name);
+    if (it == mIndex.end())
+    {
+        return false;
+    }
+
+    // the source stays mapped while a new segment is added
+    const Location location = it->second;
+    const U8* data = mSegments[location.mSegment]->mFile.getData() + location.mOffset + sizeof(RecordHeader);
+    if (!appendRecord(new_name, data, location.mSize, location.mTime, false))
+    {
+        return false;
+    }
+    appendRecord(old_name, nullptr, 0, std::time(nullptr), true);
+    return true;
+}
+
+void LLBlobStore::compact()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    U64 used = 0;
+    U64 live = 0;
+    U32 oldest = 0;
+    U32 count = 0;
+    for (U32 i = 0; i < mSegments.size(); ++i)
+    {
+        if (mSegments[i])
+        {
+            if (!count++)
+            {
+                oldest = i;
+            }
+            used += mSegments[i]->mWriteOffset;
+            live += mSegments[i]->mLiveBytes;
+        }
+    }
+
+    // never the segment being written, and only once a segment's worth or a
+    // quarter of the store is dead
+    const U64 dead = used - live;
+    if (count < 2 || (dead < SEGMENT_SIZE && dead * 4 < used))
+    {
+        return;
+    }
+
+    // Only the oldest segment is compacted: its tombstones can then only be
+    // for records in itself, and none comes back when they are dropped.
+    Segment* segment = mSegments[oldest].get();
+    const U8* data = segment->mFile.getData();
+    U32 moved = 0;
+    for (U32 offset = 0; offset < segment->mWriteOffset; )
+    {
+        RecordHeader header;
+        memcpy(&header, data + offset, sizeof(RecordHeader));
+
+        const std::string name(header.mName, header.mNameLength);
+        index_t::const_iterator it = mIndex.find(name);
+        if (it != mIndex.end() && it->second.mSegment == oldest && it->second.mOffset == offset)
+        {
+            if (!appendRecord(name, data + offset + sizeof(RecordHeader), header.mSize, it->second.mTime, false))
+            {
+                // out of disk space, keep the segment as it is
+                return;
+            }
+            ++moved;
+        }
+        offset += record_size(header.mSize);
+    }
+
+    LL_DEBUGS() << "Compacted blob segment " << oldest << ", moved " << moved << " blobs" << LL_ENDL;
+    dropSegment(oldest);
+}
+
+void LLBlobStore::dropSegment(U32 number)
+{
+    mSegments[number].reset();
+    LLFile::remove(getSegmentPath(number), ENOENT);
+}
+
+void LLBlobStore::clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (U32 i = 0; i < mSegments.size(); ++i)
+    {
+        if (mSegments[i])
+        {
+            dropSegment(i);
+        }
+    }
+    mSegments.clear();
+    mIndex.clear();
+}
+
+void LLBlobStore::getEntries(std::vector<Entry>& entries)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    entries.reserve(entries.size() + mIndex.size());
+    for (const index_t::value_type& entry : mIndex)
+    {
+        entries.push_back({ entry.first, entry.second.mSize, entry.second.mTime });
+    }
+}
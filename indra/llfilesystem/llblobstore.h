@@ -0,0 +1,129 @@
+/**
+ * @file llblobstore.h
+ * @brief Small cache files packed into shared segment files.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLBLOBSTORE_H
+#define LL_LLBLOBSTORE_H
+
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "llmappedfile.h"
+
+/**
+ * Keeps the small files of LLDiskCache (most sounds, animations, gestures,
+ * notecards are a few KB) as records in a few large memory mapped segment
+ * files instead of a file each, which is what costs the most for them,
+ * especially with a virus scanner looking at every file opened.
+ *
+ * Blobs are named by the cache file name they stand in for, LLFileSystem
+ * checks here before going to the file and LLDiskCache counts the blobs in
+ * its LRU index like any other file.
+ *
+ * Records are only ever appended; replacing or removing a blob appends a new
+ * record or a tombstone. Every record header carries a serial number, the
+ * index is rebuilt at startup from the headers, newest record winning. Once
+ * enough of the store is dead, compact() copies the live records of the
+ * oldest segment to the newest one and deletes it.
+ *
+ * All methods may be called from any thread.
+ */
+class LLBlobStore : private boost::noncopyable
+{
+public:
+    // 'dir' holds the segment files, blobs bigger than 'max_blob_size' are not taken
+    LLBlobStore(const std::string& dir, U32 max_blob_size);
+    ~LLBlobStore();
+
+    U32 getMaxBlobSize() const { return mMaxBlobSize; }
+
+    // store 'size' bytes as 'name', replacing what was there
+    // returns false if the blob is too big or no segment could be mapped
+    bool put(const std::string& name, const U8* data, U32 size);
+
+    // -1 if there is no such blob
+    S32 getSize(const std::string& name);
+
+    // copy up to 'bytes' from 'offset' into 'buffer'
+    // returns the number of bytes copied, -1 if there is no such blob
+    S32 read(const std::string& name, U32 offset, U8* buffer, S32 bytes);
+
+    // returns false if there was no such blob
+    bool remove(const std::string& name);
+    bool rename(const std::string& old_name, const std::string& new_name);
+
+    // copy the oldest segment forward if enough of the store is dead
+    void compact();
+
+    // remove every blob and segment
+    void clear();
+
+    struct Entry
+    {
+        std::string mName;
+        U32 mSize;
+        std::time_t mTime;
+    };
+    void getEntries(std::vector<Entry>& entries);
+
+private:
+    struct Segment
+    {
+        LLMappedFile mFile;
+        U32 mWriteOffset = 0;
+        U32 mLiveBytes = 0;     // data of the records the index points at
+    };
+
+    struct Location
+    {
+        U32 mSegment;
+        U32 mOffset;            // of the record header
+        U32 mSize;
+        std::time_t mTime;
+    };
+    typedef std::unordered_map<std::string, Location> index_t;
+
+    std::string getSegmentPath(U32 segment) const;
+    void openSegments();
+    void scanSegment(U32 segment, std::unordered_map<std::string, U64>& serials);
+    Segment* getWritableSegment(U32 record_size, U32& segment);
+    bool appendRecord(const std::string& name, const U8* data, U32 size, std::time_t time, bool removed);
+    void dropSegment(U32 segment);
+
+    std::mutex mMutex;
+    std::string mDir;
+    U32 mMaxBlobSize;
+    std::vector<std::unique_ptr<Segment> > mSegments;  // by number, null for deleted ones
+    index_t mIndex;
+    U64 mNextSerial;
+};
+
+#endif // LL_LLBLOBSTORE_H
@@ -34,10 +34,13 @@
 #include "llapp.h"
 #include "llassettype.h"
 #include "lldir.h"
+#include "llfile.h"
 #include <boost/filesystem.hpp>
 #include <chrono>
+#include <sstream>
 
 #include "lldiskcache.h"
+#include "llblobstore.h"
 
  /**
   * The prefix inserted at the start of a cache file filename to
@@ -49,20 +52,102 @@
   */
 static const std::string CACHE_FILENAME_PREFIX("sl_cache");
 
+/**
+ * The journal of the index, one record per line:
+ *   + <name> <size> <access time>   file added, written or accessed
+ *   - <name>                        file removed
+ *   O                               opened by a viewer
+ *   C                               closed cleanly
+ * A journal that does not end with a C was left by a viewer that did not
+ * exit cleanly and can miss files, the cache directory is scanned instead.
+ * A read only viewer (a second instance) drops the rescan marker instead
+ * of touching the journal since the files it writes are not recorded.
+ */
+static const std::string JOURNAL_FILENAME("disk_cache_index.txt");
+static const std::string RESCAN_FILENAME("disk_cache_index.rescan");
+
+/**
+ * Past this many records over two per file, the journal is rewritten
+ */
+static const size_t JOURNAL_COMPACT_SLACK = 4096;
+
+/**
+ * Accesses are only journalled when the last recorded one is older than
+ * this, the order in memory is always exact. Same threshold the file
+ * access times used to be updated at (SL-14582).
+ */
+constexpr std::time_t ACCESS_JOURNAL_THRESHOLD = 1 * 60 * 60;
+
+static boost::filesystem::path native_path(const std::string& path)
+{
+#if LL_WINDOWS
+    return boost::filesystem::path(utf8str_to_utf16str(path));
+#else
+    return boost::filesystem::path(path);
+#endif
+}
+
 std::string LLDiskCache::sCacheDir;
 
 LLDiskCache::LLDiskCache(const std::string& cache_dir,
                          const uintmax_t max_size_bytes,
-                         const bool enable_cache_debug_info) :
+                         const bool enable_cache_debug_info,
+                         const bool read_only) :
     mMaxSizeBytes(max_size_bytes),
-    mEnableCacheDebugInfo(enable_cache_debug_info)
+    mEnableCacheDebugInfo(enable_cache_debug_info),
+    mIndexBytes(0),
+    mJournalRecords(0),
+    mReadOnly(read_only)
 {
     sCacheDir = cache_dir;
     LLFile::mkdir(cache_dir);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    const std::string rescan_path = sCacheDir + gDirUtilp->getDirDelimiter() + RESCAN_FILENAME;
+    bool rescan = LLFile::isfile(rescan_path);
+    bool scanned = false;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mIndexMutex);
+        if (rescan || !loadIndex())
+        {
+            scanIndex();
+            scanned = true;
+        }
+    }
+
+    if (mReadOnly)
+    {
+        llofstream marker(rescan_path, std::ios::binary);
+    }
+    else
+    {
+        if (rescan)
+        {
+            LLFile::remove(rescan_path, ENOENT);
+        }
+        if (scanned)
+        {
+            writeSnapshot();
+        }
+        mJournalPending += "O\n";
+        flushJournal();
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    LL_INFOS() << (scanned ? "Scanned " : "Loaded ") << mIndex.size() << " cache files (" << mIndexBytes << " bytes) in "
+               << std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count() << " ms" << LL_ENDL;
 }
 
-// WARNING: purge() is called by LLPurgeDiskCacheThread. As such it must
-// NOT touch any LLDiskCache data without introducing and locking a mutex!
+LLDiskCache::~LLDiskCache()
+{
+    if (!mReadOnly)
+    {
+        flushJournal();
+        mJournalPending += "C\n";
+        flushJournal();
+    }
+}
 
 // Interaction through the filesystem itself should be safe. Let’s say thread
 // A is accessing the cache file for reading/writing and thread B is trimming
@@ -101,6 +186,266 @@ void LLDiskCache::purge()
 
     typedef std::pair<std::time_t, std::pair<uintmax_t, std::string>> file_info_t;
     std::vector<file_info_t> file_info;
+    uintmax_t file_size_total = 0;
+
+    // Take the least recently used files off the index, they are deleted
+    // after the lock is released. A file written again in between gets
+    // deleted regardless and has to be fetched again, as when another thread
+    // opens a file just before it is removed (see above).
+    {
+        std::lock_guard<std::recursive_mutex> lock(mIndexMutex);
+        while (mIndexBytes > mMaxSizeBytes && !mLRU.empty())
+        {
+            const std::string name = mLRU.back();
+            const IndexEntry& entry = mIndex[name];
+            file_info.push_back(file_info_t(entry.mAccessTime, { entry.mSize, name }));
+            removeEntry(name);
+            journalRemove(name);
+        }
+        file_size_total = mIndexBytes;
+    }
+
+    LL_INFOS() << "Purging cache to a maximum of " << mMaxSizeBytes << " bytes" << LL_ENDL;
+
+    for (file_info_t& entry : file_info)
+    {
+        if (mBlobStore && mBlobStore->remove(entry.second.second))
+        {
+            continue;
+        }
+
+        const std::string file_path = sCacheDir + gDirUtilp->getDirDelimiter() + entry.second.second;
+        boost::filesystem::remove(native_path(file_path), ec);
+        if (ec.failed() && ec != boost::system::errc::no_such_file_or_directory)
+        {
+            LL_WARNS() << "Failed to delete cache file " << file_path << ": " << ec.message() << LL_ENDL;
+        }
+    }
+
+    if (mBlobStore)
+    {
+        mBlobStore->compact();
+    }
+
+    if (mEnableCacheDebugInfo)
+    {
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto execute_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+        // Log afterward so it doesn't affect the time measurement
+        // Logging thousands of file results can take hundreds of milliseconds
+        for (const file_info_t& entry : file_info)
+        {
+            // have to do this because of LL_INFO/LL_END weirdness
+            std::ostringstream line;
+
+            line << "DELETE:  ";
+            line << entry.first << "  ";
+            line << entry.second.first << "  ";
+            line << entry.second.second;
+            line << " (" << file_size_total << "/" << mMaxSizeBytes << ")";
+            LL_INFOS() << line.str() << LL_ENDL;
+        }
+
+        LL_INFOS() << "Total dir size after purge is " << dirFileSize(sCacheDir) << LL_ENDL;
+        LL_INFOS() << "Cache purge took " << execute_time << " ms to execute for " << file_info.size() << " files" << LL_ENDL;
+    }
+}
+
+void LLDiskCache::fileAccessed(const std::string& file_path)
+{
+    const std::string name = gDirUtilp->getBaseFileName(file_path);
+    const std::time_t cur_time = std::time(nullptr);
+
+    std::lock_guard<std::recursive_mutex> lock(mIndexMutex);
+    index_t::iterator it = mIndex.find(name);
+    if (it != mIndex.end())
+    {
+        IndexEntry& entry = it->second;
+        mLRU.splice(mLRU.begin(), mLRU, entry.mLRU);
+        if (cur_time - entry.mAccessTime > ACCESS_JOURNAL_THRESHOLD)
+        {
+            entry.mAccessTime = cur_time;
+            journalEntry(name, entry.mSize, cur_time);
+        }
+        return;
+    }
+
+    // not one of ours or written by another viewer instance
+    if (name.find(CACHE_FILENAME_PREFIX) == std::string::npos)
+    {
+        return;
+    }
+    boost::system::error_code ec;
+    uintmax_t file_size = boost::filesystem::file_size(native_path(file_path), ec);
+    if (!ec.failed())
+    {
+        setEntry(name, file_size, cur_time);
+        journalEntry(name, file_size, cur_time);
+    }
+}
+
+void LLDiskCache::fileWritten(const std::string& file_path, uintmax_t size, bool grow_only)
+{
+    const std::string name = gDirUtilp->getBaseFileName(file_path);
+    const std::time_t cur_time = std::time(nullptr);
+
+    std::lock_guard<std::recursive_mutex> lock(mIndexMutex);
+    if (grow_only)
+    {
+        index_t::iterator it = mIndex.find(name);
+        if (it != mIndex.end())
+        {
+            size = llmax(size, it->second.mSize);
+        }
+    }
+    setEntry(name, size, cur_time);
+    journalEntry(name, size, cur_time);
+}
+
+void LLDiskCache::fileRemoved(const std::string& file_path)
+{
+    const std::string name = gDirUtilp->getBaseFileName(file_path);
+
+    std::lock_guard<std::recursive_mutex> lock(mIndexMutex);
+    if (mIndex.find(name) != mIndex.end())
+    {
+        removeEntry(name);
+        journalRemove(name);
+    }
+}
+
+void LLDiskCache::fileRenamed(const std::string& old_path, const std::string& new_path)
+{
+    const std::string old_name = gDirUtilp->getBaseFileName(old_path);
+
+    std::lock_guard<std::recursive_mutex> lock(mIndexMutex);
+    index_t::iterator it = mIndex.find(old_name);
+    if (it == mIndex.end())
+    {
+        fileAccessed(new_path);
+        return;
+    }
+
+    const std::string new_name = gDirUtilp->getBaseFileName(new_path);
+    const uintmax_t size = it->second.mSize;
+    const std::time_t cur_time = std::time(nullptr);
+    removeEntry(old_name);
+    journalRemove(old_name);
+    setEntry(new_name, size, cur_time);
+    journalEntry(new_name, size, cur_time);
+}
+
+void LLDiskCache::setEntry(const std::string& name, uintmax_t size, std::time_t access_time)
+{
+    index_t::iterator it = mIndex.find(name);
+    if (it == mIndex.end())
+    {
+        mLRU.push_front(name);
+        mIndex.emplace(name, IndexEntry{ size, access_time, mLRU.begin() });
+        mIndexBytes += size;
+        return;
+    }
+
+    IndexEntry& entry = it->second;
+    mIndexBytes = mIndexBytes - entry.mSize + size;
+    entry.mSize = size;
+    entry.mAccessTime = access_time;
+    mLRU.splice(mLRU.begin(), mLRU, entry.mLRU);
+}
+
+void LLDiskCache::removeEntry(const std::string& name)
+{
+    index_t::iterator it = mIndex.find(name);
+    if (it != mIndex.end())
+    {
+        mIndexBytes -= it->second.mSize;
+        mLRU.erase(it->second.mLRU);
+        mIndex.erase(it);
+    }
+}
+
+void LLDiskCache::journalEntry(const std::string& name, uintmax_t size, std::time_t access_time)
+{
+    mJournalPending += llformat("+ %s %llu %lld\n", name.c_str(), (unsigned long long)size, (long long)access_time);
+    ++mJournalRecords;
+}
+
+void LLDiskCache::journalRemove(const std::string& name)
+{
+    mJournalPending += "- " + name + "\n";
+    ++mJournalRecords;
+}
+
+void LLDiskCache::clearIndex()
+{
+    mIndex.clear();
+    mLRU.clear();
+    mIndexBytes = 0;
+    mJournalPending.clear();
+    mJournalRecords = 0;
+}
+
+std::string LLDiskCache::getJournalPath() const
+{
+    return sCacheDir + gDirUtilp->getDirDelimiter() + JOURNAL_FILENAME;
+}
+
+bool LLDiskCache::loadIndex()
+{
+    llifstream journal(getJournalPath(), std::ios::binary);
+    if (!journal.is_open())
+    {
+        return false;
+    }
+
+    bool clean = false;
+    std::string line;
+    while (std::getline(journal, line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+
+        std::istringstream record(line);
+        char op = 0;
+        std::string name;
+        record >> op;
+        clean = op == 'C';
+        if (op == '+')
+        {
+            uintmax_t size = 0;
+            long long access_time = 0;
+            if (record >> name >> size >> access_time)
+            {
+                setEntry(name, size, (std::time_t)access_time);
+                ++mJournalRecords;
+            }
+        }
+        else if (op == '-' && record >> name)
+        {
+            removeEntry(name);
+            ++mJournalRecords;
+        }
+    }
+
+    if (!clean)
+    {
+        LL_INFOS() << "Cache index journal was not closed cleanly, rescanning the cache" << LL_ENDL;
+        clearIndex();
+    }
+    return clean;
+}
+
+void LLDiskCache::scanIndex()
+{
+    clearIndex();
+
+    boost::system::error_code ec;
+
+    typedef std::pair<std::time_t, std::pair<uintmax_t, std::string>> file_info_t;
+    std::vector<file_info_t> file_info;
 
 #if LL_WINDOWS
     std::wstring cache_path(utf8str_to_utf16str(sCacheDir));
@@ -114,86 +459,105 @@ void LLDiskCache::purge()
         {
             if (boost::filesystem::is_regular_file(*iter, ec) && !ec.failed())
             {
-                if ((*iter).path().string().find(CACHE_FILENAME_PREFIX) != std::string::npos)
+                const std::string name = (*iter).path().filename().string();
+                if (name.find(CACHE_FILENAME_PREFIX) != std::string::npos)
                 {
                     uintmax_t file_size = boost::filesystem::file_size(*iter, ec);
                     if (ec.failed())
                     {
                         continue;
                     }
-                    const std::string file_path = (*iter).path().string();
                     const std::time_t file_time = boost::filesystem::last_write_time(*iter, ec);
                     if (ec.failed())
                     {
                         continue;
                     }
 
-                    file_info.push_back(file_info_t(file_time, { file_size, file_path }));
+                    file_info.push_back(file_info_t(file_time, { file_size, name }));
                 }
             }
             iter.increment(ec);
         }
     }
 
+    // oldest first, each one goes in front of the LRU list
     std::sort(file_info.begin(), file_info.end(), [](file_info_t& x, file_info_t& y)
     {
-        return x.first > y.first;
+        return x.first < y.first;
     });
 
-    LL_INFOS() << "Purging cache to a maximum of " << mMaxSizeBytes << " bytes" << LL_ENDL;
-
-    std::vector<bool> file_removed;
-    if (mEnableCacheDebugInfo)
+    for (file_info_t& entry : file_info)
     {
-        file_removed.reserve(file_info.size());
+        setEntry(entry.second.second, entry.second.first, entry.first);
     }
-    uintmax_t file_size_total = 0;
-    for (file_info_t& entry : file_info)
+}
+
+void LLDiskCache::writeSnapshot()
+{
+    if (mReadOnly)
     {
-        file_size_total += entry.second.first;
+        return;
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(mIndexMutex);
 
-        bool should_remove = file_size_total > mMaxSizeBytes;
-        if (mEnableCacheDebugInfo)
+    const std::string journal_path = getJournalPath();
+    const std::string temp_path = journal_path + ".tmp";
+    {
+        llofstream journal(temp_path, std::ios::binary | std::ios::trunc);
+        if (!journal.is_open())
         {
-            file_removed.push_back(should_remove);
+            LL_WARNS() << "Unable to write cache index " << temp_path << LL_ENDL;
+            return;
         }
-        if (should_remove)
+
+        for (lru_list_t::reverse_iterator it = mLRU.rbegin(); it != mLRU.rend(); ++it)
         {
-            boost::filesystem::remove(entry.second.second, ec);
-            if (ec.failed())
-            {
-                LL_WARNS() << "Failed to delete cache file " << entry.second.second << ": " << ec.message() << LL_ENDL;
-            }
+            const IndexEntry& entry = mIndex[*it];
+            journal << "+ " << *it << " " << entry.mSize << " " << (long long)entry.mAccessTime << "\n";
         }
     }
 
-    if (mEnableCacheDebugInfo)
+    // rename() needs the target gone on Windows
+    LLFile::remove(journal_path, ENOENT);
+    if (LLFile::rename(temp_path, journal_path) != 0)
     {
-        auto end_time = std::chrono::high_resolution_clock::now();
-        auto execute_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+        return;
+    }
 
-        // Log afterward so it doesn't affect the time measurement
-        // Logging thousands of file results can take hundreds of milliseconds
-        for (size_t i = 0; i < file_info.size(); ++i)
-        {
-            const file_info_t& entry = file_info[i];
-            const bool removed = file_removed[i];
-            const std::string action = removed ? "DELETE:" : "KEEP:";
+    mJournalPending.clear();
+    mJournalRecords = mIndex.size();
+}
 
-            // have to do this because of LL_INFO/LL_END weirdness
-            std::ostringstream line;
+void LLDiskCache::flushJournal()
+{
+    if (mReadOnly)
+    {
+        return;
+    }
 
-            line << action << "  ";
-            line << entry.first << "  ";
-            line << entry.second.first << "  ";
-            line << entry.second.second;
-            line << " (" << file_size_total << "/" << mMaxSizeBytes << ")";
-            LL_INFOS() << line.str() << LL_ENDL;
-        }
+    std::lock_guard<std::recursive_mutex> lock(mIndexMutex);
 
-        LL_INFOS() << "Total dir size after purge is " << dirFileSize(sCacheDir) << LL_ENDL;
-        LL_INFOS() << "Cache purge took " << execute_time << " ms to execute for " << file_info.size() << " files" << LL_ENDL;
+    if (mJournalRecords > mIndex.size() * 2 + JOURNAL_COMPACT_SLACK)
+    {
+        // the snapshot leaves out the open marker, keep the journal marked as in use
+        writeSnapshot();
+        mJournalPending += "O\n";
     }
+
+    if (mJournalPending.empty())
+    {
+        return;
+    }
+
+    llofstream journal(getJournalPath(), std::ios::binary | std::ios::app);
+    if (!journal.is_open())
+    {
+        LL_WARNS() << "Unable to append to cache index " << getJournalPath() << LL_ENDL;
+        return;
+    }
+    journal << mJournalPending;
+    mJournalPending.clear();
 }
 
 const std::string LLDiskCache::metaDataToFilepath(const LLUUID& id, LLAssetType::EType at)
@@ -205,8 +569,14 @@ const std::string LLDiskCache::getCacheInfo()
 {
     std::ostringstream cache_info;
 
+    uintmax_t used_bytes = 0;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mIndexMutex);
+        used_bytes = mIndexBytes;
+    }
+
     F32 max_in_mb = (F32)mMaxSizeBytes / (1024.0f * 1024.0f);
-    F32 percent_used = ((F32)dirFileSize(sCacheDir) / (F32)mMaxSizeBytes) * 100.0f;
+    F32 percent_used = ((F32)used_bytes / (F32)mMaxSizeBytes) * 100.0f;
 
     cache_info << std::fixed;
     cache_info << std::setprecision(1);
@@ -249,6 +619,46 @@ void LLDiskCache::clearCache()
             iter.increment(ec);
         }
     }
+
+    if (mBlobStore)
+    {
+        mBlobStore->clear();
+    }
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(mIndexMutex);
+        clearIndex();
+    }
+    writeSnapshot();
+    if (!mReadOnly)
+    {
+        mJournalPending += "O\n";
+        flushJournal();
+    }
+}
+
+void LLDiskCache::enableBlobStore(U32 max_blob_size)
+{
+    if (!max_blob_size || mReadOnly || mBlobStore)
+    {
+        return;
+    }
+
+    mBlobStore.reset(new LLBlobStore(sCacheDir, max_blob_size));
+
+    // a rescan of the directory does not see the blobs
+    std::vector<LLBlobStore::Entry> entries;
+    mBlobStore->getEntries(entries);
+
+    std::lock_guard<std::recursive_mutex> lock(mIndexMutex);
+    for (const LLBlobStore::Entry& entry : entries)
+    {
+        if (mIndex.find(entry.mName) == mIndex.end())
+        {
+            setEntry(entry.mName, entry.mSize, entry.mTime);
+            journalEntry(entry.mName, entry.mSize, entry.mTime);
+        }
+    }
 }
 
 void LLDiskCache::removeOldVFSFiles()
@@ -339,5 +749,6 @@ void LLPurgeDiskCacheThread::run()
     while (LLApp::instance()->sleep(CHECK_INTERVAL))
     {
         LLDiskCache::instance().purge();
+        LLDiskCache::instance().flushJournal();
     }
 }
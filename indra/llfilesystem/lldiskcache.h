@@ -22,12 +22,18 @@
                     that identifies the type of asset being stored.
         .asset      A file extension of .asset is used to help
                     identify this as a Viewer asset file
- * 2/ The time of last access for a file can be updated instantly
- *    for file reads and automatically as part of the file writes.
- * 3/ The purge algorithm collects a list of all files in the
- *    directory, sorts them by date of last access (write) and then
- *    deletes any files based on age until the total size of all
- *    the files is less than the maximum size specified.
+ * 2/ An in-memory index keeps the size and time of last access of
+ *    every file, ordered from most to least recently used. File reads
+ *    and writes update it through LLFileSystem instead of touching the
+ *    file metadata. The index is journalled to a file in the cache
+ *    directory so it survives restarts; the directory is only scanned
+ *    when there is no journal or the viewer did not exit cleanly.
+ * 3/ The purge algorithm removes the least recently used files from
+ *    the index until the total size of all the files is less than the
+ *    maximum size specified, then deletes them.
+ * 3a/ Optionally the small files are packed into the segment files of
+ *    an LLBlobStore instead (see enableBlobStore), they stay in the
+ *    index under their file name and get purged the same way.
  * 4/ An LLSingleton idiom is used since there will only ever be
  *    a single cache and we want to access it from numerous places.
  * 5/ Performance on my modest system seems very acceptable. For
@@ -62,8 +68,15 @@
 #ifndef _LLDISKCACHE
 #define _LLDISKCACHE
 
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 #include "llsingleton.h"
 
+class LLBlobStore;
+
 class LLDiskCache :
     public LLParamSingleton<LLDiskCache>
 {
@@ -92,9 +105,14 @@ class LLDiskCache :
                      * if there are bugs, we can ask uses to enable this
                      * setting and send us their logs
                      */
-                    const bool enable_cache_debug_info);
+                    const bool enable_cache_debug_info,
+                    /**
+                     * Set when another viewer instance owns the cache, the
+                     * journal is then left alone
+                     */
+                    const bool read_only);
 
-        virtual ~LLDiskCache() = default;
+        virtual ~LLDiskCache();
 
     public:
         /**
@@ -110,15 +128,30 @@ class LLDiskCache :
          * Purge the oldest items in the cache so that the combined size of all files
          * is no bigger than mMaxSizeBytes.
          *
-         * WARNING: purge() is called by LLPurgeDiskCacheThread. As such it must
-         * NOT touch any LLDiskCache data without introducing and locking a mutex!
-         *
-         * Purging the disk cache involves nontrivial work on the viewer's
-         * filesystem. If called on the main thread, this causes a noticeable
-         * freeze.
+         * purge() is called by LLPurgeDiskCacheThread, the index is guarded
+         * by mIndexMutex. Only the evicted files are deleted, there is no
+         * walk of the cache directory.
          */
         void purge();
 
+        /**
+         * Keep the index up to date with what LLFileSystem does to the cache
+         * files. May be called from any thread, none of these touch the disk
+         * except fileAccessed() for a file the index does not know yet.
+         */
+        void fileAccessed(const std::string& file_path);
+        // 'size' is where the write ended, with 'grow_only' the file was not truncated first
+        void fileWritten(const std::string& file_path, uintmax_t size, bool grow_only);
+        void fileRemoved(const std::string& file_path);
+        void fileRenamed(const std::string& old_path, const std::string& new_path);
+
+        /**
+         * Append the index changes made since the last call to the journal,
+         * and rewrite it when it has grown well past the size of the index.
+         * Called by LLPurgeDiskCacheThread after each purge.
+         */
+        void flushJournal();
+
         /**
          * Clear the cache by removing all the files in the specified cache
          * directory individually. Only the files that contain a prefix defined
@@ -133,6 +166,14 @@ class LLDiskCache :
 
         void removeOldVFSFiles();
 
+        /**
+         * Pack files of up to 'max_blob_size' bytes into shared segment
+         * files from now on, 0 leaves every file on its own. Only for the
+         * viewer that owns the cache, not a read only one.
+         */
+        void enableBlobStore(U32 max_blob_size);
+        LLBlobStore* getBlobStore() const { return mBlobStore.get(); }
+
     private:
         /**
          * Utility function to gather the total size the files in a given
@@ -141,7 +182,56 @@ class LLDiskCache :
          */
         uintmax_t dirFileSize(const std::string& dir);
 
+        // build the index from the journal, false if it is missing or the viewer crashed
+        bool loadIndex();
+        // build the index from the files in the cache directory
+        void scanIndex();
+        // replace the journal with one record per file, oldest first
+        void writeSnapshot();
+
+        // the rest assume mIndexMutex is held
+        void setEntry(const std::string& name, uintmax_t size, std::time_t access_time);
+        void removeEntry(const std::string& name);
+        void journalEntry(const std::string& name, uintmax_t size, std::time_t access_time);
+        void journalRemove(const std::string& name);
+        void clearIndex();
+
+        std::string getJournalPath() const;
+
     private:
+        typedef std::list<std::string> lru_list_t;
+
+        struct IndexEntry
+        {
+            uintmax_t mSize;
+            std::time_t mAccessTime;
+            lru_list_t::iterator mLRU;
+        };
+        typedef std::unordered_map<std::string, IndexEntry> index_t;
+
+        /**
+         * Cache files by file name, and the same names from most to least
+         * recently used. mIndexBytes is the sum of the sizes. A std mutex
+         * rather than LLMutex since the asset coroutines read and write
+         * cache files, it is never held across a suspension.
+         */
+        std::recursive_mutex mIndexMutex;
+        index_t mIndex;
+        lru_list_t mLRU;
+        uintmax_t mIndexBytes;
+
+        /**
+         * Records not yet written to the journal and how many the journal
+         * holds. When that is a lot more than the number of files, the
+         * journal is compacted.
+         */
+        std::string mJournalPending;
+        size_t mJournalRecords;
+        bool mReadOnly;
+
+        std::unique_ptr<LLBlobStore> mBlobStore;
+
+
         /**
          * The maximum size of the cache in bytes. After purge is called, the
          * total size of the cache files in the cache directory will be
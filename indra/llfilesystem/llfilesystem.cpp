@@ -33,8 +33,7 @@
 #include "llfilesystem.h"
 #include "llfasttimer.h"
 #include "lldiskcache.h"
-
-#include "boost/filesystem.hpp"
+#include "llblobstore.h"
 
 constexpr S32 LLFileSystem::READ        = 0x00000001;
 constexpr S32 LLFileSystem::WRITE       = 0x00000002;
@@ -43,6 +42,34 @@ constexpr S32 LLFileSystem::APPEND      = 0x00000006;  // 0x00000004 & LLFileSys
 
 static LLTrace::BlockTimerStatHandle FTM_VFILE_WAIT("VFile Wait");
 
+// the store small files are packed into, null when it is not in use
+static LLBlobStore* get_blob_store()
+{
+    return LLDiskCache::instanceExists() ? LLDiskCache::getInstance()->getBlobStore() : nullptr;
+}
+
+// before a write the blob store does not take, turn the blob back into a file
+static void blob_to_file(LLBlobStore* blobs, const std::string& name, const std::string& filename)
+{
+    S32 size = blobs->getSize(name);
+    if (size < 0)
+    {
+        return;
+    }
+
+    std::vector<U8> data(size);
+    if (size)
+    {
+        blobs->read(name, 0, data.data(), size);
+    }
+    llofstream ofs(filename, std::ios::binary);
+    if (ofs)
+    {
+        ofs.write((const char*)data.data(), size);
+    }
+    blobs->remove(name);
+}
+
 LLFileSystem::LLFileSystem(const LLUUID& file_id, const LLAssetType::EType file_type, S32 mode)
 {
     mFileType = file_type;
@@ -59,15 +86,11 @@ LLFileSystem::LLFileSystem(const LLUUID& file_id, const LLAssetType::EType file_
         // build the filename (TODO: we do this in a few places - perhaps we should factor into a single function)
         const std::string filename = LLDiskCache::metaDataToFilepath(mFileID, mFileType);
 
-        // update the last access time for the file if it exists - this is required
+        // update the last access time for the file - this is required
         // even though we are reading and not writing because this is the
         // way the cache works - it relies on a valid "last accessed time" for
         // each file so it knows how to remove the oldest, unused files
-        bool exists = gDirUtilp->fileExists(filename);
-        if (exists)
-        {
-            updateFileAccessTime(filename);
-        }
+        updateFileAccessTime(filename);
     }
 }
 
@@ -77,6 +100,14 @@ bool LLFileSystem::getExists(const LLUUID& file_id, const LLAssetType::EType fil
     LL_PROFILE_ZONE_SCOPED;
     const std::string filename = LLDiskCache::metaDataToFilepath(file_id, file_type);
 
+    if (LLBlobStore* blobs = get_blob_store())
+    {
+        if (blobs->getSize(gDirUtilp->getBaseFileName(filename)) > 0)
+        {
+            return true;
+        }
+    }
+
     llifstream file(filename, std::ios::binary);
     if (file.is_open())
     {
@@ -91,7 +122,17 @@ bool LLFileSystem::removeFile(const LLUUID& file_id, const LLAssetType::EType fi
 {
     const std::string filename = LLDiskCache::metaDataToFilepath(file_id, file_type);
 
+    LLBlobStore* blobs = get_blob_store();
+    if (blobs && blobs->remove(gDirUtilp->getBaseFileName(filename)))
+    {
+        // there is no file next to a blob
+        suppress_error = ENOENT;
+    }
     LLFile::remove(filename.c_str(), suppress_error);
+    if (LLDiskCache::instanceExists())
+    {
+        LLDiskCache::getInstance()->fileRemoved(filename);
+    }
 
     return true;
 }
@@ -106,6 +147,13 @@ bool LLFileSystem::renameFile(const LLUUID& old_file_id, const LLAssetType::ETyp
     // Rename needs the new file to not exist.
     LLFileSystem::removeFile(new_file_id, new_file_type, ENOENT);
 
+    LLBlobStore* blobs = get_blob_store();
+    if (blobs && blobs->rename(gDirUtilp->getBaseFileName(old_filename), gDirUtilp->getBaseFileName(new_filename)))
+    {
+        LLDiskCache::getInstance()->fileRenamed(old_filename, new_filename);
+        return true;
+    }
+
     if (LLFile::rename(old_filename, new_filename) != 0)
     {
         // We would like to return false here indicating the operation
@@ -114,6 +162,10 @@ bool LLFileSystem::renameFile(const LLUUID& old_file_id, const LLAssetType::ETyp
         //return false;
         LL_WARNS() << "Failed to rename " << old_file_id << " to " << new_file_id << " reason: " << strerror(errno) << LL_ENDL;
     }
+    else if (LLDiskCache::instanceExists())
+    {
+        LLDiskCache::getInstance()->fileRenamed(old_filename, new_filename);
+    }
 
     return true;
 }
@@ -123,6 +175,15 @@ S32 LLFileSystem::getFileSize(const LLUUID& file_id, const LLAssetType::EType fi
 {
     const std::string filename = LLDiskCache::metaDataToFilepath(file_id, file_type);
 
+    if (LLBlobStore* blobs = get_blob_store())
+    {
+        S32 blob_size = blobs->getSize(gDirUtilp->getBaseFileName(filename));
+        if (blob_size >= 0)
+        {
+            return blob_size;
+        }
+    }
+
     S32 file_size = 0;
     llifstream file(filename, std::ios::binary);
     if (file.is_open())
@@ -140,6 +201,17 @@ bool LLFileSystem::read(U8* buffer, S32 bytes)
 
     const std::string filename = LLDiskCache::metaDataToFilepath(mFileID, mFileType);
 
+    if (LLBlobStore* blobs = get_blob_store())
+    {
+        S32 read_bytes = blobs->read(gDirUtilp->getBaseFileName(filename), mPosition, buffer, bytes);
+        if (read_bytes >= 0)
+        {
+            mBytesRead = read_bytes;
+            mPosition += mBytesRead;
+            return mBytesRead > 0;
+        }
+    }
+
     llifstream file(filename, std::ios::binary);
     if (file.is_open())
     {
@@ -184,6 +256,46 @@ bool LLFileSystem::write(const U8* buffer, S32 bytes)
 
     bool success = false;
 
+    LLBlobStore* blobs = get_blob_store();
+    if (blobs && mMode != READ_WRITE)
+    {
+        // Whole small files go to the blob store. An append is taken when
+        // the file so far is a blob too, or there is none yet.
+        const std::string name = gDirUtilp->getBaseFileName(filename);
+        S32 size = blobs->getSize(name);
+        if (mMode == WRITE && (U32)bytes <= blobs->getMaxBlobSize())
+        {
+            if (blobs->put(name, buffer, bytes))
+            {
+                // a bigger write may have left a file before
+                LLFile::remove(filename, ENOENT);
+                LLDiskCache::getInstance()->fileWritten(filename, bytes, false);
+                mPosition += bytes;
+                return true;
+            }
+        }
+        else if (mMode == APPEND && (U32)(llmax(size, 0) + bytes) <= blobs->getMaxBlobSize()
+                 && (size >= 0 || !gDirUtilp->fileExists(filename)))
+        {
+            std::vector<U8> data(llmax(size, 0) + bytes);
+            if (size > 0)
+            {
+                blobs->read(name, 0, data.data(), size);
+            }
+            memcpy(data.data() + llmax(size, 0), buffer, bytes);
+            if (blobs->put(name, data.data(), (U32)data.size()))
+            {
+                LLDiskCache::getInstance()->fileWritten(filename, data.size(), false);
+                mPosition = (S32)data.size();
+                return true;
+            }
+        }
+    }
+    if (blobs)
+    {
+        blob_to_file(blobs, gDirUtilp->getBaseFileName(filename), filename);
+    }
+
     if (mMode == APPEND)
     {
         llofstream ofs(filename, std::ios::app | std::ios::binary);
@@ -232,6 +344,12 @@ bool LLFileSystem::write(const U8* buffer, S32 bytes)
         }
     }
 
+    if (success && LLDiskCache::instanceExists())
+    {
+        // a WRITE truncated the file, a READ_WRITE write may have been in the middle of it
+        LLDiskCache::getInstance()->fileWritten(filename, mMode == WRITE ? bytes : mPosition, mMode == READ_WRITE);
+    }
+
     return success;
 }
 
@@ -299,61 +417,11 @@ bool LLFileSystem::remove() const
 
 void LLFileSystem::updateFileAccessTime(const std::string& file_path)
 {
-    /**
-     * Threshold in time_t units that is used to decide if the last access time
-     * time of the file is updated or not. Added as a precaution for the concern
-     * outlined in SL-14582  about frequent writes on older SSDs reducing their
-     * lifespan. I think this is the right place for the threshold value - rather
-     * than it being a pref - do comment on that Jira if you disagree...
-     *
-     * Let's start with 1 hour in time_t units and see how that unfolds
-     */
-    constexpr std::time_t time_threshold = 1 * 60 * 60;
-
-    // current time
-    const std::time_t cur_time = std::time(nullptr);
-
-    boost::system::error_code ec;
-#if LL_WINDOWS
-    // file last write time
-    const std::time_t last_write_time = boost::filesystem::last_write_time(utf8str_to_utf16str(file_path), ec);
-    if (ec.failed())
-    {
-        LL_WARNS() << "Failed to read last write time for cache file " << file_path << ": " << ec.message() << LL_ENDL;
-        return;
-    }
-
-    // delta between cur time and last time the file was written
-    const std::time_t delta_time = cur_time - last_write_time;
-
-    // we only write the new value if the time in time_threshold has elapsed
-    // before the last one
-    if (delta_time > time_threshold)
-    {
-        boost::filesystem::last_write_time(utf8str_to_utf16str(file_path), cur_time, ec);
-    }
-#else
-    // file last write time
-    const std::time_t last_write_time = boost::filesystem::last_write_time(file_path, ec);
-    if (ec.failed())
-    {
-        LL_WARNS() << "Failed to read last write time for cache file " << file_path << ": " << ec.message() << LL_ENDL;
-        return;
-    }
-
-    // delta between cur time and last time the file was written
-    const std::time_t delta_time = cur_time - last_write_time;
-
-    // we only write the new value if the time in time_threshold has elapsed
-    // before the last one
-    if (delta_time > time_threshold)
-    {
-        boost::filesystem::last_write_time(file_path, cur_time, ec);
-    }
-#endif
-
-    if (ec.failed())
+    // The disk cache keeps the access times in its index, only journalling
+    // them now and then (SL-14582 was about wearing out older SSDs with
+    // file time updates on every read)
+    if (LLDiskCache::instanceExists())
     {
-        LL_WARNS() << "Failed to update last write time for cache file " << file_path << ": " << ec.message() << LL_ENDL;
+        LLDiskCache::getInstance()->fileAccessed(file_path);
     }
 }
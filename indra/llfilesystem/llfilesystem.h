@@ -54,7 +54,7 @@ class LLFileSystem
         bool remove() const;
 
         /**
-         * Update the "last write time" of a file to "now". This must be called whenever a
+         * Mark a file as accessed "now" in the disk cache index. This must be called whenever a
          * file in the cache is read (not written) so that the last time the file was
          * accessed is up to date (This is used in the mechanism for purging the cache)
          */
@@ -26,6 +26,7 @@
 
 #include "linden_common.h"
 #include "lllfsthread.h"
+#include "llasyncfileio.h"
 #include "llstl.h"
 #include "llapr.h"
 
@@ -36,10 +37,10 @@
 //============================================================================
 // Run on MAIN thread
 //static
-void LLLFSThread::initClass(bool local_is_threaded)
+void LLLFSThread::initClass(bool local_is_threaded, U32 async_queue_depth)
 {
     llassert(sLocal == NULL);
-    sLocal = new LLLFSThread(local_is_threaded);
+    sLocal = new LLLFSThread(local_is_threaded, async_queue_depth);
 }
 
 //static
@@ -64,21 +65,50 @@ void LLLFSThread::cleanupClass()
 
 //----------------------------------------------------------------------------
 
-LLLFSThread::LLLFSThread(bool threaded) :
-    LLQueuedThread("LFS", threaded)
+LLLFSThread::LLLFSThread(bool threaded, U32 async_queue_depth) :
+    LLQueuedThread("LFS", threaded),
+    mAsyncIO(NULL)
 {
     if(!mLocalAPRFilePoolp)
     {
         mLocalAPRFilePoolp = new LLVolatileAPRPool() ;
     }
+    if (threaded)
+    {
+        // NULL where the platform has no backend
+        mAsyncIO = LLAsyncFileIO::create(async_queue_depth);
+    }
 }
 
 LLLFSThread::~LLLFSThread()
 {
+    delete mAsyncIO;
     // mLocalAPRFilePoolp cleanup in LLThread
     // ~LLQueuedThread() will be called here
 }
 
+//virtual
+void LLLFSThread::shutdown()
+{
+    LLQueuedThread::shutdown();
+    if (mAsyncIO)
+    {
+        // answers the requests still in flight
+        mAsyncIO->shutdown();
+    }
+}
+
+//virtual
+size_t LLLFSThread::getPending()
+{
+    size_t pending = LLQueuedThread::getPending();
+    if (mAsyncIO)
+    {
+        pending += mAsyncIO->getPending();
+    }
+    return pending;
+}
+
 //----------------------------------------------------------------------------
 
 LLLFSThread::handle_t LLLFSThread::read(const std::string& filename,    /* Flawfinder: ignore */
@@ -180,6 +210,29 @@ bool LLLFSThread::Request::processRequest()
 {
     LL_PROFILE_ZONE_SCOPED;
     bool complete = false;
+    LLAsyncFileIO* async_io = mThread->mAsyncIO;
+    if (async_io && ((mOperation == FILE_READ && mOffset >= 0) || mOperation == FILE_WRITE))
+    {
+        // the completion answers the responder, finishRequest() finds none left
+        LLPointer<Responder> responder = mResponder;
+        mResponder = NULL;
+        LLAsyncFileIO::callback_t callback = [responder](S32 bytes) mutable
+        {
+            if (responder.notNull())
+            {
+                responder->completed(bytes);
+            }
+        };
+        bool queued = (mOperation == FILE_READ) ? async_io->read(mFileName, mBuffer, mOffset, mBytes, callback)
+                                                : async_io->write(mFileName, mBuffer, mOffset, mBytes, callback);
+        if (queued)
+        {
+            return true;
+        }
+        // the blocking path reports the failure
+        mResponder = responder;
+    }
+
     if (mOperation ==  FILE_READ)
     {
         llassert(mOffset >= 0);
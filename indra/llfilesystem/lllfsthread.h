@@ -35,6 +35,8 @@
 #include "llpointer.h"
 #include "llqueuedthread.h"
 
+class LLAsyncFileIO;
+
 //============================================================================
 // Threaded Local File System
 //============================================================================
@@ -114,9 +116,18 @@ public:
 
     //------------------------------------------------------------------------
 public:
-    LLLFSThread(bool threaded = true);
+    // async_queue_depth: reads and writes in flight through LLAsyncFileIO, 0 for blocking ones
+    LLLFSThread(bool threaded = true, U32 async_queue_depth = 0);
     ~LLLFSThread();
 
+    /*virtual*/ void shutdown();
+    // includes the reads and writes in flight
+    /*virtual*/ size_t getPending();
+
+    // requests complete on the I/O completion thread rather than this one,
+    // a caller can queue several before waiting on any
+    bool hasAsyncIO() const { return mAsyncIO != NULL; }
+
     // Return a Request handle
     handle_t read(const std::string& filename,  /* Flawfinder: ignore */
                   U8* buffer, S32 offset, S32 numbytes,
@@ -126,12 +137,15 @@ public:
                    Responder* responder);
 
     // static initializers
-    static void initClass(bool local_is_threaded = true); // Setup sLocal
+    static void initClass(bool local_is_threaded = true, U32 async_queue_depth = 0); // Setup sLocal
     static S32 updateClass(U32 ms_elapsed);
     static void cleanupClass();     // Delete sLocal
 
 public:
     static LLLFSThread* sLocal;     // Default local file thread
+
+private:
+    LLAsyncFileIO* mAsyncIO;
 };
 
 //============================================================================
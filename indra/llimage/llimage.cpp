@@ -39,6 +39,8 @@
 #include "llimagejpeg.h"
 #include "llimagepng.h"
 #include "llimagedxt.h"
+#include "llimagerawpool.h"
+#include "llimagesimd.h"
 #include "llmemory.h"
 
 #include <boost/preprocessor.hpp>
@@ -240,6 +242,19 @@ inline void bilinear_scale(
 
     if(3 == info.xup_yup)
     { //scale x/y - up
+        if (4 == ch && LLImageSIMD::getPath() != LLImageSIMD::PATH_SCALAR)
+        {
+            const LLImageSIMD::Kernels& kernels = LLImageSIMD::get();
+            for(y = 0; y < dstH; ++y)
+            {
+                sptr = info.ystrides[y];
+                const U8* next_row = 0 < info.yapoints[y] ? sptr + srcStride : sptr;
+                kernels.scaleUpRow4(sptr, next_row, dst + (y * dstStride), dstW,
+                                    &info.xpoints[0], &info.xapoints[0], info.yapoints[y]);
+            }
+            return;
+        }
+
         for(y = 0; y < dstH; ++y)
         {
             dptr = dst + (y * dstStride);
@@ -667,11 +682,23 @@ void LLImageBase::sanityCheck()
 // virtual
 void LLImageBase::deleteData()
 {
-    ll_aligned_free_16(mData);
+    freeBuffer(mData, mDataSize);
     mDataSize = 0;
     mData = NULL;
 }
 
+// virtual
+U8* LLImageBase::allocateBuffer(S32 size)
+{
+    return (U8*)ll_aligned_malloc_16(size);
+}
+
+// virtual
+void LLImageBase::freeBuffer(U8* data, S32 size)
+{
+    ll_aligned_free_16(data);
+}
+
 // virtual
 U8* LLImageBase::allocateData(S32 size)
 {
@@ -706,7 +733,7 @@ U8* LLImageBase::allocateData(S32 size)
     if (!mBadBufferAllocation && (!mData || size != mDataSize))
     {
         deleteData(); // virtual
-        mData = (U8*)ll_aligned_malloc_16(size);
+        mData = allocateBuffer(size); // virtual
         if (!mData)
         {
             LL_WARNS() << "Failed to allocate image data size [" << size << "]" << LL_ENDL;
@@ -732,7 +759,7 @@ U8* LLImageBase::allocateData(S32 size)
 // virtual
 U8* LLImageBase::reallocateData(S32 size)
 {
-    U8 *new_datap = (U8*)ll_aligned_malloc_16(size);
+    U8 *new_datap = allocateBuffer(size); // virtual
     if (!new_datap)
     {
         LL_WARNS() << "Out of memory in LLImageBase::reallocateData" << LL_ENDL;
@@ -742,7 +769,7 @@ U8* LLImageBase::reallocateData(S32 size)
     {
         S32 bytes = llmin(mDataSize, size);
         memcpy(new_datap, mData, bytes);    /* Flawfinder: ignore */
-        ll_aligned_free_16(mData) ;
+        freeBuffer(mData, mDataSize); // virtual
     }
     mData = new_datap;
     mDataSize = size;
@@ -881,6 +908,18 @@ void LLImageRaw::deleteData()
     LLImageBase::deleteData();
 }
 
+// virtual
+U8* LLImageRaw::allocateBuffer(S32 size)
+{
+    return LLImageRawPool::allocate(size);
+}
+
+// virtual
+void LLImageRaw::freeBuffer(U8* data, S32 size)
+{
+    LLImageRawPool::release(data, size);
+}
+
 void LLImageRaw::setDataAndSize(U8 *data, S32 width, S32 height, S8 components)
 {
     LLImageDataLock lock(this);
@@ -1011,19 +1050,8 @@ bool LLImageRaw::checkHasTransparentPixels()
         return false;
     }
 
-    U8* data = getData();
-    U32 pixels = getWidth() * getHeight();
-
     // check alpha channel for all 255
-    for (U32 i = 0; i < pixels; ++i)
-    {
-        if (data[i * 4 + 3] != 255)
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return !LLImageSIMD::get().isOpaque4(getData(), getWidth() * getHeight());
 }
 
 bool LLImageRaw::optimizeAwayAlpha()
@@ -1032,30 +1060,19 @@ bool LLImageRaw::optimizeAwayAlpha()
 
     if (getComponents() == 4)
     {
+        const LLImageSIMD::Kernels& kernels = LLImageSIMD::get();
         U8* data = getData();
-        U32 pixels = getWidth() * getHeight();
+        S32 pixels = getWidth() * getHeight();
 
         // check alpha channel for all 255
-        for (U32 i = 0; i < pixels; ++i)
+        if (!kernels.isOpaque4(data, pixels))
         {
-            if (data[i * 4 + 3] != 255)
-            {
-                return false;
-            }
+            return false;
         }
 
         // alpha channel is all 255, make a new copy of data without alpha channel
-        U8* new_data = (U8*) ll_aligned_malloc_16(getWidth() * getHeight() * 3);
-
-        for (U32 i = 0; i < pixels; ++i)
-        {
-            U32 di = i * 3;
-            U32 si = i * 4;
-            for (U32 j = 0; j < 3; ++j)
-            {
-                new_data[di+j] = data[si+j];
-            }
-        }
+        U8* new_data = LLImageRawPool::allocate(getWidth() * getHeight() * 3);
+        kernels.copy4onto3(data, new_data, pixels);
 
         setDataAndSize(new_data, getWidth(), getHeight(), 3);
 
@@ -1073,7 +1090,7 @@ bool LLImageRaw::makeAlpha()
         U32 pixels = getWidth() * getHeight();
 
         // alpha channel doesn't exist, make a new copy of data with alpha channel
-        U8* new_data = (U8*) ll_aligned_malloc_16(getWidth() * getHeight() * 4);
+        U8* new_data = LLImageRawPool::allocate(getWidth() * getHeight() * 4);
 
         for (U32 i = 0; i < pixels; ++i)
         {
@@ -1258,33 +1275,7 @@ void LLImageRaw::compositeUnscaled4onto3( const LLImageRaw* src )
     llassert( (3 == src->getComponents()) || (4 == src->getComponents()) );
     llassert( (src->getWidth() == dst->getWidth()) && (src->getHeight() == dst->getHeight()) );
 
-    const U8* src_data = src->getData();
-    U8* dst_data = dst->getData();
-    S32 pixels = getWidth() * getHeight();
-    while( pixels-- )
-    {
-        U8 alpha = src_data[3];
-        if( alpha )
-        {
-            if( 255 == alpha )
-            {
-                dst_data[0] = src_data[0];
-                dst_data[1] = src_data[1];
-                dst_data[2] = src_data[2];
-            }
-            else
-            {
-
-                U8 transparency = 255 - alpha;
-                dst_data[0] = fastFractionalMult( dst_data[0], transparency ) + fastFractionalMult( src_data[0], alpha );
-                dst_data[1] = fastFractionalMult( dst_data[1], transparency ) + fastFractionalMult( src_data[1], alpha );
-                dst_data[2] = fastFractionalMult( dst_data[2], transparency ) + fastFractionalMult( src_data[2], alpha );
-            }
-        }
-
-        src_data += 4;
-        dst_data += 3;
-    }
+    LLImageSIMD::get().composite4onto3(src->getData(), dst->getData(), getWidth() * getHeight());
 }
 
 
@@ -1304,18 +1295,7 @@ void LLImageRaw::copyUnscaledAlphaMask( const LLImageRaw* src, const LLColor4U&
     llassert( 4 == dst->getComponents() );
     llassert( (src->getWidth() == dst->getWidth()) && (src->getHeight() == dst->getHeight()) );
 
-    S32 pixels = getWidth() * getHeight();
-    const U8* src_data = src->getData();
-    U8* dst_data = dst->getData();
-    for ( S32 i = 0; i < pixels; i++ )
-    {
-        dst_data[0] = fill.mV[0];
-        dst_data[1] = fill.mV[1];
-        dst_data[2] = fill.mV[2];
-        dst_data[3] = src_data[0];
-        src_data += 1;
-        dst_data += 4;
-    }
+    LLImageSIMD::get().alphaMaskOnto4(src->getData(), dst->getData(), getWidth() * getHeight(), fill.mV);
 }
 
 
@@ -1493,17 +1473,7 @@ void LLImageRaw::copyUnscaled4onto3( const LLImageRaw* src )
     llassert( (3 == dst->getComponents()) && (4 == src->getComponents()) );
     llassert( (src->getWidth() == dst->getWidth()) && (src->getHeight() == dst->getHeight()) );
 
-    S32 pixels = getWidth() * getHeight();
-    const U8* src_data = src->getData();
-    U8* dst_data = dst->getData();
-    for( S32 i=0; i<pixels; i++ )
-    {
-        dst_data[0] = src_data[0];
-        dst_data[1] = src_data[1];
-        dst_data[2] = src_data[2];
-        src_data += 4;
-        dst_data += 3;
-    }
+    LLImageSIMD::get().copy4onto3(src->getData(), dst->getData(), getWidth() * getHeight());
 }
 
 
@@ -1518,18 +1488,7 @@ void LLImageRaw::copyUnscaled3onto4( const LLImageRaw* src )
     llassert( 4 == dst->getComponents() );
     llassert( (src->getWidth() == dst->getWidth()) && (src->getHeight() == dst->getHeight()) );
 
-    S32 pixels = getWidth() * getHeight();
-    const U8* src_data = src->getData();
-    U8* dst_data = dst->getData();
-    for( S32 i=0; i<pixels; i++ )
-    {
-        dst_data[0] = src_data[0];
-        dst_data[1] = src_data[1];
-        dst_data[2] = src_data[2];
-        dst_data[3] = 255;
-        src_data += 3;
-        dst_data += 4;
-    }
+    LLImageSIMD::get().copy3onto4(src->getData(), dst->getData(), getWidth() * getHeight());
 }
 
 
@@ -1613,7 +1572,7 @@ bool LLImageRaw::scale( S32 new_width, S32 new_height, bool scale_image_data )
 
         if (new_data_size > 0)
         {
-            U8 *new_data = (U8*)ll_aligned_malloc_16(new_data_size);
+            U8 *new_data = LLImageRawPool::allocate(new_data_size);
             if(NULL == new_data)
             {
                 return false;
@@ -121,6 +121,10 @@ protected:
     virtual U8* allocateData(S32 size = -1);
     virtual U8* reallocateData(S32 size = -1);
 
+    // Where the data buffers come from and go back to
+    virtual U8* allocateBuffer(S32 size);
+    virtual void freeBuffer(U8* data, S32 size);
+
 public:
     LLImageBase();
 
@@ -210,6 +214,12 @@ public:
     /*virtual*/ U8* allocateData(S32 size = -1);
     /*virtual*/ U8* reallocateData(S32 size);
 
+protected:
+    // Buffers come from LLImageRawPool
+    U8* allocateBuffer(S32 size) override;
+    void freeBuffer(U8* data, S32 size) override;
+
+public:
     // use in conjunction with "no_copy" constructor to release data pointer before deleting
     // so that deletion of this LLImageRaw will not free the memory at the "data" parameter
     // provided to "no_copy" constructor
@@ -0,0 +1,305 @@
+/**
+ * @file llimagebcn.cpp
+ * @brief Block compression (BC1/BC3/BC4/BC5) of raw 8 bit image data.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llimagebcn.h"
+
+#include <cmath>
+
+namespace
+{
+    U16 pack565(const F32 color[3])
+    {
+        S32 r = llclamp(S32(color[0] * 31.f / 255.f + 0.5f), 0, 31);
+        S32 g = llclamp(S32(color[1] * 63.f / 255.f + 0.5f), 0, 63);
+        S32 b = llclamp(S32(color[2] * 31.f / 255.f + 0.5f), 0, 31);
+        return U16((r << 11) | (g << 5) | b);
+    }
+
+    void unpack565(U16 packed, S32 color[3])
+    {
+        S32 r = (packed >> 11) & 0x1f;
+        S32 g = (packed >> 5) & 0x3f;
+        S32 b = packed & 0x1f;
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+
+    void write16(U8* dst, U16 value)
+    {
+        dst[0] = U8(value & 0xff);
+        dst[1] = U8(value >> 8);
+    }
+}
+
+//static
+LLImageBCn::EFormat LLImageBCn::formatForComponents(S32 components)
+{
+    switch (components)
+    {
+    case 1:     return FORMAT_BC4;
+    case 2:     return FORMAT_BC5;
+    case 3:     return FORMAT_BC1;
+    case 4:     return FORMAT_BC3;
+    default:    return FORMAT_NONE;
+    }
+}
+
+//static
+S32 LLImageBCn::blockBytes(EFormat format)
+{
+    switch (format)
+    {
+    case FORMAT_BC1:
+    case FORMAT_BC4:
+        return 8;
+    case FORMAT_BC3:
+    case FORMAT_BC5:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+//static
+S32 LLImageBCn::compressedBytes(EFormat format, S32 width, S32 height)
+{
+    S32 blocks_x = (llmax(width, 1) + 3) / 4;
+    S32 blocks_y = (llmax(height, 1) + 3) / 4;
+    return blocks_x * blocks_y * blockBytes(format);
+}
+
+//static
+bool LLImageBCn::compress(const U8* src, S32 width, S32 height, S32 components, EFormat format, U8* dst)
+{
+    if (!src || !dst || width <= 0 || height <= 0 || components <= 0 || format == FORMAT_NONE)
+    {
+        return false;
+    }
+
+    const S32 channels = llmin(components, 4);
+    U8 block[16][4];
+    for (S32 by = 0; by < height; by += 4)
+    {
+        for (S32 bx = 0; bx < width; bx += 4)
+        {
+            for (S32 i = 0; i < 16; i++)
+            {
+                S32 x = llmin(bx + (i & 3), width - 1);
+                S32 y = llmin(by + (i >> 2), height - 1);
+                const U8* texel = src + ((size_t)y * width + x) * components;
+                block[i][0] = block[i][1] = block[i][2] = 0;
+                block[i][3] = 255;
+                for (S32 c = 0; c < channels; c++)
+                {
+                    block[i][c] = texel[c];
+                }
+            }
+
+            switch (format)
+            {
+            case FORMAT_BC1:
+                compressColorBlock(block, dst);
+                break;
+            case FORMAT_BC3:
+                compressChannelBlock(block, 3, dst);
+                compressColorBlock(block, dst + 8);
+                break;
+            case FORMAT_BC4:
+                compressChannelBlock(block, 0, dst);
+                break;
+            case FORMAT_BC5:
+                compressChannelBlock(block, 0, dst);
+                compressChannelBlock(block, 1, dst + 8);
+                break;
+            default:
+                return false;
+            }
+            dst += blockBytes(format);
+        }
+    }
+    return true;
+}
+
+// Fits the two endpoints along the principal axis of the block colors and
+// always emits the four color mode (color0 > color1), which is also the
+// only mode the color half of a BC3 block has.
+//static
+void LLImageBCn::compressColorBlock(const U8 block[16][4], U8* dst)
+{
+    F32 mean[3] = { 0.f, 0.f, 0.f };
+    S32 lo[3] = { 255, 255, 255 };
+    S32 hi[3] = { 0, 0, 0 };
+    for (S32 i = 0; i < 16; i++)
+    {
+        for (S32 c = 0; c < 3; c++)
+        {
+            mean[c] += block[i][c];
+            lo[c] = llmin(lo[c], (S32)block[i][c]);
+            hi[c] = llmax(hi[c], (S32)block[i][c]);
+        }
+    }
+    for (S32 c = 0; c < 3; c++)
+    {
+        mean[c] /= 16.f;
+    }
+
+    // Covariance, upper triangle: rr rg rb gg gb bb
+    F32 cov[6] = { 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };
+    for (S32 i = 0; i < 16; i++)
+    {
+        F32 r = block[i][0] - mean[0];
+        F32 g = block[i][1] - mean[1];
+        F32 b = block[i][2] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    // A few power iterations from the bounding box diagonal are enough to
+    // settle on the dominant axis.
+    F32 axis[3] = { F32(hi[0] - lo[0]), F32(hi[1] - lo[1]), F32(hi[2] - lo[2]) };
+    for (S32 iter = 0; iter < 4; iter++)
+    {
+        F32 x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        F32 y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        F32 z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        F32 scale = llmax(fabsf(x), llmax(fabsf(y), fabsf(z)));
+        if (scale <= 0.f)
+        {
+            break;
+        }
+        axis[0] = x / scale;
+        axis[1] = y / scale;
+        axis[2] = z / scale;
+    }
+    F32 length = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+
+    F32 end0[3] = { mean[0], mean[1], mean[2] };
+    F32 end1[3] = { mean[0], mean[1], mean[2] };
+    if (length > 0.f)
+    {
+        for (S32 c = 0; c < 3; c++)
+        {
+            axis[c] /= length;
+        }
+        F32 min_t = 0.f;
+        F32 max_t = 0.f;
+        for (S32 i = 0; i < 16; i++)
+        {
+            F32 t = (block[i][0] - mean[0]) * axis[0]
+                  + (block[i][1] - mean[1]) * axis[1]
+                  + (block[i][2] - mean[2]) * axis[2];
+            min_t = llmin(min_t, t);
+            max_t = llmax(max_t, t);
+        }
+        for (S32 c = 0; c < 3; c++)
+        {
+            end0[c] = llclamp(mean[c] + axis[c] * max_t, 0.f, 255.f);
+            end1[c] = llclamp(mean[c] + axis[c] * min_t, 0.f, 255.f);
+        }
+    }
+
+    U16 color0 = pack565(end0);
+    U16 color1 = pack565(end1);
+    if (color0 < color1)
+    {
+        std::swap(color0, color1);
+    }
+
+    write16(dst, color0);
+    write16(dst + 2, color1);
+
+    U32 indices = 0;
+    if (color0 != color1)
+    {
+        S32 palette[4][3];
+        unpack565(color0, palette[0]);
+        unpack565(color1, palette[1]);
+        for (S32 c = 0; c < 3; c++)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        for (S32 i = 0; i < 16; i++)
+        {
+            S32 best = 0;
+            S32 best_error = S32_MAX;
+            for (S32 p = 0; p < 4; p++)
+            {
+                S32 dr = block[i][0] - palette[p][0];
+                S32 dg = block[i][1] - palette[p][1];
+                S32 db = block[i][2] - palette[p][2];
+                S32 error = dr * dr + dg * dg + db * db;
+                if (error < best_error)
+                {
+                    best_error = error;
+                    best = p;
+                }
+            }
+            indices |= U32(best) << (2 * i);
+        }
+    }
+    write16(dst + 4, U16(indices & 0xffff));
+    write16(dst + 6, U16(indices >> 16));
+}
+
+// Uses the eight value mode with the block minimum and maximum as
+// endpoints.
+//static
+void LLImageBCn::compressChannelBlock(const U8 block[16][4], S32 channel, U8* dst)
+{
+    S32 lo = 255;
+    S32 hi = 0;
+    for (S32 i = 0; i < 16; i++)
+    {
+        lo = llmin(lo, (S32)block[i][channel]);
+        hi = llmax(hi, (S32)block[i][channel]);
+    }
+
+    dst[0] = U8(hi);
+    dst[1] = U8(lo);
+
+    U64 indices = 0;
+    S32 range = hi - lo;
+    if (range > 0)
+    {
+        for (S32 i = 0; i < 16; i++)
+        {
+            // Step 0 is 'hi', step 7 is 'lo'; codes 0 and 1 are the
+            // endpoints and codes 2-7 the steps in between.
+            S32 step = ((hi - block[i][channel]) * 7 + range / 2) / range;
+            S32 code = (step == 0) ? 0 : (step == 7) ? 1 : step + 1;
+            indices |= U64(code) << (3 * i);
+        }
+    }
+    for (S32 b = 0; b < 6; b++)
+    {
+        dst[2 + b] = U8((indices >> (8 * b)) & 0xff);
+    }
+}
@@ -0,0 +1,67 @@
+/**
+ * @file llimagebcn.h
+ * @brief Block compression (BC1/BC3/BC4/BC5) of raw 8 bit image data.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLIMAGEBCN_H
+#define LL_LLIMAGEBCN_H
+
+#include "stdtypes.h"
+
+// Encodes decoded texture data into the GPU block compressed formats, so
+// that textures can be uploaded compressed instead of as RGBA8. The
+// encoder favours speed over quality: a principal axis fit for color
+// blocks and a min/max fit for single channel blocks.
+
+class LLImageBCn
+{
+public:
+    enum EFormat
+    {
+        FORMAT_NONE = 0,
+        FORMAT_BC1,     // RGB, 4 bits per texel (DXT1 without alpha)
+        FORMAT_BC3,     // RGBA, 8 bits per texel (DXT5)
+        FORMAT_BC4,     // one channel, 4 bits per texel (RGTC1)
+        FORMAT_BC5,     // two channels, 8 bits per texel (RGTC2)
+    };
+
+    // Format used for data with 'components' 8 bit channels per texel.
+    static EFormat formatForComponents(S32 components);
+
+    static S32 blockBytes(EFormat format);
+    static S32 compressedBytes(EFormat format, S32 width, S32 height);
+
+    // Compresses a width x height image of 'components' interleaved 8 bit
+    // channels into 'dst', which must hold compressedBytes() bytes. Blocks
+    // overlapping the right and bottom edges repeat the edge texels.
+    // Channels beyond what the format stores are ignored; missing ones
+    // read as 0 (255 for alpha).
+    static bool compress(const U8* src, S32 width, S32 height, S32 components, EFormat format, U8* dst);
+
+private:
+    static void compressColorBlock(const U8 block[16][4], U8* dst);
+    static void compressChannelBlock(const U8 block[16][4], S32 channel, U8* dst);
+};
+
+#endif // LL_LLIMAGEBCN_H
@@ -0,0 +1,217 @@
+/**
+ * @file llimagerawpool.cpp
+ * @brief Size classed pool for the decoded image buffers of LLImageRaw.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llimagerawpool.h"
+
+#include "llheap.h"
+
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // Smaller buffers are cheap enough for the allocator, the biggest is a
+    // 2048x2048 RGBA texture.
+    constexpr S32 MIN_SHIFT = 12;
+    constexpr S32 MAX_SHIFT = 24;
+    // One class for 2^n bytes (1, 2 or 4 components) and one for 3 x 2^n
+    constexpr S32 NUM_CLASSES = (MAX_SHIFT - MIN_SHIFT + 1) * 2;
+
+    struct Pool
+    {
+        std::mutex mMutex;
+        std::vector<U8*> mFreeBuffers[NUM_CLASSES];
+        S64 mResidentBytes = 0;
+    };
+
+    // Never destroyed: static LLImageRaw instances may give their buffers
+    // back after the statics of this file are gone.
+    Pool& get_pool()
+    {
+        static Pool* pool = new Pool;
+        return *pool;
+    }
+
+    std::atomic<S64> sMaxBytes(0);
+    std::atomic<U32> sHits(0);
+    std::atomic<U32> sMisses(0);
+
+    bool is_power_of_two(S32 value)
+    {
+        return value > 0 && (value & (value - 1)) == 0;
+    }
+
+    // Returns -1 if 'size' is not poolable
+    S32 get_class(S32 size)
+    {
+        bool rgb = size % 3 == 0;
+        S32 pow2 = rgb ? size / 3 : size;
+        if (!is_power_of_two(pow2))
+        {
+            return -1;
+        }
+        S32 shift = 0;
+        while ((1 << shift) < pow2)
+        {
+            ++shift;
+        }
+        if (shift < MIN_SHIFT || shift > MAX_SHIFT)
+        {
+            return -1;
+        }
+        return (shift - MIN_SHIFT) * 2 + (rgb ? 1 : 0);
+    }
+
+    S32 get_class_size(S32 size_class)
+    {
+        S32 size = 1 << (size_class / 2 + MIN_SHIFT);
+        return (size_class & 1) ? size * 3 : size;
+    }
+
+}
+
+//static
+U8* LLImageRawPool::allocate(S32 size)
+{
+    S32 size_class = get_class(size);
+    if (size_class >= 0 && sMaxBytes.load(std::memory_order_relaxed) > 0)
+    {
+        {
+            Pool& pool = get_pool();
+            std::lock_guard<std::mutex> lock(pool.mMutex);
+            std::vector<U8*>& buffers = pool.mFreeBuffers[size_class];
+            if (!buffers.empty())
+            {
+                U8* data = buffers.back();
+                buffers.pop_back();
+                pool.mResidentBytes -= size;
+                ++sHits;
+                return data;
+            }
+        }
+        ++sMisses;
+    }
+    return (U8*)LLHeap::allocate(LLHeap::HEAP_IMAGE, size);
+}
+
+//static
+void LLImageRawPool::release(U8* data, S32 size)
+{
+    if (!data)
+    {
+        return;
+    }
+
+    S32 size_class = get_class(size);
+    S64 max_bytes = sMaxBytes.load(std::memory_order_relaxed);
+    if (size_class >= 0 && max_bytes > 0)
+    {
+        Pool& pool = get_pool();
+        std::lock_guard<std::mutex> lock(pool.mMutex);
+        if (pool.mResidentBytes + size <= max_bytes)
+        {
+            pool.mFreeBuffers[size_class].push_back(data);
+            pool.mResidentBytes += size;
+            return;
+        }
+    }
+    LLHeap::free(LLHeap::HEAP_IMAGE, data, size);
+}
+
+//static
+void LLImageRawPool::setMaxBytes(S64 max_bytes)
+{
+    max_bytes = llmax(max_bytes, (S64)0);
+    if (sMaxBytes.exchange(max_bytes) > max_bytes)
+    {
+        trim(max_bytes);
+    }
+}
+
+//static
+void LLImageRawPool::trim(S64 max_bytes)
+{
+    std::vector<std::pair<U8*, S32>> to_free;
+    {
+        Pool& pool = get_pool();
+        std::lock_guard<std::mutex> lock(pool.mMutex);
+        // Drop the biggest buffers first, they are the least likely to be
+        // asked for again.
+        for (S32 i = NUM_CLASSES - 1; i >= 0 && pool.mResidentBytes > max_bytes; --i)
+        {
+            S32 size = get_class_size(i);
+            while (!pool.mFreeBuffers[i].empty() && pool.mResidentBytes > max_bytes)
+            {
+                to_free.emplace_back(pool.mFreeBuffers[i].back(), size);
+                pool.mFreeBuffers[i].pop_back();
+                pool.mResidentBytes -= size;
+            }
+        }
+    }
+    // Free outside of the lock, the decode threads may be waiting on it
+    for (const auto& [data, size] : to_free)
+    {
+        LLHeap::free(LLHeap::HEAP_IMAGE, data, size);
+    }
+}
+
+//static
+S64 LLImageRawPool::getResidentBytes()
+{
+    Pool& pool = get_pool();
+    std::lock_guard<std::mutex> lock(pool.mMutex);
+    return pool.mResidentBytes;
+}
+
+//static
+S64 LLImageRawPool::getMaxBytes()
+{
+    return sMaxBytes.load(std::memory_order_relaxed);
+}
+
+//static
+U32 LLImageRawPool::getHits()
+{
+    return sHits.load(std::memory_order_relaxed);
+}
+
+//static
+U32 LLImageRawPool::getMisses()
+{
+    return sMisses.load(std::memory_order_relaxed);
+}
+
+//static
+F32 LLImageRawPool::getHitRate()
+{
+    U32 hits = getHits();
+    U32 total = hits + getMisses();
+    return total ? (F32)hits / (F32)total : 0.f;
+}
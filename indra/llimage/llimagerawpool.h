@@ -0,0 +1,65 @@
+/**
+ * @file llimagerawpool.h
+ * @brief Size classed pool for the decoded image buffers of LLImageRaw.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLIMAGERAWPOOL_H
+#define LL_LLIMAGERAWPOOL_H
+
+#include "stdtypes.h"
+
+// Decoded textures are power of two sized, so the same few buffer sizes get
+// allocated by the decode threads and freed after the GL upload over and
+// over. LLImageRaw takes its buffers from here and gives them back instead,
+// which keeps that churn off the heap. Only sizes of the form
+// 2^n x 1, 2, 3 or 4 components are pooled; everything else, and every
+// buffer once the pool is full, goes straight to ll_aligned_malloc_16().
+//
+// Pooled buffers come from ll_aligned_malloc_16() at their exact size, so
+// code that takes a buffer away from an LLImageRaw may still free it with
+// ll_aligned_free_16().
+//
+// The pool is empty and disabled until setMaxBytes() is called.
+
+class LLImageRawPool
+{
+public:
+    static U8* allocate(S32 size);
+    // 'data' must have been allocated with ll_aligned_malloc_16() and be at
+    // least 'size' bytes, null is ignored.
+    static void release(U8* data, S32 size);
+
+    static void setMaxBytes(S64 max_bytes);
+    // Frees pooled buffers until no more than 'max_bytes' are kept
+    static void trim(S64 max_bytes);
+
+    static S64 getResidentBytes();
+    static S64 getMaxBytes();
+    static U32 getHits();
+    static U32 getMisses();
+    // Hits over poolable allocations, 0 to 1
+    static F32 getHitRate();
+};
+
+#endif // LL_LLIMAGERAWPOOL_H
@@ -0,0 +1,568 @@
+/**
+ * @file llimagesimd.cpp
+ * @brief Vectorized pixel loops for LLImageRaw, with runtime dispatch.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llimagesimd.h"
+
+#include "llprocessor.h"
+
+#include <atomic>
+#include <cstring>
+
+#if LL_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#if LL_MSVC
+#include <intrin.h>
+// MSVC compiles AVX2 intrinsics in any function
+#define LL_TARGET_AVX2
+#else
+#define LL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace
+{
+    //------------------------------------------------------------------------
+    // Scalar
+    //------------------------------------------------------------------------
+
+    inline U8 fast_fractional_mult(U8 a, U8 b)
+    {
+        U32 i = a * b + 128;
+        return U8((i + (i >> 8)) >> 8);
+    }
+
+    void copy4onto3_scalar(const U8* src, U8* dst, S32 pixels)
+    {
+        for (S32 i = 0; i < pixels; ++i)
+        {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            src += 4;
+            dst += 3;
+        }
+    }
+
+    void copy3onto4_scalar(const U8* src, U8* dst, S32 pixels)
+    {
+        for (S32 i = 0; i < pixels; ++i)
+        {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = 255;
+            src += 3;
+            dst += 4;
+        }
+    }
+
+    void composite4onto3_scalar(const U8* src, U8* dst, S32 pixels)
+    {
+        for (S32 i = 0; i < pixels; ++i)
+        {
+            U8 alpha = src[3];
+            if (alpha)
+            {
+                if (255 == alpha)
+                {
+                    dst[0] = src[0];
+                    dst[1] = src[1];
+                    dst[2] = src[2];
+                }
+                else
+                {
+                    U8 transparency = 255 - alpha;
+                    dst[0] = fast_fractional_mult(dst[0], transparency) + fast_fractional_mult(src[0], alpha);
+                    dst[1] = fast_fractional_mult(dst[1], transparency) + fast_fractional_mult(src[1], alpha);
+                    dst[2] = fast_fractional_mult(dst[2], transparency) + fast_fractional_mult(src[2], alpha);
+                }
+            }
+            src += 4;
+            dst += 3;
+        }
+    }
+
+    void alphaMaskOnto4_scalar(const U8* src, U8* dst, S32 pixels, const U8* fill)
+    {
+        for (S32 i = 0; i < pixels; ++i)
+        {
+            dst[0] = fill[0];
+            dst[1] = fill[1];
+            dst[2] = fill[2];
+            dst[3] = src[0];
+            src += 1;
+            dst += 4;
+        }
+    }
+
+    bool isOpaque4_scalar(const U8* src, S32 pixels)
+    {
+        for (S32 i = 0; i < pixels; ++i)
+        {
+            if (src[i * 4 + 3] != 255)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Same arithmetic as the up-scale branch of bilinear_scale<4>(); note
+    // that rows with a 0 vertical weight take the nearest source pixel.
+    void scaleUpRow4_scalar(const U8* row, const U8* next_row, U8* dst, S32 width,
+                            const S32* xpoints, const S32* xapoints, S32 yap)
+    {
+        for (S32 x = 0; x < width; ++x)
+        {
+            const U8* pix = row + xpoints[x] * 4;
+            if (yap <= 0)
+            {
+                memcpy(dst, pix, 4);
+            }
+            else
+            {
+                const S32 xap = xapoints[x];
+                const S32 right = xap > 0 ? 4 : 0;
+                const U8* below = next_row + xpoints[x] * 4;
+                for (S32 c = 0; c < 4; ++c)
+                {
+                    S32 comp = pix[c] * (256 - xap) + pix[c + right] * xap;
+                    S32 cx = below[c] * (256 - xap) + below[c + right] * xap;
+                    dst[c] = U8(((cx * yap + comp * (256 - yap)) >> 16) & 0xff);
+                }
+            }
+            dst += 4;
+        }
+    }
+
+#if LL_X86
+    //------------------------------------------------------------------------
+    // SSE2, always available on the x86 builds
+    //------------------------------------------------------------------------
+
+    inline S32 load_s32(const U8* p)
+    {
+        S32 v;
+        memcpy(&v, p, 4);
+        return v;
+    }
+
+    inline void store_s32(U8* p, S32 v)
+    {
+        memcpy(p, &v, 4);
+    }
+
+    // Loads 4 RGB pixels (12 bytes, no over-read)
+    inline __m128i load_rgb4(const U8* src)
+    {
+        return _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)src), _mm_cvtsi32_si128(load_s32(src + 8)));
+    }
+
+    // Stores the low 12 bytes
+    inline void store_rgb4(U8* dst, __m128i v)
+    {
+        _mm_storel_epi64((__m128i*)dst, v);
+        store_s32(dst + 8, _mm_cvtsi128_si32(_mm_srli_si128(v, 8)));
+    }
+
+    // 12 bytes of RGB to 16 bytes of RGB0
+    inline __m128i expand_rgb4(__m128i v)
+    {
+        const __m128i mask = _mm_set1_epi32(0x00ffffff);
+        __m128i p0 = v;
+        __m128i p1 = _mm_slli_si128(v, 1);
+        __m128i p2 = _mm_slli_si128(v, 2);
+        __m128i p3 = _mm_slli_si128(v, 3);
+        // pixel n sits in lane n of pn
+        __m128i r = _mm_and_si128(p0, _mm_setr_epi32(-1, 0, 0, 0));
+        r = _mm_or_si128(r, _mm_and_si128(p1, _mm_setr_epi32(0, -1, 0, 0)));
+        r = _mm_or_si128(r, _mm_and_si128(p2, _mm_setr_epi32(0, 0, -1, 0)));
+        r = _mm_or_si128(r, _mm_and_si128(p3, _mm_setr_epi32(0, 0, 0, -1)));
+        return _mm_and_si128(r, mask);
+    }
+
+    // 16 bytes of RGBA to 12 bytes of RGB
+    inline __m128i pack_rgb4(__m128i v)
+    {
+        v = _mm_and_si128(v, _mm_set1_epi32(0x00ffffff));
+        __m128i r = _mm_and_si128(v, _mm_setr_epi32(-1, 0, 0, 0));
+        r = _mm_or_si128(r, _mm_srli_si128(_mm_and_si128(v, _mm_setr_epi32(0, -1, 0, 0)), 1));
+        r = _mm_or_si128(r, _mm_srli_si128(_mm_and_si128(v, _mm_setr_epi32(0, 0, -1, 0)), 2));
+        r = _mm_or_si128(r, _mm_srli_si128(_mm_and_si128(v, _mm_setr_epi32(0, 0, 0, -1)), 3));
+        return r;
+    }
+
+    // fast_fractional_mult() on 16 bit lanes
+    inline __m128i fractional_mult_epi16(__m128i a, __m128i b)
+    {
+        __m128i i = _mm_add_epi16(_mm_mullo_epi16(a, b), _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(i, _mm_srli_epi16(i, 8)), 8);
+    }
+
+    // dst * (255 - alpha) + src * alpha, on 16 bit lanes; equal to the
+    // scalar branches for alpha 0 and 255.
+    inline __m128i blend_epi16(__m128i src, __m128i dst, __m128i alpha)
+    {
+        __m128i transparency = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+        return _mm_add_epi16(fractional_mult_epi16(dst, transparency), fractional_mult_epi16(src, alpha));
+    }
+
+    void copy4onto3_sse2(const U8* src, U8* dst, S32 pixels)
+    {
+        for (; pixels >= 4; pixels -= 4, src += 16, dst += 12)
+        {
+            store_rgb4(dst, pack_rgb4(_mm_loadu_si128((const __m128i*)src)));
+        }
+        copy4onto3_scalar(src, dst, pixels);
+    }
+
+    void copy3onto4_sse2(const U8* src, U8* dst, S32 pixels)
+    {
+        const __m128i alpha = _mm_set1_epi32(0xff000000);
+        for (; pixels >= 4; pixels -= 4, src += 12, dst += 16)
+        {
+            _mm_storeu_si128((__m128i*)dst, _mm_or_si128(expand_rgb4(load_rgb4(src)), alpha));
+        }
+        copy3onto4_scalar(src, dst, pixels);
+    }
+
+    void composite4onto3_sse2(const U8* src, U8* dst, S32 pixels)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        for (; pixels >= 4; pixels -= 4, src += 16, dst += 12)
+        {
+            __m128i s = _mm_loadu_si128((const __m128i*)src);
+            __m128i d = expand_rgb4(load_rgb4(dst));
+
+            __m128i a = _mm_srli_epi32(s, 24);
+            a = _mm_or_si128(a, _mm_or_si128(_mm_slli_epi32(a, 8), _mm_slli_epi32(a, 16)));
+
+            __m128i lo = blend_epi16(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(a, zero));
+            __m128i hi = blend_epi16(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(a, zero));
+            store_rgb4(dst, pack_rgb4(_mm_packus_epi16(lo, hi)));
+        }
+        composite4onto3_scalar(src, dst, pixels);
+    }
+
+    void alphaMaskOnto4_sse2(const U8* src, U8* dst, S32 pixels, const U8* fill)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i rgb = _mm_set1_epi32(fill[0] | (fill[1] << 8) | (fill[2] << 16));
+        for (; pixels >= 16; pixels -= 16, src += 16, dst += 64)
+        {
+            __m128i a = _mm_loadu_si128((const __m128i*)src);
+            __m128i lo = _mm_unpacklo_epi8(zero, a); // alpha << 8 on 16 bits
+            __m128i hi = _mm_unpackhi_epi8(zero, a);
+            _mm_storeu_si128((__m128i*)(dst +  0), _mm_or_si128(rgb, _mm_unpacklo_epi16(zero, lo)));
+            _mm_storeu_si128((__m128i*)(dst + 16), _mm_or_si128(rgb, _mm_unpackhi_epi16(zero, lo)));
+            _mm_storeu_si128((__m128i*)(dst + 32), _mm_or_si128(rgb, _mm_unpacklo_epi16(zero, hi)));
+            _mm_storeu_si128((__m128i*)(dst + 48), _mm_or_si128(rgb, _mm_unpackhi_epi16(zero, hi)));
+        }
+        alphaMaskOnto4_scalar(src, dst, pixels, fill);
+    }
+
+    bool isOpaque4_sse2(const U8* src, S32 pixels)
+    {
+        const __m128i alpha = _mm_set1_epi32(0xff000000);
+        for (; pixels >= 16; pixels -= 16, src += 64)
+        {
+            __m128i v = _mm_and_si128(_mm_loadu_si128((const __m128i*)(src +  0)),
+                                      _mm_loadu_si128((const __m128i*)(src + 16)));
+            v = _mm_and_si128(v, _mm_loadu_si128((const __m128i*)(src + 32)));
+            v = _mm_and_si128(v, _mm_loadu_si128((const __m128i*)(src + 48)));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(v, alpha), alpha)) != 0xffff)
+            {
+                return false;
+            }
+        }
+        return isOpaque4_scalar(src, pixels);
+    }
+
+    void scaleUpRow4_sse2(const U8* row, const U8* next_row, U8* dst, S32 width,
+                          const S32* xpoints, const S32* xapoints, S32 yap)
+    {
+        if (yap <= 0)
+        {
+            scaleUpRow4_scalar(row, next_row, dst, width, xpoints, xapoints, yap);
+            return;
+        }
+
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i low_byte = _mm_set1_epi32(0xff);
+        // (comp, cx) pairs get weights (256 - yap, yap)
+        const __m128i wy = _mm_set1_epi32((yap << 16) | (256 - yap));
+        for (S32 x = 0; x < width; ++x, dst += 4)
+        {
+            const S32 xap = xapoints[x];
+            const S32 right = xap > 0 ? 4 : 0;
+            const U8* pix = row + xpoints[x] * 4;
+            const U8* below = next_row + xpoints[x] * 4;
+            const __m128i wx = _mm_set1_epi32((xap << 16) | (256 - xap));
+
+            // Channel pairs (left, right) on 16 bits, times (256 - xap, xap)
+            __m128i top = _mm_unpacklo_epi8(_mm_unpacklo_epi8(_mm_cvtsi32_si128(load_s32(pix)),
+                                                              _mm_cvtsi32_si128(load_s32(pix + right))), zero);
+            __m128i bottom = _mm_unpacklo_epi8(_mm_unpacklo_epi8(_mm_cvtsi32_si128(load_s32(below)),
+                                                                 _mm_cvtsi32_si128(load_s32(below + right))), zero);
+            __m128i comp = _mm_madd_epi16(top, wx);
+            __m128i cx = _mm_madd_epi16(bottom, wx);
+
+            // comp and cx go up to 65280, too much for signed 16 bit pairs:
+            // blend their high and low bytes separately.
+            __m128i high = _mm_packs_epi32(_mm_srli_epi32(comp, 8), _mm_srli_epi32(cx, 8));
+            __m128i low = _mm_packs_epi32(_mm_and_si128(comp, low_byte), _mm_and_si128(cx, low_byte));
+            high = _mm_madd_epi16(_mm_unpacklo_epi16(high, _mm_srli_si128(high, 8)), wy);
+            low = _mm_madd_epi16(_mm_unpacklo_epi16(low, _mm_srli_si128(low, 8)), wy);
+            __m128i result = _mm_srli_epi32(_mm_add_epi32(_mm_slli_epi32(high, 8), low), 16);
+
+            result = _mm_packs_epi32(result, result);
+            store_s32(dst, _mm_cvtsi128_si32(_mm_packus_epi16(result, result)));
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // AVX2, eight pixels at a time. The 3 byte layouts go through a byte
+    // shuffle per 128 bit lane, so each lane holds four pixels.
+    //------------------------------------------------------------------------
+
+    LL_TARGET_AVX2 void copy4onto3_avx2(const U8* src, U8* dst, S32 pixels)
+    {
+        const __m256i pack = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                              0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        // The second 16 byte store spills 4 bytes into the next pixels, so
+        // keep two pixels of slack.
+        for (; pixels >= 10; pixels -= 8, src += 32, dst += 24)
+        {
+            __m256i v = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)src), pack);
+            _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(v));
+            _mm_storeu_si128((__m128i*)(dst + 12), _mm256_extracti128_si256(v, 1));
+        }
+        copy4onto3_sse2(src, dst, pixels);
+    }
+
+    LL_TARGET_AVX2 void copy3onto4_avx2(const U8* src, U8* dst, S32 pixels)
+    {
+        const __m256i expand = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                                0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m256i alpha = _mm256_set1_epi32(0xff000000);
+        // The 16 byte load at src + 12 reads up to src + 28
+        for (; pixels >= 10; pixels -= 8, src += 24, dst += 32)
+        {
+            __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)src)),
+                                                _mm_loadu_si128((const __m128i*)(src + 12)), 1);
+            _mm256_storeu_si256((__m256i*)dst, _mm256_or_si256(_mm256_shuffle_epi8(v, expand), alpha));
+        }
+        copy3onto4_sse2(src, dst, pixels);
+    }
+
+    LL_TARGET_AVX2 void composite4onto3_avx2(const U8* src, U8* dst, S32 pixels)
+    {
+        const __m256i expand = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                                0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m256i pack = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                              0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        const __m256i spread_alpha = _mm256_setr_epi8(3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15,
+                                                      3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i rounding = _mm256_set1_epi16(128);
+        const __m256i opaque = _mm256_set1_epi16(255);
+        // Reads go up to dst + 28, writes stop at exactly dst + 24 since the
+        // next pixels are still to be read.
+        for (; pixels >= 10; pixels -= 8, src += 32, dst += 24)
+        {
+            __m256i s = _mm256_loadu_si256((const __m256i*)src);
+            __m256i d = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)dst)),
+                                                _mm_loadu_si128((const __m128i*)(dst + 12)), 1);
+            d = _mm256_shuffle_epi8(d, expand);
+            __m256i a = _mm256_shuffle_epi8(s, spread_alpha);
+
+            __m256i result[2];
+            for (S32 half = 0; half < 2; ++half)
+            {
+                __m256i s16 = half ? _mm256_unpackhi_epi8(s, zero) : _mm256_unpacklo_epi8(s, zero);
+                __m256i d16 = half ? _mm256_unpackhi_epi8(d, zero) : _mm256_unpacklo_epi8(d, zero);
+                __m256i a16 = half ? _mm256_unpackhi_epi8(a, zero) : _mm256_unpacklo_epi8(a, zero);
+                __m256i t16 = _mm256_sub_epi16(opaque, a16);
+
+                __m256i i = _mm256_add_epi16(_mm256_mullo_epi16(d16, t16), rounding);
+                __m256i dt = _mm256_srli_epi16(_mm256_add_epi16(i, _mm256_srli_epi16(i, 8)), 8);
+                i = _mm256_add_epi16(_mm256_mullo_epi16(s16, a16), rounding);
+                __m256i sa = _mm256_srli_epi16(_mm256_add_epi16(i, _mm256_srli_epi16(i, 8)), 8);
+                result[half] = _mm256_add_epi16(dt, sa);
+            }
+
+            __m256i v = _mm256_shuffle_epi8(_mm256_packus_epi16(result[0], result[1]), pack);
+            _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(v));
+            store_rgb4(dst + 12, _mm256_extracti128_si256(v, 1));
+        }
+        composite4onto3_sse2(src, dst, pixels);
+    }
+
+    LL_TARGET_AVX2 bool isOpaque4_avx2(const U8* src, S32 pixels)
+    {
+        const __m256i alpha = _mm256_set1_epi32(0xff000000);
+        for (; pixels >= 16; pixels -= 16, src += 64)
+        {
+            __m256i v = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)src),
+                                         _mm256_loadu_si256((const __m256i*)(src + 32)));
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(v, alpha), alpha)) != -1)
+            {
+                return false;
+            }
+        }
+        return isOpaque4_sse2(src, pixels);
+    }
+
+    bool cpu_has_avx2()
+    {
+#if LL_MSVC
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+        {
+            return false;
+        }
+        __cpuid(info, 1);
+        const bool os_saves_ymm = (info[2] & (1 << 27)) && ((_xgetbv(0) & 6) == 6);
+        __cpuidex(info, 7, 0);
+        return os_saves_ymm && (info[1] & (1 << 5));
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif // LL_X86
+
+    const LLImageSIMD::Kernels sKernels[LLImageSIMD::PATH_COUNT] =
+    {
+        {
+            copy4onto3_scalar, copy3onto4_scalar, composite4onto3_scalar,
+            alphaMaskOnto4_scalar, isOpaque4_scalar, scaleUpRow4_scalar
+        },
+#if LL_X86
+        {
+            copy4onto3_sse2, copy3onto4_sse2, composite4onto3_sse2,
+            alphaMaskOnto4_sse2, isOpaque4_sse2, scaleUpRow4_sse2
+        },
+        {
+            // Expanding one channel and the per pixel gather of the scale
+            // gain nothing from the wider registers.
+            copy4onto3_avx2, copy3onto4_avx2, composite4onto3_avx2,
+            alphaMaskOnto4_sse2, isOpaque4_avx2, scaleUpRow4_sse2
+        },
+#else
+        {
+            copy4onto3_scalar, copy3onto4_scalar, composite4onto3_scalar,
+            alphaMaskOnto4_scalar, isOpaque4_scalar, scaleUpRow4_scalar
+        },
+        {
+            copy4onto3_scalar, copy3onto4_scalar, composite4onto3_scalar,
+            alphaMaskOnto4_scalar, isOpaque4_scalar, scaleUpRow4_scalar
+        },
+#endif
+    };
+
+    std::atomic<S32> sPath(-1);
+}
+
+//static
+bool LLImageSIMD::isSupported(EPath path)
+{
+    switch (path)
+    {
+    case PATH_SCALAR:
+        return true;
+#if LL_X86
+    case PATH_SSE2:
+        return true;
+    case PATH_AVX2:
+    {
+        static const bool has_avx2 = cpu_has_avx2();
+        return has_avx2;
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+//static
+LLImageSIMD::EPath LLImageSIMD::getBestPath()
+{
+    for (S32 path = PATH_COUNT - 1; path > PATH_SCALAR; --path)
+    {
+        if (isSupported((EPath)path))
+        {
+            return (EPath)path;
+        }
+    }
+    return PATH_SCALAR;
+}
+
+//static
+LLImageSIMD::EPath LLImageSIMD::getPath()
+{
+    S32 path = sPath.load(std::memory_order_relaxed);
+    if (path < 0)
+    {
+        path = getBestPath();
+        sPath.store(path, std::memory_order_relaxed);
+        LL_INFOS("Image") << "Using " << getPathName((EPath)path) << " image kernels" << LL_ENDL;
+    }
+    return (EPath)path;
+}
+
+//static
+void LLImageSIMD::setPath(EPath path)
+{
+    while (path > PATH_SCALAR && !isSupported(path))
+    {
+        path = (EPath)(path - 1);
+    }
+    sPath.store(path, std::memory_order_relaxed);
+}
+
+//static
+const LLImageSIMD::Kernels& LLImageSIMD::get()
+{
+    return sKernels[getPath()];
+}
+
+//static
+const LLImageSIMD::Kernels& LLImageSIMD::getKernels(EPath path)
+{
+    return sKernels[llclamp((S32)path, (S32)PATH_SCALAR, (S32)PATH_COUNT - 1)];
+}
+
+//static
+const char* LLImageSIMD::getPathName(EPath path)
+{
+    static const char* names[PATH_COUNT] = { "scalar", "SSE2", "AVX2" };
+    return names[llclamp((S32)path, (S32)PATH_SCALAR, (S32)PATH_COUNT - 1)];
+}
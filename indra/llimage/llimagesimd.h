@@ -0,0 +1,82 @@
+/**
+ * @file llimagesimd.h
+ * @brief Vectorized pixel loops for LLImageRaw, with runtime dispatch.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLIMAGESIMD_H
+#define LL_LLIMAGESIMD_H
+
+#include "stdtypes.h"
+
+// The per-pixel loops of LLImageRaw that run on every UI image, map tile
+// and local texture, in a scalar, SSE2 and AVX2 flavor. The fastest set
+// the CPU supports is picked the first time it is asked for; every set
+// produces exactly the same bytes as the scalar one.
+
+class LLImageSIMD
+{
+public:
+    enum EPath
+    {
+        PATH_SCALAR = 0,
+        PATH_SSE2,
+        PATH_AVX2,
+        PATH_COUNT
+    };
+
+    struct Kernels
+    {
+        // RGBA -> RGB, dropping alpha
+        void (*copy4onto3)(const U8* src, U8* dst, S32 pixels);
+        // RGB -> RGBA, alpha 255
+        void (*copy3onto4)(const U8* src, U8* dst, S32 pixels);
+        // Blends RGBA src over RGB dst, see LLImageRaw::fastFractionalMult()
+        void (*composite4onto3)(const U8* src, U8* dst, S32 pixels);
+        // One channel src becomes the alpha of RGBA dst, RGB set to 'fill'
+        void (*alphaMaskOnto4)(const U8* src, U8* dst, S32 pixels, const U8* fill);
+        // True if every alpha of RGBA src is 255
+        bool (*isOpaque4)(const U8* src, S32 pixels);
+        // One output row of the RGBA bilinear up-scale in bilinear_scale():
+        // 'row' and 'next_row' are the two source rows to blend with weight
+        // 'yap' (next_row may be row when yap is 0), xpoints/xapoints the
+        // per-column source pixel and weight.
+        void (*scaleUpRow4)(const U8* row, const U8* next_row, U8* dst, S32 width,
+                            const S32* xpoints, const S32* xapoints, S32 yap);
+    };
+
+    // Kernels for the current path
+    static const Kernels& get();
+
+    // Best path the CPU supports
+    static EPath getBestPath();
+    static EPath getPath();
+    // Forces a path, e.g. to compare them; clamped to what the CPU supports
+    static void setPath(EPath path);
+
+    static bool isSupported(EPath path);
+    static const Kernels& getKernels(EPath path);
+    static const char* getPathName(EPath path);
+};
+
+#endif // LL_LLIMAGESIMD_H
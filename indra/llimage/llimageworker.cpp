@@ -29,12 +29,14 @@
 #include "llimageworker.h"
 #include "llimagedxt.h"
 #include "threadpool.h"
+#include "workqueue.h"
 
 /*--------------------------------------------------------------------------*/
 class ImageRequest
 {
 public:
     ImageRequest(const LLPointer<LLImageFormatted>& image,
+                 const std::string& filename,
                  S32 discard,
                  bool needs_aux,
                  const LLPointer<LLImageDecodeThread::Responder>& responder,
@@ -49,6 +51,7 @@ private:
     // than references: we need to increment the refcount when storing these.
     // input
     LLPointer<LLImageFormatted> mFormattedImage;
+    std::string mFilename; // to load first, if not empty
     S32 mDiscardLevel;
     U32 mRequestId;
     bool mNeedsAux;
@@ -60,6 +63,39 @@ private:
     LLPointer<LLImageDecodeThread::Responder> mResponder;
     std::string mErrorString;};
 
+// Hands the result of a decode to a decode_callback_t on the main loop
+class CallbackResponder : public LLImageDecodeThread::Responder
+{
+public:
+    CallbackResponder(const LLImageDecodeThread::decode_callback_t& callback)
+        : mCallback(callback)
+    {
+        LL::WorkQueue::ptr_t main_queue = LL::WorkQueue::getInstance("mainloop");
+        mMainQueue = main_queue;
+        mHasMainQueue = bool(main_queue);
+    }
+
+    void completed(bool success, const std::string& error_message, LLImageRaw* raw, LLImageRaw* aux, U32 request_id) override
+    {
+        LLPointer<LLImageRaw> result = success ? raw : nullptr;
+        if (!mHasMainQueue)
+        {
+            mCallback(result, error_message);
+            return;
+        }
+        // If the main loop is gone we are shutting down, drop the result
+        LL::WorkQueue::postMaybe(mMainQueue,
+            [callback = mCallback, result, error_message]()
+            {
+                callback(result, error_message);
+            });
+    }
+
+private:
+    LLImageDecodeThread::decode_callback_t mCallback;
+    LL::WorkQueue::weak_t mMainQueue;
+    bool mHasMainQueue;
+};
 
 //----------------------------------------------------------------------------
 
@@ -67,7 +103,7 @@ private:
 LLImageDecodeThread::LLImageDecodeThread(bool /*threaded*/)
     : mDecodeCount(0)
 {
-    mThreadPool.reset(new LL::ThreadPool("ImageDecode", 8));
+    mThreadPool.reset(new LL::WorkStealingThreadPool("ImageDecode", 8));
     mThreadPool->start();
 }
 
@@ -93,6 +129,43 @@ LLImageDecodeThread::handle_t LLImageDecodeThread::decodeImage(
     S32 discard,
     bool needs_aux,
     const LLPointer<LLImageDecodeThread::Responder>& responder)
+{
+    return post(image, std::string(), discard, needs_aux, responder);
+}
+
+LLImageDecodeThread::handle_t LLImageDecodeThread::decodeImage(
+    const LLPointer<LLImageFormatted>& image,
+    const decode_callback_t& callback)
+{
+    return post(image, std::string(), -1, false, new CallbackResponder(callback));
+}
+
+LLImageDecodeThread::handle_t LLImageDecodeThread::decodeFile(
+    const std::string& filename,
+    const decode_callback_t& callback)
+{
+    std::string exten;
+    size_t dot = filename.rfind('.');
+    if (dot != std::string::npos)
+    {
+        exten = filename.substr(dot + 1);
+        LLStringUtil::toLower(exten);
+    }
+    LLPointer<LLImageFormatted> image = LLImageFormatted::createFromExtension(exten);
+    if (image.isNull())
+    {
+        LL_WARNS() << "Unknown image type for " << filename << LL_ENDL;
+        return 0;
+    }
+    return post(image, filename, -1, false, new CallbackResponder(callback));
+}
+
+LLImageDecodeThread::handle_t LLImageDecodeThread::post(
+    const LLPointer<LLImageFormatted>& image,
+    const std::string& filename,
+    S32 discard,
+    bool needs_aux,
+    const LLPointer<LLImageDecodeThread::Responder>& responder)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
 
@@ -102,7 +175,7 @@ LLImageDecodeThread::handle_t LLImageDecodeThread::decodeImage(
 
     // Instantiate the ImageRequest right in the lambda, why not?
     bool posted = mThreadPool->getQueue().post(
-        [req = ImageRequest(image, discard, needs_aux, responder, decode_id)]
+        [req = ImageRequest(image, filename, discard, needs_aux, responder, decode_id)]
         () mutable
         {
             auto done = req.processRequest();
@@ -129,11 +202,13 @@ LLImageDecodeThread::Responder::~Responder()
 //----------------------------------------------------------------------------
 
 ImageRequest::ImageRequest(const LLPointer<LLImageFormatted>& image,
+                           const std::string& filename,
                            S32 discard,
                            bool needs_aux,
                            const LLPointer<LLImageDecodeThread::Responder>& responder,
                            U32 request_id)
     : mFormattedImage(image),
+      mFilename(filename),
       mDiscardLevel(discard),
       mNeedsAux(needs_aux),
       mDecodedRaw(false),
@@ -164,6 +239,17 @@ bool ImageRequest::processRequest()
     const F32 decode_time_slice = 0.f; //disable time slicing
     bool done = true;
 
+    if (!mFilename.empty())
+    {
+        bool loaded = mFormattedImage->load(mFilename);
+        mFilename.clear();
+        if (!loaded)
+        {
+            mErrorString = LLImage::getLastThreadError();
+            return true; // done (failed)
+        }
+    }
+
     LLImageDataLock lockFormatted(mFormattedImage);
     LLImageDataLock lockDecodedRaw(mDecodedImageRaw);
     LLImageDataLock lockDecodedAux(mDecodedImageAux);
@@ -31,6 +31,8 @@
 #include "llpointer.h"
 #include "threadpool_fwd.h"
 
+#include <functional>
+
 class LLImageDecodeThread
 {
 public:
@@ -51,16 +53,29 @@ public:
     handle_t decodeImage(const LLPointer<LLImageFormatted>& image,
                          S32 discard, bool needs_aux,
                          const LLPointer<Responder>& responder);
+
+    // Simpler API for the formats the viewer loads locally (JPEG, PNG, TGA,
+    // BMP). The callback runs on the "mainloop" work queue, or on the decode
+    // thread when there is none (tests, tools). 'raw' is null on failure.
+    typedef std::function<void(const LLPointer<LLImageRaw>& raw, const std::string& error_message)> decode_callback_t;
+    handle_t decodeImage(const LLPointer<LLImageFormatted>& image, const decode_callback_t& callback);
+    // Also reads the file on the decode thread. Returns 0, without calling
+    // back, if the extension is not a known image type.
+    handle_t decodeFile(const std::string& filename, const decode_callback_t& callback);
     size_t getPending();
     size_t update(F32 max_time_ms);
     S32 getTotalDecodeCount() { return mDecodeCount; }
     void shutdown();
 
 private:
+    handle_t post(const LLPointer<LLImageFormatted>& image, const std::string& filename,
+                  S32 discard, bool needs_aux, const LLPointer<Responder>& responder);
+
     // As of SL-17483, LLImageDecodeThread is no longer itself an
     // LLQueuedThread - instead this is the API by which we submit work to the
-    // "ImageDecode" ThreadPool.
-    std::unique_ptr<LL::ThreadPool> mThreadPool;
+    // "ImageDecode" ThreadPool. Decodes are many and small, so the pool's
+    // threads each keep their own queue and steal from each other.
+    std::unique_ptr<LL::WorkStealingThreadPool> mThreadPool;
     LLAtomicU32 mDecodeCount;
 };
 
@@ -0,0 +1,111 @@
+/**
+ * @file llimagebcn_test.cpp
+ * @brief Test for the block compression encoder.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+// Class to test
+#include "../llimagebcn.h"
+// Tut header
+#include "../test/lltut.h"
+
+#include <vector>
+
+namespace tut
+{
+    struct llimagebcn_data
+    {
+        // Fills a width x height image of 'components' channels with one value per channel
+        std::vector<U8> solid(S32 width, S32 height, S32 components, const U8* value)
+        {
+            std::vector<U8> image(width * height * components);
+            for (size_t i = 0; i < image.size(); i++)
+            {
+                image[i] = value[i % components];
+            }
+            return image;
+        }
+    };
+    typedef test_group<llimagebcn_data> llimagebcn_group;
+    typedef llimagebcn_group::object object;
+    llimagebcn_group llimagebcngrp("LLImageBCn");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("compressed sizes round partial blocks up");
+        ensure_equals("BC1 4x4", LLImageBCn::compressedBytes(LLImageBCn::FORMAT_BC1, 4, 4), 8);
+        ensure_equals("BC3 8x4", LLImageBCn::compressedBytes(LLImageBCn::FORMAT_BC3, 8, 4), 32);
+        ensure_equals("BC4 1x1", LLImageBCn::compressedBytes(LLImageBCn::FORMAT_BC4, 1, 1), 8);
+        ensure_equals("BC5 6x6", LLImageBCn::compressedBytes(LLImageBCn::FORMAT_BC5, 6, 6), 64);
+        ensure_equals("RGBA", LLImageBCn::formatForComponents(4), LLImageBCn::FORMAT_BC3);
+        ensure_equals("5 channels", LLImageBCn::formatForComponents(5), LLImageBCn::FORMAT_NONE);
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("solid color BC1 block");
+        const U8 red[] = { 255, 0, 0 };
+        std::vector<U8> image = solid(4, 4, 3, red);
+        U8 block[8];
+        ensure("compress", LLImageBCn::compress(image.data(), 4, 4, 3, LLImageBCn::FORMAT_BC1, block));
+        ensure_equals("color0 is pure red", (U32)(block[0] | (block[1] << 8)), 0xf800U);
+        ensure_equals("color1 matches", (U32)(block[2] | (block[3] << 8)), 0xf800U);
+        for (S32 i = 4; i < 8; i++)
+        {
+            ensure_equals("all texels use color0", (U32)block[i], 0U);
+        }
+    }
+
+    template<> template<>
+    void object::test<3>()
+    {
+        set_test_name("BC4 endpoints are the block extremes");
+        std::vector<U8> image(16);
+        for (S32 i = 0; i < 16; i++)
+        {
+            image[i] = U8(i * 16);
+        }
+        U8 block[8];
+        ensure("compress", LLImageBCn::compress(image.data(), 4, 4, 1, LLImageBCn::FORMAT_BC4, block));
+        ensure_equals("red0 is the maximum", (S32)block[0], 240);
+        ensure_equals("red1 is the minimum", (S32)block[1], 0);
+        ensure_equals("first texel selects red1", (S32)(block[2] & 7), 1);
+        ensure_equals("last texel selects red0", (S32)(block[7] >> 5), 0);
+    }
+
+    template<> template<>
+    void object::test<4>()
+    {
+        set_test_name("BC3 puts alpha first and repeats edge texels");
+        const U8 color[] = { 10, 20, 30, 128 };
+        std::vector<U8> image = solid(2, 2, 4, color);
+        U8 block[16];
+        ensure("compress", LLImageBCn::compress(image.data(), 2, 2, 4, LLImageBCn::FORMAT_BC3, block));
+        ensure_equals("alpha0", (S32)block[0], 128);
+        ensure_equals("alpha1", (S32)block[1], 128);
+        ensure("null source rejected", ! LLImageBCn::compress(nullptr, 2, 2, 4, LLImageBCn::FORMAT_BC3, block));
+    }
+}
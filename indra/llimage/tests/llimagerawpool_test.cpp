@@ -0,0 +1,115 @@
+/**
+ * @file llimagerawpool_test.cpp
+ * @brief Test for the decoded image buffer pool.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+// Class to test
+#include "../llimagerawpool.h"
+// Tut header
+#include "../test/lltut.h"
+
+#include "llmemory.h"
+
+namespace tut
+{
+    // 64x64 RGBA and RGB
+    const S32 RGBA_SIZE = 64 * 64 * 4;
+    const S32 RGB_SIZE = 64 * 64 * 3;
+
+    struct llimagerawpool_data
+    {
+        ~llimagerawpool_data()
+        {
+            LLImageRawPool::setMaxBytes(0);
+        }
+    };
+    typedef test_group<llimagerawpool_data> llimagerawpool_group;
+    typedef llimagerawpool_group::object object;
+    llimagerawpool_group llimagerawpoolgrp("LLImageRawPool");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("disabled until sized");
+        U8* data = LLImageRawPool::allocate(RGBA_SIZE);
+        ensure("allocated", data != NULL);
+        LLImageRawPool::release(data, RGBA_SIZE);
+        ensure_equals("nothing kept", LLImageRawPool::getResidentBytes(), (S64)0);
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("released buffers are handed out again");
+        LLImageRawPool::setMaxBytes(1024 * 1024);
+        U32 hits = LLImageRawPool::getHits();
+
+        U8* rgba = LLImageRawPool::allocate(RGBA_SIZE);
+        U8* rgb = LLImageRawPool::allocate(RGB_SIZE);
+        LLImageRawPool::release(rgba, RGBA_SIZE);
+        LLImageRawPool::release(rgb, RGB_SIZE);
+        ensure_equals("both kept", LLImageRawPool::getResidentBytes(), (S64)(RGBA_SIZE + RGB_SIZE));
+
+        ensure("same RGB buffer", LLImageRawPool::allocate(RGB_SIZE) == rgb);
+        ensure("same RGBA buffer", LLImageRawPool::allocate(RGBA_SIZE) == rgba);
+        ensure_equals("two hits", LLImageRawPool::getHits(), hits + 2);
+        ensure_equals("all handed out", LLImageRawPool::getResidentBytes(), (S64)0);
+
+        // Pooled buffers are plain aligned allocations
+        ll_aligned_free_16(rgb);
+        LLImageRawPool::release(rgba, RGBA_SIZE);
+    }
+
+    template<> template<>
+    void object::test<3>()
+    {
+        set_test_name("only power of two sized buffers are pooled");
+        LLImageRawPool::setMaxBytes(1024 * 1024);
+        LLImageRawPool::release(LLImageRawPool::allocate(1000), 1000);
+        LLImageRawPool::release(LLImageRawPool::allocate(16), 16);
+        ensure_equals("odd sizes are not kept", LLImageRawPool::getResidentBytes(), (S64)0);
+        LLImageRawPool::release(NULL, RGBA_SIZE);
+        ensure_equals("null is ignored", LLImageRawPool::getResidentBytes(), (S64)0);
+    }
+
+    template<> template<>
+    void object::test<4>()
+    {
+        set_test_name("pool size is capped");
+        LLImageRawPool::setMaxBytes(RGBA_SIZE + RGB_SIZE);
+        U8* first = LLImageRawPool::allocate(RGBA_SIZE);
+        U8* second = LLImageRawPool::allocate(RGBA_SIZE);
+        U8* third = LLImageRawPool::allocate(RGB_SIZE);
+        LLImageRawPool::release(first, RGBA_SIZE);
+        LLImageRawPool::release(second, RGBA_SIZE);
+        LLImageRawPool::release(third, RGB_SIZE);
+        ensure_equals("one RGBA buffer dropped", LLImageRawPool::getResidentBytes(), (S64)(RGBA_SIZE + RGB_SIZE));
+
+        LLImageRawPool::trim(RGB_SIZE);
+        ensure_equals("biggest buffers trimmed first", LLImageRawPool::getResidentBytes(), (S64)RGB_SIZE);
+        LLImageRawPool::setMaxBytes(0);
+        ensure_equals("shrinking frees", LLImageRawPool::getResidentBytes(), (S64)0);
+    }
+}
@@ -0,0 +1,205 @@
+/**
+ * @file llimagesimd_test.cpp
+ * @brief Test for the vectorized LLImageRaw pixel loops.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+// Class to test
+#include "../llimagesimd.h"
+// Tut header
+#include "../test/lltut.h"
+
+#include <vector>
+
+namespace tut
+{
+    // Odd sizes so every path also runs its scalar tail
+    const S32 PIXEL_COUNTS[] = { 0, 1, 5, 9, 10, 17, 33, 257 };
+
+    struct llimagesimd_data
+    {
+        // Deterministic noise, with some fully opaque and transparent alphas
+        std::vector<U8> noise(S32 bytes, U32 seed)
+        {
+            std::vector<U8> data(bytes);
+            for (S32 i = 0; i < bytes; i++)
+            {
+                seed = seed * 1664525 + 1013904223;
+                U8 value = U8(seed >> 24);
+                if ((i & 3) == 3 && (seed & 0x300) == 0)
+                {
+                    value = (seed & 0x400) ? 255 : 0;
+                }
+                data[i] = value;
+            }
+            return data;
+        }
+
+        const LLImageSIMD::Kernels& scalar()
+        {
+            return LLImageSIMD::getKernels(LLImageSIMD::PATH_SCALAR);
+        }
+    };
+    typedef test_group<llimagesimd_data> llimagesimd_group;
+    typedef llimagesimd_group::object object;
+    llimagesimd_group llimagesimdgrp("LLImageSIMD");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("scalar kernels");
+        const U8 rgba[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+        U8 rgb[6];
+        scalar().copy4onto3(rgba, rgb, 2);
+        ensure_equals("4 onto 3 drops alpha", (S32)rgb[3], 5);
+
+        U8 back[8];
+        scalar().copy3onto4(rgb, back, 2);
+        ensure_equals("3 onto 4 keeps color", (S32)back[6], 7);
+        ensure_equals("3 onto 4 sets alpha", (S32)back[7], 255);
+        ensure("opaque", scalar().isOpaque4(back, 2));
+        ensure("not opaque", ! scalar().isOpaque4(rgba, 2));
+
+        const U8 mask[] = { 0, 128 };
+        const U8 fill[] = { 10, 20, 30, 40 };
+        scalar().alphaMaskOnto4(mask, back, 2, fill);
+        ensure_equals("mask fills color", (S32)back[4], 10);
+        ensure_equals("mask sets alpha", (S32)back[7], 128);
+
+        const U8 over[] = { 200, 200, 200, 0, 200, 200, 200, 255 };
+        U8 under[] = { 50, 50, 50, 50, 50, 50 };
+        scalar().composite4onto3(over, under, 2);
+        ensure_equals("transparent keeps dst", (S32)under[0], 50);
+        ensure_equals("opaque replaces dst", (S32)under[3], 200);
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("every path matches scalar");
+        for (S32 path = LLImageSIMD::PATH_SCALAR + 1; path < LLImageSIMD::PATH_COUNT; path++)
+        {
+            if (! LLImageSIMD::isSupported((LLImageSIMD::EPath)path))
+            {
+                continue;
+            }
+            const LLImageSIMD::Kernels& kernels = LLImageSIMD::getKernels((LLImageSIMD::EPath)path);
+            std::string name = LLImageSIMD::getPathName((LLImageSIMD::EPath)path);
+
+            for (S32 pixels : PIXEL_COUNTS)
+            {
+                std::vector<U8> src4 = noise(pixels * 4, pixels + 1);
+                std::vector<U8> src3 = noise(pixels * 3, pixels + 2);
+                std::vector<U8> src1 = noise(pixels, pixels + 3);
+                std::string what = name + " " + std::to_string(pixels) + " pixels ";
+
+                std::vector<U8> expected(pixels * 4), actual(pixels * 4);
+                scalar().copy4onto3(src4.data(), expected.data(), pixels);
+                kernels.copy4onto3(src4.data(), actual.data(), pixels);
+                ensure(what + "4 onto 3", expected == actual);
+
+                scalar().copy3onto4(src3.data(), expected.data(), pixels);
+                kernels.copy3onto4(src3.data(), actual.data(), pixels);
+                ensure(what + "3 onto 4", expected == actual);
+
+                const U8 fill[] = { 10, 20, 30, 40 };
+                scalar().alphaMaskOnto4(src1.data(), expected.data(), pixels, fill);
+                kernels.alphaMaskOnto4(src1.data(), actual.data(), pixels, fill);
+                ensure(what + "alpha mask", expected == actual);
+
+                expected = actual = noise(pixels * 3, pixels + 4);
+                scalar().composite4onto3(src4.data(), expected.data(), pixels);
+                kernels.composite4onto3(src4.data(), actual.data(), pixels);
+                ensure(what + "composite", expected == actual);
+
+                ensure_equals(what + "opaque noise", kernels.isOpaque4(src4.data(), pixels),
+                              scalar().isOpaque4(src4.data(), pixels));
+                std::vector<U8> opaque(pixels * 4);
+                kernels.copy3onto4(src3.data(), opaque.data(), pixels);
+                ensure(what + "opaque", kernels.isOpaque4(opaque.data(), pixels));
+                if (pixels)
+                {
+                    opaque[(pixels - 1) * 4 + 3] = 254;
+                    ensure(what + "last pixel not opaque", ! kernels.isOpaque4(opaque.data(), pixels));
+                }
+            }
+        }
+    }
+
+    template<> template<>
+    void object::test<3>()
+    {
+        set_test_name("up-scale rows match scalar");
+        const S32 width = 19;
+        std::vector<U8> row = noise(12 * 4, 5);
+        std::vector<U8> next_row = noise(12 * 4, 6);
+        std::vector<S32> xpoints(width), xapoints(width);
+        for (S32 x = 0; x < width; x++)
+        {
+            xpoints[x] = x * 11 / width;
+            xapoints[x] = (x * 37) % 256;
+        }
+        xapoints[width - 1] = 0; // last column must not blend with the next one
+
+        std::vector<U8> expected(width * 4);
+        scalar().scaleUpRow4(row.data(), row.data(), expected.data(), width, xpoints.data(), xapoints.data(), 0);
+        for (S32 x = 0; x < width; x++)
+        {
+            ensure_equals("0 vertical weight takes the nearest pixel",
+                          (S32)expected[x * 4 + 1], (S32)row[xpoints[x] * 4 + 1]);
+        }
+
+        for (S32 path = LLImageSIMD::PATH_SCALAR + 1; path < LLImageSIMD::PATH_COUNT; path++)
+        {
+            if (! LLImageSIMD::isSupported((LLImageSIMD::EPath)path))
+            {
+                continue;
+            }
+            const LLImageSIMD::Kernels& kernels = LLImageSIMD::getKernels((LLImageSIMD::EPath)path);
+            for (S32 yap : { 0, 1, 100, 255 })
+            {
+                std::vector<U8> actual(width * 4);
+                scalar().scaleUpRow4(row.data(), next_row.data(), expected.data(), width,
+                                     xpoints.data(), xapoints.data(), yap);
+                kernels.scaleUpRow4(row.data(), next_row.data(), actual.data(), width,
+                                    xpoints.data(), xapoints.data(), yap);
+                ensure(std::string(LLImageSIMD::getPathName((LLImageSIMD::EPath)path))
+                       + " weight " + std::to_string(yap), expected == actual);
+            }
+        }
+    }
+
+    template<> template<>
+    void object::test<4>()
+    {
+        set_test_name("path selection");
+        LLImageSIMD::EPath best = LLImageSIMD::getBestPath();
+        ensure("best is supported", LLImageSIMD::isSupported(best));
+        LLImageSIMD::setPath(LLImageSIMD::PATH_COUNT);
+        ensure_equals("clamped to best", LLImageSIMD::getPath(), best);
+        LLImageSIMD::setPath(LLImageSIMD::PATH_SCALAR);
+        ensure_equals("forced scalar", LLImageSIMD::getPath(), LLImageSIMD::PATH_SCALAR);
+        LLImageSIMD::setPath(best);
+    }
+}
@@ -36,6 +36,8 @@
 // Tut header
 #include "../test/lltut.h"
 
+#include <atomic>
+
 // -------------------------------------------------------------------------------------------
 // Stubbing: Declarations required to link and run the class being tested
 // Notes:
@@ -60,15 +62,21 @@ void LLImageBase::sanityCheck() { }
 void LLImageBase::deleteData() { }
 U8* LLImageBase::allocateData(S32 size) { return NULL; }
 U8* LLImageBase::reallocateData(S32 size) { return NULL; }
+U8* LLImageBase::allocateBuffer(S32 size) { return NULL; }
+void LLImageBase::freeBuffer(U8* data, S32 size) { }
 
 LLImageRaw::LLImageRaw(U16 width, U16 height, S8 components) { }
 LLImageRaw::~LLImageRaw() { }
 void LLImageRaw::deleteData() { }
 U8* LLImageRaw::allocateData(S32 size) { return NULL; }
 U8* LLImageRaw::reallocateData(S32 size) { return NULL; }
+U8* LLImageRaw::allocateBuffer(S32 size) { return NULL; }
+void LLImageRaw::freeBuffer(U8* data, S32 size) { }
 const U8* LLImageBase::getData() const { return NULL; }
 U8* LLImageBase::getData() { return NULL; }
 const std::string& LLImage::getLastThreadError() { static std::string msg; return msg; }
+LLPointer<LLImageFormatted> LLImageFormatted::createFromExtension(const std::string& instring) { return NULL; }
+bool LLImageFormatted::load(const std::string& filename, int load_size) { return false; }
 
 // End Stubbing
 // -------------------------------------------------------------------------------------------
@@ -166,4 +174,32 @@ namespace tut
         // Verifies that the responder has now been called
         ensure("LLImageDecodeThread: threaded work unit not processed", done == true);
     }
+
+    template<> template<>
+    void imagedecodethread_object_t::test<2>()
+    {
+        // Test the callback API: without a "mainloop" work queue the callback runs on the decode thread
+        mThread = new LLImageDecodeThread(true);
+        std::atomic<bool> done(false);
+        std::atomic<bool> got_raw(true);
+        LLImageDecodeThread::handle_t decodeHandle = mThread->decodeImage(NULL,
+            [&done, &got_raw](const LLPointer<LLImageRaw>& raw, const std::string& error_message)
+            {
+                got_raw = raw.notNull();
+                done = true;
+            });
+        ensure("LLImageDecodeThread: callback decodeImage(), returned handle is null", decodeHandle != 0);
+        const U32 INCREMENT_TIME = 500;             // 500 milliseconds
+        const U32 MAX_TIME = 20 * INCREMENT_TIME;   // Do the loop 20 times max, i.e. wait 10 seconds but no more
+        U32 total_time = 0;
+        while (!done && (total_time < MAX_TIME))
+        {
+            ms_sleep(INCREMENT_TIME);
+            total_time += INCREMENT_TIME;
+        }
+        ensure("LLImageDecodeThread: callback not called", done);
+        ensure("LLImageDecodeThread: failed decode returned an image", !got_raw);
+        ensure_equals("LLImageDecodeThread: unknown extension accepted",
+                      mThread->decodeFile("image.xyz", [](const LLPointer<LLImageRaw>&, const std::string&) {}), 0U);
+    }
 }
@@ -335,6 +335,10 @@ public:
 
     bool decode(U8* data, U32 dataSize, U32* channels, U8 discard_level)
     {
+        source = data;
+        source_size = dataSize;
+        reusable = false;
+
         parameters.flags &= ~OPJ_DPARAMETERS_DUMP_FLAG;
 
         decoder = opj_create_decompress(OPJ_CODEC_J2K);
@@ -389,6 +393,16 @@ public:
             *channels = image->numcomps;
         }
 
+        // OpenJPEG keeps the codestream of a single tile image in the codec
+        // once it has been read, so the same codec can decode it again at
+        // another resolution without going back to the stream.
+        opj_codestream_info_v2_t* info = opj_get_cstr_info(decoder);
+        bool single_tile = info && info->tw == 1 && info->th == 1;
+        if (info)
+        {
+            opj_destroy_cstr_info(&info);
+        }
+
         OPJ_BOOL decoded = opj_decode(decoder, stream, image);
 
         // count was zero.  The latter is just a sanity check before we
@@ -399,11 +413,62 @@ public:
             return false;
         }
 
-        opj_end_decompress(decoder, stream);
+        if (!single_tile)
+        {
+            opj_end_decompress(decoder, stream);
+        }
+        reusable = single_tile;
 
         return true;
     }
 
+    // True when decode() already ran over exactly these bytes and the
+    // codec can be asked for another resolution of them.
+    bool canRedecode(const U8* data, U32 dataSize) const
+    {
+        return reusable && decoder && image && source == data && source_size == dataSize;
+    }
+
+    bool redecode(U32* channels, U8 discard_level)
+    {
+        if (!opj_set_decoded_resolution_factor(decoder, discard_level))
+        {
+            reusable = false;
+            return false;
+        }
+
+        if (channels)
+        {
+            *channels = image->numcomps;
+        }
+
+        if (!opj_decode(decoder, stream, image) || !image->numcomps)
+        {
+            reusable = false;
+            return false;
+        }
+        return true;
+    }
+
+    // Frees the decoded pixels but keeps the codec state for redecode().
+    void releaseImageData()
+    {
+        if (!image)
+        {
+            return;
+        }
+        for (U32 comp = 0; comp < image->numcomps; comp++)
+        {
+            if (image->comps[comp].data)
+            {
+                opj_image_data_free(image->comps[comp].data);
+                image->comps[comp].data = nullptr;
+            }
+        }
+    }
+
+    bool isReusable() const { return reusable; }
+
     opj_image_t* getImage() { return image; }
 
 private:
@@ -413,6 +478,9 @@ private:
     opj_codec_t*              decoder = nullptr;
     opj_stream_t*             stream = nullptr;
     opj_codestream_info_v2_t* codestream_info = nullptr;
+    const U8*                 source = nullptr;
+    U32                       source_size = 0;
+    bool                      reusable = false;
 };
 
 class JPEG2KEncode : public JPEG2KBase
@@ -779,12 +847,22 @@ bool LLImageJ2COJ::decodeImpl(LLImageJ2C &base, LLImageRaw &raw_image, F32 decod
     LLImageDataLock lockIn(&base);
     LLImageDataLock lockOut(&raw_image);
 
-    JPEG2KDecode decoder(0);
-
     U32 image_channels = 0;
     S32 data_size = base.getDataSize();
     S32 max_bytes = (base.getMaxBytes() ? base.getMaxBytes() : data_size);
-    bool decoded = decoder.decode(base.getData(), max_bytes, &image_channels, base.mDiscardLevel);
+
+    // A sharper discard level of data we already decoded reuses the codec
+    // that parsed it instead of starting over from the first byte.
+    bool decoded = false;
+    if (mDecoder && mDecoder->canRedecode(base.getData(), max_bytes))
+    {
+        decoded = mDecoder->redecode(&image_channels, base.mDiscardLevel);
+    }
+    if (!decoded)
+    {
+        mDecoder = std::make_unique<JPEG2KDecode>(0);
+        decoded = mDecoder->decode(base.getData(), max_bytes, &image_channels, base.mDiscardLevel);
+    }
 
     // set correct channel count early so failed decodes don't miss it...
     S32 channels = (S32)image_channels - first_channel;
@@ -799,10 +877,11 @@ bool LLImageJ2COJ::decodeImpl(LLImageJ2C &base, LLImageRaw &raw_image, F32 decod
         }
 
         LL_DEBUGS("Texture") << "ERROR -> decodeImpl: failed to decode image!" << LL_ENDL;
+        mDecoder.reset();
         return true; // done
     }
 
-    opj_image_t *image = decoder.getImage();
+    opj_image_t *image = mDecoder->getImage();
 
     // Component buffers are allocated in an image width by height buffer.
     // The image placed in that buffer is ceil(width/2^factor) by
@@ -848,6 +927,17 @@ bool LLImageJ2COJ::decodeImpl(LLImageJ2C &base, LLImageRaw &raw_image, F32 decod
 
     base.setDiscardLevel(f);
 
+    // Nothing sharper than discard 0 will be asked for, and only the codec
+    // state is worth keeping for the other levels.
+    if (f == 0 || !mDecoder->isReusable())
+    {
+        mDecoder.reset();
+    }
+    else
+    {
+        mDecoder->releaseImageData();
+    }
+
     return true; // done
 }
 
@@ -868,6 +958,9 @@ bool LLImageJ2COJ::getMetadata(LLImageJ2C &base)
 {
     LLImageDataLock lock(&base);
 
+    // New data, whatever was decoded before no longer applies
+    mDecoder.reset();
+
     JPEG2KDecode decode(0);
 
     S32 width = 0;
@@ -29,6 +29,10 @@
 
 #include "llimagej2c.h"
 
+#include <memory>
+
+class JPEG2KDecode;
+
 class LLImageJ2COJ : public LLImageJ2CImpl
 {
 public:
@@ -42,6 +46,12 @@ protected:
     virtual bool initDecode(LLImageJ2C &base, LLImageRaw &raw_image, int discard_level = -1, int* region = NULL);
     virtual bool initEncode(LLImageJ2C &base, LLImageRaw &raw_image, int blocks_size = -1, int precincts_size = -1, int levels = 0);
     virtual std::string getEngineInfo() const;
+
+private:
+    // Codec of the last decode, kept so that a sharper discard level of the
+    // same data does not have to read and parse the codestream again.
+    // Guarded by the data lock of the LLImageJ2C that owns this instance.
+    std::unique_ptr<JPEG2KDecode> mDecoder;
 };
 
 #endif
@@ -925,6 +925,18 @@ void LLInventoryItem::asLLSD( LLSD& sd ) const
 }
 
 bool LLInventoryItem::fromLLSD(const LLSD& sd, bool is_new)
+{
+    // iterate as map to avoid making unnecessary temp copies of everything
+    return fromLLSDFields(sd.beginMap(), sd.endMap(), is_new);
+}
+
+bool LLInventoryItem::fromLLSD(const llsd_fields_t& fields, bool is_new)
+{
+    return fromLLSDFields(fields.begin(), fields.end(), is_new);
+}
+
+template <typename ITER>
+bool LLInventoryItem::fromLLSDFields(ITER begin, ITER end, bool is_new)
 {
     LL_PROFILE_ZONE_SCOPED;
     if (is_new)
@@ -938,10 +950,7 @@ bool LLInventoryItem::fromLLSD(const LLSD& sd, bool is_new)
     // TODO - figure out if this should be moved into the noclobber fields above
     mThumbnailUUID.setNull();
 
-    // iterate as map to avoid making unnecessary temp copies of everything
-    LLSD::map_const_iterator i, end;
-    end = sd.endMap();
-    for (i = sd.beginMap(); i != end; ++i)
+    for (ITER i = begin; i != end; ++i)
     {
         if (i->first == INV_ITEM_ID_LABEL)
         {
@@ -209,6 +209,12 @@ public:
     LLSD asLLSD() const;
     void asLLSD( LLSD& sd ) const;
     bool fromLLSD(const LLSD& sd, bool is_new = true);
+    // The same from an item's fields one by one, as an LLSDVisitor sees them
+    typedef std::vector<std::pair<std::string, LLSD> > llsd_fields_t;
+    bool fromLLSD(const llsd_fields_t& fields, bool is_new = true);
+private:
+    template <typename ITER>
+    bool fromLLSDFields(ITER begin, ITER end, bool is_new);
 
     //--------------------------------------------------------------------
     // Member Variables
@@ -134,8 +134,8 @@ void LLSettingsBase::lerpSettings(LLSettingsBase &other, F64 mix)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_ENVIRONMENT;
     saveValuesIfNeeded();
-    stringset_t skip = getSkipInterpolateKeys();
-    stringset_t slerps = getSlerpKeys();
+    const stringset_t& skip = getSkipInterpolateKeys();
+    const stringset_t& slerps = getSlerpKeys();
     mSettings = interpolateSDMap(mSettings, other.getSettings(), other.getParameterMap(), mix, skip, slerps);
     setDirtyFlag(true);
     loadValuesFromLLSD();
@@ -406,7 +406,7 @@ LLSD LLSettingsBase::interpolateSDValue(const std::string& key_name, const LLSD
     return new_value;
 }
 
-LLSettingsBase::stringset_t LLSettingsBase::getSkipInterpolateKeys() const
+const LLSettingsBase::stringset_t& LLSettingsBase::getSkipInterpolateKeys() const
 {
     static stringset_t skipSet;
 
@@ -419,6 +419,20 @@ LLSettingsBase::stringset_t LLSettingsBase::getSkipInterpolateKeys() const
     return skipSet;
 }
 
+const LLSettingsBase::stringset_t& LLSettingsBase::getSlerpKeys() const
+{
+    static stringset_t slerpSet;
+
+    return slerpSet;
+}
+
+const LLSettingsBase::parammapping_t& LLSettingsBase::getParameterMap() const
+{
+    static parammapping_t param_map;
+
+    return param_map;
+}
+
 LLSD& LLSettingsBase::getSettings()
 {
     saveValuesIfNeeded();
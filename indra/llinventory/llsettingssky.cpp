@@ -659,12 +659,24 @@ void LLSettingsSky::blend(LLSettingsBase::ptr_t &end, F64 blendf)
         mHasLegacyHaze |= lerp_legacy_color(mBlueHorizon, mLegacyBlueHorizon, other->mBlueHorizon, other->mLegacyBlueHorizon, LLColor3(0.4954f, 0.4954f, 0.6399f), (F32)blendf);
         mHasLegacyHaze |= lerp_legacy_color(mBlueDensity, mLegacyBlueDensity, other->mBlueDensity, other->mLegacyBlueDensity, LLColor3(0.2447f, 0.4487f, 0.7599f), (F32)blendf);
 
-        parammapping_t defaults = other->getParameterMap();
-        stringset_t skip = getSkipInterpolateKeys();
-        stringset_t slerps = getSlerpKeys();
-        mAbsorptionConfigs = interpolateSDMap(mAbsorptionConfigs, other->mAbsorptionConfigs, defaults, blendf, skip, slerps);
-        mMieConfigs = interpolateSDMap(mMieConfigs, other->mMieConfigs, defaults, blendf, skip, slerps);
-        mRayleighConfigs = interpolateSDMap(mRayleighConfigs, other->mRayleighConfigs, defaults, blendf, skip, slerps);
+        // The density profiles are the only parameters still blended as LLSD, and both
+        // skies usually have the same ones, keep them as they are rather than rebuilding
+        // equal maps on every blend step.
+        const parammapping_t& defaults = other->getParameterMap();
+        const stringset_t& skip = getSkipInterpolateKeys();
+        const stringset_t& slerps = getSlerpKeys();
+        if (!llsd_equals(mAbsorptionConfigs, other->mAbsorptionConfigs))
+        {
+            mAbsorptionConfigs = interpolateSDMap(mAbsorptionConfigs, other->mAbsorptionConfigs, defaults, blendf, skip, slerps);
+        }
+        if (!llsd_equals(mMieConfigs, other->mMieConfigs))
+        {
+            mMieConfigs = interpolateSDMap(mMieConfigs, other->mMieConfigs, defaults, blendf, skip, slerps);
+        }
+        if (!llsd_equals(mRayleighConfigs, other->mRayleighConfigs))
+        {
+            mRayleighConfigs = interpolateSDMap(mRayleighConfigs, other->mRayleighConfigs, defaults, blendf, skip, slerps);
+        }
 
         setDirtyFlag(true);
         setReplaced();
@@ -685,7 +697,7 @@ void LLSettingsSky::blend(LLSettingsBase::ptr_t &end, F64 blendf)
     setBlendFactor(blendf);
 }
 
-LLSettingsSky::stringset_t LLSettingsSky::getSkipInterpolateKeys() const
+const LLSettingsSky::stringset_t& LLSettingsSky::getSkipInterpolateKeys() const
 {
     static stringset_t skipSet;
 
@@ -701,7 +713,7 @@ LLSettingsSky::stringset_t LLSettingsSky::getSkipInterpolateKeys() const
     return skipSet;
 }
 
-LLSettingsSky::stringset_t LLSettingsSky::getSlerpKeys() const
+const LLSettingsSky::stringset_t& LLSettingsSky::getSlerpKeys() const
 {
     static stringset_t slepSet;
 
@@ -296,6 +296,96 @@ S32 LLCamera::AABBInRegionFrustumNoFarClip(const LLVector4a& center, const LLVec
     return AABBInFrustumNoFarClip(center, radius, mRegionPlanes);
 }
 
+// Structure of arrays version of AABBInFrustum(): the x, y and z of four
+// centers and radii go in one register each, and every plane is tested
+// against all four boxes at once. Rather than picking the nearest corner
+// through the plane mask, each box is projected onto the plane normal as
+// center distance +/- |n|.radius, which comes to the same thing.
+void LLCamera::AABBsInFrustum(const LLVector4a* const* bounds, U32 count, S32* results, const LLPlane* planes, U32 skip_plane)
+{
+    if (!planes)
+    {
+        //use agent space
+        planes = mAgentPlanes;
+    }
+
+    // splat the planes once for all the batches: normal, |normal| and d
+    const LLQuad abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    LLQuad n[AGENT_PLANE_USER_CLIP_NUM][3], abs_n[AGENT_PLANE_USER_CLIP_NUM][3], d[AGENT_PLANE_USER_CLIP_NUM];
+    U32 num_planes = 0;
+    U32 max_planes = llmin(mPlaneCount, (U32) AGENT_PLANE_USER_CLIP_NUM);       // mAgentPlanes[] size is 7
+    for (U32 i = 0; i < max_planes; i++)
+    {
+        if ((i != skip_plane) && (mPlaneMask[i] < PLANE_MASK_NUM))
+        {
+            const LLPlane& p(planes[i]);
+            for (U32 axis = 0; axis < 3; axis++)
+            {
+                n[num_planes][axis] = _mm_set1_ps(p[axis]);
+                abs_n[num_planes][axis] = _mm_and_ps(n[num_planes][axis], abs_mask);
+            }
+            d[num_planes] = _mm_set1_ps(p[3]);
+            num_planes++;
+        }
+    }
+
+    const LLQuad zero = _mm_setzero_ps();
+    for (U32 first = 0; first < count; first += 4)
+    {
+        const U32 batch = llmin(count - first, 4U);
+        // pad a short batch out with its first box
+        const LLVector4a* box[4];
+        for (U32 j = 0; j < 4; j++)
+        {
+            box[j] = bounds[first + ((j < batch) ? j : 0)];
+        }
+        LLQuad cx = box[0][0], cy = box[1][0], cz = box[2][0], cw = box[3][0];
+        LLQuad rx = box[0][1], ry = box[1][1], rz = box[2][1], rw = box[3][1];
+        _MM_TRANSPOSE4_PS(cx, cy, cz, cw);
+        _MM_TRANSPOSE4_PS(rx, ry, rz, rw);
+
+        LLQuad outside = zero;
+        LLQuad partial = zero;
+        for (U32 i = 0; i < num_planes; i++)
+        {
+            LLQuad dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(n[i][0], cx), _mm_mul_ps(n[i][1], cy)),
+                                     _mm_add_ps(_mm_mul_ps(n[i][2], cz), d[i]));
+            LLQuad extent = _mm_add_ps(_mm_add_ps(_mm_mul_ps(abs_n[i][0], rx), _mm_mul_ps(abs_n[i][1], ry)),
+                                       _mm_mul_ps(abs_n[i][2], rz));
+            // wholly outside if even the nearest corner is, partly in if the farthest is
+            outside = _mm_or_ps(outside, _mm_cmpgt_ps(_mm_sub_ps(dist, extent), zero));
+            partial = _mm_or_ps(partial, _mm_cmpgt_ps(_mm_add_ps(dist, extent), zero));
+        }
+
+        const S32 outside_bits = _mm_movemask_ps(outside);
+        const S32 partial_bits = _mm_movemask_ps(partial);
+        for (U32 j = 0; j < batch; j++)
+        {
+            results[first + j] = (outside_bits & (1 << j)) ? 0 : ((partial_bits & (1 << j)) ? 1 : 2);
+        }
+    }
+}
+
+void LLCamera::AABBsInFrustum(const LLVector4a* const* bounds, U32 count, S32* results, const LLPlane* planes)
+{
+    AABBsInFrustum(bounds, count, results, planes, AGENT_PLANE_USER_CLIP_NUM);
+}
+
+void LLCamera::AABBsInRegionFrustum(const LLVector4a* const* bounds, U32 count, S32* results)
+{
+    AABBsInFrustum(bounds, count, results, mRegionPlanes, AGENT_PLANE_USER_CLIP_NUM);
+}
+
+void LLCamera::AABBsInFrustumNoFarClip(const LLVector4a* const* bounds, U32 count, S32* results, const LLPlane* planes)
+{
+    AABBsInFrustum(bounds, count, results, planes, AGENT_PLANE_FAR);
+}
+
+void LLCamera::AABBsInRegionFrustumNoFarClip(const LLVector4a* const* bounds, U32 count, S32* results)
+{
+    AABBsInFrustum(bounds, count, results, mRegionPlanes, AGENT_PLANE_FAR);
+}
+
 int LLCamera::sphereInFrustumQuick(const LLVector3 &sphere_center, const F32 radius)
 {
     LLVector3 dist = sphere_center-mFrustCenter;
@@ -202,6 +202,14 @@ public:
     S32 AABBInFrustumNoFarClip(const LLVector4a& center, const LLVector4a& radius, const LLPlane* planes = NULL);
     S32 AABBInRegionFrustumNoFarClip(const LLVector4a& center, const LLVector4a& radius);
 
+    // Test count boxes at once, four at a time, storing what the single box
+    // versions above would return for each in results[]. bounds[i] points
+    // at a center, radius pair, such as LLViewerOctreeGroup::getBounds().
+    void AABBsInFrustum(const LLVector4a* const* bounds, U32 count, S32* results, const LLPlane* planes = NULL);
+    void AABBsInRegionFrustum(const LLVector4a* const* bounds, U32 count, S32* results);
+    void AABBsInFrustumNoFarClip(const LLVector4a* const* bounds, U32 count, S32* results, const LLPlane* planes = NULL);
+    void AABBsInRegionFrustumNoFarClip(const LLVector4a* const* bounds, U32 count, S32* results);
+
     //does a quick 'n dirty sphere-sphere check
     S32 sphereInFrustumQuick(const LLVector3 &sphere_center, const F32 radius);
 
@@ -218,6 +226,8 @@ protected:
     void calculateFrustumPlanes();
     void calculateFrustumPlanes(F32 left, F32 right, F32 top, F32 bottom);
     void calculateFrustumPlanesFromWindow(F32 x1, F32 y1, F32 x2, F32 y2);
+    // skip_plane is left out, AGENT_PLANE_USER_CLIP_NUM to test them all
+    void AABBsInFrustum(const LLVector4a* const* bounds, U32 count, S32* results, const LLPlane* planes, U32 skip_plane);
 } LL_ALIGN_POSTFIX(16);
 
 
@@ -0,0 +1,433 @@
+/**
+ * @file llvector4abulk.cpp
+ * @brief LLVector4a operations over whole arrays
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llmath.h"
+#include "llvector4abulk.h"
+#include "llmatrix4a.h"
+#include "llprocessor.h"
+
+#include <atomic>
+
+#if LL_X86
+#include <immintrin.h>
+// MSVC takes AVX intrinsics anywhere; gcc and clang want the functions
+// using them marked, so the rest of llmath still builds for plain SSE2
+#if LL_MSVC
+#define LL_TARGET_AVX2
+#else
+#define LL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    using namespace LLVector4aBulk;
+
+    // what to do with the w of each result
+    enum EWMode
+    {
+        W_ANY,  // whatever the matrix makes of it
+        W_SET,  // the w passed in
+        W_KEEP  // the source vector's
+    };
+
+    //------------------------------------------------------------------------
+    // SSE2: the one-at-a-time LLVector4a calls, and the tails of the others
+
+    template <bool TRANSLATE, EWMode W>
+    void transform_sse2(const LLMatrix4a& mat, const LLVector4a* src, LLVector4a* dst, U32 count, F32 w)
+    {
+        LLVector4Logical mask;
+        mask.clear();
+        mask.setElement<3>();
+        LLVector4a w_vec(0.f, 0.f, 0.f, w);
+
+        for (U32 i = 0; i < count; ++i)
+        {
+            LLVector4a res;
+            if (TRANSLATE)
+            {
+                mat.affineTransform(src[i], res);
+            }
+            else
+            {
+                mat.rotate(src[i], res);
+            }
+            if (W == W_SET)
+            {
+                res.setSelectWithMask(mask, w_vec, res);
+            }
+            else if (W == W_KEEP)
+            {
+                res.setSelectWithMask(mask, src[i], res);
+            }
+            dst[i] = res;
+        }
+    }
+
+    void min_max_sse2(const LLVector4a* src, U32 count, LLVector4a& min, LLVector4a& max)
+    {
+        for (U32 i = 0; i < count; ++i)
+        {
+            min.setMin(min, src[i]);
+            max.setMax(max, src[i]);
+        }
+    }
+
+    void normalize_sse2(LLVector4a* v, U32 count)
+    {
+        for (U32 i = 0; i < count; ++i)
+        {
+            v[i].normalize3fast();
+        }
+    }
+
+#if LL_X86
+    //------------------------------------------------------------------------
+    // AVX2: two vectors to a register, and two registers at a time. The
+    // arithmetic is in the same order as the SSE2 versions, so results
+    // match them exactly.
+
+    template <bool TRANSLATE, EWMode W>
+    LL_TARGET_AVX2 inline __m256 transform8(__m256 v, const __m256* m, __m256 w_vec)
+    {
+        __m256 x = _mm256_mul_ps(_mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)), m[0]);
+        __m256 y = _mm256_mul_ps(_mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), m[1]);
+        __m256 z = _mm256_mul_ps(_mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), m[2]);
+        __m256 res;
+        if (TRANSLATE)
+        {
+            res = _mm256_add_ps(_mm256_add_ps(x, y), _mm256_add_ps(z, m[3]));
+        }
+        else
+        {
+            res = _mm256_add_ps(_mm256_add_ps(x, y), z);
+        }
+        if (W == W_SET)
+        {
+            res = _mm256_blend_ps(res, w_vec, 0x88);
+        }
+        else if (W == W_KEEP)
+        {
+            res = _mm256_blend_ps(res, v, 0x88);
+        }
+        return res;
+    }
+
+    template <bool TRANSLATE, EWMode W>
+    LL_TARGET_AVX2 void transform_avx2(const LLMatrix4a& mat, const LLVector4a* src, LLVector4a* dst, U32 count, F32 w)
+    {
+        __m256 m[4];
+        for (U32 j = 0; j < 4; ++j)
+        {
+            m[j] = _mm256_broadcast_ps((const __m128*)mat.mMatrix[j].getF32ptr());
+        }
+        const __m256 w_vec = _mm256_set1_ps(w);
+
+        const F32* in = src->getF32ptr();
+        F32* out = dst->getF32ptr();
+        U32 i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m256 a = _mm256_loadu_ps(in + i * 4);
+            __m256 b = _mm256_loadu_ps(in + i * 4 + 8);
+            _mm256_storeu_ps(out + i * 4, transform8<TRANSLATE, W>(a, m, w_vec));
+            _mm256_storeu_ps(out + i * 4 + 8, transform8<TRANSLATE, W>(b, m, w_vec));
+        }
+        transform_sse2<TRANSLATE, W>(mat, src + i, dst + i, count - i, w);
+    }
+
+    LL_TARGET_AVX2 void min_max_avx2(const LLVector4a* src, U32 count, LLVector4a& min, LLVector4a& max)
+    {
+        const F32* in = src->getF32ptr();
+        __m256 lo = _mm256_broadcast_ps((const __m128*)min.getF32ptr());
+        __m256 hi = _mm256_broadcast_ps((const __m128*)max.getF32ptr());
+        U32 i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m256 a = _mm256_loadu_ps(in + i * 4);
+            __m256 b = _mm256_loadu_ps(in + i * 4 + 8);
+            lo = _mm256_min_ps(lo, _mm256_min_ps(a, b));
+            hi = _mm256_max_ps(hi, _mm256_max_ps(a, b));
+        }
+        min = _mm_min_ps(_mm256_castps256_ps128(lo), _mm256_extractf128_ps(lo, 1));
+        max = _mm_max_ps(_mm256_castps256_ps128(hi), _mm256_extractf128_ps(hi, 1));
+        min_max_sse2(src + i, count - i, min, max);
+    }
+
+    // LLVector4a::normalize3fast(), two vectors at a time
+    LL_TARGET_AVX2 inline __m256 normalize8(__m256 v)
+    {
+        __m256 ab = _mm256_mul_ps(v, v);
+        __m256 x_plus_y = _mm256_add_ps(ab, _mm256_permute_ps(ab, _MM_SHUFFLE(3, 2, 0, 1)));
+        __m256 dot = _mm256_add_ps(_mm256_permute_ps(x_plus_y, _MM_SHUFFLE(1, 0, 1, 0)),
+                                   _mm256_permute_ps(ab, _MM_SHUFFLE(2, 2, 2, 2)));
+        return _mm256_mul_ps(v, _mm256_rsqrt_ps(dot));
+    }
+
+    LL_TARGET_AVX2 void normalize_avx2(LLVector4a* v, U32 count)
+    {
+        F32* data = v->getF32ptr();
+        U32 i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m256 a = _mm256_loadu_ps(data + i * 4);
+            __m256 b = _mm256_loadu_ps(data + i * 4 + 8);
+            _mm256_storeu_ps(data + i * 4, normalize8(a));
+            _mm256_storeu_ps(data + i * 4 + 8, normalize8(b));
+        }
+        normalize_sse2(v + i, count - i);
+    }
+#endif // LL_X86
+
+#if defined(__ARM_NEON)
+    //------------------------------------------------------------------------
+    // NEON: four vectors at a time, split into x, y, z and w registers on
+    // the way in, so each lane does a whole vector's work
+
+    template <bool TRANSLATE, EWMode W>
+    void transform_neon(const LLMatrix4a& mat, const LLVector4a* src, LLVector4a* dst, U32 count, F32 w)
+    {
+        const F32* m = mat.mMatrix[0].getF32ptr();
+        const F32* in = src->getF32ptr();
+        F32* out = dst->getF32ptr();
+        U32 i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            float32x4x4_t v = vld4q_f32(in + i * 4);
+            float32x4x4_t res;
+            for (U32 j = 0; j < 4; ++j)
+            {
+                if (j == 3 && W != W_ANY)
+                {
+                    break;
+                }
+                float32x4_t r = vaddq_f32(vmulq_n_f32(v.val[0], m[j]), vmulq_n_f32(v.val[1], m[4 + j]));
+                if (TRANSLATE)
+                {
+                    r = vaddq_f32(r, vaddq_f32(vmulq_n_f32(v.val[2], m[8 + j]), vdupq_n_f32(m[12 + j])));
+                }
+                else
+                {
+                    r = vaddq_f32(r, vmulq_n_f32(v.val[2], m[8 + j]));
+                }
+                res.val[j] = r;
+            }
+            if (W == W_SET)
+            {
+                res.val[3] = vdupq_n_f32(w);
+            }
+            else if (W == W_KEEP)
+            {
+                res.val[3] = v.val[3];
+            }
+            vst4q_f32(out + i * 4, res);
+        }
+        transform_sse2<TRANSLATE, W>(mat, src + i, dst + i, count - i, w);
+    }
+
+    void min_max_neon(const LLVector4a* src, U32 count, LLVector4a& min, LLVector4a& max)
+    {
+        const F32* in = src->getF32ptr();
+        float32x4_t lo = vld1q_f32(min.getF32ptr());
+        float32x4_t hi = vld1q_f32(max.getF32ptr());
+        U32 i = 0;
+        for (; i + 2 <= count; i += 2)
+        {
+            float32x4_t a = vld1q_f32(in + i * 4);
+            float32x4_t b = vld1q_f32(in + i * 4 + 4);
+            lo = vminq_f32(lo, vminq_f32(a, b));
+            hi = vmaxq_f32(hi, vmaxq_f32(a, b));
+        }
+        vst1q_f32(min.getF32ptr(), lo);
+        vst1q_f32(max.getF32ptr(), hi);
+        min_max_sse2(src + i, count - i, min, max);
+    }
+
+    void normalize_neon(LLVector4a* v, U32 count)
+    {
+        F32* data = v->getF32ptr();
+        U32 i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            float32x4x4_t a = vld4q_f32(data + i * 4);
+            float32x4_t dot = vaddq_f32(vaddq_f32(vmulq_f32(a.val[0], a.val[0]), vmulq_f32(a.val[1], a.val[1])),
+                                        vmulq_f32(a.val[2], a.val[2]));
+            // the NEON estimate is coarser than SSE's, so refine it once
+            float32x4_t rsqrt = vrsqrteq_f32(dot);
+            rsqrt = vmulq_f32(rsqrt, vrsqrtsq_f32(vmulq_f32(dot, rsqrt), rsqrt));
+            for (U32 j = 0; j < 4; ++j)
+            {
+                a.val[j] = vmulq_f32(a.val[j], rsqrt);
+            }
+            vst4q_f32(data + i * 4, a);
+        }
+        normalize_sse2(v + i, count - i);
+    }
+#endif // __ARM_NEON
+
+    //------------------------------------------------------------------------
+
+    bool can_use(EPath path)
+    {
+        switch (path)
+        {
+        case PATH_SSE2:
+            return true;
+        case PATH_AVX2:
+#if LL_X86
+            return LLProcessorInfo().hasAVX2();
+#else
+            return false;
+#endif
+        case PATH_NEON:
+#if defined(__ARM_NEON)
+            return true;
+#else
+            return false;
+#endif
+        }
+        return false;
+    }
+
+    std::atomic<S32> sPath{ -1 };
+
+    EPath current_path()
+    {
+        S32 path = sPath.load(std::memory_order_relaxed);
+        if (path < 0)
+        {
+            path = can_use(PATH_NEON) ? PATH_NEON : can_use(PATH_AVX2) ? PATH_AVX2 : PATH_SSE2;
+            sPath.store(path, std::memory_order_relaxed);
+        }
+        return EPath(path);
+    }
+
+    template <bool TRANSLATE, EWMode W>
+    void transform(const LLMatrix4a& mat, const LLVector4a* src, LLVector4a* dst, U32 count, F32 w)
+    {
+        switch (current_path())
+        {
+#if LL_X86
+        case PATH_AVX2:
+            transform_avx2<TRANSLATE, W>(mat, src, dst, count, w);
+            return;
+#endif
+#if defined(__ARM_NEON)
+        case PATH_NEON:
+            transform_neon<TRANSLATE, W>(mat, src, dst, count, w);
+            return;
+#endif
+        default:
+            transform_sse2<TRANSLATE, W>(mat, src, dst, count, w);
+            return;
+        }
+    }
+}
+
+void LLVector4aBulk::affineTransform(const LLMatrix4a& mat, const LLVector4a* src, LLVector4a* dst, U32 count)
+{
+    transform<true, W_ANY>(mat, src, dst, count, 0.f);
+}
+
+void LLVector4aBulk::affineTransform(const LLMatrix4a& mat, const LLVector4a* src, LLVector4a* dst, U32 count, F32 w)
+{
+    transform<true, W_SET>(mat, src, dst, count, w);
+}
+
+void LLVector4aBulk::rotate(const LLMatrix4a& mat, const LLVector4a* src, LLVector4a* dst, U32 count, bool keep_w)
+{
+    if (keep_w)
+    {
+        transform<false, W_KEEP>(mat, src, dst, count, 0.f);
+    }
+    else
+    {
+        transform<false, W_ANY>(mat, src, dst, count, 0.f);
+    }
+}
+
+void LLVector4aBulk::getMinMax(const LLVector4a* src, U32 count, LLVector4a& min, LLVector4a& max)
+{
+    llassert(count > 0);
+    min = src[0];
+    max = src[0];
+    switch (current_path())
+    {
+#if LL_X86
+    case PATH_AVX2:
+        min_max_avx2(src + 1, count - 1, min, max);
+        return;
+#endif
+#if defined(__ARM_NEON)
+    case PATH_NEON:
+        min_max_neon(src + 1, count - 1, min, max);
+        return;
+#endif
+    default:
+        min_max_sse2(src + 1, count - 1, min, max);
+        return;
+    }
+}
+
+void LLVector4aBulk::normalize3fast(LLVector4a* v, U32 count)
+{
+    switch (current_path())
+    {
+#if LL_X86
+    case PATH_AVX2:
+        normalize_avx2(v, count);
+        return;
+#endif
+#if defined(__ARM_NEON)
+    case PATH_NEON:
+        normalize_neon(v, count);
+        return;
+#endif
+    default:
+        normalize_sse2(v, count);
+        return;
+    }
+}
+
+LLVector4aBulk::EPath LLVector4aBulk::getPath()
+{
+    return current_path();
+}
+
+bool LLVector4aBulk::setPath(EPath path)
+{
+    if (!can_use(path))
+    {
+        return false;
+    }
+    sPath.store(path, std::memory_order_relaxed);
+    return true;
+}
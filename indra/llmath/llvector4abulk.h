@@ -0,0 +1,74 @@
+/**
+ * @file llvector4abulk.h
+ * @brief LLVector4a operations over whole arrays
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLVECTOR4ABULK_H
+#define LL_LLVECTOR4ABULK_H
+
+#include "llvector4a.h"
+
+class LLMatrix4a;
+
+// The same LLVector4a and LLMatrix4a operations the mesh code otherwise
+// makes one vector at a time, run over whole arrays. On x86 they use 8-wide
+// AVX2 when the CPU has it, checked once on first use, and SSE2 otherwise;
+// ARM builds use NEON directly rather than going through the SSE
+// translation. Every path gives the same results as the LLVector4a calls to
+// within rounding.
+//
+// Arrays are LLVector4a arrays, so 16-byte aligned. dst may be src, but
+// they mustn't otherwise overlap.
+namespace LLVector4aBulk
+{
+    enum EPath
+    {
+        PATH_SSE2,
+        PATH_AVX2,
+        PATH_NEON
+    };
+
+    // dst[i] = src[i] through mat.affineTransform()
+    void affineTransform(const LLMatrix4a& mat, const LLVector4a* src, LLVector4a* dst, U32 count);
+    // the same, with the w of every result set to w, as for vertex
+    // positions that carry a texture index there
+    void affineTransform(const LLMatrix4a& mat, const LLVector4a* src, LLVector4a* dst, U32 count, F32 w);
+
+    // dst[i] = src[i] through mat.rotate(); with keep_w, each result keeps
+    // src[i]'s w, as tangents do
+    void rotate(const LLMatrix4a& mat, const LLVector4a* src, LLVector4a* dst, U32 count, bool keep_w = false);
+
+    // per-component bounds of the count > 0 vectors in src
+    void getMinMax(const LLVector4a* src, U32 count, LLVector4a& min, LLVector4a& max);
+
+    // v[i].normalize3fast()
+    void normalize3fast(LLVector4a* v, U32 count);
+
+    EPath getPath();
+    // Use path from now on, if this machine can; returns whether it can.
+    // For tests and benchmarks.
+    bool setPath(EPath path);
+}
+
+#endif // LL_LLVECTOR4ABULK_H
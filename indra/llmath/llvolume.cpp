@@ -24,6 +24,7 @@
  */
 
 #include "linden_common.h"
+#include "llheap.h"
 #include "llmemory.h"
 #include "llmath.h"
 
@@ -49,8 +50,10 @@
 #include "llsdserialize.h"
 #include "llvector4a.h"
 #include "llmatrix4a.h"
+#include "llvector4abulk.h"
 #include "llmeshoptimizer.h"
 #include "lltimer.h"
+#include "llparallel.h"
 #include "llvolumeoctree.h"
 
 #include "mikktspace/mikktspace.hh"
@@ -94,6 +97,11 @@ constexpr F32 SKEW_MAX  =  0.95f;
 constexpr F32 SCULPT_MIN_AREA = 0.002f;
 constexpr S32 SCULPT_MIN_AREA_DETAIL = 1;
 
+// path by profile points below which faces build faster one after another
+constexpr size_t PARALLEL_FACE_POINTS = 4096;
+// indices over all faces below which meshes optimize faster one face at a time
+constexpr size_t PARALLEL_OPTIMIZE_INDICES = 12288;
+
 bool gDebugGL = false; // See settings.xml "RenderDebugGL"
 
 bool check_same_clock_dir( const LLVector3& pt1, const LLVector3& pt2, const LLVector3& pt3, const LLVector3& norm)
@@ -1951,7 +1959,7 @@ LLProfile::~LLProfile()
 }
 
 
-S32 LLVolume::sNumMeshPoints = 0;
+std::atomic<S32> LLVolume::sNumMeshPoints(0);
 
 LLVolume::LLVolume(const LLVolumeParams &params, const F32 detail, const bool generate_single_face, const bool is_unique)
     : mParams(params)
@@ -2710,6 +2718,323 @@ bool LLVolume::unpackVolumeFacesInternal(const LLSD& mdl)
 }
 
 
+//============================================================================
+// Decoded face cache format, see packDecodedFaces().  Everything is a
+// multiple of 16 bytes so the arrays following a face header keep the
+// alignment LLVolumeFace allocates them with.
+
+const U32 LLVolume::DECODED_FACES_VERSION = 2;
+
+namespace
+{
+    const U32 DECODED_FACES_MAGIC = 0x464d4c4c; // "LLMF"
+
+    enum
+    {
+        DECODED_HAS_NORMALS     = 1 << 0,
+        DECODED_HAS_TEXCOORDS   = 1 << 1,
+        DECODED_HAS_TANGENTS    = 1 << 2,
+        DECODED_HAS_WEIGHTS     = 1 << 3,
+        DECODED_OPTIMIZED       = 1 << 4,
+        DECODED_WEIGHTS_SCRUBBED = 1 << 5
+    };
+
+    struct DecodedFacesHeader
+    {
+        U32 mMagic;
+        U32 mVersion;
+        U32 mFaceCount;
+        U32 mVectorSize;    // catches a different LLVector4a layout
+    };
+
+    struct DecodedFaceHeader
+    {
+        S32 mID;
+        U32 mTypeMask;
+        S32 mNumVertices;
+        S32 mNumIndices;
+        U32 mFlags;
+        F32 mNormalizedScale[3];
+        F32 mTexCoordExtents[4];
+        F32 mExtents[8];
+        F32 mCenter[4];
+        S32 mNumClusters;
+        S32 mPad[3];
+    };
+
+    static_assert(sizeof(DecodedFacesHeader) % 16 == 0, "decoded faces header must keep arrays 16 byte aligned");
+    static_assert(sizeof(DecodedFaceHeader) % 16 == 0, "decoded face header must keep arrays 16 byte aligned");
+
+    S32 decoded_tc_size(S32 num_verts)
+    {
+        // Same padding as LLVolumeFace::resizeVertices()
+        return ((num_verts * (S32)sizeof(LLVector2)) + 0xF) & ~0xF;
+    }
+
+    S32 decoded_index_size(S32 num_indices)
+    {
+        // Same padding as LLVolumeFace::resizeIndices()
+        return ((num_indices * (S32)sizeof(U16)) + 0xF) & ~0xF;
+    }
+
+    S32 decoded_cluster_size(S32 num_clusters)
+    {
+        return ((num_clusters * (S32)sizeof(LLMeshOptimizer::Cluster)) + 0xF) & ~0xF;
+    }
+
+    S32 decoded_face_size(const DecodedFaceHeader& header)
+    {
+        S32 vert_size = header.mNumVertices * (S32)sizeof(LLVector4a);
+        S32 size = (S32)sizeof(DecodedFaceHeader) + vert_size;
+        size += (header.mFlags & DECODED_HAS_NORMALS) ? vert_size : 0;
+        size += (header.mFlags & DECODED_HAS_TEXCOORDS) ? decoded_tc_size(header.mNumVertices) : 0;
+        size += (header.mFlags & DECODED_HAS_TANGENTS) ? vert_size : 0;
+        size += (header.mFlags & DECODED_HAS_WEIGHTS) ? vert_size : 0;
+        size += decoded_index_size(header.mNumIndices);
+        size += decoded_cluster_size(header.mNumClusters);
+        return size;
+    }
+}
+
+bool LLVolume::packDecodedFaces(std::vector<U8>& out) const
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    if (mVolumeFaces.empty())
+    {
+        return false;
+    }
+
+    std::vector<DecodedFaceHeader> headers(mVolumeFaces.size());
+    size_t total = sizeof(DecodedFacesHeader);
+    for (size_t i = 0; i < mVolumeFaces.size(); ++i)
+    {
+        const LLVolumeFace& face = mVolumeFaces[i];
+        DecodedFaceHeader& header = headers[i];
+        memset(&header, 0, sizeof(header));
+
+        header.mID = face.mID;
+        header.mTypeMask = face.mTypeMask;
+        header.mNumVertices = face.mNumVertices;
+        header.mNumIndices = face.mNumIndices;
+        header.mNumClusters = (S32)face.mClusters.size();
+        if (face.mNumVertices > 0)
+        {
+            header.mFlags |= face.mNormals ? DECODED_HAS_NORMALS : 0;
+            header.mFlags |= face.mTexCoords ? DECODED_HAS_TEXCOORDS : 0;
+            header.mFlags |= face.mTangents ? DECODED_HAS_TANGENTS : 0;
+            header.mFlags |= face.mWeights ? DECODED_HAS_WEIGHTS : 0;
+        }
+        header.mFlags |= face.mOptimized ? DECODED_OPTIMIZED : 0;
+        header.mFlags |= face.mWeightsScrubbed ? DECODED_WEIGHTS_SCRUBBED : 0;
+        memcpy(header.mNormalizedScale, face.mNormalizedScale.mV, sizeof(header.mNormalizedScale));
+        header.mTexCoordExtents[0] = face.mTexCoordExtents[0].mV[VX];
+        header.mTexCoordExtents[1] = face.mTexCoordExtents[0].mV[VY];
+        header.mTexCoordExtents[2] = face.mTexCoordExtents[1].mV[VX];
+        header.mTexCoordExtents[3] = face.mTexCoordExtents[1].mV[VY];
+        memcpy(header.mExtents, face.mExtents[0].getF32ptr(), 4 * sizeof(F32));
+        memcpy(header.mExtents + 4, face.mExtents[1].getF32ptr(), 4 * sizeof(F32));
+        memcpy(header.mCenter, face.mCenter->getF32ptr(), 4 * sizeof(F32));
+
+        total += decoded_face_size(header);
+    }
+
+    out.resize(total);
+    U8* dst = out.data();
+
+    DecodedFacesHeader file_header = { DECODED_FACES_MAGIC, DECODED_FACES_VERSION,
+                                       (U32)mVolumeFaces.size(), (U32)sizeof(LLVector4a) };
+    memcpy(dst, &file_header, sizeof(file_header));
+    dst += sizeof(file_header);
+
+    for (size_t i = 0; i < mVolumeFaces.size(); ++i)
+    {
+        const LLVolumeFace& face = mVolumeFaces[i];
+        const DecodedFaceHeader& header = headers[i];
+        const S32 vert_size = face.mNumVertices * (S32)sizeof(LLVector4a);
+
+        memcpy(dst, &header, sizeof(header));
+        dst += sizeof(header);
+
+        if (vert_size)
+        {
+            memcpy(dst, face.mPositions, vert_size);
+            dst += vert_size;
+        }
+        if (header.mFlags & DECODED_HAS_NORMALS)
+        {
+            memcpy(dst, face.mNormals, vert_size);
+            dst += vert_size;
+        }
+        if (header.mFlags & DECODED_HAS_TEXCOORDS)
+        {
+            memcpy(dst, face.mTexCoords, decoded_tc_size(face.mNumVertices));
+            dst += decoded_tc_size(face.mNumVertices);
+        }
+        if (header.mFlags & DECODED_HAS_TANGENTS)
+        {
+            memcpy(dst, face.mTangents, vert_size);
+            dst += vert_size;
+        }
+        if (header.mFlags & DECODED_HAS_WEIGHTS)
+        {
+            memcpy(dst, face.mWeights, vert_size);
+            dst += vert_size;
+        }
+        if (face.mNumIndices)
+        {
+            memcpy(dst, face.mIndices, decoded_index_size(face.mNumIndices));
+            dst += decoded_index_size(face.mNumIndices);
+        }
+        if (header.mNumClusters)
+        {
+            memset(dst, 0, decoded_cluster_size(header.mNumClusters));
+            memcpy(dst, face.mClusters.data(), header.mNumClusters * sizeof(LLMeshOptimizer::Cluster));
+            dst += decoded_cluster_size(header.mNumClusters);
+        }
+    }
+
+    llassert(dst == out.data() + out.size());
+    return true;
+}
+
+bool LLVolume::unpackDecodedFaces(const U8* data, S32 size)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    DecodedFacesHeader file_header;
+    if (!data || size < (S32)sizeof(file_header))
+    {
+        return false;
+    }
+    memcpy(&file_header, data, sizeof(file_header));
+    if (file_header.mMagic != DECODED_FACES_MAGIC
+        || file_header.mVersion != DECODED_FACES_VERSION
+        || file_header.mVectorSize != sizeof(LLVector4a)
+        || file_header.mFaceCount == 0
+        || file_header.mFaceCount > (U32)(size / sizeof(DecodedFaceHeader)))
+    {
+        LL_DEBUGS("MeshStreaming") << "Decoded faces of unknown version, will unpack the asset again." << LL_ENDL;
+        return false;
+    }
+
+    const U8* src = data + sizeof(file_header);
+    const U8* end = data + size;
+
+    std::vector<LLVolumeFace> faces(file_header.mFaceCount);
+    for (LLVolumeFace& face : faces)
+    {
+        DecodedFaceHeader header;
+        if (end - src < (S64)sizeof(header))
+        {
+            return false;
+        }
+        memcpy(&header, src, sizeof(header));
+
+        if (header.mNumVertices < 0 || header.mNumVertices > 65536
+            || header.mNumIndices < 0 || header.mNumIndices % 3 != 0
+            || header.mNumClusters < 0 || header.mNumClusters > header.mNumIndices / 3
+            || end - src < (S64)decoded_face_size(header))
+        {
+            LL_WARNS() << "Corrupt decoded face, will unpack the asset again." << LL_ENDL;
+            return false;
+        }
+        src += sizeof(header);
+
+        face.mID = header.mID;
+        face.mTypeMask = header.mTypeMask;
+        face.resizeVertices(header.mNumVertices);
+        face.resizeIndices(header.mNumIndices);
+        if (face.mNumVertices != header.mNumVertices || face.mNumIndices != header.mNumIndices)
+        {
+            LL_WARNS() << "Failed to allocate " << header.mNumVertices << " vertices for a decoded face" << LL_ENDL;
+            return false;
+        }
+
+        const S32 vert_size = header.mNumVertices * (S32)sizeof(LLVector4a);
+        if (vert_size)
+        {
+            memcpy(face.mPositions, src, vert_size);
+            src += vert_size;
+        }
+        if (header.mFlags & DECODED_HAS_NORMALS)
+        {
+            memcpy(face.mNormals, src, vert_size);
+            src += vert_size;
+        }
+        if (header.mFlags & DECODED_HAS_TEXCOORDS)
+        {
+            memcpy(face.mTexCoords, src, decoded_tc_size(header.mNumVertices));
+            src += decoded_tc_size(header.mNumVertices);
+        }
+        if (header.mFlags & DECODED_HAS_TANGENTS)
+        {
+            face.allocateTangents(header.mNumVertices);
+            if (!face.mTangents)
+            {
+                return false;
+            }
+            memcpy(face.mTangents, src, vert_size);
+            src += vert_size;
+        }
+        if (header.mFlags & DECODED_HAS_WEIGHTS)
+        {
+            face.allocateWeights(header.mNumVertices);
+            if (!face.mWeights)
+            {
+                return false;
+            }
+            memcpy(face.mWeights, src, vert_size);
+            src += vert_size;
+        }
+        if (header.mNumIndices)
+        {
+            memcpy(face.mIndices, src, decoded_index_size(header.mNumIndices));
+            src += decoded_index_size(header.mNumIndices);
+
+            for (S32 i = 0; i < header.mNumIndices; ++i)
+            {
+                if (face.mIndices[i] >= header.mNumVertices)
+                {
+                    LL_WARNS() << "Decoded face index out of range, will unpack the asset again." << LL_ENDL;
+                    return false;
+                }
+            }
+        }
+        if (header.mNumClusters)
+        {
+            LLVolumeFace::cluster_list_t clusters(header.mNumClusters);
+            memcpy(clusters.data(), src, header.mNumClusters * sizeof(LLMeshOptimizer::Cluster));
+            src += decoded_cluster_size(header.mNumClusters);
+
+            for (const LLMeshOptimizer::Cluster& cluster : clusters)
+            {
+                if (cluster.mIndexOffset > (U32)header.mNumIndices
+                    || cluster.mIndexCount > (U32)header.mNumIndices - cluster.mIndexOffset)
+                {
+                    LL_WARNS() << "Decoded face cluster out of range, will unpack the asset again." << LL_ENDL;
+                    return false;
+                }
+            }
+            face.mClusters.swap(clusters);
+        }
+
+        face.mOptimized = (header.mFlags & DECODED_OPTIMIZED) != 0;
+        face.mWeightsScrubbed = (header.mFlags & DECODED_WEIGHTS_SCRUBBED) != 0;
+        face.mNormalizedScale.set(header.mNormalizedScale);
+        face.mTexCoordExtents[0].set(header.mTexCoordExtents[0], header.mTexCoordExtents[1]);
+        face.mTexCoordExtents[1].set(header.mTexCoordExtents[2], header.mTexCoordExtents[3]);
+        face.mExtents[0].loadua(header.mExtents);
+        face.mExtents[1].loadua(header.mExtents + 4);
+        face.mCenter->loadua(header.mCenter);
+    }
+
+    mVolumeFaces.swap(faces);
+    mSculptLevel = 0;  // success!
+
+    return true;
+}
+
 bool LLVolume::isMeshAssetLoaded() const
 {
     return mIsMeshAssetLoaded;
@@ -2755,16 +3080,52 @@ void LLVolume::copyVolumeFaces(const LLVolume* volume)
     mSculptLevel = 0;
 }
 
+void LLVolume::takeVolumeFaces(LLVolume* volume)
+{
+    mVolumeFaces.swap(volume->mVolumeFaces);
+    volume->mVolumeFaces.clear();
+    mSculptLevel = 0;
+}
+
+void LLVolume::swapGeometry(LLVolume* volume)
+{
+    llassert(volume->mParams == mParams && volume->mDetail == mDetail);
+
+    std::swap(mPathp, volume->mPathp);
+    std::swap(mProfilep, volume->mProfilep);
+    std::swap(mMesh.mArray, volume->mMesh.mArray);
+    std::swap(mMesh.mElementCount, volume->mMesh.mElementCount);
+    std::swap(mMesh.mCapacity, volume->mMesh.mCapacity);
+    mVolumeFaces.swap(volume->mVolumeFaces);
+    std::swap(mFaceMask, volume->mFaceMask);
+    std::swap(mSculptLevel, volume->mSculptLevel);
+    std::swap(mSurfaceArea, volume->mSurfaceArea);
+}
+
 bool LLVolume::cacheOptimize(bool gen_tangents)
 {
-    for (S32 i = 0; i < mVolumeFaces.size(); ++i)
+    // Tangent generation and the cache optimization only touch their own
+    // face, so a mesh big enough to be worth it spreads them out.
+    size_t indices = 0;
+    for (const LLVolumeFace& vf : mVolumeFaces)
     {
-        if (!mVolumeFaces[i].cacheOptimize(gen_tangents))
-        {
-            return false;
-        }
+        indices += (size_t)vf.mNumIndices;
     }
-    return true;
+    size_t grain = (indices >= PARALLEL_OPTIMIZE_INDICES)? 1 : mVolumeFaces.size();
+
+    std::atomic<bool> success{ true };
+    LL::parallel_for(size_t(0), mVolumeFaces.size(), grain,
+        [this, gen_tangents, &success](size_t first, size_t last)
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                if (!mVolumeFaces[i].cacheOptimize(gen_tangents))
+                {
+                    success = false;
+                }
+            }
+        });
+    return success;
 }
 
 
@@ -2859,11 +3220,22 @@ void LLVolume::createVolumeFaces()
             }
         }
 
-        for (face_list_t::iterator iter = mVolumeFaces.begin();
-             iter != mVolumeFaces.end(); ++iter)
+        // Faces don't share anything while they build, so once there's
+        // enough geometry to be worth handing out, build them side by side.
+        size_t points = 0;
+        for (const LLVolumeFace& vf : mVolumeFaces)
         {
-            (*iter).create(this, partial_build);
+            points += (size_t)vf.mNumS * vf.mNumT;
         }
+        size_t grain = (points >= PARALLEL_FACE_POINTS)? 1 : mVolumeFaces.size();
+        LL::parallel_for(size_t(0), mVolumeFaces.size(), grain,
+            [this, partial_build](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    mVolumeFaces[i].create(this, partial_build);
+                }
+            });
     }
 }
 
@@ -5044,6 +5416,7 @@ LLVolumeFace& LLVolumeFace::operator=(const LLVolumeFace& src)
     }
 
     mOptimized = src.mOptimized;
+    mClusters = src.mClusters;
     mNormalizedScale = src.mNormalizedScale;
 
     //delete
@@ -5059,10 +5432,28 @@ LLVolumeFace::~LLVolumeFace()
     freeData();
 }
 
+// A face's positions, normals and texture coordinates share one buffer, with
+// the texture coordinate block padded to allow for QWORD reads.
+static size_t vertex_buffer_size(S32 num_verts)
+{
+    return sizeof(LLVector4a) * 2 * num_verts + (((num_verts * sizeof(LLVector2)) + 0xF) & ~0xF);
+}
+
+static LLVector4a* allocate_vertex_buffer(S32 num_verts)
+{
+    return (LLVector4a*)LLHeap::allocate(LLHeap::HEAP_GEOMETRY, vertex_buffer_size(num_verts), 64);
+}
+
+static void free_vertex_buffer(LLVector4a* buffer, S32 num_verts)
+{
+    LLHeap::free(LLHeap::HEAP_GEOMETRY, buffer, vertex_buffer_size(num_verts), 64);
+}
+
 void LLVolumeFace::freeData()
 {
-    ll_aligned_free<64>(mPositions);
+    free_vertex_buffer(mPositions, mNumAllocatedVertices);
     mPositions = NULL;
+    mNumAllocatedVertices = 0;
 
     //normals and texture coordinates are part of the same buffer as mPositions, do not free them separately
     mNormals = NULL;
@@ -5082,6 +5473,8 @@ void LLVolumeFace::freeData()
     mJustWeights = NULL;
 #endif
 
+    mClusters.clear();
+
     destroyOctree();
 }
 
@@ -5172,8 +5565,7 @@ void LLVolumeFace::remap()
     S32 size = ((mNumIndices * sizeof(U16)) + 0xF) & ~0xF;
     U16* remap_indices = (U16*)ll_aligned_malloc_16(size);
 
-    S32 tc_bytes_size = ((remap_vertices_count * sizeof(LLVector2)) + 0xF) & ~0xF;
-    LLVector4a* remap_positions = (LLVector4a*)ll_aligned_malloc<64>(sizeof(LLVector4a) * 2 * remap_vertices_count + tc_bytes_size);
+    LLVector4a* remap_positions = allocate_vertex_buffer(remap_vertices_count);
     LLVector4a* remap_normals = remap_positions + remap_vertices_count;
     LLVector2* remap_tex_coords = (LLVector2*)(remap_normals + remap_vertices_count);
 
@@ -5185,7 +5577,7 @@ void LLVolumeFace::remap()
 
     // Free unused buffers
     ll_aligned_free_16(mIndices);
-    ll_aligned_free<64>(mPositions);
+    free_vertex_buffer(mPositions, mNumAllocatedVertices);
 
     // Tangets are now invalid
     ll_aligned_free_16(mTangents);
@@ -5761,6 +6153,154 @@ bool LLVolumeFace::cacheOptimize(bool gen_tangents)
 
     ll_aligned_free_16(src_indices);
 
+    buildClusters();
+
+    return true;
+}
+
+// Faces with fewer triangles are culled as a whole
+const S32 CLUSTER_MIN_TRIANGLES = 4096;
+// Bigger than the usual meshlet, clusters are culled on the CPU and should
+// stay few: 255 is the most meshoptimizer allows
+const U64 CLUSTER_MAX_VERTICES = 255;
+const U64 CLUSTER_MAX_TRIANGLES = 512;
+
+bool LLVolumeFace::buildClusters()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    mClusters.clear();
+
+    if (mNumIndices / 3 < CLUSTER_MIN_TRIANGLES || !mPositions || !mIndices)
+    {
+        return false;
+    }
+
+    cluster_list_t clusters(LLMeshOptimizer::getMaxClusterCount(mNumIndices, CLUSTER_MAX_VERTICES, CLUSTER_MAX_TRIANGLES));
+
+    // same pointer shuffling as cacheOptimize()
+    U16* src_indices = mIndices;
+    mIndices = nullptr;
+    resizeIndices(mNumIndices);
+    if (!mIndices)
+    {
+        mIndices = src_indices;
+        return false;
+    }
+
+    U64 count = LLMeshOptimizer::buildClustersU16(mIndices, clusters.data(), src_indices, mNumIndices,
+                                                  mPositions, mNumVertices, CLUSTER_MAX_VERTICES, CLUSTER_MAX_TRIANGLES);
+    if (count == 0)
+    {
+        // keep the original order
+        ll_aligned_free_16(mIndices);
+        mIndices = src_indices;
+        return false;
+    }
+
+    ll_aligned_free_16(src_indices);
+
+    clusters.resize(count);
+    mClusters.swap(clusters);
+    return true;
+}
+
+bool LLVolumeFace::simplify(F32 ratio, F32 target_error)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    if (!mPositions || !mIndices || mNumIndices < 3 || ratio <= 0.f || ratio >= 1.f)
+    {
+        return false;
+    }
+
+    U64 target_index_count = llmax((U64)(mNumIndices / 3 * ratio), (U64)1) * 3;
+    std::vector<U16> indices(mNumIndices);
+    U64 index_count = LLMeshOptimizer::simplify(indices.data(), mIndices, mNumIndices,
+                                                mPositions, mNumVertices, sizeof(LLVector4a),
+                                                target_index_count, target_error, false, nullptr);
+    if (index_count == 0 || index_count >= (U64)mNumIndices)
+    {
+        return false;
+    }
+
+    // keep the vertices still in use, in order of first use
+    std::vector<S32> remap(mNumVertices, -1);
+    S32 vertex_count = 0;
+    for (U64 i = 0; i < index_count; ++i)
+    {
+        S32& dst = remap[indices[i]];
+        if (dst < 0)
+        {
+            dst = vertex_count++;
+        }
+    }
+
+    LLVolumeFace face;
+    face.resizeVertices(vertex_count);
+    face.resizeIndices((S32)index_count);
+    if (mTangents)
+    {
+        face.allocateTangents(vertex_count);
+    }
+    if (mWeights)
+    {
+        face.allocateWeights(vertex_count);
+    }
+    if (face.mNumVertices != vertex_count || face.mNumIndices != (S32)index_count
+        || (mTangents && !face.mTangents) || (mWeights && !face.mWeights))
+    {
+        LL_WARNS() << "Failed to allocate " << vertex_count << " vertices for a simplified face" << LL_ENDL;
+        return false;
+    }
+
+    for (S32 i = 0; i < mNumVertices; ++i)
+    {
+        S32 dst = remap[i];
+        if (dst < 0)
+        {
+            continue;
+        }
+        face.mPositions[dst] = mPositions[i];
+        if (mNormals)
+        {
+            face.mNormals[dst] = mNormals[i];
+        }
+        else
+        {
+            face.mNormals[dst].clear();
+        }
+        if (mTexCoords)
+        {
+            face.mTexCoords[dst] = mTexCoords[i];
+        }
+        else
+        {
+            face.mTexCoords[dst].clear();
+        }
+        if (mTangents)
+        {
+            face.mTangents[dst] = mTangents[i];
+        }
+        if (mWeights)
+        {
+            face.mWeights[dst] = mWeights[i];
+        }
+    }
+
+    for (U64 i = 0; i < index_count; ++i)
+    {
+        indices[i] = (U16)remap[indices[i]];
+    }
+    LLMeshOptimizer::optimizeVertexCacheU16(face.mIndices, indices.data(), index_count, vertex_count);
+
+    // the old buffers go away with 'face'
+    swapData(face);
+    llswap(mWeights, face.mWeights);
+    llswap(mNumAllocatedVertices, face.mNumAllocatedVertices);
+    destroyOctree();
+
+    buildClusters();
     return true;
 }
 
@@ -5863,6 +6403,7 @@ void LLVolumeFace::swapData(LLVolumeFace& rhs)
     llswap(rhs.mIndices,mIndices);
     llswap(rhs.mNumVertices, mNumVertices);
     llswap(rhs.mNumIndices, mNumIndices);
+    rhs.mClusters.swap(mClusters);
 }
 
 void    LerpPlanarVertex(LLVolumeFace::VertexData& v0,
@@ -6486,11 +7027,8 @@ void LLVolumeFace::createTangents()
         LLCalculateTangentArray(mNumVertices, mPositions, mNormals, mTexCoords, mNumIndices / 3, mIndices, mTangents);
 
         //normalize normals
-        for (S32 i = 0; i < mNumVertices; i++)
-        {
-            //bump map/planar projection code requires normals to be normalized
-            mNormals[i].normalize3fast();
-        }
+        //bump map/planar projection code requires normals to be normalized
+        LLVector4aBulk::normalize3fast(mNormals, mNumVertices);
     }
 
 }
@@ -6499,7 +7037,7 @@ void LLVolumeFace::resizeVertices(S32 num_verts)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
 
-    ll_aligned_free<64>(mPositions);
+    free_vertex_buffer(mPositions, mNumAllocatedVertices);
     //DO NOT free mNormals and mTexCoords as they are part of mPositions buffer
     ll_aligned_free_16(mTangents);
 
@@ -6507,10 +7045,7 @@ void LLVolumeFace::resizeVertices(S32 num_verts)
 
     if (num_verts)
     {
-        //pad texture coordinate block end to allow for QWORD reads
-        S32 tc_size = ((num_verts*sizeof(LLVector2)) + 0xF) & ~0xF;
-
-        mPositions = (LLVector4a*) ll_aligned_malloc<64>(sizeof(LLVector4a)*2*num_verts+tc_size);
+        mPositions = allocate_vertex_buffer(num_verts);
         mNormals = mPositions+num_verts;
         mTexCoords = (LLVector2*) (mNormals+num_verts);
 
@@ -6554,16 +7089,13 @@ void LLVolumeFace::pushVertex(const LLVector4a& pos, const LLVector4a& norm, con
         // double buffer size on expansion
         new_verts *= 2;
 
-        S32 new_tc_size = ((new_verts*8)+0xF) & ~0xF;
         S32 old_tc_size = ((mNumVertices*8)+0xF) & ~0xF;
 
         S32 old_vsize = mNumVertices*16;
 
-        S32 new_size = new_verts*16*2+new_tc_size;
-
         LLVector4a* old_buf = mPositions;
 
-        mPositions = (LLVector4a*) ll_aligned_malloc<64>(new_size);
+        mPositions = allocate_vertex_buffer(new_verts);
         mNormals = mPositions+new_verts;
         mTexCoords = (LLVector2*) (mNormals+new_verts);
 
@@ -6582,7 +7114,7 @@ void LLVolumeFace::pushVertex(const LLVector4a& pos, const LLVector4a& norm, con
         // just clear tangents
         ll_aligned_free_16(mTangents);
         mTangents = NULL;
-        ll_aligned_free<64>(old_buf);
+        free_vertex_buffer(old_buf, mNumAllocatedVertices);
 
         mNumAllocatedVertices = new_verts;
 
@@ -6624,6 +7156,7 @@ void LLVolumeFace::resizeIndices(S32 num_indices)
     LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
 
     ll_aligned_free_16(mIndices);
+    mClusters.clear();
     llassert(num_indices % 3 == 0);
 
     if (num_indices)
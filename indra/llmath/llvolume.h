@@ -27,6 +27,7 @@
 #ifndef LL_LLVOLUME_H
 #define LL_LLVOLUME_H
 
+#include <atomic>
 #include <iostream>
 
 class LLProfileParams;
@@ -59,6 +60,7 @@ class LLVolumeOctree;
 #include "llfile.h"
 #include "llalignedarray.h"
 #include "llrigginginfo.h"
+#include "llmeshoptimizer.h"
 
 //============================================================================
 
@@ -912,6 +914,15 @@ public:
     void optimize(F32 angle_cutoff = 2.f);
     bool cacheOptimize(bool gen_tangents = false);
 
+    // Reorders the index buffer of a large face into clusters, see mClusters.
+    // Returns false and leaves the face alone if it is too small to bother.
+    bool buildClusters();
+
+    // Reduces the face to about 'ratio' of its triangles with meshoptimizer,
+    // keeping within 'target_error' (relative to the face extents), and
+    // drops the vertices no longer used. Returns false if nothing changed.
+    bool simplify(F32 ratio, F32 target_error);
+
     void createOctree(F32 scaler = 0.25f, const LLVector4a& center = LLVector4a(0,0,0), const LLVector4a& size = LLVector4a(0.5f,0.5f,0.5f));
     void destroyOctree();
     // Get a reference to the octree, which may be null
@@ -990,6 +1001,13 @@ public:
     //whether or not face has been cache optimized
     bool mOptimized;
 
+    // Consecutive ranges of mIndices with their bounds, in volume space.
+    // Only large faces have them, so the renderer can skip the parts of
+    // a face that are out of view or facing away. Cleared whenever the
+    // index buffer is reallocated.
+    typedef std::vector<LLMeshOptimizer::Cluster> cluster_list_t;
+    cluster_list_t mClusters;
+
     // if this is a mesh asset, scale and translation that were applied
     // when encoding the source mesh into a unit cube
     // used for regenerating tangents
@@ -1079,7 +1097,7 @@ public:
     LLFaceID generateFaceMask();
 
     bool isFaceMaskValid(LLFaceID face_mask);
-    static S32 sNumMeshPoints;
+    static std::atomic<S32> sNumMeshPoints; // volumes are also generated off the main thread
 
     friend std::ostream& operator<<(std::ostream &s, const LLVolume &volume);
     friend std::ostream& operator<<(std::ostream &s, const LLVolume *volumep);      // HACK to bypass Windoze confusion over
@@ -1095,6 +1113,12 @@ public:
 
     void sculpt(U16 sculpt_width, U16 sculpt_height, S8 sculpt_components, const U8* sculpt_data, S32 sculpt_level, bool visible_placeholder);
     void copyVolumeFaces(const LLVolume* volume);
+    // Same as copyVolumeFaces(), but moves the faces out of 'volume'
+    void takeVolumeFaces(LLVolume* volume);
+    // Takes over the path, profile, mesh and faces of 'volume', which must
+    // have the same parameters and detail. Lets a volume that is in use be
+    // regenerated elsewhere and swapped in at once.
+    void swapGeometry(LLVolume* volume);
     void copyFacesTo(std::vector<LLVolumeFace> &faces) const;
     void copyFacesFrom(const std::vector<LLVolumeFace> &faces);
 
@@ -1114,6 +1138,14 @@ protected:
 public:
     bool unpackVolumeFaces(std::istream& is, S32 size);
     bool unpackVolumeFaces(U8* in_data, S32 size);
+
+    // Flat, versioned copy of the faces unpackVolumeFaces() produced, laid
+    // out so unpackDecodedFaces() can copy the arrays straight back in
+    // without unzipping or parsing anything.  The copy is only valid for
+    // volumes with the same sculpt ID, sculpt type flags and LOD.
+    bool packDecodedFaces(std::vector<U8>& out) const;
+    bool unpackDecodedFaces(const U8* data, S32 size);
+    static const U32 DECODED_FACES_VERSION;
 private:
     bool unpackVolumeFacesInternal(const LLSD& mdl);
 
@@ -132,6 +132,40 @@ LLVolumeLODGroup* LLVolumeMgr::getGroup( const LLVolumeParams& volume_params ) c
     return volgroupp;
 }
 
+bool LLVolumeMgr::hasVolume(const LLVolumeParams& volume_params, const S32 detail) const
+{
+    if (mDataMutex)
+    {
+        mDataMutex->lock();
+    }
+    volume_lod_group_map_t::const_iterator iter = mVolumeLODGroups.find(&volume_params);
+    bool res = iter != mVolumeLODGroups.end() && iter->second->hasLOD(detail);
+    if (mDataMutex)
+    {
+        mDataMutex->unlock();
+    }
+    return res;
+}
+
+bool LLVolumeMgr::publishVolume(LLVolume* volumep, const S32 detail)
+{
+    if (volumep->isUnique())
+    {
+        return false;
+    }
+    if (mDataMutex)
+    {
+        mDataMutex->lock();
+    }
+    volume_lod_group_map_t::iterator iter = mVolumeLODGroups.find(&volumep->getParams());
+    bool res = iter != mVolumeLODGroups.end() && iter->second->setLOD(detail, volumep);
+    if (mDataMutex)
+    {
+        mDataMutex->unlock();
+    }
+    return res;
+}
+
 void LLVolumeMgr::unrefVolume(LLVolume *volumep)
 {
     if (volumep->isUnique())
@@ -301,6 +335,17 @@ LLVolume* LLVolumeLODGroup::refLOD(const S32 lod)
     return mVolumeLODs[lod];
 }
 
+bool LLVolumeLODGroup::setLOD(const S32 lod, LLVolume* volumep)
+{
+    llassert(lod >=0 && lod < NUM_LODS);
+    if (mVolumeLODs[lod].notNull() || volumep->getDetail() != mDetailScales[lod])
+    {
+        return false;
+    }
+    mVolumeLODs[lod] = volumep;
+    return true;
+}
+
 bool LLVolumeLODGroup::derefLOD(LLVolume *volumep)
 {
     llassert_always(mRefs > 0);
@@ -57,6 +57,9 @@ public:
 
     LLVolume* refLOD(const S32 detail);
     bool derefLOD(LLVolume *volumep);
+    bool hasLOD(const S32 detail) const { return mVolumeLODs[detail].notNull(); }
+    // Installs a volume built elsewhere, unless that LOD exists already
+    bool setLOD(const S32 detail, LLVolume* volumep);
     S32 getNumRefs() const { return mRefs; }
 
     const LLVolumeParams* getVolumeParams() const { return &mVolumeParams; };
@@ -90,6 +93,14 @@ public:
     virtual LLVolume *refVolume(const LLVolumeParams &volume_params, const S32 detail);
     virtual void unrefVolume(LLVolume *volumep);
 
+    // Whether 'detail' of 'volume_params' exists, i.e. refVolume() would not
+    // have to generate it
+    bool hasVolume(const LLVolumeParams& volume_params, const S32 detail) const;
+    // Publishes a volume generated off the main thread as 'detail' of its
+    // parameters. Fails if nothing uses those parameters any more or the
+    // LOD was generated in the meantime.
+    bool publishVolume(LLVolume* volumep, const S32 detail);
+
     void dump();
 
     // manually call this for mutex magic
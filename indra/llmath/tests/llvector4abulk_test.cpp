@@ -0,0 +1,195 @@
+/**
+ * @file llvector4abulk_test.cpp
+ * @brief LLVector4aBulk test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "../test/lltut.h"
+#include "../llmath.h"
+#include "../llmatrix4a.h"
+#include "../llquaternion.h"
+#include "../llvector4abulk.h"
+#include "../v4math.h"
+#include "stringize.h"
+
+#include <vector>
+
+namespace tut
+{
+    struct llvector4abulk_data
+    {
+        static const U32 MAX_COUNT = 37;
+
+        llvector4abulk_data():
+            mOriginalPath(LLVector4aBulk::getPath())
+        {
+            mSrc = (LLVector4a*)ll_aligned_malloc_16(MAX_COUNT * sizeof(LLVector4a));
+            mDst = (LLVector4a*)ll_aligned_malloc_16(MAX_COUNT * sizeof(LLVector4a));
+            mExpected = (LLVector4a*)ll_aligned_malloc_16(MAX_COUNT * sizeof(LLVector4a));
+            for (U32 i = 0; i < MAX_COUNT; ++i)
+            {
+                mSrc[i].set(sin(i * 1.7f) * 10.f, cos(i * 0.3f) * 5.f - 2.f, i * 0.25f - 4.f, i + 0.5f);
+            }
+
+            LLMatrix4 mat(LLQuaternion(0.7f, LLVector3(0.3f, -0.2f, 0.9f)), LLVector4(1.f, -2.f, 3.f, 1.f));
+            mat.mMatrix[0][3] = 0.1f;
+            mat.mMatrix[1][3] = 0.2f;
+            mMat.loadu(mat);
+        }
+
+        ~llvector4abulk_data()
+        {
+            LLVector4aBulk::setPath(mOriginalPath);
+            ll_aligned_free_16(mSrc);
+            ll_aligned_free_16(mDst);
+            ll_aligned_free_16(mExpected);
+        }
+
+        // every path this machine can run
+        std::vector<LLVector4aBulk::EPath> paths() const
+        {
+            std::vector<LLVector4aBulk::EPath> found;
+            for (auto path : { LLVector4aBulk::PATH_SSE2, LLVector4aBulk::PATH_AVX2, LLVector4aBulk::PATH_NEON })
+            {
+                if (LLVector4aBulk::setPath(path))
+                {
+                    found.push_back(path);
+                }
+            }
+            return found;
+        }
+
+        void ensureMatches(const std::string& what, U32 count, F32 tolerance = 1e-5f)
+        {
+            for (U32 i = 0; i < count; ++i)
+            {
+                ensure(STRINGIZE(what << " " << count << " [" << i << "] " << mDst[i] << " vs " << mExpected[i]),
+                       mDst[i].equals4(mExpected[i], tolerance));
+            }
+        }
+
+        LLVector4aBulk::EPath mOriginalPath;
+        LLMatrix4a mMat;
+        LLVector4a* mSrc;
+        LLVector4a* mDst;
+        LLVector4a* mExpected;
+    };
+    typedef test_group<llvector4abulk_data> llvector4abulk_group;
+    typedef llvector4abulk_group::object object;
+    tut::llvector4abulk_group llvector4abulkgrp("LLVector4aBulk");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("transforms match LLMatrix4a");
+        LLVector4Logical w_mask;
+        w_mask.clear();
+        w_mask.setElement<3>();
+        LLVector4a w_vec(0.f, 0.f, 0.f, 7.f);
+
+        for (auto path : paths())
+        {
+            LLVector4aBulk::setPath(path);
+            std::string name = STRINGIZE("path " << path);
+            for (U32 count = 0; count <= MAX_COUNT; ++count)
+            {
+                for (U32 i = 0; i < count; ++i)
+                {
+                    mMat.affineTransform(mSrc[i], mExpected[i]);
+                }
+                LLVector4aBulk::affineTransform(mMat, mSrc, mDst, count);
+                ensureMatches(name + " affine", count);
+
+                for (U32 i = 0; i < count; ++i)
+                {
+                    mExpected[i].setSelectWithMask(w_mask, w_vec, mExpected[i]);
+                }
+                LLVector4aBulk::affineTransform(mMat, mSrc, mDst, count, 7.f);
+                ensureMatches(name + " affine set w", count);
+
+                for (U32 i = 0; i < count; ++i)
+                {
+                    mMat.rotate(mSrc[i], mExpected[i]);
+                }
+                LLVector4aBulk::rotate(mMat, mSrc, mDst, count);
+                ensureMatches(name + " rotate", count);
+
+                for (U32 i = 0; i < count; ++i)
+                {
+                    mExpected[i].setSelectWithMask(w_mask, mSrc[i], mExpected[i]);
+                }
+                LLVector4aBulk::rotate(mMat, mSrc, mDst, count, true);
+                ensureMatches(name + " rotate keep w", count);
+
+                // in place
+                for (U32 i = 0; i < count; ++i)
+                {
+                    mMat.affineTransform(mSrc[i], mExpected[i]);
+                    mDst[i] = mSrc[i];
+                }
+                LLVector4aBulk::affineTransform(mMat, mDst, mDst, count);
+                ensureMatches(name + " affine in place", count);
+            }
+        }
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("min/max and normalize match LLVector4a");
+        for (auto path : paths())
+        {
+            LLVector4aBulk::setPath(path);
+            std::string name = STRINGIZE("path " << path);
+            for (U32 count = 1; count <= MAX_COUNT; ++count)
+            {
+                LLVector4a expected_min(mSrc[0]), expected_max(mSrc[0]);
+                for (U32 i = 1; i < count; ++i)
+                {
+                    expected_min.setMin(expected_min, mSrc[i]);
+                    expected_max.setMax(expected_max, mSrc[i]);
+                }
+                LLVector4a min, max;
+                LLVector4aBulk::getMinMax(mSrc, count, min, max);
+                ensure(STRINGIZE(name << " min " << count), min.equals4(expected_min));
+                ensure(STRINGIZE(name << " max " << count), max.equals4(expected_max));
+
+                for (U32 i = 0; i < count; ++i)
+                {
+                    mExpected[i] = mSrc[i];
+                    mExpected[i].normalize3fast();
+                    mDst[i] = mSrc[i];
+                }
+                LLVector4aBulk::normalize3fast(mDst, count);
+                // the estimates differ between instruction sets
+                ensureMatches(name + " normalize", count, 1e-2f);
+                for (U32 i = 0; i < count; ++i)
+                {
+                    ensure_approximately_equals(STRINGIZE(name << " length " << i),
+                                                mDst[i].getLength3().getF32(), 1.f, 10);
+                }
+            }
+        }
+    }
+}
@@ -31,6 +31,8 @@
 #include "llmath.h"
 #include "v2math.h"
 
+#include <vector>
+
 LLMeshOptimizer::LLMeshOptimizer()
 {
     // Todo: Looks like for memory management, we can add allocator and deallocator callbacks
@@ -339,3 +341,163 @@ U64 LLMeshOptimizer::simplify(U16 *destination,
     }
 }
 
+
+//static
+U64 LLMeshOptimizer::getMaxClusterCount(U64 index_count, U64 max_vertices, U64 max_triangles)
+{
+    return meshopt_buildMeshletsBound(index_count, max_vertices, max_triangles);
+}
+
+//static
+U64 LLMeshOptimizer::buildClustersU16(U16 *destination,
+                                      Cluster *clusters,
+                                      const U16 *indices,
+                                      U64 index_count,
+                                      const LLVector4a *vertex_positions,
+                                      U64 vertex_count,
+                                      U64 max_vertices,
+                                      U64 max_triangles
+    )
+{
+    if (!destination || !clusters || !indices || !vertex_positions || index_count % 3 != 0)
+    {
+        return 0;
+    }
+
+    std::vector<U32> indices_u32(index_count);
+    for (U64 i = 0; i < index_count; i++)
+    {
+        if (indices[i] >= vertex_count)
+        {
+            return 0;
+        }
+        indices_u32[i] = (U32)indices[i];
+    }
+
+    U64 max_meshlets = meshopt_buildMeshletsBound(index_count, max_vertices, max_triangles);
+    std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+    std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
+    std::vector<unsigned char> meshlet_triangles(max_meshlets * max_triangles * 3);
+
+    // a little weight on the cone keeps clusters facing one way, so more
+    // of them can be back face culled
+    const F32 cone_weight = 0.25f;
+    U64 meshlet_count = meshopt_buildMeshlets(meshlets.data(),
+        meshlet_vertices.data(),
+        meshlet_triangles.data(),
+        indices_u32.data(),
+        index_count,
+        vertex_positions->getF32ptr(),
+        vertex_count,
+        sizeof(LLVector4a),
+        max_vertices,
+        max_triangles,
+        cone_weight);
+
+    U32 index_offset = 0;
+    for (U64 i = 0; i < meshlet_count; i++)
+    {
+        const meshopt_Meshlet& meshlet = meshlets[i];
+        const unsigned int* local_vertices = &meshlet_vertices[meshlet.vertex_offset];
+        const unsigned char* local_triangles = &meshlet_triangles[meshlet.triangle_offset];
+
+        Cluster& cluster = clusters[i];
+        cluster.mIndexOffset = index_offset;
+        cluster.mIndexCount = meshlet.triangle_count * 3;
+
+        for (U32 j = 0; j < cluster.mIndexCount; j++)
+        {
+            destination[index_offset++] = (U16)local_vertices[local_triangles[j]];
+        }
+
+        meshopt_Bounds bounds = meshopt_computeMeshletBounds(local_vertices,
+            local_triangles,
+            meshlet.triangle_count,
+            vertex_positions->getF32ptr(),
+            vertex_count,
+            sizeof(LLVector4a));
+
+        for (U32 j = 0; j < 3; j++)
+        {
+            cluster.mCenter[j] = bounds.center[j];
+            cluster.mConeApex[j] = bounds.cone_apex[j];
+            cluster.mConeAxis[j] = bounds.cone_axis[j];
+        }
+        cluster.mRadius = bounds.radius;
+        cluster.mConeCutoff = bounds.cone_cutoff;
+    }
+
+    llassert(meshlet_count == 0 || index_offset == index_count);
+    return meshlet_count;
+}
+
+//static
+bool LLMeshOptimizer::decodeBuffer(void *destination,
+    U64 count,
+    U64 stride,
+    const U8 *buffer,
+    U64 buffer_size,
+    EDecodeMode mode,
+    EDecodeFilter filter)
+{
+    // the decoders assert on strides they can't handle, check up front
+    int result = -1;
+    switch (mode)
+    {
+    case DECODE_ATTRIBUTES:
+        if (stride == 0 || stride % 4 != 0 || stride > 256)
+        {
+            return false;
+        }
+        result = meshopt_decodeVertexBuffer(destination, count, stride, buffer, buffer_size);
+        break;
+    case DECODE_TRIANGLES:
+        if ((stride != 2 && stride != 4) || count % 3 != 0)
+        {
+            return false;
+        }
+        result = meshopt_decodeIndexBuffer(destination, count, stride, buffer, buffer_size);
+        break;
+    case DECODE_INDICES:
+        if (stride != 2 && stride != 4)
+        {
+            return false;
+        }
+        result = meshopt_decodeIndexSequence(destination, count, stride, buffer, buffer_size);
+        break;
+    }
+
+    if (result != 0)
+    {
+        return false;
+    }
+
+    switch (filter)
+    {
+    case FILTER_NONE:
+        break;
+    case FILTER_OCTAHEDRAL:
+        if (mode != DECODE_ATTRIBUTES || (stride != 4 && stride != 8))
+        {
+            return false;
+        }
+        meshopt_decodeFilterOct(destination, count, stride);
+        break;
+    case FILTER_QUATERNION:
+        if (mode != DECODE_ATTRIBUTES || stride != 8)
+        {
+            return false;
+        }
+        meshopt_decodeFilterQuat(destination, count, stride);
+        break;
+    case FILTER_EXPONENTIAL:
+        if (mode != DECODE_ATTRIBUTES)
+        {
+            return false;
+        }
+        meshopt_decodeFilterExp(destination, count, stride);
+        break;
+    }
+
+    return true;
+}
@@ -150,6 +150,69 @@ public:
         F32 target_error,
         bool sloppy,
         F32* result_error);
+
+    // Clusters (meshlets)
+
+    struct Cluster
+    {
+        U32 mIndexOffset;   // first index of the cluster in the destination buffer
+        U32 mIndexCount;
+        F32 mCenter[3];     // bounding sphere
+        F32 mRadius;
+        // all triangles of the cluster face away from a point p when
+        // dot(normalize(mConeApex - p), mConeAxis) >= mConeCutoff
+        F32 mConeApex[3];
+        F32 mConeAxis[3];
+        F32 mConeCutoff;
+    };
+
+    // Upper bound of the number of clusters buildClustersU16 can return
+    static U64 getMaxClusterCount(U64 index_count, U64 max_vertices, U64 max_triangles);
+
+    // Splits a mesh into clusters of at most max_vertices vertices (255 at
+    // most) and max_triangles triangles (512 at most, multiple of 4) and
+    // writes its indices to destination cluster by cluster.
+    // clusters needs room for getMaxClusterCount() entries.
+    // Returns the amount of clusters, 0 on failure.
+    static U64 buildClustersU16(
+        U16 *destination,
+        Cluster *clusters,
+        const U16 *indices,
+        U64 index_count,
+        const LLVector4a *vertex_positions,
+        U64 vertex_count,
+        U64 max_vertices,
+        U64 max_triangles);
+
+    // How a buffer was encoded, as EXT_meshopt_compression names them
+    enum EDecodeMode
+    {
+        DECODE_ATTRIBUTES,  // meshopt_encodeVertexBuffer
+        DECODE_TRIANGLES,   // meshopt_encodeIndexBuffer
+        DECODE_INDICES      // meshopt_encodeIndexSequence
+    };
+
+    // Filter applied to the attributes after decoding
+    enum EDecodeFilter
+    {
+        FILTER_NONE,
+        FILTER_OCTAHEDRAL,
+        FILTER_QUATERNION,
+        FILTER_EXPONENTIAL
+    };
+
+    // Decodes count elements of stride bytes each from the encoded buffer
+    // into destination, which needs room for count * stride bytes.
+    // Returns false if the stride doesn't suit the mode or filter, or if
+    // buffer is malformed.
+    static bool decodeBuffer(
+        void *destination,
+        U64 count,
+        U64 stride,
+        const U8 *buffer,
+        U64 buffer_size,
+        EDecodeMode mode,
+        EDecodeFilter filter);
 private:
 };
 
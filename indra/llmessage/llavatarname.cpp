@@ -124,6 +124,67 @@ void LLAvatarName::fromLLSD(const LLSD& sd)
     }
 }
 
+namespace
+{
+    // Longer than any name the services hand out, anything past it is a
+    // corrupt file
+    const U16 MAX_CACHED_NAME_LENGTH = 1024;
+
+    void write_name_string(std::ostream& ostr, const std::string& str)
+    {
+        U16 length = (U16)llmin(str.size(), (size_t)MAX_CACHED_NAME_LENGTH);
+        ostr.write((const char*)&length, sizeof(length));
+        ostr.write(str.data(), length);
+    }
+
+    bool read_name_string(std::istream& istr, std::string& str)
+    {
+        U16 length = 0;
+        if (!istr.read((char*)&length, sizeof(length)) || length > MAX_CACHED_NAME_LENGTH)
+        {
+            return false;
+        }
+        str.resize(length);
+        return length == 0 || (bool)istr.read(&str[0], length);
+    }
+}
+
+void LLAvatarName::write(std::ostream& ostr) const
+{
+    ostr.write((const char*)&mExpires, sizeof(mExpires));
+    ostr.write((const char*)&mNextUpdate, sizeof(mNextUpdate));
+    U8 is_default = mIsDisplayNameDefault ? 1 : 0;
+    ostr.write((const char*)&is_default, sizeof(is_default));
+    write_name_string(ostr, mUsername);
+    write_name_string(ostr, mDisplayName);
+    write_name_string(ostr, mLegacyFirstName);
+    write_name_string(ostr, mLegacyLastName);
+}
+
+bool LLAvatarName::read(std::istream& istr)
+{
+    U8 is_default = 0;
+    if (!istr.read((char*)&mExpires, sizeof(mExpires))
+        || !istr.read((char*)&mNextUpdate, sizeof(mNextUpdate))
+        || !istr.read((char*)&is_default, sizeof(is_default))
+        || !read_name_string(istr, mUsername)
+        || !read_name_string(istr, mDisplayName)
+        || !read_name_string(istr, mLegacyFirstName)
+        || !read_name_string(istr, mLegacyLastName))
+    {
+        return false;
+    }
+    mIsDisplayNameDefault = is_default != 0;
+    mIsTemporaryName = false;
+
+    // as fromLLSD()
+    if (mDisplayName.empty())
+    {
+        mDisplayName = mUsername;
+    }
+    return true;
+}
+
 // Transform a string (typically provided by the legacy service) into a decent
 // avatar name instance.
 void LLAvatarName::fromString(const std::string& full_name)
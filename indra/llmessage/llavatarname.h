@@ -43,6 +43,11 @@ public:
     LLSD asLLSD() const;
     void fromLLSD(const LLSD& sd);
 
+    // Compact binary form for the cache file, read() returns false on a
+    // truncated or corrupt record
+    void write(std::ostream& ostr) const;
+    bool read(std::istream& istr);
+
     // Used only in legacy mode when the display name capability is not provided server side
     // or to otherwise create a temporary valid item.
     void fromString(const std::string& full_name);
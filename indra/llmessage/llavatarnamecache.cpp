@@ -56,6 +56,11 @@ const F64 TEMP_CACHE_ENTRY_LIFETIME = 60.0;
 // Maximum time an unrefreshed cache entry is allowed.
 const F64 MAX_UNREFRESHED_TIME = 20.0 * 60.0;
 
+// Header of the binary cache file, bump the version whenever
+// LLAvatarName::write() changes
+const char NAME_CACHE_MAGIC[4] = { 'A', 'V', 'N', 'C' };
+const U32 NAME_CACHE_VERSION = 1;
+
 // Send bulk lookup requests a few times a second at most.
 // Only need per-frame timing resolution.
 static LLFrameTimer sRequestTimer;
@@ -109,7 +114,8 @@ LLCore::HttpRequest::policy_t   sHttpPolicy;
 // Do not call directly.  See documentation in lleventcoro.h and llcoro.h for
 // further explanation.
 
-LLAvatarNameCache::LLAvatarNameCache()
+LLAvatarNameCache::LLAvatarNameCache() :
+    mFetch("AvatarNameCache")
 {
     // Will be set to running later
     // For now fail immediate lookups and query async ones.
@@ -125,6 +131,7 @@ LLAvatarNameCache::LLAvatarNameCache()
 
 LLAvatarNameCache::~LLAvatarNameCache()
 {
+    mFetch.logStats();
     sHttpRequest.reset();
     sHttpHeaders.reset();
     sHttpOptions.reset();
@@ -291,7 +298,7 @@ void LLAvatarNameCache::handleAgentError(const LLUUID& agent_id)
         // been returned by the get method, there is no need to signal anyone
 
         // Clear this agent from the pending list
-        LLAvatarNameCache::mPendingQueue.erase(agent_id);
+        mFetch.done(agent_id);
 
         LLAvatarName& av_name = existing->second;
         LL_DEBUGS("AvNameCache") << "LLAvatarNameCache use cache for agent " << agent_id << LL_ENDL;
@@ -322,7 +329,7 @@ void LLAvatarNameCache::processName(const LLUUID& agent_id, const LLAvatarName&
     mCache[agent_id] = av_name;
 
     // Suppress request from the queue
-    mPendingQueue.erase(agent_id);
+    mFetch.done(agent_id);
 
     // notify mute list about changes
     if (updated_account && mAccountNameChangedCallback)
@@ -348,8 +355,6 @@ void LLAvatarNameCache::processName(const LLUUID& agent_id, const LLAvatarName&
 
 void LLAvatarNameCache::requestNamesViaCapability()
 {
-    F64 now = LLFrameTimer::getTotalSeconds();
-
     // URL format is like:
     // http://pdp60.lindenlab.com:8000/agents/?ids=3941037e-78ab-45f0-b421-bd6e77c1804d&ids=0012809d-7d2d-4c24-9609-af1230a37715&ids=0019aaba-24af-4f0a-aa72-6457953cf7f0
     //
@@ -360,17 +365,19 @@ void LLAvatarNameCache::requestNamesViaCapability()
     std::string url;
     url.reserve(NAME_URL_MAX);
 
+    // as many ids as fit in "&ids=<uuid>" each
+    static const size_t ID_URL_LENGTH = 5 + UUID_STR_LENGTH - 1;
+    size_t max_ids = mNameLookupURL.size() < NAME_URL_SEND_THRESHOLD
+        ? (NAME_URL_SEND_THRESHOLD - mNameLookupURL.size()) / ID_URL_LENGTH + 1
+        : 1;
+
     std::vector<LLUUID> agent_ids;
-    agent_ids.reserve(128);
+    agent_ids.reserve(max_ids);
+    mFetch.takeBatch(agent_ids, max_ids);
 
     U32 ids = 0;
-    ask_queue_t::const_iterator it;
-    while(!mAskQueue.empty())
+    for (const LLUUID& agent_id : agent_ids)
     {
-        it = mAskQueue.begin();
-        LLUUID agent_id = *it;
-        mAskQueue.erase(it);
-
         if (url.empty())
         {
             // ...starting new request
@@ -385,15 +392,6 @@ void LLAvatarNameCache::requestNamesViaCapability()
             ids++;
         }
         url += agent_id.asString();
-        agent_ids.push_back(agent_id);
-
-        // mark request as pending
-        mPendingQueue[agent_id] = now;
-
-        if (url.size() > NAME_URL_SEND_THRESHOLD)
-        {
-            break;
-        }
     }
 
     if (!url.empty())
@@ -443,19 +441,12 @@ void LLAvatarNameCache::legacyNameFetch(const LLUUID& agent_id,
 void LLAvatarNameCache::requestNamesViaLegacy()
 {
     static const S32 MAX_REQUESTS = 100;
-    F64 now = LLFrameTimer::getTotalSeconds();
-    std::string full_name;
-    ask_queue_t::const_iterator it;
-    for (S32 requests = 0; !mAskQueue.empty() && requests < MAX_REQUESTS; ++requests)
+    // Marked as pending first, just in case the callback is immediately
+    // invoked below.  This should never happen in practice.
+    std::vector<LLUUID> agent_ids;
+    mFetch.takeBatch(agent_ids, MAX_REQUESTS);
+    for (const LLUUID& agent_id : agent_ids)
     {
-        it = mAskQueue.begin();
-        LLUUID agent_id = *it;
-        mAskQueue.erase(it);
-
-        // Mark as pending first, just in case the callback is immediately
-        // invoked below.  This should never happen in practice.
-        mPendingQueue[agent_id] = now;
-
         LL_DEBUGS("AvNameCache") << "agent " << agent_id << LL_ENDL;
 
         gCacheName->get(agent_id, false,  // legacy compatibility
@@ -465,6 +456,15 @@ void LLAvatarNameCache::requestNamesViaLegacy()
 
 bool LLAvatarNameCache::importFile(std::istream& istr)
 {
+    char magic[sizeof(NAME_CACHE_MAGIC)];
+    if (istr.read(magic, sizeof(magic)) && !memcmp(magic, NAME_CACHE_MAGIC, sizeof(magic)))
+    {
+        return importBinary(istr);
+    }
+
+    // Older viewers stored the cache as LLSD XML
+    istr.clear();
+    istr.seekg(0);
     LLSD data;
     if (LLSDParser::PARSE_FAILURE == LLSDSerialize::fromXMLDocument(data, istr))
     {
@@ -493,27 +493,62 @@ bool LLAvatarNameCache::importFile(std::istream& istr)
     return true;
 }
 
+bool LLAvatarNameCache::importBinary(std::istream& istr)
+{
+    U32 version = 0;
+    U32 count = 0;
+    if (!istr.read((char*)&version, sizeof(version))
+        || version != NAME_CACHE_VERSION
+        || !istr.read((char*)&count, sizeof(count)))
+    {
+        LL_WARNS("AvNameCache") << "avatar name cache has an unknown version " << version << LL_ENDL;
+        return false;
+    }
+
+    LLUUID agent_id;
+    LLAvatarName av_name;
+    for (U32 i = 0; i < count; ++i)
+    {
+        if (!istr.read((char*)agent_id.mData, UUID_BYTES) || !av_name.read(istr))
+        {
+            LL_WARNS("AvNameCache") << "avatar name cache truncated after " << i << " of " << count << " entries" << LL_ENDL;
+            return false;
+        }
+        mCache[agent_id] = av_name;
+    }
+    LL_INFOS("AvNameCache") << "LLAvatarNameCache loaded " << mCache.size() << LL_ENDL;
+    // Expired entries go in the first eraseUnrefreshed(), as for XML
+
+    return true;
+}
+
 void LLAvatarNameCache::exportFile(std::ostream& ostr)
 {
-    LLSD agents;
     F64 max_unrefreshed = LLFrameTimer::getTotalSeconds() - MAX_UNREFRESHED_TIME;
     LL_INFOS("AvNameCache") << "LLAvatarNameCache at exit cache has " << mCache.size() << LL_ENDL;
-    cache_t::const_iterator it = mCache.begin();
-    for ( ; it != mCache.end(); ++it)
+
+    // Do not write temporary or expired entries to the stored cache
+    U32 count = 0;
+    for (const cache_t::value_type& entry : mCache)
     {
-        const LLUUID& agent_id = it->first;
-        const LLAvatarName& av_name = it->second;
-        // Do not write temporary or expired entries to the stored cache
-        if (av_name.isValidName(max_unrefreshed))
+        if (entry.second.isValidName(max_unrefreshed))
         {
-            // key must be a string
-            agents[agent_id.asString()] = av_name.asLLSD();
+            ++count;
         }
     }
-    LL_INFOS("AvNameCache") << "LLAvatarNameCache returning " << agents.size() << LL_ENDL;
-    LLSD data;
-    data["agents"] = agents;
-    LLSDSerialize::toPrettyXML(data, ostr);
+
+    ostr.write(NAME_CACHE_MAGIC, sizeof(NAME_CACHE_MAGIC));
+    ostr.write((const char*)&NAME_CACHE_VERSION, sizeof(NAME_CACHE_VERSION));
+    ostr.write((const char*)&count, sizeof(count));
+    for (const cache_t::value_type& entry : mCache)
+    {
+        if (entry.second.isValidName(max_unrefreshed))
+        {
+            ostr.write((const char*)entry.first.mData, UUID_BYTES);
+            entry.second.write(ostr);
+        }
+    }
+    LL_INFOS("AvNameCache") << "LLAvatarNameCache returning " << count << LL_ENDL;
 }
 
 void LLAvatarNameCache::setNameLookupURL(const std::string& name_lookup_url)
@@ -550,7 +585,7 @@ void LLAvatarNameCache::idle()
         return;
     }
 
-    if (!mAskQueue.empty())
+    if (mFetch.hasQueued())
     {
         if (usePeopleAPI())
         {
@@ -563,7 +598,7 @@ void LLAvatarNameCache::idle()
         }
     }
 
-    if (mAskQueue.empty())
+    if (!mFetch.hasQueued())
     {
         // cleared the list, reset the request timer.
         sRequestTimer.resetWithExpiry(SECS_BETWEEN_REQUESTS);
@@ -575,17 +610,8 @@ void LLAvatarNameCache::idle()
 
 bool LLAvatarNameCache::isRequestPending(const LLUUID& agent_id)
 {
-    bool isPending = false;
-    const F64 PENDING_TIMEOUT_SECS = 5.0 * 60.0;
-
-    pending_queue_t::const_iterator it = mPendingQueue.find(agent_id);
-    if (it != mPendingQueue.end())
-    {
-        // in the list of requests in flight, retry if too old
-        F64 expire_time = LLFrameTimer::getTotalSeconds() - PENDING_TIMEOUT_SECS;
-        isPending = (it->second > expire_time);
-    }
-    return isPending;
+    // in the list of requests in flight, retry if too old
+    return mFetch.isPending(agent_id);
 }
 
 void LLAvatarNameCache::eraseUnrefreshed()
@@ -639,11 +665,10 @@ bool LLAvatarNameCache::getName(const LLUUID& agent_id, LLAvatarName *av_name)
             // re-request name if entry is expired
             if (av_name->mExpires < LLFrameTimer::getTotalSeconds())
             {
-                if (!isRequestPending(agent_id))
+                if (mFetch.request(agent_id))
                 {
                     LL_DEBUGS("AvNameCache") << "LLAvatarNameCache refresh agent " << agent_id
                                              << LL_ENDL;
-                    mAskQueue.insert(agent_id);
                 }
             }
 
@@ -651,10 +676,9 @@ bool LLAvatarNameCache::getName(const LLUUID& agent_id, LLAvatarName *av_name)
         }
     }
 
-    if (!isRequestPending(agent_id))
+    if (mFetch.request(agent_id))
     {
         LL_DEBUGS("AvNameCache") << "LLAvatarNameCache queue request for agent " << agent_id << LL_ENDL;
-        mAskQueue.insert(agent_id);
     }
 
     return false;
@@ -697,10 +721,7 @@ LLAvatarNameCache::callback_connection_t LLAvatarNameCache::getNameCallback(cons
     }
 
     // schedule a request
-    if (!isRequestPending(agent_id))
-    {
-        mAskQueue.insert(agent_id);
-    }
+    mFetch.request(agent_id);
 
     // always store additional callback, even if request is pending
     signal_map_t::iterator sig_it = mSignalMap.find(agent_id);
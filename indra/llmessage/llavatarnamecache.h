@@ -29,6 +29,7 @@
 #define LLAVATARNAMECACHE_H
 
 #include "llavatarname.h"   // for convenience
+#include "llbatchedidfetch.h"
 #include "llsingleton.h"
 #include <boost/signals2.hpp>
 #include <set>
@@ -44,7 +45,8 @@ public:
     typedef boost::signals2::signal<void (void)> use_display_name_signal_t;
     typedef boost::function<void (const LLUUID id, const LLAvatarName& av_name)> account_name_changed_callback_t;
 
-    // Import/export the name cache to file.
+    // Import/export the name cache to file. Exports are binary, streams
+    // should be opened as such. Imports also take the older LLSD XML file.
     bool importFile(std::istream& istr);
     void exportFile(std::ostream& ostr);
 
@@ -113,6 +115,9 @@ private:
 
     void requestNamesViaCapability();
 
+    // Reads the entries of what exportFile() wrote, past the magic
+    bool importBinary(std::istream& istr);
+
     // Legacy name system callbacks
     static void legacyNameCallback(const LLUUID& agent_id,
         const std::string& full_name,
@@ -160,14 +165,9 @@ private:
     // Includes the trailing slash, like "http://pdp60.lindenlab.com:8000/agents/"
     std::string mNameLookupURL;
 
-    // Accumulated agent IDs for next query against service
-    typedef std::set<LLUUID> ask_queue_t;
-    ask_queue_t mAskQueue;
-
-    // Agent IDs that have been requested, but with no reply.
-    // Maps agent ID to frame time request was made.
-    typedef std::map<LLUUID, F64> pending_queue_t;
-    pending_queue_t mPendingQueue;
+    // Agent IDs for the next queries against the service, and the ones
+    // requested with no reply yet
+    LLBatchedIDFetch mFetch;
 
     // Callbacks to fire when we received a name.
     // May have multiple callbacks for a single ID, which are
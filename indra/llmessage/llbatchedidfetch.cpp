@@ -0,0 +1,93 @@
+/**
+ * @file llbatchedidfetch.cpp
+ * @brief Queue of ids waiting to be looked up in batches by a capability,
+ * with the bookkeeping of the ones already asked for.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llbatchedidfetch.h"
+
+#include "llframetimer.h"
+
+LLBatchedIDFetch::LLBatchedIDFetch(const std::string& name, F64 pending_timeout) :
+    mName(name),
+    mPendingTimeout(pending_timeout),
+    mRequested(0),
+    mCoalesced(0),
+    mBatches(0),
+    mSent(0)
+{
+}
+
+bool LLBatchedIDFetch::request(const LLUUID& id)
+{
+    ++mRequested;
+    if (isPending(id) || !mQueue.insert(id).second)
+    {
+        ++mCoalesced;
+        return false;
+    }
+    return true;
+}
+
+bool LLBatchedIDFetch::isPending(const LLUUID& id) const
+{
+    std::map<LLUUID, F64>::const_iterator it = mPending.find(id);
+    return it != mPending.end()
+        && it->second > LLFrameTimer::getTotalSeconds() - mPendingTimeout;
+}
+
+void LLBatchedIDFetch::takeBatch(std::vector<LLUUID>& ids, size_t max_count)
+{
+    F64 now = LLFrameTimer::getTotalSeconds();
+    size_t taken = 0;
+    while (!mQueue.empty() && taken < max_count)
+    {
+        std::set<LLUUID>::iterator it = mQueue.begin();
+        ids.push_back(*it);
+        mPending[*it] = now;
+        mQueue.erase(it);
+        ++taken;
+    }
+    if (taken)
+    {
+        ++mBatches;
+        mSent += taken;
+    }
+}
+
+void LLBatchedIDFetch::done(const LLUUID& id)
+{
+    mPending.erase(id);
+}
+
+void LLBatchedIDFetch::logStats() const
+{
+    LL_INFOS("BatchedFetch") << mName << ": " << mRequested << " lookups, "
+                             << mCoalesced << " coalesced, "
+                             << mSent << " ids sent in " << mBatches << " batches, "
+                             << mQueue.size() << " queued, "
+                             << mPending.size() << " in flight" << LL_ENDL;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file llbatchedidfetch.h
+ * @brief Queue of ids waiting to be looked up in batches by a capability,
+ * with the bookkeeping of the ones already asked for.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLBATCHEDIDFETCH_H
+#define LL_LLBATCHEDIDFETCH_H
+
+#include "lluuid.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+/**
+ * Ids to look up are queued with request(), which ignores the ones already
+ * queued or in flight, so that bursts of lookups for the same id cost one
+ * fetch. The owner drains the queue with takeBatch(), one batch per request
+ * it sends, and reports each answer or failure with done().
+ *
+ * Ids whose answer never came are asked for again once the pending timeout
+ * has passed. How failures are retried is up to the owner, usually through
+ * a short lived placeholder in its cache.
+ */
+class LLBatchedIDFetch
+{
+public:
+    LLBatchedIDFetch(const std::string& name, F64 pending_timeout = 5.0 * 60.0);
+
+    /// Queue id unless it is already queued or in flight, returns false if
+    /// it was
+    bool request(const LLUUID& id);
+    /// In flight, and not for longer than the pending timeout
+    bool isPending(const LLUUID& id) const;
+    bool hasQueued() const { return !mQueue.empty(); }
+
+    /// Move up to max_count queued ids into ids and mark them in flight
+    void takeBatch(std::vector<LLUUID>& ids, size_t max_count);
+    /// The answer for id, or its failure, arrived
+    void done(const LLUUID& id);
+
+    /// Log the counts so far
+    void logStats() const;
+
+private:
+    std::string mName;
+    F64 mPendingTimeout;
+
+    std::set<LLUUID> mQueue;
+    std::map<LLUUID, F64> mPending; // id -> time it was sent
+
+    U64 mRequested;  // request() calls
+    U64 mCoalesced;  // of which were already queued or in flight
+    U64 mBatches;
+    U64 mSent;       // ids sent, refetches of timed out ones included
+};
+
+#endif // LL_LLBATCHEDIDFETCH_H
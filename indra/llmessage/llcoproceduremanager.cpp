@@ -36,6 +36,7 @@
 #include <boost/fiber/buffered_channel.hpp>
 
 #include "llexception.h"
+#include "lltimer.h"
 #include "stringize.h"
 
 //=========================================================================
@@ -47,6 +48,18 @@ static const std::map<std::string, U32> DefaultPoolSizes{
 };
 
 static const U32 DEFAULT_POOL_SIZE = 5;
+static const U32 DEFAULT_POOL_SIZE_MIN = 1;
+
+// The pools start at their configured size and adapt between the minimum and
+// that size once requests come back: each reply under the latency baseline
+// adds 1/limit to the limit (one more slot per limit's worth of replies), a
+// 429/5xx halves it, and replies slower than LATENCY_CONGESTION_FACTOR times
+// the baseline take one slot away. Decreases happen at most once per smoothed
+// latency so one burst of failures only counts once.
+static const F64 LATENCY_SMOOTHING = 0.2;
+static const F64 LATENCY_BASELINE_DRIFT = 0.01;
+static const F64 LATENCY_CONGESTION_FACTOR = 3.0;
+static const F32 CONCURRENCY_WAIT_SECONDS = 0.1f;
 // SL-14399: When we teleport to a brand-new simulator, the coprocedure queue
 // gets absolutely slammed with fetch requests. Make this queue effectively
 // unlimited.
@@ -58,7 +71,7 @@ class LLCoprocedurePool: private boost::noncopyable
 public:
     typedef LLCoprocedureManager::CoProcedure_t CoProcedure_t;
 
-    LLCoprocedurePool(const std::string &name, size_t size);
+    LLCoprocedurePool(const std::string &name, size_t size, size_t min_size);
     ~LLCoprocedurePool();
 
     /// Places the coprocedure on the queue for processing.
@@ -90,6 +103,13 @@ public:
         return static_cast<S32>(countPending() + countActive());
     }
 
+    /// Returns how many coprocedures the pool currently lets run at once.
+    ///
+    inline size_t getConcurrencyLimit() const
+    {
+        return mConcurrencyLimit;
+    }
+
     void close();
 
 private:
@@ -119,6 +139,10 @@ private:
 
     std::string     mPoolName;
     size_t          mPoolSize, mActiveCoprocsCount, mPending;
+    size_t          mMinSize, mConcurrencyLimit, mClaimedCount;
+    size_t          mRepliesSinceIncrease;
+    F64             mSmoothedLatency, mBaseLatency;
+    LLTimer         mDecreaseTimer;
     CoprocQueuePtr  mPendingCoprocs;
     LLTempBoundListener mStatusListener;
 
@@ -129,6 +153,11 @@ private:
 
     void coprocedureInvokerCoro(CoprocQueuePtr pendingCoprocs,
                                 LLCoreHttpUtil::HttpCoroutineAdapter::ptr_t httpAdapter);
+
+    /// Adjusts mConcurrencyLimit after a coprocedure finished in 'latency'
+    /// seconds with 'status' as its last HTTP reply.
+    void updateConcurrency(F64 latency, const LLCore::HttpStatus &status);
+    void decreaseConcurrency(size_t limit);
 };
 
 //=========================================================================
@@ -155,7 +184,9 @@ void LLCoprocedureManager::initializePool(const std::string &poolName)
 
     // Attempt to look up a pool size in the configuration.  If found use that
     std::string keyName = "PoolSize" + poolName;
+    std::string minKeyName = "PoolSizeMin" + poolName;
     int size = 0;
+    int min_size = 0;
 
     LL_ERRS_IF(poolName.empty(), "CoprocedureManager") << "Poolname must not be empty" << LL_ENDL;
     LL_INFOS("CoprocedureManager") << "Initializing pool " << poolName << LL_ENDL;
@@ -180,7 +211,25 @@ void LLCoprocedureManager::initializePool(const std::string &poolName)
         LL_WARNS("CoProcMgr") << "LLCoprocedureManager: No setting for \"" << keyName << "\" setting pool size to default of " << size << LL_ENDL;
     }
 
-    poolPtr_t pool(new LLCoprocedurePool(poolName, size));
+    // The pool size is the most the pool runs at once, the adaptive limit
+    // never goes below this one.
+    if (mPropertyQueryFn)
+    {
+        min_size = mPropertyQueryFn(minKeyName);
+    }
+
+    if (min_size == 0)
+    {
+        min_size = DEFAULT_POOL_SIZE_MIN;
+
+        if (mPropertyDefineFn)
+        {
+            mPropertyDefineFn(minKeyName, min_size, "Lowest concurrency the coroutine pool " + poolName + " backs off to");
+        }
+    }
+    min_size = llmin(min_size, size);
+
+    poolPtr_t pool(new LLCoprocedurePool(poolName, size, min_size));
     LL_ERRS_IF(!pool, "CoprocedureManager") << "Unable to create pool named \"" << poolName << "\" FATAL!" << LL_ENDL;
 
     bool inserted = mPoolMap.emplace(poolName, pool).second;
@@ -259,6 +308,17 @@ size_t LLCoprocedureManager::countActive(const std::string &pool) const
     return it->second->countActive();
 }
 
+size_t LLCoprocedureManager::getConcurrencyLimit(const std::string &pool) const
+{
+    poolMap_t::const_iterator it = mPoolMap.find(pool);
+
+    if (it == mPoolMap.end())
+    {
+        return 0;
+    }
+    return it->second->getConcurrencyLimit();
+}
+
 size_t LLCoprocedureManager::count() const
 {
     size_t count = 0;
@@ -296,11 +356,18 @@ void LLCoprocedureManager::close(const std::string &pool)
 }
 
 //=========================================================================
-LLCoprocedurePool::LLCoprocedurePool(const std::string &poolName, size_t size):
+LLCoprocedurePool::LLCoprocedurePool(const std::string &poolName, size_t size, size_t min_size):
     mPoolName(poolName),
     mPoolSize(size),
     mActiveCoprocsCount(0),
     mPending(0),
+    mMinSize(min_size),
+    mConcurrencyLimit(size),
+    mClaimedCount(0),
+    mRepliesSinceIncrease(0),
+    mSmoothedLatency(0.0),
+    mBaseLatency(0.0),
+    mDecreaseTimer(),
     mPendingCoprocs(std::make_shared<CoprocQueue_t>(LLCoprocedureManager::DEFAULT_QUEUE_SIZE)),
     mHTTPPolicy(LLCore::HttpRequest::DEFAULT_POLICY_ID),
     mCoroMapping()
@@ -347,7 +414,7 @@ LLCoprocedurePool::LLCoprocedurePool(const std::string &poolName, size_t size):
         mCoroMapping.insert(CoroAdapterMap_t::value_type(pooledCoro, httpAdapter));
     }
 
-    LL_INFOS("CoProcMgr") << "Created coprocedure pool named \"" << mPoolName << "\" with " << size << " items, queue max " << LLCoprocedureManager::DEFAULT_QUEUE_SIZE << LL_ENDL;
+    LL_INFOS("CoProcMgr") << "Created coprocedure pool named \"" << mPoolName << "\" with " << size << " items (min " << mMinSize << "), queue max " << LLCoprocedureManager::DEFAULT_QUEUE_SIZE << LL_ENDL;
 }
 
 LLCoprocedurePool::~LLCoprocedurePool()
@@ -405,6 +472,21 @@ void LLCoprocedurePool::coprocedureInvokerCoro(
 {
     for (;;)
     {
+        if (pendingCoprocs->is_closed())
+        {
+            break;
+        }
+
+        // Each invoker claims a slot before waiting for work, so no more
+        // than mConcurrencyLimit of them take coprocedures off the queue.
+        if (mClaimedCount >= mConcurrencyLimit)
+        {
+            LLCoros::TempStatus st("waiting for a concurrency slot");
+            llcoro::suspendUntilTimeout(CONCURRENCY_WAIT_SECONDS);
+            continue;
+        }
+        ++mClaimedCount;
+
         // It is VERY IMPORTANT that we instantiate a new ptr_t just before
         // the pop_wait_for() call below. When this ptr_t was declared at
         // function scope (outside the for loop), NickyD correctly diagnosed a
@@ -430,11 +512,13 @@ void LLCoprocedurePool::coprocedureInvokerCoro(
         }
         if (status == boost::fibers::channel_op_status::closed)
         {
+            --mClaimedCount;
             break;
         }
 
         if(status == boost::fibers::channel_op_status::timeout)
         {
+            --mClaimedCount;
             LL_DEBUGS_ONCE("CoProcMgr") << "pool '" << mPoolName << "' waiting." << LL_ENDL;
             continue;
         }
@@ -444,6 +528,8 @@ void LLCoprocedurePool::coprocedureInvokerCoro(
 
         LL_DEBUGS("CoProcMgr") << "Dequeued and invoking coprocedure(" << coproc->mName << ") with id=" << coproc->mId.asString() << " in pool \"" << mPoolName << "\" (" << mPending << " left)" << LL_ENDL;
 
+        LLTimer timer;
+        httpAdapter->clearLastStatus();
         try
         {
             coproc->mProc(httpAdapter, coproc->mId);
@@ -461,13 +547,70 @@ void LLCoprocedurePool::coprocedureInvokerCoro(
                                               << ") in pool '" << mPoolName << "'"));
             // must NOT omit this or we deplete the pool
             mActiveCoprocsCount--;
+            --mClaimedCount;
             continue;
         }
 
         LL_DEBUGS("CoProcMgr") << "Finished coprocedure(" << coproc->mName << ")" << " in pool \"" << mPoolName << "\"" << LL_ENDL;
 
+        updateConcurrency(timer.getElapsedTimeF64(), httpAdapter->getLastStatus());
+
         mActiveCoprocsCount--;
+        --mClaimedCount;
+    }
+}
+
+void LLCoprocedurePool::updateConcurrency(F64 latency, const LLCore::HttpStatus &status)
+{
+    if (mMinSize >= mPoolSize)
+    {
+        // fixed size pool (AIS has to stay serialized)
+        return;
+    }
+
+    // the server telling us to slow down, or failing under the load
+    if (status.isHttpStatus() && (status.getType() == 429 || (status.getType() >= 500 && status.getType() <= 599)))
+    {
+        decreaseConcurrency(mConcurrencyLimit / 2);
+        return;
+    }
+
+    mSmoothedLatency = (mSmoothedLatency > 0.0) ? mSmoothedLatency + (latency - mSmoothedLatency) * LATENCY_SMOOTHING : latency;
+    if (mBaseLatency <= 0.0 || mSmoothedLatency < mBaseLatency)
+    {
+        mBaseLatency = mSmoothedLatency;
     }
+    else
+    {
+        // creep up so a link that got slower for good becomes the new baseline
+        mBaseLatency += (mSmoothedLatency - mBaseLatency) * LATENCY_BASELINE_DRIFT;
+    }
+
+    if (mSmoothedLatency > mBaseLatency * LATENCY_CONGESTION_FACTOR)
+    {
+        decreaseConcurrency(mConcurrencyLimit - 1);
+    }
+    else if (mConcurrencyLimit < mPoolSize && ++mRepliesSinceIncrease >= mConcurrencyLimit)
+    {
+        mRepliesSinceIncrease = 0;
+        ++mConcurrencyLimit;
+        LL_DEBUGS("CoProcMgr") << "Pool \"" << mPoolName << "\" concurrency raised to " << mConcurrencyLimit << LL_ENDL;
+    }
+}
+
+void LLCoprocedurePool::decreaseConcurrency(size_t limit)
+{
+    mRepliesSinceIncrease = 0;
+    limit = llmax(limit, mMinSize);
+    if (limit >= mConcurrencyLimit || mDecreaseTimer.getElapsedTimeF64() < mSmoothedLatency)
+    {
+        return;
+    }
+
+    mConcurrencyLimit = limit;
+    mDecreaseTimer.reset();
+    LL_INFOS("CoProcMgr") << "Pool \"" << mPoolName << "\" concurrency lowered to " << mConcurrencyLimit
+                          << " (" << mPending << " pending)" << LL_ENDL;
 }
 
 void LLCoprocedurePool::close()
@@ -71,6 +71,11 @@ public:
     size_t countActive() const;
     size_t countActive(const std::string &pool) const;
 
+    /// Returns how many coprocedures the pool currently runs at once. The
+    /// pool adapts it between the "PoolSizeMin" and "PoolSize" settings.
+    ///
+    size_t getConcurrencyLimit(const std::string &pool) const;
+
     /// Returns the total number of coprocedures either queued or in active processing.
     ///
     size_t count() const;
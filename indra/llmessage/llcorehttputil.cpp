@@ -30,6 +30,8 @@
 #include <sstream>
 #include <algorithm>
 #include <iterator>
+#include <optional>
+#include <set>
 #include "llcorehttputil.h"
 #include "llhttpconstants.h"
 #include "llsd.h"
@@ -47,6 +49,8 @@ namespace LLCoreHttpUtil
 {
 
 const F32 HTTP_REQUEST_EXPIRY_SECS = 60.0f;
+// replies at least this big are parsed into the LLSD arena
+const size_t LLSD_ARENA_MIN_BODY_SIZE = 64 * 1024;
 
 namespace
 {
@@ -105,9 +109,15 @@ private:
 
 
 //=========================================================================
-// *TODO:  Currently converts only from XML content.  A mode
-// to convert using fromBinary() might be useful as well.  Mesh
-// headers could use it.
+// The body is parsed as binary LLSD when the server says so in its
+// content type, as XML otherwise. Either parser reads the BufferArray
+// in place.
+static bool isBinaryLLSD(const std::string & content_type)
+{
+    // may be followed by parameters
+    return content_type.compare(0, HTTP_CONTENT_LLSD_BINARY.size(), HTTP_CONTENT_LLSD_BINARY) == 0;
+}
+
 bool responseToLLSD(HttpResponse * response, bool log, LLSD & out_llsd)
 {
     // Convert response to LLSD
@@ -119,7 +129,33 @@ bool responseToLLSD(HttpResponse * response, bool log, LLSD & out_llsd)
 
     LLCore::BufferArrayStream bas(body);
     LLSD body_llsd;
-    S32 parse_status(LLSDSerialize::fromXML(body_llsd, bas, log));
+    // Big replies cost more in allocations than in parsing, small ones aren't
+    // worth pinning a block of the arena with whatever the caller keeps.
+    std::optional<LLSD::ArenaScope> arena;
+    if (body->size() >= LLSD_ARENA_MIN_BODY_SIZE)
+    {
+        arena.emplace();
+    }
+    S32 parse_status;
+    if (isBinaryLLSD(response->getContentType()))
+    {
+        parse_status = LLSDSerialize::fromBinary(body_llsd, bas, body->size());
+    }
+    else
+    {
+        // XML parses much faster from memory than through the stream, and a
+        // copy of a body spanning several blocks is cheap in comparison.
+        std::string contents;
+        size_t len = body->size();
+        const char* xml = body->contiguous(0, len);
+        if (!xml)
+        {
+            contents.resize(len);
+            len = body->read(0, contents.data(), len);
+            xml = contents.data();
+        }
+        parse_status = LLSDSerialize::fromXML(body_llsd, xml, len, log);
+    }
     if (LLSDParser::PARSE_FAILURE == parse_status){
         return false;
     }
@@ -249,8 +285,52 @@ std::string responseToString(LLCore::HttpResponse * response)
 
 //========================================================================
 
+HttpCancelScope::HttpCancelScope() :
+    mCanceled(false)
+{
+}
+
+void HttpCancelScope::cancel()
+{
+    mCanceled = true;
+
+    pending_map_t pending;
+    pending.swap(mPending);
+    for (pending_map_t::value_type &entry : pending)
+    {
+        LLCore::HttpRequest::ptr_t request = entry.second.lock();
+        if (request)
+        {
+            // The canceled request still replies to its own handler
+            request->requestCancel(entry.first, LLCore::HttpHandler::ptr_t());
+        }
+    }
+
+    if (!pending.empty())
+    {
+        LL_INFOS("CoreHTTP") << "Canceled " << pending.size() << " pending requests" << LL_ENDL;
+    }
+}
+
+void HttpCancelScope::add(LLCore::HttpHandle handle, const LLCore::HttpRequest::ptr_t &request)
+{
+    mPending[handle] = request;
+}
+
+void HttpCancelScope::remove(LLCore::HttpHandle handle)
+{
+    mPending.erase(handle);
+}
+
+//========================================================================
+
 HttpCoroHandler::HttpCoroHandler(LLEventStream &reply) :
-    mReplyPump(reply)
+    mReplyPump(&reply)
+{
+}
+
+HttpCoroHandler::HttpCoroHandler() :
+    mReplyPump(NULL)
 {
 }
 
@@ -318,7 +398,20 @@ void HttpCoroHandler::onCompleted(LLCore::HttpHandle handle, LLCore::HttpRespons
         }
     }
 
-    mReplyPump.post(result);
+    HttpCancelScope::ptr_t scope = mCancelScope.lock();
+    if (scope)
+    {
+        scope->remove(handle);
+    }
+
+    if (mReplyPump)
+    {
+        mReplyPump->post(result);
+    }
+    else
+    {
+        mPromise.set_value(result);
+    }
 }
 
 void HttpCoroHandler::buildStatusEntry(LLCore::HttpResponse *response, LLCore::HttpStatus status, LLSD &result)
@@ -379,6 +472,9 @@ class HttpCoroLLSDHandler : public HttpCoroHandler
 {
 public:
     HttpCoroLLSDHandler(LLEventStream &reply);
+    HttpCoroLLSDHandler();
+
+    virtual bool acceptsBinaryLLSD() const { return true; }
 
 protected:
     virtual LLSD handleSuccess(LLCore::HttpResponse * response, LLCore::HttpStatus &status);
@@ -391,6 +487,11 @@ HttpCoroLLSDHandler::HttpCoroLLSDHandler(LLEventStream &reply):
 {
 }
 
+HttpCoroLLSDHandler::HttpCoroLLSDHandler():
+    HttpCoroHandler()
+{
+}
+
 
 LLSD HttpCoroLLSDHandler::handleSuccess(LLCore::HttpResponse * response, LLCore::HttpStatus &status)
 {
@@ -426,11 +527,11 @@ LLSD HttpCoroLLSDHandler::handleSuccess(LLCore::HttpResponse * response, LLCore:
     if (!success)
     {
 #if 1
-        // Only emit a warning if we failed to parse when 'content-type' == 'application/llsd+xml'
+        // Only emit a warning if we failed to parse when 'content-type' == 'application/llsd+xml' or 'application/llsd+binary'
         LLCore::HttpHeaders::ptr_t headers(response->getHeaders());
         const std::string *contentType = (headers) ? headers->find(HTTP_IN_HEADER_CONTENT_TYPE) : NULL;
 
-        if (contentType && (HTTP_CONTENT_LLSD_XML == *contentType))
+        if (contentType && (HTTP_CONTENT_LLSD_XML == *contentType || isBinaryLLSD(*contentType)))
         {
             std::string thebody = LLCoreHttpUtil::responseToString(response);
             LL_WARNS("CoreHTTP") << "Failed to deserialize . " << response->getRequestURL() << " [status:" << response->getStatus().toString() << "] "
@@ -518,10 +619,9 @@ LLSD HttpCoroRawHandler::handleSuccess(LLCore::HttpResponse * response, LLCore::
     //
     // *TODO: https://jira.secondlife.com/browse/MAINT-5221
 
-    LLSD::Binary data;
-    data.reserve(size);
-    bas >> std::noskipws;
-    data.assign(std::istream_iterator<U8>(bas), std::istream_iterator<U8>());
+    // straight out of the buffer, not byte by byte through the stream
+    LLSD::Binary data(size);
+    data.resize(body->read(0, data.data(), size));
 
     result[HttpCoroutineAdapter::HTTP_RESULTS_RAW] = std::move(data);
 
@@ -648,6 +748,8 @@ bool HttpRequestPumper::pollRequest(const LLSD&)
 }
 
 //========================================================================
+bool HttpCoroutineAdapter::sPreferBinaryLLSD(false);
+
 const std::string HttpCoroutineAdapter::HTTP_RESULTS("http_result");
 const std::string HttpCoroutineAdapter::HTTP_RESULTS_SUCCESS("success");
 const std::string HttpCoroutineAdapter::HTTP_RESULTS_TYPE("type");
@@ -690,7 +792,7 @@ LLSD HttpCoroutineAdapter::postAndSuspend_(LLCore::HttpRequest::ptr_t &request,
 {
     HttpRequestPumper pumper(request);
 
-    checkDefaultHeaders(headers);
+    checkDefaultHeaders(headers, handler);
 
     // The HTTPCoroHandler does not self delete, so retrieval of a the contained
     // pointer from the smart pointer is safe in this case.
@@ -706,6 +808,7 @@ LLSD HttpCoroutineAdapter::postAndSuspend_(LLCore::HttpRequest::ptr_t &request,
     saveState(hhandle, request, handler);
     LLSD results = llcoro::suspendUntilEventOn(handler->getReplyPump());
     cleanState();
+    mLastStatus = getStatusFromLLSD(results[HTTP_RESULTS]);
 
     return results;
 }
@@ -814,7 +917,7 @@ LLSD HttpCoroutineAdapter::postAndSuspend_(LLCore::HttpRequest::ptr_t &request,
 {
     HttpRequestPumper pumper(request);
 
-    checkDefaultHeaders(headers);
+    checkDefaultHeaders(headers, handler);
 
     // The HTTPCoroHandler does not self delete, so retrieval of a the contained
     // pointer from the smart pointer is safe in this case.
@@ -829,6 +932,7 @@ LLSD HttpCoroutineAdapter::postAndSuspend_(LLCore::HttpRequest::ptr_t &request,
     saveState(hhandle, request, handler);
     LLSD results = llcoro::suspendUntilEventOn(handler->getReplyPump());
     cleanState();
+    mLastStatus = getStatusFromLLSD(results[HTTP_RESULTS]);
 
     return results;
 }
@@ -871,7 +975,7 @@ LLSD HttpCoroutineAdapter::putAndSuspend_(LLCore::HttpRequest::ptr_t &request,
 {
     HttpRequestPumper pumper(request);
 
-    checkDefaultHeaders(headers);
+    checkDefaultHeaders(headers, handler);
 
     // The HTTPCoroHandler does not self delete, so retrieval of a the contained
     // pointer from the smart pointer is safe in this case.
@@ -887,6 +991,7 @@ LLSD HttpCoroutineAdapter::putAndSuspend_(LLCore::HttpRequest::ptr_t &request,
     saveState(hhandle, request, handler);
     LLSD results = llcoro::suspendUntilEventOn(handler->getReplyPump());
     cleanState();
+    mLastStatus = getStatusFromLLSD(results[HTTP_RESULTS]);
 
     return results;
 }
@@ -898,7 +1003,7 @@ LLSD HttpCoroutineAdapter::putAndSuspend_(LLCore::HttpRequest::ptr_t &request,
 {
     HttpRequestPumper pumper(request);
 
-    checkDefaultHeaders(headers);
+    checkDefaultHeaders(headers, handler);
 
     // The HTTPCoroHandler does not self delete, so retrieval of a the contained
     // pointer from the smart pointer is safe in this case.
@@ -913,6 +1018,7 @@ LLSD HttpCoroutineAdapter::putAndSuspend_(LLCore::HttpRequest::ptr_t &request,
     saveState(hhandle, request, handler);
     LLSD results = llcoro::suspendUntilEventOn(handler->getReplyPump());
     cleanState();
+    mLastStatus = getStatusFromLLSD(results[HTTP_RESULTS]);
 
     return results;
 }
@@ -954,7 +1060,7 @@ LLSD HttpCoroutineAdapter::getAndSuspend_(LLCore::HttpRequest::ptr_t &request,
     HttpCoroHandler::ptr_t &handler)
 {
     HttpRequestPumper pumper(request);
-    checkDefaultHeaders(headers);
+    checkDefaultHeaders(headers, handler);
 
     // The HTTPCoroHandler does not self delete, so retrieval of a the contained
     // pointer from the smart pointer is safe in this case.
@@ -969,6 +1075,7 @@ LLSD HttpCoroutineAdapter::getAndSuspend_(LLCore::HttpRequest::ptr_t &request,
     saveState(hhandle, request, handler);
     LLSD results = llcoro::suspendUntilEventOn(handler->getReplyPump());
     cleanState();
+    mLastStatus = getStatusFromLLSD(results[HTTP_RESULTS]);
 
     return results;
 }
@@ -1001,7 +1108,7 @@ LLSD HttpCoroutineAdapter::deleteAndSuspend_(LLCore::HttpRequest::ptr_t &request
 {
     HttpRequestPumper pumper(request);
 
-    checkDefaultHeaders(headers);
+    checkDefaultHeaders(headers, handler);
     // The HTTPCoroHandler does not self delete, so retrieval of a the contained
     // pointer from the smart pointer is safe in this case.
     LLCore::HttpHandle hhandle = request->requestDelete(mPolicyId,
@@ -1015,6 +1122,7 @@ LLSD HttpCoroutineAdapter::deleteAndSuspend_(LLCore::HttpRequest::ptr_t &request
     saveState(hhandle, request, handler);
     LLSD results = llcoro::suspendUntilEventOn(handler->getReplyPump());
     cleanState();
+    mLastStatus = getStatusFromLLSD(results[HTTP_RESULTS]);
 
     return results;
 }
@@ -1037,7 +1145,7 @@ LLSD HttpCoroutineAdapter::patchAndSuspend_(LLCore::HttpRequest::ptr_t &request,
 {
     HttpRequestPumper pumper(request);
 
-    checkDefaultHeaders(headers);
+    checkDefaultHeaders(headers, handler);
 
     // The HTTPCoroHandler does not self delete, so retrieval of a the contained
     // pointer from the smart pointer is safe in this case.
@@ -1053,6 +1161,7 @@ LLSD HttpCoroutineAdapter::patchAndSuspend_(LLCore::HttpRequest::ptr_t &request,
     saveState(hhandle, request, handler);
     LLSD results = llcoro::suspendUntilEventOn(handler->getReplyPump());
     cleanState();
+    mLastStatus = getStatusFromLLSD(results[HTTP_RESULTS]);
 
     return results;
 }
@@ -1079,7 +1188,7 @@ LLSD HttpCoroutineAdapter::copyAndSuspend_(LLCore::HttpRequest::ptr_t &request,
 {
     HttpRequestPumper pumper(request);
 
-    checkDefaultHeaders(headers);
+    checkDefaultHeaders(headers, handler);
 
     // The HTTPCoroHandler does not self delete, so retrieval of a the contained
     // pointer from the smart pointer is safe in this case.
@@ -1095,6 +1204,7 @@ LLSD HttpCoroutineAdapter::copyAndSuspend_(LLCore::HttpRequest::ptr_t &request,
     saveState(hhandle, request, handler);
     LLSD results = llcoro::suspendUntilEventOn(handler->getReplyPump());
     cleanState();
+    mLastStatus = getStatusFromLLSD(results[HTTP_RESULTS]);
 
     return results;
 }
@@ -1121,7 +1231,7 @@ LLSD HttpCoroutineAdapter::moveAndSuspend_(LLCore::HttpRequest::ptr_t &request,
 {
     HttpRequestPumper pumper(request);
 
-    checkDefaultHeaders(headers);
+    checkDefaultHeaders(headers, handler);
 
     // The HTTPCoroHandler does not self delete, so retrieval of a the contained
     // pointer from the smart pointer is safe in this case.
@@ -1137,18 +1247,28 @@ LLSD HttpCoroutineAdapter::moveAndSuspend_(LLCore::HttpRequest::ptr_t &request,
     saveState(hhandle, request, handler);
     LLSD results = llcoro::suspendUntilEventOn(handler->getReplyPump());
     cleanState();
+    mLastStatus = getStatusFromLLSD(results[HTTP_RESULTS]);
 
     return results;
 }
 
 
-void HttpCoroutineAdapter::checkDefaultHeaders(LLCore::HttpHeaders::ptr_t &headers)
+void HttpCoroutineAdapter::checkDefaultHeaders(LLCore::HttpHeaders::ptr_t &headers, const HttpCoroHandler::ptr_t &handler)
 {
     if (!headers)
         headers.reset(new LLCore::HttpHeaders);
     if (!headers->find(HTTP_OUT_HEADER_ACCEPT))
     {
-        headers->append(HTTP_OUT_HEADER_ACCEPT, HTTP_CONTENT_LLSD_XML);
+        if (sPreferBinaryLLSD && handler && handler->acceptsBinaryLLSD())
+        {
+            // servers that know no binary LLSD answer in XML, the reply is parsed by its content type
+            static const std::string accept_llsd(HTTP_CONTENT_LLSD_BINARY + ", " + HTTP_CONTENT_LLSD_XML + ";q=0.5");
+            headers->append(HTTP_OUT_HEADER_ACCEPT, accept_llsd);
+        }
+        else
+        {
+            headers->append(HTTP_OUT_HEADER_ACCEPT, HTTP_CONTENT_LLSD_XML);
+        }
     }
     if (!headers->find(HTTP_OUT_HEADER_CONTENT_TYPE))
     {
@@ -1174,6 +1294,108 @@ void HttpCoroutineAdapter::cancelSuspendedOperation()
     }
 }
 
+HttpCoroutineAdapter::Pending HttpCoroutineAdapter::getAsync(LLCore::HttpRequest::ptr_t request,
+    const std::string & url,
+    LLCore::HttpOptions::ptr_t options, LLCore::HttpHeaders::ptr_t headers,
+    const HttpCancelScope::ptr_t &scope)
+{
+    HttpCoroHandler::ptr_t handler(new HttpCoroLLSDHandler());
+    checkDefaultHeaders(headers, handler);
+
+    LLCore::HttpHandle hhandle(LLCORE_HTTP_HANDLE_INVALID);
+    if (!scope || !scope->isCanceled())
+    {
+        hhandle = request->requestGet(mPolicyId, url, options, headers, handler);
+    }
+
+    return startAsync(request, url, hhandle, handler, scope);
+}
+
+HttpCoroutineAdapter::Pending HttpCoroutineAdapter::postAsync(LLCore::HttpRequest::ptr_t request,
+    const std::string & url, const LLSD & body,
+    LLCore::HttpOptions::ptr_t options, LLCore::HttpHeaders::ptr_t headers,
+    const HttpCancelScope::ptr_t &scope)
+{
+    HttpCoroHandler::ptr_t handler(new HttpCoroLLSDHandler());
+    checkDefaultHeaders(headers, handler);
+
+    LLCore::HttpHandle hhandle(LLCORE_HTTP_HANDLE_INVALID);
+    if (!scope || !scope->isCanceled())
+    {
+        hhandle = requestPostWithLLSD(request, mPolicyId, url, body, options, headers, handler);
+    }
+
+    return startAsync(request, url, hhandle, handler, scope);
+}
+
+HttpCoroutineAdapter::Pending HttpCoroutineAdapter::startAsync(LLCore::HttpRequest::ptr_t &request,
+    const std::string & url, LLCore::HttpHandle hhandle, HttpCoroHandler::ptr_t &handler,
+    const HttpCancelScope::ptr_t &scope)
+{
+    Pending pending;
+    pending.mRequest = request;
+
+    if (scope && scope->isCanceled())
+    {
+        LLSD httpresults = LLSD::emptyMap();
+        HttpCoroHandler::writeStatusCodes(LLCore::HttpStatus(LLCore::HttpStatus::LLCORE, LLCore::HE_OP_CANCELED),
+            url, httpresults);
+        pending.mImmediateResult = LLSD::emptyMap();
+        pending.mImmediateResult[HTTP_RESULTS] = httpresults;
+    }
+    else if (hhandle == LLCORE_HTTP_HANDLE_INVALID)
+    {
+        pending.mImmediateResult = buildImmediateErrorResult(request, url);
+    }
+    else
+    {
+        // Replies are only delivered by request->update() on this thread,
+        // none can arrive before the scope knows the handle
+        if (scope)
+        {
+            handler->setCancelScope(scope);
+            scope->add(hhandle, request);
+        }
+        pending.mFuture = handler->getFuture();
+    }
+
+    return pending;
+}
+
+LLSD HttpCoroutineAdapter::Pending::get()
+{
+    if (!mFuture.valid())
+    {
+        return mImmediateResult;
+    }
+
+    HttpRequestPumper pumper(mRequest);
+    return mFuture.get();
+}
+
+/*static*/
+LLSD HttpCoroutineAdapter::whenAll(std::vector<Pending> &pending)
+{
+    // Pump every request object for the whole wait, collecting the
+    // results one by one then leaves none of them stalled
+    std::vector<std::unique_ptr<HttpRequestPumper> > pumpers;
+    std::set<LLCore::HttpRequest *> pumped;
+    for (Pending &entry : pending)
+    {
+        if (entry.mFuture.valid() && pumped.insert(entry.mRequest.get()).second)
+        {
+            pumpers.emplace_back(new HttpRequestPumper(entry.mRequest));
+        }
+    }
+
+    LLSD results = LLSD::emptyArray();
+    for (Pending &entry : pending)
+    {
+        results.append(entry.mFuture.valid() ? entry.mFuture.get() : entry.mImmediateResult);
+    }
+    return results;
+}
+
 void HttpCoroutineAdapter::saveState(LLCore::HttpHandle yieldingHandle,
     LLCore::HttpRequest::ptr_t &request, HttpCoroHandler::ptr_t &handler)
 {
@@ -28,7 +28,10 @@
 #ifndef LL_LLCOREHTTPUTIL_H
 #define LL_LLCOREHTTPUTIL_H
 
+#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "httpcommon.h"
 #include "httprequest.h"
@@ -73,7 +76,9 @@ extern const F32 HTTP_REQUEST_EXPIRY_SECS;
 /// If there is data but it cannot be successfully parsed,
 /// an error is also returned.  If successfully parsed,
 /// the output LLSD object, out_llsd, is written with the
-/// result and true is returned.
+/// result and true is returned.  Bodies with an
+/// 'application/llsd+binary' content type are parsed as
+/// binary LLSD, all others as XML.
 ///
 /// @arg    response    Response object as returned in
 ///                     in an HttpHandler onCompleted() callback.
@@ -246,10 +251,41 @@ inline LLCore::HttpHandle requestPatchWithLLSD(LLCore::HttpRequest::ptr_t & requ
         url, body, options, headers, handler);
 }
 
+//=========================================================================
+/// A group of requests started by the HttpCoroutineAdapter *Async() methods
+/// that are canceled together, for example the requests that lose their
+/// meaning when the agent teleports away.  The coroutines waiting on them
+/// resume with an HE_OP_CANCELED result.  A canceled scope stays canceled,
+/// requests started in it afterwards fail right away.
+///
+/// Threading:  main thread, like the coroutines using it.
+class HttpCancelScope
+{
+public:
+    typedef std::shared_ptr<HttpCancelScope> ptr_t;
+
+    HttpCancelScope();
+
+    void cancel();
+    bool isCanceled() const { return mCanceled; }
+
+private:
+    friend class HttpCoroHandler;
+    friend class HttpCoroutineAdapter;
+
+    void add(LLCore::HttpHandle handle, const LLCore::HttpRequest::ptr_t &request);
+    void remove(LLCore::HttpHandle handle);
+
+    typedef std::map<LLCore::HttpHandle, LLCore::HttpRequest::wptr_t> pending_map_t;
+    pending_map_t   mPending;
+    bool            mCanceled;
+};
+
 //=========================================================================
 /// The HttpCoroHandler is a specialization of the LLCore::HttpHandler for
 /// interacting with coroutines. When the request is completed the response
-/// will be posted onto the supplied Event Pump.
+/// will be posted onto the supplied Event Pump, or to the future of a
+/// handler constructed without one.
 ///
 /// The LLSD posted back to the coroutine will have the following additions:
 /// llsd["http_result"] -+- ["message"] - An error message returned from the HTTP status
@@ -267,14 +303,29 @@ public:
     typedef std::weak_ptr<HttpCoroHandler>    wptr_t;
 
     HttpCoroHandler(LLEventStream &reply);
+    HttpCoroHandler();
 
     static void writeStatusCodes(LLCore::HttpStatus status, const std::string &url, LLSD &result);
 
     virtual void onCompleted(LLCore::HttpHandle handle, LLCore::HttpResponse * response);
 
+    /// true if the reply may come as binary LLSD, see HttpCoroutineAdapter::setPreferBinaryLLSD()
+    virtual bool acceptsBinaryLLSD() const { return false; }
+
     inline LLEventStream &getReplyPump()
     {
-        return mReplyPump;
+        return *mReplyPump;
+    }
+
+    /// Result of a handler without a reply pump, may be taken once
+    LLCoros::Future<LLSD> getFuture()
+    {
+        return LLCoros::getFuture(mPromise);
+    }
+
+    void setCancelScope(const HttpCancelScope::ptr_t &scope)
+    {
+        mCancelScope = scope;
     }
 
 protected:
@@ -285,7 +336,9 @@ protected:
 private:
     void buildStatusEntry(LLCore::HttpResponse *response, LLCore::HttpStatus status, LLSD &result);
 
-    LLEventStream &mReplyPump;
+    LLEventStream *                 mReplyPump;     // NULL to reply through mPromise
+    LLCoros::Promise<LLSD>          mPromise;
+    std::weak_ptr<HttpCancelScope>  mCancelScope;
 };
 
 //=========================================================================
@@ -304,6 +357,9 @@ private:
 ///     "Accept=application/llsd+xml"
 ///     "X-SecondLife-UDP-Listen-Port=###"
 ///
+/// With setPreferBinaryLLSD(true) the requests that expect LLSD back accept
+/// "application/llsd+binary" ahead of XML instead.
+///
 class HttpCoroutineAdapter
 {
 public:
@@ -323,6 +379,9 @@ public:
     HttpCoroutineAdapter(const std::string &name, LLCore::HttpRequest::policy_t policyId);
     ~HttpCoroutineAdapter();
 
+    /// Ask for binary LLSD replies, which parse much faster than XML.
+    static void setPreferBinaryLLSD(bool prefer) { sPreferBinaryLLSD = prefer; }
+
     /// Execute a Post transaction on the supplied URL and yield execution of
     /// the coroutine until a result is available.
     ///
@@ -578,8 +637,53 @@ public:
     ///
     void cancelSuspendedOperation();
 
+    /// A request started by one of the *Async() methods below.  They return
+    /// as soon as the request is queued, so a coroutine may start many
+    /// requests and then wait for them together with whenAll().  The reply
+    /// is handed straight to the waiting coroutine instead of through an
+    /// event pump.
+    class Pending
+    {
+    public:
+        Pending() {}
+
+        /// Suspends the calling coroutine until the result, decorated as
+        /// for the *AndSuspend() methods, is in.  May be called once.
+        LLSD get();
+
+    private:
+        friend class HttpCoroutineAdapter;
+
+        LLCore::HttpRequest::ptr_t  mRequest;
+        LLCoros::Future<LLSD>       mFuture;
+        LLSD                        mImmediateResult;   // request couldn't be queued
+    };
+
+    /// Start a GET or POST with an LLSD reply, canceled with 'scope' if one
+    /// is given.
+    Pending getAsync(LLCore::HttpRequest::ptr_t request,
+        const std::string & url,
+        LLCore::HttpOptions::ptr_t options = LLCore::HttpOptions::ptr_t(new LLCore::HttpOptions()),
+        LLCore::HttpHeaders::ptr_t headers = LLCore::HttpHeaders::ptr_t(new LLCore::HttpHeaders()),
+        const HttpCancelScope::ptr_t &scope = HttpCancelScope::ptr_t());
+    Pending postAsync(LLCore::HttpRequest::ptr_t request,
+        const std::string & url, const LLSD & body,
+        LLCore::HttpOptions::ptr_t options = LLCore::HttpOptions::ptr_t(new LLCore::HttpOptions()),
+        LLCore::HttpHeaders::ptr_t headers = LLCore::HttpHeaders::ptr_t(new LLCore::HttpHeaders()),
+        const HttpCancelScope::ptr_t &scope = HttpCancelScope::ptr_t());
+
+    /// Suspends until all of the requests are done and returns an LLSD
+    /// array of their results, in order.
+    static LLSD whenAll(std::vector<Pending> &pending);
+
     static LLCore::HttpStatus getStatusFromLLSD(const LLSD &httpResults);
 
+    /// Status of the last reply one of the suspending calls above got.
+    /// Lets the owner of a reused adapter (see LLCoprocedurePool) see how
+    /// the requests made through it went.
+    const LLCore::HttpStatus &getLastStatus() const { return mLastStatus; }
+    void clearLastStatus() { mLastStatus = LLCore::HttpStatus(); }
+
     /// The convenience routines below can be provided with callback functors
     /// which will be invoked in the case of success or failure.  These callbacks
     /// should match this form.
@@ -615,6 +719,10 @@ private:
 
     void saveState(LLCore::HttpHandle yieldingHandle, LLCore::HttpRequest::ptr_t &request,
             HttpCoroHandler::ptr_t &handler);
+
+    Pending startAsync(LLCore::HttpRequest::ptr_t &request, const std::string & url,
+            LLCore::HttpHandle hhandle, HttpCoroHandler::ptr_t &handler,
+            const HttpCancelScope::ptr_t &scope);
     void cleanState();
 
     LLSD postAndSuspend_(LLCore::HttpRequest::ptr_t &request,
@@ -664,7 +772,9 @@ private:
     static void trivialPostCoro(std::string url, LLCore::HttpRequest::policy_t policyId, LLSD postData, completionCallback_t success, completionCallback_t failure);
     static void trivialDelCoro(std::string url, LLCore::HttpRequest::policy_t policyId, completionCallback_t success, completionCallback_t failure);
 
-    void checkDefaultHeaders(LLCore::HttpHeaders::ptr_t &headers);
+    void checkDefaultHeaders(LLCore::HttpHeaders::ptr_t &headers, const HttpCoroHandler::ptr_t &handler);
+
+    static bool                     sPreferBinaryLLSD;
 
     std::string                     mAdapterName;
     LLCore::HttpRequest::policy_t   mPolicyId;
@@ -672,6 +782,7 @@ private:
     LLCore::HttpHandle              mYieldingHandle;
     LLCore::HttpRequest::wptr_t     mWeakRequest;
     HttpCoroHandler::wptr_t         mWeakHandler;
+    LLCore::HttpStatus              mLastStatus;
 };
 
 
@@ -88,7 +88,8 @@ const int LLExperienceCache::SEARCH_PAGE_SIZE     = 30;
 bool LLExperienceCache::sShutdown = false;
 
 //=========================================================================
-LLExperienceCache::LLExperienceCache()
+LLExperienceCache::LLExperienceCache() :
+    mFetch("ExperienceCache")
 {
 }
 
@@ -116,6 +117,8 @@ void LLExperienceCache::initSingleton()
 
 void LLExperienceCache::cleanup()
 {
+    mFetch.logStats();
+
     LL_INFOS("ExperienceCache") << "Saving " << mCacheFileName << LL_ENDL;
 
     llofstream cache_stream(mCacheFileName.c_str());
@@ -226,7 +229,7 @@ void LLExperienceCache::processExperience(const LLUUID& public_key, const LLSD&
 
     if(row.has(EXPERIENCE_ID))
     {
-        mPendingQueue.erase(row[EXPERIENCE_ID].asUUID());
+        mFetch.done(row[EXPERIENCE_ID].asUUID());
     }
 
     //signal
@@ -338,34 +341,36 @@ void LLExperienceCache::requestExperiences()
     urlBase += "id/";
 
 
-    F64 now = LLFrameTimer::getTotalSeconds();
-
     const U32 EXP_URL_SEND_THRESHOLD = 3000;
     const U32 PAGE_SIZE1 = EXP_URL_SEND_THRESHOLD / UUID_STR_LENGTH;
 
-    std::ostringstream ostr;
-    ostr << urlBase << "?page_size=" << PAGE_SIZE1;
-    RequestQueue_t  requests;
+    std::ostringstream base;
+    base << urlBase << "?page_size=" << PAGE_SIZE1;
+    urlBase = base.str();
 
-    while (!mRequestQueue.empty() && !sShutdown)
-    {
-        RequestQueue_t::iterator it = mRequestQueue.begin();
-        LLUUID key = (*it);
-        mRequestQueue.erase(it);
-        requests.insert(key);
+    // as many ids as fit in "&public_id=<uuid>" each
+    const size_t id_url_length = EXPERIENCE_ID.size() + 2 + UUID_STR_LENGTH - 1;
+    const size_t max_ids = urlBase.size() < EXP_URL_SEND_THRESHOLD
+        ? (EXP_URL_SEND_THRESHOLD - urlBase.size()) / id_url_length + 1
+        : 1;
 
-        ostr << "&" << EXPERIENCE_ID << "=" << key.asString();
-        mPendingQueue[key] = now;
-
-        if (mRequestQueue.empty() || (ostr.tellp() > EXP_URL_SEND_THRESHOLD))
-        {   // request is placed in the coprocedure pool for the ExpCache cache.  Throttling is done by the pool itself.
-            LLCoprocedureManager::instance().enqueueCoprocedure("ExpCache", "RequestExperiences",
-                boost::bind(&LLExperienceCache::requestExperiencesCoro, this, _1, ostr.str(), requests) );
+    std::vector<LLUUID> ids;
+    while (mFetch.hasQueued() && !sShutdown)
+    {
+        ids.clear();
+        mFetch.takeBatch(ids, max_ids);
 
-            ostr.str(std::string());
-            ostr << urlBase << "?page_size=" << PAGE_SIZE1;
-            requests.clear();
+        std::ostringstream ostr;
+        ostr << urlBase;
+        for (const LLUUID& key : ids)
+        {
+            ostr << "&" << EXPERIENCE_ID << "=" << key.asString();
         }
+        RequestQueue_t requests(ids.begin(), ids.end());
+
+        // request is placed in the coprocedure pool for the ExpCache cache.  Throttling is done by the pool itself.
+        LLCoprocedureManager::instance().enqueueCoprocedure("ExpCache", "RequestExperiences",
+            boost::bind(&LLExperienceCache::requestExperiencesCoro, this, _1, ostr.str(), requests) );
     }
 
 }
@@ -373,18 +378,7 @@ void LLExperienceCache::requestExperiences()
 
 bool LLExperienceCache::isRequestPending(const LLUUID& public_key)
 {
-    bool isPending = false;
-    const F64 PENDING_TIMEOUT_SECS = 5.0 * 60.0;
-
-    PendingQueue_t::const_iterator it = mPendingQueue.find(public_key);
-
-    if(it != mPendingQueue.end())
-    {
-        F64 expire_time = LLFrameTimer::getTotalSeconds() - PENDING_TIMEOUT_SECS;
-        isPending = (it->second > expire_time);
-    }
-
-    return isPending;
+    return mFetch.isPending(public_key);
 }
 
 void LLExperienceCache::setCapabilityQuery(LLExperienceCache::CapabilityQuery_t queryfn)
@@ -403,7 +397,7 @@ void LLExperienceCache::expirationTimer()
         eraseExpired();
     }
 
-    if (!mRequestQueue.empty())
+    if (mFetch.hasQueued())
     {
         requestExperiences();
     }
@@ -458,11 +452,9 @@ void LLExperienceCache::eraseExpired()
 
 bool LLExperienceCache::fetch(const LLUUID& key, bool refresh/* = true*/)
 {
-    if(!key.isNull() && !isRequestPending(key) && (refresh || mCache.find(key)==mCache.end()))
+    if(!key.isNull() && (refresh || mCache.find(key)==mCache.end()) && mFetch.request(key))
     {
         LL_DEBUGS("ExperienceCache") << " queue request for " << EXPERIENCE_ID << " " << key << LL_ENDL;
-
-        mRequestQueue.insert(key);
         return true;
     }
     return false;
@@ -31,6 +31,7 @@
 
 #include "linden_common.h"
 
+#include "llbatchedidfetch.h"
 #include "llcallbacklist.h" // LL::Timers::handle_t
 #include "llcorehttputil.h"
 #include "llframetimer.h"
@@ -123,7 +124,6 @@ private:
     typedef std::map<LLUUID, LLSD> cache_t;
 
     typedef std::set<LLUUID> RequestQueue_t;
-    typedef std::map<LLUUID, F64> PendingQueue_t;
 
     //--------------------------------------------
     static const std::string PRIVATE_KEY;   // "private_id"
@@ -139,8 +139,7 @@ private:
 //--------------------------------------------
     cache_t         mCache;
     signal_map_t    mSignalMap;
-    RequestQueue_t  mRequestQueue;
-    PendingQueue_t  mPendingQueue;
+    LLBatchedIDFetch mFetch;
 
     LLFrameTimer    mEraseExpiredTimer;    // Periodically clean out expired entries from the cache
     CapabilityQuery_t mCapability;
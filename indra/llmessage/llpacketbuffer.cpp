@@ -34,6 +34,11 @@
 
 ///////////////////////////////////////////////////////////
 
+LLPacketBuffer::LLPacketBuffer() : mSize(0)
+{
+    mData[0] = '!';
+}
+
 LLPacketBuffer::LLPacketBuffer(const LLHost &host, const char *datap, const S32 size) : mHost(host)
 {
     mSize = 0;
@@ -74,3 +79,23 @@ void LLPacketBuffer::init (S32 hSocket)
     mReceivingIF = ::get_receiving_interface();
 }
 
+// static
+S32 LLPacketBuffer::receivePackets(S32 hSocket, LLPacketBuffer* packets, S32 count)
+{
+    LLNetPacket batch[NET_RECEIVE_BATCH];
+    count = llmin(count, NET_RECEIVE_BATCH);
+    for (S32 i = 0; i < count; ++i)
+    {
+        batch[i].mData = packets[i].mData;
+    }
+
+    S32 received = receive_packets(hSocket, batch, count);
+    for (S32 i = 0; i < received; ++i)
+    {
+        LLPacketBuffer& packet = packets[i];
+        packet.mSize = batch[i].mSize;
+        packet.mHost.set(batch[i].mSenderIP, batch[i].mSenderPort);
+        packet.mReceivingIF.set(batch[i].mReceivingIP, INVALID_PORT);
+    }
+    return received;
+}
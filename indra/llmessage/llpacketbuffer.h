@@ -34,10 +34,14 @@
 class LLPacketBuffer
 {
 public:
+    LLPacketBuffer();                      // empty, see receivePackets()
     LLPacketBuffer(const LLHost &host, const char *datap, const S32 size);
     LLPacketBuffer(S32 hSocket);           // receive a packet
     ~LLPacketBuffer();
 
+    // receive up to 'count' waiting packets into consecutive buffers, returns how many arrived
+    static S32 receivePackets(S32 hSocket, LLPacketBuffer* packets, S32 count);
+
     S32         getSize() const                 { return mSize; }
     const char  *getData() const                { return mData; }
     LLHost      getHost() const                 { return mHost; }
@@ -31,6 +31,7 @@
 #if LL_WINDOWS
     #include <winsock2.h>
 #else
+    #include <sys/select.h>
     #include <sys/socket.h>
     #include <netinet/in.h>
 #endif
@@ -43,6 +44,13 @@
 #include "message.h"
 #include "u64.h"
 
+// packets the receive thread holds before it leaves the rest in the socket, a power of two
+const U32 RECEIVE_RING_SIZE = 512;
+// how long the receive thread waits on the socket before it checks whether it should stop
+const S32 RECEIVE_WAIT_MSEC = 100;
+// how long the receive thread waits for the main thread to free a slot of a full ring
+const S32 RECEIVE_RING_FULL_WAIT_MSEC = 1;
+
 ///////////////////////////////////////////////////////////
 LLPacketRing::LLPacketRing () :
     mUseInThrottle(false),
@@ -55,7 +63,10 @@ LLPacketRing::LLPacketRing () :
     mInBufferLength(0),
     mOutBufferLength(0),
     mDropPercentage(0.0f),
-    mPacketsToDrop(0x0)
+    mPacketsToDrop(0x0),
+    mReceiveHead(0),
+    mReceiveTail(0),
+    mReceiveThreadRunning(false)
 {
 }
 
@@ -68,6 +79,8 @@ LLPacketRing::~LLPacketRing ()
 ///////////////////////////////////////////////////////////
 void LLPacketRing::cleanup ()
 {
+    stopReceiveThread();
+
     LLPacketBuffer *packetp;
 
     while (!mReceiveQueue.empty())
@@ -153,6 +166,110 @@ S32 LLPacketRing::receiveFromRing (S32 socket, char *datap)
     return packet_size;
 }
 
+///////////////////////////////////////////////////////////
+void LLPacketRing::startReceiveThread(S32 socket)
+{
+    if (mReceiveThread.joinable())
+    {
+        return;
+    }
+
+    mReceiveSlots.reset(new LLPacketBuffer[RECEIVE_RING_SIZE]);
+    mReceiveHead = 0;
+    mReceiveTail = 0;
+    mReceiveThreadRunning = true;
+    mReceiveThread = std::thread([this, socket]() { receiveLoop(socket); });
+    LL_INFOS("Messaging") << "Started packet receive thread" << LL_ENDL;
+}
+
+void LLPacketRing::stopReceiveThread()
+{
+    if (!mReceiveThread.joinable())
+    {
+        return;
+    }
+
+    mReceiveThreadRunning = false;
+    mReceiveThread.join();
+    mReceiveSlots.reset();
+}
+
+void LLPacketRing::receiveLoop(S32 socket)
+{
+    LL_PROFILER_SET_THREAD_NAME("Packet Receive");
+
+    while (mReceiveThreadRunning)
+    {
+        U32 head = mReceiveHead.load(std::memory_order_relaxed);
+        U32 free_slots = RECEIVE_RING_SIZE - (head - mReceiveTail.load(std::memory_order_acquire));
+        if (!free_slots)
+        {
+            // the main thread is behind, later packets wait in the socket meanwhile
+            std::this_thread::sleep_for(std::chrono::milliseconds(RECEIVE_RING_FULL_WAIT_MSEC));
+            continue;
+        }
+
+        // a batch fills consecutive slots, up to the end of the ring
+        U32 index = head & (RECEIVE_RING_SIZE - 1);
+        S32 count = (S32)llmin(free_slots, RECEIVE_RING_SIZE - index);
+        S32 received = LLPacketBuffer::receivePackets(socket, &mReceiveSlots[index], count);
+        if (received > 0)
+        {
+            mReceiveHead.store(head + received, std::memory_order_release);
+            continue;
+        }
+
+        // drained the socket, it is non blocking, wait for more
+        fd_set read_set;
+        FD_ZERO(&read_set);
+        FD_SET(socket, &read_set);
+        timeval timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_usec = RECEIVE_WAIT_MSEC * 1000;
+        select(socket + 1, &read_set, NULL, NULL, &timeout);
+    }
+}
+
+LLPacketBuffer* LLPacketRing::frontReceived()
+{
+    U32 tail = mReceiveTail.load(std::memory_order_relaxed);
+    if (tail == mReceiveHead.load(std::memory_order_acquire))
+    {
+        return NULL;
+    }
+    return &mReceiveSlots[tail & (RECEIVE_RING_SIZE - 1)];
+}
+
+void LLPacketRing::popReceived()
+{
+    mReceiveTail.store(mReceiveTail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+LLPacketBuffer* LLPacketRing::readPacket(S32 socket)
+{
+    LLPacketBuffer* packetp = NULL;
+    if (mReceiveSlots)
+    {
+        // the delay queue keeps its packets for a while, copy them out of the ring
+        LLPacketBuffer* slotp = frontReceived();
+        if (!slotp)
+        {
+            return NULL;
+        }
+        packetp = new LLPacketBuffer(*slotp);
+        popReceived();
+        return packetp;
+    }
+
+    packetp = new LLPacketBuffer(socket);
+    if (!packetp->getSize())
+    {
+        delete packetp;
+        return NULL;
+    }
+    return packetp;
+}
+
 ///////////////////////////////////////////////////////////
 S32 LLPacketRing::receivePacket (S32 socket, char *datap)
 {
@@ -161,31 +278,30 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
     // If using the throttle, simulate a limited size input buffer.
     if (mUseInThrottle)
     {
-        bool done = false;
-
         // push any current net packet (if any) onto delay ring
-        while (!done)
+        while (true)
         {
-            LLPacketBuffer *packetp;
-            packetp = new LLPacketBuffer(socket);
-
-            if (packetp->getSize())
+            LLPacketBuffer *packetp = readPacket(socket);
+            if (!packetp)
             {
-                mActualBitsIn += packetp->getSize() * 8;
+                // nothing left to read
+                break;
+            }
 
-                // Fake packet loss
-                if (mDropPercentage && (ll_frand(100.f) < mDropPercentage))
-                {
-                    mPacketsToDrop++;
-                }
+            mActualBitsIn += packetp->getSize() * 8;
 
-                if (mPacketsToDrop)
-                {
-                    delete packetp;
-                    packetp = NULL;
-                    packet_size = 0;
-                    mPacketsToDrop--;
-                }
+            // Fake packet loss
+            if (mDropPercentage && (ll_frand(100.f) < mDropPercentage))
+            {
+                mPacketsToDrop++;
+            }
+
+            if (mPacketsToDrop)
+            {
+                delete packetp;
+                packetp = NULL;
+                packet_size = 0;
+                mPacketsToDrop--;
             }
 
             // If we faked packet loss, then we don't have a packet
@@ -199,17 +315,11 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
                     delete packetp;
                     packetp = NULL;
                 }
-                else if (packetp->getSize())
+                else
                 {
                     mReceiveQueue.push(packetp);
                     mInBufferLength += packetp->getSize();
                 }
-                else
-                {
-                    delete packetp;
-                    packetp = NULL;
-                    done = true;
-                }
             }
             else
             {
@@ -223,8 +333,39 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
     }
     else
     {
+        if (mReceiveSlots)
+        {
+            // no delay, take what the receive thread read off the net
+            LLPacketBuffer* packetp = frontReceived();
+            if (packetp)
+            {
+                packet_size = packetp->getSize();
+                mLastSender = packetp->getHost();
+                mLastReceivingIF = packetp->getReceivingInterface();
+
+                if (!LLProxy::isSOCKSProxyEnabled())
+                {
+                    memcpy(datap, packetp->getData(), packet_size);
+                }
+                else if (packet_size > SOCKS_HEADER_SIZE)
+                {
+                    // *FIX We are assuming ATYP is 0x01 (IPv4), not 0x03 (hostname) or 0x04 (IPv6)
+                    memcpy(datap, packetp->getData() + SOCKS_HEADER_SIZE, packet_size - SOCKS_HEADER_SIZE);
+                    const proxywrap_t * header = static_cast<const proxywrap_t*>(static_cast<const void*>(packetp->getData()));
+                    mLastSender.setAddress(header->addr);
+                    mLastSender.setPort(ntohs(header->port));
+
+                    packet_size -= SOCKS_HEADER_SIZE; // The unwrapped packet size
+                }
+                else
+                {
+                    packet_size = 0;
+                }
+                popReceived();
+            }
+        }
         // no delay, pull straight from net
-        if (LLProxy::isSOCKSProxyEnabled())
+        else if (LLProxy::isSOCKSProxyEnabled())
         {
             U8 buffer[NET_BUFFER_SIZE + SOCKS_HEADER_SIZE];
             packet_size = receive_packet(socket, static_cast<char*>(static_cast<void*>(buffer)));
@@ -250,7 +391,10 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
             mLastSender = ::get_sender();
         }
 
-        mLastReceivingIF = ::get_receiving_interface();
+        if (!mReceiveSlots)
+        {
+            mLastReceivingIF = ::get_receiving_interface();
+        }
 
         if (packet_size)  // did we actually get a packet?
         {
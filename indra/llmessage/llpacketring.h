@@ -28,7 +28,10 @@
 #ifndef LL_LLPACKETRING_H
 #define LL_LLPACKETRING_H
 
+#include <atomic>
+#include <memory>
 #include <queue>
+#include <thread>
 
 #include "llhost.h"
 #include "llpacketbuffer.h"
@@ -53,6 +56,14 @@ public:
     S32  receivePacket (S32 socket, char *datap);
     S32  receiveFromRing (S32 socket, char *datap);
 
+    // Read the socket on a thread of its own, receivePacket() then takes the packets
+    // from that thread. Packets no longer wait in the kernel buffer, and get dropped
+    // once it fills up, while the main thread is busy. The thread reads batches of
+    // packets with one system call where the platform allows (see receive_packets()).
+    void startReceiveThread(S32 socket);
+    void stopReceiveThread();
+    bool hasReceiveThread() const               { return mReceiveThread.joinable(); }
+
     bool sendPacket(int h_socket, char * send_buffer, S32 buf_size, LLHost host);
 
     inline LLHost getLastSender();
@@ -85,6 +96,24 @@ protected:
 
 private:
     bool sendPacketImpl(int h_socket, const char * send_buffer, S32 buf_size, LLHost host);
+
+    // the next packet from the receive thread or the socket, NULL if there is none
+    LLPacketBuffer* readPacket(S32 socket);
+    void receiveLoop(S32 socket);
+
+    // the oldest packet the receive thread read, NULL if there is none, popReceived() hands its slot back
+    LLPacketBuffer* frontReceived();
+    void popReceived();
+
+    // Preallocated ring of packets between the receive thread, the only writer of
+    // mReceiveHead, and the main thread, the only writer of mReceiveTail. Both
+    // count packets and only grow, so no lock is needed and nothing is allocated
+    // per packet.
+    std::unique_ptr<LLPacketBuffer[]> mReceiveSlots;
+    std::atomic<U32> mReceiveHead;
+    std::atomic<U32> mReceiveTail;
+    std::thread mReceiveThread;
+    std::atomic<bool> mReceiveThreadRunning;
 };
 
 
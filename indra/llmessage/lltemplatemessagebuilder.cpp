@@ -492,32 +492,63 @@ void LLTemplateMessageBuilder::addUUID(const char *varname, const LLUUID& uuid)
     addData(varname, uuid.mData, MVT_LLUUID, sizeof(uuid.mData));
 }
 
-static S32 zero_code(U8 **data, U32 *data_size)
-{
-    // Encoded send buffer needs to be slightly larger since the zero
-    // coding can potentially increase the size of the send data.
-    static U8 encodedSendBuffer[2 * MAX_BUFFER_SIZE];
-
-    S32 count = *data_size;
-
-    S32 net_gain = 0;
+// sequential zero bytes are encoded as 0 [U8 count]
+// with 0 0 [count] representing wrap (>256 zeroes)
+//
+// The first pass only measures: the size of the encoding, and whether it can
+// be written over the packet itself, which it can as long as no byte is
+// written ahead of the next one still to be read.
+static S32 zero_code_size(const U8* inptr, S32 count, bool& in_place)
+{
+    S32 in = 0;
+    S32 out = 0;
     U8 num_zeroes = 0;
+    in_place = true;
 
-    U8 *inptr = (U8 *)*data;
-    U8 *outptr = (U8 *)encodedSendBuffer;
-
-// skip the packet id field
-
-    for (U32 ii = 0; ii < LL_PACKET_ID_SIZE ; ++ii)
+    for (; in < count; ++in)
     {
-        count--;
-        *outptr++ = *inptr++;
+        if (!inptr[in])   // in a zero count
+        {
+            if (num_zeroes)
+            {
+                if (++num_zeroes > 254)
+                {
+                    in_place = in_place && out <= in;
+                    ++out;
+                    num_zeroes = 0;
+                }
+            }
+            else
+            {
+                in_place = in_place && out <= in;
+                ++out;
+                num_zeroes = 1;
+            }
+        }
+        else
+        {
+            if (num_zeroes)
+            {
+                // the count goes in before this byte is copied
+                in_place = in_place && out < in;
+                ++out;
+                num_zeroes = 0;
+            }
+            in_place = in_place && out <= in;
+            ++out;
+        }
     }
 
-// build encoded packet, keeping track of net size gain
+    if (num_zeroes)
+    {
+        ++out;
+    }
+    return out;
+}
 
-// sequential zero bytes are encoded as 0 [U8 count]
-// with 0 0 [count] representing wrap (>256 zeroes)
+static U8* zero_code_encode(const U8* inptr, S32 count, U8* outptr)
+{
+    U8 num_zeroes = 0;
 
     while (count--)
     {
@@ -530,12 +561,10 @@ static S32 zero_code(U8 **data, U32 *data_size)
                     *outptr++ = num_zeroes;
                     num_zeroes = 0;
                 }
-                net_gain--;   // subseqent zeroes save one
             }
             else
             {
                 *outptr++ = 0;
-                net_gain++;  // starting a zero count adds one
                 num_zeroes = 1;
             }
             inptr++;
@@ -555,6 +584,22 @@ static S32 zero_code(U8 **data, U32 *data_size)
     {
         *outptr++ = num_zeroes;
     }
+    return outptr;
+}
+
+static S32 zero_code(U8 **data, U32 *data_size)
+{
+    // Encoded send buffer needs to be slightly larger since the zero
+    // coding can potentially increase the size of the send data.
+    static U8 encodedSendBuffer[2 * MAX_BUFFER_SIZE];
+
+    // skip the packet id field
+    U8* packet = *data;
+    const S32 count = *data_size - LL_PACKET_ID_SIZE;
+
+    bool in_place = false;
+    const S32 encoded_size = zero_code_size(packet + LL_PACKET_ID_SIZE, count, in_place);
+    const S32 net_gain = encoded_size - count;
 
     if (net_gain < 0)
     {
@@ -562,9 +607,19 @@ static S32 zero_code(U8 **data, U32 *data_size)
         //mCompressedPacketsOut++;
         //mUncompressedBytesOut += *data_size;
 
-        *data = encodedSendBuffer;
+        if (in_place)
+        {
+            // the usual case, no copy of the packet at all
+            zero_code_encode(packet + LL_PACKET_ID_SIZE, count, packet + LL_PACKET_ID_SIZE);
+        }
+        else
+        {
+            memcpy(encodedSendBuffer, packet, LL_PACKET_ID_SIZE);     /* Flawfinder: ignore */
+            zero_code_encode(packet + LL_PACKET_ID_SIZE, count, encodedSendBuffer + LL_PACKET_ID_SIZE);
+            *data = encodedSendBuffer;
+        }
         *data_size += net_gain;
-        encodedSendBuffer[0] |= LL_ZERO_CODE_FLAG;          // set the head bit to indicate zero coding
+        (*data)[0] |= LL_ZERO_CODE_FLAG;          // set the head bit to indicate zero coding
 
         //mCompressedBytesOut += *data_size;
 
@@ -39,6 +39,8 @@ const U32 LLXfer::XFER_FILE = 1;
 const U32 LLXfer::XFER_VFILE = 2;
 const U32 LLXfer::XFER_MEM = 3;
 
+S32 LLXfer::sMaxWindowSize = 16;
+
 ///////////////////////////////////////////////////////////
 
 LLXfer::LLXfer (S32 chunk_size)
@@ -76,6 +78,11 @@ void LLXfer::init (S32 chunk_size)
 
     mRetries = 0;
 
+    mWindowSize = 1;
+    mWindowConfirms = 0;
+    mConfirmedPacketNum = -1;
+    mSlowStart = true;
+
     if (chunk_size < 1)
     {
         chunk_size = LL_XFER_CHUNK_SIZE;
@@ -286,7 +293,6 @@ void LLXfer::sendPacket(S32 packet_num)
 
 void LLXfer::sendNextPacket()
 {
-    mRetries = 0;
     sendPacket(++mPacketNum);
 }
 
@@ -300,6 +306,65 @@ void LLXfer::resendLastPacket()
 
 ///////////////////////////////////////////////////////////
 
+void LLXfer::sendWindow()
+{
+    while ((mStatus == e_LL_XFER_IN_PROGRESS)
+           && (mPacketNum - mConfirmedPacketNum < mWindowSize))
+    {
+        sendNextPacket();
+    }
+}
+
+///////////////////////////////////////////////////////////
+
+void LLXfer::resendUnconfirmedPackets()
+{
+    mRetries++;
+    mWindowSize = llmax(mWindowSize / 2, 1);
+    mWindowConfirms = 0;
+    mSlowStart = false;
+
+    // Receivers drop what comes after a missing packet unless they hold
+    // it, so resend the whole window from there
+    mPacketNum = mConfirmedPacketNum;
+    sendNextPacket();
+    sendWindow();
+}
+
+///////////////////////////////////////////////////////////
+
+void LLXfer::confirmPacket(S32 packet_num)
+{
+    if ((packet_num <= mConfirmedPacketNum) || (packet_num > mPacketNum))
+    {
+        // stale, or for a packet we haven't sent
+        return;
+    }
+
+    S32 confirmed = packet_num - mConfirmedPacketNum;
+    mConfirmedPacketNum = packet_num;
+    mWaitingForACK = (mConfirmedPacketNum < mPacketNum);
+    mRetries = 0;
+    ACKTimer.reset();
+
+    if (mSlowStart)
+    {
+        mWindowSize += confirmed;
+    }
+    else
+    {
+        mWindowConfirms += confirmed;
+        if (mWindowConfirms >= mWindowSize)
+        {
+            mWindowConfirms -= mWindowSize;
+            mWindowSize++;
+        }
+    }
+    mWindowSize = llclamp(mWindowSize, 1, llclamp(sMaxWindowSize, 1, LL_XFER_MAX_WINDOW));
+}
+
+///////////////////////////////////////////////////////////
+
 S32 LLXfer::processEOF()
 {
     S32 retval = 0;
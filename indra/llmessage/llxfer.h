@@ -31,7 +31,10 @@
 #include "lltimer.h"
 #include "llextendedstatus.h"
 
+#include <map>
+
 const S32 LL_XFER_LARGE_PAYLOAD = 7680;
+const S32 LL_XFER_MAX_WINDOW = 32;  // packets in flight or held out of order, per xfer
 const S32 LL_ERR_FILE_EMPTY     = -44;
 const int LL_ERR_FILE_NOT_FOUND = -43;
 const int LL_ERR_CANNOT_OPEN_FILE = -42;
@@ -76,6 +79,20 @@ class LLXfer
     LLTimer ACKTimer;
     S32 mRetries;
 
+    // Sending keeps up to mWindowSize packets unconfirmed. The window
+    // doubles every round trip until the first timeout, then grows by one
+    // packet per window confirmed, and halves on every timeout.
+    S32 mWindowSize;
+    S32 mWindowConfirms;        // confirmed since the window last grew
+    S32 mConfirmedPacketNum;    // last packet confirmed, confirms are cumulative
+    bool mSlowStart;
+
+    // Packets received ahead of mPacketNum, by packet number, with their
+    // encoded packet number and data, until the ones before them come in
+    std::map<S32, std::pair<S32, std::string> > mReceivedAhead;
+
+    static S32 sMaxWindowSize;  // 1 for one packet at a time
+
     static const U32 XFER_FILE;
     static const U32 XFER_VFILE;
     static const U32 XFER_MEM;
@@ -95,6 +112,11 @@ class LLXfer
     virtual void sendPacket(S32 packet_num);
     virtual void sendNextPacket();
     virtual void resendLastPacket();
+    // send new packets while the window allows it
+    void sendWindow();
+    // go back to the first unconfirmed packet after a timeout
+    void resendUnconfirmedPackets();
+    void confirmPacket(S32 packet_num);
     virtual S32 processEOF();
     virtual S32 startDownload();
     virtual S32 receiveData (char *datap, S32 data_size);
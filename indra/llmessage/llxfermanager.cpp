@@ -77,6 +77,7 @@ void LLXferManager::init()
     setMaxOutgoingXfersPerCircuit(LL_DEFAULT_MAX_SIMULTANEOUS_XFERS);
     setHardLimitOutgoingXfersPerCircuit(LL_DEFAULT_MAX_HARD_LIMIT_SIMULTANEOUS_XFERS);
     setMaxIncomingXfers(LL_DEFAULT_MAX_REQUEST_FIFO_XFERS);
+    setMaxIncomingXfersPerHost(LL_DEFAULT_MAX_REQUEST_FIFO_XFERS);
 
     // Turn on or off ack throttling
     mUseAckThrottling = false;
@@ -106,6 +107,20 @@ void LLXferManager::setMaxIncomingXfers(S32 max_num)
 
 ///////////////////////////////////////////////////////////
 
+void LLXferManager::setMaxIncomingXfersPerHost(S32 max_num)
+{
+    mMaxIncomingXfersPerHost = max_num;
+}
+
+///////////////////////////////////////////////////////////
+
+void LLXferManager::setMaxSendWindow(S32 max_packets)
+{
+    LLXfer::sMaxWindowSize = llclamp(max_packets, 1, LL_XFER_MAX_WINDOW);
+}
+
+///////////////////////////////////////////////////////////
+
 void LLXferManager::setMaxOutgoingXfersPerCircuit(S32 max_num)
 {
     mMaxOutgoingXfersPerCircuit = max_num;
@@ -560,14 +575,21 @@ void LLXferManager::processReceiveData (LLMessageSystem *mesgsys, void ** /*user
         return;
     }
 
-    S32 xfer_size;
-
-    if (decodePacketNum(packetnum) != xferp->mPacketNum) // is the packet different from what we were expecting?
+    S32 packet = decodePacketNum(packetnum);
+    if (packet != xferp->mPacketNum) // is the packet different from what we were expecting?
     {
         // confirm it if it was a resend of the last one, since the confirmation might have gotten dropped
-        if (decodePacketNum(packetnum) == (xferp->mPacketNum - 1))
+        if (packet == (xferp->mPacketNum - 1))
         {
-            LL_INFOS("Xfer") << "Reconfirming xfer " << xferp->mRemoteHost << ":" << xferp->getFileName() << " packet " << packetnum << LL_ENDL;            sendConfirmPacket(mesgsys, id, decodePacketNum(packetnum), mesgsys->getSender());
+            LL_INFOS("Xfer") << "Reconfirming xfer " << xferp->mRemoteHost << ":" << xferp->getFileName() << " packet " << packetnum << LL_ENDL;            sendConfirmPacket(mesgsys, id, packet, mesgsys->getSender());
+        }
+        else if ((packet > xferp->mPacketNum)
+                 && (packet - xferp->mPacketNum < LL_XFER_MAX_WINDOW))
+        {
+            // A windowed sender got ahead of a lost or reordered packet,
+            // hold this one until that comes in. Confirms stay in order, so
+            // nothing past the gap is confirmed yet.
+            xferp->mReceivedAhead[packet] = std::make_pair(packetnum, std::string(fdata_buf, fdata_size));
         }
         else
         {
@@ -576,6 +598,29 @@ void LLXferManager::processReceiveData (LLMessageSystem *mesgsys, void ** /*user
         return;
     }
 
+    if (!receivePacket(xferp, packetnum, fdata_buf, fdata_size, mesgsys->getSender()))
+    {
+        return;
+    }
+
+    // the packets held back behind this one can go in now
+    while (!xferp->mReceivedAhead.empty()
+           && (xferp->mReceivedAhead.begin()->first == xferp->mPacketNum))
+    {
+        std::pair<S32, std::string> ahead = xferp->mReceivedAhead.begin()->second;
+        xferp->mReceivedAhead.erase(xferp->mReceivedAhead.begin());
+        if (!receivePacket(xferp, ahead.first, &ahead.second[0], (S32)ahead.second.size(), mesgsys->getSender()))
+        {
+            return;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////
+
+bool LLXferManager::receivePacket(LLXfer* xferp, S32 packetnum, char* fdata_buf, S32 fdata_size, const LLHost& sender)
+{
+    S32 xfer_size;
     S32 result = 0;
 
     if (xferp->mPacketNum == 0) // first packet has size encoded as additional S32 at beginning of data
@@ -598,7 +643,7 @@ void LLXferManager::processReceiveData (LLMessageSystem *mesgsys, void ** /*user
             xferp->abort(LL_ERR_CANNOT_OPEN_FILE);
             removeXfer(xferp,mReceiveList);
             startPendingDownloads();
-            return;
+            return false;
     }
 
     xferp->mPacketNum++;  // expect next packet
@@ -606,15 +651,15 @@ void LLXferManager::processReceiveData (LLMessageSystem *mesgsys, void ** /*user
     if (!mUseAckThrottling)
     {
         // No throttling, confirm right away
-        sendConfirmPacket(mesgsys, id, decodePacketNum(packetnum), mesgsys->getSender());
+        sendConfirmPacket(gMessageSystem, xferp->mID, decodePacketNum(packetnum), sender);
     }
     else
     {
         // Throttling, put on queue to be confirmed later.
         LLXferAckInfo ack_info;
-        ack_info.mID = id;
+        ack_info.mID = xferp->mID;
         ack_info.mPacketNum = decodePacketNum(packetnum);
-        ack_info.mRemoteHost = mesgsys->getSender();
+        ack_info.mRemoteHost = sender;
         mXferAckQueue.push_back(ack_info);
     }
 
@@ -623,7 +668,9 @@ void LLXferManager::processReceiveData (LLMessageSystem *mesgsys, void ** /*user
         xferp->processEOF();
         removeXfer(xferp,mReceiveList);
         startPendingDownloads();
+        return false;
     }
+    return true;
 }
 
 ///////////////////////////////////////////////////////////
@@ -917,6 +964,7 @@ void LLXferManager::processFileRequest (LLMessageSystem *mesgsys, void ** /*user
             if (host_statusp->mNumActive < mMaxOutgoingXfersPerCircuit)
             {   // Not many transfers in progress already, so start immediately
                 xferp->sendNextPacket();
+                xferp->sendWindow();
                 changeNumActiveXfers(xferp->mRemoteHost,1);
                 LL_DEBUGS("Xfer") << "Starting xfer ID " << U64_to_str(id) << " immediately" << LL_ENDL;
             }
@@ -1005,13 +1053,14 @@ void LLXferManager::processConfirmation (LLMessageSystem *mesgsys, void ** /*use
     if (xferp)
     {
 //      cout << "confirmed packet #" << packetNum << " ping: "<< xferp->ACKTimer.getElapsedTimeF32() <<  endl;
-        xferp->mWaitingForACK = false;
+        xferp->confirmPacket(packetNum);
         if (xferp->mStatus == e_LL_XFER_IN_PROGRESS)
         {
-            xferp->sendNextPacket();
+            xferp->sendWindow();
         }
-        else
+        else if ((xferp->mStatus != e_LL_XFER_COMPLETE) || !xferp->mWaitingForACK)
         {
+            // complete once the last packet and all before it are confirmed
             removeXfer(xferp, mSendList);
         }
     }
@@ -1068,8 +1117,9 @@ void LLXferManager::retransmitUnackedPackets()
             }
             else
             {
-                LL_INFOS("Xfer") << "resending xfer " << xferp->mRemoteHost << ":" << xferp->getFileName() << " packet unconfirmed after: "<< et << " sec, packet " << xferp->mPacketNum << LL_ENDL;
-                xferp->resendLastPacket();
+                LL_INFOS("Xfer") << "resending xfer " << xferp->mRemoteHost << ":" << xferp->getFileName() << " packet unconfirmed after: "<< et << " sec, packets "
+                                 << xferp->mConfirmedPacketNum + 1 << " to " << xferp->mPacketNum << LL_ENDL;
+                xferp->resendUnconfirmedPackets();
             }
         }
         else if ((xferp->mStatus == e_LL_XFER_REGISTERED) && ( (et = xferp->ACKTimer.getElapsedTimeF32()) > LL_XFER_REGISTRATION_TIMEOUT))
@@ -1105,6 +1155,7 @@ void LLXferManager::retransmitUnackedPackets()
                 {   // No error re-opening the file, send the first packet
                     LL_DEBUGS("Xfer") << "Moving pending xfer ID " << U64_to_str(xferp->mID) << " to active" << LL_ENDL;
                     xferp->sendNextPacket();
+                    xferp->sendWindow();
                     changeNumActiveXfers(xferp->mRemoteHost,1);
                 }
             }
@@ -1187,9 +1238,11 @@ void LLXferManager::startPendingDownloads()
     // xfers are stored as an intrusive linked list where older
     // requests get pushed toward the back. Thus, if we didn't do a
     // stateful iteration, it would be possible for old requests to
-    // never start.
+    // never start. Each host also gets at most mMaxIncomingXfersPerHost,
+    // so that a slow one doesn't hold up the others.
     LLXfer* xferp;
     std::list<LLXfer*> pending_downloads;
+    std::map<LLHost, S32> host_download_count;
     S32 download_count = 0;
     S32 pending_count = 0;
     for (xfer_list_t::iterator iter = mReceiveList.begin();
@@ -1205,6 +1258,7 @@ void LLXferManager::startPendingDownloads()
         else if(xferp->mStatus == e_LL_XFER_IN_PROGRESS)
         {   // Count downloads in progress
             ++download_count;
+            ++host_download_count[xferp->mRemoteHost];
         }
     }
 
@@ -1221,13 +1275,20 @@ void LLXferManager::startPendingDownloads()
              iter != pending_downloads.end(); ++iter)
         {
             xferp = *iter;
-            if (start_count-- <= 0)
+            if (start_count <= 0)
                 break;
+            S32& host_count = host_download_count[xferp->mRemoteHost];
+            if (host_count >= mMaxIncomingXfersPerHost)
+                continue;
             result = xferp->startDownload();
             if(result)
             {
                 xferp->abort(result);
-                ++start_count;
+            }
+            else
+            {
+                --start_count;
+                ++host_count;
             }
         }
     }
@@ -75,6 +75,7 @@ class LLXferManager
     S32    mMaxOutgoingXfersPerCircuit;
     S32    mHardLimitOutgoingXfersPerCircuit;   // At this limit, kill off the connection
     S32    mMaxIncomingXfers;
+    S32    mMaxIncomingXfersPerHost;
 
     bool    mUseAckThrottling; // Use ack throttling to cap file xfer bandwidth
     std::deque<LLXferAckInfo> mXferAckQueue;
@@ -101,6 +102,9 @@ class LLXferManager
     // implementation methods
     virtual void startPendingDownloads();
     virtual void addToList(LLXfer* xferp, xfer_list_t & xfer_list, bool is_priority);
+    // hand packetnum, the next one xferp expects, to it and confirm it,
+    // false once xferp is done with
+    bool receivePacket(LLXfer* xferp, S32 packetnum, char* fdata_buf, S32 fdata_size, const LLHost& sender);
     std::multiset<std::string> mExpectedTransfers; // files that are authorized to transfer out
     std::multiset<std::string> mExpectedRequests;  // files that are authorized to be downloaded on top of
     std::multiset<std::string> mExpectedVFileTransfers; // files that are authorized to transfer out
@@ -129,6 +133,9 @@ class LLXferManager
     virtual void setMaxOutgoingXfersPerCircuit (S32 max_num);
     virtual void setHardLimitOutgoingXfersPerCircuit(S32 max_num);
     virtual void setMaxIncomingXfers(S32 max_num);
+    virtual void setMaxIncomingXfersPerHost(S32 max_num);
+    // packets a send keeps in flight at most, 1 sends one at a time
+    void setMaxSendWindow(S32 max_packets);
     virtual void updateHostStatus();
     virtual void printHostStatus();
 
@@ -325,6 +325,9 @@ LLMessageSystem::~LLMessageSystem()
     for_each(mMessageNumbers.begin(), mMessageNumbers.end(), DeletePairedPointer());
     mMessageNumbers.clear();
 
+    // the receive thread reads the socket
+    mPacketRing.stopReceiveThread();
+
     if (!mbError)
     {
         end_net(mSocket);
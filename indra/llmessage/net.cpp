@@ -26,7 +26,7 @@
 
 #include "linden_common.h"
 
-//#include "net.h"
+#include "net.h"
 
 // system library includes
 #include <stdexcept>
@@ -523,12 +523,30 @@ void end_net(S32& socket_out)
 }
 
 #if LL_LINUX
+static void read_destip(struct msghdr* msg, U32* dstip)
+{
+    struct cmsghdr *cmsgptr;
+    for (cmsgptr = CMSG_FIRSTHDR(msg); cmsgptr != NULL; cmsgptr = CMSG_NXTHDR(msg, cmsgptr))
+    {
+        if( cmsgptr->cmsg_level == SOL_IP && cmsgptr->cmsg_type == IP_PKTINFO )
+        {
+            in_pktinfo *pktinfo = (in_pktinfo *)CMSG_DATA(cmsgptr);
+            if( pktinfo )
+            {
+                // Two choices. routed and specified. ipi_addr is routed, ipi_spec_dst is
+                // routed. We should stay with specified until we go to multiple
+                // interfaces
+                *dstip = pktinfo->ipi_spec_dst.s_addr;
+            }
+        }
+    }
+}
+
 static int recvfrom_destip( int socket, void *buf, int len, struct sockaddr *from, socklen_t *fromlen, U32 *dstip )
 {
     int size;
     struct iovec iov[1];
     char cmsg[CMSG_SPACE(sizeof(struct in_pktinfo))];
-    struct cmsghdr *cmsgptr;
     struct msghdr msg = {0};
 
     iov[0].iov_base = buf;
@@ -549,20 +567,7 @@ static int recvfrom_destip( int socket, void *buf, int len, struct sockaddr *fro
         return -1;
     }
 
-    for (cmsgptr = CMSG_FIRSTHDR(&msg); cmsgptr != NULL; cmsgptr = CMSG_NXTHDR( &msg, cmsgptr))
-    {
-        if( cmsgptr->cmsg_level == SOL_IP && cmsgptr->cmsg_type == IP_PKTINFO )
-        {
-            in_pktinfo *pktinfo = (in_pktinfo *)CMSG_DATA(cmsgptr);
-            if( pktinfo )
-            {
-                // Two choices. routed and specified. ipi_addr is routed, ipi_spec_dst is
-                // routed. We should stay with specified until we go to multiple
-                // interfaces
-                *dstip = pktinfo->ipi_spec_dst.s_addr;
-            }
-        }
-    }
+    read_destip(&msg, dstip);
 
     return size;
 }
@@ -660,4 +665,78 @@ bool send_packet(int hSocket, const char * sendBuffer, int size, U32 recipient,
 
 #endif
 
+#if LL_LINUX
+
+S32 receive_packets(int hSocket, LLNetPacket* packets, S32 count)
+{
+    count = llmin(count, NET_RECEIVE_BATCH);
+    if (count <= 0)
+    {
+        return 0;
+    }
+
+    struct mmsghdr msgs[NET_RECEIVE_BATCH];
+    struct iovec iovs[NET_RECEIVE_BATCH];
+    struct sockaddr_in addrs[NET_RECEIVE_BATCH];
+    char cmsgs[NET_RECEIVE_BATCH][CMSG_SPACE(sizeof(struct in_pktinfo))];
+
+    memset(msgs, 0, sizeof(msgs[0]) * count);
+    for (S32 i = 0; i < count; ++i)
+    {
+        iovs[i].iov_base = packets[i].mData;
+        iovs[i].iov_len = NET_BUFFER_SIZE;
+
+        struct msghdr& msg = msgs[i].msg_hdr;
+        msg.msg_name = &addrs[i];
+        msg.msg_namelen = sizeof(addrs[i]);
+        msg.msg_iov = &iovs[i];
+        msg.msg_iovlen = 1;
+        msg.msg_control = cmsgs[i];
+        msg.msg_controllen = sizeof(cmsgs[i]);
+    }
+
+    // the socket is non blocking, this returns what is waiting
+    int received = recvmmsg(hSocket, msgs, count, 0, NULL);
+    if (received <= 0)
+    {
+        return 0;
+    }
+
+    for (S32 i = 0; i < received; ++i)
+    {
+        LLNetPacket& packet = packets[i];
+        packet.mSize = msgs[i].msg_len;
+        packet.mSenderIP = addrs[i].sin_addr.s_addr;
+        packet.mSenderPort = ntohs(addrs[i].sin_port);
+        packet.mReceivingIP = INVALID_HOST_IP_ADDRESS;
+        read_destip(&msgs[i].msg_hdr, &packet.mReceivingIP);
+    }
+    return received;
+}
+
+#else
+
+S32 receive_packets(int hSocket, LLNetPacket* packets, S32 count)
+{
+    // no batched receive here, read the datagrams one by one
+    count = llmin(count, NET_RECEIVE_BATCH);
+    S32 received = 0;
+    while (received < count)
+    {
+        LLNetPacket& packet = packets[received];
+        packet.mSize = receive_packet(hSocket, packet.mData);
+        if (packet.mSize <= 0)
+        {
+            break;
+        }
+        packet.mSenderIP = get_sender_ip();
+        packet.mSenderPort = get_sender_port();
+        packet.mReceivingIP = get_receiving_interface_ip();
+        ++received;
+    }
+    return received;
+}
+
+#endif
+
 //EOF
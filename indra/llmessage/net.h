@@ -43,6 +43,21 @@ void    end_net(S32& socket_out);
 // returns size of packet or -1 in case of error
 S32     receive_packet(int hSocket, char * receiveBuffer);
 
+// one datagram of a receive_packets() batch, mData points to NET_BUFFER_SIZE bytes
+struct LLNetPacket
+{
+    char*   mData;
+    S32     mSize;
+    U32     mSenderIP;
+    U32     mSenderPort;
+    U32     mReceivingIP;
+};
+
+// Receives up to count (at most NET_RECEIVE_BATCH) waiting datagrams, with a single
+// system call where the platform has one (recvmmsg on Linux). Returns how many were received.
+const S32 NET_RECEIVE_BATCH = 64;
+S32     receive_packets(int hSocket, LLNetPacket* packets, S32 count);
+
 bool    send_packet(int hSocket, const char *sendBuffer, int size, U32 recipient, int nPort);   // Returns true on success.
 
 //void  get_sender(char * tmp);
@@ -55,4 +55,31 @@ namespace tut
         ensure("oversized local_filename nul-terminated",
                xff.getFileName().length() < LL_MAX_PATH);
     }
+
+    template<> template<>
+    void llxfer_object::test<2>()
+    {
+        // test that confirms open the send window up
+        LLXfer_File xff("window", false, 1);
+        ensure_equals("first packet sent alone", xff.mWindowSize, 1);
+
+        xff.mPacketNum = 0;
+        xff.confirmPacket(0);
+        ensure_equals("window grows with each confirm", xff.mWindowSize, 2);
+        ensure("nothing left unconfirmed", !xff.mWaitingForACK);
+
+        xff.mPacketNum = 2;
+        xff.confirmPacket(2);
+        ensure_equals("confirms are cumulative", xff.mWindowSize, 4);
+        ensure_equals(xff.mConfirmedPacketNum, 2);
+
+        xff.confirmPacket(1);
+        xff.confirmPacket(5);
+        ensure_equals("stale and unsent confirms are ignored", xff.mConfirmedPacketNum, 2);
+        ensure_equals(xff.mWindowSize, 4);
+
+        xff.mPacketNum = 100;
+        xff.confirmPacket(100);
+        ensure_equals("window is capped", xff.mWindowSize, LLXfer::sMaxWindowSize);
+    }
 }
@@ -32,6 +32,9 @@
 #include "llsdserialize.h"
 #include "llvector4a.h"
 #include "hbxxh.h"
+#include "llmutex.h"
+
+#include <unordered_map>
 
 #ifdef LL_USESYSTEMLIBS
 # include <zlib.h>
@@ -50,6 +53,51 @@ std::string model_names[] =
 
 const int MODEL_NAMES_LENGTH = sizeof(model_names) / sizeof(std::string);
 
+namespace
+{
+    // Every tweak in the upload floater asks for a new fee estimate, which
+    // writes the whole model set again although usually only a few of its
+    // blocks changed. Compressing a block costs far more than serializing
+    // it, so compressed blocks are kept by the hash of their binary LLSD.
+    constexpr size_t ZIPPED_BLOCK_CACHE_BYTES = 64 * 1024 * 1024;
+
+    LLMutex sZippedBlockMutex;
+    std::unordered_map<LLUUID, std::string> sZippedBlocks;
+    size_t sZippedBlockBytes = 0;
+
+    std::string zip_llsd_cached(LLSD& data)
+    {
+        std::ostringstream binary;
+        LLSDSerialize::toBinary(data, binary);
+        LLUUID key = HBXXH128::digest(binary.str());
+
+        {
+            LLMutexLock lock(&sZippedBlockMutex);
+            auto found = sZippedBlocks.find(key);
+            if (found != sZippedBlocks.end())
+            {
+                return found->second;
+            }
+        }
+
+        std::string zipped = zip_llsd(data);
+        if (!zipped.empty())
+        {
+            LLMutexLock lock(&sZippedBlockMutex);
+            if (sZippedBlockBytes + zipped.size() > ZIPPED_BLOCK_CACHE_BYTES)
+            { // blocks of models that are long gone, start over
+                sZippedBlocks.clear();
+                sZippedBlockBytes = 0;
+            }
+            if (sZippedBlocks.emplace(key, zipped).second)
+            {
+                sZippedBlockBytes += zipped.size();
+            }
+        }
+        return zipped;
+    }
+}
+
 LLModel::LLModel(const LLVolumeParams& params, F32 detail)
     : LLVolume(params, detail),
       mNormalizedScale(1,1,1),
@@ -959,7 +1007,7 @@ LLSD LLModel::writeModelToStream(std::ostream& ostr, LLSD& mdl, bool nowrite, bo
 
     if (mdl.has("skin"))
     { //write out skin block
-        skin = zip_llsd(mdl["skin"]);
+        skin = zip_llsd_cached(mdl["skin"]);
 
         U32 size = static_cast<U32>(skin.size());
         if (size > 0)
@@ -974,7 +1022,7 @@ LLSD LLModel::writeModelToStream(std::ostream& ostr, LLSD& mdl, bool nowrite, bo
 
     if (mdl.has("physics_convex"))
     { //write out convex decomposition
-        decomposition = zip_llsd(mdl["physics_convex"]);
+        decomposition = zip_llsd_cached(mdl["physics_convex"]);
 
         U32 size = static_cast<U32>(decomposition.size());
         if (size > 0)
@@ -996,7 +1044,7 @@ LLSD LLModel::writeModelToStream(std::ostream& ostr, LLSD& mdl, bool nowrite, bo
     {
         if (mdl.has(model_names[i]))
         {
-            out[i] = zip_llsd(mdl[model_names[i]]);
+            out[i] = zip_llsd_cached(mdl[model_names[i]]);
 
             U32 size = static_cast<U32>(out[i].size());
 
@@ -40,6 +40,7 @@
 #include "llprimtexturelist.h"
 #include "llmaterialid.h"
 #include "llsdutil.h"
+#include "hbxxh.h"
 
 /**
  * exported constants
@@ -1469,13 +1470,48 @@ S32 LLPrimitive::applyParsedTEMessage(LLTEContents& tec)
     return retval;
 }
 
+U64 LLPrimitive::getTEStateHash(U32 face_count) const
+{
+    HBXXH64 hash;
+    hash.update(&face_count, sizeof(face_count));
+    for (U32 i = 0; i < face_count; i++)
+    {
+        const LLTextureEntry* tep = getTE(i);
+        if (!tep)
+        {
+            continue;
+        }
+        hash.update(tep->getID().mData, UUID_BYTES);
+        hash.update(tep->getColor().mV, sizeof(tep->getColor().mV));
+        const F32 params[] = { tep->mScaleS, tep->mScaleT, tep->mOffsetS, tep->mOffsetT, tep->getRotation(), tep->getGlow() };
+        hash.update(params, sizeof(params));
+        const U8 flags[] = { tep->getBumpShinyFullbright(), tep->getMediaTexGen() };
+        hash.update(flags, sizeof(flags));
+        hash.update(tep->getMaterialID().get(), MATERIAL_ID_SIZE);
+    }
+    return hash.digest();
+}
+
 S32 LLPrimitive::unpackTEMessage(LLMessageSystem* mesgsys, char const* block_name, const S32 block_num)
 {
     LLTEContents tec;
     S32 retval = parseTEMessage(mesgsys, block_name, block_num, tec);
     if (!retval)
         return retval;
-    return applyParsedTEMessage(tec);
+
+    // Object updates resend the TextureEntry block whether it changed or
+    // not. When it is the block we applied last and nothing touched the
+    // faces since, applying it again would not change anything.
+    U64 block_hash = HBXXH64::digest(tec.packed_buffer, tec.size) ^ tec.face_count;
+    if (block_hash == mTEBlockHash && getTEStateHash(tec.face_count) == mTEStateHash)
+    {
+        return 0;
+    }
+
+    retval = applyParsedTEMessage(tec);
+    mTEBlockHash = block_hash;
+    mTEStateHash = getTEStateHash(tec.face_count);
+    return retval;
 }
 
 S32 LLPrimitive::unpackTEMessage(LLDataPacker &dp)
@@ -1539,6 +1575,13 @@ S32 LLPrimitive::unpackTEMessage(LLDataPacker &dp)
     face_count = llmin((U32) getNumTEs(), MAX_TES);
     U32 i;
 
+    // Same as above, skip the parsing too for an unchanged block
+    U64 block_hash = HBXXH64::digest(packed_buffer, size) ^ face_count;
+    if (block_hash == mTEBlockHash && getTEStateHash(face_count) == mTEStateHash)
+    {
+        return 0;
+    }
+
     U8 *cur_ptr = packed_buffer;
     LL_DEBUGS("TEXTUREENTRY") << "Texture Entry with buffer sized: " << size << LL_ENDL;
     U8 *buffer_end = packed_buffer + size;
@@ -1591,6 +1634,8 @@ S32 LLPrimitive::unpackTEMessage(LLDataPacker &dp)
         retval |= setTEColor(i, color);
     }
 
+    mTEBlockHash = block_hash;
+    mTEStateHash = getTEStateHash(face_count);
     return retval;
 }
 
@@ -502,6 +502,8 @@ public:
     S32 unpackTEMessage(LLDataPacker &dp);
     S32 parseTEMessage(LLMessageSystem* mesgsys, char const* block_name, const S32 block_num, LLTEContents& tec);
     S32 applyParsedTEMessage(LLTEContents& tec);
+    // Hash of the face parameters a TextureEntry block sets, see unpackTEMessage()
+    U64 getTEStateHash(U32 face_count) const;
 
 #ifdef CHECK_FOR_FINITE
     inline void setPosition(const LLVector3& pos);
@@ -592,6 +594,10 @@ protected:
     U8                  mNumTEs;            // # of faces on the primitve
     U8                  mNumBumpmapTEs;     // number of bumpmap TEs.
     U32                 mMiscFlags;         // home for misc bools
+    // Last TextureEntry block applied, and the face state it left, so that
+    // the many resends of an unchanged block don't walk all the setters again
+    U64                 mTEBlockHash = 0;
+    U64                 mTEStateHash = 0;
 
 public:
     static LLVolumeMgr* sVolumeManager;
@@ -113,12 +113,24 @@ bool LLFontBitmapCache::nextOpenPos(S32 width, S32& pos_x, S32& pos_y, EFontGlyp
             LLImageRaw* image_raw = getImageRaw(bitmap_type, bitmap_num);
             if (EFontGlyphType::Grayscale == bitmap_type)
             {
-                image_raw->clear(255, 0);
+                if (num_components == 1)
+                {
+                    image_raw->clear(0);
+                }
+                else
+                {
+                    image_raw->clear(255, 0);
+                }
             }
 
             // Make corresponding GL image.
-            mImageGLVec[bitmap_idx].push_back(new LLImageGL(image_raw, false, false));
-            LLImageGL* image_gl = getImageGL(bitmap_type, bitmap_num);
+            LLImageGL* image_gl = new LLImageGL(false, false);
+            if (EFontGlyphType::Grayscale == bitmap_type && num_components == 1)
+            {
+                image_gl->setExplicitFormat(GL_R8, GL_RED);
+            }
+            image_gl->createGLTexture(0, image_raw);
+            mImageGLVec[bitmap_idx].push_back(image_gl);
 
             // Start at beginning of the new image.
             mCurrentOffsetX[bitmap_idx] = 1;
@@ -127,6 +139,13 @@ bool LLFontBitmapCache::nextOpenPos(S32 width, S32& pos_x, S32& pos_y, EFontGlyp
             // Attach corresponding GL texture. (*TODO: is this needed?)
             gGL.getTexUnit(0)->bind(image_gl);
             image_gl->setFilteringOption(LLTexUnit::TFO_POINT); // was setMipFilterNearest(true, true);
+            if (EFontGlyphType::Grayscale == bitmap_type && num_components == 1)
+            {
+                // coverage only, read it as white with that alpha, as the
+                // luminance alpha pages are
+                const GLint mask[] = { GL_ONE, GL_ONE, GL_ONE, GL_RED };
+                glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, mask);
+            }
         }
         else
         {
@@ -176,7 +195,9 @@ U32 LLFontBitmapCache::getNumComponents(EFontGlyphType bitmap_type)
     switch (bitmap_type)
     {
         case EFontGlyphType::Grayscale:
-            return 2;
+            // The luminance of a glyph is always full, only its coverage
+            // needs storing, given texture swizzles to read it back as alpha
+            return (gGLManager.mGLVersion >= 3.29f) ? 1 : 2;
         case EFontGlyphType::Color:
             return 4;
         default:
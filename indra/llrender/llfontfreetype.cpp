@@ -584,9 +584,14 @@ LLFontGlyphInfo* LLFontFreetype::addGlyphFromFont(const LLFontFreetype *fontp, l
         llassert(false);
     }
 
+    // Upload the glyph alone, the page texture was created with the page and
+    // a whole page per glyph added adds up when a new size or scale comes in
     LLImageGL *image_gl = mFontBitmapCachep->getImageGL(bitmap_glyph_type, bitmap_num);
     LLImageRaw *image_raw = mFontBitmapCachep->getImageRaw(bitmap_glyph_type, bitmap_num);
-    image_gl->setSubImage(image_raw, 0, 0, image_gl->getWidth(), image_gl->getHeight());
+    if (!image_gl->setSubImage(image_raw, pos_x, pos_y, width, height))
+    {
+        image_gl->setSubImage(image_raw, 0, 0, image_gl->getWidth(), image_gl->getHeight());
+    }
 
     return gi;
 }
@@ -784,7 +789,7 @@ void LLFontFreetype::setSubImageLuminanceAlpha(U32 x, U32 y, U32 bitmap_num, U32
     LLImageDataLock lock(image_raw);
 
     llassert(!mIsFallback);
-    llassert(image_raw && (image_raw->getComponents() == 2));
+    llassert(image_raw && (image_raw->getComponents() <= 2));
 
     U8 *target = image_raw->getData();
     llassert(target);
@@ -801,13 +806,16 @@ void LLFontFreetype::setSubImageLuminanceAlpha(U32 x, U32 y, U32 bitmap_num, U32
     U32 to_offset;
     U32 from_offset;
     U32 target_width = image_raw->getWidth();
+    // alpha only pages, or luminance alpha ones
+    const U32 components = image_raw->getComponents();
+    const U32 alpha_offset = components - 1;
     for (i = 0; i < height; i++)
     {
         to_offset = (y + i)*target_width + x;
         from_offset = (height - 1 - i)*stride;
         for (j = 0; j < width; j++)
         {
-            *(target + to_offset*2 + 1) = *(data + from_offset);
+            *(target + to_offset*components + alpha_offset) = *(data + from_offset);
             to_offset++;
             from_offset++;
         }
@@ -33,6 +33,17 @@
 
 bool LLFontVertexBuffer::sEnableBufferCollection = true;
 
+// Where LLFontGL::render() starts the glyphs drawn at x, y
+static F32 getScreenX(F32 x)
+{
+    return x * LLFontGL::sScaleX + floorf(LLFontGL::sCurOrigin.mX * LLFontGL::sScaleX);
+}
+
+static F32 getScreenY(F32 y)
+{
+    return y * LLFontGL::sScaleY + floorf(LLFontGL::sCurOrigin.mY * LLFontGL::sScaleY);
+}
+
 LLFontVertexBuffer::LLFontVertexBuffer()
 {
 }
@@ -126,37 +137,42 @@ S32 LLFontVertexBuffer::render(
         // For debug purposes and performance testing
         return fontp->render(text, begin_offset, x, y, color, halign, valign, style, shadow, max_chars, max_pixels, right_x, use_ellipses, use_color);
     }
-    if (mBufferList.empty())
+    if (mBufferList.empty()
+        || mLastFont != fontp
+        || mLastColor != color // alphas change often
+        || mLastHalign != halign
+        || mLastValign != valign
+        || mLastMaxChars != max_chars
+        || mLastMaxPixels != max_pixels
+        || mLastStyle != style
+        || mLastShadow != shadow // ex: buttons change shadow state
+        || mLastUseEllipses != use_ellipses
+        || mLastUseColor != use_color
+        || mLastScaleX != LLFontGL::sScaleX
+        || mLastScaleY != LLFontGL::sScaleY
+        || !isSameRun(text, begin_offset, max_chars))
     {
         genBuffers(fontp, text, begin_offset, x, y, color, halign, valign,
             style, shadow, max_chars, max_pixels, right_x, use_ellipses, use_color);
+        return mChars;
     }
-    else if (mLastX != x
-             || mLastY != y
-             || mLastFont != fontp
-             || mLastColor != color // alphas change often
-             || mLastHalign != halign
-             || mLastValign != valign
-             || mLastOffset != begin_offset
-             || mLastMaxChars != max_chars
-             || mLastMaxPixels != max_pixels
-             || mLastStyle != style
-             || mLastShadow != shadow // ex: buttons change shadow state
-             || mLastScaleX != LLFontGL::sScaleX
-             || mLastScaleY != LLFontGL::sScaleY
-             || mLastOrigin != LLFontGL::sCurOrigin)
+
+    // Same glyphs, moved by scrolling or by a floater being dragged. As long
+    // as the move is by whole screen pixels the vertices only need a translation.
+    F32 dx = getScreenX(x) - mLastScreenX;
+    F32 dy = getScreenY(y) - mLastScreenY;
+    if (dx != floorf(dx) || dy != floorf(dy))
     {
         genBuffers(fontp, text, begin_offset, x, y, color, halign, valign,
             style, shadow, max_chars, max_pixels, right_x, use_ellipses, use_color);
+        return mChars;
     }
-    else
-    {
-        renderBuffers();
 
-        if (right_x)
-        {
-            *right_x = mLastRightX;
-        }
+    renderBuffers(dx, dy);
+
+    if (right_x)
+    {
+        *right_x = mLastRightX + (x - mLastX);
     }
     return mChars;
 }
@@ -183,7 +199,7 @@ void LLFontVertexBuffer::genBuffers(
     gGL.endList();
 
     mLastFont = fontp;
-    mLastOffset = begin_offset;
+    mLastRun.assign(text, llmin((S32)text.length(), begin_offset), getRunLength(text, begin_offset, max_chars));
     mLastMaxChars = max_chars;
     mLastMaxPixels = max_pixels;
     mLastX = x;
@@ -193,10 +209,13 @@ void LLFontVertexBuffer::genBuffers(
     mLastValign = valign;
     mLastStyle = style;
     mLastShadow = shadow;
+    mLastUseEllipses = use_ellipses;
+    mLastUseColor = use_color;
 
     mLastScaleX = LLFontGL::sScaleX;
     mLastScaleY = LLFontGL::sScaleY;
-    mLastOrigin = LLFontGL::sCurOrigin;
+    mLastScreenX = getScreenX(x);
+    mLastScreenY = getScreenY(y);
 
     if (right_x)
     {
@@ -204,7 +223,7 @@ void LLFontVertexBuffer::genBuffers(
     }
 }
 
-void LLFontVertexBuffer::renderBuffers()
+void LLFontVertexBuffer::renderBuffers(F32 dx, F32 dy)
 {
     gGL.flush(); // deliberately empty pending verts
     gGL.getTexUnit(0)->enable(LLTexUnit::TT_TEXTURE);
@@ -214,7 +233,7 @@ void LLFontVertexBuffer::renderBuffers()
 
     // Depth translation, so that floating text appears 'in-world'
     // and is correctly occluded.
-    gGL.translatef(0.f, 0.f, LLFontGL::sCurDepth);
+    gGL.translatef(dx, dy, LLFontGL::sCurDepth);
     gGL.setSceneBlendType(LLRender::BT_ALPHA);
 
     // Note: ellipses should technically be covered by push/load/translate of their own
@@ -227,3 +246,23 @@ void LLFontVertexBuffer::renderBuffers()
     gGL.popUIMatrix();
 }
 
+//static
+S32 LLFontVertexBuffer::getRunLength(const LLWString& text, S32 begin_offset, S32 max_chars)
+{
+    S32 available = (S32)text.length() - begin_offset;
+    if (available <= 0)
+    {
+        return 0;
+    }
+    // as LLFontGL::render(), -1 is everything
+    S32 length = (max_chars == -1) ? available : llclamp(max_chars, 0, available);
+    // the next glyph kerns the last one drawn
+    return llmin(length + 1, available);
+}
+
+bool LLFontVertexBuffer::isSameRun(const LLWString& text, S32 begin_offset, S32 max_chars) const
+{
+    S32 length = getRunLength(text, begin_offset, max_chars);
+    return length == (S32)mLastRun.length()
+        && (length == 0 || mLastRun.compare(0, length, text, begin_offset, length) == 0);
+}
@@ -95,12 +95,18 @@ private:
          bool use_ellipses,
          bool use_color);
 
-    void renderBuffers();
+    void renderBuffers(F32 dx, F32 dy);
+
+    // The glyphs drawn last, plus the one after for kerning. Comparing them
+    // is much cheaper than regenerating, and lets callers keep their buffers
+    // across unrelated edits of the same text.
+    bool isSameRun(const LLWString& text, S32 begin_offset, S32 max_chars) const;
+    static S32 getRunLength(const LLWString& text, S32 begin_offset, S32 max_chars);
 
     std::list<LLVertexBufferData> mBufferList;
     S32 mChars = 0;
     const LLFontGL *mLastFont = nullptr;
-    S32 mLastOffset = 0;
+    LLWString mLastRun;
     S32 mLastMaxChars = 0;
     S32 mLastMaxPixels = 0;
     F32 mLastX = 0.f;
@@ -110,12 +116,17 @@ private:
     LLFontGL::VAlign mLastValign = LLFontGL::BASELINE;
     U8 mLastStyle = LLFontGL::NORMAL;
     LLFontGL::ShadowType mLastShadow = LLFontGL::NO_SHADOW;
+    bool mLastUseEllipses = false;
+    bool mLastUseColor = true;
     F32 mLastRightX = 0.f;
 
     // LLFontGL's statics
     F32 mLastScaleX = 1.f;
     F32 mLastScaleY = 1.f;
-    LLCoordGL mLastOrigin;
+    // where x, y landed on screen, glyphs are snapped to whole pixels from
+    // there, so a move by whole pixels is only a translation
+    F32 mLastScreenX = 0.f;
+    F32 mLastScreenY = 0.f;
 
     static bool sEnableBufferCollection;
 };
@@ -1437,6 +1437,24 @@ void LLGLManager::initExtensions()
         mHasNVXGpuMemoryInfo = ExtensionExists("GL_NVX_gpu_memory_info", gGLHExts.mSysExts);
     else
         LL_WARNS() << "gGLHExts.mSysExts is not set.?" << LL_ENDL;
+
+    // KHR_parallel_shader_compile, let the driver use as many compiler
+    // threads as it likes (see LLShaderMgr::loadShaderFileDeferred)
+    if (gGLHExts.mSysExts &&
+        (ExtensionExists("GL_KHR_parallel_shader_compile", gGLHExts.mSysExts) || ExtensionExists("GL_ARB_parallel_shader_compile", gGLHExts.mSysExts)))
+    {
+        PFNGLMAXSHADERCOMPILERTHREADSKHRPROC max_compiler_threads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)GLH_EXT_GET_PROC_ADDRESS("glMaxShaderCompilerThreadsKHR");
+        if (!max_compiler_threads)
+        {
+            max_compiler_threads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)GLH_EXT_GET_PROC_ADDRESS("glMaxShaderCompilerThreadsARB");
+        }
+        if (max_compiler_threads)
+        {
+            max_compiler_threads(0xFFFFFFFF);
+            mHasParallelShaderCompile = true;
+            LL_INFOS("RenderInit") << "Using parallel shader compilation" << LL_ENDL;
+        }
+    }
 #endif
 
     // Misc
@@ -2528,6 +2546,10 @@ void LLGLState::setEnabled(S32 enabled)
         glDisable(mState);
         sStateMap[mState] = GL_FALSE;
     }
+    else
+    {
+        ++LLRender::sRedundantGLCalls;
+    }
     mIsEnabled = enabled;
 }
 
@@ -99,6 +99,7 @@ public:
     // Vendor-specific extensions
     bool mHasAMDAssociations = false;
     bool mHasNVXGpuMemoryInfo = false;
+    bool mHasParallelShaderCompile = false;
 
     bool mIsAMD;
     bool mIsNVIDIA;
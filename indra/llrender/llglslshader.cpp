@@ -63,6 +63,8 @@ U64 LLGLSLShader::sTotalTimeElapsed = 0;
 U32 LLGLSLShader::sTotalTrianglesDrawn = 0;
 U64 LLGLSLShader::sTotalSamplesDrawn = 0;
 U32 LLGLSLShader::sTotalBinds = 0;
+U32 LLGLSLShader::sUniformSets = 0;
+U32 LLGLSLShader::sRedundantUniformSets = 0;
 boost::json::value LLGLSLShader::sDefaultStats;
 
 //UI shader -- declared here so llui_libtest will link properly
@@ -89,6 +91,16 @@ bool shouldChange(const LLVector4& v1, const LLVector4& v2)
     return v1 != v2;
 }
 
+// Short vec4 arrays (texture transforms and the like) are compared as a
+// whole so that binding a material with the same parameters costs nothing.
+// Longer arrays mostly change every time they are set.
+constexpr U32 MAX_CACHED_ARRAY_FLOATS = 16;
+
+// Uniform locations are small and dense within a program, so the last known
+// values live in a flat array indexed by location. Anything past this (which
+// no driver we know of hands out) is simply never deduplicated.
+constexpr GLint MAX_CACHED_UNIFORM_LOCATION = 4096;
+
 //===============================
 // LLGLSL Shader implementation
 //===============================
@@ -447,12 +459,17 @@ bool LLGLSLShader::createShader()
         fprintf(stderr, "--- %s ---\n", mName.c_str());
 #endif // DEBUG_SHADER_INCLUDES
 
-        //compile new source
-        vector< pair<string, GLenum> >::iterator fileIter = mShaderFiles.begin();
-        for (; fileIter != mShaderFiles.end(); fileIter++)
+        //compile new source, all stages at once
+        std::vector<GLuint> handles(mShaderFiles.size(), 0);
+        for (size_t i = 0; i < mShaderFiles.size(); ++i)
+        {
+            LLShaderMgr::instance()->loadShaderFileDeferred(&handles[i], mShaderFiles[i].first, mShaderLevel, mShaderFiles[i].second, &mDefines, mFeatures.mIndexedTextureChannels);
+            LL_DEBUGS("ShaderLoading") << "SHADER FILE: " << mShaderFiles[i].first << " mShaderLevel=" << mShaderLevel << LL_ENDL;
+        }
+        LLShaderMgr::instance()->finishDeferredCompile();
+
+        for (GLuint shaderhandle : handles)
         {
-            GLuint shaderhandle = LLShaderMgr::instance()->loadShaderFile((*fileIter).first, mShaderLevel, (*fileIter).second, &mDefines, mFeatures.mIndexedTextureChannels);
-            LL_DEBUGS("ShaderLoading") << "SHADER FILE: " << (*fileIter).first << " mShaderLevel=" << mShaderLevel << LL_ENDL;
             if (shaderhandle)
             {
                 attachObject(shaderhandle);
@@ -855,6 +872,8 @@ bool LLGLSLShader::mapUniforms()
     mUniformMap.clear();
     mTexture.clear();
     mValue.clear();
+    mValueSet.clear();
+    mArrayValue.clear();
     //initialize arrays
     mUniform.resize(LLShaderMgr::instance()->mReservedUniforms.size(), -1);
     mTexture.resize(LLShaderMgr::instance()->mReservedUniforms.size(), -1);
@@ -1003,6 +1022,8 @@ bool LLGLSLShader::mapUniforms()
         "GLTFJoints",       // UB_GLTF_JOINTS
         "GLTFNodes",        // UB_GLTF_NODES
         "GLTFMaterials",    // UB_GLTF_MATERIALS
+        "AvatarPalette",    // UB_AVATAR_PALETTE
+        "TreeInstances",    // UB_TREE_INSTANCES
     };
 
     llassert(LL_ARRAY_SIZE(ubo_names) == NUM_UNIFORM_BLOCKS);
@@ -1063,6 +1084,10 @@ void LLGLSLShader::bind()
         placeProfileQuery();
         LLVertexBuffer::setupClientArrays(mAttributeMask);
     }
+    else
+    {
+        ++LLRender::sRedundantGLCalls;
+    }
 
     if (mUniformsDirty)
     {
@@ -1286,6 +1311,60 @@ S32 LLGLSLShader::disableTexture(S32 uniform, LLTexUnit::eTextureType mode)
     return index;
 }
 
+bool LLGLSLShader::shouldChangeArray(GLint location, U32 floats, const GLfloat* v)
+{
+    if (floats > MAX_CACHED_ARRAY_FLOATS)
+    {
+        mArrayValue.erase(location);
+        clearValue(location);
+        return true;
+    }
+
+    std::vector<F32>& cached = mArrayValue[location];
+    if (cached.size() == floats && memcmp(cached.data(), v, floats * sizeof(F32)) == 0)
+    {
+        return false;
+    }
+
+    cached.assign(v, v + floats);
+    // the first element no longer matches what may have been set on its own
+    clearValue(location);
+    return true;
+}
+
+bool LLGLSLShader::updateValue(GLint location, const LLVector4& value, bool force)
+{
+    if (location >= MAX_CACHED_UNIFORM_LOCATION)
+    {
+        ++sUniformSets;
+        return true;
+    }
+
+    if ((size_t)location >= mValue.size())
+    {
+        mValue.resize(location + 1);
+        mValueSet.resize(location + 1, false);
+    }
+    else if (!force && mValueSet[location] && !shouldChange(mValue[location], value))
+    {
+        ++sRedundantUniformSets;
+        return false;
+    }
+
+    mValue[location] = value;
+    mValueSet[location] = true;
+    ++sUniformSets;
+    return true;
+}
+
+void LLGLSLShader::clearValue(GLint location)
+{
+    if ((size_t)location < mValueSet.size())
+    {
+        mValueSet[location] = false;
+    }
+}
+
 void LLGLSLShader::uniform1i(U32 index, GLint x)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_SHADER;
@@ -1301,11 +1380,10 @@ void LLGLSLShader::uniform1i(U32 index, GLint x)
 
         if (mUniform[index] >= 0)
         {
-            const auto& iter = mValue.find(mUniform[index]);
-            if (iter == mValue.end() || iter->second.mV[0] != x)
+            LLVector4 vec((F32)x, 0.f, 0.f, 0.f);
+            if (updateValue(mUniform[index], vec))
             {
                 glUniform1i(mUniform[index], x);
-                mValue[mUniform[index]] = LLVector4((F32)x, 0.f, 0.f, 0.f);
             }
         }
     }
@@ -1327,11 +1405,10 @@ void LLGLSLShader::uniform1f(U32 index, GLfloat x)
 
         if (mUniform[index] >= 0)
         {
-            const auto& iter = mValue.find(mUniform[index]);
-            if (iter == mValue.end() || iter->second.mV[0] != x)
+            LLVector4 vec(x, 0.f, 0.f, 0.f);
+            if (updateValue(mUniform[index], vec))
             {
                 glUniform1f(mUniform[index], x);
-                mValue[mUniform[index]] = LLVector4(x, 0.f, 0.f, 0.f);
             }
         }
     }
@@ -1363,12 +1440,10 @@ void LLGLSLShader::uniform2f(U32 index, GLfloat x, GLfloat y)
 
         if (mUniform[index] >= 0)
         {
-            const auto& iter = mValue.find(mUniform[index]);
             LLVector4 vec(x, y, 0.f, 0.f);
-            if (iter == mValue.end() || shouldChange(iter->second, vec))
+            if (updateValue(mUniform[index], vec))
             {
                 glUniform2f(mUniform[index], x, y);
-                mValue[mUniform[index]] = vec;
             }
         }
     }
@@ -1390,12 +1465,10 @@ void LLGLSLShader::uniform3f(U32 index, GLfloat x, GLfloat y, GLfloat z)
 
         if (mUniform[index] >= 0)
         {
-            const auto& iter = mValue.find(mUniform[index]);
             LLVector4 vec(x, y, z, 0.f);
-            if (iter == mValue.end() || shouldChange(iter->second, vec))
+            if (updateValue(mUniform[index], vec))
             {
                 glUniform3f(mUniform[index], x, y, z);
-                mValue[mUniform[index]] = vec;
             }
         }
     }
@@ -1417,12 +1490,10 @@ void LLGLSLShader::uniform4f(U32 index, GLfloat x, GLfloat y, GLfloat z, GLfloat
 
         if (mUniform[index] >= 0)
         {
-            const auto& iter = mValue.find(mUniform[index]);
             LLVector4 vec(x, y, z, w);
-            if (iter == mValue.end() || shouldChange(iter->second, vec))
+            if (updateValue(mUniform[index], vec))
             {
                 glUniform4f(mUniform[index], x, y, z, w);
-                mValue[mUniform[index]] = vec;
             }
         }
     }
@@ -1444,12 +1515,10 @@ void LLGLSLShader::uniform1iv(U32 index, U32 count, const GLint* v)
 
         if (mUniform[index] >= 0)
         {
-            const auto& iter = mValue.find(mUniform[index]);
             LLVector4 vec((F32)v[0], 0.f, 0.f, 0.f);
-            if (iter == mValue.end() || shouldChange(iter->second, vec) || count != 1)
+            if (updateValue(mUniform[index], vec, count != 1))
             {
                 glUniform1iv(mUniform[index], count, v);
-                mValue[mUniform[index]] = vec;
             }
         }
     }
@@ -1471,12 +1540,10 @@ void LLGLSLShader::uniform4iv(U32 index, U32 count, const GLint* v)
 
         if (mUniform[index] >= 0)
         {
-            const auto& iter = mValue.find(mUniform[index]);
             LLVector4 vec((F32)v[0], (F32)v[1], (F32)v[2], (F32)v[3]);
-            if (iter == mValue.end() || shouldChange(iter->second, vec) || count != 1)
+            if (updateValue(mUniform[index], vec, count != 1))
             {
                 glUniform1iv(mUniform[index], count, v);
-                mValue[mUniform[index]] = vec;
             }
         }
     }
@@ -1499,12 +1566,10 @@ void LLGLSLShader::uniform1fv(U32 index, U32 count, const GLfloat* v)
 
         if (mUniform[index] >= 0)
         {
-            const auto& iter = mValue.find(mUniform[index]);
             LLVector4 vec(v[0], 0.f, 0.f, 0.f);
-            if (iter == mValue.end() || shouldChange(iter->second, vec) || count != 1)
+            if (updateValue(mUniform[index], vec, count != 1))
             {
                 glUniform1fv(mUniform[index], count, v);
-                mValue[mUniform[index]] = vec;
             }
         }
     }
@@ -1526,12 +1591,10 @@ void LLGLSLShader::uniform2fv(U32 index, U32 count, const GLfloat* v)
 
         if (mUniform[index] >= 0)
         {
-            const auto& iter = mValue.find(mUniform[index]);
             LLVector4 vec(v[0], v[1], 0.f, 0.f);
-            if (iter == mValue.end() || shouldChange(iter->second, vec) || count != 1)
+            if (updateValue(mUniform[index], vec, count != 1))
             {
                 glUniform2fv(mUniform[index], count, v);
-                mValue[mUniform[index]] = vec;
             }
         }
     }
@@ -1553,12 +1616,10 @@ void LLGLSLShader::uniform3fv(U32 index, U32 count, const GLfloat* v)
 
         if (mUniform[index] >= 0)
         {
-            const auto& iter = mValue.find(mUniform[index]);
             LLVector4 vec(v[0], v[1], v[2], 0.f);
-            if (iter == mValue.end() || shouldChange(iter->second, vec) || count != 1)
+            if (updateValue(mUniform[index], vec, count != 1))
             {
                 glUniform3fv(mUniform[index], count, v);
-                mValue[mUniform[index]] = vec;
             }
         }
     }
@@ -1580,13 +1641,21 @@ void LLGLSLShader::uniform4fv(U32 index, U32 count, const GLfloat* v)
 
         if (mUniform[index] >= 0)
         {
-            const auto& iter = mValue.find(mUniform[index]);
+            if (count != 1)
+            {
+                if (shouldChangeArray(mUniform[index], count * 4, v))
+                {
+                    glUniform4fv(mUniform[index], count, v);
+                }
+                return;
+            }
+
             LLVector4 vec(v[0], v[1], v[2], v[3]);
-            if (iter == mValue.end() || shouldChange(iter->second, vec) || count != 1)
+            if (updateValue(mUniform[index], vec))
             {
                 LL_PROFILE_ZONE_SCOPED_CATEGORY_SHADER;
                 glUniform4fv(mUniform[index], count, v);
-                mValue[mUniform[index]] = vec;
+                mArrayValue.erase(mUniform[index]);
             }
         }
     }
@@ -1608,13 +1677,11 @@ void LLGLSLShader::uniform4uiv(U32 index, U32 count, const GLuint* v)
 
         if (mUniform[index] >= 0)
         {
-            const auto& iter = mValue.find(mUniform[index]);
             LLVector4 vec((F32)v[0], (F32)v[1], (F32)v[2], (F32)v[3]);
-            if (iter == mValue.end() || shouldChange(iter->second, vec) || count != 1)
+            if (updateValue(mUniform[index], vec, count != 1))
             {
                 LL_PROFILE_ZONE_SCOPED_CATEGORY_SHADER;
                 glUniform4uiv(mUniform[index], count, v);
-                mValue[mUniform[index]] = vec;
             }
         }
     }
@@ -1769,12 +1836,10 @@ void LLGLSLShader::uniform1i(const LLStaticHashedString& uniform, GLint v)
 
     if (location >= 0)
     {
-        const auto& iter = mValue.find(location);
         LLVector4 vec((F32)v, 0.f, 0.f, 0.f);
-        if (iter == mValue.end() || shouldChange(iter->second, vec))
+        if (updateValue(location, vec))
         {
             glUniform1i(location, v);
-            mValue[location] = vec;
         }
     }
 }
@@ -1787,12 +1852,10 @@ void LLGLSLShader::uniform1iv(const LLStaticHashedString& uniform, U32 count, co
     if (location >= 0)
     {
         LLVector4 vec((F32)v[0], 0.f, 0.f, 0.f);
-        const auto& iter = mValue.find(location);
-        if (iter == mValue.end() || shouldChange(iter->second, vec) || count != 1)
+        if (updateValue(location, vec, count != 1))
         {
             LL_PROFILE_ZONE_SCOPED_CATEGORY_SHADER;
             glUniform1iv(location, count, v);
-            mValue[location] = vec;
         }
     }
 }
@@ -1805,12 +1868,10 @@ void LLGLSLShader::uniform4iv(const LLStaticHashedString& uniform, U32 count, co
     if (location >= 0)
     {
         LLVector4 vec((F32)v[0], (F32)v[1], (F32)v[2], (F32)v[3]);
-        const auto& iter = mValue.find(location);
-        if (iter == mValue.end() || shouldChange(iter->second, vec) || count != 1)
+        if (updateValue(location, vec, count != 1))
         {
             LL_PROFILE_ZONE_SCOPED_CATEGORY_SHADER;
             glUniform4iv(location, count, v);
-            mValue[location] = vec;
         }
     }
 }
@@ -1822,12 +1883,10 @@ void LLGLSLShader::uniform2i(const LLStaticHashedString& uniform, GLint i, GLint
 
     if (location >= 0)
     {
-        const auto& iter = mValue.find(location);
         LLVector4 vec((F32)i, (F32)j, 0.f, 0.f);
-        if (iter == mValue.end() || shouldChange(iter->second, vec))
+        if (updateValue(location, vec))
         {
             glUniform2i(location, i, j);
-            mValue[location] = vec;
         }
     }
 }
@@ -1840,12 +1899,10 @@ void LLGLSLShader::uniform1f(const LLStaticHashedString& uniform, GLfloat v)
 
     if (location >= 0)
     {
-        const auto& iter = mValue.find(location);
         LLVector4 vec(v, 0.f, 0.f, 0.f);
-        if (iter == mValue.end() || shouldChange(iter->second, vec))
+        if (updateValue(location, vec))
         {
             glUniform1f(location, v);
-            mValue[location] = vec;
         }
     }
 }
@@ -1857,12 +1914,10 @@ void LLGLSLShader::uniform2f(const LLStaticHashedString& uniform, GLfloat x, GLf
 
     if (location >= 0)
     {
-        const auto& iter = mValue.find(location);
         LLVector4 vec(x, y, 0.f, 0.f);
-        if (iter == mValue.end() || shouldChange(iter->second, vec))
+        if (updateValue(location, vec))
         {
             glUniform2f(location, x, y);
-            mValue[location] = vec;
         }
     }
 
@@ -1875,12 +1930,10 @@ void LLGLSLShader::uniform3f(const LLStaticHashedString& uniform, GLfloat x, GLf
 
     if (location >= 0)
     {
-        const auto& iter = mValue.find(location);
         LLVector4 vec(x, y, z, 0.f);
-        if (iter == mValue.end() || shouldChange(iter->second, vec))
+        if (updateValue(location, vec))
         {
             glUniform3f(location, x, y, z);
-            mValue[location] = vec;
         }
     }
 }
@@ -1892,12 +1945,10 @@ void LLGLSLShader::uniform1fv(const LLStaticHashedString& uniform, U32 count, co
 
     if (location >= 0)
     {
-        const auto& iter = mValue.find(location);
         LLVector4 vec(v[0], 0.f, 0.f, 0.f);
-        if (iter == mValue.end() || shouldChange(iter->second, vec) || count != 1)
+        if (updateValue(location, vec, count != 1))
         {
             glUniform1fv(location, count, v);
-            mValue[location] = vec;
         }
     }
 }
@@ -1909,12 +1960,10 @@ void LLGLSLShader::uniform2fv(const LLStaticHashedString& uniform, U32 count, co
 
     if (location >= 0)
     {
-        const auto& iter = mValue.find(location);
         LLVector4 vec(v[0], v[1], 0.f, 0.f);
-        if (iter == mValue.end() || shouldChange(iter->second, vec) || count != 1)
+        if (updateValue(location, vec, count != 1))
         {
             glUniform2fv(location, count, v);
-            mValue[location] = vec;
         }
     }
 }
@@ -1926,12 +1975,10 @@ void LLGLSLShader::uniform3fv(const LLStaticHashedString& uniform, U32 count, co
 
     if (location >= 0)
     {
-        const auto& iter = mValue.find(location);
         LLVector4 vec(v[0], v[1], v[2], 0.f);
-        if (iter == mValue.end() || shouldChange(iter->second, vec) || count != 1)
+        if (updateValue(location, vec, count != 1))
         {
             glUniform3fv(location, count, v);
-            mValue[location] = vec;
         }
     }
 }
@@ -1943,13 +1990,21 @@ void LLGLSLShader::uniform4fv(const LLStaticHashedString& uniform, U32 count, co
 
     if (location >= 0)
     {
+        if (count != 1)
+        {
+            if (shouldChangeArray(location, count * 4, v))
+            {
+                glUniform4fv(location, count, v);
+            }
+            return;
+        }
+
         LLVector4 vec(v);
-        const auto& iter = mValue.find(location);
-        if (iter == mValue.end() || shouldChange(iter->second, vec) || count != 1)
+        if (updateValue(location, vec))
         {
             LL_PROFILE_ZONE_SCOPED_CATEGORY_SHADER;
             glUniform4fv(location, count, v);
-            mValue[location] = vec;
+            mArrayValue.erase(location);
         }
     }
 }
@@ -1962,12 +2017,10 @@ void LLGLSLShader::uniform4uiv(const LLStaticHashedString& uniform, U32 count, c
     if (location >= 0)
     {
         LLVector4 vec((F32)v[0], (F32)v[1], (F32)v[2], (F32)v[3]);
-        const auto& iter = mValue.find(location);
-        if (iter == mValue.end() || shouldChange(iter->second, vec) || count != 1)
+        if (updateValue(location, vec, count != 1))
         {
             LL_PROFILE_ZONE_SCOPED_CATEGORY_SHADER;
             glUniform4uiv(location, count, v);
-            mValue[location] = vec;
         }
     }
 }
@@ -58,6 +58,7 @@ public:
     bool attachNothing = false;
     bool hasHeroProbes = false;
     bool isPBRTerrain = false;
+    bool isGPUTerrain = false; // terrain vertices are generated from a height map, see terrainGPUUtilV.glsl
 };
 
 // ============= Structure for caching shader uniforms ===============
@@ -152,6 +153,8 @@ public:
         UB_GLTF_JOINTS,         // "GLTFJoints"
         UB_GLTF_NODES,          // "GLTFNodes"
         UB_GLTF_MATERIALS,      // "GLTFMaterials"
+        UB_AVATAR_PALETTE,      // "AvatarPalette"
+        UB_TREE_INSTANCES,      // "TreeInstances"
         NUM_UNIFORM_BLOCKS
     };
 
@@ -169,6 +172,11 @@ public:
     static U32 sMaxGLTFMaterials;
     static U32 sMaxGLTFNodes;
 
+    // uniform uploads issued and skipped because the value was unchanged,
+    // reset by whoever displays them
+    static U32 sUniformSets;
+    static U32 sRedundantUniformSets;
+
     static void initProfile();
     static void finishProfile(boost::json::value& stats=sDefaultStats);
 
@@ -302,8 +310,10 @@ public:
     U32 mAttributeMask;  //mask of which reserved attributes are set (lines up with LLVertexBuffer::getTypeMask())
     std::vector<GLint> mUniform;   //lookup table of uniform enum to uniform location
     LLStaticStringTable<GLint> mUniformMap; //lookup map of uniform name to uniform location
-    typedef std::unordered_map<GLint, LLVector4> uniform_value_map_t;
-    uniform_value_map_t mValue; //lookup map of uniform location to last known value
+    std::vector<LLVector4> mValue; //last known value of each uniform location
+    std::vector<bool> mValueSet;   //which entries of mValue are known
+    typedef std::unordered_map<GLint, std::vector<F32> > uniform_array_map_t;
+    uniform_array_map_t mArrayValue; //lookup map of uniform location to last known value of short arrays
     std::vector<GLint> mTexture;
     S32 mTotalUniformSize;
     S32 mActiveTextureChannels;
@@ -366,6 +376,13 @@ public:
 
 private:
     void unloadInternal();
+    // true if the array at 'location' must be uploaded, remembers 'v' if so
+    bool shouldChangeArray(GLint location, U32 floats, const GLfloat* v);
+    // true if 'value' must be uploaded to 'location' (always if force),
+    // remembers it if so
+    bool updateValue(GLint location, const LLVector4& value, bool force = false);
+    // forget the last known value of 'location'
+    void clearValue(GLint location);
     // This must be static because finishProfile() is called at least once
     // within a __try block. If we default its stats parameter to a temporary
     // json::value, that temporary must be destroyed when the stack is
@@ -34,6 +34,7 @@
 #include "llerror.h"
 #include "llfasttimer.h"
 #include "llimage.h"
+#include "llimagebcn.h"
 
 #include "llmath.h"
 #include "llgl.h"
@@ -41,6 +42,7 @@
 #include "llrender.h"
 #include "llwindow.h"
 #include "llframetimer.h"
+#include <mutex>
 #include <unordered_set>
 
 extern LL_COMMON_API bool on_main_thread();
@@ -141,12 +143,118 @@ bool LLImageGL::sGlobalUseAnisotropic   = false;
 F32 LLImageGL::sLastFrameTime           = 0.f;
 LLImageGL* LLImageGL::sDefaultGLTexture = NULL ;
 bool LLImageGL::sCompressTextures = false;
+bool LLImageGL::sTranscodeTextures = false;
 std::unordered_set<LLImageGL*> LLImageGL::sImageList;
 
 
 bool LLImageGLThread::sEnabledTextures = false;
 bool LLImageGLThread::sEnabledMedia = false;
 
+// Persistently mapped pixel unpack buffer that media frames are copied into
+// before their upload, see LLImageGL::setSubImageStreamed(). Split in parts
+// used in turn, a fence placed when moving on from a part tells when it may
+// be written again. Uploads of all media instances share the part being
+// filled, so they share their fence too.
+class LLSubImageRing
+{
+public:
+    static constexpr U32 SEGMENT_COUNT = 3;
+    static constexpr U32 SEGMENT_SIZE = 8 * 1024 * 1024;
+
+    ~LLSubImageRing()
+    {
+        cleanup();
+    }
+
+    U8* allocate(U32 size, U32& offset)
+    {
+        if (!mData && (mFailed || !init()))
+        {
+            return nullptr;
+        }
+
+        size = (size + 0xF) & ~0xF;
+        if (size > SEGMENT_SIZE)
+        {
+            return nullptr;
+        }
+
+        if (mHead + size > (mSegment + 1) * SEGMENT_SIZE)
+        {
+            // the uploads reading the part are all issued, fence them and
+            // wait for the oldest part, normally long done
+            mFences[mSegment].placeFence();
+            mSegment = (mSegment + 1) % SEGMENT_COUNT;
+            mHead = mSegment * SEGMENT_SIZE;
+
+            LL_PROFILE_ZONE_NAMED_CATEGORY_TEXTURE("sub image ring wait");
+            mFences[mSegment].wait();
+        }
+
+        offset = mHead;
+        mHead += size;
+        return mData + offset;
+    }
+
+    void cleanup()
+    {
+        if (mName)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mName);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            glDeleteBuffers(1, &mName);
+            mName = 0;
+        }
+        mData = nullptr;
+    }
+
+    GLuint  mName = 0;
+
+private:
+    bool init()
+    {
+        LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+        mFailed = true;
+        if (gGLManager.mIsApple || gGLManager.mGLVersion < 4.39f || !glBufferStorage)
+        {
+            return false;
+        }
+
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        constexpr U32 size = SEGMENT_COUNT * SEGMENT_SIZE;
+
+        glGenBuffers(1, &mName);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mName);
+        glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+        mData = (U8*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (!mData)
+        {
+            LL_WARNS("RenderInit") << "Could not map sub image ring, uploading media from client memory" << LL_ENDL;
+            cleanup();
+            return false;
+        }
+
+        LL_INFOS("RenderInit") << "Uploading media through a " << (size >> 20) << " MB ring" << LL_ENDL;
+        mFailed = false;
+        mHead = 0;
+        mSegment = 0;
+        return true;
+    }
+
+    U8*             mData = nullptr;
+    LLGLSyncFence   mFences[SEGMENT_COUNT];
+    U32             mHead = 0;
+    U32             mSegment = 0;
+    bool            mFailed = false;
+};
+
+static LLSubImageRing* sSubImageRing = nullptr;
+// media updates run on the LLImageGL thread or the main thread, depending on
+// RenderGLMultiThreadedMedia
+static std::mutex sSubImageRingMutex;
+
 //****************************************************************************************************
 //The below for texture auditing use only
 //****************************************************************************************************
@@ -254,6 +362,11 @@ void LLImageGL::initClass(LLWindow* window, S32 num_catagories, bool skip_analyz
         glGenBuffers(1, &sScratchPBO);
     }
 
+    if (!sSubImageRing)
+    {
+        sSubImageRing = new LLSubImageRing();
+    }
+
     if (thread_texture_loads || thread_media_updates)
     {
         LLImageGLThread::createInstance(window);
@@ -267,6 +380,8 @@ void LLImageGL::cleanupClass()
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
     LLImageGLThread::deleteSingleton();
+    delete sSubImageRing;
+    sSubImageRing = nullptr;
     if (sScratchPBO != 0)
     {
         glDeleteBuffers(1, &sScratchPBO);
@@ -290,12 +405,16 @@ S32 LLImageGL::dataFormatBits(S32 dataformat)
     case GL_COMPRESSED_LUMINANCE:                   return 8;
     case GL_COMPRESSED_LUMINANCE_ALPHA:             return 16;
     case GL_COMPRESSED_ALPHA:                       return 8;
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:           return 4;
+    case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:          return 4;
     case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:          return 4;
     case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:    return 4;
     case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:          return 8;
     case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:    return 8;
     case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:          return 8;
     case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:    return 8;
+    case GL_COMPRESSED_RED_RGTC1:                   return 4;
+    case GL_COMPRESSED_RG_RGTC2:                    return 8;
     case GL_LUMINANCE:                              return 8;
     case GL_LUMINANCE8:                             return 8;
     case GL_ALPHA:                                  return 8;
@@ -335,12 +454,16 @@ S64 LLImageGL::dataFormatBytes(S32 dataformat, S32 width, S32 height)
 {
     switch (dataformat)
     {
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
     case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
     case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
     case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
     case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
     case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
     case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+    case GL_COMPRESSED_RED_RGTC1:
+    case GL_COMPRESSED_RG_RGTC2:
         if (width < 4) width = 4;
         if (height < 4) height = 4;
         break;
@@ -357,12 +480,16 @@ S32 LLImageGL::dataFormatComponents(S32 dataformat)
 {
     switch (dataformat)
     {
+      case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:     return 3;
+      case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:    return 3;
       case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:    return 3;
       case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT: return 3;
       case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:    return 4;
       case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT: return 4;
       case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:    return 4;
       case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT: return 4;
+      case GL_COMPRESSED_RED_RGTC1:             return 1;
+      case GL_COMPRESSED_RG_RGTC2:              return 2;
       case GL_LUMINANCE:                        return 1;
       case GL_ALPHA:                            return 1;
       case GL_RED:                              return 1;
@@ -547,6 +674,7 @@ void LLImageGL::init(bool usemipmaps, bool allow_compression)
     mFormatPrimary = (LLGLenum) 0;
     mFormatType = GL_UNSIGNED_BYTE;
     mFormatSwapBytes = false;
+    mTranscodedFormat = 0;
 
 #ifdef DEBUG_MISS
     mMissed = false;
@@ -723,6 +851,19 @@ bool LLImageGL::setImage(const U8* data_in, bool data_hasmips /* = false */, S32
 
     const bool is_compressed = isCompressed();
 
+    // Mipmapped images that the driver would compress anyway are block
+    // compressed here instead, this thread usually being the image GL
+    // thread. Compressed levels cannot be generated by the GL, so mips are
+    // built by hand in that case.
+    mTranscodedFormat = 0;
+    if (sCompressTextures && sTranscodeTextures && mAllowCompression && mUseMipMaps && data_in && !is_compressed &&
+        mTarget == GL_TEXTURE_2D && mFormatType == GL_UNSIGNED_BYTE && !mFormatSwapBytes &&
+        (getWidth(mCurrentDiscardLevel) & 3) == 0 && (getHeight(mCurrentDiscardLevel) & 3) == 0 &&
+        dataFormatComponents(mFormatPrimary) == mComponents)
+    {
+        mTranscodedFormat = getTranscodedFormat(mFormatInternal);
+    }
+
     if (mUseMipMaps)
     {
         //set has mip maps to true before binding image so tex parameters get set properly
@@ -779,7 +920,10 @@ bool LLImageGL::setImage(const U8* data_in, bool data_hasmips /* = false */, S32
                         stop_glerror();
                     }
 
-                    LLImageGL::setManualImage(mTarget, gl_level, mFormatInternal, w, h, mFormatPrimary, GL_UNSIGNED_BYTE, (GLvoid*)data_in, mAllowCompression);
+                    if (!mTranscodedFormat || !setTranscodedImage(gl_level, w, h, data_in))
+                    {
+                        LLImageGL::setManualImage(mTarget, gl_level, mFormatInternal, w, h, mFormatPrimary, GL_UNSIGNED_BYTE, (GLvoid*)data_in, mAllowCompression);
+                    }
                     if (gl_level == 0)
                     {
                         analyzeAlpha(data_in, w, h);
@@ -799,7 +943,7 @@ bool LLImageGL::setImage(const U8* data_in, bool data_hasmips /* = false */, S32
         }
         else if (!is_compressed)
         {
-            if (mAutoGenMips)
+            if (mAutoGenMips && !mTranscodedFormat)
             {
                 stop_glerror();
                 {
@@ -926,7 +1070,10 @@ bool LLImageGL::setImage(const U8* data_in, bool data_hasmips /* = false */, S32
                             stop_glerror();
                         }
 
-                        LLImageGL::setManualImage(mTarget, m, mFormatInternal, w, h, mFormatPrimary, mFormatType, cur_mip_data, mAllowCompression);
+                        if (!mTranscodedFormat || !setTranscodedImage(m, w, h, cur_mip_data))
+                        {
+                            LLImageGL::setManualImage(mTarget, m, mFormatInternal, w, h, mFormatPrimary, mFormatType, cur_mip_data, mAllowCompression);
+                        }
                         if (m == 0)
                         {
                             analyzeAlpha(data_in, w, h);
@@ -1003,6 +1150,67 @@ bool LLImageGL::setImage(const U8* data_in, bool data_hasmips /* = false */, S32
     return true;
 }
 
+bool LLImageGL::setTranscodedImage(S32 gl_level, S32 width, S32 height, const U8* data_in)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+
+    LLImageBCn::EFormat format = LLImageBCn::formatForComponents(mComponents);
+    S32 size = LLImageBCn::compressedBytes(format, width, height);
+
+    // A failed transcode leaves this level to setManualImage, the others
+    // keep the block format; mixed levels are legal GL
+    static thread_local std::vector<U8> scratch;
+    try
+    {
+        scratch.resize(size);
+    }
+    catch (std::bad_alloc&)
+    {
+        LL_WARNS() << "Failed to allocate " << size << " bytes for texture transcode" << LL_ENDL;
+        return false;
+    }
+    if (!LLImageBCn::compress(data_in, width, height, mComponents, format, scratch.data()))
+    {
+        return false;
+    }
+
+    free_cur_tex_image();
+    glCompressedTexImage2D(mTarget, gl_level, mTranscodedFormat, width, height, 0, size, scratch.data());
+    stop_glerror();
+    alloc_tex_image(width, height, mTranscodedFormat, 1);
+    return true;
+}
+
+//static
+LLGLenum LLImageGL::getTranscodedFormat(LLGLint internal_format)
+{
+    switch (internal_format)
+    {
+    case GL_R8:
+    case GL_RED:
+        return GL_COMPRESSED_RED_RGTC1;
+    case GL_RG8:
+    case GL_RG:
+        return GL_COMPRESSED_RG_RGTC2;
+    case GL_RGB8:
+    case GL_RGB:
+        return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case GL_SRGB8:
+    case GL_SRGB:
+        return GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
+    case GL_RGBA8:
+    case GL_RGBA:
+        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case GL_SRGB8_ALPHA8:
+    case GL_SRGB_ALPHA:
+        return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+    default:
+        // Luminance and alpha formats rely on swizzles set up by
+        // setManualImage, leave them to the driver
+        return 0;
+    }
+}
+
 U32 type_width_from_pixtype(U32 pixtype)
 {
     U32 type_width = 0;
@@ -1198,6 +1406,67 @@ bool LLImageGL::setSubImage(const U8* datap, S32 data_width, S32 data_height, S3
     return true;
 }
 
+bool LLImageGL::setSubImageStreamed(const U8* datap, S32 data_width, S32 data_height, S32 x_pos, S32 y_pos, S32 width, S32 height, LLGLuint use_name)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    LLGLuint tex_name = use_name != 0 ? use_name : mTexName;
+    const S32 components = getComponents();
+    const U32 row_size = width * components;
+
+    if (!width || !height || !tex_name || !datap || mUseMipMaps
+        || (row_size & 0x3) // rows are packed, keep them at the default unpack alignment
+        || x_pos < 0 || y_pos < 0
+        || x_pos + width > getWidth() || y_pos + height > getHeight()
+        || x_pos + width > data_width || y_pos + height > data_height)
+    {
+        // setSubImage() deals with, or complains about, all of these
+        return setSubImage(datap, data_width, data_height, x_pos, y_pos, width, height, false, use_name);
+    }
+
+    std::lock_guard<std::mutex> lock(sSubImageRingMutex);
+
+    U32 offset = 0;
+    U8* dst = sSubImageRing ? sSubImageRing->allocate(row_size * height, offset) : nullptr;
+    if (!dst)
+    {
+        return setSubImage(datap, data_width, data_height, x_pos, y_pos, width, height, false, use_name);
+    }
+
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_TEXTURE("ssis - copy");
+        const U8* src = datap + (y_pos * data_width + x_pos) * components;
+        for (S32 row = 0; row < height; ++row)
+        {
+            memcpy(dst, src, row_size);
+            dst += row_size;
+            src += data_width * components;
+        }
+    }
+
+    if (mFormatSwapBytes)
+    {
+        glPixelStorei(GL_UNPACK_SWAP_BYTES, 1);
+    }
+
+    bool res = gGL.getTexUnit(0)->bindManual(mBindTarget, tex_name);
+    if (!res) LL_ERRS() << "LLImageGL::setSubImageStreamed(): bindTexture failed" << LL_ENDL;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, sSubImageRing->mName);
+    glTexSubImage2D(mTarget, 0, x_pos, y_pos, width, height, mFormatPrimary, mFormatType, (const void*)(uintptr_t)offset);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    gGL.getTexUnit(0)->disable();
+
+    if (mFormatSwapBytes)
+    {
+        glPixelStorei(GL_UNPACK_SWAP_BYTES, 0);
+    }
+    stop_glerror();
+
+    mGLTextureCreated = true;
+    return true;
+}
+
 bool LLImageGL::setSubImage(const LLImageRaw* imageraw, S32 x_pos, S32 y_pos, S32 width, S32 height, bool force_fast_update /* = false */, LLGLuint use_name)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
@@ -1278,6 +1547,7 @@ void LLImageGL::deleteTextures(S32 numTextures, const U32 *textures)
         {
             free_tex_images((GLsizei) sFreeList[idx].size(), sFreeList[idx].data());
             glDeleteTextures((GLsizei)sFreeList[idx].size(), sFreeList[idx].data());
+            gGL.invalidateTextures((S32)sFreeList[idx].size(), sFreeList[idx].data());
             sFreeList[idx].resize(0);
         }
     }
@@ -1699,6 +1969,15 @@ bool LLImageGL::createGLTexture(S32 discard_level, const U8* data_in, bool data_
         mAutoGenMips = true;
     }
 
+    // When sharpening a texture, the levels it already has are copied over
+    // and only the new top levels are generated from the uploaded data
+    S32 copy_level = 0;
+    if (usename == 0 && old_texname != 0 && discard_level < mCurrentDiscardLevel &&
+        canCopyMips(data_in, data_hasmips, mCurrentDiscardLevel))
+    {
+        copy_level = mCurrentDiscardLevel - discard_level;
+        glTexParameteri(LLTexUnit::getInternalType(mBindTarget), GL_TEXTURE_MAX_LEVEL, copy_level - 1);
+    }
     mCurrentDiscardLevel = discard_level;
 
     {
@@ -1709,6 +1988,12 @@ bool LLImageGL::createGLTexture(S32 discard_level, const U8* data_in, bool data_
         }
     }
 
+    if (copy_level > 0)
+    {
+        copyMips(old_texname, new_texname, copy_level);
+        glTexParameteri(LLTexUnit::getInternalType(mBindTarget), GL_TEXTURE_MAX_LEVEL, mMaxDiscardLevel - discard_level);
+    }
+
     // Set texture options to our defaults.
     gGL.getTexUnit(0)->setHasMipMaps(mHasMipMaps);
     gGL.getTexUnit(0)->setTextureAddressMode(mAddressMode);
@@ -1745,6 +2030,42 @@ bool LLImageGL::createGLTexture(S32 discard_level, const U8* data_in, bool data_
     return true;
 }
 
+bool LLImageGL::canCopyMips(const U8* data_in, bool data_hasmips, S32 old_discard)
+{
+    // Formats that setManualImage converts, or that get compressed or
+    // transcoded, may not match between the two textures
+    return gGLManager.mGLVersion >= 4.29f && glCopyImageSubData &&
+        mUseMipMaps && mAutoGenMips && data_in && !data_hasmips && !isCompressed() &&
+        !(sCompressTextures && mAllowCompression) &&
+        mTarget == GL_TEXTURE_2D && mFormatType == GL_UNSIGNED_BYTE && !mFormatSwapBytes &&
+        (mFormatPrimary == GL_RGB || mFormatPrimary == GL_RGBA) &&
+        old_discard >= 0 && old_discard <= mMaxDiscardLevel &&
+        getWidth(old_discard) > 0 && getHeight(old_discard) > 0;
+}
+
+void LLImageGL::copyMips(LLGLuint old_texname, LLGLuint new_texname, S32 gl_level)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    LL_PROFILE_GPU_ZONE("copy mips");
+
+    // match the internal format the top level was actually given
+    GLint intformat = mFormatInternal;
+    glGetTexLevelParameteriv(mTarget, 0, GL_TEXTURE_INTERNAL_FORMAT, &intformat);
+
+    for (S32 d = mCurrentDiscardLevel + gl_level; d <= mMaxDiscardLevel; ++d)
+    {
+        S32 w = getWidth(d);
+        S32 h = getHeight(d);
+        S32 level = d - mCurrentDiscardLevel;
+
+        // allocated directly so the memory tracking keeps the size of level 0
+        glTexImage2D(mTarget, level, intformat, w, h, 0, mFormatPrimary, mFormatType, nullptr);
+        glCopyImageSubData(old_texname, mTarget, level - gl_level, 0, 0, 0,
+                           new_texname, mTarget, level, 0, 0, 0, w, h, 1);
+    }
+    stop_glerror();
+}
+
 void LLImageGL::syncToMainThread(LLGLuint new_tex_name)
 {
     LL_PROFILE_ZONE_SCOPED;
@@ -2038,7 +2359,7 @@ S64 LLImageGL::getBytes(S32 discard_level) const
     S32 h = mHeight>>discard_level;
     if (w == 0) w = 1;
     if (h == 0) h = 1;
-    return dataFormatBytes(mFormatPrimary, w, h);
+    return dataFormatBytes(mTranscodedFormat ? mTranscodedFormat : mFormatPrimary, w, h);
 }
 
 S64 LLImageGL::getMipBytes(S32 discard_level) const
@@ -2049,14 +2370,15 @@ S64 LLImageGL::getMipBytes(S32 discard_level) const
     }
     S32 w = mWidth>>discard_level;
     S32 h = mHeight>>discard_level;
-    S64 res = dataFormatBytes(mFormatPrimary, w, h);
+    const LLGLenum format = mTranscodedFormat ? mTranscodedFormat : mFormatPrimary;
+    S64 res = dataFormatBytes(format, w, h);
     if (mUseMipMaps)
     {
         while (w > 1 && h > 1)
         {
             w >>= 1; if (w == 0) w = 1;
             h >>= 1; if (h == 0) h = 1;
-            res += dataFormatBytes(mFormatPrimary, w, h);
+            res += dataFormatBytes(format, w, h);
         }
     }
     return res;
@@ -113,6 +113,14 @@ protected:
 
     void analyzeAlpha(const void* data_in, U32 w, U32 h);
     void calcAlphaChannelOffsetAndStride();
+    // Block compresses one mip level into mTranscodedFormat and uploads it
+    bool setTranscodedImage(S32 gl_level, S32 width, S32 height, const U8* data_in);
+    // Whether the lower levels of a texture sharpened from old_discard can be
+    // copied from its current GL texture rather than generated again
+    bool canCopyMips(const U8* data_in, bool data_hasmips, S32 old_discard);
+    // Allocates the levels of new_texname from gl_level down and copies them
+    // from old_texname, which has them starting at its level 0
+    void copyMips(LLGLuint old_texname, LLGLuint new_texname, S32 gl_level);
 
 public:
     virtual void dump();    // debugging info to LL_INFOS()
@@ -123,6 +131,10 @@ public:
 
     static void setManualImage(U32 target, S32 miplevel, S32 intformat, S32 width, S32 height, U32 pixformat, U32 pixtype, const void *pixels, bool allow_compression = true);
 
+    // Block compressed format that an image with the given internal format
+    // is transcoded to on upload, or 0 if it is uploaded as is.
+    static LLGLenum getTranscodedFormat(LLGLint internal_format);
+
     bool createGLTexture() ;
     bool createGLTexture(S32 discard_level, const LLImageRaw* imageraw, S32 usename = 0, bool to_create = true,
         S32 category = sMaxCategories-1, bool defer_copy = false, LLGLuint* tex_name = nullptr);
@@ -134,6 +146,11 @@ public:
     // compressed textures.
     bool setSubImage(const LLImageRaw* imageraw, S32 x_pos, S32 y_pos, S32 width, S32 height, bool force_fast_update = false, LLGLuint use_name = 0);
     bool setSubImage(const U8* datap, S32 data_width, S32 data_height, S32 x_pos, S32 y_pos, S32 width, S32 height, bool force_fast_update = false, LLGLuint use_name = 0);
+    // Same as setSubImage(), but the rows are copied once into a persistently
+    // mapped pixel unpack buffer shared by all callers and the upload is done
+    // from there, without waiting for the driver to copy client memory. Meant
+    // for media frames. Falls back to setSubImage() without GL 4.4.
+    bool setSubImageStreamed(const U8* datap, S32 data_width, S32 data_height, S32 x_pos, S32 y_pos, S32 width, S32 height, LLGLuint use_name = 0);
     bool setSubImageFromFrameBuffer(S32 fb_x, S32 fb_y, S32 x_pos, S32 y_pos, S32 width, S32 height);
 
     // wait for gl commands to finish on current thread and push
@@ -272,6 +289,7 @@ protected:
     LLGLenum mFormatPrimary;  // = GL format (pixel data format)
     LLGLenum mFormatType;
     bool     mFormatSwapBytes;// if true, use glPixelStorei(GL_UNPACK_SWAP_BYTES, 1)
+    LLGLenum mTranscodedFormat; // block compressed format of the last upload, 0 if uncompressed
 
     bool mExternalTexture;
 
@@ -289,6 +307,7 @@ public:
     static LLImageGL* sDefaultGLTexture ;
     static bool sAutomatedTest;
     static bool sCompressTextures;          //use GL texture compression
+    static bool sTranscodeTextures;         //block compress on the CPU rather than in the driver
 #if DEBUG_MISS
     bool mMissed; // Missed on last bind?
     bool getMissed() const { return mMissed; };
@@ -66,6 +66,7 @@ S32 gGLViewport[4];
 
 U32 LLRender::sUICalls = 0;
 U32 LLRender::sUIVerts = 0;
+U32 LLRender::sRedundantGLCalls = 0;
 U32 LLTexUnit::sWhiteTexture = 0;
 bool LLRender::sGLCoreProfile = false;
 bool LLRender::sNsightDebugSupport = false;
@@ -160,6 +161,10 @@ void LLTexUnit::activate(void)
         glActiveTexture(GL_TEXTURE0 + mIndex);
         gGL.mCurrTextureUnitIndex = mIndex;
     }
+    else
+    {
+        ++LLRender::sRedundantGLCalls;
+    }
 }
 
 void LLTexUnit::enable(eTextureType type)
@@ -196,9 +201,24 @@ void LLTexUnit::bindFast(LLTexture* texture)
 {
     LLImageGL* gl_tex = texture->getGLTexture();
     texture->setActive();
-    glActiveTexture(GL_TEXTURE0 + mIndex);
-    gGL.mCurrTextureUnitIndex = mIndex;
-    mCurrTexture = gl_tex->getTexName();
+    U32 name = gl_tex->getTexName();
+    if (name && name == mCurrTexture && !gGL.mDirty)
+    {
+        // already bound here, and binding doesn't have to leave this unit active
+        LLRender::sRedundantGLCalls += 2;
+        mHasMipMaps = gl_tex->mHasMipMaps;
+        return;
+    }
+    if ((S32)gGL.mCurrTextureUnitIndex != mIndex || gGL.mDirty)
+    {
+        glActiveTexture(GL_TEXTURE0 + mIndex);
+        gGL.mCurrTextureUnitIndex = mIndex;
+    }
+    else
+    {
+        ++LLRender::sRedundantGLCalls;
+    }
+    mCurrTexture = name;
     if (!mCurrTexture)
     {
         LL_PROFILE_ZONE_NAMED("MISSING TEXTURE");
@@ -245,6 +265,10 @@ bool LLTexUnit::bind(LLTexture* texture, bool for_rendering, bool forceBind)
                         setTextureFilteringOption(gl_tex->mFilterOption);
                     }
                 }
+                else
+                {
+                    ++LLRender::sRedundantGLCalls;
+                }
             }
             else
             {
@@ -324,6 +348,10 @@ bool LLTexUnit::bind(LLImageGL* texture, bool for_rendering, bool forceBind, S32
             stop_glerror();
         }
     }
+    else
+    {
+        ++LLRender::sRedundantGLCalls;
+    }
 
     stop_glerror();
 
@@ -413,6 +441,10 @@ bool LLTexUnit::bindManual(eTextureType type, U32 texture, bool hasMips)
         glBindTexture(sGLTextureType[type], texture);
         mHasMipMaps = hasMips;
     }
+    else
+    {
+        ++LLRender::sRedundantGLCalls;
+    }
 
     return true;
 }
@@ -821,7 +853,8 @@ LLRender::LLRender()
   : mDirty(false),
     mCount(0),
     mMode(LLRender::TRIANGLES),
-    mCurrTextureUnitIndex(0)
+    mCurrTextureUnitIndex(0),
+    mListMask(0)
 {
     for (U32 i = 0; i < LL_NUM_TEXTURE_LAYERS; i++)
     {
@@ -922,6 +955,7 @@ void LLRender::initVertexBuffer()
 void LLRender::resetVertexBuffer()
 {
     mBuffer = NULL;
+    mStreamBuffer = NULL;
 }
 
 void LLRender::shutdown()
@@ -1428,6 +1462,10 @@ void LLRender::blendFunc(eBlendFactor sfactor, eBlendFactor dfactor)
         flush();
         glBlendFunc(sGLBlendFactor[sfactor], sGLBlendFactor[dfactor]);
     }
+    else
+    {
+        ++sRedundantGLCalls;
+    }
 }
 
 void LLRender::blendFunc(eBlendFactor color_sfactor, eBlendFactor color_dfactor,
@@ -1450,6 +1488,22 @@ void LLRender::blendFunc(eBlendFactor color_sfactor, eBlendFactor color_dfactor,
         glBlendFuncSeparate(sGLBlendFactor[color_sfactor], sGLBlendFactor[color_dfactor],
                             sGLBlendFactor[alpha_sfactor], sGLBlendFactor[alpha_dfactor]);
     }
+    else
+    {
+        ++sRedundantGLCalls;
+    }
+}
+
+void LLRender::invalidateTextures(S32 count, const U32* textures)
+{
+    for (LLTexUnit& unit : mTexUnits)
+    {
+        U32 bound = unit.getCurrTexture();
+        if (bound && std::find(textures, textures + count, bound) != textures + count)
+        {
+            unit.invalidateTexture(bound);
+        }
+    }
 }
 
 LLTexUnit* LLRender::getTexUnit(U32 index)
@@ -1519,6 +1573,7 @@ void LLRender::endList()
     if (sBufferDataList)
     {
         flush();
+        uploadList();
         sBufferDataList = nullptr;
     }
     else
@@ -1607,15 +1662,33 @@ void LLRender::flush()
 
             if (sBufferDataList)
             {
-                vb = genBuffer(attribute_mask, count);
+                // drawn now from the stream ring, kept as a range of the
+                // buffer the whole list gets at endList()
+                U32 first = (U32)mListVertices.size();
+                vb = nullptr;
+                if (!first || attribute_mask == mListMask)
+                {
+                    vb = genStreamBuffer(attribute_mask, count);
+                }
+                bool shared = vb != nullptr;
+                if (shared)
+                {
+                    appendToList(attribute_mask, count);
+                }
+                else
+                {
+                    vb = genBuffer(attribute_mask, count);
+                    first = 0;
+                }
                 sBufferDataList->emplace_back(
-                    vb,
+                    shared ? nullptr : vb,
                     mMode,
                     count,
                     gGL.getTexUnit(0)->mCurrTexture,
                     mMatrix[MM_MODELVIEW][mMatIdx[MM_MODELVIEW]],
                     mMatrix[MM_PROJECTION][mMatIdx[MM_PROJECTION]],
-                    mMatrix[MM_TEXTURE0][mMatIdx[MM_TEXTURE0]]
+                    mMatrix[MM_TEXTURE0][mMatIdx[MM_TEXTURE0]],
+                    first
                     );
             }
             else
@@ -1670,9 +1743,15 @@ LLVertexBuffer* LLRender::bufferfromCache(U32 attribute_mask, U32 count)
     // cache just before creating a vertex buffer in VRAM
     std::unordered_map<U64, LLVBCache>::iterator cache = sVBCache.find(vhash);
 
+    // Geometry seen for the first time is streamed through the ring if there
+    // is one, and only gets a buffer of its own if it comes back.
     if (cache != sVBCache.end())
     {
         LL_PROFILE_ZONE_NAMED_CATEGORY_VERTEX("vb cache hit");
+        if (cache->second.vb.isNull())
+        {
+            cache->second.vb = genBuffer(attribute_mask, count);
+        }
         // cache hit, just use the cached buffer
         vb = cache->second.vb;
         cache->second.touched = std::chrono::steady_clock::now();
@@ -1680,9 +1759,16 @@ LLVertexBuffer* LLRender::bufferfromCache(U32 attribute_mask, U32 count)
     else
     {
         LL_PROFILE_ZONE_NAMED_CATEGORY_VERTEX("vb cache miss");
-        vb = genBuffer(attribute_mask, count);
-
-        sVBCache[vhash] = { vb , std::chrono::steady_clock::now() };
+        vb = genStreamBuffer(attribute_mask, count);
+        if (vb)
+        {
+            sVBCache[vhash] = { nullptr, std::chrono::steady_clock::now() };
+        }
+        else
+        {
+            vb = genBuffer(attribute_mask, count);
+            sVBCache[vhash] = { vb , std::chrono::steady_clock::now() };
+        }
 
         static U32 miss_count = 0;
         miss_count++;
@@ -1715,7 +1801,88 @@ LLVertexBuffer* LLRender::genBuffer(U32 attribute_mask, S32 count)
 {
     LLVertexBuffer * vb = new LLVertexBuffer(attribute_mask);
     vb->allocateBuffer(count, 0);
+    fillBuffer(vb, attribute_mask);
+    return vb;
+}
+
+LLVertexBuffer* LLRender::genStreamBuffer(U32 attribute_mask, S32 count)
+{
+    // the last batch is done with its part of the ring once drawn, so its
+    // buffer object takes the next part unless someone else holds it
+    LLPointer<LLVertexBuffer> vb;
+    if (mStreamBuffer.notNull() && mStreamBuffer->getNumRefs() == 1 && mStreamBuffer->getTypeMask() == attribute_mask)
+    {
+        vb = mStreamBuffer;
+    }
+    else
+    {
+        vb = new LLVertexBuffer(attribute_mask);
+    }
+    if (!vb->allocateStreamBuffer(count))
+    {
+        return nullptr;
+    }
+    fillBuffer(vb, attribute_mask);
+
+    // drawn right away, keep it until the next one
+    mStreamBuffer = vb;
+    return vb;
+}
+
+void LLRender::appendToList(U32 attribute_mask, U32 count)
+{
+    mListMask = attribute_mask;
+    mListVertices.insert(mListVertices.end(), mVerticesp.get(), mVerticesp.get() + count);
+    if (attribute_mask & LLVertexBuffer::MAP_TEXCOORD0)
+    {
+        mListTexcoords.insert(mListTexcoords.end(), mTexcoordsp.get(), mTexcoordsp.get() + count);
+    }
+    if (attribute_mask & LLVertexBuffer::MAP_COLOR)
+    {
+        mListColors.insert(mListColors.end(), mColorsp.get(), mColorsp.get() + count);
+    }
+}
 
+void LLRender::uploadList()
+{
+    if (mListVertices.empty())
+    {
+        return;
+    }
+
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VERTEX;
+    LLPointer<LLVertexBuffer> vb = new LLVertexBuffer(mListMask);
+    vb->allocateBuffer((U32)mListVertices.size(), 0);
+    vb->setBuffer();
+    vb->setPositionData(mListVertices.data());
+    if (mListMask & LLVertexBuffer::MAP_TEXCOORD0)
+    {
+        vb->setTexCoord0Data(mListTexcoords.data());
+    }
+    if (mListMask & LLVertexBuffer::MAP_COLOR)
+    {
+        vb->setColorData(mListColors.data());
+    }
+#if LL_DARWIN
+    vb->unmapBuffer();
+#endif
+    vb->unbind();
+
+    for (LLVertexBufferData& data : *sBufferDataList)
+    {
+        if (data.mVB.isNull())
+        {
+            data.mVB = vb;
+        }
+    }
+
+    mListVertices.clear();
+    mListTexcoords.clear();
+    mListColors.clear();
+}
+
+void LLRender::fillBuffer(LLVertexBuffer* vb, U32 attribute_mask)
+{
     vb->setBuffer();
 
     vb->setPositionData(mVerticesp.get());
@@ -1734,8 +1901,6 @@ LLVertexBuffer* LLRender::genBuffer(U32 attribute_mask, S32 count)
     vb->unmapBuffer();
 #endif
     vb->unbind();
-
-    return vb;
 }
 
 void LLRender::drawBuffer(LLVertexBuffer* vb, U32 mode, S32 count)
@@ -179,7 +179,6 @@ public:
     //  - No need for gGL.flush()
     //  - texture is not null
     //  - gl_tex->getTexName() is not zero
-    //  - This texture is not being bound redundantly
     //  - USE_SRGB_DECODE is disabled
     //  - mTexOptionsDirty is false
     //  -
@@ -218,6 +217,10 @@ public:
 
     U32 getCurrTexture(void) { return mCurrTexture; }
 
+    // Forget the bound texture if it is 'texture', which is being deleted
+    // (GL unbinds deleted names, and the name may be handed out again)
+    void invalidateTexture(U32 texture) { if (mCurrTexture == texture) mCurrTexture = 0; }
+
     eTextureType getCurrType(void) { return mCurrTexType; }
 
     void setHasMipMaps(bool hasMips) { mHasMipMaps = hasMips; }
@@ -478,6 +481,9 @@ public:
 
     U32 getCurrentTexUnitIndex(void) const { return mCurrTextureUnitIndex; }
 
+    // Forget the given texture names on every unit they are bound to
+    void invalidateTextures(S32 count, const U32* textures);
+
     bool verifyTexUnitActive(U32 unitToVerify);
 
     void debugTexUnits(void);
@@ -494,6 +500,7 @@ public:
 public:
     static U32 sUICalls;
     static U32 sUIVerts;
+    static U32 sRedundantGLCalls; // state changes skipped because GL already had them
     static bool sGLCoreProfile;
     static bool sNsightDebugSupport;
     static LLVector2 sUIGLScaleFactor;
@@ -503,6 +510,10 @@ private:
 
     LLVertexBuffer* bufferfromCache(U32 attribute_mask, U32 count);
     LLVertexBuffer* genBuffer(U32 attribute_mask, S32 count);
+    LLVertexBuffer* genStreamBuffer(U32 attribute_mask, S32 count);
+    void appendToList(U32 attribute_mask, U32 count);
+    void uploadList();
+    void fillBuffer(LLVertexBuffer* vb, U32 attribute_mask);
     void drawBuffer(LLVertexBuffer* vb, U32 mode, S32 count);
     void resetStriders(S32 count);
 
@@ -521,6 +532,13 @@ private:
     bool                mCurrColorMask[4];
 
     LLPointer<LLVertexBuffer>   mBuffer;
+    LLPointer<LLVertexBuffer>   mStreamBuffer; // last batch drawn from the stream ring
+    // vertices of every batch flushed into the open list, uploaded into one
+    // buffer they all draw ranges of when the list ends
+    std::vector<LLVector4a>     mListVertices;
+    std::vector<LLVector2>      mListTexcoords;
+    std::vector<LLColor4U>      mListColors;
+    U32                         mListMask;
     LLStrider<LLVector4a>       mVerticesp;
     LLStrider<LLVector2>        mTexcoordsp;
     LLStrider<LLColor4U>        mColorsp;
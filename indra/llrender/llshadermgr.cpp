@@ -179,6 +179,14 @@ bool LLShaderMgr::attachShaderFeatures(LLGLSLShader * shader)
         return false;
     }
 
+    if (features->isGPUTerrain)
+    {
+        if (!shader->attachVertexObject("deferred/terrainGPUUtilV.glsl"))
+        {
+            return false;
+        }
+    }
+
     ///////////////////////////////////////
     // Attach Fragment Shader Features Next
     ///////////////////////////////////////
@@ -867,7 +875,12 @@ GLuint LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shader_lev
         }
     }
 
-    if (error == GL_NO_ERROR)
+    if (error == GL_NO_ERROR && mDeferredHandle)
+    {
+        // leave the driver compiling, finishDeferredCompile() checks the result
+        mDeferredShaderFiles.push_back({ ret, mDeferredHandle, filename, open_file_name, &shader_level, try_gpu_class, type, defines, texture_index_channels });
+    }
+    else if (error == GL_NO_ERROR)
     {
         //check for errors
         GLint success = GL_TRUE;
@@ -920,6 +933,63 @@ GLuint LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shader_lev
     return ret;
 }
 
+void LLShaderMgr::loadShaderFileDeferred(GLuint* handle, const std::string& filename, S32 & shader_level, GLenum type, std::map<std::string, std::string>* defines, S32 texture_index_channels)
+{
+    mDeferredHandle = handle;
+    *handle = loadShaderFile(filename, shader_level, type, defines, texture_index_channels);
+    mDeferredHandle = nullptr;
+}
+
+bool LLShaderMgr::finishDeferredCompile(std::string* failed_filename)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_SHADER;
+
+    bool success = true;
+
+    std::vector<DeferredShaderFile> pending;
+    pending.swap(mDeferredShaderFiles);
+    for (DeferredShaderFile& file : pending)
+    {
+        GLint compiled = GL_TRUE;
+        glGetShaderiv(file.mShader, GL_COMPILE_STATUS, &compiled);
+        if (compiled == GL_TRUE)
+        {
+            continue;
+        }
+
+        LL_WARNS("ShaderLoading") << "GLSL Compilation Error:" << LL_ENDL;
+        dumpObjectLog(file.mShader, true, file.mPath);
+
+        std::map<std::string, GLuint>& objects = file.mType == GL_VERTEX_SHADER ? mVertexShaderObjects : mFragmentShaderObjects;
+        auto iter = objects.find(file.mFilename);
+        if (iter != objects.end() && iter->second == file.mShader)
+        {
+            objects.erase(iter);
+        }
+        glDeleteShader(file.mShader);
+
+        // same fallback as loadShaderFile(), but without deferring
+        *file.mHandle = 0;
+        if (file.mTryLevel > 1)
+        {
+            *file.mShaderLevel = file.mTryLevel - 1;
+            *file.mHandle = loadShaderFile(file.mFilename, *file.mShaderLevel, file.mType, file.mDefines, file.mTextureIndexChannels);
+        }
+
+        if (!*file.mHandle)
+        {
+            LL_WARNS("ShaderLoading") << "Failed to load " << file.mFilename << LL_ENDL;
+            if (success && failed_filename)
+            {
+                *failed_filename = file.mFilename;
+            }
+            success = false;
+        }
+    }
+
+    return success;
+}
+
 bool LLShaderMgr::linkProgramObject(GLuint obj, bool suppress_errors)
 {
     //check for errors
@@ -1209,6 +1279,13 @@ void LLShaderMgr::initAttribsAndUniforms()
 
     llassert(mReservedUniforms.size() == LLShaderMgr::MULTI_LIGHT_FAR_Z+1);
 
+    mReservedUniforms.push_back("clusterLights");
+    mReservedUniforms.push_back("clusterGrid");
+    mReservedUniforms.push_back("clusterIndex");
+    mReservedUniforms.push_back("cluster_params");
+
+    llassert(mReservedUniforms.size() == LLShaderMgr::CLUSTER_PARAMS+1);
+
     //NOTE: MUST match order in eGLSLReservedUniforms
     mReservedUniforms.push_back("proj_mat");
     mReservedUniforms.push_back("proj_near");
@@ -1411,6 +1488,7 @@ void LLShaderMgr::initAttribsAndUniforms()
 
     mReservedUniforms.push_back("alpha_ramp");
     mReservedUniforms.push_back("paint_map");
+    mReservedUniforms.push_back("terrain_height_map");
 
     mReservedUniforms.push_back("detail_0_base_color");
     mReservedUniforms.push_back("detail_1_base_color");
@@ -1465,6 +1543,14 @@ void LLShaderMgr::initAttribsAndUniforms()
     mReservedUniforms.push_back("sun_up_factor");
     mReservedUniforms.push_back("moonlight_color");
 
+    mReservedUniforms.push_back("atmo_transmittance");
+    mReservedUniforms.push_back("atmo_ambient");
+    mReservedUniforms.push_back("atmo_extinction");
+    mReservedUniforms.push_back("atmo_blue_weight");
+    mReservedUniforms.push_back("atmo_haze_weight");
+
+    llassert(mReservedUniforms.size() == LLShaderMgr::ATMO_HAZE_WEIGHT+1);
+
     mReservedUniforms.push_back("debug_normal_draw_length");
 
     mReservedUniforms.push_back("edgesTex");
@@ -80,6 +80,10 @@ public:
         MULTI_LIGHT,                        //  "light"
         MULTI_LIGHT_COL,                    //  "light_col"
         MULTI_LIGHT_FAR_Z,                  //  "far_z"
+        CLUSTER_LIGHTS,                     //  "clusterLights"
+        CLUSTER_GRID,                       //  "clusterGrid"
+        CLUSTER_INDEX,                      //  "clusterIndex"
+        CLUSTER_PARAMS,                     //  "cluster_params"
         PROJECTOR_MATRIX,                   //  "proj_mat"
         PROJECTOR_NEAR,                     //  "proj_near"
         PROJECTOR_P,                        //  "proj_p"
@@ -262,6 +266,7 @@ public:
 
         TERRAIN_ALPHARAMP,                  //  "alpha_ramp"
         TERRAIN_PAINTMAP,                   //  "paint_map"
+        TERRAIN_HEIGHT_MAP,                 //  "terrain_height_map"
 
         TERRAIN_DETAIL0_BASE_COLOR,                //  "detail_0_base_color" (GLTF)
         TERRAIN_DETAIL1_BASE_COLOR,                //  "detail_1_base_color" (GLTF)
@@ -318,6 +323,12 @@ public:
         SUN_UP_FACTOR,                      //  "sun_up_factor"
         MOONLIGHT_COLOR,                    //  "moonlight_color"
 
+        ATMO_TRANSMITTANCE,                 //  "atmo_transmittance"
+        ATMO_AMBIENT,                       //  "atmo_ambient"
+        ATMO_EXTINCTION,                    //  "atmo_extinction"
+        ATMO_BLUE_WEIGHT,                   //  "atmo_blue_weight"
+        ATMO_HAZE_WEIGHT,                   //  "atmo_haze_weight"
+
         DEBUG_NORMAL_DRAW_LENGTH,           //  "debug_normal_draw_length"
 
         SMAA_EDGE_TEX,                      //  "edgesTex"
@@ -340,6 +351,13 @@ public:
     bool    linkProgramObject(GLuint obj, bool suppress_errors = false);
     bool    validateProgramObject(GLuint obj);
     GLuint loadShaderFile(const std::string& filename, S32 & shader_level, GLenum type, std::map<std::string, std::string>* defines = NULL, S32 texture_index_channels = -1);
+    // Like loadShaderFile(), but the compile status is not checked until
+    // finishDeferredCompile(), which lets drivers with parallel shader
+    // compilation work on several files at once. *handle, shader_level and
+    // defines must stay valid until then, finishDeferredCompile() replaces
+    // the handles of the files that failed with their fallback (or 0).
+    void loadShaderFileDeferred(GLuint* handle, const std::string& filename, S32 & shader_level, GLenum type, std::map<std::string, std::string>* defines = NULL, S32 texture_index_channels = -1);
+    bool finishDeferredCompile(std::string* failed_filename = nullptr);
 
     // Implemented in the application to actually point to the shader directory.
     virtual std::string getShaderDirPrefix(void) = 0; // Pure Virtual
@@ -376,6 +394,20 @@ public:
     std::string mShaderCacheDir;
 
 protected:
+    struct DeferredShaderFile
+    {
+        GLuint mShader;
+        GLuint* mHandle;
+        std::string mFilename;
+        std::string mPath;
+        S32* mShaderLevel;
+        S32 mTryLevel;
+        GLenum mType;
+        std::map<std::string, std::string>* mDefines;
+        S32 mTextureIndexChannels;
+    };
+    std::vector<DeferredShaderFile> mDeferredShaderFiles;
+    GLuint* mDeferredHandle = nullptr;
 
     // our parameter manager singleton instance
     static LLShaderMgr * sInstance;
@@ -604,6 +604,113 @@ public:
 
 static LLVBOPool* sVBOPool = nullptr;
 
+// Persistently and coherently mapped buffer that buffers drawn only once
+// are written into, instead of each getting a pooled VBO and a
+// glBufferSubData. Split in one part per frame in flight, a fence placed at
+// the end of a frame tells when its part may be written again.
+class LLStreamRing
+{
+public:
+    static constexpr U32 SEGMENT_COUNT = 3;
+    static constexpr U32 SEGMENT_SIZE = 4 * 1024 * 1024;
+
+    ~LLStreamRing()
+    {
+        cleanup();
+    }
+
+    bool allocate(U32 size, U32& offset)
+    {
+        if (!mData && (mFailed || !init()))
+        {
+            return false;
+        }
+
+        size = (size + 0xF) & ~0xF;
+        if (mHead + size > (mSegment + 1) * SEGMENT_SIZE)
+        {
+            LL_WARNS_ONCE("RenderInit") << "Stream ring full, drawing from pooled buffers for the rest of the frame" << LL_ENDL;
+            return false;
+        }
+
+        offset = mHead;
+        mHead += size;
+        return true;
+    }
+
+    void nextFrame()
+    {
+        if (!mData)
+        {
+            return;
+        }
+
+        mFences[mSegment].placeFence();
+        mSegment = (mSegment + 1) % SEGMENT_COUNT;
+        mHead = mSegment * SEGMENT_SIZE;
+
+        // normally long done, the part was drawn from SEGMENT_COUNT - 1 frames ago
+        LL_PROFILE_ZONE_NAMED_CATEGORY_VERTEX("stream ring wait");
+        mFences[mSegment].wait();
+    }
+
+    void cleanup()
+    {
+        if (mName)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, mName);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            LLVertexBuffer::sGLRenderBuffer = 0;
+            glDeleteBuffers(1, &mName);
+            mName = 0;
+        }
+        mData = nullptr;
+    }
+
+    GLuint  mName = 0;
+    U8*     mData = nullptr;
+
+private:
+    bool init()
+    {
+        LL_PROFILE_ZONE_SCOPED_CATEGORY_VERTEX;
+        mFailed = true;
+        if (gGLManager.mIsApple || gGLManager.mGLVersion < 4.39f || !glBufferStorage)
+        {
+            return false;
+        }
+
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        constexpr U32 size = SEGMENT_COUNT * SEGMENT_SIZE;
+
+        glGenBuffers(1, &mName);
+        glBindBuffer(GL_ARRAY_BUFFER, mName);
+        LLVertexBuffer::sGLRenderBuffer = mName;
+        glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+        mData = (U8*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+        if (!mData)
+        {
+            LL_WARNS("RenderInit") << "Could not map stream ring, streaming through pooled buffers" << LL_ENDL;
+            cleanup();
+            return false;
+        }
+
+        LL_INFOS("RenderInit") << "Streaming buffers through a " << (size >> 20) << " MB ring" << LL_ENDL;
+        mFailed = false;
+        mHead = 0;
+        mSegment = 0;
+        return true;
+    }
+
+    LLGLSyncFence   mFences[SEGMENT_COUNT];
+    U32             mHead = 0;
+    U32             mSegment = 0;
+    bool            mFailed = false;
+};
+
+static LLStreamRing* sStreamRing = nullptr;
+
 void LLVertexBufferData::drawWithMatrix()
 {
     if (!mVB)
@@ -633,7 +740,7 @@ void LLVertexBufferData::drawWithMatrix()
     gGL.loadMatrix(glm::value_ptr(mTexture0));
 
     mVB->setBuffer();
-    mVB->drawArrays(mMode, 0, mCount);
+    mVB->drawArrays(mMode, mFirst, mCount);
 
     gGL.popMatrix();
     gGL.matrixMode(LLRender::MM_PROJECTION);
@@ -661,7 +768,7 @@ void LLVertexBufferData::draw()
     }
 
     mVB->setBuffer();
-    mVB->drawArrays(mMode, 0, mCount);
+    mVB->drawArrays(mMode, mFirst, mCount);
 }
 
 //============================================================================
@@ -676,6 +783,7 @@ U64 LLVertexBuffer::getBytesAllocated()
 //
 //static
 U32 LLVertexBuffer::sGLRenderBuffer = 0;
+bool LLVertexBuffer::sStreamBuffers = true;
 U32 LLVertexBuffer::sGLRenderIndices = 0;
 U32 LLVertexBuffer::sLastMask = 0;
 U32 LLVertexBuffer::sVertexCount = 0;
@@ -913,6 +1021,41 @@ void LLVertexBuffer::drawRange(U32 mode, U32 start, U32 end, U32 count, U32 indi
     STOP_GLERROR;
 }
 
+void LLVertexBuffer::multiDraw(U32 mode, const U32* counts, const U32* indices_offsets, U32 draw_count) const
+{
+    llassert(mGLBuffer == sGLRenderBuffer);
+    llassert(mGLIndices == sGLRenderIndices);
+    gGL.syncMatrices();
+
+    // main thread only, like every other draw
+    static std::vector<GLsizei> gl_counts;
+    static std::vector<const GLvoid*> gl_offsets;
+    gl_counts.resize(draw_count);
+    gl_offsets.resize(draw_count);
+    for (U32 i = 0; i < draw_count; ++i)
+    {
+        llassert(indices_offsets[i] + counts[i] <= mNumIndices);
+        gl_counts[i] = (GLsizei) counts[i];
+        gl_offsets[i] = (const GLvoid*) (indices_offsets[i] * (size_t) mIndicesStride);
+    }
+
+    STOP_GLERROR;
+    glMultiDrawElements(sGLMode[mode], gl_counts.data(), mIndicesType, gl_offsets.data(), (GLsizei) draw_count);
+    STOP_GLERROR;
+}
+
+void LLVertexBuffer::drawInstanced(U32 mode, U32 count, U32 indices_offset, U32 instance_count) const
+{
+    llassert(indices_offset + count <= mNumIndices);
+    llassert(mGLBuffer == sGLRenderBuffer);
+    llassert(mGLIndices == sGLRenderIndices);
+    gGL.syncMatrices();
+    STOP_GLERROR;
+    glDrawElementsInstanced(sGLMode[mode], count, mIndicesType,
+        (GLvoid*) (indices_offset * (size_t) mIndicesStride), instance_count);
+    STOP_GLERROR;
+}
+
 void LLVertexBuffer::drawRangeFast(U32 mode, U32 start, U32 end, U32 count, U32 indices_offset) const
 {
     glDrawRangeElements(sGLMode[mode], start, end, count, mIndicesType,
@@ -953,6 +1096,11 @@ void LLVertexBuffer::initClass(LLWindow* window)
         sVBOPool = new LLDefaultVBOPool();
     }
 
+    if (sStreamBuffers && !gGLManager.mIsApple)
+    {
+        sStreamRing = new LLStreamRing();
+    }
+
 #if ENABLE_GL_WORK_QUEUE
     sQueue = new GLWorkQueue();
 
@@ -983,6 +1131,9 @@ void LLVertexBuffer::cleanupClass()
     delete sVBOPool;
     sVBOPool = nullptr;
 
+    delete sStreamRing;
+    sStreamRing = nullptr;
+
 #if ENABLE_GL_WORK_QUEUE
     sQueue->close();
     for (int i = 0; i < THREAD_COUNT; ++i)
@@ -997,6 +1148,15 @@ void LLVertexBuffer::cleanupClass()
 #endif
 }
 
+//static
+void LLVertexBuffer::updateClass()
+{
+    if (sStreamRing)
+    {
+        sStreamRing->nextFrame();
+    }
+}
+
 //----------------------------------------------------------------------------
 
 LLVertexBuffer::LLVertexBuffer(U32 typemask)
@@ -1171,7 +1331,14 @@ bool LLVertexBuffer::createGLIndices(U32 size)
 
 void LLVertexBuffer::destroyGLBuffer()
 {
-    if (mGLBuffer || mMappedData)
+    if (mStream)
+    { // the ring takes its part back when the GPU is done with the frame
+        mStream = false;
+        mSize = 0;
+        mGLBuffer = 0;
+        mMappedData = nullptr;
+    }
+    else if (mGLBuffer || mMappedData)
     {
         LL_PROFILE_ZONE_SCOPED_CATEGORY_VERTEX;
         //llassert(sVBOPool);
@@ -1239,6 +1406,33 @@ bool LLVertexBuffer::updateNumIndices(U32 nindices)
     return success;
 }
 
+bool LLVertexBuffer::allocateStreamBuffer(U32 nverts)
+{
+    U32 offset = 0;
+    U32 size = calcOffsets(mTypeMask, mOffsets, nverts);
+    if (!sStreamRing || size == 0 || !sStreamRing->allocate(size, offset))
+    {
+        return false;
+    }
+
+    destroyGLBuffer();
+    destroyGLIndices();
+
+    // the offsets are into the whole ring, like the attribute pointers
+    for (U32 i = 0; i < TYPE_MAX; ++i)
+    {
+        mOffsets[i] += offset;
+    }
+
+    mStream = true;
+    mGLBuffer = sStreamRing->mName;
+    mMappedData = sStreamRing->mData;
+    mSize = size;
+    mNumVerts = nverts;
+    mNumIndices = 0;
+    return true;
+}
+
 bool LLVertexBuffer::allocateBuffer(U32 nverts, U32 nindices)
 {
     if (nverts < 0 || nindices < 0)
@@ -1267,8 +1461,15 @@ bool expand_region(LLVertexBuffer::MappedRegion& region, U32 start, U32 end)
         return false;
     }
 
-    region.mStart = llmin(region.mStart, start);
-    region.mEnd = llmax(region.mEnd, end);
+    // don't write a region that already covers the range, see mapAll()
+    if (start < region.mStart)
+    {
+        region.mStart = start;
+    }
+    if (end > region.mEnd)
+    {
+        region.mEnd = end;
+    }
 
     return true;
 }
@@ -1285,7 +1486,7 @@ U8* LLVertexBuffer::mapVertexBuffer(LLVertexBuffer::AttributeType type, U32 inde
         count = mNumVerts - index;
     }
 
-    if (!gGLManager.mIsApple)
+    if (!gGLManager.mIsApple && !mStream)
     {
         U32 start = mOffsets[type] + sTypeSize[type] * index;
         U32 end = start + sTypeSize[type] * count-1;
@@ -1312,6 +1513,21 @@ U8* LLVertexBuffer::mapVertexBuffer(LLVertexBuffer::AttributeType type, U32 inde
 }
 
 
+void LLVertexBuffer::mapAll()
+{
+    for (U32 type = 0; type < TYPE_MAX; ++type)
+    {
+        if (hasDataType((AttributeType)type))
+        {
+            mapVertexBuffer((AttributeType)type, 0);
+        }
+    }
+    if (mNumIndices > 0)
+    {
+        mapIndexBuffer(0);
+    }
+}
+
 U8* LLVertexBuffer::mapIndexBuffer(U32 index, S32 count)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_VERTEX;
@@ -1357,7 +1573,13 @@ U8* LLVertexBuffer::mapIndexBuffer(U32 index, S32 count)
 //  dst -- mMappedData or mMappedIndexData
 void LLVertexBuffer::flush_vbo(GLenum target, U32 start, U32 end, void* data, U8* dst)
 {
-    if (gGLManager.mIsApple)
+    if (mStream)
+    {
+        // coherent mapping, nothing to send
+        llassert(target == GL_ARRAY_BUFFER);
+        memcpy(dst + start, data, end - start + 1);
+    }
+    else if (gGLManager.mIsApple)
     {
         // on OS X, flush_vbo doesn't actually write to the GL buffer, so be sure to call
         // _mapBuffer to tag the buffer for flushing to GL
@@ -1682,8 +1904,8 @@ void LLVertexBuffer::setBuffer()
 
         setupVertexBuffer();
     }
-    else if (sLastMask != data_mask)
-    {
+    else if (sLastMask != data_mask || mStream)
+    { // stream buffers share the ring, each at its own offsets
         setupVertexBuffer();
         sLastMask = data_mask;
     }
@@ -1802,7 +2024,7 @@ void LLVertexBuffer::setupVertexBuffer()
 
 void LLVertexBuffer::setPositionData(const LLVector4a* data)
 {
-    flush_vbo(GL_ARRAY_BUFFER, 0, sizeof(LLVector4a) * getNumVerts()-1, (U8*) data, mMappedData);
+    flush_vbo(GL_ARRAY_BUFFER, mOffsets[TYPE_VERTEX], mOffsets[TYPE_VERTEX] + sizeof(LLVector4a) * getNumVerts() - 1, (U8*) data, mMappedData);
 }
 
 void LLVertexBuffer::setTexCoord0Data(const LLVector2* data)
@@ -1858,7 +2080,7 @@ void LLVertexBuffer::setIndexData(const U32* data)
 
 void LLVertexBuffer::setPositionData(const LLVector4a* data, U32 offset, U32 count)
 {
-    flush_vbo(GL_ARRAY_BUFFER, offset * sizeof(LLVector4a), (offset + count) * sizeof(LLVector4a) - 1, (U8*)data, mMappedData);
+    flush_vbo(GL_ARRAY_BUFFER, mOffsets[TYPE_VERTEX] + offset * sizeof(LLVector4a), mOffsets[TYPE_VERTEX] + (offset + count) * sizeof(LLVector4a) - 1, (U8*)data, mMappedData);
 }
 
 void LLVertexBuffer::setNormalData(const LLVector4a* data, U32 offset, U32 count)
@@ -62,15 +62,17 @@ public:
     LLVertexBufferData()
         : mVB(nullptr)
         , mMode(0)
+        , mFirst(0)
         , mCount(0)
         , mTexName(0)
         , mProjection(glm::identity<glm::mat4>())
         , mModelView(glm::identity<glm::mat4>())
         , mTexture0(glm::identity<glm::mat4>())
     {}
-    LLVertexBufferData(LLVertexBuffer* buffer, U8 mode, U32 count, U32 tex_name, const glm::mat4& model_view, const glm::mat4& projection, const glm::mat4& texture0)
+    LLVertexBufferData(LLVertexBuffer* buffer, U8 mode, U32 count, U32 tex_name, const glm::mat4& model_view, const glm::mat4& projection, const glm::mat4& texture0, U32 first = 0)
         : mVB(buffer)
         , mMode(mode)
+        , mFirst(first)
         , mCount(count)
         , mTexName(tex_name)
         , mProjection(model_view)
@@ -79,8 +81,9 @@ public:
     {}
     void drawWithMatrix();
     void draw();
-    LLPointer<LLVertexBuffer> mVB;
+    LLPointer<LLVertexBuffer> mVB; // may be shared by all the draws of a list
     U8 mMode;
+    U32 mFirst;
     U32 mCount;
     U32 mTexName;
     glm::mat4 mProjection;
@@ -128,6 +131,9 @@ public:
     // flush any pending mapped buffers
     static void flushBuffers();
 
+    // once per frame, hands the stream ring over to the next frame
+    static void updateClass();
+
     //WARNING -- when updating these enums you MUST
     // 1 - update LLVertexBuffer::sTypeSize
     // 2 - update LLVertexBuffer::vb_type_name
@@ -195,10 +201,20 @@ public:
     // allocate buffer
     bool    allocateBuffer(U32 nverts, U32 nindices);
 
+    // allocate vertices for drawing once this frame from the persistently
+    // mapped stream ring (GL 4.4), no indices. Returns false if the ring is
+    // not available or full, use allocateBuffer() then.
+    bool    allocateStreamBuffer(U32 nverts);
+
     // map for data access (see also getFooStrider below)
     U8*     mapVertexBuffer(AttributeType type, U32 index, S32 count = -1);
     U8*     mapIndexBuffer(U32 index, S32 count = -1);
 
+    // map every attribute and the indices in full, after which the
+    // getFooStrider calls only read the mapped regions, so several threads
+    // may fill disjoint ranges of this buffer side by side
+    void    mapAll();
+
     // synonym for flushBuffers
     void    unmapBuffer();
 
@@ -272,6 +288,12 @@ public:
     void drawArrays(U32 mode, U32 offset, U32 count) const;
     void drawRange(U32 mode, U32 start, U32 end, U32 count, U32 indices_offset) const;
 
+    // draw draw_count index ranges in one call, see glMultiDrawElements
+    void multiDraw(U32 mode, const U32* counts, const U32* indices_offsets, U32 draw_count) const;
+
+    // draw the index range instance_count times, see glDrawElementsInstanced
+    void drawInstanced(U32 mode, U32 count, U32 indices_offset, U32 instance_count) const;
+
     // draw without syncing matrices.  If you're positive there have been no matrix
     // since the last call to syncMatrices, this is much faster than drawRange
     void drawRangeFast(U32 mode, U32 start, U32 end, U32 count, U32 indices_offset) const;
@@ -329,12 +351,16 @@ private:
     void _mapBuffer();
     bool mMapped = false;
 
+    // allocated from the stream ring
+    bool mStream = false;
+
 public:
 
     static U64 getBytesAllocated();
     static const U32 sTypeSize[TYPE_MAX];
     static const U32 sGLMode[LLRender::NUM_MODES];
     static U32 sGLRenderBuffer;
+    static bool sStreamBuffers; // "RenderStreamBuffers", read before initClass()
     static U32 sGLRenderIndices;
     static U32 sLastMask;
     static U32 sVertexCount;
@@ -2110,6 +2110,7 @@ void LLFloater::updateTransparency(LLView* view, ETypeTransparency transparency_
 void LLFloater::updateTransparency(ETypeTransparency transparency_type)
 {
     updateTransparency(this, transparency_type);
+    dirtyRect();
 }
 
 void    LLFloater::setCanMinimize(bool can_minimize)
@@ -3430,7 +3431,7 @@ bool LLFloater::initFloaterXML(LLXMLNodePtr node, LLView *parent, const std::str
 
         LLUICtrlFactory::instance().pushFileName(xml_filename);
 
-        if (!LLUICtrlFactory::getLayeredXMLNode(xml_filename, referenced_xml))
+        if (!LLUICtrlFactory::getLayoutXMLNode(xml_filename, referenced_xml))
         {
             LL_WARNS() << "Couldn't parse panel from: " << xml_filename << LL_ENDL;
 
@@ -3555,7 +3556,7 @@ bool LLFloater::buildFromFile(const std::string& filename)
     LL_PROFILE_ZONE_SCOPED;
     LLXMLNodePtr root;
 
-    if (!LLUICtrlFactory::getLayeredXMLNode(filename, root))
+    if (!LLUICtrlFactory::getLayoutXMLNode(filename, root))
     {
         LL_WARNS() << "Couldn't find (or parse) floater from: " << filename << LL_ENDL;
         return false;
@@ -2163,12 +2163,76 @@ void LLFolderViewFolder::draw()
     // draw children if root folder, or any other folder that is open or animating to closed state
     if( getRoot() == this || (isOpen() || mCurHeight != mTargetHeight ))
     {
-        LLView::draw();
+        if (getRoot() == this || !drawVisibleChildren())
+        {
+            LLView::draw();
+        }
     }
 
     mExpanderHighlighted = false;
 }
 
+// Draw only the rows that fall inside the scroll container's view. A folder
+// with thousands of children would otherwise compute a screen rect for every
+// one of them each frame just to find it is off screen.
+bool LLFolderViewFolder::drawVisibleChildren()
+{
+    LLFolderView* root = getRoot();
+    // anything but rows (e.g. conversation widgets) goes the usual way
+    if (!root || getChildCount() != (S32)(mFolders.size() + mItems.size()))
+    {
+        return false;
+    }
+
+    LLRect visible_rect = root->getVisibleRect();
+    if (visible_rect.isEmpty())
+    {
+        // not in a scroll container
+        return false;
+    }
+    LLRect local_visible_rect;
+    root->localRectToOtherView(visible_rect, &local_visible_rect, this);
+
+    // arrange() stacks the folders top down, then the items below them, so
+    // once a row is below the view every later one is too
+    bool below = false;
+    for (folders_t::iterator fit = mFolders.begin(); !below && fit != mFolders.end(); ++fit)
+    {
+        LLFolderViewFolder* folderp = *fit;
+        if (!folderp->getVisible())
+        {
+            continue;
+        }
+        const LLRect& rect = folderp->getRect();
+        if (rect.mTop <= local_visible_rect.mBottom)
+        {
+            below = true;
+        }
+        else if (rect.mBottom < local_visible_rect.mTop)
+        {
+            drawChild(folderp);
+        }
+    }
+    for (items_t::iterator iit = mItems.begin(); !below && iit != mItems.end(); ++iit)
+    {
+        LLFolderViewItem* itemp = *iit;
+        if (!itemp->getVisible())
+        {
+            continue;
+        }
+        const LLRect& rect = itemp->getRect();
+        if (rect.mTop <= local_visible_rect.mBottom)
+        {
+            below = true;
+        }
+        else if (rect.mBottom < local_visible_rect.mTop)
+        {
+            drawChild(itemp);
+        }
+    }
+    return true;
+}
+
 // this does prefix traversal, as folders are listed above their contents
 LLFolderViewItem* LLFolderViewFolder::getNextFromChild( LLFolderViewItem* item, bool include_children )
 {
@@ -491,6 +491,10 @@ public:
     //WARNING: do not call directly...use the appropriate LLFolderViewModel-derived class instead
     template<typename SORT_FUNC> void sortFolders(const SORT_FUNC& func) { mFolders.sort(func); }
     template<typename SORT_FUNC> void sortItems(const SORT_FUNC& func) { mItems.sort(func); }
+
+protected:
+    // false if the children need LLView::draw()
+    bool drawVisibleChildren();
 };
 
 typedef std::deque<LLFolderViewItem*> folder_view_item_deque;
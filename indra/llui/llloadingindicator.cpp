@@ -84,6 +84,12 @@ void LLLoadingIndicator::draw()
     }
 
     LLUICtrl::draw();
+
+    if (mImageSwitchTimer.getStarted())
+    {
+        // spinning, draw again next frame
+        dirtyRect();
+    }
 }
 
 void LLLoadingIndicator::stop()
@@ -517,7 +517,7 @@ bool LLPanel::initPanelXML(LLXMLNodePtr node, LLView *parent, LLXMLNodePtr outpu
             LLUICtrlFactory::instance().pushFileName(xml_filename);
 
             LL_RECORD_BLOCK_TIME(FTM_EXTERNAL_PANEL_LOAD);
-            if (!LLUICtrlFactory::getLayeredXMLNode(xml_filename, referenced_xml))
+            if (!LLUICtrlFactory::getLayoutXMLNode(xml_filename, referenced_xml))
             {
                 LL_WARNS() << "Couldn't parse panel from: " << xml_filename << LL_ENDL;
 
@@ -787,7 +787,7 @@ bool LLPanel::buildFromFile(const std::string& filename, const LLPanel::Params&
     bool didPost = false;
     LLXMLNodePtr root;
 
-    if (!LLUICtrlFactory::getLayeredXMLNode(filename, root))
+    if (!LLUICtrlFactory::getLayoutXMLNode(filename, root))
     {
         LL_WARNS() << "Couldn't parse panel from: " << filename << LL_ENDL;
         return didPost;
@@ -120,6 +120,90 @@ struct SortScrollListItem
     const bool mAltSort;
 };
 
+// Same order as SortScrollListItem, but the strings are pulled out of the
+// cells once per sort instead of twice per comparison. Sorting a few
+// thousand rows otherwise spends most of its time building LLSD strings.
+static void sort_scroll_list_items(std::deque<LLScrollListItem*>& items,
+                                   const std::vector<std::pair<S32, bool> >& sort_orders,
+                                   const LLScrollListCtrl::sort_signal_t* sort_signal,
+                                   bool alternate_sort)
+{
+    if (sort_signal)
+    {
+        // the callback wants the items themselves
+        std::stable_sort(items.begin(), items.end(), SortScrollListItem(sort_orders, sort_signal, alternate_sort));
+        return;
+    }
+
+    const size_t num_items = items.size();
+    const size_t num_keys = sort_orders.size();
+    if (num_items < 2 || !num_keys)
+    {
+        return;
+    }
+
+    // key k of row r is at r * num_keys + k, most significant column first
+    std::vector<std::string> values(num_items * num_keys);
+    std::vector<std::string> alt_values(alternate_sort ? num_items * num_keys : 0);
+    std::vector<U8> has_cell(num_items * num_keys);
+    for (size_t row = 0; row < num_items; ++row)
+    {
+        size_t key = row * num_keys;
+        for (auto it = sort_orders.rbegin(); it != sort_orders.rend(); ++it, ++key)
+        {
+            if (const LLScrollListCell* cell = items[row]->getColumn(it->first))
+            {
+                has_cell[key] = 1;
+                values[key] = cell->getValue().asString();
+                if (alternate_sort)
+                {
+                    alt_values[key] = cell->getAltValue().asString();
+                }
+            }
+        }
+    }
+
+    std::vector<S32> order(num_items);
+    for (size_t row = 0; row < num_items; ++row)
+    {
+        order[row] = (S32)row;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](S32 row1, S32 row2)
+    {
+        size_t key1 = row1 * num_keys;
+        size_t key2 = row2 * num_keys;
+        for (auto it = sort_orders.rbegin(); it != sort_orders.rend(); ++it, ++key1, ++key2)
+        {
+            if (!has_cell[key1] || !has_cell[key2])
+            {
+                continue;
+            }
+            S32 sort_result;
+            if (alternate_sort && !alt_values[key1].empty() && !alt_values[key2].empty())
+            {
+                sort_result = LLStringUtil::compareDict(alt_values[key1], alt_values[key2]);
+            }
+            else
+            {
+                sort_result = LLStringUtil::compareDict(values[key1], values[key2]);
+            }
+            if (sort_result != 0)
+            {
+                // ascending or descending sort for this column?
+                return (it->second ? sort_result : -sort_result) < 0;
+            }
+        }
+        return false;
+    });
+
+    std::deque<LLScrollListItem*> sorted;
+    for (S32 row : order)
+    {
+        sorted.push_back(items[row]);
+    }
+    items.swap(sorted);
+}
+
 //---------------------------------------------------------------------------
 // LLScrollListCtrl
 //---------------------------------------------------------------------------
@@ -2762,10 +2846,7 @@ void LLScrollListCtrl::updateSort() const
     if (hasSortOrder() && !isSorted())
     {
         // do stable sort to preserve any previous sorts
-        std::stable_sort(
-            mItemList.begin(),
-            mItemList.end(),
-            SortScrollListItem(mSortColumns,mSortCallback, mAlternateSort));
+        sort_scroll_list_items(mItemList, mSortColumns, mSortCallback, mAlternateSort);
 
         mSorted = true;
     }
@@ -2778,10 +2859,7 @@ void LLScrollListCtrl::sortOnce(S32 column, bool ascending)
     sort_column.push_back(std::make_pair(column, ascending));
 
     // do stable sort to preserve any previous sorts
-    std::stable_sort(
-        mItemList.begin(),
-        mItemList.end(),
-        SortScrollListItem(sort_column,mSortCallback,mAlternateSort));
+    sort_scroll_list_items(mItemList, sort_column, mSortCallback, mAlternateSort);
 }
 
 void LLScrollListCtrl::dirtyColumns()
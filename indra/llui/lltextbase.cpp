@@ -2361,6 +2361,7 @@ void LLTextBase::needsReflow(S32 index)
 {
     LL_DEBUGS() << "reflow on object " << (void*)this << " index = " << mReflowIndex << ", new index = " << index << LL_ENDL;
     mReflowIndex = llmin(mReflowIndex, index);
+    dirtyRect();
 }
 
 S32 LLTextBase::removeFirstLine()
@@ -3339,8 +3340,7 @@ LLNormalTextSegment::LLNormalTextSegment( LLStyleConstSP style, S32 start, S32 e
 :   LLTextSegment(start, end),
     mStyle( style ),
     mToken(NULL),
-    mEditor(editor),
-    mLastGeneration(-1)
+    mEditor(editor)
 {
     mFontHeight = mStyle->getFont()->getLineHeight();
 
@@ -3354,8 +3354,7 @@ LLNormalTextSegment::LLNormalTextSegment( LLStyleConstSP style, S32 start, S32 e
 LLNormalTextSegment::LLNormalTextSegment( const LLUIColor& color, S32 start, S32 end, LLTextBase& editor, bool is_visible)
 :   LLTextSegment(start, end),
     mToken(NULL),
-    mEditor(editor),
-    mLastGeneration(-1)
+    mEditor(editor)
 {
     mStyle = new LLStyle(LLStyle::Params().visible(is_visible).color(color));
 
@@ -3376,9 +3375,7 @@ F32 LLNormalTextSegment::draw(S32 start, S32 end, S32 selection_start, S32 selec
     }
     else
     {
-        mFontBufferPreSelection.reset();
-        mFontBufferSelection.reset();
-        mFontBufferPostSelection.reset();
+        mLineFontBuffers.clear();
     }
     return draw_rect.mLeft;
 }
@@ -3395,20 +3392,18 @@ F32 LLNormalTextSegment::drawClippedSegment(S32 seg_start, S32 seg_end, S32 sele
     F32 alpha = LLViewDrawContext::getCurrentContext().mAlpha;
 
     const LLWString& text = getWText();
-    S32 text_gen = mEditor.getTextGeneration();
-
-    if (text_gen != mLastGeneration)
-    {
-        mLastGeneration = text_gen;
-
-        mFontBufferPreSelection.reset();
-        mFontBufferSelection.reset();
-        mFontBufferPostSelection.reset();
-    }
 
     const LLFontGL* font = mStyle->getFont();
     LLColor4 color = (mEditor.getReadOnly() ? mStyle->getReadOnlyColor() : mStyle->getColor())  % (alpha * mStyle->getAlpha());
     bool use_font_buffers = useFontBuffers();
+    LineFontBuffers* buffers = nullptr;
+    if (use_font_buffers)
+    {
+        // The buffers check the glyphs they drew themselves, so edits
+        // elsewhere in the text and scrolling leave them be
+        buffers = &mLineFontBuffers[seg_start];
+        mLastDrawFrame = buffers->mLastDrawFrame = LLFrameTimer::getFrameCount();
+    }
 
     if( selection_start > seg_start )
     {
@@ -3418,7 +3413,7 @@ F32 LLNormalTextSegment::drawClippedSegment(S32 seg_start, S32 seg_end, S32 sele
         S32 length =  end - start;
         if (use_font_buffers)
         {
-            mFontBufferPreSelection.render(
+            buffers->mPreSelection.render(
                 font,
                 text, start,
                 rect,
@@ -3433,11 +3428,6 @@ F32 LLNormalTextSegment::drawClippedSegment(S32 seg_start, S32 seg_end, S32 sele
         }
         else
         {
-            // Font buffer doesn't do well with changes and huge notecard with a bunch
-            // of segments will see a lot of buffer updates, so instead use derect
-            // rendering to cache.
-            // Todo: instead of mLastGeneration make buffer invalidation more fine grained
-            // like string hash of a given segment.
             font->render(
                 text, start,
                 rect,
@@ -3462,7 +3452,7 @@ F32 LLNormalTextSegment::drawClippedSegment(S32 seg_start, S32 seg_end, S32 sele
 
         if (use_font_buffers)
         {
-            mFontBufferSelection.render(
+            buffers->mSelection.render(
                 font,
                 text, start,
                 rect,
@@ -3499,7 +3489,7 @@ F32 LLNormalTextSegment::drawClippedSegment(S32 seg_start, S32 seg_end, S32 sele
         S32 length = end - start;
         if (use_font_buffers)
         {
-            mFontBufferPostSelection.render(
+            buffers->mPostSelection.render(
                 font,
                 text, start,
                 rect,
@@ -3732,9 +3722,19 @@ void LLNormalTextSegment::updateLayout(const class LLTextBase& editor)
 {
     LLTextSegment::updateLayout(editor);
 
-    mFontBufferPreSelection.reset();
-    mFontBufferSelection.reset();
-    mFontBufferPostSelection.reset();
+    // Lines may start elsewhere now. Keep the buffers of the lines drawn last
+    // time, the ones likely to be drawn next, and drop the rest.
+    for (auto it = mLineFontBuffers.begin(); it != mLineFontBuffers.end();)
+    {
+        if (it->first < mStart || it->first >= mEnd || it->second.mLastDrawFrame != mLastDrawFrame)
+        {
+            it = mLineFontBuffers.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
 }
 
 void LLNormalTextSegment::dump() const
@@ -37,6 +37,7 @@
 #include "llpanel.h"
 #include "lltextparser.h"
 
+#include <map>
 #include <string>
 #include <vector>
 #include <set>
@@ -170,11 +171,17 @@ protected:
     std::string         mTooltip;
     boost::signals2::connection mImageLoadedConnection;
 
-    // font rendering
-    LLFontVertexBuffer  mFontBufferPreSelection;
-    LLFontVertexBuffer  mFontBufferSelection;
-    LLFontVertexBuffer  mFontBufferPostSelection;
-    S32                 mLastGeneration = -1;
+    // font rendering, a segment spanning several lines is drawn once per
+    // line, each with its own buffers keyed by the line's first character
+    struct LineFontBuffers
+    {
+        LLFontVertexBuffer  mPreSelection;
+        LLFontVertexBuffer  mSelection;
+        LLFontVertexBuffer  mPostSelection;
+        U32                 mLastDrawFrame = 0;
+    };
+    std::map<S32, LineFontBuffers> mLineFontBuffers;
+    U32                 mLastDrawFrame = 0;
 };
 
 // This text segment is the same as LLNormalTextSegment, the only difference
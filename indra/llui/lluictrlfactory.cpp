@@ -35,6 +35,7 @@
 #include <boost/tokenizer.hpp>
 
 // other library includes
+#include "llcallbacklist.h"
 #include "llcontrol.h"
 #include "lldir.h"
 #include "v4color.h"
@@ -172,6 +173,94 @@ bool LLUICtrlFactory::getLayeredXMLNode(const std::string &xui_filename, LLXMLNo
     return LLXMLNode::getLayeredXMLNode(root, paths);
 }
 
+static bool layout_cache_enabled()
+{
+    static LLUICachedControl<bool> cache_layouts("XUILayoutCache", true);
+    return cache_layouts;
+}
+
+// the UI preview floater switches languages on the fly
+static std::string layout_cache_key(const std::string& filename)
+{
+    return gDirUtilp->getSkinFolder() + "|" + gDirUtilp->getLanguage() + "|" + filename;
+}
+
+//static
+bool LLUICtrlFactory::getLayoutXMLNode(const std::string &filename, LLXMLNodePtr& root)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_UI;
+    if (!layout_cache_enabled())
+    {
+        return getLayeredXMLNode(filename, root);
+    }
+
+    std::string key = layout_cache_key(filename);
+    std::map<std::string, LLXMLNodePtr>& cache = instance().mLayoutCache;
+    auto found = cache.find(key);
+    if (found != cache.end())
+    {
+        root = found->second;
+        return true;
+    }
+
+    if (!getLayeredXMLNode(filename, root))
+    {
+        return false;
+    }
+    cache[key] = root;
+    return true;
+}
+
+static void collect_referenced_layouts(LLXMLNodePtr node, std::deque<std::string>& filenames)
+{
+    std::string filename;
+    if (node->getAttributeString("filename", filename) && !filename.empty())
+    {
+        filenames.push_back(filename);
+    }
+    for (LLXMLNodePtr child = node->getFirstChild(); child.notNull(); child = child->getNextSibling())
+    {
+        collect_referenced_layouts(child, filenames);
+    }
+}
+
+void LLUICtrlFactory::prewarmLayouts(const std::vector<std::string>& filenames)
+{
+    bool idle = !mPrewarmQueue.empty();
+    mPrewarmQueue.insert(mPrewarmQueue.end(), filenames.begin(), filenames.end());
+    if (!idle && !mPrewarmQueue.empty())
+    {
+        doOnIdleRepeating([]() { return LLUICtrlFactory::instance().prewarmNextLayout(); });
+    }
+}
+
+bool LLUICtrlFactory::prewarmNextLayout()
+{
+    if (mPrewarmQueue.empty() || !layout_cache_enabled())
+    {
+        mPrewarmQueue.clear();
+        return true;
+    }
+
+    std::string filename = mPrewarmQueue.front();
+    mPrewarmQueue.pop_front();
+
+    LLXMLNodePtr root;
+    if (mLayoutCache.count(layout_cache_key(filename)))
+    {
+        // parsed already, along with what it refers to
+    }
+    else if (getLayoutXMLNode(filename, root))
+    {
+        collect_referenced_layouts(root, mPrewarmQueue);
+    }
+    else
+    {
+        LL_DEBUGS("XUI") << "Couldn't prewarm " << filename << LL_ENDL;
+    }
+    return mPrewarmQueue.empty();
+}
+
 
 //-----------------------------------------------------------------------------
 // saveToXML()
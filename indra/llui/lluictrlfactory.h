@@ -36,6 +36,9 @@
 #include "llsingleton.h"
 #include "llheteromap.h"
 
+#include <deque>
+#include <map>
+
 class LLView;
 void deleteView(LLView*); // Inside LLView.cpp, avoid having to potentially delete an incomplete type here.
 
@@ -156,7 +159,7 @@ public:
         {
             LLXMLNodePtr root_node;
 
-            if (!LLUICtrlFactory::getLayeredXMLNode(filename, root_node))
+            if (!LLUICtrlFactory::getLayoutXMLNode(filename, root_node))
             {
                 LL_WARNS() << "Couldn't parse XUI from path: " << instance().getCurFileName() << ", from filename: " << filename << LL_ENDL;
                 goto fail;
@@ -194,6 +197,15 @@ fail:
     static bool getLayeredXMLNode(const std::string &filename, LLXMLNodePtr& root,
                                   LLDir::ESkinConstraint constraint=LLDir::CURRENT_SKIN);
 
+    // getLayeredXMLNode() for floaters, panels and widgets built from a file.
+    // The merged tree is parsed once per skin and language and then shared
+    // by every build, so it must be treated as read only.
+    static bool getLayoutXMLNode(const std::string &filename, LLXMLNodePtr& root);
+
+    // Parse these layouts, and the ones they refer to, a file per idle
+    // frame, so that building them the first time doesn't have to.
+    void prewarmLayouts(const std::vector<std::string>& filenames);
+
 private:
     //NOTE: both friend declarations are necessary to keep both gcc and msvc happy
     template <typename T> friend class LLChildRegistry;
@@ -271,9 +283,15 @@ private:
     // this exists to get around dependency on llview
     static void setCtrlParent(LLView* view, LLView* parent, S32 tab_group);
 
+    bool prewarmNextLayout();
+
     class LLPanel*      mDummyPanel;
     std::vector<std::string>    mFileNames;
 
+    // skin, language and file name to parsed layout
+    std::map<std::string, LLXMLNodePtr> mLayoutCache;
+    std::deque<std::string>     mPrewarmQueue;
+
     // store ParamDefaults specializations
     // Each ParamDefaults specialization used to be an LLSingleton in its own
     // right. But the 2016 changes to the LLSingleton mechanism, making
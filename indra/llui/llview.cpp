@@ -63,6 +63,8 @@ bool    LLView::sDebugUnicode = false;
 bool    LLView::sDebugCamera = false;
 bool    LLView::sIsRectDirty = false;
 LLRect  LLView::sDirtyRect;
+bool    LLView::sIsDeferredRectDirty = false;
+LLRect  LLView::sDeferredDirtyRect;
 bool    LLView::sDebugRectsShowNames = true;
 bool    LLView::sDebugKeys = false;
 bool    LLView::sDebugMouseHandling = false;
@@ -1284,14 +1286,45 @@ void LLView::dirtyRect()
         parent = parent->getParent();
     }
 
+    dirtyScreenRect(cur->calcScreenRect());
+}
+
+//static
+void LLView::dirtyScreenRect(const LLRect& screen_rect)
+{
+    if (sIsDrawing)
+    {
+        // an animating view dirties itself as it draws, for the next frame
+        if (!sIsDeferredRectDirty)
+        {
+            sDeferredDirtyRect = screen_rect;
+            sIsDeferredRectDirty = true;
+        }
+        else
+        {
+            sDeferredDirtyRect.unionWith(screen_rect);
+        }
+        return;
+    }
+
     if (!sIsRectDirty)
     {
-        sDirtyRect = cur->calcScreenRect();
+        sDirtyRect = screen_rect;
         sIsRectDirty = true;
     }
     else
     {
-        sDirtyRect.unionWith(cur->calcScreenRect());
+        sDirtyRect.unionWith(screen_rect);
+    }
+}
+
+//static
+void LLView::applyDeferredDirtyRect()
+{
+    if (sIsDeferredRectDirty)
+    {
+        sIsDeferredRectDirty = false;
+        dirtyScreenRect(sDeferredDirtyRect);
     }
 }
 
@@ -35,6 +35,7 @@
 #include "llcoord.h"
 #include "llfontgl.h"
 #include "llhandle.h"
+#include "llheap.h"
 #include "llmortician.h"
 #include "llmousehandler.h"
 #include "llstring.h"
@@ -103,6 +104,7 @@ class LLView
     public LLHandleProvider<LLView>     // passes out weak references to self
 {
 public:
+    LL_HEAP_OPERATORS(LLHeap::HEAP_UI)
 
     enum EOrientation { HORIZONTAL, VERTICAL, ORIENTATION_COUNT };
 
@@ -667,8 +669,17 @@ public:
     // Show camera position and direction in Camera Controls floater
     static bool sDebugCamera;
 
+    // Screen area to redraw when the UI is retained in a buffer
+    // (RenderUIBuffer). It also culls the draw, so anything dirtied while
+    // drawing is held back until the draw is done.
     static bool sIsRectDirty;
     static LLRect sDirtyRect;
+    static bool sIsDeferredRectDirty;
+    static LLRect sDeferredDirtyRect;
+
+    static void dirtyScreenRect(const LLRect& screen_rect);
+    // call once the UI is drawn
+    static void applyDeferredDirtyRect();
 
     // Draw widget names and sizes when drawing debug rectangles, turning this
     // off is useful to make the rectangles themselves easier to see.
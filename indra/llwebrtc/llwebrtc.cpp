@@ -47,7 +47,7 @@ static int16_t RECORD_DEVICE_BAD      = -2;
 
 LLAudioDeviceObserver::LLAudioDeviceObserver() : mSumVector {0}, mMicrophoneEnergy(0.0) {}
 
-float LLAudioDeviceObserver::getMicrophoneEnergy() { return mMicrophoneEnergy; }
+float LLAudioDeviceObserver::getMicrophoneEnergy() { return mMicrophoneEnergy.load(std::memory_order_relaxed); }
 
 // TODO: Pull smoothing/filtering code into a common helper function
 // for LLAudioDeviceObserver and LLCustomProcessor
@@ -78,7 +78,7 @@ void LLAudioDeviceObserver::OnCaptureData(const void    *audio_samples,
     }
     mSumVector[i] = energy;
     totalSum += energy;
-    mMicrophoneEnergy = std::sqrt(totalSum / (num_samples * buffer_size));
+    mMicrophoneEnergy.store(std::sqrt(totalSum / (num_samples * buffer_size)), std::memory_order_relaxed);
 }
 
 void LLAudioDeviceObserver::OnRenderData(const void    *audio_samples,
@@ -125,11 +125,12 @@ void LLCustomProcessor::Process(webrtc::AudioBuffer *audio_in)
     audio_in->CopyTo(stream_config, &frame[0]);
 
     // calculate the energy
+    float gain   = mGain.load(std::memory_order_relaxed);
     float energy = 0;
     for (size_t index = 0; index < stream_config.num_samples(); index++)
     {
         float sample = frame_samples[index];
-        sample       = sample * mGain; // apply gain
+        sample       = sample * gain; // apply gain
         frame_samples[index] = sample; // write processed sample back to buffer.
         energy += sample * sample;
     }
@@ -147,7 +148,7 @@ void LLCustomProcessor::Process(webrtc::AudioBuffer *audio_in)
     }
     mSumVector[i] = energy;
     totalSum += energy;
-    mMicrophoneEnergy = std::sqrt(totalSum / (stream_config.num_samples() * buffer_size));
+    mMicrophoneEnergy.store(std::sqrt(totalSum / (stream_config.num_samples() * buffer_size)), std::memory_order_relaxed);
 }
 
 //
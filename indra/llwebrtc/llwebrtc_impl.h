@@ -39,6 +39,8 @@
 #endif
 
 #include "llwebrtc.h"
+
+#include <atomic>
 // WebRTC Includes
 #ifdef WEBRTC_WIN
 #pragma warning(push)
@@ -147,7 +149,8 @@ class LLAudioDeviceObserver : public webrtc::AudioDeviceDataObserver
   protected:
     static const int NUM_PACKETS_TO_FILTER = 30;  // 300 ms of smoothing (30 frames)
     float mSumVector[NUM_PACKETS_TO_FILTER];
-    float mMicrophoneEnergy;
+    // written on the audio device thread, read by the main loop
+    std::atomic<float> mMicrophoneEnergy;
 };
 
 // Used to process/retrieve audio levels after
@@ -167,9 +170,9 @@ class LLCustomProcessor : public webrtc::CustomProcessing
     // Returns a string representation of the module state.
     std::string ToString() const override { return ""; }
 
-    float getMicrophoneEnergy() { return mMicrophoneEnergy; }
+    float getMicrophoneEnergy() { return mMicrophoneEnergy.load(std::memory_order_relaxed); }
 
-    void setGain(float gain) { mGain = gain; }
+    void setGain(float gain) { mGain.store(gain, std::memory_order_relaxed); }
 
   protected:
     static const int NUM_PACKETS_TO_FILTER = 30;  // 300 ms of smoothing
@@ -177,8 +180,10 @@ class LLCustomProcessor : public webrtc::CustomProcessing
     int              mNumChannels;
 
     float mSumVector[NUM_PACKETS_TO_FILTER];
-    float mMicrophoneEnergy;
-    float mGain;
+    // written on the audio processing thread, read by the main loop
+    std::atomic<float> mMicrophoneEnergy;
+    // set by the main loop, applied on the audio processing thread
+    std::atomic<float> mGain;
 };
 
 
@@ -47,6 +47,7 @@
 #include "llfile.h"
 #include "lltimer.h"
 #include "lldir.h"
+#include "hbxxh.h"
 
 #if LL_RELEASE_WITH_DEBUG_INFO || LL_DEBUG
 #define CONTROL_ERRS LL_ERRS("ControlErrors")
@@ -347,11 +348,30 @@ LLPointer<LLControlVariable> LLControlGroup::getControl(std::string_view name)
     {
         incrCount(name);
     }
+    if (mTrackLookups)
+    {
+        countLookup(name);
+    }
 
     ctrl_name_table_t::iterator iter = mNameTable.find(name);
     return iter == mNameTable.end() ? LLPointer<LLControlVariable>() : iter->second;
 }
 
+LLPointer<LLControlVariable> LLControlGroup::getControl(const LLSymbol& name)
+{
+    if (mSettingsProfile)
+    {
+        incrCount(name);
+    }
+    if (mTrackLookups)
+    {
+        countLookup(name);
+    }
+
+    ctrl_symbol_table_t::iterator iter = mSymbolTable.find(name);
+    return iter == mSymbolTable.end() ? LLPointer<LLControlVariable>() : iter->second;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////
 
@@ -372,7 +392,8 @@ const std::string LLControlGroup::mTypeString[TYPE_COUNT] = { "U32"
 
 LLControlGroup::LLControlGroup(const std::string& name)
 :   LLInstanceTracker<LLControlGroup, std::string>(name),
-    mSettingsProfile(false)
+    mSettingsProfile(false),
+    mTrackLookups(false)
 {
 
     if (NULL != getenv("LL_SETTINGS_PROFILE"))
@@ -447,6 +468,7 @@ void LLControlGroup::cleanup()
     }
 
     mNameTable.clear();
+    mSymbolTable.clear();
 }
 
 eControlType LLControlGroup::typeStringToEnum(const std::string& typestr)
@@ -488,6 +510,7 @@ LLControlVariable* LLControlGroup::declareControl(const std::string& name, eCont
     // if not, create the control and add it to the name table
     LLControlVariable* control = new LLControlVariable(name, type, initial_val, comment, persist, hidefromsettingseditor);
     mNameTable[name] = control;
+    mSymbolTable[LLSymbol(name)] = control;
     return control;
 }
 
@@ -560,6 +583,31 @@ void LLControlGroup::incrCount(std::string_view name)
     getCount[name.data()] = getCount[name.data()].asInteger() + 1;
 }
 
+void LLControlGroup::setTrackLookups(bool track)
+{
+    LLMutexLock lock(&mLookupMutex);
+    mTrackLookups = track;
+    mLookupCounts.clear();
+}
+
+void LLControlGroup::takeLookupCounts(lookup_counts_t& counts)
+{
+    LLMutexLock lock(&mLookupMutex);
+    counts.clear();
+    counts.swap(mLookupCounts);
+}
+
+void LLControlGroup::countLookup(std::string_view name)
+{
+    LLMutexLock lock(&mLookupMutex);
+    lookup_counts_t::iterator it = mLookupCounts.find(name);
+    if (it == mLookupCounts.end())
+    {
+        it = mLookupCounts.emplace(std::string(name), 0).first;
+    }
+    ++it->second;
+}
+
 bool LLControlGroup::getBOOL(std::string_view name)
 {
     return get<bool>(name);
@@ -575,6 +623,26 @@ U32 LLControlGroup::getU32(std::string_view name)
     return get<U32>(name);
 }
 
+bool LLControlGroup::getBOOL(const LLSymbol& name)
+{
+    return get<bool>(name);
+}
+
+S32 LLControlGroup::getS32(const LLSymbol& name)
+{
+    return get<S32>(name);
+}
+
+F32 LLControlGroup::getF32(const LLSymbol& name)
+{
+    return get<F32>(name);
+}
+
+U32 LLControlGroup::getU32(const LLSymbol& name)
+{
+    return get<U32>(name);
+}
+
 F32 LLControlGroup::getF32(std::string_view name)
 {
     return get<F32>(name);
@@ -987,22 +1055,95 @@ U32 LLControlGroup::saveToFile(const std::string& filename, bool nondefault_only
     return num_saved;
 }
 
+// The default settings files only change with an install, so a binary copy
+// of what they parse to, which loads several times faster than the XML,
+// stands in for them for as long as their contents hash the same.
+static std::string precompiled_settings_filename(const std::string& filename)
+{
+    if (gDirUtilp->getOSUserAppDir().empty())
+    {
+        return std::string(); // no place to keep it, e.g. in unit tests
+    }
+    return gDirUtilp->getExpandedFilename(LL_PATH_USER_SETTINGS,
+                                          "precompiled_" + gDirUtilp->getBaseFileName(filename) + ".bin");
+}
+
+static bool load_precompiled_settings(const std::string& filename, const std::string& hash, LLSD& settings)
+{
+    std::string precompiled_filename = precompiled_settings_filename(filename);
+    if (precompiled_filename.empty() || !LLFile::isfile(precompiled_filename))
+    {
+        return false;
+    }
+
+    std::string contents = LLFile::getContents(precompiled_filename);
+    LLSD precompiled;
+    if (LLSDParser::PARSE_FAILURE == LLSDSerialize::fromBinary(precompiled, contents.data(), contents.size())
+        || precompiled["source"].asString() != filename
+        || precompiled["hash"].asString() != hash)
+    {
+        return false;
+    }
+    settings = precompiled["settings"];
+    return settings.isMap();
+}
+
+static void save_precompiled_settings(const std::string& filename, const std::string& hash, const LLSD& settings)
+{
+    std::string precompiled_filename = precompiled_settings_filename(filename);
+    if (precompiled_filename.empty())
+    {
+        return;
+    }
+
+    LLSD precompiled;
+    precompiled["source"] = filename;
+    precompiled["hash"] = hash;
+    precompiled["settings"] = settings;
+
+    // another viewer may be reading it, only ever replace it whole
+    std::string temp_filename = precompiled_filename + ".tmp";
+    {
+        llofstream out(temp_filename, std::ios::out | std::ios::binary);
+        if (!out.is_open())
+        {
+            return;
+        }
+        LLSDSerialize::toBinary(precompiled, out);
+    }
+    if (LLFile::rename(temp_filename, precompiled_filename) != 0)
+    {
+        LLFile::remove(temp_filename);
+    }
+}
+
 U32 LLControlGroup::loadFromFile(const std::string& filename, bool set_default_values, bool save_values)
 {
     LLSD settings;
-    llifstream infile;
-    infile.open(filename.c_str());
-    if(!infile.is_open())
+    if (!LLFile::isfile(filename))
     {
         LL_WARNS("Settings") << "Cannot find file " << filename << " to load." << LL_ENDL;
         return 0;
     }
 
-    if (LLSDParser::PARSE_FAILURE == LLSDSerialize::fromXML(settings, infile))
+    // the whole file at once, which parses far faster than a stream
+    std::string contents = LLFile::getContents(filename);
+    std::string hash;
+    if (set_default_values)
+    {
+        hash = llformat("%016llx", (unsigned long long)HBXXH64(contents).digest());
+    }
+    if (!set_default_values || !load_precompiled_settings(filename, hash, settings))
     {
-        infile.close();
-        LL_WARNS("Settings") << "Unable to parse LLSD control file " << filename << ". Trying Legacy Method." << LL_ENDL;
-        return loadFromFileLegacy(filename, true, TYPE_STRING);
+        if (LLSDParser::PARSE_FAILURE == LLSDSerialize::fromXML(settings, contents.data(), contents.size()))
+        {
+            LL_WARNS("Settings") << "Unable to parse LLSD control file " << filename << ". Trying Legacy Method." << LL_ENDL;
+            return loadFromFileLegacy(filename, true, TYPE_STRING);
+        }
+        if (set_default_values)
+        {
+            save_precompiled_settings(filename, hash, settings);
+        }
     }
 
     U32 validitems = 0;
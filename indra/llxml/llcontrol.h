@@ -33,7 +33,12 @@
 #include "llrect.h"
 #include "llrefcount.h"
 #include "llinstancetracker.h"
+#include "llmutex.h"
+#include "llsymbol.h"
 
+#include <atomic>
+#include <map>
+#include <unordered_map>
 #include <vector>
 
 #include <boost/bind.hpp>
@@ -167,6 +172,9 @@ class LLControlGroup : public LLInstanceTracker<LLControlGroup, std::string>
 protected:
     typedef std::map<std::string, LLControlVariablePtr, std::less<> > ctrl_name_table_t;
     ctrl_name_table_t mNameTable;
+    // the same controls by interned name, for the LLSymbol overloads
+    typedef std::unordered_map<LLSymbol, LLControlVariablePtr> ctrl_symbol_table_t;
+    ctrl_symbol_table_t mSymbolTable;
     static const std::string mTypeString[TYPE_COUNT];
 
 public:
@@ -178,6 +186,8 @@ public:
     void cleanup();
 
     LLControlVariablePtr getControl(std::string_view name);
+    // a hash lookup on the symbol's address instead of string comparisons
+    LLControlVariablePtr getControl(const LLSymbol& name);
 
     struct ApplyFunctor
     {
@@ -206,6 +216,10 @@ public:
     S32         getS32(std::string_view name);
     F32         getF32(std::string_view name);
     U32         getU32(std::string_view name);
+    bool        getBOOL(const LLSymbol& name);
+    S32         getS32(const LLSymbol& name);
+    F32         getF32(const LLSymbol& name);
+    U32         getU32(const LLSymbol& name);
 
     LLWString   getWString(std::string_view name);
     LLVector3   getVector3(std::string_view name);
@@ -224,21 +238,12 @@ public:
     template<typename T> T get(std::string_view name)
     {
         LL_PROFILE_ZONE_SCOPED_CATEGORY_LLSD;
-        LLControlVariable* control = getControl(name);
-        LLSD value;
-        eControlType type = TYPE_COUNT;
-
-        if (control)
-        {
-            value = control->get();
-            type = control->type();
-        }
-        else
-        {
-            LL_WARNS() << "Control " << name << " not found." << LL_ENDL;
-            return T();
-        }
-        return convert_from_llsd<T>(value, type, name);
+        return getFrom<T>(getControl(name), name);
+    }
+    template<typename T> T get(const LLSymbol& name)
+    {
+        LL_PROFILE_ZONE_SCOPED_CATEGORY_LLSD;
+        return getFrom<T>(getControl(name), name);
     }
 
     void    setBOOL(std::string_view name, bool val);
@@ -259,16 +264,11 @@ public:
     // generic setter
     template<typename T> void set(std::string_view name, const T& val)
     {
-        LLControlVariable* control = getControl(name);
-
-        if (control && control->isType(get_control_type<T>()))
-        {
-            control->set(convert_to_llsd(val));
-        }
-        else
-        {
-            LL_WARNS() << "Invalid control " << name << LL_ENDL;
-        }
+        setOn(getControl(name), name, val);
+    }
+    template<typename T> void set(const LLSymbol& name, const T& val)
+    {
+        setOn(getControl(name), name, val);
     }
 
     bool    controlExists(std::string_view name);
@@ -282,7 +282,46 @@ public:
     void    resetToDefaults();
     void    incrCount(std::string_view name);
 
+    // Count the lookups by name while on. Reads through an LLCachedControl
+    // don't look anything up, so these are the getters worth caching when
+    // they show up once a frame or more.
+    typedef std::map<std::string, U32, std::less<> > lookup_counts_t;
+    void    setTrackLookups(bool track);
+    bool    getTrackLookups() const { return mTrackLookups; }
+    // Hand over the counts so far and start again
+    void    takeLookupCounts(lookup_counts_t& counts);
+
     bool    mSettingsProfile;
+
+private:
+    void    countLookup(std::string_view name);
+
+    std::atomic<bool> mTrackLookups;
+    lookup_counts_t mLookupCounts;
+    LLMutex mLookupMutex; // getters may run off the main thread
+
+private:
+    template<typename T> T getFrom(LLControlVariable* control, std::string_view name)
+    {
+        if (!control)
+        {
+            LL_WARNS() << "Control " << name << " not found." << LL_ENDL;
+            return T();
+        }
+        return convert_from_llsd<T>(control->get(), control->type(), name);
+    }
+
+    template<typename T> void setOn(LLControlVariable* control, std::string_view name, const T& val)
+    {
+        if (control && control->isType(get_control_type<T>()))
+        {
+            control->set(convert_to_llsd(val));
+        }
+        else
+        {
+            LL_WARNS() << "Invalid control " << name << LL_ENDL;
+        }
+    }
 };
 
 
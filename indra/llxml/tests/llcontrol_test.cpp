@@ -151,4 +151,26 @@ namespace tut
         ensure("listener fired on changed setting", mListenerFired);
     }
 
+    //lookup counts
+    template<> template<>
+    void control_group_t::test<5>()
+    {
+        mCG->loadFromFile(mTestConfigFile);
+        LLControlGroup::lookup_counts_t counts;
+        mCG->getU32("TestSetting");
+        mCG->takeLookupCounts(counts);
+        ensure("nothing counted while off", counts.empty());
+
+        mCG->setTrackLookups(true);
+        mCG->getU32("TestSetting");
+        mCG->getU32("TestSetting");
+        mCG->getControl(LLSymbol("TestSetting"));
+        mCG->takeLookupCounts(counts);
+        ensure_equals("lookups counted", counts["TestSetting"], 3U);
+
+        mCG->takeLookupCounts(counts);
+        ensure("counts start again", counts.empty());
+        mCG->setTrackLookups(false);
+    }
+
 }
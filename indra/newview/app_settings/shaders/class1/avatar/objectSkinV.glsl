@@ -24,7 +24,11 @@
 
 in vec4 weight4;
 
-uniform mat3x4 matrixPalette[MAX_JOINTS_PER_MESH_OBJECT];
+// written once per frame and shared by every pass, see LLSkinPalettes
+layout (std140) uniform AvatarPalette
+{
+    mat3x4 matrixPalette[MAX_JOINTS_PER_MESH_OBJECT];
+};
 
 mat4 getObjectSkinnedTransform()
 {
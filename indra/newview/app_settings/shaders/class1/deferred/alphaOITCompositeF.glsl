@@ -0,0 +1,50 @@
+/**
+ * @file alphaOITCompositeF.glsl
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+/*[EXTRA_CODE_HERE]*/
+
+// Resolves the weighted blended transparency accumulated by LLDrawPoolAlpha::renderOIT
+// into a color and coverage that blend over the screen like a single alpha surface
+
+out vec4 frag_color;
+
+uniform sampler2D diffuseRect;  // .rgb = sum of weighted premultiplied color, .a = product of (1 - alpha)
+uniform sampler2D specularRect; // .r = sum of weighted alpha
+
+in vec2 vary_fragcoord;
+
+void main()
+{
+    vec4 accum = texture(diffuseRect, vary_fragcoord.xy);
+    float revealage = accum.a;
+    if (revealage >= 1.0)
+    { // nothing was drawn here
+        discard;
+    }
+
+    float weight = texture(specularRect, vary_fragcoord.xy).r;
+
+    frag_color = vec4(accum.rgb / max(weight, 1e-5), 1.0 - revealage);
+}
@@ -40,12 +40,16 @@ uniform float region_scale;
 #endif
 
 in vec3 position;
+#ifdef TERRAIN_GPU
+void terrain_gpu_vertex(vec2 grid, out vec3 position, out vec3 normal, out vec4 tangent, out vec2 texcoord1);
+#else
 in vec3 normal;
 in vec4 tangent;
 in vec4 diffuse_color;
 #if TERRAIN_PAINT_TYPE == TERRAIN_PAINT_TYPE_HEIGHTMAP_WITH_NOISE
 in vec2 texcoord1;
 #endif
+#endif
 
 out vec3 vary_position;
 out vec3 vary_normal;
@@ -80,15 +84,31 @@ vec4 terrain_tangent_space_transform(vec4 vertex_tangent, vec3 vertex_normal, ve
 
 void main()
 {
+#ifdef TERRAIN_GPU
+    // position is within the patch grid, see terrainGPUUtilV.glsl
+    vec3 vert;
+    vec3 vert_normal;
+    vec4 vert_tangent;
+    vec2 vert_texcoord1;
+    terrain_gpu_vertex(position.xy, vert, vert_normal, vert_tangent, vert_texcoord1);
+#else
+    vec3 vert = position;
+    vec3 vert_normal = normal;
+    vec4 vert_tangent = tangent;
+#if TERRAIN_PAINT_TYPE == TERRAIN_PAINT_TYPE_HEIGHTMAP_WITH_NOISE
+    vec2 vert_texcoord1 = texcoord1;
+#endif
+#endif
+
     //transform vertex
-    gl_Position = modelview_projection_matrix * vec4(position.xyz, 1.0);
-    vary_position = (modelview_matrix*vec4(position.xyz, 1.0)).xyz;
+    gl_Position = modelview_projection_matrix * vec4(vert.xyz, 1.0);
+    vary_position = (modelview_matrix*vec4(vert.xyz, 1.0)).xyz;
 
-    vec3 n = normal_matrix * normal;
+    vec3 n = normal_matrix * vert_normal;
 #if TERRAIN_PLANAR_TEXTURE_SAMPLE_COUNT == 3
-    vary_vertex_normal = normal;
+    vary_vertex_normal = vert_normal;
 #endif
-    vec3 t = normal_matrix * tangent.xyz;
+    vec3 t = normal_matrix * vert_tangent.xyz;
 
 #if (TERRAIN_PBR_DETAIL >= TERRAIN_PBR_DETAIL_NORMAL)
     {
@@ -98,27 +118,27 @@ void main()
         ttt[0].xyz = terrain_texture_transforms[0].xyz;
         ttt[1].x = terrain_texture_transforms[0].w;
         ttt[1].y = terrain_texture_transforms[1].x;
-        transformed_tangent = terrain_tangent_space_transform(vec4(t, tangent.w), n, ttt);
+        transformed_tangent = terrain_tangent_space_transform(vec4(t, vert_tangent.w), n, ttt);
         vary_tangents[0] = normalize(transformed_tangent.xyz);
         vary_signs[0] = transformed_tangent.w;
         // material 2
         ttt[0].xyz = terrain_texture_transforms[1].yzw;
         ttt[1].xy = terrain_texture_transforms[2].xy;
-        transformed_tangent = terrain_tangent_space_transform(vec4(t, tangent.w), n, ttt);
+        transformed_tangent = terrain_tangent_space_transform(vec4(t, vert_tangent.w), n, ttt);
         vary_tangents[1] = normalize(transformed_tangent.xyz);
         vary_signs[1] = transformed_tangent.w;
         // material 3
         ttt[0].xy = terrain_texture_transforms[2].zw;
         ttt[0].z = terrain_texture_transforms[3].x;
         ttt[1].xy = terrain_texture_transforms[3].yz;
-        transformed_tangent = terrain_tangent_space_transform(vec4(t, tangent.w), n, ttt);
+        transformed_tangent = terrain_tangent_space_transform(vec4(t, vert_tangent.w), n, ttt);
         vary_tangents[2] = normalize(transformed_tangent.xyz);
         vary_signs[2] = transformed_tangent.w;
         // material 4
         ttt[0].x = terrain_texture_transforms[3].w;
         ttt[0].yz = terrain_texture_transforms[4].xy;
         ttt[1].xy = terrain_texture_transforms[4].zw;
-        transformed_tangent = terrain_tangent_space_transform(vec4(t, tangent.w), n, ttt);
+        transformed_tangent = terrain_tangent_space_transform(vec4(t, vert_tangent.w), n, ttt);
         vary_tangents[3] = normalize(transformed_tangent.xyz);
         vary_signs[3] = transformed_tangent.w;
     }
@@ -128,13 +148,13 @@ void main()
     // Transform and pass tex coords
     {
         vec4[2] ttt;
-#define transform_xy()             terrain_texture_transform(position.xy,               ttt)
+#define transform_xy()             terrain_texture_transform(vert.xy,                   ttt)
 #if TERRAIN_PLANAR_TEXTURE_SAMPLE_COUNT == 3
 // Don't care about upside-down (transform_xy_flipped())
-#define transform_yz()             terrain_texture_transform(position.yz,               ttt)
-#define transform_negx_z()         terrain_texture_transform(position.xz * vec2(-1, 1), ttt)
-#define transform_yz_flipped()     terrain_texture_transform(position.yz * vec2(-1, 1), ttt)
-#define transform_negx_z_flipped() terrain_texture_transform(position.xz,               ttt)
+#define transform_yz()             terrain_texture_transform(vert.yz,                   ttt)
+#define transform_negx_z()         terrain_texture_transform(vert.xz * vec2(-1, 1),     ttt)
+#define transform_yz_flipped()     terrain_texture_transform(vert.yz * vec2(-1, 1),     ttt)
+#define transform_negx_z_flipped() terrain_texture_transform(vert.xz,                   ttt)
         // material 1
         ttt[0].xyz = terrain_texture_transforms[0].xyz;
         ttt[1].x = terrain_texture_transforms[0].w;
@@ -194,11 +214,11 @@ void main()
     }
 
 #if TERRAIN_PAINT_TYPE == TERRAIN_PAINT_TYPE_HEIGHTMAP_WITH_NOISE
-    vec2 tc = texcoord1.xy;
+    vec2 tc = vert_texcoord1.xy;
     vary_texcoord0.zw = tc.xy;
     vary_texcoord1.xy = tc.xy-vec2(2.0, 0.0);
     vary_texcoord1.zw = tc.xy-vec2(1.0, 0.0);
 #elif TERRAIN_PAINT_TYPE == TERRAIN_PAINT_TYPE_PBR_PAINTMAP
-    vary_texcoord = position.xy / region_scale;
+    vary_texcoord = vert.xy / region_scale;
 #endif
 }
@@ -27,8 +27,22 @@ uniform mat4 modelview_projection_matrix;
 
 in vec3 position;
 
+#ifdef TERRAIN_GPU
+void terrain_gpu_vertex(vec2 grid, out vec3 position, out vec3 normal, out vec4 tangent, out vec2 texcoord1);
+#endif
+
 void main()
 {
+#ifdef TERRAIN_GPU
+    vec3 vert;
+    vec3 vert_normal;
+    vec4 vert_tangent;
+    vec2 vert_texcoord1;
+    terrain_gpu_vertex(position.xy, vert, vert_normal, vert_tangent, vert_texcoord1);
+#else
+    vec3 vert = position;
+#endif
+
     //transform vertex
-    gl_Position = modelview_projection_matrix*vec4(position.xyz, 1.0);
+    gl_Position = modelview_projection_matrix*vec4(vert.xyz, 1.0);
 }
@@ -0,0 +1,93 @@
+/**
+ * @file temporalUpscaleF.glsl
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+/*[EXTRA_CODE_HERE]*/
+
+// Reconstructs a display resolution frame from a jittered render resolution frame and
+// the previous output (LLPipeline::applyTemporalUpscale). Each output pixel blends the
+// nearest render texel into its reprojected history, weighted by how close the jittered
+// texel center landed to the pixel. History outside the neighborhood of the current
+// texels is clamped into it so disocclusions and moving objects don't ghost.
+
+out vec4 frag_color;
+
+uniform sampler2D diffuseRect; // this frame at render resolution
+uniform sampler2D depthMap;    // this frame's depth at render resolution
+uniform sampler2D sceneMap;    // last frame's output at display resolution
+
+uniform mat4 reproj_mat;       // this frame's clip space to last frame's clip space, both jittered
+uniform vec2 render_res;
+uniform vec2 jitter;           // this frame's jitter in render texels
+uniform vec2 last_jitter;      // last frame's jitter in NDC
+uniform float history_weight;  // how many frames the history stands for, 0 for none
+
+in vec2 vary_fragcoord;
+
+void main()
+{
+    // where this pixel's center landed in the jittered render, in texels
+    vec2 pos = vary_fragcoord * render_res + jitter;
+    ivec2 tc = clamp(ivec2(floor(pos)), ivec2(0), ivec2(render_res) - 1);
+    vec2 d = pos - (vec2(tc) + 0.5);
+
+    if (history_weight <= 0.0)
+    {
+        frag_color = vec4(texture(diffuseRect, pos / render_res).rgb, 1.0);
+        return;
+    }
+
+    vec3 cur = texelFetch(diffuseRect, tc, 0).rgb;
+    vec3 mn = cur;
+    vec3 mx = cur;
+    for (int y = -1; y <= 1; ++y)
+    {
+        for (int x = -1; x <= 1; ++x)
+        {
+            ivec2 ntc = clamp(tc + ivec2(x, y), ivec2(0), ivec2(render_res) - 1);
+            vec3 c = texelFetch(diffuseRect, ntc, 0).rgb;
+            mn = min(mn, c);
+            mx = max(mx, c);
+        }
+    }
+
+    // reproject the texel center, then step back to this pixel
+    float depth = texelFetch(depthMap, tc, 0).r;
+    vec4 clip = vec4((vec2(tc) + 0.5) / render_res * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    vec4 last = reproj_mat * clip;
+    vec2 history_tc = ((last.xy / last.w) - last_jitter) * 0.5 + 0.5 + d / render_res;
+
+    if (any(lessThan(history_tc, vec2(0))) || any(greaterThan(history_tc, vec2(1))))
+    {
+        frag_color = vec4(texture(diffuseRect, pos / render_res).rgb, 1.0);
+        return;
+    }
+
+    vec3 history = clamp(texture(sceneMap, history_tc).rgb, mn, mx);
+
+    // gaussian falloff with the distance from the texel center, in render texels
+    float w = exp(-2.29 * dot(d, d));
+
+    frag_color = vec4(mix(history, cur, w / (w + history_weight)), 1.0);
+}
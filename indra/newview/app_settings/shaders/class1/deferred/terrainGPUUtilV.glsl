@@ -0,0 +1,67 @@
+/**
+ * @file class1\deferred\terrainGPUUtilV.glsl
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+// Terrain vertices for LLTerrainGPU. Every patch is drawn with a flat grid
+// that gets displaced by the region's height map here, see llterraingpu.h
+
+uniform sampler2D terrain_height_map; // per grid point: height, composition, detail noise
+uniform vec4 terrain_node;   // xy patch origin in region space, z patch width in meters, w grid quads per edge
+uniform vec2 terrain_morph;  // distance the morph to the next level starts at, 1/length of the morph
+uniform vec2 terrain_grid;   // meters per grid point, 1/height map size
+uniform vec3 terrain_camera; // xy camera in region space, z squared camera height above the terrain
+
+vec3 terrain_sample(vec2 xy)
+{
+    // grid point i is the center of texel i
+    return texture(terrain_height_map, (xy / terrain_grid.x + 0.5) * terrain_grid.y).rgb;
+}
+
+// grid is the position within the patch in [0, 1]
+void terrain_gpu_vertex(vec2 grid, out vec3 position, out vec3 normal, out vec4 tangent, out vec2 texcoord1)
+{
+    float quads = terrain_node.w;
+
+    // the morph only depends on where the undisplaced vertex is, so patches agree along shared edges
+    vec2 d = terrain_node.xy + grid * terrain_node.z - terrain_camera.xy;
+    float dist = sqrt(dot(d, d) + terrain_camera.z);
+    float morph = clamp((dist - terrain_morph.x) * terrain_morph.y, 0.0, 1.0);
+
+    // slide odd vertices onto their even neighbor, at 1 the grid is the next level's
+    grid -= fract(grid * quads * 0.5) * 2.0 / quads * morph;
+
+    vec2 xy = terrain_node.xy + grid * terrain_node.z;
+    vec3 s = terrain_sample(xy);
+    position = vec3(xy, s.r);
+
+    float mpg = terrain_grid.x;
+    float dx = terrain_sample(xy + vec2(mpg, 0.0)).r - terrain_sample(xy - vec2(mpg, 0.0)).r;
+    float dy = terrain_sample(xy + vec2(0.0, mpg)).r - terrain_sample(xy - vec2(0.0, mpg)).r;
+    normal = normalize(vec3(-dx, -dy, 2.0 * mpg));
+
+    // texture coordinates run along x and y, as in gen_terrain_tangents
+    tangent = vec4(normalize(vec3(1.0, 0.0, 0.0) - normal * normal.x), 1.0);
+
+    texcoord1 = s.gb;
+}
@@ -29,9 +29,13 @@ uniform mat4 modelview_matrix;
 uniform mat4 modelview_projection_matrix;
 
 in vec3 position;
+#ifdef TERRAIN_GPU
+void terrain_gpu_vertex(vec2 grid, out vec3 position, out vec3 normal, out vec4 tangent, out vec2 texcoord1);
+#else
 in vec3 normal;
 in vec4 diffuse_color;
 in vec2 texcoord1;
+#endif
 
 out vec3 pos;
 out vec3 vary_normal;
@@ -57,19 +61,32 @@ vec2 texgen_object(vec4 vpos, mat4 mat, vec4 tp0, vec4 tp1)
 
 void main()
 {
+#ifdef TERRAIN_GPU
+    // position is within the patch grid, see terrainGPUUtilV.glsl
+    vec3 vert;
+    vec3 vert_normal;
+    vec4 vert_tangent;
+    vec2 vert_texcoord1;
+    terrain_gpu_vertex(position.xy, vert, vert_normal, vert_tangent, vert_texcoord1);
+#else
+    vec3 vert = position;
+    vec3 vert_normal = normal;
+    vec2 vert_texcoord1 = texcoord1;
+#endif
+
     //transform vertex
-    vec4 pre_pos = vec4(position.xyz, 1.0);
+    vec4 pre_pos = vec4(vert.xyz, 1.0);
     vec4 t_pos = modelview_projection_matrix * pre_pos;
 
     gl_Position = t_pos;
     pos = (modelview_matrix*pre_pos).xyz;
 
-    vary_normal = normalize(normal_matrix * normal);
+    vary_normal = normalize(normal_matrix * vert_normal);
 
     // Transform and pass tex coords
-    vary_texcoord0.xy = texgen_object(vec4(position, 1.0), texture_matrix0, object_plane_s, object_plane_t);
+    vary_texcoord0.xy = texgen_object(vec4(vert, 1.0), texture_matrix0, object_plane_s, object_plane_t);
 
-    vec4 t = vec4(texcoord1,0,1);
+    vec4 t = vec4(vert_texcoord1,0,1);
 
     vary_texcoord0.zw = t.xy;
     vary_texcoord1.xy = t.xy-vec2(2.0, 0.0);
@@ -29,12 +29,26 @@ uniform mat4 modelview_projection_matrix;
 in vec3 position;
 in vec2 texcoord0;
 
+#ifdef TREE_INSTANCES
+// region space transform of each tree in the draw, see LLDrawPoolTree
+layout (std140) uniform TreeInstances
+{
+    mat3x4 treeInstance[TREE_INSTANCES];
+};
+#endif
+
 out vec2 vary_texcoord0;
 
 void main()
 {
+#ifdef TREE_INSTANCES
+    vec3 pos = vec4(position.xyz, 1.0) * treeInstance[gl_InstanceID];
+#else
+    vec3 pos = position.xyz;
+#endif
+
     //transform vertex
-    gl_Position = modelview_projection_matrix*vec4(position.xyz, 1.0);
+    gl_Position = modelview_projection_matrix*vec4(pos, 1.0);
 
     vary_texcoord0 = (texture_matrix0 * vec4(texcoord0,0,1)).xy;
 }
@@ -32,6 +32,14 @@ in vec3 position;
 in vec3 normal;
 in vec2 texcoord0;
 
+#ifdef TREE_INSTANCES
+// region space transform of each tree in the draw, see LLDrawPoolTree
+layout (std140) uniform TreeInstances
+{
+    mat3x4 treeInstance[TREE_INSTANCES];
+};
+#endif
+
 out vec3 vary_normal;
 out vec4 vertex_color;
 out vec2 vary_texcoord0;
@@ -39,13 +47,22 @@ out vec3 vary_position;
 
 void main()
 {
+#ifdef TREE_INSTANCES
+    mat3x4 instance = treeInstance[gl_InstanceID];
+    vec3 pos = vec4(position.xyz, 1.0) * instance;
+    vec3 norm = vec4(normal, 0.0) * instance;
+#else
+    vec3 pos = position.xyz;
+    vec3 norm = normal;
+#endif
+
     //transform vertex
-    gl_Position = modelview_projection_matrix * vec4(position.xyz, 1.0);
-    vary_position = (modelview_matrix*vec4(position.xyz, 1.0)).xyz;
+    gl_Position = modelview_projection_matrix * vec4(pos, 1.0);
+    vary_position = (modelview_matrix*vec4(pos, 1.0)).xyz;
 
     vary_texcoord0 = (texture_matrix0 * vec4(texcoord0,0,1)).xy;
 
-    vary_normal = normalize(normal_matrix * normal);
+    vary_normal = normalize(normal_matrix * norm);
 
     vertex_color = vec4(1,1,1,1);
 }
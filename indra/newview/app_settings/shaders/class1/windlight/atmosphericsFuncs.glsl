@@ -27,14 +27,7 @@ uniform vec3  lightnorm;
 uniform vec3  sunlight_color;
 uniform vec3  moonlight_color;
 uniform int   sun_up_factor;
-uniform vec3  ambient_color;
-uniform vec3  blue_horizon;
-uniform vec3  blue_density;
-uniform float haze_horizon;
-uniform float haze_density;
 uniform float cloud_shadow;
-uniform float density_multiplier;
-uniform float distance_multiplier;
 uniform float max_y;
 uniform vec3  glow;
 uniform float scene_light_strength;
@@ -42,6 +35,13 @@ uniform float sun_moon_glow_factor;
 uniform float sky_sunlight_scale;
 uniform float sky_ambient_scale;
 
+// terms that don't depend on position, see LLSettingsVOSky::applySpecial
+uniform vec3  atmo_transmittance; // sun and moon light attenuation due to atmosphere
+uniform vec3  atmo_ambient;       // ambient increased when there are more clouds
+uniform vec3  atmo_extinction;    // combined haze * density and distance multipliers
+uniform vec3  atmo_blue_weight;   // blue horizon * blue density share of combined haze
+uniform vec3  atmo_haze_weight;   // haze horizon * haze density share of combined haze
+
 float getAmbientClamp() { return 1.0f; }
 
 vec3 srgb_to_linear(vec3 col);
@@ -58,32 +58,10 @@ void calcAtmosphericVars(vec3 inPositionEye, vec3 light_dir, float ambFactor, ou
     vec3  rel_pos_norm = normalize(rel_pos);
     float rel_pos_len  = length(rel_pos);
 
-    vec3  sunlight     = (sun_up_factor == 1) ? sunlight_color: moonlight_color;
-
-    // sunlight attenuation effect (hue and brightness) due to atmosphere
-    // this is used later for sunlight modulation at various altitudes
-    vec3 light_atten = (blue_density + vec3(haze_density * 0.25)) * (density_multiplier * max_y);
-    // I had thought blue_density and haze_density should have equal weighting,
-    // but attenuation due to haze_density tends to seem too strong
-
-    vec3 combined_haze = max(blue_density + vec3(haze_density), vec3(1e-6));
-    vec3 blue_weight   = blue_density / combined_haze;
-    vec3 haze_weight   = vec3(haze_density) / combined_haze;
-
-    //(TERRAIN) compute sunlight from lightnorm y component. Factor is roughly cosecant(sun elevation) (for short rays like terrain)
-    float above_horizon_factor = 1.0 / max(1e-6, lightnorm.y);
-    sunlight *= exp(-light_atten * above_horizon_factor);  // for sun [horizon..overhead] this maps to an exp curve [0..1]
-
-    // main atmospheric scattering line integral
-    float density_dist = rel_pos_len * density_multiplier;
-
-    // Transparency (-> combined_haze)
-    // ATI Bugfix -- can't store combined_haze*density_dist*distance_multiplier in a variable because the ati
-    // compiler gets confused.
-    combined_haze = exp(-combined_haze * density_dist * distance_multiplier);
+    vec3  sunlight     = ((sun_up_factor == 1) ? sunlight_color : moonlight_color) * atmo_transmittance;
 
     // final atmosphere attenuation factor
-    atten = combined_haze.rgb;
+    atten = exp(-atmo_extinction * rel_pos_len);
 
     // compute haze glow
     float haze_glow = dot(rel_pos_norm, lightnorm.xyz);
@@ -106,24 +84,20 @@ void calcAtmosphericVars(vec3 inPositionEye, vec3 light_dir, float ambFactor, ou
 
     haze_glow *= sun_moon_glow_factor;
 
-    vec3 amb_color = ambient_color;
-
-    // increase ambient when there are more clouds
-    vec3 tmpAmbient = amb_color + (vec3(1.) - amb_color) * cloud_shadow * 0.5;
-
     // Similar/Shared Algorithms:
     //     indra\llinventory\llsettingssky.cpp                                        -- LLSettingsSky::calculateLightSettings()
+    //     indra\newview\llsettingsvo.cpp                                             -- LLSettingsVOSky::applySpecial()
     //     indra\newview\app_settings\shaders\class1\windlight\atmosphericsFuncs.glsl -- calcAtmosphericVars()
     // haze color
     vec3 cs = sunlight.rgb * (1. - cloud_shadow);
-    additive = (blue_horizon.rgb * blue_weight.rgb) * (cs + tmpAmbient.rgb) + (haze_horizon * haze_weight.rgb) * (cs * haze_glow + tmpAmbient.rgb);
+    additive = atmo_blue_weight * (cs + atmo_ambient) + atmo_haze_weight * (cs * haze_glow + atmo_ambient);
 
     // brightness of surface both sunlight and ambient
 
     sunlit = sunlight.rgb;
-    amblit = tmpAmbient;
+    amblit = atmo_ambient;
 
-    additive *= vec3(1.0 - combined_haze);
+    additive *= vec3(1.0) - atten;
 
     // sanity clamp haze contribution
     additive = min(additive, vec3(10));
@@ -31,7 +31,11 @@
 #define NON_INDEXED 2
 #define NON_INDEXED_NO_COLOR 3
 
+#ifdef WB_OIT
+out vec4 frag_data[2]; // weighted blended transparency accumulation, see LLDrawPoolAlpha::renderOIT
+#else
 out vec4 frag_color;
+#endif
 
 uniform mat3 env_mat;
 uniform vec3 sun_dir;
@@ -291,6 +295,14 @@ void main()
     color.rgb = linear_to_srgb(color.rgb);
 #endif
 
+#ifdef WB_OIT
+    // the weight falls off with distance so nearer surfaces dominate, see "Weighted Blended Order-Independent Transparency", McGuire & Bavoil 2013
+    float oit_z = abs(pos.z);
+    float oit_w = color.a * clamp(10.0 / (1e-5 + pow(oit_z / 5.0, 2.0) + pow(oit_z / 200.0, 6.0)), 1e-2, 3e3);
+    frag_data[0] = vec4(max(color.rgb, vec3(0)) * oit_w, color.a);
+    frag_data[1] = vec4(oit_w, 0, 0, 0);
+#else
     frag_color = max(color, vec4(0));
+#endif
 }
 
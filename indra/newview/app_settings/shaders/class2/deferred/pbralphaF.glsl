@@ -44,7 +44,11 @@ uniform int sun_up_factor;
 uniform vec3 sun_dir;
 uniform vec3 moon_dir;
 
+#ifdef WB_OIT
+out vec4 frag_data[2];
+#else
 out vec4 frag_color;
+#endif
 
 in vec3 vary_fragcoord;
 
@@ -220,7 +224,15 @@ void main()
 
     float a = basecolor.a*vertex_color.a;
 
+#ifdef WB_OIT
+    // same weighting as alphaF.glsl
+    float oit_z = abs(pos.z);
+    float oit_w = a * clamp(10.0 / (1e-5 + pow(oit_z / 5.0, 2.0) + pow(oit_z / 200.0, 6.0)), 1e-2, 3e3);
+    frag_data[0] = vec4(max(color.rgb, vec3(0)) * oit_w, a);
+    frag_data[1] = vec4(oit_w, 0, 0, 0);
+#else
     frag_color = max(vec4(color.rgb,a), vec4(0));
+#endif
 }
 
 #else
@@ -0,0 +1,183 @@
+/**
+ * @file class3\deferred\clusteredLightF.glsl
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+/*[EXTRA_CODE_HERE]*/
+
+// Shades every point light in the view with one full screen pass, see LLLightClusters
+
+out vec4 frag_color;
+
+uniform sampler2D diffuseRect;
+uniform sampler2D specularRect;
+uniform sampler2D emissiveRect; // PBR linear packed Occlusion, Roughness, Metal. See: pbropaqueF.glsl
+uniform sampler2D     lightFunc;
+
+uniform sampler2D clusterLights; // 2 texels per light, .w = size, then linear color, .a = falloff
+uniform sampler2D clusterGrid;   // .r = first entry in clusterIndex, .g = light count
+uniform sampler2D clusterIndex;  // indices into clusterLights
+uniform vec4  cluster_params;    // x = slice near, y = slice scale, z = slice far
+
+uniform vec2  screen_res;
+uniform mat4  inv_proj;
+
+in vec4 vary_fragcoord;
+
+void calcHalfVectors(vec3 lv, vec3 n, vec3 v, out vec3 h, out vec3 l, out float nh, out float nl, out float nv, out float vh, out float lightDist);
+float calcLegacyDistanceAttenuation(float distance, float falloff);
+vec4 getPosition(vec2 pos_screen);
+vec4 getNorm(vec2 screenpos);
+vec2 getScreenCoord(vec4 clip);
+vec3 srgb_to_linear(vec3 c);
+
+vec3 pbrPunctual(vec3 diffuseColor, vec3 specularColor,
+                    float perceptualRoughness,
+                    float metallic,
+                    vec3 n, // normal
+                    vec3 v, // surface point to camera
+                    vec3 l); //surface point to light
+
+// must match LLLightClusters::getSlice
+int getSlice(float depth)
+{
+    if (depth <= cluster_params.x)
+    {
+        return 0;
+    }
+
+    return min(1 + int(log(depth / cluster_params.x) * cluster_params.y), CLUSTER_SLICES - 1);
+}
+
+void main()
+{
+    vec3 final_color = vec3(0, 0, 0);
+    vec2 tc          = getScreenCoord(vary_fragcoord);
+    vec3 pos         = getPosition(tc).xyz;
+    float depth      = -pos.z;
+    if (depth > cluster_params.z)
+    {
+        discard;
+    }
+
+    ivec2 tile = clamp(ivec2(tc * vec2(CLUSTER_TILES_X, CLUSTER_TILES_Y)), ivec2(0), ivec2(CLUSTER_TILES_X - 1, CLUSTER_TILES_Y - 1));
+    vec2 cluster = texelFetch(clusterGrid, ivec2(tile.x + tile.y * CLUSTER_TILES_X, getSlice(depth)), 0).rg;
+    int first = int(cluster.r);
+    int count = int(cluster.g);
+    if (count == 0)
+    {
+        discard;
+    }
+
+    vec4 norm = getNorm(tc); // need `norm.w` for GET_GBUFFER_FLAG()
+    vec3 n = norm.xyz;
+
+    vec4 spec    = texture(specularRect, tc);
+    vec3 diffuse = texture(diffuseRect, tc).rgb;
+
+    vec3  h, l, v = -normalize(pos);
+    float nh, nv, vh, lightDist;
+
+    bool has_pbr = GET_GBUFFER_FLAG(GBUFFER_FLAG_HAS_PBR);
+
+    vec3 diffuseColor = vec3(0);
+    vec3 specularColor = vec3(0);
+    float perceptualRoughness = 0.0;
+    float metallic = 0.0;
+
+    if (has_pbr)
+    {
+        vec3 orm = spec.rgb;
+        perceptualRoughness = orm.g;
+        metallic = orm.b;
+        vec3 f0 = vec3(0.04);
+        vec3 baseColor = diffuse.rgb;
+
+        diffuseColor = baseColor.rgb*(vec3(1.0)-f0);
+        diffuseColor *= 1.0 - metallic;
+
+        specularColor = mix(f0, baseColor.rgb, metallic);
+    }
+    else
+    {
+        diffuse = srgb_to_linear(diffuse);
+        spec.rgb = srgb_to_linear(spec.rgb);
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        int entry = first + i;
+        int light_idx = int(texelFetch(clusterIndex, ivec2(entry % CLUSTER_INDEX_WIDTH, entry / CLUSTER_INDEX_WIDTH), 0).r);
+        vec4 light = texelFetch(clusterLights, ivec2(0, light_idx), 0);
+        vec4 light_col = texelFetch(clusterLights, ivec2(1, light_idx), 0);
+
+        vec3  lv   = light.xyz - pos;
+        lightDist  = length(lv);
+        float dist = lightDist / light.w;
+        if (dist > 1.0)
+        {
+            continue;
+        }
+
+        float dist_atten = calcLegacyDistanceAttenuation(dist, light_col.a);
+
+        if (has_pbr)
+        {
+            vec3 intensity = dist_atten * light_col.rgb * 3.25;
+
+            final_color += intensity*pbrPunctual(diffuseColor, specularColor, perceptualRoughness, metallic, n.xyz, v, lv / lightDist);
+        }
+        else
+        {
+            float nl = dot(n, lv);
+            if (nl > 0.0)
+            {
+                calcHalfVectors(lv, n, v, h, l, nh, nl, nv, vh, lightDist);
+
+                float lit = nl * dist_atten;
+
+                vec3 col = light_col.rgb * lit * diffuse;
+
+                if (spec.a > 0.0)
+                {
+                    lit        = min(nl * 6.0, 1.0) * dist_atten;
+                    float fres = pow(1 - vh, 5) * 0.4 + 0.5;
+
+                    float gtdenom = 2 * nh;
+                    float gt      = max(0, min(gtdenom * nv / vh, gtdenom * nl / vh));
+
+                    if (nh > 0.0)
+                    {
+                        float scol = fres * texture(lightFunc, vec2(nh, spec.a)).r * gt / (nh * nl);
+                        col += lit * scol * light_col.rgb * spec.rgb;
+                    }
+                }
+
+                final_color += col;
+            }
+        }
+    }
+
+    frag_color.rgb = max(final_color, vec3(0));
+    frag_color.a   = 0.0;
+}
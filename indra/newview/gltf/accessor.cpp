@@ -29,6 +29,7 @@
 #include "asset.h"
 #include "buffer_util.h"
 #include "llfilesystem.h"
+#include "llmeshoptimizer.h"
 
 using namespace LL::GLTF;
 using namespace boost::json;
@@ -178,6 +179,11 @@ bool Buffer::prep(Asset& asset)
         file.read((char*)mData.data(), mData.size());
     }
 
+    else if (mMeshopt.mFallback && mData.empty())
+    { // filled in when the compressed buffer views are decoded
+        mData.resize(mByteLength);
+    }
+
     // POSTCONDITION: on success, mData.size == mByteLength
     llassert(mData.size() == mByteLength);
     return true;
@@ -225,6 +231,7 @@ void Buffer::serialize(object& dst) const
     write(mName, "name", dst);
     write(mUri, "uri", dst);
     write_always(mByteLength, "byteLength", dst);
+    write_extensions(dst, &mMeshopt, "EXT_meshopt_compression");
 };
 
 const Buffer& Buffer::operator=(const Value& src)
@@ -234,6 +241,7 @@ const Buffer& Buffer::operator=(const Value& src)
         copy(src, "name", mName);
         copy(src, "uri", mUri);
         copy(src, "byteLength", mByteLength);
+        copy_extensions(src, "EXT_meshopt_compression", &mMeshopt);
 
         // NOTE: DO NOT attempt to handle the uri here.
         // The uri is a reference to a file that is not loaded until
@@ -250,6 +258,7 @@ void BufferView::serialize(object& dst) const
     write(mByteStride, "byteStride", dst, 0);
     write(mTarget, "target", dst, -1);
     write(mName, "name", dst);
+    write_extensions(dst, &mMeshopt, "EXT_meshopt_compression");
 }
 
 const BufferView& BufferView::operator=(const Value& src)
@@ -262,10 +271,135 @@ const BufferView& BufferView::operator=(const Value& src)
         copy(src, "byteStride", mByteStride);
         copy(src, "target", mTarget);
         copy(src, "name", mName);
+        copy_extensions(src, "EXT_meshopt_compression", &mMeshopt);
     }
     return *this;
 }
 
+bool BufferView::decode(Asset& asset)
+{
+    if (!mMeshopt.mPresent)
+    {
+        return true;
+    }
+
+    const MeshoptCompression& ext = mMeshopt;
+
+    LLMeshOptimizer::EDecodeMode mode;
+    if (ext.mMode == "ATTRIBUTES")
+    {
+        mode = LLMeshOptimizer::DECODE_ATTRIBUTES;
+    }
+    else if (ext.mMode == "TRIANGLES")
+    {
+        mode = LLMeshOptimizer::DECODE_TRIANGLES;
+    }
+    else if (ext.mMode == "INDICES")
+    {
+        mode = LLMeshOptimizer::DECODE_INDICES;
+    }
+    else
+    {
+        LL_WARNS("GLTF") << "Unknown meshopt mode: " << ext.mMode << LL_ENDL;
+        return false;
+    }
+
+    LLMeshOptimizer::EDecodeFilter filter;
+    if (ext.mFilter.empty() || ext.mFilter == "NONE")
+    {
+        filter = LLMeshOptimizer::FILTER_NONE;
+    }
+    else if (ext.mFilter == "OCTAHEDRAL")
+    {
+        filter = LLMeshOptimizer::FILTER_OCTAHEDRAL;
+    }
+    else if (ext.mFilter == "QUATERNION")
+    {
+        filter = LLMeshOptimizer::FILTER_QUATERNION;
+    }
+    else if (ext.mFilter == "EXPONENTIAL")
+    {
+        filter = LLMeshOptimizer::FILTER_EXPONENTIAL;
+    }
+    else
+    {
+        LL_WARNS("GLTF") << "Unknown meshopt filter: " << ext.mFilter << LL_ENDL;
+        return false;
+    }
+
+    if (ext.mBuffer < 0 || (size_t)ext.mBuffer >= asset.mBuffers.size() || ext.mBuffer == mBuffer ||
+        mBuffer < 0 || (size_t)mBuffer >= asset.mBuffers.size())
+    {
+        LL_WARNS("GLTF") << "Invalid meshopt buffer index" << LL_ENDL;
+        return false;
+    }
+
+    const Buffer& src = asset.mBuffers[ext.mBuffer];
+    Buffer& dst = asset.mBuffers[mBuffer];
+
+    if (ext.mByteOffset < 0 || ext.mByteLength < 0 || ext.mCount < 0 || ext.mByteStride <= 0 ||
+        (size_t)ext.mByteOffset + ext.mByteLength > src.mData.size() ||
+        (U64)ext.mCount * ext.mByteStride > (U64)mByteLength ||
+        mByteOffset < 0 || (size_t)mByteOffset + mByteLength > dst.mData.size())
+    {
+        LL_WARNS("GLTF") << "meshopt compressed buffer view out of range" << LL_ENDL;
+        return false;
+    }
+
+    if (!LLMeshOptimizer::decodeBuffer(dst.mData.data() + mByteOffset, ext.mCount, ext.mByteStride,
+                                       src.mData.data() + ext.mByteOffset, ext.mByteLength, mode, filter))
+    {
+        LL_WARNS("GLTF") << "Failed to decode meshopt compressed buffer view " << mName << LL_ENDL;
+        return false;
+    }
+
+    return true;
+}
+
+const MeshoptFallback& MeshoptFallback::operator=(const Value& src)
+{
+    mPresent = true;
+    if (src.is_object())
+    {
+        copy(src, "fallback", mFallback);
+    }
+
+    return *this;
+}
+
+void MeshoptFallback::serialize(object& dst) const
+{
+    write(mFallback, "fallback", dst, false);
+}
+
+const MeshoptCompression& MeshoptCompression::operator=(const Value& src)
+{
+    mPresent = true;
+    if (src.is_object())
+    {
+        copy(src, "buffer", mBuffer);
+        copy(src, "byteOffset", mByteOffset);
+        copy(src, "byteLength", mByteLength);
+        copy(src, "byteStride", mByteStride);
+        copy(src, "count", mCount);
+        copy(src, "mode", mMode);
+        copy(src, "filter", mFilter);
+    }
+
+    return *this;
+}
+
+void MeshoptCompression::serialize(object& dst) const
+{
+    write_always(mBuffer, "buffer", dst);
+    write(mByteOffset, "byteOffset", dst, 0);
+    write_always(mByteLength, "byteLength", dst);
+    write_always(mByteStride, "byteStride", dst);
+    write_always(mCount, "count", dst);
+    write_always(mMode, "mode", dst);
+    write(mFilter, "filter", dst);
+}
+
 void Accessor::serialize(object& dst) const
 {
     write(mName, "name", dst);
@@ -36,6 +36,34 @@ namespace LL
 {
     namespace GLTF
     {
+        class MeshoptFallback : public Extension // EXT_meshopt_compression implementation, buffers
+        {
+        public:
+            // true if the buffer has no data of its own and is filled in by
+            // decoding the buffer views that reference it
+            bool mFallback = false;
+
+            const MeshoptFallback& operator=(const Value& src);
+            void serialize(boost::json::object& dst) const;
+        };
+
+        class MeshoptCompression : public Extension // EXT_meshopt_compression implementation, buffer views
+        {
+        public:
+            // where the encoded data is
+            S32 mBuffer = INVALID_INDEX;
+            S32 mByteOffset = 0;
+            S32 mByteLength = 0;
+            // layout of the decoded data
+            S32 mByteStride = 0;
+            S32 mCount = 0;
+            std::string mMode;
+            std::string mFilter;
+
+            const MeshoptCompression& operator=(const Value& src);
+            void serialize(boost::json::object& dst) const;
+        };
+
         class Buffer
         {
         public:
@@ -44,6 +72,8 @@ namespace LL
             std::string mUri;
             S32 mByteLength = 0;
 
+            MeshoptFallback mMeshopt;
+
             // erase the given range from this buffer.
             // also updates all buffer views in given asset that reference this buffer
             void erase(Asset& asset, S32 offset, S32 length);
@@ -67,6 +97,12 @@ namespace LL
 
             std::string mName;
 
+            MeshoptCompression mMeshopt;
+
+            // decode compressed data into the range of mBuffer this view
+            // covers, does nothing for an uncompressed view
+            bool decode(Asset& asset);
+
             void serialize(boost::json::object& obj) const;
             const BufferView& operator=(const Value& value);
         };
@@ -28,6 +28,7 @@
 
 #include "asset.h"
 #include "llvolumeoctree.h"
+#include "llparallel.h"
 #include "../llviewershadermgr.h"
 #include "../llviewercontrol.h"
 #include "../llviewertexturelist.h"
@@ -46,6 +47,7 @@ namespace LL
     namespace GLTF
     {
         static std::unordered_set<std::string> ExtensionsSupported = {
+            "EXT_meshopt_compression",
             "KHR_materials_unlit",
             "KHR_texture_transform"
         };
@@ -503,14 +505,42 @@ bool Asset::prep()
     }
 
     // do buffers first as other resources depend on them
-    for (auto& buffer : mBuffers)
+    // each buffer is read from its own file, so read them side by side
+    std::atomic<bool> failed{ false };
+    LL::parallel_for(size_t(0), mBuffers.size(), size_t(1),
+        [this, &failed](size_t first, size_t last)
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                if (!mBuffers[i].prep(*this))
+                {
+                    failed = true;
+                }
+            }
+        });
+    if (failed)
     {
-        if (!buffer.prep(*this))
+        return false;
+    }
+
+    // compressed buffer views expand into their own ranges of the buffers
+    LL::parallel_for(size_t(0), mBufferViews.size(), size_t(1),
+        [this, &failed](size_t first, size_t last)
         {
-            return false;
-        }
+            for (size_t i = first; i < last; ++i)
+            {
+                if (!mBufferViews[i].decode(*this))
+                {
+                    failed = true;
+                }
+            }
+        });
+    if (failed)
+    {
+        return false;
     }
 
+    // images go through the texture manager, which lives on this thread
     for (auto& image : mImages)
     {
         if (!image.prep(*this))
@@ -519,13 +549,31 @@ bool Asset::prep()
         }
     }
 
+    // primitives only read the buffers and the materials while they copy out
+    // their attributes and build tangents and octrees
+    std::vector<Primitive*> primitives;
     for (auto& mesh : mMeshes)
     {
-        if (!mesh.prep(*this))
+        for (auto& primitive : mesh.mPrimitives)
         {
-            return false;
+            primitives.push_back(&primitive);
         }
     }
+    LL::parallel_for(size_t(0), primitives.size(), size_t(1),
+        [this, &primitives, &failed](size_t first, size_t last)
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                if (!primitives[i]->prep(*this))
+                {
+                    failed = true;
+                }
+            }
+        });
+    if (failed)
+    {
+        return false;
+    }
 
     for (auto& animation : mAnimations)
     {
@@ -50,14 +50,6 @@ namespace LL
     {
         class Asset;
 
-        class Extension
-        {
-        public:
-            // true if this extension is present in the gltf file
-            // otherwise false
-            bool mPresent = false;
-        };
-
         class TextureTransform : public Extension // KHR_texture_transform implementation
         {
         public:
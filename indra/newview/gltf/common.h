@@ -94,6 +94,14 @@ namespace LL
         };
 
         constexpr U32 TEXTURE_TYPE_COUNT = 5;
+
+        class Extension
+        {
+        public:
+            // true if this extension is present in the gltf file
+            // otherwise false
+            bool mPresent = false;
+        };
     }
 }
 
@@ -748,7 +748,10 @@ void GLTFSceneManager::bindTexture(Asset& asset, TextureType texture_type, Textu
 
     if (channel > -1)
     {
-        glActiveTexture(GL_TEXTURE0 + channel);
+        // go through the texture unit so its record of what is bound stays
+        // right, and leave it active for the sampler state below
+        LLTexUnit* unit = gGL.getTexUnit(channel);
+        unit->activate();
 
         if (info.mIndex != INVALID_INDEX)
         {
@@ -758,7 +761,7 @@ void GLTFSceneManager::bindTexture(Asset& asset, TextureType texture_type, Textu
             if (tex)
             {
                 LL_PROFILE_ZONE_NAMED_CATEGORY_GLTF("gl bind texture");
-                glBindTexture(GL_TEXTURE_2D, tex->getTexName());
+                unit->bindManual(LLTexUnit::TT_TEXTURE, tex->getTexName());
 
                 if (channel != -1 && texture.mSampler != -1)
                 { // set sampler state
@@ -779,12 +782,12 @@ void GLTFSceneManager::bindTexture(Asset& asset, TextureType texture_type, Textu
             }
             else
             {
-                glBindTexture(GL_TEXTURE_2D, fallback->getTexName());
+                unit->bindManual(LLTexUnit::TT_TEXTURE, fallback->getTexName());
             }
         }
         else
         {
-            glBindTexture(GL_TEXTURE_2D, fallback->getTexName());
+            unit->bindManual(LLTexUnit::TT_TEXTURE, fallback->getTexName());
         }
     }
 }
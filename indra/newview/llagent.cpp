@@ -91,6 +91,7 @@
 #include "llviewerstats.h"
 #include "llviewerwindow.h"
 #include "llvoavatarself.h"
+#include "llvocache.h"
 #include "llwindow.h"
 #include "llworld.h"
 #include "llworldmap.h"
@@ -403,6 +404,7 @@ LLAgent::LLAgent() :
     mLastKnownResponseMaturity(SIM_ACCESS_MIN),
     mHttpPolicy(LLCore::HttpRequest::DEFAULT_POLICY_ID),
     mTeleportState(TELEPORT_NONE),
+    mRegionHttpScope(std::make_shared<LLCoreHttpUtil::HttpCancelScope>()),
     mRegionp(NULL),
     mInterestListMode(IL_MODE_DEFAULT),
 
@@ -4297,6 +4299,12 @@ void LLAgent::teleportRequest(
         }
         msg->addVector3("LookAt", look_at);
         sendReliableMessage();
+
+        if (region_handle != regionp->getHandle() && LLVOCache::instanceExists())
+        {
+            // the disk reads for the destination can get going while the sim works out the teleport
+            LLVOCache::getInstance()->prefetchAssets(region_handle);
+        }
     }
 }
 
@@ -4526,6 +4534,9 @@ void LLAgent::setTeleportState(ETeleportState state)
         case TELEPORT_MOVING:
         // We're outa here. Save "back" slurl.
         LLAgentUI::buildSLURL(*mTeleportSourceSLURL);
+        // Replies from the region we leave are of no use now
+        mRegionHttpScope->cancel();
+        mRegionHttpScope = std::make_shared<LLCoreHttpUtil::HttpCancelScope>();
             break;
 
         case TELEPORT_ARRIVING:
@@ -736,8 +736,12 @@ private:
 public:
     ETeleportState  getTeleportState() const;
     void            setTeleportState(ETeleportState state);
+
+    // Capability requests made for the current region, canceled when a teleport leaves it
+    const LLCoreHttpUtil::HttpCancelScope::ptr_t& getRegionHttpScope() const { return mRegionHttpScope; }
 private:
     ETeleportState  mTeleportState;
+    LLCoreHttpUtil::HttpCancelScope::ptr_t mRegionHttpScope;
 
     //--------------------------------------------------------------------
     // Teleport Message
@@ -1426,8 +1426,9 @@ void LLAgentCamera::updateCamera()
         if (cameraThirdPerson() && !mCameraSmoothingStop)
         {
             const F32 SMOOTHING_HALF_LIFE = 0.02f;
+            static LLCachedControl<F32> camera_position_smoothing(gSavedSettings, "CameraPositionSmoothing");
 
-            F32 smoothing = LLSmoothInterpolation::getInterpolant(gSavedSettings.getF32("CameraPositionSmoothing") * SMOOTHING_HALF_LIFE, false);
+            F32 smoothing = LLSmoothInterpolation::getInterpolant(camera_position_smoothing * SMOOTHING_HALF_LIFE, false);
 
             if (mFocusOnAvatar && !mFocusObject) // we differentiate on avatar mode
             {
@@ -32,14 +32,28 @@
 
 #include "llagentpilot.h"
 #include "llagent.h"
+#include "llagentpilotlistener.h"
 #include "llappviewer.h"
+#include "llgl.h"
+#include "llgpupasstimers.h"
+#include "llstartup.h"
 #include "llviewercontrol.h"
 #include "llviewercamera.h"
+#include "llsdjson.h"
 #include "llsdserialize.h"
 #include "llsdutil_math.h"
+#include "llviewerstats.h"
+
+#include <boost/json.hpp>
+
+// defined in llviewerdisplay.cpp, shared with the shader profile report
+void getProfileStatsContext(boost::json::object& stats);
 
 LLAgentPilot gAgentPilot;
 
+// constructed after gAgentPilot, which it connects to
+static LLAgentPilotListener sAgentPilotListener;
+
 LLAgentPilot::LLAgentPilot() :
     mNumRuns(-1),
     mQuitAfterRuns(false),
@@ -49,6 +63,9 @@ LLAgentPilot::LLAgentPilot() :
     mPlaying(false),
     mCurrentAction(0),
     mOverrideCamera(false),
+    mBenchmarking(false),
+    mBenchmarkSeconds(0.f),
+    mBenchmarkWarmup(0.f),
     mLoop(true),
     mReplaySession(false)
 {
@@ -255,6 +272,9 @@ void LLAgentPilot::startPlayback()
         mPlaying = true;
         mCurrentAction = 0;
         mTimer.reset();
+        mFrameTimes.clear();
+        mFrameTriangles.clear();
+        mFrameGPUTimes.clear();
 
         if (mActions.size())
         {
@@ -287,6 +307,92 @@ void LLAgentPilot::stopPlayback()
     }
 }
 
+void LLAgentPilot::startBenchmark(F32 seconds, F32 warmup)
+{
+    if (mPlaying || mBenchmarking || seconds <= 0.f)
+    {
+        return;
+    }
+
+    LL_INFOS("AgentPilot") << "Starting benchmark of " << seconds << " seconds after " << warmup
+                           << " seconds of warmup" << LL_ENDL;
+    if (gHeadlessClient)
+    {
+        // the headless window has no GL context to render with
+        LL_WARNS("AgentPilot") << "Benchmarking a headless client, frame times won't include rendering" << LL_ENDL;
+    }
+    mBenchmarking = true;
+    mBenchmarkSeconds = seconds;
+    mBenchmarkWarmup = llmax(warmup, 0.f);
+    mStarted = false;
+    mTimer.reset();
+    mFrameTimes.clear();
+    mFrameTriangles.clear();
+    mFrameGPUTimes.clear();
+}
+
+void LLAgentPilot::stopBenchmark()
+{
+    if (mBenchmarking)
+    {
+        LL_INFOS("AgentPilot") << "Benchmark cancelled" << LL_ENDL;
+        mBenchmarking = false;
+        mFrameTimes.clear();
+        mFrameTriangles.clear();
+        mFrameGPUTimes.clear();
+        runsDone();
+    }
+}
+
+void LLAgentPilot::updateBenchmark()
+{
+    if (LLStartUp::getStartupState() < STATE_STARTED
+        || gAgent.getTeleportState() != LLAgent::TELEPORT_NONE)
+    {
+        // Nothing to measure until the agent is in a region, and a teleport
+        // throws the scene away, so warm up again from there
+        if (mStarted)
+        {
+            LL_INFOS("AgentPilot") << "Scene changed, restarting benchmark" << LL_ENDL;
+        }
+        mStarted = false;
+        mTimer.reset();
+        mFrameTimes.clear();
+        mFrameTriangles.clear();
+        mFrameGPUTimes.clear();
+        return;
+    }
+
+    if (!mStarted)
+    {
+        if (mTimer.getElapsedTimeF32() < mBenchmarkWarmup)
+        {
+            return;
+        }
+        LL_INFOS("AgentPilot") << "Warmed up, beginning benchmark" << LL_ENDL;
+        mTimer.reset();
+        mStarted = true;
+    }
+
+    recordFrame();
+    if (mTimer.getElapsedTimeF32() >= mBenchmarkSeconds)
+    {
+        finishRun();
+        mBenchmarking = false;
+        runsDone();
+        if (mQuitAfterRuns)
+        {
+            LL_INFOS("AgentPilot") << "Done benchmarking, quitting viewer!" << LL_ENDL;
+            LLAppViewer::instance()->forceQuit();
+        }
+    }
+}
+
+void LLAgentPilot::runsDone()
+{
+    mRunsDoneSignal(mRunStats);
+}
+
 void LLAgentPilot::moveCamera()
 {
     if (!getOverrideCamera())
@@ -330,7 +436,11 @@ void LLAgentPilot::moveCamera()
 
 void LLAgentPilot::updateTarget()
 {
-    if (mPlaying)
+    if (mBenchmarking)
+    {
+        updateBenchmark();
+    }
+    else if (mPlaying)
     {
         if (mCurrentAction < mActions.size())
         {
@@ -351,6 +461,7 @@ void LLAgentPilot::updateTarget()
                     }
                 }
             }
+            recordFrame();
             if (mTimer.getElapsedTimeF32() > mActions[mCurrentAction].mTime)
             {
                 //gAgent.stopAutoPilot();
@@ -363,6 +474,7 @@ void LLAgentPilot::updateTarget()
                 }
                 else
                 {
+                    finishRun();
                     stopPlayback();
                     mNumRuns--;
                     if (mLoop)
@@ -375,14 +487,20 @@ void LLAgentPilot::updateTarget()
                         else if (mQuitAfterRuns)
                         {
                             LL_INFOS() << "Done with all runs, quitting viewer!" << LL_ENDL;
+                            runsDone();
                             LLAppViewer::instance()->forceQuit();
                         }
                         else
                         {
                             LL_INFOS() << "Done with all runs, disabling pilot" << LL_ENDL;
                             stopPlayback();
+                            runsDone();
                         }
                     }
+                    else
+                    {
+                        runsDone();
+                    }
                 }
             }
         }
@@ -400,6 +518,125 @@ void LLAgentPilot::updateTarget()
     }
 }
 
+void LLAgentPilot::recordFrame()
+{
+    LLTrace::Recording& last_frame = LLTrace::get_frame_recording().getLastRecording();
+    mFrameTimes.push_back(F32Milliseconds(gFrameIntervalSeconds).value());
+    mFrameTriangles.push_back((F32)last_frame.getSum(LLStatViewer::TRIANGLES_DRAWN).value());
+    mFrameGPUTimes.push_back(gGPUPassTimers.getFrameTime());
+}
+
+void LLAgentPilot::finishRun()
+{
+    if (mFrameTimes.empty())
+    {
+        return;
+    }
+
+    std::vector<F32> sorted(mFrameTimes);
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](F32 fraction)
+    {
+        size_t index = llmin((size_t)(fraction * (F32)sorted.size()), sorted.size() - 1);
+        return (LLSD::Real)sorted[index];
+    };
+
+    F64 total_ms = 0.0;
+    for (F32 ms : mFrameTimes)
+    {
+        total_ms += ms;
+    }
+    F64 total_triangles = 0.0;
+    for (F32 triangles : mFrameTriangles)
+    {
+        total_triangles += triangles;
+    }
+    F64 total_gpu_ms = 0.0;
+    for (F32 ms : mFrameGPUTimes)
+    {
+        total_gpu_ms += ms;
+    }
+
+    LLSD run;
+    run["frames"] = (LLSD::Integer)mFrameTimes.size();
+    run["seconds"] = total_ms / 1000.0;
+    run["frame_ms_mean"] = total_ms / (F64)mFrameTimes.size();
+    run["frame_ms_p50"] = percentile(0.5f);
+    run["frame_ms_p90"] = percentile(0.9f);
+    run["frame_ms_p99"] = percentile(0.99f);
+    run["frame_ms_max"] = (LLSD::Real)sorted.back();
+    run["ktriangles_mean"] = total_triangles / (F64)mFrameTriangles.size();
+    run["gpu_ms_mean"] = total_gpu_ms / (F64)mFrameGPUTimes.size();
+    run["benchmark"] = mBenchmarking;
+    mRunStats.append(run);
+
+    LL_INFOS("AgentPilot") << "Run " << mRunStats.size() << ": " << mFrameTimes.size() << " frames, "
+                           << run["frame_ms_mean"].asReal() << " ms mean, "
+                           << run["frame_ms_p50"].asReal() << " p50, "
+                           << run["frame_ms_p90"].asReal() << " p90, "
+                           << run["frame_ms_p99"].asReal() << " p99" << LL_ENDL;
+
+    writeFrames();
+    mFrameTimes.clear();
+    mFrameTriangles.clear();
+    mFrameGPUTimes.clear();
+    writeReport();
+}
+
+void LLAgentPilot::writeReport()
+{
+    std::string filename = gSavedSettings.getString("StatsPilotReportFile");
+    if (filename.empty())
+    {
+        return;
+    }
+
+    boost::json::value report{ boost::json::object_kind };
+    getProfileStatsContext(report.as_object());
+    report.as_object().emplace("runs", LlsdToJson(mRunStats));
+
+    // rewritten after every run so that a session cut short keeps its
+    // finished runs
+    std::string path = gDirUtilp->getExpandedFilename(LL_PATH_LOGS, filename);
+    llofstream file(path.c_str());
+    if (!file)
+    {
+        LL_WARNS("AgentPilot") << "Couldn't write pilot report " << path << LL_ENDL;
+        return;
+    }
+    file << boost::json::serialize(report);
+}
+
+void LLAgentPilot::writeFrames()
+{
+    std::string filename = gSavedSettings.getString("StatsPilotFrameFile");
+    if (filename.empty())
+    {
+        return;
+    }
+
+    // one row per frame of every run of the session, the first run starts
+    // the file over
+    std::string path = gDirUtilp->getExpandedFilename(LL_PATH_LOGS, filename);
+    bool first_run = mRunStats.size() <= 1;
+    llofstream file(path.c_str(), first_run ? std::ios::out | std::ios::trunc : std::ios::out | std::ios::app);
+    if (!file)
+    {
+        LL_WARNS("AgentPilot") << "Couldn't write pilot frames " << path << LL_ENDL;
+        return;
+    }
+    if (first_run)
+    {
+        file << "run,frame,frame_ms,gpu_ms,ktriangles\n";
+    }
+    S32 run = (S32)mRunStats.size();
+    for (size_t i = 0; i < mFrameTimes.size(); ++i)
+    {
+        file << run << ',' << i << ',' << mFrameTimes[i] << ',' << mFrameGPUTimes[i] << ','
+             << mFrameTriangles[i] << '\n';
+    }
+}
+
 void LLAgentPilot::addWaypoint()
 {
     addAction(STRAIGHT);
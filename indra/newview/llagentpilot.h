@@ -30,6 +30,9 @@
 #include "stdtypes.h"
 #include "lltimer.h"
 #include "v3dmath.h"
+#include "llsd.h"
+
+#include <boost/signals2.hpp>
 
 // Class that drives the agent around according to a "script".
 
@@ -59,8 +62,14 @@ public:
     void startPlayback();
     void stopPlayback();
 
+    // Render in place for seconds once logged in and warmup seconds have
+    // passed, to measure a scene without walking a path
+    void startBenchmark(F32 seconds, F32 warmup);
+    void stopBenchmark();
+
     bool isRecording() { return mRecording; }
     bool isPlaying() { return mPlaying; }
+    bool isBenchmarking() { return mBenchmarking; }
     bool getOverrideCamera() { return mOverrideCamera; }
 
     void updateTarget();
@@ -77,9 +86,26 @@ public:
     void setQuitAfterRuns(bool quit_val) { mQuitAfterRuns = quit_val; }
     void setNumRuns(S32 num_runs) { mNumRuns = num_runs; }
 
-private:
+    // Stats of the runs finished this session, as written to the report
+    const LLSD& getRunStats() const { return mRunStats; }
 
+    // Fired with the run stats when playback or a benchmark is done with
+    // all its runs
+    typedef boost::signals2::signal<void(const LLSD& run_stats)> runs_done_signal_t;
+    boost::signals2::connection setRunsDoneCallback(const runs_done_signal_t::slot_type& cb)
+    {
+        return mRunsDoneSignal.connect(cb);
+    }
 
+private:
+    // Frame statistics of the playback, so that replaying the same path
+    // over the same scene gives comparable numbers between builds
+    void recordFrame();
+    void finishRun();
+    void writeReport();
+    void writeFrames();
+    void updateBenchmark();
+    void runsDone();
 
     bool    mLoop;
     bool    mReplaySession;
@@ -98,6 +124,10 @@ private:
 
     bool    mOverrideCamera;
 
+    bool    mBenchmarking;
+    F32     mBenchmarkSeconds;
+    F32     mBenchmarkWarmup;
+
     class Action
     {
     public:
@@ -115,6 +145,13 @@ private:
     std::vector<Action> mActions;
     LLTimer                 mTimer;
 
+    std::vector<F32>    mFrameTimes;      // ms, for the current run
+    std::vector<F32>    mFrameTriangles;  // thousands, for the current run
+    std::vector<F32>    mFrameGPUTimes;   // ms, running average of the GPU passes
+    LLSD                mRunStats;        // one map per finished run
+
+    runs_done_signal_t  mRunsDoneSignal;
+
 };
 
 extern LLAgentPilot gAgentPilot;
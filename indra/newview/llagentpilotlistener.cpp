@@ -0,0 +1,163 @@
+/**
+ * @file   llagentpilotlistener.cpp
+ * @brief  LEAP API to replay autopilot paths and run benchmarks, to automate
+ *         performance measurements.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llagentpilotlistener.h"
+
+#include <iomanip>
+
+#include "llagentpilot.h"
+#include "lldir.h"
+#include "llfile.h"
+#include "llviewercontrol.h"
+#include "stringize.h"
+
+LLAgentPilotListener::LLAgentPilotListener()
+  : LLEventAPI("LLAgentPilot",
+               "Replay recorded autopilot paths and benchmark the scene, reporting frame stats")
+{
+    add("play",
+        "Replay an autopilot path, and reply when done with all the runs:\n"
+        "[\"file\"]: path of the .xml or .txt path to load, else the last one loaded\n"
+        "[\"runs\"]: number of times to walk the path, default 1\n"
+        "Replies with [\"runs\"], the frame stats of all the runs of the session",
+        &LLAgentPilotListener::play,
+        llsd::map("reply", LLSD()));
+    add("benchmark",
+        "Render the scene in place for a while, and reply when done:\n"
+        "[\"seconds\"]: how long to measure\n"
+        "[\"warmup\"]: seconds to wait after login or a teleport before measuring,\n"
+        "  default StatsBenchmarkWarmup\n"
+        "Replies with [\"run\"], the frame stats of this benchmark, and [\"runs\"], all runs of the session",
+        &LLAgentPilotListener::benchmark,
+        llsd::map("reply", LLSD()));
+    add("stop",
+        "Stop replaying or benchmarking, pending requests get the runs finished so far",
+        &LLAgentPilotListener::stop);
+    add("getStats",
+        "Reply with [\"runs\"], the frame stats of all the runs of the session,\n"
+        "and whether [\"playing\"] or [\"benchmarking\"]",
+        &LLAgentPilotListener::getStats,
+        llsd::map("reply", LLSD()));
+
+    gAgentPilot.setRunsDoneCallback([this](const LLSD& run_stats) { onRunsDone(run_stats); });
+}
+
+void LLAgentPilotListener::play(const LLSD& event_data)
+{
+    if (gAgentPilot.isPlaying() || gAgentPilot.isBenchmarking())
+    {
+        sendReply(llsd::map("error", "Autopilot is already running"), event_data);
+        return;
+    }
+
+    if (event_data.has("file"))
+    {
+        std::string filename = event_data["file"].asString();
+        if (!LLFile::isfile(filename))
+        {
+            sendReply(llsd::map("error", stringize("No autopilot file ", std::quoted(filename))), event_data);
+            return;
+        }
+        if (gDirUtilp->getExtension(filename) == "xml")
+        {
+            gAgentPilot.loadXML(filename);
+        }
+        else
+        {
+            gAgentPilot.loadTxt(filename);
+        }
+    }
+
+    gAgentPilot.setNumRuns(event_data.has("runs") ? llmax(event_data["runs"].asInteger(), 1) : 1);
+    gAgentPilot.setLoop(true);
+    gAgentPilot.startPlayback();
+    if (!gAgentPilot.isPlaying())
+    {
+        sendReply(llsd::map("error", "No autopilot path to replay"), event_data);
+        return;
+    }
+    mPending.push_back(event_data);
+}
+
+void LLAgentPilotListener::benchmark(const LLSD& event_data)
+{
+    if (gAgentPilot.isPlaying() || gAgentPilot.isBenchmarking())
+    {
+        sendReply(llsd::map("error", "Autopilot is already running"), event_data);
+        return;
+    }
+
+    F32 seconds = (F32)event_data["seconds"].asReal();
+    if (seconds <= 0.f)
+    {
+        sendReply(llsd::map("error", "Benchmark needs a positive number of seconds"), event_data);
+        return;
+    }
+    F32 warmup = event_data.has("warmup") ? (F32)event_data["warmup"].asReal()
+                                          : gSavedSettings.getF32("StatsBenchmarkWarmup");
+
+    gAgentPilot.startBenchmark(seconds, warmup);
+    mPending.push_back(event_data);
+}
+
+void LLAgentPilotListener::stop(const LLSD& event_data)
+{
+    gAgentPilot.stopBenchmark();
+    if (gAgentPilot.isPlaying())
+    {
+        gAgentPilot.stopPlayback();
+    }
+    // playback stopped short doesn't signal
+    onRunsDone(gAgentPilot.getRunStats());
+}
+
+void LLAgentPilotListener::getStats(const LLSD& event_data) const
+{
+    LLSD reply;
+    reply["runs"] = gAgentPilot.getRunStats();
+    reply["playing"] = gAgentPilot.isPlaying();
+    reply["benchmarking"] = gAgentPilot.isBenchmarking();
+    sendReply(reply, event_data);
+}
+
+void LLAgentPilotListener::onRunsDone(const LLSD& run_stats)
+{
+    std::vector<LLSD> pending;
+    pending.swap(mPending);
+    for (const LLSD& request : pending)
+    {
+        LLSD reply;
+        reply["runs"] = run_stats;
+        if (request["op"].asString() == "benchmark" && run_stats.size())
+        {
+            reply["run"] = run_stats[run_stats.size() - 1];
+        }
+        sendReply(reply, request);
+    }
+}
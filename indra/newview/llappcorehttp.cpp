@@ -58,58 +58,59 @@ static const struct
     U32                         mMin;
     U32                         mMax;
     U32                         mRate;
+    U32                         mUrgency;
     bool                        mPipelined;
     std::string                 mKey;
     const char *                mUsage;
 } init_data[LLAppCoreHttp::AP_COUNT] =
 {
     { // AP_DEFAULT
-        8,      8,      8,      0,      false,
+        8,      8,      8,      0,      0,      false,
         "",
         "other"
     },
     { // AP_TEXTURE
-        8,      1,      12,     0,      true,
+        8,      1,      12,     0,      2,      true,
         "TextureFetchConcurrency",
         "texture fetch"
     },
     { // AP_MESH1
-        32,     1,      128,    0,      false,
+        32,     1,      128,    0,      3,      false,
         "MeshMaxConcurrentRequests",
         "mesh fetch"
     },
     { // AP_MESH2
-        8,      1,      32,     0,      true,
+        8,      1,      32,     0,      3,      true,
         "Mesh2MaxConcurrentRequests",
         "mesh2 fetch"
     },
     { // AP_LARGE_MESH
-        2,      1,      8,      0,      false,
+        2,      1,      8,      0,      1,      false,
         "",
         "large mesh fetch"
     },
     { // AP_UPLOADS
-        2,      1,      8,      0,      false,
+        2,      1,      8,      0,      0,      false,
         "",
         "asset upload"
     },
     { // AP_LONG_POLL
-        32,     32,     32,     0,      false,
+        32,     32,     32,     0,      0,      false,
         "",
         "long poll"
     },
     { // AP_INVENTORY
-        4,      1,      4,      0,      false,
+        4,      1,      4,      0,      4,      false,
         "",
         "inventory"
     },
     { // AP_MATERIALS
-        2,      1,      8,      0,      false,
+        2,      1,      8,      0,      2,      false,
         "RenderMaterials",
         "material manager requests"
     },
     { // AP_AGENT
-        2,      1,      32,     0,      false,
+        2,      1,      32,     0,      0,      false,
         "Agent",
         "Agent requests"
     }
@@ -229,6 +230,21 @@ void LLAppCoreHttp::init()
                                                             trace_level, NULL);
     }
 
+    // Requests in flight shared by the classes with an urgency (textures,
+    // meshes, inventory...), the most urgent classes get them first
+    static const std::string http_active_limit("HttpActiveLimit");
+    if (gSavedSettings.controlExists(http_active_limit))
+    {
+        status = LLCore::HttpRequest::setStaticPolicyOption(LLCore::HttpRequest::PO_ACTIVE_LIMIT,
+                                                            LLCore::HttpRequest::GLOBAL_POLICY_ID,
+                                                            long(gSavedSettings.getU32(http_active_limit)), NULL);
+        if (! status)
+        {
+            LL_WARNS("Init") << "Failed to set HTTP active limit.  Reason:  " << status.toString()
+                             << LL_ENDL;
+        }
+    }
+
     // Setup default policy and constrain if directed to
     mHttpClasses[AP_DEFAULT].mPolicy = LLCore::HttpRequest::DEFAULT_POLICY_ID;
 
@@ -281,6 +297,13 @@ void LLAppCoreHttp::init()
         LL_INFOS("Init") << "HTTP Pipelining " << (mPipelined ? "enabled" : "disabled") << "!" << LL_ENDL;
     }
 
+    // Binary LLSD replies where the servers offer them
+    static const std::string http_binary_llsd("HttpBinaryLLSD");
+    if (gSavedSettings.controlExists(http_binary_llsd))
+    {
+        LLCoreHttpUtil::HttpCoroutineAdapter::setPreferBinaryLLSD(gSavedSettings.getBOOL(http_binary_llsd));
+    }
+
     // Register signals for settings and state changes
     for (int i(0); i < LL_ARRAY_SIZE(init_data); ++i)
     {
@@ -415,6 +438,21 @@ void LLAppCoreHttp::refreshSettings(bool initial)
                 }
             }
 
+            if (init_data[i].mUrgency)
+            {
+                // Compete for the shared active limit
+                status = LLCore::HttpRequest::setStaticPolicyOption(LLCore::HttpRequest::PO_URGENCY,
+                                                                    mHttpClasses[app_policy].mPolicy,
+                                                                    init_data[i].mUrgency,
+                                                                    NULL);
+                if (! status)
+                {
+                    LL_WARNS("Init") << "Unable to set " << init_data[i].mUsage
+                                     << " urgency.  Reason:  " << status.toString()
+                                     << LL_ENDL;
+                }
+            }
+
         }
 
         // Init- or run-time settings.  Must use the queued request API.
@@ -598,6 +598,7 @@ public:
     {
     }
     /* virtual */ void changed(U32 mask);
+    /* virtual */ U32 getInterestMask() const { return LLInventoryObserver::REBUILD; }
     void postProcess();
 };
 
@@ -2204,6 +2205,11 @@ void LLAppearanceMgr::updateCOF(const LLUUID& category, bool append)
     std::copy(obj_items.begin(), obj_items.end(), std::back_inserter(all_items));
     std::copy(gest_items.begin(), gest_items.end(), std::back_inserter(all_items));
 
+    // Start loading the wearables now rather than once the COF has been
+    // slammed, so that they download while the links are being made.
+    prefetchWearables(body_items, U32_MAX);
+    prefetchWearables(wear_items, U32_MAX);
+
     // Find any wearables that need description set to enforce ordering.
     desc_map_t desc_map;
     getWearableOrderingDescUpdates(wear_items, desc_map);
@@ -2736,6 +2742,56 @@ void LLAppearanceMgr::getUserDescendents(const LLUUID& category,
                                     is_gesture);
 }
 
+U32 LLAppearanceMgr::prefetchWearables(const LLInventoryModel::item_array_t& items, U32 max_count)
+{
+    U32 started = 0;
+    if (!isAgentAvatarValid())
+    {
+        return started;
+    }
+    for (LLViewerInventoryItem* item : items)
+    {
+        if (started >= max_count)
+        {
+            break;
+        }
+        LLViewerInventoryItem* linked_item = item->getIsLinkType() ? item->getLinkedItem() : item;
+        if (linked_item && linked_item->isWearableType()
+            && LLWearableList::instance().prefetchAsset(linked_item->getAssetUUID(),
+                                                        linked_item->getName(),
+                                                        gAgentAvatarp,
+                                                        linked_item->getType()))
+        {
+            ++started;
+        }
+    }
+    return started;
+}
+
+void LLAppearanceMgr::prefetchOutfit(const LLUUID& outfit_id)
+{
+    static LLCachedControl<U32> max_wearables(gSavedSettings, "OutfitPrefetchMaxWearables", 200);
+    if (mPrefetchedWearables >= max_wearables
+        || outfit_id == getCOF()
+        || !gInventory.isCategoryComplete(outfit_id))
+    {
+        // only what is already in the inventory, this isn't worth a fetch
+        return;
+    }
+
+    LLInventoryModel::item_array_t wear_items;
+    LLInventoryModel::item_array_t obj_items;
+    LLInventoryModel::item_array_t gest_items;
+    getUserDescendents(outfit_id, wear_items, obj_items, gest_items);
+    U32 started = prefetchWearables(wear_items, max_wearables - mPrefetchedWearables);
+    if (started)
+    {
+        mPrefetchedWearables += started;
+        LL_DEBUGS("Avatar") << "Prefetching " << started << " wearables of outfit " << outfit_id
+                            << ", " << mPrefetchedWearables << " this session" << LL_ENDL;
+    }
+}
+
 void LLAppearanceMgr::wearInventoryCategory(LLInventoryCategory* category, bool copy, bool append)
 {
     if(!category) return;
@@ -4341,6 +4397,7 @@ LLAppearanceMgr::LLAppearanceMgr():
     mOutfitIsDirty(false),
     mOutfitLocked(false),
     mInFlightTimer(),
+    mPrefetchedWearables(0),
     mIsInUpdateAppearanceFromCOF(false),
     mOutstandingAppearanceBakeRequest(false),
     mRerequestAppearanceBake(false)
@@ -64,6 +64,9 @@ public:
     bool wearOutfitByName(const std::string &name, bool append = false);
     void changeOutfit(bool proceed, const LLUUID& category, bool append);
     void replaceCurrentOutfit(const LLUUID& new_outfit);
+    // Load the wearables of an outfit the user is likely to put on next,
+    // within the session's OutfitPrefetchMaxWearables budget.
+    void prefetchOutfit(const LLUUID& outfit_id);
     void renameOutfit(const LLUUID& outfit_id);
     void removeOutfitPhoto(const LLUUID& outfit_id);
     void takeOffOutfit(const LLUUID& cat_id);
@@ -261,6 +264,10 @@ private:
                                    LLInventoryModel::item_array_t& obj_items,
                                    LLInventoryModel::item_array_t& gest_items);
 
+    // Starts loading the wearables items link to, at most max_count of them.
+    // Returns the number of downloads started.
+    U32 prefetchWearables(const LLInventoryModel::item_array_t& items, U32 max_count);
+
     static void onOutfitRename(const LLSD& notification, const LLSD& response);
 
     // used by both wearOutfit(LLUUID) and wearOutfitByName(std::string)
@@ -279,6 +286,7 @@ private:
      */
     bool mOutfitLocked;
     LLTimer mInFlightTimer;
+    U32 mPrefetchedWearables; // by prefetchOutfit(), this session
     static bool mActive;
 
     attachments_changed_signal_t        mAttachmentsChangeSignal;
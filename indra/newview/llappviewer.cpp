@@ -57,6 +57,7 @@
 #include "llmarketplacenotifications.h"
 #include "llmd5.h"
 #include "llmeshrepository.h"
+#include "llvolumebuilder.h"
 #include "llpumpio.h"
 #include "llmimetypes.h"
 #include "llslurl.h"
@@ -73,6 +74,7 @@
 #endif
 #include "lltexturestats.h"
 #include "lltrace.h"
+#include "lltracecapture.h"
 #include "lltracethreadrecorder.h"
 #include "llviewerwindow.h"
 #include "llviewerdisplay.h"
@@ -113,12 +115,15 @@
 #include "lllocalbitmaps.h"
 #include "llperfstats.h"
 #include "llgltfmateriallist.h"
+#include "llgpupasstimers.h"
+#include "llframespikemonitor.h"
 
 // Linden library includes
 #include "fsyspath.h"
 #include "llavatarnamecache.h"
 #include "lldiriterator.h"
 #include "llexperiencecache.h"
+#include "llheap.h"
 #include "llimagej2c.h"
 #include "llluamanager.h"
 #include "llmemory.h"
@@ -245,6 +250,7 @@
 #include "gltfscenemanager.h"
 
 #include "workqueue.h"
+#include "llparallel.h"
 using namespace LL;
 
 // Include for security api initialization
@@ -333,6 +339,10 @@ F32 gFrameDTClamped = 0.f;                  // Time between adjacent checks to n
 U64MicrosecondsImplicit gStartTime = 0; // gStartTime is "private", used only to calculate gFrameTimeSeconds
 
 LLTimer gRenderStartTime;
+
+// Frame pacing (MainloopFramePacing), measured by doFrame and spent by idleNetwork
+static LLTimer sSinceSwapTimer;         // started when the last frame was presented
+static F32 sDisplayWorkTime = 0.f;      // smoothed CPU time of display() up to the swap
 LLFrameTimer gForegroundTime;
 LLFrameTimer gLoggedInTime;
 LLTimer gLogoutTimer;
@@ -371,8 +381,9 @@ bool gLogoutInProgress = false;
 bool gSimulateMemLeak = false;
 
 // We don't want anyone, especially threads working on the graphics pipeline,
-// to have to block due to this WorkQueue being full.
-WorkQueue gMainloopWork("mainloop", 1024*1024);
+// to have to block due to this WorkQueue being full. Nor contend with each
+// other for its lock: worker threads of every kind post results here.
+WorkQueue gMainloopWork("mainloop", 1024*1024, true);
 
 ////////////////////////////////////////////////////////////
 // Internal globals... that should be removed.
@@ -469,6 +480,23 @@ void idle_afk_check()
     }
 }
 
+void idle_heap_purge()
+{
+    // Once per idle spell: the purge itself costs a few milliseconds, and
+    // nothing is freed while the viewer sits idle.
+    static bool purged = false;
+    static LLCachedControl<F32> purge_seconds(gSavedSettings, "HeapPurgeIdleSeconds");
+    if (purge_seconds <= 0.f || gAwayTriggerTimer.getElapsedTimeF32() < purge_seconds)
+    {
+        purged = false;
+    }
+    else if (!purged)
+    {
+        purged = true;
+        LLHeap::purge();
+    }
+}
+
 // A callback set in LLAppViewer::init()
 static void ui_audio_callback(const LLUUID& uuid)
 {
@@ -543,6 +571,8 @@ static void settings_to_globals()
     LLRender::sNsightDebugSupport = gSavedSettings.getBOOL("RenderNsightDebugSupport");
     LLImageGL::sGlobalUseAnisotropic    = gSavedSettings.getBOOL("RenderAnisotropic");
     LLImageGL::sCompressTextures        = gSavedSettings.getBOOL("RenderCompressTextures");
+    LLImageGL::sTranscodeTextures       = gSavedSettings.getBOOL("RenderTranscodeTextures");
+    LLVertexBuffer::sStreamBuffers      = gSavedSettings.getBOOL("RenderStreamBuffers");
     LLVOVolume::sLODFactor              = llclamp(gSavedSettings.getF32("RenderVolumeLODFactor"), 0.01f, MAX_LOD_FACTOR);
     LLVOVolume::sDistanceFactor         = 1.f-LLVOVolume::sLODFactor * 0.1f;
     LLVolumeImplFlexible::sUpdateFactor = gSavedSettings.getF32("RenderFlexTimeFactor");
@@ -767,6 +797,7 @@ bool LLAppViewer::init()
     //set the max heap size.
     initMaxHeapSize() ;
     LLCoros::instance().setStackSize(gSavedSettings.getS32("CoroutineStackSize"));
+    LLCoros::instance().setStackDebug(gSavedSettings.getBOOL("CoroutineStackDebug"));
     // Use our custom scheduler for coroutine scheduling.
     llcoro::scheduler::use();
 
@@ -782,6 +813,8 @@ bool LLAppViewer::init()
         LLError::setFatalFunction([rc](const std::string&){ _exit(rc); });
     }
 
+    LLError::setAsyncLogging(gSavedSettings.getBOOL("AsyncLogging"));
+
     // Initialize the non-LLCurl libcurl library.  Should be called
     // before consumers (LLTextureFetch).
     mAppCoreHttp.init();
@@ -1473,6 +1506,101 @@ void sendGameControlInput()
     gAgent.sendMessage();
 }
 
+// Keep LLTrace::TraceCapture in step with its settings, and write it out
+// when asked to or when a frame takes too long. Call once a frame.
+static void update_trace_capture()
+{
+    static LLCachedControl<bool> enabled(gSavedSettings, "TraceCaptureEnabled", true);
+    static LLCachedControl<bool> dump_now(gSavedSettings, "TraceCaptureDump", false);
+    static LLCachedControl<F32> seconds(gSavedSettings, "TraceCaptureSeconds", 10.f);
+    static LLCachedControl<F32> spike_ms(gSavedSettings, "TraceCaptureSpikeMs", 0.f);
+    // so that a viewer struggling all session doesn't fill the disk
+    const S32 MAX_SPIKE_DUMPS = 10;
+    static S32 spike_dumps = 0;
+    static LLFrameTimer since_spike_dump;
+
+    LLTrace::TraceCapture::setEnabled(enabled);
+    F64 frame_secs = LLTrace::TraceCapture::endFrame();
+    if (!enabled)
+    {
+        return;
+    }
+
+    std::string reason;
+    if (dump_now)
+    {
+        gSavedSettings.setBOOL("TraceCaptureDump", false);
+        reason = "manual";
+    }
+    else if (spike_ms > 0.f
+             && frame_secs * 1000.0 > spike_ms
+             && LLStartUp::getStartupState() == STATE_STARTED
+             && spike_dumps < MAX_SPIKE_DUMPS
+             && (!spike_dumps || since_spike_dump.getElapsedTimeF32() > seconds))
+    {
+        LL_WARNS("TraceCapture") << "Frame took " << frame_secs * 1000.0 << "ms" << LL_ENDL;
+        ++spike_dumps;
+        since_spike_dump.reset();
+        reason = "spike";
+    }
+    if (!reason.empty())
+    {
+        std::string name(stringize("trace_", reason, '_',
+                                   LLDate::now().toHTTPDateString("%Y%m%d_%H%M%S"), ".json"));
+        LLTrace::TraceCapture::dump(gDirUtilp->getExpandedFilename(LL_PATH_LOGS, name), seconds);
+    }
+}
+
+// Log the settings that the frame loop looks up by name instead of through
+// an LLCachedControl, with ReportSettingsLookups. Call once a frame.
+static void report_settings_lookups()
+{
+    static LLCachedControl<bool> report(gSavedSettings, "ReportSettingsLookups", false);
+    const F32 REPORT_PERIOD = 10.f;
+    const size_t MAX_REPORTED = 20;
+    static LLFrameTimer since_report;
+    static U32 frames = 0;
+
+    bool track = report && LLStartUp::getStartupState() == STATE_STARTED;
+    if (track != gSavedSettings.getTrackLookups())
+    {
+        gSavedSettings.setTrackLookups(track);
+        since_report.reset();
+        frames = 0;
+    }
+    if (!track)
+    {
+        return;
+    }
+
+    ++frames;
+    if (since_report.getElapsedTimeF32() < REPORT_PERIOD)
+    {
+        return;
+    }
+
+    LLControlGroup::lookup_counts_t counts;
+    gSavedSettings.takeLookupCounts(counts);
+    std::vector<std::pair<U32, std::string> > frequent;
+    for (const LLControlGroup::lookup_counts_t::value_type& count : counts)
+    {
+        if (count.second >= frames)
+        {
+            frequent.emplace_back(count.second, count.first);
+        }
+    }
+    std::sort(frequent.rbegin(), frequent.rend());
+
+    LL_INFOS("SettingsLookups") << frequent.size() << " settings looked up once a frame or more over "
+                                << frames << " frames" << LL_ENDL;
+    for (size_t i = 0; i < frequent.size() && i < MAX_REPORTED; ++i)
+    {
+        LL_INFOS("SettingsLookups") << frequent[i].second << ": "
+                                    << llformat("%.1f", (F32)frequent[i].first / frames) << " per frame" << LL_ENDL;
+    }
+    since_report.reset();
+    frames = 0;
+}
 
 bool LLAppViewer::doFrame()
 {
@@ -1490,19 +1618,28 @@ bool LLAppViewer::doFrame()
         LLWorld::createInstance();
     }
 
-    LLEventPump& mainloop(LLEventPumps::instance().obtain("mainloop"));
+    static const LLSymbol sMainloop("mainloop");
+    LLEventPump& mainloop(LLEventPumps::instance().obtain(sMainloop));
     LLSD newFrame;
     {
         LLPerfStats::RecordSceneTime T (LLPerfStats::StatType_t::RENDER_IDLE); // perf stats
         {
             LL_PROFILE_ZONE_NAMED_CATEGORY_APP("df LLTrace");
-            if (LLFloaterReg::instanceVisible("block_timers"))
+            bool timers_visible = LLFloaterReg::instanceVisible("block_timers");
+            if (timers_visible)
             {
                 LLTrace::BlockTimer::processTimes();
             }
+            // Self times and the timer tree only matter to the fast timer
+            // view and the timer logs; otherwise timers just sample the clock.
+            LLTrace::BlockTimer::setFullTiming(timers_visible
+                                               || LLTrace::BlockTimer::sLog
+                                               || LLTrace::BlockTimer::sMetricLog
+                                               || LLFastTimerView::sAnalyzePerformance);
 
             LLTrace::get_frame_recording().nextPeriod();
             LLTrace::BlockTimer::logStats();
+            LLFrameSpikeMonitor::instance().update();
         }
 
         LLTrace::get_thread_recorder()->pullFromChildren();
@@ -1627,13 +1764,24 @@ bool LLAppViewer::doFrame()
                 pingMainloopTimeout("Main:Display");
                 gGLActive = true;
 
+                LLTimer display_timer;
                 display();
 
+                // swap ends the frame, whatever it spent waiting for vsync is slack, not work
+                F32 display_work = llmax(display_timer.getElapsedTimeF32() - gSwapBuffersTime, 0.f);
+                sDisplayWorkTime = lerp(sDisplayWorkTime, display_work, 0.1f);
+                sSinceSwapTimer.reset();
+
                 {
                     LLPerfStats::RecordSceneTime T(LLPerfStats::StatType_t::RENDER_IDLE);
                     LL_PROFILE_ZONE_NAMED_CATEGORY_APP("df Snapshot");
                     pingMainloopTimeout("Main:Snapshot");
-                    gPipeline.mReflectionMapManager.update();
+                    if (!mBackgroundMode)
+                    {
+                        gGPUPassTimers.begin(LLGPUPassTimers::PASS_PROBES);
+                        gPipeline.mReflectionMapManager.update();
+                        gGPUPassTimers.end(LLGPUPassTimers::PASS_PROBES);
+                    }
                     LLFloaterSnapshot::update(); // take snapshots
                     LLFloaterSimpleSnapshot::update();
                     gGLActive = false;
@@ -1776,6 +1924,8 @@ bool LLAppViewer::doFrame()
         LL_INFOS() << "Exiting main_loop" << LL_ENDL;
     }
     }LLPerfStats::StatsRecorder::endFrame();
+    update_trace_capture();
+    report_settings_lookups();
     LL_PROFILER_FRAME_END;
 
     return ! LLApp::isRunning();
@@ -1889,6 +2039,9 @@ bool LLAppViewer::cleanup()
     // shut down mesh streamer
     gMeshRepo.shutdown();
 
+    // stop generating volumes, and let go of the objects waiting on them
+    gVolumeBuilder.shutdown();
+
     // shut down Havok
     LLPhysicsExtensions::quitSystem();
 
@@ -2269,6 +2422,8 @@ bool LLAppViewer::cleanup()
 
     ll_close_fail_log();
 
+    // write out anything still queued before the recorders go away
+    LLError::setAsyncLogging(false);
     LLError::LLCallStacks::cleanup();
     LL::GLTFSceneManager::deleteSingleton();
     LLEnvironment::deleteSingleton();
@@ -2317,7 +2472,8 @@ bool LLAppViewer::initThreads()
 
     LLImage::initClass(gSavedSettings.getBOOL("TextureNewByteRange"),gSavedSettings.getS32("TextureReverseByteRange"));
 
-    LLLFSThread::initClass(enable_threads && true); // TODO: fix crashes associated with this shutdo
+    // reads and writes through io_uring or a completion port where there is one
+    LLLFSThread::initClass(enable_threads && true, gSavedSettings.getU32("LFSAsyncQueueDepth")); // TODO: fix crashes associated with this shutdo
 
     //auto configure thread count
     LLSD threadCounts = gSavedSettings.getLLSD("ThreadPoolSizes");
@@ -2348,6 +2504,12 @@ bool LLAppViewer::initThreads()
     // general task background thread (LLPerfStats, etc)
     LLAppViewer::instance()->initGeneralThread();
 
+    LLTrace::TraceCapture::nameThread("Main");
+
+    // TaskGroup and parallel_for's pool: launch it here on the main thread
+    // rather than on whichever thread happens to want it first
+    LL::getComputeWidth();
+
     LLAppViewer::sPurgeDiskCacheThread = new LLPurgeDiskCacheThread();
 
     if (LLTrace::BlockTimer::sLog || LLTrace::BlockTimer::sMetricLog)
@@ -2360,6 +2522,9 @@ bool LLAppViewer::initThreads()
     // Mesh streaming and caching
     gMeshRepo.init();
 
+    // Prim and sculpt volume generation
+    gVolumeBuilder.init();
+
     LLFilePickerThread::initClass();
     LLDirPickerThread::initClass();
 
@@ -4396,7 +4561,11 @@ bool LLAppViewer::initCache()
     }
 
     const std::string cache_dir = gDirUtilp->getExpandedFilename(LL_PATH_CACHE, cache_dir_name);
-    LLDiskCache::initParamSingleton(cache_dir, disk_cache_size, enable_cache_debug_info);
+    LLDiskCache::initParamSingleton(cache_dir, disk_cache_size, enable_cache_debug_info, read_only);
+    if (!read_only)
+    {
+        LLDiskCache::getInstance()->enableBlobStore(gSavedSettings.getU32("DiskCacheBlobMaxSize"));
+    }
 
     if (!read_only)
     {
@@ -4629,9 +4798,16 @@ void LLAppViewer::loadNameCache()
 {
     // display names cache
     std::string filename =
+        gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "avatar_name_cache.bin");
+    // left by older viewers, read once if there is nothing newer
+    std::string xml_filename =
         gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "avatar_name_cache.xml");
+    if (!LLFile::isfile(filename) && LLFile::isfile(xml_filename))
+    {
+        filename = xml_filename;
+    }
     LL_INFOS("AvNameCache") << filename << LL_ENDL;
-    llifstream name_cache_stream(filename.c_str());
+    llifstream name_cache_stream(filename.c_str(), std::ios::in | std::ios::binary);
     if(name_cache_stream.is_open())
     {
         if ( ! LLAvatarNameCache::getInstance()->importFile(name_cache_stream))
@@ -4641,6 +4817,11 @@ void LLAppViewer::loadNameCache()
             LLFile::remove(filename);
         }
     }
+    if (filename == xml_filename)
+    {
+        name_cache_stream.close();
+        LLFile::remove(xml_filename);
+    }
 
     if (!gCacheName) return;
 
@@ -4657,8 +4838,8 @@ void LLAppViewer::saveNameCache()
 {
     // display names cache
     std::string filename =
-        gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "avatar_name_cache.xml");
-    llofstream name_cache_stream(filename.c_str());
+        gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "avatar_name_cache.bin");
+    llofstream name_cache_stream(filename.c_str(), std::ios::out | std::ios::binary);
     if(name_cache_stream.is_open())
     {
         LLAvatarNameCache::getInstance()->exportFile(name_cache_stream);
@@ -4736,11 +4917,15 @@ void LLAppViewer::idle()
     LLDirPickerThread::clearDead();
     F32 dt_raw = idle_timer.getElapsedTimeAndResetF32();
 
+    updateBackgroundMode();
+
     LLGLTFMaterialList::flushUpdates();
+    gGLTFMaterialList.applyParsedOverrides();
 
     static LLCachedControl<U32> downscale_method(gSavedSettings, "RenderDownScaleMethod");
     gGLManager.mDownScaleMethod = downscale_method;
     LLImageGL::updateClass();
+    LLVertexBuffer::updateClass();
 
     // Service the WorkQueue we use for replies from worker threads.
     // Use function statics for the timeslice setting so we only have to fetch
@@ -4917,6 +5102,7 @@ void LLAppViewer::idle()
 
         // Check for away from keyboard, kick idle agents.
         idle_afk_check();
+        idle_heap_purge();
 
         //  Update statistics for this frame
         update_statistics();
@@ -4995,13 +5181,20 @@ void LLAppViewer::idle()
     {
         LL_RECORD_BLOCK_TIME(FTM_OBJECTLIST_UPDATE);
 
-        if (!(logoutRequestSent() && hasSavedFinalSnapshot()))
+        if (!(logoutRequestSent() && hasSavedFinalSnapshot()) && mBackgroundTick)
         {
             gObjectList.update(gAgent);
             LL::GLTFSceneManager::instance().update();
         }
     }
 
+    if (mBackgroundMode && mBackgroundTick)
+    {
+        // display() doesn't run, keep the texture fetches going from here
+        const F32 BACKGROUND_IMAGE_TIME = 0.005f;
+        gTextureList.updateImages(BACKGROUND_IMAGE_TIME);
+    }
+
     //////////////////////////////////////
     //
     // Deletes objects...
@@ -5035,6 +5228,7 @@ void LLAppViewer::idle()
     {
         LL_RECORD_BLOCK_TIME(FTM_HUD_EFFECTS);
         LLSelectMgr::getInstance()->updateEffects();
+        LLSelectMgr::getInstance()->updatePropertiesRefresh();
         LLHUDManager::getInstance()->cleanupEffects();
         LLHUDManager::getInstance()->sendEffects();
     }
@@ -5093,12 +5287,13 @@ void LLAppViewer::idle()
     // Here, particles are updated and drawables are moved.
     //
 
+    if (mBackgroundTick)
     {
         LL_PROFILE_ZONE_NAMED_CATEGORY_APP("world update"); //LL_RECORD_BLOCK_TIME(FTM_WORLD_UPDATE);
         gPipeline.updateMove();
-    }
 
-    LLWorld::getInstance()->updateParticles();
+        LLWorld::getInstance()->updateParticles();
+    }
 
     if (gAgentPilot.isPlaying() && gAgentPilot.getOverrideCamera())
     {
@@ -5130,6 +5325,7 @@ void LLAppViewer::idle()
     LLMarketplaceInventoryNotifications::update();
 
     // objects and camera should be in sync, do LOD calculations now
+    if (mBackgroundTick)
     {
         LL_RECORD_BLOCK_TIME(FTM_LOD_UPDATE);
         gObjectList.updateApparentAngles(gAgent);
@@ -5162,6 +5358,51 @@ void LLAppViewer::idle()
     }
 }
 
+void LLAppViewer::updateBackgroundMode()
+{
+    // 0: never, 1: when minimized or hidden, 2: also when the window doesn't have focus
+    static LLCachedControl<U32> background_mode(gSavedSettings, "BackgroundMode", 1);
+    static LLCachedControl<F32> background_interval(gSavedSettings, "BackgroundModeInterval", 0.25f);
+
+    bool background = false;
+    if (background_mode > 0
+        && gViewerWindow
+        && !gHeadlessClient
+        && !mQuitRequested
+        && LLStartUp::getStartupState() == STATE_STARTED
+        // keep frame stats meaningful, whatever the window is up to
+        && !gAgentPilot.isPlaying()
+        && !gAgentPilot.isBenchmarking())
+    {
+        LLWindow* window = gViewerWindow->getWindow();
+        background = !window->getVisible()
+            || window->getMinimized()
+            || (background_mode > 1 && !gFocusMgr.getAppHasFocus());
+    }
+
+    if (background != mBackgroundMode)
+    {
+        LL_INFOS() << (background ? "Entering" : "Leaving") << " background mode" << LL_ENDL;
+        mBackgroundMode = background;
+        mBackgroundTickTimer.reset();
+        mBackgroundTick = true;
+        return;
+    }
+
+    mBackgroundTick = !mBackgroundMode || mBackgroundTickTimer.getElapsedTimeF32() >= background_interval;
+    if (mBackgroundMode && mBackgroundTick)
+    {
+        mBackgroundTickTimer.reset();
+
+        // nothing renders until we're back, so scratch targets are cheap to
+        // give back if something else needs the memory
+        if (LLViewerTexture::isSystemMemoryLow() || LLViewerTexture::sFreeVRAMMegabytes <= 0.f)
+        {
+            gRenderTargetPool.releaseIdle();
+        }
+    }
+}
+
 void LLAppViewer::idleShutdown()
 {
     // Wait for all modal alerts to get resolved
@@ -5399,6 +5640,8 @@ void LLAppViewer::idleNameCache()
 #ifdef TIME_THROTTLE_MESSAGES
 #define CHECK_MESSAGES_DEFAULT_MAX_TIME .020f // 50 ms = 50 fps (just for messages!)
 static F32 CheckMessagesMaxTime = CHECK_MESSAGES_DEFAULT_MAX_TIME;
+// with frame pacing on, messages never get less than this fraction of the normal budget
+static const F32 MIN_PACED_MESSAGE_FRACTION = 0.1f;
 #endif
 
 static LLTrace::BlockTimerStatHandle FTM_IDLE_NETWORK("Idle Network");
@@ -5425,6 +5668,20 @@ void LLAppViewer::idleNetwork()
         const S64 frame_count = gFrameCount;  // U32->S64
         F32 total_time = 0.0f;
 
+#ifdef TIME_THROTTLE_MESSAGES
+        F32 max_time = CheckMessagesMaxTime;
+        static LLCachedControl<bool> frame_pacing(gSavedSettings, "MainloopFramePacing", false);
+        if (frame_pacing && gViewerWindow && gViewerWindow->getWindow())
+        {
+            // Only decode in what's left of this frame once display() has had its share,
+            // the rest waits in the socket. Scaling rather than replacing the budget keeps
+            // the catch up below working when the backlog grows.
+            F32 interval = 1.f / (F32)llmax(gViewerWindow->getWindow()->getRefreshRate(), 30);
+            F32 slack = interval - sSinceSwapTimer.getElapsedTimeF32() - sDisplayWorkTime;
+            max_time *= llclamp(slack / CHECK_MESSAGES_DEFAULT_MAX_TIME, MIN_PACED_MESSAGE_FRACTION, 1.f);
+        }
+#endif
+
         {
             LockMessageChecker lmc(gMessageSystem);
             while (lmc.checkAllMessages(frame_count, gServicePump))
@@ -5451,7 +5708,7 @@ void LLAppViewer::idleNetwork()
                 // of network processing time (which needs to be fixed, but this is
                 // a good limit anyway).
                 total_time = check_message_timer.getElapsedTimeF32();
-                if (total_time >= CheckMessagesMaxTime)
+                if (total_time >= max_time)
                     break;
 #endif
             }
@@ -5461,7 +5718,7 @@ void LLAppViewer::idleNetwork()
         }
 
 #ifdef TIME_THROTTLE_MESSAGES
-        if (total_time >= CheckMessagesMaxTime)
+        if (total_time >= max_time)
         {
             // Increase CheckMessagesMaxTime so that we will eventually catch up
             CheckMessagesMaxTime *= 1.035f; // 3.5% ~= x2 in 20 frames, ~8x in 60 frames
@@ -99,6 +99,9 @@ public:
     void abortQuit();  // Called to abort a quit request.
 
     bool quitRequested() { return mQuitRequested; }
+    // Minimized, or unfocused if "BackgroundMode" says so: nothing renders and
+    // the world only ticks every "BackgroundModeInterval", networking stays live
+    bool isInBackgroundMode() const { return mBackgroundMode; }
     bool logoutRequestSent() { return mLogoutRequestSent; }
     bool isSecondInstance() { return mSecondInstance; }
     bool isUpdaterMissing(); // In use by tests
@@ -275,6 +278,7 @@ private:
 
     void idle();
     void idleShutdown();
+    void updateBackgroundMode();
     // update avatar SLID and display name caches
     void idleNameCache();
     void idleNetwork();
@@ -322,6 +326,9 @@ private:
     bool mQuitRequested;                // User wants to quit, may have modified documents open.
     bool mClosingFloaters;
     bool mLogoutRequestSent;            // Disconnect message sent to simulator, no longer safe to send messages to the sim.
+    bool mBackgroundMode = false;
+    bool mBackgroundTick = true;        // whether the world updates this frame, always true in the foreground
+    LLTimer mBackgroundTickTimer;
     struct SettingsFiles* mSettingsLocationList;
 
     LLWatchdogTimeout* mMainloopTimeout;
@@ -34,6 +34,7 @@
 #include "llmeshrepository.h"
 #include "llviewerregion.h"
 #include "llskinningutil.h"
+#include "hbxxh.h"
 
 const F32 LLControlAvatar::MAX_LEGAL_OFFSET = 3.0f;
 const F32 LLControlAvatar::MAX_LEGAL_SIZE = 64.0f;
@@ -41,6 +42,17 @@ const F32 LLControlAvatar::MAX_LEGAL_SIZE = 64.0f;
 //static
 boost::signals2::connection LLControlAvatar::sRegionChangedSlot;
 
+namespace
+{
+    // The control avatars evaluating their motions this frame, by pose key.
+    // Plain pointers, markDead() takes them out.
+    std::unordered_map<U64, LLControlAvatar*> sPoseLeaders;
+    U32 sPoseLeadersFrame = 0;
+
+    // Animation start times are compared at this resolution, in seconds
+    constexpr F64 POSE_TIME_RESOLUTION = 1.0 / 30.0;
+}
+
 LLControlAvatar::LLControlAvatar(const LLUUID& id, const LLPCode pcode, LLViewerRegion* regionp) :
     LLVOAvatar(id, pcode, regionp),
     mPlaying(false),
@@ -49,7 +61,8 @@ LLControlAvatar::LLControlAvatar(const LLUUID& id, const LLPCode pcode, LLViewer
     mRootVolp(NULL),
     mControlAVBridge(NULL),
     mScaleConstraintFixup(1.0),
-    mRegionChanged(false)
+    mRegionChanged(false),
+    mPoseFrame(0)
 {
     mIsDummy = true;
     mIsControlAvatar = true;
@@ -371,6 +384,15 @@ void LLControlAvatar::idleUpdate(LLAgent &agent, const F64 &time)
 
 void LLControlAvatar::markDead()
 {
+    for (auto it = sPoseLeaders.begin(); it != sPoseLeaders.end(); ++it)
+    {
+        if (it->second == this)
+        {
+            sPoseLeaders.erase(it);
+            break;
+        }
+    }
+    mPoseLeader = NULL;
     mRootVolp = NULL;
     super::markDead();
     mControlAVBridge = NULL;
@@ -405,9 +427,140 @@ bool LLControlAvatar::computeNeedsUpdate()
 
 bool LLControlAvatar::updateCharacter(LLAgent &agent)
 {
+    static LLCachedControl<bool> share_pose(gSavedSettings, "AnimatedObjectsSharePose", true);
+
+    mSharesPose = false;
+    mPoseLeader = NULL;
+    U64 key = share_pose ? getPoseKey() : 0;
+    if (key)
+    {
+        U32 frame = LLFrameTimer::getFrameCount();
+        if (frame != sPoseLeadersFrame)
+        {
+            sPoseLeaders.clear();
+            sPoseLeadersFrame = frame;
+        }
+
+        auto inserted = sPoseLeaders.emplace(key, this);
+        if (!inserted.second && inserted.first->second != this)
+        {
+            mPoseLeader = inserted.first->second;
+            mSharesPose = true;
+        }
+    }
+
     return LLVOAvatar::updateCharacter(agent);
 }
 
+U64 LLControlAvatar::getPoseKey()
+{
+    if (!mRootVolp || isDead())
+    {
+        return 0;
+    }
+
+    LLMotionController& controller = getMotionController();
+    if (controller.isPaused() || controller.hasLoadingMotions() || controller.getTimeFactor() <= 0.f)
+    {
+        return 0;
+    }
+
+    LLMotionController::motion_list_t& motions = controller.getActiveMotions();
+    if (motions.empty())
+    {
+        // rest pose, nothing worth sharing
+        return 0;
+    }
+
+    HBXXH64 hash;
+
+    std::vector<LLVOVolume*> volumes;
+    getAnimatedVolumes(volumes);
+    for (LLVOVolume* volp : volumes)
+    {
+        const LLVolume* volume = volp->getVolume();
+        if (volume)
+        {
+            const LLUUID& mesh_id = volume->getParams().getSculptID();
+            hash.update(mesh_id.mData, UUID_BYTES);
+        }
+    }
+
+    F32 scale[] = { mGlobalScale, mScaleConstraintFixup };
+    hash.update(scale, sizeof(scale));
+    hash.update(&mNumBones, sizeof(mNumBones));
+
+    F32 time_factor = controller.getTimeFactor();
+    F32 timing[] = { controller.getTimeStep(), time_factor };
+    hash.update(timing, sizeof(timing));
+    bool flags[] = { controller.getBaseJointsOnly(), controller.getSkipAdditiveMotions() };
+    hash.update(flags, sizeof(flags));
+
+    // Each controller keeps its own animation clock, so compare when the
+    // motions started in frame time instead. Controllers skipping frames
+    // catch up through their timers, getPendingAnimTime() is where they'd
+    // be if they updated now.
+    F64 now = LLFrameTimer::getElapsedSeconds();
+    F32 anim_time = controller.getPendingAnimTime();
+    for (LLMotion* motion : motions)
+    {
+        hash.update(motion->getID().mData, UUID_BYTES);
+
+        S64 started = (S64)ll_round((now - (anim_time - motion->getActivationTime()) / time_factor) / POSE_TIME_RESOLUTION);
+        hash.update(&started, sizeof(started));
+
+        bool stopped = motion->isStopped();
+        hash.update(&stopped, sizeof(stopped));
+        if (stopped)
+        {
+            S64 stopped_at = (S64)ll_round((now - (anim_time - motion->getStopTime()) / time_factor) / POSE_TIME_RESOLUTION);
+            hash.update(&stopped_at, sizeof(stopped_at));
+        }
+    }
+
+    U64 key = hash.digest();
+    return key ? key : 1;
+}
+
+// virtual
+void LLControlAvatar::updateCharacterMotion()
+{
+    if (!mSharesPose || !copyPose())
+    {
+        super::updateCharacterMotion();
+        mPoseFrame = LLFrameTimer::getFrameCount();
+    }
+    mSharesPose = false;
+}
+
+bool LLControlAvatar::copyPose()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
+
+    LLControlAvatar* leader = mPoseLeader.get();
+    mPoseLeader = NULL;
+    if (!leader || leader->isDead() || leader->mPoseFrame != LLFrameTimer::getFrameCount()
+        || leader->mSkeleton.size() != mSkeleton.size())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < mSkeleton.size(); ++i)
+    {
+        LLAvatarJoint* from = leader->mSkeleton[i];
+        LLAvatarJoint* to = mSkeleton[i];
+        if (from && to)
+        {
+            to->setPosition(from->getPosition(), false);
+            to->setRotation(from->getRotation());
+            to->setScale(from->getScale(), false);
+        }
+    }
+    updateJointWorldMatrices();
+
+    return true;
+}
+
 //virtual
 void LLControlAvatar::updateDebugText()
 {
@@ -63,6 +63,12 @@ public:
     virtual bool computeNeedsUpdate();
     virtual bool updateCharacter(LLAgent &agent);
 
+    // Identifies what this avatar's pose depends on this frame: the same meshes
+    // playing the same animations from the same start, at the same scale. Two
+    // control avatars with the same key end up with the same joints, so only
+    // one of them evaluates its motions. 0 when it can't be shared.
+    U64 getPoseKey();
+
     void getAnimatedVolumes(std::vector<LLVOVolume*>& volumes);
     void updateAnimations();
 
@@ -105,6 +111,17 @@ public:
     static void onRegionChanged();
     bool mRegionChanged;
     static boost::signals2::connection sRegionChangedSlot;
+
+protected:
+    virtual void updateCharacterMotion();
+
+private:
+    // copy mPoseLeader's joints, false if it has no pose for this frame
+    bool copyPose();
+
+    LLPointer<LLControlAvatar> mPoseLeader;
+    // frame the motions were last evaluated in
+    U32 mPoseFrame;
 };
 
 typedef std::map<LLUUID, S32> signaled_animation_map_t;
@@ -63,8 +63,8 @@ LL_ALIGN_PREFIX(16)
 class LLDrawable
     : public LLViewerOctreeEntryData
 {
-    LL_ALIGN_NEW;
 public:
+    LL_HEAP_OPERATORS(LLHeap::HEAP_SCENE)
     typedef std::vector<LLFace*> face_list_t;
 
     LLDrawable(const LLDrawable& rhs)
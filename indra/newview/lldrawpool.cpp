@@ -566,6 +566,172 @@ void LLRenderPass::applyModelMatrix(const LLMatrix4* model_matrix)
     }
 }
 
+//static
+void LLRenderPass::drawBatchRange(LLDrawInfo& params, bool back_face_cull)
+{
+    static LLCachedControl<bool> cull_clusters(gSavedSettings, "RenderCullMeshClusters", true);
+    if (params.mClusters.empty() || !cull_clusters)
+    {
+        params.mVertexBuffer->drawRange(LLRender::TRIANGLES, params.mStart, params.mEnd, params.mCount, params.mOffset);
+        return;
+    }
+
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL;
+
+    // Frustum planes in vertex buffer space, from the rows of the
+    // modelview projection (glm matrices are column major)
+    const glm::mat4& modelview = gGL.getModelviewMatrix();
+    const glm::mat4& projection = gGL.getProjectionMatrix();
+    glm::mat4 mvp = projection * modelview;
+
+    LLVector4a planes[6];
+    U32 plane_count = 0;
+    // Shadow maps clamp depth so casters behind the near plane still count,
+    // only their side planes cull
+    const U32 frustum_planes = LLPipeline::sShadowRender ? 4 : 6;
+    for (U32 i = 0; i < frustum_planes; ++i)
+    {
+        U32 row = i / 2;
+        F32 sign = (i & 1) ? -1.f : 1.f;
+        LLVector4a& plane = planes[plane_count++];
+        plane.set(mvp[0][3] + sign * mvp[0][row],
+                  mvp[1][3] + sign * mvp[1][row],
+                  mvp[2][3] + sign * mvp[2][row],
+                  mvp[3][3] + sign * mvp[3][row]);
+        F32 len = plane.getLength3().getF32();
+        if (len > 0.f)
+        {
+            plane.mul(1.f / len);
+        }
+    }
+
+    // Camera position (or direction, for orthographic shadow views) in
+    // vertex buffer space for the normal cones
+    bool cull_cones = back_face_cull && (params.mGLTFMaterial.isNull() || !params.mGLTFMaterial->mDoubleSided);
+    bool ortho = projection[3][3] == 1.f;
+    glm::mat4 inv_modelview = glm::inverse(modelview);
+    glm::vec4 eye = inv_modelview * (ortho ? glm::vec4(0, 0, -1, 0) : glm::vec4(0, 0, 0, 1));
+    LLVector4a eye_vec(eye.x, eye.y, eye.z);
+    if (ortho)
+    {
+        eye_vec.normalize3fast();
+    }
+
+    // Visible clusters, merged when they follow each other in the index buffer
+    static std::vector<U32> counts;
+    static std::vector<U32> offsets;
+    counts.clear();
+    offsets.clear();
+
+    for (const LLDrawInfo::Cluster& cluster : params.mClusters)
+    {
+        F32 radius = cluster.mCenter.getF32ptr()[3];
+
+        bool visible = true;
+        for (U32 i = 0; i < plane_count && visible; ++i)
+        {
+            LLVector4a dist;
+            dist.setAllDot3(planes[i], cluster.mCenter);
+            visible = dist.getF32ptr()[0] + planes[i].getF32ptr()[3] >= -radius;
+        }
+
+        if (visible && cull_cones && cluster.mConeAxis.getF32ptr()[3] <= 1.f)
+        {
+            LLVector4a view_dir;
+            if (ortho)
+            {
+                view_dir = eye_vec;
+            }
+            else
+            {
+                view_dir.setSub(cluster.mConeApex, eye_vec);
+                view_dir.normalize3fast();
+            }
+            LLVector4a dot;
+            dot.setAllDot3(view_dir, cluster.mConeAxis);
+            visible = dot.getF32ptr()[0] < cluster.mConeAxis.getF32ptr()[3];
+        }
+
+        if (!visible)
+        {
+            continue;
+        }
+
+        if (!counts.empty() && offsets.back() + counts.back() == cluster.mOffset)
+        {
+            counts.back() += cluster.mCount;
+        }
+        else
+        {
+            offsets.push_back(cluster.mOffset);
+            counts.push_back(cluster.mCount);
+        }
+    }
+
+    if (counts.size() == 1)
+    {
+        params.mVertexBuffer->drawRange(LLRender::TRIANGLES, params.mStart, params.mEnd, counts[0], offsets[0]);
+    }
+    else if (!counts.empty())
+    {
+        params.mVertexBuffer->multiDraw(LLRender::TRIANGLES, counts.data(), offsets.data(), (U32)counts.size());
+    }
+}
+
+//static
+void LLRenderPass::drawBatchRun(LLDrawInfo& params, LLCullResult::drawinfo_iterator& i, LLCullResult::drawinfo_iterator const& end, bool textured)
+{
+    static LLCachedControl<bool> multi_draw(gSavedSettings, "RenderGLTFMultiDraw", true);
+    if (!multi_draw || !params.mClusters.empty() || params.mTextureMatrix)
+    {
+        drawBatchRange(params);
+        return;
+    }
+
+    static std::vector<U32> counts;
+    static std::vector<U32> offsets;
+    counts.clear();
+    offsets.clear();
+    counts.push_back(params.mCount);
+    offsets.push_back(params.mOffset);
+
+    while (i != end)
+    {
+        const LLDrawInfo& next = **i;
+        if (next.mVertexBuffer != params.mVertexBuffer
+            || next.mModelMatrix != params.mModelMatrix
+            || (textured ? (next.mGLTFMaterial != params.mGLTFMaterial || next.mTexture != params.mTexture || next.mTextureMatrix)
+                         : next.mGLTFMaterial->mDoubleSided != params.mGLTFMaterial->mDoubleSided)
+            || !next.mClusters.empty())
+        {
+            break;
+        }
+
+        if (next.mCount)
+        {
+            if (offsets.back() + counts.back() == next.mOffset)
+            {
+                counts.back() += next.mCount;
+            }
+            else
+            {
+                counts.push_back(next.mCount);
+                offsets.push_back(next.mOffset);
+            }
+        }
+        LLCullResult::increment_iterator(i, end);
+    }
+
+    if (counts.size() == 1)
+    {
+        params.mVertexBuffer->drawRange(LLRender::TRIANGLES, params.mStart, params.mEnd, counts[0], offsets[0]);
+    }
+    else
+    {
+        params.mVertexBuffer->multiDraw(LLRender::TRIANGLES, counts.data(), offsets.data(), (U32)counts.size());
+    }
+}
+
 void LLRenderPass::pushBatch(LLDrawInfo& params, bool texture, bool batch_textures)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL;
@@ -613,7 +779,7 @@ void LLRenderPass::pushBatch(LLDrawInfo& params, bool texture, bool batch_textur
     }
 
     params.mVertexBuffer->setBuffer();
-    params.mVertexBuffer->drawRange(LLRender::TRIANGLES, params.mStart, params.mEnd, params.mCount, params.mOffset);
+    drawBatchRange(params);
 
     if (tex_setup)
     {
@@ -635,7 +801,7 @@ void LLRenderPass::pushUntexturedBatch(LLDrawInfo& params)
     applyModelMatrix(params);
 
     params.mVertexBuffer->setBuffer();
-    params.mVertexBuffer->drawRange(LLRender::TRIANGLES, params.mStart, params.mEnd, params.mCount, params.mOffset);
+    drawBatchRange(params);
 }
 
 // static
@@ -654,21 +820,9 @@ bool LLRenderPass::uploadMatrixPalette(LLVOAvatar* avatar, LLMeshSkinInfo* skinI
     {
         return false;
     }
-    const LLVOAvatar::MatrixPaletteCache& mpc = avatar->updateSkinInfoMatrixPalette(skinInfo);
-    U32 count = static_cast<U32>(mpc.mMatrixPalette.size());
-
-    if (count == 0)
-    {
-        //skin info not loaded yet, don't render
-        return false;
-    }
-
-    LLGLSLShader::sCurBoundShaderPtr->uniformMatrix3x4fv(LLViewerShaderMgr::AVATAR_MATRIX,
-        count,
-        false,
-        (GLfloat*)&(mpc.mGLMp[0]));
 
-    return true;
+    //skin info not loaded yet, don't render
+    return gPipeline.mSkinPalettes.bind(avatar, skinInfo);
 }
 
 // Returns true if rendering should proceed
@@ -690,60 +844,22 @@ bool LLRenderPass::uploadMatrixPalette(LLVOAvatar* avatar, LLMeshSkinInfo* skinI
         return !skipLastSkin;
     }
 
-    const LLVOAvatar::MatrixPaletteCache& mpc = avatar->updateSkinInfoMatrixPalette(skinInfo);
-    U32 count = static_cast<U32>(mpc.mMatrixPalette.size());
     // skipLastSkin -> skin info not loaded yet, don't render
-    skipLastSkin = !bool(count);
+    skipLastSkin = !gPipeline.mSkinPalettes.bind(avatar, skinInfo);
     lastAvatar = avatar;
     lastMeshId = skinInfo->mHash;
 
-    if (!skipLastSkin)
-    {
-        LLGLSLShader::sCurBoundShaderPtr->uniformMatrix3x4fv(LLViewerShaderMgr::AVATAR_MATRIX,
-            count,
-            false,
-            (GLfloat*)&(mpc.mGLMp[0]));
-    }
-
     return !skipLastSkin;
 }
 
 // Returns true if rendering should proceed
+// The palette is a uniform buffer binding rather than program state, so lastAvatarShader is
+// only kept for the callers that track it
 //static
 bool LLRenderPass::uploadMatrixPalette(LLVOAvatar* avatar, LLMeshSkinInfo* skinInfo, const LLVOAvatar*& lastAvatar, U64& lastMeshId, const LLGLSLShader*& lastAvatarShader, bool& skipLastSkin)
 {
-    LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
-
-    llassert(skinInfo);
-    llassert(LLGLSLShader::sCurBoundShaderPtr);
-
-    if (!avatar)
-    {
-        return false;
-    }
-
-    if (avatar == lastAvatar && skinInfo->mHash == lastMeshId && lastAvatarShader == LLGLSLShader::sCurBoundShaderPtr)
-    {
-        return !skipLastSkin;
-    }
-
-    const LLVOAvatar::MatrixPaletteCache& mpc = avatar->updateSkinInfoMatrixPalette(skinInfo);
-    U32 count = static_cast<U32>(mpc.mMatrixPalette.size());
-    // skipLastSkin -> skin info not loaded yet, don't render
-    skipLastSkin = !bool(count);
-    lastAvatar = avatar;
-    lastMeshId = skinInfo->mHash;
     lastAvatarShader = LLGLSLShader::sCurBoundShaderPtr;
-
-    if (!skipLastSkin)
-    {
-        LLGLSLShader::sCurBoundShaderPtr->uniformMatrix3x4fv(LLViewerShaderMgr::AVATAR_MATRIX,
-            count,
-            false,
-            (GLfloat*)&(mpc.mGLMp[0]));
-    }
-
-    return !skipLastSkin;
+    return uploadMatrixPalette(avatar, skinInfo, lastAvatar, lastMeshId, skipLastSkin);
 }
 
 void setup_texture_matrix(LLDrawInfo& params)
@@ -784,13 +900,41 @@ void LLRenderPass::pushGLTFBatches(U32 type)
     LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL;
     auto* begin = gPipeline.beginRenderMap(type);
     auto* end = gPipeline.endRenderMap(type);
+
+    // Neighbouring batches often share a material, only bind it again (a
+    // dozen uniforms and five textures) when it changes
+    const LLFetchedGLTFMaterial* last_mat = nullptr;
+    const LLViewerTexture* last_tex = nullptr;
+
     for (LLCullResult::drawinfo_iterator i = begin; i != end; )
     {
         LL_PROFILE_ZONE_NAMED_CATEGORY_DRAWPOOL("pushGLTFBatch");
         LLDrawInfo& params = **i;
         LLCullResult::increment_iterator(i, end);
 
-        pushGLTFBatch(params);
+        if (!params.mCount)
+        {
+            continue;
+        }
+
+        auto& mat = params.mGLTFMaterial;
+        if (mat.notNull() && (mat.get() != last_mat || params.mTexture.get() != last_tex))
+        {
+            mat->bind(params.mTexture);
+            last_mat = mat.get();
+            last_tex = params.mTexture.get();
+        }
+
+        LLGLDisable cull_face(mat.notNull() && mat->mDoubleSided ? GL_CULL_FACE : 0);
+
+        setup_texture_matrix(params);
+
+        applyModelMatrix(params);
+
+        params.mVertexBuffer->setBuffer();
+        drawBatchRun(params, i, end, true);
+
+        teardown_texture_matrix(params);
     }
 }
 
@@ -805,7 +949,19 @@ void LLRenderPass::pushUntexturedGLTFBatches(U32 type)
         LLDrawInfo& params = **i;
         LLCullResult::increment_iterator(i, end);
 
-        pushUntexturedGLTFBatch(params);
+        if (!params.mCount)
+        {
+            continue;
+        }
+
+        auto& mat = params.mGLTFMaterial;
+
+        LLGLDisable cull_face(mat->mDoubleSided ? GL_CULL_FACE : 0);
+
+        applyModelMatrix(params);
+
+        params.mVertexBuffer->setBuffer();
+        drawBatchRun(params, i, end, false);
     }
 }
 
@@ -826,7 +982,7 @@ void LLRenderPass::pushGLTFBatch(LLDrawInfo& params)
     applyModelMatrix(params);
 
     params.mVertexBuffer->setBuffer();
-    params.mVertexBuffer->drawRange(LLRender::TRIANGLES, params.mStart, params.mEnd, params.mCount, params.mOffset);
+    drawBatchRange(params);
 
     teardown_texture_matrix(params);
 }
@@ -841,7 +997,7 @@ void LLRenderPass::pushUntexturedGLTFBatch(LLDrawInfo& params)
     applyModelMatrix(params);
 
     params.mVertexBuffer->setBuffer();
-    params.mVertexBuffer->drawRange(LLRender::TRIANGLES, params.mStart, params.mEnd, params.mCount, params.mOffset);
+    drawBatchRange(params);
 }
 
 void LLRenderPass::pushRiggedGLTFBatches(U32 type, bool textured)
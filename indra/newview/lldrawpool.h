@@ -352,6 +352,14 @@ public:
     static void applyModelMatrix(const LLDrawInfo& params);
     // For rendering that doesn't use LLDrawInfo for some reason
     static void applyModelMatrix(const LLMatrix4* model_matrix);
+    // Draws the indices of params from its vertex buffer, which must be set
+    // along with the model matrix. Batches split into clusters only draw the
+    // clusters that are in view and, if back_face_cull, face the camera.
+    static void drawBatchRange(LLDrawInfo& params, bool back_face_cull = true);
+    // Like drawBatchRange, but also draws the batches following params that
+    // differ only in their index range, with one glMultiDrawElements, and
+    // moves i past them.
+    static void drawBatchRun(LLDrawInfo& params, LLDrawInfo**& i, LLDrawInfo** const& end, bool textured);
     void pushBatches(U32 type, bool texture = true, bool batch_textures = false);
     void pushUntexturedBatches(U32 type);
 
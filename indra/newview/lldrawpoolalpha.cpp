@@ -194,6 +194,25 @@ void LLDrawPoolAlpha::renderPostDeferred(S32 pass)
 
     prepare_alpha_shader(pbr_shader, true, water_sign);
 
+    mUseOIT = LLPipeline::RenderAlphaOIT &&
+        getType() == LLDrawPool::POOL_ALPHA_POST_WATER &&
+        !LLPipeline::sImpostorRender &&
+        !LLPipeline::sRenderingHUDs &&
+        !gCubeSnapshot &&
+        gPipeline.mOITMap.isComplete() &&
+        gDeferredAlphaOITProgram.isComplete() &&
+        gDeferredPBRAlphaOITProgram.isComplete() &&
+        gDeferredAlphaOITCompositeProgram.isComplete();
+
+    if (mUseOIT)
+    {
+        oit_shader = &gDeferredAlphaOITProgram;
+        prepare_alpha_shader(oit_shader, true, water_sign);
+
+        pbr_oit_shader = &gDeferredPBRAlphaOITProgram;
+        prepare_alpha_shader(pbr_oit_shader, true, water_sign);
+    }
+
     // explicitly unbind here so render loop doesn't make assumptions about the last shader
     // already being setup for rendering
     LLGLSLShader::unbind();
@@ -261,10 +280,19 @@ void LLDrawPoolAlpha::forwardRender(bool rigged)
         LL::GLTFSceneManager::instance().render(false, true, true);
     }
 
+    // the accumulation targets are screen sized and share the scene depth, so only collect when drawing to the screen
+    mCollectOIT = mUseOIT && !rigged && LLRenderTarget::getCurrentBoundTarget() == &gPipeline.mRT->screen;
+
     // If the face is more than 90% transparent, then don't update the Depth buffer for Dof
     // We don't want the nearly invisible objects to cause of DoF effects
     renderAlpha(getVertexDataMask() | LLVertexBuffer::MAP_TEXTURE_INDEX | LLVertexBuffer::MAP_TANGENT | LLVertexBuffer::MAP_TEXCOORD1 | LLVertexBuffer::MAP_TEXCOORD2, false, rigged);
 
+    if (mCollectOIT)
+    {
+        mCollectOIT = false;
+        renderOIT();
+    }
+
     gGL.setColorMask(true, false);
 
     if (!rigged)
@@ -385,6 +413,28 @@ inline bool IsEmissive(LLDrawInfo& params)
     return params.mVertexBuffer->hasDataType(LLVertexBuffer::TYPE_EMISSIVE);
 }
 
+// faces that can be drawn in any order with weighted blended transparency, the rest need sorting
+static bool is_oit_candidate(const LLDrawInfo& params)
+{
+    if (params.mAvatar || params.mVertexBuffer->hasDataType(LLVertexBuffer::TYPE_EMISSIVE))
+    { // rigged alpha keeps attachment order, glow has to be drawn sorted with its alpha
+        return false;
+    }
+
+    if (params.mBlendFuncSrc != LLRender::BF_SOURCE_ALPHA || params.mBlendFuncDst != LLRender::BF_ONE_MINUS_SOURCE_ALPHA)
+    { // custom blend functions don't commute
+        return false;
+    }
+
+    if (params.mGLTFMaterial)
+    {
+        return params.mGLTFMaterial->mAlphaMode == LLGLTFMaterial::ALPHA_MODE_BLEND;
+    }
+
+    // legacy materials and fullbright faces have their own shaders without an OIT variant
+    return !params.mFullbright && params.mMaterial.isNull();
+}
+
 inline void Draw(LLDrawInfo* draw, U32 mask)
 {
     draw->mVertexBuffer->setBuffer();
@@ -561,6 +611,100 @@ void LLDrawPoolAlpha::renderRiggedPbrEmissives(std::vector<LLDrawInfo*>& emissiv
     }
 }
 
+void LLDrawPoolAlpha::renderOIT()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL;
+    LL_PROFILE_GPU_ZONE("alpha oit");
+
+    if (mOITDraws.empty())
+    {
+        return;
+    }
+
+    // draw order doesn't matter to the weighted blend, so batch by material and texture
+    std::sort(mOITDraws.begin(), mOITDraws.end(), [](const OITDraw& lhs, const OITDraw& rhs)
+        {
+            const LLDrawInfo* a = lhs.mDraw;
+            const LLDrawInfo* b = rhs.mDraw;
+            if (a->mGLTFMaterial.get() != b->mGLTFMaterial.get())
+            {
+                return a->mGLTFMaterial.get() < b->mGLTFMaterial.get();
+            }
+            return a->mTexture.get() < b->mTexture.get();
+        });
+
+    LLRenderTarget& oit_map = gPipeline.mOITMap;
+    oit_map.bindTarget();
+
+    glClearColor(0, 0, 0, 1); // revealage starts at 1, weights at 0
+    oit_map.clear(GL_COLOR_BUFFER_BIT);
+    glClearColor(0, 0, 0, 0);
+
+    {
+        LLGLDepthTest depth(GL_TRUE, GL_FALSE);
+
+        // weighted colors and weights add up, revealage multiplies down by (1 - alpha)
+        gGL.blendFunc(LLRender::BF_ONE, LLRender::BF_ONE, LLRender::BF_ZERO, LLRender::BF_ONE_MINUS_SOURCE_ALPHA);
+
+        for (const OITDraw& oit_draw : mOITDraws)
+        {
+            LLDrawInfo* draw = oit_draw.mDraw;
+            LLGLTFMaterial* gltf_mat = draw->mGLTFMaterial;
+
+            LLGLDisable cull_face(oit_draw.mTwoSided || (gltf_mat && gltf_mat->mDoubleSided) ? GL_CULL_FACE : 0);
+
+            LLRenderPass::applyModelMatrix(*draw);
+
+            if (gltf_mat)
+            {
+                // shader must be bound before LLGLTFMaterial::bind
+                if (current_shader != pbr_oit_shader)
+                {
+                    gPipeline.bindDeferredShaderFast(*pbr_oit_shader);
+                }
+
+                draw->mGLTFMaterial->bind(draw->mTexture);
+            }
+            else if (current_shader != oit_shader)
+            {
+                gPipeline.bindDeferredShaderFast(*oit_shader);
+
+                // same constants renderAlpha uses for faces without a material
+                oit_shader->uniform4f(LLShaderMgr::SPECULAR_COLOR, 1.f, 1.f, 1.f, 1.f);
+                oit_shader->uniform1f(LLShaderMgr::ENVIRONMENT_INTENSITY, 0.f);
+                oit_shader->uniform1f(LLShaderMgr::EMISSIVE_BRIGHTNESS, 1.f);
+                oit_shader->bindTexture(LLShaderMgr::BUMP_MAP, LLViewerFetchedTexture::sFlatNormalImagep);
+                oit_shader->bindTexture(LLShaderMgr::SPECULAR_MAP, LLViewerFetchedTexture::sWhiteImagep);
+            }
+
+            bool tex_setup = TexSetup(draw, false);
+            draw->mVertexBuffer->setBuffer();
+            draw->mVertexBuffer->drawRange(LLRender::TRIANGLES, draw->mStart, draw->mEnd, draw->mCount, draw->mOffset);
+            RestoreTexSetup(tex_setup);
+        }
+    }
+
+    oit_map.flush();
+
+    {
+        // lay the resolved layer over the screen like a single alpha blended surface
+        LLGLDepthTest depth(GL_FALSE, GL_FALSE);
+        gGL.blendFunc(mColorSFactor, mColorDFactor, mAlphaSFactor, mAlphaDFactor);
+
+        LLGLSLShader& shader = gDeferredAlphaOITCompositeProgram;
+        shader.bind();
+        shader.bindTexture(LLShaderMgr::DEFERRED_DIFFUSE, &oit_map, false, LLTexUnit::TFO_POINT, 0);
+        shader.bindTexture(LLShaderMgr::DEFERRED_SPECULAR, &oit_map, false, LLTexUnit::TFO_POINT, 1);
+
+        gPipeline.mScreenTriangleVB->setBuffer();
+        gPipeline.mScreenTriangleVB->drawArrays(LLRender::TRIANGLES, 0, 3);
+
+        shader.unbind();
+    }
+
+    mOITDraws.clear();
+}
+
 void LLDrawPoolAlpha::renderAlpha(U32 mask, bool depth_only, bool rigged)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL;
@@ -654,6 +798,12 @@ void LLDrawPoolAlpha::renderAlpha(U32 mask, bool depth_only, bool rigged)
                     continue;
                 }
 
+                if (mCollectOIT && is_oit_candidate(params))
+                {
+                    mOITDraws.push_back({ &params, disable_cull });
+                    continue;
+                }
+
                 LL_PROFILE_ZONE_NAMED_CATEGORY_DRAWPOOL("ra - push batch");
 
                 LLRenderPass::applyModelMatrix(params);
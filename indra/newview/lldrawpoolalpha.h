@@ -65,6 +65,9 @@ public:
 
     void renderGroupAlpha(LLSpatialGroup* group, U32 type, U32 mask, bool texture = true);
     void renderAlpha(U32 mask, bool depth_only = false, bool rigged = false);
+
+    // draw the faces renderAlpha set aside with weighted blended transparency and composite them onto the bound target
+    void renderOIT();
     void renderAlphaHighlight();
 
     static bool sShowDebugAlpha;
@@ -78,6 +81,8 @@ private:
     LLGLSLShader* emissive_shader = nullptr;
     LLGLSLShader* pbr_emissive_shader = nullptr;
     LLGLSLShader* pbr_shader = nullptr;
+    LLGLSLShader* oit_shader = nullptr;
+    LLGLSLShader* pbr_oit_shader = nullptr;
 
     void drawEmissive(LLDrawInfo* draw);
     void renderEmissives(std::vector<LLDrawInfo*>& emissives);
@@ -95,6 +100,19 @@ private:
 
     // if true, we're executing a rigged render pass
     bool mRigged = false;
+
+    // if true, this pass may use weighted blended transparency (LLPipeline::RenderAlphaOIT)
+    bool mUseOIT = false;
+
+    // if true, renderAlpha sets order independent faces aside in mOITDraws instead of drawing them
+    bool mCollectOIT = false;
+
+    struct OITDraw
+    {
+        LLDrawInfo* mDraw;
+        bool        mTwoSided;
+    };
+    std::vector<OITDraw> mOITDraws;
 };
 
 #endif // LL_LLDRAWPOOLALPHA_H
@@ -506,6 +506,7 @@ void LLDrawPoolAvatar::endImpostor()
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
 
+    gGL.flush(); // draws the impostor quads batched by renderImpostor
         gImpostorProgram.unbind();
     gPipeline.enableLightsDynamic();
 }
@@ -563,6 +564,7 @@ void LLDrawPoolAvatar::endDeferredImpostor()
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
 
+    gGL.flush(); // draws the impostor quads batched by renderImpostor
     sShaderLevel = mShaderLevel;
     sVertexProgram->disableTexture(LLViewerShaderMgr::NORMAL_MAP);
     sVertexProgram->disableTexture(LLViewerShaderMgr::SPECULAR_MAP);
@@ -773,15 +775,17 @@ void LLDrawPoolAvatar::renderAvatars(LLVOAvatar* single_avatar, S32 pass)
 //      if (impostor || (LLVOAvatar::AV_DO_NOT_RENDER == avatarp->getVisualMuteSettings() && !avatarp->needsImpostorUpdate()))
         if (impostor || (LLVOAvatar::AOA_NORMAL != avatarp->getOverallAppearance() && !avatarp->needsImpostorUpdate()))
         {
-            if (LLPipeline::sRenderDeferred && !LLPipeline::sReflectionRender && avatarp->mImpostor.isComplete())
+            LLImpostorAtlas& atlas = gPipeline.mImpostorAtlas;
+            if (LLPipeline::sRenderDeferred && !LLPipeline::sReflectionRender && atlas.isValid(avatarp->mImpostorTile))
             {
+                // the same textures for every impostor, rebinding them doesn't break the batch
                 if (normal_channel > -1)
                 {
-                    avatarp->mImpostor.bindTexture(2, normal_channel);
+                    gGL.getTexUnit(normal_channel)->bindManual(LLTexUnit::TT_TEXTURE, atlas.getTarget().getTexture(2));
                 }
                 if (specular_channel > -1)
                 {
-                    avatarp->mImpostor.bindTexture(1, specular_channel);
+                    gGL.getTexUnit(specular_channel)->bindManual(LLTexUnit::TT_TEXTURE, atlas.getTarget().getTexture(1));
                 }
             }
             avatarp->renderImpostor(avatarp->getMutedAVColor(), sDiffuseChannel);
@@ -408,7 +408,7 @@ void LLDrawPoolBump::renderGroup(LLSpatialGroup* group, U32 type, bool texture =
         applyModelMatrix(params);
 
         params.mVertexBuffer->setBuffer();
-        params.mVertexBuffer->drawRange(LLRender::TRIANGLES, params.mStart, params.mEnd, params.mCount, params.mOffset);
+        drawBatchRange(params);
     }
 }
 
@@ -767,7 +767,8 @@ LLViewerTexture* LLBumpImageList::getBrightnessDarknessImage(LLViewerFetchedText
         return nullptr;
     }
 
-    bump_image_map_t::iterator iter = entries_list->find(src_image->getID());
+    BumpKey key = getKey(src_image);
+    bump_image_map_t::iterator iter = entries_list->find(key);
     if (iter != entries_list->end() && iter->second.notNull())
     {
         bump = iter->second;
@@ -780,7 +781,13 @@ LLViewerTexture* LLBumpImageList::getBrightnessDarknessImage(LLViewerFetchedText
         onSourceUpdated(src_image, (EBumpEffect) bump_code);
     }
 
-    return (*entries_list)[src_image->getID()];
+    return (*entries_list)[key];
+}
+
+// static
+LLBumpImageList::BumpKey LLBumpImageList::getKey(LLViewerTexture* src)
+{
+    return BumpKey{ src->getID(), src->getDiscardLevel() };
 }
 
 
@@ -863,15 +870,14 @@ void LLBumpImageList::onSourceUpdated(LLViewerTexture* src, EBumpEffect bump_cod
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL;
 
-    const LLUUID& src_id = src->getID();
+    BumpKey key = getKey(src);
 
     bump_image_map_t& entries_list(bump_code == BE_BRIGHTNESS ? gBumpImageList.mBrightnessEntries : gBumpImageList.mDarknessEntries);
-    bump_image_map_t::iterator iter = entries_list.find(src_id);
+    bump_image_map_t::iterator iter = entries_list.find(key);
 
     if (iter == entries_list.end())
-    { //make sure an entry exists for this image
-        entries_list[src_id] = LLViewerTextureManager::getLocalTexture(true);
-        iter = entries_list.find(src_id);
+    { //make sure an entry exists for this image and discard level
+        iter = entries_list.emplace(key, LLViewerTextureManager::getLocalTexture(true)).first;
     }
 
     //---------------------------------------------------
@@ -1049,7 +1055,7 @@ void LLRenderPass::pushBumpBatch(LLDrawInfo& params, bool texture, bool batch_te
     }
 
     params.mVertexBuffer->setBuffer();
-    params.mVertexBuffer->drawRange(LLRender::TRIANGLES, params.mStart, params.mEnd, params.mCount, params.mOffset);
+    drawBatchRange(params);
 
     if (tex_setup)
     {
@@ -149,7 +149,30 @@ private:
     static void onSourceUpdated( LLViewerTexture *src_vi, EBumpEffect bump );
 
 private:
-    typedef std::unordered_map<LLUUID, LLPointer<LLViewerTexture> > bump_image_map_t;
+    // Normal maps are kept per source texture and discard level, so a source
+    // going back and forth between discard levels finds the map it had for
+    // each of them instead of regenerating it. The ones not bound recently go
+    // in updateImages().
+    struct BumpKey
+    {
+        LLUUID mID;
+        S32 mDiscardLevel;
+
+        bool operator==(const BumpKey& other) const
+        {
+            return mID == other.mID && mDiscardLevel == other.mDiscardLevel;
+        }
+    };
+    struct BumpKeyHash
+    {
+        size_t operator()(const BumpKey& key) const
+        {
+            return (size_t)(key.mID.getDigest64() ^ ((U64)(key.mDiscardLevel + 1) * 0x9e3779b97f4a7c15ULL));
+        }
+    };
+    static BumpKey getKey(LLViewerTexture* src);
+
+    typedef std::unordered_map<BumpKey, LLPointer<LLViewerTexture>, BumpKeyHash> bump_image_map_t;
     bump_image_map_t mBrightnessEntries;
     bump_image_map_t mDarknessEntries;
     static LL::WorkQueue::weak_t sMainQueue;
@@ -277,7 +277,7 @@ void LLDrawPoolMaterials::renderDeferred(S32 pass)
         }*/
 
         params.mVertexBuffer->setBuffer();
-        params.mVertexBuffer->drawRange(LLRender::TRIANGLES, params.mStart, params.mEnd, params.mCount, params.mOffset);
+        drawBatchRange(params);
 
         if (tex_setup)
         {
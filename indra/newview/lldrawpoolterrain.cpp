@@ -37,6 +37,7 @@
 #include "llsky.h"
 #include "llsurface.h"
 #include "llsurfacepatch.h"
+#include "llterraingpu.h"
 #include "llviewerregion.h"
 #include "llvlcomposition.h"
 #include "llviewerparcelmgr.h"      // for gRenderParcelOwnership
@@ -113,10 +114,67 @@ void LLDrawPoolTerrain::prerender()
 
 void LLDrawPoolTerrain::boostTerrainDetailTextures()
 {
-    // Hack! Get the region that this draw pool is rendering from!
-    LLViewerRegion *regionp = mDrawFace[0]->getDrawable()->getVObj()->getRegion();
-    LLVLComposition *compp = regionp->getComposition();
-    compp->boost();
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL;
+
+    static LLCachedControl<bool> stream_by_distance(gSavedSettings, "RenderTerrainStreamByDistance", true);
+    if (!stream_by_distance)
+    {
+        // Hack! Get the region that this draw pool is rendering from!
+        LLViewerRegion *regionp = mDrawFace[0]->getDrawable()->getVObj()->getRegion();
+        LLVLComposition *compp = regionp->getComposition();
+        compp->boost(LLTerrainMaterials::getMaxDecodePriority());
+        return;
+    }
+
+    // The detail textures repeat every few meters, so how sharp they need
+    // to be depends only on how close the camera gets to the nearest patch
+    // of each region, not on how much of the screen the terrain covers.
+    // Fetch them at the resolution that patch needs and let distant
+    // terrain run on the lower discard levels.
+    LLViewerCamera* camera = LLViewerCamera::getInstance();
+    LLVector4a origin;
+    origin.load3(camera->getOrigin().mV);
+
+    std::vector<std::pair<LLViewerRegion*, F32>> nearest;
+    for (LLFace* facep : mDrawFace)
+    {
+        LLViewerRegion* regionp = facep->getDrawable()->getVObj()->getRegion();
+        if (!regionp)
+        {
+            continue;
+        }
+
+        LLVector4a closest;
+        closest.setMax(facep->mExtents[0], origin);
+        closest.setMin(facep->mExtents[1], closest);
+        closest.sub(origin);
+        F32 distance = closest.getLength3().getF32();
+
+        auto it = std::find_if(nearest.begin(), nearest.end(),
+                               [regionp](const std::pair<LLViewerRegion*, F32>& entry) { return entry.first == regionp; });
+        if (it == nearest.end())
+        {
+            nearest.emplace_back(regionp, distance);
+        }
+        else
+        {
+            it->second = llmin(it->second, distance);
+        }
+    }
+
+    // Screen pixels per meter at 1m from the camera
+    const F32 pixels_per_meter = (F32)camera->getViewHeightInPixels() / (2.f * tanf(camera->getView() * 0.5f));
+    for (const auto& entry : nearest)
+    {
+        LLVLComposition* compp = entry.first->getComposition();
+        if (!compp)
+        {
+            continue;
+        }
+        const F32 scale = compp->getMaterialType() == LLTerrainMaterials::Type::PBR ? sPBRDetailScale : sDetailScale;
+        const F32 repeat_pixels = pixels_per_meter / (scale * llmax(entry.second, 1.f));
+        compp->boost(repeat_pixels * repeat_pixels);
+    }
 }
 
 void LLDrawPoolTerrain::beginDeferredPass(S32 pass)
@@ -157,17 +215,18 @@ void LLDrawPoolTerrain::beginShadowPass(S32 pass)
     LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL; //LL_RECORD_BLOCK_TIME(FTM_SHADOW_TERRAIN);
     LLFacePool::beginRenderPass(pass);
     gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
-    gDeferredShadowProgram.bind();
+    sShader = LLTerrainGPU::isEnabled() ? &gDeferredTerrainGPUShadowProgram : &gDeferredShadowProgram;
+    sShader->bind();
 
     LLEnvironment& environment = LLEnvironment::instance();
-    gDeferredShadowProgram.uniform1i(LLShaderMgr::SUN_UP_FACTOR, environment.getIsSunUp() ? 1 : 0);
+    sShader->uniform1i(LLShaderMgr::SUN_UP_FACTOR, environment.getIsSunUp() ? 1 : 0);
 }
 
 void LLDrawPoolTerrain::endShadowPass(S32 pass)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL; //LL_RECORD_BLOCK_TIME(FTM_SHADOW_TERRAIN);
     LLFacePool::endRenderPass(pass);
-    gDeferredShadowProgram.unbind();
+    sShader->unbind();
 }
 
 void LLDrawPoolTerrain::renderShadow(S32 pass)
@@ -177,10 +236,21 @@ void LLDrawPoolTerrain::renderShadow(S32 pass)
     {
         return;
     }
+    const bool gpu = LLTerrainGPU::isEnabled();
+    if (gpu)
+    {
+        gPipeline.mTerrainGPU.bindSurface(*sShader, &mDrawFace[0]->getDrawable()->getRegion()->getLand());
+    }
+
     //LLGLEnable offset(GL_POLYGON_OFFSET);
     //glCullFace(GL_FRONT);
     drawLoop();
     //glCullFace(GL_BACK);
+
+    if (gpu)
+    {
+        gPipeline.mTerrainGPU.unbind(*sShader);
+    }
 }
 
 
@@ -188,6 +258,9 @@ void LLDrawPoolTerrain::drawLoop()
 {
     if (!mDrawFace.empty())
     {
+        // the height map of this pool's region is bound, the patch meshes only tell which patches are visible
+        const bool gpu = LLTerrainGPU::isEnabled();
+
         for (std::vector<LLFace*>::iterator iter = mDrawFace.begin();
              iter != mDrawFace.end(); iter++)
         {
@@ -196,7 +269,18 @@ void LLDrawPoolTerrain::drawLoop()
             llassert(gGL.getMatrixMode() == LLRender::MM_MODELVIEW);
             LLRenderPass::applyModelMatrix(&facep->getDrawable()->getRegion()->mRenderMatrix);
 
-            facep->renderIndexed();
+            if (gpu)
+            {
+                LLSurfacePatch* patchp = ((LLVOSurfacePatch*)facep->getDrawable()->getVObj().get())->getPatch();
+                if (patchp)
+                {
+                    gPipeline.mTerrainGPU.drawPatch(*LLGLSLShader::sCurBoundShaderPtr, patchp);
+                }
+            }
+            else
+            {
+                facep->renderIndexed();
+            }
         }
     }
 }
@@ -208,23 +292,41 @@ void LLDrawPoolTerrain::renderFullShader()
     LLViewerRegion *regionp = mDrawFace[0]->getDrawable()->getVObj()->getRegion();
     LLVLComposition *compp = regionp->getComposition();
     const bool use_textures = !use_local_materials && (compp->getMaterialType() == LLTerrainMaterials::Type::TEXTURE);
+    const bool gpu = LLTerrainGPU::isEnabled();
 
     if (use_textures)
     {
         // Use textures
-        sShader = &gDeferredTerrainProgram;
-        sShader->bind();
-        renderFullShaderTextures();
+        sShader = gpu ? &gDeferredTerrainGPUProgram : &gDeferredTerrainProgram;
     }
     else
     {
         // Use materials
         U32 paint_type = use_local_materials ? gLocalTerrainMaterials.getPaintType() : compp->getPaintType();
         paint_type = llclamp(paint_type, 0, TERRAIN_PAINT_TYPE_COUNT);
-        sShader = &gDeferredPBRTerrainProgram[paint_type];
-        sShader->bind();
+        sShader = gpu ? &gDeferredPBRTerrainGPUProgram[paint_type] : &gDeferredPBRTerrainProgram[paint_type];
+    }
+    sShader->bind();
+
+    if (gpu)
+    {
+        // before the detail textures, the upload goes through texture unit 0
+        gPipeline.mTerrainGPU.bindSurface(*sShader, &regionp->getLand());
+    }
+
+    if (use_textures)
+    {
+        renderFullShaderTextures();
+    }
+    else
+    {
         renderFullShaderPBR(use_local_materials);
     }
+
+    if (gpu)
+    {
+        gPipeline.mTerrainGPU.unbind(*sShader);
+    }
 }
 
 void LLDrawPoolTerrain::renderFullShaderTextures()
@@ -39,10 +39,18 @@
 #include "llviewercontrol.h"
 #include "llviewerregion.h"
 #include "llenvironment.h"
+#include "llappviewer.h"
 
 S32 LLDrawPoolTree::sDiffTex = 0;
 static LLGLSLShader* shader = NULL;
 
+std::vector<U32> LLDrawPoolTree::sInstanceBuffers;
+U32 LLDrawPoolTree::sInstanceBuffersUsed = 0;
+U32 LLDrawPoolTree::sInstanceFrame = 0;
+
+// std140 mat3x4, see LLVOTree::mInstanceTransform
+constexpr U32 INSTANCE_TRANSFORM_SIZE = 12 * sizeof(F32);
+
 LLDrawPoolTree::LLDrawPoolTree(LLViewerTexture *texturep) :
     LLFacePool(POOL_TREE),
     mTexturep(texturep)
@@ -75,23 +83,93 @@ void LLDrawPoolTree::renderDeferred(S32 pass)
     gGL.getTexUnit(sDiffTex)->bindFast(mTexturep);
     mTexturep->addTextureStats(1024.f * 1024.f); // <=== keep Linden tree textures at full res
 
-    for (std::vector<LLFace*>::iterator iter = mDrawFace.begin();
-        iter != mDrawFace.end(); iter++)
+    // Trees of one species at one LOD share their mesh, see LLVOTree::updateMesh().
+    // Sorted by region and mesh, each run is one instanced draw.
+    static std::vector<LLFace*> faces; // main thread only
+    faces.clear();
+    for (LLFace* face : mDrawFace)
     {
-        LLFace* face = *iter;
-        LLVertexBuffer* buff = face->getVertexBuffer();
+        if (face->getVertexBuffer() && face->getViewerObject())
+        {
+            faces.push_back(face);
+        }
+    }
 
-        if (buff)
+    std::sort(faces.begin(), faces.end(), [](LLFace* a, LLFace* b)
+        {
+            LLViewerRegion* region_a = a->getDrawable()->getRegion();
+            LLViewerRegion* region_b = b->getDrawable()->getRegion();
+            if (region_a != region_b)
+            {
+                return region_a < region_b;
+            }
+            return a->getVertexBuffer() < b->getVertexBuffer();
+        });
+
+    static std::vector<F32> transforms;
+    for (size_t first = 0; first < faces.size(); )
+    {
+        LLViewerRegion* region = faces[first]->getDrawable()->getRegion();
+        LLVertexBuffer* buff = faces[first]->getVertexBuffer();
+
+        transforms.clear();
+        size_t last = first;
+        while (last < faces.size() && last - first < MAX_INSTANCES
+            && faces[last]->getVertexBuffer() == buff
+            && faces[last]->getDrawable()->getRegion() == region)
         {
-            LLMatrix4* model_matrix = &(face->getDrawable()->getRegion()->mRenderMatrix);
+            const LLVOTree* tree = (const LLVOTree*)faces[last]->getViewerObject();
+            transforms.insert(transforms.end(), tree->mInstanceTransform, tree->mInstanceTransform + 12);
+            ++last;
+        }
+        U32 count = (U32)(last - first);
 
-            llassert(gGL.getMatrixMode() == LLRender::MM_MODELVIEW);
-            LLRenderPass::applyModelMatrix(model_matrix);
+        llassert(gGL.getMatrixMode() == LLRender::MM_MODELVIEW);
+        LLRenderPass::applyModelMatrix(&region->mRenderMatrix);
 
-            buff->setBuffer();
-            buff->drawRange(LLRender::TRIANGLES, 0, buff->getNumVerts() - 1, buff->getNumIndices(), 0);
-        }
+        bindInstances(transforms.data(), count);
+        buff->setBuffer();
+        buff->drawInstanced(LLRender::TRIANGLES, buff->getNumIndices(), 0, count);
+
+        first = last;
+    }
+}
+
+// static
+void LLDrawPoolTree::bindInstances(const F32* transforms, U32 count)
+{
+    llassert(count <= MAX_INSTANCES);
+
+    if (sInstanceFrame != gFrameCount)
+    {
+        sInstanceFrame = gFrameCount;
+        sInstanceBuffersUsed = 0;
+    }
+
+    if (sInstanceBuffersUsed == sInstanceBuffers.size())
+    {
+        U32 name = 0;
+        glGenBuffers(1, &name);
+        sInstanceBuffers.push_back(name);
+    }
+
+    U32 name = sInstanceBuffers[sInstanceBuffersUsed++];
+    glBindBuffer(GL_UNIFORM_BUFFER, name);
+    // orphan last frame's storage rather than wait for the GPU to finish reading it
+    glBufferData(GL_UNIFORM_BUFFER, MAX_INSTANCES * INSTANCE_TRANSFORM_SIZE, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, count * INSTANCE_TRANSFORM_SIZE, transforms);
+    glBindBufferBase(GL_UNIFORM_BUFFER, LLGLSLShader::UB_TREE_INSTANCES, name);
+}
+
+// static
+void LLDrawPoolTree::releaseInstanceBuffers()
+{
+    if (!sInstanceBuffers.empty())
+    {
+        glDeleteBuffers((GLsizei)sInstanceBuffers.size(), sInstanceBuffers.data());
+        sInstanceBuffers.clear();
     }
+    sInstanceBuffersUsed = 0;
 }
 
 void LLDrawPoolTree::endDeferredPass(S32 pass)
@@ -113,9 +191,9 @@ void LLDrawPoolTree::beginShadowPass(S32 pass)
 
     LLEnvironment& environment = LLEnvironment::instance();
 
-    gDeferredTreeShadowProgram.bind();
-    gDeferredTreeShadowProgram.uniform1i(LLShaderMgr::SUN_UP_FACTOR, environment.getIsSunUp() ? 1 : 0);
-    gDeferredTreeShadowProgram.setMinimumAlpha(0.5f);
+    gDeferredTreeInstancedShadowProgram.bind();
+    gDeferredTreeInstancedShadowProgram.uniform1i(LLShaderMgr::SUN_UP_FACTOR, environment.getIsSunUp() ? 1 : 0);
+    gDeferredTreeInstancedShadowProgram.setMinimumAlpha(0.5f);
 }
 
 void LLDrawPoolTree::renderShadow(S32 pass)
@@ -129,7 +207,7 @@ void LLDrawPoolTree::endShadowPass(S32 pass)
 
     glPolygonOffset(gSavedSettings.getF32("RenderDeferredSpotShadowOffset"),
                         gSavedSettings.getF32("RenderDeferredSpotShadowBias"));
-    gDeferredTreeShadowProgram.unbind();
+    gDeferredTreeInstancedShadowProgram.unbind();
 }
 
 bool LLDrawPoolTree::verify() const
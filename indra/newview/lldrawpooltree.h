@@ -41,6 +41,9 @@ public:
                             LLVertexBuffer::MAP_TEXCOORD0
     };
 
+    // trees per instanced draw, the size of "TreeInstances" in deferred/treeV.glsl
+    static constexpr U32 MAX_INSTANCES = 256;
+
     virtual U32 getVertexDataMask() { return VERTEX_DATA_MASK; }
 
     LLDrawPoolTree(LLViewerTexture *texturep);
@@ -61,6 +64,18 @@ public:
     /*virtual*/ LLColor3 getDebugColor() const; // For AGP debug display
 
     static S32 sDiffTex;
+
+    // release the uniform buffers the instance transforms go through
+    static void releaseInstanceBuffers();
+
+private:
+    // copy count instance transforms to a uniform buffer bound to UB_TREE_INSTANCES
+    static void bindInstances(const F32* transforms, U32 count);
+
+    // one per instanced draw this frame, see bindInstances()
+    static std::vector<U32> sInstanceBuffers;
+    static U32 sInstanceBuffersUsed;
+    static U32 sInstanceFrame;
 };
 
 #endif // LL_LLDRAWPOOLTREE_H
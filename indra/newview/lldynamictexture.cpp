@@ -253,7 +253,36 @@ bool LLViewerDynamicTexture::updateAllInstances()
 
     result = false;
     ret = false;
-    for (S32 order = ORDER_LAST; order < ORDER_COUNT; ++order)
+
+    // Spread the local composites over frames, a wearable change or a slider drag dirties several at once.
+    // The starting composite rotates so a composite that keeps getting dirtied can't starve the others.
+    static LLCachedControl<U32> composite_budget(gSavedSettings, "AvatarCompositeUpdatesPerFrame", 2);
+    static U32 composite_start = 0;
+    const instance_list_t& composites = LLViewerDynamicTexture::sInstances[ORDER_LAST];
+    if (!composites.empty())
+    {
+        std::vector<LLViewerDynamicTexture*> ordered(composites.begin(), composites.end());
+        composite_start %= ordered.size();
+        std::rotate(ordered.begin(), ordered.begin() + composite_start, ordered.end());
+        ++composite_start;
+
+        U32 rendered = 0;
+        for (LLViewerDynamicTexture* dynamicTexture : ordered)
+        {
+            if (composite_budget > 0 && rendered >= composite_budget)
+            {
+                break;
+            }
+            S32 renders = sNumRenders;
+            update_func(dynamicTexture, bake_target, LLAvatarAppearanceDefines::SCRATCH_TEX_WIDTH, LLAvatarAppearanceDefines::SCRATCH_TEX_HEIGHT);
+            if (sNumRenders != renders)
+            {
+                ++rendered;
+            }
+        }
+    }
+
+    for (S32 order = ORDER_LAST + 1; order < ORDER_COUNT; ++order)
     {
         for (LLViewerDynamicTexture* dynamicTexture : LLViewerDynamicTexture::sInstances[order])
         {
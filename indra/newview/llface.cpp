@@ -34,6 +34,7 @@
 #include "llvolume.h"
 #include "m3math.h"
 #include "llmatrix4a.h"
+#include "llvector4abulk.h"
 #include "v3color.h"
 
 #include "lldefs.h"
@@ -54,6 +55,7 @@
 #include "llviewershadermgr.h"
 #include "llviewertexture.h"
 #include "llvoavatar.h"
+#include "llworld.h"
 #include "llsculptidsize.h"
 #include "llmeshrepository.h"
 #include "llskinningutil.h"
@@ -1906,9 +1908,6 @@ bool LLFace::getGeometryVolume(const LLVolume& volume,
 
             //_mm_prefetch((char*)src, _MM_HINT_T0);
 
-            LLVector4a* end = src+num_vertices;
-            //LLVector4a* end_64 = end-4;
-
             llassert(num_vertices > 0);
 
             mVertexBuffer->getVertexStrider(vert, mGeomIndex, mGeomCount);
@@ -1917,16 +1916,6 @@ bool LLFace::getGeometryVolume(const LLVolume& volume,
             F32* dst = (F32*) vert.get();
             F32* end_f32 = dst+mGeomCount*4;
 
-            //_mm_prefetch((char*)dst, _MM_HINT_NTA);
-            //_mm_prefetch((char*)src, _MM_HINT_NTA);
-
-            //_mm_prefetch((char*)dst, _MM_HINT_NTA);
-
-
-            LLVector4a res0; //,res1,res2,res3;
-
-            LLVector4a texIdx;
-
             S32 index = mTextureIndex < FACE_DO_NOT_BATCH_TEXTURES ? mTextureIndex : 0;
 
             F32 val = 0.f;
@@ -1935,22 +1924,12 @@ bool LLFace::getGeometryVolume(const LLVolume& volume,
 
             llassert(index < LLGLSLShader::sIndexedTextureChannels);
 
-            LLVector4Logical mask;
-            mask.clear();
-            mask.setElement<3>();
-
-            texIdx.set(0,0,0,val);
-
-            LLVector4a tmp;
+            // the texture index rides in w
+            LLVector4aBulk::affineTransform(mat_vert, src, (LLVector4a*) dst, num_vertices, val);
+            dst += num_vertices*4;
 
-
-            while (src < end)
-            {
-                mat_vert.affineTransform(*src++, res0);
-                tmp.setSelectWithMask(mask, texIdx, res0);
-                tmp.store4a((F32*) dst);
-                dst += 4;
-            }
+            LLVector4a res0;
+            mat_vert.affineTransform(src[num_vertices-1], res0);
 
             while (dst < end_f32)
             {
@@ -1965,16 +1944,7 @@ bool LLFace::getGeometryVolume(const LLVolume& volume,
 
             mVertexBuffer->getNormalStrider(norm, mGeomIndex, mGeomCount);
             F32* normals = (F32*) norm.get();
-            LLVector4a* src = vf.mNormals;
-            LLVector4a* end = src+num_vertices;
-
-            while (src < end)
-            {
-                LLVector4a normal;
-                mat_normal.rotate(*src++, normal);
-                normal.store4a(normals);
-                normals += 4;
-            }
+            LLVector4aBulk::rotate(mat_normal, vf.mNormals, (LLVector4a*) normals, num_vertices);
         }
 
         if (rebuild_tangent)
@@ -1985,23 +1955,8 @@ bool LLFace::getGeometryVolume(const LLVolume& volume,
 
             mVObjp->getVolume()->genTangents(face_index);
 
-            LLVector4Logical mask;
-            mask.clear();
-            mask.setElement<3>();
-
-            LLVector4a* src = vf.mTangents;
-            LLVector4a* end = vf.mTangents +num_vertices;
-
-            while (src < end)
-            {
-                LLVector4a tangent_out;
-                mat_normal.rotate(*src, tangent_out);
-                tangent_out.setSelectWithMask(mask, *src, tangent_out);
-                tangent_out.store4a(tangents);
-
-                src++;
-                tangents += 4;
-            }
+            // w is the bitangent sign, and stays as it is
+            LLVector4aBulk::rotate(mat_normal, vf.mTangents, (LLVector4a*) tangents, num_vertices, true);
         }
 
         if (rebuild_weights && vf.mWeights)
@@ -2092,6 +2047,36 @@ bool LLFace::getGeometryVolume(const LLVolume& volume,
     return true;
 }
 
+bool LLFace::prepareGeometryOffThread()
+{
+    const LLTextureEntry* tep = getTextureEntry();
+    if (!tep || mVertexBuffer.isNull() || !mDrawablep || mDrawablep->isState(LLDrawable::ANIMATED_CHILD))
+    {
+        return false;
+    }
+
+    // selected faces may create or free mVertexBufferGLTF, which is GL work
+    if (tep->isSelected() || mVertexBufferGLTF.notNull())
+    {
+        return false;
+    }
+
+    LLVolume* volume = mVObjp->getVolume();
+    if (!volume || mTEOffset < 0 || mTEOffset >= volume->getNumVolumeFaces())
+    {
+        return false;
+    }
+
+    // other faces of the volume may be filled at the same time, allocate
+    // the tangents here rather than in getGeometryVolume()
+    if (tep->getBumpmap() || mVertexBuffer->hasDataType(LLVertexBuffer::TYPE_TANGENT))
+    {
+        volume->genTangents(mTEOffset);
+    }
+
+    return true;
+}
+
 void LLFace::renderIndexed()
 {
     if (mVertexBuffer.notNull())
@@ -2119,6 +2104,38 @@ bool LLFace::hasMedia() const
 const F32 LEAST_IMPORTANCE = 0.05f ;
 const F32 LEAST_IMPORTANCE_FOR_LARGE_IMAGE = 0.3f ;
 
+void LLFace::setVirtualSize(F32 size)
+{
+    mVSize = size;
+    notifyPixelAreaChange();
+}
+
+void LLFace::setPixelArea(F32 area)
+{
+    mPixelArea = area;
+    notifyPixelAreaChange();
+}
+
+void LLFace::notifyPixelAreaChange()
+{
+    const F32 old_area = mNotifiedPixelArea;
+    if ((mPixelArea > 0.f) == (old_area > 0.f) &&
+        mPixelArea < old_area * 2.f && mPixelArea * 2.f > old_area)
+    {
+        return;
+    }
+    mNotifiedPixelArea = mPixelArea;
+
+    for (U32 ch = 0; ch < LLRender::NUM_TEXTURE_CHANNELS; ++ch)
+    {
+        LLViewerFetchedTexture* imagep = LLViewerTextureManager::staticCastToFetchedTexture(mTexture[ch].get());
+        if (imagep)
+        {
+            gTextureList.markPriorityDirty(imagep);
+        }
+    }
+}
+
 void LLFace::resetVirtualSize()
 {
     setVirtualSize(0.f);
@@ -2171,6 +2188,11 @@ F32 LLFace::getTextureVirtualSize()
         }
     }
 
+    if (!isState(LLFace::RIGGED))
+    { // hold back detail past the ring that's still loading
+        face_area *= LLWorld::getInstance()->getStreamingTextureScale(dist_vec(getPositionAgent(), LLViewerCamera::getInstance()->getOrigin()));
+    }
+
     setVirtualSize(face_area) ;
 
     return face_area;
@@ -2293,6 +2315,7 @@ bool LLFace::calcPixelArea(F32& cos_angle_to_view_dir, F32& radius)
     F32 app_angle = atanf((F32) sqrt(size_squared) / dist);
     radius = app_angle*LLDrawable::sCurPixelAngle;
     mPixelArea = radius*radius * 3.14159f;
+    notifyPixelAreaChange();
 
     // remember last update time, add 10% noise to avoid all faces updating at the same time
     mLastPixelAreaUpdate = gFrameTimeSeconds + ll_frand() * PIXEL_AREA_UPDATE_PERIOD * 0.1f;
@@ -56,8 +56,8 @@ const U8 FACE_DO_NOT_BATCH_TEXTURES = 255;
 
 class alignas(16) LLFace
 {
-    LL_ALIGN_NEW
 public:
+    LL_HEAP_OPERATORS(LLHeap::HEAP_SCENE)
     LLFace(const LLFace& rhs)
     {
         *this = rhs;
@@ -118,8 +118,8 @@ public:
     void            setState(U32 state)         { mState |= state; }
     void            clearState(U32 state)       { mState &= ~state; }
     bool            isState(U32 state)  const   { return (mState & state) != 0; }
-    void            setVirtualSize(F32 size) { mVSize = size; }
-    void            setPixelArea(F32 area)  { mPixelArea = area; }
+    void            setVirtualSize(F32 size);
+    void            setPixelArea(F32 area);
     F32             getVirtualSize() const { return mVSize; }
     F32             getPixelArea() const { return mPixelArea; }
 
@@ -163,6 +163,10 @@ public:
                             bool force_rebuild = false,
                             bool no_debug_assert = false,
                             bool rebuild_for_gltf = false);
+    // Whether getGeometryVolume() can run on a worker thread for this face:
+    // generates the tangents it would ask the volume for and returns true
+    // when it would then only touch this face and its range of the buffer.
+    bool prepareGeometryOffThread();
 
     // For avatar
     U16          getGeometryAvatar(
@@ -264,6 +268,9 @@ public:
     LLMatrix4*  mSpecMapMatrix;
     LLMatrix4*  mNormalMapMatrix;
     LLDrawInfo* mDrawInfo;
+    // hash of what decided the buffer and batch this face landed in at the last full
+    // rebuild of its group, 0 if it has none (see LLVolumeGeometryManager::rebuildGeom)
+    U64 mLayoutKey = 0;
     LLVOAvatar* mAvatar = nullptr;
     LLMeshSkinInfo* mSkinInfo = nullptr;
 
@@ -317,6 +324,9 @@ private:
     // pixel area face covers on screen
     F32         mPixelArea;
 
+    // mPixelArea when the texture list was last told about it
+    F32         mNotifiedPixelArea = 0.f;
+
     //importance factor, in the range [0, 1.0].
     //1.0: the most important.
     //based on the distance from the face to the view point and the angle from the face center to the view direction.
@@ -328,6 +338,10 @@ private:
     U32 mDrawOrderIndex = 0; // see setDrawOrderIndex
 
 protected:
+    // Marks the face's textures for priority re-evaluation when its pixel
+    // area moved by a factor of two or more since the last notification
+    void notifyPixelAreaChange();
+
     static bool sSafeRenderSelect;
 
 public:
@@ -33,7 +33,7 @@
 #include "llfloaterimnearbychat.h"
 #include "llspinctrl.h"
 #include "lltrans.h"
-#include "llnotificationsutil.h"
+#include "workqueue.h"
 
 const std::string LL_FCP_COMPLETE_NAME("complete_name");
 const std::string LL_FCP_ACCOUNT_NAME("user_name");
@@ -47,10 +47,8 @@ LLFloaterConversationPreview::LLFloaterConversationPreview(const LLSD& session_i
     mPageSize(CONVERSATION_HISTORY_PAGE_SIZE),
     mAccountName(session_id[LL_FCP_ACCOUNT_NAME]),
     mCompleteName(session_id[LL_FCP_COMPLETE_NAME]),
-    mMutex(),
+    mIndexedSize(0),
     mShowHistory(false),
-    mMessages(NULL),
-    mHistoryThreadsBusy(false),
     mIsGroup(false),
     mOpened(false)
 {
@@ -97,32 +95,96 @@ bool LLFloaterConversationPreview::postBuild()
     return LLFloater::postBuild();
 }
 
-void LLFloaterConversationPreview::setPages(std::list<LLSD>* messages, const std::string& file_name)
+// Reads the transcript on the general queue and hands the result to the
+// floater, if it is still around.
+template <typename WORK, typename DONE>
+static void post_history_work(LLHandle<LLFloaterConversationPreview> handle, WORK work, DONE done)
 {
-    if(file_name == mChatHistoryFileName && messages)
-    {
-        // additional protection to avoid changes of mMessages in setPages()
-        LLMutexLock lock(&mMutex);
-        if (mMessages)
+    LL::WorkQueue::ptr_t main_queue = LL::WorkQueue::getInstance("mainloop");
+    LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+    bool posted = main_queue && general_queue && main_queue->postTo(
+        general_queue,
+        work,
+        [handle, done]() // Callback to main thread
+        {
+            if (LLFloaterConversationPreview* floater = handle.get())
+            {
+                done(floater);
+            }
+        });
+    if (!posted)
+    {   // no queues while shutting down
+        work();
+        if (LLFloaterConversationPreview* floater = handle.get())
         {
-            delete mMessages; // Clean up temporary message list with "Loading..." text
+            done(floater);
         }
-        mMessages = messages;
-        mCurrentPage = (mMessages->size() ? (static_cast<int>(mMessages->size()) - 1) / mPageSize : 0);
+    }
+}
+
+LLSD LLFloaterConversationPreview::getLoadParams() const
+{
+    LLSD load_params;
+    load_params["cut_off_todays_date"] = false;
+    load_params["is_group"] = mIsGroup;
+    return load_params;
+}
 
-        mPageSpinner->setEnabled(true);
-        mPageSpinner->setMaxValue((F32)(mCurrentPage+1));
-        mPageSpinner->set((F32)(mCurrentPage+1));
+void LLFloaterConversationPreview::setPages(const LLLogChat::message_offsets_t& offsets, const std::string& log_file_name, S64 indexed_size)
+{
+    mMessageOffsets = offsets;
+    mLogFileName = log_file_name;
+    mIndexedSize = indexed_size;
 
-        std::string total_page_num = llformat("/ %d", mCurrentPage+1);
-        getChild<LLTextBox>("page_num_label")->setValue(total_page_num);
-        mShowHistory = true;
-    }
-    LLLoadHistoryThread* loadThread = LLLogChat::getInstance()->getLoadHistoryThread(mSessionID);
-    if (loadThread)
+    S32 last_page = (mMessageOffsets.size() ? (static_cast<int>(mMessageOffsets.size()) - 1) / mPageSize : 0);
+
+    mPageSpinner->setEnabled(true);
+    mPageSpinner->setMaxValue((F32)(last_page+1));
+    mPageSpinner->set((F32)(last_page+1));
+
+    std::string total_page_num = llformat("/ %d", last_page+1);
+    getChild<LLTextBox>("page_num_label")->setValue(total_page_num);
+
+    loadPage(last_page);
+}
+
+void LLFloaterConversationPreview::loadPage(S32 page)
+{
+    mCurrentPage = page;
+
+    size_t first = (size_t)page * mPageSize;
+    if (first >= mMessageOffsets.size())
     {
-        loadThread->removeLoadEndSignal(boost::bind(&LLFloaterConversationPreview::setPages, this, _1, _2));
+        std::list<LLSD> messages;
+        setPage(page, messages);
+        return;
+    }
+    size_t last = first + mPageSize;
+    S64 begin = mMessageOffsets[first];
+    S64 end = last < mMessageOffsets.size() ? mMessageOffsets[last] : mIndexedSize;
+
+    auto messages = std::make_shared<std::list<LLSD>>();
+    std::string log_file_name = mLogFileName;
+    LLSD load_params = getLoadParams();
+    post_history_work(getDerivedHandle<LLFloaterConversationPreview>(),
+        [messages, log_file_name, begin, end, load_params]() // Work done on general queue
+        {
+            LLLogChat::loadChatHistoryRange(log_file_name, begin, end, *messages, load_params);
+        },
+        [messages, page](LLFloaterConversationPreview* floater)
+        {
+            floater->setPage(page, *messages);
+        });
+}
+
+void LLFloaterConversationPreview::setPage(S32 page, std::list<LLSD>& messages)
+{
+    if (page != mCurrentPage)
+    {   // another page was asked for meanwhile
+        return;
     }
+    mMessages.swap(messages);
+    mShowHistory = true;
 }
 
 void LLFloaterConversationPreview::draw()
@@ -142,82 +204,51 @@ void LLFloaterConversationPreview::onOpen(const LLSD& key)
         return;
     }
     mOpened = true;
-    if (!LLLogChat::getInstance()->historyThreadsFinished(mSessionID))
-    {
-        LLNotificationsUtil::add("ChatHistoryIsBusyAlert");
-        mHistoryThreadsBusy = true;
-        closeFloater();
-        return;
-    }
-    LLSD load_params;
-    load_params["load_all_history"] = true;
-    load_params["cut_off_todays_date"] = false;
-    load_params["is_group"] = mIsGroup;
-
-    // The temporary message list with "Loading..." text
-    // Will be deleted upon loading completion in setPages() method
-    mMessages = new std::list<LLSD>();
-
 
+    // "Loading..." until the last page of the transcript has been read
+    mMessages.clear();
     LLSD loading;
     loading[LL_IM_TEXT] = LLTrans::getString("loading_chat_logs");
-    mMessages->push_back(loading);
+    mMessages.push_back(loading);
     mPageSpinner = getChild<LLSpinCtrl>("history_page_spin");
     mPageSpinner->setCommitCallback(boost::bind(&LLFloaterConversationPreview::onMoreHistoryBtnClick, this));
     mPageSpinner->setMinValue(1);
     mPageSpinner->set(1);
     mPageSpinner->setEnabled(false);
-
-    // The actual message list to load from file
-    // Will be deleted in a separate thread LLDeleteHistoryThread not to freeze UI
-    // LLDeleteHistoryThread is started in destructor
-    std::list<LLSD>* messages = new std::list<LLSD>();
-
-    LLLogChat *log_chat_inst = LLLogChat::getInstance();
-    log_chat_inst->cleanupHistoryThreads();
-
-    LLLoadHistoryThread* loadThread = new LLLoadHistoryThread(mChatHistoryFileName, messages, load_params);
-    loadThread->setLoadEndSignal(boost::bind(&LLFloaterConversationPreview::setPages, this, _1, _2));
-    loadThread->start();
-    log_chat_inst->addLoadHistoryThread(mSessionID, loadThread);
-
-    LLDeleteHistoryThread* deleteThread = new LLDeleteHistoryThread(messages, loadThread);
-    log_chat_inst->addDeleteHistoryThread(mSessionID, deleteThread);
-
     mShowHistory = true;
+
+    // Only index the transcript here, pages are read as they are shown
+    struct Index
+    {
+        LLLogChat::message_offsets_t mOffsets;
+        std::string mLogFileName;
+        S64 mIndexedSize = 0;
+    };
+    auto index = std::make_shared<Index>();
+    std::string file_name = mChatHistoryFileName;
+    bool is_group = mIsGroup;
+    post_history_work(getDerivedHandle<LLFloaterConversationPreview>(),
+        [index, file_name, is_group]() // Work done on general queue
+        {
+            index->mIndexedSize = LLLogChat::indexChatHistory(file_name, index->mOffsets, index->mLogFileName, is_group);
+        },
+        [index](LLFloaterConversationPreview* floater)
+        {
+            floater->setPages(index->mOffsets, index->mLogFileName, index->mIndexedSize);
+        });
 }
 
 void LLFloaterConversationPreview::onClose(bool app_quitting)
 {
     mOpened = false;
-    if (!mHistoryThreadsBusy)
-    {
-        LLDeleteHistoryThread* deleteThread = LLLogChat::getInstance()->getDeleteHistoryThread(mSessionID);
-        if (deleteThread)
-        {
-            deleteThread->start();
-        }
-    }
 }
 
 void LLFloaterConversationPreview::showHistory()
 {
-    // additional protection to avoid changes of mMessages in setPages
-    LLMutexLock lock(&mMutex);
-    if(mMessages == NULL || !mMessages->size() || mCurrentPage * mPageSize >= mMessages->size())
-    {
-        return;
-    }
-
     mChatHistory->clear();
-    std::ostringstream message;
-    std::list<LLSD>::const_iterator iter = mMessages->begin();
-    std::advance(iter, mCurrentPage * mPageSize);
 
-    for (int msg_num = 0; iter != mMessages->end() && msg_num < mPageSize; ++iter, ++msg_num)
+    for (const LLSD& msg : mMessages)
     {
-        LLSD msg = *iter;
-
         LLUUID from_id      = LLUUID::null;
         std::string time    = msg["time"].asString();
         std::string from    = msg["from"].asString();
@@ -263,12 +294,11 @@ void LLFloaterConversationPreview::showHistory()
 
 void LLFloaterConversationPreview::onMoreHistoryBtnClick()
 {
-    mCurrentPage = (int)(mPageSpinner->getValueF32());
-    if (!mCurrentPage)
+    S32 page = (int)(mPageSpinner->getValueF32());
+    if (!page)
     {
         return;
     }
 
-    mCurrentPage--;
-    mShowHistory = true;
+    loadPage(page - 1);
 }
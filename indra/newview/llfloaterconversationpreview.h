@@ -28,6 +28,7 @@
 
 #include "llchathistory.h"
 #include "llfloater.h"
+#include "lllogchat.h"
 
 extern const std::string LL_FCP_COMPLETE_NAME;  //"complete_name"
 extern const std::string LL_FCP_ACCOUNT_NAME;       //"user_name"
@@ -42,7 +43,6 @@ public:
     virtual ~LLFloaterConversationPreview();
 
     bool postBuild() override;
-    void setPages(std::list<LLSD>* messages,const std::string& file_name);
 
     void draw() override;
     void onOpen(const LLSD& key) override;
@@ -51,20 +51,28 @@ public:
 private:
     void onMoreHistoryBtnClick();
     void showHistory();
+    void setPages(const LLLogChat::message_offsets_t& offsets, const std::string& log_file_name, S64 indexed_size);
+    void loadPage(S32 page);
+    void setPage(S32 page, std::list<LLSD>& messages);
+    LLSD getLoadParams() const;
 
-    LLMutex         mMutex;
     LLSpinCtrl*     mPageSpinner;
     LLChatHistory*  mChatHistory;
     LLUUID          mSessionID;
     int             mCurrentPage;
     int             mPageSize;
 
-    std::list<LLSD>*    mMessages;
+    // Only the messages of the page on display are read from the transcript,
+    // the index says where each of them starts.
+    std::list<LLSD> mMessages;
+    LLLogChat::message_offsets_t mMessageOffsets;
+    std::string     mLogFileName;
+    S64             mIndexedSize;
+
     std::string     mAccountName;
     std::string     mCompleteName;
     std::string     mChatHistoryFileName;
     bool            mShowHistory;
-    bool            mHistoryThreadsBusy;
     bool            mOpened;
     bool            mIsGroup;
 };
@@ -0,0 +1,116 @@
+/**
+ * @file llfloaterframespikes.cpp
+ * @brief Floater ranking the recurring causes of frame time spikes
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llfloaterframespikes.h"
+
+#include "llframespikemonitor.h"
+#include "llscrolllistctrl.h"
+
+// recent spikes shown, newest first
+static const size_t MAX_LISTED_SPIKES = 50;
+
+LLFloaterFrameSpikes::LLFloaterFrameSpikes(const LLSD& key) :
+    LLFloater(key)
+{
+}
+
+bool LLFloaterFrameSpikes::postBuild()
+{
+    mCausesList = getChild<LLScrollListCtrl>("causes_list");
+    mSpikesList = getChild<LLScrollListCtrl>("spikes_list");
+    childSetAction("clear_btn", [this](void*) { onClickClear(); }, this);
+
+    refresh();
+    return true;
+}
+
+void LLFloaterFrameSpikes::draw()
+{
+    if (mChangeCount != LLFrameSpikeMonitor::instance().getChangeCount())
+    {
+        refresh();
+    }
+    LLFloater::draw();
+}
+
+void LLFloaterFrameSpikes::refresh()
+{
+    const LLFrameSpikeMonitor& monitor = LLFrameSpikeMonitor::instance();
+    mChangeCount = monitor.getChangeCount();
+
+    // ranked by the total time they cost
+    std::vector<std::pair<std::string, LLFrameSpikeMonitor::Cause> > causes(monitor.getCauses().begin(), monitor.getCauses().end());
+    std::sort(causes.begin(), causes.end(), [](const auto& a, const auto& b)
+        {
+            return a.second.mTotalMs > b.second.mTotalMs;
+        });
+
+    S32 causes_pos = mCausesList->getScrollPos();
+    mCausesList->clearRows();
+    for (const auto& entry : causes)
+    {
+        const LLFrameSpikeMonitor::Cause& cause = entry.second;
+        LLSD item;
+        LLSD& row = item["columns"];
+        row[0]["column"] = "cause";
+        row[0]["value"] = entry.first;
+        row[1]["column"] = "count";
+        row[1]["value"] = (LLSD::Integer)cause.mCount;
+        row[2]["column"] = "total";
+        row[2]["value"] = llformat("%.0f", cause.mTotalMs);
+        row[3]["column"] = "worst";
+        row[3]["value"] = llformat("%.0f", cause.mWorstMs);
+        mCausesList->addElement(item);
+    }
+    mCausesList->setScrollPos(causes_pos);
+
+    mSpikesList->clearRows();
+    const LLFrameSpikeMonitor::spike_list_t& spikes = monitor.getSpikes();
+    size_t listed = 0;
+    for (auto it = spikes.rbegin(); it != spikes.rend() && listed < MAX_LISTED_SPIKES; ++it, ++listed)
+    {
+        LLSD item;
+        LLSD& row = item["columns"];
+        row[0]["column"] = "frame";
+        row[0]["value"] = (LLSD::Integer)it->mFrame;
+        row[1]["column"] = "ms";
+        row[1]["value"] = llformat("%.0f", it->mFrameMs);
+        row[2]["column"] = "cause";
+        row[2]["value"] = it->mCause;
+        for (S32 i = 0; i < 3; ++i)
+        {
+            row[i]["tool_tip"] = it->mDetails;
+        }
+        mSpikesList->addElement(item);
+    }
+}
+
+void LLFloaterFrameSpikes::onClickClear()
+{
+    LLFrameSpikeMonitor::instance().clear();
+}
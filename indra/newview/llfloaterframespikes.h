@@ -0,0 +1,53 @@
+/**
+ * @file llfloaterframespikes.h
+ * @brief Floater ranking the recurring causes of frame time spikes
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLFLOATERFRAMESPIKES_H
+#define LL_LLFLOATERFRAMESPIKES_H
+
+#include "llfloater.h"
+
+class LLScrollListCtrl;
+
+// Recurring causes of frame time spikes, ranked by the total time they
+// cost, and the most recent spikes. See LLFrameSpikeMonitor.
+class LLFloaterFrameSpikes : public LLFloater
+{
+public:
+    LLFloaterFrameSpikes(const LLSD& key);
+
+    bool postBuild() override;
+    void draw() override;
+
+private:
+    void refresh() override;
+    void onClickClear();
+
+    LLScrollListCtrl* mCausesList = nullptr;
+    LLScrollListCtrl* mSpikesList = nullptr;
+    U32 mChangeCount = 0;
+};
+
+#endif // LL_LLFLOATERFRAMESPIKES_H
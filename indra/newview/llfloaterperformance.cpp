@@ -36,6 +36,8 @@
 #include "llfeaturemanager.h"
 #include "llfloaterpreference.h" // LLAvatarComplexityControls
 #include "llfloaterreg.h"
+#include "llgpupasstimers.h"
+#include "llmemoryfootprint.h"
 #include "llnamelistctrl.h"
 #include "llnotificationsutil.h"
 #include "llperfstats.h"
@@ -402,10 +404,14 @@ void LLFloaterPerformance::populateObjectList()
                     row[1]["value"] = llformat("%.f", gpu_time * 1000.f);
                     row[1]["font"]["name"] = "SANSSERIF";
 
-                    row[2]["column"] = "name";
-                    row[2]["type"] = "text";
-                    row[2]["value"] = attached_object->getAttachmentItemName();
-                    row[2]["font"]["name"] = "SANSSERIF";
+                    LLMemoryFootprint footprint;
+                    footprint.addObject(attached_object);
+                    setMemoryColumn(row[2], footprint);
+
+                    row[3]["column"] = "name";
+                    row[3]["type"] = "text";
+                    row[3]["value"] = attached_object->getAttachmentItemName();
+                    row[3]["font"]["name"] = "SANSSERIF";
 
                     LLScrollListItem* obj = mObjectList->addElement(item);
                     if (obj)
@@ -464,6 +470,10 @@ void LLFloaterPerformance::populateNearbyList()
             row[1]["value"] = llformat( "%.f", render_av_gpu_ms * 1000.f);
             row[1]["font"]["name"] = "SANSSERIF";
 
+            LLMemoryFootprint footprint;
+            footprint.addAvatar(avatar);
+            setMemoryColumn(row[2], footprint);
+
             row[3]["column"] = "name";
             row[3]["type"] = "text";
             row[3]["value"] = avatar->getFullname();
@@ -477,7 +487,7 @@ void LLFloaterPerformance::populateNearbyList()
                 {
                     value_text->setAlignment(LLFontGL::HCENTER);
                 }
-                LLScrollListText* name_text = dynamic_cast<LLScrollListText*>(av_item->getColumn(2));
+                LLScrollListText* name_text = dynamic_cast<LLScrollListText*>(av_item->getColumn(3));
                 if (name_text)
                 {
                     if (avatar->isSelf())
@@ -511,6 +521,17 @@ void LLFloaterPerformance::populateNearbyList()
     mNearbyList->selectByID(prev_selected_id);
 }
 
+void LLFloaterPerformance::setMemoryColumn(LLSD& column, const LLMemoryFootprint& footprint)
+{
+    const F64 MB = 1024.0 * 1024.0;
+    column["column"] = "memory";
+    column["type"] = "text";
+    column["value"] = llformat("%.1f MB", footprint.getTotal() / MB);
+    column["tool_tip"] = llformat("VRAM %.1f MB, RAM %.1f MB\n", footprint.getVRAM() / MB, footprint.getRAM() / MB)
+        + footprint.asString();
+    column["font"]["name"] = "SANSSERIF";
+}
+
 void LLFloaterPerformance::setFPSText()
 {
     const S32 NUM_PERIODS = 50;
@@ -524,6 +545,22 @@ void LLFloaterPerformance::setFPSText()
     {
         fps_text += getString("max_text");
     }
+
+    F32 gpu_ms = gGPUPassTimers.getFrameTime();
+    if (gpu_ms > 0.f)
+    {
+        LLStringUtil::format_map_t args;
+        args["[TIME]"] = llformat("%.1f", gpu_ms);
+        fps_text += getString("gpu_text", args);
+
+        args["[PROBES]"] = llformat("%.1f", gGPUPassTimers.getTime(LLGPUPassTimers::PASS_PROBES));
+        args["[SHADOWS]"] = llformat("%.1f", gGPUPassTimers.getTime(LLGPUPassTimers::PASS_SHADOWS));
+        args["[GEOMETRY]"] = llformat("%.1f", gGPUPassTimers.getTime(LLGPUPassTimers::PASS_GEOMETRY));
+        args["[LIGHTING]"] = llformat("%.1f", gGPUPassTimers.getTime(LLGPUPassTimers::PASS_LIGHTING));
+        args["[ALPHA]"] = llformat("%.1f", gGPUPassTimers.getTime(LLGPUPassTimers::PASS_ALPHA));
+        args["[POST]"] = llformat("%.1f", gGPUPassTimers.getTime(LLGPUPassTimers::PASS_POST));
+        mTextFPSLabel->setToolTip(getString("gpu_tooltip", args));
+    }
     mTextFPSLabel->setValue(fps_text);
 }
 
@@ -31,6 +31,7 @@
 
 class LLCharacter;
 class LLCheckBoxCtrl;
+class LLMemoryFootprint;
 class LLNameListCtrl;
 class LLTextBox;
 
@@ -60,6 +61,7 @@ private:
     void populateHUDList();
     void populateObjectList();
     void populateNearbyList();
+    static void setMemoryColumn(LLSD& column, const LLMemoryFootprint& footprint);
     void setFPSText();
 
     void onClickAdvanced();
@@ -0,0 +1,184 @@
+/**
+ * @file llframespikemonitor.cpp
+ * @brief Detects frame time spikes and attributes them to a fast timer
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llframespikemonitor.h"
+
+#include "llappviewer.h"
+#include "llmeshrepository.h"
+#include "llstartup.h"
+#include "lltexturefetch.h"
+#include "llviewercontrol.h"
+#include "llviewerstats.h"
+#include "workqueue.h"
+
+// spikes kept for the floater, oldest dropped first
+static const size_t MAX_SPIKES = 256;
+// frames of averages to gather before blaming anything
+static const U32 WARMUP_FRAMES = 100;
+
+LLFrameSpikeMonitor::LLFrameSpikeMonitor() :
+    mFrames(0),
+    mChangeCount(0)
+{
+}
+
+void LLFrameSpikeMonitor::update()
+{
+    LL_PROFILE_ZONE_SCOPED;
+
+    static LLCachedControl<F32> threshold_ms(gSavedSettings, "FrameSpikeThreshold", 100.f);
+    if (threshold_ms <= 0.f || LLStartUp::getStartupState() < STATE_STARTED)
+    {
+        return;
+    }
+
+    LLTrace::Recording& last_frame = LLTrace::get_frame_recording().getLastRecording();
+    F32 frame_ms = (F32)F64Milliseconds(last_frame.getDuration()).value();
+
+    if (mFrames >= WARMUP_FRAMES && frame_ms > threshold_ms)
+    {
+        addSpike(frame_ms);
+        // keep the spike out of the averages it is measured against
+        return;
+    }
+
+    ++mFrames;
+    for (auto& base : LLTrace::BlockTimerStatHandle::instance_snapshot())
+    {
+        LLTrace::BlockTimerStatHandle& timer = static_cast<LLTrace::BlockTimerStatHandle&>(base);
+        size_t index = timer.getIndex();
+        if (index >= mAverageMs.size())
+        {
+            mAverageMs.resize(index + 1, 0.0);
+        }
+        F64 ms = F64Milliseconds(last_frame.getSum(timer)).value();
+        mAverageMs[index] += (ms - mAverageMs[index]) * 0.05;
+    }
+}
+
+void LLFrameSpikeMonitor::addSpike(F32 frame_ms)
+{
+    LLTrace::Recording& last_frame = LLTrace::get_frame_recording().getLastRecording();
+
+    // Timer totals include their children, so every timer around the one
+    // that stalled went over its average by as much as it did. Of the timers
+    // that account for most of the largest overrun, the cheapest one is the
+    // innermost, and gets the blame.
+    struct Overrun
+    {
+        const LLTrace::BlockTimerStatHandle* mTimer;
+        F64 mMs;
+        F64 mExcessMs;
+    };
+    std::vector<Overrun> overruns;
+    F64 max_excess = 0.0;
+    for (auto& base : LLTrace::BlockTimerStatHandle::instance_snapshot())
+    {
+        LLTrace::BlockTimerStatHandle& timer = static_cast<LLTrace::BlockTimerStatHandle&>(base);
+        size_t index = timer.getIndex();
+        if (&timer == &FTM_FRAME || index >= mAverageMs.size())
+        {
+            continue;
+        }
+        F64 ms = F64Milliseconds(last_frame.getSum(timer)).value();
+        F64 excess = ms - mAverageMs[index];
+        if (excess > 0.0)
+        {
+            overruns.push_back({ &timer, ms, excess });
+            max_excess = llmax(max_excess, excess);
+        }
+    }
+
+    const Overrun* blamed = nullptr;
+    for (const Overrun& overrun : overruns)
+    {
+        if (overrun.mExcessMs >= max_excess * 0.5 && (!blamed || overrun.mMs < blamed->mMs))
+        {
+            blamed = &overrun;
+        }
+    }
+
+    Spike spike;
+    spike.mFrame = gFrameCount;
+    spike.mFrameMs = frame_ms;
+    spike.mCause = blamed ? blamed->mTimer->getName() : std::string("Untimed");
+    spike.mCauseMs = blamed ? (F32)blamed->mExcessMs : frame_ms;
+    spike.mDetails = getDetails();
+
+    LL_INFOS("FrameSpike") << "Frame " << spike.mFrame << " took " << frame_ms << " ms, "
+                           << spike.mCause << " " << spike.mCauseMs << " ms over average, "
+                           << spike.mDetails << LL_ENDL;
+
+    Cause& cause = mCauses[spike.mCause];
+    cause.mCount++;
+    cause.mTotalMs += spike.mCauseMs;
+    cause.mWorstMs = llmax(cause.mWorstMs, spike.mCauseMs);
+
+    mSpikes.push_back(spike);
+    if (mSpikes.size() > MAX_SPIKES)
+    {
+        mSpikes.pop_front();
+    }
+    ++mChangeCount;
+}
+
+std::string LLFrameSpikeMonitor::getDetails() const
+{
+    std::ostringstream details;
+
+    LLTrace::Recording& last_frame = LLTrace::get_frame_recording().getLastRecording();
+    details << "packets in " << last_frame.getSum(LLStatViewer::PACKETS_IN)
+            << " (" << (S32)F64Kilobytes(last_frame.getSum(LLStatViewer::MESSAGE_SYSTEM_DATA_IN)).value() << " KB)";
+
+    LLTextureFetch* fetch = LLAppViewer::getTextureFetch();
+    if (fetch)
+    {
+        details << ", texture fetches " << fetch->getNumRequests();
+    }
+    details << ", mesh requests " << gMeshRepo.mPendingRequests.size()
+            << " pending " << LLMeshRepoThread::sActiveLODRequests + LLMeshRepoThread::sActiveHeaderRequests
+            << " active";
+
+    for (auto& queue : LL::WorkQueueBase::instance_snapshot())
+    {
+        size_t size = queue.size();
+        if (size)
+        {
+            details << ", " << queue.getKey() << " " << size;
+        }
+    }
+
+    return details.str();
+}
+
+void LLFrameSpikeMonitor::clear()
+{
+    mSpikes.clear();
+    mCauses.clear();
+    ++mChangeCount;
+}
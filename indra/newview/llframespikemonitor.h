@@ -0,0 +1,86 @@
+/**
+ * @file llframespikemonitor.h
+ * @brief Detects frame time spikes and attributes them to a fast timer
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLFRAMESPIKEMONITOR_H
+#define LL_LLFRAMESPIKEMONITOR_H
+
+#include "llsingleton.h"
+
+#include <deque>
+#include <map>
+
+// Watches the length of every frame. When one takes longer than
+// FrameSpikeThreshold milliseconds, the fast timer that went furthest over
+// its running average that frame is blamed for it, and the spike is kept,
+// with the work queue, fetch and network state of the moment, in a bounded
+// list for LLFloaterFrameSpikes.
+class LLFrameSpikeMonitor : public LLSingleton<LLFrameSpikeMonitor>
+{
+    LLSINGLETON(LLFrameSpikeMonitor);
+
+public:
+    struct Spike
+    {
+        U32         mFrame;
+        F32         mFrameMs;
+        std::string mCause;     // fast timer name
+        F32         mCauseMs;   // over that timer's average
+        std::string mDetails;   // queue depths and network traffic
+    };
+    typedef std::deque<Spike> spike_list_t;
+
+    struct Cause
+    {
+        U32 mCount = 0;
+        F32 mTotalMs = 0.f;
+        F32 mWorstMs = 0.f;
+    };
+    typedef std::map<std::string, Cause> cause_map_t;
+
+    // once a frame, right after the frame recording moved to a new period
+    void update();
+
+    const spike_list_t& getSpikes() const { return mSpikes; }
+    const cause_map_t& getCauses() const { return mCauses; }
+    // changes whenever a spike is added or the lists are cleared
+    U32 getChangeCount() const { return mChangeCount; }
+
+    void clear();
+
+private:
+    void addSpike(F32 frame_ms);
+    std::string getDetails() const;
+
+    // running average of each fast timer's time per frame, by timer index
+    std::vector<F64> mAverageMs;
+    U32 mFrames;
+    U32 mChangeCount;
+
+    spike_list_t mSpikes;
+    cause_map_t mCauses;
+};
+
+#endif // LL_LLFRAMESPIKEMONITOR_H
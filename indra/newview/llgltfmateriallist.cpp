@@ -58,6 +58,7 @@ LLGLTFMaterialList::apply_queue_t LLGLTFMaterialList::sApplyQueue;
 LLSD LLGLTFMaterialList::sUpdates;
 
 const size_t MAX_TASK_UPDATES = 255;
+const U32 MAX_OVERRIDE_TES = 45;
 
 #ifdef SHOW_ASSERT
 // return true if given data is (probably) valid update message for ModifyMaterialParams capability
@@ -170,86 +171,178 @@ namespace
 
 void LLGLTFMaterialList::applyOverrideMessage(LLMessageSystem* msg, const std::string& data_in)
 {
+    const LLHost& host = msg->getSender();
+
+    LLViewerRegion* region = LLWorld::instance().getRegion(host);
+    llassert(region);
+
+    if (region)
+    {
+        // region entry can bring thousands of these, parse them off the main thread
+        // and apply them in the order they arrived
+        U64 sequence = mOverrideSequence++;
+        U64 region_handle = region->getHandle();
+
+        LL::WorkQueue::ptr_t main_queue = LL::WorkQueue::getInstance("mainloop");
+        LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+
+        bool posted = main_queue && general_queue && main_queue->postTo(
+            general_queue,
+            [data_in, region_handle]() // Work done on general queue
+            {
+                ParsedOverride parsed;
+                parsed.mRegionHandle = region_handle;
+                parseOverride(data_in, parsed);
+                return parsed;
+            },
+            [sequence](ParsedOverride parsed) // Callback to main thread
+            {
+                gGLTFMaterialList.mParsedOverrides[sequence] = std::move(parsed);
+            });
+
+        if (!posted)
+        { // queues are gone (shutting down), parse it here
+            ParsedOverride& parsed = mParsedOverrides[sequence];
+            parsed.mRegionHandle = region_handle;
+            parseOverride(data_in, parsed);
+        }
+    }
+}
+
+// static
+void LLGLTFMaterialList::parseOverride(const std::string& data_in, ParsedOverride& parsed)
+{
+    LL_PROFILE_ZONE_SCOPED;
+
     boost::iostreams::stream<boost::iostreams::array_source> str(data_in.data(), data_in.size());
 
     LLSD data;
 
     LLSDSerialize::fromNotation(data, str, data_in.length());
 
-    const LLHost& host = msg->getSender();
+    parsed.mLocalId = data.get("id").asInteger();
 
-    LLViewerRegion* region = LLWorld::instance().getRegion(host);
-    llassert(region);
+    const LLSD& tes = data["te"];
+    const LLSD& od = data["od"];
 
-    if (region)
+    if (!tes.isArray()) // NOTE: if no "te" array exists, this is a malformed message (null out all overrides will come in as an empty te array)
     {
-        U32 local_id = data.get("id").asInteger();
-        LLUUID id;
-        gObjectList.getUUIDFromLocal(id, local_id, host.getAddress(), host.getPort());
-        LLViewerObject* obj = gObjectList.findObject(id);
+        return;
+    }
+    parsed.mValid = true;
+
+    auto count = llmin(tes.size(), MAX_OVERRIDE_TES);
+    for (size_t i = 0; i < count; ++i)
+    {
+        S32 te = tes[i].asInteger();
+        if (te < 0 || te >= (S32)MAX_OVERRIDE_TES)
+        {
+            continue;
+        }
+
+        LLGLTFMaterial* mat = new LLGLTFMaterial(); // setTEGLTFMaterialOverride and cache will take ownership
+        mat->applyOverrideLLSD(od[i]);
+
+        parsed.mTEs.push_back(te);
+        parsed.mSides.push_back(od[i]);
+        parsed.mMaterials.push_back(mat);
+    }
+}
 
-        // NOTE: obj may be null if the viewer hasn't heard about the object yet, cache update in any case
+void LLGLTFMaterialList::applyParsedOverrides()
+{
+    LL_PROFILE_ZONE_SCOPED;
 
-        if (obj && gShowObjectUpdates)
-        { // display a cyan blip for override updates when "Show Updates to Objects" enabled
-            LLColor4 color(0.f, 1.f, 1.f, 1.f);
-            gPipeline.addDebugBlip(obj->getPositionAgent(), color);
+    const F64 MAX_APPLY_SECONDS = 0.002;
+    LLTimer timer;
+
+    auto iter = mParsedOverrides.begin();
+    while (iter != mParsedOverrides.end() && iter->first == mNextAppliedOverride)
+    {
+        applyParsedOverride(iter->second);
+        iter = mParsedOverrides.erase(iter);
+        ++mNextAppliedOverride;
+
+        if (timer.getElapsedTimeF64() > MAX_APPLY_SECONDS)
+        { // rest will be applied next frame
+            break;
         }
+    }
+}
 
-        const LLSD& tes = data["te"];
-        const LLSD& od = data["od"];
+void LLGLTFMaterialList::applyParsedOverride(const ParsedOverride& parsed)
+{
+    LLViewerRegion* region = LLWorld::instance().getRegionFromHandle(parsed.mRegionHandle);
+    if (!region || !parsed.mValid)
+    { // region went away while the message was parsed, or malformed message
+        return;
+    }
 
-        constexpr U32 MAX_TES = 45;
-        bool has_te[MAX_TES] = { false };
+    const LLHost& host = region->getHost();
+    LLUUID id;
+    gObjectList.getUUIDFromLocal(id, parsed.mLocalId, host.getAddress(), host.getPort());
+    LLViewerObject* obj = gObjectList.findObject(id);
 
-        if (tes.isArray()) // NOTE: if no "te" array exists, this is a malformed message (null out all overrides will come in as an empty te array)
-        {
-            LLGLTFOverrideCacheEntry cache;
-            cache.mLocalId = local_id;
-            cache.mObjectId = id;
-            cache.mRegionHandle = region->getHandle();
+    // NOTE: obj may be null if the viewer hasn't heard about the object yet, cache update in any case
 
-            auto count = llmin(tes.size(), MAX_TES);
-            for (size_t i = 0; i < count; ++i)
-            {
-                LLGLTFMaterial* mat = new LLGLTFMaterial(); // setTEGLTFMaterialOverride and cache will take ownership
-                mat->applyOverrideLLSD(od[i]);
+    if (obj && gShowObjectUpdates)
+    { // display a cyan blip for override updates when "Show Updates to Objects" enabled
+        LLColor4 color(0.f, 1.f, 1.f, 1.f);
+        gPipeline.addDebugBlip(obj->getPositionAgent(), color);
+    }
 
-                S32 te = tes[i].asInteger();
+    bool has_te[MAX_OVERRIDE_TES] = { false };
 
-                has_te[te] = true;
-                cache.mSides[te] = od[i];
-                cache.mGLTFMaterial[te] = mat;
+    LLGLTFOverrideCacheEntry cache;
+    cache.mLocalId = parsed.mLocalId;
+    cache.mObjectId = id;
+    cache.mRegionHandle = parsed.mRegionHandle;
 
-                if (obj)
-                {
-                    obj->setTEGLTFMaterialOverride(te, mat);
-                    if (obj->getTE(te) && obj->getTE(te)->isSelected())
-                    {
-                        handle_gltf_override_message.doSelectionCallbacks(id, te);
-                    }
-                }
-            }
+    for (size_t i = 0; i < parsed.mTEs.size(); ++i)
+    {
+        S32 te = parsed.mTEs[i];
+        LLPointer<LLGLTFMaterial> mat = parsed.mMaterials[i];
+
+        has_te[te] = true;
 
-            if (obj)
-            { // null out overrides on TEs that shouldn't have them
-                U32 count = llmin(obj->getNumTEs(), MAX_TES);
-                for (U32 i = 0; i < count; ++i)
+        if (obj)
+        {
+            LLTextureEntry* tep = obj->getTE(te);
+            LLGLTFMaterial* current = tep ? tep->getGLTFMaterialOverride() : nullptr;
+            if (current && current->getHash() == mat->getHash())
+            { // unchanged, keep the applied one so the render material isn't rebuilt now or from the cache later
+                mat = current;
+            }
+            else
+            {
+                obj->setTEGLTFMaterialOverride(te, mat);
+                if (obj->getTE(te) && obj->getTE(te)->isSelected())
                 {
-                    LLTextureEntry* te = obj->getTE(i);
-                    if (!has_te[i] && te && te->getGLTFMaterialOverride())
-                    {
-                        obj->setTEGLTFMaterialOverride(i, nullptr);
-                        handle_gltf_override_message.doSelectionCallbacks(id, i);
-                    }
+                    handle_gltf_override_message.doSelectionCallbacks(id, te);
                 }
             }
-
-            region->cacheFullUpdateGLTFOverride(cache);
-            LL_DEBUGS("GLTF") << "GLTF Material Override: " << cache.mObjectId << " " << cache.mLocalId << " " << cache.mRegionHandle << " (sides:" << (cache.mSides.size()) << ")" << LL_ENDL;
         }
 
+        cache.mSides[te] = parsed.mSides[i];
+        cache.mGLTFMaterial[te] = mat;
+    }
+
+    if (obj)
+    { // null out overrides on TEs that shouldn't have them
+        U32 count = llmin(obj->getNumTEs(), MAX_OVERRIDE_TES);
+        for (U32 i = 0; i < count; ++i)
+        {
+            LLTextureEntry* te = obj->getTE(i);
+            if (!has_te[i] && te && te->getGLTFMaterialOverride())
+            {
+                obj->setTEGLTFMaterialOverride(i, nullptr);
+                handle_gltf_override_message.doSelectionCallbacks(id, i);
+            }
+        }
     }
+
+    region->cacheFullUpdateGLTFOverride(cache);
+    LL_DEBUGS("GLTF") << "GLTF Material Override: " << cache.mObjectId << " " << cache.mLocalId << " " << cache.mRegionHandle << " (sides:" << (cache.mSides.size()) << ")" << LL_ENDL;
 }
 
 void LLGLTFMaterialList::queueOverrideUpdate(const LLUUID& id, S32 side, LLGLTFMaterial* override_data)
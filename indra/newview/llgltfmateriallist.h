@@ -32,7 +32,9 @@
 #include "llgltfmaterial.h"
 #include "llpointer.h"
 
+#include <map>
 #include <unordered_map>
+#include <vector>
 
 class LLFetchedGLTFMaterial;
 class LLGLTFOverrideCacheEntry;
@@ -100,14 +102,32 @@ public:
     void applyQueuedOverrides(LLViewerObject* obj);
 
     // Apply an override update with the given data
+    // The data is parsed on the general work queue and applied later by applyParsedOverrides
     void applyOverrideMessage(LLMessageSystem* msg, const std::string& data);
 
+    // Apply the override updates parsed so far, in the order they arrived, for up to a
+    // few milliseconds. Called once per frame.
+    void applyParsedOverrides();
+
 private:
     friend class LLGLTFMaterialOverrideDispatchHandler;
     // save an override update that we got from the simulator for later (for example, if an override arrived for an unknown object)
     // NOTE: this is NOT for applying overrides from the UI, see queueModifyMaterial above
     void queueOverrideUpdate(const LLUUID& id, S32 side, LLGLTFMaterial* override_data);
 
+    // override update as parsed off the main thread
+    struct ParsedOverride
+    {
+        U64 mRegionHandle = 0;
+        U32 mLocalId = 0;
+        bool mValid = false; // false if malformed, has no "te" array
+        std::vector<S32> mTEs;
+        std::vector<LLSD> mSides;
+        std::vector<LLPointer<LLGLTFMaterial> > mMaterials;
+    };
+    static void parseOverride(const std::string& data, ParsedOverride& parsed);
+    void applyParsedOverride(const ParsedOverride& parsed);
+
 
     class CallbackHolder
     {
@@ -140,6 +160,11 @@ protected:
     typedef std::unordered_map<LLUUID, override_list_t > queued_override_map_t;
     queued_override_map_t mQueuedOverrides;
 
+    // parsed override updates by arrival order, applied only once all the earlier ones are
+    U64 mOverrideSequence = 0;
+    U64 mNextAppliedOverride = 0;
+    std::map<U64, ParsedOverride> mParsedOverrides;
+
     LLUUID mLastUpdateKey;
 
     struct ModifyMaterialData
@@ -386,6 +386,8 @@ void fixup_shader_constants(LLGLSLShader& shader)
     shader.uniform1i(LLShaderMgr::SUN_UP_FACTOR, 1);
     shader.uniform3fv(LLShaderMgr::SUNLIGHT_COLOR, 1, LLColor3::white.mV);
     shader.uniform1f(LLShaderMgr::DENSITY_MULTIPLIER, 0.0f);
+    shader.uniform3fv(LLShaderMgr::ATMO_TRANSMITTANCE, 1, LLColor3::white.mV);
+    shader.uniform3fv(LLShaderMgr::ATMO_EXTINCTION, 1, LLColor3::black.mV);
 
     // Ignore sun shadow (if enabled)
     for (U32 i = 0; i < 6; i++)
@@ -523,12 +525,39 @@ bool LLGLTFPreviewTexture::render()
     gPipeline.copyScreenSpaceReflections(&screen, &gPipeline.mSceneMap);
     gPipeline.generateLuminance(&screen, &gPipeline.mLuminanceMap);
     gPipeline.generateExposure(&gPipeline.mLuminanceMap, &gPipeline.mExposureMap, /*use_history = */ false);
-    gPipeline.gammaCorrect(&screen, &gPipeline.mPostMap);
-    LLVertexBuffer::unbind();
-    gPipeline.generateGlow(&gPipeline.mPostMap);
-    gPipeline.combineGlow(&gPipeline.mPostMap, &screen);
-    gPipeline.renderDoF(&screen, &gPipeline.mPostMap);
-    gPipeline.applyFXAA(&gPipeline.mPostMap, &screen);
+    {
+        // post scratch targets come from the pipeline's post graph, sized for the preview
+        LLRenderGraph& graph = gPipeline.mPostGraph;
+
+        LLRenderGraph::TargetDesc desc;
+        desc.mWidth = screen.getWidth();
+        desc.mHeight = screen.getHeight();
+        desc.mColorFormat = GL_RGBA16F;
+        S32 screen_h = graph.importTarget(&screen);
+        S32 post_h = graph.createTarget("preview post", desc);
+
+        std::vector<S32> writes = { post_h };
+        S32 fxaa_h = -1;
+        if (LLPipeline::RenderFSAAType == 1)
+        {
+            desc.mColorFormat = GL_RGBA;
+            fxaa_h = graph.createTarget("preview fxaa", desc);
+            writes.push_back(fxaa_h);
+        }
+
+        graph.addPass("preview post", { screen_h }, writes, [&graph, screen_h, post_h, fxaa_h]()
+            {
+                LLRenderTarget* screen_rt = graph.getTarget(screen_h);
+                LLRenderTarget* post_rt = graph.getTarget(post_h);
+                gPipeline.gammaCorrect(screen_rt, post_rt);
+                LLVertexBuffer::unbind();
+                gPipeline.generateGlow(post_rt);
+                gPipeline.combineGlow(post_rt, screen_rt);
+                gPipeline.renderDoF(screen_rt, post_rt);
+                gPipeline.applyFXAA(post_rt, screen_rt, fxaa_h != -1 ? graph.getTarget(fxaa_h) : nullptr);
+            });
+        graph.execute();
+    }
 
     // *HACK: Restore mExposureMap (it will be consumed by generateExposure next frame)
     gPipeline.mExposureMap.swapFBORefs(gPipeline.mLastExposure);
@@ -0,0 +1,132 @@
+/**
+ * @file llgpupasstimers.cpp
+ * @brief GPU timer queries around the major passes of the render pipeline
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llgpupasstimers.h"
+
+#include "llviewerstats.h"
+
+LLGPUPassTimers gGPUPassTimers;
+
+void LLGPUPassTimers::begin(EPass pass)
+{
+    Timer& timer = mTimers[pass][mIndex[pass]];
+    if (timer.mPending || !glQueryCounter)
+    { // previous query in this slot is still in flight, don't time this frame
+        return;
+    }
+
+    if (timer.mQueries[0] == 0)
+    {
+        glGenQueries(2, timer.mQueries);
+    }
+
+    glQueryCounter(timer.mQueries[0], GL_TIMESTAMP);
+    mActive[pass] = true;
+}
+
+void LLGPUPassTimers::end(EPass pass)
+{
+    if (!mActive[pass])
+    {
+        return;
+    }
+
+    Timer& timer = mTimers[pass][mIndex[pass]];
+    glQueryCounter(timer.mQueries[1], GL_TIMESTAMP);
+    timer.mPending = true;
+    mActive[pass] = false;
+
+    mIndex[pass] = (mIndex[pass] + 1) % RING_SIZE;
+}
+
+void LLGPUPassTimers::update()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DISPLAY;
+
+    static LLTrace::SampleStatHandle<F64Milliseconds>* stats[PASS_COUNT] =
+    {
+        &LLStatViewer::GPU_PROBE_TIME,
+        &LLStatViewer::GPU_SHADOW_TIME,
+        &LLStatViewer::GPU_GEOMETRY_TIME,
+        &LLStatViewer::GPU_LIGHTING_TIME,
+        &LLStatViewer::GPU_ALPHA_TIME,
+        &LLStatViewer::GPU_POST_TIME
+    };
+
+    for (U32 pass = 0; pass < PASS_COUNT; ++pass)
+    {
+        for (Timer& timer : mTimers[pass])
+        {
+            if (!timer.mPending)
+            {
+                continue;
+            }
+
+            GLuint available = 0;
+            glGetQueryObjectuiv(timer.mQueries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+            {
+                continue;
+            }
+
+            GLuint64 begin = 0;
+            GLuint64 end = 0;
+            glGetQueryObjectui64v(timer.mQueries[0], GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(timer.mQueries[1], GL_QUERY_RESULT, &end);
+            timer.mPending = false;
+
+            F32 ms = end > begin ? (F32)((end - begin) / 1000000.0) : 0.f;
+            mAverage[pass] = mAverage[pass] == 0.f ? ms : lerp(mAverage[pass], ms, 0.1f);
+            sample(*stats[pass], F64Milliseconds(ms));
+        }
+    }
+}
+
+F32 LLGPUPassTimers::getFrameTime() const
+{
+    return mAverage[PASS_PROBES] + mAverage[PASS_SHADOWS] + mAverage[PASS_GEOMETRY]
+        + mAverage[PASS_LIGHTING] + mAverage[PASS_POST];
+}
+
+void LLGPUPassTimers::cleanup()
+{
+    for (U32 pass = 0; pass < PASS_COUNT; ++pass)
+    {
+        for (Timer& timer : mTimers[pass])
+        {
+            if (timer.mQueries[0])
+            {
+                glDeleteQueries(2, timer.mQueries);
+            }
+            timer = Timer();
+        }
+        mIndex[pass] = 0;
+        mActive[pass] = false;
+        mAverage[pass] = 0.f;
+    }
+}
@@ -0,0 +1,78 @@
+/**
+ * @file llgpupasstimers.h
+ * @brief GPU timer queries around the major passes of the render pipeline
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#pragma once
+
+#include "llgl.h"
+
+// Times the major passes of a frame on the GPU with timestamp queries kept
+// in a small ring per pass. The results are read back a few frames later,
+// once they are available, so the CPU never waits on the GPU for them.
+class LLGPUPassTimers
+{
+public:
+    enum EPass
+    {
+        PASS_PROBES = 0,
+        PASS_SHADOWS,
+        PASS_GEOMETRY,
+        PASS_LIGHTING,  // includes the alpha pass
+        PASS_ALPHA,
+        PASS_POST,
+        PASS_COUNT
+    };
+
+    // time the GPU work submitted between begin() and end() of pass,
+    // passes may nest
+    void begin(EPass pass);
+    void end(EPass pass);
+
+    // read back the finished queries and record them as stats, once a frame
+    void update();
+
+    // running average GPU time of pass in milliseconds, 0 until measured
+    F32 getTime(EPass pass) const { return mAverage[pass]; }
+    // sum of the running averages of the passes that do not nest
+    F32 getFrameTime() const;
+
+    // free the queries, on GL shutdown
+    void cleanup();
+
+private:
+    struct Timer
+    {
+        GLuint mQueries[2] = { 0, 0 };
+        bool mPending = false;
+    };
+    static constexpr U32 RING_SIZE = 4;
+
+    Timer mTimers[PASS_COUNT][RING_SIZE];
+    U32 mIndex[PASS_COUNT] = {};
+    bool mActive[PASS_COUNT] = {}; // between begin() and end()
+    F32 mAverage[PASS_COUNT] = {};
+};
+
+extern LLGPUPassTimers gGPUPassTimers;
@@ -58,6 +58,9 @@
 #include <boost/lexical_cast.hpp>
 
 const U32 MAX_CACHED_GROUPS = 20;
+// Large groups reply with tens of thousands of members, that many are turned
+// into member data a slice per frame
+const F32 GROUP_MEMBERS_SLICE_SECONDS = 0.008f;
 
 //
 // LLRoleActionSet
@@ -2170,19 +2173,30 @@ void LLGroupMgr::groupMembersRequestCoro(std::string url, LLUUID group_id, U32 p
 
     LLSD response = httpAdapter->postAndSuspend(httpRequest, url, postData, httpOpts);
 
-    mMemberRequestInFlight = false;
-
     LLSD httpResults = response.get(LLCoreHttpUtil::HttpCoroutineAdapter::HTTP_RESULTS);
     LLCore::HttpStatus status = LLCoreHttpUtil::HttpCoroutineAdapter::getStatusFromLLSD(httpResults);
 
     if (!status)
     {
+        mMemberRequestInFlight = false;
         LL_WARNS("GrpMgr") << "Error receiving group member data " << LL_ENDL;
         return;
     }
 
     response.erase(LLCoreHttpUtil::HttpCoroutineAdapter::HTTP_RESULTS);
-    processCapGroupMembersResponse(response, url, page_size, page_start, sort_column, sort_descending);
+    // Processing yields, the request stays in flight until it is done so
+    // that nobody asks for the same members meanwhile.
+    bool next_page = processCapGroupMembersResponse(response, page_size, page_start, sort_column, sort_descending);
+    mMemberRequestInFlight = false;
+
+    if (next_page)
+    {
+        U32 next_page_start = page_start + page_size;
+        LLCoros::instance().launch("LLGroupMgr::groupMembersRequestCoro", [=]()
+            {
+                groupMembersRequestCoro(url, group_id, page_size, next_page_start, sort_column, sort_descending);
+            });
+    }
 }
 
 void LLGroupMgr::sendCapGroupMembersRequest(const LLUUID& group_id, U32 page_size, U32 page_start, const std::string& sort_column_name, bool sort_descending)
@@ -2251,7 +2265,7 @@ void LLGroupMgr::sendCapGroupMembersRequest(const LLUUID& group_id, U32 page_siz
         });
 }
 
-void LLGroupMgr::processCapGroupMembersResponse(const LLSD& response, const std::string& url, U32 page_size, U32 page_start, U32 sort_column, bool sort_descending)
+bool LLGroupMgr::processCapGroupMembersResponse(const LLSD& response, U32 page_size, U32 page_start, U32 sort_column, bool sort_descending)
 {
     LLUUID group_id = response["group_id"].asUUID();
     LL_INFOS("GrpMgr") << "group_id: '" << group_id << "'"
@@ -2262,15 +2276,16 @@ void LLGroupMgr::processCapGroupMembersResponse(const LLSD& response, const std:
     if (!response.size())
     {
         LL_INFOS("GrpMgr") << "No group member data received." << LL_ENDL;
-        return;
+        return false;
     }
 
     LLGroupMgrGroupData* group_datap = getGroupData(group_id);
     if (!group_datap)
     {
         LL_WARNS("GrpMgr") << "Received incorrect, possibly stale, group or request id" << LL_ENDL;
-        return;
+        return false;
     }
+    const LLUUID request_id = group_datap->mMemberRequestID;
 
     LLSD members = response["members"];
     LLSD titles = response["titles"];
@@ -2283,9 +2298,32 @@ void LLGroupMgr::processCapGroupMembersResponse(const LLSD& response, const std:
     std::string default_title = titles.size() ? titles[0].asString() : LLStringUtil::null;
     U64 default_powers = llstrtou64(defaults["default_powers"].asString().c_str(), NULL, 16);
 
+    // Members this reply replaces, freed once observers know about the new
+    // ones. Until then panels may still be walking the old ones.
+    std::vector<LLGroupMemberData*> replaced_members;
+
+    LLTimer slice_timer;
+    slice_timer.setTimerExpirySec(GROUP_MEMBERS_SLICE_SECONDS);
+
     auto members_end = members.endMap();
     for (auto it = members.beginMap(); it != members_end; ++it)
     {
+        if (slice_timer.hasExpired())
+        {
+            llcoro::suspend();
+            LLCoros::checkStop();
+            slice_timer.setTimerExpirySec(GROUP_MEMBERS_SLICE_SECONDS);
+
+            // The group may have been dropped from the cache or asked for
+            // again while we were away.
+            group_datap = getGroupData(group_id);
+            if (!group_datap || group_datap->mMemberRequestID != request_id)
+            {
+                LL_INFOS("GrpMgr") << "Group " << group_id << " member data went stale while processing" << LL_ENDL;
+                return false;
+            }
+        }
+
         // Reset defaults
         std::string online_status = "unknown";
         std::string title = default_title;
@@ -2332,9 +2370,10 @@ void LLGroupMgr::processCapGroupMembersResponse(const LLSD& response, const std:
         LLGroupMemberData* data = new LLGroupMemberData(member_id,
             donated_square_meters, member_powers, title, online_status, is_owner);
 
+        LLGroupMemberData*& member_slot = group_datap->mMembers[member_id];
         if (group_datap->mRoleMemberDataComplete)
         {
-            if (LLGroupMemberData* member_old = group_datap->mMembers[member_id])
+            if (LLGroupMemberData* member_old = member_slot)
             {
                 auto role_end = member_old->roleEnd();
                 for (auto role_it = member_old->roleBegin(); role_it != role_end; ++role_it)
@@ -2348,7 +2387,11 @@ void LLGroupMgr::processCapGroupMembersResponse(const LLSD& response, const std:
             }
         }
 
-        group_datap->mMembers[member_id] = data;
+        if (member_slot)
+        {
+            replaced_members.push_back(member_slot);
+        }
+        member_slot = data;
     }
 
     U32 member_count = (U32)group_datap->mMembers.size();
@@ -2374,14 +2417,6 @@ void LLGroupMgr::processCapGroupMembersResponse(const LLSD& response, const std:
         sendGroupTitlesRequest(group_id);
     }
 
-    if (page_size && members_loaded >= page_size && member_count > members_before)
-    {
-        LLCoros::instance().launch("LLGroupMgr::groupMembersRequestCoro", [&]()
-            {
-                groupMembersRequestCoro(url, group_id, page_size, page_start, sort_column, sort_descending);
-            });
-    }
-
     // Make the role-member data request
     if (group_datap->mPendingRoleMemberRequest || !group_datap->mRoleMemberDataComplete)
     {
@@ -2391,6 +2426,12 @@ void LLGroupMgr::processCapGroupMembersResponse(const LLSD& response, const std:
 
     group_datap->mChanged = true;
     notifyObservers(GC_MEMBER_DATA);
+
+    // The member version changed, callbacks holding the old data drop it
+    std::for_each(replaced_members.begin(), replaced_members.end(), DeletePointer());
+
+    // A full page means there may be more
+    return page_size && members_loaded >= page_size && member_count > members_before;
 }
 
 void LLGroupMgr::sendGroupRoleChanges(const LLUUID& group_id)
@@ -438,7 +438,9 @@ public:
 
 private:
     void groupMembersRequestCoro(std::string url, LLUUID group_id, U32 page_size, U32 page_start, U32 sort_column, bool sort_descending);
-    void processCapGroupMembersResponse(const LLSD& response, const std::string& url, U32 page_size, U32 page_start, U32 sort_column, bool sort_descending);
+    // Yields while turning the reply into member data, returns whether the
+    // next page should be requested
+    bool processCapGroupMembersResponse(const LLSD& response, U32 page_size, U32 page_start, U32 sort_column, bool sort_descending);
 
     void getGroupBanRequestCoro(std::string url, LLUUID group_id);
     void postGroupBanRequestCoro(std::string url, LLUUID group_id, U32 action, uuid_vec_t ban_list, bool update);
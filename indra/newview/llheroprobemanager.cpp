@@ -244,7 +244,17 @@ void LLHeroProbeManager::renderProbes()
 
         S32 face = gFrameCount % 6;
 
-        if (!mProbes.empty() && !mProbes[0].isNull() && !mProbes[0]->mOccluded)
+        static LLCachedControl<bool> sAdaptive(gSavedSettings, "RenderHeroProbeAdaptive", false);
+        updateRenderResolution(sAdaptive);
+
+        bool is_dynamic = mNearestHero->getReflectionProbeIsDynamic() && sDetail > 0;
+
+        if (canReuseLastCapture(sAdaptive, is_dynamic))
+        { // the cube map already covers every view direction from the last capture point,
+          // so this frame's camera rotation gets sampled correctly without rendering anything
+            LL_PROFILE_ZONE_NAMED_CATEGORY_DISPLAY("hpmu - reuse");
+        }
+        else if (!mProbes.empty() && !mProbes[0].isNull() && !mProbes[0]->mOccluded)
         {
             LL_PROFILE_ZONE_NUM(gFrameCount % rate);
             LL_PROFILE_ZONE_NUM(rate);
@@ -254,10 +264,14 @@ void LLHeroProbeManager::renderProbes()
                 if ((gFrameCount % rate) == (i % rate))
                 { // update 6/rate faces per frame
                     LL_PROFILE_ZONE_NUM(i);
-                    updateProbeFace(mProbes[0], i, mNearestHero->getReflectionProbeIsDynamic() && sDetail > 0, near_clip);
+                    updateProbeFace(mProbes[0], i, is_dynamic, near_clip);
                 }
             }
             generateRadiance(mProbes[0]);
+
+            mLastCaptureHero = mNearestHero;
+            mLastCaptureOrigin = mProbes[0]->mOrigin;
+            mLastCaptureFrame = gFrameCount;
         }
 
         mRenderingMirror = false;
@@ -269,6 +283,87 @@ void LLHeroProbeManager::renderProbes()
     }
 }
 
+bool LLHeroProbeManager::canReuseLastCapture(bool adaptive, bool is_dynamic) const
+{
+    // adaptive renders at most every other frame, a static capture has no avatars or particles
+    // in it, so it only goes stale when the eye moves or the scene is edited and may be kept longer
+    static LLCachedControl<U32> sStaticFrames(gSavedSettings, "RenderHeroProbeStaticReuseFrames", 4);
+    U32 max_age = adaptive ? 2 : 1;
+    if (!is_dynamic)
+    {
+        max_age = llmax(max_age, (U32)sStaticFrames);
+    }
+
+    if (mLastCaptureHero == nullptr || mLastCaptureHero != mNearestHero.get() || gFrameCount - mLastCaptureFrame >= max_age)
+    {
+        return false;
+    }
+
+    // translation is the only camera motion a cube map can't absorb, render again if the mirrored eye moved too far
+    static LLCachedControl<F32> sMaxShift(gSavedSettings, "RenderHeroProbeReuseDistance", 0.1f);
+    LLVector4a shift;
+    shift.setSub(mProbes[0]->mOrigin, mLastCaptureOrigin);
+    return shift.getLength3().getF32() <= sMaxShift;
+}
+
+void LLHeroProbeManager::updateRenderResolution(bool adaptive)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DISPLAY;
+
+    U32 res = mProbeResolution;
+    if (adaptive && mNearestHero.notNull())
+    {
+        // fraction of the screen height the mirror's bounding sphere spans
+        LLViewerCamera& camera = LLViewerCamera::instance();
+        F32 radius = mNearestHero->getScale().magVec() * 0.5f;
+        F32 distance = llmax((camera.getOrigin() - mNearestHero->getPositionAgent()).magVec(), 0.01f);
+        F32 coverage = radius / (distance * tanf(camera.getView() * 0.5f));
+
+        if (coverage < 0.25f)
+        {
+            res /= 4;
+        }
+        else if (coverage < 0.5f)
+        {
+            res /= 2;
+        }
+        res = llmax(res, (U32)128);
+    }
+
+    // mHeroProbeRT gets reallocated at mProbeResolution alongside the main render targets
+    if (res == gPipeline.mHeroProbeRT.width)
+    {
+        mPendingResolution = 0;
+        return;
+    }
+
+    if (res != mPendingResolution)
+    { // wait for the coverage to settle before paying for a reallocation
+        mPendingResolution = res;
+        mPendingResolutionTime = gFrameTimeSeconds;
+        return;
+    }
+
+    if (gFrameTimeSeconds - mPendingResolutionTime < 1.f)
+    {
+        return;
+    }
+
+    LL_DEBUGS("Mirrors") << "Mirror render resolution " << gPipeline.mHeroProbeRT.width << " -> " << res << LL_ENDL;
+
+    // the probe filters sample the render targets with normalized coordinates, a smaller render gets
+    // upsampled into the full resolution cube map
+    LLPipeline::RenderTargetPack* rt = gPipeline.mRT;
+    gCubeSnapshot = true;
+    gPipeline.mRT = &gPipeline.mHeroProbeRT;
+    gPipeline.allocateScreenBufferInternal(res, res);
+    gPipeline.mRT = rt;
+    gCubeSnapshot = false;
+
+    mPendingResolution = 0;
+    mLastCaptureHero = nullptr;
+}
+
 // Do the reflection map update render passes.
 // For every 12 calls of this function, one complete reflection probe radiance map and irradiance map is generated
 // First six passes render the scene with direct lighting only into a scratch space cube map at the end of the cube map array and generate
@@ -594,6 +689,8 @@ void LLHeroProbeManager::cleanup()
     mProbes.clear();
 
     mDefaultProbe = nullptr;
+    mLastCaptureHero = nullptr;
+    mPendingResolution = 0;
 }
 
 void LLHeroProbeManager::doOcclusion()
@@ -119,6 +119,13 @@ private:
     void updateProbeFace(LLReflectionMap* probe, U32 face, bool is_dynamic, F32 near_clip);
     void generateRadiance(LLReflectionMap *probe);
 
+    // "RenderHeroProbeAdaptive" support
+    // resize mHeroProbeRT to suit the nearest mirror's screen coverage
+    void updateRenderResolution(bool adaptive);
+    // true if the captured cube map is still close enough to this frame's view to be reused
+    // is_dynamic is whether the capture includes avatars and particles
+    bool canReuseLastCapture(bool adaptive, bool is_dynamic) const;
+
     // list of active reflection maps
     std::vector<LLPointer<LLReflectionMap>> mProbes;
 
@@ -144,6 +151,15 @@ private:
     std::vector<LLPointer<LLVOVolume>>                       mHeroVOList;
     LLPointer<LLVOVolume>                                 mNearestHero;
 
+    // mirror, origin and frame of the last cube map capture
+    LLVOVolume* mLastCaptureHero = nullptr;
+    LLVector4a mLastCaptureOrigin;
+    U32 mLastCaptureFrame = 0;
+
+    // render resolution the adaptive mode wants to switch mHeroProbeRT to, and since when
+    U32 mPendingResolution = 0;
+    F32 mPendingResolutionTime = 0.f;
+
 
 };
 
@@ -746,7 +746,7 @@ void LLHUDNameTag::updateAll()
     {
         LLHUDNameTag* textp = (*text_it);
         textp->mTargetPositionOffset.clearVec();
-        textp->updateSize();
+        // size is only needed on screen, visible tags get it in the LOD pass below
         textp->updateVisibility();
     }
 
@@ -789,19 +789,33 @@ void LLHUDNameTag::updateAll()
         return;
     }
 
-    VisibleTextObjectIterator src_it;
+    // Tags sorted by their left edge, so that each one is only tested against
+    // the ones starting before its right edge instead of against all others.
+    // Tags pushed during an iteration are sorted again for the next one.
+    std::vector<std::pair<F32, LLHUDNameTag*> > sorted_tags;
+    sorted_tags.reserve(sVisibleTextObjects.size());
 
     for (S32 i = 0; i < NUM_OVERLAP_ITERATIONS; i++)
     {
-        for (src_it = sVisibleTextObjects.begin(); src_it != sVisibleTextObjects.end(); ++src_it)
+        sorted_tags.clear();
+        for (LLHUDNameTag* textp : sVisibleTextObjects)
+        {
+            sorted_tags.emplace_back(textp->mSoftScreenRect.mLeft, textp);
+        }
+        std::sort(sorted_tags.begin(), sorted_tags.end());
+
+        for (size_t src_idx = 0; src_idx < sorted_tags.size(); ++src_idx)
         {
-            LLHUDNameTag* src_textp = (*src_it);
+            LLHUDNameTag* src_textp = sorted_tags[src_idx].second;
 
-            VisibleTextObjectIterator dst_it = src_it;
-            ++dst_it;
-            for (; dst_it != sVisibleTextObjects.end(); ++dst_it)
+            for (size_t dst_idx = src_idx + 1; dst_idx < sorted_tags.size(); ++dst_idx)
             {
-                LLHUDNameTag* dst_textp = (*dst_it);
+                if (sorted_tags[dst_idx].first > src_textp->mSoftScreenRect.mRight)
+                {
+                    break;
+                }
+
+                LLHUDNameTag* dst_textp = sorted_tags[dst_idx].second;
 
                 if (src_textp->mSoftScreenRect.overlaps(dst_textp->mSoftScreenRect))
                 {
@@ -0,0 +1,225 @@
+/**
+ * @file llimpostoratlas.cpp
+ * @brief Shared render target the avatar impostors are packed into.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llimpostoratlas.h"
+
+#include "llgl.h"
+
+LLImpostorAtlas::LLImpostorAtlas()
+{
+}
+
+LLImpostorAtlas::~LLImpostorAtlas()
+{
+}
+
+void LLImpostorAtlas::setSize(U32 size)
+{
+    size = llclamp(size, (U32)512, (U32)llmax(gGLManager.mGLMaxTextureSize, 512));
+
+    // round down to a power of two, the blocks halve all the way to the smallest tile
+    U32 pow2 = 512;
+    while (pow2 * 2 <= size)
+    {
+        pow2 *= 2;
+    }
+
+    if (pow2 != mSize)
+    {
+        release();
+        mSize = pow2;
+    }
+}
+
+S32 LLImpostorAtlas::allocatePair()
+{
+    if (!mFreePairs.empty())
+    {
+        S32 pair = mFreePairs.back();
+        mFreePairs.pop_back();
+        return pair;
+    }
+
+    S32 pair = (S32)mNodes.size();
+    mNodes.resize(mNodes.size() + 2);
+    return pair;
+}
+
+bool LLImpostorAtlas::allocateTile(Tile& tile, U32 width, U32 height)
+{
+    width = llclamp(width, MIN_TILE_SIZE, mSize);
+    height = llclamp(height, MIN_TILE_SIZE, mSize);
+
+    // round up to a block shape
+    if (width > height)
+    {
+        height = width;
+    }
+    else if (height > width * 2)
+    {
+        width = height / 2;
+    }
+
+    if (isValid(tile))
+    {
+        if (tile.mWidth == width && tile.mHeight == height)
+        {
+            return true;
+        }
+        freeTile(tile);
+    }
+    tile.mNode = -1;
+
+    if (mNodes.empty())
+    {
+        mNodes.push_back({ 0, 0, mSize, mSize, -1, -1, NODE_FREE });
+    }
+
+    // best fit, the smallest free block the tile fits in
+    S32 best = -1;
+    for (S32 i = 0; i < (S32)mNodes.size(); ++i)
+    {
+        const Node& node = mNodes[i];
+        if (node.mState == NODE_FREE && node.mWidth >= width && node.mHeight >= height
+            && (best < 0 || node.mWidth * node.mHeight < mNodes[best].mWidth * mNodes[best].mHeight))
+        {
+            best = i;
+            if (node.mWidth == width && node.mHeight == height)
+            {
+                break;
+            }
+        }
+    }
+
+    if (best < 0)
+    {
+        return false;
+    }
+
+    // halve the block until it is the tile, square blocks split into two tall ones and tall ones into two squares
+    while (mNodes[best].mWidth != width || mNodes[best].mHeight != height)
+    {
+        llassert(mNodes[best].mWidth * mNodes[best].mHeight > width * height);
+
+        S32 child = allocatePair();
+        Node& block = mNodes[best];
+
+        Node first = { block.mX, block.mY, block.mWidth, block.mHeight, best, -1, NODE_FREE };
+        Node second = first;
+        if (block.mWidth == block.mHeight)
+        {
+            first.mWidth = second.mWidth = block.mWidth / 2;
+            second.mX += first.mWidth;
+        }
+        else
+        {
+            first.mHeight = second.mHeight = block.mHeight / 2;
+            second.mY += first.mHeight;
+        }
+
+        block.mState = NODE_SPLIT;
+        block.mChild = child;
+        mNodes[child] = first;
+        mNodes[child + 1] = second;
+        best = child;
+    }
+
+    Node& node = mNodes[best];
+    node.mState = NODE_USED;
+
+    tile.mNode = best;
+    tile.mSerial = mSerial;
+    tile.mX = node.mX;
+    tile.mY = node.mY;
+    tile.mWidth = node.mWidth;
+    tile.mHeight = node.mHeight;
+    return true;
+}
+
+void LLImpostorAtlas::freeTile(Tile& tile)
+{
+    if (!isValid(tile))
+    {
+        tile.mNode = -1;
+        return;
+    }
+
+    S32 i = tile.mNode;
+    tile.mNode = -1;
+    llassert(mNodes[i].mState == NODE_USED);
+    mNodes[i].mState = NODE_FREE;
+
+    // merge with the buddy for as long as both halves are free
+    while (mNodes[i].mParent >= 0)
+    {
+        S32 parent = mNodes[i].mParent;
+        S32 child = mNodes[parent].mChild;
+        if (mNodes[child].mState != NODE_FREE || mNodes[child + 1].mState != NODE_FREE)
+        {
+            break;
+        }
+
+        mNodes[child].mState = NODE_UNUSED;
+        mNodes[child + 1].mState = NODE_UNUSED;
+        mFreePairs.push_back(child);
+
+        mNodes[parent].mState = NODE_FREE;
+        mNodes[parent].mChild = -1;
+        i = parent;
+    }
+}
+
+void LLImpostorAtlas::bindTarget(const Tile& tile)
+{
+    llassert(isValid(tile));
+    mTarget.bindTarget();
+    glViewport(tile.mX, tile.mY, tile.mWidth, tile.mHeight);
+}
+
+void LLImpostorAtlas::clearTile(const Tile& tile)
+{
+    // the clear ignores the viewport
+    LLGLEnable scissor(GL_SCISSOR_TEST);
+    glScissor(tile.mX, tile.mY, tile.mWidth, tile.mHeight);
+    mTarget.clear();
+}
+
+void LLImpostorAtlas::getTexCoords(const Tile& tile, LLVector2& tc_min, LLVector2& tc_max) const
+{
+    F32 scale = 1.f / mSize;
+    tc_min.set(tile.mX * scale, tile.mY * scale);
+    tc_max.set((tile.mX + tile.mWidth) * scale, (tile.mY + tile.mHeight) * scale);
+}
+
+void LLImpostorAtlas::release()
+{
+    mTarget.release();
+    mNodes.clear();
+    mFreePairs.clear();
+    ++mSerial;
+}
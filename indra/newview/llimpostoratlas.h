@@ -0,0 +1,115 @@
+/**
+ * @file llimpostoratlas.h
+ * @brief Shared render target the avatar impostors are packed into.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLIMPOSTORATLAS_H
+#define LL_LLIMPOSTORATLAS_H
+
+#include <vector>
+
+#include "llrendertarget.h"
+#include "v2math.h"
+
+// Holds every avatar impostor in one square render target (with the deferred
+// attachments, see LLPipeline::generateImpostor) instead of a target per
+// avatar, so drawing the impostors binds the same textures throughout and
+// LLRender batches their quads into a single draw.
+//
+// Tiles are handed out by a binary buddy allocator. Every block is either
+// square or twice as tall as it is wide and splits in two across its longer
+// side, which fits the mostly tall impostors: a square or tall request takes
+// at most twice its area. Freed tiles merge back with their buddy.
+class LLImpostorAtlas
+{
+public:
+    // smallest tile edge, keeps the block tree shallow
+    static constexpr U32 MIN_TILE_SIZE = 16;
+
+    // a region of the atlas, only valid until the atlas is released
+    struct Tile
+    {
+        S32 mNode = -1;
+        U32 mSerial = 0;
+        U32 mX = 0;         // texels
+        U32 mY = 0;
+        U32 mWidth = 0;
+        U32 mHeight = 0;
+    };
+
+    LLImpostorAtlas();
+    ~LLImpostorAtlas();
+
+    // edge of the atlas in texels, a change releases the atlas
+    void setSize(U32 size);
+    U32 getSize() const { return mSize; }
+
+    // allocated by LLPipeline::generateImpostor, releasing it drops every tile
+    LLRenderTarget& getTarget() { return mTarget; }
+
+    // give 'tile' a region of at least 'width' x 'height', keeping the one it has if that already is the size
+    // returns false if the atlas has no room left, 'tile' is freed then
+    bool allocateTile(Tile& tile, U32 width, U32 height);
+    void freeTile(Tile& tile);
+    bool isValid(const Tile& tile) const { return tile.mNode >= 0 && tile.mSerial == mSerial; }
+
+    // bind the atlas for rendering into 'tile' only
+    void bindTarget(const Tile& tile);
+    void clearTile(const Tile& tile);
+
+    void getTexCoords(const Tile& tile, LLVector2& tc_min, LLVector2& tc_max) const;
+
+    void release();
+
+private:
+    enum
+    {
+        NODE_FREE,
+        NODE_USED,
+        NODE_SPLIT,
+        NODE_UNUSED,    // slot of a merged pair, see mFreePairs
+    };
+
+    struct Node
+    {
+        U32 mX;
+        U32 mY;
+        U32 mWidth;
+        U32 mHeight;
+        S32 mParent;
+        S32 mChild;     // the children of a split block are at mChild and mChild + 1
+        U32 mState;
+    };
+
+    // index of two new consecutive nodes
+    S32 allocatePair();
+
+    LLRenderTarget mTarget;
+    std::vector<Node> mNodes;
+    std::vector<S32> mFreePairs;
+    U32 mSize = 2048;
+    U32 mSerial = 1;    // changes whenever the atlas is released, tiles of older serials are gone
+};
+
+#endif // LL_LLIMPOSTORATLAS_H
@@ -102,27 +102,18 @@ bool LLInventoryFilter::check(const LLFolderViewModelItem* item)
         return true;
     }
 
-    std::string desc = listener->getSearchableCreatorName();
-    switch (mSearchType)
+    std::string desc;
+    if (mSearchType == SEARCHTYPE_NAME)
     {
-        case SEARCHTYPE_CREATOR:
-            desc = listener->getSearchableCreatorName();
-            break;
-        case SEARCHTYPE_DESCRIPTION:
-            desc = listener->getSearchableDescription();
-            break;
-        case SEARCHTYPE_UUID:
-            desc = listener->getSearchableUUIDString();
-            break;
-        case SEARCHTYPE_NAME:
-        default:
-            desc = listener->getSearchableName();
-            break;
+        desc = listener->getSearchableName();
     }
 
-
     bool passed = true;
-    if (!mExactToken.empty() && (mSearchType == SEARCHTYPE_NAME))
+    if (mSearchType != SEARCHTYPE_NAME)
+    {
+        passed = checkAgainstSearchIndex(listener->getUUID());
+    }
+    else if (!mExactToken.empty())
     {
         passed = false;
         typedef boost::tokenizer<boost::char_separator<char> > tokenizer;
@@ -138,7 +129,7 @@ bool LLInventoryFilter::check(const LLFolderViewModelItem* item)
             }
         }
     }
-    else if (!mFilterTokens.empty() && mSearchType == SEARCHTYPE_NAME)
+    else if (!mFilterTokens.empty())
     {
         for (const auto& token_iter : mFilterTokens)
         {
@@ -304,6 +295,28 @@ bool LLInventoryFilter::checkAgainstFilterSubString(const std::string& desc) con
     return pos != std::string::npos;
 }
 
+bool LLInventoryFilter::checkAgainstSearchIndex(const LLUUID& object_id)
+{
+    if (mFilterSubString.empty())
+        return true;
+
+    LLInventorySearchIndex::EField field;
+    switch (mSearchType)
+    {
+        case SEARCHTYPE_CREATOR:
+            field = LLInventorySearchIndex::FIELD_CREATOR;
+            break;
+        case SEARCHTYPE_UUID:
+            field = LLInventorySearchIndex::FIELD_ASSET_ID;
+            break;
+        case SEARCHTYPE_DESCRIPTION:
+        default:
+            field = LLInventorySearchIndex::FIELD_DESCRIPTION;
+            break;
+    }
+    return mSearchResults.matches(field, mFilterSubString, object_id);
+}
+
 bool LLInventoryFilter::checkAgainstFilterType(const LLFolderViewModelItemInventory* listener) const
 {
     if (!listener)
@@ -30,6 +30,7 @@
 #include "llinventorytype.h"
 #include "llpermissionsflags.h"
 #include "llfolderviewmodel.h"
+#include "llinventorysearchindex.h"
 
 class LLFolderViewItem;
 class LLFolderViewFolder;
@@ -343,6 +344,7 @@ public:
 private:
     bool                areDateLimitsSet() const;
     bool                checkAgainstFilterSubString(const std::string& desc) const;
+    bool                checkAgainstSearchIndex(const LLUUID& object_id);
     bool                checkAgainstFilterType(const class LLFolderViewModelItemInventory* listener) const;
     bool                checkAgainstFilterType(const LLInventoryItem* item) const;
     bool                checkAgainstPermissions(const class LLFolderViewModelItemInventory* listener) const;
@@ -379,6 +381,7 @@ private:
 
     std::vector<std::string> mFilterTokens;
     std::string              mExactToken;
+    LLInventorySearchResults mSearchResults; // description, creator and UUID searches
 
     bool mSingleFolderMode;
 };
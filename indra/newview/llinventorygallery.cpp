@@ -109,6 +109,7 @@ LLInventoryGallery::LLInventoryGallery(const LLInventoryGallery::Params& p)
       mRootDirty(false),
       mLoadThumbnailsImmediately(true),
       mNeedsArrange(false),
+      mThumbnailsInViewDirty(true),
       mSearchType(LLInventoryFilter::SEARCHTYPE_NAME),
       mSortOrder(LLInventoryFilter::SO_DATE)
 {
@@ -356,6 +357,7 @@ void LLInventoryGallery::initGallery()
 
 void LLInventoryGallery::draw()
 {
+    updateThumbnailsInView();
     LLPanel::draw();
     if (mGalleryCreated)
     {
@@ -400,6 +402,34 @@ bool LLInventoryGallery::updateRowsIfNeeded()
     return false;
 }
 
+void LLInventoryGallery::updateThumbnailsInView()
+{
+    if (!mScrollPanel || mItemsInRow <= 0)
+    {
+        return;
+    }
+
+    // Keep a row above and below the visible ones loaded, so that scrolling
+    // doesn't uncover thumbnails that haven't even started loading.
+    LLRect in_view_rect = mScrollPanel->getVisibleContentRect();
+    in_view_rect.stretch(0, mRowPanelHeight + mVerticalGap);
+    if (!mThumbnailsInViewDirty && in_view_rect == mThumbnailsInViewRect)
+    {
+        return;
+    }
+    mThumbnailsInViewRect = in_view_rect;
+    mThumbnailsInViewDirty = false;
+
+    // Items scrolled out of view drop their thumbnails and with them their
+    // fetches, so what is shown is what gets fetched first.
+    for (size_t i = 0; i < mItems.size(); ++i)
+    {
+        size_t row = i / mItemsInRow;
+        bool in_view = row < mRowPanels.size() && mRowPanels[row]->getRect().overlaps(in_view_rect);
+        mItems[i]->setThumbnailInView(in_view);
+    }
+}
+
 bool compareGalleryItem(LLInventoryGalleryItem* item1, LLInventoryGalleryItem* item2, bool sort_by_date, bool sort_folders_by_name)
 {
     if (item1->getSortGroup() != item2->getSortGroup())
@@ -543,9 +573,10 @@ void LLInventoryGallery::addToGallery(LLInventoryGalleryItem* item)
 
     // Avoid loading too many items.
     // Intent is for small folders to display all content fast
-    // and for large folders to load content mostly as needed
-    // Todo: ideally needs to unload images outside visible area
+    // and for large folders to load content mostly as needed,
+    // updateThumbnailsInView() unloads images outside visible area
     mLoadThumbnailsImmediately = mItemsAddedCount < FAST_LOAD_THUMBNAIL_TRSHOLD;
+    mThumbnailsInViewDirty = true;
 
     bool add_row = row_count != row_count_prev;
     int pos = 0;
@@ -581,6 +612,7 @@ void LLInventoryGallery::removeFromGalleryLast(LLInventoryGalleryItem* item, boo
     mIndexToItemMap.erase(mItemsAddedCount);
 
     mLoadThumbnailsImmediately = mItemsAddedCount < FAST_LOAD_THUMBNAIL_TRSHOLD;
+    mThumbnailsInViewDirty = true;
 
     bool remove_row = row_count != row_count_prev;
     removeFromLastRow(mItems[mItemsAddedCount]);
@@ -798,29 +830,28 @@ bool LLInventoryGallery::checkAgainstFilters(LLInventoryGalleryItem* item, const
         return false;
     }
 
-    std::string desc;
+    std::string cur_filter = filter_substring;
+    LLStringUtil::toUpper(cur_filter);
+
     switch(mSearchType)
     {
         case LLInventoryFilter::SEARCHTYPE_CREATOR:
-            desc = item->getCreatorName();
-            break;
+            return cur_filter.empty()
+                || mSearchResults.matches(LLInventorySearchIndex::FIELD_CREATOR, cur_filter, item->getUUID());
         case LLInventoryFilter::SEARCHTYPE_DESCRIPTION:
-            desc = item->getDescription();
-            break;
+            return cur_filter.empty()
+                || mSearchResults.matches(LLInventorySearchIndex::FIELD_DESCRIPTION, cur_filter, item->getUUID());
         case LLInventoryFilter::SEARCHTYPE_UUID:
-            desc = item->getAssetIDStr();
-            break;
+            return cur_filter.empty()
+                || mSearchResults.matches(LLInventorySearchIndex::FIELD_ASSET_ID, cur_filter, item->getUUID());
         case LLInventoryFilter::SEARCHTYPE_NAME:
         default:
-            desc = item->getItemName() + item->getItemNameSuffix();
             break;
     }
 
+    std::string desc = item->getItemName() + item->getItemNameSuffix();
     LLStringUtil::toUpper(desc);
 
-    std::string cur_filter = filter_substring;
-    LLStringUtil::toUpper(cur_filter);
-
     hidden = (std::string::npos == desc.find(cur_filter));
     return !hidden;
 }
@@ -2891,6 +2922,11 @@ void LLInventoryGalleryItem::setLoadImmediately(bool val)
     mThumbnailCtrl->setInitImmediately(val);
 }
 
+void LLInventoryGalleryItem::setThumbnailInView(bool in_view)
+{
+    mThumbnailCtrl->setInView(in_view);
+}
+
 void LLInventoryGalleryItem::draw()
 {
     if (isFadeItem())
@@ -226,6 +226,7 @@ private:
     void reArrangeRows(S32 row_diff = 0);
     bool updateRowsIfNeeded();
     void updateGalleryWidth();
+    void updateThumbnailsInView();
 
     LLInventoryGalleryItem* buildGalleryItem(std::string name, LLUUID item_id, LLAssetType::EType type, LLUUID thumbnail_id, LLInventoryType::EType inventory_type, U32 flags, time_t creation_date, bool is_link, bool is_worn);
     LLInventoryGalleryItem* getItem(const LLUUID& id) const;
@@ -251,6 +252,9 @@ private:
     bool mGalleryCreated;
     bool mLoadThumbnailsImmediately;
     bool mNeedsArrange;
+    // rows scrolled in view the last time thumbnails were told about it
+    LLRect mThumbnailsInViewRect;
+    bool mThumbnailsInViewDirty;
 
     /* Params */
     int mRowPanelHeight;
@@ -280,6 +284,7 @@ private:
     std::map<S32, LLInventoryGalleryItem*> mIndexToItemMap;
 
     LLInventoryFilter::ESearchType mSearchType;
+    LLInventorySearchResults mSearchResults;
     std::string mUsername;
 };
 
@@ -347,6 +352,7 @@ public:
     void setThumbnail(LLUUID id);
     void setGallery(LLInventoryGallery* gallery) { mGallery = gallery; }
     void setLoadImmediately(bool val);
+    void setThumbnailInView(bool in_view);
     bool isFolder() { return mIsFolder; }
     bool isLink() { return mIsLink; }
     EInventorySortGroup getSortGroup() { return mSortGroup; }
@@ -67,12 +67,19 @@
 #include "llcorehttputil.h"
 #include "hbxxh.h"
 #include "llstartup.h"
+#include "workqueue.h"
 
 //#define DIFF_INVENTORY_FILES
 #ifdef DIFF_INVENTORY_FILES
 #include "process.h"
 #endif
 
+#ifdef LL_USESYSTEMLIBS
+#include <zlib.h>
+#else
+#include "zlib-ng/zlib.h"
+#endif
+
 #include <algorithm>
 #include <boost/algorithm/string/join.hpp>
 
@@ -92,6 +99,20 @@ static const char PRODUCTION_CACHE_FORMAT_STRING[] = "%s.inv.llsd";
 static const char GRID_CACHE_FORMAT_STRING[] = "%s.%s.inv.llsd";
 static const char * const LOG_INV("Inventory");
 
+// An inventory cache read by LLInventoryModel::preloadCache()
+struct PreloadedCache
+{
+    std::string mFilename;
+    LLInventoryModel::cat_array_t mCategories;
+    LLInventoryModel::item_array_t mItems;
+    LLInventoryModel::changed_items_t mCatsToUpdate;
+    bool mIsCacheObsolete = false;
+    bool mLoaded = false;
+    bool mDone = false; // set on the main thread once the read is over
+};
+typedef std::map<LLUUID, std::shared_ptr<PreloadedCache> > preloaded_caches_t;
+static preloaded_caches_t sPreloadedCaches;
+
 struct InventoryIDPtrLess
 {
     bool operator()(const LLViewerInventoryCategory* i1, const LLViewerInventoryCategory* i2) const
@@ -444,6 +465,8 @@ LLInventoryModel::LLInventoryModel()
     mIsNotifyObservers(false),
     mModifyMask(LLInventoryObserver::ALL),
     mChangedItemIDs(),
+    mAnyCategoryChanged(true),
+    mAnyCategoryChangedBacklog(false),
     mBulkFecthCallbackSlot(),
     mObservers(),
     mHttpRequestFG(NULL),
@@ -1442,6 +1465,7 @@ U32 LLInventoryModel::updateItem(const LLViewerInventoryItem* item, U32 mask)
         if(old_parent_id != new_parent_id)
         {
             // need to update the parent-child tree
+            addChangedCategory(old_parent_id);
             item_array_t* item_array;
             item_array = get_ptr_in_map(mParentChildItemTree, old_parent_id);
             if(item_array)
@@ -1631,6 +1655,7 @@ void LLInventoryModel::updateCategory(const LLViewerInventoryCategory* cat, U32
         if(old_parent_id != new_parent_id)
         {
             // need to update the parent-child tree
+            addChangedCategory(old_parent_id);
             cat_array_t* cat_array;
             cat_array = getUnlockedCatArray(old_parent_id);
             if(cat_array)
@@ -1694,7 +1719,7 @@ void LLInventoryModel::moveObject(const LLUUID& object_id, const LLUUID& cat_id)
         return;
     }
 
-    if((object_id == cat_id) || !is_in_map(mCategoryMap, cat_id))
+    if((object_id == cat_id) || !mCategoryMap.contains(cat_id))
     {
         LL_WARNS(LOG_INV) << "Could not move inventory object " << object_id << " to "
                           << cat_id << LL_ENDL;
@@ -1704,6 +1729,7 @@ void LLInventoryModel::moveObject(const LLUUID& object_id, const LLUUID& cat_id)
     if(cat && (cat->getParentUUID() != cat_id))
     {
         LL_DEBUGS(LOG_INV) << "Move category '" << make_path(cat) << "' to '" << make_inventory_path(cat_id) << "'" << LL_ENDL;
+        addChangedCategory(cat->getParentUUID());
         cat_array_t* cat_array;
         cat_array = getUnlockedCatArray(cat->getParentUUID());
         if(cat_array) vector_replace_with_last(*cat_array, cat);
@@ -1717,6 +1743,7 @@ void LLInventoryModel::moveObject(const LLUUID& object_id, const LLUUID& cat_id)
     if(item && (item->getParentUUID() != cat_id))
     {
         LL_DEBUGS(LOG_INV) << "Move item '" << make_path(item) << "' to '" << make_inventory_path(cat_id) << "'" << LL_ENDL;
+        addChangedCategory(item->getParentUUID());
         item_array_t* item_array;
         item_array = getUnlockedItemArray(item->getParentUUID());
         if(item_array) vector_replace_with_last(*item_array, item);
@@ -2025,6 +2052,7 @@ void LLInventoryModel::deleteObject(const LLUUID& id, bool fix_broken_links, boo
     }
 
     // Note : We need to tell the inventory observers that those things are going to be deleted *before* the tree is cleared or they won't know what to delete (in views and view models)
+    addChangedCategory(parent_id);
     addChangedMask(LLInventoryObserver::REMOVE, id);
     gInventory.notifyObservers();
 
@@ -2151,7 +2179,10 @@ void LLInventoryModel::notifyObservers()
          iter != mObservers.end(); )
     {
         LLInventoryObserver* observer = *iter;
-        observer->changed(mModifyMask);
+        if (observer->getInterestMask() & mModifyMask)
+        {
+            observer->changed(mModifyMask);
+        }
 
         // safe way to increment since changed may delete entries! (@!##%@!@&*!)
         iter = mObservers.upper_bound(observer);
@@ -2164,10 +2195,15 @@ void LLInventoryModel::notifyObservers()
     mChangedItemIDs.insert(mChangedItemIDsBacklog.begin(), mChangedItemIDsBacklog.end());
     mAddedItemIDs.clear();
     mAddedItemIDs.insert(mAddedItemIDsBacklog.begin(), mAddedItemIDsBacklog.end());
+    mChangedCategoryIDs.clear();
+    mChangedCategoryIDs.insert(mChangedCategoryIDsBacklog.begin(), mChangedCategoryIDsBacklog.end());
+    mAnyCategoryChanged = mAnyCategoryChangedBacklog;
 
     mModifyMaskBacklog = LLInventoryObserver::NONE;
     mChangedItemIDsBacklog.clear();
     mAddedItemIDsBacklog.clear();
+    mChangedCategoryIDsBacklog.clear();
+    mAnyCategoryChangedBacklog = false;
 
     mIsNotifyObservers = false;
 }
@@ -2208,6 +2244,31 @@ void LLInventoryModel::addChangedMask(U32 mask, const LLUUID& referent)
         mModifyMask |= mask;
     }
 
+    if (referent.isNull())
+    {
+        // can't tell where this happened
+        if (mIsNotifyObservers)
+        {
+            mAnyCategoryChangedBacklog = true;
+        }
+        else
+        {
+            mAnyCategoryChanged = true;
+        }
+    }
+
+    // A change to an object is a change to the contents of its parent, and
+    // to a category itself. Recorded even for known referents, they may have
+    // moved since.
+    if (const LLInventoryObject* obj = referent.notNull() ? getObject(referent) : NULL)
+    {
+        addChangedCategory(obj->getParentUUID());
+        if (obj->getType() == LLAssetType::AT_CATEGORY)
+        {
+            addChangedCategory(referent);
+        }
+    }
+
     bool needs_update = false;
     if (referent.notNull())
     {
@@ -2261,6 +2322,26 @@ void LLInventoryModel::addChangedMask(U32 mask, const LLUUID& referent)
     }
 }
 
+void LLInventoryModel::addChangedCategory(const LLUUID& cat_id)
+{
+    if (cat_id.notNull())
+    {
+        if (mIsNotifyObservers)
+        {
+            mChangedCategoryIDsBacklog.insert(cat_id);
+        }
+        else
+        {
+            mChangedCategoryIDs.insert(cat_id);
+        }
+    }
+}
+
+bool LLInventoryModel::isCategoryChanged(const LLUUID& cat_id) const
+{
+    return mAnyCategoryChanged || mChangedCategoryIDs.find(cat_id) != mChangedCategoryIDs.end();
+}
+
 bool LLInventoryModel::fetchDescendentsOf(const LLUUID& folder_id) const
 {
     if(folder_id.isNull())
@@ -2332,21 +2413,9 @@ void LLInventoryModel::cache(
         items,
         INCLUDE_TRASH,
         can_cache);
-    // Use temporary file to avoid potential conflicts with other
-    // instances (even a 'read only' instance unzips into a file)
-    std::string temp_file = gDirUtilp->getTempFilename();
-    saveToFile(temp_file, categories, items);
     std::string gzip_filename = getInvCacheAddres(agent_id);
     gzip_filename.append(".gz");
-    if(gzip_file(temp_file, gzip_filename))
-    {
-        LL_DEBUGS(LOG_INV) << "Successfully compressed " << temp_file << " to " << gzip_filename << LL_ENDL;
-        LLFile::remove(temp_file);
-    }
-    else
-    {
-        LL_WARNS(LOG_INV) << "Unable to compress " << temp_file << " into " << gzip_filename << LL_ENDL;
-    }
+    saveToFile(gzip_filename, categories, items);
 }
 
 
@@ -2702,37 +2771,36 @@ bool LLInventoryModel::loadSkeleton(
         const S32 NO_VERSION = LLViewerInventoryCategory::VERSION_UNKNOWN;
         std::string gzip_filename(inventory_filename);
         gzip_filename.append(".gz");
-        LLFILE* fp = LLFile::fopen(gzip_filename, "rb");
+        // The cache is read straight out of the gzipped file, nothing gets
+        // unpacked to disk anymore. An uncompressed cache left over by older
+        // viewers reads just the same.
         bool remove_inventory_file = false;
-        if (LLAppViewer::instance()->isSecondInstance())
+        if (LLFile::isfile(gzip_filename))
         {
-            // Safeguard viewer against trying to unpack file twice
-            // ex: user logs into two accounts simultaneously, so two
-            // viewers are trying to unpack library into same file
-            //
-            // Would be better to do it in gunzip_file, but it doesn't
-            // have access to llfilesystem
-            inventory_filename = gDirUtilp->getTempFilename();
-            remove_inventory_file = true;
+            // a leftover uncompressed cache is older than this one
+            remove_inventory_file = !LLAppViewer::instance()->isSecondInstance() && LLFile::isfile(inventory_filename);
+            inventory_filename = gzip_filename;
+        }
+        bool is_cache_obsolete = false;
+        bool cache_loaded = false;
+        preloaded_caches_t::iterator preloaded = sPreloadedCaches.find(owner_id);
+        if (preloaded != sPreloadedCaches.end()
+            && preloaded->second->mDone
+            && preloaded->second->mFilename == inventory_filename)
+        {
+            PreloadedCache& preload = *preloaded->second;
+            categories.swap(preload.mCategories);
+            items.swap(preload.mItems);
+            categories_to_update.swap(preload.mCatsToUpdate);
+            is_cache_obsolete = preload.mIsCacheObsolete;
+            cache_loaded = preload.mLoaded;
+            LL_INFOS(LOG_INV) << "using inventory preloaded from: (" << inventory_filename << ")" << LL_ENDL;
         }
-        if(fp)
+        else
         {
-            fclose(fp);
-            fp = NULL;
-            if(gunzip_file(gzip_filename, inventory_filename))
-            {
-                // we only want to remove the inventory file if it was
-                // gzipped before we loaded, and we successfully
-                // gunziped it.
-                remove_inventory_file = true;
-            }
-            else
-            {
-                LL_INFOS(LOG_INV) << "Unable to gunzip " << gzip_filename << LL_ENDL;
-            }
+            cache_loaded = loadFromFile(inventory_filename, categories, items, categories_to_update, is_cache_obsolete);
         }
-        bool is_cache_obsolete = false;
-        if (loadFromFile(inventory_filename, categories, items, categories_to_update, is_cache_obsolete))
+        if (cache_loaded)
         {
             // We were able to find a cache of files. So, use what we
             // found to generate a set of categories we should add. We
@@ -2918,8 +2986,8 @@ bool LLInventoryModel::loadSkeleton(
 
         if(remove_inventory_file)
         {
-            // clean up the gunzipped file.
-            LLFile::remove(inventory_filename);
+            // clean up the uncompressed file.
+            LLFile::remove(getInvCacheAddres(owner_id));
         }
         if(is_cache_obsolete && !LLAppViewer::instance()->isSecondInstance())
         {
@@ -2930,6 +2998,9 @@ bool LLInventoryModel::loadSkeleton(
         categories.clear(); // will unref and delete entries
     }
 
+    // done with it, or the skeleton didn't need it
+    sPreloadedCaches.erase(owner_id);
+
     LL_INFOS(LOG_INV) << "Successfully loaded " << cached_category_count
                       << " categories and " << cached_item_count << " items from cache."
                       << LL_ENDL;
@@ -2937,6 +3008,68 @@ bool LLInventoryModel::loadSkeleton(
     return rv;
 }
 
+// static
+void LLInventoryModel::preloadCache(const LLUUID& owner_id)
+{
+    if (owner_id.isNull())
+    {
+        return;
+    }
+
+    // same pick as loadSkeleton()
+    std::string filename = getInvCacheAddres(owner_id);
+    std::string gzip_filename(filename);
+    gzip_filename.append(".gz");
+    if (LLFile::isfile(gzip_filename))
+    {
+        filename = gzip_filename;
+    }
+    else if (!LLFile::isfile(filename))
+    {
+        return;
+    }
+
+    std::shared_ptr<PreloadedCache> preload = std::make_shared<PreloadedCache>();
+    preload->mFilename = filename;
+
+    LL::WorkQueue::ptr_t main_queue = LL::WorkQueue::getInstance("mainloop");
+    LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+    bool posted = main_queue && general_queue && main_queue->postTo(
+        general_queue,
+        [preload]() // Work done on general queue
+        {
+            // Everything read is new and only seen by this thread until
+            // the callback hands it over.
+            preload->mLoaded = loadFromFile(preload->mFilename,
+                                            preload->mCategories,
+                                            preload->mItems,
+                                            preload->mCatsToUpdate,
+                                            preload->mIsCacheObsolete);
+        },
+        [preload]() // Callback to main thread
+        {
+            preload->mDone = true;
+        });
+    if (posted)
+    {
+        LL_INFOS(LOG_INV) << "preloading inventory from: (" << filename << ")" << LL_ENDL;
+        sPreloadedCaches[owner_id] = preload;
+    }
+}
+
+// static
+bool LLInventoryModel::isPreloadingCache()
+{
+    for (const preloaded_caches_t::value_type& preloaded : sPreloadedCaches)
+    {
+        if (!preloaded.second->mDone)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 // This is a brute force method to rebuild the entire parent-child
 // relations. The overall operation has O(NlogN) performance, which
 // should be sufficient for our needs.
@@ -3322,6 +3455,129 @@ bool LLUUIDAndName::operator>(const LLUUIDAndName& rhs) const
     return (mID > rhs.mID);
 }
 
+namespace
+{
+    // Takes each line of the inventory cache apart into the fields of its
+    // map, the nested ones like permissions built as LLSD, so that items can
+    // be made from them without an LLSD map for every item in between.
+    class InventoryCacheVisitor : public LLSDVisitor
+    {
+    public:
+        void clear()
+        {
+            mFields.clear();
+            mKey.clear();
+            mDepth = 0;
+        }
+
+        const LLInventoryItem::llsd_fields_t& getFields() const { return mFields; }
+
+        const LLSD* find(const std::string& key) const
+        {
+            for (const auto& field : mFields)
+            {
+                if (field.first == key)
+                {
+                    return &field.second;
+                }
+            }
+            return NULL;
+        }
+
+        LLSD asLLSD() const
+        {
+            LLSD sd = LLSD::emptyMap();
+            for (const auto& field : mFields)
+            {
+                sd.insert(field.first, field.second);
+            }
+            return sd;
+        }
+
+        void beginMap() override { begin(true); }
+        void beginArray() override { begin(false); }
+        void endMap() override { end(true); }
+        void endArray() override { end(false); }
+
+        void key(const std::string& name) override
+        {
+            if (mDepth == 1)
+            {
+                mKey = name;
+            }
+            else
+            {
+                mNested.key(name);
+            }
+        }
+
+        void value(const LLSD& value) override
+        {
+            if (mDepth == 1 && mRecord)
+            {
+                mFields.emplace_back(mKey, value);
+            }
+            else if (mDepth > 1)
+            {
+                mNested.value(value);
+            }
+        }
+
+    private:
+        void begin(bool map)
+        {
+            if (mDepth == 0)
+            {
+                // lines that aren't maps have nothing for us
+                mRecord = map;
+            }
+            else if (mDepth == 1)
+            {
+                mNested.clear();
+            }
+            if (mDepth >= 1)
+            {
+                map ? mNested.beginMap() : mNested.beginArray();
+            }
+            ++mDepth;
+        }
+
+        void end(bool map)
+        {
+            --mDepth;
+            if (mDepth >= 1)
+            {
+                map ? mNested.endMap() : mNested.endArray();
+            }
+            if (mDepth == 1 && mRecord)
+            {
+                mFields.emplace_back(mKey, mNested.get());
+            }
+        }
+
+        LLInventoryItem::llsd_fields_t mFields;
+        std::string mKey;
+        LLSDTreeBuilder mNested;
+        S32 mDepth = 0;
+        bool mRecord = false;
+    };
+}
+
+namespace
+{
+    const S32 INVENTORY_CACHE_BUFFER_SIZE = 256 * 1024;
+
+    gzFile open_inventory_cache(const std::string& filename, const char* mode)
+    {
+#ifdef LL_WINDOWS
+        llutf16string utf16filename = utf8str_to_utf16str(filename);
+        return gzopen_w(utf16filename.c_str(), mode);
+#else
+        return gzopen(filename.c_str(), mode);
+#endif
+    }
+}
+
 // static
 bool LLInventoryModel::loadFromFile(const std::string& filename,
                                     LLInventoryModel::cat_array_t& categories,
@@ -3338,62 +3594,75 @@ bool LLInventoryModel::loadFromFile(const std::string& filename,
     }
     LL_INFOS(LOG_INV) << "loading inventory from: (" << filename << ")" << LL_ENDL;
 
-    llifstream file(filename.c_str());
-
-    if (!file.is_open())
+    // gzread() passes files that aren't gzipped through as they are
+    gzFile file = open_inventory_cache(filename, "rb");
+    if (!file)
     {
         LL_INFOS(LOG_INV) << "unable to load inventory from: " << filename << LL_ENDL;
         return false;
     }
+    gzbuffer(file, INVENTORY_CACHE_BUFFER_SIZE);
 
     is_cache_obsolete = true; // Obsolete until proven current
 
-    //U64 lines_count = 0U;
-    std::string line;
     LLPointer<LLSDParser> parser = new LLSDNotationParser();
-    while (std::getline(file, line))
+    // every line is turned into an item or category and dropped
+    parser->setUseArena(true);
+    InventoryCacheVisitor fields;
+    //U64 lines_count = 0U;
+    // false to stop reading
+    auto parse_line = [&](const char* line, size_t length)
     {
-        LLSD s_item;
-        std::istringstream iss(line);
-        if (parser->parse(iss, s_item, line.length()) == LLSDParser::PARSE_FAILURE)
+        if (length && line[length - 1] == '\r')
+        {   // written in text mode on Windows
+            --length;
+        }
+        if (!length)
+        {
+            return true;
+        }
+
+        fields.clear();
+        if (parser->visitBuffer(line, length, fields) == LLSDParser::PARSE_FAILURE)
         {
             LL_WARNS(LOG_INV)<< "Parsing inventory cache failed" << LL_ENDL;
-            break;
+            return false;
         }
 
-        if (s_item.has("inv_cache_version"))
+        if (const LLSD* cache_version = fields.find("inv_cache_version"))
         {
-            S32 version = s_item["inv_cache_version"].asInteger();
+            S32 version = cache_version->asInteger();
             if (version == sCurrentInvCacheVersion)
             {
                 // Cache is up to date
                 is_cache_obsolete = false;
-                continue;
+                return true;
             }
             else
             {
                 LL_WARNS(LOG_INV)<< "Inventory cache is out of date" << LL_ENDL;
-                break;
+                return false;
             }
         }
-        else if (s_item.has("cat_id"))
+        else if (fields.find("cat_id"))
         {
             if (is_cache_obsolete)
-                break;
+                return false;
 
+            // far fewer than items, so these still go through a map
             LLPointer<LLViewerInventoryCategory> inv_cat = new LLViewerInventoryCategory(LLUUID::null);
-            if(inv_cat->importLLSD(s_item))
+            if(inv_cat->importLLSD(fields.asLLSD()))
             {
                 categories.push_back(inv_cat);
             }
         }
-        else if (s_item.has("item_id"))
+        else if (fields.find("item_id"))
         {
             if (is_cache_obsolete)
-                break;
+                return false;
 
             LLPointer<LLViewerInventoryItem> inv_item = new LLViewerInventoryItem;
-            if( inv_item->fromLLSD(s_item) )
+            if( inv_item->fromLLSD(fields.getFields()) )
             {
                 if(inv_item->getUUID().isNull())
                 {
@@ -3421,9 +3690,55 @@ bool LLInventoryModel::loadFromFile(const std::string& filename,
 //          // SL-19968 - make sure message system code gets a chance to run every so often
 //          pump_idle_startup_network();
 //      }
+        return true;
+    };
+
+    // Lines are parsed where they sit in the read buffer, only those that
+    // straddle two reads get copied.
+    std::vector<char> buffer(INVENTORY_CACHE_BUFFER_SIZE);
+    std::string straddling;
+    bool reading = true;
+    int bytes;
+    while (reading && (bytes = gzread(file, buffer.data(), (unsigned)buffer.size())) > 0)
+    {
+        const char* start = buffer.data();
+        const char* end = start + bytes;
+        while (start < end)
+        {
+            const char* eol = (const char*)memchr(start, '\n', end - start);
+            if (!eol)
+            {
+                straddling.append(start, end);
+                break;
+            }
+            if (straddling.empty())
+            {
+                reading = parse_line(start, eol - start);
+            }
+            else
+            {
+                straddling.append(start, eol);
+                reading = parse_line(straddling.data(), straddling.size());
+                straddling.clear();
+            }
+            if (!reading)
+            {
+                break;
+            }
+            start = eol + 1;
+        }
+    }
+    if (reading && bytes < 0)
+    {
+        LL_WARNS(LOG_INV) << "Failed to read inventory cache: " << gzerror(file, NULL) << LL_ENDL;
+        is_cache_obsolete = true;
+    }
+    else if (reading && !straddling.empty())
+    {
+        parse_line(straddling.data(), straddling.size());
     }
 
-    file.close();
+    gzclose(file);
 
     return !is_cache_obsolete;
 }
@@ -3441,67 +3756,93 @@ bool LLInventoryModel::saveToFile(const std::string& filename,
 
     LL_INFOS(LOG_INV) << "saving inventory to: (" << filename << ")" << LL_ENDL;
 
+    // Compressed as it is written, into a temporary file to avoid potential
+    // conflicts with other instances, which is then moved into place
+    std::string tmpfile = filename + ".t";
+    gzFile file = open_inventory_cache(tmpfile, "wb1"); // fastest compression
+    if (!file)
+    {
+        LL_WARNS(LOG_INV) << "Failed to open file. Unable to save inventory to: " << filename << LL_ENDL;
+        return false;
+    }
+    gzbuffer(file, INVENTORY_CACHE_BUFFER_SIZE);
+
+    bool success = true;
     try
     {
-        llofstream fileXML(filename.c_str());
-        if (!fileXML.is_open())
+        std::ostringstream line;
+        auto write_line = [&](const LLSD& sd)
         {
-            LL_WARNS(LOG_INV) << "Failed to open file. Unable to save inventory to: " << filename << LL_ENDL;
-            return false;
-        }
+            line.str(LLStringUtil::null);
+            line << LLSDOStreamer<LLSDNotationFormatter>(sd) << '\n';
+            const std::string& str = line.str();
+            return gzwrite(file, str.data(), (unsigned)str.size()) > 0;
+        };
 
         LLSD cache_ver;
         cache_ver["inv_cache_version"] = sCurrentInvCacheVersion;
 
-        if (fileXML.fail())
+        if (!write_line(cache_ver))
         {
             LL_WARNS(LOG_INV) << "Failed to write cache version to file. Unable to save inventory to: " << filename << LL_ENDL;
-            return false;
+            success = false;
         }
 
-        fileXML << LLSDOStreamer<LLSDNotationFormatter>(cache_ver) << std::endl;
-
         S32 cat_count = 0;
-        for (auto& cat : categories)
+        for (auto it = categories.begin(); success && it != categories.end(); ++it)
         {
+            const LLPointer<LLViewerInventoryCategory>& cat = *it;
             if (cat->getVersion() != LLViewerInventoryCategory::VERSION_UNKNOWN)
             {
-                fileXML << LLSDOStreamer<LLSDNotationFormatter>(cat->exportLLSD()) << std::endl;
+                if (!write_line(cat->exportLLSD()))
+                {
+                    LL_WARNS(LOG_INV) << "Failed to write a folder to file. Unable to save inventory to: " << filename << LL_ENDL;
+                    success = false;
+                }
                 cat_count++;
             }
-
-            if (fileXML.fail())
-            {
-                LL_WARNS(LOG_INV) << "Failed to write a folder to file. Unable to save inventory to: " << filename << LL_ENDL;
-                return false;
-            }
         }
 
         auto it_count = items.size();
-        for (auto& item : items)
+        for (auto it = items.begin(); success && it != items.end(); ++it)
         {
-            fileXML << LLSDOStreamer<LLSDNotationFormatter>(item->asLLSD()) << std::endl;
-
-            if (fileXML.fail())
+            if (!write_line((*it)->asLLSD()))
             {
                 LL_WARNS(LOG_INV) << "Failed to write an item to file. Unable to save inventory to: " << filename << LL_ENDL;
-                return false;
+                success = false;
             }
         }
-        fileXML.flush();
-
-        fileXML.close();
 
-        LL_INFOS(LOG_INV) << "Inventory saved: " << cat_count << " categories, " << it_count << " items." << LL_ENDL;
+        if (success)
+        {
+            LL_INFOS(LOG_INV) << "Inventory saved: " << cat_count << " categories, " << it_count << " items." << LL_ENDL;
+        }
     }
     catch (...)
     {
         LOG_UNHANDLED_EXCEPTION("");
         LL_INFOS(LOG_INV) << "Failed to save inventory to: (" << filename << ")" << LL_ENDL;
-        return false;
+        success = false;
     }
 
-    return true;
+    if (gzclose(file) != Z_OK)
+    {
+        LL_WARNS(LOG_INV) << "Failed to finish writing. Unable to save inventory to: " << filename << LL_ENDL;
+        success = false;
+    }
+    if (success)
+    {
+#if LL_WINDOWS
+        // Rename in windows needs the filename to not exist.
+        LLFile::remove(filename, ENOENT);
+#endif
+        success = LLFile::rename(tmpfile, filename) == 0;
+    }
+    if (!success)
+    {
+        LLFile::remove(tmpfile, ENOENT);
+    }
+    return success;
 }
 
 // message handling functionality
@@ -36,6 +36,7 @@
 #include "llfoldertype.h"
 #include "llframetimer.h"
 #include "lluuid.h"
+#include "lluuidhashmap.h"
 #include "llpermissionsflags.h"
 #include "llviewerinventory.h"
 #include "llstring.h"
@@ -193,6 +194,11 @@ public:
     void createCommonSystemCategories();
 
     static std::string getInvCacheAddres(const LLUUID& owner_id);
+    // Start reading the inventory cache of owner_id on the general queue,
+    // loadSkeleton() uses what was read instead of reading it again.
+    static void preloadCache(const LLUUID& owner_id);
+    // Some preloaded cache isn't read yet
+    static bool isPreloadingCache();
 
     // Call on logout to save a terse representation.
     void cache(const LLUUID& parent_folder_id, const LLUUID& agent_id);
@@ -201,14 +207,15 @@ private:
     // information in a lot of different ways so we can access
     // the inventory using several different identifiers.
     // mInventory member data is the 'master' list of inventory, and
-    // mCategoryMap and mItemMap store uuid->object mappings.
-    typedef std::map<LLUUID, LLPointer<LLViewerInventoryCategory> > cat_map_t;
-    typedef std::map<LLUUID, LLPointer<LLViewerInventoryItem> > item_map_t;
+    // mCategoryMap and mItemMap store uuid->object mappings. None of
+    // these indices are ordered.
+    typedef LLUUIDHashMap<LLPointer<LLViewerInventoryCategory> > cat_map_t;
+    typedef LLUUIDHashMap<LLPointer<LLViewerInventoryItem> > item_map_t;
     cat_map_t mCategoryMap;
     item_map_t mItemMap;
     // This last set of indices is used to map parents to children.
-    typedef std::map<LLUUID, cat_array_t*> parent_cat_map_t;
-    typedef std::map<LLUUID, item_array_t*> parent_item_map_t;
+    typedef LLUUIDHashMap<cat_array_t*> parent_cat_map_t;
+    typedef LLUUIDHashMap<item_array_t*> parent_item_map_t;
     parent_cat_map_t mParentChildCategoryTree;
     parent_item_map_t mParentChildItemTree;
 
@@ -571,9 +578,15 @@ public:
 
     const changed_items_t& getChangedIDs() const { return mChangedItemIDs; }
     const changed_items_t& getAddedIDs() const { return mAddedItemIDs; }
+    // Whether the pending notification touches this category itself or its
+    // direct contents, so that observers watching a few folders can skip the
+    // rest without rescanning them.
+    bool isCategoryChanged(const LLUUID& cat_id) const;
 protected:
     // Updates all linked items pointing to this id.
     void addChangedMaskForLinks(const LLUUID& object_id, U32 mask);
+    // Records a category whose contents changed
+    void addChangedCategory(const LLUUID& cat_id);
 private:
     // Flag set when notifyObservers is being called, to look for bugs
     // where it's called recursively.
@@ -582,10 +595,14 @@ private:
     U32 mModifyMask;
     changed_items_t mChangedItemIDs;
     changed_items_t mAddedItemIDs;
+    changed_items_t mChangedCategoryIDs;
+    bool mAnyCategoryChanged; // a change came without a referent
     // Fallback when notifyObservers is in progress
     U32 mModifyMaskBacklog;
     changed_items_t mChangedItemIDsBacklog;
     changed_items_t mAddedItemIDsBacklog;
+    changed_items_t mChangedCategoryIDsBacklog;
+    bool mAnyCategoryChangedBacklog;
     typedef std::map<LLUUID , changed_items_t> broken_links_t;
     broken_links_t mPossiblyBrockenLinks; // there can be multiple links per item
     changed_items_t mLinksRebuildList;
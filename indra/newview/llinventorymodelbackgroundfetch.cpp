@@ -180,6 +180,13 @@ private:
 
 const char* const LOG_INV("Inventory");
 
+// AIS fetch concurrency, see onAISFetchResponse()
+const F32 AIS_FETCH_WINDOW_START = 8.f;
+const F32 AIS_FETCH_WINDOW_MIN = 2.f;
+// responses this many times slower than the quickest we've seen mean AIS is queueing
+const F64 AIS_FETCH_CONGESTED_LATENCY = 4.0;
+const F64 AIS_FETCH_LATENCY_SMOOTHING = 0.2;
+
 } // end of namespace anonymous
 
 
@@ -193,6 +200,10 @@ LLInventoryModelBackgroundFetch::LLInventoryModelBackgroundFetch():
     mFetchCount(0),
     mLastFetchCount(0),
     mFetchFolderCount(0),
+    mAISFetchWindow(AIS_FETCH_WINDOW_START),
+    mAISLatency(0.0),
+    mAISLatencyFloor(0.0),
+    mAISLastBackoff(0.0),
     mAllRecursiveFoldersFetched(false),
     mRecursiveInventoryFetchStarted(false),
     mRecursiveLibraryFetchStarted(false),
@@ -577,6 +588,40 @@ void ais_simple_item_callback(const LLUUID& inv_id)
     LLInventoryModelBackgroundFetch::instance().incrFetchCount(-1);
 }
 
+void LLInventoryModelBackgroundFetch::onAISFetchResponse(F64 request_time, bool success)
+{
+    F64 now = LLTimer::getTotalSeconds();
+    F64 latency = now - request_time;
+    mAISLatency = mAISLatency > 0.0 ? mAISLatency + (latency - mAISLatency) * AIS_FETCH_LATENCY_SMOOTHING : latency;
+    if (mAISLatencyFloor <= 0.0 || mAISLatency < mAISLatencyFloor)
+    {
+        mAISLatencyFloor = mAISLatency;
+    }
+
+    static LLCachedControl<U32> ais_pool(gSavedSettings, "PoolSizeAIS", 20);
+    const F32 max_window = (F32)llclamp(ais_pool - 1, 1, 50);
+
+    bool congested = !success || mAISLatency > mAISLatencyFloor * AIS_FETCH_CONGESTED_LATENCY;
+    if (congested)
+    {
+        // Back off once per round trip, the requests already in flight
+        // will report the same congestion
+        if (now - mAISLastBackoff > mAISLatency)
+        {
+            mAISFetchWindow = llmax(mAISFetchWindow * 0.5f, AIS_FETCH_WINDOW_MIN);
+            mAISLastBackoff = now;
+            LL_DEBUGS(LOG_INV, "AIS3") << (success ? "Slow" : "Failed") << " fetch response, latency " << latency
+                << "s, smoothed " << mAISLatency << "s, floor " << mAISLatencyFloor << "s. Fetch window: "
+                << mAISFetchWindow << LL_ENDL;
+        }
+    }
+    else
+    {
+        // about one more request per window's worth of good responses
+        mAISFetchWindow = llmin(mAISFetchWindow + 1.f / mAISFetchWindow, max_window);
+    }
+}
+
 void LLInventoryModelBackgroundFetch::onAISContentCalback(
     const LLUUID& request_id,
     const uuid_vec_t& content_ids,
@@ -749,7 +794,8 @@ void LLInventoryModelBackgroundFetch::bulkFetchViaAis()
     static LLCachedControl<U32> ais_pool(gSavedSettings, "PoolSizeAIS", 20);
     // Don't have too many requests at once, AIS throttles
     // Reserve one request for actions outside of fetch (like renames)
-    const U32 max_concurrent_fetches = llclamp(ais_pool - 1, 1, 50);
+    // and otherwise go by how well AIS has been keeping up
+    const U32 max_concurrent_fetches = llclamp((U32)mAISFetchWindow, 1U, llclamp(ais_pool - 1, 1U, 50U));
 
     if ((U32)mFetchCount >= max_concurrent_fetches)
     {
@@ -921,9 +967,12 @@ void LLInventoryModelBackgroundFetch::bulkFetchViaAis(const FetchQueueInfo& fetc
 
                         EFetchType type = fetch_info.mFetchType;
                         LLUUID cat_id = cat->getUUID(); // need a copy for lambda
-                        AISAPI::completion_t cb = [cat_id, children, type](const LLUUID& response_id)
+                        F64 request_time = LLTimer::getTotalSeconds();
+                        AISAPI::completion_t cb = [cat_id, children, type, request_time](const LLUUID& response_id)
                         {
-                            LLInventoryModelBackgroundFetch::instance().onAISContentCalback(cat_id, children, response_id, type);
+                            LLInventoryModelBackgroundFetch& fetcher = LLInventoryModelBackgroundFetch::instance();
+                            fetcher.onAISFetchResponse(request_time, response_id.notNull());
+                            fetcher.onAISContentCalback(cat_id, children, response_id, type);
                         };
 
                         AISAPI::ITEM_TYPE item_type = AISAPI::INVENTORY;
@@ -975,9 +1024,12 @@ void LLInventoryModelBackgroundFetch::bulkFetchViaAis(const FetchQueueInfo& fetc
 
                         EFetchType type = fetch_info.mFetchType;
                         LLUUID cat_cb_id = cat_id;
-                        AISAPI::completion_t cb = [cat_cb_id, type](const LLUUID& response_id)
+                        F64 request_time = LLTimer::getTotalSeconds();
+                        AISAPI::completion_t cb = [cat_cb_id, type, request_time](const LLUUID& response_id)
                         {
-                            LLInventoryModelBackgroundFetch::instance().onAISFolderCalback(cat_cb_id, response_id , type);
+                            LLInventoryModelBackgroundFetch& fetcher = LLInventoryModelBackgroundFetch::instance();
+                            fetcher.onAISFetchResponse(request_time, response_id.notNull());
+                            fetcher.onAISFolderCalback(cat_cb_id, response_id , type);
                         };
 
                         AISAPI::ITEM_TYPE item_type = AISAPI::INVENTORY;
@@ -112,6 +112,7 @@ protected:
     void onAISFolderCalback(const LLUUID& request_id, const LLUUID& response_id, EFetchType fetch_type);
     void bulkFetchViaAis();
     void bulkFetchViaAis(const FetchQueueInfo& fetch_info);
+    void onAISFetchResponse(F64 request_time, bool success);
     void bulkFetch();
 
     void backgroundFetch();
@@ -133,6 +134,14 @@ private:
     S32 mLastFetchCount; // for debug
     S32 mFetchFolderCount;
 
+    // How many AIS fetches to keep in flight. Grows while responses come back
+    // about as fast as they ever did, shrinks when they slow down or fail,
+    // since that is AIS queueing or throttling us.
+    F32 mAISFetchWindow;
+    F64 mAISLatency;        // smoothed response time
+    F64 mAISLatencyFloor;   // lowest smoothed response time seen
+    F64 mAISLastBackoff;
+
     LLFrameTimer mFetchTimer;
     F32 mMinTimeBetweenFetches;
     fetch_queue_t mFetchFolderQueue;
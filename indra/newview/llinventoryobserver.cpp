@@ -730,8 +730,9 @@ void LLInventoryCategoriesObserver::changed(U32 mask)
 
         // If any item names have changed, update the name hash
         // Only need to check if (a) name hash has not previously been
-        // computed, or (b) a name has changed.
-        if (!cat_data.mIsNameHashInitialized || (mask & LLInventoryObserver::LABEL))
+        // computed, or (b) a name in this category has changed.
+        if (!cat_data.mIsNameHashInitialized
+            || ((mask & LLInventoryObserver::LABEL) && gInventory.isCategoryChanged(cat_id)))
         {
             digest_t item_name_hash = gInventory.hashDirectDescendentNames(cat_id);
             if (cat_data.mItemNameHash != item_name_hash)
@@ -65,6 +65,9 @@ public:
     LLInventoryObserver();
     virtual ~LLInventoryObserver();
     virtual void changed(U32 mask) = 0;
+    // changed() is only called when the notification's mask shares a bit
+    // with this one.
+    virtual U32 getInterestMask() const { return ALL; }
 };
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -170,6 +173,7 @@ class LLInventoryAddItemByAssetObserver : public LLInventoryObserver
 public:
     LLInventoryAddItemByAssetObserver() : mIsDirty(false) {}
     virtual void changed(U32 mask);
+    virtual U32 getInterestMask() const { return ADD; }
 
     void watchAsset(const LLUUID& asset_id);
     bool isAssetWatched(const LLUUID& asset_id);
@@ -197,6 +201,7 @@ class LLInventoryAddedObserver : public LLInventoryObserver
 public:
     LLInventoryAddedObserver() {}
     /*virtual*/ void changed(U32 mask);
+    /*virtual*/ U32 getInterestMask() const { return ADD; }
 
 protected:
     virtual void done() = 0;
@@ -217,6 +222,7 @@ public:
 
     LLInventoryCategoryAddedObserver() : mAddedCategories() {}
     /*virtual*/ void changed(U32 mask);
+    /*virtual*/ U32 getInterestMask() const { return ADD; }
 
 protected:
     virtual void done() = 0;
@@ -308,6 +314,7 @@ public:
     {
     }
     /* virtual */ void changed(U32 mask);
+    /* virtual */ U32 getInterestMask() const { return LABEL; }
 };
 
 
@@ -163,9 +163,15 @@ LLInventoryPanel::LLInventoryPanel(const LLInventoryPanel::Params& p) :
     mGroupedItemBridge(new LLFolderViewGroupedItemBridge),
     mFocusSelection(false),
     mBuildChildrenViews(true),
-    mRootInited(false)
+    mRootInited(false),
+    mBuildViewsOnOpen(p.build_views_on_open && gSavedSettings.getBOOL("InventoryBuildViewsOnOpen")),
+    mOpenAllWhenBuilt(false)
 {
     mInvFVBridgeBuilder = &INVENTORY_BRIDGE_BUILDER;
+    if (mBuildViewsOnOpen)
+    {
+        mBuildChildrenViews = false;
+    }
 
     if (!sColorSetInitialized)
     {
@@ -842,6 +848,14 @@ void LLInventoryPanel::idle(void* user_data)
 
     bool in_visible_chain = panel->isInVisibleChain();
 
+    // a filter can only find what has views
+    if (panel->mBuildViewsOnOpen
+        && !panel->mBuildChildrenViews
+        && panel->getFilter().isNotDefault())
+    {
+        panel->buildAllViews();
+    }
+
     if (!panel->mBuildViewsQueue.empty())
     {
         const F64 max_time = in_visible_chain ? 0.006f : 0.001f; // 6 ms
@@ -880,6 +894,11 @@ void LLInventoryPanel::idle(void* user_data)
         if (panel->mBuildViewsQueue.empty())
         {
             panel->mViewsInitialized = VIEWS_INITIALIZED;
+            if (panel->mOpenAllWhenBuilt)
+            {
+                panel->mOpenAllWhenBuilt = false;
+                panel->openAllFolders();
+            }
         }
     }
 
@@ -1488,10 +1507,87 @@ bool LLInventoryPanel::addBadge(LLBadge * badge)
 
 void LLInventoryPanel::openAllFolders()
 {
+    if (!mBuildChildrenViews && mBuildViewsOnOpen)
+    {
+        // open whatever gets built too, once it is
+        buildAllViews();
+        mOpenAllWhenBuilt = true;
+    }
     mFolderRoot.get()->setOpenArrangeRecursively(true, LLFolderViewFolder::RECURSE_DOWN);
     mFolderRoot.get()->arrangeAll();
 }
 
+void LLInventoryPanel::buildAllViews()
+{
+    struct UninitedFoldersFunctor : public LLFolderViewFunctor
+    {
+        /*virtual*/ void doFolder(LLFolderViewFolder* folder)
+        {
+            LLFolderViewModelItemInventory* view_model = static_cast<LLFolderViewModelItemInventory*>(folder->getViewModelItem());
+            if (view_model && !folder->areChildrenInited())
+            {
+                mFolderIDs.push_back(view_model->getUUID());
+            }
+        }
+        /*virtual*/ void doItem(LLFolderViewItem* item) {}
+
+        uuid_vec_t mFolderIDs;
+    };
+
+    mBuildChildrenViews = true;
+    LLFolderView* root = mFolderRoot.get();
+    if (!root)
+    {
+        return;
+    }
+
+    UninitedFoldersFunctor functor;
+    root->applyFunctorRecursively(functor);
+    // the functor goes top down and the queue is processed from the back,
+    // so push in reverse to build closer to root first
+    mBuildViewsQueue.insert(mBuildViewsQueue.end(), functor.mFolderIDs.rbegin(), functor.mFolderIDs.rend());
+    if (!mBuildViewsQueue.empty() && mViewsInitialized == VIEWS_INITIALIZED)
+    {
+        mViewsInitialized = VIEWS_BUILDING;
+    }
+}
+
+void LLInventoryPanel::buildViewsToItem(const LLUUID& obj_id)
+{
+    // find the ancestors that have no views yet
+    uuid_vec_t missing;
+    LLUUID id = obj_id;
+    while (id.notNull() && !getItemByID(id))
+    {
+        const LLInventoryObject* objectp = mInventory->getObject(id);
+        if (!objectp)
+        {
+            return;
+        }
+        id = objectp->getParentUUID();
+        missing.push_back(id);
+    }
+    if (id.isNull())
+    {
+        // not under this panel's root
+        return;
+    }
+
+    // missing.back() has a view, build down from there
+    for (uuid_vec_t::reverse_iterator it = missing.rbegin(); it != missing.rend(); ++it)
+    {
+        LLFolderViewItem* view_item = getItemByID(*it);
+        if (!view_item)
+        {
+            break;
+        }
+        if (!view_item->areChildrenInited())
+        {
+            buildNewViews(*it, mInventory->getObject(*it), view_item, BUILD_ONE_FOLDER);
+        }
+    }
+}
+
 void LLInventoryPanel::setSelection(const LLUUID& obj_id, bool take_keyboard_focus)
 {
     // Don't select objects in COF (e.g. to prevent refocus when items are worn).
@@ -2077,6 +2173,11 @@ void LLInventoryPanel::setSelectionByID( const LLUUID& obj_id, bool    take_keyb
     }
     else
     {
+        if (!itemp && mBuildViewsOnOpen && !mBuildChildrenViews)
+        {
+            // the view may exist next time
+            buildViewsToItem(obj_id);
+        }
         // save the desired item to be selected later (if/when ready)
         mFocusSelection = take_keyboard_focus;
         mSelectThisID = obj_id;
@@ -113,6 +113,11 @@ public:
         // Will initialize on visibility change otherwise.
         Optional<bool>                      preinitialize_views;
 
+        // Build a folder's children only when it is first opened, so a large
+        // inventory doesn't create widgets for rows nobody looks at. Everything
+        // gets built once a filter needs to search the whole tree.
+        Optional<bool>                      build_views_on_open;
+
         Params()
         :   sort_order_setting("sort_order_setting"),
             inventory("", &gInventory),
@@ -133,7 +138,8 @@ public:
             folder_view("folder_view"),
             folder("folder"),
             item("item"),
-            preinitialize_views("preinitialize_views", true)
+            preinitialize_views("preinitialize_views", true),
+            build_views_on_open("build_views_on_open", false)
         {}
     };
 
@@ -309,6 +315,8 @@ protected:
 
     bool mBuildChildrenViews; // build root and children
     bool mRootInited;
+    bool mBuildViewsOnOpen; // mBuildChildrenViews is off until something needs the whole tree
+    bool mOpenAllWhenBuilt;
 
 
     //--------------------------------------------------------------------
@@ -382,6 +390,13 @@ private:
                                               const EBuildModes &mode,
                                               S32 depth = -1);
 
+    // Queue every folder that still lacks children views; from then on
+    // views are built the usual way, all of them.
+    void                        buildAllViews();
+    // Build the views of the folders between the closest existing view and
+    // the object, so that the object has one.
+    void                        buildViewsToItem(const LLUUID& obj_id);
+
     typedef enum e_views_initialization_state
     {
         VIEWS_UNINITIALIZED = 0,
@@ -0,0 +1,205 @@
+/**
+ * @file llinventorysearchindex.cpp
+ * @brief Searchable copies of inventory item fields, kept up to date from
+ * inventory changes.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llinventorysearchindex.h"
+
+#include "llagent.h"
+#include "llavatarnamecache.h"
+#include "llinventorymodel.h"
+#include "llviewerinventory.h"
+
+LLInventorySearchIndex::LLInventorySearchIndex() :
+    mGeneration(0),
+    mBuilt(false)
+{
+    gInventory.addObserver(this);
+}
+
+LLInventorySearchIndex::~LLInventorySearchIndex()
+{
+    if (gInventory.containsObserver(this))
+    {
+        gInventory.removeObserver(this);
+    }
+}
+
+void LLInventorySearchIndex::build()
+{
+    LL_PROFILE_ZONE_SCOPED;
+    LLTimer timer;
+
+    mEntries.clear();
+    for (const LLUUID& root_id : { gInventory.getRootFolderID(), gInventory.getLibraryRootFolderID() })
+    {
+        if (root_id.isNull())
+        {
+            continue;
+        }
+        LLInventoryModel::cat_array_t cats;
+        LLInventoryModel::item_array_t items;
+        gInventory.collectDescendents(root_id, cats, items, LLInventoryModel::INCLUDE_TRASH);
+        mEntries.reserve(mEntries.size() + items.size());
+        for (const LLPointer<LLViewerInventoryItem>& item : items)
+        {
+            update(item->getUUID());
+        }
+    }
+    mBuilt = true;
+    ++mGeneration;
+
+    LL_INFOS("Inventory") << "Indexed " << mEntries.size() << " items for search in "
+                          << timer.getElapsedTimeF32() * 1000.f << "ms" << LL_ENDL;
+}
+
+void LLInventorySearchIndex::update(const LLUUID& item_id)
+{
+    const LLViewerInventoryItem* item = gInventory.getItem(item_id);
+    if (!item)
+    {
+        mEntries.erase(item_id);
+        return;
+    }
+
+    Entry& entry = mEntries[item_id];
+    entry.mDescription = item->getDescription();
+    LLStringUtil::toUpper(entry.mDescription);
+    entry.mAssetID = item->getAssetUUID().asString();
+    LLStringUtil::toUpper(entry.mAssetID);
+    entry.mCreatorID = item->getCreatorUUID();
+    entry.mFullPerm = item->getIsFullPerm();
+}
+
+void LLInventorySearchIndex::changed(U32 mask)
+{
+    if (!mBuilt)
+    {
+        // nothing to keep up to date until somebody searches
+        return;
+    }
+    for (const LLUUID& id : gInventory.getChangedIDs())
+    {
+        update(id);
+    }
+    ++mGeneration;
+}
+
+void LLInventorySearchIndex::find(EField field, const std::string& substring, LLUUIDHashSet& matches)
+{
+    LL_PROFILE_ZONE_SCOPED;
+
+    matches.clear();
+    if (!mBuilt)
+    {
+        if (!gInventory.isInventoryUsable())
+        {
+            return;
+        }
+        build();
+    }
+
+    switch (field)
+    {
+        case FIELD_DESCRIPTION:
+        {
+            for (const auto& pair : mEntries)
+            {
+                if (pair.second.mDescription.find(substring) != std::string::npos)
+                {
+                    matches.insert(pair.first);
+                }
+            }
+            break;
+        }
+        case FIELD_CREATOR:
+        {
+            // far fewer creators than items, look each name up only once
+            LLUUIDHashMap<bool> creator_matches;
+            for (const auto& pair : mEntries)
+            {
+                const LLUUID& creator_id = pair.second.mCreatorID;
+                auto found = creator_matches.find(creator_id);
+                if (found == creator_matches.end())
+                {
+                    bool match = false;
+                    LLAvatarName av_name;
+                    if (LLAvatarNameCache::get(creator_id, &av_name))
+                    {
+                        std::string username = av_name.getUserName();
+                        LLStringUtil::toUpper(username);
+                        match = username.find(substring) != std::string::npos;
+                    }
+                    found = creator_matches.emplace(creator_id, match).first;
+                }
+                if (found->second)
+                {
+                    matches.insert(pair.first);
+                }
+            }
+            break;
+        }
+        case FIELD_ASSET_ID:
+        {
+            const bool godlike = gAgent.isGodlikeWithoutAdminMenuFakery();
+            for (const auto& pair : mEntries)
+            {
+                if ((pair.second.mFullPerm || godlike)
+                    && pair.second.mAssetID.find(substring) != std::string::npos)
+                {
+                    matches.insert(pair.first);
+                }
+            }
+            break;
+        }
+    }
+}
+
+LLInventorySearchResults::LLInventorySearchResults() :
+    mField(LLInventorySearchIndex::FIELD_DESCRIPTION),
+    mGeneration(0),
+    mValid(false)
+{
+}
+
+bool LLInventorySearchResults::matches(LLInventorySearchIndex::EField field, const std::string& substring, const LLUUID& item_id)
+{
+    LLInventorySearchIndex& index = LLInventorySearchIndex::instance();
+    if (!mValid
+        || field != mField
+        || substring != mSubString
+        || index.getGeneration() != mGeneration)
+    {
+        index.find(field, substring, mMatches);
+        mField = field;
+        mSubString = substring;
+        // find() may have built the index, or not been able to yet
+        mGeneration = index.getGeneration();
+        mValid = index.isBuilt();
+    }
+    return mMatches.contains(item_id);
+}
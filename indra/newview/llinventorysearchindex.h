@@ -0,0 +1,109 @@
+/**
+ * @file llinventorysearchindex.h
+ * @brief Searchable copies of inventory item fields, kept up to date from
+ * inventory changes.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLINVENTORYSEARCHINDEX_H
+#define LL_LLINVENTORYSEARCHINDEX_H
+
+#include "llinventoryobserver.h"
+#include "llsingleton.h"
+#include "lluuidhashmap.h"
+
+/**
+ * Upper cased descriptions, creators and asset ids of every item in the
+ * inventory, so that a description, creator or UUID search is one pass over
+ * compact strings instead of a model lookup, a copy and an upper casing per
+ * item for every filter pass.
+ *
+ * Names aren't indexed: the bridges already cache their searchable name,
+ * which carries UI suffixes ("worn", "no copy") the model doesn't know about.
+ *
+ * The index is built on the first search and follows the inventory's
+ * changes from then on.
+ */
+class LLInventorySearchIndex : public LLInventoryObserver, public LLSingleton<LLInventorySearchIndex>
+{
+    LLSINGLETON(LLInventorySearchIndex);
+    virtual ~LLInventorySearchIndex();
+
+public:
+    enum EField
+    {
+        FIELD_DESCRIPTION,
+        FIELD_CREATOR,
+        FIELD_ASSET_ID, // full permission items only, as get_searchable_UUID()
+    };
+
+    /// Collect the items whose field contains substring, which is expected
+    /// in upper case already, as LLInventoryFilter keeps it.
+    void find(EField field, const std::string& substring, LLUUIDHashSet& matches);
+
+    /// Changes whenever an entry does, so that callers can tell whether
+    /// their matches are stale.
+    U32 getGeneration() const { return mGeneration; }
+    /// false until the inventory is usable and somebody searched
+    bool isBuilt() const { return mBuilt; }
+
+    void changed(U32 mask) override;
+    U32 getInterestMask() const override { return LABEL | INTERNAL | ADD | REMOVE | REBUILD; }
+
+private:
+    struct Entry
+    {
+        std::string mDescription;
+        std::string mAssetID;
+        LLUUID mCreatorID;
+        bool mFullPerm;
+    };
+
+    void build();
+    void update(const LLUUID& item_id);
+
+    LLUUIDHashMap<Entry> mEntries;
+    U32 mGeneration;
+    bool mBuilt;
+};
+
+/**
+ * The matches of the last search a filter made, redone when the field, the
+ * substring or the index changes.
+ */
+class LLInventorySearchResults
+{
+public:
+    LLInventorySearchResults();
+
+    bool matches(LLInventorySearchIndex::EField field, const std::string& substring, const LLUUID& item_id);
+
+private:
+    LLUUIDHashSet mMatches;
+    std::string mSubString;
+    LLInventorySearchIndex::EField mField;
+    U32 mGeneration;
+    bool mValid;
+};
+
+#endif // LL_LLINVENTORYSEARCHINDEX_H
@@ -0,0 +1,287 @@
+/**
+ * @file lllightclusters.cpp
+ * @brief Bins local lights into view space clusters for single pass deferred lighting.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "lllightclusters.h"
+
+#include "llglslshader.h"
+#include "llimagegl.h"
+#include "llrender.h"
+#include "llshadermgr.h"
+
+static S32 ndc_to_tile(F32 ndc, U32 tiles)
+{
+    S32 tile = (S32)floorf((ndc * 0.5f + 0.5f) * tiles);
+    return llclamp(tile, 0, (S32)tiles - 1);
+}
+
+static void upload_texture(U32& tex, S32 intformat, S32 width, S32 height, U32 pixformat, const F32* data)
+{
+    if (!tex)
+    {
+        LLImageGL::generateTextures(1, &tex);
+    }
+
+    gGL.getTexUnit(0)->bindManual(LLTexUnit::TT_TEXTURE, tex);
+    LLImageGL::setManualImage(LLTexUnit::getInternalType(LLTexUnit::TT_TEXTURE), 0, intformat, width, height, pixformat, GL_FLOAT, data, false);
+    // no mips, or texelFetch would see an incomplete texture
+    gGL.getTexUnit(0)->setTextureFilteringOption(LLTexUnit::TFO_POINT);
+}
+
+static void bind_texture(LLGLSLShader& shader, U32 uniform, U32 tex)
+{
+    S32 channel = shader.enableTexture(uniform);
+    if (channel > -1)
+    {
+        gGL.getTexUnit(channel)->bindManual(LLTexUnit::TT_TEXTURE, tex);
+    }
+}
+
+LLLightClusters::LLLightClusters()
+{
+}
+
+LLLightClusters::~LLLightClusters()
+{
+    release();
+}
+
+void LLLightClusters::clear()
+{
+    mLights.clear();
+}
+
+bool LLLightClusters::addLight(const LLVector4& pos, const LLVector4& col)
+{
+    if (getLightCount() >= MAX_LIGHTS)
+    {
+        return false;
+    }
+
+    mLights.push_back(pos);
+    mLights.push_back(col);
+    return true;
+}
+
+U32 LLLightClusters::getSlice(F32 depth) const
+{
+    if (depth <= mSliceNear)
+    {
+        return 0;
+    }
+
+    U32 slice = 1 + (U32)(logf(depth / mSliceNear) * mSliceScale);
+    return llmin(slice, SLICES - 1);
+}
+
+bool LLLightClusters::computeRange(const LLVector4& pos, const glm::mat4& proj, F32 near_clip, Range& range) const
+{
+    F32 radius = pos.mV[3];
+    F32 depth = -pos.mV[2];
+
+    if (depth + radius <= 0.f)
+    { // entirely behind the camera
+        return false;
+    }
+
+    range.mS0 = getSlice(depth - radius);
+    range.mS1 = getSlice(depth + radius);
+
+    if (depth - radius <= near_clip)
+    { // crosses the near plane, the projected bounds are unbounded
+        range.mX0 = 0;
+        range.mX1 = TILES_X - 1;
+        range.mY0 = 0;
+        range.mY1 = TILES_Y - 1;
+        return true;
+    }
+
+    // every corner of the bounding box is in front of the camera, so the box
+    // of their projections bounds the projection of the sphere
+    F32 min_x = F32_MAX;
+    F32 min_y = F32_MAX;
+    F32 max_x = -F32_MAX;
+    F32 max_y = -F32_MAX;
+
+    for (U32 i = 0; i < 8; ++i)
+    {
+        glm::vec4 corner(pos.mV[0] + ((i & 1) ? radius : -radius),
+                         pos.mV[1] + ((i & 2) ? radius : -radius),
+                         pos.mV[2] + ((i & 4) ? radius : -radius),
+                         1.f);
+        glm::vec4 clip = proj * corner;
+        F32 x = clip.x / clip.w;
+        F32 y = clip.y / clip.w;
+
+        min_x = llmin(min_x, x);
+        min_y = llmin(min_y, y);
+        max_x = llmax(max_x, x);
+        max_y = llmax(max_y, y);
+    }
+
+    if (max_x < -1.f || min_x > 1.f || max_y < -1.f || min_y > 1.f)
+    { // off screen
+        return false;
+    }
+
+    range.mX0 = ndc_to_tile(min_x, TILES_X);
+    range.mX1 = ndc_to_tile(max_x, TILES_X);
+    range.mY0 = ndc_to_tile(min_y, TILES_Y);
+    range.mY1 = ndc_to_tile(max_y, TILES_Y);
+    return true;
+}
+
+void LLLightClusters::build(const glm::mat4& proj, F32 near_clip)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
+
+    U32 light_count = getLightCount();
+    if (light_count == 0)
+    {
+        return;
+    }
+
+    // fit the slices to the lights so none are wasted on empty space
+    mSliceFar = mSliceNear * 2.f;
+    for (U32 i = 0; i < light_count; ++i)
+    {
+        const LLVector4& pos = mLights[i * 2];
+        mSliceFar = llmax(mSliceFar, -pos.mV[2] + pos.mV[3]);
+    }
+    mSliceScale = (SLICES - 1) / logf(mSliceFar / mSliceNear);
+
+    constexpr U32 cluster_count = TILES_X * TILES_Y * SLICES;
+    constexpr U32 slice_stride = TILES_X * TILES_Y;
+
+    std::vector<Range> ranges(light_count);
+    std::vector<bool> visible(light_count);
+    std::vector<U32> counts(cluster_count, 0);
+
+    for (U32 i = 0; i < light_count; ++i)
+    {
+        visible[i] = computeRange(mLights[i * 2], proj, near_clip, ranges[i]);
+        if (!visible[i])
+        {
+            continue;
+        }
+
+        const Range& r = ranges[i];
+        for (U32 s = r.mS0; s <= r.mS1; ++s)
+        {
+            for (U32 y = r.mY0; y <= r.mY1; ++y)
+            {
+                for (U32 x = r.mX0; x <= r.mX1; ++x)
+                {
+                    counts[s * slice_stride + y * TILES_X + x]++;
+                }
+            }
+        }
+    }
+
+    // lay the per cluster lists out back to back, counts becomes the write cursor of each list
+    mGrid.resize(cluster_count * 2);
+    U32 total = 0;
+    bool overflow = false;
+    for (U32 c = 0; c < cluster_count; ++c)
+    {
+        U32 count = llmin(counts[c], MAX_INDICES - total);
+        overflow = overflow || count < counts[c];
+
+        mGrid[c * 2] = (F32)total;
+        mGrid[c * 2 + 1] = (F32)count;
+        counts[c] = total;
+        total += count;
+    }
+
+    if (overflow)
+    {
+        LL_WARNS_ONCE("Pipeline") << "Light cluster index list full, some local lights will be missing" << LL_ENDL;
+    }
+
+    U32 index_rows = llmax((total + INDEX_WIDTH - 1) / INDEX_WIDTH, 1U);
+    mIndices.assign(index_rows * INDEX_WIDTH, 0.f);
+
+    for (U32 i = 0; i < light_count; ++i)
+    {
+        if (!visible[i])
+        {
+            continue;
+        }
+
+        const Range& r = ranges[i];
+        for (U32 s = r.mS0; s <= r.mS1; ++s)
+        {
+            for (U32 y = r.mY0; y <= r.mY1; ++y)
+            {
+                for (U32 x = r.mX0; x <= r.mX1; ++x)
+                {
+                    U32 c = s * slice_stride + y * TILES_X + x;
+                    U32 end = (U32)(mGrid[c * 2] + mGrid[c * 2 + 1]);
+                    if (counts[c] < end)
+                    {
+                        mIndices[counts[c]++] = (F32)i;
+                    }
+                }
+            }
+        }
+    }
+
+    upload_texture(mLightTex, GL_RGBA32F, 2, light_count, GL_RGBA, mLights[0].mV);
+    upload_texture(mGridTex, GL_RG32F, slice_stride, SLICES, GL_RG, mGrid.data());
+    upload_texture(mIndexTex, GL_R32F, INDEX_WIDTH, index_rows, GL_RED, mIndices.data());
+    gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
+}
+
+void LLLightClusters::bind(LLGLSLShader& shader)
+{
+    bind_texture(shader, LLShaderMgr::CLUSTER_LIGHTS, mLightTex);
+    bind_texture(shader, LLShaderMgr::CLUSTER_GRID, mGridTex);
+    bind_texture(shader, LLShaderMgr::CLUSTER_INDEX, mIndexTex);
+    shader.uniform4f(LLShaderMgr::CLUSTER_PARAMS, mSliceNear, mSliceScale, mSliceFar, 0.f);
+}
+
+void LLLightClusters::unbind(LLGLSLShader& shader)
+{
+    shader.disableTexture(LLShaderMgr::CLUSTER_LIGHTS);
+    shader.disableTexture(LLShaderMgr::CLUSTER_GRID);
+    shader.disableTexture(LLShaderMgr::CLUSTER_INDEX);
+}
+
+void LLLightClusters::release()
+{
+    for (U32* tex : { &mLightTex, &mGridTex, &mIndexTex })
+    {
+        if (*tex)
+        {
+            LLImageGL::deleteTextures(1, tex);
+            *tex = 0;
+        }
+    }
+    mLights.clear();
+    mGrid.clear();
+    mIndices.clear();
+}
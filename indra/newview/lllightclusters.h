@@ -0,0 +1,101 @@
+/**
+ * @file lllightclusters.h
+ * @brief Bins local lights into view space clusters for single pass deferred lighting.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLLIGHTCLUSTERS_H
+#define LL_LLLIGHTCLUSTERS_H
+
+#include <vector>
+
+#include "v4math.h"
+#include "glm/mat4x4.hpp"
+
+class LLGLSLShader;
+
+// Divides the view frustum into a grid of screen tiles by exponentially spaced
+// depth slices and records which point lights touch each cell, so a single
+// full screen pass (deferred/clusteredLightF.glsl) can shade every local light
+// while only evaluating the few that can reach a given pixel.
+//
+// The lists are built on the CPU each frame and handed to the shader as float
+// textures read with texelFetch:
+//      clusterLights - 2 x light count, view space position + radius, then linear color + falloff
+//      clusterGrid   - (TILES_X * TILES_Y) x SLICES, offset into clusterIndex + light count
+//      clusterIndex  - INDEX_WIDTH wide, light indices into clusterLights
+class LLLightClusters
+{
+public:
+    static constexpr U32 TILES_X = 16;
+    static constexpr U32 TILES_Y = 8;
+    static constexpr U32 SLICES = 24;
+    static constexpr U32 MAX_LIGHTS = 1024;
+    static constexpr U32 INDEX_WIDTH = 1024;
+    static constexpr U32 MAX_INDICES = INDEX_WIDTH * 256;
+
+    LLLightClusters();
+    ~LLLightClusters();
+
+    void clear();
+
+    // pos is in view space with .w = radius, col is linear with .a = falloff
+    // returns false if no more lights fit, the caller should light it some other way
+    bool addLight(const LLVector4& pos, const LLVector4& col);
+
+    U32 getLightCount() const { return (U32)mLights.size() / 2; }
+
+    // bin the lights into the clusters of the given projection and upload the lists
+    void build(const glm::mat4& proj, F32 near_clip);
+
+    // bind the lists to 'shader', which must be bound
+    void bind(LLGLSLShader& shader);
+    void unbind(LLGLSLShader& shader);
+
+    void release();
+
+private:
+    struct Range
+    {
+        U32 mX0, mX1, mY0, mY1, mS0, mS1;
+    };
+
+    bool computeRange(const LLVector4& pos, const glm::mat4& proj, F32 near_clip, Range& range) const;
+    U32 getSlice(F32 depth) const;
+
+    std::vector<LLVector4> mLights;
+    std::vector<F32> mGrid;
+    std::vector<F32> mIndices;
+
+    U32 mLightTex = 0;
+    U32 mGridTex = 0;
+    U32 mIndexTex = 0;
+
+    // slice 0 runs from the camera to mSliceNear, the rest are spaced
+    // exponentially out to mSliceFar, mSliceScale is (SLICES - 1) / log(far / near)
+    F32 mSliceNear = 1.f;
+    F32 mSliceFar = 2.f;
+    F32 mSliceScale = 1.f;
+};
+
+#endif // LL_LLLIGHTCLUSTERS_H
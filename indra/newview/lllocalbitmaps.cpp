@@ -66,6 +66,8 @@
 #include "llviewercontrol.h"
 #include "lltrans.h"
 #include "llviewerdisplay.h"
+#include "llappviewer.h"
+#include "llimageworker.h"
 
 /*=======================================*/
 /*  Formal declarations, constants, etc. */
@@ -88,6 +90,7 @@ LLLocalBitmap::LLLocalBitmap(std::string filename)
     , mLastModified()
     , mLinkStatus(LS_ON)
     , mUpdateRetries(LL_LOCAL_UPDATE_RETRIES)
+    , mDecodePending(false)
 {
     mTrackingID.generate();
 
@@ -181,7 +184,7 @@ bool LLLocalBitmap::updateSelf(EUpdateType optional_firstupdate)
 {
     bool updated = false;
 
-    if (mLinkStatus == LS_ON)
+    if (mLinkStatus == LS_ON && !mDecodePending)
     {
         // verifying that the file exists
         if (gDirUtilp->fileExists(mFilename))
@@ -197,67 +200,39 @@ bool LLLocalBitmap::updateSelf(EUpdateType optional_firstupdate)
 
             if (mLastModified.asString() != new_last_modified.asString())
             {
-                /* loading the image file and decoding it, here is a critical point which,
-                   if fails, invalidates the whole update (or unit creation) process. */
-                LLPointer<LLImageRaw> raw_image = new LLImageRaw();
-                if (decodeBitmap(raw_image))
+                if (optional_firstupdate == UT_FIRSTUSE)
                 {
-                    // decode is successful, we can safely proceed.
-                    LLUUID old_id = LLUUID::null;
-                    if ((optional_firstupdate != UT_FIRSTUSE) && !mWorldID.isNull())
+                    /* loading the image file and decoding it, here is a critical point which,
+                       if fails, invalidates the whole update (or unit creation) process. */
+                    LLPointer<LLImageRaw> raw_image = new LLImageRaw();
+                    if (decodeBitmap(raw_image))
                     {
-                        old_id = mWorldID;
+                        applyBitmap(raw_image, new_last_modified, optional_firstupdate);
+                        updated = true;
                     }
-                    mWorldID.generate();
-                    mLastModified = new_last_modified;
-
-                    LLPointer<LLViewerFetchedTexture> texture = new LLViewerFetchedTexture
-                        ("file://"+mFilename, FTT_LOCAL_FILE, mWorldID, LL_LOCAL_USE_MIPMAPS);
-
-                    texture->createGLTexture(LL_LOCAL_DISCARD_LEVEL, raw_image);
-                    texture->ref();
-
-                    gTextureList.addImage(texture, TEX_LIST_STANDARD);
-
-                    if (optional_firstupdate != UT_FIRSTUSE)
+                    else
                     {
-                        // seek out everything old_id uses and replace it with mWorldID
-                        replaceIDs(old_id, mWorldID);
-
-                        // remove old_id from gimagelist
-                        LLViewerFetchedTexture* image = gTextureList.findImage(old_id, TEX_LIST_STANDARD);
-                        if (image != NULL)
-                        {
-                            gTextureList.deleteImage(image);
-                            image->unref();
-                        }
+                        decodeFailed();
                     }
-
-                    mUpdateRetries = LL_LOCAL_UPDATE_RETRIES;
-                    updated = true;
                 }
-
-                // if decoding failed, we get here and it will attempt to decode it in the next cycles
-                // until mUpdateRetries runs out. this is done because some software lock the bitmap while writing to it
                 else
                 {
-                    if (mUpdateRetries)
-                    {
-                        mUpdateRetries--;
-                    }
-                    else
+                    // the file is being edited, do not hitch the frame while
+                    // decoding it: the ids are swapped once it is done.
+                    mDecodePending = true;
+                    LLUUID tracking_id = mTrackingID;
+                    LLImageDecodeThread::handle_t handle = LLAppViewer::getImageDecodeThread()->decodeFile(mFilename,
+                        [tracking_id, new_last_modified](const LLPointer<LLImageRaw>& raw, const std::string& error_message)
+                        {
+                            if (LLLocalBitmapMgr::instanceExists())
+                            {
+                                LLLocalBitmapMgr::getInstance()->onBitmapDecoded(tracking_id, raw, new_last_modified);
+                            }
+                        });
+                    if (!handle)
                     {
-                        LL_WARNS() << "During the update process the following file was found" << "\n"
-                                << "but could not be opened or decoded for " << LL_LOCAL_UPDATE_RETRIES << " attempts." << "\n"
-                                << "Filename: " << mFilename << "\n"
-                                << "Disabling further update attempts for this file." << LL_ENDL;
-
-                        LLSD notif_args;
-                        notif_args["FNAME"] = mFilename;
-                        notif_args["NRETRIES"] = LL_LOCAL_UPDATE_RETRIES;
-                        LLNotificationsUtil::add("LocalBitmapsUpdateFailedFinal", notif_args);
-
-                        mLinkStatus = LS_BROKEN;
+                        mDecodePending = false;
+                        decodeFailed();
                     }
                 }
             }
@@ -281,6 +256,87 @@ bool LLLocalBitmap::updateSelf(EUpdateType optional_firstupdate)
     return updated;
 }
 
+void LLLocalBitmap::onBitmapDecoded(LLPointer<LLImageRaw> raw_image, const LLSD& last_modified)
+{
+    mDecodePending = false;
+    if (mLinkStatus != LS_ON)
+    {
+        return;
+    }
+
+    // tga files with neither 3 nor 4 components are rejected, as in decodeBitmap()
+    if (raw_image.notNull()
+        && (mExtension != ET_IMG_TGA || raw_image->getComponents() == 3 || raw_image->getComponents() == 4))
+    {
+        raw_image->biasedScaleToPowerOfTwo(LLViewerFetchedTexture::MAX_IMAGE_SIZE_DEFAULT);
+        applyBitmap(raw_image, last_modified, UT_REGUPDATE);
+    }
+    else
+    {
+        decodeFailed();
+    }
+}
+
+void LLLocalBitmap::applyBitmap(LLPointer<LLImageRaw> raw_image, const LLSD& last_modified, EUpdateType optional_firstupdate)
+{
+    // decode is successful, we can safely proceed.
+    LLUUID old_id = LLUUID::null;
+    if ((optional_firstupdate != UT_FIRSTUSE) && !mWorldID.isNull())
+    {
+        old_id = mWorldID;
+    }
+    mWorldID.generate();
+    mLastModified = last_modified;
+
+    LLPointer<LLViewerFetchedTexture> texture = new LLViewerFetchedTexture
+        ("file://"+mFilename, FTT_LOCAL_FILE, mWorldID, LL_LOCAL_USE_MIPMAPS);
+
+    texture->createGLTexture(LL_LOCAL_DISCARD_LEVEL, raw_image);
+    texture->ref();
+
+    gTextureList.addImage(texture, TEX_LIST_STANDARD);
+
+    if (optional_firstupdate != UT_FIRSTUSE)
+    {
+        // seek out everything old_id uses and replace it with mWorldID
+        replaceIDs(old_id, mWorldID);
+
+        // remove old_id from gimagelist
+        LLViewerFetchedTexture* image = gTextureList.findImage(old_id, TEX_LIST_STANDARD);
+        if (image != NULL)
+        {
+            gTextureList.deleteImage(image);
+            image->unref();
+        }
+    }
+
+    mUpdateRetries = LL_LOCAL_UPDATE_RETRIES;
+}
+
+// if decoding failed, we get here and it will attempt to decode it in the next cycles
+// until mUpdateRetries runs out. this is done because some software lock the bitmap while writing to it
+void LLLocalBitmap::decodeFailed()
+{
+    if (mUpdateRetries)
+    {
+        mUpdateRetries--;
+    }
+    else
+    {
+        LL_WARNS() << "During the update process the following file was found" << "\n"
+                << "but could not be opened or decoded for " << LL_LOCAL_UPDATE_RETRIES << " attempts." << "\n"
+                << "Filename: " << mFilename << "\n"
+                << "Disabling further update attempts for this file." << LL_ENDL;
+
+        LLSD notif_args;
+        notif_args["FNAME"] = mFilename;
+        notif_args["NRETRIES"] = LL_LOCAL_UPDATE_RETRIES;
+        LLNotificationsUtil::add("LocalBitmapsUpdateFailedFinal", notif_args);
+
+        mLinkStatus = LS_BROKEN;
+    }
+}
+
 boost::signals2::connection LLLocalBitmap::setChangedCallback(const LLLocalTextureCallback& cb)
 {
     return mChangedSignal.connect(cb);
@@ -1268,6 +1324,21 @@ void LLLocalBitmapMgr::doUpdates()
     mTimer.startTimer();
 }
 
+void LLLocalBitmapMgr::onBitmapDecoded(const LLUUID& tracking_id, LLPointer<LLImageRaw> raw_image, const LLSD& last_modified)
+{
+    for (local_list_iter iter = mBitmapList.begin(); iter != mBitmapList.end(); iter++)
+    {
+        LLLocalBitmap* unit = *iter;
+        if (unit->getTrackingID() == tracking_id)
+        {
+            unit->onBitmapDecoded(raw_image, last_modified);
+            doRebake();
+            return;
+        }
+    }
+    // the unit was removed while its file was decoding
+}
+
 void LLLocalBitmapMgr::setNeedsRebake()
 {
     mNeedsRebake = true;
@@ -58,7 +58,10 @@ class LLLocalBitmap
             UT_REGUPDATE
         };
 
+        // UT_FIRSTUSE decodes right away, regular updates decode on the
+        // image decode threads and call onBitmapDecoded() when done.
         bool updateSelf(EUpdateType = UT_REGUPDATE);
+        void onBitmapDecoded(LLPointer<LLImageRaw> raw, const LLSD& last_modified);
 
         typedef boost::signals2::signal<void(const LLUUID& tracking_id,
                                              const LLUUID& old_id,
@@ -69,6 +72,8 @@ class LLLocalBitmap
 
     private: /* self update private section */
         bool decodeBitmap(LLPointer<LLImageRaw> raw);
+        void applyBitmap(LLPointer<LLImageRaw> raw, const LLSD& last_modified, EUpdateType optional_firstupdate);
+        void decodeFailed();
         void replaceIDs(const LLUUID &old_id, LLUUID new_id);
         std::vector<LLViewerObject*> prepUpdateObjects(LLUUID old_id, U32 channel);
         void updateUserPrims(LLUUID old_id, LLUUID new_id, U32 channel);
@@ -102,6 +107,7 @@ class LLLocalBitmap
         EExtension  mExtension;
         ELinkStatus mLinkStatus;
         S32         mUpdateRetries;
+        bool        mDecodePending;
         LLLocalTextureChangedSignal mChangedSignal;
 
         // Store a list of accosiated materials
@@ -143,6 +149,7 @@ public:
 
     void         feedScrollList(LLScrollListCtrl* ctrl);
     void         doUpdates();
+    void         onBitmapDecoded(const LLUUID& tracking_id, LLPointer<LLImageRaw> raw, const LLSD& last_modified);
     void         setNeedsRebake();
     void         doRebake();
 
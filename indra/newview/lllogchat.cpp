@@ -131,6 +131,59 @@ const char* remove_utf8_bom(const char* buf)
     return start;
 }
 
+// Parse a line read from a transcript into messages, subsequent lines of a
+// multilined message are appended to the message they belong to
+void append_history_line(char* buffer, std::list<LLSD>& messages, const LLSD& load_params)
+{
+    size_t len = strlen(buffer) - 1;        /*Flawfinder: ignore*/
+    // backfill any end of line characters with nulls
+    for (char* bptr = (buffer + len); (*bptr == '\n' || *bptr == '\r') && bptr>buffer; bptr--)    *bptr='\0';
+
+    std::string line(remove_utf8_bom(buffer));
+
+    //updated 1.23 plain text log format requires a space added before subsequent lines in a multilined message
+    if (' ' == line[0])
+    {
+        line.erase(0, MULTI_LINE_PREFIX.length());
+        append_to_last_message(messages, '\n' + line);
+    }
+    else if (0 == len && ('\n' == line[0] || '\r' == line[0]))
+    {
+        //to support old format's multilined messages with new lines used to divide paragraphs
+        append_to_last_message(messages, line);
+    }
+    else
+    {
+        LLSD item;
+        if (!LLChatLogParser::parse(line, item, load_params))
+        {
+            item[LL_IM_TEXT] = line;
+        }
+        messages.push_back(item);
+    }
+}
+
+// Where the messages of the transcripts indexed so far start. Transcripts are
+// only ever appended to, so an index stays good for the bytes it covers and
+// only what was written since needs scanning the next time.
+struct LLTranscriptIndex
+{
+    LLLogChat::message_offsets_t mOffsets;
+    S64 mIndexedSize = 0; // always ends a line
+};
+
+LLMutex& transcript_index_mutex()
+{
+    static LLMutex sMutex;
+    return sMutex;
+}
+
+std::map<std::string, LLTranscriptIndex>& transcript_indexes()
+{
+    static std::map<std::string, LLTranscriptIndex> sIndexes;
+    return sIndexes;
+}
+
 class LLLogChatTimeScanner: public LLSingleton<LLLogChatTimeScanner>
 {
     LLSINGLETON(LLLogChatTimeScanner);
@@ -208,14 +261,10 @@ LLLogChatTimeScanner::LLLogChatTimeScanner()
 LLLogChat::LLLogChat()
 : mSaveHistorySignal(NULL) // only needed in preferences
 {
-    mHistoryThreadsMutex = new LLMutex();
 }
 
 LLLogChat::~LLLogChat()
 {
-    delete mHistoryThreadsMutex;
-    mHistoryThreadsMutex = NULL;
-
     if (mSaveHistorySignal)
     {
         mSaveHistorySignal->disconnect_all_slots();
@@ -445,8 +494,6 @@ void LLLogChat::loadChatHistory(const std::string& file_name, std::list<LLSD>& m
     auto save_num_messages = messages.size();
 
     char buffer[LOG_RECALL_SIZE];       /*Flawfinder: ignore*/
-    char *bptr;
-    size_t len;
     bool firstline = true;
 
     if (load_all_history || fseek(fptr, (LOG_RECALL_SIZE - 1) * -1  , SEEK_END))
@@ -460,38 +507,13 @@ void LLLogChat::loadChatHistory(const std::string& file_name, std::list<LLSD>& m
     }
     while (fgets(buffer, LOG_RECALL_SIZE, fptr)  && !feof(fptr))
     {
-        len = strlen(buffer) - 1;       /*Flawfinder: ignore*/
-        // backfill any end of line characters with nulls
-        for (bptr = (buffer + len); (*bptr == '\n' || *bptr == '\r') && bptr>buffer; bptr--)    *bptr='\0';
-
         if (firstline)
         {
             firstline = false;
             continue;
         }
 
-        std::string line(remove_utf8_bom(buffer));
-
-        //updated 1.23 plain text log format requires a space added before subsequent lines in a multilined message
-        if (' ' == line[0])
-        {
-            line.erase(0, MULTI_LINE_PREFIX.length());
-            append_to_last_message(messages, '\n' + line);
-        }
-        else if (0 == len && ('\n' == line[0] || '\r' == line[0]))
-        {
-            //to support old format's multilined messages with new lines used to divide paragraphs
-            append_to_last_message(messages, line);
-        }
-        else
-        {
-            LLSD item;
-            if (!LLChatLogParser::parse(line, item, load_params))
-            {
-                item[LL_IM_TEXT] = line;
-            }
-            messages.push_back(item);
-        }
+        append_history_line(buffer, messages, load_params);
     }
     fclose(fptr);
 
@@ -500,98 +522,136 @@ void LLLogChat::loadChatHistory(const std::string& file_name, std::list<LLSD>& m
         << " file mod time " << (F64)stat_data.st_mtime << LL_ENDL;
 }
 
-bool LLLogChat::historyThreadsFinished(LLUUID session_id)
+// static
+S64 LLLogChat::indexChatHistory(const std::string& file_name, message_offsets_t& offsets, std::string& log_file_name, bool is_group)
 {
-    LLMutexLock lock(historyThreadsMutex());
-    bool finished = true;
-    std::map<LLUUID,LLLoadHistoryThread *>::iterator it = mLoadHistoryThreads.find(session_id);
-    if (it != mLoadHistoryThreads.end())
+    LL_PROFILE_ZONE_SCOPED;
+
+    offsets.clear();
+    log_file_name.clear();
+    if (file_name.empty())
     {
-        finished = it->second->isFinished();
+        LL_WARNS("ChatHistory") << "Local history file name is empty!" << LL_ENDL;
+        return 0;
     }
-    if (!finished)
+
+    std::string found_name = makeLogFileName(file_name);
+    if (!LLFile::isfile(found_name) && is_group)
     {
-        return false;
+        std::string old_name(file_name);
+        old_name.erase(old_name.size() - GROUP_CHAT_SUFFIX.size());     // trim off " (group)"
+        if (LLFile::isfile(makeLogFileName(old_name)))
+        {   // copy to new naming style
+            LLFile::copy(makeLogFileName(old_name), found_name);
+        }
     }
-    std::map<LLUUID,LLDeleteHistoryThread *>::iterator dit = mDeleteHistoryThreads.find(session_id);
-    if (dit != mDeleteHistoryThreads.end())
+    if (!LLFile::isfile(found_name))
     {
-        finished = finished && dit->second->isFinished();
+        found_name = oldLogFileName(file_name);
     }
-    return finished;
-}
 
-LLLoadHistoryThread* LLLogChat::getLoadHistoryThread(LLUUID session_id)
-{
-    LLMutexLock lock(historyThreadsMutex());
-    std::map<LLUUID,LLLoadHistoryThread *>::iterator it = mLoadHistoryThreads.find(session_id);
-    if (it != mLoadHistoryThreads.end())
+    LLFILE* fptr = LLFile::fopen(found_name, "rb");      /*Flawfinder: ignore*/
+    if (!fptr)
     {
-        return it->second;
+        LL_DEBUGS("ChatHistory") << "No previous conversation log file found for " << file_name << LL_ENDL;
+        return 0;
     }
-    return NULL;
-}
 
-LLDeleteHistoryThread* LLLogChat::getDeleteHistoryThread(LLUUID session_id)
-{
-    LLMutexLock lock(historyThreadsMutex());
-    std::map<LLUUID,LLDeleteHistoryThread *>::iterator it = mDeleteHistoryThreads.find(session_id);
-    if (it != mDeleteHistoryThreads.end())
+    LLTranscriptIndex index;
     {
-        return it->second;
+        LLMutexLock lock(&transcript_index_mutex());
+        std::map<std::string, LLTranscriptIndex>::const_iterator it = transcript_indexes().find(found_name);
+        if (it != transcript_indexes().end())
+        {
+            index = it->second;
+        }
     }
-    return NULL;
-}
 
-bool LLLogChat::addLoadHistoryThread(LLUUID& session_id, LLLoadHistoryThread* lthread)
-{
-    LLMutexLock lock(historyThreadsMutex());
-    std::map<LLUUID,LLLoadHistoryThread *>::const_iterator it = mLoadHistoryThreads.find(session_id);
-    if (it != mLoadHistoryThreads.end())
+    // Reuse what was indexed before only if the file still looks like it was
+    // appended to, anything else (deleted and written again, truncated) is
+    // indexed from scratch.
+    fseek(fptr, 0, SEEK_END);
+    S64 file_size = ftell(fptr);
+    bool reuse = index.mIndexedSize > 0 && index.mIndexedSize <= file_size;
+    if (reuse)
     {
-        return false;
+        reuse = !fseek(fptr, (long)(index.mIndexedSize - 1), SEEK_SET) && fgetc(fptr) == '\n';
     }
-    mLoadHistoryThreads[session_id] = lthread;
-    return true;
-}
-
-bool LLLogChat::addDeleteHistoryThread(LLUUID& session_id, LLDeleteHistoryThread* dthread)
-{
-    LLMutexLock lock(historyThreadsMutex());
-    std::map<LLUUID,LLDeleteHistoryThread *>::const_iterator it = mDeleteHistoryThreads.find(session_id);
-    if (it != mDeleteHistoryThreads.end())
+    if (!reuse)
     {
-        return false;
+        index = LLTranscriptIndex();
+        fseek(fptr, 0, SEEK_SET);
     }
-    mDeleteHistoryThreads[session_id] = dthread;
-    return true;
-}
 
-void LLLogChat::cleanupHistoryThreads()
-{
-    LLMutexLock lock(historyThreadsMutex());
-    std::vector<LLUUID> uuids;
-    std::map<LLUUID,LLLoadHistoryThread *>::iterator lit = mLoadHistoryThreads.begin();
-    for (; lit != mLoadHistoryThreads.end(); lit++)
+    // Every line that isn't the continuation of a multilined message, or a
+    // paragraph break of the old format, starts a message.
+    const size_t indexed_count = index.mOffsets.size();
+    char buffer[LOG_RECALL_SIZE];       /*Flawfinder: ignore*/
+    S64 pos = index.mIndexedSize;
+    bool line_start = true;
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), fptr)) > 0)
     {
-        if (lit->second->isFinished() && mDeleteHistoryThreads[lit->first]->isFinished())
+        for (size_t i = 0; i < read; ++i, ++pos)
         {
-            delete lit->second;
-            delete mDeleteHistoryThreads[lit->first];
-            uuids.push_back(lit->first);
+            char c = buffer[i];
+            if (line_start && c != ' ' && c != '\n' && c != '\r')
+            {
+                index.mOffsets.push_back(pos);
+            }
+            line_start = (c == '\n');
+            if (line_start)
+            {
+                index.mIndexedSize = pos + 1;
+            }
         }
     }
-    std::vector<LLUUID>::iterator uuid_it = uuids.begin();
-    for ( ;uuid_it != uuids.end(); uuid_it++)
+    fclose(fptr);
+
+    // A line still being written isn't a message yet
+    while (index.mOffsets.size() > indexed_count && index.mOffsets.back() >= index.mIndexedSize)
+    {
+        index.mOffsets.pop_back();
+    }
+
     {
-        mLoadHistoryThreads.erase(*uuid_it);
-        mDeleteHistoryThreads.erase(*uuid_it);
+        LLMutexLock lock(&transcript_index_mutex());
+        transcript_indexes()[found_name] = index;
     }
+
+    LL_DEBUGS("ChatHistory") << "Indexed " << index.mOffsets.size() << " messages of " << found_name
+        << ", " << (index.mOffsets.size() - indexed_count) << " of them new" << LL_ENDL;
+
+    offsets.swap(index.mOffsets);
+    log_file_name = found_name;
+    return index.mIndexedSize;
 }
 
-LLMutex* LLLogChat::historyThreadsMutex()
+// static
+void LLLogChat::loadChatHistoryRange(const std::string& log_file_name, S64 begin, S64 end, std::list<LLSD>& messages, const LLSD& load_params)
 {
-    return mHistoryThreadsMutex;
+    LL_PROFILE_ZONE_SCOPED;
+
+    LLFILE* fptr = LLFile::fopen(log_file_name, "rb");      /*Flawfinder: ignore*/
+    if (!fptr)
+    {
+        LL_WARNS("ChatHistory") << "Unable to read file " << log_file_name << LL_ENDL;
+        return;
+    }
+    if (fseek(fptr, (long)begin, SEEK_SET))
+    {
+        fclose(fptr);
+        return;
+    }
+
+    char buffer[LOG_RECALL_SIZE];       /*Flawfinder: ignore*/
+    S64 pos = begin;
+    while (pos < end && fgets(buffer, LOG_RECALL_SIZE, fptr))
+    {
+        pos = ftell(fptr);
+        append_history_line(buffer, messages, load_params);
+    }
+    fclose(fptr);
 }
 
 void LLLogChat::triggerHistorySignal()
@@ -790,6 +850,11 @@ void LLLogChat::deleteTranscripts()
     getListOfTranscriptFiles(list_of_transcriptions);
     getListOfTranscriptBackupFiles(list_of_transcriptions);
 
+    {   // new transcripts will be written in their place
+        LLMutexLock lock(&transcript_index_mutex());
+        transcript_indexes().clear();
+    }
+
     for (const std::string& fullpath : list_of_transcriptions)
     {
         S32 retry_count = 0;
@@ -1055,203 +1120,3 @@ bool LLChatLogParser::parse(std::string& raw, LLSD& im, const LLSD& parse_params
     im[LL_IM_TEXT] = name_and_text[IDX_TEXT];
     return true;  //parsed name and message text, maybe have a timestamp too
 }
-
-LLDeleteHistoryThread::LLDeleteHistoryThread(std::list<LLSD>* messages, LLLoadHistoryThread* loadThread)
-    : LLActionThread("delete chat history"),
-    mMessages(messages),
-    mLoadThread(loadThread)
-{
-}
-LLDeleteHistoryThread::~LLDeleteHistoryThread()
-{
-}
-void LLDeleteHistoryThread::run()
-{
-    if (mLoadThread != NULL)
-    {
-        mLoadThread->waitFinished();
-    }
-    if (NULL != mMessages)
-    {
-        delete mMessages;
-    }
-    mMessages = NULL;
-    setFinished();
-}
-
-LLActionThread::LLActionThread(const std::string& name)
-    : LLThread(name),
-    mMutex(),
-    mRunCondition(),
-    mFinished(false)
-{
-}
-
-LLActionThread::~LLActionThread()
-{
-}
-
-void LLActionThread::waitFinished()
-{
-    mMutex.lock();
-    if (!mFinished)
-    {
-        mMutex.unlock();
-        mRunCondition.wait();
-    }
-    else
-    {
-        mMutex.unlock();
-    }
-}
-
-void LLActionThread::setFinished()
-{
-    mMutex.lock();
-    mFinished = true;
-    mMutex.unlock();
-    mRunCondition.signal();
-}
-
-LLLoadHistoryThread::LLLoadHistoryThread(const std::string& file_name, std::list<LLSD>* messages, const LLSD& load_params)
-    : LLActionThread("load chat history"),
-    mMessages(messages),
-    mFileName(file_name),
-    mLoadParams(load_params),
-    mNewLoad(true),
-    mLoadEndSignal(NULL)
-{
-}
-
-LLLoadHistoryThread::~LLLoadHistoryThread()
-{
-}
-
-void LLLoadHistoryThread::run()
-{
-    if(mNewLoad)
-    {
-        loadHistory(mFileName, mMessages, mLoadParams);
-        auto count = mMessages->size();
-        LL_INFOS() << "mMessages->size(): " << count << LL_ENDL;
-        setFinished();
-    }
-}
-
-void LLLoadHistoryThread::loadHistory(const std::string& file_name, std::list<LLSD>* messages, const LLSD& load_params)
-{
-    if (file_name.empty())
-    {
-        LL_WARNS("LLLogChat::loadHistory") << "Session name is Empty!" << LL_ENDL;
-        return ;
-    }
-
-    bool load_all_history = load_params.has("load_all_history") ? load_params["load_all_history"].asBoolean() : false;
-    LLFILE* fptr = LLFile::fopen(LLLogChat::makeLogFileName(file_name), "r");/*Flawfinder: ignore*/
-
-    if (!fptr)
-    {
-        bool is_group = load_params.has("is_group") ? load_params["is_group"].asBoolean() : false;
-        if (is_group)
-        {
-            std::string old_name(file_name);
-            old_name.erase(old_name.size() - GROUP_CHAT_SUFFIX.size());
-            fptr = LLFile::fopen(LLLogChat::makeLogFileName(old_name), "r");
-            if (fptr)
-            {
-                fclose(fptr);
-                LLFile::copy(LLLogChat::makeLogFileName(old_name), LLLogChat::makeLogFileName(file_name));
-            }
-            fptr = LLFile::fopen(LLLogChat::makeLogFileName(file_name), "r");
-        }
-        if (!fptr)
-        {
-            fptr = LLFile::fopen(LLLogChat::oldLogFileName(file_name), "r");/*Flawfinder: ignore*/
-            if (!fptr)
-            {
-                mNewLoad = false;
-                (*mLoadEndSignal)(messages, file_name);
-                return;                     //No previous conversation with this name.
-            }
-        }
-    }
-
-    char buffer[LOG_RECALL_SIZE];       /*Flawfinder: ignore*/
-
-    char *bptr;
-    size_t len;
-    bool firstline = true;
-
-    if (load_all_history || fseek(fptr, (LOG_RECALL_SIZE - 1) * -1  , SEEK_END))
-    {   //We need to load the whole historyFile or it's smaller than recall size, so get it all.
-        firstline = false;
-        if (fseek(fptr, 0, SEEK_SET))
-        {
-            fclose(fptr);
-            mNewLoad = false;
-            (*mLoadEndSignal)(messages, file_name);
-            return;
-        }
-    }
-
-
-    while (fgets(buffer, LOG_RECALL_SIZE, fptr)  && !feof(fptr))
-    {
-        len = strlen(buffer) - 1;       /*Flawfinder: ignore*/
-
-        for (bptr = (buffer + len); (*bptr == '\n' || *bptr == '\r') && bptr>buffer; bptr--)    *bptr='\0';
-
-
-        if (firstline)
-        {
-            firstline = false;
-            continue;
-        }
-        std::string line(remove_utf8_bom(buffer));
-
-        //updated 1.23 plaint text log format requires a space added before subsequent lines in a multilined message
-        if (' ' == line[0])
-        {
-            line.erase(0, MULTI_LINE_PREFIX.length());
-            append_to_last_message(*messages, '\n' + line);
-        }
-        else if (0 == len && ('\n' == line[0] || '\r' == line[0]))
-        {
-            //to support old format's multilined messages with new lines used to divide paragraphs
-            append_to_last_message(*messages, line);
-        }
-        else
-        {
-            LLSD item;
-            if (!LLChatLogParser::parse(line, item, load_params))
-            {
-                item[LL_IM_TEXT] = line;
-            }
-            messages->push_back(item);
-        }
-    }
-
-    fclose(fptr);
-    mNewLoad = false;
-    (*mLoadEndSignal)(messages, file_name);
-}
-
-boost::signals2::connection LLLoadHistoryThread::setLoadEndSignal(const load_end_signal_t::slot_type& cb)
-{
-    if (NULL == mLoadEndSignal)
-    {
-        mLoadEndSignal = new load_end_signal_t();
-    }
-
-    return mLoadEndSignal->connect(cb);
-}
-
-void LLLoadHistoryThread::removeLoadEndSignal(const load_end_signal_t::slot_type& cb)
-{
-    if (NULL != mLoadEndSignal)
-    {
-        mLoadEndSignal->disconnect_all_slots();
-        delete mLoadEndSignal;
-    }
-    mLoadEndSignal = NULL;
-}
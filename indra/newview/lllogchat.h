@@ -30,55 +30,6 @@
 
 class LLChat;
 
-class LLActionThread : public LLThread
-{
-public:
-    LLActionThread(const std::string& name);
-    ~LLActionThread();
-
-    void waitFinished();
-    bool isFinished() { return mFinished; }
-protected:
-    void setFinished();
-private:
-    bool mFinished;
-    LLMutex mMutex;
-    LLCondition mRunCondition;
-};
-
-class LLLoadHistoryThread : public LLActionThread
-{
-private:
-    const std::string& mFileName;
-    std::list<LLSD>* mMessages;
-    LLSD mLoadParams;
-    bool mNewLoad;
-public:
-    LLLoadHistoryThread(const std::string& file_name, std::list<LLSD>* messages, const LLSD& load_params);
-    ~LLLoadHistoryThread();
-    //void setHistoryParams(const std::string& file_name, const LLSD& load_params);
-    virtual void loadHistory(const std::string& file_name, std::list<LLSD>* messages, const LLSD& load_params);
-    virtual void run();
-
-    typedef boost::signals2::signal<void (std::list<LLSD>* messages,const std::string& file_name)> load_end_signal_t;
-    load_end_signal_t * mLoadEndSignal;
-    boost::signals2::connection setLoadEndSignal(const load_end_signal_t::slot_type& cb);
-    void removeLoadEndSignal(const load_end_signal_t::slot_type& cb);
-};
-
-class LLDeleteHistoryThread : public LLActionThread
-{
-private:
-    std::list<LLSD>* mMessages;
-    LLLoadHistoryThread* mLoadThread;
-public:
-    LLDeleteHistoryThread(std::list<LLSD>* messages, LLLoadHistoryThread* loadThread);
-    ~LLDeleteHistoryThread();
-
-    virtual void run();
-    static void deleteHistory();
-};
-
 class LLLogChat : public LLSingleton<LLLogChat>
 {
     LLSINGLETON(LLLogChat);
@@ -110,6 +61,19 @@ public:
 
     static void loadChatHistory(const std::string& file_name, std::list<LLSD>& messages, const LLSD& load_params = LLSD(), bool is_group = false);
 
+    typedef std::vector<S64> message_offsets_t;
+    /**
+     * Find where each message of a transcript starts, so that any page of it can
+     * be read without parsing the rest. Indexes are kept, a transcript that grew
+     * only has its new messages scanned. Reads the file, don't call it from the
+     * main thread.
+     * @param log_file_name set to the transcript file that was indexed
+     * @return where the last complete message ends, 0 if there's no transcript
+     */
+    static S64 indexChatHistory(const std::string& file_name, message_offsets_t& offsets, std::string& log_file_name, bool is_group = false);
+    /// Read the messages from begin up to end of a transcript found by indexChatHistory()
+    static void loadChatHistoryRange(const std::string& log_file_name, S64 begin, S64 end, std::list<LLSD>& messages, const LLSD& load_params = LLSD());
+
     typedef boost::signals2::signal<void ()> save_history_signal_t;
     boost::signals2::connection setSaveHistorySignal(const save_history_signal_t::slot_type& cb);
 
@@ -127,23 +91,12 @@ public:
     static bool isAdHocTranscriptExist(std::string file_name);
     static bool isTranscriptFileFound(std::string fullname);
 
-    bool historyThreadsFinished(LLUUID session_id);
-    LLLoadHistoryThread* getLoadHistoryThread(LLUUID session_id);
-    LLDeleteHistoryThread* getDeleteHistoryThread(LLUUID session_id);
-    bool addLoadHistoryThread(LLUUID& session_id, LLLoadHistoryThread* lthread);
-    bool addDeleteHistoryThread(LLUUID& session_id, LLDeleteHistoryThread* dthread);
-    void cleanupHistoryThreads();
-
 private:
     static std::string cleanFileName(std::string filename);
 
-    LLMutex* historyThreadsMutex();
     void triggerHistorySignal();
 
     save_history_signal_t * mSaveHistorySignal;
-    std::map<LLUUID,LLLoadHistoryThread *> mLoadHistoryThreads;
-    std::map<LLUUID,LLDeleteHistoryThread *> mDeleteHistoryThreads;
-    LLMutex* mHistoryThreadsMutex;
 };
 
 /**
@@ -0,0 +1,180 @@
+/**
+ * @file llmemoryfootprint.cpp
+ * @brief Estimate of the memory an object or an avatar costs the viewer,
+ * by subsystem.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llmemoryfootprint.h"
+
+#include "lldrawable.h"
+#include "llface.h"
+#include "llimagegl.h"
+#include "llmodel.h"
+#include "llrender.h"
+#include "llvertexbuffer.h"
+#include "llviewerjointattachment.h"
+#include "llviewerregion.h"
+#include "llviewertexture.h"
+#include "llvoavatar.h"
+#include "llvocache.h"
+#include "llvovolume.h"
+
+namespace
+{
+    // What LLVolumeFace::allocateVertices() and allocateIndices() ask for
+    U64 volume_face_bytes(const LLVolumeFace& face)
+    {
+        U64 per_vertex = sizeof(LLVector4a) * 2 + sizeof(LLVector2);
+        if (face.mTangents)
+        {
+            per_vertex += sizeof(LLVector4a);
+        }
+        if (face.mWeights)
+        {
+            per_vertex += sizeof(LLVector4a);
+        }
+        return (U64)face.mNumAllocatedVertices * per_vertex + (U64)face.mNumIndices * sizeof(U16);
+    }
+}
+
+LLMemoryFootprint::LLMemoryFootprint() :
+    mGeometryBytes(0),
+    mTextureBytes(0),
+    mMeshBytes(0),
+    mCacheBytes(0)
+{
+}
+
+void LLMemoryFootprint::addObject(LLViewerObject* object, bool with_children)
+{
+    if (!object || object->isDead())
+    {
+        return;
+    }
+
+    LLDrawable* drawable = object->mDrawable;
+    if (drawable)
+    {
+        for (S32 i = 0; i < drawable->getNumFaces(); ++i)
+        {
+            LLFace* face = drawable->getFace(i);
+            if (!face)
+            {
+                continue;
+            }
+
+            // Faces of a spatial group share its buffers, bill each one for
+            // its own range only
+            LLVertexBuffer* buffer = face->getVertexBuffer();
+            if (buffer)
+            {
+                mGeometryBytes += (U64)face->getGeomCount() * LLVertexBuffer::calcVertexSize(buffer->getTypeMask())
+                    + (U64)face->getIndicesCount() * sizeof(U16);
+            }
+
+            for (U32 ch = 0; ch < LLRender::NUM_TEXTURE_CHANNELS; ++ch)
+            {
+                addTexture(face->getTexture(ch));
+            }
+        }
+    }
+
+    // Avatars bind their baked textures without going through faces
+    for (U8 te = 0; te < object->getNumTEs(); ++te)
+    {
+        addTexture(object->getTEImage(te));
+    }
+
+    const LLVolume* volume = object->getVolume();
+    if (volume && mVolumes.insert(volume).second)
+    {
+        for (S32 i = 0; i < volume->getNumVolumeFaces(); ++i)
+        {
+            mMeshBytes += volume_face_bytes(volume->getVolumeFace(i));
+        }
+    }
+
+    LLVOVolume* vobj = dynamic_cast<LLVOVolume*>(object);
+    const LLMeshSkinInfo* skin = vobj ? vobj->getSkinInfo() : nullptr;
+    if (skin && mSkins.insert(skin).second)
+    {
+        mMeshBytes += skin->sizeBytes();
+    }
+
+    LLViewerRegion* region = object->getRegion();
+    LLVOCacheEntry* entry = region ? region->getCacheEntry(object->getLocalID()) : nullptr;
+    if (entry && entry->getDP())
+    {
+        mCacheBytes += entry->getDP()->getBufferSize();
+    }
+
+    if (with_children)
+    {
+        for (LLViewerObject* child : object->getChildren())
+        {
+            addObject(child, true);
+        }
+    }
+}
+
+void LLMemoryFootprint::addTexture(LLViewerTexture* texture)
+{
+    LLImageGL* image = texture ? texture->getGLTexture() : nullptr;
+    if (image && mTextures.insert(image).second)
+    {
+        mTextureBytes += image->mTextureMemory.value();
+    }
+}
+
+void LLMemoryFootprint::addAvatar(LLVOAvatar* avatar)
+{
+    if (!avatar || avatar->isDead())
+    {
+        return;
+    }
+
+    addObject(avatar, false);
+
+    for (const auto& point : avatar->mAttachmentPoints)
+    {
+        LLViewerJointAttachment* attachment = point.second;
+        if (!attachment)
+        {
+            continue;
+        }
+        for (const auto& attached_object : attachment->mAttachedObjects)
+        {
+            addObject(attached_object.get(), true);
+        }
+    }
+}
+
+std::string LLMemoryFootprint::asString() const
+{
+    const F64 MB = 1024.0 * 1024.0;
+    return llformat("Geometry %.1f MB, textures %.1f MB, mesh %.1f MB, object cache %.1f MB",
+                    mGeometryBytes / MB, mTextureBytes / MB, mMeshBytes / MB, mCacheBytes / MB);
+}
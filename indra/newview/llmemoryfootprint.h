@@ -0,0 +1,83 @@
+/**
+ * @file llmemoryfootprint.h
+ * @brief Estimate of the memory an object or an avatar costs the viewer,
+ * by subsystem.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLMEMORYFOOTPRINT_H
+#define LL_LLMEMORYFOOTPRINT_H
+
+#include <set>
+#include <string>
+
+class LLImageGL;
+class LLMeshSkinInfo;
+class LLViewerObject;
+class LLViewerTexture;
+class LLVOAvatar;
+class LLVolume;
+
+/**
+ * Walks the objects handed to it and adds up what their resident data
+ * costs: the vertex and index buffers of their faces and the textures bound
+ * to them on the GPU, their volume faces and skin info in RAM, and the
+ * object cache entries they were built from.
+ *
+ * Textures, volumes and skins shared between the objects of one footprint
+ * are counted once, so the footprint of an avatar is what derendering it
+ * could give back, at best. Shared with other owners they are counted by
+ * each of them, which keeps the numbers comparable between owners but means
+ * they don't add up to the totals.
+ */
+class LLMemoryFootprint
+{
+public:
+    LLMemoryFootprint();
+
+    /// Add object, and its children if with_children
+    void addObject(LLViewerObject* object, bool with_children = true);
+    /// Add the avatar body and all its attachments, HUDs included for self
+    void addAvatar(LLVOAvatar* avatar);
+
+    U64 getVRAM() const { return mGeometryBytes + mTextureBytes; }
+    U64 getRAM() const  { return mMeshBytes + mCacheBytes; }
+    U64 getTotal() const { return getVRAM() + getRAM(); }
+
+    /// Per subsystem breakdown, for a tool tip
+    std::string asString() const;
+
+    U64 mGeometryBytes; // vertex and index buffers
+    U64 mTextureBytes;  // GL textures
+    U64 mMeshBytes;     // volume faces and skin info
+    U64 mCacheBytes;    // object cache entries
+
+private:
+    void addTexture(LLViewerTexture* texture);
+
+    std::set<const LLImageGL*> mTextures;
+    std::set<const LLVolume*> mVolumes;
+    std::set<const LLMeshSkinInfo*> mSkins;
+};
+
+#endif // LL_LLMEMORYFOOTPRINT_H
@@ -79,6 +79,7 @@
 #include "llfloaterreg.h"
 #include "llvoavatarself.h"
 #include "llskinningutil.h"
+#include "threadpool.h"
 
 #include "boost/iostreams/device/array.hpp"
 #include "boost/iostreams/stream.hpp"
@@ -113,6 +114,7 @@
 //
 //   main     Main rendering thread, very sensitive to locking and other stalls
 //   repo     Overseeing worker thread associated with the LLMeshRepoThread class
+//   decodeN  0-N "MeshDecode" pool threads unpacking what repo fetched
 //   decom    Worker thread for mesh decomposition requests
 //   core     HTTP worker thread:  does the work but doesn't intrude here
 //   uploadN  0-N temporary mesh upload threads (0-1 in practice)
@@ -153,9 +155,13 @@
 //                             ...
 //                             onCompleted() invoked for GET
 //                               data copied
-//                               lodReceived() invoked
-//                                 unpack data into LLVolume
-//                                 append LoadedMesh to mLoadedQ
+//                               postDecode() invoked
+//                             ...
+//                                                 decode thread
+//                                                   lodReceived() invoked
+//                                                     unpack data into LLVolume
+//                                                     append LoadedMesh to mLoadedQ
+//                                                   write LOD to cache
 //                             ...
 //         notifyLoadedMeshes() invoked again
 //           scan mLoadedQ
@@ -169,6 +175,8 @@
 //   LLMeshRepository::mMeshMutex
 //   LLMeshRepoThread::mMutex
 //   LLMeshRepoThread::mHeaderMutex
+//   LLMeshRepoThread::mLoadedMutex
+//   LLMeshRepoThread::mSkinMapMutex
 //   LLMeshRepoThread::mSignal (LLCondition)
 //   LLPhysicsDecomp::mSignal (LLCondition)
 //   LLPhysicsDecomp::mMutex
@@ -178,6 +186,8 @@
 //
 //   1.  LLMeshRepoThread::mMutex before LLMeshRepoThread::mHeaderMutex
 //   2.  LLMeshRepository::mMeshMutex before LLMeshRepoThread::mMutex
+//   3.  LLMeshRepoThread::mLoadedMutex and mSkinMapMutex are leaves, hold
+//       nothing else while holding them
 //   (There are more rules, haven't been extracted.)
 //
 // Data Member Access/Locking
@@ -187,7 +197,7 @@
 //   the mutex, if any, covering the data and then a list of data
 //   access models each of which is a triplet of the following form:
 //
-//     {ro, wo, rw}.{main, repo, any}.{mutex, none}
+//     {ro, wo, rw}.{main, repo, decode, any}.{mutex, none}
 //     Type of access:  read-only, write-only, read-write.
 //     Accessing thread or 'any'
 //     Relevant mutex held during access (several may be held) or 'none'
@@ -252,19 +262,22 @@
 //     sMaxConcurrentRequests   mMutex        wo.main.none, ro.repo.none, ro.main.mMutex
 //     mMeshHeader              mHeaderMutex  rw.repo.mHeaderMutex, ro.main.mHeaderMutex, ro.main.none [0]
 //     mSkinRequests            mMutex        rw.repo.mMutex, ro.repo.none [5]
-//     mSkinInfoQ               mMutex        rw.repo.mMutex, rw.main.mMutex [5] (was:  [0])
+//     mSkinInfoQ               mLoadedMutex  rw.decode.mLoadedMutex, rw.main.mLoadedMutex [5]
 //     mDecompositionRequests   mMutex        rw.repo.mMutex, ro.repo.none [5]
 //     mPhysicsShapeRequests    mMutex        rw.repo.mMutex, ro.repo.none [5]
-//     mDecompositionQ          mMutex        rw.repo.mMutex, rw.main.mMutex [5] (was:  [0])
+//     mDecompositionQ          mLoadedMutex  rw.decode.mLoadedMutex, rw.main.mLoadedMutex [5]
 //     mHeaderReqQ              mMutex        ro.repo.none [5], rw.repo.mMutex, rw.any.mMutex
 //     mLODReqQ                 mMutex        ro.repo.none [5], rw.repo.mMutex, rw.any.mMutex
 //     mUnavailableQ            mMutex        rw.repo.none [0], ro.main.none [5], rw.main.mMutex
-//     mLoadedQ                 mMutex        rw.repo.mMutex, ro.main.none [5], rw.main.mMutex
+//     mLoadedQ                 mLoadedMutex  rw.decode.mLoadedMutex, ro.main.none [5], rw.main.mLoadedMutex
+//     mSkinMap                 mSkinMapMutex rw.decode.mSkinMapMutex, rw.repo.mSkinMapMutex
 //     mPendingLOD              mMutex        rw.repo.mMutex, rw.any.mMutex
 //     mGetMeshCapability       mMutex        rw.main.mMutex, ro.repo.mMutex (was:  [0])
 //     mGetMesh2Capability      mMutex        rw.main.mMutex, ro.repo.mMutex (was:  [0])
 //     mGetMeshVersion          mMutex        rw.main.mMutex, ro.repo.mMutex
 //     mHttp*                   none          rw.repo.none
+//     sUseDecodedCache         none          wo.main.none, ro.repo.none, ro.decode.none [1]
+//     sSimplifyFlatLODs        none          wo.main.none, ro.repo.none, ro.decode.none [1]
 //
 //   LLMeshUploadThread:
 //
@@ -355,6 +368,16 @@ const U32 LARGE_MESH_FETCH_THRESHOLD = 1U << 21;        // Size at which request
 const long SMALL_MESH_XFER_TIMEOUT = 120L;              // Seconds to complete xfer, small mesh downloads
 const long LARGE_MESH_XFER_TIMEOUT = 600L;              // Seconds to complete xfer, large downloads
 
+const S32 MESH_UNKNOWN_LOD_BYTES = 32768;                // LOD size to assume until the header arrived
+const S32 MESH_OUT_OF_VIEW_FRAMES = 30;                 // Frames off screen before requests may be taken back
+const F32 MESH_CANCEL_REQUESTS_INTERVAL = 1.f;          // Seconds between checks for requests out of view
+
+const F32 MESH_FLAT_LOD_SIZE_RATIO = 0.5f;              // Low LODs at least this share of the high LOD's size are flat
+// Share of the high LOD's triangles a simplified lowest, low and medium
+// LOD keeps, like the upload defaults, and the error each may introduce
+const F32 MESH_SIMPLIFIED_LOD_RATIO[] = { 1.f / 64.f, 1.f / 16.f, 1.f / 4.f };
+const F32 MESH_SIMPLIFIED_LOD_ERROR[] = { 0.05f, 0.02f, 0.01f };
+
 const U32 DOWNLOAD_RETRY_LIMIT = 8;
 const F32 DOWNLOAD_RETRY_DELAY = 0.5f; // seconds
 
@@ -554,6 +577,8 @@ U32 LLMeshRepoThread::sMaxConcurrentRequests = 1;
 S32 LLMeshRepoThread::sRequestLowWater = REQUEST2_LOW_WATER_MIN;
 S32 LLMeshRepoThread::sRequestHighWater = REQUEST2_HIGH_WATER_MIN;
 S32 LLMeshRepoThread::sRequestWaterLevel = 0;
+bool LLMeshRepoThread::sUseDecodedCache = true;
+bool LLMeshRepoThread::sSimplifyFlatLODs = false;
 
 // Base handler class for all mesh users of llcorehttp.
 // This is roughly equivalent to a Responder class in
@@ -823,7 +848,7 @@ void log_upload_error(LLCore::HttpStatus status, const LLSD& content,
     gMeshRepo.uploadError(args);
 }
 
-LLMeshRepoThread::LLMeshRepoThread()
+LLMeshRepoThread::LLMeshRepoThread(U32 decode_threads)
 : LLThread("mesh repo"),
   mHttpRequest(NULL),
   mHttpOptions(),
@@ -837,6 +862,8 @@ LLMeshRepoThread::LLMeshRepoThread()
 
     mMutex = new LLMutex();
     mHeaderMutex = new LLMutex();
+    mLoadedMutex = new LLMutex();
+    mSkinMapMutex = new LLMutex();
     mSignal = new LLCondition();
     mHttpRequest = new LLCore::HttpRequest;
     mHttpOptions = LLCore::HttpOptions::ptr_t(new LLCore::HttpOptions);
@@ -849,6 +876,13 @@ LLMeshRepoThread::LLMeshRepoThread()
     mHttpHeaders->append(HTTP_OUT_HEADER_ACCEPT, HTTP_CONTENT_VND_LL_MESH);
     mHttpPolicyClass = app_core_http.getPolicy(LLAppCoreHttp::AP_MESH2);
     mHttpLargePolicyClass = app_core_http.getPolicy(LLAppCoreHttp::AP_LARGE_MESH);
+
+    // "ThreadPoolSizes" may override the width, 0 decodes on this thread
+    if (LL::ThreadPool::getConfiguredWidth("MeshDecode", decode_threads) > 0)
+    {
+        mDecodePool.reset(new LL::ThreadPool("MeshDecode", decode_threads));
+        mDecodePool->start();
+    }
 }
 
 
@@ -859,6 +893,13 @@ LLMeshRepoThread::~LLMeshRepoThread()
                        << ", Max Lock Holdoffs:  " << LLMeshRepository::sMaxLockHoldoffs
                        << LL_ENDL;
 
+    // Decoders still reference this thread's queues and maps
+    if (mDecodePool)
+    {
+        mDecodePool->close();
+        mDecodePool.reset();
+    }
+
     mHttpRequestSet.clear();
     mHttpHeaders.reset();
 
@@ -880,6 +921,10 @@ LLMeshRepoThread::~LLMeshRepoThread()
     mMutex = NULL;
     delete mHeaderMutex;
     mHeaderMutex = NULL;
+    delete mLoadedMutex;
+    mLoadedMutex = NULL;
+    delete mSkinMapMutex;
+    mSkinMapMutex = NULL;
     delete mSignal;
     mSignal = NULL;
 }
@@ -941,6 +986,12 @@ void LLMeshRepoThread::run()
                 }
 
                 mMutex->lock();
+                if (mLODReqQ.empty())
+                {
+                    // main thread took the rest back, see cancelOutOfViewRequests()
+                    mMutex->unlock();
+                    break;
+                }
                 LODRequest req = mLODReqQ.front();
                 mLODReqQ.pop();
                 LLMeshRepository::sLODProcessing--;
@@ -1326,6 +1377,22 @@ LLCore::HttpHandle LLMeshRepoThread::getByteRange(const std::string & url,
     return handle;
 }
 
+// Thread:  repo
+bool LLMeshRepoThread::postDecode(const std::function<void()>& decode)
+{
+    if (!mDecodePool)
+    {
+        decode();
+        return true;
+    }
+    return mDecodePool->getQueue().post(decode);
+}
+
+U32 LLMeshRepoThread::getDecodeThreadCount() const
+{
+    return mDecodePool ? (U32)mDecodePool->getWidth() : 0;
+}
+
 
 bool LLMeshRepoThread::fetchMeshSkinInfo(const LLUUID& mesh_id, bool can_retry)
 {
@@ -1393,49 +1460,31 @@ bool LLMeshRepoThread::fetchMeshSkinInfo(const LLUUID& mesh_id, bool can_retry)
                 }
 
                 if (!zero)
-                { //attempt to parse
-                    if (skinInfoReceived(mesh_id, buffer, size))
-                    {
-                        delete[] buffer;
-                        return true;
-                    }
+                { //attempt to parse, falling back to the sim if that fails
+                    std::shared_ptr<U8[]> data(buffer);
+                    postDecode([this, mesh_id, offset, size, can_retry, data]()
+                        {
+                            if (!skinInfoReceived(mesh_id, data.get(), size))
+                            {
+                                mWorkQueue.post([this, mesh_id, offset, size, can_retry]()
+                                    {
+                                        if (!fetchMeshSkinInfoFromSim(mesh_id, offset, size, can_retry))
+                                        {
+                                            LLMutexLock locker(mMutex);
+                                            mSkinUnavailableQ.emplace_back(mesh_id);
+                                        }
+                                    });
+                                mSignal->signal();
+                            }
+                        });
+                    return true;
                 }
 
                 delete[] buffer;
             }
 
             //reading from cache failed for whatever reason, fetch from sim
-            std::string http_url;
-            constructUrl(mesh_id, &http_url);
-
-            if (!http_url.empty())
-            {
-                LLMeshHandlerBase::ptr_t handler(new LLMeshSkinInfoHandler(mesh_id, offset, size));
-                LLCore::HttpHandle handle = getByteRange(http_url, offset, size, handler);
-                if (LLCORE_HTTP_HANDLE_INVALID == handle)
-                {
-                    LL_WARNS(LOG_MESH) << "HTTP GET request failed for skin info on mesh " << mID
-                                       << ".  Reason:  " << mHttpStatus.toString()
-                                       << " (" << mHttpStatus.toTerseString() << ")"
-                                       << LL_ENDL;
-                    ret = false;
-                }
-                else if(can_retry)
-                {
-                    handler->mHttpHandle = handle;
-                    mHttpRequestSet.insert(handler);
-                }
-                else
-                {
-                    LLMutexLock locker(mMutex);
-                    mSkinUnavailableQ.emplace_back(mesh_id);
-                }
-            }
-            else
-            {
-                LLMutexLock locker(mMutex);
-                mSkinUnavailableQ.emplace_back(mesh_id);
-            }
+            ret = fetchMeshSkinInfoFromSim(mesh_id, offset, size, can_retry);
         }
         else
         {
@@ -1452,6 +1501,42 @@ bool LLMeshRepoThread::fetchMeshSkinInfo(const LLUUID& mesh_id, bool can_retry)
     return ret;
 }
 
+bool LLMeshRepoThread::fetchMeshSkinInfoFromSim(const LLUUID& mesh_id, S32 offset, S32 size, bool can_retry)
+{
+    std::string http_url;
+    constructUrl(mesh_id, &http_url);
+
+    if (!http_url.empty())
+    {
+        LLMeshHandlerBase::ptr_t handler(new LLMeshSkinInfoHandler(mesh_id, offset, size));
+        LLCore::HttpHandle handle = getByteRange(http_url, offset, size, handler);
+        if (LLCORE_HTTP_HANDLE_INVALID == handle)
+        {
+            LL_WARNS(LOG_MESH) << "HTTP GET request failed for skin info on mesh " << mID
+                               << ".  Reason:  " << mHttpStatus.toString()
+                               << " (" << mHttpStatus.toTerseString() << ")"
+                               << LL_ENDL;
+            return false;
+        }
+        else if(can_retry)
+        {
+            handler->mHttpHandle = handle;
+            mHttpRequestSet.insert(handler);
+        }
+        else
+        {
+            LLMutexLock locker(mMutex);
+            mSkinUnavailableQ.emplace_back(mesh_id);
+        }
+    }
+    else
+    {
+        LLMutexLock locker(mMutex);
+        mSkinUnavailableQ.emplace_back(mesh_id);
+    }
+    return true;
+}
+
 bool LLMeshRepoThread::fetchMeshDecomposition(const LLUUID& mesh_id)
 {
     LL_PROFILE_ZONE_SCOPED;
@@ -1795,6 +1880,11 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
 
         if (version <= MAX_MESH_VERSION && offset >= 0 && size > 0)
         {
+            //check cache for an earlier unpack of this LOD
+            if (sUseDecodedCache && fetchDecodedMeshLOD(mesh_params, lod, can_retry))
+            {
+                return true;
+            }
 
             //check cache for mesh asset
             LLFileSystem file(mesh_id, LLAssetType::AT_MESH);
@@ -1829,55 +1919,34 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
                 }
 
                 if (!zero)
-                { //attempt to parse
-                    if (lodReceived(mesh_params, lod, buffer, size) == MESH_OK)
-                    {
-                        delete[] buffer;
-
-                        LL_DEBUGS(LOG_MESH) << "Mesh/Cache: Mesh body for ID " << mesh_id << " - was retrieved from the cache." << LL_ENDL;
+                { //attempt to parse, falling back to the sim if that fails
+                    std::shared_ptr<U8[]> data(buffer);
+                    postDecode([this, mesh_params, lod, offset, size, can_retry, data]()
+                        {
+                            if (lodReceived(mesh_params, lod, data.get(), size) == MESH_OK)
+                            {
+                                LL_DEBUGS(LOG_MESH) << "Mesh/Cache: Mesh body for ID " << mesh_params.getSculptID() << " - was retrieved from the cache." << LL_ENDL;
+                                return;
+                            }
 
-                        return true;
-                    }
+                            mWorkQueue.post([this, mesh_params, lod, offset, size, can_retry]()
+                                {
+                                    if (!fetchMeshLODFromSim(mesh_params, lod, offset, size, can_retry))
+                                    {
+                                        LLMutexLock lock(mMutex);
+                                        mUnavailableQ.push_back(LODRequest(mesh_params, lod));
+                                    }
+                                });
+                            mSignal->signal();
+                        });
+                    return true;
                 }
 
                 delete[] buffer;
             }
 
             //reading from cache failed for whatever reason, fetch from sim
-            std::string http_url;
-            constructUrl(mesh_id, &http_url);
-
-            if (!http_url.empty())
-            {
-                LL_DEBUGS(LOG_MESH) << "Mesh/Cache: Mesh body for ID " << mesh_id << " - was retrieved from the simulator." << LL_ENDL;
-
-                LLMeshHandlerBase::ptr_t handler(new LLMeshLODHandler(mesh_params, lod, offset, size));
-                LLCore::HttpHandle handle = getByteRange(http_url, offset, size, handler);
-                if (LLCORE_HTTP_HANDLE_INVALID == handle)
-                {
-                    LL_WARNS(LOG_MESH) << "HTTP GET request failed for LOD on mesh " << mID
-                                       << ".  Reason:  " << mHttpStatus.toString()
-                                       << " (" << mHttpStatus.toTerseString() << ")"
-                                       << LL_ENDL;
-                    retval = false;
-                }
-                else if (can_retry)
-                {
-                    handler->mHttpHandle = handle;
-                    mHttpRequestSet.insert(handler);
-                    // *NOTE:  Allowing a re-request, not marking as unavailable.  Is that correct?
-                }
-                else
-                {
-                    LLMutexLock lock(mMutex);
-                    mUnavailableQ.push_back(LODRequest(mesh_params, lod));
-                }
-            }
-            else
-            {
-                LLMutexLock lock(mMutex);
-                mUnavailableQ.push_back(LODRequest(mesh_params, lod));
-            }
+            retval = fetchMeshLODFromSim(mesh_params, lod, offset, size, can_retry);
         }
         else
         {
@@ -1893,6 +1962,131 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
     return retval;
 }
 
+bool LLMeshRepoThread::fetchMeshLODFromSim(const LLVolumeParams& mesh_params, S32 lod, S32 offset, S32 size, bool can_retry)
+{
+    const LLUUID& mesh_id = mesh_params.getSculptID();
+
+    std::string http_url;
+    constructUrl(mesh_id, &http_url);
+
+    if (!http_url.empty())
+    {
+        LL_DEBUGS(LOG_MESH) << "Mesh/Cache: Mesh body for ID " << mesh_id << " - was retrieved from the simulator." << LL_ENDL;
+
+        LLMeshHandlerBase::ptr_t handler(new LLMeshLODHandler(mesh_params, lod, offset, size));
+        LLCore::HttpHandle handle = getByteRange(http_url, offset, size, handler);
+        if (LLCORE_HTTP_HANDLE_INVALID == handle)
+        {
+            LL_WARNS(LOG_MESH) << "HTTP GET request failed for LOD on mesh " << mID
+                               << ".  Reason:  " << mHttpStatus.toString()
+                               << " (" << mHttpStatus.toTerseString() << ")"
+                               << LL_ENDL;
+            return false;
+        }
+        else if (can_retry)
+        {
+            handler->mHttpHandle = handle;
+            mHttpRequestSet.insert(handler);
+            // *NOTE:  Allowing a re-request, not marking as unavailable.  Is that correct?
+        }
+        else
+        {
+            LLMutexLock lock(mMutex);
+            mUnavailableQ.push_back(LODRequest(mesh_params, lod));
+        }
+    }
+    else
+    {
+        LLMutexLock lock(mMutex);
+        mUnavailableQ.push_back(LODRequest(mesh_params, lod));
+    }
+    return true;
+}
+
+bool LLMeshRepoThread::fetchDecodedMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool can_retry)
+{
+    const LLUUID decoded_id = getDecodedCacheID(mesh_params, lod, getFlatLODRatio(mesh_params.getSculptID(), lod) > 0.f);
+    LLFileSystem file(decoded_id, LLAssetType::AT_MESH);
+    S32 size = file.getSize();
+    if (size <= 0)
+    {
+        return false;
+    }
+
+    std::shared_ptr<U8[]> data(new(std::nothrow) U8[size]);
+    if (!data || !file.read(data.get(), size))
+    {
+        return false;
+    }
+    LLMeshRepository::sCacheBytesRead += size;
+    ++LLMeshRepository::sCacheReads;
+
+    postDecode([this, mesh_params, lod, can_retry, decoded_id, data, size]()
+        {
+            if (lodReceived(mesh_params, lod, data.get(), size, true) == MESH_OK)
+            {
+                LL_DEBUGS(LOG_MESH) << "Mesh/Cache: Mesh body for ID " << mesh_params.getSculptID() << " - was retrieved decoded from the cache." << LL_ENDL;
+                return;
+            }
+
+            // Older format or damaged, unpack the asset again
+            LLFileSystem::removeFile(decoded_id, LLAssetType::AT_MESH);
+            mWorkQueue.post([this, mesh_params, lod, can_retry]()
+                {
+                    if (!fetchMeshLOD(mesh_params, lod, can_retry))
+                    {
+                        LLMutexLock lock(mMutex);
+                        mUnavailableQ.push_back(LODRequest(mesh_params, lod));
+                    }
+                });
+            mSignal->signal();
+        });
+    return true;
+}
+
+//static
+LLUUID LLMeshRepoThread::getDecodedCacheID(const LLVolumeParams& mesh_params, S32 lod, bool simplified)
+{
+    // Mirror and invert are applied while unpacking, so they are part of
+    // the key along with the format version
+    LLUUID id;
+    id.generate(llformat("%s:%s:%d:%d:%u", mesh_params.getSculptID().asString().c_str(),
+                         simplified ? "simplified" : "decoded", lod,
+                         (S32)(mesh_params.getSculptType() & LL_SCULPT_FLAG_MASK),
+                         LLVolume::DECODED_FACES_VERSION));
+    return id;
+}
+
+F32 LLMeshRepoThread::getFlatLODRatio(const LLUUID& mesh_id, S32 lod)
+{
+    if (!sSimplifyFlatLODs || lod < LLModel::LOD_IMPOSTOR || lod >= LLModel::LOD_HIGH)
+    {
+        return 0.f;
+    }
+
+    S32 lod_size = 0;
+    S32 high_size = 0;
+    {
+        LLMutexLock lock(mHeaderMutex);
+        auto header_it = mMeshHeader.find(mesh_id);
+        if (header_it == mMeshHeader.end() || header_it->second.first == 0)
+        {
+            return 0.f;
+        }
+        lod_size = header_it->second.second.mLodSize[lod];
+        high_size = header_it->second.second.mLodSize[LLModel::LOD_HIGH];
+    }
+
+    if (lod_size <= 0 || high_size <= 0 || lod_size < high_size * MESH_FLAT_LOD_SIZE_RATIO)
+    {
+        return 0.f;
+    }
+
+    // Compressed sizes stand in for triangle counts, scale the share of
+    // the high LOD to what this LOD has
+    return llmin(MESH_SIMPLIFIED_LOD_RATIO[lod] * (F32)high_size / (F32)lod_size, 1.f);
+}
+
 EMeshProcessingResult LLMeshRepoThread::headerReceived(const LLVolumeParams& mesh_params, U8* data, S32 data_size)
 {
     const LLUUID mesh_id = mesh_params.getSculptID();
@@ -1982,7 +2176,7 @@ EMeshProcessingResult LLMeshRepoThread::headerReceived(const LLVolumeParams& mes
     return MESH_OK;
 }
 
-EMeshProcessingResult LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size)
+EMeshProcessingResult LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size, bool decoded)
 {
     if (data == NULL || data_size == 0)
     {
@@ -1990,25 +2184,58 @@ EMeshProcessingResult LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_p
     }
 
     LLPointer<LLVolume> volume = new LLVolume(mesh_params, LLVolumeLODGroup::getVolumeScaleFromDetail(lod));
-    if (volume->unpackVolumeFaces(data, data_size))
+    bool unpacked = decoded ? volume->unpackDecodedFaces(data, data_size) : volume->unpackVolumeFaces(data, data_size);
+    if (unpacked)
     {
         if (volume->getNumFaces() > 0)
         {
+            // The decoded cache already holds the simplified copy, if any.
+            // It is stored under its own ID, simplified or not, so that it
+            // is found again when fetchDecodedMeshLOD() looks for one.
+            F32 ratio = decoded ? 0.f : getFlatLODRatio(mesh_params.getSculptID(), lod);
+            if (ratio > 0.f && ratio < 1.f)
+            {
+                LL_PROFILE_ZONE_NAMED_CATEGORY_VOLUME("simplify flat LOD");
+                S32 triangles = volume->getNumTriangles();
+                for (S32 i = 0; i < volume->getNumVolumeFaces(); ++i)
+                {
+                    volume->getVolumeFace(i).simplify(ratio, MESH_SIMPLIFIED_LOD_ERROR[lod]);
+                }
+                LL_DEBUGS(LOG_MESH) << "Simplified flat LOD " << lod << " of mesh " << mesh_params.getSculptID()
+                                    << " from " << triangles << " to " << volume->getNumTriangles() << " triangles" << LL_ENDL;
+            }
+
+            std::vector<U8> decoded_faces;
+            if (!decoded && sUseDecodedCache && volume->packDecodedFaces(decoded_faces))
+            {
+                LLFileSystem file(getDecodedCacheID(mesh_params, lod, ratio > 0.f), LLAssetType::AT_MESH, LLFileSystem::WRITE);
+                if (file.write(decoded_faces.data(), (S32)decoded_faces.size()))
+                {
+                    LLMeshRepository::sCacheBytesWritten += (U32)decoded_faces.size();
+                    ++LLMeshRepository::sCacheWrites;
+                }
+            }
+
             // if we have a valid SkinInfo, cache per-joint bounding boxes for this LOD
-            LLMeshSkinInfo* skin_info = mSkinMap[mesh_params.getSculptID()];
-            if (skin_info && isAgentAvatarValid())
             {
-                for (S32 i = 0; i < volume->getNumFaces(); ++i)
+                // Another decoder may replace the entry, the repo thread erase it
+                LLMutexLock lock(mSkinMapMutex);
+                auto skin_it = mSkinMap.find(mesh_params.getSculptID());
+                LLMeshSkinInfo* skin_info = skin_it != mSkinMap.end() ? skin_it->second.get() : nullptr;
+                if (skin_info && isAgentAvatarValid())
                 {
-                    // NOTE: no need to lock gAgentAvatarp as the state being checked is not changed after initialization
-                    LLVolumeFace& face = volume->getVolumeFace(i);
-                    LLSkinningUtil::updateRiggingInfo(skin_info, gAgentAvatarp, face);
+                    for (S32 i = 0; i < volume->getNumFaces(); ++i)
+                    {
+                        // NOTE: no need to lock gAgentAvatarp as the state being checked is not changed after initialization
+                        LLVolumeFace& face = volume->getVolumeFace(i);
+                        LLSkinningUtil::updateRiggingInfo(skin_info, gAgentAvatarp, face);
+                    }
                 }
             }
 
             LoadedMesh mesh(volume, mesh_params, lod);
             {
-                LLMutexLock lock(mMutex);
+                LLMutexLock lock(mLoadedMutex);
                 mLoadedQ.push_back(mesh);
                 // LLPointer is not thread safe, since we added this pointer into
                 // threaded list, make sure counter gets decreased inside mutex lock
@@ -2060,12 +2287,15 @@ bool LLMeshRepoThread::skinInfoReceived(const LLUUID& mesh_id, U8* data, S32 dat
 
         // copy the skin info for the background thread so we can use it
         // to calculate per-joint bounding boxes when volumes are loaded
-        mSkinMap[mesh_id] = new LLMeshSkinInfo(*info);
+        {
+            LLMutexLock lock(mSkinMapMutex);
+            mSkinMap[mesh_id] = new LLMeshSkinInfo(*info);
+        }
 
         {
             // Move the LLPointer in to the skin info queue to avoid reference
             // count modification after we leave the lock
-            LLMutexLock lock(mMutex);
+            LLMutexLock lock(mLoadedMutex);
             mSkinInfoQ.emplace_back(std::move(info));
         }
     }
@@ -2101,7 +2331,7 @@ bool LLMeshRepoThread::decompositionReceived(const LLUUID& mesh_id, U8* data, S3
         LLModel::Decomposition* d = new LLModel::Decomposition(decomp);
         d->mMeshID = mesh_id;
         {
-            LLMutexLock lock(mMutex);
+            LLMutexLock lock(mLoadedMutex);
             mDecompositionQ.push_back(d);
         }
     }
@@ -2150,7 +2380,7 @@ EMeshProcessingResult LLMeshRepoThread::physicsShapeReceived(const LLUUID& mesh_
     }
 
     {
-        LLMutexLock lock(mMutex);
+        LLMutexLock lock(mLoadedMutex);
         mDecompositionQ.push_back(d);
     }
     return MESH_OK;
@@ -2947,11 +3177,11 @@ void LLMeshRepoThread::notifyLoadedMeshes()
     {
         std::deque<LoadedMesh> loaded_queue;
 
-        mMutex->lock();
+        mLoadedMutex->lock();
         if (!mLoadedQ.empty())
         {
             loaded_queue.swap(mLoadedQ);
-            mMutex->unlock();
+            mLoadedMutex->unlock();
 
             update_metrics = true;
 
@@ -2991,48 +3221,52 @@ void LLMeshRepoThread::notifyLoadedMeshes()
         }
     }
 
-    if (!mSkinInfoQ.empty() || !mSkinUnavailableQ.empty() || ! mDecompositionQ.empty())
+    if (!mSkinInfoQ.empty() || ! mDecompositionQ.empty())
     {
-        if (mMutex->trylock())
+        // Decoders only hold mLoadedMutex for a push, no need to try
+        std::deque<LLPointer<LLMeshSkinInfo>> skin_info_q;
+        std::list<LLModel::Decomposition*> decomp_q;
+
+        mLoadedMutex->lock();
+        if (! mSkinInfoQ.empty())
         {
-            std::deque<LLPointer<LLMeshSkinInfo>> skin_info_q;
-            std::deque<UUIDBasedRequest> skin_info_unavail_q;
-            std::list<LLModel::Decomposition*> decomp_q;
+            skin_info_q.swap(mSkinInfoQ);
+        }
 
-            if (! mSkinInfoQ.empty())
-            {
-                skin_info_q.swap(mSkinInfoQ);
-            }
+        if (! mDecompositionQ.empty())
+        {
+            decomp_q.swap(mDecompositionQ);
+        }
+        mLoadedMutex->unlock();
 
-            if (! mSkinUnavailableQ.empty())
-            {
-                skin_info_unavail_q.swap(mSkinUnavailableQ);
-            }
+        // Process the elements free of the lock
+        while (! skin_info_q.empty())
+        {
+            gMeshRepo.notifySkinInfoReceived(skin_info_q.front());
+            skin_info_q.pop_front();
+        }
 
-            if (! mDecompositionQ.empty())
-            {
-                decomp_q.swap(mDecompositionQ);
-            }
+        while (! decomp_q.empty())
+        {
+            gMeshRepo.notifyDecompositionReceived(decomp_q.front());
+            decomp_q.pop_front();
+        }
+    }
 
+    if (!mSkinUnavailableQ.empty())
+    {
+        if (mMutex->trylock())
+        {
+            std::deque<UUIDBasedRequest> skin_info_unavail_q;
+            skin_info_unavail_q.swap(mSkinUnavailableQ);
             mMutex->unlock();
 
             // Process the elements free of the lock
-            while (! skin_info_q.empty())
-            {
-                gMeshRepo.notifySkinInfoReceived(skin_info_q.front());
-                skin_info_q.pop_front();
-            }
             while (! skin_info_unavail_q.empty())
             {
                 gMeshRepo.notifySkinInfoUnavailable(skin_info_unavail_q.front().mId);
                 skin_info_unavail_q.pop_front();
             }
-
-            while (! decomp_q.empty())
-            {
-                gMeshRepo.notifyDecompositionReceived(decomp_q.front());
-                decomp_q.pop_front();
-            }
         }
     }
 
@@ -3148,6 +3382,7 @@ void LLMeshHandlerBase::onCompleted(LLCore::HttpHandle handle, LLCore::HttpRespo
         LLCore::BufferArray * body(response->getBody());
         S32 body_offset(0);
         U8 * data(NULL);
+        U8 * data_copy(NULL);
         auto data_size(body ? body->size() : 0);
 
         if (data_size > 0)
@@ -3200,15 +3435,20 @@ void LLMeshHandlerBase::onCompleted(LLCore::HttpHandle handle, LLCore::HttpRespo
                 goto common_exit;
             }
 
-            // *TODO: Try to get rid of data copying and add interfaces
-            // that support BufferArray directly.  Introduce a two-phase
-            // handler, optional first that takes a body, fallback second
-            // that requires a temporary allocation and data copy.
+            // Bodies of known length arrive in one block and are used
+            // in place, otherwise copy them out.
             body_offset = mOffset - offset;
-            data = new(std::nothrow) U8[data_size - body_offset];
+            data = (U8 *) body->contiguous(body_offset, data_size - body_offset);
+            if (! data)
+            {
+                data = data_copy = new(std::nothrow) U8[data_size - body_offset];
+                if (data)
+                {
+                    body->read(body_offset, (char *) data, data_size - body_offset);
+                }
+            }
             if (data)
             {
-                body->read(body_offset, (char *) data, data_size - body_offset);
                 LLMeshRepository::sBytesReceived += static_cast<U32>(data_size);
             }
             else
@@ -3220,7 +3460,7 @@ void LLMeshHandlerBase::onCompleted(LLCore::HttpHandle handle, LLCore::HttpRespo
 
         processData(body, body_offset, data, static_cast<S32>(data_size) - body_offset);
 
-        delete [] data;
+        delete [] data_copy;
     }
 
     // Release handler
@@ -3368,6 +3608,32 @@ void LLMeshHeaderHandler::processData(LLCore::BufferArray * /* body */, S32 /* b
     }
 }
 
+// Response bodies are released with their handler, share or copy what the
+// decode pool still needs.  Null if there is nothing to copy or no memory for it.
+static std::shared_ptr<U8[]> copy_mesh_data(LLCore::BufferArray* body, S32 body_offset, U8* data, S32 data_size)
+{
+    std::shared_ptr<U8[]> buffer;
+    if (body && data && data_size > 0 && (U8*)body->contiguous(body_offset, data_size) == data)
+    {
+        // data is the body itself, keep the body alive instead
+        body->addRef();
+        buffer.reset(data, [body](U8*) { body->release(); });
+    }
+    else if (data && data_size > 0)
+    {
+        buffer.reset(new(std::nothrow) U8[data_size]);
+        if (buffer)
+        {
+            memcpy(buffer.get(), data, data_size);
+        }
+        else
+        {
+            LL_WARNS(LOG_MESH) << "Failed to allocate " << data_size << " bytes for mesh decode" << LL_ENDL;
+        }
+    }
+    return buffer;
+}
+
 LLMeshLODHandler::~LLMeshLODHandler()
 {
     if (! LLApp::isExiting())
@@ -3392,41 +3658,49 @@ void LLMeshLODHandler::processFailure(LLCore::HttpStatus status)
     gMeshRepo.mThread->mUnavailableQ.push_back(LLMeshRepoThread::LODRequest(mMeshParams, mLOD));
 }
 
-void LLMeshLODHandler::processData(LLCore::BufferArray * /* body */, S32 /* body_offset */,
+void LLMeshLODHandler::processData(LLCore::BufferArray * body, S32 body_offset,
                                    U8 * data, S32 data_size)
 {
     LL_PROFILE_ZONE_SCOPED;
+    // Unpacked on the decode pool, which outlives this handler
+    std::shared_ptr<U8[]> buffer = copy_mesh_data(body, body_offset, data, data_size);
     if ((!MESH_LOD_PROCESS_FAILED)
-        && ((data != NULL) == (data_size > 0))) // if we have data but no size or have size but no data, something is wrong
+        && ((data != NULL) == (data_size > 0)) // if we have data but no size or have size but no data, something is wrong
+        && (buffer || !data))
     {
-        EMeshProcessingResult result = gMeshRepo.mThread->lodReceived(mMeshParams, mLOD, data, data_size);
-        if (result == MESH_OK)
-        {
-            // good fetch from sim, write to cache
-            LLFileSystem file(mMeshParams.getSculptID(), LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
-
-            S32 offset = mOffset;
-            S32 size = mRequestedBytes;
-
-            if (file.getSize() >= offset+size)
+        LLVolumeParams mesh_params = mMeshParams;
+        S32 lod = mLOD;
+        S32 offset = mOffset;
+        S32 size = mRequestedBytes;
+        gMeshRepo.mThread->postDecode([mesh_params, lod, offset, size, buffer, data_size]()
             {
-                file.seek(offset);
-                file.write(data, size);
-                LLMeshRepository::sCacheBytesWritten += size;
-                ++LLMeshRepository::sCacheWrites;
-            }
-        }
-        else
-        {
-            LL_WARNS(LOG_MESH) << "Error during mesh LOD processing.  ID:  " << mMeshParams.getSculptID()
-                               << ", Reason: " << result
-                               << " LOD: " << mLOD
-                               << " Data size: " << data_size
-                               << " Not retrying."
-                               << LL_ENDL;
-            LLMutexLock lock(gMeshRepo.mThread->mMutex);
-            gMeshRepo.mThread->mUnavailableQ.push_back(LLMeshRepoThread::LODRequest(mMeshParams, mLOD));
-        }
+                LLMeshRepoThread* thread = gMeshRepo.mThread;
+                EMeshProcessingResult result = thread->lodReceived(mesh_params, lod, buffer.get(), data_size);
+                if (result == MESH_OK)
+                {
+                    // good fetch from sim, write to cache
+                    LLFileSystem file(mesh_params.getSculptID(), LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
+
+                    if (file.getSize() >= offset+size)
+                    {
+                        file.seek(offset);
+                        file.write(buffer.get(), size);
+                        LLMeshRepository::sCacheBytesWritten += size;
+                        ++LLMeshRepository::sCacheWrites;
+                    }
+                }
+                else
+                {
+                    LL_WARNS(LOG_MESH) << "Error during mesh LOD processing.  ID:  " << mesh_params.getSculptID()
+                                       << ", Reason: " << result
+                                       << " LOD: " << lod
+                                       << " Data size: " << data_size
+                                       << " Not retrying."
+                                       << LL_ENDL;
+                    LLMutexLock lock(thread->mMutex);
+                    thread->mUnavailableQ.push_back(LLMeshRepoThread::LODRequest(mesh_params, lod));
+                }
+            });
     }
     else
     {
@@ -3458,27 +3732,44 @@ void LLMeshSkinInfoHandler::processFailure(LLCore::HttpStatus status)
         gMeshRepo.mThread->mSkinUnavailableQ.emplace_back(mMeshID);
 }
 
-void LLMeshSkinInfoHandler::processData(LLCore::BufferArray * /* body */, S32 /* body_offset */,
+void LLMeshSkinInfoHandler::processData(LLCore::BufferArray * body, S32 body_offset,
                                         U8 * data, S32 data_size)
 {
     LL_PROFILE_ZONE_SCOPED;
+    // Unpacked on the decode pool, which outlives this handler
+    std::shared_ptr<U8[]> buffer = copy_mesh_data(body, body_offset, data, data_size);
     if ((!MESH_SKIN_INFO_PROCESS_FAILED)
         && ((data != NULL) == (data_size > 0)) // if we have data but no size or have size but no data, something is wrong
-        && gMeshRepo.mThread->skinInfoReceived(mMeshID, data, data_size))
+        && (buffer || !data))
     {
-        // good fetch from sim, write to cache
-        LLFileSystem file(mMeshID, LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
-
+        LLUUID mesh_id = mMeshID;
         S32 offset = mOffset;
         S32 size = mRequestedBytes;
+        gMeshRepo.mThread->postDecode([mesh_id, offset, size, buffer, data_size]()
+            {
+                LLMeshRepoThread* thread = gMeshRepo.mThread;
+                if (thread->skinInfoReceived(mesh_id, buffer.get(), data_size))
+                {
+                    // good fetch from sim, write to cache
+                    LLFileSystem file(mesh_id, LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
 
-        if (file.getSize() >= offset+size)
-        {
-            LLMeshRepository::sCacheBytesWritten += size;
-            ++LLMeshRepository::sCacheWrites;
-            file.seek(offset);
-            file.write(data, size);
-        }
+                    if (file.getSize() >= offset+size)
+                    {
+                        LLMeshRepository::sCacheBytesWritten += size;
+                        ++LLMeshRepository::sCacheWrites;
+                        file.seek(offset);
+                        file.write(buffer.get(), size);
+                    }
+                }
+                else
+                {
+                    LL_WARNS(LOG_MESH) << "Error during mesh skin info processing.  ID:  " << mesh_id
+                                       << ", Unknown reason.  Not retrying."
+                                       << LL_ENDL;
+                    LLMutexLock lock(thread->mMutex);
+                    thread->mSkinUnavailableQ.emplace_back(mesh_id);
+                }
+            });
     }
     else
     {
@@ -3508,27 +3799,42 @@ void LLMeshDecompositionHandler::processFailure(LLCore::HttpStatus status)
     // request unfulfilled rather than retry forever.
 }
 
-void LLMeshDecompositionHandler::processData(LLCore::BufferArray * /* body */, S32 /* body_offset */,
+void LLMeshDecompositionHandler::processData(LLCore::BufferArray * body, S32 body_offset,
                                              U8 * data, S32 data_size)
 {
     LL_PROFILE_ZONE_SCOPED;
+    // Unpacked on the decode pool, which outlives this handler
+    std::shared_ptr<U8[]> buffer = copy_mesh_data(body, body_offset, data, data_size);
     if ((!MESH_DECOMP_PROCESS_FAILED)
         && ((data != NULL) == (data_size > 0)) // if we have data but no size or have size but no data, something is wrong
-        && gMeshRepo.mThread->decompositionReceived(mMeshID, data, data_size))
+        && (buffer || !data))
     {
-        // good fetch from sim, write to cache
-        LLFileSystem file(mMeshID, LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
-
+        LLUUID mesh_id = mMeshID;
         S32 offset = mOffset;
         S32 size = mRequestedBytes;
+        gMeshRepo.mThread->postDecode([mesh_id, offset, size, buffer, data_size]()
+            {
+                if (gMeshRepo.mThread->decompositionReceived(mesh_id, buffer.get(), data_size))
+                {
+                    // good fetch from sim, write to cache
+                    LLFileSystem file(mesh_id, LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
 
-        if (file.getSize() >= offset+size)
-        {
-            LLMeshRepository::sCacheBytesWritten += size;
-            ++LLMeshRepository::sCacheWrites;
-            file.seek(offset);
-            file.write(data, size);
-        }
+                    if (file.getSize() >= offset+size)
+                    {
+                        LLMeshRepository::sCacheBytesWritten += size;
+                        ++LLMeshRepository::sCacheWrites;
+                        file.seek(offset);
+                        file.write(buffer.get(), size);
+                    }
+                }
+                else
+                {
+                    LL_WARNS(LOG_MESH) << "Error during mesh decomposition processing.  ID:  " << mesh_id
+                                       << ", Unknown reason.  Not retrying."
+                                       << LL_ENDL;
+                    // *TODO:  Mark mesh unavailable on error
+                }
+            });
     }
     else
     {
@@ -3556,27 +3862,42 @@ void LLMeshPhysicsShapeHandler::processFailure(LLCore::HttpStatus status)
     // *TODO:  Mark mesh unavailable on error
 }
 
-void LLMeshPhysicsShapeHandler::processData(LLCore::BufferArray * /* body */, S32 /* body_offset */,
+void LLMeshPhysicsShapeHandler::processData(LLCore::BufferArray * body, S32 body_offset,
                                             U8 * data, S32 data_size)
 {
     LL_PROFILE_ZONE_SCOPED;
+    // Unpacked on the decode pool, which outlives this handler
+    std::shared_ptr<U8[]> buffer = copy_mesh_data(body, body_offset, data, data_size);
     if ((!MESH_PHYS_SHAPE_PROCESS_FAILED)
         && ((data != NULL) == (data_size > 0)) // if we have data but no size or have size but no data, something is wrong
-        && gMeshRepo.mThread->physicsShapeReceived(mMeshID, data, data_size) == MESH_OK)
+        && (buffer || !data))
     {
-        // good fetch from sim, write to cache for caching
-        LLFileSystem file(mMeshID, LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
-
+        LLUUID mesh_id = mMeshID;
         S32 offset = mOffset;
         S32 size = mRequestedBytes;
+        gMeshRepo.mThread->postDecode([mesh_id, offset, size, buffer, data_size]()
+            {
+                if (gMeshRepo.mThread->physicsShapeReceived(mesh_id, buffer.get(), data_size) == MESH_OK)
+                {
+                    // good fetch from sim, write to cache for caching
+                    LLFileSystem file(mesh_id, LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
 
-        if (file.getSize() >= offset+size)
-        {
-            LLMeshRepository::sCacheBytesWritten += size;
-            ++LLMeshRepository::sCacheWrites;
-            file.seek(offset);
-            file.write(data, size);
-        }
+                    if (file.getSize() >= offset+size)
+                    {
+                        LLMeshRepository::sCacheBytesWritten += size;
+                        ++LLMeshRepository::sCacheWrites;
+                        file.seek(offset);
+                        file.write(buffer.get(), size);
+                    }
+                }
+                else
+                {
+                    LL_WARNS(LOG_MESH) << "Error during mesh physics shape processing.  ID:  " << mesh_id
+                                       << ", Unknown reason.  Not retrying."
+                                       << LL_ENDL;
+                    // *TODO:  Mark mesh unavailable on error
+                }
+            });
     }
     else
     {
@@ -3617,8 +3938,14 @@ void LLMeshRepository::init()
 
     metrics_teleport_started_signal = LLViewerMessage::getInstance()->setTeleportStartedCallback(teleport_started);
 
-    mThread = new LLMeshRepoThread();
+    // The repo thread keeps the network side, what it fetches is
+    // unpacked on the decode pool
+    mMeshThreadCount = llclamp(std::thread::hardware_concurrency() / 2, 1U, 8U);
+    mThread = new LLMeshRepoThread(mMeshThreadCount);
+    mMeshThreadCount = mThread->getDecodeThreadCount();
     mThread->start();
+
+    LL_INFOS(LOG_MESH) << "Decoding meshes on " << mMeshThreadCount << " threads" << LL_ENDL;
 }
 
 void LLMeshRepository::shutdown()
@@ -3854,6 +4181,10 @@ void LLMeshRepository::notifyLoadedMeshes()
 
     static LLCachedControl<U32> mesh2_max_req(gSavedSettings, "Mesh2MaxConcurrentRequests");
     LLMeshRepoThread::sMaxConcurrentRequests = mesh2_max_req;
+    static LLCachedControl<bool> use_decoded_cache(gSavedSettings, "MeshUseDecodedCache", true);
+    LLMeshRepoThread::sUseDecodedCache = use_decoded_cache;
+    static LLCachedControl<bool> simplify_flat_lods(gSavedSettings, "MeshSimplifyFlatLODs", false);
+    LLMeshRepoThread::sSimplifyFlatLODs = simplify_flat_lods;
     LLMeshRepoThread::sRequestHighWater = llclamp(scale * S32(LLMeshRepoThread::sMaxConcurrentRequests),
                                                   REQUEST2_HIGH_WATER_MIN,
                                                   REQUEST2_HIGH_WATER_MAX);
@@ -3961,6 +4292,7 @@ void LLMeshRepository::notifyLoadedMeshes()
             // erase from background thread
             mThread->mWorkQueue.post([=]()
                 {
+                    LLMutexLock lock(mThread->mSkinMapMutex);
                     mThread->mSkinMap.erase(id);
                 });
         }
@@ -4017,6 +4349,11 @@ void LLMeshRepository::notifyLoadedMeshes()
             mUploadErrorQ.pop();
         }
 
+        if (mCancelRequestsTimer.checkExpirationAndReset(MESH_CANCEL_REQUESTS_INTERVAL))
+        {
+            cancelOutOfViewRequests();
+        }
+
         S32 active_count = LLMeshRepoThread::sActiveHeaderRequests + LLMeshRepoThread::sActiveLODRequests;
         if (active_count < LLMeshRepoThread::sRequestLowWater)
         {
@@ -4025,42 +4362,18 @@ void LLMeshRepository::notifyLoadedMeshes()
             if (mPendingRequests.size() > push_count)
             {
                 // More requests than the high-water limit allows so
-                // sort and forward the most important.
-
-                //calculate "score" for pending requests
-
-                //create score map
-                std::map<LLUUID, F32> score_map;
-
-                for (U32 i = 0; i < LLVolumeLODGroup::NUM_LODS; ++i)
+                // sort and forward the ones that take away the most
+                // screen-space error per byte, those in view first.
                 {
-                    for (mesh_load_map::iterator iter = mLoadingMeshes[i].begin();  iter != mLoadingMeshes[i].end(); ++iter)
+                    LLMutexLock header_lock(mThread->mHeaderMutex);
+                    for (LLMeshRepoThread::LODRequest& request : mPendingRequests)
                     {
-                        F32 max_score = 0.f;
-                        for (auto obj_iter = iter->second.begin(); obj_iter != iter->second.end(); ++obj_iter)
-                        {
-                            LLVOVolume* object = *obj_iter;
-                            if (object)
-                            {
-                                LLDrawable* drawable = object->mDrawable;
-                                if (drawable)
-                                {
-                                    F32 cur_score = drawable->getRadius()/llmax(drawable->mDistanceWRTCamera, 1.f);
-                                    max_score = llmax(max_score, cur_score);
-                                }
-                            }
-                        }
-
-                        score_map[iter->first] = max_score;
+                        bool in_view = false;
+                        F32 score = getLODRequestScore(request, in_view);
+                        request.mScore = in_view ? score : -1.f;
                     }
                 }
 
-                //set "score" for pending requests
-                for (std::vector<LLMeshRepoThread::LODRequest>::iterator iter = mPendingRequests.begin(); iter != mPendingRequests.end(); ++iter)
-                {
-                    iter->mScore = score_map[iter->mMeshParams.getSculptID()];
-                }
-
                 //sort by "score"
                 std::partial_sort(mPendingRequests.begin(), mPendingRequests.begin() + push_count,
                                   mPendingRequests.end(), LLMeshRepoThread::CompareScoreGreater());
@@ -4180,7 +4493,15 @@ void LLMeshRepository::notifyMeshLoaded(const LLVolumeParams& mesh_params, LLVol
             LLVolume* sys_volume = LLPrimitive::getVolumeManager()->refVolume(mesh_params, detail);
             if (sys_volume)
             {
-                sys_volume->copyVolumeFaces(volume);
+                // Nothing else holds the decoded volume, don't copy it
+                if (volume->getNumRefs() == 1)
+                {
+                    sys_volume->takeVolumeFaces(volume);
+                }
+                else
+                {
+                    sys_volume->copyVolumeFaces(volume);
+                }
                 sys_volume->setMeshAssetLoaded(true);
                 LLPrimitive::getVolumeManager()->unrefVolume(sys_volume);
             }
@@ -4462,6 +4783,104 @@ void LLMeshRepository::uploadModel(std::vector<LLModelInstance>& data, LLVector3
     mUploadWaitList.push_back(thread);
 }
 
+F32 LLMeshRepository::getLODRequestScore(const LLMeshRepoThread::LODRequest& request, bool& in_view)
+{
+    const LLUUID& mesh_id = request.mMeshParams.getSculptID();
+    mesh_load_map::iterator iter = mLoadingMeshes[request.mLOD].find(mesh_id);
+    if (iter == mLoadingMeshes[request.mLOD].end())
+    {
+        // Nobody to show it to, leave it where it is
+        in_view = true;
+        return 0.f;
+    }
+
+    F32 error_reduction = 0.f;
+    in_view = false;
+    for (LLVOVolume* object : iter->second)
+    {
+        LLDrawable* drawable = object ? object->mDrawable.get() : NULL;
+        if (!drawable)
+        {
+            continue;
+        }
+
+        // Attachments are drawn with their avatar, always keep them going
+        in_view |= object->isAttachment()
+            || LLDrawable::getCurrentFrame() - (S32)drawable->getVisible() < MESH_OUT_OF_VIEW_FRAMES;
+
+        F32 reduction = object->getMeshLODError(object->getLoadedMeshLOD()) - object->getMeshLODError(request.mLOD);
+        error_reduction = llmax(error_reduction, reduction);
+    }
+
+    S32 bytes = MESH_UNKNOWN_LOD_BYTES;
+    LLMeshRepoThread::mesh_header_map::iterator header_iter = mThread->mMeshHeader.find(mesh_id);
+    if (header_iter != mThread->mMeshHeader.end() && header_iter->second.first > 0)
+    {
+        const LLMeshHeader& header = header_iter->second.second;
+        if (!header.m404 && header.mLodSize[request.mLOD] > 0)
+        {
+            bytes = header.mLodSize[request.mLOD];
+        }
+    }
+
+    return error_reduction * 1024.f / (F32)llmax(bytes, 1024);
+}
+
+void LLMeshRepository::cancelOutOfViewRequests()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    if (mThread->mLODReqQ.empty() || mPendingRequests.empty())
+    {
+        return;
+    }
+
+    LLMutexLock header_lock(mThread->mHeaderMutex);
+
+    // Only worth it if something in view is waiting for the slots
+    bool in_view_waiting = false;
+    for (const LLMeshRepoThread::LODRequest& request : mPendingRequests)
+    {
+        getLODRequestScore(request, in_view_waiting);
+        if (in_view_waiting)
+        {
+            break;
+        }
+    }
+    if (!in_view_waiting)
+    {
+        return;
+    }
+
+    std::queue<LLMeshRepoThread::LODRequest> keep;
+    U32 canceled = 0;
+    while (!mThread->mLODReqQ.empty())
+    {
+        const LLMeshRepoThread::LODRequest& request = mThread->mLODReqQ.front();
+        bool in_view = false;
+        getLODRequestScore(request, in_view);
+        if (in_view)
+        {
+            keep.push(request);
+        }
+        else
+        {
+            // Keeps its retry state for when it is sent again
+            mPendingRequests.push_back(request);
+            LLMeshRepository::sLODProcessing--;
+            LLMeshRepository::sLODPending++;
+            ++canceled;
+        }
+        mThread->mLODReqQ.pop();
+    }
+    mThread->mLODReqQ.swap(keep);
+
+    if (canceled)
+    {
+        LL_DEBUGS(LOG_MESH) << "Took back " << canceled << " LOD requests for meshes out of view" << LL_ENDL;
+    }
+}
+
 S32 LLMeshRepository::getMeshSize(const LLUUID& mesh_id, S32 lod)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
@@ -32,6 +32,7 @@
 #include "llassettype.h"
 #include "llmodel.h"
 #include "lluuid.h"
+#include "lluuidhashmap.h"
 #include "llviewertexture.h"
 #include "llvolume.h"
 #include "lldeadmantimer.h"
@@ -41,6 +42,7 @@
 #include "httpheaders.h"
 #include "httphandler.h"
 #include "llthread.h"
+#include "threadpool_fwd.h"
 
 #define LLCONVEXDECOMPINTER_STATIC 1
 
@@ -262,9 +264,13 @@ public:
     static S32 sRequestLowWater;
     static S32 sRequestHighWater;
     static S32 sRequestWaterLevel;          // Stats-use only, may read outside of thread
+    static bool sUseDecodedCache;           // "MeshUseDecodedCache", set by main thread
+    static bool sSimplifyFlatLODs;          // "MeshSimplifyFlatLODs", set by main thread
 
     LLMutex*    mMutex;
     LLMutex*    mHeaderMutex;
+    LLMutex*    mLoadedMutex;       // mLoadedQ, mSkinInfoQ and mDecompositionQ
+    LLMutex*    mSkinMapMutex;      // mSkinMap
     LLCondition* mSignal;
 
     //map of known mesh headers
@@ -374,12 +380,17 @@ public:
 
     // map of mesh ID to skin info (mirrors LLMeshRepository::mSkinMap)
     /// NOTE: LLMeshRepository::mSkinMap is accessed very frequently, so maintain a copy here to avoid mutex overhead
-    typedef std::unordered_map<LLUUID, LLPointer<LLMeshSkinInfo>> skin_map;
+    typedef LLUUIDHashMap<LLPointer<LLMeshSkinInfo>> skin_map;
     skin_map mSkinMap;
 
     // workqueue for processing generic requests
     LL::WorkQueue mWorkQueue;
 
+    // Unpacks LOD, skin info, decomposition and physics shape data off the
+    // repo thread, which is left with the network side. Null when the pool
+    // is configured to 0 threads, see postDecode().
+    std::unique_ptr<LL::ThreadPool> mDecodePool;
+
     // llcorehttp library interface objects.
     LLCore::HttpStatus                  mHttpStatus;
     LLCore::HttpRequest *               mHttpRequest;
@@ -394,7 +405,7 @@ public:
 
     std::string mGetMeshCapability;
 
-    LLMeshRepoThread();
+    LLMeshRepoThread(U32 decode_threads);
     ~LLMeshRepoThread();
 
     virtual void run();
@@ -405,7 +416,8 @@ public:
     bool fetchMeshHeader(const LLVolumeParams& mesh_params, bool can_retry = true);
     bool fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool can_retry = true);
     EMeshProcessingResult headerReceived(const LLVolumeParams& mesh_params, U8* data, S32 data_size);
-    EMeshProcessingResult lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size);
+    // decoded = true -> data is a LLVolume::packDecodedFaces() copy
+    EMeshProcessingResult lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size, bool decoded = false);
     bool skinInfoReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
     bool decompositionReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
     EMeshProcessingResult physicsShapeReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
@@ -446,7 +458,40 @@ public:
     // Mutex:  acquires mMutex
     void constructUrl(LLUUID mesh_id, std::string * url);
 
+    // Runs 'decode' on the decode pool, or right away when there is no
+    // pool.  Returns false if the pool is shutting down and 'decode' was
+    // dropped.
+    //
+    // Threads:  Repo thread only
+    bool postDecode(const std::function<void()>& decode);
+
+    // Width of the decode pool, 0 if decoding runs on the repo thread
+    U32 getDecodeThreadCount() const;
+
 private:
+    // HTTP halves of fetchMeshLOD() and fetchMeshSkinInfo(), for when the
+    // cache has nothing usable.
+    //
+    // Threads:  Repo thread only
+    bool fetchMeshLODFromSim(const LLVolumeParams& mesh_params, S32 lod, S32 offset, S32 size, bool can_retry);
+
+    // Decoded LOD cache: what lodReceived() unpacked, kept in the disk
+    // cache next to the asset so a later visit skips unzipping and parsing.
+    // fetchDecodedMeshLOD() returns false if there is no such copy.
+    //
+    // Threads:  Repo thread only
+    bool fetchDecodedMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool can_retry);
+    static LLUUID getDecodedCacheID(const LLVolumeParams& mesh_params, S32 lod, bool simplified = false);
+
+    // Flat LODs: low LODs nearly as heavy as the high LOD, which this viewer
+    // may replace with a simplified copy of its own. The copy only lives in
+    // the decoded LOD cache and is never uploaded. Returns the share of the
+    // triangles to keep, or 0 if 'lod' is fine as it is.
+    //
+    // Threads:  Repo and decode threads (takes mHeaderMutex)
+    F32 getFlatLODRatio(const LLUUID& mesh_id, S32 lod);
+    bool fetchMeshSkinInfoFromSim(const LLUUID& mesh_id, S32 offset, S32 size, bool can_retry);
+
     // Issue a GET request to a URL with 'Range' header using
     // the correct policy class and other attributes.  If an invalid
     // handle is returned, the request failed and caller must retry
@@ -689,7 +734,7 @@ public:
     typedef boost::unordered_map<LLUUID, std::vector<LLVOVolume*> > mesh_load_map;
     mesh_load_map mLoadingMeshes[4];
 
-    typedef std::unordered_map<LLUUID, LLPointer<LLMeshSkinInfo>> skin_map;
+    typedef LLUUIDHashMap<LLPointer<LLMeshSkinInfo>> skin_map;
     skin_map mSkinMap;
 
     typedef std::map<LLUUID, LLModel::Decomposition*> decomposition_map;
@@ -699,6 +744,19 @@ public:
 
     std::vector<LLMeshRepoThread::LODRequest> mPendingRequests;
 
+    // Screen-space error, in pixels, that 'request' takes away per KB of
+    // mesh data to fetch, best of the objects waiting on it. 'in_view' is
+    // set if one of them was on screen recently.
+    // Mutex:  must be holding mMeshMutex and mThread->mHeaderMutex.
+    F32 getLODRequestScore(const LLMeshRepoThread::LODRequest& request, bool& in_view);
+
+    // Takes the LOD requests the repo thread has not sent yet back into
+    // mPendingRequests when their objects left view and requests in view
+    // are waiting.
+    // Mutex:  must be holding mMeshMutex and mThread->mMutex.
+    void cancelOutOfViewRequests();
+    LLFrameTimer mCancelRequestsTimer;
+
     //list of mesh ids awaiting skin info
     typedef boost::unordered_map<LLUUID, std::vector<LLVOVolume*> > skin_load_map;
     skin_load_map mLoadingSkins;
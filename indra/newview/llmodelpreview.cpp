@@ -43,6 +43,7 @@
 #include "llmatrix4a.h"
 #include "llmeshrepository.h"
 #include "llmeshoptimizer.h"
+#include "llparallel.h"
 #include "llrender.h"
 #include "llsdutil_math.h"
 #include "llskinningutil.h"
@@ -1891,6 +1892,8 @@ void LLModelPreview::genMeshOptimizerLODs(S32 which_lod, S32 meshopt_mode, U32 d
         end = which_lod;
     }
 
+    // lod and decimator of each lod to build
+    std::vector<std::pair<S32, F32>> lod_decimators;
     for (S32 lod = start; lod >= end; --lod)
     {
         if (which_lod == -1)
@@ -1911,220 +1914,238 @@ void LLModelPreview::genMeshOptimizerLODs(S32 which_lod, S32 meshopt_mode, U32 d
         mModel[lod].resize(mBaseModel.size());
         mVertexBuffer[lod].clear();
 
+        lod_decimators.emplace_back(lod, indices_decimator);
+    }
 
-        for (U32 mdl_idx = 0; mdl_idx < mBaseModel.size(); ++mdl_idx)
+    // Every lod of every model is simplified from the base model alone, so
+    // they can all be built side by side
+    size_t model_count = mBaseModel.size();
+    LL::parallel_for(size_t(0), lod_decimators.size() * model_count, size_t(1),
+        [&](size_t first, size_t last)
         {
-            LLModel* base = mBaseModel[mdl_idx];
-
-            LLVolumeParams volume_params;
-            volume_params.setType(LL_PCODE_PROFILE_SQUARE, LL_PCODE_PATH_LINE);
-            mModel[lod][mdl_idx] = new LLModel(volume_params, 0.f);
-
-            std::string name = base->mLabel + getLodSuffix(lod);
-
-            mModel[lod][mdl_idx]->mLabel = name;
-            mModel[lod][mdl_idx]->mSubmodelID = base->mSubmodelID;
-            mModel[lod][mdl_idx]->setNumVolumeFaces(base->getNumVolumeFaces());
-
-            LLModel* target_model = mModel[lod][mdl_idx];
-
-            // carry over normalized transform into simplified model
-            for (S32 i = 0; i < base->getNumVolumeFaces(); ++i)
+            for (size_t i = first; i < last; ++i)
             {
-                LLVolumeFace& src = base->getVolumeFace(i);
-                LLVolumeFace& dst = target_model->getVolumeFace(i);
-                dst.mNormalizedScale = src.mNormalizedScale;
+                const auto& [lod, lod_decimator] = lod_decimators[i / model_count];
+                genMeshOptimizerModelLOD(lod, (U32)(i % model_count), meshopt_mode, lod_mode, decimation,
+                                         lod_decimator, lod_error_threshold);
             }
+        });
 
-            S32 model_meshopt_mode = meshopt_mode;
+    for (S32 lod = start; lod >= end; --lod)
+    {
+        //rebuild scene based on mBaseScene
+        mScene[lod].clear();
+        mScene[lod] = mBaseScene;
 
-            // Ideally this should run not per model,
-            // but combine all submodels with origin model as well
-            if (model_meshopt_mode == MESH_OPTIMIZER_PRECISE)
+        for (U32 i = 0; i < mBaseModel.size(); ++i)
+        {
+            LLModel* mdl = mBaseModel[i];
+            LLModel* target = mModel[lod][i];
+            if (target)
             {
-                // Run meshoptimizer for each face
-                for (S32 face_idx = 0; face_idx < base->getNumVolumeFaces(); ++face_idx)
+                for (LLModelLoader::scene::iterator iter = mScene[lod].begin(); iter != mScene[lod].end(); ++iter)
                 {
-                    F32 res = genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
-                    if (res < 0)
+                    for (U32 j = 0; j < iter->second.size(); ++j)
                     {
-                        // Mesh optimizer failed and returned an invalid model
-                        const LLVolumeFace &face = base->getVolumeFace(face_idx);
-                        LLVolumeFace &new_face = target_model->getVolumeFace(face_idx);
-                        new_face = face;
+                        if (iter->second[j].mModel == mdl)
+                        {
+                            iter->second[j].mModel = target;
+                        }
                     }
                 }
             }
+        }
+    }
+}
+
+void LLModelPreview::genMeshOptimizerModelLOD(S32 lod, U32 mdl_idx, S32 meshopt_mode, U32 lod_mode, U32 decimation, F32 indices_decimator, F32 lod_error_threshold)
+{
+    LLModel* base = mBaseModel[mdl_idx];
+
+    LLVolumeParams volume_params;
+    volume_params.setType(LL_PCODE_PROFILE_SQUARE, LL_PCODE_PATH_LINE);
+    mModel[lod][mdl_idx] = new LLModel(volume_params, 0.f);
 
-            if (model_meshopt_mode == MESH_OPTIMIZER_SLOPPY)
+    std::string name = base->mLabel + getLodSuffix(lod);
+
+    mModel[lod][mdl_idx]->mLabel = name;
+    mModel[lod][mdl_idx]->mSubmodelID = base->mSubmodelID;
+    mModel[lod][mdl_idx]->setNumVolumeFaces(base->getNumVolumeFaces());
+
+    LLModel* target_model = mModel[lod][mdl_idx];
+
+    // carry over normalized transform into simplified model
+    for (S32 i = 0; i < base->getNumVolumeFaces(); ++i)
+    {
+        LLVolumeFace& src = base->getVolumeFace(i);
+        LLVolumeFace& dst = target_model->getVolumeFace(i);
+        dst.mNormalizedScale = src.mNormalizedScale;
+    }
+
+    S32 model_meshopt_mode = meshopt_mode;
+
+    // Ideally this should run not per model,
+    // but combine all submodels with origin model as well
+    if (model_meshopt_mode == MESH_OPTIMIZER_PRECISE)
+    {
+        // Run meshoptimizer for each face
+        for (S32 face_idx = 0; face_idx < base->getNumVolumeFaces(); ++face_idx)
+        {
+            F32 res = genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
+            if (res < 0)
             {
-                // Run meshoptimizer for each face
-                for (S32 face_idx = 0; face_idx < base->getNumVolumeFaces(); ++face_idx)
-                {
-                    if (genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY) < 0)
-                    {
-                        // Sloppy failed and returned an invalid model
-                        genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
-                    }
-                }
+                // Mesh optimizer failed and returned an invalid model
+                const LLVolumeFace &face = base->getVolumeFace(face_idx);
+                LLVolumeFace &new_face = target_model->getVolumeFace(face_idx);
+                new_face = face;
             }
+        }
+    }
 
-            if (model_meshopt_mode == MESH_OPTIMIZER_AUTO)
+    if (model_meshopt_mode == MESH_OPTIMIZER_SLOPPY)
+    {
+        // Run meshoptimizer for each face
+        for (S32 face_idx = 0; face_idx < base->getNumVolumeFaces(); ++face_idx)
+        {
+            if (genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY) < 0)
             {
-                // Remove progressively more data if we can't reach the target.
-                F32 allowed_ratio_drift = 1.8f;
-                F32 precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
+                // Sloppy failed and returned an invalid model
+                genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
+            }
+        }
+    }
 
-                if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
-                {
-                    precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_NORMALS);
-                }
+    if (model_meshopt_mode == MESH_OPTIMIZER_AUTO)
+    {
+        // Remove progressively more data if we can't reach the target.
+        F32 allowed_ratio_drift = 1.8f;
+        F32 precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
 
-                if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
-                {
-                    precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_UVS);
-                }
+        if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
+        {
+            precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_NORMALS);
+        }
 
-                if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
-                {
-                    // Try sloppy variant if normal one failed to simplify model enough.
-                    // Sloppy variant can fail entirely and has issues with precision,
-                    // so code needs to do multiple attempts with different decimators.
-                    // Todo: this is a bit of a mess, needs to be refined and improved
+        if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
+        {
+            precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_UVS);
+        }
 
-                    F32 last_working_decimator = 0.f;
-                    F32 last_working_ratio = F32_MAX;
+        if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
+        {
+            // Try sloppy variant if normal one failed to simplify model enough.
+            // Sloppy variant can fail entirely and has issues with precision,
+            // so code needs to do multiple attempts with different decimators.
+            // Todo: this is a bit of a mess, needs to be refined and improved
 
-                    F32 sloppy_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
+            F32 last_working_decimator = 0.f;
+            F32 last_working_ratio = F32_MAX;
 
-                    if (sloppy_ratio > 0)
-                    {
-                        // Would be better to do a copy of target_model here, but if
-                        // we need to use sloppy decimation, model should be cheap
-                        // and fast to generate and it won't affect end result
-                        last_working_decimator = indices_decimator;
-                        last_working_ratio = sloppy_ratio;
-                    }
+            F32 sloppy_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
 
-                    // Sloppy has a tendecy to error into lower side, so a request for 100
-                    // triangles turns into ~70, so check for significant difference from target decimation
-                    F32 sloppy_ratio_drift = 1.4f;
-                    if (lod_mode == LIMIT_TRIANGLES
-                        && (sloppy_ratio > indices_decimator * sloppy_ratio_drift || sloppy_ratio < 0))
-                    {
-                        // Apply a correction to compensate.
+            if (sloppy_ratio > 0)
+            {
+                // Would be better to do a copy of target_model here, but if
+                // we need to use sloppy decimation, model should be cheap
+                // and fast to generate and it won't affect end result
+                last_working_decimator = indices_decimator;
+                last_working_ratio = sloppy_ratio;
+            }
+
+            // Sloppy has a tendecy to error into lower side, so a request for 100
+            // triangles turns into ~70, so check for significant difference from target decimation
+            F32 sloppy_ratio_drift = 1.4f;
+            if (lod_mode == LIMIT_TRIANGLES
+                && (sloppy_ratio > indices_decimator * sloppy_ratio_drift || sloppy_ratio < 0))
+            {
+                // Apply a correction to compensate.
 
-                        // (indices_decimator / res_ratio) by itself is likely to overshoot to a differend
-                        // side due to overal lack of precision, and we don't need an ideal result, which
-                        // likely does not exist, just a better one, so a partial correction is enough.
-                        F32 sloppy_decimator = indices_decimator * (indices_decimator / sloppy_ratio + 1) / 2;
-                        sloppy_ratio = genMeshOptimizerPerModel(base, target_model, sloppy_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
-                    }
+                // (indices_decimator / res_ratio) by itself is likely to overshoot to a differend
+                // side due to overal lack of precision, and we don't need an ideal result, which
+                // likely does not exist, just a better one, so a partial correction is enough.
+                F32 sloppy_decimator = indices_decimator * (indices_decimator / sloppy_ratio + 1) / 2;
+                sloppy_ratio = genMeshOptimizerPerModel(base, target_model, sloppy_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
+            }
 
-                    if (last_working_decimator > 0 && sloppy_ratio < last_working_ratio)
-                    {
-                        // Compensation didn't work, return back to previous decimator
-                        sloppy_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
-                    }
+            if (last_working_decimator > 0 && sloppy_ratio < last_working_ratio)
+            {
+                // Compensation didn't work, return back to previous decimator
+                sloppy_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
+            }
 
-                    if (sloppy_ratio < 0)
+            if (sloppy_ratio < 0)
+            {
+                // Sloppy method didn't work, try with smaller decimation values
+                {
+                    // Find a decimator that does work
+                    F32 sloppy_decimation_step = sqrt((F32)decimation); // example: 27->15->9->5->3
+                    F32 sloppy_decimator = indices_decimator / sloppy_decimation_step;
+                    U64Microseconds end_time = LLTimer::getTotalTime() + U64Seconds(5);
+
+                    while (sloppy_ratio < 0
+                        && sloppy_decimator > precise_ratio
+                        && sloppy_decimator > 1 // precise_ratio isn't supposed to be below 1, but check just in case
+                        && end_time > LLTimer::getTotalTime())
                     {
-                        // Sloppy method didn't work, try with smaller decimation values
-                        {
-                            // Find a decimator that does work
-                            F32 sloppy_decimation_step = sqrt((F32)decimation); // example: 27->15->9->5->3
-                            F32 sloppy_decimator = indices_decimator / sloppy_decimation_step;
-                            U64Microseconds end_time = LLTimer::getTotalTime() + U64Seconds(5);
-
-                            while (sloppy_ratio < 0
-                                && sloppy_decimator > precise_ratio
-                                && sloppy_decimator > 1 // precise_ratio isn't supposed to be below 1, but check just in case
-                                && end_time > LLTimer::getTotalTime())
-                            {
-                                sloppy_ratio = genMeshOptimizerPerModel(base, target_model, sloppy_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
-                                sloppy_decimator = sloppy_decimator / sloppy_decimation_step;
-                            }
-                        }
+                        sloppy_ratio = genMeshOptimizerPerModel(base, target_model, sloppy_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
+                        sloppy_decimator = sloppy_decimator / sloppy_decimation_step;
                     }
+                }
+            }
 
-                    if (sloppy_ratio < 0 || sloppy_ratio < precise_ratio)
-                    {
-                        // Sloppy variant failed to generate triangles or is worse.
-                        // Can happen with models that are too simple as is.
-
-                        if (precise_ratio < 0)
-                        {
-                            // Precise method failed as well, just copy face over
-                            target_model->copyVolumeFaces(base);
-                            precise_ratio = 1.f;
-                        }
-                        else
-                        {
-                            // Fallback to normal method
-                            precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
-                        }
+            if (sloppy_ratio < 0 || sloppy_ratio < precise_ratio)
+            {
+                // Sloppy variant failed to generate triangles or is worse.
+                // Can happen with models that are too simple as is.
 
-                        LL_INFOS() << "Model " << target_model->getName()
-                            << " lod " << which_lod
-                            << " resulting ratio " << precise_ratio
-                            << " simplified using per model method." << LL_ENDL;
-                    }
-                    else
-                    {
-                        LL_INFOS() << "Model " << target_model->getName()
-                            << " lod " << which_lod
-                            << " resulting ratio " << sloppy_ratio
-                            << " sloppily simplified using per model method." << LL_ENDL;
-                    }
+                if (precise_ratio < 0)
+                {
+                    // Precise method failed as well, just copy face over
+                    target_model->copyVolumeFaces(base);
+                    precise_ratio = 1.f;
                 }
                 else
                 {
-                    LL_INFOS() << "Model " << target_model->getName()
-                        << " lod " << which_lod
-                        << " resulting ratio " << precise_ratio
-                        << " simplified using per model method." << LL_ENDL;
+                    // Fallback to normal method
+                    precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
                 }
-            }
 
-            //blind copy skin weights and just take closest skin weight to point on
-            //decimated mesh for now (auto-generating LODs with skin weights is still a bit
-            //of an open problem).
-            target_model->mPosition = base->mPosition;
-            target_model->mSkinWeights = base->mSkinWeights;
-            target_model->mSkinInfo = base->mSkinInfo;
-
-            //copy material list
-            target_model->mMaterialList = base->mMaterialList;
-
-            if (!validate_model(target_model))
+                LL_INFOS() << "Model " << target_model->getName()
+                    << " lod " << lod
+                    << " resulting ratio " << precise_ratio
+                    << " simplified using per model method." << LL_ENDL;
+            }
+            else
             {
-                LL_ERRS() << "Invalid model generated when creating LODs" << LL_ENDL;
+                LL_INFOS() << "Model " << target_model->getName()
+                    << " lod " << lod
+                    << " resulting ratio " << sloppy_ratio
+                    << " sloppily simplified using per model method." << LL_ENDL;
             }
         }
-
-        //rebuild scene based on mBaseScene
-        mScene[lod].clear();
-        mScene[lod] = mBaseScene;
-
-        for (U32 i = 0; i < mBaseModel.size(); ++i)
+        else
         {
-            LLModel* mdl = mBaseModel[i];
-            LLModel* target = mModel[lod][i];
-            if (target)
-            {
-                for (LLModelLoader::scene::iterator iter = mScene[lod].begin(); iter != mScene[lod].end(); ++iter)
-                {
-                    for (U32 j = 0; j < iter->second.size(); ++j)
-                    {
-                        if (iter->second[j].mModel == mdl)
-                        {
-                            iter->second[j].mModel = target;
-                        }
-                    }
-                }
-            }
+            LL_INFOS() << "Model " << target_model->getName()
+                << " lod " << lod
+                << " resulting ratio " << precise_ratio
+                << " simplified using per model method." << LL_ENDL;
         }
     }
+
+    //blind copy skin weights and just take closest skin weight to point on
+    //decimated mesh for now (auto-generating LODs with skin weights is still a bit
+    //of an open problem).
+    target_model->mPosition = base->mPosition;
+    target_model->mSkinWeights = base->mSkinWeights;
+    target_model->mSkinInfo = base->mSkinInfo;
+
+    //copy material list
+    target_model->mMaterialList = base->mMaterialList;
+
+    if (!validate_model(target_model))
+    {
+        LL_ERRS() << "Invalid model generated when creating LODs" << LL_ENDL;
+    }
 }
 
 void LLModelPreview::updateStatusMessages()
@@ -257,6 +257,9 @@ private:
     // Simplifies specified face using mesh optimizer.
     // Returns reached simplification ratio. -1 in case of a failure.
     F32 genMeshOptimizerPerFace(LLModel *base_model, LLModel *target_model, U32 face_idx, F32 indices_ratio, F32 error_threshold, eSimplificationMode simplification_mode);
+    // Builds mModel[lod][mdl_idx] from mBaseModel[mdl_idx]. Doesn't touch
+    // anything else, so it can run for several models and lods at once.
+    void genMeshOptimizerModelLOD(S32 lod, U32 mdl_idx, S32 meshopt_mode, U32 lod_mode, U32 decimation, F32 indices_decimator, F32 lod_error_threshold);
 
 protected:
     friend class LLModelLoader;
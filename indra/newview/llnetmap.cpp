@@ -536,6 +536,9 @@ void LLNetMap::draw()
     gGL.popUIMatrix();
 
     LLUICtrl::draw();
+
+    // follows the camera and everyone around, never retained
+    dirtyRect();
 }
 
 void LLNetMap::reshape(S32 width, S32 height, bool called_from_parent)
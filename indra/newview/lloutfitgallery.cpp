@@ -59,6 +59,8 @@ static LLPanelInjector<LLOutfitGallery> t_outfit_gallery("outfit_gallery");
 #define MAX_OUTFIT_PHOTO_HEIGHT 256
 
 const S32 GALLERY_ITEMS_PER_ROW_MIN = 2;
+// Mouse just passing over an outfit isn't worth its wearables
+const F32 OUTFIT_PREFETCH_HOVER_DELAY = 0.5f;
 
 LLOutfitGallery::LLOutfitGallery(const LLOutfitGallery::Params& p)
     : LLOutfitListBase(),
@@ -943,6 +945,7 @@ LLOutfitGalleryItem::LLOutfitGalleryItem(const Params& p)
     mSelected(false),
     mWorn(false),
     mDefaultImage(true),
+    mPrefetchPending(false),
     mOutfitName(""),
     mUUID(LLUUID())
 {
@@ -969,6 +972,12 @@ bool LLOutfitGalleryItem::postBuild()
 
 void LLOutfitGalleryItem::draw()
 {
+    if (mPrefetchPending && mHoverTimer.getElapsedTimeF32() > OUTFIT_PREFETCH_HOVER_DELAY)
+    {
+        mPrefetchPending = false;
+        LLAppearanceMgr::instance().prefetchOutfit(mUUID);
+    }
+
     LLPanel::draw();
 
     // Draw border
@@ -1031,6 +1040,10 @@ void LLOutfitGalleryItem::setSelected(bool value)
     mSelected = value;
     mTextBgPanel->setBackgroundVisible(value);
     setOutfitWorn(mWorn);
+    if (value && mUUID.notNull())
+    {
+        LLAppearanceMgr::instance().prefetchOutfit(mUUID);
+    }
 }
 
 bool LLOutfitGalleryItem::handleMouseDown(S32 x, S32 y, MASK mask)
@@ -1045,6 +1058,19 @@ bool LLOutfitGalleryItem::handleRightMouseDown(S32 x, S32 y, MASK mask)
     return LLUICtrl::handleRightMouseDown(x, y, mask);
 }
 
+void LLOutfitGalleryItem::onMouseEnter(S32 x, S32 y, MASK mask)
+{
+    mPrefetchPending = true;
+    mHoverTimer.reset();
+    LLPanel::onMouseEnter(x, y, mask);
+}
+
+void LLOutfitGalleryItem::onMouseLeave(S32 x, S32 y, MASK mask)
+{
+    mPrefetchPending = false;
+    LLPanel::onMouseLeave(x, y, mask);
+}
+
 bool LLOutfitGalleryItem::handleDoubleClick(S32 x, S32 y, MASK mask)
 {
     return openOutfitsContent() || LLPanel::handleDoubleClick(x, y, mask);
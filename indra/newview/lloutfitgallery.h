@@ -233,6 +233,8 @@ public:
     /*virtual*/ bool handleRightMouseDown(S32 x, S32 y, MASK mask);
     /*virtual*/ bool handleDoubleClick(S32 x, S32 y, MASK mask);
     /*virtual*/ bool handleKeyHere(KEY key, MASK mask);
+    /*virtual*/ void onMouseEnter(S32 x, S32 y, MASK mask);
+    /*virtual*/ void onMouseLeave(S32 x, S32 y, MASK mask);
     /*virtual*/ void onFocusLost();
     /*virtual*/ void onFocusReceived();
 
@@ -268,6 +270,8 @@ private:
     bool     mDefaultImage;
     bool     mImageUpdatePending;
     bool     mHidden;
+    bool     mPrefetchPending; // hovered, prefetch once it's been long enough
+    LLFrameTimer mHoverTimer;
     std::string mOutfitName;
 };
 
@@ -168,6 +168,9 @@ public:
         }
     }
 
+    // tabs are created on any change, not only additions
+    /*virtual*/ U32 getInterestMask() const { return ALL; }
+
 protected:
     /*virtual*/ void done()
     {
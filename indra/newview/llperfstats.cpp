@@ -27,6 +27,7 @@
 #include "llviewerprecompiledheaders.h"
 #include "llperfstats.h"
 #include "llcontrol.h"
+#include "llgpupasstimers.h"
 #include "pipeline.h"
 #include "llagentcamera.h"
 #include "llviewerwindow.h"
@@ -72,6 +73,7 @@ namespace LLPerfStats
         if( tuningFlag & NonImpostors ){ gSavedSettings.setU32("RenderAvatarMaxNonImpostors", nonImpostors); };
         if( tuningFlag & ReflectionDetail ){ gSavedSettings.setS32("RenderReflectionDetail", reflectionDetail); };
         if( tuningFlag & FarClip ){ gSavedSettings.setF32("RenderFarClip", farClip); };
+        if( tuningFlag & LightMapDivisor ){ gSavedSettings.setU32("RenderLightMapDivisor", lightMapDivisor); };
         if( tuningFlag & UserMinDrawDistance ){ gSavedSettings.setF32("AutoTuneRenderFarClipMin", userMinDrawDistance); };
         if( tuningFlag & UserTargetDrawDistance ){ gSavedSettings.setF32("AutoTuneRenderFarClipTarget", userTargetDrawDistance); };
         if( tuningFlag & UserImpostorDistance ){ gSavedSettings.setF32("AutoTuneImpostorFarAwayDistance", userImpostorDistance); };
@@ -126,6 +128,7 @@ namespace LLPerfStats
         LLPerfStats::tunables.userFPSTuningStrategy = gSavedSettings.getU32("TuningFPSStrategy");
         LLPerfStats::tunables.userTargetFPS = gSavedSettings.getU32("TargetFPS");
         LLPerfStats::tunables.vsyncEnabled = gSavedSettings.getBOOL("RenderVSyncEnable");
+        LLPerfStats::tunables.userLightMapDivisor = gSavedSettings.getU32("RenderLightMapDivisor");
 
         LLPerfStats::tunables.userAutoTuneLock = gSavedSettings.getBOOL("AutoTuneLock") && gSavedSettings.getU32("KeepAutoTuneLock");
 
@@ -442,6 +445,17 @@ namespace LLPerfStats
                         }
                         else // deliberately "else" here so we only do one of these in any given frame
 #endif
+                        // halve the resolution of the shadow/SSAO light map before giving up any draw distance,
+                        // unless the GPU timers show lighting is not where the frame goes
+                        F32 lighting_ms = gGPUPassTimers.getTime(LLGPUPassTimers::PASS_LIGHTING);
+                        bool lighting_bound = lighting_ms == 0.f || lighting_ms > raw_to_ms(target_frame_time_raw) * 0.25;
+                        if (LLPipeline::RenderDeferredSSAO && lighting_bound && LLPipeline::RenderLightMapDivisor < LLPipeline::MAX_LIGHT_MAP_DIVISOR)
+                        {
+                            LLPerfStats::tunables.updateLightMapDivisor(std::max(LLPipeline::RenderLightMapDivisor * 2, 2U));
+                            LLPerfStats::lastGlobalPrefChange = gFrameCount;
+                            return;
+                        }
+                        else // one change per update, as above
                         {
                             // step down the DD by 10m per update
                             auto new_dd = (LLPipeline::RenderFarClip - DD_STEP > tunables.userMinDrawDistance)?(LLPipeline::RenderFarClip - DD_STEP) : tunables.userMinDrawDistance;
@@ -534,6 +548,12 @@ namespace LLPerfStats
                         LLPerfStats::lastGlobalPrefChange = gFrameCount;
                         return;
                     }
+                    if (LLPipeline::RenderLightMapDivisor > std::max(tunables.userLightMapDivisor, 1U))
+                    {
+                        LLPerfStats::tunables.updateLightMapDivisor( std::max(LLPipeline::RenderLightMapDivisor / 2, tunables.userLightMapDivisor) );
+                        LLPerfStats::lastGlobalPrefChange = gFrameCount;
+                        return;
+                    }
                     if ((tot_frame_time_raw * 1.5) < target_frame_time_raw)
                     {
                         // if everything else is "max" and we have >50% headroom let's knock the water quality up a notch at a time.
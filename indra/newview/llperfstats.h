@@ -119,6 +119,7 @@ namespace LLPerfStats
         static constexpr U32 UserTargetFPS{512};
         static constexpr U32 UserARTCutoff{1024};
         static constexpr U32 UserAutoTuneLock{4096};
+        static constexpr U32 LightMapDivisor{8192};
 
         U32 tuningFlag{0}; // bit mask for changed settings
 
@@ -126,6 +127,7 @@ namespace LLPerfStats
         U32 nonImpostors{0};
         S32 reflectionDetail{0};
         F32 farClip{0.0};
+        U32 lightMapDivisor{1};
         F32 userMinDrawDistance{0.0};
         F32 userTargetDrawDistance{0.0};
         F32 userImpostorDistance{0.0};
@@ -136,12 +138,14 @@ namespace LLPerfStats
         U32 userTargetFPS{0};
         F32 userARTCutoffSliderValue{0};
         S32 userTargetReflections{0};
+        U32 userLightMapDivisor{1}; // light map divisor chosen by the user, autotune only ever raises it above this
         bool autoTuneTimeout{true};
         bool vsyncEnabled{true};
 
         void updateNonImposters(U32 nv){nonImpostors=nv; tuningFlag |= NonImpostors;};
         void updateReflectionDetail(S32 nv){reflectionDetail=nv; tuningFlag |= ReflectionDetail;};
         void updateFarClip(F32 nv){farClip=nv; tuningFlag |= FarClip;};
+        void updateLightMapDivisor(U32 nv){lightMapDivisor=nv; tuningFlag |= LightMapDivisor;};
         void updateUserMinDrawDistance(F32 nv){userMinDrawDistance=nv; tuningFlag |= UserMinDrawDistance;};
         void updateUserTargetDrawDistance(F32 nv){userTargetDrawDistance=nv; tuningFlag |= UserTargetDrawDistance;};
         void updateImposterDistance(F32 nv){userImpostorDistance=nv; tuningFlag |= UserImpostorDistance;};
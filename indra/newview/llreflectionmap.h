@@ -132,6 +132,9 @@ public:
     // 1 - manual probe
     U32 mPriority = 0;
 
+    // true if this probe's influence volume was in the view frustum on the last update
+    bool mOnScreen = false;
+
     // occlusion culling state
     GLuint mOcclusionQuery = 0;
     bool mOccluded = false;
@@ -36,6 +36,7 @@
 #include "pipeline.h"
 #include "llviewershadermgr.h"
 #include "llviewercontrol.h"
+#include "llviewertexture.h"
 #include "llenvironment.h"
 #include "llstartup.h"
 #include "llviewermenufile.h"
@@ -150,7 +151,7 @@ LLReflectionMapManager::LLReflectionMapManager()
 void LLReflectionMapManager::initCubeFree()
 {
     // start at 1 because index 0 is reserved for mDefaultProbe
-    for (int i = 1; i < LL_MAX_REFLECTION_PROBE_COUNT; ++i)
+    for (U32 i = 1; i < mReflectionProbeCount; ++i)
     {
         mCubeFree.push_back(i);
     }
@@ -166,9 +167,18 @@ struct CompareProbeDistance
     }
 };
 
+static LLTrace::SampleStatHandle<F64Seconds> sProbeLag("reflectionprobelag", "Time since the stalest reflection probe in use was updated");
+static LLTrace::SampleStatHandle<F64Milliseconds> sProbeFaceCost("reflectionprobefacecost", "Average cost of rendering one reflection probe face");
+
 static F32 update_score(LLReflectionMap* p)
 {
-    return gFrameTimeSeconds - p->mLastUpdateTime  - p->mDistance*0.1f;
+    // staleness of probes that are influencing what's on screen matters twice as much
+    F32 age = gFrameTimeSeconds - p->mLastUpdateTime;
+    if (p->mOnScreen)
+    {
+        age *= 2.f;
+    }
+    return age - p->mDistance*0.1f;
 }
 
 // return true if a is higher priority for an update than b
@@ -273,6 +283,8 @@ void LLReflectionMapManager::update()
         return;
     }
 
+    updateProbeCount();
+
 
     bool did_update = false;
 
@@ -286,10 +298,14 @@ void LLReflectionMapManager::update()
     LLReflectionMap* oldestProbe = nullptr;
     LLReflectionMap* oldestOccluded = nullptr;
 
+    F32 probe_lag = 0.f;
+
+    readStepTimers();
+
     if (mUpdatingProbe != nullptr)
     {
         did_update = true;
-        doProbeUpdate();
+        doProbeUpdates();
     }
 
     // update distance to camera for all probes
@@ -359,6 +375,7 @@ void LLReflectionMapManager::update()
             }
             d.setSub(camera_pos, probe->mOrigin);
             probe->mDistance = d.getLength3().getF32() - probe->mRadius;
+            probe->mOnScreen = LLViewerCamera::instance().sphereInFrustum(LLVector3(probe->mOrigin.getF32ptr()), probe->mRadius) != 0;
         }
         else if (probe->mComplete)
         {
@@ -374,6 +391,11 @@ void LLReflectionMapManager::update()
         {
             probe->autoAdjustOrigin();
             probe->mFadeIn = llmin((F32) (probe->mFadeIn + gFrameIntervalSeconds), 1.f);
+
+            if (probe->mCubeIndex != -1 && !probe->mOccluded)
+            {
+                probe_lag = llmax(probe_lag, (F32)(gFrameTimeSeconds - probe->mLastUpdateTime));
+            }
         }
         if (probe->mOccluded && probe->mComplete)
         {
@@ -450,7 +472,7 @@ void LLReflectionMapManager::update()
 
         sUpdateCount++;
         mUpdatingProbe = probe;
-        doProbeUpdate();
+        doProbeUpdates();
     }
 
     if (oldestOccluded)
@@ -459,6 +481,12 @@ void LLReflectionMapManager::update()
         oldestOccluded->autoAdjustOrigin();
         oldestOccluded->mLastUpdateTime = gFrameTimeSeconds;
     }
+
+    sample(sProbeLag, F64Seconds(probe_lag));
+    if (mFaceCost >= 0.f)
+    {
+        sample(sProbeFaceCost, F64Milliseconds(mFaceCost));
+    }
 }
 
 LLReflectionMap* LLReflectionMapManager::addProbe(LLSpatialGroup* group)
@@ -633,16 +661,68 @@ void LLReflectionMapManager::deleteProbe(U32 i)
 }
 
 
+void LLReflectionMapManager::doProbeUpdates()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DISPLAY;
+    llassert(mUpdatingProbe != nullptr);
+
+    static LLCachedControl<F32> update_budget(gSavedSettings, "RenderReflectionProbeUpdateBudget", 1.5f);
+    if (update_budget <= 0.f || !mDefaultProbe->mComplete)
+    { // unbudgeted (or still generating the first sky probe), one step per frame
+        doProbeUpdate();
+        return;
+    }
+
+    // Bank this frame's share of the budget. Steps that cost more than the budget run every few frames instead of
+    // every frame, cheap ones run several to a frame, but never more than one pass (six faces and the filter) at a time.
+    F32 max_cost = llmax(mFaceCost, mFilterCost);
+    mUpdateCredit = llmin(mUpdateCredit + update_budget, update_budget + llmax(max_cost, 0.f));
+
+    for (U32 steps = 0; mUpdatingProbe != nullptr && steps < 7; ++steps)
+    {
+        // until a step has been measured, assume it fills the budget
+        F32 cost = mUpdatingFace == 6 ? mFilterCost : mFaceCost;
+        if (cost < 0.f)
+        {
+            cost = update_budget;
+        }
+
+        if (cost > mUpdateCredit)
+        {
+            break;
+        }
+
+        mUpdateCredit -= cost;
+        doProbeUpdate();
+    }
+}
+
 void LLReflectionMapManager::doProbeUpdate()
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_DISPLAY;
     llassert(mUpdatingProbe != nullptr);
 
-    updateProbeFace(mUpdatingProbe, mUpdatingFace);
+    bool filter = mUpdatingFace == 6;
+
+    beginStepTimer(filter);
+    if (filter)
+    { // run the irradiance/radiance filter on a frame of its own rather than on top of the last face
+        gGL.setColorMask(true, true);
+        LLGLDepthTest depth(GL_FALSE, GL_FALSE);
+        LLGLDisable cull(GL_CULL_FACE);
+        LLGLDisable blend(GL_BLEND);
+
+        filterProbe(mUpdatingProbe, mReflectionProbeCount);
+    }
+    else
+    {
+        updateProbeFace(mUpdatingProbe, mUpdatingFace);
+    }
+    endStepTimer();
 
     bool debug_updates = gPipeline.hasRenderDebugMask(LLPipeline::RENDER_DEBUG_PROBE_UPDATES) && mUpdatingProbe->mViewerObject;
 
-    if (++mUpdatingFace == 6)
+    if (++mUpdatingFace == 7)
     {
         if (debug_updates)
         {
@@ -675,6 +755,7 @@ void LLReflectionMapManager::doProbeUpdate()
 // The next six passes render the scene with both radiance and irradiance into the same scratch space cube map and generate a simple mip chain.
 // At the end of these passes, a radiance map is generated for this probe and placed into the radiance cube map array at the index for this probe.
 // In effect this simulates single-bounce lighting.
+// The realtime probe runs the filter at the end of the sixth pass, mUpdatingProbe runs it as a separate step (see doProbeUpdate).
 void LLReflectionMapManager::updateProbeFace(LLReflectionMap* probe, U32 face)
 {
     // hacky hot-swap of camera specific render targets
@@ -815,107 +896,184 @@ void LLReflectionMapManager::updateProbeFace(LLReflectionMap* probe, U32 face)
         gReflectionMipProgram.unbind();
     }
 
-    if (face == 5)
+    if (face == 5 && probe != mUpdatingProbe)
     {
-        mMipChain[0].bindTarget();
-        static LLStaticHashedString sSourceIdx("sourceIdx");
+        filterProbe(probe, sourceIdx);
+    }
+}
 
-        if (isRadiancePass())
-        {
-            //generate radiance map (even if this is not the irradiance map, we need the mip chain for the irradiance map)
-            gRadianceGenProgram.bind();
-            mVertexBuffer->setBuffer();
+void LLReflectionMapManager::filterProbe(LLReflectionMap* probe, S32 sourceIdx)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DISPLAY;
 
-            S32 channel = gRadianceGenProgram.enableTexture(LLShaderMgr::REFLECTION_PROBES, LLTexUnit::TT_CUBE_MAP_ARRAY);
-            mTexture->bind(channel);
-            gRadianceGenProgram.uniform1i(sSourceIdx, sourceIdx);
-            gRadianceGenProgram.uniform1f(LLShaderMgr::REFLECTION_PROBE_MAX_LOD, mMaxProbeLOD);
-            gRadianceGenProgram.uniform1f(LLShaderMgr::REFLECTION_PROBE_STRENGTH, 1.f);
+    gGL.matrixMode(gGL.MM_MODELVIEW);
+    gGL.pushMatrix();
 
-            U32 res = mMipChain[0].getWidth();
+    mMipChain[0].bindTarget();
+    static LLStaticHashedString sSourceIdx("sourceIdx");
 
-            for (int i = 0; i < mMipChain.size(); ++i)
-            {
-                LL_PROFILE_GPU_ZONE("probe radiance gen");
-                static LLStaticHashedString sMipLevel("mipLevel");
-                static LLStaticHashedString sRoughness("roughness");
-                static LLStaticHashedString sWidth("u_width");
+    if (isRadiancePass())
+    {
+        //generate radiance map (even if this is not the irradiance map, we need the mip chain for the irradiance map)
+        gRadianceGenProgram.bind();
+        mVertexBuffer->setBuffer();
 
-                gRadianceGenProgram.uniform1f(sRoughness, (F32)i / (F32)(mMipChain.size() - 1));
-                gRadianceGenProgram.uniform1f(sMipLevel, (GLfloat)i);
-                gRadianceGenProgram.uniform1i(sWidth, mProbeResolution);
+        S32 channel = gRadianceGenProgram.enableTexture(LLShaderMgr::REFLECTION_PROBES, LLTexUnit::TT_CUBE_MAP_ARRAY);
+        mTexture->bind(channel);
+        gRadianceGenProgram.uniform1i(sSourceIdx, sourceIdx);
+        gRadianceGenProgram.uniform1f(LLShaderMgr::REFLECTION_PROBE_MAX_LOD, mMaxProbeLOD);
+        gRadianceGenProgram.uniform1f(LLShaderMgr::REFLECTION_PROBE_STRENGTH, 1.f);
 
-                for (int cf = 0; cf < 6; ++cf)
-                { // for each cube face
-                    LLCoordFrame frame;
-                    frame.lookAt(LLVector3(0, 0, 0), LLCubeMapArray::sClipToCubeLookVecs[cf], LLCubeMapArray::sClipToCubeUpVecs[cf]);
+        U32 res = mMipChain[0].getWidth();
 
-                    F32 mat[16];
-                    frame.getOpenGLRotation(mat);
-                    gGL.loadMatrix(mat);
+        for (int i = 0; i < mMipChain.size(); ++i)
+        {
+            LL_PROFILE_GPU_ZONE("probe radiance gen");
+            static LLStaticHashedString sMipLevel("mipLevel");
+            static LLStaticHashedString sRoughness("roughness");
+            static LLStaticHashedString sWidth("u_width");
 
-                    mVertexBuffer->drawArrays(gGL.TRIANGLE_STRIP, 0, 4);
+            gRadianceGenProgram.uniform1f(sRoughness, (F32)i / (F32)(mMipChain.size() - 1));
+            gRadianceGenProgram.uniform1f(sMipLevel, (GLfloat)i);
+            gRadianceGenProgram.uniform1i(sWidth, mProbeResolution);
 
-                    glCopyTexSubImage3D(GL_TEXTURE_CUBE_MAP_ARRAY, i, 0, 0, probe->mCubeIndex * 6 + cf, 0, 0, res, res);
-                }
+            for (int cf = 0; cf < 6; ++cf)
+            { // for each cube face
+                LLCoordFrame frame;
+                frame.lookAt(LLVector3(0, 0, 0), LLCubeMapArray::sClipToCubeLookVecs[cf], LLCubeMapArray::sClipToCubeUpVecs[cf]);
 
-                if (i != mMipChain.size() - 1)
-                {
-                    res /= 2;
-                    glViewport(0, 0, res, res);
-                }
+                F32 mat[16];
+                frame.getOpenGLRotation(mat);
+                gGL.loadMatrix(mat);
+
+                mVertexBuffer->drawArrays(gGL.TRIANGLE_STRIP, 0, 4);
+
+                glCopyTexSubImage3D(GL_TEXTURE_CUBE_MAP_ARRAY, i, 0, 0, probe->mCubeIndex * 6 + cf, 0, 0, res, res);
             }
 
-            gRadianceGenProgram.unbind();
+            if (i != mMipChain.size() - 1)
+            {
+                res /= 2;
+                glViewport(0, 0, res, res);
+            }
         }
-        else
+
+        gRadianceGenProgram.unbind();
+    }
+    else
+    {
+        //generate irradiance map
+        gIrradianceGenProgram.bind();
+        S32 channel = gIrradianceGenProgram.enableTexture(LLShaderMgr::REFLECTION_PROBES, LLTexUnit::TT_CUBE_MAP_ARRAY);
+        mTexture->bind(channel);
+
+        gIrradianceGenProgram.uniform1i(sSourceIdx, sourceIdx);
+        gIrradianceGenProgram.uniform1f(LLShaderMgr::REFLECTION_PROBE_MAX_LOD, mMaxProbeLOD);
+
+        mVertexBuffer->setBuffer();
+        int start_mip = 0;
+        // find the mip target to start with based on irradiance map resolution
+        for (start_mip = 0; start_mip < mMipChain.size(); ++start_mip)
         {
-            //generate irradiance map
-            gIrradianceGenProgram.bind();
-            S32 channel = gIrradianceGenProgram.enableTexture(LLShaderMgr::REFLECTION_PROBES, LLTexUnit::TT_CUBE_MAP_ARRAY);
-            mTexture->bind(channel);
-
-            gIrradianceGenProgram.uniform1i(sSourceIdx, sourceIdx);
-            gIrradianceGenProgram.uniform1f(LLShaderMgr::REFLECTION_PROBE_MAX_LOD, mMaxProbeLOD);
-
-            mVertexBuffer->setBuffer();
-            int start_mip = 0;
-            // find the mip target to start with based on irradiance map resolution
-            for (start_mip = 0; start_mip < mMipChain.size(); ++start_mip)
+            if (mMipChain[start_mip].getWidth() == LL_IRRADIANCE_MAP_RESOLUTION)
             {
-                if (mMipChain[start_mip].getWidth() == LL_IRRADIANCE_MAP_RESOLUTION)
-                {
-                    break;
-                }
+                break;
             }
+        }
 
-            //for (int i = start_mip; i < mMipChain.size(); ++i)
-            {
-                int i = start_mip;
-                LL_PROFILE_GPU_ZONE("probe irradiance gen");
-                glViewport(0, 0, mMipChain[i].getWidth(), mMipChain[i].getHeight());
-                for (int cf = 0; cf < 6; ++cf)
-                { // for each cube face
-                    LLCoordFrame frame;
-                    frame.lookAt(LLVector3(0, 0, 0), LLCubeMapArray::sClipToCubeLookVecs[cf], LLCubeMapArray::sClipToCubeUpVecs[cf]);
-
-                    F32 mat[16];
-                    frame.getOpenGLRotation(mat);
-                    gGL.loadMatrix(mat);
-
-                    mVertexBuffer->drawArrays(gGL.TRIANGLE_STRIP, 0, 4);
-
-                    S32 res = mMipChain[i].getWidth();
-                    mIrradianceMaps->bind(channel);
-                    glCopyTexSubImage3D(GL_TEXTURE_CUBE_MAP_ARRAY, i - start_mip, 0, 0, probe->mCubeIndex * 6 + cf, 0, 0, res, res);
-                    mTexture->bind(channel);
-                }
+        //for (int i = start_mip; i < mMipChain.size(); ++i)
+        {
+            int i = start_mip;
+            LL_PROFILE_GPU_ZONE("probe irradiance gen");
+            glViewport(0, 0, mMipChain[i].getWidth(), mMipChain[i].getHeight());
+            for (int cf = 0; cf < 6; ++cf)
+            { // for each cube face
+                LLCoordFrame frame;
+                frame.lookAt(LLVector3(0, 0, 0), LLCubeMapArray::sClipToCubeLookVecs[cf], LLCubeMapArray::sClipToCubeUpVecs[cf]);
+
+                F32 mat[16];
+                frame.getOpenGLRotation(mat);
+                gGL.loadMatrix(mat);
+
+                mVertexBuffer->drawArrays(gGL.TRIANGLE_STRIP, 0, 4);
+
+                S32 res = mMipChain[i].getWidth();
+                mIrradianceMaps->bind(channel);
+                glCopyTexSubImage3D(GL_TEXTURE_CUBE_MAP_ARRAY, i - start_mip, 0, 0, probe->mCubeIndex * 6 + cf, 0, 0, res, res);
+                mTexture->bind(channel);
             }
         }
+    }
 
-        mMipChain[0].flush();
+    mMipChain[0].flush();
 
-        gIrradianceGenProgram.unbind();
+    gIrradianceGenProgram.unbind();
+
+    gGL.popMatrix();
+}
+
+void LLReflectionMapManager::beginStepTimer(bool filter)
+{
+    mStepTimer.reset();
+
+    StepTimer& timer = mStepTimers[mStepTimerIndex];
+    if (timer.mPending || !glQueryCounter)
+    { // previous query in this slot is still in flight, don't time this step
+        return;
+    }
+
+    if (timer.mQueries[0] == 0)
+    {
+        glGenQueries(2, timer.mQueries);
+    }
+
+    timer.mFilter = filter;
+    glQueryCounter(timer.mQueries[0], GL_TIMESTAMP);
+}
+
+void LLReflectionMapManager::endStepTimer()
+{
+    StepTimer& timer = mStepTimers[mStepTimerIndex];
+    if (timer.mPending || timer.mQueries[0] == 0)
+    {
+        return;
+    }
+
+    glQueryCounter(timer.mQueries[1], GL_TIMESTAMP);
+    timer.mCPUTime = mStepTimer.getElapsedTimeF32() * 1000.f;
+    timer.mPending = true;
+
+    mStepTimerIndex = (mStepTimerIndex + 1) % STEP_TIMER_COUNT;
+}
+
+void LLReflectionMapManager::readStepTimers()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DISPLAY;
+    for (StepTimer& timer : mStepTimers)
+    {
+        if (!timer.mPending)
+        {
+            continue;
+        }
+
+        GLuint available = 0;
+        glGetQueryObjectuiv(timer.mQueries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+        {
+            continue;
+        }
+
+        GLuint64 begin = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(timer.mQueries[0], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(timer.mQueries[1], GL_QUERY_RESULT, &end);
+        timer.mPending = false;
+
+        // a face render costs main thread time too, budget for whichever is larger
+        F32 cost = llmax((F32)((end - begin) / 1000000.0), timer.mCPUTime);
+
+        F32& avg = timer.mFilter ? mFilterCost : mFaceCost;
+        avg = avg < 0.f ? cost : lerp(avg, cost, 0.1f);
     }
 }
 
@@ -1370,9 +1528,126 @@ void LLReflectionMapManager::renderDebug()
     gDebugProgram.unbind();
 }
 
+// without glCopyImageSubData, resizing the probe arrays would mean regenerating every probe
+static bool can_resize_probe_arrays()
+{
+    return gGLManager.mGLVersion >= 4.29f && glCopyImageSubData;
+}
+
+void LLReflectionMapManager::updateProbeCount()
+{
+    if (mUpdatingProbe != nullptr || mTexture.isNull() || !can_resize_probe_arrays())
+    { // wait for the updating probe, it renders into the scratch cube maps past the last probe
+        return;
+    }
+
+    const U32 step = LL_REFLECTION_PROBE_COUNT_STEP;
+    const F32 SHRINK_DELAY = 10.f; // seconds
+
+    // radiance maps with their mips plus irradiance maps, RGB16F takes 8 bytes per texel with most drivers
+    const F32 layer_mb = (mProbeResolution * mProbeResolution * 6.f * 8.f * 4.f / 3.f
+        + LL_IRRADIANCE_MAP_RESOLUTION * LL_IRRADIANCE_MAP_RESOLUTION * 6.f * 8.f) / (1024.f * 1024.f);
+
+    U32 count = mReflectionProbeCount;
+    U32 wanted = llclamp((((U32)mProbes.size() + step - 1) / step) * step, step, (U32)LL_MAX_REFLECTION_PROBE_COUNT);
+
+    // textures are already being downscaled to fit, don't take more from them
+    bool starved = LLViewerTexture::sDesiredDiscardBias > 2.f;
+
+    U32 target = count;
+    if (wanted > count && !starved)
+    { // grow into at most half of the free texture memory
+        U32 affordable = LLViewerTexture::sFreeVRAMMegabytes > 0.f ? (U32)(LLViewerTexture::sFreeVRAMMegabytes * 0.5f / (layer_mb * step)) * step : 0;
+        target = llmin(wanted, count + affordable);
+        mProbeShrinkTimer.reset();
+    }
+    else if ((wanted + step < count || starved) && count > step)
+    { // shrink a step at a time once the probes have been gone for a while, or the textures need the memory
+        if (mProbeShrinkTimer.getElapsedTimeF32() > SHRINK_DELAY)
+        {
+            target = starved ? count - step : llmax(wanted, count - step);
+            mProbeShrinkTimer.reset();
+        }
+    }
+    else
+    {
+        mProbeShrinkTimer.reset();
+    }
+
+    if (target != count)
+    {
+        LL_DEBUGS("ReflectionProbes") << "Resizing probe arrays from " << count << " to " << target << " probes ("
+            << mProbes.size() << " probes, " << LLViewerTexture::sFreeVRAMMegabytes << "MB free)" << LL_ENDL;
+
+        mTargetProbeCount = target;
+        resizeProbeArrays(target);
+    }
+}
+
+void LLReflectionMapManager::resizeProbeArrays(U32 count)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DISPLAY;
+    llassert(can_resize_probe_arrays());
+
+    LLPointer<LLCubeMapArray> texture = new LLCubeMapArray();
+    texture->allocate(mProbeResolution, 3, count + 2);
+
+    LLPointer<LLCubeMapArray> irradiance = new LLCubeMapArray();
+    irradiance->allocate(LL_IRRADIANCE_MAP_RESOLUTION, 3, count, false);
+
+    // copy the cube maps that keep their index, every mip of the radiance maps (scratch space isn't kept)
+    U32 keep = llmin(count, mReflectionProbeCount);
+    U32 mip = 0;
+    for (U32 res = mProbeResolution; res >= 1; res /= 2, ++mip)
+    {
+        glCopyImageSubData(mTexture->getGLName(), GL_TEXTURE_CUBE_MAP_ARRAY, mip, 0, 0, 0,
+            texture->getGLName(), GL_TEXTURE_CUBE_MAP_ARRAY, mip, 0, 0, 0,
+            res, res, keep * 6);
+    }
+
+    glCopyImageSubData(mIrradianceMaps->getGLName(), GL_TEXTURE_CUBE_MAP_ARRAY, 0, 0, 0, 0,
+        irradiance->getGLName(), GL_TEXTURE_CUBE_MAP_ARRAY, 0, 0, 0, 0,
+        LL_IRRADIANCE_MAP_RESOLUTION, LL_IRRADIANCE_MAP_RESOLUTION, keep * 6);
+
+    for (auto& probe : mProbes)
+    {
+        if (probe->mCubeIndex >= (S32)count)
+        { // no room left for this probe, it will get a new index if it's still among the closest
+            probe->mCubeArray = nullptr;
+            probe->mCubeIndex = -1;
+            probe->mComplete = false;
+        }
+        else if (probe->mCubeArray.notNull())
+        {
+            probe->mCubeArray = texture;
+        }
+    }
+
+    for (auto iter = mCubeFree.begin(); iter != mCubeFree.end(); )
+    {
+        if (*iter >= (S32)count)
+        {
+            iter = mCubeFree.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
+    for (U32 i = mReflectionProbeCount; i < count; ++i)
+    {
+        mCubeFree.push_back(i);
+    }
+
+    mTexture = texture;
+    mIrradianceMaps = irradiance;
+    mReflectionProbeCount = count;
+}
+
 void LLReflectionMapManager::initReflectionMaps()
 {
-    U32 count = LL_MAX_REFLECTION_PROBE_COUNT;
+    U32 count = can_resize_probe_arrays() ? mTargetProbeCount : LL_MAX_REFLECTION_PROBE_COUNT;
 
     static LLCachedControl<U32> ref_probe_res(gSavedSettings, "RenderReflectionProbeResolution", 128U);
     U32 probe_resolution = nhpo2(llclamp(ref_probe_res(), (U32)64, (U32)512));
@@ -1486,6 +1761,17 @@ void LLReflectionMapManager::cleanup()
     mDefaultProbe = nullptr;
     mUpdatingProbe = nullptr;
 
+    for (StepTimer& timer : mStepTimers)
+    {
+        if (timer.mQueries[0] != 0)
+        {
+            glDeleteQueries(2, timer.mQueries);
+        }
+        timer = StepTimer();
+    }
+    mStepTimerIndex = 0;
+    mUpdateCredit = 0.f;
+
     glDeleteBuffers(1, &mUBO);
     mUBO = 0;
 
@@ -30,6 +30,7 @@
 #include "llrendertarget.h"
 #include "llcubemaparray.h"
 #include "llcubemap.h"
+#include "lltimer.h"
 
 class LLSpatialGroup;
 class LLViewerObject;
@@ -37,6 +38,9 @@ class LLViewerObject;
 // number of reflection probes to keep in vram
 #define LL_MAX_REFLECTION_PROBE_COUNT 256
 
+// the probe cube map arrays grow and shrink by this many probes at a time
+#define LL_REFLECTION_PROBE_COUNT_STEP 32
+
 // reflection probe resolution
 #define LL_IRRADIANCE_MAP_RESOLUTION 64
 
@@ -155,12 +159,31 @@ private:
     // list of free cubemap indices
     std::list<S32> mCubeFree;
 
-    // perform an update on the currently updating Probe
+    // pick the number of probes to keep in vram from the probes in the scene and the texture memory budget
+    void updateProbeCount();
+
+    // reallocate mTexture and mIrradianceMaps for count probes, keeping the probes whose cube index still fits
+    void resizeProbeArrays(U32 count);
+
+    // perform as many update steps on the currently updating Probe as the frame's time budget allows
+    void doProbeUpdates();
+
+    // perform one update step (one face or the filter pass) on the currently updating Probe
     void doProbeUpdate();
 
     // update the specified face of the specified probe
     void updateProbeFace(LLReflectionMap* probe, U32 face);
 
+    // generate the irradiance or radiance map of the specified probe from the scratch space cube map at sourceIdx
+    void filterProbe(LLReflectionMap* probe, S32 sourceIdx);
+
+    // timestamp the GPU work of an update step so its cost can be budgeted for
+    void beginStepTimer(bool filter);
+    void endStepTimer();
+
+    // fold the timer queries that have completed into mFaceCost and mFilterCost (never waits on the GPU)
+    void readStepTimers();
+
     // list of active reflection maps
     std::vector<LLPointer<LLReflectionMap> > mProbes;
 
@@ -177,8 +200,30 @@ private:
     std::vector<LLReflectionMap*> mReflectionMaps;
 
     LLReflectionMap* mUpdatingProbe = nullptr;
+
+    // step of the current pass of mUpdatingProbe, 0-5 render the cube faces, 6 runs the filter pass
     U32 mUpdatingFace = 0;
 
+    // timer queries of recent update steps, read back a few frames later
+    struct StepTimer
+    {
+        GLuint mQueries[2] = { 0, 0 };
+        F32 mCPUTime = 0.f; // milliseconds
+        bool mFilter = false;
+        bool mPending = false;
+    };
+    static constexpr U32 STEP_TIMER_COUNT = 8;
+    StepTimer mStepTimers[STEP_TIMER_COUNT];
+    U32 mStepTimerIndex = 0;
+    LLTimer mStepTimer;
+
+    // running average cost in milliseconds of rendering a probe face and of a filter pass (negative until measured)
+    F32 mFaceCost = -1.f;
+    F32 mFilterCost = -1.f;
+
+    // part of the "RenderReflectionProbeUpdateBudget" not spent yet
+    F32 mUpdateCredit = 0.f;
+
     // if true, we're generating the radiance map for the current probe, otherwise we're generating the irradiance map.
     // Update sequence should be to generate the irradiance map from render of the world that has no irradiance,
     // then generate the radiance map from a render of the world that includes irradiance.
@@ -193,7 +238,13 @@ private:
     LLPointer<LLReflectionMap> mDefaultProbe;  // default reflection probe to fall back to for pixels with no probe influences (should always be at cube index 0)
 
     // number of reflection probes to use for rendering
-    U32 mReflectionProbeCount;
+    U32 mReflectionProbeCount = 0;
+
+    // number of reflection probes updateProbeCount wants in vram
+    U32 mTargetProbeCount = LL_REFLECTION_PROBE_COUNT_STEP;
+
+    // how long the probe arrays have been larger than needed
+    LLFrameTimer mProbeShrinkTimer;
 
     // resolution of reflection probes
     U32 mProbeResolution = 128;
@@ -0,0 +1,187 @@
+/**
+ * @file llrendergraph.cpp
+ * @brief Declares chains of render passes and backs their scratch targets with shared storage.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llrendergraph.h"
+
+#include <algorithm>
+
+static bool fits(const LLRenderGraph::TargetDesc& want, const LLRenderGraph::TargetDesc& have)
+{
+    // an extra depth buffer is harmless, post passes don't depth test
+    return want.mWidth == have.mWidth &&
+        want.mHeight == have.mHeight &&
+        want.mColorFormat == have.mColorFormat &&
+        (have.mDepth || !want.mDepth);
+}
+
+LLRenderGraph::LLRenderGraph()
+{
+}
+
+LLRenderGraph::~LLRenderGraph()
+{
+    llassert(mAcquired.empty());
+}
+
+S32 LLRenderGraph::importTarget(LLRenderTarget* target)
+{
+    llassert(target);
+    Resource res;
+    res.mTarget = target;
+    res.mImported = true;
+    mResources.push_back(res);
+    return (S32)mResources.size() - 1;
+}
+
+void LLRenderGraph::donateTarget(LLRenderTarget* target, const TargetDesc& desc)
+{
+    if (target && target->isComplete())
+    {
+        Storage storage;
+        storage.mTarget = target;
+        storage.mDesc = desc;
+        mDonated.push_back(std::move(storage));
+    }
+}
+
+S32 LLRenderGraph::createTarget(const std::string& name, const TargetDesc& desc)
+{
+    Resource res;
+    res.mName = name;
+    res.mDesc = desc;
+    mResources.push_back(res);
+    return (S32)mResources.size() - 1;
+}
+
+void LLRenderGraph::addPass(const std::string& name, const std::vector<S32>& reads, const std::vector<S32>& writes, const pass_func_t& func)
+{
+    S32 idx = (S32)mPasses.size();
+    for (S32 handle : reads)
+    {
+        useResource(handle, idx);
+    }
+    for (S32 handle : writes)
+    {
+        useResource(handle, idx);
+    }
+
+    mPasses.push_back({ name, reads, writes, func });
+}
+
+void LLRenderGraph::useResource(S32 handle, S32 pass)
+{
+    llassert(handle >= 0 && handle < (S32)mResources.size());
+    Resource& res = mResources[handle];
+    if (res.mFirstPass == -1)
+    {
+        res.mFirstPass = pass;
+    }
+    res.mLastPass = pass;
+}
+
+LLRenderTarget* LLRenderGraph::getTarget(S32 handle) const
+{
+    llassert(handle >= 0 && handle < (S32)mResources.size());
+    llassert(mResources[handle].mTarget);
+    return mResources[handle].mTarget;
+}
+
+LLRenderTarget* LLRenderGraph::assignStorage(const Resource& res)
+{
+    // prefer donated storage so the pool doesn't duplicate memory that's sitting idle anyway
+    for (Storage& storage : mDonated)
+    {
+        if (storage.mBusyUntil < res.mFirstPass && fits(res.mDesc, storage.mDesc))
+        {
+            storage.mBusyUntil = res.mLastPass;
+            return storage.mTarget;
+        }
+    }
+
+    for (Storage& storage : mAcquired)
+    {
+        if (storage.mBusyUntil < res.mFirstPass && fits(res.mDesc, storage.mDesc))
+        {
+            storage.mBusyUntil = res.mLastPass;
+            return storage.mTarget;
+        }
+    }
+
+    Storage storage;
+    storage.mTarget = gRenderTargetPool.acquire(res.mDesc, res.mName);
+    if (!storage.mTarget)
+    {
+        return &mUnallocated;
+    }
+    storage.mDesc = res.mDesc;
+    storage.mBusyUntil = res.mLastPass;
+
+    mAcquired.push_back(storage);
+    return storage.mTarget;
+}
+
+void LLRenderGraph::execute()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
+
+    // hand out storage in order of first use, so a transient can take over the storage of
+    // one whose last pass came before its first
+    std::vector<S32> order;
+    for (S32 i = 0; i < (S32)mResources.size(); ++i)
+    {
+        if (!mResources[i].mImported && mResources[i].mFirstPass != -1)
+        {
+            order.push_back(i);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [this](S32 a, S32 b)
+        {
+            return mResources[a].mFirstPass < mResources[b].mFirstPass;
+        });
+
+    for (S32 i : order)
+    {
+        mResources[i].mTarget = assignStorage(mResources[i]);
+    }
+
+    for (Pass& pass : mPasses)
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_PIPELINE("render graph pass");
+        pass.mFunc();
+    }
+
+    for (Storage& storage : mAcquired)
+    {
+        gRenderTargetPool.release(storage.mTarget);
+    }
+    mAcquired.clear();
+
+    mPasses.clear();
+    mResources.clear();
+    mDonated.clear();
+}
@@ -0,0 +1,121 @@
+/**
+ * @file llrendergraph.h
+ * @brief Declares chains of render passes and backs their scratch targets with shared storage.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLRENDERGRAPH_H
+#define LL_LLRENDERGRAPH_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "llrendertargetpool.h"
+
+// A small render graph for post processing chains.
+//
+// Passes are declared in execution order along with the targets they read and
+// write. Targets are either imported (owned elsewhere, e.g. mRT->screen) or
+// transient. A transient target's contents only live from the first pass that
+// uses it to the last one, so transients whose lifetimes don't overlap share
+// storage, as can targets donated by the caller for the duration of the graph.
+// Disabled passes are simply not declared. Storage comes from, and goes back
+// to, gRenderTargetPool, which frees what nothing asks for any more.
+//
+// Usage, once per frame:
+//      S32 src = graph.importTarget(&screen);
+//      S32 dst = graph.createTarget("post", desc);
+//      graph.addPass("tonemap", { src }, { dst }, [&, src, dst]() { tonemap(graph.getTarget(src), graph.getTarget(dst)); });
+//      graph.execute();
+
+class LLRenderGraph
+{
+public:
+    typedef LLRenderTargetPool::Desc TargetDesc;
+
+    typedef std::function<void()> pass_func_t;
+
+    LLRenderGraph();
+    ~LLRenderGraph();
+
+    // declare a target the graph doesn't own, its contents live for the whole graph
+    S32 importTarget(LLRenderTarget* target);
+
+    // lend a target whose contents are dead for the duration of this graph, transients that fit in it may use it
+    void donateTarget(LLRenderTarget* target, const TargetDesc& desc);
+
+    // declare a scratch target, contents are undefined before the first pass that uses it
+    S32 createTarget(const std::string& name, const TargetDesc& desc);
+
+    void addPass(const std::string& name, const std::vector<S32>& reads, const std::vector<S32>& writes, const pass_func_t& func);
+
+    // render target backing the given handle, only valid while the graph executes
+    LLRenderTarget* getTarget(S32 handle) const;
+
+    // assign storage to the transient targets, run the passes in order, then forget the declarations
+    void execute();
+
+private:
+    struct Resource
+    {
+        std::string mName;
+        TargetDesc mDesc;
+        LLRenderTarget* mTarget = nullptr;
+        bool mImported = false;
+        S32 mFirstPass = -1;
+        S32 mLastPass = -1;
+    };
+
+    struct Pass
+    {
+        std::string mName;
+        std::vector<S32> mReads;
+        std::vector<S32> mWrites;
+        pass_func_t mFunc;
+    };
+
+    struct Storage
+    {
+        LLRenderTarget* mTarget = nullptr;
+        TargetDesc mDesc;
+        S32 mBusyUntil = -1; // last pass of the transient currently using this storage
+    };
+
+    void useResource(S32 handle, S32 pass);
+    LLRenderTarget* assignStorage(const Resource& res);
+
+    std::vector<Resource> mResources;
+    std::vector<Pass> mPasses;
+
+    // storage acquired from the pool for the current graph
+    std::vector<Storage> mAcquired;
+
+    // storage lent for the current graph only
+    std::vector<Storage> mDonated;
+
+    // handed out when the pool can't allocate, passes find it incomplete
+    LLRenderTarget mUnallocated;
+};
+
+#endif // LL_LLRENDERGRAPH_H
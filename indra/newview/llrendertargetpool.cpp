@@ -0,0 +1,151 @@
+/**
+ * @file llrendertargetpool.cpp
+ * @brief Scratch render targets shared between subsystems and reused across frames.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llrendertargetpool.h"
+
+#include "llappviewer.h" // gFrameCount
+
+LLRenderTargetPool gRenderTargetPool;
+
+// Targets nothing has acquired in this many frames are freed (e.g. the
+// anti-aliasing scratch targets after FSAA gets turned off, or the scratch
+// space of a high resolution snapshot)
+constexpr U32 MAX_IDLE_FRAMES = 60;
+
+static bool fits(const LLRenderTargetPool::Desc& want, const LLRenderTargetPool::Desc& have)
+{
+    // an extra depth buffer is harmless, it just isn't used
+    return want.mWidth == have.mWidth &&
+        want.mHeight == have.mHeight &&
+        want.mColorFormat == have.mColorFormat &&
+        (have.mDepth || !want.mDepth);
+}
+
+LLRenderTargetPool::~LLRenderTargetPool()
+{
+    // LLPipeline::releaseGLBuffers() freed the idle targets while there was
+    // still a GL, anything left was never given back: leak it rather than
+    // make GL calls without a context
+    for (Entry& entry : mTargets)
+    {
+        (void)entry.mTarget.release();
+    }
+}
+
+LLRenderTarget* LLRenderTargetPool::acquire(const Desc& desc, const std::string& name)
+{
+    for (Entry& entry : mTargets)
+    {
+        if (!entry.mInUse && fits(desc, entry.mDesc))
+        {
+            entry.mInUse = true;
+            entry.mLastUsedFrame = gFrameCount;
+            return entry.mTarget.get();
+        }
+    }
+
+    Entry entry;
+    entry.mTarget = std::make_unique<LLRenderTarget>();
+    if (!entry.mTarget->allocate(desc.mWidth, desc.mHeight, desc.mColorFormat, desc.mDepth))
+    {
+        LL_WARNS("RenderTargetPool") << "Failed to allocate " << desc.mWidth << "x" << desc.mHeight << " target for " << name << LL_ENDL;
+        return nullptr;
+    }
+
+    LL_DEBUGS("RenderTargetPool") << "Allocated " << desc.mWidth << "x" << desc.mHeight << " target for " << name << LL_ENDL;
+
+    entry.mDesc = desc;
+    entry.mBytes = (U64)entry.mTarget->getWidth() * entry.mTarget->getHeight() * 4 *
+        (entry.mTarget->getNumTextures() + (entry.mTarget->getDepth() ? 1 : 0));
+    entry.mLastUsedFrame = gFrameCount;
+    entry.mInUse = true;
+    mBytesAllocated += entry.mBytes;
+
+    mTargets.push_back(std::move(entry));
+    return mTargets.back().mTarget.get();
+}
+
+void LLRenderTargetPool::release(LLRenderTarget* target)
+{
+    if (!target)
+    {
+        return;
+    }
+
+    for (Entry& entry : mTargets)
+    {
+        if (entry.mTarget.get() == target)
+        {
+            llassert(entry.mInUse);
+            llassert(!target->isBoundInStack());
+            entry.mInUse = false;
+            entry.mLastUsedFrame = gFrameCount;
+            return;
+        }
+    }
+
+    llassert(false); // not one of ours
+}
+
+void LLRenderTargetPool::free(std::vector<Entry>::iterator& iter)
+{
+    mBytesAllocated -= iter->mBytes;
+    iter->mTarget->release();
+    iter = mTargets.erase(iter);
+}
+
+void LLRenderTargetPool::reclaim()
+{
+    for (auto iter = mTargets.begin(); iter != mTargets.end(); )
+    {
+        if (!iter->mInUse && gFrameCount - iter->mLastUsedFrame > MAX_IDLE_FRAMES)
+        {
+            free(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
+void LLRenderTargetPool::releaseIdle()
+{
+    for (auto iter = mTargets.begin(); iter != mTargets.end(); )
+    {
+        if (!iter->mInUse)
+        {
+            free(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
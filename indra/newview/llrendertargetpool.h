@@ -0,0 +1,98 @@
+/**
+ * @file llrendertargetpool.h
+ * @brief Scratch render targets shared between subsystems and reused across frames.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#ifndef LL_LLRENDERTARGETPOOL_H
+#define LL_LLRENDERTARGETPOOL_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "llrendertarget.h"
+
+// Scratch render targets, keyed by size and format.
+//
+// A subsystem that needs a target for a while (a render graph transient, a
+// snapshot) acquires one and releases it when done. Released targets stay
+// allocated, so the next request for the same size and format, from any
+// subsystem, reuses one instead of going back to the GL. Targets nothing
+// acquired for a while are freed by reclaim(), called once per frame.
+//
+// Usage:
+//      LLRenderTarget* target = gRenderTargetPool.acquire(desc, "snapshot");
+//      if (target) { ... }
+//      gRenderTargetPool.release(target);
+
+class LLRenderTargetPool
+{
+public:
+    struct Desc
+    {
+        U32 mWidth = 0;
+        U32 mHeight = 0;
+        U32 mColorFormat = GL_RGBA;
+        bool mDepth = false;
+    };
+
+    ~LLRenderTargetPool();
+
+    // a complete target of the given size and format, with a depth buffer if asked
+    // for (and maybe when not), or nullptr if it can't be allocated. Contents are undefined.
+    LLRenderTarget* acquire(const Desc& desc, const std::string& name);
+
+    // give back a target from acquire(), safe to call with nullptr
+    void release(LLRenderTarget* target);
+
+    // free the targets nothing acquired in the last few frames
+    void reclaim();
+
+    // free every target that isn't acquired, e.g. when the screen size changes
+    void releaseIdle();
+
+    // estimate of the GL memory held by the pool, same basis as LLRenderTarget::sBytesAllocated
+    U64 getBytesAllocated() const { return mBytesAllocated; }
+    U32 getNumTargets() const { return (U32)mTargets.size(); }
+
+private:
+    struct Entry
+    {
+        std::unique_ptr<LLRenderTarget> mTarget;
+        Desc mDesc;
+        U64 mBytes = 0;
+        U32 mLastUsedFrame = 0;
+        bool mInUse = false;
+    };
+
+    void free(std::vector<Entry>::iterator& iter);
+
+    std::vector<Entry> mTargets;
+    U64 mBytesAllocated = 0;
+};
+
+extern LLRenderTargetPool gRenderTargetPool;
+
+#endif // LL_LLRENDERTARGETPOOL_H
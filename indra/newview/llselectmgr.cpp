@@ -242,6 +242,7 @@ LLSelectMgr::LLSelectMgr()
     mHighlightedObjects = new LLObjectSelection();
 
     mForceSelection = false;
+    mPropertiesRefreshPending = false;
     mShowSelection = false;
 }
 
@@ -294,6 +295,20 @@ void LLSelectMgr::updateEffects()
     }
 }
 
+void LLSelectMgr::updatePropertiesRefresh()
+{
+    if (!mPropertiesRefreshPending)
+    {
+        return;
+    }
+    mPropertiesRefreshPending = false;
+
+    dialog_refresh_all();
+
+    // hack for left-click buy object
+    LLToolPie::selectionPropertiesReceived();
+}
+
 void LLSelectMgr::resetObjectOverrides()
 {
     resetObjectOverrides(getSelection());
@@ -5992,10 +6007,10 @@ void LLSelectMgr::processObjectProperties(LLMessageSystem* msg, void** user_data
         }
     }
 
-    dialog_refresh_all();
-
-    // hack for left-click buy object
-    LLToolPie::selectionPropertiesReceived();
+    // Selecting a big build brings a reply per packet of ObjectSelect, each
+    // of which would otherwise refresh every selection dialog and rescan the
+    // selection for the left-click buy hack, refresh once per frame instead
+    LLSelectMgr::getInstance()->mPropertiesRefreshPending = true;
 }
 
 // static
@@ -6075,7 +6090,7 @@ void LLSelectMgr::processObjectPropertiesFamily(LLMessageSystem* msg, void** use
         node->mDescription.assign(desc);
     }
 
-    dialog_refresh_all();
+    LLSelectMgr::getInstance()->mPropertiesRefreshPending = true;
 }
 
 
@@ -6704,6 +6719,7 @@ LLSelectNode::LLSelectNode(const LLSelectNode& nodep)
     mSilhouetteVertices = nodep.mSilhouetteVertices;
     mSilhouetteNormals = nodep.mSilhouetteNormals;
     mSilhouetteExists = nodep.mSilhouetteExists;
+    mSilhouetteHash = nodep.mSilhouetteHash;
     mObject = nodep.mObject;
 
     std::vector<LLColor4>::const_iterator color_iter;
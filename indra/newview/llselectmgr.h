@@ -243,6 +243,7 @@ public:
     std::vector<LLVector3>  mSilhouetteVertices;    // array of vertices to render silhouette of object
     std::vector<LLVector3>  mSilhouetteNormals; // array of normals to render silhouette of object
     bool                    mSilhouetteExists;  // need to generate silhouette?
+    U64                     mSilhouetteHash = 0; // inputs of the last generated silhouette
     S32             mSelectedGLTFNode = -1;
     S32             mSelectedGLTFPrimitive = -1;
 
@@ -487,6 +488,7 @@ public:
     void clearSelections();
     void update();
     void updateEffects(); // Update HUD effects
+    void updatePropertiesRefresh(); // Refresh dialogs once for this frame's property replies
 
     // When we edit object's position/rotation/scale we set local
     // overrides and ignore any updates (override received valeus).
@@ -936,6 +938,7 @@ private:
 
     LLFrameTimer            mEffectsTimer;
     bool                    mForceSelection;
+    bool                    mPropertiesRefreshPending; // property replies arrived since the last refresh
 
     std::vector<LLAnimPauseRequest> mPauseRequests;
 };
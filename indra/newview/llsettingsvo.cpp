@@ -808,9 +808,15 @@ void LLSettingsVOSky::applySpecial(void *ptarget, bool force)
 
     F32 probe_ambiance = getReflectionProbeAmbiance();
 
+    // values the shaders end up with, for the atmospheric terms below
+    LLColor3 shader_ambient(ambient);
+    LLColor3 shader_blue_horizon = getBlueHorizon();
+    LLColor3 shader_blue_density = getBlueDensity();
+
     if (irradiance_pass)
     { // during an irradiance map update, disable ambient lighting (direct lighting only) and desaturate sky color (avoid tinting the world blue)
         shader->uniform3fv(LLShaderMgr::AMBIENT, LLVector3::zero.mV);
+        shader_ambient = LLColor3::black;
     }
     else
     {
@@ -821,15 +827,16 @@ void LLSettingsVOSky::applySpecial(void *ptarget, bool force)
         }
         else if (psky->canAutoAdjust() && should_auto_adjust)
         { // auto-adjust legacy sky to take advantage of probe ambiance
-            shader->uniform3fv(LLShaderMgr::AMBIENT, (ambient * auto_adjust_ambient_scale).mV);
+            shader_ambient = ambient * auto_adjust_ambient_scale;
+            shader->uniform3fv(LLShaderMgr::AMBIENT, shader_ambient.mV);
             shader->uniform1f(LLShaderMgr::SKY_HDR_SCALE, auto_adjust_hdr_scale);
-            LLColor3 blue_horizon = getBlueHorizon() * auto_adjust_blue_horizon_scale;
-            LLColor3 blue_density = getBlueDensity() * auto_adjust_blue_density_scale;
+            shader_blue_horizon = getBlueHorizon() * auto_adjust_blue_horizon_scale;
+            shader_blue_density = getBlueDensity() * auto_adjust_blue_density_scale;
             sun_light_color = sun_light_color * auto_adjust_sun_color_scale;
 
             shader->uniform3fv(LLShaderMgr::SUNLIGHT_COLOR, sun_light_color.mV);
-            shader->uniform3fv(LLShaderMgr::BLUE_DENSITY, blue_density.mV);
-            shader->uniform3fv(LLShaderMgr::BLUE_HORIZON, blue_horizon.mV);
+            shader->uniform3fv(LLShaderMgr::BLUE_DENSITY, shader_blue_density.mV);
+            shader->uniform3fv(LLShaderMgr::BLUE_HORIZON, shader_blue_horizon.mV);
 
             probe_ambiance = sAutoAdjustProbeAmbiance;
         }
@@ -848,9 +855,37 @@ void LLSettingsVOSky::applySpecial(void *ptarget, bool force)
     shader->uniform1f(LLShaderMgr::DISTANCE_MULTIPLIER, getDistanceMultiplier());
 
     shader->uniform1f(LLShaderMgr::GAMMA, g);
+
+    // Terms of calcAtmosphericVars() that depend on neither the fragment position nor the
+    // sun and moon colors (LLPipeline::bindDeferredShader sets its own), computed once here
+    // instead of in every pixel of every shader using atmospherics.
+    // Keep in sync with indra\newview\app_settings\shaders\class1\windlight\atmosphericsFuncs.glsl
+    {
+        F32 haze_density = getHazeDensity();
+        F32 density_multiplier = getDensityMultiplier();
+
+        // sunlight attenuation due to atmosphere, from the light elevation
+        LLColor3 light_atten = (shader_blue_density + smear(haze_density * 0.25f)) * (density_multiplier * getMaxY());
+        F32 above_horizon_factor = 1.f / llmax(1e-6f, light_direction.mV[VY]);
+        LLColor3 transmittance = componentExp(light_atten * -above_horizon_factor);
+
+        LLColor3 combined_haze = shader_blue_density + smear(haze_density);
+        combined_haze.set(llmax(combined_haze.mV[0], 1e-6f), llmax(combined_haze.mV[1], 1e-6f), llmax(combined_haze.mV[2], 1e-6f));
+        LLColor3 blue_weight = componentMult(shader_blue_horizon, componentDiv(shader_blue_density, combined_haze));
+        LLColor3 haze_weight = componentDiv(smear(haze_density), combined_haze) * getHazeHorizon();
+
+        // increase ambient when there are more clouds
+        LLColor3 tmp_ambient = shader_ambient + (smear(1.f) - shader_ambient) * getCloudShadow() * 0.5f;
+
+        shader->uniform3fv(LLShaderMgr::ATMO_TRANSMITTANCE, transmittance.mV);
+        shader->uniform3fv(LLShaderMgr::ATMO_AMBIENT, tmp_ambient.mV);
+        shader->uniform3fv(LLShaderMgr::ATMO_EXTINCTION, (combined_haze * (density_multiplier * getDistanceMultiplier())).mV);
+        shader->uniform3fv(LLShaderMgr::ATMO_BLUE_WEIGHT, blue_weight.mV);
+        shader->uniform3fv(LLShaderMgr::ATMO_HAZE_WEIGHT, haze_weight.mV);
+    }
 }
 
-LLSettingsSky::parammapping_t LLSettingsVOSky::getParameterMap() const
+const LLSettingsSky::parammapping_t& LLSettingsVOSky::getParameterMap() const
 {
     static parammapping_t param_map;
 
@@ -1140,7 +1175,7 @@ void LLSettingsVOWater::updateSettings()
     }
 }
 
-LLSettingsWater::parammapping_t LLSettingsVOWater::getParameterMap() const
+const LLSettingsWater::parammapping_t& LLSettingsVOWater::getParameterMap() const
 {
     static parammapping_t param_map;
 
@@ -113,7 +113,7 @@ protected:
     virtual void    applyToUniforms(void*) override;
     virtual void    applySpecial(void *, bool) override;
 
-    virtual parammapping_t getParameterMap() const override;
+    virtual const parammapping_t& getParameterMap() const override;
 
     bool m_isAdvanced = false;
     F32 mSceneLightStrength = 3.0f;
@@ -142,7 +142,7 @@ protected:
     virtual void    applyToUniforms(void*) override;
     virtual void    applySpecial(void *, bool) override;
 
-    virtual parammapping_t getParameterMap() const override;
+    virtual const parammapping_t& getParameterMap() const override;
 
 
 private:
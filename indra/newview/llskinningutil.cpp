@@ -36,6 +36,17 @@
 
 #define DEBUG_SKINNING  LL_DEBUG
 
+namespace
+{
+    // Keyed by mesh rather than LLMeshSkinInfo::mHash, which does not cover
+    // the alternate bind matrices, and by the bone and collision volume
+    // counts, which fix the joint numbering of a skeleton.
+    typedef std::tuple<LLUUID, S32, S32> joint_override_key_t;
+    typedef std::map<joint_override_key_t, LLPointer<LLJointOverrideTable> > joint_override_map_t;
+    joint_override_map_t sJointOverrides;
+    size_t sJointOverridesPurgeSize = 256;
+}
+
 void dump_avatar_and_skin_state(const std::string& reason, LLVOAvatar *avatar, const LLMeshSkinInfo *skin)
 {
 #if DEBUG_SKINNING
@@ -373,6 +384,62 @@ void LLSkinningUtil::updateRiggingInfo(const LLMeshSkinInfo* skin, LLVOAvatar *a
 
 // This is used for extracting rotation from a bind shape matrix that
 // already has scales baked in
+LLPointer<LLJointOverrideTable> LLSkinningUtil::getJointOverrides(const LLMeshSkinInfo* skin, LLVOAvatar* avatar)
+{
+    joint_override_key_t key(skin->mMeshID, avatar->mNumBones, avatar->mNumCollisionVolumes);
+    joint_override_map_t::iterator iter = sJointOverrides.find(key);
+    if (iter != sJointOverrides.end())
+    {
+        return iter->second;
+    }
+
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
+
+    LLPointer<LLJointOverrideTable> table = new LLJointOverrideTable;
+    table->mLockScale = skin->mLockScaleIfJointPosition;
+
+    U32 count = llmin((U32)skin->mJointNames.size(), (U32)skin->mAlternateBindMatrix.size());
+    for (U32 i = 0; i < count; ++i)
+    {
+        LLJoint* joint = avatar->getJoint(skin->mJointNames[i]);
+        // numbered joints only, the others could not be found again
+        if (joint && avatar->getJoint(joint->getJointNum()) == joint)
+        {
+            LLVector3 pos(skin->mAlternateBindMatrix[i].getTranslation());
+            if (joint->aboveJointPosThreshold(pos))
+            {
+                table->mPosOverrides.push_back({ joint->getJointNum(), pos, skin->mJointNames[i] == "mPelvis" });
+            }
+        }
+    }
+
+    // A skeleton that is still being built resolves differently, don't keep that
+    if (!avatar->isBuilt())
+    {
+        return table;
+    }
+
+    // Drop the tables no avatar wears any more once in a while
+    if (sJointOverrides.size() >= sJointOverridesPurgeSize)
+    {
+        for (iter = sJointOverrides.begin(); iter != sJointOverrides.end();)
+        {
+            if (iter->second->getNumRefs() == 1)
+            {
+                iter = sJointOverrides.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+        sJointOverridesPurgeSize = llmax((size_t)256, sJointOverrides.size() * 2);
+    }
+
+    sJointOverrides[key] = table;
+    return table;
+}
+
 LLQuaternion LLSkinningUtil::getUnscaledQuaternion(const LLMatrix4& mat4)
 {
     LLMatrix3 bind_mat = mat4.getMat3();
@@ -31,12 +31,34 @@
 #include "v4math.h"
 #include "llvector4a.h"
 #include "llmatrix4a.h"
+#include "llpointer.h"
+#include "llrefcount.h"
+#include "v3math.h"
 
 class LLVOAvatar;
 class LLMeshSkinInfo;
 class LLVolumeFace;
 class LLJointRiggingInfoTab;
 
+// Joint position overrides of a skin, resolved against a skeleton layout.
+// Shared by every avatar with that layout that wears the mesh, so adding
+// and removing the overrides of an attachment does not look up joint names
+// or matrices again.
+class LLJointOverrideTable : public LLRefCount
+{
+public:
+    struct Entry
+    {
+        S32         mJointNum;
+        LLVector3   mPosition;
+        bool        mIsPelvis;
+    };
+
+    // only the joints whose alternate bind position is above the threshold
+    std::vector<Entry>  mPosOverrides;
+    bool                mLockScale = false;
+};
+
 namespace LLSkinningUtil
 {
     S32 getMaxJointCount();
@@ -69,6 +91,10 @@ namespace LLSkinningUtil
     void initJointNums(LLMeshSkinInfo* skin, LLVOAvatar *avatar);
     void updateRiggingInfo(const LLMeshSkinInfo* skin, LLVOAvatar *avatar, LLVolumeFace& vol_face);
     LLQuaternion getUnscaledQuaternion(const LLMatrix4& mat4);
+
+    // Returns the override table of a full rig skin for 'avatar', resolved
+    // on first use and shared afterwards. Main thread only.
+    LLPointer<LLJointOverrideTable> getJointOverrides(const LLMeshSkinInfo* skin, LLVOAvatar* avatar);
 };
 
 #endif
@@ -0,0 +1,115 @@
+/**
+ * @file llskinpalettes.cpp
+ * @brief Per frame uniform buffers of rigged mesh joint palettes shared by every render pass.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llskinpalettes.h"
+
+#include "llglslshader.h"
+#include "lljoint.h"
+#include "llvoavatar.h"
+
+// std140 mat3x4, see LLVOAvatar::updateSkinInfoMatrixPalette
+constexpr U32 PALETTE_MATRIX_SIZE = 12 * sizeof(F32);
+
+LLSkinPalettes::LLSkinPalettes()
+{
+}
+
+LLSkinPalettes::~LLSkinPalettes()
+{
+}
+
+U32 LLSkinPalettes::allocateSlot()
+{
+    if (mSlotSize == 0)
+    {
+        // a range has to cover the whole block, however few joints the mesh uses
+        GLint align = 256;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &align);
+        align = llmax(align, 16);
+        mSlotSize = ((LL_MAX_JOINTS_PER_MESH_OBJECT * PALETTE_MATRIX_SIZE + align - 1) / align) * align;
+    }
+
+    if (mFrame != gFrameCount)
+    {
+        mFrame = gFrameCount;
+        mUsed = 0;
+        ++mGeneration;
+    }
+
+    U32 slot = mUsed++;
+    U32 buffer = slot / SLOTS_PER_BUFFER;
+    if (buffer == mBuffers.size())
+    {
+        U32 name = 0;
+        glGenBuffers(1, &name);
+        mBuffers.push_back(name);
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, mBuffers[buffer]);
+    if (slot % SLOTS_PER_BUFFER == 0)
+    { // first use this frame, orphan last frame's storage rather than wait for the GPU to finish reading it
+        glBufferData(GL_UNIFORM_BUFFER, SLOTS_PER_BUFFER * mSlotSize, nullptr, GL_STREAM_DRAW);
+    }
+
+    return slot;
+}
+
+bool LLSkinPalettes::bind(LLVOAvatar* avatar, const LLMeshSkinInfo* skin)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
+
+    const LLVOAvatar::MatrixPaletteCache& mpc = avatar->updateSkinInfoMatrixPalette(skin);
+    U32 count = static_cast<U32>(mpc.mMatrixPalette.size());
+    if (count == 0)
+    {
+        return false;
+    }
+
+    if (mpc.mSlotGeneration != mGeneration || mFrame != gFrameCount)
+    {
+        mpc.mSlot = allocateSlot();
+        mpc.mSlotGeneration = mGeneration;
+
+        glBufferSubData(GL_UNIFORM_BUFFER, (mpc.mSlot % SLOTS_PER_BUFFER) * mSlotSize, count * PALETTE_MATRIX_SIZE, mpc.mGLMp.data());
+    }
+
+    glBindBufferRange(GL_UNIFORM_BUFFER, LLGLSLShader::UB_AVATAR_PALETTE, mBuffers[mpc.mSlot / SLOTS_PER_BUFFER],
+                      (mpc.mSlot % SLOTS_PER_BUFFER) * mSlotSize, mSlotSize);
+    return true;
+}
+
+void LLSkinPalettes::release()
+{
+    if (!mBuffers.empty())
+    {
+        glDeleteBuffers((GLsizei)mBuffers.size(), mBuffers.data());
+        mBuffers.clear();
+    }
+    mUsed = 0;
+    ++mGeneration; // every palette gets written again
+}
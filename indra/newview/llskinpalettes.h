@@ -0,0 +1,71 @@
+/**
+ * @file llskinpalettes.h
+ * @brief Per frame uniform buffers of rigged mesh joint palettes shared by every render pass.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLSKINPALETTES_H
+#define LL_LLSKINPALETTES_H
+
+#include <vector>
+
+#include "stdtypes.h"
+
+class LLMeshSkinInfo;
+class LLVOAvatar;
+
+// Holds the joint matrix palettes of the rigged meshes drawn this frame in
+// uniform buffers, bound to LLGLSLShader::UB_AVATAR_PALETTE ("AvatarPalette"
+// in avatar/objectSkinV.glsl) one range per draw.
+//
+// A palette is written the first time some pass draws its mesh in a frame.
+// The depth, shadow, reflection probe and main passes after it only rebind
+// its range, where each of them used to upload it as uniforms again, once per
+// shader.
+class LLSkinPalettes
+{
+public:
+    // palettes per uniform buffer
+    static constexpr U32 SLOTS_PER_BUFFER = 64;
+
+    LLSkinPalettes();
+    ~LLSkinPalettes();
+
+    // bind the palette of 'skin' posed by 'avatar' this frame, writing it first if no pass has yet
+    // returns false if the skin isn't loaded, the mesh can't be drawn
+    bool bind(LLVOAvatar* avatar, const LLMeshSkinInfo* skin);
+
+    void release();
+
+private:
+    // returns the slot for a palette not written this frame yet, bound to GL_UNIFORM_BUFFER
+    U32 allocateSlot();
+
+    std::vector<U32> mBuffers;
+    U32 mSlotSize = 0;  // bytes, a full palette rounded up to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+    U32 mUsed = 0;      // slots handed out this frame
+    U32 mFrame = 0;
+    U32 mGeneration = 1; // changes whenever the slots are handed out anew, see LLVOAvatar::MatrixPaletteCache::mSlotGeneration
+};
+
+#endif // LL_LLSKINPALETTES_H
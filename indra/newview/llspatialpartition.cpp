@@ -60,6 +60,7 @@ static U32 sZombieGroups = 0;
 U32 LLSpatialGroup::sNodeCount = 0;
 
 bool LLSpatialGroup::sNoDelete = false;
+U32 LLSpatialPartition::sChangeCount = 0;
 
 static F32 sLastMaxTexPriority = 1.f;
 static F32 sCurMaxTexPriority = 1.f;
@@ -577,6 +578,7 @@ LLSpatialGroup::LLSpatialGroup(OctreeNode* node, LLSpatialPartition* part) : LLO
     mObjectBoxSize(1.f),
     mGeometryBytes(0),
     mSurfaceArea(0.f),
+    mLayoutFaceCount(0),
     mBuilt(0.f),
     mVertexBuffer(NULL),
     mDistance(0.f),
@@ -766,6 +768,16 @@ bool LLSpatialGroup::changeLOD()
     return false;
 }
 
+//virtual
+void LLSpatialGroup::unbound()
+{
+    // every insertion, removal and move comes through here, even when the
+    // group is already dirty
+    getSpatialPartition()->mChangeCount++;
+    LLSpatialPartition::sChangeCount++;
+    LLViewerOctreeGroup::unbound();
+}
+
 void LLSpatialGroup::handleInsertion(const TreeNode* node, LLViewerOctreeEntry* entry)
 {
     addObject((LLDrawable*)entry->getDrawable());
@@ -903,7 +915,7 @@ void LLSpatialGroup::destroyGLState(bool keep_occlusion)
 //==============================================
 
 LLSpatialPartition::LLSpatialPartition(U32 data_mask, bool render_by_group, LLViewerRegion* regionp)
-: mRenderByGroup(render_by_group), mBridge(NULL)
+: mRenderByGroup(render_by_group), mChangeCount(0), mBridge(NULL)
 {
     mRegionp = regionp;
     mPartitionType = LLViewerRegion::PARTITION_NONE;
@@ -1025,12 +1037,14 @@ void LLSpatialPartition::shift(const LLVector4a &offset)
 { //shift octree node bounding boxes by offset
     LLSpatialShift shifter(offset);
     shifter.traverse(mOctree);
+    mChangeCount++;
+    sChangeCount++;
 }
 
 class LLOctreeCull : public LLViewerOctreeCull
 {
 public:
-    LLOctreeCull(LLCamera* camera) : LLViewerOctreeCull(camera) {}
+    LLOctreeCull(LLCamera* camera) : LLViewerOctreeCull(camera), mVisible(NULL) {}
 
     virtual bool earlyFail(LLViewerOctreeGroup* base_group)
     {
@@ -1064,6 +1078,18 @@ public:
         return res;
     }
 
+    virtual void frustumCheckBatch(const LLViewerOctreeGroup* const* groups, const LLVector4a* const* bounds, U32 count, S32* results)
+    {
+        AABBsInFrustumNoFarClipGroupBounds(bounds, count, results);
+        for (U32 i = 0; i < count; i++)
+        {
+            if (results[i] != 0)
+            {
+                results[i] = llmin(results[i], AABBSphereIntersectGroupExtents(groups[i]));
+            }
+        }
+    }
+
     virtual S32 frustumCheckObjects(const LLViewerOctreeGroup* group)
     {
         S32 res = AABBInFrustumNoFarClipObjectBounds(group);
@@ -1082,8 +1108,18 @@ public:
         {
             group->doOcclusion(mCamera);
         }*/
-        gPipeline.markNotCulled(group, *mCamera);
+        if (mVisible)
+        {
+            mVisible->push_back(group);
+        }
+        else
+        {
+            gPipeline.markNotCulled(group, *mCamera);
+        }
     }
+
+    // if set, visible groups are collected here instead of marked
+    std::vector<LLSpatialGroup*>* mVisible;
 };
 
 class LLOctreeCullNoFarClip : public LLOctreeCull
@@ -1097,6 +1133,11 @@ public:
         return AABBInFrustumNoFarClipGroupBounds(group);
     }
 
+    virtual void frustumCheckBatch(const LLViewerOctreeGroup* const* groups, const LLVector4a* const* bounds, U32 count, S32* results)
+    {
+        AABBsInFrustumNoFarClipGroupBounds(bounds, count, results);
+    }
+
     virtual S32 frustumCheckObjects(const LLViewerOctreeGroup* group)
     {
         S32 res = AABBInFrustumNoFarClipObjectBounds(group);
@@ -1115,12 +1156,49 @@ public:
         return AABBInFrustumGroupBounds(group);
     }
 
+    virtual void frustumCheckBatch(const LLViewerOctreeGroup* const* groups, const LLVector4a* const* bounds, U32 count, S32* results)
+    {
+        AABBsInFrustumGroupBounds(bounds, count, results);
+    }
+
     virtual S32 frustumCheckObjects(const LLViewerOctreeGroup* group)
     {
         return AABBInFrustumObjectBounds(group);
     }
 };
 
+// Cull for cube snapshots (reflection probes and mirrors). Their faces are low resolution
+// and get blurred further by the probe filtering, so groups whose bounding radius is less
+// than RenderReflectionMinCoverage of their distance from the snapshot origin are left out.
+class LLOctreeCullReflection : public LLOctreeCull
+{
+public:
+    LLOctreeCullReflection(LLCamera* camera, F32 min_coverage)
+        : LLOctreeCull(camera), mMinCoverage(min_coverage) { }
+
+    virtual bool earlyFail(LLViewerOctreeGroup* base_group)
+    {
+        // group bounds enclose the children too, so a group too small to see takes its whole subtree with it
+        const LLVector4a* bounds = base_group->getBounds();
+        LLVector4a delta;
+        delta.setSub(bounds[0], mOrigin);
+        F32 radius = bounds[1].getLength3().getF32();
+        F32 distance = delta.getLength3().getF32();
+        if (distance > radius && radius < distance * mMinCoverage)
+        {
+            return true;
+        }
+
+        return LLOctreeCull::earlyFail(base_group);
+    }
+
+    void setOrigin(const LLVector3& origin) { mOrigin.load3(origin.mV); }
+
+private:
+    LLVector4a mOrigin;
+    F32 mMinCoverage;
+};
+
 class LLOctreeCullVisExtents: public LLOctreeCullShadow
 {
 public:
@@ -1434,23 +1512,54 @@ S32 LLSpatialPartition::cull(LLCamera &camera, bool do_occlusion)
     ((LLSpatialGroup*)mOctree->getListener(0))->validate();
 #endif
 
+    traverseCull(camera, NULL);
+
+    return 0;
+}
+
+void LLSpatialPartition::prepareCull()
+{
+    LLSpatialGroup* group = (LLSpatialGroup*) mOctree->getListener(0);
+    group->rebound();
+}
+
+void LLSpatialPartition::cullGroups(LLCamera& camera, std::vector<LLSpatialGroup*>& visible)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_SPATIAL;
+    // occlusion checks read back queries and change group state
+    llassert(LLPipeline::sUseOcclusion < 2);
+    traverseCull(camera, &visible);
+}
+
+void LLSpatialPartition::traverseCull(LLCamera& camera, std::vector<LLSpatialGroup*>* visible)
+{
+    const F32 min_coverage = LLPipeline::RenderReflectionMinCoverage;
+
     if (LLPipeline::sShadowRender)
     {
         LLOctreeCullShadow culler(&camera);
+        culler.mVisible = visible;
         culler.traverse(mOctree);
     }
     else if (mInfiniteFarClip || (!LLPipeline::sUseFarClip && !gCubeSnapshot))
     {
         LLOctreeCullNoFarClip culler(&camera);
+        culler.mVisible = visible;
+        culler.traverse(mOctree);
+    }
+    else if (gCubeSnapshot && min_coverage > 0.f)
+    {
+        LLOctreeCullReflection culler(&camera, min_coverage);
+        culler.setOrigin(camera.getOrigin());
+        culler.mVisible = visible;
         culler.traverse(mOctree);
     }
     else
     {
         LLOctreeCull culler(&camera);
+        culler.mVisible = visible;
         culler.traverse(mOctree);
     }
-
-    return 0;
 }
 
 void pushVerts(LLDrawInfo* params)
@@ -3641,6 +3750,231 @@ bool LLSpatialPartition::isVisible(const LLVector3& v)
     return true;
 }
 
+//-----------------------------------------------------------------------------------
+//class LLDrawableBVH definitions
+//-----------------------------------------------------------------------------------
+
+namespace
+{
+    // drawables per leaf
+    const U32 BVH_LEAF_SIZE = 4;
+
+    struct BVHItem
+    {
+        LLVector4a mMin;
+        LLVector4a mMax;
+        LLVector4a mCenter;
+        LLViewerOctreeEntry* mEntry;
+    };
+    // scratch for build(), kept to save reallocating
+    std::vector<BVHItem> sBVHItems;
+
+    void collect_bvh_items(const OctreeNode* node)
+    {
+        for (OctreeNode::const_element_iter i = node->getDataBegin(); i != node->getDataEnd(); ++i)
+        {
+            LLViewerOctreeEntry* entry = *i;
+            const LLVector4a* exts = entry->getSpatialExtents();
+            BVHItem item;
+            item.mMin = exts[0];
+            item.mMax = exts[1];
+            item.mCenter.setAdd(exts[0], exts[1]);
+            item.mCenter.mul(0.5f);
+            item.mEntry = entry;
+            sBVHItems.push_back(item);
+        }
+        for (U32 i = 0; i < node->getChildCount(); i++)
+        {
+            collect_bvh_items(node->getChild(i));
+        }
+    }
+
+    // Slab test: where the segment start + t * dir, t in [0, t_max], enters
+    // the box, or -1 if it misses
+    inline F32 bvh_enter(const LLVector4a& min, const LLVector4a& max,
+                         const LLVector4a& start, const LLVector4a& inv_dir, F32 t_max)
+    {
+        LLVector4a t0, t1, t_near, t_far;
+        t0.setSub(min, start);
+        t0.mul(inv_dir);
+        t1.setSub(max, start);
+        t1.mul(inv_dir);
+        t_near.setMin(t0, t1);
+        t_far.setMax(t0, t1);
+        F32 enter = llmax(t_near[0], t_near[1], t_near[2], 0.f);
+        F32 leave = llmin(t_far[0], t_far[1], t_far[2], t_max);
+        return (enter <= leave) ? enter : -1.f;
+    }
+}
+
+void LLDrawableBVH::build(const OctreeNode* root, U32 change_count)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_SPATIAL;
+    mNodes.clear();
+    mEntries.clear();
+    mEntryExtents.clear();
+    mChangeCount = change_count;
+
+    sBVHItems.clear();
+    collect_bvh_items(root);
+    if (sBVHItems.empty())
+    {
+        // leave one empty leaf so isCurrent() holds
+        Node node;
+        node.mMin.clear();
+        node.mMax.clear();
+        node.mFirst = 0;
+        node.mCount = 0;
+        mNodes.push_back(node);
+        return;
+    }
+
+    mNodes.reserve(2 * sBVHItems.size() / BVH_LEAF_SIZE + 1);
+    buildNode(0, (U32)sBVHItems.size());
+
+    mEntries.reserve(sBVHItems.size());
+    mEntryExtents.reserve(sBVHItems.size() * 2);
+    for (const BVHItem& item : sBVHItems)
+    {
+        mEntries.push_back(item.mEntry);
+        mEntryExtents.push_back(item.mMin);
+        mEntryExtents.push_back(item.mMax);
+    }
+    sBVHItems.clear();
+}
+
+U32 LLDrawableBVH::buildNode(U32 begin, U32 end)
+{
+    LLVector4a min = sBVHItems[begin].mMin;
+    LLVector4a max = sBVHItems[begin].mMax;
+    LLVector4a center_min = sBVHItems[begin].mCenter;
+    LLVector4a center_max = center_min;
+    for (U32 i = begin + 1; i < end; i++)
+    {
+        const BVHItem& item = sBVHItems[i];
+        min.setMin(min, item.mMin);
+        max.setMax(max, item.mMax);
+        center_min.setMin(center_min, item.mCenter);
+        center_max.setMax(center_max, item.mCenter);
+    }
+
+    U32 index = (U32)mNodes.size();
+    Node node;
+    node.mMin = min;
+    node.mMax = max;
+    node.mFirst = begin;
+    node.mCount = end - begin;
+    mNodes.push_back(node);
+
+    LLVector4a spread;
+    spread.setSub(center_max, center_min);
+    S32 axis = (spread[0] > spread[1]) ? ((spread[0] > spread[2]) ? 0 : 2) : ((spread[1] > spread[2]) ? 1 : 2);
+    if (end - begin <= BVH_LEAF_SIZE || spread[axis] <= 0.f)
+    {
+        return index;
+    }
+
+    // median split: always balanced, so the tree is never deeper than
+    // log2 of the drawable count
+    U32 mid = begin + (end - begin) / 2;
+    std::nth_element(sBVHItems.begin() + begin, sBVHItems.begin() + mid, sBVHItems.begin() + end,
+                     [axis](const BVHItem& a, const BVHItem& b)
+                     {
+                         return a.mCenter[axis] < b.mCenter[axis];
+                     });
+    buildNode(begin, mid);
+    U32 second = buildNode(mid, end);
+    mNodes[index].mFirst = second;
+    mNodes[index].mCount = 0;
+    return index;
+}
+
+template <typename CHECK>
+void LLDrawableBVH::intersect(const LLVector4a& start, LLVector4a& end, CHECK&& check) const
+{
+    LLVector4a dir;
+    dir.setSub(end, start);
+    F32 len_sq = dir.dot3(dir).getF32();
+    if (mNodes.empty() || len_sq <= 0.f)
+    {
+        return;
+    }
+
+    LLVector4a inv_dir;
+    for (S32 i = 0; i < 3; i++)
+    {
+        // keep away from infinities, so no 0 * inf in the slab test
+        F32 d = dir[i];
+        inv_dir.getF32ptr()[i] = 1.f / ((fabsf(d) > 1e-20f) ? d : ((d < 0.f) ? -1e-20f : 1e-20f));
+    }
+    inv_dir.getF32ptr()[3] = 0.f;
+
+    // end moves in as check() finds hits
+    auto t_max = [&]()
+    {
+        LLVector4a delta;
+        delta.setSub(end, start);
+        return delta.dot3(dir).getF32() / len_sq;
+    };
+
+    F32 limit = t_max();
+    struct Pending
+    {
+        U32 mNode;
+        F32 mEnter;
+    };
+    Pending stack[64];
+    U32 depth = 0;
+    F32 enter = bvh_enter(mNodes[0].mMin, mNodes[0].mMax, start, inv_dir, limit);
+    if (enter >= 0.f)
+    {
+        stack[depth++] = { 0, enter };
+    }
+
+    while (depth)
+    {
+        const Pending pending = stack[--depth];
+        if (pending.mEnter > limit)
+        {
+            continue;
+        }
+
+        const Node& node = mNodes[pending.mNode];
+        if (node.mCount)
+        {
+            for (U32 i = node.mFirst; i < node.mFirst + node.mCount; i++)
+            {
+                if (bvh_enter(mEntryExtents[i * 2], mEntryExtents[i * 2 + 1], start, inv_dir, limit) >= 0.f)
+                {
+                    check(mEntries[i]);
+                    limit = t_max();
+                }
+            }
+            continue;
+        }
+
+        U32 near_node = pending.mNode + 1;
+        U32 far_node = node.mFirst;
+        F32 near_enter = bvh_enter(mNodes[near_node].mMin, mNodes[near_node].mMax, start, inv_dir, limit);
+        F32 far_enter = bvh_enter(mNodes[far_node].mMin, mNodes[far_node].mMax, start, inv_dir, limit);
+        if (far_enter >= 0.f && (near_enter < 0.f || far_enter < near_enter))
+        {
+            std::swap(near_node, far_node);
+            std::swap(near_enter, far_enter);
+        }
+        // push the farther first, so the nearer is checked first
+        llassert(depth + 2 <= LL_ARRAY_SIZE(stack));
+        if (far_enter >= 0.f)
+        {
+            stack[depth++] = { far_node, far_enter };
+        }
+        if (near_enter >= 0.f)
+        {
+            stack[depth++] = { near_node, near_enter };
+        }
+    }
+}
+
 LL_ALIGN_PREFIX(16)
 class LLOctreeIntersect : public LLOctreeTraveler<LLViewerOctreeEntry, LLPointer<LLViewerOctreeEntry>>
 {
@@ -3726,6 +4060,12 @@ public:
         return mHit;
     }
 
+    LLDrawable* check(const LLDrawableBVH& bvh)
+    {
+        bvh.intersect(mStart, mEnd, [this](LLViewerOctreeEntry* entry) { check(entry); });
+        return mHit;
+    }
+
     virtual bool check(LLViewerOctreeEntry* entry)
     {
         LLDrawable* drawable = (LLDrawable*)entry->getDrawable();
@@ -3812,11 +4152,35 @@ LLDrawable* LLSpatialPartition::lineSegmentIntersect(const LLVector4a& start, co
 
 {
     LLOctreeIntersect intersect(start, end, pick_transparent, pick_rigged, pick_unselectable, pick_reflection_probe, face_hit, intersection, tex_coord, normal, tangent);
-    LLDrawable* drawable = intersect.check(mOctree);
+    LLDrawable* drawable;
+    if (usePickBVH())
+    {
+        if (!mPickBVH.isCurrent(mChangeCount))
+        {
+            mPickBVH.build(mOctree, mChangeCount);
+        }
+        drawable = intersect.check(mPickBVH);
+    }
+    else
+    {
+        drawable = intersect.check(mOctree);
+    }
 
     return drawable;
 }
 
+// Bridges have their own local space octrees, which the BVH doesn't follow
+// into, and avatars are picked by more than their drawable's extents (rigged
+// attachments), so those stay on the octree.
+bool LLSpatialPartition::usePickBVH()
+{
+    static LLCachedControl<bool> use_bvh(gSavedSettings, "RenderPickBVH", true);
+    return use_bvh
+        && !isBridge()
+        && mPartitionType != LLViewerRegion::PARTITION_AVATAR
+        && mPartitionType != LLViewerRegion::PARTITION_CONTROL_AV;
+}
+
 LLDrawable* LLSpatialGroup::lineSegmentIntersect(const LLVector4a& start, const LLVector4a& end,
     bool pick_transparent,
     bool pick_rigged,
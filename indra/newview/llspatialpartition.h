@@ -101,6 +101,19 @@ public:
     U32 mCount = 0;
     U32 mOffset = 0;
 
+    // Clusters of the single large face this batch draws, in the space of
+    // mVertexBuffer (see LLVolumeFace::mClusters). Empty for batches that
+    // can only be drawn whole.
+    struct Cluster
+    {
+        LLVector4a mCenter;     // w is the radius
+        LLVector4a mConeApex;
+        LLVector4a mConeAxis;   // w is the cutoff, above 1 if the cone is unusable
+        U32 mOffset = 0;        // first index in mVertexBuffer
+        U32 mCount = 0;
+    };
+    std::vector<Cluster> mClusters;
+
     LLPointer<LLViewerTexture>     mTexture;
     LLPointer<LLViewerTexture> mSpecularMap;
     LLPointer<LLViewerTexture> mNormalMap;
@@ -336,6 +349,7 @@ public:
 
     // LLViewerOctreeGroup
     virtual void rebound();
+    virtual void unbound();
 
 public:
     LL_ALIGN_16(LLVector4a mViewAngle);
@@ -354,6 +368,7 @@ public:
     F32 mObjectBoxSize; //cached mObjectBounds[1].getLength3()
     U32 mGeometryBytes; //used by volumes to track how many bytes of geometry data are in this node
     F32 mSurfaceArea; //used by volumes to track estimated surface area of geometry in this node
+    U32 mLayoutFaceCount; //used by volumes to track how many faces the last full rebuild laid out, see LLFace::mLayoutKey
     F32 mBuilt;
 
     F32 mDistance;
@@ -382,6 +397,43 @@ public:
     virtual void addGeometryCount(LLSpatialGroup* group, U32 &vertex_count, U32 &index_count);
 };
 
+// Bounding volume hierarchy over the drawables in an octree, built from
+// their spatial extents, for picking. Boxes are split at the median along
+// their longest axis down to a few drawables each, and intersect() visits
+// the nearer child first, so that the first hits shorten the segment and
+// prune the rest.
+class LLDrawableBVH
+{
+public:
+    LLDrawableBVH() : mChangeCount(0) { }
+
+    // change_count is the partition's mChangeCount when built
+    void build(const OctreeNode* root, U32 change_count);
+    bool isCurrent(U32 change_count) const { return !mNodes.empty() && mChangeCount == change_count; }
+
+    // Call check(entry) on every entry whose extents the segment from start
+    // to end crosses; check() may move end closer to start, and only
+    // entries nearer than that are checked after.
+    template <typename CHECK>
+    void intersect(const LLVector4a& start, LLVector4a& end, CHECK&& check) const;
+
+private:
+    U32 buildNode(U32 begin, U32 end);
+
+    struct Node
+    {
+        LLVector4a mMin;
+        LLVector4a mMax;
+        U32 mFirst;     // first entry if a leaf, else the second child (the first follows this node)
+        U32 mCount;     // entries in a leaf, 0 for an inner node
+    };
+
+    std::vector<Node> mNodes;
+    std::vector<LLViewerOctreeEntry*> mEntries;
+    std::vector<LLVector4a> mEntryExtents; // min, max pairs in mEntries order
+    U32 mChangeCount;
+};
+
 class LLSpatialPartition: public LLViewerOctreePartition, public LLGeometryManager
 {
 public:
@@ -418,6 +470,14 @@ public:
     /*virtual*/ S32 cull(LLCamera &camera, bool do_occlusion=false); // Cull on arbitrary frustum
     S32 cull(LLCamera &camera, std::vector<LLDrawable *>* results, bool for_select); // Cull on arbitrary frustum
 
+    // Split cull() for culling several partitions at once. prepareCull()
+    // runs on the main thread, cullGroups() may then run on any thread as
+    // long as occlusion culling is off (LLPipeline::sUseOcclusion < 2): it
+    // only collects the visible groups, the caller passes them to
+    // LLPipeline::markNotCulled() in order.
+    void prepareCull();
+    void cullGroups(LLCamera& camera, std::vector<LLSpatialGroup*>& visible);
+
     bool isVisible(const LLVector3& v);
     bool isHUDPartition() ;
 
@@ -431,7 +491,18 @@ public:
 
     bool getVisibleExtents(LLCamera& camera, LLVector3& visMin, LLVector3& visMax);
 
+private:
+    void traverseCull(LLCamera& camera, std::vector<LLSpatialGroup*>* visible);
+    bool usePickBVH();
+
+    LLDrawableBVH mPickBVH;
+
 public:
+    // bumped by every insertion, removal or move in this partition, and in
+    // sChangeCount for all of them
+    U32 mChangeCount;
+    static U32 sChangeCount;
+
     LLSpatialBridge* mBridge; // NULL for non-LLSpatialBridge instances, otherwise, mBridge == this
                             // use a pointer instead of making "isBridge" and "asBridge" virtual so it's safe
                             // to call asBridge() from the destructor
@@ -682,6 +753,10 @@ class LLVolumeGeometryManager: public LLGeometryManager
     void registerFace(LLSpatialGroup* group, LLFace* facep, U32 type);
 
 private:
+    // rewrite the faces of the drawables marked for rebuild into the ranges they already
+    // have, returns false if the group's layout changed and needs a full rebuild
+    bool rebuildGeomInPlace(LLSpatialGroup* group);
+
     void allocateFaces(U32 pMaxFaceCount);
     void freeFaces();
 
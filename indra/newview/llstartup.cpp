@@ -73,6 +73,7 @@
 #include "llregionhandle.h"
 #include "llsd.h"
 #include "llsdserialize.h"
+#include "llsdutil.h"
 #include "llsdutil_math.h"
 #include "llstring.h"
 #include "lluserrelations.h"
@@ -140,6 +141,7 @@
 #include "lltoolmgr.h"
 #include "lltrans.h"
 #include "llui.h"
+#include "lluictrlfactory.h"
 #include "lluiusage.h"
 #include "llurldispatcher.h"
 #include "llurlentry.h"
@@ -608,10 +610,11 @@ bool idle_startup()
             }
 
             // start the xfer system. by default, choke the downloads
-            // a lot...
-            const S32 VIEWER_MAX_XFER = 3;
+            // a lot, per region...
             start_xfer_manager();
-            gXferManager->setMaxIncomingXfers(VIEWER_MAX_XFER);
+            gXferManager->setMaxIncomingXfers(gSavedSettings.getS32("XferMaxIncoming"));
+            gXferManager->setMaxIncomingXfersPerHost(gSavedSettings.getS32("XferMaxIncomingPerHost"));
+            gXferManager->setMaxSendWindow(gSavedSettings.getS32("XferSendWindow"));
             F32 xfer_throttle_bps = gSavedSettings.getF32("XferThrottle");
             if (xfer_throttle_bps > 1.f)
             {
@@ -638,6 +641,11 @@ bool idle_startup()
                 msg->mPacketRing.setUseOutThrottle(true);
                 msg->mPacketRing.setOutBandwidth(outBandwidth);
             }
+
+            if (gSavedSettings.getBOOL("MessageReceiveThread"))
+            {
+                msg->mPacketRing.startReceiveThread(msg->mSocket);
+            }
         }
 
         LL_INFOS("AppInit") << "Message System Initialized." << LL_ENDL;
@@ -1269,6 +1277,19 @@ bool idle_startup()
         // We should have an agent id by this point.
         llassert(!(gAgentID == LLUUID::null));
 
+        // Reading the inventory caches doesn't need anything that follows,
+        // get it going while the world, media and fonts are set up and the
+        // seed capability and the region handshake are waited for.
+        {
+            LLSD response = LLLoginInstance::getInstance()->getResponse();
+            LLInventoryModel::preloadCache(gAgentID);
+            LLSD inv_lib_owner = response["inventory-lib-owner"];
+            if (inv_lib_owner.isDefined())
+            {
+                LLInventoryModel::preloadCache(inv_lib_owner[0]["agent_id"].asUUID());
+            }
+        }
+
         // Finish agent initialization.  (Requires gSavedSettings, builds camera)
         gAgent.init();
         display_startup();
@@ -1790,6 +1811,13 @@ bool idle_startup()
     {
         LL_PROFILE_ZONE_NAMED("State inventory load skeleton")
 
+        if (LLInventoryModel::isPreloadingCache())
+        {
+            // let the general queue finish reading the caches
+            display_startup();
+            return false;
+        }
+
         LLSD response = LLLoginInstance::getInstance()->getResponse();
 
         LLSD inv_skel_lib = response["inventory-skel-lib"];
@@ -2348,7 +2376,14 @@ bool idle_startup()
         gAgent.observeFriends();
 
         // Start automatic replay if the flag is set.
-        if (gSavedSettings.getBOOL("StatsAutoRun") || gAgentPilot.getReplaySession())
+        F32 benchmark_seconds = gSavedSettings.getF32("StatsBenchmarkSeconds");
+        if (benchmark_seconds > 0.f)
+        {
+            LL_DEBUGS("AppInit") << "Starting automatic benchmark" << LL_ENDL;
+            gAgentPilot.setQuitAfterRuns(true);
+            gAgentPilot.startBenchmark(benchmark_seconds, gSavedSettings.getF32("StatsBenchmarkWarmup"));
+        }
+        else if (gSavedSettings.getBOOL("StatsAutoRun") || gAgentPilot.getReplaySession())
         {
             LL_DEBUGS("AppInit") << "Starting automatic playback" << LL_ENDL;
             gAgentPilot.startPlayback();
@@ -2364,6 +2399,15 @@ bool idle_startup()
         // then the data is cached for the viewer's lifetime)
         LLProductInfoRequestManager::instance();
 
+        // Parse the layouts of the heaviest, most used floaters while idle,
+        // rather than the first time someone opens them
+        std::vector<std::string> layouts;
+        for (const LLSD& layout : llsd::inArray(gSavedSettings.getLLSD("XUILayoutPrewarm")))
+        {
+            layouts.push_back(layout.asString());
+        }
+        LLUICtrlFactory::instance().prewarmLayouts(layouts);
+
         // *FIX:Mani - What do I do here?
         // Need we really clear the Auth response data?
         // Clean up the userauth stuff.
@@ -29,6 +29,7 @@
 #include "llsurface.h"
 
 #include "llrender.h"
+#include "llimagegl.h"
 
 #include "llviewertexturelist.h"
 #include "llpatchvertexarray.h"
@@ -83,6 +84,7 @@ LLSurface::LLSurface(U32 type, LLViewerRegion *regionp) :
     // Surface data
     mSurfaceZ = NULL;
     mNorm = NULL;
+    mHeightMap = 0;
 
     // Patch data
     mPatchList = NULL;
@@ -114,6 +116,8 @@ LLSurface::~LLSurface()
 
     delete [] mNorm;
 
+    releaseHeightMap();
+
     mGridsPerEdge = 0;
     mGridsPerPatchEdge = 0;
     mPatchesPerEdge = 0;
@@ -1123,6 +1127,7 @@ void LLSurface::dirtyAllPatches()
     for (i = 0; i < mNumberOfPatches; i++)
     {
         mPatchList[i].dirtyZ();
+        dirtyHeightMap(&mPatchList[i]);
     }
 }
 
@@ -1132,6 +1137,93 @@ void LLSurface::dirtySurfacePatch(LLSurfacePatch *patchp)
     mDirtyPatchList.insert(patchp);
 }
 
+void LLSurface::getHeightMapTexels(S32 x, S32 y, S32 width, S32 height, std::vector<LLVector4>& texels) const
+{
+    // Same composition and noise as LLSurfacePatch::eval
+    const F32 xyScale = 4.9215f*7.f;
+    const F32 xyScaleInv = (1.f / xyScale)*(0.2222222222f);
+
+    texels.resize(width * height);
+    for (S32 j = 0; j < height; j++)
+    {
+        for (S32 i = 0; i < width; i++)
+        {
+            S32 gx = x + i;
+            S32 gy = y + j;
+            F32 vec[3] = {
+                            (F32)fmod((F32)(mOriginGlobal.mdV[VX] + gx * mMetersPerGrid)*xyScaleInv, 256.f),
+                            (F32)fmod((F32)(mOriginGlobal.mdV[VY] + gy * mMetersPerGrid)*xyScaleInv, 256.f),
+                            0.f
+                        };
+
+            LLVector4& texel = texels[i + j * width];
+            texel.mV[0] = mSurfaceZ[gx + gy * mGridsPerEdge];
+            texel.mV[1] = mRegionp->getCompositionXY(llfloor(gx * mMetersPerGrid), llfloor(gy * mMetersPerGrid));
+            texel.mV[2] = llclamp(noise2(vec)* 0.75f + 0.5f, 0.f, 1.f);
+            texel.mV[3] = 1.f;
+        }
+    }
+}
+
+U32 LLSurface::updateHeightMap()
+{
+    LL_PROFILE_ZONE_SCOPED;
+
+    if (!mSurfaceZ || !mRegionp)
+    {
+        return 0;
+    }
+
+    std::vector<LLVector4> texels;
+    LLTexUnit* unit = gGL.getTexUnit(0);
+
+    if (!mHeightMap)
+    {
+        getHeightMapTexels(0, 0, mGridsPerEdge, mGridsPerEdge, texels);
+
+        LLImageGL::generateTextures(1, &mHeightMap);
+        unit->bindManual(LLTexUnit::TT_TEXTURE, mHeightMap);
+        LLImageGL::setManualImage(LLTexUnit::getInternalType(LLTexUnit::TT_TEXTURE), 0, GL_RGBA32F, mGridsPerEdge, mGridsPerEdge, GL_RGBA, GL_FLOAT, texels[0].mV, false);
+        unit->setTextureFilteringOption(LLTexUnit::TFO_BILINEAR);
+        unit->setTextureAddressMode(LLTexUnit::TAM_CLAMP);
+        unit->unbind(LLTexUnit::TT_TEXTURE);
+
+        mHeightMapDirtyPatches.clear();
+        return mHeightMap;
+    }
+
+    if (!mHeightMapDirtyPatches.empty())
+    {
+        unit->bindManual(LLTexUnit::TT_TEXTURE, mHeightMap);
+        for (LLSurfacePatch* patchp : mHeightMapDirtyPatches)
+        {
+            // a patch shares its north and east edges with its neighbors
+            S32 index = (S32)(patchp - mPatchList);
+            S32 x = (index % mPatchesPerEdge) * mGridsPerPatchEdge;
+            S32 y = (index / mPatchesPerEdge) * mGridsPerPatchEdge;
+            S32 width = llmin((S32)mGridsPerPatchEdge + 1, mGridsPerEdge - x);
+            S32 height = llmin((S32)mGridsPerPatchEdge + 1, mGridsPerEdge - y);
+
+            getHeightMapTexels(x, y, width, height, texels);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_FLOAT, texels[0].mV);
+        }
+        unit->unbind(LLTexUnit::TT_TEXTURE);
+        mHeightMapDirtyPatches.clear();
+    }
+
+    return mHeightMap;
+}
+
+void LLSurface::releaseHeightMap()
+{
+    if (mHeightMap)
+    {
+        LLImageGL::deleteTextures(1, &mHeightMap);
+        mHeightMap = 0;
+    }
+    mHeightMapDirtyPatches.clear();
+}
+
 
 void LLSurface::setWaterHeight(F32 height)
 {
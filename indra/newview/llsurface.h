@@ -134,6 +134,13 @@ public:
     void dirtyAllPatches(); // Use this to dirty all patches when changing terrain parameters
 
     void dirtySurfacePatch(LLSurfacePatch *patchp);
+
+    // Height, composition and detail noise of every grid point as a float
+    // texture, for drawing the terrain with LLTerrainGPU. Uploads whatever
+    // changed since the last call and returns the texture name.
+    U32 updateHeightMap();
+    void dirtyHeightMap(LLSurfacePatch *patchp)     { mHeightMapDirtyPatches.insert(patchp); }
+    void releaseHeightMap();
     LLVOWater *getWaterObj()                        { return mWaterObjp; }
 
     static void setTextureSize(const S32 texture_size);
@@ -176,6 +183,8 @@ protected:
     void createPatchData();     // Allocates memory for patches.
     void destroyPatchData();    // Deallocates memory for patches.
 
+    void getHeightMapTexels(S32 x, S32 y, S32 width, S32 height, std::vector<LLVector4>& texels) const;
+
 protected:
     LLVector3d  mOriginGlobal;      // In absolute frame
     LLSurfacePatch *mPatchList;     // Array of all patches
@@ -188,6 +197,10 @@ protected:
 
     std::set<LLSurfacePatch *> mDirtyPatchList;
 
+    // Patches changed since the height map was last uploaded
+    std::set<LLSurfacePatch *> mHeightMapDirtyPatches;
+    U32 mHeightMap;
+
 
     // The textures should never be directly initialized - use the setter methods!
     LLPointer<LLViewerTexture> mSTexturep;      // Texture for surface
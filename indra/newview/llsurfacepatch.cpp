@@ -31,6 +31,7 @@
 #include "llviewerobjectlist.h"
 #include "llvosurfacepatch.h"
 #include "llsurface.h"
+#include "llterraingpu.h"
 #include "pipeline.h"
 #include "llagent.h"
 #include "llsky.h"
@@ -104,6 +105,7 @@ void LLSurfacePatch::dirty()
 
     mDirtyZStats = true;
     mHeightsGenerated = false;
+    mSurfacep->dirtyHeightMap(this);
 
     if (!mDirty)
     {
@@ -1040,6 +1042,12 @@ void LLSurfacePatch::updateVisibility()
         max_render_stride = lltrunc(mVisInfo.mDistance * stride_per_distance);
         max_render_stride = llmin(max_render_stride , 2*grids_per_patch_edge);
 
+        if (LLTerrainGPU::isEnabled())
+        {
+            // LLTerrainGPU picks the detail itself, the mesh only stands in for the patch
+            max_render_stride = grids_per_patch_edge;
+        }
+
         // We only use render_strides that are powers of two, so we use look-up tables to figure out
         // the render_level and corresponding render_stride
         new_render_level = mVisInfo.mRenderLevel = mSurfacep->getRenderLevel(max_render_stride);
@@ -98,6 +98,7 @@ public:
     F32 getMinComposition() const;
     F32 getMaxComposition() const;
     const LLVector3 &getCenterRegion() const;
+    const LLVector3 &getOriginRegion() const { return mOriginRegion; }
     const U64 &getLastUpdateTime() const;
     LLSurface *getSurface() const { return mSurfacep; }
     LLVector3 getPointAgent(const U32 x, const U32 y) const; // get the point at the offset.
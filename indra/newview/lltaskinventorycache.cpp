@@ -0,0 +1,121 @@
+/**
+ * @file lltaskinventorycache.cpp
+ * @brief Object inventories as last received, by object and serial.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "lltaskinventorycache.h"
+
+#include "llfilesystem.h"
+
+namespace
+{
+    // bump when the entry format changes
+    const S32 TASK_INVENTORY_CACHE_VERSION = 1;
+
+    // most objects hold a handful of items, this is a few thousand of them
+    const U64 MAX_MEMORY_BYTES = 16 * 1024 * 1024;
+}
+
+LLTaskInventoryCache::LLTaskInventoryCache() :
+    mBytes(0)
+{
+}
+
+bool LLTaskInventoryCache::get(const LLUUID& task_id, Entry& entry)
+{
+    auto found = mEntries.find(task_id);
+    if (found != mEntries.end())
+    {
+        mLRU.splice(mLRU.begin(), mLRU, found->second);
+        entry = found->second->second;
+        return true;
+    }
+
+    if (!read(task_id, entry))
+    {
+        return false;
+    }
+    put(task_id, entry);
+    return true;
+}
+
+void LLTaskInventoryCache::put(const LLUUID& task_id, const Entry& entry)
+{
+    auto found = mEntries.find(task_id);
+    if (found != mEntries.end())
+    {
+        mBytes -= found->second->second.mData.size();
+        mLRU.erase(found->second);
+        mEntries.erase(found);
+    }
+
+    mLRU.emplace_front(task_id, entry);
+    mEntries[task_id] = mLRU.begin();
+    mBytes += entry.mData.size();
+
+    while (mBytes > MAX_MEMORY_BYTES && mLRU.size() > 1)
+    {
+        mBytes -= mLRU.back().second.mData.size();
+        mEntries.erase(mLRU.back().first);
+        mLRU.pop_back();
+    }
+}
+
+// static
+LLUUID LLTaskInventoryCache::getDiskID(const LLUUID& task_id)
+{
+    LLUUID id;
+    id.generate(llformat("%s:task_inventory:%d", task_id.asString().c_str(), TASK_INVENTORY_CACHE_VERSION));
+    return id;
+}
+
+// static
+bool LLTaskInventoryCache::read(const LLUUID& task_id, Entry& entry)
+{
+    LLFileSystem file(getDiskID(task_id), LLAssetType::AT_UNKNOWN);
+    S32 size = file.getSize();
+    S32 serial = 0;
+    if (size <= (S32)sizeof(serial) || !file.read((U8*)&serial, sizeof(serial)))
+    {
+        return false;
+    }
+
+    entry.mSerial = (S16)serial;
+    entry.mData.resize(size - sizeof(serial));
+    return file.read((U8*)&entry.mData[0], (S32)entry.mData.size());
+}
+
+// static
+void LLTaskInventoryCache::write(const LLUUID& task_id, const Entry& entry)
+{
+    // in one write, small files are kept whole
+    S32 serial = entry.mSerial;
+    std::string buffer((const char*)&serial, sizeof(serial));
+    buffer += entry.mData;
+
+    LLFileSystem file(getDiskID(task_id), LLAssetType::AT_UNKNOWN, LLFileSystem::WRITE);
+    file.write((const U8*)buffer.data(), (S32)buffer.size());
+}
@@ -0,0 +1,81 @@
+/**
+ * @file lltaskinventorycache.h
+ * @brief Object inventories as last received, by object and serial.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLTASKINVENTORYCACHE_H
+#define LL_LLTASKINVENTORYCACHE_H
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "llsingleton.h"
+#include "lluuid.h"
+
+// Keeps the last inventory received for an object, so that opening its
+// contents again, or a script or a floater asking for them, needn't
+// download and parse them again while the serial is unchanged. Entries are
+// kept in memory up to a budget and on disk, in the asset cache.
+//
+// An entry is the inventory as an LLSD map, serialized as binary, with
+// either ["contents"] as the RequestTaskInventory capability sends them,
+// or ["legacy"], the text of the file xfer sends. The worker that parses
+// it decodes it, the main thread only moves bytes around.
+//
+// Only inventories as received from the simulator go in; local changes
+// bump the expected serial, so they never match a cached entry.
+
+class LLTaskInventoryCache : public LLSingleton<LLTaskInventoryCache>
+{
+    LLSINGLETON(LLTaskInventoryCache);
+
+public:
+    struct Entry
+    {
+        S16 mSerial = 0;
+        std::string mData;
+    };
+
+    // main thread, looks in memory then on disk
+    bool get(const LLUUID& task_id, Entry& entry);
+    // main thread, memory only, see write()
+    void put(const LLUUID& task_id, const Entry& entry);
+
+    // any thread
+    static bool read(const LLUUID& task_id, Entry& entry);
+    static void write(const LLUUID& task_id, const Entry& entry);
+
+    U64 getBytesCached() const { return mBytes; }
+
+private:
+    static LLUUID getDiskID(const LLUUID& task_id);
+
+    typedef std::list<std::pair<LLUUID, Entry> > lru_t;
+    lru_t mLRU; // most recently used first
+    std::unordered_map<LLUUID, lru_t::iterator> mEntries;
+    U64 mBytes;
+};
+
+#endif // LL_LLTASKINVENTORYCACHE_H
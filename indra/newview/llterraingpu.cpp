@@ -0,0 +1,215 @@
+/**
+ * @file llterraingpu.cpp
+ * @brief Draws terrain patches from height maps with continuous distance based LOD.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llterraingpu.h"
+
+#include "llglslshader.h"
+#include "llrender.h"
+#include "llshadermgr.h"
+#include "llsurface.h"
+#include "llsurfacepatch.h"
+#include "llviewercamera.h"
+#include "llviewercontrol.h"
+#include "llviewerregion.h"
+#include "llviewershadermgr.h"
+#include "llvosurfacepatch.h"
+#include "llworld.h"
+#include "pipeline.h"
+
+static LLStaticHashedString sTerrainNode("terrain_node");
+static LLStaticHashedString sTerrainMorph("terrain_morph");
+static LLStaticHashedString sTerrainGrid("terrain_grid");
+static LLStaticHashedString sTerrainCamera("terrain_camera");
+
+LLTerrainGPU::LLTerrainGPU()
+{
+}
+
+LLTerrainGPU::~LLTerrainGPU()
+{
+}
+
+// static
+bool LLTerrainGPU::isEnabled()
+{
+    // the parcel owner overlay is drawn over the patch meshes
+    static LLCachedControl<bool> show_parcel_owners(gSavedSettings, "ShowParcelOwners");
+    return LLPipeline::RenderTerrainGPU && !show_parcel_owners && gDeferredTerrainGPUShadowProgram.isComplete();
+}
+
+void LLTerrainGPU::createGrids(U32 quads)
+{
+    llassert(quads > 0 && (quads & (quads - 1)) == 0); // the morph needs every level to halve the one before
+
+    mGrids.clear();
+    mQuads = quads;
+
+    for (U32 n = quads; n > 0; n >>= 1)
+    {
+        const U32 verts_per_edge = n + 1;
+        LLPointer<LLVertexBuffer> grid = new LLVertexBuffer(LLVertexBuffer::MAP_VERTEX);
+        if (!grid->allocateBuffer(verts_per_edge * verts_per_edge, n * n * 6))
+        {
+            LL_WARNS("Terrain") << "Failed to allocate terrain grid with " << n << " quads per edge" << LL_ENDL;
+            mGrids.clear();
+            mQuads = 0;
+            return;
+        }
+
+        LLStrider<LLVector3> verts;
+        LLStrider<U16> indices;
+        grid->getVertexStrider(verts);
+        grid->getIndexStrider(indices);
+
+        // positions are in units of the patch width, the shader scales and displaces them
+        for (U32 y = 0; y < verts_per_edge; ++y)
+        {
+            for (U32 x = 0; x < verts_per_edge; ++x)
+            {
+                (verts++)->set((F32)x / n, (F32)y / n, 0.f);
+            }
+        }
+
+        for (U32 y = 0; y < n; ++y)
+        {
+            for (U32 x = 0; x < n; ++x)
+            {
+                U16 v00 = (U16)(x + y * verts_per_edge);
+                U16 v10 = (U16)(v00 + 1);
+                U16 v01 = (U16)(v00 + verts_per_edge);
+                U16 v11 = (U16)(v01 + 1);
+
+                *(indices++) = v00;
+                *(indices++) = v10;
+                *(indices++) = v11;
+
+                *(indices++) = v00;
+                *(indices++) = v11;
+                *(indices++) = v01;
+            }
+        }
+
+        grid->unmapBuffer();
+        mGrids.push_back(grid);
+    }
+}
+
+void LLTerrainGPU::bindSurface(LLGLSLShader& shader, LLSurface* surfacep)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL;
+
+    U32 quads = surfacep->getGridsPerPatchEdge();
+    if (quads != mQuads)
+    {
+        createGrids(quads);
+    }
+
+    U32 height_map = surfacep->updateHeightMap();
+    S32 channel = shader.enableTexture(LLShaderMgr::TERRAIN_HEIGHT_MAP);
+    if (channel > -1)
+    {
+        gGL.getTexUnit(channel)->bindManual(LLTexUnit::TT_TEXTURE, height_map);
+    }
+
+    const F32 meters_per_grid = surfacep->getMetersPerGrid();
+    mPatchWidth = quads * meters_per_grid;
+
+    // Level 0 has to reach past the diagonal of a patch for neighbors to stay
+    // within one level of each other
+    mBaseRange = llmax(32.f * LLVOSurfacePatch::sLODFactor, 3.f * mPatchWidth);
+
+    // The height counts the same in every region, so the ranges line up at region edges
+    LLVector3 camera = LLViewerCamera::getInstance()->getOrigin();
+    F32 height = llmax(camera.mV[VZ] - LLWorld::getInstance()->resolveLandHeightAgent(camera), 0.f);
+    camera -= surfacep->getOriginAgent();
+    mCamera.set(camera.mV[VX], camera.mV[VY]);
+    mCameraHeight2 = height * height;
+
+    shader.uniform2f(sTerrainGrid, meters_per_grid, 1.f / surfacep->getGridsPerEdge());
+    shader.uniform3f(sTerrainCamera, mCamera.mV[VX], mCamera.mV[VY], mCameraHeight2);
+}
+
+void LLTerrainGPU::unbind(LLGLSLShader& shader)
+{
+    shader.disableTexture(LLShaderMgr::TERRAIN_HEIGHT_MAP);
+}
+
+void LLTerrainGPU::drawPatch(LLGLSLShader& shader, const LLSurfacePatch* patchp)
+{
+    if (mGrids.empty())
+    {
+        return;
+    }
+
+    const LLVector3& origin = patchp->getOriginRegion();
+    F32 dx = llmax(origin.mV[VX] - mCamera.mV[VX], mCamera.mV[VX] - (origin.mV[VX] + mPatchWidth), 0.f);
+    F32 dy = llmax(origin.mV[VY] - mCamera.mV[VY], mCamera.mV[VY] - (origin.mV[VY] + mPatchWidth), 0.f);
+    F32 distance = sqrtf(dx * dx + dy * dy + mCameraHeight2);
+
+    // the nearest point of the patch picks the level, so no part of it is drawn coarser than its range allows
+    const U32 last = (U32)mGrids.size() - 1;
+    U32 level = 0;
+    F32 range = mBaseRange;
+    while (level < last && distance >= range)
+    {
+        ++level;
+        range *= 2.f;
+    }
+
+    // the last level has nothing coarser to morph to
+    F32 morph_start = 0.f;
+    F32 morph_scale = 0.f;
+    if (level < last)
+    {
+        F32 band = level == 0 ? range : range * 0.5f;
+        morph_start = range - band * MORPH_FRACTION;
+        morph_scale = 1.f / (range - morph_start);
+    }
+
+    F32 node[4] = { origin.mV[VX], origin.mV[VY], mPatchWidth, (F32)(mQuads >> level) };
+    shader.uniform4fv(sTerrainNode, 1, node);
+    shader.uniform2f(sTerrainMorph, morph_start, morph_scale);
+
+    LLVertexBuffer* grid = mGrids[level];
+    grid->setBuffer();
+    grid->drawRange(LLRender::TRIANGLES, 0, grid->getNumVerts() - 1, grid->getNumIndices(), 0);
+}
+
+void LLTerrainGPU::release()
+{
+    mGrids.clear();
+    mQuads = 0;
+
+    if (LLWorld::instanceExists())
+    {
+        for (LLViewerRegion* regionp : LLWorld::getInstance()->getRegionList())
+        {
+            regionp->getLand().releaseHeightMap();
+        }
+    }
+}
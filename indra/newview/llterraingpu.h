@@ -0,0 +1,89 @@
+/**
+ * @file llterraingpu.h
+ * @brief Draws terrain patches from height maps with continuous distance based LOD.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLTERRAINGPU_H
+#define LL_LLTERRAINGPU_H
+
+#include <vector>
+
+#include "llpointer.h"
+#include "llvertexbuffer.h"
+#include "v2math.h"
+
+class LLGLSLShader;
+class LLSurface;
+class LLSurfacePatch;
+
+// Draws terrain patches from their region's height map (see LLSurface::updateHeightMap)
+// instead of the meshes LLVOSurfacePatch builds on the CPU.
+//
+// Every patch is drawn with one of a few shared flat grids, each level having
+// half the quads per edge of the one before, picked by the distance from the
+// camera to the patch. The vertex shader (deferred/terrainGPUUtilV.glsl)
+// displaces the grid by the height map and, over the last part of a level's
+// range, slides its vertices onto the next coarser grid (CDLOD). Levels of
+// neighboring patches differ by at most one and the morph is a function of
+// the vertex position only, so shared edges always match and nothing pops.
+//
+// The patch meshes are still built, at their coarsest, because the draw pool
+// and culling work off their faces.
+class LLTerrainGPU
+{
+public:
+    // fraction of a level's distance band spent morphing toward the next level
+    static constexpr F32 MORPH_FRACTION = 0.3f;
+
+    LLTerrainGPU();
+    ~LLTerrainGPU();
+
+    // true if the terrain should be drawn by this rather than from the patch meshes
+    static bool isEnabled();
+
+    // upload the changed parts of the height map of 'surfacep' and bind it to 'shader', which must be bound
+    // call before binding other textures, the upload uses texture unit 0
+    void bindSurface(LLGLSLShader& shader, LLSurface* surfacep);
+    void unbind(LLGLSLShader& shader);
+
+    // draw 'patchp' at the level its distance calls for, its surface must be bound
+    void drawPatch(LLGLSLShader& shader, const LLSurfacePatch* patchp);
+
+    void release();
+
+private:
+    void createGrids(U32 quads);
+
+    // mGrids[k] has mQuads >> k quads per edge
+    std::vector<LLPointer<LLVertexBuffer>> mGrids;
+    U32 mQuads = 0;
+
+    // of the bound surface
+    LLVector2 mCamera;              // camera position in region space
+    F32 mCameraHeight2 = 0.f;       // squared height of the camera above the terrain
+    F32 mPatchWidth = 0.f;          // meters
+    F32 mBaseRange = 0.f;           // end of level 0's range, each level ends at twice the distance of the one before
+};
+
+#endif // LL_LLTERRAINGPU_H
@@ -0,0 +1,305 @@
+/**
+ * @file lltexturebudget.cpp
+ * @brief Per-category video memory budgets for viewer textures.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "lltexturebudget.h"
+
+#include "llappviewer.h"
+#include "llimagegl.h"
+#include "lltexturecache.h"
+#include "llviewercamera.h"
+#include "llviewercontrol.h"
+#include "llviewertexture.h"
+#include "llviewertexturelist.h"
+
+LLTextureBudget gTextureBudget;
+
+// Textures that are not on screen still have to be fetched again once they
+// are, so give them a small coverage instead of letting them all tie at 0.
+constexpr F32 MIN_COVERAGE = 1.e-4f;
+
+// Decoding is cheap next to waiting for a texture the local cache does not
+// have (any more).
+constexpr F32 NOT_CACHED_COST_FACTOR = 4.f;
+
+LLTextureBudget::LLTextureBudget()
+:   mNumEvicted(0),
+    mCanEvict(true)
+{
+    for (S32 i = 0; i < CATEGORY_COUNT; ++i)
+    {
+        mUsedBytes[i] = 0;
+        mPendingBytes[i] = 0;
+        mBudgetBytes[i] = 0;
+    }
+}
+
+//static
+LLTextureBudget::ECategory LLTextureBudget::getCategory(LLViewerFetchedTexture* imagep)
+{
+    switch (imagep->getBoostLevel())
+    {
+    case LLGLTexture::BOOST_AVATAR:
+    case LLGLTexture::BOOST_AVATAR_BAKED:
+    case LLGLTexture::BOOST_AVATAR_BAKED_SELF:
+    case LLGLTexture::BOOST_AVATAR_SELF:
+        return CATEGORY_AVATAR;
+    case LLGLTexture::BOOST_TERRAIN:
+        return CATEGORY_TERRAIN;
+    case LLGLTexture::BOOST_HUD:
+    case LLGLTexture::BOOST_ICON:
+    case LLGLTexture::BOOST_THUMBNAIL:
+    case LLGLTexture::BOOST_UI:
+    case LLGLTexture::BOOST_PREVIEW:
+    case LLGLTexture::BOOST_MAP:
+    case LLGLTexture::BOOST_MAP_VISIBLE:
+        return CATEGORY_UI;
+    default:
+        return CATEGORY_WORLD;
+    }
+}
+
+//static
+const char* LLTextureBudget::getCategoryName(ECategory category)
+{
+    static const char* names[CATEGORY_COUNT] = { "World", "Avatar", "Terrain", "UI", "Media" };
+    return names[category];
+}
+
+//static
+bool LLTextureBudget::canEvict(LLViewerFetchedTexture* imagep)
+{
+    // Only LOD textures below BOOST_AVATAR_BAKED get scaled down by
+    // LLViewerLODTexture::processTextureStats()
+    if (imagep->getType() != LLViewerTexture::LOD_TEXTURE
+        || imagep->getBoostLevel() >= LLGLTexture::BOOST_AVATAR_BAKED
+        || imagep->getDontDiscard()
+        || imagep->mForceToSaveRawImage
+        || !imagep->hasGLTexture())
+    {
+        return false;
+    }
+
+    LLImageGL* gl_image = imagep->getGLTexture();
+    S32 discard = imagep->getDiscardLevel();
+    return gl_image->getUseMipMaps() && discard >= 0 && discard < gl_image->getMaxDiscardLevel();
+}
+
+//static
+F32 LLTextureBudget::getRefetchCost(LLViewerFetchedTexture* imagep)
+{
+    LLImageGL* gl_image = imagep->getGLTexture();
+    S32 discard = imagep->getDiscardLevel();
+
+    F32 screen_area = (F32)llmax(LLViewerCamera::getInstance()->getScreenPixelArea(), 1);
+    F32 coverage = llclamp(imagep->getMaxVirtualSize() / screen_area, MIN_COVERAGE, 1.f);
+
+    // Decoding time is roughly proportional to the texel count
+    F32 decode_cost = (F32)gl_image->getWidth(discard) * (F32)gl_image->getHeight(discard);
+    if (!LLAppViewer::getTextureCache()->isInCache(imagep->getID()))
+    {
+        decode_cost *= NOT_CACHED_COST_FACTOR;
+    }
+
+    F32 bytes = (F32)llmax(gl_image->getBytes(discard), (S64)1);
+    return coverage * decode_cost / bytes;
+}
+
+bool LLTextureBudget::update(S64 texture_bytes, F32 interval)
+{
+    if (mUpdateTimer.getElapsedTimeF32() < interval)
+    {
+        return mCanEvict;
+    }
+    mUpdateTimer.reset();
+
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+
+    static LLCachedControl<F32> world_share(gSavedSettings, "RenderTextureBudgetWorld", 0.55f);
+    static LLCachedControl<F32> avatar_share(gSavedSettings, "RenderTextureBudgetAvatar", 0.2f);
+    static LLCachedControl<F32> terrain_share(gSavedSettings, "RenderTextureBudgetTerrain", 0.1f);
+    static LLCachedControl<F32> ui_share(gSavedSettings, "RenderTextureBudgetUI", 0.1f);
+    static LLCachedControl<F32> media_share(gSavedSettings, "RenderTextureBudgetMedia", 0.05f);
+    static LLCachedControl<F32> budget_headroom(gSavedSettings, "RenderTextureBudgetHeadroom", 0.1f);
+
+    F32 shares[CATEGORY_COUNT] = { world_share(), avatar_share(), terrain_share(), ui_share(), media_share() };
+    F32 total_share = 0.f;
+    for (S32 i = 0; i < CATEGORY_COUNT; ++i)
+    {
+        shares[i] = llmax(shares[i], 0.f);
+        total_share += shares[i];
+    }
+    for (S32 i = 0; i < CATEGORY_COUNT; ++i)
+    {
+        F32 share = total_share > 0.f ? shares[i] / total_share : 1.f / CATEGORY_COUNT;
+        mBudgetBytes[i] = (S64)((F64)texture_bytes * share);
+        mUsedBytes[i] = 0;
+        mPendingBytes[i] = 0;
+    }
+    mNumEvicted = 0;
+
+    // Tally what every category uses, and what it is about to use once
+    // the fetches in flight reach their desired discard level.
+    for (auto& imagep : gTextureList)
+    {
+        if (!imagep->hasGLTexture())
+        {
+            // Nothing left to hold down, it will be fetched normally
+            imagep->mBudgetDiscardLevel = 0;
+            continue;
+        }
+
+        if (imagep->mBudgetDiscardLevel > 0)
+        {
+            ++mNumEvicted;
+        }
+
+        ECategory category = getCategory(imagep);
+        LLImageGL* gl_image = imagep->getGLTexture();
+        S32 current = imagep->getDiscardLevel();
+        mUsedBytes[category] += gl_image->getBytes(current);
+
+        S32 desired = llmax(imagep->getDesiredDiscardLevel(), (S32)imagep->mBudgetDiscardLevel);
+        if (current >= 0 && desired >= 0 && desired < current)
+        {
+            mPendingBytes[category] += gl_image->getBytes(desired) - gl_image->getBytes(current);
+        }
+    }
+    mUsedBytes[CATEGORY_MEDIA] = LLViewerMediaTexture::getTotalTextureBytes();
+
+    F32 headroom = llclamp(budget_headroom(), 0.f, 0.5f);
+    S64 predicted_total = 0;
+    for (S32 i = 0; i < CATEGORY_COUNT; ++i)
+    {
+        predicted_total += mUsedBytes[i] + mPendingBytes[i];
+    }
+
+    // Start evicting when the prediction gets within the headroom of the
+    // total, but only from the categories over their own share. Release
+    // once there is twice the headroom left, so the two do not fight.
+    bool under_pressure = predicted_total > (S64)((F64)texture_bytes * (1.f - headroom));
+    S64 global_room = (S64)((F64)texture_bytes * (1.f - 2.f * headroom)) - predicted_total;
+
+    S64 needed[CATEGORY_COUNT];
+    S64 room[CATEGORY_COUNT];
+    bool any_needed = false;
+    bool any_room = false;
+    for (S32 i = 0; i < CATEGORY_COUNT; ++i)
+    {
+        S64 predicted = mUsedBytes[i] + mPendingBytes[i];
+        S64 category_room = (S64)((F64)mBudgetBytes[i] * (1.f - 2.f * headroom)) - predicted;
+        if (under_pressure)
+        {
+            needed[i] = llmax(predicted - (S64)((F64)mBudgetBytes[i] * (1.f - headroom)), (S64)0);
+            room[i] = category_room;
+        }
+        else
+        {
+            needed[i] = 0;
+            room[i] = llmax(category_room, global_room);
+        }
+        any_needed |= needed[i] > 0;
+        any_room |= needed[i] == 0 && room[i] > 0;
+    }
+
+    typedef std::pair<F32, LLViewerFetchedTexture*> candidate_t;
+    std::vector<candidate_t> evict[CATEGORY_COUNT];
+    std::vector<candidate_t> release[CATEGORY_COUNT];
+
+    if (any_needed || any_room)
+    {
+        for (auto& imagep : gTextureList)
+        {
+            if (!imagep->hasGLTexture())
+            {
+                continue;
+            }
+
+            ECategory category = getCategory(imagep);
+            if (needed[category] > 0)
+            {
+                if (canEvict(imagep))
+                {
+                    evict[category].emplace_back(getRefetchCost(imagep), imagep.get());
+                }
+            }
+            else if (room[category] > 0 && imagep->mBudgetDiscardLevel > 0)
+            {
+                release[category].emplace_back(getRefetchCost(imagep), imagep.get());
+            }
+        }
+    }
+
+    mCanEvict = true;
+    for (S32 i = 0; i < CATEGORY_COUNT; ++i)
+    {
+        // Cheapest to bring back first
+        std::sort(evict[i].begin(), evict[i].end(),
+                  [](const candidate_t& lhs, const candidate_t& rhs) { return lhs.first < rhs.first; });
+
+        S64 freed = 0;
+        for (const candidate_t& candidate : evict[i])
+        {
+            if (freed >= needed[i])
+            {
+                break;
+            }
+            LLViewerFetchedTexture* imagep = candidate.second;
+            LLImageGL* gl_image = imagep->getGLTexture();
+            S32 current = imagep->getDiscardLevel();
+            freed += gl_image->getBytes(current) - gl_image->getBytes(current + 1);
+            imagep->mBudgetDiscardLevel = (S8)(current + 1);
+            gTextureList.markPriorityDirty(imagep);
+        }
+        if (freed < needed[i])
+        {
+            LL_DEBUGS("TextureBudget") << getCategoryName((ECategory)i) << " textures are "
+                                       << (needed[i] - freed) / 1024 << " KB over budget with nothing left to evict" << LL_ENDL;
+            mCanEvict = false;
+        }
+
+        // Most expensive to have evicted first
+        std::sort(release[i].begin(), release[i].end(),
+                  [](const candidate_t& lhs, const candidate_t& rhs) { return lhs.first > rhs.first; });
+
+        for (const candidate_t& candidate : release[i])
+        {
+            LLViewerFetchedTexture* imagep = candidate.second;
+            LLImageGL* gl_image = imagep->getGLTexture();
+            S32 sharper = imagep->mBudgetDiscardLevel - 1;
+            S64 growth = gl_image->getBytes(sharper) - gl_image->getBytes(imagep->getDiscardLevel());
+            if (growth <= room[i])
+            {
+                room[i] -= growth;
+                imagep->mBudgetDiscardLevel = (S8)sharper;
+                gTextureList.markPriorityDirty(imagep);
+            }
+        }
+    }
+
+    return mCanEvict;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file lltexturebudget.h
+ * @brief Per-category video memory budgets for viewer textures.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLTEXTUREBUDGET_H
+#define LL_LLTEXTUREBUDGET_H
+
+#include "llframetimer.h"
+
+class LLViewerFetchedTexture;
+
+// Splits the video memory available to textures into one budget per
+// category and, when a category is (or is about to be) over its share,
+// evicts the textures of that category that are cheapest to bring back,
+// one discard level at a time. Evicted textures are scaled down in place
+// and held there until the category has room again; raising them back
+// reads the sharper level from the local texture cache.
+//
+// This replaces the global discard bias ramp for video memory pressure.
+// The bias is still used when system memory is low, when the viewer is in
+// the background, or when the budgets cannot find enough to evict.
+
+class LLTextureBudget
+{
+public:
+    enum ECategory
+    {
+        CATEGORY_WORLD = 0,
+        CATEGORY_AVATAR,
+        CATEGORY_TERRAIN,
+        CATEGORY_UI,
+        CATEGORY_MEDIA,
+        CATEGORY_COUNT
+    };
+
+    LLTextureBudget();
+
+    // Re-evaluates the budgets at most once per 'interval' seconds.
+    // 'texture_bytes' is the video memory textures may use in total.
+    // Returns false if the categories that are over budget have nothing
+    // left to evict, in which case the caller should fall back to the
+    // discard bias.
+    bool update(S64 texture_bytes, F32 interval);
+
+    static ECategory getCategory(LLViewerFetchedTexture* imagep);
+    static const char* getCategoryName(ECategory category);
+
+    S64 getUsedBytes(ECategory category) const      { return mUsedBytes[category]; }
+    S64 getBudgetBytes(ECategory category) const    { return mBudgetBytes[category]; }
+    U32 getNumEvicted() const                       { return mNumEvicted; }
+
+private:
+    // Cost of bringing 'imagep' back to its current discard level per byte
+    // the eviction frees: screen coverage x decode cost / bytes.
+    static F32 getRefetchCost(LLViewerFetchedTexture* imagep);
+    static bool canEvict(LLViewerFetchedTexture* imagep);
+
+private:
+    S64  mUsedBytes[CATEGORY_COUNT];
+    S64  mPendingBytes[CATEGORY_COUNT];  // growth of the fetches in flight
+    S64  mBudgetBytes[CATEGORY_COUNT];
+    U32  mNumEvicted;
+    bool mCanEvict;
+    LLFrameTimer mUpdateTimer;
+};
+
+extern LLTextureBudget gTextureBudget;
+
+#endif // LL_LLTEXTUREBUDGET_H
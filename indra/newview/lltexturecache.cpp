@@ -32,6 +32,7 @@
 #include "lldir.h"
 #include "llimage.h"
 #include "llimagej2c.h" // for version control
+#include "llimagerawpool.h"
 #include "lllfsthread.h"
 #include "llviewercontrol.h"
 
@@ -65,17 +66,27 @@ private:
     class ReadResponder : public LLLFSThread::Responder
     {
     public:
-        ReadResponder(LLTextureCache* cache, handle_t handle) : mCache(cache), mHandle(handle) {}
-        ~ReadResponder() {}
+        // owns 'data', the buffer being read into, until the reader gets it back
+        ReadResponder(LLTextureCache* cache, handle_t handle, U8* data) : mCache(cache), mHandle(handle), mData(data) {}
+        ~ReadResponder()
+        {
+            // the reader went away while the read was in flight
+            ll_aligned_free_16(mData);
+        }
         void completed(S32 bytes)
         {
             mCache->lockWorkers();
             LLTextureCacheWorker* reader = mCache->getReader(mHandle);
-            if (reader) reader->ioComplete(bytes);
+            if (reader)
+            {
+                reader->ioComplete(bytes, mData);
+                mData = NULL;
+            }
             mCache->unlockWorkers();
         }
         LLTextureCache* mCache;
         LLTextureCacheWorker::handle_t mHandle;
+        U8* mData;
     };
 
     class WriteResponder : public LLLFSThread::Responder
@@ -134,6 +145,11 @@ public:
     {
         mBytesRead = bytes;
     }
+    void ioComplete(S32 bytes, U8* data)
+    {
+        mReadData = data;
+        mBytesRead = bytes;
+    }
 
 private:
     virtual void startWork(S32 param); // called from addWork() (MAIN THREAD)
@@ -260,7 +276,8 @@ private:
         LOCAL = 1,
         CACHE = 2,
         HEADER = 3,
-        BODY = 4
+        BODY = 4,
+        BODY_READING = 5    // waiting for LLLFSThread
     };
 
     e_state mState;
@@ -482,8 +499,20 @@ bool LLTextureCacheRemoteWorker::doRead()
                     // No data from header cache to copy in that case, we skipped it all
                 }
 
-                // Now use that buffer as the object read buffer
                 llassert_always(mReadData == NULL);
+                if (LLLFSThread::sLocal->hasAsyncIO() && mCache->getPending() > 0)
+                {
+                    // Let the thread get on with the other requests while this one is read,
+                    // the responder holds on to the buffer until the read is done
+                    mBytesToRead = file_size;
+                    mBytesRead = -1;
+                    mState = BODY_READING;
+                    mFileHandle = LLLFSThread::sLocal->read(filename, data + data_offset, file_offset, file_size,
+                                                            new ReadResponder(mCache, mRequestHandle, data));
+                    return false;
+                }
+
+                // Now use that buffer as the object read buffer
                 mReadData = data;
 
                 // Read the data at last
@@ -522,6 +551,25 @@ bool LLTextureCacheRemoteWorker::doRead()
         done = true;
     }
 
+    if (!done && (mState == BODY_READING))
+    {
+        if (mBytesRead < 0)
+        {
+            return false; // still in flight
+        }
+        mFileHandle = LLLFSThread::nullHandle();
+        if (mBytesRead != mBytesToRead)
+        {
+            LL_WARNS() << "LLTextureCacheWorker: "  << mID
+                    << " incorrect number of bytes read from body: " << mBytesRead
+                    << " / " << mBytesToRead << LL_ENDL;
+            ll_aligned_free_16(mReadData);
+            mReadData = NULL;
+            mDataSize = -1; // failed
+        }
+        done = true;
+    }
+
     // Clean up and exit
     return done;
 }
@@ -875,10 +923,7 @@ std::string LLTextureCache::getTextureFileName(const LLUUID& id)
 //debug
 bool LLTextureCache::isInCache(const LLUUID& id)
 {
-    LLMutexLock lock(&mHeaderMutex);
-    id_map_t::const_iterator iter = mHeaderIDMap.find(id);
-
-    return (iter != mHeaderIDMap.end()) ;
+    return findHeaderIndex(id) >= 0;
 }
 
 //debug
@@ -1067,11 +1112,127 @@ void LLTextureCache::closeHeaderEntriesFile()
     mHeaderAPRFile = NULL;
 }
 
+void LLTextureCache::mapHeaderEntriesFile()
+{
+    if (mReadOnly || mHeaderEntriesMap.isOpen())
+    {
+        return;
+    }
+
+    // Entries waiting in mUpdatedEntryMap have to reach the file first,
+    // once the view is open every update is written through it directly.
+    if (!mUpdatedEntryMap.empty())
+    {
+        openHeaderEntriesFile(false, 0);
+        updatedHeaderEntriesFile();
+        closeHeaderEntriesFile();
+    }
+
+    // Reserve room for every entry we may allocate so the view never has
+    // to grow. A cache that was shrunk may still hold more entries than
+    // sCacheMaxEntries until it gets purged.
+    U32 max_entries = llmax(sCacheMaxEntries, mHeaderEntriesInfo.mEntries);
+    size_t map_size = sizeof(EntriesInfo) + (size_t)max_entries * sizeof(Entry);
+
+    for (U32 i = 0; i < HEADER_SHARD_COUNT; ++i)
+    {
+        mHeaderShards[i].mMutex.lock();
+    }
+    bool mapped = mHeaderEntriesMap.open(mHeaderEntriesFileName, map_size);
+    for (U32 i = 0; i < HEADER_SHARD_COUNT; ++i)
+    {
+        mHeaderShards[i].mMutex.unlock();
+    }
+
+    if (mapped)
+    {
+        LL_INFOS("TextureCache") << "Mapped " << max_entries << " header entries" << LL_ENDL;
+    }
+    else
+    {
+        LL_WARNS("TextureCache") << "Could not map " << mHeaderEntriesFileName << ", using file reads" << LL_ENDL;
+    }
+}
+
+void LLTextureCache::unmapHeaderEntriesFile()
+{
+    if (!mHeaderEntriesMap.isOpen())
+    {
+        return;
+    }
+
+    // Readers on the fast path only hold their shard lock
+    for (U32 i = 0; i < HEADER_SHARD_COUNT; ++i)
+    {
+        mHeaderShards[i].mMutex.lock();
+    }
+    mHeaderEntriesMap.close();
+    for (U32 i = 0; i < HEADER_SHARD_COUNT; ++i)
+    {
+        mHeaderShards[i].mMutex.unlock();
+    }
+}
+
+// Returns the mapped slot for idx, or NULL when the entry has to go through
+// the header file instead. The caller must hold mHeaderMutex or the shard
+// lock of the UUID the slot belongs to.
+LLTextureCache::Entry* LLTextureCache::getMappedEntry(S32 idx) const
+{
+    if (idx < 0 || !mHeaderEntriesMap.isOpen())
+    {
+        return NULL;
+    }
+    size_t offset = sizeof(EntriesInfo) + (size_t)idx * sizeof(Entry);
+    if (offset + sizeof(Entry) > mHeaderEntriesMap.getSize())
+    {
+        return NULL;
+    }
+    return (Entry*)(mHeaderEntriesMap.getData() + offset);
+}
+
+S32 LLTextureCache::findHeaderIndex(const LLUUID& id)
+{
+    HeaderShard& shard = getHeaderShard(id);
+    LLMutexLock lock(&shard.mMutex);
+    id_map_t::const_iterator iter = shard.mIDMap.find(id);
+    return iter != shard.mIDMap.end() ? iter->second : -1;
+}
+
+//mHeaderMutex is locked before calling this.
+void LLTextureCache::setHeaderIndex(const LLUUID& id, S32 idx)
+{
+    HeaderShard& shard = getHeaderShard(id);
+    LLMutexLock lock(&shard.mMutex);
+    shard.mIDMap[id] = idx;
+}
+
+//mHeaderMutex is locked before calling this.
+void LLTextureCache::eraseHeaderIndex(const LLUUID& id)
+{
+    HeaderShard& shard = getHeaderShard(id);
+    LLMutexLock lock(&shard.mMutex);
+    shard.mIDMap.erase(id);
+}
+
+//mHeaderMutex is locked before calling this.
+void LLTextureCache::clearHeaderIndex()
+{
+    for (U32 i = 0; i < HEADER_SHARD_COUNT; ++i)
+    {
+        LLMutexLock lock(&mHeaderShards[i].mMutex);
+        mHeaderShards[i].mIDMap.clear();
+    }
+}
+
 void LLTextureCache::readEntriesHeader()
 {
     // mHeaderEntriesInfo initializes to default values so safe not to read it
     llassert_always(mHeaderAPRFile == NULL);
-    if (LLAPRFile::isExist(mHeaderEntriesFileName, mHeaderAPRFilePoolp))
+    if (mHeaderEntriesMap.isOpen())
+    {
+        memcpy(&mHeaderEntriesInfo, mHeaderEntriesMap.getData(), sizeof(EntriesInfo));
+    }
+    else if (LLAPRFile::isExist(mHeaderEntriesFileName, mHeaderAPRFilePoolp))
     {
         LLAPRFile::readEx(mHeaderEntriesFileName, (U8*)&mHeaderEntriesInfo, 0, sizeof(EntriesInfo),
                           mHeaderAPRFilePoolp);
@@ -1103,7 +1264,11 @@ void LLTextureCache::setEntriesHeader()
 void LLTextureCache::writeEntriesHeader()
 {
     llassert_always(mHeaderAPRFile == NULL);
-    if (!mReadOnly)
+    if (mHeaderEntriesMap.isOpen())
+    {
+        memcpy(mHeaderEntriesMap.getData(), &mHeaderEntriesInfo, sizeof(EntriesInfo));
+    }
+    else if (!mReadOnly)
     {
         LLAPRFile::writeEx(mHeaderEntriesFileName, (U8*)&mHeaderEntriesInfo, 0, sizeof(EntriesInfo),
                            mHeaderAPRFilePoolp);
@@ -1113,13 +1278,7 @@ void LLTextureCache::writeEntriesHeader()
 //mHeaderMutex is locked before calling this.
 S32 LLTextureCache::openAndReadEntry(const LLUUID& id, Entry& entry, bool create)
 {
-    S32 idx = -1;
-
-    id_map_t::iterator iter1 = mHeaderIDMap.find(id);
-    if (iter1 != mHeaderIDMap.end())
-    {
-        idx = iter1->second;
-    }
+    S32 idx = findHeaderIndex(id);
 
     if (idx < 0)
     {
@@ -1139,19 +1298,24 @@ S32 LLTextureCache::openAndReadEntry(const LLUUID& id, Entry& entry, bool create
             else
             {
                 // Look for a still valid entry in the LRU
-                for (std::set<LLUUID>::iterator iter2 = mLRU.begin(); iter2 != mLRU.end();)
+                while (idx < 0)
                 {
-                    std::set<LLUUID>::iterator curiter2 = iter2++;
-                    LLUUID oldid = *curiter2;
-                    // Erase entry from LRU regardless
-                    mLRU.erase(curiter2);
+                    LLUUID oldid;
+                    {
+                        LLMutexLock lock(&mLRUMutex);
+                        if (mLRU.empty())
+                        {
+                            break;
+                        }
+                        // Erase entry from LRU regardless
+                        oldid = *mLRU.begin();
+                        mLRU.erase(mLRU.begin());
+                    }
                     // Look up entry and use it if it is valid
-                    id_map_t::iterator iter3 = mHeaderIDMap.find(oldid);
-                    if (iter3 != mHeaderIDMap.end() && iter3->second >= 0)
+                    idx = findHeaderIndex(oldid);
+                    if (idx >= 0)
                     {
-                        idx = iter3->second;
                         removeCachedTexture(oldid) ;//remove the existing cached texture to release the entry index.
-                        break;
                     }
                 }
                 // if (idx < 0) at this point, we will rebuild the LRU
@@ -1169,7 +1333,10 @@ S32 LLTextureCache::openAndReadEntry(const LLUUID& id, Entry& entry, bool create
     else
     {
         // Remove this entry from the LRU if it exists
-        mLRU.erase(id);
+        {
+            LLMutexLock lock(&mLRUMutex);
+            mLRU.erase(id);
+        }
         // Read the entry
         idx_entry_map_t::iterator iter = mUpdatedEntryMap.find(idx) ;
         if(iter != mUpdatedEntryMap.end())
@@ -1197,6 +1364,23 @@ S32 LLTextureCache::openAndReadEntry(const LLUUID& id, Entry& entry, bool create
 //mHeaderMutex is locked before calling this.
 void LLTextureCache::writeEntryToHeaderImmediately(S32& idx, Entry& entry, bool write_header)
 {
+    Entry* mapped_entry = getMappedEntry(idx);
+    if (mapped_entry)
+    {
+        if (write_header)
+        {
+            memcpy(mHeaderEntriesMap.getData(), &mHeaderEntriesInfo, sizeof(EntriesInfo));
+        }
+        {
+            // Fast path readers of this UUID copy the slot under the shard lock
+            HeaderShard& shard = getHeaderShard(entry.mID);
+            LLMutexLock lock(&shard.mMutex);
+            memcpy(mapped_entry, &entry, sizeof(Entry));
+        }
+        mUpdatedEntryMap.erase(idx) ;
+        return;
+    }
+
     LLAPRFile* aprfile ;
     S32 bytes_written ;
     S32 offset = sizeof(EntriesInfo) + idx * sizeof(Entry);
@@ -1233,6 +1417,13 @@ void LLTextureCache::writeEntryToHeaderImmediately(S32& idx, Entry& entry, bool
 //mHeaderMutex is locked before calling this.
 void LLTextureCache::readEntryFromHeaderImmediately(S32& idx, Entry& entry)
 {
+    Entry* mapped_entry = getMappedEntry(idx);
+    if (mapped_entry)
+    {
+        memcpy(&entry, mapped_entry, sizeof(Entry));
+        return;
+    }
+
     S32 offset = sizeof(EntriesInfo) + idx * sizeof(Entry);
     LLAPRFile* aprfile = openHeaderEntriesFile(true, offset);
     S32 bytes_read = aprfile->read((void*)&entry, (S32)sizeof(Entry));
@@ -1249,9 +1440,7 @@ void LLTextureCache::readEntryFromHeaderImmediately(S32& idx, Entry& entry)
 //update an existing entry time stamp, delay writing.
 void LLTextureCache::updateEntryTimeStamp(S32 idx, Entry& entry)
 {
-    static const U32 MAX_ENTRIES_WITHOUT_TIME_STAMP = (U32)(LLTextureCache::sCacheMaxEntries * 0.75f) ;
-
-    if(mHeaderEntriesInfo.mEntries < MAX_ENTRIES_WITHOUT_TIME_STAMP)
+    if (!needsTimeStamp())
     {
         return ; //there are enough empty entry index space, no need to stamp time.
     }
@@ -1261,11 +1450,28 @@ void LLTextureCache::updateEntryTimeStamp(S32 idx, Entry& entry)
         if (!mReadOnly)
         {
             entry.mTime = (U32)time(NULL);
-            mUpdatedEntryMap[idx] = entry ;
+            Entry* mapped_entry = getMappedEntry(idx);
+            if (mapped_entry)
+            {
+                HeaderShard& shard = getHeaderShard(entry.mID);
+                LLMutexLock lock(&shard.mMutex);
+                mapped_entry->mTime = entry.mTime;
+            }
+            else
+            {
+                mUpdatedEntryMap[idx] = entry ;
+            }
         }
     }
 }
 
+bool LLTextureCache::needsTimeStamp() const
+{
+    static const U32 MAX_ENTRIES_WITHOUT_TIME_STAMP = (U32)(LLTextureCache::sCacheMaxEntries * 0.75f) ;
+
+    return mHeaderEntriesInfo.mEntries >= MAX_ENTRIES_WITHOUT_TIME_STAMP;
+}
+
 //update an existing entry, write to header file immediately.
 bool LLTextureCache::updateEntry(S32& idx, Entry& entry, S32 new_image_size, S32 new_data_size)
 {
@@ -1285,7 +1491,7 @@ bool LLTextureCache::updateEntry(S32& idx, Entry& entry, S32 new_image_size, S32
         bool update_header = false ;
         if(entry.mImageSize < 0) //is a brand-new entry
         {
-            mHeaderIDMap[entry.mID] = idx;
+            setHeaderIndex(entry.mID, idx);
             mTexturesSizeMap[entry.mID] = new_body_size ;
             mTexturesSizeTotal += new_body_size ;
 
@@ -1294,7 +1500,7 @@ bool LLTextureCache::updateEntry(S32& idx, Entry& entry, S32 new_image_size, S32
         }
         else if (entry.mBodySize != new_body_size)
         {
-            //already in mHeaderIDMap.
+            //already in the header index.
             mTexturesSizeMap[entry.mID] = new_body_size ;
             mTexturesSizeTotal -= entry.mBodySize ;
             mTexturesSizeTotal += new_body_size ;
@@ -1325,11 +1531,32 @@ U32 LLTextureCache::openAndReadEntries(std::vector<Entry>& entries)
 {
     U32 num_entries = mHeaderEntriesInfo.mEntries;
 
-    mHeaderIDMap.clear();
+    clearHeaderIndex();
     mTexturesSizeMap.clear();
     mFreeList.clear();
     mTexturesSizeTotal = 0;
 
+    if (num_entries && getMappedEntry(num_entries - 1))
+    {
+        entries.resize(num_entries);
+        memcpy(entries.data(), getMappedEntry(0), num_entries * sizeof(Entry));
+        for (U32 idx = 0; idx < num_entries; idx++)
+        {
+            const Entry& entry = entries[idx];
+            if (entry.mImageSize > entry.mBodySize)
+            {
+                setHeaderIndex(entry.mID, idx);
+                mTexturesSizeMap[entry.mID] = entry.mBodySize;
+                mTexturesSizeTotal += entry.mBodySize;
+            }
+            else
+            {
+                mFreeList.insert(idx);
+            }
+        }
+        return num_entries;
+    }
+
     LLAPRFile* aprfile = NULL;
     if(mUpdatedEntryMap.empty())
     {
@@ -1360,7 +1587,7 @@ U32 LLTextureCache::openAndReadEntries(std::vector<Entry>& entries)
 //      LL_INFOS() << "ENTRY: " << entry.mTime << " TEX: " << entry.mID << " IDX: " << idx << " Size: " << entry.mImageSize << LL_ENDL;
         if(entry.mImageSize > entry.mBodySize)
         {
-            mHeaderIDMap[entry.mID] = idx;
+            setHeaderIndex(entry.mID, idx);
             mTexturesSizeMap[entry.mID] = entry.mBodySize;
             mTexturesSizeTotal += entry.mBodySize;
         }
@@ -1378,7 +1605,18 @@ void LLTextureCache::writeEntriesAndClose(const std::vector<Entry>& entries)
     auto num_entries = entries.size();
     llassert_always(num_entries == mHeaderEntriesInfo.mEntries);
 
-    if (!mReadOnly)
+    if (num_entries && getMappedEntry((S32)num_entries - 1))
+    {
+        for (size_t idx = 0; idx < num_entries; idx++)
+        {
+            // Purged entries are already out of the index, the others are
+            // rewritten with the same UUID so they keep their shard.
+            HeaderShard& shard = getHeaderShard(entries[idx].mID);
+            LLMutexLock lock(&shard.mMutex);
+            memcpy(getMappedEntry((S32)idx), &entries[idx], sizeof(Entry));
+        }
+    }
+    else if (!mReadOnly)
     {
         LLAPRFile* aprfile = openHeaderEntriesFile(false, (S32)sizeof(EntriesInfo));
         for (size_t idx=0; idx<num_entries; idx++)
@@ -1397,6 +1635,11 @@ void LLTextureCache::writeEntriesAndClose(const std::vector<Entry>& entries)
 void LLTextureCache::writeUpdatedEntries()
 {
     lockHeaders() ;
+    if (mHeaderEntriesMap.isOpen())
+    {
+        memcpy(mHeaderEntriesMap.getData(), &mHeaderEntriesInfo, sizeof(EntriesInfo));
+        mHeaderEntriesMap.flush();
+    }
     if (!mReadOnly && !mUpdatedEntryMap.empty())
     {
         openHeaderEntriesFile(false, 0);
@@ -1450,7 +1693,10 @@ void LLTextureCache::readHeaderCache()
 {
     mHeaderMutex.lock();
 
-    mLRU.clear(); // always clear the LRU
+    {
+        LLMutexLock lock(&mLRUMutex);
+        mLRU.clear(); // always clear the LRU
+    }
 
     readEntriesHeader();
 
@@ -1514,6 +1760,7 @@ void LLTextureCache::readHeaderCache()
 
             {
                 S32 lru_entries = (S32)((F32)sCacheMaxEntries * TEXTURE_CACHE_LRU_SIZE);
+                LLMutexLock lock(&mLRUMutex);
                 for (std::set<lru_data_t>::iterator iter = lru.begin(); iter != lru.end(); ++iter)
                 {
                     mLRU.insert(entries[iter->second].mID);
@@ -1545,6 +1792,7 @@ void LLTextureCache::readHeaderCache()
             }
         }
     }
+    mapHeaderEntriesFile();
     mHeaderMutex.unlock();
 }
 
@@ -1575,6 +1823,9 @@ void LLTextureCache::clearCorruptedCache()
 
 void LLTextureCache::purgeAllTextures(bool purge_directories)
 {
+    // The view has to go before the file it maps gets deleted
+    unmapHeaderEntriesFile();
+
     if (!mReadOnly)
     {
         const char* subdirs = "0123456789abcdef";
@@ -1605,7 +1856,7 @@ void LLTextureCache::purgeAllTextures(bool purge_directories)
             LLFile::rmdir(mTexturesDirName);
         }
     }
-    mHeaderIDMap.clear();
+    clearHeaderIndex();
     mTexturesSizeMap.clear();
     mTexturesSizeTotal = 0;
     mFreeList.clear();
@@ -1652,15 +1903,14 @@ void LLTextureCache::purgeTexturesLazy(F32 time_limit_sec)
         {
             if (iter1->second > 0)
             {
-                id_map_t::iterator iter2 = mHeaderIDMap.find(iter1->first);
-                if (iter2 != mHeaderIDMap.end())
+                S32 idx = findHeaderIndex(iter1->first);
+                if (idx >= 0)
                 {
-                    S32 idx = iter2->second;
                     time_idx_set.insert(std::make_pair(entries[idx].mTime, idx));
                 }
                 else
                 {
-                    LL_ERRS("TextureCache") << "mTexturesSizeMap / mHeaderIDMap corrupted." << LL_ENDL;
+                    LL_ERRS("TextureCache") << "mTexturesSizeMap / header index corrupted." << LL_ENDL;
                 }
             }
         }
@@ -1693,8 +1943,7 @@ void LLTextureCache::purgeTexturesLazy(F32 time_limit_sec)
             Entry entry = mPurgeEntryList.back().second;
             mPurgeEntryList.pop_back();
             // make sure record is still valid
-            id_map_t::iterator iter_header = mHeaderIDMap.find(entry.mID);
-            if (iter_header != mHeaderIDMap.end() && iter_header->second == idx)
+            if (findHeaderIndex(entry.mID) == idx)
             {
                 std::string tex_filename = getTextureFileName(entry.mID);
                 removeEntry(idx, entry, tex_filename);
@@ -1737,16 +1986,15 @@ void LLTextureCache::purgeTextures(bool validate)
     {
         if (iter1->second > 0)
         {
-            id_map_t::iterator iter2 = mHeaderIDMap.find(iter1->first);
-            if (iter2 != mHeaderIDMap.end())
+            S32 idx = findHeaderIndex(iter1->first);
+            if (idx >= 0)
             {
-                S32 idx = iter2->second;
                 time_idx_set.insert(std::make_pair(entries[idx].mTime, idx));
 //              LL_INFOS() << "TIME: " << entries[idx].mTime << " TEX: " << entries[idx].mID << " IDX: " << idx << " Size: " << entries[idx].mImageSize << LL_ENDL;
             }
             else
             {
-                LL_ERRS() << "mTexturesSizeMap / mHeaderIDMap corrupted." << LL_ENDL ;
+                LL_ERRS() << "mTexturesSizeMap / header index corrupted." << LL_ENDL ;
             }
         }
     }
@@ -1854,8 +2102,14 @@ LLTextureCacheWorker* LLTextureCache::getWriter(handle_t handle)
 S32 LLTextureCache::getHeaderCacheEntry(const LLUUID& id, Entry& entry)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    S32 idx = readMappedEntry(id, entry);
+    if (idx >= 0)
+    {
+        return idx;
+    }
+
     LLMutexLock lock(&mHeaderMutex);
-    S32 idx = openAndReadEntry(id, entry, false);
+    idx = openAndReadEntry(id, entry, false);
     if (idx >= 0)
     {
         updateEntryTimeStamp(idx, entry); // updates time
@@ -1863,6 +2117,44 @@ S32 LLTextureCache::getHeaderCacheEntry(const LLUUID& id, Entry& entry)
     return idx;
 }
 
+// Lock free (with respect to mHeaderMutex) version of getHeaderCacheEntry()
+// for entries that are already indexed and live in the mapped entries file.
+// Returns -1 whenever the regular path has to handle the request.
+S32 LLTextureCache::readMappedEntry(const LLUUID& id, Entry& entry)
+{
+    S32 idx = -1;
+    {
+        HeaderShard& shard = getHeaderShard(id);
+        LLMutexLock lock(&shard.mMutex);
+        id_map_t::const_iterator iter = shard.mIDMap.find(id);
+        if (iter == shard.mIDMap.end())
+        {
+            return -1;
+        }
+        Entry* mapped_entry = getMappedEntry(iter->second);
+        if (!mapped_entry)
+        {
+            return -1;
+        }
+        memcpy(&entry, mapped_entry, sizeof(Entry));
+        if (entry.mID != id || entry.mImageSize <= entry.mBodySize)
+        {
+            // Corrupted entries get cleaned up by openAndReadEntry()
+            return -1;
+        }
+        idx = iter->second;
+        if (!mReadOnly && needsTimeStamp())
+        {
+            entry.mTime = (U32)time(NULL);
+            mapped_entry->mTime = entry.mTime;
+        }
+    }
+
+    LLMutexLock lock(&mLRUMutex);
+    mLRU.erase(id);
+    return idx;
+}
+
 // Writes imagesize to the header, updates timestamp
 S32 LLTextureCache::setHeaderCacheEntry(const LLUUID& id, Entry& entry, S32 imagesize, S32 datasize)
 {
@@ -1991,14 +2283,13 @@ LLPointer<LLImageRaw> LLTextureCache::readFromFastCache(const LLUUID& id, S32& d
 {
     U32 offset;
     {
-        LLMutexLock lock(&mHeaderMutex);
-        id_map_t::const_iterator iter = mHeaderIDMap.find(id);
-        if(iter == mHeaderIDMap.end())
+        S32 idx = findHeaderIndex(id);
+        if(idx < 0)
         {
             return NULL; //not in the cache
         }
 
-        offset = iter->second;
+        offset = idx;
     }
     offset *= TEXTURE_FAST_CACHE_ENTRY_SIZE;
 
@@ -2028,10 +2319,12 @@ LLPointer<LLImageRaw> LLTextureCache::readFromFastCache(const LLUUID& id, S32& d
         }
         discardlevel = head[3];
 
-        data = (U8*)ll_aligned_malloc_16(image_size);
+        // the raw image adopts data, so it has to come from where raw
+        // image buffers do
+        data = LLImageRawPool::allocate(image_size);
         if(mFastCachep->read(data, image_size) != image_size)
         {
-            ll_aligned_free_16(data);
+            LLImageRawPool::release(data, image_size);
             closeFastCache();
             return NULL;
         }
@@ -2216,7 +2509,7 @@ void LLTextureCache::removeCachedTexture(const LLUUID& id)
         mTexturesSizeTotal -= mTexturesSizeMap[id] ;
         mTexturesSizeMap.erase(id);
     }
-    mHeaderIDMap.erase(id);
+    eraseHeaderIndex(id);
     // We are inside header's mutex so mHeaderAPRFilePoolp is safe to use,
     // but getLocalAPRFilePool() is not safe, it might be in use by worker
     LLAPRFile::remove(getTextureFileName(id), mHeaderAPRFilePoolp);
@@ -2247,7 +2540,7 @@ void LLTextureCache::removeEntry(S32 idx, Entry& entry, std::string& filename)
 
         entry.mImageSize = -1;
         entry.mBodySize = 0;
-        mHeaderIDMap.erase(entry.mID);
+        eraseHeaderIndex(entry.mID);
         mTexturesSizeMap.erase(entry.mID);
         mFreeList.insert(idx);
     }
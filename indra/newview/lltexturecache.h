@@ -28,6 +28,7 @@
 #define LL_LLTEXTURECACHE_H
 
 #include "lldir.h"
+#include "llmappedfile.h"
 #include "llstl.h"
 #include "llstring.h"
 #include "lluuid.h"
@@ -149,10 +150,12 @@ public:
     bool isInCache(const LLUUID& id) ;
     bool isInLocal(const LLUUID& id) ; //not thread safe at the moment
 
+    // body file of the texture, also used by LLVOCache::prefetchAssets
+    std::string getTextureFileName(const LLUUID& id);
+
 protected:
     // Accessed by LLTextureCacheWorker
     std::string getLocalFileName(const LLUUID& id);
-    std::string getTextureFileName(const LLUUID& id);
     void addCompleted(Responder* responder, bool success);
 
 protected:
@@ -173,6 +176,7 @@ private:
     S32 openAndReadEntry(const LLUUID& id, Entry& entry, bool create);
     bool updateEntry(S32& idx, Entry& entry, S32 new_image_size, S32 new_body_size);
     void updateEntryTimeStamp(S32 idx, Entry& entry) ;
+    bool needsTimeStamp() const;
     U32 openAndReadEntries(std::vector<Entry>& entries);
     void writeEntriesAndClose(const std::vector<Entry>& entries);
     void readEntryFromHeaderImmediately(S32& idx, Entry& entry) ;
@@ -183,6 +187,14 @@ private:
     S32 setHeaderCacheEntry(const LLUUID& id, Entry& entry, S32 imagesize, S32 datasize);
     void writeUpdatedEntries() ;
     void updatedHeaderEntriesFile() ;
+    void mapHeaderEntriesFile();
+    void unmapHeaderEntriesFile();
+    Entry* getMappedEntry(S32 idx) const;
+    S32 readMappedEntry(const LLUUID& id, Entry& entry);
+    S32 findHeaderIndex(const LLUUID& id);
+    void setHeaderIndex(const LLUUID& id, S32 idx);
+    void eraseHeaderIndex(const LLUUID& id);
+    void clearHeaderIndex();
     void lockHeaders() { mHeaderMutex.lock(); }
     void unlockHeaders() { mHeaderMutex.unlock(); }
 
@@ -196,6 +208,7 @@ private:
     LLMutex mHeaderMutex;
     LLMutex mListMutex;
     LLMutex mFastCacheMutex;
+    LLMutex mLRUMutex;
     LLAPRFile* mHeaderAPRFile;
     LLVolatileAPRPool* mFastCachePoolp;
 
@@ -222,9 +235,25 @@ private:
     std::string mFastCacheFileName;
     EntriesInfo mHeaderEntriesInfo;
     std::set<S32> mFreeList; // deleted entries
-    std::set<LLUUID> mLRU;
+    std::set<LLUUID> mLRU; // guarded by mLRUMutex
     typedef std::map<LLUUID, S32> id_map_t;
-    id_map_t mHeaderIDMap;
+
+    // The UUID -> entry index map is split by UUID hash. Lookups of entries
+    // that are already cached only take the lock of their own shard, any
+    // change to the index additionally requires mHeaderMutex.
+    static const U32 HEADER_SHARD_COUNT = 16;
+    struct HeaderShard
+    {
+        LLMutex mMutex;
+        id_map_t mIDMap;
+    };
+    HeaderShard& getHeaderShard(const LLUUID& id) { return mHeaderShards[id.getDigest64() % HEADER_SHARD_COUNT]; }
+    HeaderShard mHeaderShards[HEADER_SHARD_COUNT];
+
+    // Writable view of the header entries file. Mapped and unmapped under
+    // mHeaderMutex with every shard locked; while it is open all entry reads
+    // and writes go through it instead of mHeaderAPRFile.
+    LLMappedFile mHeaderEntriesMap;
 
     LLAPRFile*   mFastCachep;
     LLFrameTimer mFastCacheTimer;
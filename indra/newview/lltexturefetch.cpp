@@ -70,6 +70,8 @@ LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sCacheReadLatency("texture
 LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sTexDecodeLatency("texture_decode_latency");
 LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sCacheWriteLatency("texture_write_latency");
 LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sTexFetchLatency("texture_fetch_latency");
+LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sHttpBatchLatency("texture_http_batch_latency");
+LLTrace::SampleStatHandle<F32> LLTextureFetch::sHttpBatchSize("texture_http_batch_size");
 
 LLTextureFetchTester* LLTextureFetch::sTesterp = NULL ;
 const std::string sTesterName("TextureFetchTester");
@@ -1487,6 +1489,7 @@ bool LLTextureFetchWorker::doWork(S32 param)
 
         mHttpActive = true;
         mFetcher->addToHTTPQueue(mID);
+        mFetcher->addToHttpBatch();
         recordTextureStart(true);
         setState(WAIT_HTTP_REQ);
 
@@ -1641,7 +1644,20 @@ bool LLTextureFetchWorker::doWork(S32 param)
                 mRequestedOffset += src_offset;
             }
 
-            U8 * buffer = (U8 *)ll_aligned_malloc_16(total_size);
+            // A first response of known length takes over the body storage,
+            // which then holds exactly total_size bytes
+            U8 * buffer = NULL;
+            if (cur_size == 0 && src_offset == 0)
+            {
+                size_t detached_size = 0;
+                buffer = (U8 *)mHttpBufferArray->detach(&detached_size);
+                llassert(!buffer || detached_size == (size_t)total_size);
+            }
+            const bool copy_body = (buffer == NULL);
+            if (copy_body)
+            {
+                buffer = (U8 *)ll_aligned_malloc_16(total_size);
+            }
             if (!buffer)
             {
                 // abort. If we have no space for packet, we have not enough space to decode image
@@ -1678,7 +1694,10 @@ bool LLTextureFetchWorker::doWork(S32 param)
                 // Copy previously collected data into buffer
                 memcpy(buffer, mFormattedImage->getData(), cur_size);
             }
-            mHttpBufferArray->read(src_offset, (char *) buffer + cur_size, append_size);
+            if (copy_body)
+            {
+                mHttpBufferArray->read(src_offset, (char *) buffer + cur_size, append_size);
+            }
 
             // NOTE: setData releases current data and owns new data (buffer)
             mFormattedImage->setData(buffer, total_size);
@@ -2408,6 +2427,9 @@ LLTextureFetch::LLTextureFetch(LLTextureCache* cache, bool threaded, bool qa_mod
       mTextureCache(cache),
       mTextureBandwidth(0),
       mHTTPTextureBits(0),
+      mHttpBatchCount(0),
+      mHttpBatchedRequests(0),
+      mHttpBatchLatencyMax(0.f),
       mTotalHTTPRequests(0),
       mQAMode(qa_mode),
       mHttpRequest(NULL),
@@ -2441,6 +2463,10 @@ LLTextureFetch::LLTextureFetch(LLTextureCache* cache, bool threaded, bool qa_mod
     mHttpHighWater = HTTP_NONPIPE_REQUESTS_HIGH_WATER;
     mHttpLowWater = HTTP_NONPIPE_REQUESTS_LOW_WATER;
     mHttpSemaphore = 0;
+    if (gSavedSettings.getBOOL("TextureFetchBatchRequests"))
+    {
+        mHttpRequest->beginBatch();
+    }
 
     // If that test log has ben requested but not yet created, create it
     if (LLMetricPerformanceTesterBasic::isMetricLogRequested(sTesterName) && !LLMetricPerformanceTesterBasic::getTester(sTesterName))
@@ -2899,6 +2925,55 @@ bool LLTextureFetch::runCondition()
 
 //////////////////////////////////////////////////////////////////////////////
 
+// Threads:  Ttf
+void LLTextureFetch::addToHttpBatch()
+{
+    static LLCachedControl<U32> batch_size(gSavedSettings, "TextureFetchBatchSize", 32);
+
+    size_t batched = mHttpRequest->getBatchSize();
+    if (batched == 1)
+    {
+        mHttpBatchTimer.reset();
+    }
+    else if (batched >= llmax((U32)batch_size, 1U))
+    {
+        flushHttpBatch();
+    }
+}
+
+// Threads:  Ttf
+void LLTextureFetch::flushHttpBatch()
+{
+    static LLCachedControl<bool> batch_requests(gSavedSettings, "TextureFetchBatchRequests", true);
+
+    size_t batched = mHttpRequest->getBatchSize();
+    if (batched)
+    {
+        F32 latency = mHttpBatchTimer.getElapsedTimeF32();
+        LLCore::HttpStatus status = mHttpRequest->flushBatch();
+        if (! status)
+        {
+            LL_WARNS(LOG_TXT) << "Failed to submit " << batched << " texture requests.  Reason:  "
+                              << status.toString() << LL_ENDL;
+        }
+
+        LLMutexLock lock(&mNetworkQueueMutex);                          // +Mfnq
+        mHttpBatchCount++;
+        mHttpBatchedRequests += (U32)batched;
+        mHttpBatchLatencyMax = llmax(mHttpBatchLatencyMax, latency);
+    }                                                                   // -Mfnq
+    else
+    {
+        // Also ends batching when it was just turned off
+        mHttpRequest->flushBatch();
+    }
+
+    if (batch_requests)
+    {
+        mHttpRequest->beginBatch();
+    }
+}
+
 // Threads:  Ttf
 void LLTextureFetch::commonUpdate()
 {
@@ -2923,6 +2998,9 @@ void LLTextureFetch::commonUpdate()
     // Run a cross-thread command, if any.
     cmdDoWork();
 
+    // Send whatever the workers queued up since the last pass
+    flushHttpBatch();
+
     // Deliver all completion notifications
     LLCore::HttpStatus status = mHttpRequest->update(0);
     if (! status)
@@ -2949,6 +3027,19 @@ size_t LLTextureFetch::update(F32 max_time_ms)
         add(LLStatViewer::TEXTURE_NETWORK_DATA_RECEIVED, mHTTPTextureBits);
         mHTTPTextureBits = (U32Bits)0;
 
+        if (mHttpBatchCount)
+        {
+            sample(sHttpBatchSize, (F32)mHttpBatchedRequests / (F32)mHttpBatchCount);
+            sample(sHttpBatchLatency, F32Seconds(mHttpBatchLatencyMax));
+            if (sTesterp)
+            {
+                sTesterp->updateBatchStats(mHttpBatchCount, mHttpBatchedRequests, mHttpBatchLatencyMax);
+            }
+            mHttpBatchCount = 0;
+            mHttpBatchedRequests = 0;
+            mHttpBatchLatencyMax = 0.f;
+        }
+
         mNetworkQueueMutex.unlock();                                    // -Mfnq
     }
 
@@ -3627,6 +3718,9 @@ LLTextureFetchTester::LLTextureFetchTester() : LLMetricPerformanceTesterBasic(sT
     mTextureFetchTime = 0;
     mSkippedStatesTime = 0;
     mFileSize = 0;
+    mBatchCount = 0;
+    mBatchedRequests = 0;
+    mMaxBatchLatency = 0.f;
 }
 
 LLTextureFetchTester::~LLTextureFetchTester()
@@ -3643,6 +3737,9 @@ void LLTextureFetchTester::outputTestRecord(LLSD *sd)
     (*sd)[currentLabel]["Texture Fetch Time"]   = (LLSD::Real)mTextureFetchTime;
     (*sd)[currentLabel]["File Size"]            = (LLSD::Integer)mFileSize;
     (*sd)[currentLabel]["Skipped States Time"]  = (LLSD::String)llformat("%.6f", mSkippedStatesTime);
+    (*sd)[currentLabel]["HTTP Batches"]         = (LLSD::Integer)mBatchCount;
+    (*sd)[currentLabel]["Mean HTTP Batch Size"] = (LLSD::Real)(mBatchCount ? (F32)mBatchedRequests / (F32)mBatchCount : 0.f);
+    (*sd)[currentLabel]["Max HTTP Batch Latency"] = (LLSD::Real)mMaxBatchLatency;
 
     for(auto i : LOGGED_STATES)
     {
@@ -3659,3 +3756,9 @@ void LLTextureFetchTester::updateStats(const std::map<S32, F32> state_timers, co
     outputTestResults();
 }
 
+void LLTextureFetchTester::updateBatchStats(const U32 batch_count, const U32 batched_requests, const F32 max_latency)
+{
+    mBatchCount += batch_count;
+    mBatchedRequests += batched_requests;
+    mMaxBatchLatency = llmax(mMaxBatchLatency, max_latency);
+}
@@ -165,6 +165,20 @@ public:
     // Threads:  T*
     LLCore::HttpRequest & getHttpRequest()  { return *mHttpRequest; }
 
+    // Called by a worker after it issued an HTTP GET.  Requests are
+    // held back in mHttpRequest's batch and submitted together, grouped
+    // by host, once per update or when the batch reaches
+    // TextureFetchBatchSize.
+    //
+    // Threads:  Ttf
+    void addToHttpBatch();
+
+    // Submits the current batch and starts a new one if batching is
+    // enabled.
+    //
+    // Threads:  Ttf
+    void flushHttpBatch();
+
     // Threads:  T*
     LLCore::HttpRequest::policy_t getPolicyClass() const { return mHttpPolicyClass; }
 
@@ -300,6 +314,8 @@ public:
     static LLTrace::SampleStatHandle<F32Seconds> sTexDecodeLatency;
     static LLTrace::SampleStatHandle<F32Seconds> sCacheWriteLatency;
     static LLTrace::SampleStatHandle<F32Seconds> sTexFetchLatency;
+    static LLTrace::SampleStatHandle<F32Seconds> sHttpBatchLatency;
+    static LLTrace::SampleStatHandle<F32>       sHttpBatchSize;
     static LLTrace::EventStatHandle<LLUnit<F32, LLUnits::Percent> > sCacheHitRate;
 
 private:
@@ -324,6 +340,12 @@ private:
     // XXX possible delete
     U32Bits mHTTPTextureBits;                                               // Mfnq
 
+    // Batch statistics gathered on Ttf, reported from Tmain
+    U32 mHttpBatchCount;                                                // Mfnq
+    U32 mHttpBatchedRequests;                                           // Mfnq
+    F32 mHttpBatchLatencyMax;                                           // Mfnq
+    LLTimer mHttpBatchTimer;                                            // Ttf
+
     // XXX possible delete
     //debug use
     U32 mTotalHTTPRequests;
@@ -413,6 +435,7 @@ public:
     ~LLTextureFetchTester();
 
     void updateStats(const std::map<S32, F32> states_timers, const F32 fetch_time, const F32 other_states_time, const S32 file_size);
+    void updateBatchStats(const U32 batch_count, const U32 batched_requests, const F32 max_latency);
 
 protected:
     /*virtual*/ void outputTestRecord(LLSD* sd);
@@ -423,6 +446,10 @@ private:
     F32 mSkippedStatesTime;
     S32 mFileSize;
 
+    U32 mBatchCount;
+    U32 mBatchedRequests;
+    F32 mMaxBatchLatency;
+
     std::map<S32, F32> mStateTimersMap;
 };
 #endif // LL_LLTEXTUREFETCH_H
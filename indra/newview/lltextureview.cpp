@@ -35,13 +35,16 @@
 #include "lllfsthread.h"
 #include "llui.h"
 #include "llimageworker.h"
+#include "llimagerawpool.h"
 #include "llrender.h"
 
 #include "lltooltip.h"
 #include "llappviewer.h"
 #include "llmeshrepository.h"
+#include "llrendertargetpool.h"
 #include "llselectmgr.h"
 #include "llviewertexlayer.h"
+#include "lltexturebudget.h"
 #include "lltexturecache.h"
 #include "lltexturefetch.h"
 #include "llviewercontrol.h"
@@ -555,31 +558,39 @@ void LLGLTexMemBar::draw()
     U32 texFetchLatMed = U32(recording.getMean(LLTextureFetch::sTexFetchLatency).value() * 1000.0f);
     U32 texFetchLatMax = U32(recording.getMax(LLTextureFetch::sTexFetchLatency).value() * 1000.0f);
 
+    F32 httpBatchSize   = (F32)recording.getMean(LLTextureFetch::sHttpBatchSize);
+    U32 httpBatchLatMax = U32(recording.getMax(LLTextureFetch::sHttpBatchLatency).value() * 1000.0f);
+
     // draw a background above first line.... no idea where the rest of the background comes from for the below text
     gGL.color4f(0.f, 0.f, 0.f, 0.25f);
     gl_rect_2d(-10, getRect().getHeight() + line_height*2 + 1, getRect().getWidth()+2, getRect().getHeight()+2);
 
-    text = llformat("Est. Free: %d MB Sys Free: %d MB FBO: %d MB Bias: %.2f Cache: %.1f/%.1f MB",
+    text = llformat("Est. Free: %d MB Sys Free: %d MB FBO: %d MB (pool %d MB) Bias: %.2f Cache: %.1f/%.1f MB",
                     (S32)LLViewerTexture::sFreeVRAMMegabytes,
                     LLMemory::getAvailableMemKB()/1024,
                     LLRenderTarget::sBytesAllocated/(1024*1024),
+                    (S32)(gRenderTargetPool.getBytesAllocated()/(1024*1024)),
                     discard_bias,
                     cache_usage,
                     cache_max_usage);
     LLFontGL::getFontMonospace()->renderUTF8(text, 0, 0, v_offset + line_height*8,
                                              text_color, LLFontGL::LEFT, LLFontGL::TOP);
 
-    text = llformat("Images: %d   Raw: %d (%.2f MB)  Saved: %d (%.2f MB) Aux: %d (%.2f MB)", image_count, raw_image_count, raw_image_bytes_MB,
+    text = llformat("Images: %d   Raw: %d (%.2f MB)  Saved: %d (%.2f MB) Aux: %d (%.2f MB) Pool: %.1f/%.0f MB %.0f%% hits", image_count, raw_image_count, raw_image_bytes_MB,
         saved_raw_image_count, saved_raw_image_bytes_MB,
-        aux_raw_image_count, aux_raw_image_bytes_MB);
+        aux_raw_image_count, aux_raw_image_bytes_MB,
+        (F32)LLImageRawPool::getResidentBytes() / (1024.f * 1024.f),
+        (F32)LLImageRawPool::getMaxBytes() / (1024.f * 1024.f),
+        LLImageRawPool::getHitRate() * 100.f);
     LLFontGL::getFontMonospace()->renderUTF8(text, 0, 0, v_offset + line_height * 7,
         text_color, LLFontGL::LEFT, LLFontGL::TOP);
 
-    text = llformat("Textures: %.2f MB  Vertex: %.2f MB  Render: %.2f MB  Total: %.2f MB",
+    text = llformat("Textures: %.2f MB  Vertex: %.2f MB  Render: %.2f MB  Total: %.2f MB  Budget evicted: %d",
                     texture_bytes_alloc,
                     vertex_bytes_alloc,
                     render_bytes_alloc,
-        texture_bytes_alloc+vertex_bytes_alloc);
+        texture_bytes_alloc+vertex_bytes_alloc,
+        gTextureBudget.getNumEvicted());
     LLFontGL::getFontMonospace()->renderUTF8(text, 0, 0, v_offset + line_height * 6,
         text_color, LLFontGL::LEFT, LLFontGL::TOP);
 
@@ -598,7 +609,7 @@ void LLGLTexMemBar::draw()
     LLFontGL::getFontMonospace()->renderUTF8(text, 0, 0, v_offset + line_height*5,
                                              text_color, LLFontGL::LEFT, LLFontGL::TOP);
 
-    text = llformat("CacheHitRate: %3.2f Read: %d/%d/%d Decode: %d/%d/%d Fetch: %d/%d/%d",
+    text = llformat("CacheHitRate: %3.2f Read: %d/%d/%d Decode: %d/%d/%d Fetch: %d/%d/%d Batch: %.1f/%d",
                     cacheHitRate,
                     cacheReadLatMin,
                     cacheReadLatMed,
@@ -608,7 +619,9 @@ void LLGLTexMemBar::draw()
                     texDecodeLatMax,
                     texFetchLatMin,
                     texFetchLatMed,
-                    texFetchLatMax);
+                    texFetchLatMax,
+                    httpBatchSize,
+                    httpBatchLatMax);
 
     LLFontGL::getFontMonospace()->renderUTF8(text, 0, 0, v_offset + line_height*4,
                                              text_color, LLFontGL::LEFT, LLFontGL::TOP);
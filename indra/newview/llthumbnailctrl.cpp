@@ -59,6 +59,7 @@ LLThumbnailCtrl::LLThumbnailCtrl(const LLThumbnailCtrl::Params& p)
 ,   mShowLoadingPlaceholder(p.show_loading())
 ,   mInited(false)
 ,   mInitImmediately(true)
+,   mInView(true)
 {
     mLoadingPlaceholderString = LLTrans::getString("texture_loading");
 
@@ -85,7 +86,7 @@ LLThumbnailCtrl::~LLThumbnailCtrl()
 
 void LLThumbnailCtrl::draw()
 {
-    if (!mInited)
+    if (!mInited && mInView)
     {
         initImage();
     }
@@ -185,6 +186,19 @@ void LLThumbnailCtrl::setVisible(bool visible)
     LLUICtrl::setVisible(visible);
 }
 
+void LLThumbnailCtrl::setInView(bool in_view)
+{
+    if (in_view == mInView)
+    {
+        return;
+    }
+    mInView = in_view;
+    if (!mInView && mInited)
+    {
+        unloadImage();
+    }
+}
+
 void LLThumbnailCtrl::clearTexture()
 {
     setValue(LLSD());
@@ -206,7 +220,7 @@ void LLThumbnailCtrl::setValue(const LLSD& value)
 
     unloadImage();
 
-    if (mInitImmediately)
+    if (mInitImmediately && mInView)
     {
         initImage();
     }
@@ -239,10 +253,10 @@ void LLThumbnailCtrl::initImage()
             // Should it support baked textures?
             mTexturep = LLViewerTextureManager::getFetchedTexture(mImageAssetID, FTT_DEFAULT, MIPMAP_YES, LLGLTexture::BOOST_THUMBNAIL);
 
-            mTexturep->forceToSaveRawImage(0);
-
-            S32 desired_draw_width = MAX_IMAGE_SIZE;
-            S32 desired_draw_height = MAX_IMAGE_SIZE;
+            // Only fetch as much of the texture as this control shows, draw()
+            // asks for more if it gets resized.
+            S32 desired_draw_width = getRect().getWidth() > 0 ? getRect().getWidth() : MAX_IMAGE_SIZE;
+            S32 desired_draw_height = getRect().getHeight() > 0 ? getRect().getHeight() : MAX_IMAGE_SIZE;
             mTexturep->setKnownDrawSize(desired_draw_width, desired_draw_height);
         }
     }
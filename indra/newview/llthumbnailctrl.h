@@ -68,6 +68,9 @@ public:
 
     virtual void setValue(const LLSD& value ) override;
     void setInitImmediately(bool val) { mInitImmediately = val; }
+    // Controls scrolled out of view let go of their texture, which drops its
+    // fetch if nothing else wants it, and load it again when back in view.
+    void setInView(bool in_view);
     void clearTexture();
 
     virtual bool handleHover(S32 x, S32 y, MASK mask) override;
@@ -82,6 +85,7 @@ private:
     bool mShowLoadingPlaceholder;
     bool mInited;
     bool mInitImmediately;
+    bool mInView;
     std::string mLoadingPlaceholderString;
     LLUUID mImageAssetID;
     LLViewBorder* mBorder;
@@ -49,8 +49,10 @@
 #include "llgl.h"
 #include "llglheaders.h"
 #include "llgltfmateriallist.h"
+#include "llgpupasstimers.h"
 #include "llhudmanager.h"
 #include "llimagepng.h"
+#include "lllocalcliprect.h"
 #include "llmachineid.h"
 #include "llmemory.h"
 #include "llparcel.h"
@@ -109,6 +111,7 @@ constexpr F32 RESTORE_GL_TIME = 5.f;  // Wait this long while reloading textures
 
 bool gForceRenderLandFence = false;
 bool gDisplaySwapBuffers = false;
+F32 gSwapBuffersTime = 0.f;
 bool gDepthDirty = false;
 bool gResizeScreenTexture = false;
 bool gResizeShadowTexture = false;
@@ -450,6 +453,7 @@ void display(bool rebuild, F32 zoom_factor, int subfield, bool for_snapshot)
     if (   !gViewerWindow->getActive()
         || !gViewerWindow->getWindow()->getVisible()
         || gViewerWindow->getWindow()->getMinimized()
+        || (LLAppViewer::instance()->isInBackgroundMode() && !for_snapshot)
         || gNonInteractive)
     {
         // Clean up memory the pools may have allocated
@@ -772,7 +776,9 @@ void display(bool rebuild, F32 zoom_factor, int subfield, bool for_snapshot)
                 if (gFrameCount > 1 && !for_snapshot)
                 { //for some reason, ATI 4800 series will error out if you
                   //try to generate a shadow before the first frame is through
+                    gGPUPassTimers.begin(LLGPUPassTimers::PASS_SHADOWS);
                     gPipeline.generateSunShadow(*LLViewerCamera::getInstance());
+                    gGPUPassTimers.end(LLGPUPassTimers::PASS_SHADOWS);
                 }
 
                 LLVertexBuffer::unbind();
@@ -928,6 +934,11 @@ void display(bool rebuild, F32 zoom_factor, int subfield, bool for_snapshot)
 
         gGL.setColorMask(true, true);
 
+        if (!for_snapshot)
+        {
+            gPipeline.jitterProjection();
+        }
+
         if (LLPipeline::sRenderDeferred)
         {
             gPipeline.mRT->deferredScreen.bindTarget();
@@ -986,7 +997,9 @@ void display(bool rebuild, F32 zoom_factor, int subfield, bool for_snapshot)
             }
 
             gGL.setColorMask(true, true);
+            gGPUPassTimers.begin(LLGPUPassTimers::PASS_GEOMETRY);
             gPipeline.renderGeomDeferred(*LLViewerCamera::getInstance(), true);
+            gGPUPassTimers.end(LLGPUPassTimers::PASS_GEOMETRY);
         }
 
         {
@@ -1008,9 +1021,14 @@ void display(bool rebuild, F32 zoom_factor, int subfield, bool for_snapshot)
 
         if (LLPipeline::sRenderDeferred)
         {
+            gGPUPassTimers.begin(LLGPUPassTimers::PASS_LIGHTING);
             gPipeline.renderDeferredLighting();
+            gGPUPassTimers.end(LLGPUPassTimers::PASS_LIGHTING);
         }
 
+        // UI in the world is drawn at display resolution after the upscale
+        gPipeline.unjitterProjection();
+
         LLPipeline::sUnderWaterRender = false;
 
         {
@@ -1036,6 +1054,8 @@ void display(bool rebuild, F32 zoom_factor, int subfield, bool for_snapshot)
 
     display_stats();
 
+    gGPUPassTimers.update();
+
     LLAppViewer::instance()->pingMainloopTimeout("Display:Done");
 
     gShiftFrame = false;
@@ -1467,7 +1487,9 @@ void render_ui(F32 zoom_factor, int subfield)
     }
 
     // apply gamma correction and post effects
+    gGPUPassTimers.begin(LLGPUPassTimers::PASS_POST);
     gPipeline.renderFinalize();
+    gGPUPassTimers.end(LLGPUPassTimers::PASS_POST);
 
     {
         LLGLState::checkStates();
@@ -1528,7 +1550,13 @@ void swap()
     LL_PROFILE_GPU_ZONE("swap");
     if (gDisplaySwapBuffers)
     {
+        LLTimer swap_timer;
         gViewerWindow->getWindow()->swapBuffers();
+        gSwapBuffersTime = swap_timer.getElapsedTimeF32();
+    }
+    else
+    {
+        gSwapBuffersTime = 0.f;
     }
     gDisplaySwapBuffers = true;
 }
@@ -1702,10 +1730,19 @@ void render_ui_2d()
 
     if (LLPipeline::RenderUIBuffer)
     {
+        // Catch up with whatever changed without dirtying itself, e.g. a
+        // toast fading or a line editor's text set from code
+        static LLCachedControl<F32> refresh_interval(gSavedSettings, "RenderUIBufferRefreshInterval", 0.25f);
+        static LLFrameTimer refresh_timer;
+        if (refresh_interval() > 0.f && refresh_timer.getElapsedTimeF32() > refresh_interval())
+        {
+            refresh_timer.reset();
+            LLView::dirtyScreenRect(gViewerWindow->getWindowRectScaled());
+        }
+
         if (LLView::sIsRectDirty)
         {
             LLView::sIsRectDirty = false;
-            LLRect t_rect;
 
             gPipeline.mUIScreen.bindTarget();
             gGL.setColorMask(true, true);
@@ -1717,23 +1754,19 @@ void render_ui_2d()
                 LLView::sDirtyRect.mBottom -= pad;
                 LLView::sDirtyRect.mTop += pad;
 
-                LLGLEnable scissor(GL_SCISSOR_TEST);
                 static LLRect last_rect = LLView::sDirtyRect;
 
                 //union with last rect to avoid mouse poop
                 last_rect.unionWith(LLView::sDirtyRect);
 
-                t_rect = LLView::sDirtyRect;
+                LLRect t_rect = LLView::sDirtyRect;
                 LLView::sDirtyRect = last_rect;
                 last_rect = t_rect;
 
-                last_rect.mLeft = LLRect::tCoordType(last_rect.mLeft / LLUI::getScaleFactor().mV[0]);
-                last_rect.mRight = LLRect::tCoordType(last_rect.mRight / LLUI::getScaleFactor().mV[0]);
-                last_rect.mTop = LLRect::tCoordType(last_rect.mTop / LLUI::getScaleFactor().mV[1]);
-                last_rect.mBottom = LLRect::tCoordType(last_rect.mBottom / LLUI::getScaleFactor().mV[1]);
-
-                LLRect clip_rect(last_rect);
-
+                // Clear and redraw the dirty area only. Views overlapping it
+                // are clipped to it too, or their translucent parts would
+                // blend again over what the buffer retained.
+                LLScreenClipRect clip(LLView::sDirtyRect);
                 glClear(GL_COLOR_BUFFER_BIT);
 
                 gViewerWindow->draw();
@@ -1741,8 +1774,6 @@ void render_ui_2d()
 
             gPipeline.mUIScreen.flush();
             gGL.setColorMask(true, false);
-
-            LLView::sDirtyRect = t_rect;
         }
 
         LLGLDisable cull(GL_CULL_FACE);
@@ -33,6 +33,7 @@ void display_cleanup();
 void display(bool rebuild = true, F32 zoom_factor = 1.f, int subfield = 0, bool for_snapshot = false);
 
 extern bool gDisplaySwapBuffers;
+extern F32 gSwapBuffersTime; // seconds the last swap blocked, includes waiting for vsync
 extern bool gDepthDirty;
 extern bool gTeleportDisplay;
 extern LLFrameTimer gTeleportDisplayTimer;
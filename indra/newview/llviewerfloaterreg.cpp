@@ -76,6 +76,7 @@
 #include "llfloaterfixedenvironment.h"
 #include "llfloaterfonttest.h"
 #include "llfloaterforgetuser.h"
+#include "llfloaterframespikes.h"
 #include "llfloatergesture.h"
 #include "llfloatergltfasseteditor.h"
 #include "llfloatergodtools.h"
@@ -253,6 +254,7 @@ public:
                 "env_edit_extdaycycle",
                 "font_test",
                 "forget_username",
+                "frame_spikes",
                 "gltf_asset_editor",
                 "god_tools",
                 "group_picker",
@@ -379,6 +381,7 @@ void LLViewerFloaterReg::registerFloaters()
 
     LLFloaterReg::add("font_test", "floater_font_test.xml", (LLFloaterBuildFunc)&LLFloaterReg::build<LLFloaterFontTest>);
     LLFloaterReg::add("forget_username", "floater_forget_user.xml", (LLFloaterBuildFunc)&LLFloaterReg::build<LLFloaterForgetUser>);
+    LLFloaterReg::add("frame_spikes", "floater_frame_spikes.xml", (LLFloaterBuildFunc)&LLFloaterReg::build<LLFloaterFrameSpikes>);
 
     LLFloaterReg::add("gestures", "floater_gesture.xml", (LLFloaterBuildFunc)&LLFloaterReg::build<LLFloaterGesture>);
     LLFloaterReg::add("gltf_asset_editor", "floater_gltf_asset_editor.xml", (LLFloaterBuildFunc)&LLFloaterReg::build<LLFloaterGLTFAssetEditor>);
@@ -507,6 +507,11 @@ bool LLViewerInventoryItem::unpackMessage(const LLSD& item)
     return rv;
 }
 
+void LLViewerInventoryItem::localizeName()
+{
+    LLLocalizedInventoryItemsDictionary::getInstance()->localizeInventoryObjectName(mName);
+}
+
 // virtual
 bool LLViewerInventoryItem::unpackMessage(LLMessageSystem* msg, const char* block, S32 block_num)
 {
@@ -133,6 +133,9 @@ public:
     virtual bool unpackMessage(LLMessageSystem* msg, const char* block, S32 block_num = 0);
     virtual bool unpackMessage(const LLSD& item);
     virtual bool importLegacyStream(std::istream& input_stream);
+    // what unpackMessage() does to the name, for items unpacked off the
+    // main thread with LLInventoryItem::fromLLSD()
+    void localizeName();
 
     // new methods
     bool isFinished() const { return mIsComplete; }
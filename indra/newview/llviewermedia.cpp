@@ -708,6 +708,7 @@ void LLViewerMedia::updateMedia(void *dummy_arg)
             LLViewerMediaImpl* pimpl = *iter;
 
             LLPluginClassMedia::EPriority new_priority = LLPluginClassMedia::PRIORITY_NORMAL;
+            F32 target_frame_rate = 0.f; // every frame
 
             if(pimpl->isForcedUnloaded() || (impl_count_total >= (int)max_instances))
             {
@@ -780,6 +781,15 @@ void LLViewerMedia::updateMedia(void *dummy_arg)
 
                         pimpl->setLowPrioritySizeLimit(ll_round(approximate_interest_dimension));
                     }
+
+                    // And update its texture less often, the less of it shows on screen.
+                    // Full rate down to a quarter of the native area, as above.
+                    static LLCachedControl<F32> low_frame_rate(gSavedSettings, "PluginInstancesLowFrameRate", 15.f);
+                    if (low_frame_rate > 0.f)
+                    {
+                        F32 area_fraction = approximate_interest > 0.0 ? (F32)(pimpl->getInterest() * 4.0 / approximate_interest) : 0.f;
+                        target_frame_rate = llmax(low_frame_rate * llmin(area_fraction, 1.f), 1.f);
+                    }
                 }
                 else
                 {
@@ -788,6 +798,12 @@ void LLViewerMedia::updateMedia(void *dummy_arg)
                 }
             }
 
+            if (new_priority == LLPluginClassMedia::PRIORITY_SLIDESHOW)
+            {
+                // matches the sleep time of the plugin at that priority
+                target_frame_rate = 1.f;
+            }
+
             if(!pimpl->getUsedInUI() && (new_priority != LLPluginClassMedia::PRIORITY_UNLOADED))
             {
                 // This is a loadable inworld impl -- the last one in the list in this class defines the lowest loadable interest.
@@ -838,6 +854,7 @@ void LLViewerMedia::updateMedia(void *dummy_arg)
             }
 
             pimpl->setPriority(new_priority);
+            pimpl->setTargetFrameRate(target_frame_rate);
 
             if(pimpl->getUsedInUI())
             {
@@ -2892,8 +2909,16 @@ void LLViewerMediaImpl::update()
     S32 width;
     S32 height;
 
+    if (mTargetFrameRate > 0.f && mTextureUpdateTimer.getElapsedTimeF32() < 1.f / mTargetFrameRate)
+    {
+        // Not yet, see LLViewerMedia::updateMedia()
+        return;
+    }
+
     if (preMediaTexUpdate(media_tex, data, data_width, data_height, x_pos, y_pos, width, height))
     {
+        mTextureUpdateTimer.reset();
+
         // Push update to worker thread
         auto main_queue = LLImageGLThread::sEnabledMedia ? mMainQueue.lock() : nullptr;
         if (main_queue)
@@ -2994,8 +3019,10 @@ void LLViewerMediaImpl::doMediaTexUpdate(LLViewerMediaTexture* media_tex, U8* da
     LLGLuint tex_name = 0;
     media_tex->createGLTexture(0, raw, 0, true, LLGLTexture::OTHER, true, &tex_name);
 
-    // copy just the subimage covered by the image raw to GL
-    media_tex->setSubImage(data, data_width, data_height, x_pos, y_pos, width, height, tex_name);
+    // copy just the subimage covered by the image raw to GL, through the
+    // shared upload ring so that the copy out of the plugin's shared memory
+    // is the only one done on this thread
+    media_tex->getGLTexture()->setSubImageStreamed(data, data_width, data_height, x_pos, y_pos, width, height, tex_name);
 
     if (sync)
     {
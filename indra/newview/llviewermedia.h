@@ -380,6 +380,9 @@ public:
     LLPluginClassMedia::EPriority getPriority() { return mPriority; };
 
     void setLowPrioritySizeLimit(int size);
+    // Texture updates per second, 0 for every frame. Updates skipped in
+    // between are not lost, the dirty rect of the plugin keeps growing.
+    void setTargetFrameRate(F32 fps) { mTargetFrameRate = fps; }
 
     void setTextureID(LLUUID id = LLUUID::null);
 
@@ -453,6 +456,8 @@ private:
     S32 mTextureUsedHeight;
     bool mSuspendUpdates;
     bool mTextureUpdatePending = false;
+    F32 mTargetFrameRate = 0.f;
+    LLFrameTimer mTextureUpdateTimer;
     bool mVisible;
     ECursorType mLastSetCursor;
     EMediaNavState mMediaNavState;
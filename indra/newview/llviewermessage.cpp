@@ -106,6 +106,7 @@
 #include "llviewerwindow.h"
 #include "llvlmanager.h"
 #include "llvoavatarself.h"
+#include "llvocache.h"
 #include "llvovolume.h"
 #include "llworld.h"
 #include "pipeline.h"
@@ -2877,6 +2878,12 @@ void process_teleport_finish(LLMessageSystem* msg, void**)
 
     LLHost sim_host(sim_ip, sim_port);
 
+    if (LLVOCache::instanceExists())
+    {
+        // teleports by landmark, lure or home only learn the destination here
+        LLVOCache::getInstance()->prefetchAssets(region_handle);
+    }
+
     // Viewer trusts the simulator.
     gMessageSystem->enableCircuit(sim_host, true);
     LLViewerRegion* regionp =  LLWorld::getInstance()->addRegion(region_handle, sim_host);
@@ -106,7 +106,9 @@
 #include "llmeshrepository.h"
 #include "llgltfmateriallist.h"
 #include "llgl.h"
+#include "lltaskinventorycache.h"
 #include "gltf/asset.h"
+#include "workqueue.h"
 
 //#define DEBUG_UPDATE_TYPE
 
@@ -252,6 +254,7 @@ LLViewerObject::LLViewerObject(const LLUUID &id, const LLPCode pcode, LLViewerRe
     mLocalID(0),
     mTotalCRC(0),
     mListIndex(-1),
+    mLastIdleUpdateSecs(0.0),
     mTEImages(NULL),
     mTENormalMaps(NULL),
     mTESpecularMaps(NULL),
@@ -2993,8 +2996,16 @@ void LLViewerObject::fetchInventoryFromCapCoro(const LLUUID task_inv)
         std::string url = obj->mRegionp->getCapability("RequestTaskInventory") + "?task_id=" + obj->mID.asString();
         // If we already have a copy of the inventory then add it so the server won't re-send something we already have.
         // We expect this case to crop up in the case of failed inventory mutations, but it might happen otherwise as well.
+        // Failing that, what we got the last time we fetched it may still be current.
+        LLTaskInventoryCache::Entry cached;
+        bool sent_cached_serial = false;
         if (obj->mInventorySerialNum && obj->mInventory)
             url += "&inventory_serial=" + std::to_string(obj->mInventorySerialNum);
+        else if (LLTaskInventoryCache::instance().get(task_inv, cached) && cached.mSerial)
+        {
+            url += "&inventory_serial=" + std::to_string(cached.mSerial);
+            sent_cached_serial = true;
+        }
 
         obj->mInvRequestState = INVENTORY_XFER;
         LLSD result = httpAdapter->getAndSuspend(httpRequest, url);
@@ -3026,7 +3037,29 @@ void LLViewerObject::fetchInventoryFromCapCoro(const LLUUID task_inv)
             LL_INFOS() << "Inventory loaded for " << task_inv << LL_ENDL;
             obj->mInventorySerialNum = serial;
             obj->mExpectedInventorySerialNum = serial;
-            obj->loadTaskInvLLSD(result);
+            if (result.has("contents"))
+            {
+                LLSD entry;
+                entry["contents"] = result["contents"];
+                std::ostringstream ostr;
+                LLSDSerialize::toBinary(entry, ostr);
+                // Re-requests once loaded if stale
+                loadTaskInvAsync(task_inv, serial, ostr.str(), std::string(), true, potentially_stale);
+                potentially_stale = false;
+            }
+            else
+            {
+                LL_WARNS() << "unable to load task inventory: " << result << LL_ENDL;
+            }
+        }
+        else if (status.getType() == 304 && sent_cached_serial && !obj->mInventory)
+        {
+            LL_INFOS() << "Inventory wasn't changed on server, loading cached copy" << LL_ENDL;
+            potentially_stale = cached.mSerial < obj->mExpectedInventorySerialNum;
+            obj->mInventorySerialNum = cached.mSerial;
+            obj->mExpectedInventorySerialNum = cached.mSerial;
+            loadTaskInvAsync(task_inv, cached.mSerial, cached.mData, std::string(), false, potentially_stale);
+            potentially_stale = false;
         }
         else if (status.getType() == 304)
         {
@@ -3301,6 +3334,22 @@ void LLViewerObject::processTaskInv(LLMessageSystem* msg, void** user_data)
             delete ft;
             return;
         }
+        LLTaskInventoryCache::Entry cached;
+        if (LLTaskInventoryCache::instance().get(task_id, cached) && cached.mSerial == serial)
+        {
+            // Unchanged since we last got it, skip the xfer
+            LL_DEBUGS() << "Task inventory serial " << serial << " of " << task_id << " is cached" << LL_ENDL;
+            if (object->mInvRequestState == INVENTORY_XFER && object->mInvRequestXFerId)
+            {
+                gXferManager->abortRequestById(object->mInvRequestXFerId, -1);
+            }
+            object->mInvRequestState = INVENTORY_XFER;
+            object->mInvRequestXFerId = 0;
+            loadTaskInvAsync(task_id, serial, cached.mData, std::string(), false, false);
+            delete ft;
+            return;
+        }
+
         U64 new_id = gXferManager->requestFile(gDirUtilp->getExpandedFilename(LL_PATH_CACHE, ft->mFilename),
             ft->mFilename, LL_PATH_CACHE,
             object->mRegionp->getHost(),
@@ -3343,33 +3392,7 @@ void LLViewerObject::processTaskInvFile(void** user_data, S32 error_code, LLExtS
             LL_DEBUGS() << "Processing file that is potentially out of date for task: " << ft->mTaskID << LL_ENDL;
         }
 
-        if (object->loadTaskInvFile(ft->mFilename))
-        {
-
-            LLInventoryObject::object_list_t::iterator it = object->mInventory->begin();
-            LLInventoryObject::object_list_t::iterator end = object->mInventory->end();
-            std::list<LLUUID>& pending_lst = object->mPendingInventoryItemsIDs;
-
-            for (; it != end && pending_lst.size(); ++it)
-            {
-                LLViewerInventoryItem* item = dynamic_cast<LLViewerInventoryItem*>(it->get());
-                if(item && item->getType() != LLAssetType::AT_CATEGORY)
-                {
-                    std::list<LLUUID>::iterator id_it = std::find(pending_lst.begin(), pending_lst.begin(), item->getAssetUUID());
-                    if (id_it != pending_lst.end())
-                    {
-                        pending_lst.erase(id_it);
-                    }
-                }
-            }
-        }
-        else
-        {
-            // MAINT-2597 - crash when trying to edit a no-mod object
-            // Somehow get an contents inventory response, but with an invalid stream (possibly 0 size?)
-            // Stated repro was specific to no-mod objects so failing without user interaction should be safe.
-            LL_WARNS() << "Trying to load invalid task inventory file. Ignoring file contents." << LL_ENDL;
-        }
+        loadTaskInvAsync(ft->mTaskID, ft->mSerial, std::string(), ft->mFilename, true, false);
     }
     else
     {
@@ -3381,51 +3404,74 @@ void LLViewerObject::processTaskInvFile(void** user_data, S32 error_code, LLExtS
     delete ft;
 }
 
-bool LLViewerObject::loadTaskInvFile(const std::string& filename)
+namespace
 {
-    std::string filename_and_local_path = gDirUtilp->getExpandedFilename(LL_PATH_CACHE, filename);
-    llifstream ifs(filename_and_local_path.c_str());
-    if(ifs.good())
+    // Runs on the general queue: everything it builds is only seen by that
+    // thread until the callback hands it over.
+    bool parse_task_inventory(const LLUUID& task_id, const LLSD& entry, LLInventoryObject::object_list_t& inventory)
     {
-        U32 fail_count = 0;
-        char buffer[MAX_STRING];    /* Flawfinder: ignore */
-        // *NOTE: This buffer size is hard coded into scanf() below.
-        char keyword[MAX_STRING];   /* Flawfinder: ignore */
-        if(mInventory)
+        if (entry.has("contents"))
         {
-            mInventory->clear(); // will deref and delete it
+            // Synthesize the "Contents" category, the viewer expects it, but it isn't sent.
+            LLPointer<LLInventoryObject> inv = new LLInventoryObject(task_id, LLUUID::null, LLAssetType::AT_CATEGORY, "Contents");
+            inventory.push_front(inv);
+
+            const LLSD& contents = entry["contents"];
+            for (const auto& inv_entry : llsd::inArray(contents))
+            {
+                if (inv_entry.has("item_id"))
+                {
+                    // unpackMessage() would localize the name, which is left to the main thread
+                    LLPointer<LLViewerInventoryItem> item = new LLViewerInventoryItem;
+                    item->LLInventoryItem::fromLLSD(inv_entry);
+                    item->setComplete(true);
+                    inventory.push_front(item);
+                }
+                else
+                {
+                    LL_WARNS_ONCE() << "Unknown inventory entry while reading from inventory file. Entry: '"
+                                    << inv_entry << "'" << LL_ENDL;
+                }
+            }
+            return true;
         }
-        else
+
+        if (!entry.has("legacy"))
         {
-            mInventory = new LLInventoryObject::object_list_t;
+            return false;
         }
+
+        std::istringstream ifs(entry["legacy"].asString());
+        U32 fail_count = 0;
+        char buffer[MAX_STRING];    /* Flawfinder: ignore */
+        // *NOTE: This buffer size is hard coded into scanf() below.
+        char keyword[MAX_STRING];   /* Flawfinder: ignore */
         while(ifs.good())
         {
             ifs.getline(buffer, MAX_STRING);
             if (sscanf(buffer, " %254s", keyword) == EOF) /* Flawfinder: ignore */
             {
                 // Blank file?
-                LL_WARNS() << "Issue reading from file '"
-                        << filename << "'" << LL_ENDL;
+                LL_WARNS() << "Issue reading task inventory of " << task_id << LL_ENDL;
                 break;
             }
             else if(0 == strcmp("inv_item", keyword))
             {
                 LLPointer<LLInventoryObject> inv = new LLViewerInventoryItem;
                 inv->importLegacyStream(ifs);
-                mInventory->push_front(inv);
+                inventory.push_front(inv);
             }
             else if(0 == strcmp("inv_object", keyword))
             {
                 LLPointer<LLInventoryObject> inv = new LLInventoryObject;
                 inv->importLegacyStream(ifs);
                 inv->rename("Contents");
-                mInventory->push_front(inv);
+                inventory.push_front(inv);
             }
             else if (fail_count >= MAX_INV_FILE_READ_FAILS)
             {
-                LL_WARNS() << "Encountered too many unknowns while reading from file: '"
-                        << filename << "'" << LL_ENDL;
+                LL_WARNS() << "Encountered too many unknowns while reading task inventory of "
+                        << task_id << LL_ENDL;
                 break;
             }
             else
@@ -3436,58 +3482,153 @@ bool LLViewerObject::loadTaskInvFile(const std::string& filename)
                         << keyword << "'" << LL_ENDL;
             }
         }
-        ifs.close();
-        LLFile::remove(filename_and_local_path);
-    }
-    else
-    {
-        LL_WARNS() << "unable to load task inventory: " << filename_and_local_path
-                << LL_ENDL;
-        return false;
+        return true;
     }
-    doInventoryCallback();
 
-    return true;
+    struct LoadedTaskInventory
+    {
+        LLTaskInventoryCache::Entry mEntry;
+        LLInventoryObject::object_list_t mInventory;
+        bool mLocalize = false;
+        bool mLoaded = false;
+    };
 }
 
-void LLViewerObject::loadTaskInvLLSD(const LLSD& inv_result)
+//static
+void LLViewerObject::loadTaskInvAsync(const LLUUID& task_id, S16 serial, const std::string& data,
+                                      const std::string& filename, bool store, bool potentially_stale)
 {
-    if (inv_result.has("contents"))
+    std::shared_ptr<LoadedTaskInventory> loaded = std::make_shared<LoadedTaskInventory>();
+    loaded->mEntry.mSerial = serial;
+    loaded->mEntry.mData = data;
+
+    auto load = [loaded, task_id, filename, store]()
     {
-        if(mInventory)
+        if (!filename.empty())
+        {
+            std::string filename_and_local_path = gDirUtilp->getExpandedFilename(LL_PATH_CACHE, filename);
+            llifstream ifs(filename_and_local_path.c_str(), std::ios::binary);
+            if (!ifs.good())
+            {
+                LL_WARNS() << "unable to load task inventory: " << filename_and_local_path << LL_ENDL;
+                return;
+            }
+            std::ostringstream text;
+            text << ifs.rdbuf();
+            ifs.close();
+            LLFile::remove(filename_and_local_path);
+
+            LLSD entry;
+            entry["legacy"] = text.str();
+            std::ostringstream ostr;
+            LLSDSerialize::toBinary(entry, ostr);
+            loaded->mEntry.mData = ostr.str();
+        }
+
+        LLSD entry;
+        std::istringstream istr(loaded->mEntry.mData);
+        if (LLSDSerialize::fromBinary(entry, istr, loaded->mEntry.mData.size()) <= 0)
         {
-            mInventory->clear(); // will deref and delete it
+            LL_WARNS() << "unable to decode task inventory of " << task_id << LL_ENDL;
+            return;
         }
-        else
+        loaded->mLocalize = entry.has("contents");
+        loaded->mLoaded = parse_task_inventory(task_id, entry, loaded->mInventory);
+        if (loaded->mLoaded && store)
         {
-            mInventory = new LLInventoryObject::object_list_t;
+            LLTaskInventoryCache::write(task_id, loaded->mEntry);
         }
+    };
 
-        // Synthesize the "Contents" category, the viewer expects it, but it isn't sent.
-        LLPointer<LLInventoryObject> inv = new LLInventoryObject(mID, LLUUID::null, LLAssetType::AT_CATEGORY, "Contents");
-        mInventory->push_front(inv);
+    auto apply = [loaded, task_id, store, potentially_stale]()
+    {
+        if (loaded->mLoaded && store)
+        {
+            LLTaskInventoryCache::instance().put(task_id, loaded->mEntry);
+        }
 
-        const LLSD& inventory = inv_result["contents"];
-        for (const auto& inv_entry : llsd::inArray(inventory))
+        LLViewerObject* object = gObjectList.findObject(task_id);
+        if (!object || object->isDead())
         {
-            if (inv_entry.has("item_id"))
-            {
-                LLPointer<LLViewerInventoryItem> inv = new LLViewerInventoryItem;
-                inv->unpackMessage(inv_entry);
-                mInventory->push_front(inv);
-            }
-            else
-            {
-                LL_WARNS_ONCE() << "Unknown inventory entry while reading from inventory file. Entry: '"
-                                << inv_entry << "'" << LL_ENDL;
-            }
+            loaded->mInventory.clear();
+            return;
+        }
+        if (object->mInventorySerialNum != loaded->mEntry.mSerial)
+        {
+            // A newer inventory is on its way
+            LL_DEBUGS() << "Dropping task inventory serial " << loaded->mEntry.mSerial << " for " << task_id
+                        << ", expecting " << object->mInventorySerialNum << LL_ENDL;
+            loaded->mInventory.clear();
+            return;
+        }
+        if (!loaded->mLoaded)
+        {
+            // MAINT-2597 - crash when trying to edit a no-mod object
+            // Somehow get an contents inventory response, but with an invalid stream (possibly 0 size?)
+            // Stated repro was specific to no-mod objects so failing without user interaction should be safe.
+            LL_WARNS() << "Trying to load invalid task inventory. Ignoring contents." << LL_ENDL;
+            object->mInvRequestState = INVENTORY_REQUEST_STOPPED;
+            object->mInvRequestXFerId = 0;
+            return;
+        }
+
+        object->applyTaskInv(loaded->mInventory, loaded->mLocalize);
+
+        if (potentially_stale)
+        {
+            // Stale? I guess we can use what we got for now, but we'll have to re-request
+            LL_WARNS() << "Stale inv_serial? Re-requesting." << LL_ENDL;
+            object->fetchInventoryDelayed(INVENTORY_UPDATE_WAIT_TIME_OUTDATED);
         }
+    };
+
+    LL::WorkQueue::ptr_t main_queue = LL::WorkQueue::getInstance("mainloop");
+    LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+    bool posted = main_queue && general_queue && main_queue->postTo(general_queue, load, apply);
+    if (!posted)
+    {
+        // Queues are gone or shutting down, do it here
+        load();
+        apply();
+    }
+}
+
+void LLViewerObject::applyTaskInv(LLInventoryObject::object_list_t& inventory, bool localize)
+{
+    if(mInventory)
+    {
+        mInventory->clear(); // will deref and delete it
     }
     else
     {
-        LL_WARNS() << "unable to load task inventory: " << inv_result << LL_ENDL;
-        return;
+        mInventory = new LLInventoryObject::object_list_t;
     }
+    mInventory->swap(inventory);
+
+    for (LLPointer<LLInventoryObject>& obj : *mInventory)
+    {
+        LLViewerInventoryItem* item = dynamic_cast<LLViewerInventoryItem*>(obj.get());
+        if (!item)
+        {
+            continue;
+        }
+        if (localize)
+        {
+            item->localizeName();
+        }
+
+        // The simulator has these now
+        std::list<LLUUID>& pending_lst = mPendingInventoryItemsIDs;
+        if (!pending_lst.empty() && item->getType() != LLAssetType::AT_CATEGORY)
+        {
+            std::list<LLUUID>::iterator id_it = std::find(pending_lst.begin(), pending_lst.end(), item->getAssetUUID());
+            if (id_it != pending_lst.end())
+            {
+                pending_lst.erase(id_it);
+            }
+        }
+    }
+
     doInventoryCallback();
 }
 
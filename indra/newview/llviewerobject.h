@@ -45,6 +45,7 @@
 #include "llvertexbuffer.h"
 #include "llbbox.h"
 #include "llrigginginfo.h"
+#include "llheap.h"
 #include "llreflectionmap.h"
 
 namespace LL
@@ -135,6 +136,9 @@ protected:
     std::unordered_map<U16, ExtraParameter*> mExtraParameterList;
 
 public:
+    // objects come and go by the thousands on region entry and teleports
+    LL_HEAP_OPERATORS(LLHeap::HEAP_SCENE)
+
     typedef std::list<LLPointer<LLViewerObject> > child_list_t;
     typedef std::list<LLPointer<LLViewerObject> > vobj_list_t;
 
@@ -728,6 +732,9 @@ public:
     // index into LLViewerObjectList::mActiveObjects or -1 if not in list
     S32             mListIndex;
 
+    // frame time of the last idleUpdate, distant and hidden objects are updated less often
+    F64             mLastIdleUpdateSecs;
+
     LLPointer<LLViewerTexture> *mTEImages;
     LLPointer<LLViewerTexture> *mTENormalMaps;
     LLPointer<LLViewerTexture> *mTESpecularMaps;
@@ -822,8 +829,13 @@ protected:
     //
 
     static void processTaskInvFile(void** user_data, S32 error_code, LLExtStat ext_status);
-    bool loadTaskInvFile(const std::string& filename);
-    void loadTaskInvLLSD(const LLSD &inv_result);
+    // Parses a task inventory, as LLTaskInventoryCache keeps it, on the
+    // general queue, or the file xfer left at filename if not empty, and
+    // hands it to the object if it still expects that serial. If store
+    // it goes in the cache as well.
+    static void loadTaskInvAsync(const LLUUID& task_id, S16 serial, const std::string& data,
+                                 const std::string& filename, bool store, bool potentially_stale);
+    void applyTaskInv(LLInventoryObject::object_list_t& inventory, bool localize);
     void doInventoryCallback();
 
     bool isOnMap();
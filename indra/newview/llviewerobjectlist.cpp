@@ -227,6 +227,35 @@ void LLViewerObjectList::setUUIDAndLocal(const LLUUID &id,
 S32 gFullObjectUpdates = 0;
 S32 gTerseObjectUpdates = 0;
 
+// One block of an ObjectUpdateCompressed message, copied out of the message with its header unpacked.
+// Decoding it reads nothing but the block, the objects and regions are only touched when it is applied.
+struct LLCompressedObjectBlock
+{
+    U8      mData[2048];
+    S32     mSize = 0;
+    S32     mHeaderSize = 0;    // where processUpdateCore and the object cache continue reading
+    U32     mFlags = 0;
+    U32     mLocalID = 0;
+    LLUUID  mFullID;            // null for terse updates, they only carry the local id
+    LLPCode mPCode = 0;
+};
+
+static void decode_compressed_block(LLCompressedObjectBlock& block, const EObjectUpdateType update_type)
+{
+    LLDataPackerBinaryBuffer dp(block.mData, block.mSize);
+    if (update_type != OUT_TERSE_IMPROVED) // OUT_FULL_COMPRESSED only?
+    {
+        dp.unpackUUID(block.mFullID, "ID");
+        dp.unpackU32(block.mLocalID, "LocalID");
+        dp.unpackU8(block.mPCode, "PCode");
+    }
+    else
+    {
+        dp.unpackU32(block.mLocalID, "LocalID");
+    }
+    block.mHeaderSize = dp.getCurrentSize();
+}
+
 void LLViewerObjectList::processUpdateCore(LLViewerObject* objectp,
                                            void** user_data,
                                            U32 i,
@@ -461,6 +490,30 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
         return;
     }
 
+    // Decode every compressed block before applying any of them, the decode stage
+    // only produces LLCompressedObjectBlocks
+    std::vector<LLCompressedObjectBlock> compressed_blocks;
+    if (compressed && num_objects > 0)
+    {
+        LLTimer decode_timer;
+        compressed_blocks.resize(num_objects);
+        for (i = 0; i < num_objects; i++)
+        {
+            LLCompressedObjectBlock& block = compressed_blocks[i];
+            block.mSize = llmin(mesgsys->getSizeFast(_PREHASH_ObjectData, i, _PREHASH_Data), (S32)sizeof(block.mData));
+            LL_DEBUGS("ObjectUpdate") << "got binary data from message to compressed block" << LL_ENDL;
+            mesgsys->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_Data, block.mData, 0, i, sizeof(block.mData));
+            if (update_type != OUT_TERSE_IMPROVED)
+            {
+                mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_UpdateFlags, block.mFlags, i);
+            }
+
+            decode_compressed_block(block, update_type);
+        }
+        record(LLStatViewer::OBJECT_UPDATE_DECODE_TIME, F64Seconds(decode_timer.getElapsedTimeF64()));
+    }
+
+    // the packer keeps reading from one buffer, assigning it another one would delete the old one
     U8 compressed_dpbuffer[2048];
     LLDataPackerBinaryBuffer compressed_dp(compressed_dpbuffer, 2048);
     LLViewerStatsRecorder& recorder = LLViewerStatsRecorder::instance();
@@ -472,21 +525,17 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 
         if (compressed)
         {
-            compressed_dp.reset();
-
-            S32 uncompressed_length = mesgsys->getSizeFast(_PREHASH_ObjectData, i, _PREHASH_Data);
-            LL_DEBUGS("ObjectUpdate") << "got binary data from message to compressed_dpbuffer" << LL_ENDL;
-            mesgsys->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_Data, compressed_dpbuffer, 0, i, 2048);
-            compressed_dp.assignBuffer(compressed_dpbuffer, uncompressed_length);
+            LLCompressedObjectBlock& block = compressed_blocks[i];
+            memcpy(compressed_dpbuffer, block.mData, block.mSize);    /* Flawfinder: ignore */
+            compressed_dp.assignBuffer(compressed_dpbuffer, block.mSize);
+            compressed_dp.shift(block.mHeaderSize);
+            local_id = block.mLocalID;
 
             if (update_type != OUT_TERSE_IMPROVED) // OUT_FULL_COMPRESSED only?
             {
-                U32 flags = 0;
-                mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_UpdateFlags, flags, i);
-
-                compressed_dp.unpackUUID(fullid, "ID");
-                compressed_dp.unpackU32(local_id, "LocalID");
-                compressed_dp.unpackU8(pcode, "PCode");
+                U32 flags = block.mFlags;
+                fullid = block.mFullID;
+                pcode = block.mPCode;
 
                 if (pcode == 0)
                 {
@@ -509,7 +558,6 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
             else //OUT_TERSE_IMPROVED
             {
                 update_cache = true;
-                compressed_dp.unpackU32(local_id, "LocalID");
                 getUUIDFromLocal(fullid,
                                  local_id,
                                  gMessageSystem->getSenderIP(),
@@ -726,6 +774,13 @@ void LLViewerObjectList::processCachedObjectUpdate(LLMessageSystem *mesgsys,
 
         LL_DEBUGS("ObjectUpdate") << "got probe for id " << id << " crc " << crc << LL_ENDL;
 
+        if (regionp->isCacheLoading())
+        {
+            // probed once the cache file is in
+            regionp->deferCacheProbe(id, crc, flags);
+            continue;
+        }
+
         // Lookup data packer and add this id to cache miss lists if necessary.
         U8 cache_miss_type = LLViewerRegion::CACHE_MISS_TYPE_NONE;
         if (regionp->probeCache(id, crc, flags, cache_miss_type))
@@ -831,17 +886,66 @@ void LLViewerObjectList::updateApparentAngles(LLAgent &agent)
     LLVOAvatar::cullAvatarsByPixelArea();
 }
 
+// Interest tiers of the moving objects: a linkset root that was not drawn in the
+// last frames (off screen or occluded) is interpolated and moved only every
+// ObjectInterestHiddenInterval seconds, a visible one beyond
+// ObjectInterestFarDistance every ObjectInterestFarInterval. Interpolation
+// steps from the time of its last update, so a skipped frame only delays
+// where the object is drawn. Returns 0 for objects updated every frame.
+static F64 get_idle_update_interval(LLViewerObject* objectp, const LLVector3& camera_origin)
+{
+    static LLCachedControl<F32> near_distance(gSavedSettings, "ObjectInterestNearDistance", 16.f);
+    static LLCachedControl<F32> far_distance(gSavedSettings, "ObjectInterestFarDistance", 64.f);
+    static LLCachedControl<F32> far_interval(gSavedSettings, "ObjectInterestFarInterval", 0.1f);
+    static LLCachedControl<F32> hidden_interval(gSavedSettings, "ObjectInterestHiddenInterval", 0.25f);
+
+    // children and sitting avatars follow their root, selections follow the mouse
+    if (objectp->isAvatar() || objectp->getParent() || objectp->mDrawable.isNull() || objectp->isSelected()
+        || (isAgentAvatarValid() && gAgentAvatarp->getRoot() == objectp))
+    {
+        return 0.0;
+    }
+
+    // near objects may still cast shadows into view
+    F32 distance2 = dist_vec_squared(objectp->getPositionAgent(), camera_origin);
+    if (distance2 < near_distance * near_distance)
+    {
+        return 0.0;
+    }
+
+    F64 interval = 0.0;
+    if (!objectp->mDrawable->isRecentlyVisible())
+    {
+        interval = hidden_interval;
+    }
+    else if (distance2 > far_distance * far_distance)
+    {
+        interval = far_interval;
+    }
+
+    // spread objects that entered a tier in the same frame over a few frames
+    return interval * (1.0 + (objectp->getLocalID() & 7) * 0.0625);
+}
+
 void LLViewerObjectList::update(LLAgent &agent)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK;
 
+    static LLCachedControl<bool> velocity_interpolate(gSavedSettings, "VelocityInterpolate");
+    static LLCachedControl<bool> ping_interpolate(gSavedSettings, "PingInterpolate");
+    static LLCachedControl<F32> interpolation_time(gSavedSettings, "InterpolationTime");
+    static LLCachedControl<F32> interpolation_phase_out(gSavedSettings, "InterpolationPhaseOut");
+    static LLCachedControl<F32> region_crossing_interpolation_time(gSavedSettings, "RegionCrossingInterpolationTime");
+    static LLCachedControl<bool> animate_textures(gSavedSettings, "AnimateTextures");
+    static LLCachedControl<bool> freeze_time(gSavedSettings, "FreezeTime");
+
     // Update globals
-    LLViewerObject::setVelocityInterpolate( gSavedSettings.getBOOL("VelocityInterpolate") );
-    LLViewerObject::setPingInterpolate( gSavedSettings.getBOOL("PingInterpolate") );
+    LLViewerObject::setVelocityInterpolate(velocity_interpolate);
+    LLViewerObject::setPingInterpolate(ping_interpolate);
 
-    F32 interp_time = gSavedSettings.getF32("InterpolationTime");
-    F32 phase_out_time = gSavedSettings.getF32("InterpolationPhaseOut");
-    F32 region_interp_time = llclamp(gSavedSettings.getF32("RegionCrossingInterpolationTime"), 0.5f, 5.f);
+    F32 interp_time = interpolation_time;
+    F32 phase_out_time = interpolation_phase_out;
+    F32 region_interp_time = llclamp((F32)region_crossing_interpolation_time, 0.5f, 5.f);
     if (interp_time < 0.0 ||
         phase_out_time < 0.0 ||
         phase_out_time > interp_time)
@@ -854,7 +958,7 @@ void LLViewerObjectList::update(LLAgent &agent)
     LLViewerObject::setMaxUpdateInterpolationTime( phase_out_time );
     LLViewerObject::setMaxRegionCrossingInterpolationTime(region_interp_time);
 
-    gAnimateTextures = gSavedSettings.getBOOL("AnimateTextures");
+    gAnimateTextures = animate_textures;
 
     // update global timer
     F32 last_time = gFrameTimeSeconds;
@@ -917,7 +1021,11 @@ void LLViewerObjectList::update(LLAgent &agent)
 
     std::vector<LLViewerObject*>::iterator idle_end = idle_list.begin()+idle_count;
 
-    if (gSavedSettings.getBOOL("FreezeTime"))
+    // avatars leave their motion and joint updates for updateDeferredCharacters, which runs them all at once
+    static LLCachedControl<bool> parallel_avatars(gSavedSettings, "AvatarParallelUpdate", false);
+    LLVOAvatar::sDeferCharacterMotion = parallel_avatars && gPipeline.mCullPool;
+
+    if (freeze_time)
     {
 
         for (std::vector<LLViewerObject*>::iterator iter = idle_list.begin();
@@ -929,17 +1037,34 @@ void LLViewerObjectList::update(LLAgent &agent)
                 objectp->idleUpdate(agent, frame_time);
             }
         }
+
+        LLVOAvatar::updateDeferredCharacters(agent, frame_time);
     }
     else
     {
+        static LLCachedControl<bool> interest_tiers(gSavedSettings, "ObjectInterestTiers", true);
+        const LLVector3 camera_origin = LLViewerCamera::getInstance()->getOrigin();
+
         for (std::vector<LLViewerObject*>::iterator idle_iter = idle_list.begin();
             idle_iter != idle_end; idle_iter++)
         {
             objectp = *idle_iter;
             llassert(objectp->isActive());
-                objectp->idleUpdate(agent, frame_time);
+            if (interest_tiers)
+            {
+                F64 interval = get_idle_update_interval(objectp, camera_origin);
+                if (interval > 0.0 && frame_time - objectp->mLastIdleUpdateSecs < interval)
+                {
+                    continue;
+                }
+            }
+            objectp->mLastIdleUpdateSecs = frame_time;
+            objectp->idleUpdate(agent, frame_time);
         }
 
+        // attachments and flexible objects follow the joints
+        LLVOAvatar::updateDeferredCharacters(agent, frame_time);
+
         //update flexible objects
         LLVolumeImplFlexible::updateClass();
 
@@ -1090,7 +1215,9 @@ void LLViewerObjectList::fetchObjectCostsCoro(std::string url)
 
     postData["object_ids"] = idList;
 
-    LLSD result = httpAdapter->postAndSuspend(httpRequest, url, postData);
+    LLSD result = httpAdapter->postAsync(httpRequest, url, postData,
+        LLCore::HttpOptions::ptr_t(new LLCore::HttpOptions()), LLCore::HttpHeaders::ptr_t(new LLCore::HttpHeaders()),
+        gAgent.getRegionHttpScope()).get();
 
     LLSD httpResults = result[LLCoreHttpUtil::HttpCoroutineAdapter::HTTP_RESULTS];
     LLCore::HttpStatus status = LLCoreHttpUtil::HttpCoroutineAdapter::getStatusFromLLSD(httpResults);
@@ -1216,7 +1343,9 @@ void LLViewerObjectList::fetchPhisicsFlagsCoro(std::string url)
 
     postData["object_ids"] = idList;
 
-    LLSD result = httpAdapter->postAndSuspend(httpRequest, url, postData);
+    LLSD result = httpAdapter->postAsync(httpRequest, url, postData,
+        LLCore::HttpOptions::ptr_t(new LLCore::HttpOptions()), LLCore::HttpHeaders::ptr_t(new LLCore::HttpHeaders()),
+        gAgent.getRegionHttpScope()).get();
 
     LLSD httpResults = result[LLCoreHttpUtil::HttpCoroutineAdapter::HTTP_RESULTS];
     LLCore::HttpStatus status = LLCoreHttpUtil::HttpCoroutineAdapter::getStatusFromLLSD(httpResults);
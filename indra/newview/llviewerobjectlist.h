@@ -33,6 +33,7 @@
 // common includes
 #include "llstring.h"
 #include "lltrace.h"
+#include "lluuidhashmap.h"
 
 // project includes
 #include "llviewerobject.h"
@@ -201,9 +202,9 @@ protected:
 
     vobj_list_t mMapObjects;
 
-    uuid_set_t   mDeadObjects;
+    LLUUIDHashSet mDeadObjects;
 
-    std::map<LLUUID, LLPointer<LLViewerObject> > mUUIDObjectMap;
+    LLUUIDHashMap<LLPointer<LLViewerObject> > mUUIDObjectMap;
 
     //set of objects that need to update their cost
     uuid_set_t   mStaleObjectCost;
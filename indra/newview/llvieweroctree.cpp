@@ -1136,13 +1136,15 @@ void LLOcclusionCullingGroup::checkOcclusion()
             }
 
             static LLCachedControl<U32> occlusion_timeout(gSavedSettings, "RenderOcclusionTimeout", 4);
+            static LLCachedControl<U32> occlusion_max_latency(gSavedSettings, "RenderOcclusionMaxLatency", 3);
 
-            if (available || mOcclusionCheckCount[LLViewerCamera::sCurCameraID] > occlusion_timeout)
+            if (available)
             {
                 mOcclusionCheckCount[LLViewerCamera::sCurCameraID] = 0;
                 GLuint query_result;    // Will be # samples drawn, or a boolean depending on mHasOcclusionQuery2 (both are type GLuint)
                 {
                     LL_PROFILE_ZONE_NAMED_CATEGORY_OCTREE("co - query result");
+                    // the result is available, this does not wait
                     glGetQueryObjectuiv(mOcclusionQuery[LLViewerCamera::sCurCameraID], GL_QUERY_RESULT, &query_result);
                 }
 #if LL_TRACK_PENDING_OCCLUSION_QUERIES
@@ -1153,12 +1155,23 @@ void LLOcclusionCullingGroup::checkOcclusion()
                 {
                     clearOcclusionState(LLOcclusionCullingGroup::OCCLUDED, LLOcclusionCullingGroup::STATE_MODE_DIFF);
                 }
-                else
+                else if (gFrameCount - mOcclusionIssued[LLViewerCamera::sCurCameraID] <= occlusion_max_latency)
                 {
                     setOcclusionState(LLOcclusionCullingGroup::OCCLUDED, LLOcclusionCullingGroup::STATE_MODE_DIFF);
                 }
+                // else the box was tested against a camera that has likely
+                // moved on since, keep the group as it is rather than pop it
+                // out of view, the next query decides
                 clearOcclusionState(QUERY_PENDING);
             }
+            else if (mOcclusionCheckCount[LLViewerCamera::sCurCameraID] > occlusion_timeout)
+            {
+                // Waiting on the result would stall the pipeline. Give up on
+                // it, draw the group and issue a fresh query instead.
+                mOcclusionCheckCount[LLViewerCamera::sCurCameraID] = 0;
+                clearOcclusionState(LLOcclusionCullingGroup::OCCLUDED, LLOcclusionCullingGroup::STATE_MODE_DIFF);
+                setOcclusionState(DISCARD_QUERY);
+            }
         }
     }
     else if (mSpatialPartition->isOcclusionEnabled() && isOcclusionState(LLOcclusionCullingGroup::OCCLUDED))
@@ -1330,6 +1343,42 @@ bool LLViewerOctreePartition::isOcclusionEnabled()
 }
 
 
+//-----------------------------------------------------------------------------------
+//class LLViewerOctreeFlat definitions
+//-----------------------------------------------------------------------------------
+
+void LLViewerOctreeFlat::build(const OctreeNode* root)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_OCTREE;
+    clear();
+    if (!root)
+    {
+        return;
+    }
+
+    mNodes.push_back({ root, (LLViewerOctreeGroup*) root->getListener(0), 0, 0 });
+    // the array grows as we go: each node's children are appended together
+    for (U32 i = 0; i < mNodes.size(); i++)
+    {
+        const OctreeNode* node = mNodes[i].mNode;
+        mNodes[i].mFirstChild = (U32)mNodes.size();
+        mNodes[i].mChildCount = node->getChildCount();
+        for (U32 j = 0; j < node->getChildCount(); j++)
+        {
+            const OctreeNode* child = node->getChild(j);
+            mNodes.push_back({ child, (LLViewerOctreeGroup*) child->getListener(0), 0, 0 });
+        }
+    }
+
+    mBounds.reserve(mNodes.size() * 2);
+    for (const Node& node : mNodes)
+    {
+        const LLVector4a* bounds = node.mGroup->getBounds();
+        mBounds.push_back(bounds[0]);
+        mBounds.push_back(bounds[1]);
+    }
+}
+
 //-----------------------------------------------------------------------------------
 //class LLViewerOctreeCull definitions
 //-----------------------------------------------------------------------------------
@@ -1344,6 +1393,8 @@ bool LLViewerOctreeCull::earlyFail(LLViewerOctreeGroup* group)
 void LLViewerOctreeCull::traverse(const OctreeNode* n)
 {
     LLViewerOctreeGroup* group = (LLViewerOctreeGroup*) n->getListener(0);
+    S32 checked = mCheckedRes;
+    mCheckedRes = -1;
 
     if (earlyFail(group))
     {
@@ -1357,17 +1408,125 @@ void LLViewerOctreeCull::traverse(const OctreeNode* n)
     }
     else
     {
-        mRes = frustumCheck(group);
+        mRes = (checked >= 0) ? checked : frustumCheck(group);
+
+        if (mRes == 1)
+        { //partially in, run on down checking the children together
+            traversePartial(n);
+        }
+        else if (mRes)
+        { //fully in
+            OctreeTraveler::traverse(n);
+        }
+
+        mRes = 0;
+    }
+}
+
+// Same as OctreeTraveler::traverse(), but with the frustum checks for all of
+// n's children done in one frustumCheckBatch() call up front. Children that
+// turn out not to need theirs (early fails, fully visible parents) just
+// ignore the result.
+void LLViewerOctreeCull::traversePartial(const OctreeNode* n)
+{
+    n->accept(this);
+
+    const LLViewerOctreeGroup* children[8];
+    const LLVector4a* bounds[8];
+    S32 results[8];
+    U32 count = n->getChildCount();
+    llassert(count <= 8);
+    for (U32 i = 0; i < count; i++)
+    {
+        children[i] = (const LLViewerOctreeGroup*) n->getChild(i)->getListener(0);
+        bounds[i] = children[i]->getBounds();
+    }
+    frustumCheckBatch(children, bounds, count, results);
+
+    for (U32 i = 0; i < count; i++)
+    {
+        mCheckedRes = results[i];
+        traverse(n->getChild(i));
+    }
+    mCheckedRes = -1;
+}
+
+void LLViewerOctreeCull::traverseFlat(const LLViewerOctreeFlat& flat)
+{
+    if (!flat.empty())
+    {
+        traverseFlat(flat, 0);
+    }
+}
+
+// traverse() by index: keep the two in step
+void LLViewerOctreeCull::traverseFlat(const LLViewerOctreeFlat& flat, U32 index)
+{
+    const LLViewerOctreeFlat::Node& node = flat.getNode(index);
+    LLViewerOctreeGroup* group = node.mGroup;
+    S32 checked = mCheckedRes;
+    mCheckedRes = -1;
+
+    if (earlyFail(group))
+    {
+        return;
+    }
+
+    if (mRes == 2 ||
+        (mRes && group->hasState(LLViewerOctreeGroup::SKIP_FRUSTUM_CHECK)))
+    {   //fully in, just add everything
+        traverseFlatChildren(flat, node, false);
+    }
+    else
+    {
+        mRes = (checked >= 0) ? checked : frustumCheck(group);
 
         if (mRes)
         { //at least partially in, run on down
-            OctreeTraveler::traverse(n);
+            traverseFlatChildren(flat, node, mRes == 1);
         }
 
         mRes = 0;
     }
 }
 
+void LLViewerOctreeCull::traverseFlatChildren(const LLViewerOctreeFlat& flat, const LLViewerOctreeFlat::Node& node, bool batch)
+{
+    visit(node.mNode);
+
+    const U32 first = node.mFirstChild;
+    const U32 count = node.mChildCount;
+    S32 results[8];
+    if (batch)
+    {
+        const LLViewerOctreeGroup* children[8];
+        const LLVector4a* bounds[8];
+        llassert(count <= 8);
+        for (U32 i = 0; i < count; i++)
+        {
+            children[i] = flat.getNode(first + i).mGroup;
+            bounds[i] = flat.getBounds(first + i);
+        }
+        frustumCheckBatch(children, bounds, count, results);
+    }
+
+    for (U32 i = 0; i < count; i++)
+    {
+        mCheckedRes = batch ? results[i] : -1;
+        traverseFlat(flat, first + i);
+    }
+    mCheckedRes = -1;
+}
+
+//virtual
+void LLViewerOctreeCull::frustumCheckBatch(const LLViewerOctreeGroup* const* groups, const LLVector4a* const* bounds, U32 count, S32* results)
+{
+    for (U32 i = 0; i < count; i++)
+    {
+        results[i] = frustumCheck(groups[i]);
+    }
+}
+
 //------------------------------------------
 //agent space group culling
 S32 LLViewerOctreeCull::AABBInFrustumNoFarClipGroupBounds(const LLViewerOctreeGroup* group)
@@ -1384,6 +1543,16 @@ S32 LLViewerOctreeCull::AABBInFrustumGroupBounds(const LLViewerOctreeGroup* grou
 {
     return mCamera->AABBInFrustum(group->mBounds[0], group->mBounds[1]);
 }
+
+void LLViewerOctreeCull::AABBsInFrustumNoFarClipGroupBounds(const LLVector4a* const* bounds, U32 count, S32* results)
+{
+    mCamera->AABBsInFrustumNoFarClip(bounds, count, results);
+}
+
+void LLViewerOctreeCull::AABBsInFrustumGroupBounds(const LLVector4a* const* bounds, U32 count, S32* results)
+{
+    mCamera->AABBsInFrustum(bounds, count, results);
+}
 //------------------------------------------
 
 //------------------------------------------
@@ -1420,6 +1589,16 @@ S32 LLViewerOctreeCull::AABBRegionSphereIntersectGroupExtents(const LLViewerOctr
 {
     return AABBSphereIntersect(group->mExtents[0], group->mExtents[1], mCamera->getOrigin() - shift, mCamera->mFrustumCornerDist);
 }
+
+void LLViewerOctreeCull::AABBsInRegionFrustumNoFarClipGroupBounds(const LLVector4a* const* bounds, U32 count, S32* results)
+{
+    mCamera->AABBsInRegionFrustumNoFarClip(bounds, count, results);
+}
+
+void LLViewerOctreeCull::AABBsInRegionFrustumGroupBounds(const LLVector4a* const* bounds, U32 count, S32* results)
+{
+    mCamera->AABBsInRegionFrustum(bounds, count, results);
+}
 //------------------------------------------
 
 //------------------------------------------
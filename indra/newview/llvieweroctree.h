@@ -38,6 +38,7 @@
 #include "llquaternion.h"
 #include "lloctree.h"
 #include "llviewercamera.h"
+#include "llheap.h"
 
 class LLViewerRegion;
 class LLViewerOctreeEntryData;
@@ -73,7 +74,8 @@ S32 AABBSphereIntersectR2(const LLVector3& min, const LLVector3& max, const LLVe
 //LL_ALIGN_PREFIX(16)
 class LLViewerOctreeEntry : public LLRefCount
 {
-    LL_ALIGN_NEW
+public:
+    LL_HEAP_OPERATORS(LLHeap::HEAP_SCENE)
     friend class LLViewerOctreeEntryData;
 
 public:
@@ -181,7 +183,8 @@ protected:
 class LLViewerOctreeGroup
 :   public OctreeListener
 {
-    LL_ALIGN_NEW
+public:
+    LL_HEAP_OPERATORS(LLHeap::HEAP_SCENE)
     friend class LLViewerOctreeCull;
 protected:
     virtual ~LLViewerOctreeGroup();
@@ -366,13 +369,49 @@ public:
     U32              mLODPeriod;    //number of frames between LOD updates for a given spatial group (staggered by mLODSeed)
 };
 
+// A flat copy of an octree's nodes for the read-mostly cull passes: one
+// array in breadth first order, so the children of each node sit side by
+// side and are found by index, with the group bounds of every node kept in a
+// second contiguous array. It only copies the shape and the bounds; groups
+// are still read live for their states. Any insertion, removal or move in
+// the octree goes through LLViewerOctreeGroup::unbound(), which leaves the
+// root group dirty until its next rebound(), so check that before rebounding
+// and build() again if set.
+class LLViewerOctreeFlat
+{
+public:
+    struct Node
+    {
+        const OctreeNode*    mNode;
+        LLViewerOctreeGroup* mGroup;
+        U32                  mFirstChild;
+        U32                  mChildCount;
+    };
+
+    // copy root and everything below it; groups must be rebound first
+    void build(const OctreeNode* root);
+    void clear()                             { mNodes.clear(); mBounds.clear(); }
+
+    bool empty() const                       { return mNodes.empty(); }
+    U32  size() const                        { return (U32)mNodes.size(); }
+    const Node& getNode(U32 index) const     { return mNodes[index]; }
+    // the center, radius pair copied from getGroup()->getBounds()
+    const LLVector4a* getBounds(U32 index) const { return &mBounds[index * 2]; }
+
+private:
+    std::vector<Node>       mNodes;
+    std::vector<LLVector4a> mBounds;
+};
+
 class LLViewerOctreeCull : public OctreeTraveler
 {
 public:
     LLViewerOctreeCull(LLCamera* camera)
-        : mCamera(camera), mRes(0) { }
+        : mCamera(camera), mRes(0), mCheckedRes(-1) { }
 
     virtual void traverse(const OctreeNode* n);
+    // the same walk as traverse(), over a flat copy of the tree
+    void traverseFlat(const LLViewerOctreeFlat& flat);
 
 protected:
     virtual bool earlyFail(LLViewerOctreeGroup* group);
@@ -381,6 +420,8 @@ protected:
     S32 AABBInFrustumNoFarClipGroupBounds(const LLViewerOctreeGroup* group);
     S32 AABBSphereIntersectGroupExtents(const LLViewerOctreeGroup* group);
     S32 AABBInFrustumGroupBounds(const LLViewerOctreeGroup* group);
+    void AABBsInFrustumNoFarClipGroupBounds(const LLVector4a* const* bounds, U32 count, S32* results);
+    void AABBsInFrustumGroupBounds(const LLVector4a* const* bounds, U32 count, S32* results);
 
     //agent space object set cull
     S32 AABBInFrustumNoFarClipObjectBounds(const LLViewerOctreeGroup* group);
@@ -391,6 +432,8 @@ protected:
     S32 AABBInRegionFrustumNoFarClipGroupBounds(const LLViewerOctreeGroup* group);
     S32 AABBInRegionFrustumGroupBounds(const LLViewerOctreeGroup* group);
     S32 AABBRegionSphereIntersectGroupExtents(const LLViewerOctreeGroup* group, const LLVector3& shift);
+    void AABBsInRegionFrustumNoFarClipGroupBounds(const LLVector4a* const* bounds, U32 count, S32* results);
+    void AABBsInRegionFrustumGroupBounds(const LLVector4a* const* bounds, U32 count, S32* results);
 
     //local region space object set cull
     S32 AABBInRegionFrustumNoFarClipObjectBounds(const LLViewerOctreeGroup* group);
@@ -399,6 +442,10 @@ protected:
 
     virtual S32 frustumCheck(const LLViewerOctreeGroup* group) = 0;
     virtual S32 frustumCheckObjects(const LLViewerOctreeGroup* group) = 0;
+    // frustumCheck() count groups at once, the children of a partly visible
+    // node, with bounds[i] holding groups[i]->getBounds() or a copy of them;
+    // override along with frustumCheck() to batch the tests
+    virtual void frustumCheckBatch(const LLViewerOctreeGroup* const* groups, const LLVector4a* const* bounds, U32 count, S32* results);
 
     bool checkProjectionArea(const LLVector4a& center, const LLVector4a& size, const LLVector3& shift, F32 pixel_threshold, F32 near_radius);
     virtual bool checkObjects(const OctreeNode* branch, const LLViewerOctreeGroup* group);
@@ -406,9 +453,18 @@ protected:
     virtual void processGroup(LLViewerOctreeGroup* group);
     virtual void visit(const OctreeNode* branch);
 
+private:
+    void traversePartial(const OctreeNode* n);
+    void traverseFlat(const LLViewerOctreeFlat& flat, U32 index);
+    void traverseFlatChildren(const LLViewerOctreeFlat& flat, const LLViewerOctreeFlat::Node& node, bool batch);
+
 protected:
     LLCamera *mCamera;
     S32 mRes;
+private:
+    // frustumCheck() result for the node about to be traversed, if it was
+    // batched with its siblings, else -1
+    S32 mCheckedRes;
 };
 
 //scan the octree, output the info of each node for debug use.
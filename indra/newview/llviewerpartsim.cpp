@@ -42,9 +42,14 @@
 #include "llspatialpartition.h"
 #include "llvoavatarself.h"
 #include "llvovolume.h"
+#include "threadpool.h"
 
 const F32 PART_SIM_BOX_SIDE = 16.f;
 
+// Below this many particles waking the pool costs more than stepping them here
+constexpr S32 PARALLEL_PART_MIN = 512;
+constexpr size_t PART_SIM_THREADS = 2;
+
 //static
 S32 LLViewerPartSim::sMaxParticleCount = 0;
 S32 LLViewerPartSim::sParticleCount = 0;
@@ -189,6 +194,7 @@ LLViewerPartGroup::LLViewerPartGroup(const LLVector3 &center_agent, const F32 bo
     }
 
     mSkippedTime = 0.f;
+    mStepping = false;
 
     static U32 id_seed = 0;
     mID = ++id_seed;
@@ -273,129 +279,152 @@ bool LLViewerPartGroup::addPart(LLViewerPart* part, F32 desired_size)
 }
 
 
-void LLViewerPartGroup::updateParticles(const F32 lastdt)
+// Advance one particle by the group's step, 'wind' is null when the group has no region
+static void integrate_particle(LLViewerPart* part, const F32 group_dt, LLWind* wind, const LLVector3& region_origin, const F32 region_width)
 {
-    F32 dt;
+    const F32 dt = group_dt - part->mSkipOffset;
+    part->mSkipOffset = 0.f;
 
-    LLVector3 gravity(0.f, 0.f, GRAVITY);
+    // Update current time
+    const F32 cur_time = part->mLastUpdateTime + dt;
+    const F32 frac = cur_time / part->mMaxAge;
 
-    LLViewerPartSim::checkParticleCount(static_cast<U32>(mParticles.size()));
+    // "Drift" the object based on the source object
+    if (part->mFlags & LLPartData::LL_PART_FOLLOW_SRC_MASK)
+    {
+        part->mPosAgent = part->mPartSourcep->mPosAgent;
+        part->mPosAgent += part->mPosOffset;
+    }
 
-    LLViewerCamera* camera = LLViewerCamera::getInstance();
-    LLViewerRegion *regionp = getRegion();
-    S32 end = (S32) mParticles.size();
-    for (S32 i = 0 ; i < (S32)mParticles.size();)
+    // Do a custom callback if we have one...
+    if (part->mVPCallback)
     {
-        LLVector3 a(0.f, 0.f, 0.f);
-        LLViewerPart* part = mParticles[i] ;
+        (*part->mVPCallback)(*part, dt);
+    }
 
-        dt = lastdt + mSkippedTime - part->mSkipOffset;
-        part->mSkipOffset = 0.f;
+    if (wind && (part->mFlags & LLPartData::LL_PART_WIND_MASK))
+    {
+        part->mVelocity *= 1.f - 0.1f*dt;
+        part->mVelocity += 0.1f*dt*wind->getVelocity(part->mPosAgent - region_origin, region_width);
+    }
 
-        // Update current time
-        const F32 cur_time = part->mLastUpdateTime + dt;
-        const F32 frac = cur_time / part->mMaxAge;
+    // Now do interpolation towards a target
+    if (part->mFlags & LLPartData::LL_PART_TARGET_POS_MASK)
+    {
+        F32 remaining = part->mMaxAge - part->mLastUpdateTime;
+        F32 step = dt / remaining;
 
-        // "Drift" the object based on the source object
-        if (part->mFlags & LLPartData::LL_PART_FOLLOW_SRC_MASK)
-        {
-            part->mPosAgent = part->mPartSourcep->mPosAgent;
-            part->mPosAgent += part->mPosOffset;
-        }
+        step = llclamp(step, 0.f, 0.1f);
+        step *= 5.f;
+        // we want a velocity that will result in reaching the target in the
+        // Interpolate towards the target.
+        LLVector3 delta_pos = part->mPartSourcep->mTargetPosAgent - part->mPosAgent;
+
+        delta_pos /= remaining;
+
+        part->mVelocity *= (1.f - step);
+        part->mVelocity += step*delta_pos;
+    }
 
-        // Do a custom callback if we have one...
-        if (part->mVPCallback)
-        {
-            (*part->mVPCallback)(*part, dt);
-        }
 
-        if (part->mFlags & LLPartData::LL_PART_WIND_MASK)
+    if (part->mFlags & LLPartData::LL_PART_TARGET_LINEAR_MASK)
+    {
+        LLVector3 delta_pos = part->mPartSourcep->mTargetPosAgent - part->mPartSourcep->mPosAgent;
+        part->mPosAgent = part->mPartSourcep->mPosAgent;
+        part->mPosAgent += frac*delta_pos;
+        part->mVelocity = delta_pos;
+    }
+    else
+    {
+        // Do velocity interpolation
+        part->mPosAgent += dt*part->mVelocity;
+        part->mPosAgent += 0.5f*dt*dt*part->mAccel;
+        part->mVelocity += part->mAccel*dt;
+    }
+
+    // Do a bounce test
+    if (part->mFlags & LLPartData::LL_PART_BOUNCE_MASK)
+    {
+        // Need to do point vs. plane check...
+        // For now, just check relative to object height...
+        F32 dz = part->mPosAgent.mV[VZ] - part->mPartSourcep->mPosAgent.mV[VZ];
+        if (dz < 0)
         {
-            part->mVelocity *= 1.f - 0.1f*dt;
-            part->mVelocity += 0.1f*dt*regionp->mWind.getVelocity(regionp->getPosRegionFromAgent(part->mPosAgent));
+            part->mPosAgent.mV[VZ] += -2.f*dz;
+            part->mVelocity.mV[VZ] *= -0.75f;
         }
+    }
 
-        // Now do interpolation towards a target
-        if (part->mFlags & LLPartData::LL_PART_TARGET_POS_MASK)
-        {
-            F32 remaining = part->mMaxAge - part->mLastUpdateTime;
-            F32 step = dt / remaining;
 
-            step = llclamp(step, 0.f, 0.1f);
-            step *= 5.f;
-            // we want a velocity that will result in reaching the target in the
-            // Interpolate towards the target.
-            LLVector3 delta_pos = part->mPartSourcep->mTargetPosAgent - part->mPosAgent;
+    // Reset the offset from the source position
+    if (part->mFlags & LLPartData::LL_PART_FOLLOW_SRC_MASK)
+    {
+        part->mPosOffset = part->mPosAgent;
+        part->mPosOffset -= part->mPartSourcep->mPosAgent;
+    }
 
-            delta_pos /= remaining;
+    // Do color interpolation
+    if (part->mFlags & LLPartData::LL_PART_INTERP_COLOR_MASK)
+    {
+        part->mColor.setVec(part->mStartColor);
+        // note: LLColor4's v%k means multiply-alpha-only,
+        //       LLColor4's v*k means multiply-rgb-only
+        part->mColor *= 1.f - frac; // rgb*k
+        part->mColor %= 1.f - frac; // alpha*k
+        part->mColor += frac%(frac*part->mEndColor); // rgb,alpha
+    }
 
-            part->mVelocity *= (1.f - step);
-            part->mVelocity += step*delta_pos;
-        }
+    // Do scale interpolation
+    if (part->mFlags & LLPartData::LL_PART_INTERP_SCALE_MASK)
+    {
+        part->mScale.setVec(part->mStartScale);
+        part->mScale *= 1.f - frac;
+        part->mScale += frac*part->mEndScale;
+    }
 
+    // Do glow interpolation
+    part->mGlow.mV[3] = (U8) ll_round(lerp(part->mStartGlow, part->mEndGlow, frac)*255.f);
 
-        if (part->mFlags & LLPartData::LL_PART_TARGET_LINEAR_MASK)
-        {
-            LLVector3 delta_pos = part->mPartSourcep->mTargetPosAgent - part->mPartSourcep->mPosAgent;
-            part->mPosAgent = part->mPartSourcep->mPosAgent;
-            part->mPosAgent += frac*delta_pos;
-            part->mVelocity = delta_pos;
-        }
-        else
-        {
-            // Do velocity interpolation
-            part->mPosAgent += dt*part->mVelocity;
-            part->mPosAgent += 0.5f*dt*dt*part->mAccel;
-            part->mVelocity += part->mAccel*dt;
-        }
+    // Set the last update time to now.
+    part->mLastUpdateTime = cur_time;
+}
 
-        // Do a bounce test
-        if (part->mFlags & LLPartData::LL_PART_BOUNCE_MASK)
+void LLViewerPartGroup::integrateParticles(const F32 lastdt, const LLVector3& region_origin, const F32 region_width)
+{
+    LLWind* wind = mRegionp ? &mRegionp->mWind : NULL;
+    const F32 group_dt = lastdt + mSkippedTime;
+
+    // callbacks may do anything, they wait for updateParticles
+    for (LLViewerPart* part : mParticles)
+    {
+        if (!part->mVPCallback)
         {
-            // Need to do point vs. plane check...
-            // For now, just check relative to object height...
-            F32 dz = part->mPosAgent.mV[VZ] - part->mPartSourcep->mPosAgent.mV[VZ];
-            if (dz < 0)
-            {
-                part->mPosAgent.mV[VZ] += -2.f*dz;
-                part->mVelocity.mV[VZ] *= -0.75f;
-            }
+            integrate_particle(part, group_dt, wind, region_origin, region_width);
         }
+    }
+}
 
+void LLViewerPartGroup::updateParticles(const F32 lastdt)
+{
+    LLViewerPartSim::checkParticleCount(static_cast<U32>(mParticles.size()));
 
-        // Reset the offset from the source position
-        if (part->mFlags & LLPartData::LL_PART_FOLLOW_SRC_MASK)
-        {
-            part->mPosOffset = part->mPosAgent;
-            part->mPosOffset -= part->mPartSourcep->mPosAgent;
-        }
+    LLViewerCamera* camera = LLViewerCamera::getInstance();
+    LLViewerRegion *regionp = getRegion();
+    LLWind* wind = regionp ? &regionp->mWind : NULL;
+    const LLVector3 region_origin = regionp ? regionp->getOriginAgent() : LLVector3::zero;
+    const F32 region_width = LLWorld::getInstance()->getRegionWidthInMeters();
+    const F32 group_dt = lastdt + mSkippedTime;
 
-        // Do color interpolation
-        if (part->mFlags & LLPartData::LL_PART_INTERP_COLOR_MASK)
-        {
-            part->mColor.setVec(part->mStartColor);
-            // note: LLColor4's v%k means multiply-alpha-only,
-            //       LLColor4's v*k means multiply-rgb-only
-            part->mColor *= 1.f - frac; // rgb*k
-            part->mColor %= 1.f - frac; // alpha*k
-            part->mColor += frac%(frac*part->mEndColor); // rgb,alpha
-        }
+    S32 end = (S32) mParticles.size();
+    for (S32 i = 0 ; i < (S32)mParticles.size();)
+    {
+        LLViewerPart* part = mParticles[i] ;
 
-        // Do scale interpolation
-        if (part->mFlags & LLPartData::LL_PART_INTERP_SCALE_MASK)
+        if (part->mVPCallback)
         {
-            part->mScale.setVec(part->mStartScale);
-            part->mScale *= 1.f - frac;
-            part->mScale += frac*part->mEndScale;
+            integrate_particle(part, group_dt, wind, region_origin, region_width);
         }
 
-        // Do glow interpolation
-        part->mGlow.mV[3] = (U8) ll_round(lerp(part->mStartGlow, part->mEndGlow, frac)*255.f);
-
-        // Set the last update time to now.
-        part->mLastUpdateTime = cur_time;
-
-
         // Kill dead particles (either flagged dead, or too old)
         if ((part->mLastUpdateTime > part->mMaxAge) || (LLViewerPart::LL_PART_DEAD_MASK == part->mFlags))
         {
@@ -490,6 +519,18 @@ LLViewerPartSim::LLViewerPartSim()
     sMaxParticleCount = llmin(gSavedSettings.getS32("RenderMaxPartCount"), LL_MAX_PARTICLE_COUNT);
     static U32 id_seed = 0;
     mID = ++id_seed;
+
+    // the main thread steps groups too, "ThreadPoolSizes" may override the width
+    size_t threads = LL::ThreadPool::getConfiguredWidth("PartSim", PART_SIM_THREADS);
+    if (threads > 0)
+    {
+        mPool.reset(new LL::ThreadPool("PartSim", threads));
+        mPool->start();
+    }
+}
+
+LLViewerPartSim::~LLViewerPartSim()
+{
 }
 
 //enable/disable particle system
@@ -522,6 +563,12 @@ void LLViewerPartSim::destroyClass()
 
     // Kill all of the sources
     mViewerPartSources.clear();
+
+    if (mPool)
+    {
+        mPool->close();
+        mPool.reset();
+    }
 }
 
 //static
@@ -747,10 +794,15 @@ void LLViewerPartSim::updateSimulation()
         num_updates++;
     }
 
+    // Integrate the groups due this frame first, then run callbacks and move
+    // particles between groups. Particles moved into a group that was already
+    // integrated wait for its next step.
+    std::vector<GroupStep> steps;
     count = (S32) mViewerPartGroups.size();
     for (i = 0; i < count; i++)
     {
-        LLViewerObject* vobj = mViewerPartGroups[i]->mVOPartGroupp;
+        LLViewerPartGroup* part_group = mViewerPartGroups[i];
+        LLViewerObject* vobj = part_group->mVOPartGroupp;
 
         S32 visirate = 1;
         if (vobj && !vobj->isDead() && vobj->mDrawable && !vobj->mDrawable->isDead())
@@ -762,28 +814,48 @@ void LLViewerPartSim::updateSimulation()
             }
         }
 
-        if ((LLDrawable::getCurrentFrame()+mViewerPartGroups[i]->mID)%visirate == 0)
+        if ((LLDrawable::getCurrentFrame()+part_group->mID)%visirate == 0)
         {
             if (vobj && !vobj->isDead())
             {
                 gPipeline.markRebuild(vobj->mDrawable, LLDrawable::REBUILD_ALL);
             }
-            mViewerPartGroups[i]->updateParticles(dt * visirate);
-            mViewerPartGroups[i]->mSkippedTime=0.0f;
-            if (!mViewerPartGroups[i]->getCount())
-            {
-                delete mViewerPartGroups[i];
-                mViewerPartGroups.erase(mViewerPartGroups.begin() + i);
-                i--;
-                count--;
-            }
+            LLViewerRegion* regionp = part_group->getRegion();
+            part_group->mStepping = true;
+            steps.push_back({ part_group, dt * visirate, regionp ? regionp->getOriginAgent() : LLVector3::zero });
         }
         else
         {
-            mViewerPartGroups[i]->mSkippedTime+=dt;
+            part_group->mSkippedTime+=dt;
+        }
+    }
+
+    integrateGroups(steps);
+
+    // groups created by transfers below are not stepped until next frame
+    S32 step = 0;
+    count = (S32) mViewerPartGroups.size();
+    for (i = 0; i < count; i++)
+    {
+        LLViewerPartGroup* part_group = mViewerPartGroups[i];
+        if (!part_group->mStepping)
+        {
+            continue;
         }
 
+        llassert(steps[step].mGroup == part_group);
+        part_group->updateParticles(steps[step++].mDt);
+        part_group->mSkippedTime=0.0f;
+        part_group->mStepping = false;
+        if (!part_group->getCount())
+        {
+            delete part_group;
+            mViewerPartGroups.erase(mViewerPartGroups.begin() + i);
+            i--;
+            count--;
+        }
     }
+
     if (LLDrawable::getCurrentFrame()%16==0)
     {
         if (sParticleCount > sMaxParticleCount * 0.875f
@@ -806,6 +878,59 @@ void LLViewerPartSim::updateSimulation()
     //LL_INFOS() << "Particles: " << sParticleCount << " Adaptive Rate: " << sParticleAdaptiveRate << LL_ENDL;
 }
 
+void LLViewerPartSim::integrateGroups(const std::vector<GroupStep>& steps)
+{
+    LL_PROFILE_ZONE_SCOPED;
+
+    const F32 region_width = LLWorld::getInstance()->getRegionWidthInMeters();
+
+    static LLCachedControl<bool> parallel_particles(gSavedSettings, "RenderParallelParticles", true);
+    if (!parallel_particles || !mPool || steps.size() < 2 || sParticleCount < PARALLEL_PART_MIN)
+    {
+        for (const GroupStep& step : steps)
+        {
+            step.mGroup->integrateParticles(step.mDt, step.mRegionOrigin, region_width);
+        }
+        return;
+    }
+
+    // Shared with the pool, a job that comes late must not touch this frame
+    struct StepJobs
+    {
+        std::atomic<size_t> mNext{ 0 };
+        std::atomic<size_t> mDone{ 0 };
+        size_t              mCount;
+    };
+    std::shared_ptr<StepJobs> jobs = std::make_shared<StepJobs>();
+    jobs->mCount = steps.size();
+
+    const GroupStep* stepsp = steps.data();
+    auto work = [jobs, stepsp, region_width]()
+    {
+        size_t i;
+        while ((i = jobs->mNext++) < jobs->mCount)
+        {
+            stepsp[i].mGroup->integrateParticles(stepsp[i].mDt, stepsp[i].mRegionOrigin, region_width);
+            jobs->mDone++;
+        }
+    };
+
+    size_t helpers = llmin(mPool->getWidth(), steps.size() - 1);
+    for (size_t i = 0; i < helpers; ++i)
+    {
+        if (!mPool->getQueue().post(work))
+        {
+            break;
+        }
+    }
+
+    work();
+    while (jobs->mDone < jobs->mCount)
+    {
+        std::this_thread::yield();
+    }
+}
+
 void LLViewerPartSim::updatePartBurstRate()
 {
     if (!(LLDrawable::getCurrentFrame() & 0xf))
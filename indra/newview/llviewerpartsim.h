@@ -31,6 +31,7 @@
 #include "llpointer.h"
 #include "llpartdata.h"
 #include "llviewerpartsource.h"
+#include "threadpool_fwd.h"
 
 class LLViewerTexture;
 class LLViewerPart;
@@ -97,6 +98,13 @@ public:
 
     bool addPart(LLViewerPart* part, const F32 desired_size = -1.f);
 
+    // Advance the particles that have no callback. Touches nothing but this
+    // group's particles and its region's wind, so LLViewerPartSim may step
+    // several groups at once on its thread pool.
+    void integrateParticles(const F32 lastdt, const LLVector3& region_origin, const F32 region_width);
+
+    // Main thread half of a step: runs callbacks, kills dead particles and
+    // moves the ones that left the group. Call after integrateParticles.
     void updateParticles(const F32 lastdt);
 
     bool posInGroup(const LLVector3 &pos, const F32 desired_size = -1.f);
@@ -122,6 +130,7 @@ public:
 
     F32 mSkippedTime;
     bool mHud;
+    bool mStepping; // being stepped by the current LLViewerPartSim::updateSimulation
 
 protected:
     LLVector3 mCenterAgent;
@@ -136,6 +145,7 @@ protected:
 class LLViewerPartSim : public LLSingleton<LLViewerPartSim>
 {
     LLSINGLETON(LLViewerPartSim);
+    ~LLViewerPartSim();
 public:
     void destroyClass();
 
@@ -190,8 +200,17 @@ protected:
     LLViewerPartGroup *createViewerPartGroup(const LLVector3 &pos_agent, const F32 desired_size, bool hud);
     LLViewerPartGroup *put(LLViewerPart* part);
 
+    struct GroupStep
+    {
+        LLViewerPartGroup* mGroup;
+        F32 mDt;
+        LLVector3 mRegionOrigin;
+    };
+    void integrateGroups(const std::vector<GroupStep>& steps);
+
     group_list_t mViewerPartGroups;
     source_list_t mViewerPartSources;
+    std::unique_ptr<LL::ThreadPool> mPool;
     LLFrameTimer mSimulationTimer;
 
     static S32 sMaxParticleCount;
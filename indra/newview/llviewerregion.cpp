@@ -71,6 +71,8 @@
 #include "llspatialpartition.h"
 #include "stringize.h"
 #include "llviewercontrol.h"
+#include "llviewercamera.h"
+#include "llviewerthrottle.h"
 #include "llsdserialize.h"
 #include "llfloaterperms.h"
 #include "llvieweroctree.h"
@@ -219,6 +221,16 @@ public:
     LLVOCacheEntry::vocache_entry_priority_list_t mWaitingList; //transient list storing sorted visible entries waiting for object creation.
     std::set<U32>                          mNonCacheableCreatedList; //list of local ids of all non-cacheable objects
     LLVOCacheEntry::vocache_gltf_overrides_map_t mGLTFOverridesLLSD; // for materials
+    LLVOCache::asset_list_t               mCacheAssets; // collected before the objects go, see collectCacheAssets
+
+    // cache probes received while the cache file was still loading
+    struct CacheProbe
+    {
+        U32 mLocalID;
+        U32 mCRC;
+        U32 mFlags;
+    };
+    std::vector<CacheProbe> mDeferredCacheProbes;
 
     // time?
     // LRU info?
@@ -637,6 +649,7 @@ LLViewerRegion::LLViewerRegion(const U64 &handle,
     mProductName("unknown"),
     mViewerAssetUrl(""),
     mCacheLoaded(false),
+    mCacheLoadSerial(0),
     mCacheDirty(false),
     mReleaseNotesRequested(false),
     mCapabilitiesState(CAPABILITIES_STATE_INIT),
@@ -663,6 +676,7 @@ LLViewerRegion::LLViewerRegion(const U64 &handle,
                             grids_per_region_edge,
                             region_width_meters / grids_per_region_edge);
     mImpl->mCompositionp->setSurface(mImpl->mLandp);
+    mImpl->mCompositionp->loadCache(handle);
 
     // Create the surfaces
     mImpl->mLandp->setRegion(this);
@@ -734,11 +748,17 @@ LLViewerRegion::~LLViewerRegion()
     disconnectAllNeighbors();
     LLViewerPartSim::getInstance()->cleanupRegion(this);
 
+    if (mCacheDirty)
+    {
+        collectCacheAssets();
+    }
+
     {
         LL_RECORD_BLOCK_TIME(FTM_CLEANUP_REGION_OBJECTS);
         gObjectList.killObjects(this);
     }
 
+    mImpl->mCompositionp->saveCache();
     delete mImpl->mCompositionp;
     delete mParcelOverlay;
     delete mImpl->mLandp;
@@ -790,18 +810,118 @@ void LLViewerRegion::loadObjectCache()
 
     if(LLVOCache::instanceExists())
     {
-        LLVOCache & vocache = LLVOCache::instance();
-        // Without this a "corrupted" vocache persists until a cache clear or other rewrite. Mark as dirty hereif read fails to force a rewrite.
-        mCacheDirty = !vocache.readFromCache(mHandle, mImpl->mCacheID, mImpl->mCacheMap);
-        vocache.readGenericExtrasFromCache(mHandle, mImpl->mCacheID, mImpl->mGLTFOverridesLLSD, mImpl->mCacheMap);
+        // the file is read on the General queue, a region that is gone by then, or
+        // was replaced by another one for the same handle, ignores the result
+        static U32 sCacheLoadSerial = 0;
+        if (++sCacheLoadSerial == 0)
+        {
+            ++sCacheLoadSerial;
+        }
+        mCacheLoadSerial = sCacheLoadSerial;
+
+        const U64 handle = mHandle;
+        const U32 serial = mCacheLoadSerial;
+        LLVOCache::instance().readFromCacheAsync(mHandle, mImpl->mCacheID,
+            [handle, serial](bool success, LLVOCacheEntry::vocache_entry_map_t& cache_entry_map, LLVOCacheEntry::vocache_gltf_overrides_map_t& cache_extras_entry_map)
+            {
+                LLViewerRegion* regionp = LLWorld::instanceExists() ? LLWorld::getInstance()->getRegionFromHandle(handle) : NULL;
+                if (regionp && regionp->mCacheLoadSerial == serial)
+                {
+                    // updates the sim sent while the file was loading are newer than the file
+                    regionp->mImpl->mCacheMap.insert(cache_entry_map.begin(), cache_entry_map.end());
+                    regionp->mImpl->mGLTFOverridesLLSD.insert(cache_extras_entry_map.begin(), cache_extras_entry_map.end());
+                    regionp->onObjectCacheLoaded(success);
+                }
+            });
+    }
+}
+
+void LLViewerRegion::onObjectCacheLoaded(bool success)
+{
+    mCacheLoadSerial = 0;
+
+    // Without this a "corrupted" vocache persists until a cache clear or other rewrite. Mark as dirty hereif read fails to force a rewrite.
+    mCacheDirty = mCacheDirty || !success;
+
+    if (mImpl->mCacheMap.empty())
+    {
+        mCacheDirty = true;
+    }
 
-        if (mImpl->mCacheMap.empty())
+    std::vector<LLViewerRegionImpl::CacheProbe> probes;
+    probes.swap(mImpl->mDeferredCacheProbes);
+    LLViewerStatsRecorder& recorder = LLViewerStatsRecorder::instance();
+    for (const LLViewerRegionImpl::CacheProbe& probe : probes)
+    {
+        U8 cache_miss_type = CACHE_MISS_TYPE_NONE;
+        if (probeCache(probe.mLocalID, probe.mCRC, probe.mFlags, cache_miss_type))
+        {
+            recorder.cacheHitEvent();
+        }
+        else
         {
-            mCacheDirty = true;
+            recorder.cacheMissEvent(cache_miss_type);
         }
     }
 }
 
+void LLViewerRegion::deferCacheProbe(U32 local_id, U32 crc, U32 flags)
+{
+    llassert(isCacheLoading());
+    mImpl->mDeferredCacheProbes.push_back({ local_id, crc, flags });
+}
+
+
+void LLViewerRegion::collectCacheAssets()
+{
+    LL_PROFILE_ZONE_SCOPED;
+    std::set<std::pair<LLAssetType::EType, LLUUID> > assets;
+    for (S32 i = 0; i < gObjectList.getNumObjects(); ++i)
+    {
+        LLViewerObject* objectp = gObjectList.getObject(i);
+        if (!objectp || objectp->isDead() || objectp->getRegion() != this || objectp->isAvatar() || objectp->isAttachment())
+        {
+            continue; // avatars and what they wear are not in the object cache
+        }
+
+        for (U8 te = 0; te < objectp->getNumTEs(); ++te)
+        {
+            const LLTextureEntry* tep = objectp->getTE(te);
+            if (!tep)
+            {
+                continue;
+            }
+            if (tep->getID().notNull())
+            {
+                assets.emplace(LLAssetType::AT_TEXTURE, tep->getID());
+            }
+            const LLUUID& material_id = objectp->getRenderMaterialID(te);
+            if (material_id.notNull())
+            {
+                assets.emplace(LLAssetType::AT_MATERIAL, material_id);
+            }
+            const LLGLTFMaterial* material = tep->getGLTFRenderMaterial();
+            if (material)
+            {
+                for (const LLUUID& texture_id : material->mTextureId)
+                {
+                    if (texture_id.notNull())
+                    {
+                        assets.emplace(LLAssetType::AT_TEXTURE, texture_id);
+                    }
+                }
+            }
+        }
+
+        const LLSculptParams* sculpt_params = (const LLSculptParams*)objectp->getParameterEntry(LLNetworkData::PARAMS_SCULPT);
+        if (sculpt_params && objectp->getParameterEntryInUse(LLNetworkData::PARAMS_SCULPT) && sculpt_params->getSculptTexture().notNull())
+        {
+            bool is_mesh = (sculpt_params->getSculptType() & LL_SCULPT_TYPE_MASK) == LL_SCULPT_TYPE_MESH;
+            assets.emplace(is_mesh ? LLAssetType::AT_MESH : LLAssetType::AT_TEXTURE, sculpt_params->getSculptTexture());
+        }
+    }
+    mImpl->mCacheAssets.assign(assets.begin(), assets.end());
+}
 
 void LLViewerRegion::saveObjectCache()
 {
@@ -810,6 +930,12 @@ void LLViewerRegion::saveObjectCache()
         return;
     }
 
+    if (isCacheLoading())
+    {
+        // the file still has everything, the map only what arrived since the load started
+        return;
+    }
+
     if (mImpl->mCacheMap.empty())
     {
         return;
@@ -824,6 +950,14 @@ void LLViewerRegion::saveObjectCache()
 
         instance.writeToCache(mHandle, mImpl->mCacheID, mImpl->mCacheMap, mCacheDirty, removal_enabled);
         instance.writeGenericExtrasToCache(mHandle, mImpl->mCacheID, mImpl->mGLTFOverridesLLSD, mCacheDirty, removal_enabled);
+        if (mCacheDirty)
+        {
+            if (!mDead)
+            {
+                collectCacheAssets(); // otherwise done before the objects were killed
+            }
+            instance.writeAssetList(mHandle, mImpl->mCacheAssets);
+        }
         mCacheDirty = false;
     }
 
@@ -1502,6 +1636,11 @@ void LLViewerRegion::createVisibleObjects(F32 max_time)
         return;
     }
 
+    const F32 LARGE_SCENE_CONTRIBUTION = 1000.f; //nearby or must-be-created entries, see updateVisibleEntries
+    LLVector4a local_origin;
+    local_origin.load3((LLViewerCamera::getInstance()->getOrigin() - getOriginAgent()).mV);
+    LLWorld* world = LLWorld::getInstance();
+
     S32 throttle = sNewObjectCreationThrottle;
     bool has_new_obj = false;
     LLTimer update_timer;
@@ -1512,6 +1651,16 @@ void LLViewerRegion::createVisibleObjects(F32 max_time)
 
         if(vo_entry->getState() < LLVOCacheEntry::WAITING)
         {
+            if(vo_entry->getSceneContribution() < LARGE_SCENE_CONTRIBUTION)
+            {
+                LLVector4a lookAt;
+                lookAt.setSub(vo_entry->getPositionGroup(), local_origin);
+                if(!world->claimStreamingCreate(lookAt.getLength3().getF32()))
+                {
+                    continue; //a nearer ring is still loading
+                }
+            }
+
             addNewObject(vo_entry);
             has_new_obj = true;
             if(throttle > 0 && !(--throttle) && update_timer.getElapsedTimeF32() > max_time)
@@ -2906,6 +3055,41 @@ void LLViewerRegion::addCacheMissFull(const U32 local_id)
     addCacheMiss(local_id, CACHE_MISS_TYPE_TOTAL);
 }
 
+// Cache miss pacing, the sim answers every requested object with a full update
+// on the task channel, so about one round trip worth of task throttle is asked
+// for at a time
+const F32 CACHE_MISS_REPLY_BYTES = 250.f;  // typical compressed object update
+const F32 CACHE_MISS_TASK_SHARE = 0.3f;    // of the total throttle, see the presets in llviewerthrottle.cpp
+const S32 MIN_CACHE_MISS_WINDOW = 32;
+const S32 MAX_CACHE_MISS_WINDOW = 255 * 4;
+const F32 MIN_CACHE_MISS_RTT = 0.05f;      // seconds
+const F32 MAX_CACHE_MISS_RTT = 1.f;
+
+F32 LLViewerRegion::getCacheMissPriority(U32 local_id, const LLVector4a& local_camera_origin)
+{
+    // children are ranked by the whole linkset
+    LLVOCacheEntry* entry = getCacheEntry(local_id, false);
+    if (entry && entry->isChild())
+    {
+        LLVOCacheEntry* parent = getCacheEntry(entry->getParentID(), false);
+        if (parent)
+        {
+            entry = parent;
+        }
+    }
+
+    if (!entry)
+    {
+        return 0.f;
+    }
+
+    LLVector4a lookAt;
+    lookAt.setSub(entry->getPositionGroup(), local_camera_origin);
+    F32 distance = llmax(lookAt.getLength3().getF32(), 1.f);
+    F32 rad = entry->getBinRadius();
+    return rad * rad / distance;
+}
+
 void LLViewerRegion::requestCacheMisses()
 {
     if (!mCacheMissList.size())
@@ -2913,12 +3097,41 @@ void LLViewerRegion::requestCacheMisses()
         return;
     }
 
+    static LLCachedControl<bool> pace_cache_misses(gSavedSettings, "ObjectCacheMissPacing", true);
+    S32 window = S32_MAX;
+    if (pace_cache_misses)
+    {
+        F32 rtt = llclamp(F32Seconds(mPingDelay).value(), MIN_CACHE_MISS_RTT, MAX_CACHE_MISS_RTT);
+        if (mCacheMissRequestTimer.getElapsedTimeF32() < rtt)
+        {
+            return; // the last window may still be on its way back
+        }
+
+        F32 task_bytes_per_sec = gViewerThrottle.getCurrentBandwidth() * 1024.f / 8.f * CACHE_MISS_TASK_SHARE;
+        window = llclamp((S32)(task_bytes_per_sec * rtt / CACHE_MISS_REPLY_BYTES), MIN_CACHE_MISS_WINDOW, MAX_CACHE_MISS_WINDOW);
+
+        if ((S32)mCacheMissList.size() > window)
+        {
+            LLVector4a local_camera_origin;
+            local_camera_origin.load3((LLViewerCamera::getInstance()->getOrigin() - getOriginAgent()).mV);
+            for (CacheMissItem& item : mCacheMissList)
+            {
+                item.mPriority = getCacheMissPriority(item.mID, local_camera_origin);
+            }
+            // stable, misses of the same size keep the order the sim sent them in
+            mCacheMissList.sort([](const CacheMissItem& lhs, const CacheMissItem& rhs) { return lhs.mPriority > rhs.mPriority; });
+        }
+        mCacheMissRequestTimer.reset();
+    }
+
     LLMessageSystem* msg = gMessageSystem;
     bool start_new_message = true;
     S32 blocks = 0;
+    S32 requested = 0;
 
-    //send requests for all cache-missed objects
-    for (CacheMissItem::cache_miss_list_t::iterator iter = mCacheMissList.begin(); iter != mCacheMissList.end(); ++iter)
+    //send requests for the cache-missed objects that fit in the window
+    CacheMissItem::cache_miss_list_t::iterator iter = mCacheMissList.begin();
+    for (; iter != mCacheMissList.end() && requested < window; ++iter, ++requested)
     {
         if (start_new_message)
         {
@@ -2953,9 +3166,9 @@ void LLViewerRegion::requestCacheMisses()
 
     mCacheDirty = true ;
     // LL_INFOS() << "KILLDEBUG Sent cache miss full " << full_count << " crc " << crc_count << LL_ENDL;
-    LLViewerStatsRecorder::instance().requestCacheMissesEvent(static_cast<S32>(mCacheMissList.size()));
+    LLViewerStatsRecorder::instance().requestCacheMissesEvent(requested);
 
-    mCacheMissList.clear();
+    mCacheMissList.erase(mCacheMissList.begin(), iter);
 }
 
 void LLViewerRegion::dumpCache()
@@ -3194,7 +3407,7 @@ void LLViewerRegion::unpackRegionHandshake()
     {
         flags |= 0x00000001; //set the bit 0 to be 1 to ask sim to send all cacheable objects.
     }
-    if(mImpl->mCacheMap.empty())
+    if(mImpl->mCacheMap.empty() && !isCacheLoading())
     {
         flags |= 0x00000002; //set the bit 1 to be 1 to tell sim the cache file is empty, no need to send cache probes.
     }
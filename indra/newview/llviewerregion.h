@@ -115,6 +115,9 @@ public:
     // Call this after you have the region name and handle.
     void loadObjectCache();
     void saveObjectCache();
+    // the cache file is read in the background, probes received meanwhile wait for it
+    bool isCacheLoading() const { return mCacheLoadSerial != 0; }
+    void deferCacheProbe(U32 local_id, U32 crc, U32 flags);
 
     void sendMessage(); // Send the current message to this region's simulator
     void sendReliableMessage(); // Send the current message to this region's simulator
@@ -440,9 +443,15 @@ private:
     void createVisibleObjects(F32 max_time);
     void updateVisibleEntries(F32 max_time); //update visible entries
 
+    // the cache file entries were added to the region's, probe what waited for them
+    void onObjectCacheLoaded(bool success);
     void addCacheMiss(U32 id, LLViewerRegion::eCacheMissType miss_type);
+    // screen size of the cached entry (its linkset root for children) as seen from the camera
+    F32 getCacheMissPriority(U32 local_id, const LLVector4a& local_camera_origin);
     void decodeBoundingInfo(LLVOCacheEntry* entry);
     bool isNonCacheableObjectCreated(U32 local_id);
+    // what the region's objects use, saved with the object cache for LLVOCache::prefetchAssets
+    void collectCacheAssets();
 
 public:
     void applyCacheMiscExtras(LLViewerObject* obj);
@@ -565,6 +574,7 @@ public:
     // Regions can have order 10,000 objects, so assume
     // a structure of size 2^14 = 16,000
     bool                                    mCacheLoaded;
+    U32                                     mCacheLoadSerial; // of the load in progress, 0 when none is
     bool                                    mCacheDirty;
     bool    mAlive;                 // can become false if circuit disconnects
     bool    mSimulatorFeaturesReceived;
@@ -587,14 +597,16 @@ public:
     class CacheMissItem
     {
     public:
-        CacheMissItem(U32 id, LLViewerRegion::eCacheMissType miss_type) : mID(id), mType(miss_type) {}
+        CacheMissItem(U32 id, LLViewerRegion::eCacheMissType miss_type) : mID(id), mType(miss_type), mPriority(0.f) {}
 
         U32                         mID;     //local object id
         LLViewerRegion::eCacheMissType  mType;  // cache miss type
+        F32                         mPriority; // screen size of the cached entry, larger is requested first
 
         typedef std::list<CacheMissItem> cache_miss_list_t;
     };
     CacheMissItem::cache_miss_list_t   mCacheMissList;
+    LLFrameTimer mCacheMissRequestTimer; // since the last window of cache miss requests was sent
     U64 mRegionCacheHitCount;
     U64 mRegionCacheMissCount;
 
@@ -27,6 +27,7 @@
 
 #include "llviewerprecompiledheaders.h"
 
+#include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
 
 #include "llfeaturemanager.h"
@@ -41,6 +42,7 @@
 #include "llsky.h"
 
 #include "pipeline.h"
+#include "lldrawpooltree.h"
 
 #include "llfile.h"
 #include "llviewerwindow.h"
@@ -148,13 +150,16 @@ LLGLSLShader            gDeferredSkinnedDiffuseProgram;
 LLGLSLShader            gDeferredSkinnedBumpProgram;
 LLGLSLShader            gDeferredBumpProgram;
 LLGLSLShader            gDeferredTerrainProgram;
+LLGLSLShader            gDeferredTerrainGPUProgram;
 LLGLSLShader            gDeferredTreeProgram;
 LLGLSLShader            gDeferredTreeShadowProgram;
+LLGLSLShader            gDeferredTreeInstancedShadowProgram;
 LLGLSLShader            gDeferredSkinnedTreeShadowProgram;
 LLGLSLShader            gDeferredAvatarProgram;
 LLGLSLShader            gDeferredAvatarAlphaProgram;
 LLGLSLShader            gDeferredLightProgram;
 LLGLSLShader            gDeferredMultiLightProgram[16];
+LLGLSLShader            gDeferredClusteredLightProgram;
 LLGLSLShader            gDeferredSpotLightProgram;
 LLGLSLShader            gDeferredMultiSpotLightProgram;
 LLGLSLShader            gDeferredSunProgram;
@@ -164,6 +169,7 @@ LLGLSLShader            gHazeWaterProgram;
 LLGLSLShader            gDeferredBlurLightProgram;
 LLGLSLShader            gDeferredSoftenProgram;
 LLGLSLShader            gDeferredShadowProgram;
+LLGLSLShader            gDeferredTerrainGPUShadowProgram;
 LLGLSLShader            gDeferredSkinnedShadowProgram;
 LLGLSLShader            gDeferredShadowCubeProgram;
 LLGLSLShader            gDeferredShadowAlphaMaskProgram;
@@ -178,6 +184,8 @@ LLGLSLShader            gDeferredAvatarShadowProgram;
 LLGLSLShader            gDeferredAvatarAlphaShadowProgram;
 LLGLSLShader            gDeferredAvatarAlphaMaskShadowProgram;
 LLGLSLShader            gDeferredAlphaProgram;
+LLGLSLShader            gDeferredAlphaOITProgram;
+LLGLSLShader            gDeferredAlphaOITCompositeProgram;
 LLGLSLShader            gHUDAlphaProgram;
 LLGLSLShader            gDeferredSkinnedAlphaProgram;
 LLGLSLShader            gDeferredAlphaImpostorProgram;
@@ -206,6 +214,7 @@ LLGLSLShader            gSMAAEdgeDetectProgram[4];
 LLGLSLShader            gSMAABlendWeightsProgram[4];
 LLGLSLShader            gSMAANeighborhoodBlendProgram[4];
 LLGLSLShader            gCASProgram;
+LLGLSLShader            gTemporalUpscaleProgram;
 LLGLSLShader            gDeferredPostNoDoFProgram;
 LLGLSLShader            gDeferredPostNoDoFNoiseProgram;
 LLGLSLShader            gDeferredWLSkyProgram;
@@ -233,8 +242,10 @@ LLGLSLShader            gDeferredPBROpaqueProgram;
 LLGLSLShader            gDeferredSkinnedPBROpaqueProgram;
 LLGLSLShader            gHUDPBRAlphaProgram;
 LLGLSLShader            gDeferredPBRAlphaProgram;
+LLGLSLShader            gDeferredPBRAlphaOITProgram;
 LLGLSLShader            gDeferredSkinnedPBRAlphaProgram;
 LLGLSLShader            gDeferredPBRTerrainProgram[TERRAIN_PAINT_TYPE_COUNT];
+LLGLSLShader            gDeferredPBRTerrainGPUProgram[TERRAIN_PAINT_TYPE_COUNT];
 
 LLGLSLShader            gGLTFPBRMetallicRoughnessProgram;
 
@@ -256,6 +267,21 @@ static bool make_rigged_variant(LLGLSLShader& shader, LLGLSLShader& riggedShader
     return riggedShader.createShader();
 }
 
+// the same shader writing to the weighted blended transparency accumulation targets, see LLDrawPoolAlpha::renderOIT
+static bool make_oit_variant(LLGLSLShader& shader, LLGLSLShader& oitShader)
+{
+    oitShader.mName = llformat("%s OIT", shader.mName.c_str());
+    oitShader.mFeatures = shader.mFeatures;
+    oitShader.mDefines = shader.mDefines;
+
+    oitShader.addPermutation("WB_OIT", "1");
+    oitShader.mShaderFiles = shader.mShaderFiles;
+    oitShader.mShaderLevel = shader.mShaderLevel;
+    oitShader.mShaderGroup = shader.mShaderGroup;
+
+    return oitShader.createShader();
+}
+
 
 static bool make_gltf_variant(LLGLSLShader& shader, LLGLSLShader& variant, bool alpha_blend, bool rigged, bool unlit, bool multi_uv, bool use_sun_shadow)
 {
@@ -412,6 +438,7 @@ void LLViewerShaderMgr::finalizeShaderList()
     mShaderList.push_back(&gHazeWaterProgram);
     mShaderList.push_back(&gDeferredSoftenProgram);
     mShaderList.push_back(&gDeferredAlphaProgram);
+    mShaderList.push_back(&gDeferredAlphaOITProgram);
     mShaderList.push_back(&gHUDAlphaProgram);
     mShaderList.push_back(&gDeferredAlphaImpostorProgram);
     mShaderList.push_back(&gDeferredFullbrightProgram);
@@ -431,6 +458,7 @@ void LLViewerShaderMgr::finalizeShaderList()
     mShaderList.push_back(&gDeferredWLMoonProgram);
     mShaderList.push_back(&gDeferredWLSunProgram);
     mShaderList.push_back(&gDeferredPBRAlphaProgram);
+    mShaderList.push_back(&gDeferredPBRAlphaOITProgram);
     mShaderList.push_back(&gHUDPBRAlphaProgram);
     mShaderList.push_back(&gDeferredPostTonemapProgram);
     mShaderList.push_back(&gNoPostTonemapProgram);
@@ -447,10 +475,12 @@ void LLViewerShaderMgr::finalizeShaderList()
 
     mShaderList.push_back(&gDeferredAvatarProgram);
     mShaderList.push_back(&gDeferredTerrainProgram);
+    mShaderList.push_back(&gDeferredTerrainGPUProgram);
 
     for (U32 paint_type = 0; paint_type < TERRAIN_PAINT_TYPE_COUNT; ++paint_type)
     {
         mShaderList.push_back(&gDeferredPBRTerrainProgram[paint_type]);
+        mShaderList.push_back(&gDeferredPBRTerrainGPUProgram[paint_type]);
     }
 
     mShaderList.push_back(&gDeferredDiffuseAlphaMaskProgram);
@@ -502,6 +532,43 @@ S32 LLViewerShaderMgr::getShaderLevel(S32 type)
 //============================================================================
 // Shader Management
 
+// Hashes every file under app_settings/shaders, so that cached program
+// binaries are dropped whenever a shader source changes, not only when the
+// viewer version does.
+static void hash_shader_sources(HBXXH128& hash_obj)
+{
+    LL_PROFILE_ZONE_SCOPED;
+
+    std::string shader_dir = gDirUtilp->getExpandedFilename(LL_PATH_APP_SETTINGS, "shaders");
+#ifdef LL_WINDOWS
+    boost::filesystem::path root(utf8str_to_utf16str(shader_dir));
+#else
+    boost::filesystem::path root(shader_dir);
+#endif
+
+    boost::system::error_code ec;
+    std::vector<boost::filesystem::path> files;
+    for (boost::filesystem::recursive_directory_iterator iter(root, ec), end; iter != end && !ec; iter.increment(ec))
+    {
+        if (boost::filesystem::is_regular_file(iter->path(), ec))
+        {
+            files.push_back(iter->path());
+        }
+    }
+    // directory order is not defined
+    std::sort(files.begin(), files.end());
+
+    std::vector<char> buffer;
+    for (const boost::filesystem::path& file : files)
+    {
+        hash_obj.update(file.lexically_relative(root).generic_string());
+
+        std::ifstream in(file.c_str(), std::ios::binary);
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        hash_obj.update(buffer.data(), buffer.size());
+    }
+}
+
 void LLViewerShaderMgr::setShaders()
 {
     LL_PROFILE_ZONE_SCOPED;
@@ -530,6 +597,7 @@ void LLViewerShaderMgr::setShaders()
         {
             HBXXH128 hash_obj;
             hash_obj.update(LLVersionInfo::instance().getVersion());
+            hash_shader_sources(hash_obj);
             current_cache_version = hash_obj.digest();
 
             old_cache_version = LLUUID(gSavedSettings.getString("RenderShaderCacheVersion"));
@@ -753,6 +821,7 @@ std::string LLViewerShaderMgr::loadBasicShaders()
     shaders.push_back( make_pair( "avatar/avatarSkinV.glsl",                1 ) );
     shaders.push_back( make_pair( "avatar/objectSkinV.glsl",                1 ) );
     shaders.push_back( make_pair( "deferred/textureUtilV.glsl",             1 ) );
+    shaders.push_back( make_pair( "deferred/terrainGPUUtilV.glsl",          1 ) );
     if (gGLManager.mGLSLVersionMajor >= 2 || gGLManager.mGLSLVersionMinor >= 30)
     {
         shaders.push_back( make_pair( "objects/indexedTextureV.glsl",           1 ) );
@@ -812,16 +881,27 @@ std::string LLViewerShaderMgr::loadBasicShaders()
     LLGLSLShader::sGlobalDefines = attribs;
 
     // We no longer have to bind the shaders to global glhandles, they are automatically added to a map now.
+    // Submit them all before checking any, so parallel shader compilation can overlap them.
+    std::vector<GLuint> handles(shaders.size(), 0);
+    std::string failed;
     for (U32 i = 0; i < shaders.size(); i++)
     {
         // Note usage of GL_VERTEX_SHADER
-        if (loadShaderFile(shaders[i].first, shaders[i].second, GL_VERTEX_SHADER, &attribs) == 0)
+        loadShaderFileDeferred(&handles[i], shaders[i].first, shaders[i].second, GL_VERTEX_SHADER, &attribs);
+        if (handles[i] == 0)
         {
+            finishDeferredCompile();
             LL_WARNS("Shader") << "Failed to load vertex shader " << shaders[i].first << LL_ENDL;
             return shaders[i].first;
         }
     }
 
+    if (!finishDeferredCompile(&failed))
+    {
+        LL_WARNS("Shader") << "Failed to load vertex shader " << failed << LL_ENDL;
+        return failed;
+    }
+
     // Load the Basic Fragment Shaders at the appropriate level.
     // (in order of shader function call depth for reference purposes, deepest level first)
 
@@ -854,16 +934,25 @@ std::string LLViewerShaderMgr::loadBasicShaders()
     index_channels.push_back(ch);    shaders.push_back( make_pair( "lighting/lightF.glsl",                  mShaderLevel[SHADER_LIGHTING] ) );
     index_channels.push_back(ch);    shaders.push_back( make_pair( "lighting/lightAlphaMaskF.glsl",                 mShaderLevel[SHADER_LIGHTING] ) );
 
+    handles.assign(shaders.size(), 0);
     for (U32 i = 0; i < shaders.size(); i++)
     {
         // Note usage of GL_FRAGMENT_SHADER
-        if (loadShaderFile(shaders[i].first, shaders[i].second, GL_FRAGMENT_SHADER, &attribs, index_channels[i]) == 0)
+        loadShaderFileDeferred(&handles[i], shaders[i].first, shaders[i].second, GL_FRAGMENT_SHADER, &attribs, index_channels[i]);
+        if (handles[i] == 0)
         {
+            finishDeferredCompile();
             LL_WARNS("Shader") << "Failed to load fragment shader " << shaders[i].first << LL_ENDL;
             return shaders[i].first;
         }
     }
 
+    if (!finishDeferredCompile(&failed))
+    {
+        LL_WARNS("Shader") << "Failed to load fragment shader " << failed << LL_ENDL;
+        return failed;
+    }
+
     return std::string();
 }
 
@@ -1053,6 +1142,7 @@ bool LLViewerShaderMgr::loadShadersDeferred()
     {
         gDeferredTreeProgram.unload();
         gDeferredTreeShadowProgram.unload();
+        gDeferredTreeInstancedShadowProgram.unload();
         gDeferredSkinnedTreeShadowProgram.unload();
         gDeferredDiffuseProgram.unload();
         gDeferredSkinnedDiffuseProgram.unload();
@@ -1064,17 +1154,20 @@ bool LLViewerShaderMgr::loadShadersDeferred()
         gDeferredSkinnedBumpProgram.unload();
         gDeferredImpostorProgram.unload();
         gDeferredTerrainProgram.unload();
+        gDeferredTerrainGPUProgram.unload();
         gDeferredLightProgram.unload();
         for (U32 i = 0; i < LL_DEFERRED_MULTI_LIGHT_COUNT; ++i)
         {
             gDeferredMultiLightProgram[i].unload();
         }
+        gDeferredClusteredLightProgram.unload();
         gDeferredSpotLightProgram.unload();
         gDeferredMultiSpotLightProgram.unload();
         gDeferredSunProgram.unload();
         gDeferredBlurLightProgram.unload();
         gDeferredSoftenProgram.unload();
         gDeferredShadowProgram.unload();
+        gDeferredTerrainGPUShadowProgram.unload();
         gDeferredSkinnedShadowProgram.unload();
         gDeferredShadowCubeProgram.unload();
         gDeferredShadowAlphaMaskProgram.unload();
@@ -1089,6 +1182,8 @@ bool LLViewerShaderMgr::loadShadersDeferred()
         gDeferredAvatarProgram.unload();
         gDeferredAvatarAlphaProgram.unload();
         gDeferredAlphaProgram.unload();
+        gDeferredAlphaOITProgram.unload();
+        gDeferredAlphaOITCompositeProgram.unload();
         gHUDAlphaProgram.unload();
         gDeferredSkinnedAlphaProgram.unload();
         gDeferredFullbrightProgram.unload();
@@ -1118,6 +1213,7 @@ bool LLViewerShaderMgr::loadShadersDeferred()
             gSMAANeighborhoodBlendProgram[i].unload();
         }
         gCASProgram.unload();
+        gTemporalUpscaleProgram.unload();
         gEnvironmentMapProgram.unload();
         gDeferredWLSkyProgram.unload();
         gDeferredWLCloudProgram.unload();
@@ -1149,9 +1245,11 @@ bool LLViewerShaderMgr::loadShadersDeferred()
         gDeferredSkinnedPBROpaqueProgram.unload();
         gDeferredPBRAlphaProgram.unload();
         gDeferredSkinnedPBRAlphaProgram.unload();
+        gDeferredPBRAlphaOITProgram.unload();
         for (U32 paint_type = 0; paint_type < TERRAIN_PAINT_TYPE_COUNT; ++paint_type)
         {
             gDeferredPBRTerrainProgram[paint_type].unload();
+            gDeferredPBRTerrainGPUProgram[paint_type].unload();
         }
 
         return true;
@@ -1437,6 +1535,10 @@ bool LLViewerShaderMgr::loadShadersDeferred()
         shader->mShaderLevel = mShaderLevel[SHADER_DEFERRED];
         success = make_rigged_variant(*shader, gDeferredSkinnedPBRAlphaProgram);
         if (success)
+        {
+            success = make_oit_variant(*shader, gDeferredPBRAlphaOITProgram);
+        }
+        if (success)
         {
             success = shader->createShader();
         }
@@ -1449,6 +1551,9 @@ bool LLViewerShaderMgr::loadShadersDeferred()
 
         shader->mRiggedVariant->mFeatures.calculatesLighting = true;
         shader->mRiggedVariant->mFeatures.hasLighting = true;
+
+        gDeferredPBRAlphaOITProgram.mFeatures.calculatesLighting = true;
+        gDeferredPBRAlphaOITProgram.mFeatures.hasLighting = true;
     }
 
     if (success)
@@ -1476,30 +1581,41 @@ bool LLViewerShaderMgr::loadShadersDeferred()
         S32 detail = gSavedSettings.getS32("RenderTerrainPBRDetail");
         detail = llclamp(detail, TERRAIN_PBR_DETAIL_MIN, TERRAIN_PBR_DETAIL_MAX);
         const S32 mapping = clamp_terrain_mapping(gSavedSettings.getS32("RenderTerrainPBRPlanarSampleCount"));
+        // the GPU variants draw the patches from height maps, see LLTerrainGPU
+        const U32 variants = gSavedSettings.getBOOL("RenderTerrainGPU") ? 2 : 1;
         for (U32 paint_type = 0; paint_type < TERRAIN_PAINT_TYPE_COUNT; ++paint_type)
         {
-            LLGLSLShader* shader = &gDeferredPBRTerrainProgram[paint_type];
-            shader->mName = llformat("Deferred PBR Terrain Shader %d %s %s",
-                    detail,
-                    (paint_type == TERRAIN_PAINT_TYPE_PBR_PAINTMAP ? "paintmap" : "heightmap-with-noise"),
-                    (mapping == 1 ? "flat" : "triplanar"));
-            shader->mFeatures.hasSrgb = true;
-            shader->mFeatures.isAlphaLighting = true;
-            shader->mFeatures.calculatesAtmospherics = true;
-            shader->mFeatures.hasAtmospherics = true;
-            shader->mFeatures.hasGamma = true;
-            shader->mFeatures.hasTransport = true;
-            shader->mFeatures.isPBRTerrain = true;
-
-            shader->mShaderFiles.clear();
-            shader->mShaderFiles.push_back(make_pair("deferred/pbrterrainV.glsl", GL_VERTEX_SHADER));
-            shader->mShaderFiles.push_back(make_pair("deferred/pbrterrainF.glsl", GL_FRAGMENT_SHADER));
-            shader->mShaderLevel = mShaderLevel[SHADER_DEFERRED];
-            shader->addPermutation("TERRAIN_PBR_DETAIL", llformat("%d", detail));
-            shader->addPermutation("TERRAIN_PAINT_TYPE", llformat("%d", paint_type));
-            shader->addPermutation("TERRAIN_PLANAR_TEXTURE_SAMPLE_COUNT", llformat("%d", mapping));
-            success = success && shader->createShader();
-            llassert(success);
+            for (U32 gpu = 0; gpu < variants; ++gpu)
+            {
+                LLGLSLShader* shader = gpu ? &gDeferredPBRTerrainGPUProgram[paint_type] : &gDeferredPBRTerrainProgram[paint_type];
+                shader->mName = llformat("Deferred PBR Terrain Shader %d %s %s%s",
+                        detail,
+                        (paint_type == TERRAIN_PAINT_TYPE_PBR_PAINTMAP ? "paintmap" : "heightmap-with-noise"),
+                        (mapping == 1 ? "flat" : "triplanar"),
+                        (gpu ? " gpu" : ""));
+                shader->mFeatures.hasSrgb = true;
+                shader->mFeatures.isAlphaLighting = true;
+                shader->mFeatures.calculatesAtmospherics = true;
+                shader->mFeatures.hasAtmospherics = true;
+                shader->mFeatures.hasGamma = true;
+                shader->mFeatures.hasTransport = true;
+                shader->mFeatures.isPBRTerrain = true;
+
+                shader->mShaderFiles.clear();
+                shader->mShaderFiles.push_back(make_pair("deferred/pbrterrainV.glsl", GL_VERTEX_SHADER));
+                shader->mShaderFiles.push_back(make_pair("deferred/pbrterrainF.glsl", GL_FRAGMENT_SHADER));
+                shader->mShaderLevel = mShaderLevel[SHADER_DEFERRED];
+                shader->addPermutation("TERRAIN_PBR_DETAIL", llformat("%d", detail));
+                shader->addPermutation("TERRAIN_PAINT_TYPE", llformat("%d", paint_type));
+                shader->addPermutation("TERRAIN_PLANAR_TEXTURE_SAMPLE_COUNT", llformat("%d", mapping));
+                if (gpu)
+                {
+                    shader->mFeatures.isGPUTerrain = true;
+                    shader->addPermutation("TERRAIN_GPU", "1");
+                }
+                success = success && shader->createShader();
+                llassert(success);
+            }
         }
     }
 
@@ -1510,6 +1626,8 @@ bool LLViewerShaderMgr::loadShadersDeferred()
         gDeferredTreeProgram.mShaderFiles.push_back(make_pair("deferred/treeV.glsl", GL_VERTEX_SHADER));
         gDeferredTreeProgram.mShaderFiles.push_back(make_pair("deferred/treeF.glsl", GL_FRAGMENT_SHADER));
         gDeferredTreeProgram.mShaderLevel = mShaderLevel[SHADER_DEFERRED];
+        gDeferredTreeProgram.clearPermutations();
+        gDeferredTreeProgram.addPermutation("TREE_INSTANCES", std::to_string(LLDrawPoolTree::MAX_INSTANCES));
         success = gDeferredTreeProgram.createShader();
     }
 
@@ -1525,6 +1643,19 @@ bool LLViewerShaderMgr::loadShadersDeferred()
         llassert(success);
     }
 
+    if (success)
+    {
+        gDeferredTreeInstancedShadowProgram.mName = "Deferred Tree Instanced Shadow Shader";
+        gDeferredTreeInstancedShadowProgram.mShaderFiles.clear();
+        gDeferredTreeInstancedShadowProgram.mShaderFiles.push_back(make_pair("deferred/treeShadowV.glsl", GL_VERTEX_SHADER));
+        gDeferredTreeInstancedShadowProgram.mShaderFiles.push_back(make_pair("deferred/treeShadowF.glsl", GL_FRAGMENT_SHADER));
+        gDeferredTreeInstancedShadowProgram.mShaderLevel = mShaderLevel[SHADER_DEFERRED];
+        gDeferredTreeInstancedShadowProgram.clearPermutations();
+        gDeferredTreeInstancedShadowProgram.addPermutation("TREE_INSTANCES", std::to_string(LLDrawPoolTree::MAX_INSTANCES));
+        success = gDeferredTreeInstancedShadowProgram.createShader();
+        llassert(success);
+    }
+
     if (success)
     {
         gDeferredSkinnedTreeShadowProgram.mName = "Deferred Skinned Tree Shadow Shader";
@@ -1588,6 +1719,27 @@ bool LLViewerShaderMgr::loadShadersDeferred()
         }
     }
 
+    if (success)
+    {
+        gDeferredClusteredLightProgram.mName = "Deferred Clustered Light Shader";
+        gDeferredClusteredLightProgram.mFeatures.isDeferred = true;
+        gDeferredClusteredLightProgram.mFeatures.hasShadows = true;
+        gDeferredClusteredLightProgram.mFeatures.hasSrgb = true;
+
+        gDeferredClusteredLightProgram.clearPermutations();
+        gDeferredClusteredLightProgram.mShaderFiles.clear();
+        gDeferredClusteredLightProgram.mShaderFiles.push_back(make_pair("deferred/multiPointLightV.glsl", GL_VERTEX_SHADER));
+        gDeferredClusteredLightProgram.mShaderFiles.push_back(make_pair("deferred/clusteredLightF.glsl", GL_FRAGMENT_SHADER));
+        gDeferredClusteredLightProgram.mShaderLevel = mShaderLevel[SHADER_DEFERRED];
+        gDeferredClusteredLightProgram.addPermutation("CLUSTER_TILES_X", llformat("%d", LLLightClusters::TILES_X));
+        gDeferredClusteredLightProgram.addPermutation("CLUSTER_TILES_Y", llformat("%d", LLLightClusters::TILES_Y));
+        gDeferredClusteredLightProgram.addPermutation("CLUSTER_SLICES", llformat("%d", LLLightClusters::SLICES));
+        gDeferredClusteredLightProgram.addPermutation("CLUSTER_INDEX_WIDTH", llformat("%d", LLLightClusters::INDEX_WIDTH));
+
+        success = gDeferredClusteredLightProgram.createShader();
+        llassert(success);
+    }
+
     if (success)
     {
         gDeferredSpotLightProgram.mName = "Deferred SpotLight Shader";
@@ -1741,15 +1893,37 @@ bool LLViewerShaderMgr::loadShadersDeferred()
 
             shader->mShaderLevel = mShaderLevel[SHADER_DEFERRED];
 
-            success = shader->createShader();
+            if (!rigged && !hud)
+            {
+                success = make_oit_variant(*shader, gDeferredAlphaOITProgram);
+            }
+
+            success = success && shader->createShader();
             llassert(success);
 
             // Hack
             shader->mFeatures.calculatesLighting = true;
             shader->mFeatures.hasLighting = true;
+
+            if (!rigged && !hud)
+            {
+                gDeferredAlphaOITProgram.mFeatures.calculatesLighting = true;
+                gDeferredAlphaOITProgram.mFeatures.hasLighting = true;
+            }
         }
     }
 
+    if (success)
+    {
+        gDeferredAlphaOITCompositeProgram.mName = "Deferred Alpha OIT Composite Shader";
+        gDeferredAlphaOITCompositeProgram.mShaderFiles.clear();
+        gDeferredAlphaOITCompositeProgram.mShaderFiles.push_back(make_pair("deferred/postDeferredNoTCV.glsl", GL_VERTEX_SHADER));
+        gDeferredAlphaOITCompositeProgram.mShaderFiles.push_back(make_pair("deferred/alphaOITCompositeF.glsl", GL_FRAGMENT_SHADER));
+        gDeferredAlphaOITCompositeProgram.mShaderLevel = mShaderLevel[SHADER_DEFERRED];
+        success = gDeferredAlphaOITCompositeProgram.createShader();
+        llassert(success);
+    }
+
     if (success)
     {
         LLGLSLShader* shaders[] = {
@@ -2086,6 +2260,19 @@ bool LLViewerShaderMgr::loadShadersDeferred()
         llassert(success);
     }
 
+    if (success && gSavedSettings.getBOOL("RenderTerrainGPU"))
+    {
+        gDeferredTerrainGPUShadowProgram.mName = "Deferred GPU Terrain Shadow Shader";
+        gDeferredTerrainGPUShadowProgram.mFeatures.isGPUTerrain = true;
+        gDeferredTerrainGPUShadowProgram.mShaderFiles.clear();
+        gDeferredTerrainGPUShadowProgram.mShaderFiles.push_back(make_pair("deferred/shadowV.glsl", GL_VERTEX_SHADER));
+        gDeferredTerrainGPUShadowProgram.mShaderFiles.push_back(make_pair("deferred/shadowF.glsl", GL_FRAGMENT_SHADER));
+        gDeferredTerrainGPUShadowProgram.mShaderLevel = mShaderLevel[SHADER_DEFERRED];
+        gDeferredTerrainGPUShadowProgram.addPermutation("TERRAIN_GPU", "1");
+        success = gDeferredTerrainGPUShadowProgram.createShader();
+        llassert(success);
+    }
+
     if (success)
     {
         gDeferredSkinnedShadowProgram.mName = "Deferred Skinned Shadow Shader";
@@ -2227,6 +2414,25 @@ bool LLViewerShaderMgr::loadShadersDeferred()
         llassert(success);
     }
 
+    if (success && gSavedSettings.getBOOL("RenderTerrainGPU"))
+    {
+        gDeferredTerrainGPUProgram.mName = "Deferred GPU Terrain Shader";
+        gDeferredTerrainGPUProgram.mFeatures.hasSrgb = true;
+        gDeferredTerrainGPUProgram.mFeatures.isAlphaLighting = true;
+        gDeferredTerrainGPUProgram.mFeatures.calculatesAtmospherics = true;
+        gDeferredTerrainGPUProgram.mFeatures.hasAtmospherics = true;
+        gDeferredTerrainGPUProgram.mFeatures.hasGamma = true;
+        gDeferredTerrainGPUProgram.mFeatures.isGPUTerrain = true;
+
+        gDeferredTerrainGPUProgram.mShaderFiles.clear();
+        gDeferredTerrainGPUProgram.mShaderFiles.push_back(make_pair("deferred/terrainV.glsl", GL_VERTEX_SHADER));
+        gDeferredTerrainGPUProgram.mShaderFiles.push_back(make_pair("deferred/terrainF.glsl", GL_FRAGMENT_SHADER));
+        gDeferredTerrainGPUProgram.mShaderLevel = mShaderLevel[SHADER_DEFERRED];
+        gDeferredTerrainGPUProgram.addPermutation("TERRAIN_GPU", "1");
+        success = gDeferredTerrainGPUProgram.createShader();
+        llassert(success);
+    }
+
     if (success)
     {
         gDeferredAvatarProgram.mName = "Deferred Avatar Shader";
@@ -2495,6 +2701,17 @@ bool LLViewerShaderMgr::loadShadersDeferred()
         gCASProgram.createShader();
     }
 
+    if (success)
+    {
+        gTemporalUpscaleProgram.mName = "Temporal Upscale Shader";
+        gTemporalUpscaleProgram.mShaderFiles.clear();
+        gTemporalUpscaleProgram.mShaderFiles.push_back(make_pair("deferred/postDeferredNoTCV.glsl", GL_VERTEX_SHADER));
+        gTemporalUpscaleProgram.mShaderFiles.push_back(make_pair("deferred/temporalUpscaleF.glsl", GL_FRAGMENT_SHADER));
+        gTemporalUpscaleProgram.mShaderLevel = mShaderLevel[SHADER_DEFERRED];
+        success = gTemporalUpscaleProgram.createShader();
+        llassert(success);
+    }
+
     if (success)
     {
         gDeferredPostProgram.mName = "Deferred Post Shader";
@@ -62,6 +62,8 @@
 #include "llsdserialize.h"
 #include "llsdutil.h"
 #include "llcorehttputil.h"
+#include "llcoproceduremanager.h"
+#include "llheap.h"
 #include "llvoicevivox.h"
 #include "llinventorymodel.h"
 #include "lluiusage.h"
@@ -199,8 +201,30 @@ LLTrace::SampleStatHandle<LLUnit<F32, LLUnits::Percent> >
 static LLTrace::SampleStatHandle<bool>
                             CHAT_BUBBLES("chatbubbles", "Chat Bubbles Enabled");
 
+static LLTrace::SampleStatHandle<>
+                            AIS_POOL_ACTIVE("aispoolactive", "AIS coprocedures running"),
+                            AIS_POOL_LIMIT("aispoollimit", "AIS coprocedures allowed to run at once"),
+                            AIS_POOL_PENDING("aispoolpending", "AIS coprocedures queued"),
+                            UPLOAD_POOL_ACTIVE("uploadpoolactive", "Upload coprocedures running"),
+                            UPLOAD_POOL_LIMIT("uploadpoollimit", "Upload coprocedures allowed to run at once"),
+                            UPLOAD_POOL_PENDING("uploadpoolpending", "Upload coprocedures queued"),
+                            ASSET_POOL_ACTIVE("assetpoolactive", "Asset storage coprocedures running"),
+                            ASSET_POOL_LIMIT("assetpoollimit", "Asset storage coprocedures allowed to run at once"),
+                            ASSET_POOL_PENDING("assetpoolpending", "Asset storage coprocedures queued");
+
 LLTrace::SampleStatHandle<F64Megabytes > FORMATTED_MEM("formattedmemstat");
 
+static LLTrace::SampleStatHandle<F64Megabytes >
+                            HEAP_IMAGE_MEM("heapimagemem", "Decoded image memory in use"),
+                            HEAP_LLSD_MEM("heapllsdmem", "LLSD memory in use"),
+                            HEAP_GEOMETRY_MEM("heapgeometrymem", "Volume geometry memory in use"),
+                            HEAP_UI_MEM("heapuimem", "UI widget memory in use"),
+                            HEAP_SCENE_MEM("heapscenemem", "Scene object, drawable, face and octree memory in use"),
+                            HEAP_COMMITTED_MEM("heapcommittedmem", "Memory the heap allocator has committed"),
+                            HEAP_OVERHEAD_MEM("heapoverheadmem", "Committed heap memory not in use: fragmentation and cached pages");
+
+static LLTrace::CountStatHandle<> HEAP_SCENE_ALLOCS("heapsceneallocs", "Scene objects, drawables, faces and octree nodes allocated");
+
 SimMeasurement<F64Milliseconds >    SIM_FRAME_TIME("simframemsec", "", LL_SIM_STAT_FRAMEMS),
                                                     SIM_NET_TIME("simnetmsec", "", LL_SIM_STAT_NETMS),
                                                     SIM_OTHER_TIME("simsimothermsec", "", LL_SIM_STAT_SIMOTHERMS),
@@ -223,6 +247,13 @@ LLTrace::SampleStatHandle<F64Milliseconds > FRAMETIME_JITTER("frametimejitter",
                                             FRAMETIME("frametime", "Measured frame time"),
                                             SIM_PING("simpingstat");
 
+LLTrace::SampleStatHandle<F64Milliseconds > GPU_PROBE_TIME("gpuprobetime", "GPU time of reflection probe updates"),
+                                            GPU_SHADOW_TIME("gpushadowtime", "GPU time of sun and moon shadow maps"),
+                                            GPU_GEOMETRY_TIME("gpugeometrytime", "GPU time of the deferred geometry pass"),
+                                            GPU_LIGHTING_TIME("gpulightingtime", "GPU time of deferred lighting, alpha pass included"),
+                                            GPU_ALPHA_TIME("gpualphatime", "GPU time of the alpha pass"),
+                                            GPU_POST_TIME("gpuposttime", "GPU time of post processing");
+
 LLTrace::EventStatHandle<LLUnit<F64, LLUnits::Meters> > AGENT_POSITION_SNAP("agentpositionsnap", "agent position corrections");
 
 LLTrace::EventStatHandle<>  LOADING_WEARABLES_LONG_DELAY("loadingwearableslongdelay", "Wearables took too long to load");
@@ -233,7 +264,8 @@ LLTrace::EventStatHandle<F64Milliseconds >  REGION_CROSSING_TIME("regioncrossing
                                                                 NETWORK_STACKTIME("networkstacktime", "NETWORK_SECS"),
                                                                 IMAGE_STACKTIME("imagestacktime", "IMAGE_SECS"),
                                                                 REBUILD_STACKTIME("rebuildstacktime", "REBUILD_SECS"),
-                                                                RENDER_STACKTIME("renderstacktime", "RENDER_SECS");
+                                                                RENDER_STACKTIME("renderstacktime", "RENDER_SECS"),
+                                                                OBJECT_UPDATE_DECODE_TIME("objectupdatedecodetime", "Time decoding compressed object update blocks per message");
 
 LLTrace::EventStatHandle<F64Seconds >   AVATAR_EDIT_TIME("avataredittime", "Seconds in Edit Appearance"),
                                                             TOOLBOX_TIME("toolboxtime", "Seconds using Toolbox"),
@@ -349,6 +381,44 @@ void update_statistics()
     sample(LLStatViewer::DRAW_DISTANCE,   (F64)gSavedSettings.getF32("RenderFarClip"));
     sample(LLStatViewer::CHAT_BUBBLES,    gSavedSettings.getBOOL("UseChatBubbles"));
 
+    if (LLCoprocedureManager::instanceExists())
+    {
+        LLCoprocedureManager& coprocs = LLCoprocedureManager::instance();
+        sample(LLStatViewer::AIS_POOL_ACTIVE,       (F64)coprocs.countActive("AIS"));
+        sample(LLStatViewer::AIS_POOL_LIMIT,        (F64)coprocs.getConcurrencyLimit("AIS"));
+        sample(LLStatViewer::AIS_POOL_PENDING,      (F64)coprocs.countPending("AIS"));
+        sample(LLStatViewer::UPLOAD_POOL_ACTIVE,    (F64)coprocs.countActive("Upload"));
+        sample(LLStatViewer::UPLOAD_POOL_LIMIT,     (F64)coprocs.getConcurrencyLimit("Upload"));
+        sample(LLStatViewer::UPLOAD_POOL_PENDING,   (F64)coprocs.countPending("Upload"));
+        sample(LLStatViewer::ASSET_POOL_ACTIVE,     (F64)coprocs.countActive("AssetStorage"));
+        sample(LLStatViewer::ASSET_POOL_LIMIT,      (F64)coprocs.getConcurrencyLimit("AssetStorage"));
+        sample(LLStatViewer::ASSET_POOL_PENDING,    (F64)coprocs.countPending("AssetStorage"));
+    }
+
+    size_t heap_in_use = 0;
+    const std::pair<LLTrace::SampleStatHandle<F64Megabytes>*, LLHeap::EHeap> heaps[] = {
+        { &LLStatViewer::HEAP_IMAGE_MEM,    LLHeap::HEAP_IMAGE },
+        { &LLStatViewer::HEAP_LLSD_MEM,     LLHeap::HEAP_LLSD },
+        { &LLStatViewer::HEAP_GEOMETRY_MEM, LLHeap::HEAP_GEOMETRY },
+        { &LLStatViewer::HEAP_UI_MEM,       LLHeap::HEAP_UI },
+        { &LLStatViewer::HEAP_SCENE_MEM,    LLHeap::HEAP_SCENE } };
+    for (const auto& [stat, heap] : heaps)
+    {
+        size_t in_use = LLHeap::getInUse(heap);
+        heap_in_use += in_use;
+        sample(*stat, F64Bytes((F64)in_use));
+    }
+    static U64 last_scene_allocs = 0;
+    U64 scene_allocs = LLHeap::getAllocations(LLHeap::HEAP_SCENE);
+    add(LLStatViewer::HEAP_SCENE_ALLOCS, (F64)(scene_allocs - last_scene_allocs));
+    last_scene_allocs = scene_allocs;
+    // only mimalloc can say what it has committed
+    if (size_t committed = LLHeap::getCommitted())
+    {
+        sample(LLStatViewer::HEAP_COMMITTED_MEM, F64Bytes((F64)committed));
+        sample(LLStatViewer::HEAP_OVERHEAD_MEM, F64Bytes((F64)(committed > heap_in_use ? committed - heap_in_use : 0)));
+    }
+
     typedef LLTrace::StatType<LLTrace::TimeBlockAccumulator>::instance_tracker_t stat_type_t;
 
     record(LLStatViewer::FRAME_STACKTIME, last_frame_recording.getSum(*stat_type_t::getInstance("Frame")));
@@ -211,6 +211,13 @@ extern SimMeasurement<F64Megabytes >    SIM_PHYSICS_MEM;
 extern LLTrace::SampleStatHandle<F64Milliseconds >  FRAMETIME_JITTER,
                                                     SIM_PING;
 
+extern LLTrace::SampleStatHandle<F64Milliseconds >  GPU_PROBE_TIME,
+                                                    GPU_SHADOW_TIME,
+                                                    GPU_GEOMETRY_TIME,
+                                                    GPU_LIGHTING_TIME,
+                                                    GPU_ALPHA_TIME,
+                                                    GPU_POST_TIME;
+
 extern LLTrace::EventStatHandle<LLUnit<F64, LLUnits::Meters> > AGENT_POSITION_SNAP;
 
 extern LLTrace::EventStatHandle<>   LOADING_WEARABLES_LONG_DELAY;
@@ -221,7 +228,8 @@ extern LLTrace::EventStatHandle<F64Milliseconds >   REGION_CROSSING_TIME,
                                                         NETWORK_STACKTIME,
                                                         IMAGE_STACKTIME,
                                                         REBUILD_STACKTIME,
-                                                        RENDER_STACKTIME;
+                                                        RENDER_STACKTIME,
+                                                        OBJECT_UPDATE_DECODE_TIME;
 
 extern LLTrace::EventStatHandle<F64Seconds >    AVATAR_EDIT_TIME,
                                                                 TOOLBOX_TIME,
@@ -38,6 +38,7 @@
 #include "llimage.h"
 #include "llimagebmp.h"
 #include "llimagej2c.h"
+#include "llimagerawpool.h"
 #include "llimagetga.h"
 #include "llstl.h"
 #include "message.h"
@@ -60,6 +61,7 @@
 #include "llvovolume.h"
 #include "llviewermedia.h"
 #include "lltexturecache.h"
+#include "lltexturebudget.h"
 #include "llviewerwindow.h"
 #include "llwindow.h"
 ///////////////////////////////////////////////////////////////////////////////
@@ -511,8 +513,24 @@ void LLViewerTexture::updateClass()
 
     F32 over_pct = (used - target) / target;
 
+    // Video memory pressure is handled by the per-category budgets as long
+    // as they find something to evict, the bias is what is left otherwise
+    static LLCachedControl<bool> use_budgets(gSavedSettings, "RenderTextureBudgets", true);
+    bool budgets_ok = false;
+    if (use_budgets)
+    {
+        // the estimates above count twice what we measure, the budgets work in measured bytes
+        F64 texture_target = llmax((F64)target - vertex_bytes_alloc, 0.0) * 512.0 * 1024.0;
+        budgets_ok = gTextureBudget.update((S64)texture_target, MEMORY_CHECK_WAIT_TIME);
+    }
+
     bool is_sys_low = isSystemMemoryLow();
-    bool is_low = is_sys_low || over_pct > 0.f;
+    bool is_low = is_sys_low || (over_pct > 0.f && !budgets_ok);
+
+    // Spare decode buffers are the first thing to give back when short of
+    // system memory
+    static LLCachedControl<U32> raw_pool_size(gSavedSettings, "TextureRawPoolSize", 64);
+    LLImageRawPool::setMaxBytes(is_sys_low ? 0 : (S64)raw_pool_size() * 1024 * 1024);
 
     static bool was_low = false;
     static bool was_sys_low = false;
@@ -845,6 +863,12 @@ void LLViewerTexture::addFace(U32 ch, LLFace* facep)
     facep->setIndexInTex(ch, mNumFaces[ch]);
     mNumFaces[ch]++;
     mLastFaceListUpdateTimer.reset();
+
+    LLViewerFetchedTexture* fetched = LLViewerTextureManager::staticCastToFetchedTexture(this);
+    if (fetched)
+    {
+        gTextureList.markPriorityDirty(fetched);
+    }
 }
 
 //virtual
@@ -867,6 +891,12 @@ void LLViewerTexture::removeFace(U32 ch, LLFace* facep)
         mNumFaces[ch] = 0;
     }
     mLastFaceListUpdateTimer.reset();
+
+    LLViewerFetchedTexture* fetched = LLViewerTextureManager::staticCastToFetchedTexture(this);
+    if (fetched)
+    {
+        gTextureList.markPriorityDirty(fetched);
+    }
 }
 
 S32 LLViewerTexture::getTotalNumFaces() const
@@ -1672,6 +1702,21 @@ void LLViewerFetchedTexture::processTextureStats()
         {
             mDesiredDiscardLevel = 0;
         }
+        else if (mDontDiscard && mBoostLevel == LLGLTexture::BOOST_THUMBNAIL
+                 && mKnownDrawWidth > 0 && mKnownDrawHeight > 0 && mFullWidth > 0 && mFullHeight > 0)
+        {
+            // Thumbnails get scaled down to the size they are drawn at once loaded,
+            // don't fetch more than that
+            mDesiredDiscardLevel = (S8)llmin(log((F32)mFullWidth / mKnownDrawWidth) / log_2,
+                                                 log((F32)mFullHeight / mKnownDrawHeight) / log_2);
+            mDesiredDiscardLevel = llclamp(mDesiredDiscardLevel, (S8)0, (S8)getMaxDiscardLevel());
+            mKnownDrawSizeChanged = false;
+
+            if (getDiscardLevel() >= 0 && (getDiscardLevel() <= mDesiredDiscardLevel))
+            {
+                mFullyLoaded = true;
+            }
+        }
         else if (mDontDiscard && (mBoostLevel == LLGLTexture::BOOST_ICON || mBoostLevel == LLGLTexture::BOOST_THUMBNAIL))
         {
             if (mFullWidth > MAX_IMAGE_SIZE_DEFAULT || mFullHeight > MAX_IMAGE_SIZE_DEFAULT)
@@ -1763,7 +1808,12 @@ bool LLViewerFetchedTexture::isActiveFetching()
 
 void LLViewerFetchedTexture::setBoostLevel(S32 level)
 {
+    const bool changed = level != getBoostLevel();
     LLViewerTexture::setBoostLevel(level);
+    if (changed)
+    {
+        gTextureList.markPriorityDirty(this);
+    }
 
     if (level >= LLViewerTexture::BOOST_HIGH)
     {
@@ -2939,6 +2989,11 @@ void LLViewerLODTexture::processTextureStats()
         mDesiredDiscardLevel = llmin(getMaxDiscardLevel() + 1, (S32)discard_level);
         // Clamp to min desired discard
         mDesiredDiscardLevel = llmin(mMinDesiredDiscardLevel, mDesiredDiscardLevel);
+        // Stay at the level the VRAM budget evicted us to
+        if (mBudgetDiscardLevel > mDesiredDiscardLevel && mBoostLevel < LLGLTexture::BOOST_AVATAR_BAKED)
+        {
+            mDesiredDiscardLevel = llmin(mBudgetDiscardLevel, (S8)getMaxDiscardLevel());
+        }
 
         //
         // At this point we've calculated the quality level that we want,
@@ -3065,6 +3120,20 @@ LLViewerMediaTexture* LLViewerMediaTexture::findMediaTexture(const LLUUID& media
     return media_tex;
 }
 
+//static
+S64 LLViewerMediaTexture::getTotalTextureBytes()
+{
+    S64 bytes = 0;
+    for (media_map_t::iterator iter = sMediaMap.begin(); iter != sMediaMap.end(); ++iter)
+    {
+        if (iter->second->hasGLTexture())
+        {
+            bytes += iter->second->getTextureMemory().value();
+        }
+    }
+    return bytes;
+}
+
 LLViewerMediaTexture::LLViewerMediaTexture(const LLUUID& id, bool usemipmaps, LLImageGL* gl_image)
     : LLViewerTexture(id, usemipmaps),
     mMediaImplp(NULL),
@@ -266,6 +266,8 @@ class LLViewerFetchedTexture : public LLViewerTexture
 {
     friend class LLTextureBar; // debug info only
     friend class LLTextureView; // debug info only
+    friend class LLViewerTextureList; // priority scheduling state
+    friend class LLTextureBudget; // eviction state
 
 protected:
     /*virtual*/ ~LLViewerFetchedTexture();
@@ -493,6 +495,13 @@ protected:
     LLFrameTimer mStopFetchingTimer;    // Time since mDecodePriority == 0.f.
 
     bool  mInImageList;             // true if image is in list (in which case don't reset priority!)
+
+    // Priority scheduling, see LLViewerTextureList::updateImagesFetchTextures()
+    S32   mPriorityBucket = -1;     // bucket this image is in, -1 if not scheduled
+    U32   mPriorityBucketIndex = 0; // position in that bucket
+    U32   mPriorityUpdateFrame = 0; // gFrameCount of the last re-evaluation
+    // Discard level the VRAM budget holds this image at, see LLTextureBudget
+    S8    mBudgetDiscardLevel = 0;
     // This needs to be atomic, since it is written both in the main thread
     // and in the GL image worker thread... HB
     LLAtomicBool  mNeedsCreateTexture;
@@ -602,6 +611,7 @@ public:
     static void cleanUpClass() ;
 
     static LLViewerMediaTexture* findMediaTexture(const LLUUID& media_id) ;
+    static S64 getTotalTextureBytes() ;
     static void removeMediaImplFromTexture(const LLUUID& media_id) ;
 
 private:
@@ -94,8 +94,14 @@ LLTextureKey::LLTextureKey(LLUUID id, ETexListType tex_type)
 
 LLViewerTextureList::LLViewerTextureList()
     : mForceResetTextureStats(false),
+    mPriorityDiscardBias(0.f),
+    mPriorityFullSweepFrames(0),
     mInitialized(false)
 {
+    for (S32 i = 0; i < PRIORITY_BUCKET_COUNT; ++i)
+    {
+        mPriorityBucketCursor[i] = 0;
+    }
 }
 
 void LLViewerTextureList::init()
@@ -113,7 +119,7 @@ void LLViewerTextureList::doPreloadImages()
 
     llassert_always(mInitialized) ;
     llassert_always(mImageList.empty()) ;
-    llassert_always(mUUIDMap.empty()) ;
+    llassert_always(mUUIDMap[TEX_LIST_STANDARD].empty() && mUUIDMap[TEX_LIST_SCALE].empty()) ;
 
     // Set the "missing asset" image
     LLViewerFetchedTexture::sMissingAssetImagep = LLViewerTextureManager::getFetchedTextureFromFile("missing_asset.tga", FTT_LOCAL_FILE, MIPMAP_NO, LLViewerFetchedTexture::BOOST_UI);
@@ -357,7 +363,11 @@ void LLViewerTextureList::shutdown()
     }
     mFastCacheList.clear();
 
-    mUUIDMap.clear();
+    clearPriorityBuckets();
+    for (uuid_map_t& uuid_map : mUUIDMap)
+    {
+        uuid_map.clear();
+    }
 
     mImageList.clear();
 
@@ -698,20 +708,22 @@ LLViewerFetchedTexture* LLViewerTextureList::createImage(const LLUUID &image_id,
 void LLViewerTextureList::findTexturesByID(const LLUUID &image_id, std::vector<LLViewerFetchedTexture*> &output)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
-    LLTextureKey search_key(image_id, TEX_LIST_STANDARD);
-    uuid_map_t::iterator iter = mUUIDMap.lower_bound(search_key);
-    while (iter != mUUIDMap.end() && iter->first.textureId == image_id)
+    for (const uuid_map_t& uuid_map : mUUIDMap)
     {
-        output.push_back(iter->second);
-        iter++;
+        uuid_map_t::const_iterator iter = uuid_map.find(image_id);
+        if (iter != uuid_map.end())
+        {
+            output.push_back(iter->second);
+        }
     }
 }
 
 LLViewerFetchedTexture *LLViewerTextureList::findImage(const LLTextureKey &search_key)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
-    uuid_map_t::iterator iter = mUUIDMap.find(search_key);
-    if (iter == mUUIDMap.end())
+    const uuid_map_t& uuid_map = mUUIDMap[search_key.textureType];
+    uuid_map_t::const_iterator iter = uuid_map.find(search_key.textureId);
+    if (iter == uuid_map.end())
         return NULL;
     return iter->second;
 }
@@ -766,8 +778,9 @@ void LLViewerTextureList::removeImageFromList(LLViewerFetchedTexture *image)
             << " but doesn't have mInImageList set"
             << " ref count is " << image->getNumRefs()
             << LL_ENDL;
-        uuid_map_t::iterator iter = mUUIDMap.find(LLTextureKey(image->getID(), (ETexListType)image->getTextureListType()));
-        if(iter == mUUIDMap.end())
+        const uuid_map_t& uuid_map = mUUIDMap[image->getTextureListType()];
+        uuid_map_t::const_iterator iter = uuid_map.find(image->getID());
+        if(iter == uuid_map.end())
         {
             LL_INFOS() << "Image  " << image->getID() << " is also not in mUUIDMap!" << LL_ENDL ;
         }
@@ -805,12 +818,19 @@ void LLViewerTextureList::addImage(LLViewerFetchedTexture *new_image, ETexListTy
     if (image)
     {
         LL_INFOS() << "Image with ID " << image_id << " already in list" << LL_ENDL;
+        if (image != new_image)
+        {
+            // no longer reachable through mUUIDMap, stop scheduling it
+            removeFromPriorityBuckets(image);
+        }
     }
     sNumImages++;
 
     addImageToList(new_image);
-    mUUIDMap[key] = new_image;
+    mUUIDMap[tex_type][image_id] = new_image;
     new_image->setTextureListType(tex_type);
+    updatePriorityBucket(new_image);
+    markPriorityDirty(new_image);
 }
 
 
@@ -823,13 +843,85 @@ void LLViewerTextureList::deleteImage(LLViewerFetchedTexture *image)
         {
             mCallbackList.erase(image);
         }
-        LLTextureKey key(image->getID(), (ETexListType)image->getTextureListType());
-        llverify(mUUIDMap.erase(key) == 1);
+        llverify(mUUIDMap[image->getTextureListType()].erase(image->getID()) == 1);
         sNumImages--;
+        removeFromPriorityBuckets(image);
         removeImageFromList(image);
     }
 }
 
+void LLViewerTextureList::markPriorityDirty(LLViewerFetchedTexture* imagep)
+{
+    if (imagep && imagep->mPriorityBucket >= 0)
+    {
+        mPriorityDirtyList.insert(imagep);
+    }
+}
+
+S32 LLViewerTextureList::getPriorityBucket(LLViewerFetchedTexture* imagep) const
+{
+    if (imagep->getBoostLevel() >= LLViewerFetchedTexture::BOOST_HIGH)
+    {
+        return PRIORITY_BUCKET_COUNT - 1;
+    }
+    F32 vsize = imagep->mMaxVirtualSize;
+    if (vsize < 1.f)
+    {
+        return 0;
+    }
+    // one bucket per doubling of the on screen edge length
+    return llclamp(1 + (S32)(log2f(vsize) * 0.5f), 1, PRIORITY_BUCKET_COUNT - 2);
+}
+
+void LLViewerTextureList::updatePriorityBucket(LLViewerFetchedTexture* imagep)
+{
+    S32 bucket = getPriorityBucket(imagep);
+    if (bucket == imagep->mPriorityBucket)
+    {
+        return;
+    }
+    removeFromPriorityBuckets(imagep);
+
+    priority_bucket_t& images = mPriorityBuckets[bucket];
+    imagep->mPriorityBucket = bucket;
+    imagep->mPriorityBucketIndex = (U32)images.size();
+    images.push_back(imagep);
+}
+
+void LLViewerTextureList::removeFromPriorityBuckets(LLViewerFetchedTexture* imagep)
+{
+    mPriorityDirtyList.erase(imagep);
+    if (imagep->mPriorityBucket < 0)
+    {
+        return;
+    }
+
+    priority_bucket_t& images = mPriorityBuckets[imagep->mPriorityBucket];
+    llassert(imagep->mPriorityBucketIndex < images.size() && images[imagep->mPriorityBucketIndex] == imagep);
+    LLViewerFetchedTexture* last = images.back();
+    images[imagep->mPriorityBucketIndex] = last;
+    last->mPriorityBucketIndex = imagep->mPriorityBucketIndex;
+    images.pop_back();
+
+    imagep->mPriorityBucket = -1;
+    imagep->mPriorityBucketIndex = 0;
+}
+
+void LLViewerTextureList::clearPriorityBuckets()
+{
+    for (S32 bucket = 0; bucket < PRIORITY_BUCKET_COUNT; ++bucket)
+    {
+        for (LLViewerFetchedTexture* imagep : mPriorityBuckets[bucket])
+        {
+            imagep->mPriorityBucket = -1;
+            imagep->mPriorityBucketIndex = 0;
+        }
+        mPriorityBuckets[bucket].clear();
+        mPriorityBucketCursor[bucket] = 0;
+    }
+    mPriorityDirtyList.clear();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 
@@ -1260,52 +1352,105 @@ F32 LLViewerTextureList::updateImagesFetchTextures(F32 max_time)
     typedef std::vector<LLPointer<LLViewerFetchedTexture> > entries_list_t;
     entries_list_t entries;
 
-    // update N textures at beginning of mImageList
-    U32 update_count = 0;
     static const S32 MIN_UPDATE_COUNT = gSavedSettings.getS32("TextureFetchUpdateMinCount");       // default: 32
+    const U32 FULL_SWEEP_FRAMES = 20;
 
     // NOTE:  a texture may be deleted as a side effect of some of these updates
     // Deletion rules check ref count, so be careful not to hold any LLPointer references to the textures here other than the one in entries.
 
-    //update MIN_UPDATE_COUNT or 5% of other textures, whichever is greater
-    update_count = llmax((U32) MIN_UPDATE_COUNT, (U32) mUUIDMap.size()/20);
-    update_count = llmin(update_count, (U32) mUUIDMap.size());
+    // A large move of the discard bias changes what every texture should
+    // be at, turn all buckets over quickly for a while
+    if (fabsf(LLViewerTexture::sDesiredDiscardBias - mPriorityDiscardBias) >= 0.5f)
+    {
+        mPriorityDiscardBias = LLViewerTexture::sDesiredDiscardBias;
+        mPriorityFullSweepFrames = FULL_SWEEP_FRAMES;
+    }
 
-    { // copy entries out of UUID map to avoid iterator invalidation from deletion inside updateImageDecodeProiroty or updateFetch below
+    size_t dirty_count = 0;
+    { // copy entries out of the buckets to avoid iterator invalidation from deletion inside updateImageDecodeProiroty or updateFetch below
         LL_PROFILE_ZONE_NAMED_CATEGORY_TEXTURE("vtluift - copy");
 
-        // copy entries out of UUID map for updating
-        entries.reserve(update_count);
-        uuid_map_t::iterator iter = mUUIDMap.upper_bound(mLastUpdateKey);
-        while (update_count-- > 0)
+        // dirty textures first, largest first so they get done when time runs out
+        std::vector<LLViewerFetchedTexture*> dirty(mPriorityDirtyList.begin(), mPriorityDirtyList.end());
+        mPriorityDirtyList.clear();
+        std::sort(dirty.begin(), dirty.end(),
+                  [](const LLViewerFetchedTexture* lhs, const LLViewerFetchedTexture* rhs)
+                  {
+                      return lhs->mPriorityBucket > rhs->mPriorityBucket;
+                  });
+
+        entries.reserve(dirty.size() + MIN_UPDATE_COUNT);
+        for (LLViewerFetchedTexture* imagep : dirty)
+        {
+            if (imagep->getGLTexture())
+            {
+                imagep->mPriorityUpdateFrame = gFrameCount;
+                entries.push_back(imagep);
+            }
+        }
+        dirty_count = entries.size();
+
+        // then a slice of every bucket, so that priorities that were not
+        // pushed by a face still get refreshed
+        for (S32 bucket = PRIORITY_BUCKET_COUNT - 1; bucket >= 0; --bucket)
         {
-            if (iter == mUUIDMap.end())
+            priority_bucket_t& images = mPriorityBuckets[bucket];
+            if (images.empty())
             {
-                iter = mUUIDMap.begin();
+                continue;
+            }
+
+            U32 period = llmin(4U << ((PRIORITY_BUCKET_COUNT - 1 - bucket) / 2), 256U);
+            if (mPriorityFullSweepFrames)
+            {
+                period = llmin(period, FULL_SWEEP_FRAMES);
             }
+            U32 count = ((U32)images.size() + period - 1) / period;
 
-            if (iter->second->getGLTexture())
+            U32& cursor = mPriorityBucketCursor[bucket];
+            while (count-- > 0)
             {
-                entries.push_back(iter->second);
+                if (cursor >= images.size())
+                {
+                    cursor = 0;
+                }
+                LLViewerFetchedTexture* imagep = images[cursor++];
+                if (imagep->mPriorityUpdateFrame != gFrameCount && imagep->getGLTexture())
+                {
+                    imagep->mPriorityUpdateFrame = gFrameCount;
+                    entries.push_back(imagep);
+                }
             }
-            ++iter;
+        }
+
+        if (mPriorityFullSweepFrames)
+        {
+            --mPriorityFullSweepFrames;
         }
     }
 
     LLTimer timer;
 
-    for (auto& imagep : entries)
+    for (size_t i = 0; i < entries.size(); ++i)
     {
-        mLastUpdateKey = LLTextureKey(imagep->getID(), (ETexListType)imagep->getTextureListType());
-
+        LLViewerFetchedTexture* imagep = entries[i];
         if (imagep->getNumRefs() > 1) // make sure this image hasn't been deleted before attempting to update (may happen as a side effect of some other image updating)
         {
             updateImageDecodePriority(imagep);
             imagep->updateFetch();
+            if (imagep->mPriorityBucket >= 0)
+            {
+                updatePriorityBucket(imagep);
+            }
         }
 
-        if (timer.getElapsedTimeF32() > max_time)
+        if ((S32)i >= MIN_UPDATE_COUNT && timer.getElapsedTimeF32() > max_time)
         {
+            // dirty textures that did not fit stay in line for the next frame
+            for (++i; i < dirty_count; ++i)
+            {
+                markPriorityDirty(entries[i]);
+            }
             break;
         }
     }
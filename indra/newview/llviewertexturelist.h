@@ -28,6 +28,7 @@
 #define LL_LLVIEWERTEXTURELIST_H
 
 #include "lluuid.h"
+#include "lluuidhashmap.h"
 //#include "message.h"
 #include "llgl.h"
 #include "llviewertexture.h"
@@ -62,7 +63,8 @@ typedef void (*LLImageCallback)(bool success,
 enum ETexListType
 {
     TEX_LIST_STANDARD = 0,
-    TEX_LIST_SCALE
+    TEX_LIST_SCALE,
+    TEX_LIST_TYPE_COUNT
 };
 
 struct LLTextureKey
@@ -147,6 +149,11 @@ public:
     // - cleans up textures that haven't been referenced in awhile
     void updateImageDecodePriority(LLViewerFetchedTexture* imagep, bool flush_images = true);
 
+    // Queue a texture for priority re-evaluation on the next update, called
+    // when something that feeds into its priority (faces, face pixel area,
+    // boost level) changed
+    void markPriorityDirty(LLViewerFetchedTexture* imagep);
+
 private:
     F32  updateImagesCreateTextures(F32 max_time);
     F32  updateImagesFetchTextures(F32 max_time);
@@ -162,6 +169,11 @@ private:
     void addImageToList(LLViewerFetchedTexture *image);
     void removeImageFromList(LLViewerFetchedTexture *image);
 
+    S32  getPriorityBucket(LLViewerFetchedTexture* imagep) const;
+    void updatePriorityBucket(LLViewerFetchedTexture* imagep);
+    void removeFromPriorityBuckets(LLViewerFetchedTexture* imagep);
+    void clearPriorityBuckets();
+
     LLViewerFetchedTexture * getImage(const LLUUID &image_id,
                                      FTType f_type = FTT_DEFAULT,
                                      bool usemipmap = true,
@@ -238,9 +250,23 @@ public:
     const image_list_t::const_iterator end() const { return mImageList.cend(); }
 
 private:
-    typedef std::map< LLTextureKey, LLPointer<LLViewerFetchedTexture> > uuid_map_t;
-    uuid_map_t mUUIDMap;
-    LLTextureKey mLastUpdateKey;
+    // One map per list type, as the same id may be in both
+    typedef LLUUIDHashMap<LLPointer<LLViewerFetchedTexture> > uuid_map_t;
+    uuid_map_t mUUIDMap[TEX_LIST_TYPE_COUNT];
+
+    // Incremental priority scheduling. Textures in mUUIDMap sit in buckets
+    // by the virtual size they had when last evaluated, roughly one bucket
+    // per doubling of their on screen size, boosted textures on top. Each
+    // frame re-evaluates the dirty textures, largest first, and a slice of
+    // every bucket: the top buckets turn over in a few frames, the bottom
+    // ones in a few seconds.
+    static const S32 PRIORITY_BUCKET_COUNT = 16;
+    typedef std::vector<LLViewerFetchedTexture*> priority_bucket_t;
+    priority_bucket_t mPriorityBuckets[PRIORITY_BUCKET_COUNT];
+    U32 mPriorityBucketCursor[PRIORITY_BUCKET_COUNT];
+    std::unordered_set<LLViewerFetchedTexture*> mPriorityDirtyList;
+    F32 mPriorityDiscardBias;
+    U32 mPriorityFullSweepFrames;
 
     image_list_t mImageList;
 
@@ -667,6 +667,15 @@ public:
             addText(xpos, ypos, llformat("%d Unique Textures", LLImageGL::sUniqueCount));
             ypos += y_inc;
 
+            addText(xpos, ypos, llformat("%d/%d Uniform Sets Skipped", LLGLSLShader::sRedundantUniformSets,
+                                         LLGLSLShader::sRedundantUniformSets + LLGLSLShader::sUniformSets));
+            LLGLSLShader::sUniformSets = LLGLSLShader::sRedundantUniformSets = 0;
+            ypos += y_inc;
+
+            addText(xpos, ypos, llformat("%d Redundant GL State Changes Skipped", LLRender::sRedundantGLCalls));
+            LLRender::sRedundantGLCalls = 0;
+            ypos += y_inc;
+
             addText(xpos, ypos, llformat("%d Render Calls", (U32)last_frame_recording.getSampleCount(LLPipeline::sStatBatchSize)));
             ypos += y_inc;
 
@@ -997,6 +1006,7 @@ void LLViewerWindow::handlePieMenu(S32 x, S32 y, MASK mask)
 
 bool LLViewerWindow::handleAnyMouseClick(LLWindow *window, LLCoordGL pos, MASK mask, EMouseClickType clicktype, bool down, bool& is_toolmgr_action)
 {
+    mRetainedUIInput = true;
     const char* buttonname = "";
     const char* buttonstatestr = "";
     S32 x = pos.mX;
@@ -1818,6 +1828,7 @@ LLViewerWindow::LLViewerWindow(const Params& p)
     mMiddleMouseDown(false),
     mRightMouseDown(false),
     mMouseInWindow( false ),
+    mRetainedUIInput(false),
     mAllowMouseDragging(true),
     mMouseDownTimer(),
     mLastMask( MASK_NONE ),
@@ -2773,6 +2784,7 @@ void LLViewerWindow::draw()
     gUIProgram.unbind();
 
     LLView::sIsDrawing = false;
+    LLView::applyDeferredDirtyRect();
 }
 
 // Takes a single keyup event, usually when UI is visible
@@ -2834,6 +2846,8 @@ bool LLViewerWindow::handleKeyUp(KEY key, MASK mask)
 // Takes a single keydown event, usually when UI is visible
 bool LLViewerWindow::handleKey(KEY key, MASK mask)
 {
+    mRetainedUIInput = true;
+
     // hide tooltips on keypress
     LLToolTipMgr::instance().blockToolTips();
 
@@ -3108,6 +3122,8 @@ bool LLViewerWindow::handleKey(KEY key, MASK mask)
 
 bool LLViewerWindow::handleUnicodeChar(llwchar uni_char, MASK mask)
 {
+    mRetainedUIInput = true;
+
     // HACK:  We delay processing of return keys until they arrive as a Unicode char,
     // so that if you're typing chat text at low frame rate, we don't send the chat
     // until all keystrokes have been entered. JC
@@ -3147,6 +3163,7 @@ bool LLViewerWindow::handleUnicodeChar(llwchar uni_char, MASK mask)
 
 void LLViewerWindow::handleScrollWheel(S32 clicks)
 {
+    mRetainedUIInput = true;
     LLUI::getInstance()->resetMouseIdleTimer();
 
     LLMouseHandler* mouse_captor = gFocusMgr.getMouseCapture();
@@ -3197,6 +3214,7 @@ void LLViewerWindow::handleScrollWheel(S32 clicks)
 
 void LLViewerWindow::handleScrollHWheel(S32 clicks)
 {
+    mRetainedUIInput = true;
     if (LLAppViewer::instance()->quitRequested())
     {
         return;
@@ -3590,6 +3608,36 @@ void LLViewerWindow::updateUI()
     // store resulting hover set for next frame
     swap(mMouseHoverViews, mouse_hover_set);
 
+    if (LLPipeline::RenderUIBuffer)
+    {
+        // The retained UI only redraws what is dirty. Keep the focused view
+        // (caret, typing) current, and everything the mouse is over or just
+        // left when it moves or clicks (highlights, pressed states).
+        // dirtyRect() takes the whole floater either way.
+        if (LLView* focus_view = dynamic_cast<LLView*>(gFocusMgr.getKeyboardFocus()))
+        {
+            focus_view->dirtyRect();
+        }
+        if (mRetainedUIInput || mCurrentMousePoint != mLastMousePoint)
+        {
+            for (const LLHandle<LLView>& handle : mMouseHoverViews)
+            {
+                if (LLView* viewp = handle.get())
+                {
+                    viewp->dirtyRect();
+                }
+            }
+            for (const LLHandle<LLView>& handle : mouse_leave_views)
+            {
+                if (LLView* viewp = handle.get())
+                {
+                    viewp->dirtyRect();
+                }
+            }
+        }
+    }
+    mRetainedUIInput = false;
+
     // only handle hover events when UI is enabled
     if (gPipeline.hasRenderDebugFeatureMask(LLPipeline::RENDER_DEBUG_FEATURE_UI))
     {
@@ -4364,6 +4412,47 @@ LLHUDIcon* LLViewerWindow::cursorIntersectIcon(S32 mouse_x, S32 mouse_y, F32 dep
     return LLHUDIcon::lineSegmentIntersectAll(start, end, intersection);
 }
 
+namespace
+{
+    // The last pick of all objects by cursorIntersect(). The hover tools
+    // pick several times a frame, every frame, mostly with the cursor and
+    // camera standing still, so while the segments, flags and wanted
+    // results match and nothing in any spatial partition has changed, hand
+    // back the same answer. Visibility and render types can still change
+    // under it, so it's only kept for a few frames.
+    struct CursorIntersectCache
+    {
+        static const U32 MAX_FRAMES = 10;
+
+        bool mValid = false;
+        U32 mFrame = 0;
+        U32 mChangeCount = 0;
+        U32 mFlags = 0;
+        U32 mOutputs = 0;
+        LLVector4a mWorldStart, mWorldEnd, mHUDStart, mHUDEnd;
+
+        LLPointer<LLViewerObject> mFound;
+        bool mInWorld = false;
+        S32 mFaceHit = -1, mGLTFNodeHit = -1, mGLTFPrimitiveHit = -1;
+        LLVector4a mIntersection, mNormal, mTangent;
+        LLVector2 mUV;
+
+        bool matches(U32 flags, U32 outputs, const LLVector4a& world_start, const LLVector4a& world_end,
+                     const LLVector4a& hud_start, const LLVector4a& hud_end) const
+        {
+            return mValid
+                && gFrameCount - mFrame <= MAX_FRAMES
+                && mChangeCount == LLSpatialPartition::sChangeCount
+                && mFlags == flags
+                && (outputs & ~mOutputs) == 0
+                && (!mFound || !mFound->isDead())
+                && mWorldStart.equals3(world_start) && mWorldEnd.equals3(world_end)
+                && mHUDStart.equals3(hud_start) && mHUDEnd.equals3(hud_end);
+        }
+    };
+    CursorIntersectCache sCursorIntersectCache;
+}
+
 LLViewerObject* LLViewerWindow::cursorIntersect(S32 mouse_x, S32 mouse_y, F32 depth,
                                                 LLViewerObject *this_object,
                                                 S32 this_face,
@@ -4461,6 +4550,29 @@ LLViewerObject* LLViewerWindow::cursorIntersect(S32 mouse_x, S32 mouse_y, F32 de
     }
     else // check ALL objects
     {
+        CursorIntersectCache& cache = sCursorIntersectCache;
+        U32 flags = (pick_transparent << 0) | (pick_rigged << 1) | (pick_unselectable << 2) | (pick_reflection_probe << 3);
+        U32 outputs = ((face_hit != NULL) << 0) | ((gltf_node_hit != NULL) << 1) | ((gltf_primitive_hit != NULL) << 2)
+                    | ((intersection != NULL) << 3) | ((uv != NULL) << 4) | ((normal != NULL) << 5) | ((tangent != NULL) << 6);
+
+        if (cache.matches(flags, outputs, mw_start, mw_end, mh_start, mh_end))
+        {
+            found = cache.mFound;
+            if (face_hit)           *face_hit = cache.mFaceHit;
+            if (gltf_node_hit)      *gltf_node_hit = cache.mGLTFNodeHit;
+            if (gltf_primitive_hit) *gltf_primitive_hit = cache.mGLTFPrimitiveHit;
+            if (intersection)       *intersection = cache.mIntersection;
+            if (uv)                 *uv = cache.mUV;
+            if (normal)             *normal = cache.mNormal;
+            if (tangent)            *tangent = cache.mTangent;
+            if (found && cache.mInWorld && !pick_transparent)
+            {
+                gDebugRaycastIntersection = cache.mIntersection;
+            }
+            return found;
+        }
+
+        bool in_world = false;
         found = gPipeline.lineSegmentIntersectInHUD(mh_start, mh_end, pick_transparent,
                                                     face_hit, intersection, uv, normal, tangent);
 
@@ -4468,11 +4580,31 @@ LLViewerObject* LLViewerWindow::cursorIntersect(S32 mouse_x, S32 mouse_y, F32 de
         {
             found = gPipeline.lineSegmentIntersectInWorld(mw_start, mw_end, pick_transparent, pick_rigged, pick_unselectable, pick_reflection_probe,
                                                           face_hit, gltf_node_hit, gltf_primitive_hit, intersection, uv, normal, tangent);
+            in_world = true;
             if (found && !pick_transparent)
             {
                 gDebugRaycastIntersection = *intersection;
             }
         }
+
+        cache.mValid = true;
+        cache.mFrame = gFrameCount;
+        cache.mChangeCount = LLSpatialPartition::sChangeCount;
+        cache.mFlags = flags;
+        cache.mOutputs = outputs;
+        cache.mWorldStart = mw_start;
+        cache.mWorldEnd = mw_end;
+        cache.mHUDStart = mh_start;
+        cache.mHUDEnd = mh_end;
+        cache.mFound = found;
+        cache.mInWorld = in_world;
+        if (face_hit)           cache.mFaceHit = *face_hit;
+        if (gltf_node_hit)      cache.mGLTFNodeHit = *gltf_node_hit;
+        if (gltf_primitive_hit) cache.mGLTFPrimitiveHit = *gltf_primitive_hit;
+        if (intersection)       cache.mIntersection = *intersection;
+        if (uv)                 cache.mUV = *uv;
+        if (normal)             cache.mNormal = *normal;
+        if (tangent)            cache.mTangent = *tangent;
     }
 
     return found;
@@ -4984,7 +5116,7 @@ bool LLViewerWindow::rawSnapshot(LLImageRaw *raw, S32 image_width, S32 image_hei
     S32 original_height = 0;
     bool reset_deferred = false;
 
-    LLRenderTarget scratch_space;
+    LLRenderTarget* scratch_space = nullptr;
 
     F32 scale_factor = 1.0f ;
     if (!keep_window_aspect || (image_width > window_width) || (image_height > window_height))
@@ -4992,8 +5124,13 @@ bool LLViewerWindow::rawSnapshot(LLImageRaw *raw, S32 image_width, S32 image_hei
         if ((image_width <= gGLManager.mGLMaxTextureSize && image_height <= gGLManager.mGLMaxTextureSize) &&
             (image_width > window_width || image_height > window_height) && LLPipeline::sRenderDeferred && !show_ui)
         {
-            U32 color_fmt = type == LLSnapshotModel::SNAPSHOT_TYPE_DEPTH ? GL_DEPTH_COMPONENT : GL_RGBA;
-            if (scratch_space.allocate(image_width, image_height, color_fmt, true))
+            LLRenderTargetPool::Desc desc;
+            desc.mWidth = image_width;
+            desc.mHeight = image_height;
+            desc.mColorFormat = type == LLSnapshotModel::SNAPSHOT_TYPE_DEPTH ? GL_DEPTH_COMPONENT : GL_RGBA;
+            desc.mDepth = true;
+            scratch_space = gRenderTargetPool.acquire(desc, "snapshot");
+            if (scratch_space)
             {
                 original_width = gPipeline.mRT->deferredScreen.getWidth();
                 original_height = gPipeline.mRT->deferredScreen.getHeight();
@@ -5008,11 +5145,12 @@ bool LLViewerWindow::rawSnapshot(LLImageRaw *raw, S32 image_width, S32 image_hei
                     mWorldViewRectRaw.set(0, image_height, image_width, 0);
                     LLViewerCamera::getInstance()->setViewHeightInPixels( mWorldViewRectRaw.getHeight() );
                     LLViewerCamera::getInstance()->setAspect( getWorldViewAspectRatio() );
-                    scratch_space.bindTarget();
+                    scratch_space->bindTarget();
                 }
                 else
                 {
-                    scratch_space.release();
+                    gRenderTargetPool.release(scratch_space);
+                    scratch_space = nullptr;
                     gPipeline.allocateScreenBuffer(original_width, original_height);
                 }
             }
@@ -5113,53 +5251,55 @@ bool LLViewerWindow::rawSnapshot(LLImageRaw *raw, S32 image_width, S32 image_hei
                     swap();
                 }
 
-                for (U32 out_y = 0; out_y < read_height ; out_y++)
+                // Start of this subimage in the output buffer
+                S32 output_buffer_offset = (
+                                            (window_width * subimage_x) // subimage start in x...
+                                            + (raw->getWidth() * window_height * subimage_y) // ...plus subimage start in y...
+                                            - output_buffer_offset_x // ...minus buffer padding x...
+                                            - (output_buffer_offset_y * (raw->getWidth()))  // ...minus buffer padding y...
+                                            ) * raw->getComponents();
+
+                LLAppViewer::instance()->pingMainloopTimeout("LLViewerWindow::rawSnapshot");
+
+                // disable use of glReadPixels when doing nVidia nSight graphics debugging
+                if (!LLRender::sNsightDebugSupport)
                 {
-                    S32 output_buffer_offset = (
-                                                (out_y * (raw->getWidth())) // ...plus iterated y...
-                                                + (window_width * subimage_x) // ...plus subimage start in x...
-                                                + (raw->getWidth() * window_height * subimage_y) // ...plus subimage start in y...
-                                                - output_buffer_offset_x // ...minus buffer padding x...
-                                                - (output_buffer_offset_y * (raw->getWidth()))  // ...minus buffer padding y...
-                                                ) * raw->getComponents();
-
-                    // Ping the watchdog thread every 100 lines to keep us alive (arbitrary number, feel free to change)
-                    if (out_y % 100 == 0)
+                    // Read the whole subimage at once rather than a line at a time, each
+                    // glReadPixels waits for the GPU to be done with the frame
+                    if (type == LLSnapshotModel::SNAPSHOT_TYPE_COLOR)
                     {
-                        LLAppViewer::instance()->pingMainloopTimeout("LLViewerWindow::rawSnapshot");
-                    }
-                    // disable use of glReadPixels when doing nVidia nSight graphics debugging
-                    if (!LLRender::sNsightDebugSupport)
-                    {
-                        if (type == LLSnapshotModel::SNAPSHOT_TYPE_COLOR)
-                        {
-                            glReadPixels(
-                                     subimage_x_offset, out_y + subimage_y_offset,
-                                     read_width, 1,
+                        // rows of the subimage are rows of the output buffer
+                        glPixelStorei(GL_PACK_ROW_LENGTH, raw->getWidth());
+                        glReadPixels(
+                                     subimage_x_offset, subimage_y_offset,
+                                     read_width, read_height,
                                      GL_RGB, GL_UNSIGNED_BYTE,
                                      raw->getData() + output_buffer_offset
                                      );
-                        }
-                        else // LLSnapshotModel::SNAPSHOT_TYPE_DEPTH
-                        {
-                            LLPointer<LLImageRaw> depth_line_buffer = new LLImageRaw(read_width, 1, sizeof(GL_FLOAT)); // need to store floating point values
-                            glReadPixels(
-                                         subimage_x_offset, out_y + subimage_y_offset,
-                                         read_width, 1,
-                                         GL_DEPTH_COMPONENT, GL_FLOAT,
-                                         depth_line_buffer->getData()// current output pixel is beginning of buffer...
-                                         );
+                        glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+                    }
+                    else // LLSnapshotModel::SNAPSHOT_TYPE_DEPTH
+                    {
+                        std::vector<F32> depth_buffer((size_t)read_width * read_height); // need to store floating point values
+                        glReadPixels(
+                                     subimage_x_offset, subimage_y_offset,
+                                     read_width, read_height,
+                                     GL_DEPTH_COMPONENT, GL_FLOAT,
+                                     depth_buffer.data()
+                                     );
 
+                        for (U32 out_y = 0; out_y < read_height; out_y++)
+                        {
+                            U8* output_line = raw->getData() + output_buffer_offset + out_y * raw->getWidth() * raw->getComponents();
+                            const F32* depth_line = depth_buffer.data() + (size_t)out_y * read_width;
                             for (S32 i = 0; i < (S32)read_width; i++)
                             {
-                                F32 depth_float = *(F32*)(depth_line_buffer->getData() + (i * sizeof(F32)));
-
-                                F32 linear_depth_float = 1.f / (depth_conversion_factor_1 - (depth_float * depth_conversion_factor_2));
+                                F32 linear_depth_float = 1.f / (depth_conversion_factor_1 - (depth_line[i] * depth_conversion_factor_2));
                                 U8 depth_byte = F32_to_U8(linear_depth_float, LLViewerCamera::getInstance()->getNear(), LLViewerCamera::getInstance()->getFar());
                                 // write converted scanline out to result image
                                 for (S32 j = 0; j < raw->getComponents(); j++)
                                 {
-                                    *(raw->getData() + output_buffer_offset + (i * raw->getComponents()) + j) = depth_byte;
+                                    *(output_line + (i * raw->getComponents()) + j) = depth_byte;
                                 }
                             }
                         }
@@ -5225,8 +5365,8 @@ bool LLViewerWindow::rawSnapshot(LLImageRaw *raw, S32 image_width, S32 image_hei
         mWorldViewRectRaw = window_rect;
         LLViewerCamera::getInstance()->setViewHeightInPixels( mWorldViewRectRaw.getHeight() );
         LLViewerCamera::getInstance()->setAspect( getWorldViewAspectRatio() );
-        scratch_space.flush();
-        scratch_space.release();
+        scratch_space->flush();
+        gRenderTargetPool.release(scratch_space);
         gPipeline.allocateScreenBuffer(original_width, original_height);
 
     }
@@ -5264,19 +5404,24 @@ bool LLViewerWindow::simpleSnapshot(LLImageRaw* raw, S32 image_width, S32 image_
     S32 original_width = LLPipeline::sRenderDeferred ? gPipeline.mRT->deferredScreen.getWidth() : gViewerWindow->getWorldViewWidthRaw();
     S32 original_height = LLPipeline::sRenderDeferred ? gPipeline.mRT->deferredScreen.getHeight() : gViewerWindow->getWorldViewHeightRaw();
 
-    LLRenderTarget scratch_space;
-    U32 color_fmt = GL_RGBA;
-    if (scratch_space.allocate(image_width, image_height, color_fmt, true))
+    LLRenderTargetPool::Desc desc;
+    desc.mWidth = image_width;
+    desc.mHeight = image_height;
+    desc.mColorFormat = GL_RGBA;
+    desc.mDepth = true;
+    LLRenderTarget* scratch_space = gRenderTargetPool.acquire(desc, "360 snapshot");
+    if (scratch_space)
     {
         if (gPipeline.allocateScreenBuffer(image_width, image_height))
         {
             mWorldViewRectRaw.set(0, image_height, image_width, 0);
 
-            scratch_space.bindTarget();
+            scratch_space->bindTarget();
         }
         else
         {
-            scratch_space.release();
+            gRenderTargetPool.release(scratch_space);
+            scratch_space = nullptr;
             gPipeline.allocateScreenBuffer(original_width, original_height);
         }
     }
@@ -5339,8 +5484,11 @@ bool LLViewerWindow::simpleSnapshot(LLImageRaw* raw, S32 image_width, S32 image_
 
     gPipeline.resetDrawOrders();
     mWorldViewRectRaw = window_rect;
-    scratch_space.flush();
-    scratch_space.release();
+    if (scratch_space)
+    {
+        scratch_space->flush();
+        gRenderTargetPool.release(scratch_space);
+    }
     gPipeline.allocateScreenBuffer(original_width, original_height);
 
     return true;
@@ -520,6 +520,7 @@ private:
     LLFrameTimer    mMouseDownTimer;
     typedef std::set<LLHandle<LLView> > view_handle_set_t;
     view_handle_set_t mMouseHoverViews;
+    bool            mRetainedUIInput;           // a click, key or wheel event since the last updateUI()
 
     // Variables used for tool override switching based on modifier keys.  JC
     MASK            mLastMask;          // used to detect changes in modifier mask
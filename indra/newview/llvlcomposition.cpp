@@ -42,6 +42,11 @@
 #include "noise.h"
 #include "llregionhandle.h" // for from_region_handle
 #include "llviewercontrol.h"
+#include "llworld.h"
+#include "hbxxh.h"
+#include "lldir.h"
+#include "llfile.h"
+#include "workqueue.h"
 
 
 extern LLColor4U MAX_WATER_COLOR;
@@ -140,16 +145,24 @@ bool LLTerrainMaterials::generateMaterials()
     return false;
 }
 
-void LLTerrainMaterials::boost()
+//static
+F32 LLTerrainMaterials::getMaxDecodePriority()
 {
+    return TERRAIN_DECODE_PRIORITY;
+}
+
+void LLTerrainMaterials::boost(F32 virtual_size)
+{
+    virtual_size = llclamp(virtual_size, (F32)(BASE_SIZE * BASE_SIZE), TERRAIN_DECODE_PRIORITY);
+
     for (S32 i = 0; i < ASSET_COUNT; ++i)
     {
         LLPointer<LLViewerFetchedTexture>& tex = mDetailTextures[i];
         llassert(tex.notNull());
-        boost_minimap_texture(tex, TERRAIN_DECODE_PRIORITY);
+        boost_minimap_texture(tex, virtual_size);
 
         LLPointer<LLFetchedGLTFMaterial>& mat = mDetailMaterials[i];
-        boost_minimap_material(mat, TERRAIN_DECODE_PRIORITY);
+        boost_minimap_material(mat, virtual_size);
     }
 }
 
@@ -522,7 +535,62 @@ bool LLVLComposition::generateHeights(const F32 x, const F32 y,
 
     const F32 inv_width = 1.f/mWidth;
 
+    // Everything below depends on the heights of the patch, its place and the
+    // height ranges only, skip the noise when none of them changed
+    std::vector<F32> heights;
+    heights.reserve((x_end - x_begin) * (y_end - y_begin));
+    for (S32 j = y_begin; j < y_end; j++)
+    {
+        for (S32 i = x_begin; i < x_end; i++)
+        {
+            heights.push_back(mSurfacep->resolveHeightRegion(LLVector3(i*mScale, j*mScale, 0.f)) + z_offset);
+        }
+    }
+
+    const S32 bounds[4] = { x_begin, y_begin, x_end, y_end };
+    HBXXH64 hasher;
+    hasher.update(bounds, sizeof(bounds));
+    hasher.update(origin_global.mdV, sizeof(origin_global.mdV));
+    hasher.update(mStartHeight, sizeof(mStartHeight));
+    hasher.update(mHeightRange, sizeof(mHeightRange));
+    hasher.update(heights.data(), heights.size() * sizeof(F32));
+    const U64 hash = hasher.digest();
+
+    const U32 key = (U32)x_begin | ((U32)y_begin << 16);
+    std::map<U32, U64>::iterator patch_it = mPatchHashes.find(key);
+    if (patch_it != mPatchHashes.end() && patch_it->second == hash)
+    {
+        return true;
+    }
+    mPatchHashes[key] = hash;
+
+    std::map<U32, U64>::iterator cached_it = mCachedHashes.find(key);
+    bool cache_hit = false;
+    if (cached_it != mCachedHashes.end())
+    {
+        // Values from a previous session, good if made from the same inputs
+        cache_hit = cached_it->second == hash;
+        if (cache_hit)
+        {
+            for (S32 j = y_begin; j < y_end; j++)
+            {
+                memcpy(mDatap + x_begin + j*mWidth, mCachedData.data() + x_begin + j*mWidth, (x_end - x_begin) * sizeof(F32));
+            }
+        }
+        mCachedHashes.erase(cached_it);
+        if (mCachedHashes.empty())
+        {
+            mCachedData.clear();
+            mCachedData.shrink_to_fit();
+        }
+    }
+    if (cache_hit)
+    {
+        return true;
+    }
+
     // OK, for now, just have the composition value equal the height at the point.
+    std::vector<F32>::const_iterator height_it = heights.begin();
     for (S32 j = y_begin; j < y_end; j++)
     {
         for (S32 i = x_begin; i < x_end; i++)
@@ -546,7 +614,7 @@ bool LLVLComposition::generateHeights(const F32 x, const F32 y,
 
             LLVector3 location(i*mScale, j*mScale, 0.f);
 
-            F32 height = mSurfacep->resolveHeightRegion(location) + z_offset;
+            F32 height = *height_it++;
 
             // Step 0: Measure the exact height at this texel
             vec[0] = (F32)(origin_global.mdV[VX]+location.mV[VX])*xyScaleInv;   //  Adjust to non-integer lattice
@@ -617,3 +685,183 @@ void LLVLComposition::setHeightRange(S32 corner, const F32 range)
 {
     mHeightRange[corner] = range;
 }
+
+namespace
+{
+    const U32 COMPOSITION_CACHE_VERSION = 1;
+
+    struct CompositionCache
+    {
+        std::map<U32, U64> mHashes;
+        std::vector<F32> mData;
+    };
+
+    bool read_composition_cache(const std::string& filename, U32 width, CompositionCache& cache)
+    {
+        LLFILE* fp = LLFile::fopen(filename, "rb");
+        if (!fp)
+        {
+            return false;
+        }
+
+        bool success = false;
+        U32 header[3];
+        if (fread(header, sizeof(header), 1, fp) == 1
+            && header[0] == COMPOSITION_CACHE_VERSION
+            && header[1] == width
+            && header[2] <= width * width)
+        {
+            success = true;
+            for (U32 i = 0; success && i < header[2]; ++i)
+            {
+                U32 key;
+                U64 hash;
+                success = fread(&key, sizeof(key), 1, fp) == 1
+                    && fread(&hash, sizeof(hash), 1, fp) == 1;
+                cache.mHashes[key] = hash;
+            }
+            if (success)
+            {
+                cache.mData.resize(width * width);
+                success = fread(cache.mData.data(), sizeof(F32), cache.mData.size(), fp) == cache.mData.size();
+            }
+        }
+        LLFile::close(fp);
+
+        if (!success)
+        {
+            LL_WARNS("Terrain") << "Discarding invalid composition cache " << filename << LL_ENDL;
+            cache.mHashes.clear();
+            cache.mData.clear();
+            LLFile::remove(filename);
+        }
+        return success;
+    }
+
+    void write_composition_cache(const std::string& filename, U32 width, const CompositionCache& cache)
+    {
+        LLFile::mkdir(gDirUtilp->getDirName(filename));
+
+        // written aside and renamed so that a concurrent load never sees half of it
+        std::string temp_filename = filename + ".tmp";
+        LLFILE* fp = LLFile::fopen(temp_filename, "wb");
+        if (!fp)
+        {
+            return;
+        }
+
+        U32 header[3] = { COMPOSITION_CACHE_VERSION, width, (U32)cache.mHashes.size() };
+        bool success = fwrite(header, sizeof(header), 1, fp) == 1;
+        for (std::map<U32, U64>::const_iterator it = cache.mHashes.begin(); success && it != cache.mHashes.end(); ++it)
+        {
+            success = fwrite(&it->first, sizeof(it->first), 1, fp) == 1
+                && fwrite(&it->second, sizeof(it->second), 1, fp) == 1;
+        }
+        success = success && fwrite(cache.mData.data(), sizeof(F32), cache.mData.size(), fp) == cache.mData.size();
+        LLFile::close(fp);
+
+        LLFile::remove(filename, ENOENT);
+        if (!success || LLFile::rename(temp_filename, filename) != 0)
+        {
+            LL_WARNS("Terrain") << "Failed to write composition cache " << filename << LL_ENDL;
+            LLFile::remove(temp_filename);
+        }
+    }
+}
+
+// static
+std::string LLVLComposition::getCacheFilename(U64 region_handle)
+{
+    U32 region_x, region_y;
+    grid_from_region_handle(region_handle, &region_x, &region_y);
+    return gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "terraincache",
+                                          llformat("composition_%u_%u.bin", region_x, region_y));
+}
+
+void LLVLComposition::loadCache(U64 region_handle)
+{
+    mRegionHandle = region_handle;
+
+    static LLCachedControl<bool> use_cache(gSavedSettings, "TerrainCompositionCache", true);
+    if (!use_cache)
+    {
+        return;
+    }
+
+    std::string filename = getCacheFilename(region_handle);
+    U32 width = mWidth;
+
+    LL::WorkQueue::ptr_t main_queue = LL::WorkQueue::getInstance("mainloop");
+    LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+
+    // Nothing is lost if this can't be posted, the values just get generated
+    if (main_queue && general_queue)
+    {
+        main_queue->postTo(
+            general_queue,
+            [filename, width]() // Work done on general queue
+            {
+                CompositionCache cache;
+                read_composition_cache(filename, width, cache);
+                return cache;
+            },
+            [region_handle](CompositionCache cache) // Callback to main thread
+            {
+                // the region may have gone away while the file was read
+                LLViewerRegion* regionp = LLWorld::instanceExists() ? LLWorld::getInstance()->getRegionFromHandle(region_handle) : NULL;
+                if (regionp && regionp->getComposition() && !cache.mHashes.empty())
+                {
+                    regionp->getComposition()->setCachedPatches(cache.mHashes, cache.mData);
+                }
+            });
+    }
+}
+
+void LLVLComposition::setCachedPatches(std::map<U32, U64>& hashes, std::vector<F32>& data)
+{
+    if (data.size() != (size_t)(mWidth * mWidth))
+    {
+        return;
+    }
+
+    mCachedHashes.clear();
+    for (std::map<U32, U64>::const_iterator it = hashes.begin(); it != hashes.end(); ++it)
+    {
+        // patches generated in the meantime are up to date already
+        if (mPatchHashes.find(it->first) == mPatchHashes.end())
+        {
+            mCachedHashes.insert(*it);
+        }
+    }
+
+    if (mCachedHashes.empty())
+    {
+        mCachedData.clear();
+    }
+    else
+    {
+        mCachedData.swap(data);
+    }
+}
+
+void LLVLComposition::saveCache()
+{
+    static LLCachedControl<bool> use_cache(gSavedSettings, "TerrainCompositionCache", true);
+    if (!use_cache || !mRegionHandle || mPatchHashes.empty())
+    {
+        return;
+    }
+
+    std::string filename = getCacheFilename(mRegionHandle);
+    U32 width = mWidth;
+
+    CompositionCache cache;
+    cache.mHashes = mPatchHashes;
+    cache.mData.assign(mDatap, mDatap + mWidth * mWidth);
+
+    LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+    if (!general_queue || !general_queue->post([filename, width, cache]() { write_composition_cache(filename, width, cache); }))
+    { // queue is gone (shutting down), write it here
+        write_composition_cache(filename, width, cache);
+    }
+}
@@ -35,6 +35,9 @@
 
 #include "llimage.h"
 
+#include <map>
+#include <vector>
+
 class LLSurface;
 
 class LLViewerFetchedTexture;
@@ -71,7 +74,11 @@ public:
 
     bool generateMaterials();
 
-    void boost();
+    // Keeps the detail textures and materials fetched at a resolution of
+    // virtual_size texels, see LLDrawPoolTerrain::boostTerrainDetailTextures()
+    void boost(F32 virtual_size);
+    // Upper bound for virtual_size, the whole texture at its full resolution
+    static F32 getMaxDecodePriority();
 
     virtual LLUUID getDetailAssetID(S32 asset);
     virtual void setDetailAssetID(S32 asset, const LLUUID& id);
@@ -143,6 +150,13 @@ public:
     bool generateHeights(const F32 x, const F32 y, const F32 width, const F32 height);
     bool generateComposition();
 
+    // Composition values of a region outlive the session in the cache. Each
+    // patch is keyed by a hash of everything generateHeights() reads for it,
+    // so values are only reused while the terrain and parameters match.
+    // loadCache() reads the file off the main thread.
+    void loadCache(U64 region_handle);
+    void saveCache();
+
     // Use these as indeces ito the get/setters below that use 'corner'
     enum ECorner
     {
@@ -166,9 +180,19 @@ public:
     bool getParamsReady() const { return mParamsReady; }
 
 protected:
+    static std::string getCacheFilename(U64 region_handle);
+    void setCachedPatches(std::map<U32, U64>& hashes, std::vector<F32>& data);
+
     bool mParamsReady = false;
     LLSurface *mSurfacep;
 
+    U64 mRegionHandle = 0;
+    // Patch (x_begin | y_begin << 16) -> hash of its inputs, for the values in mDatap
+    std::map<U32, U64> mPatchHashes;
+    // Same for the values loaded from the cache, until their patch is generated
+    std::map<U32, U64> mCachedHashes;
+    std::vector<F32> mCachedData;
+
     // Final minimap raw images
     LLPointer<LLImageRaw> mRawImages[LLTerrainMaterials::ASSET_COUNT];
 
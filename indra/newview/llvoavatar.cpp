@@ -31,6 +31,7 @@
 #include <stdio.h>
 #include <ctype.h>
 #include <sstream>
+#include <thread>
 
 #include "llaudioengine.h"
 #include "noise.h"
@@ -95,6 +96,7 @@
 #include "llvovolume.h"
 #include "llworld.h"
 #include "pipeline.h"
+#include "threadpool.h"
 #include "llviewershadermgr.h"
 #include "llsky.h"
 #include "llanimstatelabels.h"
@@ -612,6 +614,9 @@ bool LLVOAvatar::sRenderGroupTitles = true;
 S32 LLVOAvatar::sNumVisibleChatBubbles = 0;
 bool LLVOAvatar::sDebugInvisible = false;
 bool LLVOAvatar::sShowAttachmentPoints = false;
+bool LLVOAvatar::sDeferCharacterMotion = false;
+std::vector<LLPointer<LLVOAvatar> > LLVOAvatar::sDeferredCharacters;
+std::vector<LLPointer<LLVOAvatar> > LLVOAvatar::sDeferredAttachedCharacters;
 bool LLVOAvatar::sShowAnimationDebug = false;
 bool LLVOAvatar::sVisibleInFirstPerson = false;
 F32 LLVOAvatar::sLODFactor = 1.f;
@@ -674,6 +679,7 @@ LLVOAvatar::LLVOAvatar(const LLUUID& id,
     mNeedsSkin(false),
     mLastSkinTime(0.f),
     mUpdatePeriod(1),
+    mAnimationLOD(0),
     mOverallAppearance(AOA_INVISIBLE),
     mVisualComplexityStale(true),
     mVisuallyMuteSetting(AV_RENDER_NORMALLY),
@@ -862,6 +868,7 @@ void LLVOAvatar::markDead()
     }
     mVoiceVisualizer->markDead();
     LLLoadedCallbackEntry::cleanUpCallbackList(&mCallbackTextureList) ;
+    gPipeline.mImpostorAtlas.freeTile(mImpostorTile);
     LLViewerObject::markDead();
 }
 
@@ -1128,10 +1135,11 @@ void LLVOAvatar::destroyGL()
 //static
 void LLVOAvatar::resetImpostors()
 {
+    gPipeline.mImpostorAtlas.release();
+
     for (LLCharacter* character : LLCharacter::sInstances)
     {
         LLVOAvatar* avatar = (LLVOAvatar*)character;
-        avatar->mImpostor.release();
         avatar->mNeedsImpostorUpdate = true;
         avatar->mLastImpostorUpdateReason = 1;
     }
@@ -2671,6 +2679,16 @@ void LLVOAvatar::idleUpdate(LLAgent &agent, const F64 &time)
         return;
     }
 
+    if (sDeferCharacterMotion && isControlAvatar())
+    {
+        LLVOAvatar* attached_av = ((LLControlAvatar*)this)->getAttachedAvatar();
+        if (attached_av && !attached_av->isSelf())
+        {
+            sDeferredAttachedCharacters.push_back(this);
+            return;
+        }
+    }
+
     static LLCachedControl<bool> friends_only(gSavedSettings, "RenderAvatarFriendsOnly", false);
     if (friends_only()
         && !isUIAvatar()
@@ -2801,7 +2819,17 @@ void LLVOAvatar::idleUpdate(LLAgent &agent, const F64 &time)
     // store off last frame's root position to be consistent with camera position
     mLastRootPos = mRoot->getWorldPosition();
     bool detailed_update = updateCharacter(agent);
+    if (mCharacterMotionDeferred)
+    {
+        mDeferredDetailedUpdate = detailed_update;
+        return;
+    }
+
+    idleUpdatePostCharacter(detailed_update);
+}
 
+void LLVOAvatar::idleUpdatePostCharacter(bool detailed_update)
+{
     static LLUICachedControl<bool> visualizers_in_calls("ShowVoiceVisualizersInCalls", false);
     bool voice_enabled = (visualizers_in_calls || LLVoiceClient::getInstance()->inProximalChannel()) &&
                          LLVoiceClient::getInstance()->getVoiceEnabled(mID);
@@ -3860,7 +3888,7 @@ void LLVOAvatar::slamPosition()
     {
         gPipeline.updateMoveNormalAsync(mDrawable);
     }
-    mRoot->updateWorldMatrixChildren();
+    updateJointWorldMatrices();
 }
 
 bool LLVOAvatar::isVisuallyMuted()
@@ -4516,37 +4544,54 @@ void LLVOAvatar::updateOrientation(LLAgent& agent, F32 speed, F32 delta_time)
 // updateTimeStep()
 // Factored out from updateCharacter().
 //
-// Updates the time step used by the motion controller, based on area
-// and avatar count criteria.  This will also stop the
-// ANIM_AGENT_WALK_ADJUST animation under some circumstances.
+// Picks the animation LOD from the pixel area. Each tier past the first
+// lowers the rate motions are evaluated at, the motion controller
+// interpolates the joints in between. Far tiers also skip the additive
+// motions and leave the extended joints alone. Stepping stops the
+// ANIM_AGENT_WALK_ADJUST animation.
 // ------------------------------------------------------------------------
 void LLVOAvatar::updateTimeStep()
 {
-    if (!isSelf() && !isUIAvatar()) // ie, non-self avatars, and animated objects will be affected.
-    {
-        // Note that sInstances counts animated objects and
-        // standard avatars in the same bucket. Is this desirable?
-        F32 time_quantum = clamp_rescale((F32)sInstances.size(), 10.f, 35.f, 0.f, 0.25f);
-        F32 pixel_area_scale = clamp_rescale(mPixelArea, 100, 5000, 1.f, 0.f);
-        F32 time_step = time_quantum * pixel_area_scale;
-        // Extrema:
-        //   If number of avs is 10 or less, time_step is unmodified (flagged with 0.0).
-        //   If area of av is 5000 or greater, time_step is unmodified (flagged with 0.0).
-        //   If number of avs is 35 or greater, and area of av is 100 or less,
-        //   time_step takes the maximum possible value of 0.25.
-        //   Other situations will give values within the (0, 0.25) range.
+    static const F32 TIER_TIME_STEP[] = { 0.f, 1.f / 30.f, 1.f / 15.f, 1.f / 8.f };
+    static const S32 TIER_COUNT = LL_ARRAY_SIZE(TIER_TIME_STEP);
+    static const S32 TIER_SKIP_ADDITIVE = 2;
+    static const S32 TIER_BASE_JOINTS = 3;
+
+    static LLCachedControl<bool> animation_lod(gSavedSettings, "AvatarAnimationLOD", true);
+    static LLCachedControl<F32> lod_area(gSavedSettings, "AvatarAnimationLODArea", 5000.f);
+
+    S32 tier = 0;
+    if (animation_lod && !isSelf() && !isUIAvatar()) // ie, non-self avatars, and animated objects will be affected.
+    {
+        // each tier starts at a quarter of the area of the one before, coming
+        // closer has to clear the boundary by a margin so tiers don't flicker
+        F32 area = lod_area;
+        while (tier < TIER_COUNT - 1)
+        {
+            F32 margin = (tier < mAnimationLOD) ? 1.25f : 1.f;
+            if (mPixelArea >= area * margin)
+            {
+                break;
+            }
+            ++tier;
+            area *= 0.25f;
+        }
+    }
+
+    if (tier != mAnimationLOD)
+    {
+        mAnimationLOD = tier;
+
+        F32 time_step = TIER_TIME_STEP[tier];
         if (time_step != 0.f)
         {
             // disable walk motion servo controller as it doesn't work with motion timesteps
             stopMotion(ANIM_AGENT_WALK_ADJUST);
             removeAnimationData("Walk Speed");
         }
-        // See SL-763 - playback with altered time step does not
-        // appear to work correctly, odd behavior for distant avatars.
-        // As of 11-2017, LLMotionController::updateMotions() will
-        // ignore the value here. Need to re-enable if it's every
-        // fixed.
         mMotionController.setTimeStep(time_step);
+        mMotionController.setSkipAdditiveMotions(tier >= TIER_SKIP_ADDITIVE);
+        mMotionController.setBaseJointsOnly(tier >= TIER_BASE_JOINTS);
     }
 }
 
@@ -4803,8 +4848,7 @@ bool LLVOAvatar::updateCharacter(LLAgent &agent)
     //--------------------------------------------------------------------
     // change animation time quanta based on avatar render load
     //--------------------------------------------------------------------
-    // SL-763 the time step quantization does not currently work.
-    //updateTimeStep();
+    updateTimeStep();
 
     //--------------------------------------------------------------------
     // Update sitting state based on parent and active animation info.
@@ -4850,20 +4894,41 @@ bool LLVOAvatar::updateCharacter(LLAgent &agent)
     // update animations
     if (!visible && !isSelf()) // NOTE: never do a "hidden update" for self avatar as it interrupts controller processing
     {
-        updateMotions(LLCharacter::HIDDEN_UPDATE);
+        mMotionUpdateType = LLCharacter::HIDDEN_UPDATE;
     }
     else if (mSpecialRenderMode == 1) // Animation Preview
     {
-        updateMotions(LLCharacter::FORCE_UPDATE);
+        mMotionUpdateType = LLCharacter::FORCE_UPDATE;
     }
     else
     {
         // Might be better to do HIDDEN_UPDATE if cloud
-        updateMotions(LLCharacter::NORMAL_UPDATE);
+        mMotionUpdateType = LLCharacter::NORMAL_UPDATE;
     }
+    mMotionWasSitGroundConstrained = was_sit_ground_constrained;
+
+    // motions that are still loading may request their assets, those update here
+    if (sDeferCharacterMotion && !isSelf() && !mMotionController.hasLoadingMotions())
+    {
+        mCharacterMotionDeferred = true;
+        sDeferredCharacters.push_back(this);
+        return visible;
+    }
+
+    updateCharacterMotion();
+    finishCharacterUpdate(visible);
+
+    return visible;
+}
+
+void LLVOAvatar::updateCharacterMotion()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
+
+    updateMotions(mMotionUpdateType);
 
     // Special handling for sitting on ground.
-    if (!getParent() && (isSitting() || was_sit_ground_constrained))
+    if (!getParent() && (isSitting() || mMotionWasSitGroundConstrained))
     {
 
         F32 off_z = (F32)LLVector3d(getHoverOffset()).mdV[VZ];
@@ -4880,19 +4945,99 @@ bool LLVOAvatar::updateCharacter(LLAgent &agent)
     // update head position
     updateHeadOffset();
 
+    // Update child joints as needed.
+    updateJointWorldMatrices();
+}
+
+void LLVOAvatar::finishCharacterUpdate(bool visible)
+{
     // Generate footstep sounds when feet hit the ground
     updateFootstepSounds();
 
-    // Update child joints as needed.
-    mRoot->updateWorldMatrixChildren();
-
     if (visible)
     {
         // System avatar mesh vertices need to be reskinned.
         mNeedsSkin = true;
     }
+}
 
-    return visible;
+// static
+void LLVOAvatar::updateDeferredCharacters(LLAgent &agent, const F64 &time)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
+
+    sDeferCharacterMotion = false;
+
+    if (!sDeferredCharacters.empty())
+    {
+        struct Jobs
+        {
+            std::atomic<size_t> mNext{ 0 };
+            std::atomic<size_t> mDone{ 0 };
+            size_t mCount = 0;
+        };
+
+        auto jobs = std::make_shared<Jobs>();
+        jobs->mCount = sDeferredCharacters.size();
+
+        // every avatar is one job, nothing else runs until all of them are done
+        auto work = [jobs]()
+        {
+            size_t i;
+            while ((i = jobs->mNext++) < jobs->mCount)
+            {
+                LLVOAvatar* avatar = sDeferredCharacters[i];
+                if (!avatar->mSharesPose)
+                {
+                    avatar->updateCharacterMotion();
+                }
+                jobs->mDone++;
+            }
+        };
+
+        LL::ThreadPool* pool = gPipeline.mCullPool.get();
+        size_t helpers = pool ? llmin(pool->getWidth(), jobs->mCount - 1) : 0;
+        for (size_t i = 0; i < helpers; ++i)
+        {
+            if (!pool->getQueue().post(work))
+            {
+                break;
+            }
+        }
+
+        work();
+
+        while (jobs->mDone < jobs->mCount)
+        {
+            std::this_thread::yield();
+        }
+
+        // the poses they copy are all evaluated now
+        for (LLVOAvatar* avatar : sDeferredCharacters)
+        {
+            if (avatar->mSharesPose)
+            {
+                avatar->updateCharacterMotion();
+            }
+        }
+
+        for (LLVOAvatar* avatar : sDeferredCharacters)
+        {
+            avatar->mCharacterMotionDeferred = false;
+            avatar->finishCharacterUpdate(avatar->mDeferredDetailedUpdate);
+            avatar->idleUpdatePostCharacter(avatar->mDeferredDetailedUpdate);
+        }
+        sDeferredCharacters.clear();
+    }
+
+    for (LLVOAvatar* avatar : sDeferredAttachedCharacters)
+    {
+        if (!avatar->isDead())
+        {
+            avatar->idleUpdate(agent, time);
+        }
+    }
+    sDeferredAttachedCharacters.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -4992,7 +5137,7 @@ void LLVOAvatar::debugBodySize() const
 //------------------------------------------------------------------------
 void LLVOAvatar::postPelvisSetRecalc()
 {
-    mRoot->updateWorldMatrixChildren();
+    updateJointWorldMatrices();
     computeBodySize();
     dirtyMesh(2);
 }
@@ -5417,7 +5562,8 @@ U32 LLVOAvatar::renderRigid()
 
 U32 LLVOAvatar::renderImpostor(LLColor4U color, S32 diffuse_channel)
 {
-    if (!mImpostor.isComplete())
+    LLImpostorAtlas& atlas = gPipeline.mImpostorAtlas;
+    if (!atlas.isValid(mImpostorTile))
     {
         return 0;
     }
@@ -5453,28 +5599,31 @@ U32 LLVOAvatar::renderImpostor(LLColor4U color, S32 diffuse_channel)
         gGL.flush();
     }
     {
-    gGL.flush();
+    LLVector2 tc_min;
+    LLVector2 tc_max;
+    atlas.getTexCoords(mImpostorTile, tc_min, tc_max);
 
+    // no flush, every impostor samples the atlas and the quads of all of them
+    // go out in one batch, see LLDrawPoolAvatar::endDeferredImpostor
     gGL.color4ubv(color.mV);
-    gGL.getTexUnit(diffuse_channel)->bind(&mImpostor);
+    gGL.getTexUnit(diffuse_channel)->bindManual(LLTexUnit::TT_TEXTURE, atlas.getTarget().getTexture());
     gGL.begin(LLRender::TRIANGLES);
     {
-        gGL.texCoord2f(0.f, 0.f);
+        gGL.texCoord2f(tc_min.mV[0], tc_min.mV[1]);
         gGL.vertex3fv((pos + left - up).mV);
-        gGL.texCoord2f(1.f, 0.f);
+        gGL.texCoord2f(tc_max.mV[0], tc_min.mV[1]);
         gGL.vertex3fv((pos - left - up).mV);
-        gGL.texCoord2f(1.f, 1.f);
+        gGL.texCoord2f(tc_max.mV[0], tc_max.mV[1]);
         gGL.vertex3fv((pos - left + up).mV);
 
-        gGL.texCoord2f(0.f, 0.f);
+        gGL.texCoord2f(tc_min.mV[0], tc_min.mV[1]);
         gGL.vertex3fv((pos + left - up).mV);
-        gGL.texCoord2f(1.f, 1.f);
+        gGL.texCoord2f(tc_max.mV[0], tc_max.mV[1]);
         gGL.vertex3fv((pos - left + up).mV);
-        gGL.texCoord2f(0.f, 1.f);
+        gGL.texCoord2f(tc_min.mV[0], tc_max.mV[1]);
         gGL.vertex3fv((pos + left + up).mV);
     }
     gGL.end();
-    gGL.flush();
     }
 
     return 6;
@@ -6323,13 +6472,10 @@ LLJoint *LLVOAvatar::getJoint( const std::string &name )
 
     if (iter == mJointMap.end() || iter->second == NULL)
     {   //search for joint and cache found joint in lookup table
-        if (mJointAliasMap.empty())
-        {
-            getJointAliases();
-        }
-        joint_alias_map_t::const_iterator alias_iter = mJointAliasMap.find(name);
+        const joint_alias_map_t& aliases = getJointAliases();
+        joint_alias_map_t::const_iterator alias_iter = aliases.find(name);
         std::string canonical_name;
-        if (alias_iter != mJointAliasMap.end())
+        if (alias_iter != aliases.end())
         {
             canonical_name = alias_iter->second;
         }
@@ -6452,6 +6598,7 @@ void LLVOAvatar::clearAttachmentOverrides()
     }
 
     mActiveOverrideMeshes.clear();
+    mActiveOverrideTables.clear();
     onActiveOverrideMeshesChanged();
 }
 
@@ -6707,35 +6854,35 @@ void LLVOAvatar::addAttachmentOverridesForObject(LLViewerObject *vo, std::set<LL
             bool fullRig = jointCnt >= JOINT_COUNT_REQUIRED_FOR_FULLRIG;
             if ( fullRig && !mesh_overrides_loaded )
             {
-                for (unsigned int i = 0; i < jointCnt; ++i)
+                // Resolved once per mesh and skeleton layout, reattaching
+                // the same outfit skips the name lookups
+                LLPointer<LLJointOverrideTable> overrides = LLSkinningUtil::getJointOverrides(pSkinData, this);
+                const std::string av_string = avString();
+                for (const LLJointOverrideTable::Entry& entry : overrides->mPosOverrides)
                 {
-                    std::string lookingForJoint = pSkinData->mJointNames[i].c_str();
-                    LLJoint* pJoint = getJoint( lookingForJoint );
+                    LLJoint* pJoint = getJoint(entry.mJointNum);
                     if (pJoint)
                     {
-                        const LLVector3& jointPos = LLVector3(pSkinData->mAlternateBindMatrix[i].getTranslation());
-                        if (pJoint->aboveJointPosThreshold(jointPos))
-                        {
-                            bool override_changed;
-                            pJoint->addAttachmentPosOverride( jointPos, mesh_id, avString(), override_changed );
+                        bool override_changed;
+                        pJoint->addAttachmentPosOverride( entry.mPosition, mesh_id, av_string, override_changed );
 
-                            if (override_changed)
-                            {
-                                //If joint is a pelvis then handle old/new pelvis to foot values
-                                if ( lookingForJoint == "mPelvis" )
-                                {
-                                    pelvisGotSet = true;
-                                }
-                            }
-                            if (pSkinData->mLockScaleIfJointPosition)
+                        if (override_changed)
+                        {
+                            //If joint is a pelvis then handle old/new pelvis to foot values
+                            if ( entry.mIsPelvis )
                             {
-                                // Note that unlike positions, there's no threshold check here,
-                                // just a lock at the default value.
-                                pJoint->addAttachmentScaleOverride(pJoint->getDefaultScale(), mesh_id, avString());
+                                pelvisGotSet = true;
                             }
                         }
+                        if (overrides->mLockScale)
+                        {
+                            // Note that unlike positions, there's no threshold check here,
+                            // just a lock at the default value.
+                            pJoint->addAttachmentScaleOverride(pJoint->getDefaultScale(), mesh_id, av_string);
+                        }
                     }
                 }
+                mActiveOverrideTables[mesh_id] = overrides;
 
                 if (pelvisZOffset != 0.0F)
                 {
@@ -6913,31 +7060,139 @@ void LLVOAvatar::removeAttachmentOverridesForObject(LLViewerObject *vo)
 //-----------------------------------------------------------------------------
 void LLVOAvatar::removeAttachmentOverridesForObject(const LLUUID& mesh_id)
 {
+    if (mActiveOverrideMeshes.find(mesh_id) == mActiveOverrideMeshes.end())
+    {
+        // never added any, nothing to undo
+        return;
+    }
+
     LLJoint* pJointPelvis = getJoint("mPelvis");
     const std::string av_string = avString();
-    for (S32 joint_num = 0; joint_num < LL_CHARACTER_MAX_ANIMATED_JOINTS; joint_num++)
+
+    // The skeleton only needs recomputing if a joint ends up elsewhere,
+    // not when another mesh overrides it the same way
+    bool overrides_changed = false;
+    auto remove_overrides = [&](LLJoint* pJoint)
     {
-        LLJoint *pJoint = getJoint(joint_num);
-        if (pJoint)
+        LLVector3 scale_before = pJoint->getScale();
+        bool pos_changed;
+        pJoint->removeAttachmentPosOverride(mesh_id, av_string, pos_changed);
+        pJoint->removeAttachmentScaleOverride(mesh_id, av_string);
+        overrides_changed |= pos_changed || pJoint->getScale() != scale_before;
+    };
+
+    // Only the joints the mesh overrode when it was added need a look
+    auto table_iter = mActiveOverrideTables.find(mesh_id);
+    if (table_iter != mActiveOverrideTables.end())
+    {
+        LLPointer<LLJointOverrideTable> overrides = table_iter->second;
+        mActiveOverrideTables.erase(table_iter);
+
+        for (const LLJointOverrideTable::Entry& entry : overrides->mPosOverrides)
         {
-            bool dummy; // unused
-            pJoint->removeAttachmentPosOverride(mesh_id, av_string, dummy);
-            pJoint->removeAttachmentScaleOverride(mesh_id, av_string);
+            LLJoint *pJoint = getJoint(entry.mJointNum);
+            if (pJoint)
+            {
+                remove_overrides(pJoint);
+            }
         }
-        if (pJoint && pJoint == pJointPelvis)
+    }
+    else
+    {
+        for (S32 joint_num = 0; joint_num < LL_CHARACTER_MAX_ANIMATED_JOINTS; joint_num++)
         {
-            removePelvisFixup(mesh_id);
-            // SL-315
-            pJoint->setPosition(LLVector3( 0.0f, 0.0f, 0.0f));
+            LLJoint *pJoint = getJoint(joint_num);
+            if (pJoint)
+            {
+                remove_overrides(pJoint);
+            }
         }
     }
 
-    postPelvisSetRecalc();
+    if (pJointPelvis)
+    {
+        F32 fixup_before = 0.f;
+        F32 fixup_after = 0.f;
+        bool had_fixup = hasPelvisFixup(fixup_before);
+        removePelvisFixup(mesh_id);
+        bool has_fixup = hasPelvisFixup(fixup_after);
+        overrides_changed |= had_fixup != has_fixup || fixup_before != fixup_after;
+
+        // SL-315
+        pJointPelvis->setPosition(LLVector3( 0.0f, 0.0f, 0.0f));
+    }
+
+    if (overrides_changed)
+    {
+        postPelvisSetRecalc();
+    }
 
     mActiveOverrideMeshes.erase(mesh_id);
     onActiveOverrideMeshesChanged();
 }
 
+// collects the ids of the meshes in the linkset of 'objp' that have overrides in 'active'
+static void get_override_meshes(LLViewerObject* objp, const std::set<LLUUID>& active, std::set<LLUUID>& mesh_ids)
+{
+    LLVOVolume* vobj = dynamic_cast<LLVOVolume*>(objp);
+    const LLMeshSkinInfo* skin = vobj ? vobj->getSkinInfo() : nullptr;
+    if (skin && active.find(skin->mMeshID) != active.end())
+    {
+        mesh_ids.insert(skin->mMeshID);
+    }
+    for (LLViewerObject* childp : objp->getChildren())
+    {
+        get_override_meshes(childp, active, mesh_ids);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// removeUnusedAttachmentOverrides
+//
+// Gives the same result as updateAttachmentOverrides() after a detach, but
+// only looks at the other attachments when the detached object carried
+// overrides, and then just for its mesh ids.
+//-----------------------------------------------------------------------------
+void LLVOAvatar::removeUnusedAttachmentOverrides(LLViewerObject *vo)
+{
+    std::set<LLUUID> removed;
+    get_override_meshes(vo, mActiveOverrideMeshes, removed);
+    if (removed.empty())
+    {
+        return;
+    }
+
+    // the same mesh may still be worn by another attachment
+    for (attachment_map_t::iterator iter = mAttachmentPoints.begin();
+         iter != mAttachmentPoints.end() && !removed.empty();
+         ++iter)
+    {
+        LLViewerJointAttachment *attachment_pt = (*iter).second;
+        if (!attachment_pt)
+        {
+            continue;
+        }
+        for (const LLPointer<LLViewerObject>& attached : attachment_pt->mAttachedObjects)
+        {
+            LLViewerObject* objp = attached.get();
+            if (objp && objp != vo && !objp->isAnimatedObject())
+            {
+                std::set<LLUUID> worn;
+                get_override_meshes(objp, mActiveOverrideMeshes, worn);
+                for (const LLUUID& mesh_id : worn)
+                {
+                    removed.erase(mesh_id);
+                }
+            }
+        }
+    }
+
+    for (const LLUUID& mesh_id : removed)
+    {
+        removeAttachmentOverridesForObject(mesh_id);
+    }
+}
+
 //-----------------------------------------------------------------------------
 // getCharacterPosition()
 //-----------------------------------------------------------------------------
@@ -7183,7 +7438,7 @@ void LLVOAvatar::updateVisualParams()
     {
         computeBodySize();
         mLastSkeletonSerialNum = mSkeletonSerialNum;
-        mRoot->updateWorldMatrixChildren();
+        updateJointWorldMatrices();
     }
 
     dirtyMesh();
@@ -7524,10 +7779,11 @@ const LLViewerJointAttachment *LLVOAvatar::attachObject(LLViewerObject *viewer_o
 
     if (!viewer_object->isAnimatedObject())
     {
-        updateAttachmentOverrides();
+        // only the new object can bring new overrides, the ones already worn stay as they are
+        addAttachmentOverridesForObject(viewer_object);
     }
 
-    updateVisualComplexity();
+    updateVisualComplexity(viewer_object);
 
     if (viewer_object->isSelected())
     {
@@ -7815,14 +8071,14 @@ bool LLVOAvatar::detachObject(LLViewerObject *viewer_object)
 
         if (attachment->isObjectAttached(viewer_object))
         {
-            updateVisualComplexity();
+            updateVisualComplexity(viewer_object);
             bool is_animated_object = viewer_object->isAnimatedObject();
             cleanupAttachedMesh(viewer_object);
 
             attachment->removeObject(viewer_object);
             if (!is_animated_object)
             {
-                updateAttachmentOverrides();
+                removeUnusedAttachmentOverrides(viewer_object);
             }
             viewer_object->refreshBakeTexture();
 
@@ -7923,7 +8179,7 @@ void LLVOAvatar::sitOnObject(LLViewerObject *sit_object)
     mRoot->getXform()->setParent(&sit_object->mDrawable->mXform); // LLVOAvatar::sitOnObject
     // SL-315
     mRoot->setPosition(getPosition());
-    mRoot->updateWorldMatrixChildren();
+    updateJointWorldMatrices();
 
     stopMotion(ANIM_AGENT_BODY_NOISE);
 
@@ -9103,16 +9359,92 @@ void LLVOAvatar::applyMorphMask(const U8* tex_data, S32 width, S32 height, S32 n
         return;
     }
 
-    for (morph_list_t::const_iterator iter = mBakedTextureDatas[index].mMaskedMorphs.begin();
-         iter != mBakedTextureDatas[index].mMaskedMorphs.end(); ++iter)
+    const U32 serial = ++mMorphMaskSerial[index];
+
+    auto apply_now = [&]()
+    {
+        for (morph_list_t::const_iterator iter = mBakedTextureDatas[index].mMaskedMorphs.begin();
+             iter != mBakedTextureDatas[index].mMaskedMorphs.end(); ++iter)
+        {
+            const LLMaskedMorph* maskedMorph = (*iter);
+            LLPolyMorphTarget* morph_target = dynamic_cast<LLPolyMorphTarget*>(maskedMorph->mMorphTarget);
+            if (morph_target)
+            {
+                morph_target->applyMask(tex_data, width, height, num_components, maskedMorph->mInvert);
+            }
+        }
+    };
+
+    LL::WorkQueue::ptr_t main_queue = LL::WorkQueue::getInstance("mainloop");
+    LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+    if (mApplyMorphMasksNow || !main_queue || !general_queue)
+    {
+        apply_now();
+        return;
+    }
+
+    // The weights only depend on the mask and the shared mesh data, generate them off
+    // the main thread and apply them to the mesh once they are done.
+    struct MaskJob
+    {
+        LLPolyMorphTarget* mMorphTarget;
+        const LLPolyMorphData* mMorphData;
+        bool mInvert;
+        std::vector<F32> mWeights;
+    };
+    auto jobs = std::make_shared<std::vector<MaskJob>>();
+    for (const LLMaskedMorph* maskedMorph : mBakedTextureDatas[index].mMaskedMorphs)
     {
-        const LLMaskedMorph* maskedMorph = (*iter);
         LLPolyMorphTarget* morph_target = dynamic_cast<LLPolyMorphTarget*>(maskedMorph->mMorphTarget);
-        if (morph_target)
+        if (morph_target && morph_target->getMorphData())
         {
-            morph_target->applyMask(tex_data, width, height, num_components, maskedMorph->mInvert);
+            jobs->push_back({ morph_target, morph_target->getMorphData(), maskedMorph->mInvert, {} });
         }
     }
+    if (jobs->empty())
+    {
+        return;
+    }
+
+    // the mask belongs to the caller
+    auto mask = std::make_shared<std::vector<U8>>();
+    if (tex_data)
+    {
+        mask->assign(tex_data, tex_data + (size_t)width * height * num_components);
+    }
+
+    LLPointer<LLVOAvatar> self(this);
+    bool posted = main_queue->postTo(
+        general_queue,
+        [jobs, mask, width, height, num_components]() // Work done on general queue
+        {
+            LL_PROFILE_ZONE_NAMED("generate morph mask weights");
+            const U8* mask_data = mask->empty() ? nullptr : mask->data();
+            for (MaskJob& job : *jobs)
+            {
+                job.mWeights.resize(job.mMorphData->mNumIndices);
+                LLPolyVertexMask::generateWeights(job.mMorphData, mask_data, width, height, num_components, job.mInvert, job.mWeights.data());
+            }
+        },
+        [self, jobs, index, serial]() // Callback to main thread
+        {
+            // a newer mask supersedes this one
+            if (self->isDead() || self->mMorphMaskSerial[index] != serial)
+            {
+                return;
+            }
+
+            for (MaskJob& job : *jobs)
+            {
+                job.mMorphTarget->applyMaskWeights(job.mWeights.data());
+            }
+            self.get()->dirtyMesh();
+        });
+
+    if (!posted)
+    {
+        apply_now();
+    }
 }
 
 // returns true if morph masks are present and not valid for a given baked texture, false otherwise
@@ -10821,19 +11153,57 @@ void LLVOAvatar::updateImpostors()
 {
     LLViewerCamera::sCurCameraID = LLViewerCamera::CAMERA_WORLD;
 
+    LLImpostorAtlas& atlas = gPipeline.mImpostorAtlas;
+
+    std::vector<LLVOAvatar*> updates;
     for (LLCharacter* character : LLCharacter::sInstances)
     {
         LLVOAvatar* avatar = (LLVOAvatar*)character;
-        if (!avatar->isDead()
-            && avatar->isVisible()
-            && avatar->isImpostor()
-            && avatar->needsImpostorUpdate())
+        if (avatar->isDead())
+        {
+            continue;
+        }
+
+        if (!avatar->isImpostor())
+        {
+            if (avatar->getOverallAppearance() == AOA_NORMAL && atlas.isValid(avatar->mImpostorTile))
+            { // make room for the ones still impostored
+                atlas.freeTile(avatar->mImpostorTile);
+                avatar->mNeedsImpostorUpdate = true;
+            }
+        }
+        else if (avatar->isVisible()
+            && (avatar->needsImpostorUpdate() || !atlas.isValid(avatar->mImpostorTile)))
         {
-            avatar->calcMutedAVColor();
-            gPipeline.generateImpostor(avatar);
+            updates.push_back(avatar);
         }
     }
 
+    // under the budget impostors that have nothing to show go first, then the largest on screen,
+    // the rest keep their stale impostor until a later frame
+    static LLCachedControl<U32> update_budget(gSavedSettings, "RenderImpostorUpdateBudget", 4);
+    if (update_budget > 0 && updates.size() > update_budget)
+    {
+        std::partial_sort(updates.begin(), updates.begin() + update_budget, updates.end(),
+            [&atlas](const LLVOAvatar* lhs, const LLVOAvatar* rhs)
+            {
+                bool lhs_valid = atlas.isValid(lhs->mImpostorTile);
+                bool rhs_valid = atlas.isValid(rhs->mImpostorTile);
+                if (lhs_valid != rhs_valid)
+                {
+                    return !lhs_valid;
+                }
+                return lhs->mImpostorPixelArea > rhs->mImpostorPixelArea;
+            });
+        updates.resize(update_budget);
+    }
+
+    for (LLVOAvatar* avatar : updates)
+    {
+        avatar->calcMutedAVColor();
+        gPipeline.generateImpostor(avatar);
+    }
+
     LLCharacter::sAllowInstancesChange = true;
 }
 
@@ -11078,9 +11448,17 @@ void LLVOAvatar::idleUpdateDebugInfo()
     }
 }
 
-void LLVOAvatar::updateVisualComplexity()
+void LLVOAvatar::updateVisualComplexity(LLViewerObject* changed)
 {
     LL_DEBUGS("AvatarRender") << "avatar " << getID() << " appearance changed" << LL_ENDL;
+    if (changed)
+    {
+        mStaleAttachmentComplexity.insert(changed->getRootEdit()->getID());
+    }
+    else
+    {
+        mAllAttachmentComplexityStale = true;
+    }
     // Set the cache time to in the past so it's updated ASAP
     mVisualComplexityStale = true;
 }
@@ -11093,16 +11471,14 @@ void LLVOAvatar::accountRenderComplexityForObject(
     LLViewerObject *attached_object,
     const F32 max_attachment_complexity,
     LLVOVolume::texture_cost_t& textures,
-    U32& cost,
-    hud_complexity_list_t& hud_complexity_list,
-    object_complexity_list_t& object_complexity_list)
+    AttachmentComplexity& complexity)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
     if (attached_object && !attached_object->isHUDAttachment())
     {
-        mAttachmentVisibleTriangleCount += attached_object->recursiveGetTriangleCount();
-        mAttachmentEstTriangleCount += attached_object->recursiveGetEstTrianglesMax();
-        mAttachmentSurfaceArea += attached_object->recursiveGetScaledSurfaceArea();
+        complexity.mVisibleTriangleCount = attached_object->recursiveGetTriangleCount();
+        complexity.mEstTriangleCount = attached_object->recursiveGetEstTrianglesMax();
+        complexity.mSurfaceArea = attached_object->recursiveGetScaledSurfaceArea();
 
         textures.clear();
         const LLDrawable* drawable = attached_object->mDrawable;
@@ -11142,6 +11518,7 @@ void LLVOAvatar::accountRenderComplexityForObject(
                 {
                     // add the cost of each individual texture in the linkset
                     attachment_texture_cost += LLVOVolume::getTextureCost(*volume_texture);
+                    complexity.mTexturesPending |= (*volume_texture)->getFullWidth() == 0;
                 }
                 attachment_total_cost = attachment_volume_cost + attachment_texture_cost + attachment_children_cost;
                 LL_DEBUGS("ARCdetail") << "Attachment costs " << attached_object->getAttachmentItemID()
@@ -11153,15 +11530,15 @@ void LLVOAvatar::accountRenderComplexityForObject(
                     << " children: " << attachment_children_cost
                     << LL_ENDL;
                 // Limit attachment complexity to avoid signed integer flipping of the wearer's ACI
-                cost += (U32)llclamp(attachment_total_cost, MIN_ATTACHMENT_COMPLEXITY, max_attachment_complexity);
+                complexity.mCost = (U32)llclamp(attachment_total_cost, MIN_ATTACHMENT_COMPLEXITY, max_attachment_complexity);
 
                 if (isSelf())
                 {
-                    LLObjectComplexity object_complexity;
+                    LLObjectComplexity& object_complexity = complexity.mObjectComplexity;
                     object_complexity.objectName = attached_object->getAttachmentItemName();
                     object_complexity.objectId = attached_object->getAttachmentItemID();
                     object_complexity.objectCost = (U32)attachment_total_cost;
-                    object_complexity_list.push_back(object_complexity);
+                    complexity.mHasObjectComplexity = true;
                 }
             }
         }
@@ -11173,13 +11550,13 @@ void LLVOAvatar::accountRenderComplexityForObject(
         && attached_object->mDrawable)
     {
         textures.clear();
-        mAttachmentSurfaceArea += attached_object->recursiveGetScaledSurfaceArea();
+        complexity.mSurfaceArea = attached_object->recursiveGetScaledSurfaceArea();
 
         const LLVOVolume* volume = attached_object->mDrawable->getVOVolume();
         if (volume)
         {
             bool is_rigged_mesh = volume->isRiggedMeshFast();
-            LLHUDComplexity hud_object_complexity;
+            LLHUDComplexity& hud_object_complexity = complexity.mHUDComplexity;
             hud_object_complexity.objectName = attached_object->getAttachmentItemName();
             hud_object_complexity.objectId = attached_object->getAttachmentItemID();
             std::string joint_name;
@@ -11223,6 +11600,7 @@ void LLVOAvatar::accountRenderComplexityForObject(
                 // add the cost of each individual texture (ignores duplicates)
                 hud_object_complexity.texturesCost += LLVOVolume::getTextureCost(*volume_texture);
                 const LLViewerTexture* img = *volume_texture;
+                complexity.mTexturesPending |= img->getFullWidth() == 0;
                 if (img->getType() == LLViewerTexture::FETCHED_TEXTURE)
                 {
                     LLViewerFetchedTexture* tex = (LLViewerFetchedTexture*)img;
@@ -11234,7 +11612,7 @@ void LLVOAvatar::accountRenderComplexityForObject(
                     }
                 }
             }
-            hud_complexity_list.push_back(hud_object_complexity);
+            complexity.mHasHUDComplexity = true;
         }
     }
 }
@@ -11297,6 +11675,59 @@ void LLVOAvatar::calculateUpdateRenderComplexity()
         mAttachmentEstTriangleCount = 0.f;
         mAttachmentSurfaceArea = 0.f;
 
+        // Attachments keep what they cost until one of their prims reports a
+        // change (LOD or geometry rebuild, texture, mesh load, see
+        // updateVisualComplexity), everything else is only summed up again
+        if (mAllAttachmentComplexityStale || max_attachment_complexity != mAttachmentComplexityLimit)
+        {
+            mAttachmentComplexity.clear();
+            mAllAttachmentComplexityStale = false;
+            mAttachmentComplexityLimit = max_attachment_complexity;
+        }
+        for (const LLUUID& id : mStaleAttachmentComplexity)
+        {
+            mAttachmentComplexity.erase(id);
+        }
+        mStaleAttachmentComplexity.clear();
+
+        // rebuilt from what is still attached, entries of detached objects drop out
+        std::map<LLUUID, AttachmentComplexity> attachment_complexity;
+        auto account_object = [&](LLViewerObject* object)
+        {
+            if (!object)
+            {
+                return;
+            }
+
+            AttachmentComplexity& complexity = attachment_complexity[object->getID()];
+            auto cached = mAttachmentComplexity.find(object->getID());
+            if (cached != mAttachmentComplexity.end() && !cached->second.mTexturesPending)
+            {
+                complexity = std::move(cached->second);
+            }
+            else
+            {
+                accountRenderComplexityForObject(object, max_attachment_complexity, textures, complexity);
+            }
+
+            cost += complexity.mCost;
+            mAttachmentVisibleTriangleCount += complexity.mVisibleTriangleCount;
+            mAttachmentEstTriangleCount += complexity.mEstTriangleCount;
+            mAttachmentSurfaceArea += complexity.mSurfaceArea;
+
+            // inventory may have finished loading since, names are cheap to look up again
+            if (complexity.mHasObjectComplexity)
+            {
+                complexity.mObjectComplexity.objectName = object->getAttachmentItemName();
+                object_complexity_list.push_back(complexity.mObjectComplexity);
+            }
+            if (complexity.mHasHUDComplexity)
+            {
+                complexity.mHUDComplexity.objectName = object->getAttachmentItemName();
+                hud_complexity_list.push_back(complexity.mHUDComplexity);
+            }
+        };
+
         // A standalone animated object needs to be accounted for
         // using its associated volume. Attached animated objects
         // will be covered by the subsequent loop over attachments.
@@ -11306,8 +11737,7 @@ void LLVOAvatar::calculateUpdateRenderComplexity()
             LLVOVolume *volp = control_av->mRootVolp;
             if (volp && !volp->isAttachment())
             {
-                accountRenderComplexityForObject(volp, max_attachment_complexity,
-                                                 textures, cost, hud_complexity_list, object_complexity_list);
+                account_object(volp);
             }
         }
 
@@ -11321,11 +11751,10 @@ void LLVOAvatar::calculateUpdateRenderComplexity()
                  attachment_iter != attachment->mAttachedObjects.end();
                  ++attachment_iter)
             {
-                LLViewerObject* attached_object = attachment_iter->get();
-                accountRenderComplexityForObject(attached_object, max_attachment_complexity,
-                                                 textures, cost, hud_complexity_list, object_complexity_list);
+                account_object(attachment_iter->get());
             }
         }
+        mAttachmentComplexity.swap(attachment_complexity);
 
         if ( cost != mVisualComplexity )
         {
@@ -44,6 +44,7 @@
 #include "llviewerjointmesh.h"
 #include "llviewerjointattachment.h"
 #include "llrendertarget.h"
+#include "llimpostoratlas.h"
 #include "llavatarappearancedefines.h"
 #include "lltexglobalcolor.h"
 #include "lldriverparam.h"
@@ -75,6 +76,7 @@ class LLTexGlobalColor;
 
 struct LLAppearanceMessageContents;
 class LLViewerJointMesh;
+class LLJointOverrideTable;
 
 const F32 MAX_AVATAR_LOD_FACTOR = 1.0f;
 
@@ -213,6 +215,8 @@ public:
     void                    addAttachmentOverridesForObject(LLViewerObject *vo, std::set<LLUUID>* meshes_seen = NULL, bool recursive = true);
     void                    removeAttachmentOverridesForObject(const LLUUID& mesh_id);
     void                    removeAttachmentOverridesForObject(LLViewerObject *vo);
+    // after 'vo' was detached, removes the overrides of its meshes no other attachment still uses
+    void                    removeUnusedAttachmentOverrides(LLViewerObject *vo);
     bool                    jointIsRiggedTo(const LLJoint *joint) const;
     void                    clearAttachmentOverrides();
     void                    rebuildAttachmentOverrides();
@@ -229,6 +233,8 @@ public:
     size_t    mLastRiggingInfoKey;
 
     std::set<LLUUID>        mActiveOverrideMeshes;
+    // the tables the active overrides were added from, removal undoes just those
+    std::map<LLUUID, LLPointer<LLJointOverrideTable> > mActiveOverrideTables;
     virtual void            onActiveOverrideMeshesChanged();
 
     /*virtual*/ const LLUUID&   getID() const;
@@ -273,11 +279,34 @@ public:
     virtual void    updateDebugText();
     virtual bool    computeNeedsUpdate();
     virtual bool    updateCharacter(LLAgent &agent);
+    // finish the character updates idleUpdate left for later, see sDeferCharacterMotion
+    static void     updateDeferredCharacters(LLAgent &agent, const F64 &time);
     void            updateFootstepSounds();
     void            computeUpdatePeriod();
     void            updateOrientation(LLAgent &agent, F32 speed, F32 delta_time);
     void            updateTimeStep();
     void            updateRootPositionAndRotation(LLAgent &agent, F32 speed, bool was_sit_ground_constrained);
+protected:
+    // the parts of updateCharacter after the root moved, updateCharacterMotion
+    // only touches this avatar and its joints so it can run on a worker thread
+    virtual void    updateCharacterMotion();
+    // copies another avatar's pose in updateCharacterMotion, which then has
+    // to wait for the other one's, see LLControlAvatar
+    bool            mSharesPose = false;
+private:
+    void            finishCharacterUpdate(bool visible);
+    // the rest of idleUpdate once the joints are in place
+    void            idleUpdatePostCharacter(bool detailed_update);
+
+    LLCharacter::e_update_t mMotionUpdateType = LLCharacter::NORMAL_UPDATE;
+    bool            mMotionWasSitGroundConstrained = false;
+    bool            mCharacterMotionDeferred = false;
+    bool            mDeferredDetailedUpdate = false;
+
+    static std::vector<LLPointer<LLVOAvatar> > sDeferredCharacters;
+    // animesh attached to a deferred avatar follows its joints, so it updates after them
+    static std::vector<LLPointer<LLVOAvatar> > sDeferredAttachedCharacters;
+public:
 
     void            idleUpdateVoiceVisualizer(bool voice_enabled, const LLVector3 &position);
     void            idleUpdateMisc(bool detailed_update);
@@ -296,15 +325,28 @@ public:
     void            addNameTagLine(const std::string& line, const LLColor4& color, S32 style, const LLFontGL* font, const bool use_ellipses = false);
     void            idleUpdateRenderComplexity();
     void            idleUpdateDebugInfo();
+    // what one attached or animated object adds to the avatar's complexity,
+    // kept until a prim of its linkset reports a change
+    struct AttachmentComplexity
+    {
+        U32                 mCost = 0;
+        U32                 mVisibleTriangleCount = 0;
+        F32                 mEstTriangleCount = 0.f;
+        F32                 mSurfaceArea = 0.f;
+        bool                mTexturesPending = false;      // some texture size wasn't known yet, recomputed on the next update
+        bool                mHasObjectComplexity = false;  // own avatar only, see LLAvatarRenderNotifier
+        bool                mHasHUDComplexity = false;
+        LLObjectComplexity  mObjectComplexity;
+        LLHUDComplexity     mHUDComplexity;
+    };
     void            accountRenderComplexityForObject(LLViewerObject *attached_object,
                                                      const F32 max_attachment_complexity,
                                                      LLVOVolume::texture_cost_t& textures,
-                                                     U32& cost,
-                                                     hud_complexity_list_t& hud_complexity_list,
-                                                     object_complexity_list_t& object_complexity_list);
+                                                     AttachmentComplexity& complexity);
     void            calculateUpdateRenderComplexity();
     static const U32 VISUAL_COMPLEXITY_UNKNOWN;
-    void            updateVisualComplexity();
+    // recompute the complexity of all attachments, or, given 'changed', of just the attachment it is a prim of
+    void            updateVisualComplexity(LLViewerObject* changed = nullptr);
 
     void placeProfileQuery();
     void readProfileQuery(S32 retries);
@@ -368,6 +410,7 @@ public:
     static F32      sLODFactor; // user-settable LOD factor
     static F32      sPhysicsLODFactor; // user-settable physics LOD factor
     static bool     sJointDebug; // output total number of joints being touched for each avatar
+    static bool     sDeferCharacterMotion; // queue motion and joint updates of other avatars for updateDeferredCharacters
 
     static LLPointer<LLViewerTexture>  sCloudTexture;
 
@@ -564,6 +607,7 @@ private:
     F32         mLastSkinTime; //value of gFrameTimeSeconds at last skin update
 
     S32         mUpdatePeriod;
+    S32         mAnimationLOD; // tier picked by updateTimeStep, 0 is full animation
     S32         mNumInitFaces; //number of faces generated when creating the avatar drawable, does not inculde splitted faces due to long vertex buffer.
 
     // profile handle
@@ -582,6 +626,11 @@ private:
     // DEPRECATED -- obsolete avatar render cost values
     mutable U32  mVisualComplexity;
     mutable bool mVisualComplexityStale;
+    // by root object id, see calculateUpdateRenderComplexity
+    std::map<LLUUID, AttachmentComplexity> mAttachmentComplexity;
+    std::set<LLUUID> mStaleAttachmentComplexity;
+    bool         mAllAttachmentComplexityStale = true;
+    F32          mAttachmentComplexityLimit = 0.f; // MaxAttachmentComplexity the cached costs were clamped to
     U32          mReportedVisualComplexity; // from other viewers through the simulator
 
     mutable bool        mCachedInMuteList;
@@ -605,6 +654,13 @@ public:
 public:
     /*virtual*/ void    applyMorphMask(const U8* tex_data, S32 width, S32 height, S32 num_components, LLAvatarAppearanceDefines::EBakedTextureIndex index = LLAvatarAppearanceDefines::BAKED_NUM_INDICES);
     bool        morphMaskNeedsUpdate(LLAvatarAppearanceDefines::EBakedTextureIndex index = LLAvatarAppearanceDefines::BAKED_NUM_INDICES);
+protected:
+    // set while the caller needs the masks on the mesh before applyMorphMask returns (the visual param hints)
+    bool        mApplyMorphMasksNow = false;
+private:
+    // the mask weights are generated on the general work queue and applied on the main thread,
+    // only the result of the latest mask of each baked texture is applied
+    U32         mMorphMaskSerial[LLAvatarAppearanceDefines::BAKED_NUM_INDICES] = {};
 
 
     //--------------------------------------------------------------------
@@ -648,7 +704,7 @@ public:
     void        setImpostorDim(const LLVector2& dim);
     static void resetImpostors();
     static void updateImpostors();
-    LLRenderTarget mImpostor;
+    LLImpostorAtlas::Tile mImpostorTile; // in LLPipeline::mImpostorAtlas
     bool        mNeedsImpostorUpdate;
     S32         mLastImpostorUpdateReason;
     F32SecondsImplicit mLastImpostorUpdateFrameTime;
@@ -830,8 +886,14 @@ public:
         // Float array ready to be sent to GL
         std::vector<F32> mGLMp;
 
+        // Where LLSkinPalettes put mGLMp, valid while its generation matches
+        mutable U32 mSlotGeneration;
+        mutable U32 mSlot;
+
         MatrixPaletteCache() :
-            mFrame(gFrameCount - 1)
+            mFrame(gFrameCount - 1),
+            mSlotGeneration(0),
+            mSlot(0)
         {
         }
     };
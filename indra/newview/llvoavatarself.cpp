@@ -1648,6 +1648,8 @@ void LLVOAvatarSelf::setupComposites()
 
 void LLVOAvatarSelf::updateComposites()
 {
+    // callers render the avatar right after, the morph masks can't lag behind
+    mApplyMorphMasksNow = true;
     for (U32 i = 0; i < mBakedTextureDatas.size(); i++)
     {
         LLViewerTexLayerSet *layerset = getTexLayerSet(i);
@@ -1657,6 +1659,7 @@ void LLVOAvatarSelf::updateComposites()
             layerset->updateComposite();
         }
     }
+    mApplyMorphMasksNow = false;
 }
 
 // virtual
@@ -34,6 +34,10 @@
 #include "llagentcamera.h"
 #include "llsdserialize.h"
 #include "llworld.h" // For LLWorld::getInstance()
+#include "llappviewer.h"
+#include "lldiskcache.h"
+#include "lltexturecache.h"
+#include "workqueue.h"
 //static variables
 U32 LLVOCacheEntry::sMinFrameRange = 0;
 F32 LLVOCacheEntry::sNearRadius = 1.0f;
@@ -192,7 +196,7 @@ LLVOCacheEntry::LLVOCacheEntry()
     mDP.assignBuffer(mBuffer, 0);
 }
 
-LLVOCacheEntry::LLVOCacheEntry(LLAPRFile* apr_file)
+LLVOCacheEntry::LLVOCacheEntry(const U8*& data, const U8* data_end)
 :   LLViewerOctreeEntryData(LLViewerOctreeEntry::LLVOCACHEENTRY),
     mBuffer(NULL),
     mUpdateFlags(-1),
@@ -203,46 +207,43 @@ LLVOCacheEntry::LLVOCacheEntry(LLAPRFile* apr_file)
     mBSphereRadius(-1.0f)
 {
     S32 size = -1;
-    bool success;
-    static U8 data_buffer[ENTRY_HEADER_SIZE];
+    bool success = data_end - data >= ENTRY_HEADER_SIZE;
 
     mDP.assignBuffer(mBuffer, 0);
 
-    success = check_read(apr_file, (void *)data_buffer, ENTRY_HEADER_SIZE);
     if (success)
     {
-        memcpy(&mLocalID, data_buffer, sizeof(U32));
-        memcpy(&mCRC, data_buffer + sizeof(U32), sizeof(U32));
-        memcpy(&mHitCount, data_buffer + (2 * sizeof(U32)), sizeof(S32));
-        memcpy(&mDupeCount, data_buffer + (3 * sizeof(U32)), sizeof(S32));
-        memcpy(&mCRCChangeCount, data_buffer + (4 * sizeof(U32)), sizeof(S32));
-        memcpy(&size, data_buffer + (5 * sizeof(U32)), sizeof(S32));
+        memcpy(&mLocalID, data, sizeof(U32));
+        memcpy(&mCRC, data + sizeof(U32), sizeof(U32));
+        memcpy(&mHitCount, data + (2 * sizeof(U32)), sizeof(S32));
+        memcpy(&mDupeCount, data + (3 * sizeof(U32)), sizeof(S32));
+        memcpy(&mCRCChangeCount, data + (4 * sizeof(U32)), sizeof(S32));
+        memcpy(&size, data + (5 * sizeof(U32)), sizeof(S32));
+        data += ENTRY_HEADER_SIZE;
 
         // Corruption in the cache entries
         if ((size > MAX_ENTRY_BODY_SIZE) || (size < 1))
         {
             // We've got a bogus size, skip reading it.
-            // We won't bother seeking, because the rest of this file
-            // is likely bogus, and will be tossed anyway.
+            // The rest of this file is likely bogus, and will be tossed anyway.
             LL_WARNS() << "Bogus cache entry, size " << size << ", aborting!" << LL_ENDL;
             success = false;
         }
     }
     if(success && size > 0)
     {
-        mBuffer = new U8[size];
-        success = check_read(apr_file, mBuffer, size);
-
-        if(success)
+        if (data_end - data >= size)
         {
+            mBuffer = new U8[size];
+            memcpy(mBuffer, data, size);
+            data += size;
             mDP.assignBuffer(mBuffer, size);
         }
         else
         {
             // Improve logging around vocache
             LL_WARNS() << "Error loading cache entry for " << mLocalID << ", size " << size << " aborting!" << LL_ENDL;
-            delete[] mBuffer ;
-            mBuffer = NULL ;
+            success = false;
         }
     }
 
@@ -825,6 +826,18 @@ public:
         return res;
     }
 
+    virtual void frustumCheckBatch(const LLViewerOctreeGroup* const* groups, const LLVector4a* const* bounds, U32 count, S32* results)
+    {
+        AABBsInRegionFrustumNoFarClipGroupBounds(bounds, count, results);
+        for (U32 i = 0; i < count; i++)
+        {
+            if (results[i] != 0)
+            {
+                results[i] = llmin(results[i], AABBRegionSphereIntersectGroupExtents(groups[i], mLocalShift));
+            }
+        }
+    }
+
     virtual S32 frustumCheckObjects(const LLViewerOctreeGroup* group)
     {
 #if 0
@@ -980,7 +993,7 @@ void LLVOCachePartition::selectBackObjects(LLCamera &camera, F32 pixel_threshold
     LLVector3 region_agent = mRegionp->getOriginAgent();
 
     LLVOCacheOctreeBackCull culler(&camera, region_agent, mRegionp, pixel_threshold, use_occlusion);
-    culler.traverse(mOctree);
+    culler.traverseFlat(mFlatOctree);
 
     mBackSlectionEnabled--;
     if(!mRegionp->getNumOfVisibleGroups())
@@ -1005,7 +1018,14 @@ S32 LLVOCachePartition::cull(LLCamera &camera, bool do_occlusion)
         return 0;
     }
 
-    ((LLViewerOctreeGroup*)mOctree->getListener(0))->rebound();
+    LLViewerOctreeGroup* root = (LLViewerOctreeGroup*)mOctree->getListener(0);
+    //any change to the octree leaves the root dirty until it's rebound here
+    bool changed = root->isDirty();
+    root->rebound();
+    if (changed || mFlatOctree.empty())
+    {
+        mFlatOctree.build(mOctree);
+    }
 
     if(LLViewerCamera::sCurCameraID != LLViewerCamera::CAMERA_WORLD)
     {
@@ -1050,7 +1070,7 @@ S32 LLVOCachePartition::cull(LLCamera &camera, bool do_occlusion)
     mFrontCull = true;
     LLVOCacheOctreeCull culler(&camera, mRegionp, region_agent, do_occlusion && use_object_cache_occlusion,
         LLVOCacheEntry::getSquaredPixelThreshold(mFrontCull), this);
-    culler.traverse(mOctree);
+    culler.traverseFlat(mFlatOctree);
 
     if(!sNeedsOcclusionCheck)
     {
@@ -1135,6 +1155,12 @@ void LLVOCachePartition::removeOccluder(LLVOCacheGroup* group)
 // Format strings used to construct filename for the object cache
 static const char OBJECT_CACHE_FILENAME[] = "objects_%d_%d.slc";
 static const char OBJECT_CACHE_EXTRAS_FILENAME[] = "objects_%d_%d_extras.slec";
+static const char OBJECT_CACHE_ASSETS_FILENAME[] = "objects_%d_%d_assets.slca";
+
+const U32 ASSET_LIST_VERSION = 1;
+const U32 MAX_ASSET_LIST_ENTRIES = 16384;
+const F32 PREFETCH_REPEAT_SECONDS = 30.f; // teleport request and finish both ask for the destination
+const size_t PREFETCH_CHUNK_SIZE = 64 * 1024;
 
 const U32 MAX_NUM_OBJECT_ENTRIES = 128 ;
 const U32 MIN_ENTRIES_TO_PURGE = 16 ;
@@ -1148,7 +1174,10 @@ LLVOCache::LLVOCache(bool read_only) :
     mReadOnly(read_only),
     mNumEntries(0),
     mCacheSize(1),
-    mEnabled(true)
+    mEnabled(true),
+    mPendingWrites(std::make_shared<PendingWrites>()),
+    mPrefetchGeneration(std::make_shared<std::atomic<U32> >(0)),
+    mPrefetchHandle(0)
 {
 #ifndef LL_TEST
     mEnabled = gSavedSettings.getBOOL("ObjectCacheEnabled");
@@ -1160,6 +1189,7 @@ LLVOCache::~LLVOCache()
 {
     if(mEnabled)
     {
+        flushPendingWrites();
         writeCacheHeader();
         clearCacheInMemory();
     }
@@ -1242,6 +1272,7 @@ void LLVOCache::removeCache(ELLPath location, bool started)
     std::string mask = "*";
     std::string cache_dir = gDirUtilp->getExpandedFilename(location, object_cache_dirname);
     LL_INFOS() << "Removing cache at " << cache_dir << LL_ENDL;
+    discardPendingWrites();
     gDirUtilp->deleteFilesInDir(cache_dir, mask); //delete all files
     LLFile::rmdir(cache_dir);
 
@@ -1265,6 +1296,7 @@ void LLVOCache::removeCache()
 
     std::string mask = "*";
     LL_INFOS() << "Removing object cache at " << mObjectCacheDirName << LL_ENDL;
+    discardPendingWrites();
     gDirUtilp->deleteFilesInDir(mObjectCacheDirName, mask);
 
     clearCacheInMemory() ;
@@ -1352,6 +1384,15 @@ std::string LLVOCache::getObjectCacheExtrasFilename(U64 handle)
                llformat(OBJECT_CACHE_EXTRAS_FILENAME, region_x, region_y));
 }
 
+std::string LLVOCache::getObjectCacheAssetsFilename(U64 handle)
+{
+    U32 region_x, region_y;
+
+    grid_from_region_handle(handle, &region_x, &region_y);
+    return gDirUtilp->getExpandedFilename(LL_PATH_CACHE, object_cache_dirname,
+               llformat(OBJECT_CACHE_ASSETS_FILENAME, region_x, region_y));
+}
+
 void LLVOCache::removeFromCache(HeaderEntryInfo* entry)
 {
     if(mReadOnly)
@@ -1363,12 +1404,18 @@ void LLVOCache::removeFromCache(HeaderEntryInfo* entry)
     std::string filename;
     getObjectCacheFilename(entry->mHandle, filename);
     LL_WARNS("GLTF", "VOCache") << "Removing object cache for handle " << entry->mHandle << "Filename: " << filename << LL_ENDL;
+    discardPendingWrite(filename);
     LLAPRFile::remove(filename, mLocalAPRFilePoolp);
 
+    filename = getObjectCacheAssetsFilename(entry->mHandle);
+    discardPendingWrite(filename);
+    LLFile::remove(filename);
+
     // Note: `removeFromCache` should take responsibility for cleaning up all cache artefacts specfic to the handle/entry.
     // as such this now includes the generic extras
     filename = getObjectCacheExtrasFilename(entry->mHandle);
     LL_WARNS("GLTF", "VOCache") << "Removing generic extras for handle " << entry->mHandle << "Filename: " << filename << LL_ENDL;
+    discardPendingWrite(filename);
     LLFile::remove(filename);
 
     entry->mTime = INVALID_TIME ;
@@ -1536,52 +1583,68 @@ bool LLVOCache::readFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::voca
         return false; // arguably no a problem, but we'll mark this as dirty anyway.
     }
 
+    std::string filename;
+    getObjectCacheFilename(handle, filename);
+
+    cache_file_t pending = getPendingFile(filename);
+
     bool success = true ;
-    S32 num_entries = 0 ; // lifted out of inner loop.
-    std::string filename; // lifted out of loop
+    if (pending)
     {
-        LLUUID cache_id;
-        getObjectCacheFilename(handle, filename);
-        LLAPRFile apr_file(filename, APR_READ|APR_BINARY, mLocalAPRFilePoolp);
-
-        success = check_read(&apr_file, cache_id.mData, UUID_BYTES);
+        // left the region only a moment ago, the file is still waiting to be written
+        success = parseCacheFile(*pending, id, filename, cache_entry_map);
+    }
+    else
+    {
+        std::vector<U8> file;
+        success = readCacheFile(filename, file) && parseCacheFile(file, id, filename, cache_entry_map);
+    }
 
-        if(success)
+    if(!success)
+    {
+        if(cache_entry_map.empty())
         {
-            if(cache_id != id)
-            {
-                LL_INFOS() << "Cache ID doesn't match for this region, discarding"<< LL_ENDL;
-                success = false ;
-            }
+            removeEntry(iter->second) ;
+        }
+    }
 
-            if(success)
-            {
-                success = check_read(&apr_file, &num_entries, sizeof(S32)) ;
+    return success;
+}
 
-                if(success)
-                {
-                    for (S32 i = 0; i < num_entries && apr_file.eof() != APR_EOF; i++)
-                    {
-                        LLPointer<LLVOCacheEntry> entry = new LLVOCacheEntry(&apr_file);
-                        if (!entry->getLocalID())
-                        {
-                            LL_WARNS() << "Aborting cache file load for " << filename << ", cache file corruption!" << LL_ENDL;
-                            success = false ;
-                            break ;
-                        }
-                        cache_entry_map[entry->getLocalID()] = entry;
-                    }
-                }
-            }
-        }
+bool LLVOCache::parseCacheFile(const std::vector<U8>& file, const LLUUID& id, const std::string& filename, LLVOCacheEntry::vocache_entry_map_t& cache_entry_map)
+{
+    const U8* data = file.data();
+    const U8* data_end = data + file.size();
+
+    if (file.size() < UUID_BYTES + sizeof(S32))
+    {
+        return false;
     }
 
-    if(!success)
+    LLUUID cache_id;
+    memcpy(cache_id.mData, data, UUID_BYTES);
+    data += UUID_BYTES;
+    if(cache_id != id)
     {
-        if(cache_entry_map.empty())
+        LL_INFOS() << "Cache ID doesn't match for this region, discarding"<< LL_ENDL;
+        return false;
+    }
+
+    S32 num_entries = 0;
+    memcpy(&num_entries, data, sizeof(S32));
+    data += sizeof(S32);
+
+    bool success = true;
+    for (S32 i = 0; i < num_entries && data < data_end; i++)
+    {
+        LLPointer<LLVOCacheEntry> entry = new LLVOCacheEntry(data, data_end);
+        if (!entry->getLocalID())
         {
-            removeEntry(iter->second) ;
+            LL_WARNS() << "Aborting cache file load for " << filename << ", cache file corruption!" << LL_ENDL;
+            success = false ;
+            break ;
         }
+        cache_entry_map[entry->getLocalID()] = entry;
     }
 
     LL_DEBUGS("GLTF", "VOCache") << "Read " << cache_entry_map.size() << " entries from object cache " << filename << ", expected " << num_entries << ", success=" << (success?"True":"False") << LL_ENDL;
@@ -1591,10 +1654,6 @@ bool LLVOCache::readFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::voca
 // We now pass in the cache entry map, so that we can remove entries from extras that are no longer in the primary cache.
 void LLVOCache::readGenericExtrasFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::vocache_gltf_overrides_map_t& cache_extras_entry_map, const LLVOCacheEntry::vocache_entry_map_t& cache_entry_map)
 {
-    int loaded= 0;
-    int discarded = 0;
-    // get ViewerRegion pointer from handle
-    LLViewerRegion* pRegion = LLWorld::getInstance()->getRegionFromHandle(handle);
     if(!mEnabled)
     {
         LL_WARNS() << "Not reading cache for handle " << handle << "): Cache is currently disabled." << LL_ENDL;
@@ -1610,16 +1669,34 @@ void LLVOCache::readGenericExtrasFromCache(U64 handle, const LLUUID& id, LLVOCac
     }
 
     std::string filename(getObjectCacheExtrasFilename(handle));
-    llifstream in(filename, std::ios::in | std::ios::binary);
+    LLVOCacheEntry::vocache_gltf_overrides_map_t extras;
+    bool success;
+    if (cache_file_t pending = getPendingFile(filename))
+    {
+        std::istringstream in(std::string(pending->begin(), pending->end()));
+        success = parseGenericExtras(in, handle, id, extras);
+    }
+    else
+    {
+        llifstream in(filename, std::ios::in | std::ios::binary);
+        success = parseGenericExtras(in, handle, id, extras);
+    }
+    if (!success)
+    {
+        removeGenericExtrasForHandle(handle);
+    }
+    addGenericExtras(handle, extras, cache_extras_entry_map, cache_entry_map);
+}
 
+//static
+bool LLVOCache::parseGenericExtras(std::istream& in, U64 handle, const LLUUID& id, LLVOCacheEntry::vocache_gltf_overrides_map_t& extras)
+{
     std::string line;
     std::getline(in, line);
     if(!in.good())
     {
         LL_WARNS() << "Failed reading extras cache for handle " << handle << LL_ENDL;
-        in.close();
-        removeGenericExtrasForHandle(handle);
-        return;
+        return false;
     }
     // file formats need versions, let's add one. legacy cache files will be considered version 0
     // This will make it easier to upgrade/revise later.
@@ -1634,9 +1711,7 @@ void LLVOCache::readGenericExtrasFromCache(U64 handle, const LLUUID& id, LLVOCac
     if(versionNumber != LLGLTFOverrideCacheEntry::VERSION)
     {
         LL_WARNS() << "Unexpected version number " << versionNumber << " for extras cache for handle " << handle << LL_ENDL;
-        in.close();
-        removeGenericExtrasForHandle(handle);
-        return;
+        return false;
     }
 
     LL_DEBUGS("VOCache") << "Reading extras cache for handle " << handle << ", version " << versionNumber << LL_ENDL;
@@ -1644,9 +1719,7 @@ void LLVOCache::readGenericExtrasFromCache(U64 handle, const LLUUID& id, LLVOCac
     if(!LLUUID::validate(line))
     {
         LL_WARNS() << "Failed reading extras cache for handle" << handle << ". invalid uuid line: '" << line << "'" << LL_ENDL;
-        in.close();
-        removeGenericExtrasForHandle(handle);
-        return;
+        return false;
     }
 
     LLUUID cache_id(line);
@@ -1654,9 +1727,7 @@ void LLVOCache::readGenericExtrasFromCache(U64 handle, const LLUUID& id, LLVOCac
     {
         // if the cache id doesn't match the expected region we should just kill the file.
         LL_WARNS() << "Cache ID doesn't match for this region, deleting it" << LL_ENDL;
-        in.close();
-        removeGenericExtrasForHandle(handle);
-        return;
+        return false;
     }
 
     U32 num_entries;  // if removal was enabled during write num_entries might be wrong
@@ -1664,9 +1735,7 @@ void LLVOCache::readGenericExtrasFromCache(U64 handle, const LLUUID& id, LLVOCac
     if(!in.good())
     {
         LL_WARNS() << "Failed reading extras cache for handle " << handle << LL_ENDL;
-        in.close();
-        removeGenericExtrasForHandle(handle);
-        return;
+        return false;
     }
     try
     {
@@ -1675,12 +1744,10 @@ void LLVOCache::readGenericExtrasFromCache(U64 handle, const LLUUID& id, LLVOCac
     catch(std::logic_error&)  // either invalid_argument or out_of_range
     {
         LL_WARNS() << "Failed reading extras cache for handle " << handle << ". unreadable num_entries" << LL_ENDL;
-        in.close();
-        removeGenericExtrasForHandle(handle);
-        return;
+        return false;
     }
 
-    LL_DEBUGS("GLTF") << "Beginning reading extras cache for handle " << handle << " from " << getObjectCacheExtrasFilename(handle) << LL_ENDL;
+    LL_DEBUGS("GLTF") << "Beginning reading extras cache for handle " << handle << LL_ENDL;
 
     LLSD entry_llsd;
     for (U32 i = 0; i < num_entries && !in.eof(); i++)
@@ -1691,14 +1758,28 @@ void LLVOCache::readGenericExtrasFromCache(U64 handle, const LLUUID& id, LLVOCac
         if(!success || !in)
         {
             LL_WARNS() << "Failed reading extras cache for handle " << handle << ", entry number " << i << " cache patrtial load only." << LL_ENDL;
-            in.close();
-            removeGenericExtrasForHandle(handle);
-            break;
+            return false;
         }
 
         LLGLTFOverrideCacheEntry entry;
         entry.fromLLSD(entry_llsd);
         U32 local_id = entry_llsd["local_id"].asInteger();
+        extras[local_id] = entry;
+    }
+    return true;
+}
+
+void LLVOCache::addGenericExtras(U64 handle, LLVOCacheEntry::vocache_gltf_overrides_map_t& extras, LLVOCacheEntry::vocache_gltf_overrides_map_t& cache_extras_entry_map, const LLVOCacheEntry::vocache_entry_map_t& cache_entry_map)
+{
+    int loaded= 0;
+    int discarded = 0;
+    // get ViewerRegion pointer from handle
+    LLViewerRegion* pRegion = LLWorld::getInstance()->getRegionFromHandle(handle);
+
+    for (auto& extra : extras)
+    {
+        U32 local_id = extra.first;
+        LLGLTFOverrideCacheEntry& entry = extra.second;
         // only add entries that exist in the primary cache
         // this is a self-healing test that avoids us polluting the cache with entries that are no longer valid based on the main cache.
         if(cache_entry_map.find(local_id)!= cache_entry_map.end())
@@ -1708,7 +1789,8 @@ void LLVOCache::readGenericExtrasFromCache(U64 handle, const LLUUID& id, LLVOCac
             {
                 gObjectList.getUUIDFromLocal( entry.mObjectId, local_id, pRegion->getHost().getAddress(), pRegion->getHost().getPort() );
             }
-            cache_extras_entry_map[local_id] = entry;
+            // overrides received while the cache was loading are newer
+            cache_extras_entry_map.emplace(local_id, entry);
             loaded++;
         }
         else
@@ -1719,6 +1801,101 @@ void LLVOCache::readGenericExtrasFromCache(U64 handle, const LLUUID& id, LLVOCac
     LL_DEBUGS("GLTF") << "Completed reading extras cache for handle " << handle << ", " << loaded << " loaded, " << discarded << " discarded" << LL_ENDL;
 }
 
+void LLVOCache::readFromCacheAsync(U64 handle, const LLUUID& id, cache_loaded_callback_t callback)
+{
+    if(!mEnabled || mHandleEntryMap.find(handle) == mHandleEntryMap.end())
+    {
+        // nothing to wait for
+        LLVOCacheEntry::vocache_entry_map_t cache_entry_map;
+        LLVOCacheEntry::vocache_gltf_overrides_map_t cache_extras_entry_map;
+        bool success = readFromCache(handle, id, cache_entry_map);
+        callback(success, cache_entry_map, cache_extras_entry_map);
+        return;
+    }
+    llassert_always(mInitialized);
+
+    std::string filename;
+    getObjectCacheFilename(handle, filename);
+    std::string extras_filename = getObjectCacheExtrasFilename(handle);
+
+    cache_file_t pending = getPendingFile(filename);
+    cache_file_t pending_extras = getPendingFile(extras_filename);
+
+    struct LoadedCache
+    {
+        LLVOCacheEntry::vocache_entry_map_t mEntries;
+        LLVOCacheEntry::vocache_gltf_overrides_map_t mExtras;
+        bool mSuccess = true;
+        bool mExtrasSuccess = true;
+    };
+    std::shared_ptr<LoadedCache> loaded = std::make_shared<LoadedCache>();
+
+    LL::WorkQueue::ptr_t main_queue = LL::WorkQueue::getInstance("mainloop");
+    LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+    bool posted = main_queue && general_queue && main_queue->postTo(
+        general_queue,
+        [loaded, filename, extras_filename, pending, pending_extras, handle, id]() // Work done on general queue
+        {
+            LL_PROFILE_ZONE_NAMED("vocache read");
+            if (pending)
+            {
+                loaded->mSuccess = parseCacheFile(*pending, id, filename, loaded->mEntries);
+            }
+            else
+            {
+                std::vector<U8> file;
+                loaded->mSuccess = readCacheFile(filename, file) && parseCacheFile(file, id, filename, loaded->mEntries);
+            }
+            if (pending_extras)
+            {
+                std::istringstream in(std::string(pending_extras->begin(), pending_extras->end()));
+                loaded->mExtrasSuccess = parseGenericExtras(in, handle, id, loaded->mExtras);
+            }
+            else
+            {
+                llifstream in(extras_filename, std::ios::in | std::ios::binary);
+                loaded->mExtrasSuccess = parseGenericExtras(in, handle, id, loaded->mExtras);
+            }
+        },
+        [loaded, handle, callback]() // Callback to main thread
+        {
+            if (!LLVOCache::instanceExists())
+            {
+                return;
+            }
+
+            LLVOCache& vocache = LLVOCache::instance();
+            if (!loaded->mSuccess && loaded->mEntries.empty())
+            {
+                vocache.removeEntry(handle);
+            }
+            else if (!loaded->mExtrasSuccess)
+            {
+                // drops the objects too, so the sim sends them with their overrides
+                vocache.removeGenericExtrasForHandle(handle);
+                loaded->mEntries.clear();
+                loaded->mSuccess = false;
+            }
+
+            LLVOCacheEntry::vocache_gltf_overrides_map_t cache_extras_entry_map;
+            vocache.addGenericExtras(handle, loaded->mExtras, cache_extras_entry_map, loaded->mEntries);
+            callback(loaded->mSuccess, loaded->mEntries, cache_extras_entry_map);
+        });
+
+    if (!posted)
+    {
+        LLVOCacheEntry::vocache_entry_map_t cache_entry_map;
+        LLVOCacheEntry::vocache_gltf_overrides_map_t cache_extras_entry_map;
+        bool success = readFromCache(handle, id, cache_entry_map);
+        readGenericExtrasFromCache(handle, id, cache_extras_entry_map, cache_entry_map);
+        if (mHandleEntryMap.find(handle) == mHandleEntryMap.end())
+        {
+            cache_entry_map.clear(); // the extras were unusable, removing them removed the region's cache
+        }
+        callback(success, cache_entry_map, cache_extras_entry_map);
+    }
+}
+
 void LLVOCache::purgeEntries(U32 size)
 {
     LL_DEBUGS("VOCache","GLTF") << "Purging " << size << " entries from cache" << LL_ENDL;
@@ -1792,78 +1969,340 @@ void LLVOCache::writeToCache(U64 handle, const LLUUID& id, const LLVOCacheEntry:
         return ; //nothing changed, no need to update.
     }
 
-    //write to cache file
+    // lay the file out in memory, the General queue writes it
     bool success = true ;
+    std::shared_ptr<std::vector<U8> > file = std::make_shared<std::vector<U8> >();
+    file->resize(UUID_BYTES + sizeof(S32));
+    memcpy(file->data(), id.mData, UUID_BYTES);
+
+    S32 num_entries = 0;
+    for (LLVOCacheEntry::vocache_entry_map_t::const_iterator iter = cache_entry_map.begin(); iter != cache_entry_map.end(); ++iter)
     {
-        std::string filename;
-        getObjectCacheFilename(handle, filename);
-        LLAPRFile apr_file(filename, APR_CREATE|APR_WRITE|APR_BINARY|APR_TRUNCATE, mLocalAPRFilePoolp);
+        if (!removal_enabled || iter->second->isValid())
+        {
+            size_t offset = file->size();
+            file->resize(offset + ENTRY_HEADER_SIZE + MAX_ENTRY_BODY_SIZE);
+            S32 size = iter->second->writeToBuffer(file->data() + offset);
 
-        success = check_write(&apr_file, (void*)id.mData, UUID_BYTES);
+            if (size > ENTRY_HEADER_SIZE) // body is minimum of 1
+            {
+                file->resize(offset + size);
+                num_entries++;
+            }
+            else
+            {
+                LL_WARNS() << "Failed to write cache entry to buffer for " << filename << ", entry number " << iter->second->getLocalID() << LL_ENDL;
+                success = false;
+                break;
+            }
+        }
+    }
+    memcpy(file->data() + UUID_BYTES, &num_entries, sizeof(S32));
 
-        if(success)
+    if(!success)
+    {
+        removeEntry(entry) ;
+        return ;
+    }
+
+    LL_DEBUGS("VOCache") << "Queued " << num_entries << " entries for the primary VOCache file " << filename << LL_ENDL;
+    queueCacheFile(filename, file);
+}
+
+void LLVOCache::queueCacheFile(const std::string& filename, const cache_file_t& file)
+{
+    {
+        LLMutexLock lock(&mPendingWrites->mMutex);
+        mPendingWrites->mFiles[filename] = file;
+    }
+
+    pending_writes_t pending_writes = mPendingWrites;
+    auto write = [pending_writes, filename, file]()
+    {
+        LL_PROFILE_ZONE_NAMED("vocache write");
+        // held while writing, so a removal or a newer version of the file can't race the write
+        LLMutexLock lock(&pending_writes->mMutex);
+        auto iter = pending_writes->mFiles.find(filename);
+        if (iter == pending_writes->mFiles.end() || iter->second != file)
+        {
+            return; // removed, or replaced by a newer file
+        }
+        writeCacheFile(filename, *file);
+        pending_writes->mFiles.erase(iter);
+    };
+
+    LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+    if (!general_queue || !general_queue->post(write))
+    {
+        write();
+    }
+}
+
+LLVOCache::cache_file_t LLVOCache::getPendingFile(const std::string& filename)
+{
+    LLMutexLock lock(&mPendingWrites->mMutex);
+    auto iter = mPendingWrites->mFiles.find(filename);
+    return iter != mPendingWrites->mFiles.end() ? iter->second : cache_file_t();
+}
+
+void LLVOCache::discardPendingWrite(const std::string& filename)
+{
+    LLMutexLock lock(&mPendingWrites->mMutex);
+    mPendingWrites->mFiles.erase(filename);
+}
+
+void LLVOCache::discardPendingWrites()
+{
+    LLMutexLock lock(&mPendingWrites->mMutex);
+    mPendingWrites->mFiles.clear();
+}
+
+void LLVOCache::flushPendingWrites()
+{
+    LLMutexLock lock(&mPendingWrites->mMutex);
+    for (auto& pending : mPendingWrites->mFiles)
+    {
+        writeCacheFile(pending.first, *pending.second);
+    }
+    mPendingWrites->mFiles.clear();
+}
+
+//static
+bool LLVOCache::readCacheFile(const std::string& filename, std::vector<U8>& file)
+{
+    // one read for the whole file, the entries are parsed from memory
+    LLFILE* fp = LLFile::fopen(filename, "rb");
+    if (!fp)
+    {
+        return false;
+    }
+
+    bool success = false;
+    if (fseek(fp, 0, SEEK_END) == 0)
+    {
+        long size = ftell(fp);
+        if (size > 0 && fseek(fp, 0, SEEK_SET) == 0)
+        {
+            file.resize(size);
+            success = fread(file.data(), 1, size, fp) == (size_t)size;
+        }
+    }
+    fclose(fp);
+    return success;
+}
+
+//static
+bool LLVOCache::writeCacheFile(const std::string& filename, const std::vector<U8>& file)
+{
+    // LLFile rather than LLAPRFile, the APR pool belongs to the main thread
+    LLFILE* fp = LLFile::fopen(filename, "wb");
+    if (!fp)
+    {
+        LL_WARNS() << "Failed to open cache file " << filename << " for writing" << LL_ENDL;
+        return false;
+    }
+
+    bool success = fwrite(file.data(), 1, file.size(), fp) == file.size();
+    success = (fclose(fp) == 0) && success;
+    if (!success)
+    {
+        // the file is corrupt now, readFromCache drops the region when it sees it
+        LL_WARNS() << "Failed to write cache to disk " << filename << LL_ENDL;
+    }
+    return success;
+}
+
+void LLVOCache::writeAssetList(U64 handle, const asset_list_t& assets)
+{
+    if (!mEnabled || !mInitialized || mReadOnly || mHandleEntryMap.find(handle) == mHandleEntryMap.end())
+    {
+        return;
+    }
+
+    U32 num_entries = llmin((U32)assets.size(), MAX_ASSET_LIST_ENTRIES);
+    const size_t entry_size = sizeof(S32) + UUID_BYTES;
+    std::shared_ptr<std::vector<U8> > file = std::make_shared<std::vector<U8> >(2 * sizeof(U32) + num_entries * entry_size);
+    U8* out = file->data();
+    memcpy(out, &ASSET_LIST_VERSION, sizeof(U32));
+    memcpy(out + sizeof(U32), &num_entries, sizeof(U32));
+    out += 2 * sizeof(U32);
+    for (U32 i = 0; i < num_entries; ++i)
+    {
+        S32 type = assets[i].first;
+        memcpy(out, &type, sizeof(S32));
+        memcpy(out + sizeof(S32), assets[i].second.mData, UUID_BYTES);
+        out += entry_size;
+    }
+
+    queueCacheFile(getObjectCacheAssetsFilename(handle), file);
+}
+
+//static
+bool LLVOCache::parseAssetList(const std::vector<U8>& file, asset_list_t& assets)
+{
+    const size_t entry_size = sizeof(S32) + UUID_BYTES;
+    U32 version = 0;
+    U32 num_entries = 0;
+    if (file.size() < 2 * sizeof(U32))
+    {
+        return false;
+    }
+    memcpy(&version, file.data(), sizeof(U32));
+    memcpy(&num_entries, file.data() + sizeof(U32), sizeof(U32));
+    if (version != ASSET_LIST_VERSION || num_entries > MAX_ASSET_LIST_ENTRIES
+        || file.size() != 2 * sizeof(U32) + num_entries * entry_size)
+    {
+        return false;
+    }
+
+    const U8* in = file.data() + 2 * sizeof(U32);
+    assets.resize(num_entries);
+    for (U32 i = 0; i < num_entries; ++i)
+    {
+        S32 type;
+        memcpy(&type, in, sizeof(S32));
+        assets[i].first = (LLAssetType::EType)type;
+        memcpy(assets[i].second.mData, in + sizeof(S32), UUID_BYTES);
+        in += entry_size;
+    }
+    return true;
+}
+
+void LLVOCache::prefetchAssets(U64 handle)
+{
+    static LLCachedControl<U32> max_mb(gSavedSettings, "TeleportPrefetchMaxMB", 128);
+    if (!mEnabled || !mInitialized || max_mb == 0 || mHandleEntryMap.find(handle) == mHandleEntryMap.end())
+    {
+        return;
+    }
+    if (handle == mPrefetchHandle && mPrefetchTimer.getElapsedTimeF32() < PREFETCH_REPEAT_SECONDS)
+    {
+        return;
+    }
+    mPrefetchHandle = handle;
+    mPrefetchTimer.reset();
+
+    LL::WorkQueue::ptr_t main_queue = LL::WorkQueue::getInstance("mainloop");
+    LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+    if (!main_queue || !general_queue)
+    {
+        return;
+    }
+
+    // files still waiting to be written are in memory already
+    std::vector<std::string> region_files;
+    std::string filename;
+    getObjectCacheFilename(handle, filename);
+    if (!getPendingFile(filename))
+    {
+        region_files.push_back(filename);
+    }
+    filename = getObjectCacheExtrasFilename(handle);
+    if (!getPendingFile(filename))
+    {
+        region_files.push_back(filename);
+    }
+    std::string assets_filename = getObjectCacheAssetsFilename(handle);
+    cache_file_t pending_assets = getPendingFile(assets_filename);
+
+    struct Prefetch
+    {
+        asset_list_t mAssets;
+        U64 mBytes = 0;
+        LLTimer mTimer;
+    };
+    std::shared_ptr<Prefetch> prefetch = std::make_shared<Prefetch>();
+    std::shared_ptr<std::atomic<U32> > generation = mPrefetchGeneration;
+    U32 my_generation = ++(*generation);
+    U64 budget = (U64)max_mb() << 20;
+
+    main_queue->postTo(
+        general_queue,
+        [prefetch, region_files, assets_filename, pending_assets, generation, my_generation, budget]() // Work done on general queue
         {
-            S32 num_entries = static_cast<S32>(cache_entry_map.size()); // if removal is enabled num_entries might be wrong
-            success = check_write(&apr_file, &num_entries, sizeof(S32));
-            if (success)
+            LL_PROFILE_ZONE_NAMED("vocache prefetch region");
+            prefetch->mBytes = prefetchFiles(region_files, budget, generation, my_generation);
+            if (pending_assets)
+            {
+                parseAssetList(*pending_assets, prefetch->mAssets);
+            }
+            else
             {
-                const S32 buffer_size = 32768; //should be large enough for couple MAX_ENTRY_BODY_SIZE
-                U8 data_buffer[buffer_size]; // generaly entries are fairly small, so collect them and drop onto disk in one go
-                S32 size_in_buffer = 0;
+                std::vector<U8> file;
+                if (readCacheFile(assets_filename, file))
+                {
+                    parseAssetList(file, prefetch->mAssets);
+                }
+            }
+        },
+        [prefetch, general_queue, generation, my_generation, budget, handle]() // Callback to main thread
+        {
+            if (*generation != my_generation || prefetch->mAssets.empty())
+            {
+                return;
+            }
 
-                // This can have a lot of entries, so might be better to dump them into buffer first and write in one go.
-                for (LLVOCacheEntry::vocache_entry_map_t::const_iterator iter = cache_entry_map.begin(); success && iter != cache_entry_map.end(); ++iter)
+            // only the main thread knows where the caches are
+            LLTextureCache* texture_cache = LLAppViewer::getTextureCache();
+            std::vector<std::string> filenames;
+            filenames.reserve(prefetch->mAssets.size());
+            for (const auto& asset : prefetch->mAssets)
+            {
+                if (asset.first == LLAssetType::AT_TEXTURE)
                 {
-                    if (!removal_enabled || iter->second->isValid())
+                    if (texture_cache)
                     {
-                        S32 size = iter->second->writeToBuffer(data_buffer + size_in_buffer);
-
-                        if (size > ENTRY_HEADER_SIZE) // body is minimum of 1
-                        {
-                            size_in_buffer += size;
-                        }
-                        else
-                        {
-                            LL_WARNS() << "Failed to write cache entry to buffer for " << filename << ", entry number " << iter->second->getLocalID() << LL_ENDL;
-                            success = false;
-                            break;
-                        }
-
-                        // Make sure we have space in buffer for next element
-                        if (buffer_size - size_in_buffer < MAX_ENTRY_BODY_SIZE + ENTRY_HEADER_SIZE)
-                        {
-                            success = check_write(&apr_file, (void*)data_buffer, size_in_buffer);
-                            size_in_buffer = 0;
-                            if (!success)
-                            {
-                                LL_WARNS() << "Failed to write cache to disk " << filename << LL_ENDL;
-                                break;
-                            }
-                        }
+                        filenames.push_back(texture_cache->getTextureFileName(asset.second));
                     }
                 }
+                else if (LLDiskCache::instanceExists())
+                {
+                    // blobs of the blob store are not found here, they are mapped anyway
+                    filenames.push_back(LLDiskCache::metaDataToFilepath(asset.second, asset.first));
+                }
+            }
 
-                if (success && size_in_buffer > 0)
+            general_queue->post(
+                [prefetch, filenames, generation, my_generation, budget, handle]()
                 {
-                    // final write
-                    success = check_write(&apr_file, (void*)data_buffer, size_in_buffer);
-                    if(!success)
+                    LL_PROFILE_ZONE_NAMED("vocache prefetch assets");
+                    U64 bytes = prefetch->mBytes;
+                    if (bytes < budget)
                     {
-                        LL_WARNS() << "Failed to write cache entry to disk " << filename << LL_ENDL;
+                        bytes += prefetchFiles(filenames, budget - bytes, generation, my_generation);
                     }
-                    size_in_buffer = 0;
-                }
-                LL_DEBUGS("VOCache") << "Wrote " << num_entries << " entries to the primary VOCache file " << filename << ". success = " << (success ? "True":"False") << LL_ENDL;
-            }
-        }
-    }
+                    LL_INFOS("VOCache") << "Prefetched " << (bytes >> 10) << " KB for region " << handle << ", "
+                        << filenames.size() << " assets listed, in " << prefetch->mTimer.getElapsedTimeF32() << " seconds"
+                        << (*generation != my_generation ? " (abandoned)" : "") << LL_ENDL;
+                });
+        });
+}
 
-    if(!success)
+//static
+U64 LLVOCache::prefetchFiles(const std::vector<std::string>& filenames, U64 budget, const std::shared_ptr<std::atomic<U32> >& generation, U32 my_generation)
+{
+    std::vector<U8> buffer(PREFETCH_CHUNK_SIZE);
+    U64 bytes = 0;
+    for (const std::string& filename : filenames)
     {
-        removeEntry(entry) ;
-    }
+        if (bytes >= budget || *generation != my_generation)
+        {
+            break;
+        }
 
-    return ;
+        LLFILE* fp = LLFile::fopen(filename, "rb");
+        if (!fp)
+        {
+            continue; // not cached
+        }
+        size_t read;
+        while (bytes < budget && (read = fread(buffer.data(), 1, buffer.size(), fp)) > 0)
+        {
+            bytes += read;
+        }
+        fclose(fp);
+    }
+    return bytes;
 }
 
 void LLVOCache::removeGenericExtrasForHandle(U64 handle)
@@ -1884,6 +2323,7 @@ void LLVOCache::removeGenericExtrasForHandle(U64 handle)
     else
     {
         //shouldn't happen, but if it does, we should remove the extras file since it's orphaned
+        discardPendingWrite(getObjectCacheExtrasFilename(handle));
         LLFile::remove(getObjectCacheExtrasFilename(handle));
     }
 }
@@ -1903,34 +2343,17 @@ void LLVOCache::writeGenericExtrasToCache(U64 handle, const LLUUID& id, const LL
         return;
     }
 
+    // serialized here, the General queue writes the file
     std::string filename = getObjectCacheExtrasFilename(handle);
-    llofstream out(filename, std::ios::out | std::ios::binary);
-    if(!out.good())
-    {
-        LL_WARNS() << "Failed writing extras cache for handle " << handle << LL_ENDL;
-        removeGenericExtrasForHandle(handle);
-        return;
-    }
+    std::ostringstream out;
     // It is good practice to version file formats so let's add one.
     // legacy versions will be treated as version 0.
     out << LLGLTFOverrideCacheEntry::VERSION_LABEL << ":" << LLGLTFOverrideCacheEntry::VERSION << '\n';
 
     out << id << '\n';
-    if(!out.good())
-    {
-        LL_WARNS() << "Failed writing extras cache for handle " << handle << LL_ENDL;
-        removeGenericExtrasForHandle(handle);
-        return;
-    }
     // Because we don't write out all the entries we need to record a placeholder and rewrite this later
     auto num_entries_placeholder = out.tellp();
     out << std::setw(10) << std::setfill('0') << 0 << '\n';
-    if(!out.good())
-    {
-        LL_WARNS() << "Failed writing extras cache for handle " << handle << LL_ENDL;
-        removeGenericExtrasForHandle(handle);
-        return;
-    }
 
     // get ViewerRegion pointer from handle
     LLViewerRegion* pRegion = LLWorld::getInstance()->getRegionFromHandle(handle);
@@ -1958,13 +2381,6 @@ void LLVOCache::writeGenericExtrasToCache(U64 handle, const LLUUID& id, const LL
             entry_llsd["local_id"] = (S32)local_id;
             LLSDSerialize::serialize(entry_llsd, out, LLSDSerialize::LLSD_XML);
             out << '\n';
-            if(!out.good())
-            {
-                // We're not in a good place when this happens so we might as well nuke the file.
-                LL_WARNS() << "Failed writing extras cache for handle " << handle << ". Corrupted cache file " << filename << " removed." << LL_ENDL;
-                removeGenericExtrasForHandle(handle);
-                return;
-            }
             num_entries++;
         }
         else
@@ -1975,11 +2391,8 @@ void LLVOCache::writeGenericExtrasToCache(U64 handle, const LLUUID& id, const LL
     // Rewrite the placeholder
     out.seekp(num_entries_placeholder);
     out << std::setw(10) << std::setfill('0') << num_entries << '\n';
-    if(!out.good())
-    {
-        LL_WARNS() << "Failed writing extras cache for handle " << handle << LL_ENDL;
-        removeGenericExtrasForHandle(handle);
-        return;
-    }
-    LL_DEBUGS("GLTF") << "Completed writing extras cache for handle " << handle << ", " << num_entries << " entries. Total in RAM: " << inmem_entries << " skipped (no persist): " << skipped << LL_ENDL;
+
+    std::string text = out.str();
+    queueCacheFile(filename, std::make_shared<const std::vector<U8> >(text.begin(), text.end()));
+    LL_DEBUGS("GLTF") << "Queued extras cache for handle " << handle << ", " << num_entries << " entries. Total in RAM: " << inmem_entries << " skipped (no persist): " << skipped << LL_ENDL;
 }
@@ -33,8 +33,15 @@
 #include "llvieweroctree.h"
 #include "llapr.h"
 #include "llgltfmaterial.h"
+#include "llmutex.h"
+#include "llassettype.h"
+#include "lltimer.h"
 
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 //---------------------------------------------------------------------------
 // Cache entries
@@ -58,8 +65,8 @@ public:
 class LLVOCacheEntry
 :   public LLViewerOctreeEntryData
 {
-    LL_ALIGN_NEW
 public:
+    LL_HEAP_OPERATORS(LLHeap::HEAP_SCENE)
     enum
     {
         //low 16-bit state
@@ -102,7 +109,8 @@ protected:
     ~LLVOCacheEntry();
 public:
     LLVOCacheEntry(U32 local_id, U32 crc, LLDataPackerBinaryBuffer &dp);
-    LLVOCacheEntry(LLAPRFile* apr_file);
+    // reads the entry at 'data' and moves 'data' past it, the local id is 0 if the entry is corrupt
+    LLVOCacheEntry(const U8*& data, const U8* data_end);
     LLVOCacheEntry();
 
     void updateEntry(U32 crc, LLDataPackerBinaryBuffer &dp);
@@ -235,6 +243,7 @@ private:
     U32   mCullHistory;
     U32   mCulledTime[LLViewerCamera::NUM_CAMERAS];
     std::set<LLVOCacheGroup*> mOccludedGroups;
+    LLViewerOctreeFlat mFlatOctree; // what cull() and selectBackObjects() traverse
 
     S32   mBackSlectionEnabled; //enable to select back objects if > 0.
     U32   mIdleHash;
@@ -280,6 +289,17 @@ private:
     typedef std::set<HeaderEntryInfo*, header_entry_less> header_entry_queue_t;
     typedef std::map<U64, HeaderEntryInfo*> handle_entry_map_t;
 
+    // Region cache and extras files are laid out in memory on the main thread and
+    // written by the General queue. Until a file is on disk it is read back from
+    // here, the worker only writes it if it still is the latest version of the file.
+    typedef std::shared_ptr<const std::vector<U8> > cache_file_t;
+    struct PendingWrites
+    {
+        LLMutex mMutex;
+        std::map<std::string, cache_file_t> mFiles; // by file name
+    };
+    typedef std::shared_ptr<PendingWrites> pending_writes_t;
+
 public:
     // We need this init to be separate from constructor, since we might construct cache, purge it, then init.
     void initCache(ELLPath location, U32 size, U32 cache_version);
@@ -288,11 +308,26 @@ public:
     bool readFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::vocache_entry_map_t& cache_entry_map) ;
     void readGenericExtrasFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::vocache_gltf_overrides_map_t& cache_extras_entry_map, const LLVOCacheEntry::vocache_entry_map_t& cache_entry_map);
 
+    // readFromCache and readGenericExtrasFromCache with the file reads and parsing on the General queue,
+    // 'callback' runs on the main thread, right away if there is no cache file for the region
+    typedef std::function<void(bool success, LLVOCacheEntry::vocache_entry_map_t& cache_entry_map, LLVOCacheEntry::vocache_gltf_overrides_map_t& cache_extras_entry_map)> cache_loaded_callback_t;
+    void readFromCacheAsync(U64 handle, const LLUUID& id, cache_loaded_callback_t callback);
+
     void writeToCache(U64 handle, const LLUUID& id, const LLVOCacheEntry::vocache_entry_map_t& cache_entry_map, bool dirty_cache, bool removal_enabled);
     void writeGenericExtrasToCache(U64 handle, const LLUUID& id, const LLVOCacheEntry::vocache_gltf_overrides_map_t& cache_extras_entry_map, bool dirty_cache, bool removal_enabled);
     void removeEntry(U64 handle) ;
     void removeGenericExtrasForHandle(U64 handle);
 
+    // Assets the objects of a region used when it was last left: AT_TEXTURE for the texture cache,
+    // anything else for the disk cache. Kept next to the region's cache, read back by prefetchAssets.
+    typedef std::vector<std::pair<LLAssetType::EType, LLUUID> > asset_list_t;
+    void writeAssetList(U64 handle, const asset_list_t& assets);
+
+    // Reads the region's cache files and then the cached files of its asset list on the General queue,
+    // throwing the data away, so they come from memory rather than the disk when the region asks for them.
+    // Starting a prefetch abandons the one still running.
+    void prefetchAssets(U64 handle);
+
     U32 getCacheEntries() { return mNumEntries; }
     U32 getCacheEntriesMax() { return mCacheSize; }
 
@@ -301,6 +336,7 @@ private:
     // determine the cache filename for the region from the region handle
     void getObjectCacheFilename(U64 handle, std::string& filename);
     std::string getObjectCacheExtrasFilename(U64 handle);
+    std::string getObjectCacheAssetsFilename(U64 handle);
     void removeFromCache(HeaderEntryInfo* entry);
     void readCacheHeader();
     void writeCacheHeader();
@@ -310,6 +346,23 @@ private:
     void purgeEntries(U32 size);
     bool updateEntry(const HeaderEntryInfo* entry);
 
+    static bool parseCacheFile(const std::vector<U8>& file, const LLUUID& id, const std::string& filename, LLVOCacheEntry::vocache_entry_map_t& cache_entry_map);
+    // false if the extras file is unusable and should be removed, 'extras' holds whatever was read before the failure
+    static bool parseGenericExtras(std::istream& in, U64 handle, const LLUUID& id, LLVOCacheEntry::vocache_gltf_overrides_map_t& extras);
+    // copies the extras of objects still in 'cache_entry_map' to 'cache_extras_entry_map'
+    void addGenericExtras(U64 handle, LLVOCacheEntry::vocache_gltf_overrides_map_t& extras, LLVOCacheEntry::vocache_gltf_overrides_map_t& cache_extras_entry_map, const LLVOCacheEntry::vocache_entry_map_t& cache_entry_map);
+    void queueCacheFile(const std::string& filename, const cache_file_t& file);
+    cache_file_t getPendingFile(const std::string& filename);
+    void discardPendingWrite(const std::string& filename);
+    void discardPendingWrites();
+    // writes every file still waiting for the worker
+    void flushPendingWrites();
+    static bool readCacheFile(const std::string& filename, std::vector<U8>& file);
+    static bool writeCacheFile(const std::string& filename, const std::vector<U8>& file);
+    static bool parseAssetList(const std::vector<U8>& file, asset_list_t& assets);
+    // reads through the files until 'budget' bytes were read or 'generation' moved on, returns the bytes read
+    static U64 prefetchFiles(const std::vector<std::string>& filenames, U64 budget, const std::shared_ptr<std::atomic<U32> >& generation, U32 my_generation);
+
 private:
     bool                 mEnabled;
     bool                 mInitialized ;
@@ -322,6 +375,10 @@ private:
     LLVolatileAPRPool*   mLocalAPRFilePoolp ;
     header_entry_queue_t mHeaderEntryQueue;
     handle_entry_map_t   mHandleEntryMap;
+    pending_writes_t     mPendingWrites;
+    std::shared_ptr<std::atomic<U32> > mPrefetchGeneration;
+    U64                  mPrefetchHandle;
+    LLTimer              mPrefetchTimer;
 };
 
 #endif
@@ -2166,6 +2166,7 @@ LLVoiceWebRTCConnection::LLVoiceWebRTCConnection(const LLUUID &regionID, const s
     mIceCompleted(false),
     mSpeakerVolume(0.0),
     mOutstandingRequests(0),
+    mDataDrainPosted(false),
     mChannelID(channelID),
     mRegionID(regionID),
     mPrimary(true),
@@ -2881,9 +2882,38 @@ bool LLVoiceWebRTCConnection::connectionStateMachine()
 // 'v'  - boolean - voice activity has been detected.
 
 // llwebrtc callback
+// Level and participant updates arrive many times a second per peer, so
+// they're parsed here on the webrtc thread and queued without locking.
+// Only one drain is posted to the main loop at a time, which applies
+// everything that arrived in the meantime in one go.
 void LLVoiceWebRTCConnection::OnDataReceived(const std::string& data, bool binary)
 {
-    LL::WorkQueue::postMaybe(mMainQueue, [=] { LLVoiceWebRTCConnection::OnDataReceivedImpl(data, binary); });
+    if (binary)
+    {
+        LL_WARNS("Voice") << "Binary data received from data channel." << LL_ENDL;
+        return;
+    }
+
+    boost::system::error_code ec;
+    boost::json::value voice_data_parsed = boost::json::parse(data, ec);
+    if (ec)  // don't collect comments
+    {
+        return;
+    }
+    if (!voice_data_parsed.is_object())
+    {
+        LL_WARNS("Voice") << "Expected object from data channel:" << data << LL_ENDL;
+        return;
+    }
+
+    if (!mDataUpdates.pushIfOpen(std::move(voice_data_parsed.as_object())))
+    {
+        return;
+    }
+    if (!mDataDrainPosted.exchange(true))
+    {
+        LL::WorkQueue::postMaybe(mMainQueue, [=] { LLVoiceWebRTCConnection::processDataUpdates(); });
+    }
 }
 
 //
@@ -2891,139 +2921,133 @@ void LLVoiceWebRTCConnection::OnDataReceived(const std::string& data, bool binar
 // before the webrtc connection itself is shut down, so
 // we shouldn't be getting this callback on a nonexistant
 // this pointer.
-void LLVoiceWebRTCConnection::OnDataReceivedImpl(const std::string &data, bool binary)
+void LLVoiceWebRTCConnection::processDataUpdates()
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_VOICE;
 
-    if (mShutDown)
-    {
-        return;
-    }
+    // clear first, so that anything pushed while we drain posts again
+    mDataDrainPosted = false;
 
-    if (binary)
+    boost::json::object voice_data;
+    while (mDataUpdates.tryPop(voice_data))
     {
-        LL_WARNS("Voice") << "Binary data received from data channel." << LL_ENDL;
-        return;
+        if (mShutDown)
+        {
+            continue;
+        }
+        OnDataReceivedImpl(voice_data);
     }
+}
 
-    boost::system::error_code ec;
-    boost::json::value voice_data_parsed = boost::json::parse(data, ec);
-    if (!ec)  // don't collect comments
+void LLVoiceWebRTCConnection::OnDataReceivedImpl(const boost::json::object &voice_data)
+{
+    bool new_participant = false;
+    boost::json::object mute;
+    boost::json::object user_gain;
+    for (auto &participant_elem : voice_data)
     {
-        if (!voice_data_parsed.is_object())
+        boost::json::string participant_id(participant_elem.key());
+        LLUUID agent_id(participant_id.c_str());
+        if (agent_id.isNull())
         {
-            LL_WARNS("Voice") << "Expected object from data channel:" << data << LL_ENDL;
-            return;
+           // probably a test client.
+           continue;
         }
-        boost::json::object voice_data = voice_data_parsed.as_object();
-        bool new_participant = false;
-        boost::json::object mute;
-        boost::json::object user_gain;
-        for (auto &participant_elem : voice_data)
+
+        if (!participant_elem.value().is_object())
         {
-            boost::json::string participant_id(participant_elem.key());
-            LLUUID agent_id(participant_id.c_str());
-            if (agent_id.isNull())
-            {
-               // probably a test client.
-               continue;
-            }
+            continue;
+        }
+
+        boost::json::object participant_obj = participant_elem.value().as_object();
 
-            if (!participant_elem.value().is_object())
+        LLWebRTCVoiceClient::participantStatePtr_t participant =
+            LLWebRTCVoiceClient::getInstance()->findParticipantByID(mChannelID, agent_id);
+        bool joined  = false;
+        bool primary = false;  // we ignore any 'joins' reported about participants
+                               // that come from voice servers that aren't their primary
+                               // voice server.  This will happen with cross-region voice
+                               // where a participant on a neighboring region may be
+                               // connected to multiple servers.  We don't want to
+                               // add new identical participants from all of those servers.
+        if (participant_obj.contains("j") &&
+            participant_obj["j"].is_object())
+        {
+            // a new participant has announced that they're joining.
+            joined  = true;
+            if (participant_obj["j"].as_object().contains("p") &&
+                participant_obj["j"].as_object()["p"].is_bool())
             {
-                continue;
+                primary = participant_obj["j"].as_object()["p"].as_bool();
             }
 
-            boost::json::object participant_obj = participant_elem.value().as_object();
-
-            LLWebRTCVoiceClient::participantStatePtr_t participant =
-                LLWebRTCVoiceClient::getInstance()->findParticipantByID(mChannelID, agent_id);
-            bool joined  = false;
-            bool primary = false;  // we ignore any 'joins' reported about participants
-                                   // that come from voice servers that aren't their primary
-                                   // voice server.  This will happen with cross-region voice
-                                   // where a participant on a neighboring region may be
-                                   // connected to multiple servers.  We don't want to
-                                   // add new identical participants from all of those servers.
-            if (participant_obj.contains("j") &&
-                participant_obj["j"].is_object())
+            // track incoming participants that are muted so we can mute their connections (or set their volume)
+            bool isMuted = LLMuteList::getInstance()->isMuted(agent_id, LLMute::flagVoiceChat);
+            if (isMuted)
             {
-                // a new participant has announced that they're joining.
-                joined  = true;
-                if (participant_elem.value().as_object()["j"].as_object().contains("p") &&
-                    participant_elem.value().as_object()["j"].as_object()["p"].is_bool())
-                {
-                    primary = participant_elem.value().as_object()["j"].as_object()["p"].as_bool();
-                }
-
-                // track incoming participants that are muted so we can mute their connections (or set their volume)
-                bool isMuted = LLMuteList::getInstance()->isMuted(agent_id, LLMute::flagVoiceChat);
-                if (isMuted)
-                {
-                    mute[participant_id] = true;
-                }
-                F32 volume;
-                if(LLSpeakerVolumeStorage::getInstance()->getSpeakerVolume(agent_id, volume))
-                {
-                    user_gain[participant_id] = (uint32_t)(volume * 200);
-                }
+                mute[participant_id] = true;
             }
-
-            new_participant |= joined;
-            if (!participant && joined && (primary || !isSpatial()))
+            F32 volume;
+            if(LLSpeakerVolumeStorage::getInstance()->getSpeakerVolume(agent_id, volume))
             {
-                participant = LLWebRTCVoiceClient::getInstance()->addParticipantByID(mChannelID, agent_id, mRegionID);
+                user_gain[participant_id] = (uint32_t)(volume * 200);
             }
+        }
 
-            if (participant)
+        new_participant |= joined;
+        if (!participant && joined && (primary || !isSpatial()))
+        {
+            participant = LLWebRTCVoiceClient::getInstance()->addParticipantByID(mChannelID, agent_id, mRegionID);
+        }
+
+        if (participant)
+        {
+            if (participant_obj.contains("l") && participant_obj["l"].is_bool() && participant_obj["l"].as_bool())
             {
-                if (participant_obj.contains("l") && participant_obj["l"].is_bool() && participant_obj["l"].as_bool())
+                // an existing participant is leaving.
+                if (agent_id != gAgentID)
                 {
-                    // an existing participant is leaving.
-                    if (agent_id != gAgentID)
-                    {
-                        LLWebRTCVoiceClient::getInstance()->removeParticipantByID(mChannelID, agent_id, mRegionID);
-                    }
+                    LLWebRTCVoiceClient::getInstance()->removeParticipantByID(mChannelID, agent_id, mRegionID);
                 }
-                else
+            }
+            else
+            {
+                // we got a 'power' update.
+                if (participant_obj.contains("p") && participant_obj["p"].is_number())
                 {
-                    // we got a 'power' update.
-                    if (participant_obj.contains("p") && participant_obj["p"].is_number())
-                    {
-                        // server sends up power as an integer which is level * 128 to save
-                        // character count.
-                        participant->mLevel = (F32)participant_obj["p"].as_int64()/128.0f;
-                    }
+                    // server sends up power as an integer which is level * 128 to save
+                    // character count.
+                    participant->mLevel = (F32)participant_obj["p"].as_int64()/128.0f;
+                }
 
-                    if (participant_obj.contains("v") && participant_obj["v"].is_bool())
-                    {
-                        participant->mIsSpeaking = participant_obj["v"].as_bool();
-                    }
+                if (participant_obj.contains("v") && participant_obj["v"].is_bool())
+                {
+                    participant->mIsSpeaking = participant_obj["v"].as_bool();
+                }
 
-                    if (participant_obj.contains("m") && participant_obj["m"].is_bool())
-                    {
-                        participant->mIsModeratorMuted = participant_obj["m"].as_bool();
-                    }
+                if (participant_obj.contains("m") && participant_obj["m"].is_bool())
+                {
+                    participant->mIsModeratorMuted = participant_obj["m"].as_bool();
                 }
             }
         }
+    }
 
-        // tell the simulator to set the mute and volume data for this
-        // participant, if there are any updates.
-        boost::json::object root;
-        if (mute.size() > 0)
-        {
-            root["m"] = mute;
-        }
-        if (user_gain.size() > 0)
-        {
-            root["ug"] = user_gain;
-        }
-        if (root.size() > 0)
-        {
-            std::string json_data = boost::json::serialize(root);
-            mWebRTCDataInterface->sendData(json_data, false);
-        }
+    // tell the simulator to set the mute and volume data for this
+    // participant, if there are any updates.
+    boost::json::object root;
+    if (mute.size() > 0)
+    {
+        root["m"] = mute;
+    }
+    if (user_gain.size() > 0)
+    {
+        root["ug"] = user_gain;
+    }
+    if (root.size() > 0)
+    {
+        std::string json_data = boost::json::serialize(root);
+        mWebRTCDataInterface->sendData(json_data, false);
     }
 }
 
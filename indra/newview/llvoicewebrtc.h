@@ -41,6 +41,8 @@ class LLWebRTCProtocolParser;
 #include "llcoros.h"
 #include "llparcel.h"
 #include "llmutelist.h"
+#include "lllockfreequeue.h"
+#include <atomic>
 #include <queue>
 #include "boost/json.hpp"
 
@@ -610,7 +612,9 @@ class LLVoiceWebRTCConnection :
     void OnDataChannelReady(llwebrtc::LLWebRTCDataInterface *data_interface) override;
     //@}
 
-    void OnDataReceivedImpl(const std::string &data, bool binary);
+    // apply the updates batched up since the last drain, main thread
+    void processDataUpdates();
+    void OnDataReceivedImpl(const boost::json::object &voice_data);
 
     void sendJoin();
     void sendData(const std::string &data);
@@ -634,6 +638,7 @@ class LLVoiceWebRTCConnection :
     void shutDown()
     {
         mShutDown = true;
+        mDataUpdates.close();
     }
 
     bool isShuttingDown()
@@ -709,6 +714,11 @@ class LLVoiceWebRTCConnection :
     bool mShutDown;
     S32  mOutstandingRequests;
 
+    // Participant, level and mute updates parsed on the webrtc thread,
+    // drained once per frame on the main thread.
+    LLLockFreeQueue<boost::json::object> mDataUpdates;
+    std::atomic<bool>                    mDataDrainPosted;
+
     S32  mRetryWaitPeriod; // number of UPDATE_THROTTLE_SECONDS we've
                            // waited since our last attempt to connect.
     F32  mRetryWaitSecs;   // number of seconds to wait before next retry
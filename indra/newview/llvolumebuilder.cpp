@@ -0,0 +1,235 @@
+/**
+ * @file llvolumebuilder.cpp
+ * @brief Generates prim and sculpt volumes off the main thread.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llvolumebuilder.h"
+
+#include "llprimitive.h"
+#include "llviewercontrol.h"
+#include "llvolumemgr.h"
+#include "llvovolume.h"
+#include "threadpool.h"
+
+LLVolumeBuilder gVolumeBuilder;
+
+// Generating a volume takes well under a frame, two threads keep up with
+// region entry without competing much with the image decoders.
+constexpr size_t VOLUME_BUILD_THREADS = 2;
+
+LLVolumeBuilder::LLVolumeBuilder()
+{
+}
+
+LLVolumeBuilder::~LLVolumeBuilder()
+{
+    shutdown();
+}
+
+void LLVolumeBuilder::init()
+{
+    // "ThreadPoolSizes" may override the width, 0 builds everything on the
+    // main thread
+    size_t threads = LL::ThreadPool::getConfiguredWidth("VolumeBuild", VOLUME_BUILD_THREADS);
+    if (threads > 0)
+    {
+        mPool.reset(new LL::ThreadPool("VolumeBuild", threads));
+        mPool->start();
+    }
+    LL_INFOS() << "Volume build threads: " << threads << LL_ENDL;
+}
+
+void LLVolumeBuilder::shutdown()
+{
+    if (mPool)
+    {
+        mPool->close();
+        mPool.reset();
+    }
+
+    {
+        LLMutexLock lock(&mResultMutex);
+        mResults.clear();
+    }
+    mPrimJobs.clear();
+    mSculptJobs.clear();
+}
+
+bool LLVolumeBuilder::isEnabled() const
+{
+    static LLCachedControl<bool> async_volume_build(gSavedSettings, "RenderAsyncVolumeBuild", true);
+    return mPool && async_volume_build;
+}
+
+bool LLVolumeBuilder::post(const std::function<void()>& work)
+{
+    return mPool && mPool->getQueue().post(work);
+}
+
+//static
+void LLVolumeBuilder::addWaiter(waiter_list_t& waiters, LLVOVolume* objectp)
+{
+    if (std::find(waiters.begin(), waiters.end(), objectp) == waiters.end())
+    {
+        waiters.push_back(objectp);
+    }
+}
+
+//static
+void LLVolumeBuilder::notifyWaiters(const waiter_list_t& waiters)
+{
+    for (const LLPointer<LLVOVolume>& objectp : waiters)
+    {
+        if (!objectp->isDead())
+        {
+            objectp->notifyVolumeBuilt();
+        }
+    }
+}
+
+bool LLVolumeBuilder::buildVolume(LLVOVolume* objectp, const LLVolumeParams& params, S32 lod)
+{
+    if (!isEnabled() || LLPrimitive::getVolumeManager()->hasVolume(params, lod))
+    {
+        return false;
+    }
+
+    prim_key_t key(params, lod);
+    auto iter = mPrimJobs.find(key);
+    if (iter != mPrimJobs.end())
+    {
+        addWaiter(iter->second, objectp);
+        return true;
+    }
+
+    F32 detail = LLVolumeLODGroup::getVolumeScaleFromDetail(lod);
+    if (!post([this, params, lod, detail]()
+        {
+            LL_PROFILE_ZONE_NAMED_CATEGORY_VOLUME("build volume");
+            // generates the path, profile and faces
+            LLPointer<LLVolume> volume = new LLVolume(params, detail);
+
+            LLMutexLock lock(&mResultMutex);
+            mResults.push_back({ params, lod, NULL, std::move(volume) });
+        }))
+    {
+        return false;
+    }
+
+    addWaiter(mPrimJobs[key], objectp);
+    return true;
+}
+
+bool LLVolumeBuilder::buildSculpt(LLVOVolume* objectp, LLVolume* volume, U16 sculpt_width, U16 sculpt_height,
+                                  S8 sculpt_components, const U8* sculpt_data, S32 sculpt_level, bool visible_placeholder)
+{
+    // Placeholders are cheap, unique volumes are not shared
+    if (!isEnabled() || volume->isUnique()
+        || !sculpt_data || sculpt_width == 0 || sculpt_height == 0 || sculpt_components < 3)
+    {
+        return false;
+    }
+
+    auto iter = mSculptJobs.find(volume);
+    if (iter != mSculptJobs.end())
+    {
+        // Done or not, the object will look at the sculpt level again
+        addWaiter(iter->second.mWaiters, objectp);
+        return true;
+    }
+
+    // The raw image may change or go away before the pool gets to it
+    S32 bytes = (S32)sculpt_width * (S32)sculpt_height * (S32)sculpt_components;
+    std::shared_ptr<std::vector<U8> > data = std::make_shared<std::vector<U8> >(sculpt_data, sculpt_data + bytes);
+
+    LLVolumeParams params = volume->getParams();
+    F32 detail = volume->getDetail();
+    if (!post([this, params, detail, volume, data, sculpt_width, sculpt_height, sculpt_components, sculpt_level, visible_placeholder]()
+        {
+            LL_PROFILE_ZONE_NAMED_CATEGORY_VOLUME("build sculpt");
+            // 'volume' is only a key here, it is in use on the main thread
+            LLPointer<LLVolume> built = new LLVolume(params, detail);
+            built->sculpt(sculpt_width, sculpt_height, sculpt_components, data->data(), sculpt_level, visible_placeholder);
+
+            LLMutexLock lock(&mResultMutex);
+            mResults.push_back({ params, sculpt_level, volume, std::move(built) });
+        }))
+    {
+        return false;
+    }
+
+    SculptJob& job = mSculptJobs[volume];
+    job.mVolume = volume;
+    job.mLevel = volume->getSculptLevel();
+    addWaiter(job.mWaiters, objectp);
+    return true;
+}
+
+void LLVolumeBuilder::update()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    std::vector<Result> results;
+    {
+        LLMutexLock lock(&mResultMutex);
+        results.swap(mResults);
+    }
+
+    for (Result& result : results)
+    {
+        if (result.mSculptTarget)
+        {
+            auto iter = mSculptJobs.find(result.mSculptTarget);
+            if (iter == mSculptJobs.end())
+            {
+                continue;
+            }
+
+            SculptJob& job = iter->second;
+            // Leave it alone if it was sculpted on this thread since
+            if (job.mVolume->getSculptLevel() == job.mLevel)
+            {
+                job.mVolume->swapGeometry(result.mVolume);
+            }
+            notifyWaiters(job.mWaiters);
+            mSculptJobs.erase(iter);
+        }
+        else
+        {
+            auto iter = mPrimJobs.find(prim_key_t(result.mParams, result.mLOD));
+            if (iter == mPrimJobs.end())
+            {
+                continue;
+            }
+
+            // Nothing to do if every object that used these parameters is
+            // gone, or the LOD was generated on this thread since
+            LLPrimitive::getVolumeManager()->publishVolume(result.mVolume, result.mLOD);
+            notifyWaiters(iter->second);
+            mPrimJobs.erase(iter);
+        }
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ * @file llvolumebuilder.h
+ * @brief Generates prim and sculpt volumes off the main thread.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLVOLUMEBUILDER_H
+#define LL_LLVOLUMEBUILDER_H
+
+#include <functional>
+#include <map>
+
+#include "llpointer.h"
+#include "llthread.h"
+#include "llvolume.h"
+#include "threadpool_fwd.h"
+
+class LLVOVolume;
+
+// Builds the shared volumes that LOD switches of prims and sculpt map
+// updates need on the "VolumeBuild" thread pool, instead of in the middle
+// of the rebuild on the main thread. The objects keep drawing the volume
+// they have until the new one is published by update(); they are then
+// marked for rebuild and pick it up from LLVolumeMgr.
+//
+// Only volumes other objects may share are built here. Unique volumes
+// (flexible prims) and meshes, which have their own pipeline in
+// LLMeshRepository, are not.
+
+class LLVolumeBuilder
+{
+public:
+    LLVolumeBuilder();
+    ~LLVolumeBuilder();
+
+    void init();
+    void shutdown();
+
+    // Main thread, once per frame: publishes the finished volumes and
+    // notifies the objects waiting on them.
+    void update();
+
+    bool isEnabled() const;
+
+    // Generates LOD 'lod' of 'params' for 'objectp', which already draws
+    // another LOD of the same parameters. Returns false if it should be
+    // generated right away instead.
+    bool buildVolume(LLVOVolume* objectp, const LLVolumeParams& params, S32 lod);
+
+    // Regenerates the shared sculpt 'volume' of 'objectp' from a copy of
+    // the sculpt map. Returns false if it should be sculpted right away.
+    bool buildSculpt(LLVOVolume* objectp, LLVolume* volume, U16 sculpt_width, U16 sculpt_height,
+                     S8 sculpt_components, const U8* sculpt_data, S32 sculpt_level, bool visible_placeholder);
+
+    U32 getPendingCount() const { return (U32)(mPrimJobs.size() + mSculptJobs.size()); }
+
+private:
+    typedef std::vector<LLPointer<LLVOVolume> > waiter_list_t;
+    static void addWaiter(waiter_list_t& waiters, LLVOVolume* objectp);
+    static void notifyWaiters(const waiter_list_t& waiters);
+
+    bool post(const std::function<void()>& work);
+
+    typedef std::pair<LLVolumeParams, S32> prim_key_t;
+    std::map<prim_key_t, waiter_list_t> mPrimJobs;
+
+    struct SculptJob
+    {
+        LLPointer<LLVolume> mVolume;
+        S32                 mLevel;
+        waiter_list_t       mWaiters;
+    };
+    // keyed by the shared volume, which never leaves the main thread
+    std::map<LLVolume*, SculptJob> mSculptJobs;
+
+    // Filled by the pool, drained by update()
+    struct Result
+    {
+        LLVolumeParams      mParams;
+        S32                 mLOD;
+        LLVolume*           mSculptTarget; // key into mSculptJobs, NULL for prims
+        LLPointer<LLVolume> mVolume;
+    };
+    LLMutex             mResultMutex;
+    std::vector<Result> mResults;
+
+    std::unique_ptr<LL::ThreadPool> mPool;
+};
+
+extern LLVolumeBuilder gVolumeBuilder;
+
+#endif // LL_LLVOLUMEBUILDER_H
@@ -76,6 +76,7 @@ F32 LLVOTree::sLODAngles[sMAX_NUM_TREE_LOD_LEVELS] = {30.f, 20.f, 15.f, F_ALMOST
 F32 LLVOTree::sTreeFactor = 1.f;
 
 LLVOTree::SpeciesMap LLVOTree::sSpeciesTable;
+LLVOTree::mesh_map_t LLVOTree::sInstanceMeshes;
 S32 LLVOTree::sMaxTreeSpecies = 0;
 
 // Tree variables and functions
@@ -87,6 +88,7 @@ LLVOTree::LLVOTree(const LLUUID &id, const LLPCode pcode, LLViewerRegion *region
     mFrameCount = 0;
     mWind = mRegionp->mWind.getVelocity(getPositionRegion());
     mTrunkLOD = 0;
+    memset(mInstanceTransform, 0, sizeof(mInstanceTransform));
 
     // if assert triggers, idleUpdate() needs to be revised and adjusted to new LOD levels
     llassert(sMAX_NUM_TREE_LOD_LEVELS == LLVolumeLODGroup::NUM_LODS);
@@ -272,6 +274,7 @@ void LLVOTree::cleanupClass()
 {
     std::for_each(sSpeciesTable.begin(), sSpeciesTable.end(), DeletePairedPointer());
     sSpeciesTable.clear();
+    sInstanceMeshes.clear();
 }
 
 U32 LLVOTree::processUpdateMessage(LLMessageSystem *mesgsys,
@@ -908,6 +911,26 @@ void LLVOTree::updateMesh()
 //  const F32 THRESH_ANGLE_FOR_BILLBOARD = 15.f;
 //  const F32 BLEND_RANGE_FOR_BILLBOARD = 3.f;
 
+    // the rest is the same for every tree of the species, the mesh is built
+    // without it and the shader puts it back per instance
+    for (S32 row = 0; row < 3; ++row)
+    {
+        for (S32 col = 0; col < 4; ++col)
+        {
+            mInstanceTransform[row * 4 + col] = scale_mat.mMatrix[col][row];
+        }
+    }
+
+    LLFace* facep = mDrawable->getFace(0);
+    if (!facep) return;
+
+    LLPointer<LLVertexBuffer>& buff = sInstanceMeshes[((U32)mSpecies << 8) | mTrunkLOD];
+    if (buff.notNull())
+    {
+        facep->setVertexBuffer(buff);
+        return;
+    }
+
     F32 droop = mDroop + 25.f*(1.f - mTrunkBend.magVec());
 
     S32 stop_depth = 0;
@@ -918,21 +941,22 @@ void LLVOTree::updateMesh()
 
     calcNumVerts(vert_count, index_count, mTrunkLOD, stop_depth, mDepth, mTrunkDepth, mBranches);
 
-    LLFace* facep = mDrawable->getFace(0);
-    if (!facep) return;
-    LLVertexBuffer* buff = new LLVertexBuffer(LLDrawPoolTree::VERTEX_DATA_MASK);
+    buff = new LLVertexBuffer(LLDrawPoolTree::VERTEX_DATA_MASK);
     if (!buff->allocateBuffer(vert_count, index_count))
     {
         LL_WARNS() << "Failed to allocate Vertex Buffer on mesh update to "
             << vert_count << " vertices and "
             << index_count << " indices" << LL_ENDL;
-        buff->allocateBuffer(1, 3);
-        memset((U8*)buff->getMappedData(), 0, buff->getSize());
-        memset((U8*)buff->getMappedIndices(), 0, buff->getIndicesSize());
+        // not shared, the next tree of the species tries again
+        LLPointer<LLVertexBuffer> empty = buff;
+        buff = NULL;
+        empty->allocateBuffer(1, 3);
+        memset((U8*)empty->getMappedData(), 0, empty->getSize());
+        memset((U8*)empty->getMappedIndices(), 0, empty->getIndicesSize());
         facep->setSize(1, 3);
-        facep->setVertexBuffer(buff);
+        facep->setVertexBuffer(empty);
         mReferenceBuffer->unmapBuffer();
-        buff->unmapBuffer();
+        empty->unmapBuffer();
         return;
     }
 
@@ -951,7 +975,8 @@ void LLVOTree::updateMesh()
     buff->getColorStrider(colors);
     buff->getIndexStrider(indices);
 
-    genBranchPipeline(vertices, normals, tex_coords, colors, indices, idx_offset, scale_mat, mTrunkLOD, stop_depth, mDepth, mTrunkDepth, 1.0, mTwist, droop, mBranches, alpha);
+    LLMatrix4 tree_space;
+    genBranchPipeline(vertices, normals, tex_coords, colors, indices, idx_offset, tree_space, mTrunkLOD, stop_depth, mDepth, mTrunkDepth, 1.0, mTwist, droop, mBranches, alpha);
 
     mReferenceBuffer->unmapBuffer();
     buff->unmapBuffer();
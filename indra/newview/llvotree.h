@@ -30,6 +30,8 @@
 #include "llviewerobject.h"
 #include "xform.h"
 
+#include <unordered_map>
+
 class LLFace;
 class LLDrawPool;
 class LLViewerFetchedTexture;
@@ -182,9 +184,18 @@ protected:
 
     U32 mFrameCount;
 
+    // Where this tree's instance of the shared mesh goes: rows of the region
+    // space transform, as std140 mat3x4, see LLDrawPoolTree::renderDeferred()
+    F32 mInstanceTransform[12];
+
     typedef std::map<U32, TreeSpeciesData*> SpeciesMap;
     static SpeciesMap sSpeciesTable;
 
+    // Tree meshes in tree space. Every tree of a species builds the same one
+    // at a given LOD, so they share it, by species << 8 | LOD
+    typedef std::unordered_map<U32, LLPointer<LLVertexBuffer> > mesh_map_t;
+    static mesh_map_t sInstanceMeshes;
+
     static S32 sLODIndexOffset[4];
     static S32 sLODIndexCount[4];
     static S32 sLODVertexOffset[4];
@@ -31,6 +31,7 @@
 #include "llvovolume.h"
 
 #include <sstream>
+#include <boost/functional/hash.hpp>
 
 #include "llviewercontrol.h"
 #include "lldir.h"
@@ -68,6 +69,7 @@
 #include "pipeline.h"
 #include "llsdutil.h"
 #include "llmatrix4a.h"
+#include "llvector4abulk.h"
 #include "llmediaentry.h"
 #include "llmediadataclient.h"
 #include "llmeshrepository.h"
@@ -86,12 +88,17 @@
 #include "llinventorytype.h"
 #include "llviewerinventory.h"
 #include "llsculptidsize.h"
+#include "llvolumebuilder.h"
 #include "llavatarappearancedefines.h"
 #include "llgltfmateriallist.h"
 #include "gltfscenemanager.h"
+#include "hbxxh.h"
+#include "llparallel.h"
 
 const F32 FORCE_SIMPLE_RENDER_AREA = 512.f;
 const F32 FORCE_CULL_AREA = 8.f;
+// vertices in a batch below which handing its faces out costs more than it saves
+const U32 PARALLEL_FILL_VERTICES = 8192;
 U32 JOINT_COUNT_REQUIRED_FOR_FULLRIG = 1;
 
 bool gAnimateTextures = true;
@@ -593,6 +600,12 @@ void LLVOVolume::animateTextures()
 {
     if (!mDead)
     {
+        if (mTexAnimMode && mDrawable.notNull() && !mDrawable->isRecentlyVisible())
+        { // the animation is a function of its timer, so faces that are off screen can
+          // pick up where it is once they are drawn again
+            return;
+        }
+
         shrinkWrap();
         F32 off_s = 0.f, off_t = 0.f, scale_s = 1.f, scale_t = 1.f, rot = 0.f;
         S32 result = mTextureAnimp->animateTextures(off_s, off_t, scale_s, scale_t, rot);
@@ -1083,6 +1096,25 @@ bool LLVOVolume::setVolume(const LLVolumeParams &params_in, const S32 detail, bo
         volume_params.setSculptID(LLUUID::null, LL_SCULPT_TYPE_NONE);
 
     }
+    else if ((volume_params.getSculptType() & LL_SCULPT_TYPE_MASK) == LL_SCULPT_TYPE_MESH)
+    {
+        // The mesh replaces the path and profile, so instances that only
+        // differ in leftover prim parameters share one volume and one load
+        LLVolumeParams mesh_params;
+        mesh_params.setType(volume_params.getProfileParams().getCurveType(), volume_params.getPathParams().getCurveType());
+        mesh_params.setSculptID(volume_params.getSculptID(), volume_params.getSculptType());
+        volume_params = mesh_params;
+    }
+
+    // A LOD switch of a prim keeps drawing the current LOD until the new
+    // one has been generated off the main thread
+    if (mVolumep.notNull() && !mVolumeImpl && !mSculptChanged && NO_LOD != lod
+        && !volume_params.isSculpt() && volume_params == mVolumep->getParams()
+        && mVolumep->getDetail() != LLVolumeLODGroup::getVolumeScaleFromDetail(lod)
+        && gVolumeBuilder.buildVolume(this, volume_params, lod))
+    {
+        return false;
+    }
 
     if ((LLPrimitive::setVolume(volume_params, lod, (mVolumeImpl && mVolumeImpl->isVolumeUnique()))) || mSculptChanged)
     {
@@ -1203,12 +1235,12 @@ void LLVOVolume::updateVisualComplexity()
     LLVOAvatar* avatar = getAvatarAncestor();
     if (avatar)
     {
-        avatar->updateVisualComplexity();
+        avatar->updateVisualComplexity(this);
     }
     LLVOAvatar* rigged_avatar = getAvatar();
     if(rigged_avatar && (rigged_avatar != avatar))
     {
-        rigged_avatar->updateVisualComplexity();
+        rigged_avatar->updateVisualComplexity(this);
     }
 }
 
@@ -1242,6 +1274,25 @@ void LLVOVolume::notifyMeshLoaded()
     updateVisualComplexity();
 }
 
+void LLVOVolume::notifyVolumeBuilt()
+{
+    if (mDrawable.isNull())
+    {
+        return;
+    }
+
+    // Either way lodOrSculptChanged() picks up the new volume
+    if (isSculpted())
+    {
+        mSculptChanged = true;
+    }
+    else
+    {
+        mLODChanged = true;
+    }
+    gPipeline.markRebuild(mDrawable, LLDrawable::REBUILD_VOLUME);
+}
+
 void LLVOVolume::notifySkinInfoLoaded(const LLMeshSkinInfo* skin)
 {
     mSkinInfoUnavaliable = false;
@@ -1363,7 +1414,11 @@ void LLVOVolume::sculpt()
             }
         }
 
-        getVolume()->sculpt(sculpt_width, sculpt_height, sculpt_components, sculpt_data, discard_level, mSculptTexture->isMissingAsset());
+        if (!gVolumeBuilder.buildSculpt(this, getVolume(), sculpt_width, sculpt_height, sculpt_components, sculpt_data,
+                                        discard_level, mSculptTexture->isMissingAsset()))
+        {
+            getVolume()->sculpt(sculpt_width, sculpt_height, sculpt_components, sculpt_data, discard_level, mSculptTexture->isMissingAsset());
+        }
     }
 }
 
@@ -1383,6 +1438,37 @@ S32 LLVOVolume::computeLODDetail(F32 distance, F32 radius, F32 lod_factor)
     return cur_detail;
 }
 
+F32 LLVOVolume::getMeshLODError(S32 lod) const
+{
+    if (!mDrawable)
+    {
+        return 0.f;
+    }
+
+    LLViewerCamera* camera = LLViewerCamera::getInstance();
+    F32 pixels_per_meter = (F32)camera->getViewHeightInPixels() / (2.f * tanf(camera->getView() * 0.5f));
+    F32 projected_radius = mDrawable->getRadius() * pixels_per_meter / llmax(mDrawable->mDistanceWRTCamera, 1.f);
+    if (lod < 0)
+    {
+        return projected_radius;
+    }
+
+    // Lower LODs drop detail in proportion to their volume scale
+    F32 detail = LLVolumeLODGroup::getVolumeScaleFromDetail(llmin(lod, LLVolumeLODGroup::NUM_LODS - 1))
+        / LLVolumeLODGroup::getVolumeScaleFromDetail(LLVolumeLODGroup::NUM_LODS - 1);
+    return projected_radius * (1.f - detail);
+}
+
+S32 LLVOVolume::getLoadedMeshLOD() const
+{
+    const LLVolume* volume = getVolume();
+    if (!volume || !volume->isMeshAssetLoaded())
+    {
+        return -1;
+    }
+    return LLVolumeLODGroup::getVolumeDetailFromScale(volume->getDetail());
+}
+
 std::string get_debug_object_lod_text(LLVOVolume *rootp)
 {
     std::string cam_dist_string = "";
@@ -3892,7 +3978,28 @@ void LLVOVolume::generateSilhouette(LLSelectNode* nodep, const LLVector3& view_p
             trans_mat.translate(getRegion()->getOriginAgent());
         }
 
-        volume->generateSilhouetteVertices(nodep->mSilhouetteVertices, nodep->mSilhouetteNormals, view_vector, trans_mat, mRelativeXformInvTrans, nodep->getTESelectMask());
+        // Objects get flagged for a new silhouette by every update, and the
+        // children of a linkset by every update of their root, most of which
+        // leave the object where it was relative to the camera
+        S32 face_mask = nodep->getTESelectMask();
+        HBXXH64 hash;
+        hash.update(&volume, sizeof(volume));
+        hash.update(&face_mask, sizeof(face_mask));
+        hash.update(view_vector.mV, sizeof(view_vector.mV));
+        hash.update(trans_mat.mMatrix, sizeof(trans_mat.mMatrix));
+        hash.update(mRelativeXformInvTrans.mMatrix, sizeof(mRelativeXformInvTrans.mMatrix));
+        for (S32 i = 0; i < volume->getNumVolumeFaces(); ++i)
+        {
+            S32 num_indices = volume->getVolumeFace(i).mNumIndices;
+            hash.update(&num_indices, sizeof(num_indices));
+        }
+        U64 digest = hash.digest();
+
+        if (!nodep->mSilhouetteExists || nodep->mSilhouetteHash != digest)
+        {
+            volume->generateSilhouetteVertices(nodep->mSilhouetteVertices, nodep->mSilhouetteNormals, view_vector, trans_mat, mRelativeXformInvTrans, face_mask);
+            nodep->mSilhouetteHash = digest;
+        }
 
         nodep->mSilhouetteExists = true;
     }
@@ -4992,6 +5099,10 @@ void LLRiggedVolume::update(
                 rigged_vert_count += dst_face.mNumVertices;
                 rigged_face_count++;
 
+                // the bind shape matrix is the same for every vertex, so
+                // take all of them through it in one go, then skin in place
+                LLVector4aBulk::affineTransform(bind_shape_matrix, vol_face.mPositions, pos, dst_face.mNumVertices);
+
             #if USE_SEPARATE_JOINT_INDICES_AND_WEIGHTS
                 if (vol_face.mJointIndices) // fast path with preconditioned joint indices
                 {
@@ -5005,12 +5116,8 @@ void LLRiggedVolume::update(
                         LLSkinningUtil::getPerVertexSkinMatrixWithIndices(w, joint_indices_cursor, mat, final_mat, src);
                         joint_indices_cursor += 4;
 
-                        LLVector4a& v = vol_face.mPositions[j];
-                        LLVector4a t;
-                        LLVector4a dst;
-                        bind_shape_matrix.affineTransform(v, t);
-                        final_mat.affineTransform(t, dst);
-                        pos[j] = dst;
+                        LLVector4a t = pos[j];
+                        final_mat.affineTransform(t, pos[j]);
                     }
                 }
                 else
@@ -5021,12 +5128,8 @@ void LLRiggedVolume::update(
                         LLMatrix4a final_mat;
                         LLSkinningUtil::getPerVertexSkinMatrix(weight[j].getF32ptr(), mat, false, final_mat, max_joints);
 
-                        LLVector4a& v = vol_face.mPositions[j];
-                        LLVector4a t;
-                        LLVector4a dst;
-                        bind_shape_matrix.affineTransform(v, t);
-                        final_mat.affineTransform(t, dst);
-                        pos[j] = dst;
+                        LLVector4a t = pos[j];
+                        final_mat.affineTransform(t, pos[j]);
                     }
                 }
 
@@ -5035,20 +5138,13 @@ void LLRiggedVolume::update(
                 LLVector4a& min = dst_face.mExtents[0];
                 LLVector4a& max = dst_face.mExtents[1];
 
-                min = pos[0];
-                max = pos[1];
+                LLVector4aBulk::getMinMax(pos, dst_face.mNumVertices, min, max);
                 if (i==0)
                 {
                     box_min = min;
                     box_max = max;
                 }
 
-                for (S32 j = 1; j < dst_face.mNumVertices; ++j)
-                {
-                    min.setMin(min, pos[j]);
-                    max.setMax(max, pos[j]);
-                }
-
                 box_min.setMin(min,box_min);
                 box_max.setMax(max,box_max);
 
@@ -5155,6 +5251,21 @@ bool can_batch_texture(LLFace* facep)
     return true;
 }
 
+// Texture that decides whether two faces can share a batch. PBR faces only
+// draw their diffuse texture when it is a media texture (see registerFace),
+// so copies of a mesh with the same GLTF material batch together whatever
+// legacy texture their texture entries still carry.
+static LLViewerTexture* get_batch_texture(const LLFace* facep)
+{
+    LLViewerTexture* tex = facep->getTexture();
+    if (facep->getTextureEntry()->getGLTFRenderMaterial() != nullptr
+        && (!facep->hasMedia() || (tex && tex->getType() != LLViewerTexture::MEDIA_TEXTURE)))
+    {
+        return nullptr;
+    }
+    return tex;
+}
+
 const static U32 MAX_FACE_COUNT = 4096U;
 int32_t LLVolumeGeometryManager::sInstanceCount = 0;
 LLFace** LLVolumeGeometryManager::sFullbrightFaces[2] = { NULL };
@@ -5229,6 +5340,169 @@ void LLVolumeGeometryManager::freeFaces()
     }
 }
 
+// Returns the volume face of facep if it is split into clusters the draw
+// pools can cull, see LLVolumeFace::mClusters
+static const LLVolumeFace* get_cluster_face(LLFace* facep, U32 type)
+{
+    if (type == LLRenderPass::PASS_ALPHA || facep->isState(LLFace::RIGGED))
+    { // alpha is sorted and drawn whole, rigged faces have no fixed bounds
+        return nullptr;
+    }
+
+    LLDrawable* drawable = facep->getDrawable();
+    if (drawable->isState(LLDrawable::ANIMATED_CHILD))
+    {
+        return nullptr;
+    }
+
+    LLVOVolume* vobj = drawable->getVOVolume();
+    LLVolume* volume = vobj ? vobj->getVolume() : nullptr;
+    if (!volume || facep->getTEOffset() >= volume->getNumVolumeFaces())
+    {
+        return nullptr;
+    }
+
+    const LLVolumeFace& vf = volume->getVolumeFace(facep->getTEOffset());
+    if (vf.mClusters.empty() || vf.mNumIndices != (S32)facep->getIndicesCount())
+    {
+        return nullptr;
+    }
+    return &vf;
+}
+
+// Moves the clusters of vf into the space of the vertex buffer facep was
+// just copied to, with the transform getGeometryVolume used
+static void set_draw_info_clusters(LLDrawInfo* info, LLFace* facep, const LLVolumeFace& vf)
+{
+    LLVOVolume* vobj = facep->getDrawable()->getVOVolume();
+    const LLMatrix4& xform = vobj->getRelativeXform();
+
+    LLMatrix4a mat_vert;
+    mat_vert.loadu(xform);
+    LLMatrix4a mat_normal;
+    mat_normal.loadu(vobj->getRelativeXformInvTrans());
+
+    F32 min_scale = F32_MAX;
+    F32 max_scale = 0.f;
+    for (U32 i = 0; i < 3; ++i)
+    {
+        F32 scale = LLVector3(xform.mMatrix[i]).length();
+        min_scale = llmin(min_scale, scale);
+        max_scale = llmax(max_scale, scale);
+    }
+    // normal cones don't survive non uniform scales
+    bool use_cones = min_scale > 0.f && max_scale <= min_scale * 1.01f;
+
+    info->mClusters.resize(vf.mClusters.size());
+    for (size_t i = 0; i < vf.mClusters.size(); ++i)
+    {
+        const LLMeshOptimizer::Cluster& src = vf.mClusters[i];
+        LLDrawInfo::Cluster& dst = info->mClusters[i];
+
+        LLVector4a v;
+        v.load3(src.mCenter);
+        mat_vert.affineTransform(v, dst.mCenter);
+        dst.mCenter.getF32ptr()[3] = src.mRadius * max_scale;
+
+        v.load3(src.mConeApex);
+        mat_vert.affineTransform(v, dst.mConeApex);
+
+        v.load3(src.mConeAxis);
+        mat_normal.rotate(v, dst.mConeAxis);
+        dst.mConeAxis.normalize3fast();
+        dst.mConeAxis.getF32ptr()[3] = use_cones ? src.mConeCutoff : 2.f;
+
+        dst.mOffset = facep->getIndicesStart() + src.mIndexOffset;
+        dst.mCount = src.mIndexCount;
+    }
+}
+
+// Brings the clusters of the batch facep draws by itself back in line with the
+// geometry just rewritten into its range of the vertex buffer
+static void update_draw_info_clusters(LLSpatialGroup* group, LLFace* facep)
+{
+    const LLVolumeFace* vf = get_cluster_face(facep, LLRenderPass::PASS_SIMPLE);
+    if (!vf)
+    {
+        return;
+    }
+
+    for (auto& entry : group->mDrawMap)
+    {
+        for (LLDrawInfo* info : entry.second)
+        {
+            if (!info->mClusters.empty() &&
+                info->mVertexBuffer == facep->getVertexBuffer() &&
+                info->mOffset == facep->getIndicesStart())
+            {
+                set_draw_info_clusters(info, facep, *vf);
+                return;
+            }
+        }
+    }
+}
+
+// Copy face geometry into its range of its vertex buffer, with the transform
+// of its object. Safe on a worker thread once facep->prepareGeometryOffThread()
+// returned true.
+static bool fill_face_geometry(LLFace* facep)
+{
+    LLDrawable* drawablep = facep->getDrawable();
+    LLVOVolume* vobj = drawablep->getVOVolume();
+    LLVolume* volume = vobj->getVolume();
+
+    if (drawablep->isState(LLDrawable::ANIMATED_CHILD))
+    {
+        vobj->updateRelativeXform(true);
+    }
+
+    bool success = facep->getGeometryVolume(*volume, facep->getTEOffset(),
+        vobj->getRelativeXform(), vobj->getRelativeXformInvTrans(), facep->getGeomIndex(), true);
+    if (!success)
+    {
+        LL_WARNS() << "Failed to get geometry for face!" << LL_ENDL;
+    }
+
+    if (drawablep->isState(LLDrawable::ANIMATED_CHILD))
+    {
+        vobj->updateRelativeXform(false);
+    }
+
+    return success;
+}
+
+// Hash of everything about a face the full rebuild uses to pick its vertex buffer
+// and batch. A face whose key still matches the one stored at the last full rebuild
+// can be rewritten into the range it already has.
+static U64 face_layout_key(LLFace* facep)
+{
+    const LLTextureEntry* te = facep->getTextureEntry();
+    if (!te || facep->getGeomCount() == 0 || facep->getIndicesCount() == 0)
+    {
+        return 0;
+    }
+
+    LLViewerTexture* tex = facep->getTexture();
+    const LLGLTFMaterial* gltf_mat = te->getGLTFRenderMaterial();
+
+    size_t seed = 0;
+    boost::hash_combine(seed, facep->getGeomCount());
+    boost::hash_combine(seed, facep->getIndicesCount());
+    boost::hash_combine(seed, (const void*)tex);
+    boost::hash_combine(seed, (const void*)gltf_mat);
+    boost::hash_combine(seed, gltf_mat ? (S32)gltf_mat->mAlphaMode : -1);
+    boost::hash_combine(seed, (const void*)te->getMaterialParams().get());
+    boost::hash_combine(seed, (const void*)facep->mTextureMatrix);
+    boost::hash_combine(seed, te->getBumpShinyFullbright());
+    boost::hash_combine(seed, te->getGlow() > 0.f);
+    boost::hash_combine(seed, te->hasMedia());
+    boost::hash_combine(seed, LLPipeline::getPoolTypeFromTE(te, tex));
+    boost::hash_combine(seed, facep->getPixelArea() < FORCE_SIMPLE_RENDER_AREA);
+    boost::hash_combine(seed, facep->isState(LLFace::RIGGED | LLFace::TEXTURE_ANIM));
+
+    return llmax((U64)seed, (U64)1);
+}
+
 void LLVolumeGeometryManager::registerFace(LLSpatialGroup* group, LLFace* facep, U32 type)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
@@ -5326,10 +5600,8 @@ void LLVolumeGeometryManager::registerFace(LLSpatialGroup* group, LLFace* facep,
     if (gltf_mat != nullptr)
     {
         mat_id = gltf_mat->getHash(); // TODO: cache this hash
-        if (!facep->hasMedia() || (tex && tex->getType() != LLViewerTexture::MEDIA_TEXTURE))
-        { // no media texture, face texture will be unused
-            tex = nullptr;
-        }
+        // no media texture, face texture will be unused
+        tex = get_batch_texture(facep);
     }
     else
     {
@@ -5383,7 +5655,12 @@ void LLVolumeGeometryManager::registerFace(LLSpatialGroup* group, LLFace* facep,
 
     LLDrawInfo* info = idx >= 0 ? draw_vec[idx] : nullptr;
 
+    // clustered faces get a batch of their own so it can be partly drawn
+    const LLVolumeFace* cluster_face = get_cluster_face(facep, type);
+
     if (info &&
+        !cluster_face &&
+        info->mClusters.empty() &&
         info->mVertexBuffer == facep->getVertexBuffer() &&
         info->mEnd == facep->getGeomIndex()-1 &&
         (LLPipeline::sTextureBindTest || draw_vec[idx]->mTexture == tex || batchable) &&
@@ -5496,6 +5773,11 @@ void LLVolumeGeometryManager::registerFace(LLSpatialGroup* group, LLFace* facep,
             draw_info->mTextureList.resize(index+1);
             draw_info->mTextureList[index] = tex;
         }
+
+        if (cluster_face)
+        {
+            set_draw_info_clusters(draw_info, facep, *cluster_face);
+        }
         draw_info->validate();
     }
 
@@ -5579,6 +5861,12 @@ void LLVolumeGeometryManager::rebuildGeom(LLSpatialGroup* group)
         vol_obj->updateVisualComplexity();
     }
 
+    static LLCachedControl<bool> in_place(gSavedSettings, "RenderRebuildGeomInPlace", true);
+    if (in_place && rebuildGeomInPlace(group))
+    {
+        return;
+    }
+
     group->mGeometryBytes = 0;
     group->mSurfaceArea = 0;
 
@@ -5623,6 +5911,18 @@ void LLVolumeGeometryManager::rebuildGeom(LLSpatialGroup* group)
         {
             LLDrawable* drawablep = (LLDrawable*)(*drawable_iter)->getDrawable();
 
+            if (drawablep)
+            { // faces only get a layout again if they land in a buffer below
+                for (S32 i = 0; i < drawablep->getNumFaces(); i++)
+                {
+                    LLFace* facep = drawablep->getFace(i);
+                    if (facep)
+                    {
+                        facep->mLayoutKey = 0;
+                    }
+                }
+            }
+
             if (!drawablep || drawablep->isDead() || drawablep->isState(LLDrawable::FORCE_INVISIBLE) )
             {
                 continue;
@@ -6018,6 +6318,7 @@ void LLVolumeGeometryManager::rebuildGeom(LLSpatialGroup* group)
     }
 
     group->mGeometryBytes = geometryBytes;
+    group->mLayoutFaceCount = 0;
 
     {
         //drawables have been rebuilt, clear rebuild status
@@ -6027,6 +6328,15 @@ void LLVolumeGeometryManager::rebuildGeom(LLSpatialGroup* group)
             if(drawablep)
             {
                 drawablep->clearState(LLDrawable::REBUILD_ALL);
+
+                for (S32 i = 0; i < drawablep->getNumFaces(); i++)
+                {
+                    LLFace* facep = drawablep->getFace(i);
+                    if (facep && facep->mLayoutKey)
+                    {
+                        group->mLayoutFaceCount++;
+                    }
+                }
             }
         }
     }
@@ -6093,6 +6403,10 @@ void LLVolumeGeometryManager::rebuildMesh(LLSpatialGroup* group)
                                     group->dirtyGeom();
                                     gPipeline.markRebuild(group);
                                 }
+                                else
+                                {
+                                    update_draw_info_clusters(group, face);
+                                }
                             }
                         }
                     }
@@ -6116,6 +6430,149 @@ void LLVolumeGeometryManager::rebuildMesh(LLSpatialGroup* group)
     }
 }
 
+bool LLVolumeGeometryManager::rebuildGeomInPlace(LLSpatialGroup* group)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    if (group->hasState(LLSpatialGroup::ALPHA_DIRTY) || group->mLayoutFaceCount == 0)
+    { // alpha batches need sorting again, or there's no layout to reuse
+        return false;
+    }
+
+    static std::vector<LLDrawable*> dirty;
+    dirty.resize(0);
+
+    U32 face_count = 0;
+
+    for (LLSpatialGroup::element_iter drawable_iter = group->getDataBegin(); drawable_iter != group->getDataEnd(); ++drawable_iter)
+    {
+        LLDrawable* drawablep = (LLDrawable*)(*drawable_iter)->getDrawable();
+        if (!drawablep)
+        {
+            continue;
+        }
+
+        LLVOVolume* vobj = drawablep->getVOVolume();
+        bool skipped = drawablep->isDead() || drawablep->isState(LLDrawable::FORCE_INVISIBLE) ||
+            !vobj || vobj->isDead() || vobj->mGLTFAsset;
+
+        bool rebuild = !skipped && drawablep->isState(LLDrawable::REBUILD_ALL);
+        if (rebuild)
+        {
+            // rigged, animated and texture animated drawables pick their buffers from
+            // state the layout key doesn't cover
+            if (drawablep->isState(LLDrawable::RIGGED) || vobj->isAnimatedObject() || vobj->mTextureAnimp || !vobj->getVolume())
+            {
+                return false;
+            }
+
+            S32 num_tex = llmin(vobj->getNumTEs(), drawablep->getNumFaces());
+            for (S32 i = 0; i < num_tex; ++i)
+            {
+                vobj->updateTEMaterialTextures(i);
+            }
+            gGLTFMaterialList.applyQueuedOverrides(vobj);
+
+            dirty.push_back(drawablep);
+        }
+
+        for (S32 i = 0; i < drawablep->getNumFaces(); i++)
+        {
+            LLFace* facep = drawablep->getFace(i);
+            if (!facep)
+            {
+                continue;
+            }
+
+            if (skipped)
+            {
+                if (facep->mLayoutKey)
+                { // drawable went away since the layout was made
+                    return false;
+                }
+                continue;
+            }
+
+            if (rebuild)
+            {
+                drawablep->updateFaceSize(i);
+            }
+
+            // untouched drawables are checked too, their textures may have changed underneath them
+            if (face_layout_key(facep) != facep->mLayoutKey)
+            {
+                return false;
+            }
+
+            if (facep->mLayoutKey)
+            {
+                if (facep->getVertexBuffer() == nullptr)
+                {
+                    return false;
+                }
+                ++face_count;
+            }
+        }
+    }
+
+    if (dirty.empty() || face_count != group->mLayoutFaceCount)
+    { // dirtied by something other than its drawables, or drawables were added or removed
+        return false;
+    }
+
+    for (LLDrawable* drawablep : dirty)
+    {
+        LLVOVolume* vobj = drawablep->getVOVolume();
+        vobj->updateTextureVirtualSize(true);
+        vobj->preRebuild();
+
+        if (drawablep->isState(LLDrawable::ANIMATED_CHILD))
+        {
+            vobj->updateRelativeXform(true);
+        }
+
+        LLVolume* volume = vobj->getVolume();
+        bool success = true;
+        for (S32 i = 0; i < drawablep->getNumFaces() && success; i++)
+        {
+            LLFace* facep = drawablep->getFace(i);
+            if (facep && facep->mLayoutKey)
+            {
+                facep->updateRebuildFlags();
+                success = facep->getGeometryVolume(*volume, facep->getTEOffset(),
+                    vobj->getRelativeXform(), vobj->getRelativeXformInvTrans(), facep->getGeomIndex(), true, true);
+                if (success)
+                {
+                    update_draw_info_clusters(group, facep);
+                }
+            }
+        }
+
+        if (drawablep->isState(LLDrawable::ANIMATED_CHILD))
+        {
+            vobj->updateRelativeXform(false);
+        }
+
+        if (!success)
+        {
+            LL_DEBUGS("Pipeline") << "In place rebuild failed, falling back to a full rebuild" << LL_ENDL;
+            return false;
+        }
+
+        drawablep->clearState(LLDrawable::REBUILD_ALL);
+    }
+
+    {
+        LL_PROFILE_ZONE_NAMED("rebuildGeomInPlace - flush");
+        LLVertexBuffer::flushBuffers();
+    }
+
+    group->mLastUpdateTime = gFrameTimeSeconds;
+    group->mBuilt = 1.f;
+    group->clearState(LLSpatialGroup::GEOM_DIRTY);
+    return true;
+}
+
 struct CompareBatchBreaker
 {
     bool operator()(const LLFace* const& lhs, const LLFace* const& rhs)
@@ -6139,9 +6596,13 @@ struct CompareBatchBreaker
         {
             return lte->getShiny() < rte->getShiny();
         }
-        else if (lhs->getTexture() != rhs->getTexture())
+        else if (lte->getGLTFRenderMaterial() != rte->getGLTFRenderMaterial())
+        {
+            return lte->getGLTFRenderMaterial() < rte->getGLTFRenderMaterial();
+        }
+        else if (get_batch_texture(lhs) != get_batch_texture(rhs))
         {
-            return lhs->getTexture() < rhs->getTexture();
+            return get_batch_texture(lhs) < get_batch_texture(rhs);
         }
         else
         {
@@ -6223,6 +6684,7 @@ U32 LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace
         //pull off next face
         LLFace* facep = *face_iter;
         LLViewerTexture* tex = facep->getTexture();
+        LLViewerTexture* batch_tex = get_batch_texture(facep);
         const LLTextureEntry* te = facep->getTextureEntry();
         LLMaterialPtr mat = te->getMaterialParams();
         LLMaterialID matId = te->getMaterialID();
@@ -6343,7 +6805,7 @@ U32 LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace
                 while (i != end_faces &&
                     (LLPipeline::sTextureBindTest ||
                         (distance_sort ||
-                            ((*i)->getTexture() == tex))))
+                            get_batch_texture(*i) == batch_tex)))
                 {
                     facep = *i;
                     const LLTextureEntry* nextTe = facep->getTextureEntry();
@@ -6396,17 +6858,22 @@ U32 LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace
         U32 indices_index = 0;
         U16 index_offset = 0;
 
-        while (face_iter < i)
+        // Faces write disjoint ranges of the buffer, so a batch with enough
+        // vertices in it is filled on the compute pool. Faces that can't go
+        // there are filled right away.
+        bool fill_in_parallel = buffer.notNull() && geom_count >= PARALLEL_FILL_VERTICES;
+        std::vector<LLFace*> fill_faces;
+
+        for (LLFace** fill_iter = face_iter; fill_iter < i; ++fill_iter)
         {
             //update face indices for new buffer
-            facep = *face_iter;
+            facep = *fill_iter;
 
             if (buffer.isNull())
             {
                 // Bulk allocation failed
                 facep->setVertexBuffer(buffer);
                 facep->setSize(0, 0); // mark as no geometry
-                ++face_iter;
                 continue;
             }
             facep->setIndicesIndex(indices_index);
@@ -6418,37 +6885,55 @@ U32 LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace
                 LL_ERRS() << "Invalid texture index." << LL_ENDL;
             }
 
-            {
-                //for debugging, set last time face was updated vs moved
-                facep->updateRebuildFlags();
+            //for debugging, set last time face was updated vs moved
+            facep->updateRebuildFlags();
 
-                { //copy face geometry into vertex buffer
-                    LLDrawable* drawablep = facep->getDrawable();
-                    LLVOVolume* vobj = drawablep->getVOVolume();
-                    LLVolume* volume = vobj->getVolume();
+            if (fill_in_parallel && facep->prepareGeometryOffThread())
+            {
+                fill_faces.push_back(facep);
+            }
+            else if (fill_face_geometry(facep))
+            {
+                facep->mLayoutKey = face_layout_key(facep);
+            }
 
-                    if (drawablep->isState(LLDrawable::ANIMATED_CHILD))
-                    {
-                        vobj->updateRelativeXform(true);
-                    }
+            index_offset += facep->getGeomCount();
+            indices_index += facep->getIndicesCount();
+        }
 
-                    U32 te_idx = facep->getTEOffset();
+        if (!fill_faces.empty())
+        {
+            LL_PROFILE_ZONE_NAMED("genDrawInfo - parallel fill");
+            buffer->mapAll();
 
-                    if (!facep->getGeometryVolume(*volume, te_idx,
-                        vobj->getRelativeXform(), vobj->getRelativeXformInvTrans(), index_offset,true))
+            std::vector<U8> filled(fill_faces.size(), 0);
+            LL::parallel_for(size_t(0), fill_faces.size(), size_t(1),
+                [&fill_faces, &filled](size_t first, size_t last)
+                {
+                    for (size_t k = first; k < last; ++k)
                     {
-                        LL_WARNS() << "Failed to get geometry for face!" << LL_ENDL;
+                        filled[k] = fill_face_geometry(fill_faces[k]);
                     }
+                });
 
-                    if (drawablep->isState(LLDrawable::ANIMATED_CHILD))
-                    {
-                        vobj->updateRelativeXform(false);
-                    }
+            for (size_t k = 0; k < fill_faces.size(); ++k)
+            {
+                if (filled[k])
+                {
+                    fill_faces[k]->mLayoutKey = face_layout_key(fill_faces[k]);
                 }
             }
+        }
 
-            index_offset += facep->getGeomCount();
-            indices_index += facep->getIndicesCount();
+        while (face_iter < i)
+        {
+            facep = *face_iter;
+
+            if (buffer.isNull())
+            {
+                ++face_iter;
+                continue;
+            }
 
             //append face to appropriate render batch
 
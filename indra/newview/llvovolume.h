@@ -338,6 +338,13 @@ public:
     //convenience accessor for mesh ID (which is stored in sculpt id for legacy reasons)
     const LLUUID& getMeshID() const { return getVolume()->getParams().getSculptID(); }
 
+    // Screen-space error, in pixels, of drawing this mesh at 'lod' instead
+    // of its highest LOD, or of drawing nothing at all when 'lod' is -1.
+    // Used to order mesh LOD fetches.
+    F32 getMeshLODError(S32 lod) const;
+    // LOD of the mesh data the current volume was built from, -1 if none
+    S32 getLoadedMeshLOD() const;
+
     // Extended Mesh Properties
     U32 getExtendedMeshFlags() const;
     void onSetExtendedMeshFlags(U32 flags);
@@ -389,6 +396,8 @@ public:
     void updateVisualComplexity();
 
     void notifyMeshLoaded();
+    // The shared volume this object is waiting on was built by LLVolumeBuilder
+    void notifyVolumeBuilt();
     void notifySkinInfoLoaded(const LLMeshSkinInfo* skin);
     void notifySkinInfoUnavailable();
 
@@ -85,8 +85,17 @@ void LLWearableList::getAsset(const LLAssetID& assetID, const std::string& weara
         LL_DEBUGS("Avatar") << "wearable " << assetID << " found in LLWearableList" << LL_ENDL;
         asset_arrived_callback( instance, userdata );
     }
+    else if (mPendingCallbacks.count(assetID))
+    {
+        LL_DEBUGS("Avatar") << "wearable " << assetID << " already being fetched" << LL_ENDL;
+        if (asset_arrived_callback)
+        {
+            mPendingCallbacks[assetID].push_back(arrived_callback_t(asset_arrived_callback, userdata));
+        }
+    }
     else
     {
+        mPendingCallbacks[assetID];
         gAssetStorage->getAssetData(assetID,
             asset_type,
             LLWearableList::processGetAssetReply,
@@ -95,6 +104,16 @@ void LLWearableList::getAsset(const LLAssetID& assetID, const std::string& weara
     }
 }
 
+bool LLWearableList::prefetchAsset(const LLAssetID& assetID, const std::string& wearable_name, LLAvatarAppearance* avatarp, LLAssetType::EType asset_type)
+{
+    if (assetID.isNull() || mList.count(assetID) || mPendingCallbacks.count(assetID))
+    {
+        return false;
+    }
+    getAsset(assetID, wearable_name, avatarp, asset_type, NULL, NULL);
+    return true;
+}
+
 // static
 void LLWearableList::processGetAssetReply( const char* filename, const LLAssetID& uuid, void* userdata, S32 status, LLExtStat ext_status )
 {
@@ -229,6 +248,20 @@ void LLWearableList::processGetAssetReply( const char* filename, const LLAssetID
         }
     }
     delete data;
+
+    // The callbacks may ask for more wearables, take ours out first
+    std::vector<arrived_callback_t> pending;
+    std::map<LLUUID, std::vector<arrived_callback_t> >& pending_callbacks = LLWearableList::instance().mPendingCallbacks;
+    std::map<LLUUID, std::vector<arrived_callback_t> >::iterator found = pending_callbacks.find(uuid);
+    if (found != pending_callbacks.end())
+    {
+        pending.swap(found->second);
+        pending_callbacks.erase(found);
+    }
+    for (const arrived_callback_t& callback : pending)
+    {
+        callback.first(wearable, callback.second);
+    }
 }
 
 
@@ -54,6 +54,13 @@ public:
                                  LLAssetType::EType asset_type,
                                  void(*asset_arrived_callback)(LLViewerWearable*, void* userdata),
                                  void* userdata);
+    // Starts loading a wearable ahead of the getAsset() call that will want
+    // it. Requests for an asset that is already on its way share the one
+    // download. Returns true if a download was started.
+    bool                prefetchAsset(const LLAssetID& assetID,
+                                      const std::string& wearable_name,
+                                      LLAvatarAppearance *avatarp,
+                                      LLAssetType::EType asset_type);
 
     LLViewerWearable*           createCopy(const LLViewerWearable* old_wearable, const std::string& new_name = std::string());
     LLViewerWearable*           createNewWearable(LLWearableType::EType type, LLAvatarAppearance *avatarp);
@@ -65,6 +72,11 @@ protected:
     LLViewerWearable* generateNewWearable(); // used for the create... functions
 private:
     std::map<LLUUID, LLViewerWearable*> mList;
+
+    typedef std::pair<void(*)(LLViewerWearable*, void*), void*> arrived_callback_t;
+    // Assets being downloaded, with the callbacks of the requests that
+    // arrived while they were
+    std::map<LLUUID, std::vector<arrived_callback_t> > mPendingCallbacks;
 };
 
 #endif  // LL_LLWEARABLELIST_H
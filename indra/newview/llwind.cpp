@@ -199,6 +199,11 @@ LLVector3 LLWind::getVelocityNoisy(const LLVector3 &pos_region, const F32 dim)
 
 
 LLVector3 LLWind::getVelocity(const LLVector3 &pos_region)
+{
+    return getVelocity(pos_region, LLWorld::getInstance()->getRegionWidthInMeters());
+}
+
+LLVector3 LLWind::getVelocity(const LLVector3 &pos_region, F32 region_width_meters) const
 {
     llassert(mSize == 16);
     // Resolves value of wind at a location relative to SW corner of region
@@ -210,8 +215,6 @@ LLVector3 LLWind::getVelocity(const LLVector3 &pos_region)
 
     LLVector3 pos_clamped_region(pos_region);
 
-    F32 region_width_meters = LLWorld::getInstance()->getRegionWidthInMeters();
-
     if (pos_clamped_region.mV[VX] < 0.f)
     {
         pos_clamped_region.mV[VX] = 0.f;
@@ -45,6 +45,7 @@ public:
     ~LLWind();
     void renderVectors();
     LLVector3 getVelocity(const LLVector3 &location); // "location" is region-local
+    LLVector3 getVelocity(const LLVector3 &location, F32 region_width_meters) const; // doesn't touch LLWorld, safe off the main thread
     LLVector3 getVelocityNoisy(const LLVector3 &location, const F32 dim);   // "location" is region-local
 
     void decompress(LLBitPack &bitpack, LLGroupHeader *group_headerp);
@@ -690,6 +690,7 @@ void LLWorld::updateRegions(F32 max_update_time)
         LLViewerRegion::sLastCameraUpdated = LLViewerOctreeEntryData::getCurrentFrame() + 1;
     }
     LLViewerRegion::calcNewObjectCreationThrottle();
+    updateStreamingRing();
     if(LLViewerRegion::isNewObjectCreationThrottleDisabled())
     {
         max_update_time = llmax(max_update_time, 1.0f); //seconds, loosen the time throttle.
@@ -703,6 +704,22 @@ void LLWorld::updateRegions(F32 max_update_time)
         self_regionp->idleUpdate(max_time);
     }
 
+    // The region the agent is about to cross into comes next, so that the objects around the
+    // border are already created when the handoff happens instead of all at once after it
+    LLViewerRegion* crossing_regionp = getCrossingRegion();
+    if (crossing_regionp)
+    {
+        max_time = llmin((F32)(max_update_time - update_timer.getElapsedTimeF32()), max_update_time * 0.25f);
+        if (max_time > 0.f)
+        {
+            crossing_regionp->idleUpdate(max_time);
+        }
+        else
+        {
+            crossing_regionp->lightIdleUpdate();
+        }
+    }
+
     //sort regions by its mLastUpdate
     //smaller mLastUpdate first to make sure every region has chance to get updated.
     LLViewerRegion::region_priority_list_t region_list;
@@ -710,7 +727,7 @@ void LLWorld::updateRegions(F32 max_update_time)
          iter != mRegionList.end(); ++iter)
     {
         LLViewerRegion* regionp = *iter;
-        if(regionp != self_regionp)
+        if(regionp != self_regionp && regionp != crossing_regionp)
         {
             region_list.insert(regionp);
         }
@@ -749,6 +766,96 @@ void LLWorld::updateRegions(F32 max_update_time)
     sample(sNumActiveCachedObjects, mNumOfActiveCachedObjects);
 }
 
+LLViewerRegion* LLWorld::getCrossingRegion()
+{
+    static LLCachedControl<F32> prewarm_time(gSavedSettings, "RegionCrossingPrewarmTime", 2.f);
+
+    LLViewerRegion* self_regionp = gAgent.getRegion();
+    if (!self_regionp || prewarm_time <= 0.f)
+    {
+        return NULL;
+    }
+
+    // where the agent, or the vehicle it sits on, will be if it keeps going
+    LLVector3d predicted_pos = gAgent.getPositionGlobal() + LLVector3d(gAgent.getVelocity() * prewarm_time);
+    LLViewerRegion* regionp = getRegionFromPosGlobal(predicted_pos);
+    return regionp != self_regionp ? regionp : NULL;
+}
+
+void LLWorld::updateStreamingRing()
+{
+    static LLCachedControl<F32> ring_width(gSavedSettings, "ObjectStreamingRingWidth", 64.f);
+
+    mStreamingRingWidth = llmax((F32)ring_width, 0.f);
+    mOpenStreamingRing = mStreamingRingWidth > 0.f ? mNextStreamingRing : S32_MAX;
+    mNextStreamingRing = S32_MAX;
+    mStreamingCreates = 0;
+    mStreamingRebuilds = 0;
+}
+
+S32 LLWorld::getStreamingRing(F32 distance) const
+{
+    return (S32)llmin(distance / mStreamingRingWidth, 65536.f);
+}
+
+bool LLWorld::claimStreamingCreate(F32 distance)
+{
+    static LLCachedControl<U32> create_budget(gSavedSettings, "ObjectStreamingRingCreateBudget", 256);
+
+    if (mStreamingRingWidth <= 0.f)
+    {
+        return true;
+    }
+
+    S32 ring = getStreamingRing(distance);
+    if (ring > mOpenStreamingRing || (create_budget > 0 && mStreamingCreates >= create_budget))
+    {
+        mNextStreamingRing = llmin(mNextStreamingRing, ring);
+        return false;
+    }
+
+    ++mStreamingCreates;
+    return true;
+}
+
+bool LLWorld::claimStreamingRebuild(F32 distance)
+{
+    static LLCachedControl<U32> rebuild_budget(gSavedSettings, "ObjectStreamingRingRebuildBudget", 32);
+
+    if (mOpenStreamingRing == S32_MAX || getStreamingRing(distance) <= mOpenStreamingRing)
+    {
+        return true;
+    }
+
+    if (mStreamingRebuilds >= rebuild_budget)
+    {
+        return false;
+    }
+
+    ++mStreamingRebuilds;
+    return true;
+}
+
+F32 LLWorld::getStreamingTextureScale(F32 distance) const
+{
+    static LLCachedControl<F32> texture_scale(gSavedSettings, "ObjectStreamingRingTextureScale", 0.25f);
+
+    if (mOpenStreamingRing == S32_MAX)
+    {
+        return 1.f;
+    }
+
+    S32 rings_out = getStreamingRing(distance) - mOpenStreamingRing;
+    if (rings_out <= 0)
+    {
+        return 1.f;
+    }
+
+    // each ring further out asks for one fewer mip level
+    F32 scale = llclamp((F32)texture_scale, 0.f, 1.f);
+    return powf(scale, (F32)llmin(rings_out, 8));
+}
+
 void LLWorld::clearAllVisibleObjects()
 {
     for (region_list_t::iterator iter = mRegionList.begin();
@@ -150,6 +150,22 @@ public:
     U32  getNumOfActiveCachedObjects() const {return mNumOfActiveCachedObjects;}
 
     void clearAllVisibleObjects();
+
+    // Draw distance streaming ("ObjectStreamingRingWidth")
+    // The scene is brought in by rings of increasing distance from the camera. Objects are only
+    // created in the nearest ring that still has some waiting, the open ring, and at most
+    // ObjectStreamingRingCreateBudget of them per frame. Geometry rebuilds past the open ring
+    // are held to ObjectStreamingRingRebuildBudget per frame and their textures to lower
+    // resolutions, so whatever is near the camera gets finished first after a teleport.
+
+    // pick this frame's open ring from the work left waiting last frame, call before the region updates
+    void updateStreamingRing();
+    // true if an object 'distance' meters from the camera may be created now, otherwise it's counted as waiting
+    bool claimStreamingCreate(F32 distance);
+    // true if geometry 'distance' meters from the camera may be rebuilt now
+    bool claimStreamingRebuild(F32 distance);
+    // factor to scale the texture virtual size of a face 'distance' meters from the camera by
+    F32 getStreamingTextureScale(F32 distance) const;
 public:
     typedef std::list<LLViewerRegion*> region_list_t;
     const region_list_t& getRegionList() const { return mActiveRegionList; }
@@ -178,6 +194,9 @@ private:
     void clearHoleWaterObjects();
     void clearEdgeWaterObjects();
 
+    // the neighbor the agent will be in within RegionCrossingPrewarmTime at its current velocity, if any
+    LLViewerRegion* getCrossingRegion();
+
     region_list_t   mActiveRegionList;
     region_list_t   mRegionList;
     region_list_t   mVisibleRegionList;
@@ -201,6 +220,14 @@ private:
     U32 mNumOfActiveCachedObjects;
     U64MicrosecondsImplicit mSpaceTimeUSec;
 
+    // draw distance streaming, see updateStreamingRing
+    S32 getStreamingRing(F32 distance) const;
+    F32 mStreamingRingWidth = 0.f;          // meters, 0 when streaming by rings is off
+    S32 mOpenStreamingRing = S32_MAX;       // S32_MAX when nothing was waiting
+    S32 mNextStreamingRing = S32_MAX;       // nearest ring with objects waiting this frame
+    U32 mStreamingCreates = 0;              // objects created in this frame
+    U32 mStreamingRebuilds = 0;             // geometry rebuilds past the open ring in this frame
+
     ////////////////////////////
     //
     // Data for "Fake" objects
@@ -720,6 +720,9 @@ bool LLWorldMapView::drawMipmapLevel(S32 width, S32 height, S32 level, bool load
     pos_NE[VX] += tile_width;
     pos_NE[VY] += tile_width;
 
+    // Center of the view, to fetch the tiles there first
+    LLVector3d pos_center = viewPosToGlobal(width / 2, height / 2);
+
     // Iterate through the tiles on screen: we just need to ask for one tile every tile_width meters
     U32 grid_x, grid_y;
     for (F64 index_y = pos_SW[VY]; index_y < pos_NE[VY]; index_y += tile_width)
@@ -734,6 +737,13 @@ bool LLWorldMapView::drawMipmapLevel(S32 width, S32 height, S32 level, bool load
             LLPointer<LLViewerFetchedTexture> simimage = LLWorldMap::getInstance()->getObjectsTile(grid_x, grid_y, level, load);
             if (simimage)
             {
+                if (load)
+                {
+                    F64 dx = (index_x + tile_width / 2 - pos_center[VX]) / tile_width;
+                    F64 dy = (index_y + tile_width / 2 - pos_center[VY]) / tile_width;
+                    LLWorldMipmap::setTilePriority(simimage, (F32)sqrt(dx * dx + dy * dy));
+                }
+
                 // Checks that the image has a valid texture
                 if (simimage->hasGLTexture())
                 {
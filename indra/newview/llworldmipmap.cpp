@@ -35,6 +35,12 @@
 // Turn this on to output tile stats in the standard output
 #define DEBUG_TILES_STAT 0
 
+// Fetch priorities of the tiles (the virtual size they are given). Tiles must not go under full
+// resolution so that they don't get discarded, and tiles off view rank below all of those in view.
+constexpr F32 TILE_PRIORITY_OFF_VIEW = (F32)(LLWorldMipmap::MAP_TILE_SIZE * LLWorldMipmap::MAP_TILE_SIZE);
+constexpr F32 TILE_PRIORITY_IN_VIEW_MIN = 2.f * TILE_PRIORITY_OFF_VIEW;
+constexpr F32 TILE_PRIORITY_IN_VIEW_MAX = 2048.f * 2048.f;
+
 LLWorldMipmap::LLWorldMipmap() :
     mCurrentLevel(0)
 {
@@ -85,6 +91,9 @@ void LLWorldMipmap::equalizeBoostLevels()
                 // so we drop its boost level to BOOST_NONE.
                 img->setBoostLevel(LLGLTexture::BOOST_NONE);
             }
+            // Tiles drawn this time get their priority back from setTilePriority(), the others
+            // stop competing with them for the fetcher
+            setTilePriority(img, -1.f);
 #if DEBUG_TILES_STAT
             // Increment some stats if compile option on
             nb_tiles++;
@@ -116,6 +125,7 @@ void LLWorldMipmap::dropBoostLevels()
         {
             LLPointer<LLViewerFetchedTexture> img = iter->second;
             img->setBoostLevel(LLGLTexture::BOOST_NONE);
+            setTilePriority(img, -1.f);
         }
     }
 }
@@ -178,6 +188,20 @@ LLPointer<LLViewerFetchedTexture> LLWorldMipmap::getObjectsTile(U32 grid_x, U32
     }
 }
 
+//static
+void LLWorldMipmap::setTilePriority(LLViewerFetchedTexture* tile, F32 distance_to_center)
+{
+    // The fetch priority of a texture is its virtual size, which setBoostLevel() maxes out
+    // for all map tiles alike
+    F32 priority = TILE_PRIORITY_OFF_VIEW;
+    if (distance_to_center >= 0.f)
+    {
+        priority = llmax(TILE_PRIORITY_IN_VIEW_MAX / (1.f + distance_to_center * distance_to_center), TILE_PRIORITY_IN_VIEW_MIN);
+    }
+    tile->resetTextureStats();
+    tile->addTextureStats(priority);
+}
+
 //static
 LLPointer<LLViewerFetchedTexture> LLWorldMipmap::loadObjectsTile(U32 grid_x, U32 grid_y, S32 level)
 {
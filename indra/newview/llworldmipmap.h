@@ -67,6 +67,8 @@ public:
     void    dropBoostLevels();
     // Get the tile smart pointer, does the loading if necessary
     LLPointer<LLViewerFetchedTexture> getObjectsTile(U32 grid_x, U32 grid_y, S32 level, bool load = true);
+    // Fetch the tiles closer to the center of the view first, distance is in tiles
+    static void setTilePriority(LLViewerFetchedTexture* tile, F32 distance_to_center);
 
     // Helper functions: those are here as they depend solely on the topology of the mipmap though they don't access it
     // Convert sim scale (given in sim width in display pixels) into a mipmap level
@@ -70,6 +70,9 @@
 #include "llhudtext.h"
 #include "lllightconstants.h"
 #include "llmeshrepository.h"
+#include "llvolumebuilder.h"
+#include "threadpool.h"
+#include "llperfstats.h"
 #include "llpipelinelistener.h"
 #include "llresmgr.h"
 #include "llselectmgr.h"
@@ -109,6 +112,7 @@
 #include "llfloaterpathfindingconsole.h"
 #include "llfloaterpathfindingcharacters.h"
 #include "llfloatertools.h"
+#include "llgpupasstimers.h"
 #include "llpanelface.h"
 #include "llpathfindingpathtool.h"
 #include "llscenemonitor.h"
@@ -204,6 +208,13 @@ F32 LLPipeline::CameraMaxCoF;
 F32 LLPipeline::CameraDoFResScale;
 F32 LLPipeline::RenderAutoHideSurfaceAreaLimit;
 bool LLPipeline::RenderScreenSpaceReflections;
+bool LLPipeline::RenderAlphaOIT;
+bool LLPipeline::RenderTemporalUpscale;
+F32 LLPipeline::RenderTemporalUpscaleScale;
+U32 LLPipeline::RenderLightMapDivisor;
+bool LLPipeline::RenderAdaptiveLightMap;
+bool LLPipeline::RenderTerrainGPU;
+F32 LLPipeline::RenderReflectionMinCoverage;
 S32 LLPipeline::RenderScreenSpaceReflectionIterations;
 F32 LLPipeline::RenderScreenSpaceReflectionRayStep;
 F32 LLPipeline::RenderScreenSpaceReflectionDistanceBias;
@@ -222,6 +233,8 @@ const F32 BACKLIGHT_DAY_MAGNITUDE_OBJECT = 0.1f;
 const F32 BACKLIGHT_NIGHT_MAGNITUDE_OBJECT = 0.08f;
 const F32 ALPHA_BLEND_CUTOFF = 0.598f;
 const F32 DEFERRED_LIGHT_FALLOFF = 0.5f;
+// helpers for culling the spatial partitions, in addition to the main thread
+constexpr size_t CULL_THREADS = 3;
 const U32 DEFERRED_VB_MASK = LLVertexBuffer::MAP_VERTEX | LLVertexBuffer::MAP_TEXCOORD0 | LLVertexBuffer::MAP_TEXCOORD1;
 
 extern S32 gBoxFrame;
@@ -561,6 +574,13 @@ void LLPipeline::init()
     connectRefreshCachedSettingsSafe("CameraDoFResScale");
     connectRefreshCachedSettingsSafe("RenderAutoHideSurfaceAreaLimit");
     connectRefreshCachedSettingsSafe("RenderScreenSpaceReflections");
+    connectRefreshCachedSettingsSafe("RenderAlphaOIT");
+    connectRefreshCachedSettingsSafe("RenderTemporalUpscale");
+    connectRefreshCachedSettingsSafe("RenderTemporalUpscaleScale");
+    connectRefreshCachedSettingsSafe("RenderLightMapDivisor");
+    connectRefreshCachedSettingsSafe("RenderAdaptiveLightMap");
+    connectRefreshCachedSettingsSafe("RenderTerrainGPU");
+    connectRefreshCachedSettingsSafe("RenderReflectionMinCoverage");
     connectRefreshCachedSettingsSafe("RenderScreenSpaceReflectionIterations");
     connectRefreshCachedSettingsSafe("RenderScreenSpaceReflectionRayStep");
     connectRefreshCachedSettingsSafe("RenderScreenSpaceReflectionDistanceBias");
@@ -582,6 +602,14 @@ void LLPipeline::init()
             LLFontVertexBuffer::enableBufferCollection(control->getValue().asBoolean());
         });
     }
+
+    // the main thread culls too, "ThreadPoolSizes" may override the width
+    size_t cull_threads = LL::ThreadPool::getConfiguredWidth("Cull", CULL_THREADS);
+    if (cull_threads > 0)
+    {
+        mCullPool.reset(new LL::ThreadPool("Cull", cull_threads));
+        mCullPool->start();
+    }
 }
 
 LLPipeline::~LLPipeline()
@@ -592,6 +620,12 @@ void LLPipeline::cleanup()
 {
     assertInitialized();
 
+    if (mCullPool)
+    {
+        mCullPool->close();
+        mCullPool.reset();
+    }
+
     mGroupQ1.clear() ;
 
     for(pool_set_t::iterator iter = mPools.begin();
@@ -684,6 +718,8 @@ void LLPipeline::destroyGL()
         glDeleteQueries(1, &mMeshDirtyQueryObject);
         mMeshDirtyQueryObject = 0;
     }
+
+    gGPUPassTimers.cleanup();
 }
 
 void LLPipeline::requestResizeScreenTexture()
@@ -815,6 +851,13 @@ bool LLPipeline::allocateScreenBufferInternal(U32 resX, U32 resY)
         resY /= res_mod;
     }
 
+    if (RenderTemporalUpscale && !gCubeSnapshot)
+    { // applyTemporalUpscale reconstructs the display resolution from jittered frames
+        F32 scale = llclamp(RenderTemporalUpscaleScale, 0.5f, 1.f);
+        resX = llmax((U32)(resX * scale), 1U);
+        resY = llmax((U32)(resY * scale), 1U);
+    }
+
     S32 shadow_detail = RenderShadowDetail;
     bool ssao = RenderDeferredSSAO;
 
@@ -847,20 +890,8 @@ bool LLPipeline::allocateScreenBufferInternal(U32 resX, U32 resY)
             {
                 return false;
             }
-        }
-
-        if (RenderFSAAType > 0)
-        {
-            if (!mFXAAMap.allocate(resX, resY, GL_RGBA)) return false;
-            if (RenderFSAAType == 2)
-            {
-                if (!mSMAABlendBuffer.allocate(resX, resY, GL_RGBA, false)) return false;
-            }
-        }
-        else
-        {
-            mFXAAMap.release();
-            mSMAABlendBuffer.release();
+            // nothing retained in it yet
+            LLView::dirtyScreenRect(gViewerWindow->getWindowRectScaled());
         }
 
         //water reflection texture (always needed as scratch space whether or not transparent water is enabled)
@@ -875,7 +906,34 @@ bool LLPipeline::allocateScreenBufferInternal(U32 resX, U32 resY)
             mSceneMap.release();
         }
 
-        mPostMap.allocate(resX, resY, GL_RGBA16F);
+        // post processing scratch targets are sized on demand by mPostGraph,
+        // drop the ones sized for the old screen
+        gRenderTargetPool.releaseIdle();
+
+        if (RenderAlphaOIT)
+        { // weighted blended transparency accumulation, tested against the scene depth
+            if (!mOITMap.allocate(resX, resY, GL_RGBA16F)) return false;
+            if (!mOITMap.addColorAttachment(GL_R16F)) return false;
+            mRT->deferredScreen.shareDepthBuffer(mOITMap);
+        }
+        else
+        {
+            mOITMap.release();
+        }
+
+        if (RenderTemporalUpscale)
+        {
+            for (U32 i = 0; i < 2; ++i)
+            {
+                if (!mUpscaleHistory[i].allocate(mRT->width, mRT->height, GL_RGBA)) return false;
+            }
+        }
+        else
+        {
+            mUpscaleHistory[0].release();
+            mUpscaleHistory[1].release();
+        }
+        mUpscaleHistoryValid = false;
 
         // used to scale down textures
         // See LLViwerTextureList::updateImagesCreateTextures and LLImageGL::scaleDown
@@ -908,6 +966,11 @@ bool LLPipeline::allocateShadowBuffer(U32 resX, U32 resY)
     U32 sun_shadow_map_width = BlurHappySize(resX, scale);
     U32 sun_shadow_map_height = BlurHappySize(resY, scale);
 
+    if (!gCubeSnapshot)
+    {
+        invalidateShadowCache();
+    }
+
     if (shadow_detail > 0)
     { //allocate 4 sun shadow maps
         for (U32 i = 0; i < 4; i++)
@@ -1075,6 +1138,13 @@ void LLPipeline::refreshCachedSettings()
     CameraDoFResScale = gSavedSettings.getF32("CameraDoFResScale");
     RenderAutoHideSurfaceAreaLimit = gSavedSettings.getF32("RenderAutoHideSurfaceAreaLimit");
     RenderScreenSpaceReflections = gSavedSettings.getBOOL("RenderScreenSpaceReflections");
+    RenderAlphaOIT = gSavedSettings.getBOOL("RenderAlphaOIT");
+    RenderTemporalUpscale = gSavedSettings.getBOOL("RenderTemporalUpscale");
+    RenderTemporalUpscaleScale = gSavedSettings.getF32("RenderTemporalUpscaleScale");
+    RenderLightMapDivisor = gSavedSettings.getU32("RenderLightMapDivisor");
+    RenderAdaptiveLightMap = gSavedSettings.getBOOL("RenderAdaptiveLightMap");
+    RenderTerrainGPU = gSavedSettings.getBOOL("RenderTerrainGPU");
+    RenderReflectionMinCoverage = gSavedSettings.getF32("RenderReflectionMinCoverage");
     RenderScreenSpaceReflectionIterations = gSavedSettings.getS32("RenderScreenSpaceReflectionIterations");
     RenderScreenSpaceReflectionRayStep = gSavedSettings.getF32("RenderScreenSpaceReflectionRayStep");
     RenderScreenSpaceReflectionDistanceBias = gSavedSettings.getF32("RenderScreenSpaceReflectionDistanceBias");
@@ -1133,9 +1203,22 @@ void LLPipeline::releaseGLBuffers()
 
     mSceneMap.release();
 
-    mPostMap.release();
+    mOITMap.release();
 
-    mFXAAMap.release();
+    mUpscaleHistory[0].release();
+    mUpscaleHistory[1].release();
+    mUpscaleHistoryValid = false;
+
+    mLightMapLow.release();
+
+    gRenderTargetPool.releaseIdle();
+
+    mLightClusters.release();
+
+    mTerrainGPU.release();
+
+    mSkinPalettes.release();
+    LLDrawPoolTree::releaseInstanceBuffers();
 
     mUIScreen.release();
 
@@ -1197,6 +1280,10 @@ void LLPipeline::releaseSunShadowTarget(U32 index)
 {
     llassert(index < 4);
     mRT->shadow[index].release();
+    if (!gCubeSnapshot)
+    {
+        mSunShadowCache[index].mValid = false;
+    }
 }
 
 void LLPipeline::releaseSunShadowTargets()
@@ -1755,6 +1842,8 @@ void LLPipeline::unlinkDrawable(LLDrawable *drawable)
 
     LLPointer<LLDrawable> drawablep = drawable; // make sure this doesn't get deleted before we are done
 
+    noteShadowCasterChange(drawablep);
+
     // Based on flags, remove the drawable from the queues that it's on.
     if (drawablep->isState(LLDrawable::ON_MOVE_LIST))
     {
@@ -1845,15 +1934,25 @@ void LLPipeline::createObjects(F32 max_dtime)
     LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
 
     LLTimer update_timer;
+    LLWorld* world = LLWorld::getInstance();
+    const LLVector3& camera_origin = LLViewerCamera::getInstance()->getOrigin();
 
-    while (!mCreateQ.empty() && update_timer.getElapsedTimeF32() < max_dtime)
+    LLViewerObject::vobj_list_t::iterator iter = mCreateQ.begin();
+    while (iter != mCreateQ.end() && update_timer.getElapsedTimeF32() < max_dtime)
     {
-        LLViewerObject* vobj = mCreateQ.front();
+        LLViewerObject* vobj = *iter;
         if (!vobj->isDead())
         {
+            // a linkset shares its root's ring, so parents still get created before their children
+            LLViewerObject* root = vobj->getRootEdit();
+            if (!root->isAvatar() && !world->claimStreamingCreate(dist_vec(root->getPositionAgent(), camera_origin)))
+            { // a nearer ring is still loading
+                ++iter;
+                continue;
+            }
             createObject(vobj);
         }
-        mCreateQ.pop_front();
+        iter = mCreateQ.erase(iter);
     }
 
     //for (LLViewerObject::vobj_list_t::iterator iter = mCreateQ.begin(); iter != mCreateQ.end(); ++iter)
@@ -2410,6 +2509,14 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result)
 
         camera.setUserClipPlane(plane);
     }
+    else if (mHeroProbeManager.isMirrorPass())
+    {
+        // the shaders discard everything behind the mirror (see mirrorClip), cull it here as well
+        LLPlane plane;
+        plane.setVec(mHeroProbeManager.mMirrorPosition, -mHeroProbeManager.mMirrorNormal);
+
+        camera.setUserClipPlane(plane);
+    }
     else
     {
         camera.disableUserClipPlane();
@@ -2419,6 +2526,32 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result)
 
     sCull->clear();
 
+    // Without occlusion culling the octree walks don't touch group state,
+    // so the partitions are culled in parallel and their visible groups
+    // marked here in the order a serial cull would have marked them.
+    static LLCachedControl<bool> parallel_cull(gSavedSettings, "RenderParallelCull", true);
+    std::vector<LLSpatialPartition*> parts;
+    std::vector<std::vector<LLSpatialGroup*> > visible;
+    size_t part_index = 0;
+    if (parallel_cull && mCullPool && sUseOcclusion < 2)
+    {
+        for (LLViewerRegion* region : LLWorld::getInstance()->getRegionList())
+        {
+            for (U32 i = 0; i < LLViewerRegion::NUM_PARTITIONS; i++)
+            {
+                LLSpatialPartition* part = region->getSpatialPartition(i);
+                if (part && hasRenderType(part->mDrawableType))
+                {
+                    part->prepareCull();
+                    parts.push_back(part);
+                }
+            }
+        }
+
+        visible.resize(parts.size());
+        cullPartitions(camera, parts, visible);
+    }
+
     for (LLWorld::region_list_t::const_iterator iter = LLWorld::getInstance()->getRegionList().begin();
             iter != LLWorld::getInstance()->getRegionList().end(); ++iter)
     {
@@ -2431,7 +2564,18 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result)
             {
                 if (hasRenderType(part->mDrawableType))
                 {
-                    part->cull(camera);
+                    if (part_index < parts.size() && parts[part_index] == part)
+                    {
+                        for (LLSpatialGroup* group : visible[part_index])
+                        {
+                            markNotCulled(group, camera);
+                        }
+                        ++part_index;
+                    }
+                    else
+                    {
+                        part->cull(camera);
+                    }
                 }
             }
         }
@@ -2464,6 +2608,50 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result)
     }
 }
 
+void LLPipeline::cullPartitions(LLCamera& camera, const std::vector<LLSpatialPartition*>& parts,
+                                std::vector<std::vector<LLSpatialGroup*> >& visible)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
+
+    // Shared with the pool, a job that comes late must not touch this frame
+    struct CullJobs
+    {
+        std::atomic<size_t> mNext{ 0 };
+        std::atomic<size_t> mDone{ 0 };
+        size_t              mCount;
+    };
+    std::shared_ptr<CullJobs> jobs = std::make_shared<CullJobs>();
+    jobs->mCount = parts.size();
+
+    LLCamera* camerap = &camera;
+    LLSpatialPartition* const* partsp = parts.data();
+    std::vector<LLSpatialGroup*>* visiblep = visible.data();
+    auto work = [jobs, camerap, partsp, visiblep]()
+    {
+        size_t i;
+        while ((i = jobs->mNext++) < jobs->mCount)
+        {
+            partsp[i]->cullGroups(*camerap, visiblep[i]);
+            jobs->mDone++;
+        }
+    };
+
+    size_t helpers = llmin(mCullPool->getWidth(), parts.size() > 0 ? parts.size() - 1 : 0);
+    for (size_t i = 0; i < helpers; ++i)
+    {
+        if (!mCullPool->getQueue().post(work))
+        {
+            break;
+        }
+    }
+
+    work();
+    while (jobs->mDone < jobs->mCount)
+    {
+        std::this_thread::yield();
+    }
+}
+
 void LLPipeline::markNotCulled(LLSpatialGroup* group, LLCamera& camera)
 {
     if (group->isEmpty())
@@ -2721,6 +2909,7 @@ void LLPipeline::rebuildPriorityGroups()
     assertInitialized();
 
     gMeshRepo.notifyLoadedMeshes();
+    gVolumeBuilder.update();
 
     mGroupQ1Locked = true;
     // Iterate through all drawables on the priority build queue,
@@ -2826,6 +3015,32 @@ void LLPipeline::markVisible(LLDrawable *drawablep, LLCamera& camera)
     }
 }
 
+// Particles, water and HUD objects are not rendered into sun shadow maps
+static bool casts_sun_shadow(U32 partition_type)
+{
+    switch (partition_type)
+    {
+    case LLViewerRegion::PARTITION_HUD:
+    case LLViewerRegion::PARTITION_VOIDWATER:
+    case LLViewerRegion::PARTITION_WATER:
+    case LLViewerRegion::PARTITION_PARTICLE:
+    case LLViewerRegion::PARTITION_HUD_PARTICLE:
+    case LLViewerRegion::PARTITION_NONE:
+        return false;
+    default:
+        return true;
+    }
+}
+
+void LLPipeline::noteShadowCasterChange(LLDrawable* drawablep)
+{
+    LLViewerObject* vobj = drawablep->getVObj();
+    if (!vobj || casts_sun_shadow(vobj->getPartitionType()))
+    {
+        ++mShadowCacheEpoch;
+    }
+}
+
 void LLPipeline::markMoved(LLDrawable *drawablep, bool damped_motion)
 {
     if (!drawablep)
@@ -2840,6 +3055,8 @@ void LLPipeline::markMoved(LLDrawable *drawablep, bool damped_motion)
         return;
     }
 
+    noteShadowCasterChange(drawablep);
+
     if (drawablep->getParent())
     {
         //ensure that parent drawables are moved first
@@ -2942,6 +3159,7 @@ void LLPipeline::markTextured(LLDrawable *drawablep)
     if (drawablep && !drawablep->isDead() && assertInitialized())
     {
         mRetexturedList.insert(drawablep);
+        noteShadowCasterChange(drawablep);
     }
 }
 
@@ -2990,6 +3208,11 @@ void LLPipeline::markRebuild(LLSpatialGroup* group)
 {
     if (group && !group->isDead() && group->getSpatialPartition())
     {
+        if (casts_sun_shadow(group->getSpatialPartition()->mPartitionType))
+        {
+            ++mShadowCacheEpoch;
+        }
+
         if (!group->hasState(LLSpatialGroup::IN_BUILD_Q1))
         {
             llassert_always(!mGroupQ1Locked);
@@ -3004,6 +3227,8 @@ void LLPipeline::markRebuild(LLDrawable *drawablep, LLDrawable::EDrawableFlags f
 {
     if (drawablep && !drawablep->isDead() && assertInitialized())
     {
+        noteShadowCasterChange(drawablep);
+
         if (!drawablep->isState(LLDrawable::IN_REBUILD_Q))
         {
             mBuildQ1.push_back(drawablep);
@@ -3468,6 +3693,81 @@ void renderSoundHighlights(LLDrawable *drawablep)
     }
 }
 
+// Orders alpha groups far to near by binning their depths instead of comparing them.
+// Buckets get finer towards the camera, where misordering is most visible; groups that
+// share a bucket keep the order they were culled in.
+static void bucket_sort_alpha_groups(LLCullResult::sg_iterator begin, LLCullResult::sg_iterator end, U32 bucket_count)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
+
+    size_t count = end - begin;
+    if (count < 2)
+    {
+        return;
+    }
+
+    F32 min_depth = F32_MAX;
+    F32 max_depth = -F32_MAX;
+    for (LLCullResult::sg_iterator i = begin; i != end; ++i)
+    {
+        min_depth = llmin(min_depth, (*i)->mDepth);
+        max_depth = llmax(max_depth, (*i)->mDepth);
+    }
+
+    if (max_depth <= min_depth)
+    {
+        return;
+    }
+
+    F32 inv_range = 1.f / (max_depth - min_depth);
+    auto get_bucket = [&](const LLSpatialGroup* group)
+    { // bucket 0 is the farthest
+        F32 t = sqrtf((group->mDepth - min_depth) * inv_range);
+        return bucket_count - 1 - llmin((U32)(t * (bucket_count - 1)), bucket_count - 1);
+    };
+
+    static std::vector<U32> starts;
+    static std::vector<LLSpatialGroup*> sorted;
+    starts.assign(bucket_count + 1, 0);
+    sorted.resize(count);
+
+    for (LLCullResult::sg_iterator i = begin; i != end; ++i)
+    {
+        starts[get_bucket(*i) + 1]++;
+    }
+
+    for (U32 b = 1; b <= bucket_count; ++b)
+    {
+        starts[b] += starts[b - 1];
+    }
+
+    for (LLCullResult::sg_iterator i = begin; i != end; ++i)
+    {
+        sorted[starts[get_bucket(*i)]++] = *i;
+    }
+
+    std::copy(sorted.begin(), sorted.end(), begin);
+}
+
+// distance from 'origin' (agent space) to the center of 'group'
+static F32 group_distance(LLSpatialGroup* group, const LLVector4a& origin)
+{
+    LLVector4a center;
+    LLSpatialBridge* bridge = group->getSpatialPartition()->asBridge();
+    if (bridge)
+    { // bound by the bridge's local frame
+        center.load3(bridge->getPositionAgent().mV);
+    }
+    else
+    {
+        center = group->getObjectBounds()[0];
+    }
+
+    LLVector4a delta;
+    delta.setSub(center, origin);
+    return delta.getLength3().getF32();
+}
+
 void LLPipeline::postSort(LLCamera &camera)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
@@ -3477,6 +3777,9 @@ void LLPipeline::postSort(LLCamera &camera)
     if (!gCubeSnapshot)
     {
         // rebuild drawable geometry
+        LLWorld* world = LLWorld::getInstance();
+        LLVector4a camera_origin;
+        camera_origin.load3(camera.getOrigin().mV);
         for (LLCullResult::sg_iterator i = sCull->beginDrawableGroups(); i != sCull->endDrawableGroups(); ++i)
         {
             LLSpatialGroup *group = *i;
@@ -3484,7 +3787,8 @@ void LLPipeline::postSort(LLCamera &camera)
             {
                 continue;
             }
-            if (!sUseOcclusion || !group->isOcclusionState(LLSpatialGroup::OCCLUDED))
+            if ((!sUseOcclusion || !group->isOcclusionState(LLSpatialGroup::OCCLUDED)) &&
+                (!group->hasState(LLSpatialGroup::GEOM_DIRTY) || world->claimStreamingRebuild(group_distance(group, camera_origin))))
             {
                 group->rebuildGeom();
             }
@@ -3609,7 +3913,15 @@ void LLPipeline::postSort(LLCamera &camera)
     if (!sShadowRender)
     {
         // order alpha groups by distance
-        std::sort(sCull->beginAlphaGroups(), sCull->endAlphaGroups(), LLSpatialGroup::CompareDepthGreater());
+        static LLCachedControl<U32> alpha_sort_buckets(gSavedSettings, "RenderAlphaSortBuckets", 1024);
+        if (alpha_sort_buckets > 1)
+        {
+            bucket_sort_alpha_groups(sCull->beginAlphaGroups(), sCull->endAlphaGroups(), alpha_sort_buckets);
+        }
+        else
+        {
+            std::sort(sCull->beginAlphaGroups(), sCull->endAlphaGroups(), LLSpatialGroup::CompareDepthGreater());
+        }
 
         // order rigged alpha groups by avatar attachment order
         std::sort(sCull->beginRiggedAlphaGroups(), sCull->endRiggedAlphaGroups(), LLSpatialGroup::CompareRenderOrder());
@@ -7267,10 +7579,16 @@ void LLPipeline::generateGlow(LLRenderTarget* src)
     }
 }
 
+static bool cas_enabled()
+{
+    static LLCachedControl<F32> cas_sharpness(gSavedSettings, "RenderCASSharpness", 0.4f);
+    return cas_sharpness != 0.0f && gCASProgram.isComplete();
+}
+
 void LLPipeline::applyCAS(LLRenderTarget* src, LLRenderTarget* dst)
 {
     static LLCachedControl<F32> cas_sharpness(gSavedSettings, "RenderCASSharpness", 0.4f);
-    if (cas_sharpness == 0.0f || !gCASProgram.isComplete())
+    if (!cas_enabled())
     {
         gPipeline.copyRenderTarget(src, dst);
         return;
@@ -7312,11 +7630,11 @@ void LLPipeline::applyCAS(LLRenderTarget* src, LLRenderTarget* dst)
     dst->flush();
 }
 
-void LLPipeline::applyFXAA(LLRenderTarget* src, LLRenderTarget* dst)
+void LLPipeline::applyFXAA(LLRenderTarget* src, LLRenderTarget* dst, LLRenderTarget* scratch)
 {
     {
         llassert(!gCubeSnapshot);
-        bool multisample = RenderFSAAType == 1 && mFXAAMap.isComplete();
+        bool multisample = RenderFSAAType == 1 && scratch && scratch->isComplete();
         LLGLSLShader* shader = &gGlowCombineProgram;
 
         // Present everything.
@@ -7327,8 +7645,8 @@ void LLPipeline::applyFXAA(LLRenderTarget* src, LLRenderTarget* dst)
             S32 height = dst->getHeight();
 
             // bake out texture2D with RGBL for FXAA shader
-            mFXAAMap.bindTarget();
-            mFXAAMap.invalidate(GL_COLOR_BUFFER_BIT);
+            scratch->bindTarget();
+            scratch->invalidate(GL_COLOR_BUFFER_BIT);
 
             shader = &gGlowCombineFXAAProgram;
             shader->bind();
@@ -7348,7 +7666,7 @@ void LLPipeline::applyFXAA(LLRenderTarget* src, LLRenderTarget* dst)
             shader->disableTexture(LLShaderMgr::DEFERRED_DIFFUSE, src->getUsage());
             shader->unbind();
 
-            mFXAAMap.flush();
+            scratch->flush();
 
             dst->bindTarget();
 
@@ -7358,10 +7676,10 @@ void LLPipeline::applyFXAA(LLRenderTarget* src, LLRenderTarget* dst)
             shader = &gFXAAProgram[fsaa_quality];
             shader->bind();
 
-            channel = shader->enableTexture(LLShaderMgr::DIFFUSE_MAP, mFXAAMap.getUsage());
+            channel = shader->enableTexture(LLShaderMgr::DIFFUSE_MAP, scratch->getUsage());
             if (channel > -1)
             {
-                mFXAAMap.bindTexture(0, channel, LLTexUnit::TFO_BILINEAR);
+                scratch->bindTexture(0, channel, LLTexUnit::TFO_BILINEAR);
             }
 
             gGLViewport[0] = gViewerWindow->getWorldViewRectRaw().mLeft;
@@ -7371,8 +7689,8 @@ void LLPipeline::applyFXAA(LLRenderTarget* src, LLRenderTarget* dst)
 
             glViewport(gGLViewport[0], gGLViewport[1], gGLViewport[2], gGLViewport[3]);
 
-            F32 scale_x = (F32)width / mFXAAMap.getWidth();
-            F32 scale_y = (F32)height / mFXAAMap.getHeight();
+            F32 scale_x = (F32)width / scratch->getWidth();
+            F32 scale_y = (F32)height / scratch->getHeight();
             shader->uniform2f(LLShaderMgr::FXAA_TC_SCALE, scale_x, scale_y);
             shader->uniform2f(LLShaderMgr::FXAA_RCP_SCREEN_RES, 1.f / width * scale_x, 1.f / height * scale_y);
             shader->uniform4f(LLShaderMgr::FXAA_RCP_FRAME_OPT, -0.5f / width * scale_x, -0.5f / height * scale_y,
@@ -7398,10 +7716,10 @@ void LLPipeline::applyFXAA(LLRenderTarget* src, LLRenderTarget* dst)
     }
 }
 
-void LLPipeline::generateSMAABuffers(LLRenderTarget* src)
+void LLPipeline::generateSMAABuffers(LLRenderTarget* src, LLRenderTarget* edges, LLRenderTarget* blend)
 {
     llassert(!gCubeSnapshot);
-    bool multisample = RenderFSAAType == 2 && mFXAAMap.isComplete() && mSMAABlendBuffer.isComplete();
+    bool multisample = RenderFSAAType == 2 && edges && edges->isComplete() && blend && blend->isComplete();
 
     // Present everything.
     if (multisample)
@@ -7423,7 +7741,7 @@ void LLPipeline::generateSMAABuffers(LLRenderTarget* src)
             //LLGLState stencil(GL_STENCIL_TEST, use_stencil);
 
             // Bind setup:
-            LLRenderTarget& dest = mFXAAMap;
+            LLRenderTarget& dest = *edges;
             LLGLSLShader& edge_shader = gSMAAEdgeDetectProgram[fsaa_quality];
 
             dest.bindTarget();
@@ -7467,7 +7785,7 @@ void LLPipeline::generateSMAABuffers(LLRenderTarget* src)
             //LLGLState stencil(GL_STENCIL_TEST, use_stencil);
 
             // Bind setup:
-            LLRenderTarget& dest = mSMAABlendBuffer;
+            LLRenderTarget& dest = *blend;
             LLGLSLShader& blend_weights_shader = gSMAABlendWeightsProgram[fsaa_quality];
 
             dest.bindTarget();
@@ -7476,10 +7794,10 @@ void LLPipeline::generateSMAABuffers(LLRenderTarget* src)
             blend_weights_shader.bind();
             blend_weights_shader.uniform4fv(sSmaaRTMetrics, 1, rt_metrics);
 
-            S32 edge_tex_channel = blend_weights_shader.enableTexture(LLShaderMgr::SMAA_EDGE_TEX, mFXAAMap.getUsage());
+            S32 edge_tex_channel = blend_weights_shader.enableTexture(LLShaderMgr::SMAA_EDGE_TEX, edges->getUsage());
             if (edge_tex_channel > -1)
             {
-                mFXAAMap.bindTexture(0, edge_tex_channel, LLTexUnit::TFO_BILINEAR);
+                edges->bindTexture(0, edge_tex_channel, LLTexUnit::TFO_BILINEAR);
                 gGL.getTexUnit(edge_tex_channel)->setTextureAddressMode(LLTexUnit::TAM_CLAMP);
             }
             S32 area_tex_channel = blend_weights_shader.enableTexture(LLShaderMgr::SMAA_AREA_TEX, LLTexUnit::TT_TEXTURE);
@@ -7517,10 +7835,10 @@ void LLPipeline::generateSMAABuffers(LLRenderTarget* src)
     }
 }
 
-void LLPipeline::applySMAA(LLRenderTarget* src, LLRenderTarget* dst)
+void LLPipeline::applySMAA(LLRenderTarget* src, LLRenderTarget* dst, LLRenderTarget* blend)
 {
     llassert(!gCubeSnapshot);
-    bool multisample = RenderFSAAType == 2 && mFXAAMap.isComplete() && mSMAABlendBuffer.isComplete();
+    bool multisample = RenderFSAAType == 2 && blend && blend->isComplete();
 
     // Present everything.
     if (multisample)
@@ -7562,7 +7880,7 @@ void LLPipeline::applySMAA(LLRenderTarget* src, LLRenderTarget* dst)
             S32 blend_channel = blend_shader.enableTexture(LLShaderMgr::SMAA_BLEND_TEX);
             if (blend_channel > -1)
             {
-                mSMAABlendBuffer.bindTexture(0, blend_channel, LLTexUnit::TFO_BILINEAR);
+                blend->bindTexture(0, blend_channel, LLTexUnit::TFO_BILINEAR);
             }
 
             mScreenTriangleVB->setBuffer();
@@ -7621,13 +7939,115 @@ void LLPipeline::combineGlow(LLRenderTarget* src, LLRenderTarget* dst)
     dst->flush();
 }
 
+static bool dof_enabled()
+{
+    return (LLPipeline::RenderDepthOfFieldInEditMode || !LLToolMgr::getInstance()->inBuildMode()) &&
+        LLPipeline::RenderDepthOfField &&
+        !gCubeSnapshot;
+}
+
+// radical inverse of 'index' in 'base', a low discrepancy sequence in [0, 1)
+static F32 halton(U32 index, U32 base)
+{
+    F32 result = 0.f;
+    F32 f = 1.f;
+    while (index > 0)
+    {
+        f /= (F32)base;
+        result += f * (F32)(index % base);
+        index /= base;
+    }
+    return result;
+}
+
+// jitter positions cycled through by the temporal upscaler, enough to cover a 2x upscale a few times over
+constexpr U32 UPSCALE_JITTER_PHASES = 16;
+
+// how many frames of history an output pixel is worth against a texel landing right on it
+constexpr F32 UPSCALE_HISTORY_WEIGHT = 8.f;
+
+void LLPipeline::jitterProjection()
+{
+    mUpscaleLastJitterNDC = mUpscaleJitterNDC;
+    mUpscaleJittered = false;
+
+    if (!RenderTemporalUpscale || gCubeSnapshot || !mUpscaleHistory[0].isComplete() || !gTemporalUpscaleProgram.isComplete())
+    {
+        mUpscaleJitterNDC.clear();
+        mUpscaleHistoryValid = false;
+        return;
+    }
+
+    F32 width = (F32)mRT->screen.getWidth();
+    F32 height = (F32)mRT->screen.getHeight();
+
+    mUpscaleJitterIndex = (mUpscaleJitterIndex + 1) % UPSCALE_JITTER_PHASES;
+    mUpscaleJitter.set(halton(mUpscaleJitterIndex + 1, 2) - 0.5f, halton(mUpscaleJitterIndex + 1, 3) - 0.5f);
+    mUpscaleJitterNDC.set(mUpscaleJitter.mV[VX] * 2.f / width, mUpscaleJitter.mV[VY] * 2.f / height);
+
+    mUnjitteredProjection = get_current_projection();
+    glm::mat4 jittered = glm::translate(glm::identity<glm::mat4>(), glm::vec3(mUpscaleJitterNDC.mV[VX], mUpscaleJitterNDC.mV[VY], 0.f)) * mUnjitteredProjection;
+
+    // last frame's matrices are replaced at the end of renderDeferredLighting, they're still the old ones here
+    mUpscaleReprojection = get_last_projection() * get_last_modelview() * glm::inverse(get_current_modelview()) * glm::inverse(jittered);
+
+    set_current_projection(jittered);
+    gGL.matrixMode(LLRender::MM_PROJECTION);
+    gGL.loadMatrix(glm::value_ptr(jittered));
+    gGL.matrixMode(LLRender::MM_MODELVIEW);
+
+    mUpscaleJittered = true;
+}
+
+void LLPipeline::unjitterProjection()
+{
+    if (mUpscaleJittered)
+    {
+        set_current_projection(mUnjitteredProjection);
+        gGL.matrixMode(LLRender::MM_PROJECTION);
+        gGL.loadMatrix(glm::value_ptr(mUnjitteredProjection));
+        gGL.matrixMode(LLRender::MM_MODELVIEW);
+    }
+}
+
+void LLPipeline::applyTemporalUpscale(LLRenderTarget* src, LLRenderTarget* dst, LLRenderTarget* history)
+{
+    LL_PROFILE_GPU_ZONE("temporal upscale");
+
+    static LLStaticHashedString reproj_mat("reproj_mat");
+    static LLStaticHashedString render_res("render_res");
+    static LLStaticHashedString jitter("jitter");
+    static LLStaticHashedString last_jitter("last_jitter");
+    static LLStaticHashedString history_weight("history_weight");
+
+    LLGLSLShader& shader = gTemporalUpscaleProgram;
+
+    dst->bindTarget();
+    shader.bind();
+
+    shader.bindTexture(LLShaderMgr::DEFERRED_DIFFUSE, src, false, LLTexUnit::TFO_BILINEAR);
+    shader.bindTexture(LLShaderMgr::DEFERRED_DEPTH, &mRT->deferredScreen, true);
+    shader.bindTexture(LLShaderMgr::SCENE_MAP, history, false, LLTexUnit::TFO_BILINEAR);
+
+    shader.uniformMatrix4fv(reproj_mat, 1, GL_FALSE, glm::value_ptr(mUpscaleReprojection));
+    shader.uniform2f(render_res, (GLfloat)src->getWidth(), (GLfloat)src->getHeight());
+    shader.uniform2f(jitter, mUpscaleJitter.mV[VX], mUpscaleJitter.mV[VY]);
+    shader.uniform2f(last_jitter, mUpscaleLastJitterNDC.mV[VX], mUpscaleLastJitterNDC.mV[VY]);
+    shader.uniform1f(history_weight, mUpscaleHistoryValid ? UPSCALE_HISTORY_WEIGHT : 0.f);
+
+    mScreenTriangleVB->setBuffer();
+    mScreenTriangleVB->drawArrays(LLRender::TRIANGLES, 0, 3);
+
+    shader.unbind();
+    dst->flush();
+
+    mUpscaleHistoryValid = true;
+}
+
 void LLPipeline::renderDoF(LLRenderTarget* src, LLRenderTarget* dst)
 {
     {
-        bool dof_enabled =
-            (RenderDepthOfFieldInEditMode || !LLToolMgr::getInstance()->inBuildMode()) &&
-            RenderDepthOfField &&
-            !gCubeSnapshot;
+        bool dof_enabled = ::dof_enabled();
 
         gViewerWindow->setup3DViewport();
 
@@ -7824,6 +8244,8 @@ void LLPipeline::renderFinalize()
     LL_RECORD_BLOCK_TIME(FTM_RENDER_BLOOM);
     LL_PROFILE_GPU_ZONE("renderFinalize");
 
+    gRenderTargetPool.reclaim();
+
     gGL.color4f(1, 1, 1, 1);
     LLGLDepthTest depth(GL_FALSE);
     LLGLDisable blend(GL_BLEND);
@@ -7834,94 +8256,187 @@ void LLPipeline::renderFinalize()
     gGL.setColorMask(true, true);
     glClearColor(0, 0, 0, 0);
 
-    copyScreenSpaceReflections(&mRT->screen, &mSceneMap);
+    // Declare the post chain. Passes that are turned off are left out instead of copying their input through,
+    // so the chain only ping-pongs between mRT->screen and "post" for the passes that run.
+    LLRenderGraph& graph = mPostGraph;
 
-    generateLuminance(&mRT->screen, &mLuminanceMap);
+    LLRenderGraph::TargetDesc hdr_desc;
+    hdr_desc.mWidth = mRT->screen.getWidth();
+    hdr_desc.mHeight = mRT->screen.getHeight();
+    hdr_desc.mColorFormat = GL_RGBA16F;
 
-    generateExposure(&mLuminanceMap, &mExposureMap);
+    LLRenderGraph::TargetDesc ldr_desc = hdr_desc;
+    ldr_desc.mColorFormat = GL_RGBA;
 
-    tonemap(&mRT->screen, &mPostMap);
+    // the water and haze passes are done with their copy of the scene, "post" can live in it
+    if (mWaterDis.getWidth() == hdr_desc.mWidth && mWaterDis.getHeight() == hdr_desc.mHeight)
+    {
+        LLRenderGraph::TargetDesc water_desc = hdr_desc;
+        water_desc.mDepth = true;
+        graph.donateTarget(&mWaterDis, water_desc);
+    }
 
-    applyCAS(&mPostMap, &mRT->screen);
+    S32 screen = graph.importTarget(&mRT->screen);
+    S32 post = graph.createTarget("post", hdr_desc);
+    S32 scene_map = graph.importTarget(&mSceneMap);
+    S32 luminance = graph.importTarget(&mLuminanceMap);
+    S32 exposure = graph.importTarget(&mExposureMap);
 
-    generateSMAABuffers(&mRT->screen);
+    S32 src = screen;
+    S32 dst = post;
 
-    gammaCorrect(&mRT->screen, &mPostMap);
+    // add a pass that reads src and writes dst, its output becomes the next pass's input
+    auto add_chain_pass = [&](const std::string& name, const std::vector<S32>& extra_reads, const std::function<void(LLRenderTarget*, LLRenderTarget*)>& func)
+    {
+        std::vector<S32> reads = extra_reads;
+        reads.push_back(src);
+        graph.addPass(name, reads, { dst }, [&graph, func, src, dst]() { func(graph.getTarget(src), graph.getTarget(dst)); });
+        std::swap(src, dst);
+    };
 
-    LLVertexBuffer::unbind();
+    auto setup_world_viewport = []()
+    {
+        gGLViewport[0] = gViewerWindow->getWorldViewRectRaw().mLeft;
+        gGLViewport[1] = gViewerWindow->getWorldViewRectRaw().mBottom;
+        gGLViewport[2] = gViewerWindow->getWorldViewRectRaw().getWidth();
+        gGLViewport[3] = gViewerWindow->getWorldViewRectRaw().getHeight();
+        glViewport(gGLViewport[0], gGLViewport[1], gGLViewport[2], gGLViewport[3]);
+    };
 
-    applySMAA(&mPostMap, &mRT->screen);
+    if (RenderScreenSpaceReflections)
+    {
+        graph.addPass("ssr copy", { src }, { scene_map }, [this, &graph, src, scene_map]() { copyScreenSpaceReflections(graph.getTarget(src), graph.getTarget(scene_map)); });
+    }
 
-    generateGlow(&mRT->screen);
+    graph.addPass("luminance", { src }, { luminance }, [this, &graph, src, luminance]() { generateLuminance(graph.getTarget(src), graph.getTarget(luminance)); });
+    graph.addPass("exposure", { luminance }, { exposure }, [this, &graph, luminance, exposure]() { generateExposure(graph.getTarget(luminance), graph.getTarget(exposure)); });
 
-    combineGlow(&mRT->screen, &mPostMap);
+    add_chain_pass("tonemap", {}, [this](LLRenderTarget* s, LLRenderTarget* d) { tonemap(s, d); });
 
-    gGLViewport[0] = gViewerWindow->getWorldViewRectRaw().mLeft;
-    gGLViewport[1] = gViewerWindow->getWorldViewRectRaw().mBottom;
-    gGLViewport[2] = gViewerWindow->getWorldViewRectRaw().getWidth();
-    gGLViewport[3] = gViewerWindow->getWorldViewRectRaw().getHeight();
-    glViewport(gGLViewport[0], gGLViewport[1], gGLViewport[2], gGLViewport[3]);
+    if (cas_enabled())
+    {
+        add_chain_pass("cas", {}, [this](LLRenderTarget* s, LLRenderTarget* d) { applyCAS(s, d); });
+    }
 
-    renderDoF(&mPostMap, &mRT->screen);
+    // edges are only needed while computing the blend weights
+    S32 fsaa_scratch = -1;
+    S32 smaa_blend = -1;
+    if (RenderFSAAType == 2)
+    {
+        fsaa_scratch = graph.createTarget("smaa edges", ldr_desc);
+        smaa_blend = graph.createTarget("smaa blend", ldr_desc);
+        graph.addPass("smaa buffers", { src }, { fsaa_scratch, smaa_blend }, [this, &graph, src, fsaa_scratch, smaa_blend]()
+            {
+                generateSMAABuffers(graph.getTarget(src), graph.getTarget(fsaa_scratch), graph.getTarget(smaa_blend));
+            });
+    }
 
-    LLRenderTarget* finalBuffer = &mRT->screen;
-    if (RenderFSAAType == 1)
+    add_chain_pass("gamma", {}, [this](LLRenderTarget* s, LLRenderTarget* d)
+        {
+            gammaCorrect(s, d);
+            LLVertexBuffer::unbind();
+        });
+
+    if (RenderFSAAType == 2)
     {
-        applyFXAA(&mRT->screen, &mPostMap);
-        finalBuffer = &mPostMap;
+        add_chain_pass("smaa", { smaa_blend }, [this, &graph, smaa_blend](LLRenderTarget* s, LLRenderTarget* d) { applySMAA(s, d, graph.getTarget(smaa_blend)); });
     }
 
-    if (RenderBufferVisualization > -1)
+    graph.addPass("glow", { src }, {}, [this, &graph, src]() { generateGlow(graph.getTarget(src)); });
+
+    add_chain_pass("combine glow", {}, [this](LLRenderTarget* s, LLRenderTarget* d) { combineGlow(s, d); });
+
+    if (dof_enabled())
     {
-        switch (RenderBufferVisualization)
-        {
-        case 0:
-        case 1:
-        case 2:
-        case 3:
-            visualizeBuffers(&mRT->deferredScreen, finalBuffer, RenderBufferVisualization);
-            break;
-        case 4:
-            visualizeBuffers(&mLuminanceMap, finalBuffer, 0);
-            break;
-        case 5:
-        {
-            if (RenderFSAAType > 0)
+        add_chain_pass("dof", {}, [this, setup_world_viewport](LLRenderTarget* s, LLRenderTarget* d)
             {
-                visualizeBuffers(&mFXAAMap, finalBuffer, 0);
-            }
-            break;
-        }
-        case 6:
+                setup_world_viewport();
+                renderDoF(s, d);
+            });
+    }
+
+    if (RenderFSAAType == 1)
+    {
+        fsaa_scratch = graph.createTarget("fxaa", ldr_desc);
+        add_chain_pass("fxaa", { fsaa_scratch }, [this, &graph, fsaa_scratch](LLRenderTarget* s, LLRenderTarget* d) { applyFXAA(s, d, graph.getTarget(fsaa_scratch)); });
+    }
+
+    if (mUpscaleJittered)
+    { // the scene was rendered jittered at render resolution, everything from here on is at display resolution
+        S32 history = graph.importTarget(&mUpscaleHistory[mUpscaleHistoryIndex]);
+        mUpscaleHistoryIndex = 1 - mUpscaleHistoryIndex;
+        S32 upscaled = graph.importTarget(&mUpscaleHistory[mUpscaleHistoryIndex]);
+
+        graph.addPass("temporal upscale", { src, history }, { upscaled }, [this, &graph, src, history, upscaled]()
+            {
+                applyTemporalUpscale(graph.getTarget(src), graph.getTarget(upscaled), graph.getTarget(history));
+            });
+        src = upscaled;
+        mUpscaleJittered = false;
+    }
+
+    // Present the final target.  Whatever is last in the above post processing chain should _always_ be rendered directly here.
+    // If not, expect problems.
+    std::vector<S32> present_reads = { src };
+    if (RenderBufferVisualization == 5 && fsaa_scratch != -1)
+    {
+        present_reads.push_back(fsaa_scratch);
+    }
+    else if (RenderBufferVisualization == 6 && smaa_blend != -1)
+    {
+        present_reads.push_back(smaa_blend);
+    }
+
+    graph.addPass("present", present_reads, {}, [this, &graph, src, fsaa_scratch, smaa_blend, setup_world_viewport]()
         {
-            if (RenderFSAAType == 2)
+            setup_world_viewport();
+
+            LLRenderTarget* finalBuffer = graph.getTarget(src);
+
+            switch (RenderBufferVisualization)
             {
-                visualizeBuffers(&mSMAABlendBuffer, finalBuffer, 0);
+            case 0:
+            case 1:
+            case 2:
+            case 3:
+                visualizeBuffers(&mRT->deferredScreen, finalBuffer, RenderBufferVisualization);
+                break;
+            case 4:
+                visualizeBuffers(&mLuminanceMap, finalBuffer, 0);
+                break;
+            case 5:
+                if (fsaa_scratch != -1)
+                {
+                    visualizeBuffers(graph.getTarget(fsaa_scratch), finalBuffer, 0);
+                }
+                break;
+            case 6:
+                if (smaa_blend != -1)
+                {
+                    visualizeBuffers(graph.getTarget(smaa_blend), finalBuffer, 0);
+                }
+                break;
+            default:
+                break;
             }
-            break;
-        }
-        default:
-            break;
-        }
-    }
 
-    // Present the screen target.
+            gDeferredPostNoDoFNoiseProgram.bind(); // Add noise as part of final render to screen pass to avoid damaging other post effects
 
-    gDeferredPostNoDoFNoiseProgram.bind(); // Add noise as part of final render to screen pass to avoid damaging other post effects
+            gDeferredPostNoDoFNoiseProgram.bindTexture(LLShaderMgr::DEFERRED_DIFFUSE, finalBuffer);
+            gDeferredPostNoDoFNoiseProgram.bindTexture(LLShaderMgr::DEFERRED_DEPTH, &mRT->deferredScreen, true);
 
-    // Whatever is last in the above post processing chain should _always_ be rendered directly here.  If not, expect problems.
-    gDeferredPostNoDoFNoiseProgram.bindTexture(LLShaderMgr::DEFERRED_DIFFUSE, finalBuffer);
-    gDeferredPostNoDoFNoiseProgram.bindTexture(LLShaderMgr::DEFERRED_DEPTH, &mRT->deferredScreen, true);
+            gDeferredPostNoDoFNoiseProgram.uniform2f(LLShaderMgr::DEFERRED_SCREEN_RES, (GLfloat)finalBuffer->getWidth(), (GLfloat)finalBuffer->getHeight());
 
-    gDeferredPostNoDoFNoiseProgram.uniform2f(LLShaderMgr::DEFERRED_SCREEN_RES, (GLfloat)finalBuffer->getWidth(), (GLfloat)finalBuffer->getHeight());
+            {
+                LLGLDepthTest depth_test(GL_TRUE, GL_TRUE, GL_ALWAYS);
+                mScreenTriangleVB->setBuffer();
+                mScreenTriangleVB->drawArrays(LLRender::TRIANGLES, 0, 3);
+            }
 
-    {
-        LLGLDepthTest depth_test(GL_TRUE, GL_TRUE, GL_ALWAYS);
-        mScreenTriangleVB->setBuffer();
-        mScreenTriangleVB->drawArrays(LLRender::TRIANGLES, 0, 3);
-    }
+            gDeferredPostNoDoFNoiseProgram.unbind();
+        });
 
-    gDeferredPostNoDoFNoiseProgram.unbind();
+    graph.execute();
 
     gGL.setSceneBlendType(LLRender::BT_ALPHA);
 
@@ -8186,6 +8701,74 @@ LLVector4 pow4fsrgb(LLVector4 v, F32 f)
     return v;
 }
 
+// frames to wait after changing the adaptive light map divisor before judging its effect
+constexpr U32 LIGHT_MAP_SETTLE_FRAMES = 60;
+
+U32 LLPipeline::updateLightMapDivisor()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
+
+    if (RenderAdaptiveLightMap && LLPerfStats::tunables.userTargetFPS > 0)
+    {
+        F32 target_time = 1.f / (F32)LLPerfStats::tunables.userTargetFPS;
+        mAdaptiveFrameTime = lerp(mAdaptiveFrameTime, (F32)gFrameIntervalSeconds.value(), 0.05f);
+
+        if (gFrameCount - mAdaptiveLightMapFrame > LIGHT_MAP_SETTLE_FRAMES)
+        {
+            // leave a gap between the two thresholds so the divisor doesn't flip back and forth
+            if (mAdaptiveFrameTime > target_time * 1.1f && mAdaptiveLightMapDivisor < MAX_LIGHT_MAP_DIVISOR)
+            {
+                mAdaptiveLightMapDivisor *= 2;
+                mAdaptiveLightMapFrame = gFrameCount;
+            }
+            else if (mAdaptiveFrameTime < target_time * 0.75f && mAdaptiveLightMapDivisor > 1)
+            {
+                mAdaptiveLightMapDivisor /= 2;
+                mAdaptiveLightMapFrame = gFrameCount;
+            }
+        }
+    }
+    else
+    {
+        mAdaptiveLightMapDivisor = 1;
+    }
+
+    U32 divisor = llclamp(llmax(RenderLightMapDivisor, mAdaptiveLightMapDivisor), 1U, MAX_LIGHT_MAP_DIVISOR);
+    if (divisor == 3)
+    { // round to a power of two
+        divisor = 4;
+    }
+
+    if (divisor == 1)
+    {
+        mLightMapLow.release();
+    }
+    else
+    {
+        U32 width = llmax(mRT->deferredLight.getWidth() / divisor, 1U);
+        U32 height = llmax(mRT->deferredLight.getHeight() / divisor, 1U);
+
+        if (!mLightMapLow.isComplete() || mLightMapLow.getWidth() != width || mLightMapLow.getHeight() != height)
+        {
+            mLightMapLow.release();
+            if (!mLightMapLow.allocate(width, height, GL_RGBA16F))
+            {
+                LL_WARNS_ONCE("Pipeline") << "Failed to allocate " << width << "x" << height << " light map, using full resolution" << LL_ENDL;
+                mLightMapLow.release();
+                divisor = 1;
+            }
+        }
+    }
+
+    if (divisor != mLightMapDivisor)
+    {
+        LL_DEBUGS("Pipeline") << "Light map divisor " << mLightMapDivisor << " -> " << divisor << LL_ENDL;
+        mLightMapDivisor = divisor;
+    }
+
+    return divisor;
+}
+
 void LLPipeline::renderDeferredLighting()
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
@@ -8236,21 +8819,28 @@ void LLPipeline::renderDeferredLighting()
         tc_moon = mat * tc_moon;
         mTransformedMoonDir.set(glm::value_ptr(tc_moon));
 
+        // the light map only gets rendered at reduced resolution when the blur below is there to upsample it
+        LLRenderTarget* sun_target = deferred_light_target;
+        if (RenderDeferredSSAO && !gCubeSnapshot && updateLightMapDivisor() > 1)
+        {
+            sun_target = &mLightMapLow;
+        }
+
         if ((RenderDeferredSSAO && !gCubeSnapshot) || RenderShadowDetail > 0)
         {
             LL_PROFILE_GPU_ZONE("sun program");
-            deferred_light_target->bindTarget();
+            sun_target->bindTarget();
             {  // paint shadow/SSAO light map (direct lighting lightmap)
                 LL_PROFILE_ZONE_NAMED_CATEGORY_PIPELINE("renderDeferredLighting - sun shadow");
 
                 LLGLSLShader& sun_shader = gCubeSnapshot ? gDeferredSunProbeProgram : gDeferredSunProgram;
                 bindDeferredShader(sun_shader, deferred_light_target);
                 mScreenTriangleVB->setBuffer();
-                deferred_light_target->invalidate(GL_COLOR_BUFFER_BIT);
+                sun_target->invalidate(GL_COLOR_BUFFER_BIT);
 
                 sun_shader.uniform2f(LLShaderMgr::DEFERRED_SCREEN_RES,
-                                              (GLfloat)deferred_light_target->getWidth(),
-                                              (GLfloat)deferred_light_target->getHeight());
+                                              (GLfloat)sun_target->getWidth(),
+                                              (GLfloat)sun_target->getHeight());
 
                 if (RenderDeferredSSAO && !gCubeSnapshot)
                 {
@@ -8279,7 +8869,7 @@ void LLPipeline::renderDeferredLighting()
 
                 unbindDeferredShader(sun_shader);
             }
-            deferred_light_target->flush();
+            sun_target->flush();
         }
 
         if (RenderDeferredSSAO && !gCubeSnapshot)
@@ -8291,7 +8881,16 @@ void LLPipeline::renderDeferredLighting()
             screen_target->bindTarget();
             screen_target->invalidate(GL_COLOR_BUFFER_BIT);
 
-            bindDeferredShader(gDeferredBlurLightProgram);
+            bindDeferredShader(gDeferredBlurLightProgram, sun_target);
+
+            if (sun_target != deferred_light_target)
+            { // filter the reduced resolution light map so the depth aware blur upsamples it smoothly
+                S32 channel = gDeferredBlurLightProgram.getTextureChannel(LLShaderMgr::DEFERRED_LIGHT);
+                if (channel > -1)
+                {
+                    sun_target->bindTexture(0, channel, LLTexUnit::TFO_BILINEAR);
+                }
+            }
 
             LLVector3 go = RenderShadowGaussian;
             const U32 kern_length = 4;
@@ -8394,10 +8993,16 @@ void LLPipeline::renderDeferredLighting()
         }
 
         static LLCachedControl<S32> local_light_count(gSavedSettings, "RenderLocalLightCount", 256);
+        static LLCachedControl<bool> clustered_lights(gSavedSettings, "RenderClusteredLights", true);
 
         if (local_light_count > 0)
         {
             gGL.setSceneBlendType(LLRender::BT_ADD);
+
+            // point lights go through the clustered pass when it's available, projectors keep their own passes
+            bool use_clusters = clustered_lights && gDeferredClusteredLightProgram.isComplete();
+            mLightClusters.clear();
+
             std::list<LLVector4>        fullscreen_lights;
             LLDrawable::drawable_list_t spot_lights;
             LLDrawable::drawable_list_t fullscreen_spot_lights;
@@ -8481,6 +9086,18 @@ void LLPipeline::renderDeferredLighting()
 
                     sVisibleLightCount++;
 
+                    if (use_clusters && !volume->isLightSpotlight())
+                    {
+                        glm::vec3 tc(glm::make_vec3(c));
+                        tc = mul_mat4_vec3(mat, tc);
+
+                        if (mLightClusters.addLight(LLVector4(tc.x, tc.y, tc.z, s),
+                            LLVector4(col.mV[0], col.mV[1], col.mV[2], volume->getLightFalloff(DEFERRED_LIGHT_FALLOFF))))
+                        {
+                            continue;
+                        }
+                    }
+
                     if (camera->getOrigin().mV[0] > c[0] + s + 0.2f || camera->getOrigin().mV[0] < c[0] - s - 0.2f ||
                         camera->getOrigin().mV[1] > c[1] + s + 0.2f || camera->getOrigin().mV[1] < c[1] - s - 0.2f ||
                         camera->getOrigin().mV[2] > c[2] + s + 0.2f || camera->getOrigin().mV[2] < c[2] - s - 0.2f)
@@ -8523,6 +9140,24 @@ void LLPipeline::renderDeferredLighting()
                 unbindDeferredShader(gDeferredLightProgram);
             }
 
+            if (mLightClusters.getLightCount() > 0)
+            {
+                LL_PROFILE_ZONE_NAMED_CATEGORY_PIPELINE("renderDeferredLighting - clustered lights");
+                LL_PROFILE_GPU_ZONE("clustered lights");
+                LLGLDepthTest depth(GL_FALSE);
+
+                mLightClusters.build(get_current_projection(), camera->getNear());
+
+                bindDeferredShader(gDeferredClusteredLightProgram);
+                mLightClusters.bind(gDeferredClusteredLightProgram);
+
+                mScreenTriangleVB->setBuffer();
+                mScreenTriangleVB->drawArrays(LLRender::TRIANGLES, 0, 3);
+
+                mLightClusters.unbind(gDeferredClusteredLightProgram);
+                unbindDeferredShader(gDeferredClusteredLightProgram);
+            }
+
             if (!spot_lights.empty())
             {
                 LL_PROFILE_ZONE_NAMED_CATEGORY_PIPELINE("renderDeferredLighting - projectors");
@@ -8675,7 +9310,15 @@ void LLPipeline::renderDeferredLighting()
                           LLPipeline::RENDER_TYPE_WATER,
                           END_RENDER_TYPES);
 
+        if (!gCubeSnapshot)
+        {
+            gGPUPassTimers.begin(LLGPUPassTimers::PASS_ALPHA);
+        }
         renderGeomPostDeferred(*LLViewerCamera::getInstance());
+        if (!gCubeSnapshot)
+        {
+            gGPUPassTimers.end(LLGPUPassTimers::PASS_ALPHA);
+        }
         popRenderTypeMask();
     }
 
@@ -9626,6 +10269,62 @@ public:
     }
 };
 
+// true if anything in 'result' may cast a different shadow next frame
+// without going through markMoved() or markRebuild()
+static bool has_dynamic_shadow_casters(LLCullResult& result)
+{
+    if (result.getVisibleBridgeSize() > 0 || result.getRiggedAlphaGroupsSize() > 0)
+    { // active linksets and attachments
+        return true;
+    }
+
+    for (LLCullResult::drawable_iterator iter = result.beginVisibleList(); iter != result.endVisibleList(); ++iter)
+    {
+        LLDrawable* drawablep = *iter;
+        if (drawablep->isActive() || drawablep->isAvatar())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool matches_shadow_cache(const LLPipeline::SunShadowCache& cache, const glm::mat4& view, const glm::mat4& proj)
+{
+    static LLCachedControl<U32> max_age(gSavedSettings, "RenderShadowCacheMaxAge", 64);
+    static LLCachedControl<F32> threshold(gSavedSettings, "RenderShadowCacheThreshold", 0.0005f);
+
+    if (!cache.mValid || cache.mEpoch != gPipeline.mShadowCacheEpoch || gFrameCount - cache.mFrame >= max_age)
+    {
+        return false;
+    }
+
+    // relative to the magnitude of each element, so that small sun motion
+    // and float noise in the cascade fit don't force a re-render
+    for (S32 c = 0; c < 4; ++c)
+    {
+        for (S32 r = 0; r < 4; ++r)
+        {
+            if (fabsf(view[c][r] - cache.mView[c][r]) > threshold * llmax(1.f, fabsf(view[c][r])) ||
+                fabsf(proj[c][r] - cache.mProj[c][r]) > threshold * llmax(1.f, fabsf(proj[c][r])))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void LLPipeline::invalidateShadowCache()
+{
+    for (SunShadowCache& cache : mSunShadowCache)
+    {
+        cache.mValid = false;
+    }
+}
+
 void LLPipeline::generateSunShadow(LLCamera& camera)
 {
     if (!sRenderDeferred || RenderShadowDetail <= 0)
@@ -9633,6 +10332,8 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
         return;
     }
 
+    static LLCachedControl<bool> shadow_cache(gSavedSettings, "RenderShadowCache", true);
+
     LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE; //LL_RECORD_BLOCK_TIME(FTM_GEN_SUN_SHADOW);
     LL_PROFILE_GPU_ZONE("generateSunShadow");
 
@@ -9931,6 +10632,11 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
                 }
                 mRT->shadow[j].flush();
 
+                if (!gCubeSnapshot)
+                {
+                    mSunShadowCache[j].mValid = false;
+                }
+
                 mShadowError.mV[j] = 0.f;
                 mShadowFOV.mV[j] = 0.f;
 
@@ -10202,6 +10908,16 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
                             0.0f, 0.0f, 0.5f, 0.0f,
                             0.5f, 0.5f, 0.5f, 1.0f);
 
+            // reflection probe renders have shadow maps of their own
+            SunShadowCache& cache = mSunShadowCache[j];
+            bool use_cache = shadow_cache && !gCubeSnapshot;
+            bool cached = use_cache && matches_shadow_cache(cache, view[j], proj[j]);
+            if (cached)
+            { // keep projecting with the matrices the map was rendered with
+                view[j] = cache.mView;
+                proj[j] = cache.mProj;
+            }
+
             set_current_modelview(view[j]);
             set_current_projection(proj[j]);
 
@@ -10214,16 +10930,26 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
 
             stop_glerror();
 
-            mRT->shadow[j].bindTarget();
-            mRT->shadow[j].getViewport(gGLViewport);
-            mRT->shadow[j].clear();
-
+            if (!cached)
             {
-                static LLCullResult result[4];
-                renderShadow(view[j], proj[j], shadow_cam, result[j], true);
-            }
+                mRT->shadow[j].bindTarget();
+                mRT->shadow[j].getViewport(gGLViewport);
+                mRT->shadow[j].clear();
+
+                U32 epoch = mShadowCacheEpoch;
+                {
+                    static LLCullResult result[4];
+                    renderShadow(view[j], proj[j], shadow_cam, result[j], true);
+
+                    cache.mValid = use_cache && !has_dynamic_shadow_casters(result[j]);
+                }
+                cache.mView = view[j];
+                cache.mProj = proj[j];
+                cache.mEpoch = epoch;
+                cache.mFrame = gFrameCount;
 
-            mRT->shadow[j].flush();
+                mRT->shadow[j].flush();
+            }
 
             if (!gPipeline.hasRenderDebugMask(LLPipeline::RENDER_DEBUG_SHADOW_FRUSTA) && !gCubeSnapshot)
             {
@@ -10730,25 +11456,52 @@ void LLPipeline::generateImpostor(LLVOAvatar* avatar, bool preview_avatar, bool
 
         if (!for_profile)
         {
-            if (!avatar->mImpostor.isComplete())
+            static LLCachedControl<U32> atlas_size(gSavedSettings, "RenderImpostorAtlasSize", 2048);
+            mImpostorAtlas.setSize(atlas_size);
+
+            LLRenderTarget& atlas = mImpostorAtlas.getTarget();
+            if (!atlas.isComplete())
             {
-                avatar->mImpostor.allocate(resX, resY, GL_RGBA, true);
+                mImpostorAtlas.release();
+                atlas.allocate(mImpostorAtlas.getSize(), mImpostorAtlas.getSize(), GL_RGBA, true);
 
                 if (LLPipeline::sRenderDeferred)
                 {
-                    addDeferredAttachments(avatar->mImpostor, true);
+                    addDeferredAttachments(atlas, true);
                 }
 
-                gGL.getTexUnit(0)->bind(&avatar->mImpostor);
-                gGL.getTexUnit(0)->setTextureFilteringOption(LLTexUnit::TFO_POINT);
+                // point sampled so tiles don't bleed into their neighbors
+                for (U32 i = 0; i < atlas.getNumTextures(); ++i)
+                {
+                    atlas.bindTexture(i, 0, LLTexUnit::TFO_POINT);
+                }
                 gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
             }
-            else if (resX != avatar->mImpostor.getWidth() || resY != avatar->mImpostor.getHeight())
+
+            // with the atlas full the impostor gets a lower resolution rather than none
+            while (!mImpostorAtlas.allocateTile(avatar->mImpostorTile, resX, resY))
             {
-                avatar->mImpostor.resize(resX, resY);
+                if (llmax(resX, resY) <= LLImpostorAtlas::MIN_TILE_SIZE)
+                {
+                    LL_WARNS_ONCE("AvatarRenderPipeline") << "No room left in the impostor atlas" << LL_ENDL;
+
+                    gGL.matrixMode(LLRender::MM_PROJECTION);
+                    gGL.popMatrix();
+                    gGL.matrixMode(LLRender::MM_MODELVIEW);
+                    gGL.popMatrix();
+
+                    sUseOcclusion = occlusion;
+                    sReflectionRender = false;
+                    sImpostorRender = false;
+                    sShadowRender = false;
+                    popRenderTypeMask();
+                    return;
+                }
+                resX = llmax(resX / 2, LLImpostorAtlas::MIN_TILE_SIZE);
+                resY = llmax(resY / 2, LLImpostorAtlas::MIN_TILE_SIZE);
             }
 
-            avatar->mImpostor.bindTarget();
+            mImpostorAtlas.bindTarget(avatar->mImpostorTile);
         }
     }
 
@@ -10767,7 +11520,7 @@ void LLPipeline::generateImpostor(LLVOAvatar* avatar, bool preview_avatar, bool
     }
     else
     {
-        avatar->mImpostor.clear();
+        mImpostorAtlas.clearTile(avatar->mImpostorTile);
         renderGeomDeferred(camera);
 
         renderGeomPostDeferred(camera);
@@ -10859,7 +11612,7 @@ void LLPipeline::generateImpostor(LLVOAvatar* avatar, bool preview_avatar, bool
 
     if (!preview_avatar && !for_profile)
     {
-        avatar->mImpostor.flush();
+        mImpostorAtlas.getTarget().flush();
         avatar->setImpostorDim(tdim);
     }
 
@@ -11207,6 +11960,11 @@ void LLPipeline::skipRenderingShadows()
 {
     LLGLDepthTest depth(GL_TRUE);
 
+    if (!gCubeSnapshot)
+    {
+        invalidateShadowCache();
+    }
+
     for (S32 j = 0; j < 4; j++)
     {
         mRT->shadow[j].bindTarget();
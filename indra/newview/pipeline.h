@@ -40,6 +40,12 @@
 #include "llrendertarget.h"
 #include "llreflectionmapmanager.h"
 #include "llheroprobemanager.h"
+#include "llrendergraph.h"
+#include "lllightclusters.h"
+#include "llterraingpu.h"
+#include "llimpostoratlas.h"
+#include "llskinpalettes.h"
+#include "threadpool_fwd.h"
 
 #include <stack>
 
@@ -159,9 +165,19 @@ public:
     void gammaCorrect(LLRenderTarget* src, LLRenderTarget* dst);
     void generateGlow(LLRenderTarget* src);
     void applyCAS(LLRenderTarget* src, LLRenderTarget* dst);
-    void applyFXAA(LLRenderTarget* src, LLRenderTarget* dst);
-    void generateSMAABuffers(LLRenderTarget* src);
-    void applySMAA(LLRenderTarget* src, LLRenderTarget* dst);
+    void applyFXAA(LLRenderTarget* src, LLRenderTarget* dst, LLRenderTarget* scratch);
+    void generateSMAABuffers(LLRenderTarget* src, LLRenderTarget* edges, LLRenderTarget* blend);
+    void applySMAA(LLRenderTarget* src, LLRenderTarget* dst, LLRenderTarget* blend);
+    void applyTemporalUpscale(LLRenderTarget* src, LLRenderTarget* dst, LLRenderTarget* history);
+
+    // offset the main camera's projection by this frame's sub-pixel jitter for the temporal upscaler,
+    // call after the camera is set up and before the scene is drawn, and undo it once the scene is lit
+    void jitterProjection();
+    void unjitterProjection();
+
+    // divisor of the resolution the sun shadow/SSAO light map is rendered at this frame,
+    // allocates or frees mLightMapLow to match
+    U32 updateLightMapDivisor();
     void renderDoF(LLRenderTarget* src, LLRenderTarget* dst);
     void copyRenderTarget(LLRenderTarget* src, LLRenderTarget* dst);
     void combineGlow(LLRenderTarget* src, LLRenderTarget* dst);
@@ -265,6 +281,8 @@ public:
 
     // Populate given LLCullResult with results of a frustum cull of the entire scene against the given LLCamera
     void updateCull(LLCamera& camera, LLCullResult& result);
+    void cullPartitions(LLCamera& camera, const std::vector<LLSpatialPartition*>& parts,
+                        std::vector<std::vector<LLSpatialGroup*> >& visible);
     void createObjects(F32 max_dtime);
     void createObject(LLViewerObject* vobj);
     void processPartitionQ();
@@ -346,6 +364,9 @@ public:
     void renderHighlight(const LLViewerObject* obj, F32 fade);
 
     void renderShadow(const glm::mat4& view, const glm::mat4& proj, LLCamera& camera, LLCullResult& result, bool depth_clamp);
+    void invalidateShadowCache();
+    // bumps mShadowCacheEpoch if 'drawablep' may cast a sun shadow
+    void noteShadowCasterChange(LLDrawable* drawablep);
     void renderSelectedFaces(const LLColor4& color);
     void renderHighlights();
     void renderDebug();
@@ -644,6 +665,10 @@ public:
     S32                      mTextureMatrixOps;
     S32                      mNumVisibleNodes;
 
+    // frustum culls spatial partitions in parallel when occlusion is off, also runs the
+    // avatar motion updates of LLVOAvatar::updateDeferredCharacters
+    std::unique_ptr<LL::ThreadPool> mCullPool;
+
     S32                      mDebugTextureUploadCost;
     S32                      mDebugSculptUploadCost;
     S32                      mDebugMeshUploadCost;
@@ -724,12 +749,32 @@ public:
     LLRenderTarget          mExposureMap;
     LLRenderTarget          mLastExposure;
 
-    // tonemapped and gamma corrected render ready for post
-    LLRenderTarget          mPostMap;
-
-    // FXAA helper target
-    LLRenderTarget          mFXAAMap;
-    LLRenderTarget          mSMAABlendBuffer;
+    // weighted blended transparency accumulation (sum of weighted color + revealage, sum of weights), see LLDrawPoolAlpha::renderOIT
+    LLRenderTarget          mOITMap;
+
+    // display resolution output of the temporal upscaler, the one written last frame is this frame's history
+    LLRenderTarget          mUpscaleHistory[2];
+    U32                     mUpscaleHistoryIndex = 0;
+    bool                    mUpscaleHistoryValid = false;
+
+    // jitter of the current frame (render texels and NDC) and of the last one (NDC), see jitterProjection
+    LLVector2               mUpscaleJitter;
+    LLVector2               mUpscaleJitterNDC;
+    LLVector2               mUpscaleLastJitterNDC;
+    U32                     mUpscaleJitterIndex = 0;
+    bool                    mUpscaleJittered = false; // this frame's scene was rendered jittered and still needs upscaling
+    glm::mat4               mUpscaleReprojection;   // this frame's clip space to last frame's, both jittered
+    glm::mat4               mUnjitteredProjection;
+
+    // reduced resolution sun shadow/SSAO light map, upsampled into mRT->deferredLight by the light map blur
+    LLRenderTarget          mLightMapLow;
+    U32                     mLightMapDivisor = 1;
+    U32                     mAdaptiveLightMapDivisor = 1;
+    F32                     mAdaptiveFrameTime = 0.f;   // smoothed frame time driving mAdaptiveLightMapDivisor
+    U32                     mAdaptiveLightMapFrame = 0; // frame mAdaptiveLightMapDivisor last changed
+
+    // post processing passes and their scratch targets (tonemapped render, FXAA/SMAA helpers), see renderFinalize
+    LLRenderGraph           mPostGraph;
 
     // render ui to buffer target
     LLRenderTarget          mUIScreen;
@@ -753,6 +798,18 @@ public:
     //utility buffer for rendering cubes, 8 vertices are corners of a cube [-1, 1]
     LLPointer<LLVertexBuffer> mCubeVB;
 
+    // per cluster lists of the point lights lit in a single pass, see renderDeferredLighting
+    LLLightClusters         mLightClusters;
+
+    // shared patch grids for drawing the terrain from height maps, see LLDrawPoolTerrain
+    LLTerrainGPU            mTerrainGPU;
+
+    // joint palettes of this frame's rigged meshes, see LLRenderPass::uploadMatrixPalette
+    LLSkinPalettes          mSkinPalettes;
+
+    // the avatar impostors, see generateImpostor and LLVOAvatar::renderImpostor
+    LLImpostorAtlas         mImpostorAtlas;
+
     //list of currently bound reflection maps
     std::vector<LLReflectionMap*> mReflectionMaps;
 
@@ -768,6 +825,21 @@ public:
     glm::mat4               mShadowProjection[6];
     glm::mat4               mReflectionModelView;
 
+    // Sun shadow cascades are kept from one frame to the next while their
+    // matrices stay within RenderShadowCacheThreshold and nothing that
+    // could cast into them moved or changed (see mShadowCacheEpoch)
+    struct SunShadowCache
+    {
+        glm::mat4 mView;
+        glm::mat4 mProj;
+        U32 mEpoch = 0;
+        U32 mFrame = 0;
+        bool mValid = false;
+    };
+    SunShadowCache          mSunShadowCache[4];
+    // bumped whenever a drawable moves, is rebuilt, retextured or removed
+    U32                     mShadowCacheEpoch = 0;
+
     LLPointer<LLDrawable>   mShadowSpotLight[2];
     F32                     mSpotLightFade[2];
     LLPointer<LLDrawable>   mTargetShadowSpotLight[2];
@@ -1066,6 +1138,14 @@ public:
     static F32 CameraDoFResScale;
     static F32 RenderAutoHideSurfaceAreaLimit;
     static bool RenderScreenSpaceReflections;
+    static bool RenderAlphaOIT;
+    static bool RenderTemporalUpscale;
+    static F32 RenderTemporalUpscaleScale;
+    static constexpr U32 MAX_LIGHT_MAP_DIVISOR = 4;
+    static U32 RenderLightMapDivisor;
+    static bool RenderAdaptiveLightMap;
+    static bool RenderTerrainGPU;
+    static F32 RenderReflectionMinCoverage;
     static S32 RenderScreenSpaceReflectionIterations;
     static F32 RenderScreenSpaceReflectionRayStep;
     static F32 RenderScreenSpaceReflectionDistanceBias;
@@ -0,0 +1,33 @@
+-- Engage the LLAgentPilot LLEventAPI, to replay autopilot paths and benchmark
+-- the scene. Both wait until done and return the frame stats of the session's
+-- runs, which are also written to the StatsPilotReportFile and
+-- StatsPilotFrameFile files in the logs directory.
+
+local leap = require 'leap'
+
+local LLAgentPilot = {}
+
+-- Replay the autopilot path in file, or the last one loaded, runs times
+function LLAgentPilot.play(file, runs)
+    return leap.request('LLAgentPilot', {op='play', file=file, runs=runs}).runs
+end
+
+-- Render in place for seconds, after warmup seconds (default
+-- StatsBenchmarkWarmup) to let the scene load. Returns the stats of this
+-- benchmark and of all the runs.
+function LLAgentPilot.benchmark(seconds, warmup)
+    local result = leap.request('LLAgentPilot', {op='benchmark', seconds=seconds, warmup=warmup})
+    return result.run, result.runs
+end
+
+function LLAgentPilot.stop()
+    leap.send('LLAgentPilot', {op='stop'})
+end
+
+-- Return the stats of the runs finished so far, and whether the pilot is
+-- playing or benchmarking
+function LLAgentPilot.getStats()
+    return leap.request('LLAgentPilot', {op='getStats'})
+end
+
+return LLAgentPilot
@@ -27,6 +27,8 @@
 S32 AABBSphereIntersect(const LLVector4a& min, const LLVector4a& max, const LLVector3 &origin, const F32 &rad) { return 0; }
 
 void LLViewerOctreeCull::traverse(const LLOctreeNode<LLViewerOctreeEntry, LLPointer<LLViewerOctreeEntry> >* node) { }
+void LLViewerOctreeCull::traverseFlat(const LLViewerOctreeFlat& flat) { }
+void LLViewerOctreeCull::frustumCheckBatch(const LLViewerOctreeGroup* const* groups, const LLVector4a* const* bounds, U32 count, S32* results) { }
 void LLViewerOctreeCull::visit(const LLOctreeNode<LLViewerOctreeEntry, LLPointer<LLViewerOctreeEntry> >* node) { }
 void LLViewerOctreeCull::preprocess(LLViewerOctreeGroup* group) {}
 bool LLViewerOctreeCull::earlyFail(LLViewerOctreeGroup* group) { return false; }
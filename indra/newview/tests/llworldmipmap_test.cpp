@@ -43,6 +43,8 @@
 // * A simulator for a class can be implemented here. Please comment and document thoroughly.
 
 void LLGLTexture::setBoostLevel(S32 ) { }
+void LLViewerTexture::addTextureStats(F32 , bool ) const { }
+void LLViewerTexture::resetTextureStats() { }
 LLViewerFetchedTexture* LLViewerTextureManager::getFetchedTextureFromUrl(const std::string&, FTType, bool, LLGLTexture::EBoostLevel, S8,
                                                                          LLGLint, LLGLenum, const LLUUID& ) { return NULL; }
 
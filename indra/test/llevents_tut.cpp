@@ -452,4 +452,98 @@ void events_object::test<9>()
     heaptest.stopListening("temp");
 }
 
+template<> template<>
+void events_object::test<10>()
+{
+    set_test_name("LLEventFastStream");
+    typedef LLEventPump::NameList NameList;
+    ensure("mainloop is fast", dynamic_cast<LLEventFastStream*>(&pumps.obtain("mainloop")));
+
+    LLEventFastStream fast("fast", true);
+    Collect collector;
+    fast.listen("Mary",
+                boost::bind(&Collect::add, boost::ref(collector), "Mary", _1),
+                make<NameList>(list_of("checked")));
+    LLBoundListener checked =
+        fast.listen("checked",
+                    boost::bind(&Collect::add, boost::ref(collector), "checked", _1),
+                    make<NameList>(list_of("spot")));
+    fast.listen("spot",
+                boost::bind(&Collect::add, boost::ref(collector), "spot", _1));
+    fast.post(1);
+    ensure_equals("dependency order", collector.result,
+                  make<StringVec>(list_of("spot")("checked")("Mary")));
+
+    collector.clear();
+    {
+        LLEventPump::Blocker block(checked);
+        fast.post(2);
+    }
+    ensure_equals("blocked", collector.result, make<StringVec>(list_of("spot")("Mary")));
+
+    collector.clear();
+    checked.disconnect();
+    fast.stopListening("spot");
+    fast.post(3);
+    ensure_equals("disconnected", collector.result, make<StringVec>(list_of("Mary")));
+    ensure_contains("duplicate name",
+                    catch_what<LLEventPump::DupListenerName>(
+                        [&fast](){ fast.listen("Mary", [](const LLSD&){ return false; }); }),
+                    "'Mary'");
+
+    // the first listener to handle the event stops it, and post() says so
+    collector.clear();
+    ensure("unhandled", ! fast.post(4));
+    {
+        LLTempBoundListener handler(
+            fast.listen("handler", [](const LLSD& event){ return event.asInteger() == 5; },
+                        LLEventPump::empty, make<NameList>(list_of("Mary"))));
+        ensure("not handled", ! fast.post(4));
+        collector.clear();
+        ensure("handled", fast.post(5));
+        ensure("stopped", collector.result.empty());
+    }
+    ensure("handler gone", ! fast.post(5));
+    ensure_equals("Mary again", collector.result, make<StringVec>(list_of("Mary")));
+
+    fast.enable(false);
+    collector.clear();
+    fast.post(6);
+    ensure("disabled", collector.result.empty());
+}
+
+template<> template<>
+void events_object::test<11>()
+{
+    set_test_name("LLEventTypedStream");
+    struct Frame
+    {
+        S32 mCount;
+    };
+    LLEventTypedStream<Frame> frames("frames", true);
+    S32 total = 0;
+    LLTempBoundListener typed(
+        frames.listenTyped("total", [&total](const Frame& frame){ total += frame.mCount; }));
+    LLTempBoundListener stopper(
+        frames.listenTyped("stopper", [](const Frame& frame){ return frame.mCount < 0; },
+                           LLEventPump::empty, make<LLEventPump::NameList>(list_of("total"))));
+    listener0.reset(0);
+    LLTempBoundListener untyped(listener0.listenTo(frames));
+
+    ensure("typed unhandled", ! frames.post(Frame{ 3 }));
+    ensure_equals("typed listener", total, 3);
+    check_listener("LLSD listener doesn't see typed posts", listener0, 0);
+
+    ensure("typed handled", frames.post(Frame{ -10 }));
+    ensure_equals("stopped before total", total, 3);
+
+    frames.post(LLSD(17));
+    ensure_equals("typed listener doesn't see LLSD posts", total, 3);
+    check_listener("LLSD post", listener0, 17);
+
+    typed.disconnect();
+    frames.post(Frame{ 4 });
+    ensure_equals("disconnected", total, 3);
+}
+
 } // namespace tut
@@ -35,6 +35,8 @@
 #include "llquaternion.h"
 #include "lltemplatemessagebuilder.h"
 #include "lltemplatemessagereader.h"
+#include "lltimer.h"
+#include "message.h"
 #include "message_prehash.h"
 #include "u64.h"
 #include "v3dmath.h"
@@ -967,5 +969,97 @@ namespace tut
         ensure_equals("Ensure unchanged buffer ", strlen(outBuffer), 0);
         delete reader;
     }
+
+    // zero code the built message and expand it again, returns the encoded size
+    static U32 zeroCodeRoundTrip(const U8* data, U32 data_size, const char* msg)
+    {
+        const U32 bufferSize = 1024;
+        LLMessageTemplate messageTemplate = LLTemplateMessageBuilderTestData::defaultTemplate();
+        messageTemplate.setEncoding(ME_ZEROCODED);
+        messageTemplate.addBlock(LLTemplateMessageBuilderTestData::defaultBlock(MVT_FIXED, data_size, MBT_SINGLE));
+        LLTemplateMessageBuilder* builder = LLTemplateMessageBuilderTestData::defaultBuilder(messageTemplate);
+        builder->addBinaryData(_PREHASH_Test0, data, data_size);
+
+        U8 buffer[bufferSize];
+        memset(buffer, 0, LL_PACKET_ID_SIZE);
+        U32 builtSize = builder->buildMessage(buffer, bufferSize, 0);
+        U8 built[bufferSize];
+        memcpy(built, buffer, builtSize);
+
+        U8* buf_ptr = buffer;
+        U32 encodedSize = builtSize;
+        builder->compressMessage(buf_ptr, encodedSize);
+        delete builder;
+        ensure("Ensure zero coding did not grow the message", encodedSize <= builtSize);
+
+        S32 expandedSize = encodedSize;
+        gMessageSystem->zeroCodeExpand(&buf_ptr, &expandedSize);
+        ensure_equals(msg, (U32)expandedSize, builtSize);
+        ensure(msg, memcmp(buf_ptr, built, builtSize) == 0);
+        return encodedSize;
+    }
+
+    template<> template<>
+    void LLTemplateMessageBuilderTestObject::test<46>()
+        // zero coding round trips
+    {
+        U8 data[600];
+
+        // one long run, wraps, encodes over the message itself
+        memset(data, 0, sizeof(data));
+        data[sizeof(data) - 1] = 1;
+        ensure("Ensure long run compresses", zeroCodeRoundTrip(data, sizeof(data), "Ensure long run") < 100);
+
+        // isolated zeros first, the encoding runs ahead of the data
+        for (U32 i = 0; i < sizeof(data); ++i)
+        {
+            data[i] = (i % 2 || i > 64) ? (U8)(i | 1) : 0;
+        }
+        memset(data + 100, 0, 200);
+        zeroCodeRoundTrip(data, sizeof(data), "Ensure isolated zeros");
+
+        // nothing to gain, left as it is
+        for (U32 i = 0; i < sizeof(data); ++i)
+        {
+            data[i] = (U8)(i | 1);
+        }
+        ensure_equals("Ensure no zeros",
+            zeroCodeRoundTrip(data, sizeof(data), "Ensure no zeros"),
+            (U32)(sizeof(data) + LL_PACKET_ID_SIZE + 1)); // + the message number
+    }
+
+    template<> template<>
+    void LLTemplateMessageBuilderTestObject::test<47>()
+        // building and zero coding an AgentUpdate sized message, timed
+    {
+        LLMessageTemplate messageTemplate = defaultTemplate();
+        messageTemplate.setEncoding(ME_ZEROCODED);
+        messageTemplate.addBlock(defaultBlock(MVT_FIXED, 100, MBT_SINGLE));
+        U8 data[100];
+        for (U32 i = 0; i < sizeof(data); ++i)
+        {
+            data[i] = (i % 5) ? 0 : (U8)i; // floats near zero are mostly zero bytes
+        }
+
+        const S32 iterations = 10000;
+        U32 total = 0;
+        LLTimer timer;
+        for (S32 i = 0; i < iterations; ++i)
+        {
+            LLTemplateMessageBuilder* builder = defaultBuilder(messageTemplate);
+            builder->addBinaryData(_PREHASH_Test0, data, sizeof(data));
+            U8 buffer[MAX_BUFFER_SIZE];
+            memset(buffer, 0, LL_PACKET_ID_SIZE);
+            U32 size = builder->buildMessage(buffer, MAX_BUFFER_SIZE, 0);
+            U8* buf_ptr = buffer;
+            builder->compressMessage(buf_ptr, size);
+            total += size;
+            delete builder;
+        }
+        F64 seconds = timer.getElapsedTimeF64();
+        LL_INFOS() << "Built and zero coded " << iterations << " messages in " << seconds * 1000.0 << " ms, "
+                   << seconds * 1.0e9 / iterations << " ns per message" << LL_ENDL;
+        ensure("Ensure messages compressed", total < (U32)(iterations * (sizeof(data) + LL_PACKET_ID_SIZE + 1)));
+    }
 }
 